@@ -0,0 +1,463 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file llm_bench.cc
+ * \brief Serving benchmark of a Relax language model with the paged KV cache.
+ *
+ * Synthetic requests arrive as a Poisson process and are served by continuous batching: the
+ * waiting requests are prefilled first, as many as fit in a prefill chunk, otherwise all the
+ * running requests decode one token. The tool reports the time to first token, the inter-token
+ * latency and the throughput.
+ */
+#include <dmlc/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "llm_runner.h"
+
+using namespace std;
+using namespace tvm::runtime;
+
+static const string kUsage =
+    "Command line usage\n"
+    "--model              - The folder containing the Relax VM executable mod.so and optionally "
+    "params/\n"
+    "--device             - The target device to use {llvm, opencl, cpu, cuda, metal, rocm, "
+    "vulkan}\n"
+    "--num-requests       - The number of requests, default 100\n"
+    "--request-rate       - The mean arrivals per second, default 0 sends all requests at once\n"
+    "--prompt-len         - The prompt length distribution, default uniform:64:512\n"
+    "--output-len         - The output length distribution, default uniform:64:256\n"
+    "--max-batch-size     - The maximum number of running requests, default 32\n"
+    "--max-total-seq-len  - The maximum number of tokens in the KV cache, default 16384\n"
+    "--prefill-chunk-size - The maximum number of tokens in a prefill, default 2048\n"
+    "--page-size          - The number of tokens of a KV cache page, default 16\n"
+    "--vocab-size         - The range of the synthetic token ids, default 32000\n"
+    "--seed               - The seed of the synthetic workload, default 0\n"
+    "--output             - Json file name to dump the results\n"
+    "\n"
+    "  A length distribution is one of fixed:<n>, uniform:<min>:<max>, normal:<mean>:<stddev>\n"
+    "  or exponential:<mean>.\n"
+    "\n"
+    "  Example\n"
+    "  ./rtvm_llm_bench --model=llama --device=cuda --request-rate=4 --prompt-len=fixed:512\n"
+    "\n";
+
+/*!
+ * \brief Tool Arguments.
+ * \arg model The folder of the Relax VM executable to load & run
+ * \arg device The target device to use {llvm, cl, ...etc.}
+ * \arg request_rate The mean arrivals per second, or 0 for all at once
+ * \arg prompt_len The prompt length distribution
+ * \arg output_len The output length distribution
+ * \arg output Json file name to dump the results
+ */
+struct ToolArgs {
+  string model;
+  string device;
+  int num_requests{100};
+  double request_rate{0};
+  string prompt_len{"uniform:64:512"};
+  string output_len{"uniform:64:256"};
+  int64_t max_batch_size{32};
+  int64_t max_total_seq_len{16384};
+  int64_t prefill_chunk_size{2048};
+  int64_t page_size{16};
+  int32_t vocab_size{32000};
+  int seed{0};
+  string output;
+};
+
+/*!
+ * \brief PrintArgs print the contents of ToolArgs
+ * \param args ToolArgs structure
+ */
+void PrintArgs(const ToolArgs& args) {
+  LOG(INFO) << "Model              = " << args.model;
+  LOG(INFO) << "Device             = " << args.device;
+  LOG(INFO) << "Num Requests       = " << args.num_requests;
+  LOG(INFO) << "Request Rate       = " << args.request_rate;
+  LOG(INFO) << "Prompt Len         = " << args.prompt_len;
+  LOG(INFO) << "Output Len         = " << args.output_len;
+  LOG(INFO) << "Max Batch Size     = " << args.max_batch_size;
+  LOG(INFO) << "Max Total Seq Len  = " << args.max_total_seq_len;
+  LOG(INFO) << "Prefill Chunk Size = " << args.prefill_chunk_size;
+  LOG(INFO) << "Page Size          = " << args.page_size;
+  LOG(INFO) << "Vocab Size         = " << args.vocab_size;
+  LOG(INFO) << "Seed               = " << args.seed;
+  LOG(INFO) << "Output             = " << args.output;
+}
+
+/*!
+ * \brief GetCmdOption Parse and find the command option.
+ * \param argc arg counter
+ * \param argv arg values
+ * \param option command line option to search for, ending with "=".
+ * \return value corresponding to option.
+ */
+string GetCmdOption(int argc, char* argv[], string option) {
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg.find(option) == 0) {
+      return arg.substr(option.size());
+    }
+  }
+  return "";
+}
+
+/*!
+ * \brief ParseCmdArgs parses the command line arguments.
+ * \param argc arg counter
+ * \param argv arg values
+ * \param args the output structure which holds the parsed values
+ */
+void ParseCmdArgs(int argc, char* argv[], struct ToolArgs& args) {
+  args.model = GetCmdOption(argc, argv, "--model=");
+  args.device = GetCmdOption(argc, argv, "--device=");
+  if (args.model.empty() || args.device.empty()) {
+    LOG(INFO) << kUsage;
+    exit(0);
+  }
+  auto f_parse = [&](const string& option, auto* value) {
+    const string str = GetCmdOption(argc, argv, option);
+    if (!str.empty()) {
+      std::istringstream is(str);
+      is >> *value;
+      CHECK(!is.fail()) << "Invalid value of " << option << str;
+    }
+  };
+  f_parse("--num-requests=", &args.num_requests);
+  f_parse("--request-rate=", &args.request_rate);
+  f_parse("--prompt-len=", &args.prompt_len);
+  f_parse("--output-len=", &args.output_len);
+  f_parse("--max-batch-size=", &args.max_batch_size);
+  f_parse("--max-total-seq-len=", &args.max_total_seq_len);
+  f_parse("--prefill-chunk-size=", &args.prefill_chunk_size);
+  f_parse("--page-size=", &args.page_size);
+  f_parse("--vocab-size=", &args.vocab_size);
+  f_parse("--seed=", &args.seed);
+  args.output = GetCmdOption(argc, argv, "--output=");
+}
+
+/*!
+ * \brief A distribution of the prompt or output lengths.
+ */
+class LengthDistribution {
+ public:
+  /*!
+   * \brief Constructor
+   * \param spec the distribution, see kUsage.
+   * \param max_length the length the samples are clipped to.
+   */
+  LengthDistribution(const string& spec, int64_t max_length) : max_length_(max_length) {
+    std::istringstream is(spec);
+    std::getline(is, kind_, ':');
+    string token;
+    while (std::getline(is, token, ':')) {
+      params_.push_back(std::stod(token));
+    }
+    size_t num_params = kind_ == "fixed" || kind_ == "exponential" ? 1 : 2;
+    CHECK(kind_ == "fixed" || kind_ == "uniform" || kind_ == "normal" || kind_ == "exponential")
+        << "Unknown length distribution: " << spec;
+    CHECK_EQ(params_.size(), num_params) << "Invalid length distribution: " << spec;
+  }
+
+  /*! \brief Draw a length within [1, max_length] */
+  int64_t Sample(std::mt19937_64* rng) const {
+    double length = params_[0];
+    if (kind_ == "uniform") {
+      length = std::uniform_int_distribution<int64_t>(params_[0], params_[1])(*rng);
+    } else if (kind_ == "normal") {
+      length = std::round(std::normal_distribution<double>(params_[0], params_[1])(*rng));
+    } else if (kind_ == "exponential") {
+      length = std::ceil(std::exponential_distribution<double>(1.0 / params_[0])(*rng));
+    }
+    return std::min<int64_t>(std::max<int64_t>(length, 1), max_length_);
+  }
+
+ private:
+  /*! \brief The kind of the distribution */
+  string kind_;
+  /*! \brief The parameters of the distribution */
+  std::vector<double> params_;
+  /*! \brief The maximum length */
+  int64_t max_length_;
+};
+
+/*!
+ * \brief A synthetic request and its timeline, in seconds since the benchmark starts.
+ */
+struct Request {
+  int64_t id;
+  double arrival_time;
+  std::vector<int32_t> prompt;
+  int64_t output_len;
+  int64_t num_generated{0};
+  double first_token_time{0};
+  double last_token_time{0};
+};
+
+/*!
+ * \brief Generate the synthetic requests.
+ * \param args tool arguments
+ * \return the requests in order of arrival.
+ */
+std::vector<Request> GenerateRequests(const ToolArgs& args) {
+  std::mt19937_64 rng(args.seed);
+  // A request never holds more than the KV cache or a prefill chunk
+  LengthDistribution prompt_len(args.prompt_len,
+                                std::min(args.prefill_chunk_size, args.max_total_seq_len - 1));
+  LengthDistribution output_len(args.output_len, args.max_total_seq_len);
+  std::exponential_distribution<double> interval(args.request_rate > 0 ? args.request_rate : 1);
+  std::uniform_int_distribution<int32_t> token(0, args.vocab_size - 1);
+  std::vector<Request> requests;
+  double time = 0;
+  for (int i = 0; i < args.num_requests; ++i) {
+    Request request;
+    request.id = i;
+    request.arrival_time = time;
+    request.prompt.resize(prompt_len.Sample(&rng));
+    for (int32_t& token_id : request.prompt) {
+      token_id = token(rng);
+    }
+    request.output_len = std::min<int64_t>(output_len.Sample(&rng),
+                                           args.max_total_seq_len - request.prompt.size());
+    requests.push_back(std::move(request));
+    if (args.request_rate > 0) {
+      time += interval(rng);
+    }
+  }
+  return requests;
+}
+
+/*!
+ * \brief Summary statistics of latencies.
+ */
+struct LatencyStats {
+  double mean{0}, p50{0}, p90{0}, p99{0};
+
+  explicit LatencyStats(std::vector<double> samples) {
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    auto f_percentile = [&](double q) {
+      return samples[std::min<size_t>(q * samples.size(), samples.size() - 1)];
+    };
+    for (double sample : samples) mean += sample;
+    mean /= samples.size();
+    p50 = f_percentile(0.5);
+    p90 = f_percentile(0.9);
+    p99 = f_percentile(0.99);
+  }
+
+  /*! \brief Print the statistics in milliseconds */
+  string ToString() const {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2) << "mean " << mean * 1e3 << " ms, p50 " << p50 * 1e3
+       << " ms, p90 " << p90 * 1e3 << " ms, p99 " << p99 * 1e3 << " ms";
+    return os.str();
+  }
+
+  /*! \brief Dump the statistics in milliseconds as json */
+  string ToJSON() const {
+    std::ostringstream os;
+    os << "{\"mean_ms\": " << mean * 1e3 << ", \"p50_ms\": " << p50 * 1e3
+       << ", \"p90_ms\": " << p90 * 1e3 << ", \"p99_ms\": " << p99 * 1e3 << "}";
+    return os.str();
+  }
+};
+
+/*!
+ * \brief Serves the synthetic requests and reports the statistics.
+ * \param args tool arguments
+ * \return result of operation.
+ */
+int ExecuteBenchmark(const ToolArgs& args) {
+  LLMRunner runner(args.model, args.device);
+  runner.Load();
+  runner.CreateKVCache(args.max_batch_size, args.max_total_seq_len, args.prefill_chunk_size,
+                       args.page_size);
+  std::vector<Request> requests = GenerateRequests(args);
+
+  // Warm up the kernels with a request served out of the timeline
+  int64_t warmup_id = requests.size();
+  runner.AddSequence(warmup_id);
+  runner.Prefill({warmup_id}, {requests[0].prompt});
+  runner.Decode({warmup_id}, {0});
+  runner.Synchronize();
+  runner.RemoveSequence(warmup_id);
+
+  std::mt19937_64 rng(args.seed + 1);
+  std::uniform_int_distribution<int32_t> token(0, args.vocab_size - 1);
+  std::vector<double> ttft, itl, e2e;
+  std::deque<Request*> waiting;
+  std::vector<Request*> running;
+  size_t num_arrived = 0, num_finished = 0;
+  int64_t num_reserved_tokens = 0, num_prefill_steps = 0, num_decode_steps = 0;
+
+  auto tstart = std::chrono::high_resolution_clock::now();
+  auto f_now = [&]() {
+    auto elapsed = std::chrono::high_resolution_clock::now() - tstart;
+    return std::chrono::duration<double>(elapsed).count();
+  };
+  while (num_finished < requests.size()) {
+    double now = f_now();
+    while (num_arrived < requests.size() && requests[num_arrived].arrival_time <= now) {
+      waiting.push_back(&requests[num_arrived++]);
+    }
+    // Admit the waiting requests whose whole lifetime fits in the batch and the KV cache
+    std::vector<Request*> prefill;
+    int64_t num_prefill_tokens = 0;
+    while (!waiting.empty()) {
+      Request* request = waiting.front();
+      int64_t length = request->prompt.size();
+      int64_t reserved = length + request->output_len;
+      if (static_cast<int64_t>(running.size() + prefill.size()) >= args.max_batch_size ||
+          num_prefill_tokens + length > args.prefill_chunk_size ||
+          num_reserved_tokens + reserved > args.max_total_seq_len) {
+        break;
+      }
+      waiting.pop_front();
+      prefill.push_back(request);
+      num_prefill_tokens += length;
+      num_reserved_tokens += reserved;
+    }
+
+    std::vector<Request*> finished;
+    if (!prefill.empty()) {
+      std::vector<int64_t> seq_ids;
+      std::vector<std::vector<int32_t>> token_ids;
+      for (Request* request : prefill) {
+        runner.AddSequence(request->id);
+        seq_ids.push_back(request->id);
+        token_ids.push_back(request->prompt);
+      }
+      runner.Prefill(seq_ids, token_ids);
+      runner.Synchronize();
+      now = f_now();
+      for (Request* request : prefill) {
+        request->first_token_time = request->last_token_time = now;
+        request->num_generated = 1;
+        ttft.push_back(now - request->arrival_time);
+        (request->num_generated == request->output_len ? finished : running).push_back(request);
+      }
+      ++num_prefill_steps;
+    } else if (!running.empty()) {
+      std::vector<int64_t> seq_ids;
+      std::vector<int32_t> token_ids;
+      for (Request* request : running) {
+        seq_ids.push_back(request->id);
+        token_ids.push_back(token(rng));
+      }
+      runner.Decode(seq_ids, token_ids);
+      runner.Synchronize();
+      now = f_now();
+      std::vector<Request*> still_running;
+      for (Request* request : running) {
+        itl.push_back(now - request->last_token_time);
+        request->last_token_time = now;
+        ++request->num_generated;
+        (request->num_generated == request->output_len ? finished : still_running)
+            .push_back(request);
+      }
+      running = std::move(still_running);
+      ++num_decode_steps;
+    } else if (num_arrived < requests.size()) {
+      // Idle until the next arrival
+      std::this_thread::sleep_for(
+          std::chrono::duration<double>(requests[num_arrived].arrival_time - now));
+    }
+    for (Request* request : finished) {
+      runner.RemoveSequence(request->id);
+      num_reserved_tokens -= request->prompt.size() + request->output_len;
+      e2e.push_back(request->last_token_time - request->arrival_time);
+      ++num_finished;
+    }
+  }
+  double duration = f_now();
+
+  int64_t num_prompt_tokens = 0, num_output_tokens = 0;
+  for (const Request& request : requests) {
+    num_prompt_tokens += request.prompt.size();
+    num_output_tokens += request.output_len;
+  }
+  LatencyStats ttft_stats(ttft), itl_stats(itl), e2e_stats(e2e);
+  LOG(INFO) << "Module Load        :" << runner.r_module_load_ms << " ms";
+  LOG(INFO) << "Params Load        :" << runner.r_param_load_ms << " ms";
+  LOG(INFO) << "Duration           :" << duration << " s";
+  LOG(INFO) << "Prefill Steps      :" << num_prefill_steps;
+  LOG(INFO) << "Decode Steps       :" << num_decode_steps;
+  LOG(INFO) << "Request Throughput :" << requests.size() / duration << " req/s";
+  LOG(INFO) << "Output Throughput  :" << num_output_tokens / duration << " tok/s";
+  LOG(INFO) << "Total Throughput   :" << (num_prompt_tokens + num_output_tokens) / duration
+            << " tok/s";
+  LOG(INFO) << "TTFT               :" << ttft_stats.ToString();
+  LOG(INFO) << "ITL                :" << itl_stats.ToString();
+  LOG(INFO) << "E2E Latency        :" << e2e_stats.ToString();
+
+  if (!args.output.empty()) {
+    std::ofstream os(args.output);
+    CHECK(!os.fail()) << "Failed to open output file:" << args.output;
+    os << "{\"num_requests\": " << requests.size() << ", \"duration_s\": " << duration
+       << ", \"prompt_tokens\": " << num_prompt_tokens
+       << ", \"output_tokens\": " << num_output_tokens
+       << ", \"request_throughput\": " << requests.size() / duration
+       << ", \"output_throughput\": " << num_output_tokens / duration
+       << ", \"total_throughput\": " << (num_prompt_tokens + num_output_tokens) / duration
+       << ", \"ttft\": " << ttft_stats.ToJSON() << ", \"itl\": " << itl_stats.ToJSON()
+       << ", \"e2e_latency\": " << e2e_stats.ToJSON() << "}\n";
+  }
+  return 0;
+}
+
+/*!
+ * \brief main The main function.
+ * \param argc arg counter
+ * \param argv arg values
+ * \return result of operation.
+ */
+int main(int argc, char* argv[]) {
+  if (argc <= 1) {
+    LOG(INFO) << kUsage;
+    return 0;
+  }
+
+  ToolArgs args;
+  ParseCmdArgs(argc, argv, args);
+  PrintArgs(args);
+  CHECK_GT(args.num_requests, 0) << "At least one request is needed";
+
+  if (ExecuteBenchmark(args)) {
+    PrintArgs(args);
+    LOG(INFO) << kUsage;
+    return -1;
+  }
+  return 0;
+}
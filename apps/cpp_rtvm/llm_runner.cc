@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file llm_runner.cc
+ * \brief Runner of a Relax language model implementation.
+ */
+
+#include "llm_runner.h"
+
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tvm_runner.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Get a global function which must exist.
+ * \param name the name of the global function.
+ * \return the global function.
+ */
+static PackedFunc GetGlobalFunc(const std::string& name) {
+  const PackedFunc* f = Registry::Get(name);
+  CHECK(f != nullptr) << "LLMRunner : Cannot find the global function " << name;
+  return *f;
+}
+
+/*!
+ * \brief Constructor for LLMRunner.
+ * \param path where the Relax VM executable and the parameters present.
+ * \param device the target device where we need to load the compiled model.
+ */
+LLMRunner::LLMRunner(std::string path, std::string device)
+    : r_model_path(path), r_device{GetTVMDevice(device), 0} {
+  LOG(INFO) << "LLMRunner Constructor:" << r_model_path << " Devices:" << device;
+}
+
+/*!
+ * \brief Load the Relax VM executable and the parameters of the model.
+ * \param 0 on success else error code.
+ */
+int LLMRunner::Load(void) {
+  LOG(INFO) << "LLMRunner Load:" << r_model_path;
+  auto tstart = std::chrono::high_resolution_clock::now();
+  Module executable = Module::LoadFromFile((r_model_path + "/mod.so").c_str(), "so");
+  r_vm = executable.GetFunction("vm_load_executable")();
+  // The host device comes last and is used to allocate the shape heap
+  if (r_device.device_type == kDLCPU) {
+    r_vm.GetFunction("vm_initialization")(static_cast<int>(r_device.device_type),
+                                          r_device.device_id,
+                                          static_cast<int>(memory::kPooled));
+  } else {
+    r_vm.GetFunction("vm_initialization")(
+        static_cast<int>(r_device.device_type), r_device.device_id,
+        static_cast<int>(memory::kPooled), static_cast<int>(kDLCPU), 0,
+        static_cast<int>(memory::kPooled));
+  }
+  r_create_kv_cache = r_vm.GetFunction("create_kv_cache");
+  r_prefill = r_vm.GetFunction("prefill");
+  r_decode = r_vm.GetFunction("decode");
+  CHECK(r_create_kv_cache != nullptr && r_prefill != nullptr && r_decode != nullptr)
+      << "LLMRunner : The model must provide create_kv_cache, prefill and decode";
+  auto tend = std::chrono::high_resolution_clock::now();
+  r_module_load_ms = static_cast<double>((tend - tstart).count()) / 1e6;
+
+  r_add_sequence = GetGlobalFunc("vm.builtin.kv_state_add_sequence");
+  r_remove_sequence = GetGlobalFunc("vm.builtin.kv_state_remove_sequence");
+  r_begin_forward = GetGlobalFunc("vm.builtin.kv_state_begin_forward");
+  r_end_forward = GetGlobalFunc("vm.builtin.kv_state_end_forward");
+
+  // Load the parameters, if any, from the ndarray cache
+  tstart = std::chrono::high_resolution_clock::now();
+  std::string params_path = r_model_path + "/params";
+  if (std::ifstream(params_path + "/ndarray-cache.json").good()) {
+    GetGlobalFunc("vm.builtin.ndarray_cache.load")(
+        params_path, static_cast<int>(r_device.device_type), r_device.device_id);
+    r_params = GetGlobalFunc("vm.builtin.param_array_from_cache")("param", -1);
+    GetGlobalFunc("vm.builtin.ndarray_cache.clear")();
+  }
+  tend = std::chrono::high_resolution_clock::now();
+  r_param_load_ms = static_cast<double>((tend - tstart).count()) / 1e6;
+  LOG(INFO) << "LLMRunner Loaded " << r_params.size() << " params";
+  return 0;
+}
+
+/*!
+ * \brief Create the paged KV cache through the model.
+ * \param max_batch_size the maximum number of sequences in a forward.
+ * \param max_total_seq_len the maximum number of tokens of all the sequences.
+ * \param prefill_chunk_size the maximum number of tokens in a prefill.
+ * \param page_size the number of tokens of a page.
+ */
+void LLMRunner::CreateKVCache(int64_t max_batch_size, int64_t max_total_seq_len,
+                              int64_t prefill_chunk_size, int64_t page_size) {
+  r_kv_cache = r_create_kv_cache(ShapeTuple({max_batch_size}), ShapeTuple({max_total_seq_len}),
+                                 ShapeTuple({prefill_chunk_size}), ShapeTuple({page_size}))
+                   .operator ObjectRef();
+}
+
+void LLMRunner::AddSequence(int64_t seq_id) { r_add_sequence(r_kv_cache, seq_id); }
+
+void LLMRunner::RemoveSequence(int64_t seq_id) { r_remove_sequence(r_kv_cache, seq_id); }
+
+void LLMRunner::Prefill(const std::vector<int64_t>& seq_ids,
+                        const std::vector<std::vector<int32_t>>& token_ids) {
+  ICHECK_EQ(seq_ids.size(), token_ids.size());
+  std::vector<int64_t> append_lengths;
+  std::vector<int32_t> flattened;
+  for (const std::vector<int32_t>& tokens : token_ids) {
+    append_lengths.push_back(tokens.size());
+    flattened.insert(flattened.end(), tokens.begin(), tokens.end());
+  }
+  int64_t total_length = flattened.size();
+  Forward(r_prefill, seq_ids, append_lengths, flattened, {1, total_length});
+}
+
+void LLMRunner::Decode(const std::vector<int64_t>& seq_ids,
+                       const std::vector<int32_t>& token_ids) {
+  ICHECK_EQ(seq_ids.size(), token_ids.size());
+  std::vector<int64_t> append_lengths(seq_ids.size(), 1);
+  int64_t batch_size = seq_ids.size();
+  Forward(r_decode, seq_ids, append_lengths, token_ids, {batch_size, 1});
+}
+
+void LLMRunner::Forward(const PackedFunc& func, const std::vector<int64_t>& seq_ids,
+                        const std::vector<int64_t>& append_lengths,
+                        const std::vector<int32_t>& token_ids, std::vector<int64_t> shape) {
+  NDArray input_ids = NDArray::Empty(ShapeTuple(std::move(shape)), DataType::Int(32), r_device);
+  input_ids.CopyFromBytes(token_ids.data(), token_ids.size() * sizeof(int32_t));
+  r_begin_forward(r_kv_cache, ShapeTuple(seq_ids), ShapeTuple(append_lengths));
+  if (r_params.empty()) {
+    func(input_ids, r_kv_cache);
+  } else {
+    func(input_ids, r_kv_cache, r_params);
+  }
+  r_end_forward(r_kv_cache);
+}
+
+void LLMRunner::Synchronize(void) {
+  TVMSynchronize(r_device.device_type, r_device.device_id, nullptr);
+}
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file llm_runner.h
+ * \brief Runner of a Relax language model backed by the paged KV cache.
+ *
+ * The model folder holds the Relax VM executable exported as `mod.so`, and optionally the
+ * parameters as a ndarray cache in `params/` named `param_0`, `param_1`, ... The executable
+ * provides the functions below, where `params` is only passed when the parameters exist.
+ *  - create_kv_cache(max_batch_size: R.Shape, max_total_seq_len: R.Shape,
+ *                    prefill_chunk_size: R.Shape, page_size: R.Shape) -> R.Object,
+ *    which creates the cache with `vm.builtin.paged_attention_kv_cache_create`;
+ *  - prefill(input_ids: R.Tensor((1, n), "int32"), kv_cache: R.Object, params),
+ *    which runs the prompt tokens of all the sequences of the forward concatenated;
+ *  - decode(input_ids: R.Tensor((b, 1), "int32"), kv_cache: R.Object, params),
+ *    which runs one token of each sequence of the forward.
+ * The runner begins and ends the forwards of the KV cache around the calls.
+ */
+#ifndef TVM_APPS_CPP_RTVM_LLM_RUNNER_H_
+#define TVM_APPS_CPP_RTVM_LLM_RUNNER_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief encapsulates the prefill and decode of a Relax language model with simplified API.
+ */
+class LLMRunner {
+ public:
+  /*! \brief Constructor */
+  LLMRunner(std::string path, std::string device);
+
+  /*! \brief Loads the Relax VM executable and the parameters */
+  int Load(void);
+  /*! \brief Creates the paged KV cache of the model */
+  void CreateKVCache(int64_t max_batch_size, int64_t max_total_seq_len,
+                     int64_t prefill_chunk_size, int64_t page_size);
+  /*! \brief Adds a new sequence to the KV cache */
+  void AddSequence(int64_t seq_id);
+  /*! \brief Removes a finished sequence from the KV cache */
+  void RemoveSequence(int64_t seq_id);
+  /*!
+   * \brief Runs the prompts of the given sequences in one forward.
+   * \param seq_ids The sequences to be prefilled.
+   * \param token_ids The prompt of each sequence.
+   */
+  void Prefill(const std::vector<int64_t>& seq_ids,
+               const std::vector<std::vector<int32_t>>& token_ids);
+  /*!
+   * \brief Runs one token of each of the given sequences in one forward.
+   * \param seq_ids The sequences to be decoded.
+   * \param token_ids The next token of each sequence.
+   */
+  void Decode(const std::vector<int64_t>& seq_ids, const std::vector<int32_t>& token_ids);
+  /*! \brief Waits for the issued forwards to complete */
+  void Synchronize(void);
+
+  // Public profiling information
+  /*! Module load time */
+  int r_module_load_ms{0};
+  /*! Params load time */
+  int r_param_load_ms{0};
+
+ private:
+  /*! \brief Runs the given model function over the token ids within a KV cache forward */
+  void Forward(const PackedFunc& func, const std::vector<int64_t>& seq_ids,
+               const std::vector<int64_t>& append_lengths, const std::vector<int32_t>& token_ids,
+               std::vector<int64_t> shape);
+
+  /*! \brief The Relax VM module */
+  Module r_vm;
+  /*! \brief The model functions */
+  PackedFunc r_create_kv_cache, r_prefill, r_decode;
+  /*! \brief The KV state builtins */
+  PackedFunc r_add_sequence, r_remove_sequence, r_begin_forward, r_end_forward;
+  /*! \brief The paged KV cache */
+  ObjectRef r_kv_cache;
+  /*! \brief The model parameters, empty if the model takes none */
+  Array<NDArray> r_params;
+  /*! \brief The local model path from where we load the model */
+  std::string r_model_path;
+  /*! \brief The target device */
+  DLDevice r_device;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_APPS_CPP_RTVM_LLM_RUNNER_H_
@@ -28,7 +28,9 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "tvm/runtime/c_runtime_api.h"
 
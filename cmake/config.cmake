@@ -64,6 +64,12 @@ set(USE_MSCCL OFF)
 # - OFF: disable NCCL
 set(USE_NVTX OFF)
 
+# Whether to enable CUPTI support in profiling (must have USE_CUDA enabled).
+# CUPTI provides the hardware counters of CUDA kernels while profiling.
+# - ON: enable CUPTI, searched in the extras/CUPTI folder of the CUDA toolkit
+# - OFF: disable CUPTI
+set(USE_CUPTI OFF)
+
 # Whether enable ROCM runtime
 #
 # Possible values:
@@ -129,6 +135,11 @@ set(USE_MICRO OFF)
 # Whether enable RPC runtime
 set(USE_RPC ON)
 
+# Whether to support zlib compressed RPC channels, which clients can request
+# with rpc.connect(..., compress=True) to speed up transfers over slow links.
+# Requires zlib.
+set(USE_RPC_COMPRESSION OFF)
+
 # Whether to build the C++ RPC server binary
 set(USE_CPP_RPC OFF)
 
@@ -447,6 +458,16 @@ set(USE_PAPI OFF)
 # predefined variables to specify the path to the GTest package if needed.
 set(USE_GTEST AUTO)
 
+# Whether to use Google Benchmark for the C++ microbenchmarks of the runtime hot
+# paths. When enabled, the generated build file will have a target "cppbench".
+# Possible values:
+# - ON: enable Google Benchmark. The package `benchmark` will be required for
+#   cmake to succeed.
+# - OFF: disable Google Benchmark.
+# - AUTO: cmake will attempt to find the `benchmark` package, if found the
+#   microbenchmarks will be enabled, otherwise they will be disabled.
+set(USE_GBENCHMARK AUTO)
+
 # Enable using CUTLASS as a BYOC backend
 # Need to have USE_CUDA=ON
 set(USE_CUTLASS OFF)
@@ -472,6 +493,10 @@ set(SUMMARIZE OFF)
 # OFF or /path/to/torch/
 set(USE_LIBTORCH OFF)
 
+# Whether to build the SQLite database of meta schedule, which lets concurrent
+# tuning jobs share a database file. Requires the SQLite3 development package.
+set(USE_SQLITE OFF)
+
 # Whether to use the Universal Modular Accelerator Interface
 set(USE_UMA OFF)
 
@@ -135,6 +135,26 @@ if(USE_CUDA)
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_NVTX_LIBRARY})
   endif(USE_NVTX)
 
+  if(USE_CUPTI)
+    message(STATUS "Build with CUPTI support")
+    find_path(CUDA_CUPTI_INCLUDE_DIR cupti_profiler_target.h
+      PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/include ${CUDA_INCLUDE_DIRS})
+    find_library(CUDA_CUPTI_LIBRARY cupti
+      PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI ${CUDA_TOOLKIT_ROOT_DIR}
+      PATH_SUFFIXES lib64 lib targets/x86_64-linux/lib)
+    find_library(CUDA_NVPERF_HOST_LIBRARY nvperf_host
+      PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI ${CUDA_TOOLKIT_ROOT_DIR}
+      PATH_SUFFIXES lib64 lib targets/x86_64-linux/lib)
+    if(NOT CUDA_CUPTI_INCLUDE_DIR OR NOT CUDA_CUPTI_LIBRARY OR NOT CUDA_NVPERF_HOST_LIBRARY)
+      message(FATAL_ERROR "Cannot find CUPTI in the CUDA toolkit ${CUDA_TOOLKIT_ROOT_DIR}")
+    endif()
+    message(STATUS "${CUDA_CUPTI_LIBRARY} ${CUDA_NVPERF_HOST_LIBRARY}")
+    include_directories(SYSTEM ${CUDA_CUPTI_INCLUDE_DIR})
+    tvm_file_glob(GLOB CONTRIB_CUPTI_SRCS src/runtime/contrib/cupti/*.cc)
+    list(APPEND RUNTIME_SRCS ${CONTRIB_CUPTI_SRCS})
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_CUPTI_LIBRARY} ${CUDA_NVPERF_HOST_LIBRARY})
+  endif(USE_CUPTI)
+
   if(USE_GRAPH_EXECUTOR_CUDA_GRAPH)
     if(NOT USE_GRAPH_EXECUTOR)
       message(FATAL_ERROR "CUDA Graph is only supported by graph executor, please set USE_GRAPH_EXECUTOR=ON")
@@ -149,7 +169,9 @@ if(USE_CUDA)
 
   # Add CUDA builtins to RelaxVM
   tvm_file_glob(GLOB RELAX_VM_CUDA_BUILTIN_SRC_CC src/runtime/relax_vm/cuda/*.cc)
+  tvm_file_glob(GLOB RELAX_VM_CUDA_BUILTIN_SRC_CU src/runtime/relax_vm/cuda/*.cu)
   list(APPEND RUNTIME_SRCS ${RELAX_VM_CUDA_BUILTIN_SRC_CC})
+  list(APPEND RUNTIME_SRCS ${RELAX_VM_CUDA_BUILTIN_SRC_CU})
 else(USE_CUDA)
   list(APPEND COMPILER_SRCS src/target/opt/build_cuda_off.cc)
 endif(USE_CUDA)
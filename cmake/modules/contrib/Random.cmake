@@ -19,4 +19,8 @@ if(USE_RANDOM)
   message(STATUS "Build with contrib.random")
   tvm_file_glob(GLOB RANDOM_CONTRIB_SRC src/runtime/contrib/random/random.cc)
   list(APPEND RUNTIME_SRCS ${RANDOM_CONTRIB_SRC})
+  if(USE_CUDA)
+    tvm_file_glob(GLOB RANDOM_CONTRIB_SRC_CU src/runtime/contrib/random/*.cu)
+    list(APPEND RUNTIME_SRCS ${RANDOM_CONTRIB_SRC_CU})
+  endif(USE_CUDA)
 endif(USE_RANDOM)
@@ -0,0 +1,24 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+if(USE_SQLITE)
+  find_package(SQLite3 REQUIRED)
+  message(STATUS "Build with SQLite database of meta schedule: ${SQLite3_LIBRARIES}")
+  include_directories(SYSTEM ${SQLite3_INCLUDE_DIRS})
+  add_definitions(-DTVM_USE_SQLITE)
+  list(APPEND TVM_LINKER_LIBS ${SQLite3_LIBRARIES})
+endif(USE_SQLITE)
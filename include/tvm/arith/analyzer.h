@@ -31,6 +31,7 @@
 #include <limits>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -162,6 +163,17 @@ class ConstIntBoundAnalyzer {
    * \param allow_override Whether we allow overriding an existing var's range.
    */
   TVM_DLL void Bind(const Var& var, const Range& range, bool allow_override = false);
+  /*!
+   * \brief Get the numbers of bounds reused from the memo and computed.
+   *
+   * The bounds are memoized per expression object, and forgotten whenever the
+   * variable bounds or the constraints change.
+   *
+   * \return The pair of hits and misses.
+   */
+  TVM_DLL std::pair<int64_t, int64_t> GetMemoStats() const;
+  /*! \brief Reset the hit and miss counters of the memo. */
+  TVM_DLL void ResetMemoStats();
 
  private:
   friend class Analyzer;
@@ -243,6 +255,17 @@ class ModularSetAnalyzer {
    * \param allow_override whether we allow override of existing information.
    */
   TVM_DLL void Update(const Var& var, const ModularSet& info, bool allow_override = false);
+  /*!
+   * \brief Get the numbers of sets reused from the memo and computed.
+   *
+   * The sets are memoized per expression object, and forgotten whenever the
+   * variable sets or the constraints change.
+   *
+   * \return The pair of hits and misses.
+   */
+  TVM_DLL std::pair<int64_t, int64_t> GetMemoStats() const;
+  /*! \brief Reset the hit and miss counters of the memo. */
+  TVM_DLL void ResetMemoStats();
 
  private:
   friend class Analyzer;
@@ -396,6 +419,19 @@ class RewriteSimplifier {
    */
   TVM_DLL void SetMaximumRewriteSteps(int64_t maximum);
 
+  /*! \brief Set the step budget of each simplification
+   *
+   * Unlike SetMaximumRewriteSteps, exceeding the budget is not an
+   * error.  Once a call to the simplifier has visited or rewritten
+   * more than `budget` expressions, the remaining subexpressions are
+   * returned unchanged, so that the result is still correct but only
+   * partially simplified.  The expressions whose simplification was
+   * stopped are reported by GetStatsCounters.
+   *
+   * \param budget The maximum number of steps, or 0 for no limit.
+   */
+  TVM_DLL void SetStepBudget(int64_t budget);
+
  private:
   friend class Analyzer;
   friend class ConstraintContext;
@@ -428,6 +464,19 @@ class CanonicalSimplifier {
    */
   TVM_DLL void Update(const Var& var, const PrimExpr& new_expr, bool allow_override = false);
 
+  /*! \brief Return the statistics counters */
+  TVM_DLL ObjectRef GetStatsCounters() const;
+
+  /*! \brief Reset the statistics counters */
+  TVM_DLL void ResetStatsCounters();
+
+  /*! \brief Set the step budget of each simplification
+   *
+   * \param budget The maximum number of steps, or 0 for no limit.
+   * \sa RewriteSimplifier::SetStepBudget
+   */
+  TVM_DLL void SetStepBudget(int64_t budget);
+
  private:
   friend class Analyzer;
   friend class ConstraintContext;
@@ -457,6 +457,34 @@ class IRModule : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_COW_METHOD(IRModuleNode);
 };
 
+/*!
+ * \brief Compute a structural hash of a module by hashing its functions in parallel.
+ *
+ * Each function is hashed independently, with references to GlobalVars reduced to their
+ * names, and the results are combined in function name order. The value is deterministic
+ * and consistent with ParallelStructuralEqual, but differs from StructuralHash(mod).
+ * Modules with type definitions fall back to StructuralHash.
+ *
+ * \param mod The module to be hashed.
+ * \param num_threads The number of worker threads, -1 to use the maximum concurrency.
+ * \return The hash value.
+ */
+TVM_DLL uint64_t ParallelStructuralHash(const IRModule& mod, int num_threads = -1);
+
+/*!
+ * \brief Check the structural equality of two modules by comparing functions in parallel.
+ *
+ * Functions are paired by name and compared independently, references to GlobalVars are
+ * matched by name. Modules with type definitions fall back to StructuralEqual.
+ *
+ * \param lhs The left operand.
+ * \param rhs The right operand.
+ * \param num_threads The number of worker threads, -1 to use the maximum concurrency.
+ * \return Whether the two modules are structurally equal.
+ */
+TVM_DLL bool ParallelStructuralEqual(const IRModule& lhs, const IRModule& rhs,
+                                     int num_threads = -1);
+
 namespace attr {
 
 // Following are attributes for IRModule only.
@@ -63,6 +63,7 @@
 #include <tvm/runtime/container/string.h>
 #include <tvm/support/with.h>
 
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -319,6 +320,12 @@ class PassInfoNode : public Object {
   /*! \brief Boolean that tells whether this pass will be traced or not. */
   bool traceable;
 
+  /*!
+   * \brief Whether the function-local transformation of this pass can run on several functions
+   *  of a module at the same time, see NumFunctionPassThreads.
+   */
+  bool thread_safe = false;
+
   /*! \brief The passes that are required to perform the current pass. */
   Array<String> required;
 
@@ -329,6 +336,7 @@ class PassInfoNode : public Object {
     v->Visit("name", &name);
     v->Visit("required", &required);
     v->Visit("traceable", &traceable);
+    v->Visit("thread_safe", &thread_safe);
   }
 
   static constexpr const char* _type_key = "transform.PassInfo";
@@ -348,8 +356,10 @@ class PassInfo : public ObjectRef {
    * \param name Name of the pass.
    * \param required  The passes that are required to perform the current pass.
    * \param traceable Boolean that tells whether the pass is traceable.
+   * \param thread_safe Whether the pass can transform several functions at the same time.
    */
-  TVM_DLL PassInfo(int opt_level, String name, Array<runtime::String> required, bool traceable);
+  TVM_DLL PassInfo(int opt_level, String name, Array<runtime::String> required, bool traceable,
+                   bool thread_safe = false);
 
   TVM_DEFINE_OBJECT_REF_METHODS(PassInfo, ObjectRef, PassInfoNode);
 };
@@ -550,6 +560,35 @@ TVM_DLL Pass CreateModulePass(
 TVM_DLL Pass ApplyPassToFunction(Pass pass, String func_name_regex,
                                  bool error_if_no_function_matches_regex = false);
 
+/*!
+ * \brief Get the number of threads that a function-local pass transforms the functions of a
+ *  module on. This is 1 unless the pass is thread-safe and the config
+ *  "ir.num_function_pass_threads" asks for more, where a non-positive value means one thread
+ *  per core.
+ *
+ * \param pass_info The information of the pass.
+ * \param pass_ctx The pass context that the pass runs on.
+ *
+ * \return The number of threads.
+ */
+TVM_DLL int NumFunctionPassThreads(const PassInfo& pass_info, const PassContext& pass_ctx);
+
+/*!
+ * \brief Run the per-function tasks of a function-local pass on a number of threads.
+ *
+ * Every task runs with `pass_ctx` as the current pass context, whichever thread it runs on. The
+ * tasks must not depend on each other, and must neither modify the module nor run other passes,
+ * as the pass instruments are not thread-safe. The caller writes the results back in the order
+ * of the tasks, so that the output never depends on the scheduling.
+ *
+ * \param num_tasks The number of tasks.
+ * \param num_threads The number of threads, as given by NumFunctionPassThreads.
+ * \param pass_ctx The pass context that the pass runs on.
+ * \param ftask The task, taking its index.
+ */
+TVM_DLL void ParallelForFunctions(int num_tasks, int num_threads, const PassContext& pass_ctx,
+                                  const std::function<void(int)>& ftask);
+
 /*!
  * \brief A special trace pass that prints the header and IR to LOG(INFO).
  * \param header The header to be attached to the output.
@@ -21,11 +21,14 @@
 #define TVM_META_SCHEDULE_COST_MODEL_H_
 
 #include <tvm/meta_schedule/arg_info.h>
+#include <tvm/meta_schedule/feature_extractor.h>
 #include <tvm/meta_schedule/measure_candidate.h>
 #include <tvm/meta_schedule/runner.h>
 #include <tvm/node/reflection.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/optional.h>
 #include <tvm/runtime/container/string.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/tir/schedule/schedule.h>
@@ -165,6 +168,35 @@ class CostModel : public runtime::ObjectRef {
                                        PyCostModelNode::FUpdate f_update,    //
                                        PyCostModelNode::FPredict f_predict,  //
                                        PyCostModelNode::FAsString f_as_string);
+  /*!
+   * \brief Create a cost model that predicts with a tree ensemble in C++ and delegates the
+   * training to the python side.
+   *
+   * A tree ensemble is given as four NDArrays:
+   *  - nodes, int32 of shape [n, 4]: the split feature, the left child, the right child and the
+   *    child taken by missing values of each node, the children are -1 for leaves;
+   *  - values, float32 of shape [n]: the split threshold of each inner node, or the value of
+   *    each leaf;
+   *  - roots, int32 of shape [num_trees]: the root node of each tree;
+   *  - base_score, float64 of shape [1]: the bias added to the prediction of each feature vector.
+   * A feature vector goes left when its split feature is less than the threshold. The score of
+   * a candidate is the sum of the predictions of its feature vectors.
+   *
+   * \param extractor The feature extractor.
+   * \param f_load The packed function loading the trainer state from a file, it returns the
+   * loaded tree ensemble, or NullOpt if it is not trained yet.
+   * \param f_save The packed function saving the trainer state to a file.
+   * \param f_update The packed function updating the trainer with running results, it returns
+   * the retrained tree ensemble, or NullOpt if the current one is kept.
+   * \return The cost model created.
+   */
+  TVM_DLL static CostModel TreeEnsemble(
+      FeatureExtractor extractor,
+      runtime::TypedPackedFunc<Optional<Array<runtime::NDArray>>(String)> f_load,
+      runtime::TypedPackedFunc<void(String)> f_save,
+      runtime::TypedPackedFunc<Optional<Array<runtime::NDArray>>(
+          const TuneContext&, const Array<MeasureCandidate>&, const Array<RunnerResult>&)>
+          f_update);
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CostModel, ObjectRef, CostModelNode);
 };
 
@@ -480,9 +480,13 @@ class Database : public runtime::ObjectRef {
    * \param path_tuning_record The path to the database table.
    * \param allow_missing Whether to create new file when the given path is not found.
    * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   * \param retention_top_k The number of fastest records kept per workload and target, or -1 to
+   * keep all of them. When it is set, invalid records and duplicated traces are dropped as well,
+   * and the files are compacted on loading and periodically on commit.
    */
   TVM_DLL static Database JSONDatabase(String path_workload, String path_tuning_record,
-                                       bool allow_missing, String mod_eq_name = "structural");
+                                       bool allow_missing, String mod_eq_name = "structural",
+                                       int retention_top_k = -1);
   /*!
    * \brief A database composed of multiple databases, allowing users to guide IR rewriting using
    * combined knowledge of those databases. To each query, it returns the best record among all the
@@ -160,6 +160,13 @@ class Postproc : public runtime::ObjectRef {
    * \return The postprocessor created
    */
   TVM_DLL static Postproc RewriteLayout();
+  /*!
+   * \brief Creates a postprocessor that software pipelines the loops packing tiles of their inputs
+   * before computing on them, so that on CPUs the packing of the next tile overlaps with the
+   * computation on the current one.
+   * \return The postprocessor created
+   */
+  TVM_DLL static Postproc RewriteSoftwarePipeline();
   /*! \brief Create default postprocessors for LLVM */
   TVM_DLL static Array<Postproc, void> DefaultLLVM();
   /*! \brief Create default postprocessors for x86 (AVX512 and VNNI) */
@@ -242,6 +242,19 @@ class ScheduleRule : public runtime::ObjectRef {
    * \return The schedule rule created
    */
   TVM_DLL static ScheduleRule CrossThreadReduction(Array<Integer> thread_extents);
+  /*!
+   * \brief Create a schedule rule which splits the reduction of skinny GEMM-like blocks on GPU,
+   * e.g. the projections of LLM decoding, into partial sums computed by separate thread blocks.
+   * The partial sums are computed by a new block tiled by `tiling`, and reduced by the original
+   * block, into whose loop nest the elementwise epilogue is fused.
+   * \param split_factors Candidates of the number of splits (values are required to be larger than
+   * 1).
+   * \param max_spatial_extent The largest spatial extent of the blocks that are split.
+   * \param tiling The rule tiling the block that computes the partial sums.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule SplitK(Array<Integer> split_factors, int64_t max_spatial_extent,
+                                     ScheduleRule tiling);
   /*!
    * \brief A rule that randomly select a compute-at location for a free block
    * \return The schedule rule created
@@ -264,6 +277,13 @@ class ScheduleRule : public runtime::ObjectRef {
                                                          int max_vectorize_extent,         //
                                                          Array<Integer> unroll_max_steps,  //
                                                          bool unroll_explicit);
+  /*!
+   * \brief Mark the lookahead distance of the software prefetches to the root block. The
+   * prefetches are injected into the innermost loops on CPU targets by InjectSoftwarePrefetch.
+   * \param distances The candidates of the lookahead distance in bytes, 0 for no prefetch.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule SoftwarePrefetch(Array<Integer> distances);
   /*!
    * \brief Auto bind loops around the block to BlockIdx and ThreadIdx
    * \param max_threadblocks The maximum number of threadblock on GPU
@@ -290,7 +310,7 @@ class ScheduleRule : public runtime::ObjectRef {
 
   /*! \brief Create default schedule rules for LLVM */
   TVM_DLL static Array<ScheduleRule, void> DefaultLLVM();
-  /*! \brief Create default schedule rules for x86 (AVX512 and VNNI) */
+  /*! \brief Create default schedule rules for x86 (AVX512, VNNI and AMX) */
   TVM_DLL static Array<ScheduleRule, void> DefaultX86(const String& type);
   /*! \brief Create default schedule rules for CUDA */
   TVM_DLL static Array<ScheduleRule, void> DefaultCUDA();
@@ -300,7 +320,7 @@ class ScheduleRule : public runtime::ObjectRef {
   TVM_DLL static Array<ScheduleRule, void> DefaultHexagon();
   /*! \brief Create default schedule rules for Micro */
   TVM_DLL static Array<ScheduleRule, void> DefaultMicro();
-  /*! \brief Create default schedule rules for ARM CPU (NEON and DOTPROD) */
+  /*! \brief Create default schedule rules for ARM CPU (NEON, DOTPROD and I8MM) */
   TVM_DLL static Array<ScheduleRule, void> DefaultARM(const String& type);
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(ScheduleRule, ObjectRef, ScheduleRuleNode);
@@ -31,12 +31,15 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/support/random_engine.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace tvm {
 namespace meta_schedule {
 
+class MeasurePipeline;
+
 class TaskRecordNode : public runtime::Object {
  public:
   /*! \brief The tune context of the task. */
@@ -139,6 +142,12 @@ class TaskSchedulerNode : public runtime::Object {
   Optional<CostModel> cost_model_;
   /*! \brief The number of remaining tasks to be tuned. */
   int remaining_tasks_;
+  /*!
+   * \brief The maximum number of measurement batches in flight across tasks. With more than one,
+   * batches are built on a background thread while the next ones are generated, and the database
+   * and the cost model may miss the results of up to this many batches.
+   */
+  int max_inflight_batches = 1;
 
   /*! \brief The default destructor. */
   virtual ~TaskSchedulerNode() = default;
@@ -150,6 +159,8 @@ class TaskSchedulerNode : public runtime::Object {
     v->Visit("database_", &database_);
     v->Visit("cost_model_", &cost_model_);
     v->Visit("remaining_tasks_", &remaining_tasks_);
+    v->Visit("max_inflight_batches", &max_inflight_batches);
+    // `pipeline_` is not visited
   }
 
   /*!
@@ -201,6 +212,10 @@ class TaskSchedulerNode : public runtime::Object {
 
   static constexpr const char* _type_key = "meta_schedule.TaskScheduler";
   TVM_DECLARE_BASE_OBJECT_INFO(TaskSchedulerNode, Object);
+
+ protected:
+  /*! \brief The background builds of the batches in flight, used when pipelining. */
+  std::shared_ptr<MeasurePipeline> pipeline_ = nullptr;
 };
 
 class TaskScheduler;
@@ -273,10 +288,16 @@ class TaskScheduler : public runtime::ObjectRef {
    * \param alpha The parameter alpha to control gradient computation.
    * \param window_size The parameter to control backward window size.
    * \param seed The random seed.
+   * \param early_stop_rounds The number of rounds without improvement after which a task is
+   * retired early, or 0 to run every task until the budget is exhausted.
+   * \param early_stop_min_improvement The relative improvement of the best latency over
+   * `early_stop_rounds` rounds below which the task is considered converged.
    * \return The task scheduler created.
    */
   TVM_DLL static TaskScheduler GradientBased(PackedFunc logger, double alpha, int window_size,
-                                             support::LinearCongruentialEngine::TRandState seed);
+                                             support::LinearCongruentialEngine::TRandState seed,
+                                             int early_stop_rounds,
+                                             double early_stop_min_improvement);
   /*!
    * \brief Create a task scheduler with customized methods on the python-side.
    * \param logger The tuning task's logging function.
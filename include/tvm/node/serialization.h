@@ -47,5 +47,24 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief Save the node as well as all the node it depends on in a binary graph.
+ *
+ *  The binary graph holds the same information as SaveJSON, but is faster to load: values are
+ *  stored in binary, field names only once per node type, and NDArray data inline, aligned
+ *  for reading in place when the blob is mapped in memory.
+ *
+ * \param node The node to save.
+ * \return The binary blob.
+ */
+TVM_DLL std::string SaveBinaryGraph(const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load a node saved by SaveBinaryGraph.
+ * \param blob The binary blob.
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinaryGraph(const std::string& blob);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
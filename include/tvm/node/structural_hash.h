@@ -92,6 +92,51 @@ class StructuralHash : public BaseValueHash {
   TVM_DLL uint64_t operator()(const ObjectRef& key) const;
 };
 
+/*!
+ * \brief Memoized structural hash values of root objects, hashed without free var mapping.
+ *
+ *  Hashing a large object over and over, e.g. the same IRModule in a tuning database, repeats
+ *  the full traversal each time. The cache remembers the hash value of each root object and
+ *  keeps a reference to it, which forces copy-on-write to copy the object instead of mutating
+ *  it in place, so that a cached value never goes stale.
+ *
+ *  Only root hash values are cached: the hash of a sub-tree depends on the variables and graph
+ *  nodes visited before it. When the cache is full, the oldest entries are dropped.
+ *
+ *  The cache is thread-safe.
+ */
+class StructuralHashCache {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param capacity The maximum number of cached objects.
+   */
+  TVM_DLL explicit StructuralHashCache(size_t capacity = 1024);
+  TVM_DLL ~StructuralHashCache();
+  StructuralHashCache(const StructuralHashCache&) = delete;
+  StructuralHashCache& operator=(const StructuralHashCache&) = delete;
+  /*!
+   * \brief Get the hash value of an object, computing it with fhash at the first lookup.
+   * \param object The root object to be hashed.
+   * \param fhash The structural hash function, it must not map free variables.
+   * \return The hash value.
+   */
+  TVM_DLL uint64_t Hash(const ObjectRef& object,
+                        const std::function<uint64_t(const ObjectRef&)>& fhash);
+  /*!
+   * \brief Get the StructuralHash of an object.
+   * \param object The root object to be hashed.
+   * \return The hash value.
+   */
+  TVM_DLL uint64_t operator()(const ObjectRef& object);
+  /*! \brief Drop all the cached values. */
+  TVM_DLL void Clear();
+
+ private:
+  class Impl;
+  Impl* impl_;
+};
+
 /*!
  * \brief A Reducer class to reduce the structural hash value.
  *
@@ -48,6 +48,24 @@ using DataflowBlock = tvm::relax::DataflowBlock;
  */
 TVM_DLL Pass PropagateSharding();
 
+/*!
+ * \brief Plan the tensor-parallel sharding of the functions without sharding annotations.
+ *
+ * The matmuls by weights are grouped in the Megatron style, a row-parallel matmul with the
+ * column-parallel matmuls producing its input through elementwise ops, and the groups whose
+ * split computation saves more time than their allreduce costs are annotated with the sharding
+ * of their weights, to be propagated by PropagateSharding.
+ *
+ * \param mesh_index The index of the device mesh in the "mesh" global infos of the module. The
+ *        weights are split across the first axis of the mesh.
+ * \param device_flops The throughput of each device, in flop/s.
+ * \param link_bandwidth The bandwidth of each link between the devices, in bytes/s.
+ * \param link_latency The latency of each link between the devices, in seconds.
+ * \return The Pass.
+ */
+TVM_DLL Pass PlanSharding(int mesh_index, double device_flops, double link_bandwidth,
+                          double link_latency);
+
 /*!
  * \brief Lower global view TensorIR into local view.
  *
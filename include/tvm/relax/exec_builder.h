@@ -163,6 +163,14 @@ class ExecBuilderNode : public Object {
    * \brief Formalize the executable.
    */
   void Formalize();
+  /*!
+   * \brief Reassign the registers of each VM function by liveness, so that a register is
+   *  reused once the value it holds is dead.
+   *
+   * Besides shrinking the register files, overwriting a dead value releases the objects it
+   * refers to without waiting for the frame to exit.
+   */
+  void AllocateRegisters();
 
   /*! \brief The mutable internal executable. */
   ObjectPtr<vm::Executable> exec_;  // mutable
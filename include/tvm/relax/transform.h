@@ -47,12 +47,14 @@ using DataflowBlock = tvm::relax::DataflowBlock;
  * \param name The name of the function pass.
  * \param required The list of the passes that the function pass is dependent on.
  * \param traceable Boolean variable whether the dataflowblock pass is traceable.
+ * \param thread_safe Whether `pass_func` can run on several functions at the same time.
  *
  * \return The created function pass.
  */
 TVM_DLL Pass CreateFunctionPass(
     const runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable = false);
+    int opt_level, String name, tvm::Array<String> required, bool traceable = false,
+    bool thread_safe = false);
 
 /*!
  * \brief Create a dataflowblock pass.
@@ -76,6 +78,13 @@ TVM_DLL Pass CreateDataflowBlockPass(
  */
 TVM_DLL Pass LambdaLift();
 
+/*!
+ * \brief Inline all private relax functions into their callers.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass InlinePrivateFunctions();
+
 /*!
  * \brief Transform all dataflow structure to non-dataflow version.
  *
@@ -96,6 +105,19 @@ TVM_DLL Pass ToNonDataflow();
  */
 TVM_DLL Pass RemovePurityChecking();
 
+/*!
+ * \brief Reorder the pure bindings so that the collectives start as early as possible and their
+ * consumers come as late as possible. Outside of the dataflow blocks, the legalized allreduce and
+ * allgather are moreover started asynchronously on the communication stream of disco, and waited
+ * for right before their first consumer.
+ *
+ * \return The Pass.
+ *
+ * \note Should be used after ToNonDataflow() and before CallTIRRewrite() to start the
+ * collectives asynchronously.
+ */
+TVM_DLL Pass OverlapCollectives();
+
 /*!
  * \brief Perform explicit tensor allocation for call_tir and call_dps_packed.
  *
@@ -213,9 +235,29 @@ TVM_DLL Pass BindParams(String func_name, Map<ObjectRef, ObjectRef> params);
 TVM_DLL Pass BindSymbolicVars(Map<ObjectRef, PrimExpr> binding_map,
                               Optional<String> func_name = NullOpt);
 
+/*!
+ * \brief Specialize dynamic-shape functions for the hot values of their symbolic variables.
+ *
+ * For each bucket of a function, a private copy is added with the symbolic variables of the bucket
+ * bound to their values, so that its kernels can be static. The function itself is replaced by a
+ * dispatcher with the same signature, which calls the copy whose bucket matches the shapes of the
+ * arguments, or else a private copy of the generic function.
+ *
+ * \param buckets The buckets of each function, each a map from the names of the symbolic
+ *      variables defined by the parameters of the function to their values.
+ *
+ * \return The Pass.
+ *
+ * \note Should be used before LegalizeOps, so that the specialized copies have static kernels.
+ */
+TVM_DLL Pass SpecializeShapeBuckets(Map<String, Array<Map<String, PrimExpr>>> buckets);
+
 /*!
  * \brief Fold constant expressions within dataflow blocks.
  *
+ * The TIR functions of the foldable calls are built together into one module on the CPU, and
+ * the calls are evaluated in dependency order.
+ *
  * \note ConvertToDataflow may need to be called first to provide dataflow blocks.
  *
  * \return The Pass.
@@ -478,6 +520,22 @@ class PatternCheckContext : public ObjectRef {
 TVM_DLL Pass Gradient(String func_name, Optional<Array<Var>> require_grads = NullOpt,
                       int target_index = 0);
 
+/*!
+ * \brief Select the activations of a function that Gradient recomputes in the backward pass
+ * instead of keeping them alive, so that the kept activations fit in a memory budget.
+ *
+ * The activations freeing the most bytes per recomputed FLOP are selected first, where the FLOPs
+ * are estimated on the PrimFuncs that the operators are legalized to. The selection is marked with
+ * start_checkpoint and end_checkpoint. Functions already marked by hand are left unchanged.
+ *
+ * \param func_name The name of the function to be differentiated.
+ * \param memory_budget The number of bytes that the kept activations may take.
+ * \return The Pass.
+ *
+ * \note The pass is to be applied before Gradient.
+ */
+TVM_DLL Pass CheckpointActivations(String func_name, int64_t memory_budget);
+
 /*!
  * \brief Apply pattern matching to each function in the given module, and group matched
  * expressions into a new function. The end result is similar to FuseOps, but fusion is driven
@@ -519,6 +577,15 @@ TVM_DLL Pass MergeCompositeFunctions();
  */
 TVM_DLL Pass FuseTIR();
 
+/*!
+ * \brief Pack the independent call_tir of small GPU kernels in a dataflow block into one kernel
+ * launch. The kernels must be scheduled PrimFuncs whose body is a single loop bound to
+ * blockIdx.x, and the kernels packed together must use the same threadIdx extents. The packed
+ * kernel runs each original kernel on its own range of blockIdx.x.
+ * \return The Pass.
+ */
+TVM_DLL Pass HorizontalFuseTIR();
+
 /*!
  * \brief Run codegen.
  * \param target_options pairs of target name and compilation options
@@ -570,10 +637,13 @@ TVM_DLL Pass AlterOpImpl(const Map<String, tir::PrimFunc>& op_impl_map,
 /*!
  * \brief Layout conversion pass.
  * \param desired_layouts The desired layouts for some operators.
+ * \param minimize_transposes Whether to plan the layouts of each dataflow block globally, leaving
+ * the ops in the layouts of their inputs when converting them costs more transposes than it saves.
  * \return The Pass.
  * \note Operates only on dataflow blocks. ConvertToDataflow may need to be called first.
  */
-TVM_DLL Pass ConvertLayout(Map<String, Array<String>> desired_layouts);
+TVM_DLL Pass ConvertLayout(Map<String, Array<String>> desired_layouts,
+                           bool minimize_transposes = false);
 
 /*!
  * \brief A pass that converts consecutive dataflow operations
@@ -613,18 +683,37 @@ TVM_DLL Pass DeadCodeElimination(Array<runtime::String> entry_functions = {});
  */
 TVM_DLL Pass DataflowUseInplaceCalls();
 
+/*!
+ * \brief Pass that changes calls that can be done in-place into in-place implementations, with
+ * the liveness and aliases analyzed across whole functions instead of single dataflow blocks.
+ * Besides the operators supported by DataflowUseInplaceCalls, the `call_tir` of elementwise
+ * PrimFuncs and the `call_dps_packed` of the given packed functions write their result over an
+ * argument of the same shape that is no longer live.
+ * \param inplace_packed_funcs The packed functions that may write their output over any of their
+ * inputs of the same shape.
+ * \return The pass.
+ */
+TVM_DLL Pass UseInplaceCalls(Array<runtime::String> inplace_packed_funcs = {});
+
 /*!
  * \brief Automatic mixed precision pass. Currently the pass assumes the input module to be fp32
  * only, and will automatically cast fp32 to fp16 for certain ops.
  * \param out_dtype The output data type of gemm/conv, which is the data type of the accumulator.
  * \param fp16_input_names The names of function parameters whose dtype should become fp16. The
  * function signature would change accordingly.
+ * \param fp32_var_names The names of the vars whose bound ops are kept in fp32, e.g. the ops found
+ * numerically sensitive by calibration.
+ * \param matmul_dtype The input dtype of the matmuls, float16 by default. With e4m3_float8 or
+ * e5m2_float8, the matmul inputs are quantized with per-tensor scales and the outputs are scaled
+ * back.
  * \return The Pass.
  *
  * \note Mainly operates within dataflow blocks. ConvertToDataflow may need to be called first.
  */
 TVM_DLL Pass ToMixedPrecision(const DataType& out_dtype,
-                              Optional<Array<String>> fp16_input_names = NullOpt);
+                              Optional<Array<String>> fp16_input_names = NullOpt,
+                              Optional<Array<String>> fp32_var_names = NullOpt,
+                              Optional<String> matmul_dtype = NullOpt);
 
 /*!
  * \brief Rewrite a Relax module for executing with CUDA graph. This pass identifies
@@ -234,6 +234,11 @@ typedef void* TVMRetValueHandle;
  * can be NULL, which indicates the default one.
  */
 typedef void* TVMStreamHandle;
+/*!
+ * \brief The event that marks a point in a stream specific to device,
+ * can be NULL, which indicates work that completed when it was recorded.
+ */
+typedef void* TVMEventHandle;
 /*! \brief Handle to Object. */
 typedef void* TVMObjectHandle;
 
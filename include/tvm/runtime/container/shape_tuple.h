@@ -24,7 +24,10 @@
 #ifndef TVM_RUNTIME_CONTAINER_SHAPE_TUPLE_H_
 #define TVM_RUNTIME_CONTAINER_SHAPE_TUPLE_H_
 
+#include <algorithm>
+#include <iterator>
 #include <ostream>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -99,7 +102,21 @@ class ShapeTuple : public ObjectRef {
    * \tparam IterType The type of iterator
    */
   template <typename IterType>
-  ShapeTuple(IterType begin, IterType end) : ShapeTuple(std::vector<index_type>(begin, end)) {}
+  ShapeTuple(IterType begin, IterType end) {
+    using IterCategory = typename std::iterator_traits<IterType>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, IterCategory>) {
+      // Store the elements inplace, in a single pooled allocation.
+      size_t size = std::distance(begin, end);
+      auto ptr = make_pooled_inplace_array_object<ShapeTupleObj, index_type>(size);
+      ptr->size = size;
+      ptr->data = reinterpret_cast<index_type*>(reinterpret_cast<char*>(ptr.get()) +
+                                                sizeof(ShapeTupleObj));
+      std::copy(begin, end, ptr->data);
+      data_ = std::move(ptr);
+    } else {
+      *this = ShapeTuple(std::vector<index_type>(begin, end));
+    }
+  }
 
   /*!
    * \brief constructor from initializer list
@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \brief Performance counters of CUDA kernels for profiling via the CUPTI library.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_CUPTI_H_
+#define TVM_RUNTIME_CONTRIB_CUPTI_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/profiling.h>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief Construct a metric collector that collects the metrics of the CUDA
+ * kernels launched by each call using the profiling API of the CUDA Profiling
+ * Tools Interface (CUPTI).
+ *
+ * \param metrics The metrics that should be collected, e.g.
+ * `dram__bytes_read.sum`. You can find the names of available metrics by
+ * running `ncu --query-metrics`. The default set is used if empty.
+ */
+TVM_DLL MetricCollector CreateCUPTIMetricCollector(Array<String> metrics);
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_CUPTI_H_
@@ -110,6 +110,20 @@ int TVMGraphExecutor_GetOutput(TVMGraphExecutor* executor, const int32_t index,
 int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_blob,
                                 const uint32_t param_size);
 
+/*!
+ * \brief Load parameters from a parameter blob and execute them in place, e.g. from flash.
+ * The kernels read each parameter whose data is aligned to TVM_CRT_PARAM_ALIGNMENT_BYTES
+ * (16 by default, configurable in crt_config.h, e.g. to the cache line size) directly from
+ * the blob, and the RAM planned for it is released. The other parameters are copied as
+ * TVMGraphExecutor_LoadParams does.
+ * \param executor The graph executor.
+ * \param param_blob A binary blob of parameter, which must outlive the executor.
+ * \param param_size The parameter size.
+ * \return The result of this function execution.
+ */
+int TVMGraphExecutor_LoadParamsInPlace(TVMGraphExecutor* executor, const char* param_blob,
+                                       const uint32_t param_size);
+
 /*!
  * \brief Execute the graph.
  * \param executor The graph executor.
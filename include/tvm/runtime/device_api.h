@@ -198,6 +198,46 @@ class TVM_DLL DeviceAPI {
    * \param event_dst The destination stream to synchronize.
    */
   virtual void SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst);
+  /*!
+   * \brief Create an event to mark a point in a stream of execution.
+   * \param dev The device of the event.
+   * \return The event, nullptr if the device completes work before RecordEvent returns.
+   */
+  virtual TVMEventHandle CreateEvent(Device dev);
+  /*!
+   * \brief Free an event.
+   * \param dev The device of the event.
+   * \param event The event to be freed.
+   */
+  virtual void FreeEvent(Device dev, TVMEventHandle event);
+  /*!
+   * \brief Record an event in a stream, the event completes once all the work
+   *  enqueued to the stream so far completes.
+   * \param dev The device of the stream.
+   * \param event The event to record.
+   * \param stream The stream to record the event in.
+   */
+  virtual void RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream);
+  /*!
+   * \brief Block the host until an event completes.
+   * \param dev The device of the event.
+   * \param event The event to wait for.
+   */
+  virtual void EventSync(Device dev, TVMEventHandle event);
+  /*!
+   * \brief Check whether an event completed, without blocking the host.
+   * \param dev The device of the event.
+   * \param event The event to query.
+   * \return Whether all the work the event waits for completed.
+   */
+  virtual bool EventQuery(Device dev, TVMEventHandle event);
+  /*!
+   * \brief Make the future work of a stream wait for an event, without blocking the host.
+   * \param dev The device of the stream.
+   * \param stream The stream to wait in.
+   * \param event The event to wait for.
+   */
+  virtual void StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event);
   /*!
    * \brief Allocate temporal workspace for backend execution.
    *
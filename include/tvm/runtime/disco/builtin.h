@@ -86,6 +86,33 @@ TVM_DLL void AllReduce(NDArray send, ReduceKind reduce_kind, bool in_group, NDAr
  * \param recv The array receives the outcome of allgather
  */
 TVM_DLL void AllGather(NDArray send, bool in_group, NDArray recv);
+/*!
+ * \brief Start an allreduce on the communication stream of the worker, returning immediately.
+ * The collective runs after the work already queued on the compute stream, and overlaps with the
+ * compute work queued after it until `WaitCollective` is called on the returned handle.
+ * \param send The array send to perform allreduce on, which must not be overwritten until then
+ * \param reduce_kind The kind of reduction operation (e.g. sum, avg, min, max)
+ * \param in_group Whether the allreduce operation performs globally or in group as default.
+ * \param recv The array receives the outcome of allreduce, which must not be read until then
+ * \return A handle of the pending collective
+ */
+TVM_DLL ObjectRef AllReduceAsync(NDArray send, ReduceKind reduce_kind, bool in_group,
+                                 NDArray recv);
+/*!
+ * \brief Start an allgather on the communication stream of the worker, returning immediately.
+ * \param send The array send to perform allgather on
+ * \param in_group Whether the allgather operation performs globally or in group as default.
+ * \param recv The array receives the outcome of allgather
+ * \return A handle of the pending collective
+ * \sa AllReduceAsync
+ */
+TVM_DLL ObjectRef AllGatherAsync(NDArray send, bool in_group, NDArray recv);
+/*!
+ * \brief Make the work queued afterwards on the compute stream wait for a pending collective.
+ * It does not block the host.
+ * \param handle The handle returned by AllReduceAsync or AllGatherAsync
+ */
+TVM_DLL void WaitCollective(ObjectRef handle);
 /*!
  * \brief Perform a broadcast operation from worker-0
  * \param send The buffer to be broadcasted
@@ -96,6 +96,7 @@ enum class DiscoAction : int32_t {
   kCopyToWorker0 = 6,
   kDebugGetFromRemote = 7,
   kDebugSetRegister = 8,
+  kBatch = 9,
 };
 
 /*! \brief Converts the enum class `DiscoAction` to string */
@@ -119,6 +120,8 @@ inline std::string DiscoAction2String(DiscoAction action) {
       return "kDebugGetFromRemote";
     case DiscoAction::kDebugSetRegister:
       return "kDebugSetRegister";
+    case DiscoAction::kBatch:
+      return "kBatch";
   }
   LOG(FATAL) << "ValueError: Unknown DiscoAction: " << static_cast<int>(action);
 }
@@ -223,6 +226,14 @@ class SessionObj : public Object {
   TVM_DLL virtual void SyncWorker(int worker_id) = 0;
   /*! \brief Signal all the workers to shutdown */
   TVM_DLL virtual void Shutdown() = 0;
+  /*!
+   * \brief Start queueing commands on the controler instead of broadcasting them one by one.
+   * The queued commands are sent to the workers as a single packet by the matching `EndBatch`,
+   * or earlier by any call that waits for a worker, e.g. `SyncWorker`. Batches may be nested.
+   */
+  TVM_DLL virtual void BeginBatch() = 0;
+  /*! \brief Close the batch opened by `BeginBatch`, and flush it if it is the outermost one. */
+  TVM_DLL virtual void EndBatch() = 0;
   /*!
    * \brief Initialize the data plane between workers.
    * \param ccl The name of the communication backend, e.g., nccl, rccl, mpi.
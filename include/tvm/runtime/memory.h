@@ -47,8 +47,10 @@ inline ObjectPtr<T> make_object(Args&&... args);
 //
 // Possible future allocator optimizations:
 // - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
-// - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
+//
+// Thread-local object pools (one free list per size class) are implemented by
+// PoolObjAllocator, which is opted into by the short-lived container types.
 
 /*!
  * \brief Base class of object allocators that implements make.
@@ -191,11 +193,110 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+namespace detail {
+/*! \brief The alignment of the blocks returned by PoolAlloc. */
+constexpr size_t kPoolAllocAlignment = 16;
+/*!
+ * \brief Allocate a block from the free lists of the calling thread.
+ * \param nbytes The number of bytes.
+ * \return The block, aligned to kPoolAllocAlignment.
+ */
+TVM_DLL void* PoolAlloc(size_t nbytes);
+/*!
+ * \brief Release a block returned by PoolAlloc, the call can happen on any thread.
+ * \param ptr The block.
+ */
+TVM_DLL void PoolFree(void* ptr);
+}  // namespace detail
+
+/*!
+ * \brief Allocator that recycles the memory of small objects through per-thread free lists.
+ *
+ *  A block freed on a thread is cached by that thread and reused by its next allocation of
+ *  the same size class, which avoids malloc/free for short-lived objects such as ShapeTuple
+ *  and Array.
+ */
+class PoolObjAllocator : public ObjAllocatorBase<PoolObjAllocator> {
+ public:
+  template <typename T>
+  class Handler {
+   public:
+    static_assert(alignof(T) <= detail::kPoolAllocAlignment, "object alignment constraint");
+
+    template <typename... Args>
+    static T* New(PoolObjAllocator*, Args&&... args) {
+      void* data = detail::PoolAlloc(sizeof(T));
+      new (data) T(std::forward<Args>(args)...);
+      return reinterpret_cast<T*>(data);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      // See SimpleObjAllocator::Handler for the explicit call to T::~T.
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      detail::PoolFree(tptr);
+    }
+  };
+
+  template <typename ArrayType, typename ElemType>
+  class ArrayHandler {
+   public:
+    static_assert(alignof(ArrayType) <= detail::kPoolAllocAlignment &&
+                      alignof(ArrayType) % alignof(ElemType) == 0 &&
+                      sizeof(ArrayType) % alignof(ElemType) == 0,
+                  "element alignment constraint");
+
+    template <typename... Args>
+    static ArrayType* New(PoolObjAllocator*, size_t num_elems, Args&&... args) {
+      void* data = detail::PoolAlloc(sizeof(ArrayType) + num_elems * sizeof(ElemType));
+      new (data) ArrayType(std::forward<Args>(args)...);
+      return reinterpret_cast<ArrayType*>(data);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      ArrayType* tptr = static_cast<ArrayType*>(objptr);
+      tptr->ArrayType::~ArrayType();
+      detail::PoolFree(tptr);
+    }
+  };
+};
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
   return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
 }
 
+/*!
+ * \brief Allocate an object using the pooled allocator, see PoolObjAllocator.
+ * \param args arguments to the constructor.
+ * \tparam T the node type.
+ * \return The ObjectPtr to the allocated object.
+ */
+template <typename T, typename... Args>
+inline ObjectPtr<T> make_pooled_object(Args&&... args) {
+  return PoolObjAllocator().make_object<T>(std::forward<Args>(args)...);
+}
+
+/*!
+ * \brief Allocate an object with inplace array elements using the pooled allocator.
+ * \param num_elems The number of array elements.
+ * \param args arguments to the constructor.
+ * \tparam ArrayType the node type.
+ * \tparam ElemType the type of the array elements.
+ * \return The ObjectPtr to the allocated object.
+ */
+template <typename ArrayType, typename ElemType, typename... Args>
+inline ObjectPtr<ArrayType> make_pooled_inplace_array_object(size_t num_elems, Args&&... args) {
+  return PoolObjAllocator().make_inplace_array<ArrayType, ElemType>(num_elems,
+                                                                    std::forward<Args>(args)...);
+}
+
 template <typename ArrayType, typename ElemType, typename... Args>
 inline ObjectPtr<ArrayType> make_inplace_array_object(size_t num_elems, Args&&... args) {
   return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(num_elems,
@@ -42,6 +42,14 @@ namespace memory {
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  kBucketed,
+  /*! \brief Page-locked host memory of the device's accelerator, cached like kPooled. */
+  kPinned,
+  /*!
+   * \brief Memory of the device's stream-ordered pool, e.g. cudaMallocAsync, allocated and
+   *  freed on the current stream of the device.
+   */
+  kStreamOrdered,
 };
 
 struct Buffer {
@@ -49,7 +57,7 @@ struct Buffer {
   void* data{nullptr};
   /*! \brief The size of the block. */
   size_t size{0};
-  /*! \brief The context of the allocated buffers. */
+  /*! \brief The context of the allocated buffers, may differ from the requested device. */
   Device device;
   /*! \brief The allocator that created this buffer. */
   AllocatorType alloc_type;
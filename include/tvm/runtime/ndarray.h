@@ -44,6 +44,46 @@ using Device = DLDevice;
 
 namespace runtime {
 
+/*!
+ * \brief A point in a stream of device work, owns the underlying device event.
+ * \sa DeviceAPI::CreateEvent
+ */
+class DeviceEventObj : public Object {
+ public:
+  /*! \brief The device of the event. */
+  Device device;
+  /*! \brief The device event, nullptr if the work already completed when it was recorded. */
+  TVMEventHandle handle{nullptr};
+
+  TVM_DLL ~DeviceEventObj();
+
+  static constexpr const char* _type_key = "runtime.DeviceEvent";
+  TVM_DECLARE_FINAL_OBJECT_INFO(DeviceEventObj, Object);
+};
+
+/*! \brief Reference to DeviceEventObj. */
+class DeviceEvent : public ObjectRef {
+ public:
+  /*!
+   * \brief Record an event in a stream.
+   * \param dev The device of the stream.
+   * \param stream The stream to record the event in.
+   * \return The event, it completes once the work enqueued to the stream so far completes.
+   */
+  TVM_DLL static DeviceEvent Record(Device dev, TVMStreamHandle stream);
+  /*! \brief Block the host until the event completes. */
+  TVM_DLL void Synchronize() const;
+  /*! \return Whether the event completed, never blocks the host. */
+  TVM_DLL bool Query() const;
+  /*!
+   * \brief Make the future work of a stream wait for the event.
+   * \param stream The stream to wait in, it must belong to the device of the event.
+   */
+  TVM_DLL void StreamWait(TVMStreamHandle stream) const;
+
+  TVM_DEFINE_OBJECT_REF_METHODS(DeviceEvent, ObjectRef, DeviceEventObj);
+};
+
 /*!
  * \brief Managed NDArray.
  *  The array is backed by reference counted blocks.
@@ -115,6 +155,24 @@ class NDArray : public ObjectRef {
    * \note The copy always triggers a TVMSynchronize.
    */
   TVM_DLL NDArray CopyTo(const Device& dev, Optional<String> mem_scope = NullOpt) const;
+  /*!
+   * \brief Enqueue a copy of the data content from another array to a stream.
+   * \param other The source array to be copied from.
+   * \param stream The stream of the non-CPU device involved in the copy.
+   * \return An event that completes together with the copy.
+   * \note Both arrays must be kept alive until the event completes. The copy
+   *       only overlaps with host work if the host side is pinned memory,
+   *       see memory::kPinned.
+   */
+  TVM_DLL DeviceEvent CopyFromAsync(const NDArray& other, TVMStreamHandle stream);
+  /*!
+   * \brief Enqueue a copy of the data content into another array to a stream.
+   * \param other The target array to be copied to.
+   * \param stream The stream of the non-CPU device involved in the copy.
+   * \return An event that completes together with the copy.
+   * \note Both arrays must be kept alive until the event completes.
+   */
+  TVM_DLL DeviceEvent CopyToAsync(const NDArray& other, TVMStreamHandle stream) const;
   /*!
    * \brief Load NDArray from stream
    * \param stream The input data stream
@@ -502,6 +502,11 @@ String ShapeString(NDArray shape, DLDataType dtype);
  *  \return A textual representation of the shape. For example: `float32[2]`.
  */
 String ShapeString(const std::vector<int64_t>& shape, DLDataType dtype);
+/*! \brief String representation of a device
+ *  \param dev The device.
+ *  \return The device type followed by the device id. For example: `cuda0`.
+ */
+std::string DeviceString(Device dev);
 
 /*! \brief Collect performance information of a function execution. Usually
  * used with a compiled PrimFunc (via tvm.build).
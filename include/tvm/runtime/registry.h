@@ -47,6 +47,7 @@
 #include <tvm/runtime/packed_func.h>
 
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -142,6 +143,50 @@ class WrappedPythonObject {
   void* python_obj_ = nullptr;
 };
 
+/*!
+ * \brief Calling convention of the direct calls published by the registry.
+ * \param handle The raw function pointer of the registered body.
+ * \param args The arguments.
+ * \param rv The return value.
+ * \sa Registry::GetDirectCall
+ */
+using FDirectCall = void (*)(void* handle, const TVMArgs& args, TVMRetValue* rv);
+
+/*!
+ * \brief A direct call into the typed body of a global function.
+ *
+ * Compared to PackedFunc, it does not go through the type-erased std::function,
+ * the arguments are unpacked straight into the raw function pointer.
+ */
+struct DirectCall {
+  /*! \brief The unpacking adapter of the signature. */
+  FDirectCall call{nullptr};
+  /*! \brief The raw function pointer. */
+  void* handle{nullptr};
+
+  /*! \return Whether the direct call is available. */
+  explicit operator bool() const { return call != nullptr; }
+
+  void operator()(const TVMArgs& args, TVMRetValue* rv) const { call(handle, args, rv); }
+};
+
+namespace detail {
+template <typename FType>
+struct DirectCallAdapter;
+
+template <typename R, typename... Args>
+struct DirectCallAdapter<R(Args...)> {
+  static void Call(void* handle, const TVMArgs& args, TVMRetValue* rv) {
+    using FPtr = R (*)(Args...);
+    if (args.size() != sizeof...(Args)) {
+      LOG(FATAL) << "Function " << SignaturePrinter<function_signature<FPtr>>::F() << " expects "
+                 << sizeof...(Args) << " arguments, but " << args.size() << " were provided.";
+    }
+    unpack_call<R, sizeof...(Args)>(nullptr, reinterpret_cast<FPtr>(handle), args, rv);
+  }
+};
+}  // namespace detail
+
 /*! \brief Registry for global function */
 class Registry {
  public:
@@ -181,13 +226,25 @@ class Registry {
    *
    * \endcode
    *
+   * When f is a plain function or a capture-less lambda, its raw function pointer is
+   * published as well, see GetDirect and GetDirectCall.
+   *
    * \param f The function to forward to.
    * \tparam FLambda The signature of the function.
    */
   template <typename FLambda>
   Registry& set_body_typed(FLambda f) {
     using FType = typename detail::function_signature<FLambda>::FType;
-    return set_body(TypedPackedFunc<FType>(std::move(f), name_).packed());
+    if constexpr (std::is_convertible_v<FLambda, FType*>) {
+      FType* fptr = f;
+      set_body(TypedPackedFunc<FType>(fptr, name_).packed());
+      direct_func_ = reinterpret_cast<void*>(fptr);
+      direct_type_ = typeid(FType).name();
+      direct_call_ = &detail::DirectCallAdapter<FType>::Call;
+      return *this;
+    } else {
+      return set_body(TypedPackedFunc<FType>(std::move(f), name_).packed());
+    }
   }
   /*!
    * \brief set the body of the function to be the passed method pointer.
@@ -354,6 +411,39 @@ class Registry {
    *   nullptr if it does not exist.
    */
   TVM_DLL static const PackedFunc* Get(const String& name);  // NOLINT(*)
+  /*!
+   * \brief Get the raw function pointer of a global function registered with set_body_typed.
+   *
+   * Calling through the pointer skips the argument packing and the type-code dispatch.
+   *
+   * \code
+   *
+   * auto* multiply = Registry::GetDirect<int(int, int)>("multiply");
+   * if (multiply != nullptr) {
+   *   int z = multiply(x, y);
+   * }
+   *
+   * \endcode
+   *
+   * \param name The name of the function.
+   * \tparam FType The signature of the function, which must match the registered one exactly.
+   * \return The function pointer, nullptr if the function does not exist, has no raw
+   *   function pointer, or has a different signature.
+   */
+  template <typename FType>
+  static FType* GetDirect(const String& name) {
+    return reinterpret_cast<FType*>(GetDirectFunc(name, typeid(FType).name()));
+  }
+  /*!
+   * \brief Get the direct call of a global function registered with set_body_typed.
+   *
+   * The direct call takes packed arguments like PackedFunc, and is meant for callers that do
+   * not know the signature statically, e.g. the Relax VM.
+   *
+   * \param name The name of the function.
+   * \return The direct call, which is empty if not available.
+   */
+  TVM_DLL static DirectCall GetDirectCall(const String& name);
   /*!
    * \brief Get the names of currently registered global function.
    * \return The names
@@ -364,10 +454,18 @@ class Registry {
   struct Manager;
 
  protected:
+  TVM_DLL static void* GetDirectFunc(const String& name, const char* type_name);
+
   /*! \brief name of the function */
   String name_;
   /*! \brief internal packed function */
   PackedFunc func_;
+  /*! \brief raw function pointer of the typed body, if any */
+  void* direct_func_{nullptr};
+  /*! \brief mangled name of the signature of direct_func_ */
+  const char* direct_type_{nullptr};
+  /*! \brief unpacking adapter of direct_func_ */
+  FDirectCall direct_call_{nullptr};
   friend struct Manager;
 };
 
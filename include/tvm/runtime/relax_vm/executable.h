@@ -38,7 +38,7 @@
 // NOTE: this file only changes if we change relax vm format
 // for example if relax vm format do not change in 0.15, this should remain as 0.14
 // if it changes in 0.16, we will change it to 0.16
-#define RELAX_VM_VERSION "0.14"
+#define RELAX_VM_VERSION "0.18"
 
 namespace tvm {
 namespace runtime {
@@ -180,9 +180,9 @@ class Executable : public runtime::ModuleNode {
   void SaveGlobalSection(dmlc::Stream* strm);
   /*!
    * \brief Save the constant pool.
-   * \param strm The input stream.
+   * \param strm The input stream, whose position is the offset in the serialized executable.
    */
-  void SaveConstantSection(dmlc::Stream* strm);
+  void SaveConstantSection(dmlc::SeekStream* strm);
   /*!
    * \brief Save the instructions.
    * \param strm The input stream.
@@ -200,9 +200,14 @@ class Executable : public runtime::ModuleNode {
   void LoadGlobalSection(dmlc::Stream* strm);
   /*!
    * \brief Load the constant pool.
-   * \param strm The input stream.
+   * \param strm The input stream over the serialized executable.
+   * \param data The beginning of the serialized executable.
+   * \param size The size of the serialized executable.
+   * \param owner The object keeping the serialized executable alive, which the NDArray
+   *  constants may alias.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  void LoadConstantSection(dmlc::SeekStream* strm, const char* data, size_t size,
+                           const ObjectRef& owner);
   /*!
    * \brief Load the instructions.
    * \param strm The input stream.
@@ -213,6 +218,14 @@ class Executable : public runtime::ModuleNode {
    * \param strm The input stream.
    */
   void LoadPackedFuncNames(dmlc::Stream* strm);
+  /*!
+   * \brief Load Executable from its serialized content in memory.
+   * \param data The beginning of the serialized executable.
+   * \param size The size of the serialized executable.
+   * \param owner The object keeping the serialized executable alive.
+   * \return The loaded executable, in the form of a `runtime::Module`.
+   */
+  static Module LoadFromBytes(const char* data, size_t size, ObjectRef owner);
 };
 
 }  // namespace relax_vm
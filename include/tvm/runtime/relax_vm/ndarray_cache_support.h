@@ -48,6 +48,19 @@ struct NDArrayCacheMetadata {
       TVM_DLL NDArray Load(Device device, const std::string* raw_data,
                            Optional<NDArray>* staging_buffer = nullptr) const;
 
+      /*!
+       * \brief Load the parameter from a shard that resides in host memory.
+       * \param device The device to load the parameter onto.
+       * \param shard_data The pointer to the beginning of the shard.
+       * \param staging_buffer The buffer to be used to avoid extra OpenCL copies. Pass in a nullptr
+       * in other cases
+       * \param shard_owner The object that keeps the shard memory alive. When defined, a CPU
+       * parameter that needs no decoding aliases the shard memory instead of being copied.
+       */
+      TVM_DLL NDArray Load(Device device, const char* shard_data,
+                           Optional<NDArray>* staging_buffer = nullptr,
+                           ObjectRef shard_owner = ObjectRef()) const;
+
       /*! \brief Name of the parameter */
       std::string name;
       /*! \brief Shape of the parameter */
@@ -68,6 +81,13 @@ struct NDArrayCacheMetadata {
                                 std::string* raw_data_buffer,    //
                                 Optional<NDArray>* staging_buffer = nullptr) const;
 
+    /*!
+     * \brief Load a FileRecord by mapping the shard into memory, which avoids reading
+     * the whole shard into an intermediate host buffer.
+     */
+    TVM_DLL Array<NDArray> LoadMapped(Device device, const std::string& path_prefix,
+                                      Optional<NDArray>* staging_buffer = nullptr) const;
+
     /*! \brief Relative path to the bin file */
     std::string data_path;
     /*! \brief Format of the file */
@@ -27,7 +27,10 @@
 #define TVM_RELAX_VM_ENABLE_PROFILER 1
 #endif
 
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -98,6 +101,55 @@ class VMClosure : public Closure {
   static PackedFunc BindLastArgs(PackedFunc func, std::vector<TVMRetValue> last_args);
 };
 
+/*!
+ * \brief The result of an asynchronous VM invocation.
+ * \sa VirtualMachine::InvokeClosureAsync
+ */
+class VMFutureObj : public Object {
+ public:
+  /*! \brief The device the invocation runs on. */
+  Device device;
+  /*! \brief The stream the invocation runs on, nullptr for the default stream. */
+  TVMStreamHandle stream{nullptr};
+
+  /*! \return Whether the host side of the invocation has finished. */
+  bool IsDone();
+  /*!
+   * \brief Wait for the invocation, then synchronize its stream.
+   * \return The return value of the invocation.
+   * \note Rethrows the error if the invocation failed.
+   */
+  TVMRetValue Wait();
+  /*!
+   * \brief Finish the future with a value.
+   * \param value The return value of the invocation.
+   */
+  void SetValue(TVMRetValue value);
+  /*!
+   * \brief Finish the future with an error.
+   * \param error The error thrown by the invocation.
+   */
+  void SetError(std::exception_ptr error);
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.Future";
+  TVM_DECLARE_FINAL_OBJECT_INFO(VMFutureObj, Object);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool done_{false};
+  bool stream_synced_{false};
+  TVMRetValue value_;
+  std::exception_ptr error_;
+};
+
+/*! \brief reference to VM future. */
+class VMFuture : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(VMFuture, ObjectRef, VMFutureObj);
+};
+
 /*!
  * \brief Represent a VM extension.
  * A VM extension allows the user to extend the VM with target specific functionalities.
@@ -178,6 +230,34 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param instrument The instrument function.
    */
   virtual void SetInstrument(PackedFunc instrument) = 0;
+  /*!
+   * \brief Create an execution context that shares the loaded program of this VM.
+   *
+   * The context shares the executable, devices, allocators, constants and
+   * function pool with this VM, and has its own call stack, inputs, outputs
+   * and saved functions. Contexts may run concurrently on different threads;
+   * each context must only be used by one thread at a time.
+   *
+   * \return The created context.
+   * \note This VM must be initialized first.
+   */
+  virtual ObjectPtr<VirtualMachine> CreateContext() = 0;
+  /*!
+   * \brief Invoke closure or packed function asynchronously on a stream.
+   *
+   * The invocation runs on a worker thread of this VM, with the stream as the
+   * current stream of the first device, and returns once it is queued. The
+   * invocations are run one by one in the order they are queued, in an
+   * execution context of their own, so the VM can be used while they run.
+   *
+   * \param closure_or_packedfunc A VM closure or a packed_func.
+   * \param args The input arguments. Objects are retained by the invocation, and
+   *        raw handles such as DLTensor* must stay valid until it finishes.
+   * \param stream The stream to run on, nullptr for the default stream.
+   * \return The future of the return value.
+   */
+  virtual VMFuture InvokeClosureAsync(const ObjectRef& closure_or_packedfunc, TVMArgs args,
+                                      TVMStreamHandle stream) = 0;
 
   /*!
    * \brief Get or create a VM extension. Once created, the extension will be stored in the VM
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #if defined(__linux__) || defined(__ANDROID__)
@@ -54,6 +55,9 @@ typedef struct {
 
 namespace tvm {
 namespace runtime {
+
+class ThreadPool;
+
 namespace threading {
 
 /*!
@@ -149,6 +153,83 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
  */
 TVM_DLL int32_t NumThreads();
 
+/*!
+ * \brief Whether the calling thread is running a task of a parallel launch.
+ *
+ * A parallel loop cannot be launched from such a thread.
+ */
+TVM_DLL bool InParallelRegion();
+
+/*!
+ * \brief Get the CPUs of each NUMA node of the system.
+ *
+ * The CPUs of a node are ordered so that physical cores come before their
+ * hyper-threading siblings. Systems without NUMA information are reported as
+ * a single node holding every CPU.
+ *
+ * \return The CPU ids indexed by NUMA node.
+ */
+TVM_DLL const std::vector<std::vector<unsigned int>>& NUMANodeCPUs();
+
+/*!
+ * \return The NUMA node of the CPU the calling thread is running on, or 0 when unknown.
+ */
+TVM_DLL int CurrentNUMANode();
+
+/*!
+ * \brief Bind the worker threads used by the calling thread to one NUMA node.
+ *
+ * Each thread launching parallel loops owns its own worker group, so binding
+ * the groups of several threads to different nodes gives one group per node.
+ * Memory first touched by the workers is then placed on that node by the OS.
+ *
+ * \param node The NUMA node to bind to.
+ * \param nthreads The number of threads to use (0 = one per physical core of the node).
+ */
+TVM_DLL void ConfigureNUMANode(int node, int nthreads);
+
+/*!
+ * \brief Create a thread pool shared by the whole process, with one worker bound to each CPU.
+ *
+ * Unlike the thread-local pools, the launching thread does not run any task of
+ * the named pool, so the parallel loops launched into it only use its CPUs.
+ * The launches of different threads into the same pool are serialized.
+ *
+ * \param name The name of the pool, which must not be empty or already in use.
+ * \param cpus The CPUs of the pool.
+ */
+TVM_DLL void CreateThreadPool(const std::string& name, const std::vector<unsigned int>& cpus);
+
+/*!
+ * \brief Remove a named thread pool. Its workers exit once no scope uses the pool anymore.
+ * \param name The name of the pool.
+ */
+TVM_DLL void RemoveThreadPool(const std::string& name);
+
+/*!
+ * \brief RAII scope that routes the parallel launches of the calling thread
+ *  to a named thread pool, see CreateThreadPool.
+ */
+class ThreadPoolScope {
+ public:
+  /*!
+   * \brief Enter the scope.
+   * \param name The name of the pool, or the empty string for the thread-local pool.
+   */
+  TVM_DLL explicit ThreadPoolScope(const std::string& name);
+  TVM_DLL ~ThreadPoolScope();
+
+  ThreadPoolScope(const ThreadPoolScope&) = delete;
+  ThreadPoolScope& operator=(const ThreadPoolScope&) = delete;
+
+ private:
+  /*! \brief Whether the scope switched the pool, false when it was already current. */
+  bool active_{false};
+  /*! \brief The pool that was current before the scope. */
+  std::string prev_name_;
+  std::shared_ptr<ThreadPool> prev_pool_;
+};
+
 }  // namespace threading
 
 /*!
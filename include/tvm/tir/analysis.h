@@ -190,6 +190,10 @@ TVM_DLL bool VerifyMemory(const PrimFunc& func);
  *        "max_thread_x": Maximum length of threadIdx.x.
  *        "max_thread_y": Maximum length of threadIdx.y.
  *        "max_thread_z": Maximum length of threadIdx.z.
+ *        "max_registers_per_thread": Maximum number of 32-bit registers per thread, as estimated
+ *                                    by EstimateRegisterUsage.
+ *        "max_registers_per_block": Maximum number of 32-bit registers per block, as estimated
+ *                                   by EstimateRegisterUsage.
  *
  *        If one key is missing in this argument, the pass won't check for that item.
  * \return valid Whether it is a valid GPU code
@@ -197,6 +201,26 @@ TVM_DLL bool VerifyMemory(const PrimFunc& func);
  */
 TVM_DLL bool VerifyGPUCode(const PrimFunc& func, Map<String, PrimExpr> constraints);
 
+/*!
+ * \brief Estimate the number of 32-bit registers that each thread of a GPU kernel keeps live,
+ *  from the local buffers live at the same time, the share of each thread in the warp-level
+ *  buffers, and the values loaded by the iterations of unrolled loops, which are scheduled
+ *  together. It is meant to reject the kernels that spill before they are measured.
+ * \param stmt The lowered body of the kernel, or of a function launching several kernels.
+ * \return The estimate for the kernel using the most registers.
+ */
+TVM_DLL int64_t EstimateRegisterUsage(const Stmt& stmt);
+
+/*!
+ * \brief Detect the bank conflicts of the accesses to shared memory, by evaluating the indices
+ *  that the lanes of the first warp access at once. The loop variables are taken as zero, so the
+ *  accesses of all the iterations are assumed to conflict alike.
+ * \param func The function, either scheduled or lowered to thread_extent attributes.
+ * \return The worst conflict degree of the accesses to each shared memory buffer, by its data
+ *  variable. The buffers accessed through pointers or in vectorized loops are left out.
+ */
+TVM_DLL Map<Var, Integer> DetectSharedMemoryBankConflicts(const PrimFunc& func);
+
 /**
  * @brief Utility function to get the list of lowering passes to be applied to calculate the
  * compacted VTCM allocation size
@@ -718,8 +718,10 @@ TVM_DLL const Op& ptx_arrive_barrier_expect_tx();
 /*!
  * \brief tvm intrinsics for ptx barrier wait using mbarrier.try_wait
  *
- * ptx_wait_barrier(int barrier_id)
+ * ptx_wait_barrier(int barrier_id, int phase_bit = 0)
  *
+ * \note The barrier ids of the barrier intrinsics may be computed at runtime, and the phase bit
+ *  is the parity of the phase to wait for.
  */
 TVM_DLL const Op& ptx_wait_barrier();
 
@@ -731,6 +733,17 @@ TVM_DLL const Op& ptx_wait_barrier();
  */
 TVM_DLL const Op& create_barriers();
 
+/*!
+ * \brief tvm intrinsic for loading from the shared memory of another thread block in the same
+ *  thread block cluster (distributed shared memory) on sm_90 and later
+ *
+ * Type ptx_ld_shared_cluster(Var shared_ptr, Expr offset, Expr block_rank)
+ *
+ * \note The element at `offset` of the shared buffer is loaded from the block of rank
+ *  `block_rank` in the cluster, which has the same layout of shared memory as the current block.
+ */
+TVM_DLL const Op& ptx_ld_shared_cluster();
+
 /*!
  * \brief tvm intrinsic for storing the result of PTX MMA into a destination pointer.
  *        For example, if each thread in a warp of size 32 has 4 elements from the result of
@@ -811,6 +824,37 @@ TVM_DLL const Op& vectorhigh();
  */
 TVM_DLL const Op& vectorlow();
 
+/*!
+ * \brief Reduce the lanes of a vector by addition.
+ *
+ *  Type vector_reduce_add(VectorType vec)
+ *
+ * The order of the additions is unspecified, so this is lowered to a
+ * tree of shuffles for floating point types as well.
+ */
+TVM_DLL const Op& vector_reduce_add();
+
+/*!
+ * \brief Reduce the lanes of a vector by multiplication.
+ *
+ *  Type vector_reduce_mul(VectorType vec)
+ */
+TVM_DLL const Op& vector_reduce_mul();
+
+/*!
+ * \brief Reduce the lanes of a vector to their minimum.
+ *
+ *  Type vector_reduce_min(VectorType vec)
+ */
+TVM_DLL const Op& vector_reduce_min();
+
+/*!
+ * \brief Reduce the lanes of a vector to their maximum.
+ *
+ *  Type vector_reduce_max(VectorType vec)
+ */
+TVM_DLL const Op& vector_reduce_max();
+
 /*!
  * \brief Concat two vectors.
  */
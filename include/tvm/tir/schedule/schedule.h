@@ -599,6 +599,15 @@ class ScheduleNode : public runtime::Object {
    * \param block The block to be inlined to its producer
    */
   virtual void ReverseComputeInline(const BlockRV& block) = 0;
+  /*!
+   * \brief Fuse the elementwise epilogue of a block into it, by inlining its only consumer into it
+   * with ReverseComputeInline, as long as the consumer can be inlined, and repeating with the
+   * consumer of the result. The epilogue is then computed on the values the block holds, e.g. in
+   * the registers of the accumulator fragments of a tensor core GEMM, instead of reading them back
+   * from the buffer. It is a no-op if the consumer cannot be inlined.
+   * \param block The block storing the result that the epilogue consumes
+   */
+  virtual void FuseEpilogue(const BlockRV& block) = 0;
   /******** Schedule: Reduction ********/
   /*!
    * \brief Decompose a reduction block into two separate blocks.
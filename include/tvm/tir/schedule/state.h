@@ -61,6 +61,12 @@ struct BlockInfo {
    * 3) All the statements in the scope are schedulable statements, i.e. Block and For
    */
   bool stage_pipeline{false};
+  /*!
+   * \brief Whether the BlockInfo of the blocks nested in this block remain valid since they were
+   * last calculated, i.e. `Replace` has not changed the subtree of this block since then.
+   * Recalculating the BlockInfo of an outer scope skips the nested blocks of such block.
+   */
+  bool subtree_intact{false};
 
   BlockInfo() = default;
 
@@ -164,6 +170,8 @@ class ScheduleStateNode : public Object {
    * \brief Recalculate the BlockInfo recursively under stmt.
    * If stmt is a Block itself, we will not reset its affine binding flag unless it doesn't
    * have block vars, since the affine flag depends on the outer scope of stmt.
+   * The blocks nested in an intact block (see `BlockInfo::subtree_intact`) below the top level
+   * blocks of stmt are not recalculated.
    */
   TVM_DLL void UpdateScopeBlockInfo(const Stmt& stmt);
   /*!
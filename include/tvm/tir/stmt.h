@@ -1392,6 +1392,11 @@ namespace attr {
 constexpr const char* thread_extent = "thread_extent";
 /*! \brief Mark launching of a virtual thread. */
 constexpr const char* virtual_thread = "virtual_thread";
+/*!
+ * \brief Mark the extent of the thread block cluster along a blockIdx dimension, whose blocks
+ *  communicate through distributed shared memory. The node is the IterVar of the blockIdx.
+ */
+constexpr const char* cluster_extent = "cluster_extent";
 /*! \brief Mark region is processed by a co-processor */
 constexpr const char* coproc_scope = "coproc_scope";
 /*!
@@ -1428,6 +1433,8 @@ constexpr const char* reduce_scope = "reduce_scope";
 constexpr const char* pragma_auto_unroll_max_step = "pragma_auto_unroll_max_step";
 /*! \brief Pragma: unroll explicit */
 constexpr const char* pragma_unroll_explicit = "pragma_unroll_explicit";
+/*! \brief Pragma: the lookahead distance in bytes of the software prefetches, 0 to disable */
+constexpr const char* pragma_software_prefetch_distance = "pragma_software_prefetch_distance";
 /*! \brief Mark region is guarded by the pragma extension */
 constexpr const char* pragma_scope_prefix = "pragma_";
 /*! \brief Import C source or file into the final code gen module */
@@ -1575,6 +1582,13 @@ constexpr const char* software_pipeline_order = "software_pipeline_order";
  */
 constexpr const char* software_pipeline_async_stages = "software_pipeline_async_stages";
 
+/*! \brief Mark that the software pipeline runs its producers and consumers in separate warps
+ * \note The value is the number of versions of the buffers passed from the producers, stage 0,
+ *       to the consumers, stage 1. The producer warps are added to the threads of the innermost
+ *       enclosing threadIdx.x loop, and synchronize with the consumer warps with mbarriers.
+ */
+constexpr const char* software_pipeline_warp_specialize = "software_pipeline_warp_specialize";
+
 /*! \brief Mark the buffers which is const access and can be transformed layout. */
 constexpr const char* layout_free_buffers = "layout_free_buffers";
 
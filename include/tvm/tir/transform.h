@@ -51,12 +51,15 @@ using tvm::transform::Sequential;
  * \param opt_level The optimization level of the function pass.
  * \param name The name of the function pass.
  * \param required The list of the passes that the function pass is dependent on.
+ * \param traceable Whether the function pass is traceable.
+ * \param thread_safe Whether `pass_func` can run on several PrimFuncs at the same time.
  *
  * \return The created function pass.
  */
 TVM_DLL Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable = false);
+    int opt_level, String name, tvm::Array<String> required, bool traceable = false,
+    bool thread_safe = false);
 
 /*!
  * \brief Inject prefetch instructions into stmt.
@@ -65,6 +68,17 @@ TVM_DLL Pass CreatePrimFuncPass(
  */
 TVM_DLL Pass InjectPrefetch();
 
+/*!
+ * \brief Inject software prefetches for the streaming accesses of the innermost loops on CPU
+ *  targets.
+ *
+ * The lookahead distance in bytes is given by the "tir.software_prefetch_distance" config, and
+ * overridden by the "pragma_software_prefetch_distance" attribute of the enclosing scopes.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
 // TODO(tvm-team): consolidate configs to the PassContext
 /*!
  * \brief Flatten the multi-dimensional read/write
@@ -573,6 +587,24 @@ TVM_DLL Pass LowerOpaqueBlock();
  */
 TVM_DLL Pass FlattenBuffer();
 
+/*!
+ * \brief Choose a layout free of bank conflicts for the shared memory buffers, either by XOR
+ *  swizzling their columns with their rows or by padding their rows, as estimated from the
+ *  indices that the lanes of a warp access. It applies to the N-d buffers after
+ *  LowerOpaqueBlock, and leaves out the buffers accessed through pointers or in vectorized loops.
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSharedMemorySwizzle();
+
+/*!
+ * \brief Split off a fast path of a dynamic-shape function, specialized for the shape values that
+ *  are multiples of the tiles inferred from the ceil divisions on them, in which the boundary
+ *  predicates that always hold are removed. The fast path and the original body are dispatched
+ *  on the shape values at runtime. It applies after LowerOpaqueBlock.
+ * \return The pass.
+ */
+TVM_DLL Pass SpecializeDynamicShape();
+
 /*
  * \brief Flatten the multi-dimensional read/write
  *  to two dimensional texture Load/Store and realize
@@ -745,6 +777,21 @@ TVM_DLL Pass UnifiedStaticMemoryPlanner();
  */
 TVM_DLL Pass InjectSoftwarePipeline();
 
+/*!
+ * \brief Lower the software pipelines annotated with `software_pipeline_warp_specialize` into
+ * warp specialized pipelines.
+ *
+ * The threads of the enclosing threadIdx.x loop are doubled. The additional producer warps run the
+ * statements of stage 0 and write the versions of the staged buffers in turn, while the original
+ * consumer warps run the statements of stage 1 and the rest of the kernel. The two sides hand the
+ * versions over with a pair of mbarriers per version, the copies of the producers being
+ * asynchronous where InjectPTXAsyncCopy applies.
+ *
+ * \return The IR transform pass.
+ * \note It must run before InjectSoftwarePipeline, which lowers the other pipelines.
+ */
+TVM_DLL Pass InjectWarpSpecialization();
+
 TVM_DLL Pass BindParams(const Array<runtime::NDArray>& constants);
 
 /*!
@@ -76,6 +76,19 @@ Map<BufferInfo, PoolAllocation> HillClimb(const Array<BufferInfo>& buffer_info_a
 Map<BufferInfo, PoolAllocation> HillClimb(const Array<BufferInfo>& buffer_info_arr,
                                           const Integer& memory_pressure);
 
+/*!
+ * \brief The Branch-and-Bound algorithm to plan memory
+ *
+ * This will search the placements exactly, starting from the greedy-by-size
+ * plan and pruning with the memory pressure as lower bound. It is meant for
+ * small graphs, the search stops at the kUSMPTimeLimitOption (one second by
+ * default) with the best plan found so far.
+ *
+ * \return A Map of BufferInfo objects and their associated PoolAllocation
+ */
+Map<BufferInfo, PoolAllocation> BranchAndBound(const Array<BufferInfo>& buffer_info_arr,
+                                               const Integer& memory_pressure);
+
 }  // namespace algo
 }  // namespace usmp
 }  // namespace tir
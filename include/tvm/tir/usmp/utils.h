@@ -51,6 +51,11 @@ constexpr const char* kUSMPUseWorkspaceIO = "tir.usmp.use_workspace_io";
  * The algorithm should be provided as registered PackedFunc with the name tir.usmp.algorithm.NAME
  */
 constexpr const char* kUSMPCustomAlgorithmOption = "tir.usmp.custom_algorithm";
+/*!
+ * \brief PassContext option to bound the time in milliseconds spent by the searching memory
+ * planning algorithms in USMP, i.e. hill_climb and branch_and_bound
+ */
+constexpr const char* kUSMPTimeLimitOption = "tir.usmp.time_limit_ms";
 
 namespace tir {
 namespace usmp {
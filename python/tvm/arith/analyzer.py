@@ -116,6 +116,9 @@ class Analyzer:
         self._get_rewrite_simplify_stats = _mod("get_rewrite_simplify_stats")
         self._reset_rewrite_simplify_stats = _mod("reset_rewrite_simplify_stats")
         self._canonical_simplify = _mod("canonical_simplify")
+        self._get_canonical_simplify_stats = _mod("get_canonical_simplify_stats")
+        self._reset_canonical_simplify_stats = _mod("reset_canonical_simplify_stats")
+        self._set_simplify_step_budget = _mod("set_simplify_step_budget")
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
         self._can_prove_equal = _mod("can_prove_equal")
@@ -210,6 +213,28 @@ class Analyzer:
         """
         return self._canonical_simplify(expr)
 
+    @property
+    def canonical_simplify_stats(self):
+        return self._get_canonical_simplify_stats()
+
+    def reset_canonical_simplify_stats(self):
+        self._reset_canonical_simplify_stats()
+
+    def set_simplify_step_budget(self, budget):
+        """Set the step budget of each rewrite and canonical simplification.
+
+        Once a simplification exceeds the budget, the remaining subexpressions
+        are left unchanged instead of raising an error. The stopped
+        simplifications are reported by `budget_exceeded` and
+        `budget_exceeded_exprs` in the simplifier stats.
+
+        Parameters
+        ----------
+        budget : int
+            The maximum number of steps of each simplification, or 0 for no limit.
+        """
+        self._set_simplify_step_budget(budget)
+
     def int_set(self, expr, dom_map):
         """Compute a symbolic IntSet that covers expr for all values in dom_map.
 
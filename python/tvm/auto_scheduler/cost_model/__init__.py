@@ -18,4 +18,5 @@
 """ Cost model that estimates the performance of programs """
 
 from .cost_model import RandomModel
+from .tree_ensemble_model import TreeEnsembleModel
 from .xgb_model import XGBModel
@@ -0,0 +1,98 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Tree ensemble cost model predicting natively"""
+import tvm._ffi
+from tvm import nd
+
+from .. import _ffi_api
+from .cost_model import CostModel
+from .xgb_model import XGBModel
+
+
+@tvm._ffi.register_object("auto_scheduler.TreeEnsembleModel")
+class TreeEnsembleModel(CostModel):
+    """A cost model predicting with a tree ensemble in C++.
+
+    The ensemble is trained by an XGBModel on the python side. After each retraining its trees are
+    handed over as flat arrays, so that the predictions in the evolutionary search neither call
+    back into python nor convert the features to numpy.
+
+    Parameters
+    ----------
+    trainer : Optional[XGBModel]
+        The model that keeps the training data and trains the ensemble. If not given, an XGBModel
+        is created with the keyword arguments.
+    """
+
+    def __init__(self, trainer=None, **kwargs):
+        if trainer is None:
+            trainer = XGBModel(**kwargs)
+        self.trainer = trainer
+        self._last_bst = None
+
+        def f_update(inputs, results):
+            trainer.update(inputs, results)
+            if trainer.bst is self._last_bst:
+                return None
+            return self._ensemble()
+
+        self.__init_handle_by_constructor__(_ffi_api.TreeEnsembleModel, f_update)
+
+    def _ensemble(self):
+        ensemble = self.trainer.tree_ensemble()
+        if ensemble is None:
+            self._last_bst = None
+            return None
+        self._last_bst = self.trainer.bst
+        return [nd.array(x) for x in ensemble]
+
+    def _sync(self):
+        _ffi_api.TreeEnsembleModelSetEnsemble(self, self._ensemble())
+
+    def update_from_file(self, file_name, n_lines=None):
+        """Load measure records from a log file to update the cost model.
+
+        Parameters
+        ----------
+        file_name: str
+            The filename
+        n_lines: Optional[int]
+            Only load first n lines of the log file
+        """
+        self.trainer.update_from_file(file_name, n_lines)
+        self._sync()
+
+    def save(self, file_name):
+        """Save the model to a file
+
+        Parameters
+        ----------
+        file_name: str
+            The filename
+        """
+        self.trainer.save(file_name)
+
+    def load(self, file_name):
+        """Load the model from a file
+
+        Parameters
+        ----------
+        file_name: str
+            The filename
+        """
+        self.trainer.load(file_name)
+        self._sync()
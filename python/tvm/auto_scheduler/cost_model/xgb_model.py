@@ -309,6 +309,22 @@ class XGBModel(PythonBasedModel):
 
         return breakdown
 
+    def tree_ensemble(self):
+        """Export the trained booster as the flat tree ensemble predicted by `TreeEnsembleModel`.
+
+        Returns
+        -------
+        ensemble : Optional[List[np.ndarray]]
+            The nodes, values, roots and base score of the ensemble, or None if the model is
+            still warming up.
+        """
+        # pylint: disable=import-outside-toplevel
+        from tvm.meta_schedule.cost_model.xgb_model import booster_tree_ensemble
+
+        if self.bst is None or len(self.inputs) <= self.num_warmup_sample:
+            return None
+        return booster_tree_ensemble(self.bst)
+
     def update_from_file(self, file_name, n_lines=None):
         """Load measure records from a log file to update the cost model.
         This function can be used to pre-train the cost model with history log files.
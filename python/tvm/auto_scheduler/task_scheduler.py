@@ -30,7 +30,7 @@ import logging
 import numpy as np
 
 from .search_policy import SearchPolicy, SketchPolicy, PreloadMeasuredStates
-from .cost_model import RandomModel, XGBModel
+from .cost_model import RandomModel, TreeEnsembleModel, XGBModel
 from .utils import array_mean
 from .measure import ProgramMeasurer
 from .measure_record import RecordReader
@@ -85,12 +85,14 @@ def make_search_policies(
 
     if isinstance(search_policy, str):
         policy_type, model_type = search_policy.split(".")
-        if model_type == "xgb":
+        if model_type in ("xgb", "xgb-native"):
             cost_model = XGBModel(
                 num_warmup_sample=len(tasks) * num_measures_per_round,
                 model_file=load_model_file,
                 adaptive_training=adaptive_training,
             )
+            if model_type == "xgb-native":
+                cost_model = TreeEnsembleModel(cost_model)
             if load_model_file and os.path.isfile(load_model_file):
                 logger.info("TaskScheduler: Load pretrained model...")
                 cost_model.load(load_model_file)
@@ -297,6 +299,7 @@ class TaskScheduler:
             If it is str,
             "default" for the default policy (SketchPolicy + XGBModel),
             "sketch.xgb" for SketchPolicy + XGBModel,
+            "sketch.xgb-native" for SketchPolicy + XGBModel predicting in C++,
             "sketch.random" for SketchPolicy + RandomModel.
         search_policy_params : Optional[Dict[str, Any]]
             The parameters of the search policy
@@ -263,6 +263,29 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def set_thread_pool(self, name):
+        """Run the parallel loops of the graph in a named thread pool.
+
+        Parameters
+        ----------
+        name : str
+            The name of a pool created with ``runtime.create_threadpool``,
+            or the empty string to use the thread pool of the calling thread.
+        """
+        self.module["set_thread_pool"](name)
+
+    def set_num_branch_workers(self, num_workers):
+        """Run the independent branches of the graph concurrently.
+
+        Parameters
+        ----------
+        num_workers : int
+            The number of threads running the operators, including the calling one.
+            1 runs the operators one by one, which is the default. Only supported
+            when the graph runs on CPU.
+        """
+        self.module["set_num_branch_workers"](num_workers)
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
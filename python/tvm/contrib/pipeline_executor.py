@@ -59,6 +59,9 @@ class PipelineModule(object):
         self._get_num_inputs = self.module["get_num_inputs"]
         self._get_input_pipeline_map = self.module["get_input_pipeline_map"]
         self._get_pipe_execute_count = self.module["get_execute_count"]
+        self._set_micro_batch = self.module["set_micro_batch"]
+        self._set_queue_depth = self.module["set_queue_depth"]
+        self._get_statistics = self.module["get_statistics"]
 
     def run(self):
         """Run the pipeline executor."""
@@ -153,6 +156,50 @@ class PipelineModule(object):
 
         return outputs
 
+    def set_micro_batch(self, module_index, micro_batch):
+        """Merge consecutive requests into one run of a pipeline module.
+
+        The requests are concatenated along the first axis of the module inputs, and the
+        module outputs are split back into requests the same way. A module only runs once
+        it got ``micro_batch`` requests. This must be called before running the pipeline.
+
+        Parameters
+        ----------
+        module_index : int
+            The index of the module in the pipeline.
+        micro_batch : int
+            The number of requests, which must divide the first dimension of the inputs
+            and the outputs of the module.
+        """
+        self._set_micro_batch(module_index, micro_batch)
+
+    def set_queue_depth(self, depth):
+        """Bound the number of data waiting between two pipeline modules.
+
+        A module forwarding into a full queue waits for its consumer, so a slow module
+        slows down the ones feeding it, up to the caller of ``run``. The outputs must be
+        read while running when more requests than the depth are in flight.
+
+        Parameters
+        ----------
+        depth : int
+            The maximum number of data in each queue.
+        """
+        self._set_queue_depth(depth)
+
+    def get_statistics(self):
+        """Get the throughput and latency counters of the pipeline modules.
+
+        Returns
+        -------
+        stats : dict
+            The elapsed time since the first run, the time the caller waited for a full
+            queue, and for each module in "stages": the micro-batch size, the number of
+            requests and of runs, the total, mean and maximum time of the runs, the time
+            waited for full queues and the throughput in requests per second.
+        """
+        return json.loads(self._get_statistics())
+
     @property
     def num_executing_pipeline(self):
         """Getting the count of running pipeline.
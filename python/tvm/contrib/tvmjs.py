@@ -71,6 +71,15 @@ def _calculate_md5(filename):
     return hash_md5.hexdigest()
 
 
+def _calculate_sha256(filename):
+    # The web runtime checks the shards with sha256, as WebCrypto does not support md5.
+    hash_sha256 = hashlib.sha256()
+    with open(filename, "rb") as file:
+        for chunk in iter(lambda: file.read(8192), b""):
+            hash_sha256.update(chunk)
+    return hash_sha256.hexdigest()
+
+
 class NDArrayCacheShardingManager:
     """Internal helper to shard ndarrays."""
 
@@ -174,6 +183,7 @@ class NDArrayCacheShardingManager:
         for idx in self.updated_shards:
             full_path = os.path.join(self.cache_dir, self.shard_records[idx]["dataPath"])
             self.shard_records[idx]["md5sum"] = _calculate_md5(full_path)
+            self.shard_records[idx]["sha256"] = _calculate_sha256(full_path)
         return self.shard_records
 
     def _commit_internal(self, data, records):
@@ -189,6 +199,7 @@ class NDArrayCacheShardingManager:
             "nbytes": len(data),
             "records": records,
             "md5sum": _calculate_md5(full_path),
+            "sha256": _calculate_sha256(full_path),
         }
         self.shard_records.append(shard_record)
 
@@ -223,7 +234,7 @@ def dump_ndarray_cache(
     cache_dir: str
         The path to the cache
 
-    encode_format: {"f32-to-bf16", "raw"}
+    encode_format: {"f32-to-bf16", "f32-to-f16", "raw"}
         Encoding format.
 
     meta_data: json-compatible-struct or Callable[[], Any]
@@ -240,7 +251,7 @@ def dump_ndarray_cache(
         If the cache already exists, update the cache. When set to False, it will overwrite the
         existing files.
     """
-    if encode_format not in ("raw", "f32-to-bf16"):
+    if encode_format not in ("raw", "f32-to-bf16", "f32-to-f16"):
         raise ValueError(f"Invalie encode_format {encode_format}")
 
     records = []
@@ -290,6 +301,8 @@ def dump_ndarray_cache(
         if encode_format == "f32-to-bf16" and dtype == "float32":
             data = _convert_f32_to_bf16(v).tobytes()
             f32_to_bf16_triggered = True
+        elif encode_format == "f32-to-f16" and dtype == "float32":
+            data = v.astype("float16").tobytes()
         else:
             data = v.tobytes()
 
@@ -386,6 +399,9 @@ def load_ndarray_cache(cachepath: str, device: tvm.runtime.Device):
             if encode_format == "f32-to-bf16" and dtype == "float32":
                 data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
                 arr.copyfrom(_convert_bf16_to_f32(data))
+            elif encode_format == "f32-to-f16" and dtype == "float32":
+                data = np.frombuffer(buffer_source, dtype="float16").reshape(shape)
+                arr.copyfrom(data.astype("float32"))
             elif dtype == "bfloat16":
                 data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
                 arr.copyfrom(data)
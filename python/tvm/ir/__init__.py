@@ -27,7 +27,9 @@ from .base import (
     Span,
     SequentialSpan,
     assert_structural_equal,
+    load_binary_graph,
     load_json,
+    save_binary_graph,
     save_json,
     structural_equal,
     structural_hash,
@@ -146,6 +146,40 @@ def save_json(node) -> str:
     return _ffi_node_api.SaveJSON(node)
 
 
+def load_binary_graph(blob) -> Object:
+    """Load tvm object saved by save_binary_graph.
+
+    Parameters
+    ----------
+    blob : bytearray
+        The binary graph.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return _ffi_node_api.LoadBinaryGraph(bytearray(blob))
+
+
+def save_binary_graph(node) -> bytearray:
+    """Save tvm object in the binary graph format.
+
+    It holds the same information as save_json but loads several times faster.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    blob : bytearray
+        Saved binary graph.
+    """
+    return _ffi_node_api.SaveBinaryGraph(node)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
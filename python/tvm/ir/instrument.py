@@ -257,6 +257,60 @@ class PassTimingInstrument(tvm.runtime.Object):
         return _ffi_instrument_api.RenderTimePassProfiles()
 
 
+@tvm._ffi.register_object("instrument.PassStatisticsInstrument")
+class PassStatisticsInstrument(tvm.runtime.Object):
+    """A pass instrument implemented in C++ collecting the statistics of every pass run,
+    including the nested ones: the wall time, the resident memory of the process before, after
+    and at its peak during the pass, the number of IR nodes of the module before and after, and
+    the number of functions added, removed or changed by the pass.
+
+    The statistics are kept after the PassContext exits, until the instrument is used in another
+    PassContext.
+
+    Parameters
+    ----------
+    count_nodes : bool
+        Whether to count the IR nodes, which traverses the whole module twice per pass.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        stats = PassStatisticsInstrument()
+        with tvm.transform.PassContext(instruments=[stats]):
+            mod = relax.get_pipeline()(mod)
+        print(stats.render())
+        records = json.loads(stats.render_json())
+    """
+
+    def __init__(self, count_nodes: bool = True):
+        self.__init_handle_by_constructor__(
+            _ffi_instrument_api.MakePassStatisticsInstrument, count_nodes
+        )
+
+    def render(self) -> str:
+        """Render the statistics as a table, the nested passes indented below their parents.
+
+        Returns
+        -------
+        table : str
+            The rendered table.
+        """
+        return _ffi_instrument_api.RenderPassStatistics(self, False)
+
+    def render_json(self) -> str:
+        """Render the statistics as a JSON array of objects, in the order the passes began.
+
+        Returns
+        -------
+        json : str
+            The JSON string, with the keys name, depth, duration_ms, rss_before, rss_after,
+            peak_rss (in bytes), nodes_before, nodes_after, functions_changed and completed.
+        """
+        return _ffi_instrument_api.RenderPassStatistics(self, True)
+
+
 @pass_instrument
 class PassPrintingInstrument:
     """A pass instrument to print if before or
@@ -42,11 +42,18 @@ class PassInfo(tvm.runtime.Object):
 
     required : List[str]
         The list of passes that are required by a certain pass.
+
+    traceable : bool
+        Whether the pass is traced.
+
+    thread_safe : bool
+        Whether the function-local transformation of the pass can run on several functions of
+        a module at the same time, see the config ``ir.num_function_pass_threads``.
     """
 
-    def __init__(self, opt_level, name, required=None, traceable=False):
+    def __init__(self, opt_level, name, required=None, traceable=False, thread_safe=False):
         self.__init_handle_by_constructor__(
-            _ffi_transform_api.PassInfo, opt_level, name, required, traceable
+            _ffi_transform_api.PassInfo, opt_level, name, required, traceable, thread_safe
         )
 
 
@@ -38,7 +38,7 @@ from ..utils import _get_default_str
 class CostModel(Object):
     """Cost model."""
 
-    CostModelType = Union["CostModel", Literal["xgb", "mlp", "random"]]
+    CostModelType = Union["CostModel", Literal["xgb", "xgb-native", "mlp", "random"]]
 
     def load(self, path: str) -> None:
         """Load the cost model from given file location.
@@ -106,7 +106,7 @@ class CostModel(Object):
 
     @staticmethod
     def create(
-        kind: Literal["xgb", "mlp", "random", "none"],
+        kind: Literal["xgb", "xgb-native", "mlp", "random", "none"],
         *args,
         **kwargs,
     ) -> "CostModel":
@@ -114,18 +114,25 @@ class CostModel(Object):
 
         Parameters
         ----------
-        kind : Literal["xgb", "mlp", "random", "none"]
-            The kind of the cost model. Can be "xgb", "mlp", "random" or "none".
+        kind : Literal["xgb", "xgb-native", "mlp", "random", "none"]
+            The kind of the cost model. Can be "xgb", "xgb-native", "mlp", "random" or "none".
+            "xgb-native" trains an XGBModel and predicts with its trees in C++.
 
         Returns
         -------
         cost_model : CostModel
             The created cost model.
         """
-        from . import RandomModel, XGBModel  # pylint: disable=import-outside-toplevel
+        from . import (  # pylint: disable=import-outside-toplevel
+            RandomModel,
+            TreeEnsembleModel,
+            XGBModel,
+        )
 
         if kind == "xgb":
             return XGBModel(*args, **kwargs)  # type: ignore
+        if kind == "xgb-native":
+            return TreeEnsembleModel(XGBModel(*args, **kwargs))  # type: ignore
 
         # params only relevant to XGBModel
         _xgb_params = ["num_tuning_cores", "tree_method"]
@@ -0,0 +1,82 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Tree ensemble cost model predicting natively"""
+from typing import List, Optional
+
+from tvm._ffi import register_object
+
+from ... import nd
+from .. import _ffi_api
+from ..runner import RunnerResult
+from ..search_strategy import MeasureCandidate
+from ..tune_context import TuneContext
+from .cost_model import CostModel
+from .xgb_model import XGBModel
+
+
+@register_object("meta_schedule.TreeEnsembleCostModel")
+class TreeEnsembleModel(CostModel):
+    """A cost model predicting with a tree ensemble in C++.
+
+    The ensemble is trained by an XGBModel on the python side. After each retraining its trees are
+    handed over as flat arrays, so that the predictions in the evolutionary search neither call
+    back into python nor convert the features to numpy.
+
+    Parameters
+    ----------
+    trainer : Optional[XGBModel]
+        The model that keeps the training data and trains the ensemble. If not given, an XGBModel
+        is created with the keyword arguments.
+    """
+
+    def __init__(self, trainer: Optional[XGBModel] = None, **kwargs):
+        if trainer is None:
+            trainer = XGBModel(**kwargs)
+        last = {"booster": None}
+
+        def _ensemble() -> Optional[List[nd.NDArray]]:
+            ensemble = trainer.tree_ensemble()
+            if ensemble is None:
+                last["booster"] = None
+                return None
+            last["booster"] = trainer.booster
+            return [nd.array(x) for x in ensemble]
+
+        def f_load(path: str) -> Optional[List[nd.NDArray]]:
+            trainer.load(path)
+            return _ensemble()
+
+        def f_save(path: str) -> None:
+            trainer.save(path)
+
+        def f_update(
+            context: TuneContext,
+            candidates: List[MeasureCandidate],
+            results: List[RunnerResult],
+        ) -> Optional[List[nd.NDArray]]:
+            trainer.update(context, candidates, results)
+            if trainer.booster is last["booster"]:
+                return None
+            return _ensemble()
+
+        self.__init_handle_by_constructor__(
+            _ffi_api.CostModelTreeEnsemble,  # type: ignore # pylint: disable=no-member
+            trainer.extractor,
+            f_load,
+            f_save,
+            f_update,
+        )
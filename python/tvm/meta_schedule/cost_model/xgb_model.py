@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """XGBoost-based cost model"""
+import json
 import os
 import tempfile
 from collections import OrderedDict
@@ -60,6 +61,56 @@ def make_metric_sorter(focused_metric):
     return sort_key
 
 
+def booster_tree_ensemble(booster: "xgb.Booster") -> List[np.ndarray]:
+    """Export an XGBoost booster as the flat tree ensemble predicted natively by the cost models.
+
+    Parameters
+    ----------
+    booster : xgb.Booster
+        The trained booster.
+
+    Returns
+    -------
+    ensemble : List[np.ndarray]
+        The nodes, values, roots and base score of the ensemble.
+    """
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        model_path = os.path.join(tmp_dir, "model.json")
+        booster.save_model(model_path)
+        with open(model_path, "r", encoding="utf-8") as i_f:
+            learner = json.load(i_f)["learner"]
+    # Recent XGBoost versions store the base score as a vector, e.g. "[5E-1]"
+    base_score = float(str(learner["learner_model_param"]["base_score"]).strip("[]"))
+    nodes, values, roots = [], [], []
+    num_nodes = 0
+    for tree in learner["gradient_booster"]["model"]["trees"]:
+        left = np.array(tree["left_children"], dtype="int32")
+        right = np.array(tree["right_children"], dtype="int32")
+        is_leaf = left == -1
+        missing = np.where(np.array(tree["default_left"], dtype=bool), left, right)
+        nodes.append(
+            np.stack(
+                [
+                    np.where(is_leaf, -1, np.array(tree["split_indices"], dtype="int32")),
+                    np.where(is_leaf, -1, left + num_nodes),
+                    np.where(is_leaf, -1, right + num_nodes),
+                    np.where(is_leaf, -1, missing + num_nodes),
+                ],
+                axis=1,
+            )
+        )
+        # The split conditions of the leaves are their values
+        values.append(np.array(tree["split_conditions"], dtype="float32"))
+        roots.append(num_nodes)
+        num_nodes += len(left)
+    return [
+        np.concatenate(nodes, axis=0).astype("int32"),
+        np.concatenate(values, axis=0),
+        np.array(roots, dtype="int32"),
+        np.array([base_score], dtype="float64"),
+    ]
+
+
 class PackSum:
     """The pack-sum format
 
@@ -582,6 +633,19 @@ class XGBModel(PyCostModel):
             )
         return ret.astype("float64")
 
+    def tree_ensemble(self) -> Optional[List[np.ndarray]]:
+        """Export the trained booster as the flat tree ensemble predicted by `TreeEnsembleModel`.
+
+        Returns
+        -------
+        ensemble : Optional[List[np.ndarray]]
+            The nodes, values, roots and base score of the ensemble, or None if the model is
+            still warming up.
+        """
+        if self.data_size < self.num_warmup_samples or self.booster is None:
+            return None
+        return booster_tree_ensemble(self.booster)
+
     def _train(  # type: ignore # pylint: disable=invalid-name
         self,
         xs: List[np.ndarray],
@@ -23,4 +23,5 @@ from .json_database import JSONDatabase
 from .memory_database import MemoryDatabase
 from .ordered_union_database import OrderedUnionDatabase
 from .schedule_fn_database import ScheduleFnDatabase
+from .sqlite_database import SQLiteDatabase
 from .union_database import UnionDatabase
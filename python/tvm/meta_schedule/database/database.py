@@ -383,6 +383,7 @@ class Database(Object):
                 "memory",
                 "union",
                 "ordered_union",
+                "sqlite",
             ],
             Callable[[Schedule], bool],
         ] = "json",
@@ -393,10 +394,10 @@ class Database(Object):
 
         Parameters
         ----------
-        kind : str = "json" | "memory" | "union" | "ordered_union" | Callable[[tvm.tir.Schedule],
-        bool]
+        kind : str = "json" | "memory" | "union" | "ordered_union" | "sqlite"
+            | Callable[[tvm.tir.Schedule], bool]
             The kind of the database to be created. The following kinds are supported:
-            "json", "memory", "union", "ordered_union", and a custom schedule function.
+            "json", "memory", "union", "ordered_union", "sqlite", and a custom schedule function.
 
         Returns
         -------
@@ -408,6 +409,7 @@ class Database(Object):
             MemoryDatabase,
             OrderedUnionDatabase,
             ScheduleFnDatabase,
+            SQLiteDatabase,
             UnionDatabase,
         )
 
@@ -421,6 +423,8 @@ class Database(Object):
             return UnionDatabase(*args, **kwargs)  # type: ignore
         if kind == "ordered_union":
             return OrderedUnionDatabase(*args, **kwargs)  # type: ignore
+        if kind == "sqlite":
+            return SQLiteDatabase(*args, **kwargs)  # type: ignore
         raise ValueError(f"Unknown Database: {kind}")
 
 
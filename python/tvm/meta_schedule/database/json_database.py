@@ -44,6 +44,10 @@ class JSONDatabase(Database):
                             given module. The "ignore-ndarray" varint is used for the extracted
                             blocks or in case no anchor block is found.
                             For the definition of the anchor block, see tir/analysis/analysis.py.
+    retention_top_k : Optional[int]
+        The number of fastest records kept per workload and target. If specified, invalid records
+        and duplicated traces are dropped as well, and the files are compacted on loading and
+        periodically on commit. If not specified, all the records are kept.
     """
 
     path_workload: str
@@ -57,6 +61,7 @@ class JSONDatabase(Database):
         work_dir: Optional[str] = None,
         allow_missing: bool = True,
         module_equality: str = "structural",
+        retention_top_k: Optional[int] = None,
     ) -> None:
         """Constructor.
 
@@ -73,6 +78,10 @@ class JSONDatabase(Database):
             and `path_workload`.
         allow_missing : bool
             Whether to create new file when the given path is not found.
+        module_equality : str
+            A string to specify the module equality testing and hashing method.
+        retention_top_k : Optional[int] = None
+            The number of fastest records kept per workload and target, or None to keep all.
         """
         if work_dir is not None:
             if path_workload is None:
@@ -83,10 +92,25 @@ class JSONDatabase(Database):
             raise ValueError("`path_workload` is not specified.")
         if path_tuning_record is None:
             raise ValueError("`path_tuning_record` is not specified.")
+        if retention_top_k is not None and retention_top_k < 0:
+            raise ValueError(f"`retention_top_k` must be non-negative, but got {retention_top_k}")
         self.__init_handle_by_constructor__(
             _ffi_api.DatabaseJSONDatabase,  # type: ignore # pylint: disable=no-member
             path_workload,
             path_tuning_record,
             allow_missing,
             module_equality,
+            -1 if retention_top_k is None else retention_top_k,
         )
+
+    def compact(self, top_k: int = -1) -> None:
+        """Drop invalid records, duplicated traces and, if `top_k` is non-negative, all but the
+        `top_k` fastest records of each workload and target, then rewrite the workload and tuning
+        record tables atomically to hold only the records kept.
+
+        Parameters
+        ----------
+        top_k : int
+            The number of records kept per workload and target, or -1 to keep all valid ones.
+        """
+        _ffi_api.JSONDatabaseCompact(self, top_k)  # type: ignore # pylint: disable=no-member
@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The database that uses an SQLite file to store workloads and tuning records"""
+import os.path as osp
+from typing import Optional
+
+from tvm._ffi import get_global_func, register_object
+
+from .database import Database
+
+
+class SQLiteDatabase(Database):
+    """Database class backed by an SQLite file, which concurrent tuning jobs can share.
+
+    Opening the database does not load its content. Workloads are parsed when they are
+    first looked up, and tuning records when they are queried; the top-K query of a
+    workload is served by an index. Writers of different processes wait for each other
+    up to `busy_timeout_ms`.
+
+    Requires TVM to be built with `USE_SQLITE=ON`.
+
+    Parameters
+    ----------
+    path : str
+        The path to the database file.
+    module_equality : Optional[str]
+        A string to specify the module equality testing and hashing method.
+        See :py:class:`JSONDatabase` for the supported methods.
+    """
+
+    path: str
+
+    def __init__(
+        self,
+        path: Optional[str] = None,
+        *,
+        work_dir: Optional[str] = None,
+        busy_timeout_ms: int = 60000,
+        module_equality: str = "structural",
+    ) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        path : Optional[str] = None
+            The path to the database file, created if it does not exist. If not specified,
+            will be generated from `work_dir` as `$work_dir/database.sqlite`.
+        work_dir : Optional[str] = None
+            The work directory, if specified, will be used to generate `path`.
+        busy_timeout_ms : int
+            How long to wait for the writers of other processes, in milliseconds.
+        """
+        if path is None and work_dir is not None:
+            path = osp.join(work_dir, "database.sqlite")
+        if path is None:
+            raise ValueError("`path` is not specified.")
+        constructor = get_global_func("meta_schedule.DatabaseSQLiteDatabase", allow_missing=True)
+        if constructor is None:
+            raise RuntimeError("SQLiteDatabase requires TVM to be built with USE_SQLITE=ON")
+        self.__init_handle_by_constructor__(
+            constructor,
+            path,
+            busy_timeout_ms,
+            module_equality,
+        )
+
+
+# The object type only exists when TVM is built with USE_SQLITE=ON.
+if get_global_func("meta_schedule.DatabaseSQLiteDatabase", allow_missing=True) is not None:
+    register_object("meta_schedule.SQLiteDatabase")(SQLiteDatabase)
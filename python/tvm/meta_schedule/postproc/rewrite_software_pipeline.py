@@ -0,0 +1,35 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A postprocessor that software pipelines the packing and the computation of tiles on CPU"""
+
+from tvm._ffi.registry import register_object
+from .. import _ffi_api
+from .postproc import Postproc
+
+
+@register_object("meta_schedule.RewriteSoftwarePipeline")
+class RewriteSoftwarePipeline(Postproc):
+    """A postprocessor that software pipelines the loops packing tiles of their inputs before
+    computing on them, e.g. the cache reads added by MultiLevelTiling with `reuse_read`, so that
+    on CPUs the packing of the next tile overlaps with the computation on the current one.
+    The postprocessor does nothing on other targets.
+    """
+
+    def __init__(self) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.PostprocRewriteSoftwarePipeline,  # type: ignore # pylint: disable=no-member
+        )
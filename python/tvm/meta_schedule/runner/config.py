@@ -41,6 +41,21 @@ class EvaluatorConfig(NamedTuple):
         increase the number of runs to the given time (in ms) to reduce the measurement error.
     enable_cpu_cache_flush: bool
         Whether to flush the cache on CPU.
+    enable_device_cache_flush: bool
+        Whether to flush the caches of the device the candidate runs on before each repeat, on any
+        backend. On CPU it is the same as `enable_cpu_cache_flush`.
+    max_repeat: Optional[int]
+        The maximum number of repeats per set of arguments when repeating adaptively. If given,
+        the measurement is repeated in rounds of `repeat` until the 95% confidence interval of
+        the mean is within `target_rel_ci` of the mean, or `max_repeat` is reached.
+        None means exactly `repeat` repeats.
+    target_rel_ci: float
+        The target half-width of the 95% confidence interval relative to the mean,
+        used when `max_repeat` is given.
+    drift_threshold: Optional[float]
+        The relative difference between the mean of the first and the last third of the costs,
+        beyond which the device is considered throttled or contended during the measurement and
+        the candidate is measured again. None disables the detection.
 
     Note
     ----
@@ -52,6 +67,10 @@ class EvaluatorConfig(NamedTuple):
     repeat: int = 1
     min_repeat_ms: int = 100
     enable_cpu_cache_flush: bool = False
+    enable_device_cache_flush: bool = False
+    max_repeat: Optional[int] = None
+    target_rel_ci: float = 0.05
+    drift_threshold: Optional[float] = None
 
     @staticmethod
     def _normalized(config: Optional["EvaluatorConfig"]) -> "EvaluatorConfig":
@@ -62,7 +81,13 @@ class EvaluatorConfig(NamedTuple):
             repeat=config.repeat,
             min_repeat_ms=config.min_repeat_ms,
             enable_cpu_cache_flush=config.enable_cpu_cache_flush,
+            enable_device_cache_flush=config.enable_device_cache_flush,
+            max_repeat=config.max_repeat,
+            target_rel_ci=config.target_rel_ci,
+            drift_threshold=config.drift_threshold,
         )
+        if config.max_repeat is not None and config.max_repeat < config.repeat:
+            raise ValueError("EvaluatorConfig.max_repeat must be at least EvaluatorConfig.repeat")
         return config
 
 
@@ -81,6 +106,10 @@ class RPCConfig(NamedTuple):
         Timeout of the RPC session
     session_priority: int
         Priority of the RPC session
+    max_session_reuse: int
+        The number of measurements that one RPC session serves before reconnecting.
+        Reusing a session saves the tracker request and the handshake of each measurement,
+        but holds the device for longer. Defaults to 1, i.e. no reuse.
     """
 
     tracker_host: Optional[str] = None
@@ -88,6 +117,7 @@ class RPCConfig(NamedTuple):
     tracker_key: Optional[str] = None
     session_priority: int = 1
     session_timeout_sec: int = 10
+    max_session_reuse: int = 1
 
     def _sanity_check(self) -> None:
         err_str = (
@@ -100,6 +130,8 @@ class RPCConfig(NamedTuple):
             raise ValueError(err_str.format("tracker_port", "TVM_TRACKER_PORT"))
         if self.tracker_key is None:
             raise ValueError(err_str.format("tracker_key", "TVM_TRACKER_KEY"))
+        if self.max_session_reuse < 1:
+            raise ValueError("RPCConfig.max_session_reuse must be at least 1")
 
     @staticmethod
     def _normalized(config: Optional["RPCConfig"]) -> "RPCConfig":
@@ -116,6 +148,7 @@ class RPCConfig(NamedTuple):
             tracker_key=tracker_key,
             session_priority=config.session_priority,
             session_timeout_sec=config.session_timeout_sec,
+            max_session_reuse=config.max_session_reuse,
         )
         config._sanity_check()  # pylint: disable=protected-access
         return config
@@ -149,19 +182,27 @@ class RPCConfig(NamedTuple):
             )
         return tracker
 
-    def connect_server(self) -> rpc.RPCSession:
+    def connect_server(self, session_timeout_sec: Optional[float] = None) -> rpc.RPCSession:
         """Connect to the server
 
+        Parameters
+        ----------
+        session_timeout_sec : Optional[float]
+            The duration after which the server kills the session.
+            Defaults to `session_timeout_sec` of the config.
+
         Returns
         -------
         session : RPCSession
             The connected rpc session
         """
+        if session_timeout_sec is None:
+            session_timeout_sec = self.session_timeout_sec
         tracker = self.connect_tracker()
         session: rpc.RPCSession = tracker.request(
             key=self.tracker_key,
             priority=self.session_priority,
-            session_timeout=self.session_timeout_sec,
+            session_timeout=session_timeout_sec,
         )
         return session
 
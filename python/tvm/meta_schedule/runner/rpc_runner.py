@@ -17,8 +17,9 @@
 """RPC Runner"""
 import concurrent.futures
 import os.path as osp
+import time
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 
 from tvm.contrib.popen_pool import PopenPoolExecutor
 from tvm.rpc import RPCSession
@@ -288,6 +289,13 @@ class RPCRunner(PyRunner):
         logger.info("RPCRunner: max_workers = %d", max_workers)
         self.pool = PopenPoolExecutor(
             max_workers=max_workers,
+            # A reused session outlives the measurement, so the server-side session timeout
+            # no longer bounds each measurement. Bound it from the worker side instead.
+            timeout=(
+                self.rpc_config.session_timeout_sec
+                if self.rpc_config.max_session_reuse > 1
+                else None
+            ),
             initializer=initializer,
         )
         self._sanity_check()
@@ -381,35 +389,53 @@ def _worker_func(
                 f_cleanup(session, remote_path)
 
     with resource_handler():
-        # Step 1. Create session
-        with Profiler.timeit("RPCRunner/create_session"):
-            session = f_create_session(rpc_config)
-            device = session.device(dev_type=device_type, dev_id=0)
-        # Step 2. Upload the module
-        with Profiler.timeit("RPCRunner/upload_module"):
-            _, remote_path = osp.split(artifact_path)
-            local_path: str = artifact_path
-            rt_mod: Module = f_upload_module(session, local_path, remote_path)
-        # Step 3: Allocate input arguments
-        with Profiler.timeit("RPCRunner/alloc_argument"):
-            repeated_args: List[T_ARGUMENT_LIST] = f_alloc_argument(
-                session,
-                device,
-                args_info,
-                alloc_repeat,
-            )
-        # Step 4: Run time_evaluator
-        with Profiler.timeit("LocalRunner/run_evaluator"):
-            costs: List[float] = f_run_evaluator(
-                session,
-                rt_mod,
-                device,
-                evaluator_config,
-                repeated_args,
-            )
+        try:
+            # Step 1. Create session
+            with Profiler.timeit("RPCRunner/create_session"):
+                session = f_create_session(rpc_config)
+                device = session.device(dev_type=device_type, dev_id=0)
+            # Step 2. Upload the module
+            with Profiler.timeit("RPCRunner/upload_module"):
+                _, remote_path = osp.split(artifact_path)
+                local_path: str = artifact_path
+                rt_mod: Module = f_upload_module(session, local_path, remote_path)
+            # Step 3: Allocate input arguments
+            with Profiler.timeit("RPCRunner/alloc_argument"):
+                repeated_args: List[T_ARGUMENT_LIST] = f_alloc_argument(
+                    session,
+                    device,
+                    args_info,
+                    alloc_repeat,
+                )
+            # Step 4: Run time_evaluator
+            with Profiler.timeit("LocalRunner/run_evaluator"):
+                costs: List[float] = f_run_evaluator(
+                    session,
+                    rt_mod,
+                    device,
+                    evaluator_config,
+                    repeated_args,
+                )
+        except Exception:
+            # The session may be left in a bad state, do not reuse it.
+            _SESSION_POOL.pop(_session_pool_key(rpc_config), None)
+            raise
     return costs
 
 
+# The RPC sessions kept alive in this worker process, see RPCConfig.max_session_reuse.
+# Each entry is (session, number of remaining uses, deadline of the server-side timeout).
+_SESSION_POOL: Dict[Tuple, Tuple[RPCSession, int, float]] = {}
+
+
+def _session_pool_key(rpc_config: RPCConfig) -> Tuple:
+    return (rpc_config.tracker_host, rpc_config.tracker_port, rpc_config.tracker_key)
+
+
+def _is_pooled_session(session: RPCSession) -> bool:
+    return any(entry[0] is session for entry in _SESSION_POOL.values())
+
+
 def default_create_session(rpc_config: RPCConfig) -> RPCSession:
     """Default function to create the session
 
@@ -423,7 +449,22 @@ def default_create_session(rpc_config: RPCConfig) -> RPCSession:
     session : RPCSession
         The created rpc session
     """
-    return rpc_config.connect_server()
+    if rpc_config.max_session_reuse <= 1:
+        return rpc_config.connect_server()
+    key = _session_pool_key(rpc_config)
+    now = time.time()
+    if key in _SESSION_POOL:
+        session, uses_left, deadline = _SESSION_POOL[key]
+        # Make sure the server does not kill the session during this measurement.
+        if uses_left > 0 and now + rpc_config.session_timeout_sec < deadline:
+            _SESSION_POOL[key] = (session, uses_left - 1, deadline)
+            return session
+        del _SESSION_POOL[key]
+    # Let the server reclaim the device if the worker dies, after all uses have had their time.
+    lifetime = rpc_config.session_timeout_sec * rpc_config.max_session_reuse
+    session = rpc_config.connect_server(session_timeout_sec=lifetime)
+    _SESSION_POOL[key] = (session, rpc_config.max_session_reuse - 1, now + lifetime)
+    return session
 
 
 def default_upload_module(
@@ -531,4 +572,6 @@ def default_cleanup(
     if session is not None and remote_path is not None:
         session.remove(remote_path)
         session.remove(remote_path + ".so")
-        session.remove("")
+        # A pooled session keeps using its working directory.
+        if not _is_pooled_session(session):
+            session.remove("")
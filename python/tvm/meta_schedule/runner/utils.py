@@ -16,6 +16,7 @@
 # under the License.
 """Runner utility functions"""
 import itertools
+import math
 from typing import Any, Callable, Dict, List
 
 from ...runtime import Device, Module, ndarray
@@ -101,20 +102,72 @@ def run_evaluator_common(
     costs: List[float]
         The evaluator results
     """
+    if evaluator_config.enable_device_cache_flush:
+        f_preproc = "cache_flush_device"
+    elif evaluator_config.enable_cpu_cache_flush:
+        f_preproc = "cache_flush_cpu_non_first_arg"
+    else:
+        f_preproc = ""
     evaluator = rt_mod.time_evaluator(
         func_name=rt_mod.entry_name,
         dev=device,
         number=evaluator_config.number,
         repeat=evaluator_config.repeat,
         min_repeat_ms=evaluator_config.min_repeat_ms,
-        f_preproc="cache_flush_cpu_non_first_arg"
-        if evaluator_config.enable_cpu_cache_flush
-        else "",
+        f_preproc=f_preproc,
     )
-    repeated_costs: List[List[float]] = []
-    for args in repeated_args:
-        device.sync()
-        profile_result = evaluator(*args)
-        repeated_costs.append(profile_result.results)
-    costs = [float(cost) for cost in itertools.chain.from_iterable(repeated_costs)]
+
+    def measure_round() -> List[float]:
+        repeated_costs: List[List[float]] = []
+        for args in repeated_args:
+            device.sync()
+            profile_result = evaluator(*args)
+            repeated_costs.append(profile_result.results)
+        return [float(cost) for cost in itertools.chain.from_iterable(repeated_costs)]
+
+    def measure() -> List[float]:
+        costs = measure_round()
+        if evaluator_config.max_repeat is None:
+            return costs
+        max_costs = evaluator_config.max_repeat * len(repeated_args)
+        while (
+            len(costs) < max_costs
+            and _relative_confidence_interval(costs) > evaluator_config.target_rel_ci
+        ):
+            costs.extend(measure_round())
+        return costs
+
+    costs = measure()
+    if evaluator_config.drift_threshold is not None:
+        for _ in range(_MAX_REMEASURE):
+            if not _has_drift(costs, evaluator_config.drift_threshold):
+                break
+            costs = measure()
     return costs
+
+
+# The number of times a candidate is measured again when its costs drift
+_MAX_REMEASURE = 2
+
+
+def _relative_confidence_interval(costs: List[float]) -> float:
+    """The half-width of the 95% confidence interval of the mean, relative to the mean"""
+    n = len(costs)
+    if n < 2:
+        return math.inf
+    mean = sum(costs) / n
+    if mean <= 0.0:
+        return math.inf
+    var = sum((cost - mean) ** 2 for cost in costs) / (n - 1)
+    return 1.96 * math.sqrt(var / n) / mean
+
+
+def _has_drift(costs: List[float], threshold: float) -> bool:
+    """Whether the costs drift during the measurement, e.g. because of thermal throttling or
+    contention on the device, by comparing the first third of the costs against the last third"""
+    k = len(costs) // 3
+    if k == 0:
+        return False
+    head = sum(costs[:k]) / k
+    tail = sum(costs[-k:]) / k
+    return abs(tail - head) > threshold * min(head, tail)
@@ -33,4 +33,6 @@ from .multi_level_tiling import (
 )
 from .parallel_vectorize_unroll import ParallelizeVectorizeUnroll
 from .random_compute_location import RandomComputeLocation
+from .software_prefetch import SoftwarePrefetch
+from .split_k import SplitK
 from .schedule_rule import PyScheduleRule, ScheduleRule
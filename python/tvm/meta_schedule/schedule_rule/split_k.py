@@ -0,0 +1,56 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Rules which apply cross-thread reduction to some reduction blocks correspondingly when needed"""
+from typing import List
+"""Split-K rule that splits the reduction of skinny GEMM-like blocks across thread blocks"""
+from typing import List
+
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.SplitK")
+class SplitK(ScheduleRule):
+    """A schedule rule which splits the reduction of skinny GEMM-like blocks on GPU, e.g. the
+    projections of LLM decoding, into partial sums computed by separate thread blocks. The partial
+    sums are computed by a new block tiled by `tiling`, and reduced by the original block, into
+    whose loop nest the elementwise epilogue is fused.
+
+    Parameters
+    ----------
+    split_factors: List[int]
+        Candidates of the number of splits (values are required to be larger than 1).
+    max_spatial_extent: int
+        The largest spatial extent of the blocks that are split.
+    tiling: ScheduleRule
+        The rule tiling the block that computes the partial sums.
+    """
+
+    def __init__(
+        self,
+        split_factors: List[int],
+        max_spatial_extent: int,
+        tiling: ScheduleRule,
+    ) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleSplitK,  # type: ignore # pylint: disable=no-member
+            split_factors,
+            max_spatial_extent,
+            tiling,
+        )
@@ -45,6 +45,10 @@ class EvolutionarySearch(SearchStrategy):
         The maximum number to retry mutation.
     eps_greedy : float
         The ratio of greedy selected samples in the final picks.
+    init_transferred_ratio : float
+        The ratio of samples in the initial population transferred from the records of workloads of
+        the same structure but of different shapes, which are also used to pretrain the cost model.
+        Zero disables the warm start from similar workloads.
     """
 
     population_size: int
@@ -54,6 +58,7 @@ class EvolutionarySearch(SearchStrategy):
     genetic_mutate_prob: float
     genetic_max_fail_count: int
     eps_greedy: float
+    init_transferred_ratio: float
 
     def __init__(
         self,
@@ -66,6 +71,7 @@ class EvolutionarySearch(SearchStrategy):
         genetic_mutate_prob: float = 0.85,
         genetic_max_fail_count: int = 10,
         eps_greedy: float = 0.05,
+        init_transferred_ratio: float = 0.0,
     ) -> None:
         """Constructor"""
         self.__init_handle_by_constructor__(
@@ -78,4 +84,5 @@ class EvolutionarySearch(SearchStrategy):
             genetic_mutate_prob,
             genetic_max_fail_count,
             eps_greedy,
+            init_transferred_ratio,
         )
@@ -34,6 +34,8 @@ class GradientBased(TaskScheduler):
         alpha: float = 0.2,
         window_size: int = 3,
         seed: int = -1,
+        early_stop_rounds: int = 0,
+        early_stop_min_improvement: float = 0.01,
     ) -> None:
         """Constructor.
 
@@ -45,6 +47,12 @@ class GradientBased(TaskScheduler):
             The parameter to control backward window size in gradient computation.
         seed : int = -1
             The random seed.
+        early_stop_rounds : int = 0
+            The number of rounds without improvement after which a task is retired early, so that
+            its share of the global trial budget goes to the other tasks. 0 disables early stopping.
+        early_stop_min_improvement : float = 0.01
+            The relative improvement of the best latency over `early_stop_rounds` rounds below
+            which a task is considered converged.
         """
         self.__init_handle_by_constructor__(
             _ffi_api.TaskSchedulerGradientBased,  # type: ignore # pylint: disable=no-member
@@ -52,4 +60,6 @@ class GradientBased(TaskScheduler):
             alpha,
             window_size,
             seed,
+            early_stop_rounds,
+            early_stop_min_improvement,
         )
@@ -62,6 +62,7 @@ class TaskScheduler(Object):
     database_: Optional[Database]
     cost_model_: Optional[CostModel]
     remaining_tasks_: int
+    max_inflight_batches: int
 
     TaskSchedulerType = Union["TaskScheduler", Literal["gradient", "round-robin"]]
 
@@ -163,6 +164,20 @@ class TaskScheduler(Object):
         """
         _ffi_api.TaskSchedulerTouchTask(self, task_id)  # type: ignore # pylint: disable=no-member
 
+    def set_max_inflight_batches(self, max_inflight_batches: int) -> None:
+        """Set the maximum number of measurement batches in flight across tasks.
+
+        With more than one, the batches are built on a background thread while the next ones are
+        generated, and the database and the cost model may miss the results of up to this many
+        batches when new candidates are generated.
+
+        Parameters
+        ----------
+        max_inflight_batches : int
+            The maximum number of batches in flight, 1 to measure each batch synchronously.
+        """
+        _ffi_api.TaskSchedulerSetMaxInflightBatches(self, max_inflight_batches)  # type: ignore # pylint: disable=no-member
+
     def print_tuning_statistics(self) -> None:
         """Print out a human-readable format of the tuning statistics."""
         return _ffi_api.TaskSchedulerPrintTuningStatistics(self)  # type: ignore # pylint: disable=no-member
@@ -37,3 +37,18 @@ def schedule_using_anchor_trace(sch: Schedule, anchor_trace: Trace, target: Targ
         The compilation target
     """
     _ffi_api.ScheduleUsingAnchorTrace(sch, anchor_trace, target)  # type: ignore
+
+
+def apply_trace_across_shapes(sch: Schedule, trace: Trace) -> None:
+    """Apply a trace tuned on a workload of the same structure but of different shapes. The
+    sampled tile sizes that no longer divide the loop extents are refitted, keeping every inner
+    factor as large as possible without exceeding its original value.
+
+    Parameters
+    ----------
+    sch : Schedule
+        The target schedule
+    trace: Trace
+        The trace tuned on the other workload
+    """
+    _ffi_api.ApplyTraceAcrossShapes(sch, trace)  # type: ignore
@@ -41,6 +41,7 @@ def tune_tasks(
     measure_callbacks: MeasureCallback.CallbackListType = "default",
     task_scheduler: TaskScheduler.TaskSchedulerType = "gradient",
     module_equality: str = "structural",
+    max_inflight_batches: int = 1,
 ) -> Database:
     """Tune a list of tasks. Using a task scheduler.
 
@@ -81,6 +82,10 @@ def tune_tasks(
                 a given module. The "ignore-ndarray" varint is used for the extracted blocks or in
                 case no anchor block is found. For the definition of the anchor block, see
                 tir/analysis/analysis.py.
+    max_inflight_batches : int
+        The maximum number of measurement batches in flight across tasks. With more than one, the
+        next batches are generated while the earlier ones are built and run, at the cost of the
+        cost model and the database lagging behind by up to this many batches.
 
     Returns
     -------
@@ -115,6 +120,7 @@ def tune_tasks(
         measure_callbacks = MeasureCallback.create(measure_callbacks)
     if not isinstance(task_scheduler, TaskScheduler):
         task_scheduler = TaskScheduler.create(task_scheduler)
+    task_scheduler.set_max_inflight_batches(max_inflight_batches)
     task_scheduler.tune(
         tasks=tasks,
         task_weights=task_weights,
@@ -115,4 +115,6 @@ from . import utils
 # VM
 from .vm_build import build, Executable
 
+from .param_cache import cached_transform_params, transform_params_key
+
 from .binding_rewrite import DataflowBlockRewrite
@@ -18,6 +18,7 @@
 
 from .transform import (
     PropagateSharding,
+    PlanSharding,
     LowerGlobalViewToLocalView,
     LegalizeRedistribute,
     LowerDistIR,
@@ -32,6 +32,45 @@ def PropagateSharding() -> tvm.ir.transform.Pass:
     return _ffi_api.PropagateSharding()  # type: ignore
 
 
+def PlanSharding(
+    mesh_index: int = 0,
+    device_flops: float = 1e14,
+    link_bandwidth: float = 1e11,
+    link_latency: float = 1e-5,
+) -> tvm.ir.transform.Pass:
+    """Plan the tensor-parallel sharding of the functions without sharding annotations.
+
+    The matmuls by weights are grouped in the Megatron style, a row-parallel matmul with the
+    column-parallel matmuls producing its input through elementwise ops. A group is sharded if
+    splitting its computation across the devices saves more time than the allreduce of its
+    output costs. The plan is emitted as sharding annotations on the weights, to be propagated
+    by PropagateSharding.
+
+    Parameters
+    ----------
+    mesh_index : int
+        The index of the device mesh in the "mesh" global infos of the module. The weights are
+        split across the first axis of the mesh.
+
+    device_flops : float
+        The throughput of each device, in flop/s.
+
+    link_bandwidth : float
+        The bandwidth of each link between the devices, in bytes/s.
+
+    link_latency : float
+        The latency of each link between the devices, in seconds.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    return _ffi_api.PlanSharding(  # type: ignore
+        mesh_index, device_flops, link_bandwidth, link_latency
+    )
+
+
 def LowerGlobalViewToLocalView() -> tvm.ir.transform.Pass:
     """Lower global view TIR to local view
 
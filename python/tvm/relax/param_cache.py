@@ -0,0 +1,144 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A persistent cache of the parameters transformed by the functions that LiftTransformParams
+lifts, so that pre-packed weights are loaded directly instead of re-packed at each start."""
+import hashlib
+import os
+import uuid
+from typing import Callable, List, Optional, Union
+
+import tvm
+from tvm.ir import IRModule
+from tvm.runtime import Device, NDArray
+from tvm.runtime.params import load_param_dict_chunked, save_param_dict_chunked
+
+from . import analysis
+from .expr import Function
+
+
+def transform_params_key(
+    mod: IRModule, func_name: str, target: Union[str, tvm.target.Target]
+) -> str:
+    """Compute the key of a parameter transformation function for the cache.
+
+    The key covers the function, every function it calls transitively, the target and the version
+    of TVM, so that it changes whenever the transformed parameters could.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module containing the transformation function, as given to `relax.build`.
+    func_name : str
+        The name of the transformation function, e.g. `main_transform_params`.
+    target : Union[str, tvm.target.Target]
+        The target that the module is built for.
+
+    Returns
+    -------
+    key : str
+        The key of the transformation function.
+    """
+    hasher = hashlib.sha256()
+    hasher.update(tvm.__version__.encode())
+    hasher.update(str(tvm.target.Target(target)).encode())
+    visited = set()
+    stack = [mod.get_global_var(func_name)]
+    while stack:
+        gvar = stack.pop()
+        if gvar.name_hint in visited:
+            continue
+        visited.add(gvar.name_hint)
+        func = mod[gvar]
+        hasher.update(gvar.name_hint.encode())
+        hasher.update(str(tvm.ir.structural_hash(func)).encode())
+        if isinstance(func, Function):
+            stack.extend(gv for gv in analysis.all_global_vars(func) if gv in mod.get_global_vars())
+    return hasher.hexdigest()
+
+
+def _fingerprint_params(params: List[NDArray]) -> str:
+    hasher = hashlib.sha256()
+    for param in params:
+        hasher.update(f"{param.dtype}{tuple(param.shape)}".encode())
+        hasher.update(param.numpy().tobytes())
+    return hasher.hexdigest()
+
+
+def cached_transform_params(
+    ftransform: Callable,
+    params: List[NDArray],
+    cache_dir: str,
+    transform_key: str,
+    params_key: Optional[str] = None,
+    device: Optional[Device] = None,
+) -> List[NDArray]:
+    """Transform the parameters, or load them from the cache if they were transformed before.
+
+    The entries of the cache are files in the chunked parameter format, whose checksums are
+    verified on load. An entry that fails to load is treated as a miss and overwritten. Entries
+    are written to a temporary file and renamed, so that processes sharing a cache directory
+    never observe a partial entry.
+
+    Parameters
+    ----------
+    ftransform : Callable
+        The parameter transformation function, e.g. `vm["main_transform_params"]`, taking the
+        parameters and returning the transformed ones.
+    params : List[NDArray]
+        The parameters to transform.
+    cache_dir : str
+        The directory of the cache, created if missing.
+    transform_key : str
+        The key of the transformation function, see :py:func:`transform_params_key`.
+    params_key : Optional[str]
+        The fingerprint of the parameters, e.g. the checksum of the checkpoint they are loaded
+        from. By default the contents of the parameters are hashed, which still reads every byte
+        but is much cheaper than packing them.
+    device : Optional[Device]
+        The device to load the cached parameters to, the device of the first parameter by default.
+
+    Returns
+    -------
+    transformed : List[NDArray]
+        The transformed parameters.
+    """
+    if params_key is None:
+        params_key = _fingerprint_params(params)
+    if device is None:
+        device = params[0].device if params else tvm.cpu()
+    entry = hashlib.sha256(f"{transform_key}:{params_key}".encode()).hexdigest()
+    path = os.path.join(cache_dir, entry + ".params")
+    if os.path.exists(path):
+        try:
+            cached = load_param_dict_chunked(path, device=device)
+            return [cached[str(i)] for i in range(len(cached))]
+        except (tvm.TVMError, KeyError):
+            pass
+    transformed = ftransform(params)
+    if isinstance(transformed, NDArray):
+        transformed = [transformed]
+    transformed = list(transformed)
+    # A failure to write the cache never fails the transformation
+    tmp_path = f"{path}.tmp{uuid.uuid4().hex}"
+    try:
+        os.makedirs(cache_dir, exist_ok=True)
+        save_param_dict_chunked({str(i): param for i, param in enumerate(transformed)}, tmp_path)
+        os.replace(tmp_path, path)
+    except (OSError, tvm.TVMError):
+        if os.path.exists(tmp_path):
+            os.remove(tmp_path)
+    return transformed
@@ -27,6 +27,7 @@ from .transform import (
     BundleModelParams,
     CallTIRRewrite,
     CanonicalizeBindings,
+    CheckpointActivations,
     CombineParallelMatmul,
     ComputePrimValue,
     ConvertLayout,
@@ -47,6 +48,7 @@ from .transform import (
     FuseTIR,
     FusionPattern,
     Gradient,
+    HorizontalFuseTIR,
     InlinePrivateFunctions,
     KillAfterLastUse,
     LambdaLift,
@@ -61,7 +63,9 @@ from .transform import (
     MetaScheduleTuneTIR,
     Normalize,
     NormalizeGlobalVar,
+    OverlapCollectives,
     PatternCheckContext,
+    PrefetchLazyInput,
     RealizeVDevice,
     RemovePurityChecking,
     RemoveUnusedParameters,
@@ -71,6 +75,7 @@ from .transform import (
     RewriteCUDAGraph,
     RewriteDataflowReshape,
     RunCodegen,
+    SpecializeShapeBuckets,
     SplitCallTIRByPattern,
     StaticPlanBlockMemory,
     ToMixedPrecision,
@@ -78,15 +83,18 @@ from .transform import (
     TopologicalSort,
     UpdateParamStructInfo,
     UpdateVDevice,
+    UseInplaceCalls,
     VMBuiltinLower,
     VMShapeLower,
     dataflowblock_pass,
     function_pass,
+    select_shape_buckets,
 )
 
 from .ipc_allreduce_rewrite import IPCAllReduceRewrite
 from .lazy_transform_params import LazyTransformParams
 from .lower_gpu_ipc_alloc_storage import LowerGPUIPCAllocStorage
+from .mixed_precision import calibrate_mixed_precision
 from .optimize_layout_transform import OptimizeLayoutTransform
 from .remove_redundant_reshape import RemoveRedundantReshape
 from .fast_math import FastMathTransform
@@ -0,0 +1,140 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Calibration of the mixed precision policies of ToMixedPrecision on sample data."""
+from typing import Callable, Dict, List, Optional, Sequence, Union
+
+import numpy as np
+
+import tvm
+from tvm import relax
+from tvm.ir import IRModule, Op
+from tvm.runtime import Device, NDArray
+
+from .transform import ToMixedPrecision
+
+
+def _flatten_outputs(value) -> List[np.ndarray]:
+    if isinstance(value, NDArray):
+        return [value.numpy()]
+    if isinstance(value, (tvm.runtime.container.ADT, tvm.ir.container.Array, list, tuple)):
+        return [out for field in value for out in _flatten_outputs(field)]
+    return []
+
+
+def _relative_error(outputs: List[np.ndarray], expected: List[np.ndarray]) -> float:
+    error = 0.0
+    for out, ref in zip(outputs, expected):
+        ref = ref.astype("float64")
+        diff = np.linalg.norm(out.astype("float64") - ref)
+        error = max(error, diff / max(np.linalg.norm(ref), np.finfo("float64").tiny))
+    return error
+
+
+def _candidate_vars(func: relax.Function) -> List[str]:
+    """The names of the vars bound to ops that ToMixedPrecision may run in low precision."""
+    names = []
+    if not isinstance(func.body, relax.SeqExpr):
+        return names
+    for block in func.body.blocks:
+        if not isinstance(block, relax.DataflowBlock):
+            continue
+        for binding in block.bindings:
+            value = binding.value
+            if not isinstance(binding, relax.VarBinding) or not isinstance(value, relax.Call):
+                continue
+            if not isinstance(value.op, Op) or value.op.name == "relax.wrap_param":
+                continue
+            # kAlways (0) and kFollow (1), the kNever ops are in fp32 anyway
+            if value.op.get_attr("TMixedPrecisionPolicy") in (0, 1):
+                names.append(binding.var.name_hint)
+    return names
+
+
+def calibrate_mixed_precision(
+    mod: IRModule,
+    inputs: Sequence[Union[np.ndarray, NDArray]],
+    func_name: str = "main",
+    out_dtype: str = "float32",
+    matmul_dtype: Optional[str] = None,
+    rtol: float = 1e-2,
+    target: Union[str, tvm.target.Target] = "llvm",
+    dev: Optional[Device] = None,
+    fbuild: Optional[Callable[[IRModule], "relax.Executable"]] = None,
+) -> List[str]:
+    """Find the ops of a function that must stay in fp32 for ToMixedPrecision to meet an accuracy
+    budget on sample data.
+
+    Each op that ToMixedPrecision may run in low precision is first run in low precision alone,
+    with every other op in fp32, and the relative error of the function outputs against the fp32
+    outputs is measured. The ops whose error exceeds the budget are kept in fp32. If the error of
+    converting all the other ops together still exceeds the budget, the remaining ops are kept in
+    fp32 too, from the largest error down, until the budget is met.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The fp32 module. The function must be in dataflow form, see ConvertToDataflow.
+    inputs : Sequence[Union[np.ndarray, NDArray]]
+        The sample inputs of the function.
+    func_name : str
+        The name of the function to calibrate.
+    out_dtype : str
+        The accumulator dtype, as in ToMixedPrecision.
+    matmul_dtype : Optional[str]
+        The input dtype of the matmuls, as in ToMixedPrecision.
+    rtol : float
+        The budget of the relative L2 error of every output of the function.
+    target : Union[str, tvm.target.Target]
+        The target that the module is built for when fbuild is not given.
+    dev : Optional[Device]
+        The device that the module runs on, the CPU by default.
+    fbuild : Optional[Callable[[IRModule], relax.Executable]]
+        The function building a module, `relax.build(mod, target)` by default. It can be used to
+        schedule the kernels, e.g. for GPU targets.
+
+    Returns
+    -------
+    fp32_var_names : List[str]
+        The names of the vars whose bound ops should stay in fp32, to be given to ToMixedPrecision.
+    """
+    dev = tvm.cpu() if dev is None else dev
+    fbuild = (lambda m: relax.build(m, target)) if fbuild is None else fbuild
+    inputs = [tvm.nd.array(x, dev) if isinstance(x, np.ndarray) else x for x in inputs]
+
+    def run(m: IRModule) -> List[np.ndarray]:
+        vm = relax.VirtualMachine(fbuild(m), dev)
+        return _flatten_outputs(vm[func_name](*inputs))
+
+    expected = run(mod)
+    candidates = _candidate_vars(mod[func_name])
+
+    def measure(fp32_var_names: List[str]) -> float:
+        converted = ToMixedPrecision(out_dtype, None, fp32_var_names, matmul_dtype)(mod)
+        return _relative_error(run(converted), expected)
+
+    # Step 1. The error of converting each op alone
+    errors: Dict[str, float] = {}
+    for name in candidates:
+        errors[name] = measure([other for other in candidates if other != name])
+    fp32_var_names = [name for name in candidates if errors[name] > rtol]
+    # Step 2. Keep the ops of the largest errors in fp32, until all the others meet the budget
+    remaining = sorted(
+        (name for name in candidates if name not in fp32_var_names), key=lambda n: -errors[n]
+    )
+    while remaining and measure(fp32_var_names) > rtol:
+        fp32_var_names.append(remaining.pop(0))
+    return [name for name in candidates if name in fp32_var_names]
@@ -224,6 +224,31 @@ def Gradient(
     return _ffi_api.Gradient(func_name, require_grads, target_index)  # type: ignore
 
 
+def CheckpointActivations(func_name: str, memory_budget: int) -> tvm.ir.transform.Pass:
+    """Select the activations of a function that Gradient recomputes in the backward pass
+    instead of keeping them alive, so that the kept activations fit in a memory budget.
+
+    The activations freeing the most bytes per recomputed FLOP are selected first, where the
+    FLOPs are estimated on the PrimFuncs that the operators are legalized to. The selection is
+    marked with `relax.op.grad.start_checkpoint` and `relax.op.grad.end_checkpoint`, so the pass
+    is to be applied before Gradient. Functions already marked by hand are left unchanged.
+
+    Parameters
+    ----------
+    func_name : str
+        The name of the function to be differentiated. It must have only one dataflow block.
+
+    memory_budget : int
+        The number of bytes that the kept activations may take.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+        The Pass.
+    """
+    return _ffi_api.CheckpointActivations(func_name, memory_budget)  # type: ignore
+
+
 def ToNonDataflow() -> tvm.ir.transform.Pass:
     """Transform all dataflow structure to non-dataflow version.
 
@@ -294,6 +319,33 @@ def DataflowUseInplaceCalls() -> tvm.ir.transform.Pass:
     return _ffi_api.DataflowUseInplaceCalls()
 
 
+def UseInplaceCalls(inplace_packed_funcs: Optional[List[str]] = None) -> tvm.ir.transform.Pass:
+    """
+    Pass that changes calls that can be done in-place into in-place implementations,
+    like DataflowUseInplaceCalls, but with the liveness and aliases analyzed across
+    whole functions instead of single dataflow blocks.
+
+    Besides the operators supported by DataflowUseInplaceCalls, the `call_tir` of
+    elementwise PrimFuncs and the `call_dps_packed` of the packed functions in
+    `inplace_packed_funcs` are replaced by calls to `call_tir_inplace`, writing their
+    result over an argument of the same shape that is no longer live. The kills inserted
+    by KillAfterLastUse are not considered as uses.
+
+    Parameters
+    ----------
+    inplace_packed_funcs: Optional[List[str]]
+        The packed functions that may write their output over any of their inputs of the
+        same shape. They are called through PrimFuncs passing the overwritten input as the
+        output, so their arguments must be tensors of static shapes.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The pass
+    """
+    return _ffi_api.UseInplaceCalls(inplace_packed_funcs or [])  # type: ignore
+
+
 def LambdaLift() -> tvm.ir.transform.Pass:
     """A pass that lifts local functions into global.
 
@@ -384,6 +436,62 @@ def LazySetOutput() -> tvm.ir.transform.Pass:
     return _ffi_api.LazySetOutput()
 
 
+def PrefetchLazyInput(
+    runtime_device_index: int = 0, group_bytes: int = 1 << 30
+) -> tvm.ir.transform.Pass:
+    """A pass that streams the lazily requested inputs to the device.
+
+    After LazyGetInput, the execution stalls on every parameter that
+    is requested.  This pass packs the parameters requested at the top
+    level of a function into groups of at most `group_bytes` bytes, in
+    the order of their requests.  The groups are copied into two
+    device buffers used in turn, and the group after the one in use is
+    copied while the current one is computed.  So a model larger than
+    the device memory runs with two groups of parameters on the device
+    at any time.
+
+    A parameter still in use when the next group is waited for, or of
+    a dynamic shape, is requested as before.  For the copies to overlap
+    with the computation, the callback should return the parameters in
+    pinned host memory.
+
+    .. code-block:: python
+
+        @R.function
+        def before(fget_param: R.Callable([R.Prim('int64'), R.Object], R.Object)):
+            A_untyped = fget_param(0, R.str('A'))
+            A = R.match_cast(A_untyped, R.Tensor([16,32], "float32"))
+            ...
+
+        @R.function(pure=False)
+        def after(fget_param: R.Callable([R.Prim('int64'), R.Object], R.Object)):
+            param_stream = R.call_builtin_with_ctx(
+                "vm.builtin.param_stream_create",
+                (fget_param, R.prim_value(0), R.shape([2048])),
+                sinfo_args=R.Object,
+            )
+            R.call_packed("vm.builtin.param_stream_prefetch", param_stream, 0, 0, R.str("A"), 0)
+            R.call_packed("vm.builtin.param_stream_wait", param_stream)
+            A_untyped = R.call_packed("vm.builtin.param_stream_get", param_stream, 0)
+            A = R.match_cast(A_untyped, R.Tensor([16,32], "float32"))
+            ...
+
+    Parameters
+    ----------
+    runtime_device_index : int
+        The index of the device in the VM that the parameters are streamed to.
+
+    group_bytes : int
+        The largest number of bytes of a group of parameters.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+
+    """
+    return _ffi_api.PrefetchLazyInput(runtime_device_index, group_bytes)  # type: ignore
+
+
 def ConvertToDataflow(min_size: int = 2) -> tvm.ir.transform.Pass:
     """A pass that converts consecutive dataflow operations
     inside binding blocks into dataflow blocks.
@@ -404,6 +512,21 @@ def ConvertToDataflow(min_size: int = 2) -> tvm.ir.transform.Pass:
     return _ffi_api.ConvertToDataflow(min_size)
 
 
+def OverlapCollectives() -> tvm.ir.transform.Pass:
+    """Reorder the pure bindings so that the collectives start as early as possible and their
+    consumers come as late as possible, after all the computation independent of them.
+
+    Outside of the dataflow blocks, the legalized allreduce and allgather are moreover started
+    asynchronously on the communication stream of disco, and waited for right before their first
+    consumer. The pass should hence be used after ToNonDataflow and before CallTIRRewrite.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.OverlapCollectives()  # type: ignore
+
+
 def CallTIRRewrite() -> tvm.ir.transform.Pass:
     """Perform explicit tensor allocation for call_tir and call_dps_packed.
 
@@ -530,6 +653,15 @@ def StaticPlanBlockMemory() -> tvm.ir.transform.Pass:
     signature will have upper bound 1024. And we will use 1024 as its value
     during memory planning.
 
+    When the pass config "relax.memory_plan_arena" is set, the constant-sized
+    tensors of "global" scope are not planned by reusing whole storages.
+    Instead, each binding block gets one arena per device, inside which the
+    tensors are placed at byte offsets so that the tensors alive at the same
+    time never overlap, and a small tensor can use the free part of a large one.
+    The branches of an If share a region of the arena of the enclosing block as
+    large as the largest of them, and the private functions are inlined into
+    their callers to allocate from the arenas of the callers.
+
     Returns
     -------
     ret : tvm.ir.transform.Pass
@@ -684,6 +816,70 @@ def BindSymbolicVars(
     return _ffi_api.BindSymbolicVars(binding_map, func_name)  # type: ignore
 
 
+def SpecializeShapeBuckets(buckets: Dict[str, List[Dict[str, int]]]) -> tvm.ir.transform.Pass:
+    """Specialize dynamic-shape functions for the hot values of their symbolic variables.
+
+    For each bucket of a function, a private copy is added with the symbolic variables of the
+    bucket bound to their values, so that its kernels can be static. The function itself is
+    replaced by a dispatcher with the same signature, which calls the copy whose bucket matches
+    the shapes of the arguments, or else a private copy of the generic function, named
+    `<func>_generic`.
+
+    This pass should be applied before LegalizeOps, so that the specialized copies have static
+    kernels. The buckets can be chosen from samples of the expected shapes with
+    :py:func:`select_shape_buckets`.
+
+    Parameters
+    ----------
+    buckets : Dict[str, List[Dict[str, int]]]
+        The buckets of each function, each a map from the names of the symbolic variables defined
+        by the parameters of the function to their values, in the order that they are checked.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.SpecializeShapeBuckets(buckets)  # type: ignore
+
+
+def select_shape_buckets(
+    samples: Sequence[Dict[str, int]], max_buckets: int = 4, min_coverage: float = 0.9
+) -> List[Dict[str, int]]:
+    """Select the hot shape buckets for SpecializeShapeBuckets from samples of the traffic.
+
+    The most frequent values of the symbolic variables are taken, until they cover `min_coverage`
+    of the samples or `max_buckets` are taken. The buckets are ordered by decreasing frequency,
+    so that the dispatcher checks the hottest first.
+
+    Parameters
+    ----------
+    samples : Sequence[Dict[str, int]]
+        The values of the symbolic variables observed, one map per call.
+    max_buckets : int
+        The maximum number of buckets.
+    min_coverage : float
+        The fraction of the samples that is enough for the buckets to cover.
+
+    Returns
+    -------
+    buckets : List[Dict[str, int]]
+        The buckets, for one function of SpecializeShapeBuckets.
+    """
+    counts: Dict[Tuple[Tuple[str, int], ...], int] = {}
+    for sample in samples:
+        key = tuple(sorted((name, int(value)) for name, value in sample.items()))
+        counts[key] = counts.get(key, 0) + 1
+    buckets = []
+    covered = 0
+    for key, count in sorted(counts.items(), key=lambda kv: -kv[1]):
+        if len(buckets) >= max_buckets or covered >= min_coverage * len(samples):
+            break
+        buckets.append(dict(key))
+        covered += count
+    return buckets
+
+
 def RunCodegen(
     target_options: Optional[dict] = None,
     entry_functions: Optional[List[str]] = None,
@@ -715,6 +911,9 @@ def RunCodegen(
 def FoldConstant() -> tvm.ir.transform.Pass:
     """Fold constant expressions within dataflow blocks.
 
+    The TIR functions of the foldable calls are built together into one module on the CPU,
+    and the calls are evaluated in dependency order.
+
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
     Returns
@@ -784,6 +983,11 @@ def FuseOps(fuse_opt_level=-1) -> tvm.ir.transform.Pass:
 
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
+    The fusion decisions can be guided by a cost estimator, given as the name of a registered
+    function by the pass config "relax.FuseOps.cost_estimator". The function takes the bindings
+    of a group and returns their estimated cost, and groups are only merged if the cost of the
+    merged group is no larger than the total cost of the groups being merged.
+
     Parameters
     ----------
     fuse_opt_level : int
@@ -809,6 +1013,22 @@ def FuseTIR() -> tvm.ir.transform.Pass:
     return _ffi_api.FuseTIR()  # type: ignore
 
 
+def HorizontalFuseTIR() -> tvm.ir.transform.Pass:
+    """Pack the independent call_tir of small GPU kernels in a dataflow block into one kernel
+    launch, saving the launch overhead of each of them.
+
+    The kernels must be scheduled PrimFuncs whose body is a single loop bound to blockIdx.x, and
+    the kernels packed together must use the same threadIdx extents. The packed kernel runs each
+    original kernel on its own range of blockIdx.x.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for horizontal fusion.
+    """
+    return _ffi_api.HorizontalFuseTIR()  # type: ignore
+
+
 @tvm._ffi.register_object("relax.transform.PatternCheckContext")
 class PatternCheckContext(Object):
     """
@@ -1323,7 +1543,9 @@ def AlterOpImpl(
     )  # type: ignore
 
 
-def ConvertLayout(desired_layouts: Dict[str, List[str]]) -> tvm.ir.transform.Pass:
+def ConvertLayout(
+    desired_layouts: Dict[str, List[str]], minimize_transposes: bool = False
+) -> tvm.ir.transform.Pass:
     """Automatic layout conversion pass.
 
     Parameters
@@ -1334,12 +1556,19 @@ def ConvertLayout(desired_layouts: Dict[str, List[str]]) -> tvm.ir.transform.Pas
         layout of conv2d from NCHW to NHWC, we can set the desired layout of conv2d to be
         ``{"relax.nn.conv2d": ["NHWC", "OHWI"]}``.
 
+    minimize_transposes : bool
+        Whether to plan the layouts of each dataflow block globally instead of converting every
+        op with a desired layout. The plan minimizes the number of elements transposed at runtime,
+        where an op in its desired layout is considered to save as much as transposing its output.
+        The ops that are not worth converting, e.g. a lone conv2d between ops that cannot follow
+        its layout, keep the layouts of their inputs.
+
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for layout conversion.
     """
-    return _ffi_api.ConvertLayout(desired_layouts)  # type: ignore
+    return _ffi_api.ConvertLayout(desired_layouts, minimize_transposes)  # type: ignore
 
 
 def DeadCodeElimination(entry_functions: Optional[List[str]] = None) -> tvm.ir.transform.Pass:
@@ -1373,7 +1602,10 @@ def DeadCodeElimination(entry_functions: Optional[List[str]] = None) -> tvm.ir.t
 
 
 def ToMixedPrecision(
-    out_dtype="float32", fp16_input_names: Optional[List[str]] = None
+    out_dtype="float32",
+    fp16_input_names: Optional[List[str]] = None,
+    fp32_var_names: Optional[List[str]] = None,
+    matmul_dtype: Optional[str] = None,
 ) -> tvm.ir.transform.Pass:
     """Automatic mixed precision pass. Currently the pass assumes the input module to be fp32
     only, and will automatically cast fp32 to fp16 for certain ops.
@@ -1387,13 +1619,22 @@ def ToMixedPrecision(
     fp16_input_names : List[str]
         The names of function parameters whose dtype should become fp16. The  function signature
         would change accordingly.
+    fp32_var_names : Optional[List[str]]
+        The names of the vars whose bound ops are kept in fp32. They are usually found by
+        :py:func:`tvm.relax.transform.calibrate_mixed_precision`.
+    matmul_dtype : Optional[str]
+        The input dtype of the matmuls, float16 by default. With "e4m3_float8" or "e5m2_float8",
+        the inputs of each matmul are quantized with per-tensor scales, and the output is
+        multiplied by the product of the scales.
 
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for mixed precision.
     """
-    return _ffi_api.ToMixedPrecision(out_dtype, fp16_input_names)  # type: ignore
+    return _ffi_api.ToMixedPrecision(  # type: ignore
+        out_dtype, fp16_input_names, fp32_var_names, matmul_dtype
+    )
 
 
 def SplitCallTIRByPattern(patterns: List[PrimFunc], fcodegen: Callable) -> tvm.ir.transform.Pass:
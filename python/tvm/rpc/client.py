@@ -380,7 +380,13 @@ class TrackerSession(object):
         return res
 
     def request(
-        self, key, priority=1, session_timeout=0, max_retry=5, session_constructor_args=None
+        self,
+        key,
+        priority=1,
+        session_timeout=0,
+        max_retry=5,
+        session_constructor_args=None,
+        compress=False,
     ):
         """Request a new connection from the tracker.
 
@@ -404,6 +410,9 @@ class TrackerSession(object):
             List of additional arguments to passed as the remote session constructor.
             The first element of the list is always a string specifying the name of
             the session constructor, the following args are the positional args to that function.
+
+        compress : bool, optional
+            Whether to request a compressed channel, see :py:func:`connect`.
         """
         last_err = None
         for _ in range(max_retry):
@@ -421,6 +430,7 @@ class TrackerSession(object):
                     matchkey,
                     session_timeout,
                     session_constructor_args=session_constructor_args,
+                    compress=compress,
                 )
             except socket.error as err:
                 self.close()
@@ -473,8 +483,33 @@ class TrackerSession(object):
         )
 
 
+def set_copy_pipeline(block_size=4 << 20, window=4):
+    """Configure how arrays are copied to and from RPC servers in this process.
+
+    Copies are split into blocks of `block_size` bytes, and up to `window`
+    blocks are kept in flight, so that the socket transfer overlaps with the
+    copy on the remote device. Servers that do not support pipelining, such as
+    the web runtime, always receive one block at a time.
+
+    Parameters
+    ----------
+    block_size : int
+        The number of data bytes in each transfer packet.
+
+    window : int
+        The maximum number of packets in flight. Use 1 to disable pipelining.
+    """
+    _ffi_api.SetCopyPipeline(block_size, window)
+
+
 def connect(
-    url, port, key="", session_timeout=0, session_constructor_args=None, enable_logging=False
+    url,
+    port,
+    key="",
+    session_timeout=0,
+    session_constructor_args=None,
+    enable_logging=False,
+    compress=False,
 ):
     """Connect to RPC Server
 
@@ -502,6 +537,12 @@ def connect(
     enable_logging: boolean
         flag to enable/disable logging. Logging is disabled by default.
 
+    compress: boolean
+        Whether to request a zlib compressed channel, which helps on slow links.
+        Incompressible data is sent as-is. The connection falls back to an
+        uncompressed channel when the server does not support compression.
+        Requires building with USE_RPC_COMPRESSION=ON.
+
     Returns
     -------
     sess : RPCSession
@@ -530,6 +571,10 @@ def connect(
     try:
         if session_timeout:
             key += f" -timeout={session_timeout}"
+        if compress:
+            if not _ffi_api.CompressionSupported("zlib"):
+                raise RuntimeError("Please compile with USE_RPC_COMPRESSION=ON")
+            key += " -compress=zlib"
         session_constructor_args = session_constructor_args if session_constructor_args else []
         if not isinstance(session_constructor_args, (list, tuple)):
             raise TypeError("Expect the session constructor to be a list or tuple")
@@ -22,7 +22,8 @@ Server is TCP based with the following protocol:
 - Initial handshake to the peer
   - [RPC_MAGIC, keysize(int32), key-bytes]
 - The key is in format
-   - {server|client}:device-type[:random-key] [-timeout=timeout]
+   - {server|client}:device-type[:random-key] [-timeout=timeout] [-compress=codec]
+- The server echoes [-compress=codec] in its key when it accepts the compression
 """
 # pylint: disable=invalid-name
 import os
@@ -120,9 +121,12 @@ def _server_env(load_library, work_path=None):
     return temp
 
 
-def _serve_loop(sock, load_library, work_path):
+def _serve_loop(sock, load_library, work_path, compress):
     _server_env(load_library, work_path)
-    _ffi_api.ServerLoop(sock.fileno())
+    if compress:
+        _ffi_api.ServerLoop(sock.fileno(), compress)
+    else:
+        _ffi_api.ServerLoop(sock.fileno())
 
 
 def _parse_server_opt(opts):
@@ -141,7 +145,10 @@ def _serving(sock, addr, opts, load_library):
     os.chdir(work_path.path)  # Avoiding file name conflict between sessions.
     logger.info(f"start serving at {work_path.path}")
 
-    server_proc = multiprocessing.Process(target=_serve_loop, args=(sock, load_library, work_path))
+    compress = opts.get("compress", "")
+    server_proc = multiprocessing.Process(
+        target=_serve_loop, args=(sock, load_library, work_path, compress)
+    )
     server_proc.start()
     server_proc.join(opts.get("timeout", None))  # Wait until finish or timeout.
 
@@ -151,6 +158,7 @@ def _serving(sock, addr, opts, load_library):
             sock.fileno(),
             f'RPCSessionTimeoutError: Your {opts["timeout"]}s session has expired, '
             f'try to increase the "session_timeout" value.',
+            compress,
         )
 
         try:
@@ -243,10 +251,15 @@ def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
                 conn.close()
                 logger.warning("mismatch key from %s", addr)
                 continue
+            opts = _parse_server_opt(arr[1:])
+            # Only accept compression on direct connections, where the client sees our reply.
+            if "-compress=zlib" in arr[1:] and _ffi_api.CompressionSupported("zlib"):
+                server_key += " -compress=zlib"
+                opts["compress"] = "zlib"
             conn.sendall(struct.pack("<i", base.RPC_CODE_SUCCESS))
             conn.sendall(struct.pack("<i", len(server_key)))
             conn.sendall(server_key.encode("utf-8"))
-            return conn, addr, _parse_server_opt(arr[1:])
+            return conn, addr, opts
 
     # Server logic
     tracker_conn = None
@@ -30,13 +30,17 @@ from .profiling import Report
 from .object_generic import convert_to_object, convert, const
 from .ndarray import device, cpu, cuda, gpu, opencl, cl, vulkan, metal, mtl
 from .ndarray import vpi, rocm, ext_dev
-from .module import load_module, enabled, system_lib, load_static_library
+from .module import load_module, enabled, system_lib, load_static_library, hot_swap_module
 from .container import String, ShapeTuple
 from .params import (
     save_param_dict,
     load_param_dict,
     save_param_dict_to_file,
     load_param_dict_from_file,
+    save_param_dict_chunked,
+    load_param_dict_chunked,
+    list_param_dict_chunked,
+    validate_param_dict_chunked,
 )
 
 from . import executor
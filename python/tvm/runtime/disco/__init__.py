@@ -23,4 +23,5 @@ from .session import (
     Session,
     ThreadedSession,
     SocketSession,
+    group_devices_by_topology,
 )
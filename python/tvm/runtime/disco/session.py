@@ -18,10 +18,12 @@
 with the distributed runtime.
 """
 
+import contextlib
+import json
 import logging
 import os
 import pickle
-from typing import Any, Callable, Optional, Sequence, Union
+from typing import Any, Callable, List, Optional, Sequence, Union
 
 import numpy as np
 
@@ -244,6 +246,79 @@ class Session(Object):
         executing all the existing instructions."""
         return self._sync_worker(0)
 
+    def start_trace(self) -> None:
+        """Start recording the timelines of the controller and of all the workers, including the
+        workers of their thread pools and their kernels on the devices. See `stop_trace`."""
+        get_global_func("runtime.profiling.StartTrace")()
+        self.get_global_func("runtime.profiling.StartTrace")()
+        # Wait until every worker records.
+        for worker_id in range(self.num_workers):
+            self._estimate_clock_offset(worker_id, num_rounds=1)
+
+    def stop_trace(self) -> str:
+        """Stop recording the timelines and merge them into one trace, where the controller is
+        process 0 and worker i is process i + 1.
+
+        Returns
+        -------
+        trace: str
+            The trace in the Trace Event Format, which can be opened by chrome://tracing or
+            Perfetto. The timestamps are relative to the time the trace started on the controller.
+        """
+        self.get_global_func("runtime.profiling.StopTrace")()
+        worker_traces = self.get_global_func("runtime.disco.dump_trace")()
+        worker_traces = [
+            json.loads(worker_traces.debug_get_from_remote(i)) for i in range(self.num_workers)
+        ]
+        get_global_func("runtime.profiling.StopTrace")()
+        trace = json.loads(get_global_func("runtime.profiling.DumpTrace")(0))
+        origin_ns = trace["otherData"]["clock_origin_ns"]
+        for worker_id, worker_trace in enumerate(worker_traces):
+            # Move the timestamps of the worker onto the clock of the controller.
+            offset_ns = self._estimate_clock_offset(worker_id)
+            shift_us = (worker_trace["otherData"]["clock_origin_ns"] - offset_ns - origin_ns) / 1e3
+            for event in worker_trace["traceEvents"]:
+                if "ts" in event:
+                    event["ts"] += shift_us
+            trace["traceEvents"] += worker_trace["traceEvents"]
+        return json.dumps(trace)
+
+    def _estimate_clock_offset(self, worker_id: int, num_rounds: int = 5) -> int:
+        """Estimate how far the clock of a worker is ahead of the clock of the controller, from
+        the round trip of the lowest latency. An offset within the round-trip time cannot be told
+        apart from the latency, e.g. for the workers on the host of the controller, and is 0."""
+        f_local = get_global_func("runtime.profiling.TraceClockNs")
+        f_remote = self.get_global_func("runtime.profiling.TraceClockNs")
+        best_rtt, best_offset = None, 0
+        for _ in range(num_rounds):
+            begin = f_local()
+            remote = f_remote().debug_get_from_remote(worker_id)
+            end = f_local()
+            if best_rtt is None or end - begin < best_rtt:
+                best_rtt, best_offset = end - begin, remote - (begin + end) // 2
+        return best_offset if abs(best_offset) > best_rtt else 0
+
+    @contextlib.contextmanager
+    def batch(self):
+        """Queue the commands issued inside the context and send them to the workers as a single
+        packet when the context exits. Calls that wait for a worker, e.g. `sync_worker_0`, flush
+        the queued commands early.
+
+        Examples
+        --------
+        .. code-block:: python
+
+            with sess.batch():
+                for func, arg in steps:
+                    func(arg)
+            sess.sync_worker_0()
+        """
+        _ffi_api.SessionBeginBatch(self)  # type: ignore # pylint: disable=no-member
+        try:
+            yield
+        finally:
+            _ffi_api.SessionEndBatch(self)  # type: ignore # pylint: disable=no-member
+
     def copy_from_worker_0(self, host_array: NDArray, remote_array: DRef) -> None:
         """Copy an NDArray from worker-0 to the controller-side NDArray.
 
@@ -515,6 +590,103 @@ class Session(Object):
         func = self._get_cached_method("runtime.disco.allgather")
         func(src, in_group, dst)
 
+    def allreduce_async(
+        self,
+        src: DRef,
+        dst: DRef,
+        op: str = "sum",  # pylint: disable=invalid-name
+        in_group: bool = True,
+    ) -> DRef:
+        """Start an allreduce on the communication stream of each worker, overlapping with the
+        compute work issued afterwards until `wait_collective` is called on the returned handle.
+
+        Parameters
+        ----------
+        src : DRef
+            The array to be reduced. It must not be overwritten before the wait.
+
+        dst : DRef
+            The array to receive the result. It must not be read before the wait.
+
+        op : str = "sum"
+            The reduce operation to be performed, see `allreduce`.
+
+        in_group : bool
+            Whether the reduce operation performs globally or in group as default.
+
+        Returns
+        -------
+        handle : DRef
+            The handle of the pending collective on each worker.
+        """
+        if op not in REDUCE_OPS:
+            raise ValueError(f"Unsupported reduce op: {op}. Available ops are: {REDUCE_OPS.keys()}")
+        op = ShapeTuple([REDUCE_OPS[op]])
+        func = self._get_cached_method("runtime.disco.allreduce_async")
+        return func(src, op, in_group, dst)
+
+    def allgather_async(
+        self,
+        src: DRef,
+        dst: DRef,
+        in_group: bool = True,
+    ) -> DRef:
+        """Start an allgather on the communication stream of each worker, see `allreduce_async`.
+
+        Parameters
+        ----------
+        src : DRef
+            The array to be gathered from.
+
+        dst : DRef
+            The array to be gathered to.
+
+        in_group : bool
+            Whether the gather operation performs globally or in group as default.
+
+        Returns
+        -------
+        handle : DRef
+            The handle of the pending collective on each worker.
+        """
+        func = self._get_cached_method("runtime.disco.allgather_async")
+        return func(src, in_group, dst)
+
+    def wait_collective(self, handle: DRef) -> None:
+        """Make the compute work issued afterwards wait for a pending collective.
+        It does not block the controller.
+
+        Parameters
+        ----------
+        handle : DRef
+            The handle returned by `allreduce_async` or `allgather_async`.
+        """
+        func = self._get_cached_method("runtime.disco.wait_collective")
+        func(handle)
+
+    def tune_custom_allreduce(self, bucket_sizes: Sequence[int], num_iters: int = 20) -> List[int]:
+        """Benchmark the nccl, one-shot and two-shot all-reduce for each message-size bucket,
+        so that "runtime.disco.cuda_ipc.custom_allreduce" with the AUTO strategy picks the
+        fastest one per call afterwards. The result is cached per topology in each worker
+        process. It requires `init_ccl` with "nccl" to be called first.
+
+        Parameters
+        ----------
+        bucket_sizes : Sequence[int]
+            The ascending upper bounds, in bytes, of the message-size buckets.
+
+        num_iters : int
+            The number of timed iterations per strategy and bucket.
+
+        Returns
+        -------
+        strategies : List[int]
+            The selected AllReduceStrategyType of each bucket.
+        """
+        func = self.get_global_func("runtime.disco.cuda_ipc.tune_custom_allreduce")
+        result = self.call_packed(func, ShapeTuple(bucket_sizes), num_iters)
+        return [int(x) for x in result.debug_get_from_remote(0)]
+
     def _clear_ipc_memory_pool(self):
         # Clear the IPC memory allocator when the allocator exists.
         name = "runtime.disco.cuda_ipc.cuda_ipc_memory_allocator_clear"
@@ -522,6 +694,31 @@ class Session(Object):
             self.call_packed(self.get_global_func(name))
 
 
+def group_devices_by_topology(ccl: str, device_ids: Sequence[int], group_size: int) -> List[int]:
+    """Reorder the devices of this host so that consecutive groups of `group_size` devices lie
+    within one island of peer-accessible devices, e.g. an NVLink domain. Pass the result to
+    `Session.init_ccl`, so that in-group collectives stay on the fast interconnect.
+
+    Parameters
+    ----------
+    ccl : str
+        The name of the communication collective library, e.g. "nccl" or "rccl".
+
+    device_ids : Sequence[int]
+        The device IDs to be used by the workers of this host.
+
+    group_size : int
+        The number of workers in a group.
+
+    Returns
+    -------
+    device_ids : List[int]
+        The reordered device IDs.
+    """
+    func = get_global_func(f"runtime.disco.{ccl}.group_devices_by_topology")
+    return [int(x) for x in func(ShapeTuple(device_ids), group_size)]
+
+
 @register_object("runtime.disco.ThreadedSession")
 class ThreadedSession(Session):
     """A Disco session backed by multi-threading."""
@@ -537,7 +734,12 @@ class ThreadedSession(Session):
 
 @register_object("runtime.disco.ProcessSession")
 class ProcessSession(Session):
-    """A Disco session backed by pipe-based multi-processing."""
+    """A Disco session backed by multi-processing on the local host.
+
+    On Linux, messages travel through shared memory ring buffers set up over the worker
+    pipes, which avoids a syscall per message. Set the environment variable
+    ``TVM_DISCO_SHM=0`` to keep using the pipes.
+    """
 
     def __init__(
         self, num_workers: int, num_groups: int = 1, entrypoint: str = "tvm.exec.disco_worker"
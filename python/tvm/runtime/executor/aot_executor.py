@@ -68,6 +68,9 @@ class AotModule(object):
         self._get_input_index = module["get_input_index"]
         self._get_num_inputs = module["get_num_inputs"]
         self._get_input_name = module["get_input_name"]
+        self._set_input_zero_copy = module["set_input_zero_copy"]
+        self._set_output_zero_copy = module["set_output_zero_copy"]
+        self._share_workspace = module["share_workspace"]
 
     def set_input(self, key=None, value=None, **params):
         """Set inputs to the module via kwargs
@@ -101,6 +104,45 @@ class AotModule(object):
                 if val:
                     self._get_input(k).copyfrom(params[k])
 
+    def set_input_zero_copy(self, key, value):
+        """Bind an input to an NDArray without copying it.
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : NDArray
+           The input value, read by each following run until it is bound again.
+        """
+        self._set_input_zero_copy(key, value)
+
+    def set_output_zero_copy(self, key, value):
+        """Bind an output to an NDArray without copying it.
+
+        Parameters
+        ----------
+        key : int or str
+           The output key
+
+        value : NDArray
+           The array each following run writes the output to.
+        """
+        self._set_output_zero_copy(key, value)
+
+    def share_workspace(self, other):
+        """Share the workspace pools of another AOT module.
+
+        The shared pools are sized for the largest user, so modules sharing them must not
+        run concurrently.
+
+        Parameters
+        ----------
+        other : AotModule
+           The module whose workspace pools are used by this one.
+        """
+        self._share_workspace(other.module)
+
     def run(self, **input_dict):
         """Run forward execution of the model
 
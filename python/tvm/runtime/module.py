@@ -19,6 +19,7 @@
 """Runtime Module namespace."""
 import os
 import ctypes
+import json
 import struct
 from typing import Sequence
 import numpy as np
@@ -367,6 +368,8 @@ class Module(object):
 
         f_preproc: str, optional
             The preprocess function name we want to execute before executing the time evaluator.
+            For example, "cache_flush_device" flushes the caches of the device of the arguments
+            before each repeat, so that memory-bound functions are timed with cold caches.
 
         Note
         ----
@@ -407,6 +410,81 @@ class Module(object):
         except NameError:
             raise NameError("time_evaluator is only supported when RPC is enabled")
 
+    def batch_time_evaluator(
+        self,
+        funcs,
+        dev,
+        number=10,
+        repeat=1,
+        min_repeat_ms=0,
+        limit_zero_time_iterations=100,
+        cooldown_interval_ms=0,
+        repeats_to_cooldown=1,
+        cache_flush_bytes=0,
+        f_preproc="",
+    ):
+        """Get an evaluator that measures the time costs of many functions of the module at once.
+
+        The arguments are allocated and randomly filled once on the device, and shared by the
+        functions taking an argument of the same dtype and shape at the same position. For a
+        remote module, all the functions are timed in one round trip.
+
+        Parameters
+        ----------
+        funcs: List[Tuple[str, List[Tuple[str, Sequence[int]]]]]
+            The name of each function in the module, along with the dtype and the shape of each
+            of its arguments.
+
+        dev: Device
+            The device we should run this function on.
+
+        number, repeat, min_repeat_ms, limit_zero_time_iterations, cooldown_interval_ms,
+        repeats_to_cooldown, cache_flush_bytes, f_preproc:
+            The same as in :py:meth:`Module.time_evaluator`.
+
+        Returns
+        -------
+        feval : function
+            The function that takes no argument, and returns for each function a BenchmarkResult,
+            or the error message as a str if that function fails.
+        """
+        spec = {
+            "funcs": [
+                {
+                    "name": name,
+                    "args": [[str(dtype), [int(dim) for dim in shape]] for dtype, shape in args],
+                }
+                for name, args in funcs
+            ]
+        }
+        try:
+            feval = _ffi_api.RPCBatchTimeEvaluator(
+                self,
+                json.dumps(spec),
+                dev.device_type,
+                dev.device_id,
+                number,
+                repeat,
+                min_repeat_ms,
+                limit_zero_time_iterations,
+                cooldown_interval_ms,
+                repeats_to_cooldown,
+                cache_flush_bytes,
+                f_preproc,
+            )
+
+            def evaluator():
+                """Internal wrapped evaluator."""
+                results = json.loads(feval())
+                return [
+                    result if isinstance(result, str) else BenchmarkResult(result)
+                    for result in results
+                ]
+
+            return evaluator
+        except NameError:
+            raise NameError("batch_time_evaluator is only supported when RPC is enabled")
+
     def _collect_from_import_tree(self, filter_func):
         """Helper function to collect modules from the tree matching a filter_func, then return it.
 
@@ -699,6 +777,31 @@ def load_module(path, fmt=""):
     return _ffi_api.ModuleLoadFromFile(path, fmt)
 
 
+def hot_swap_module(mod):
+    """Create a module whose implementation can be replaced while it serves requests.
+
+    The functions obtained from the returned module always call into the current
+    implementation. Calls that are in flight during a swap finish on the previous one.
+
+    Parameters
+    ----------
+    mod : runtime.Module
+        The initial implementation.
+
+    Returns
+    -------
+    module : runtime.Module
+        The hot swap module, which provides, besides the functions of the implementation:
+
+        - ``swap(mod)``: replace the implementation, return the new version number.
+        - ``load_and_swap(path[, finit])``: load the library at path next to the loaded
+          ones, map it through ``finit`` when given (e.g. to create a VM), then swap it in.
+        - ``get_current()``: return the current implementation.
+        - ``get_version()``: return the number of swaps so far.
+    """
+    return _ffi_api.HotSwapModule(mod)
+
+
 def load_static_library(path, func_names):
     """Load the .o library at path which implements functions with func_names.
     Unlike the generic load_module the result will remain as a static_library
@@ -108,3 +108,84 @@ def load_param_dict_from_file(path):
         The parameter dictionary.
     """
     return _ffi_api.LoadParamsFromFile(path)
+
+
+def save_param_dict_chunked(params, path, chunk_size=16 << 20):
+    """Save parameter dictionary to a file in the chunked format.
+
+    Each tensor is written in chunks of ``chunk_size`` bytes, every chunk is
+    protected by a CRC-32, and an index at the end of the file allows loading
+    a subset of the parameters. Parameters may reside on any device.
+
+    Parameters
+    ----------
+    params : dict of str to NDArray
+        The parameter dictionary.
+
+    path: str
+        The path to the parameter file.
+
+    chunk_size: int
+        The number of bytes per chunk.
+    """
+    return _ffi_api.SaveParamsChunked(_to_ndarray(params), path, chunk_size)
+
+
+def load_param_dict_chunked(path, names=None, device=None):
+    """Load parameters from a file in the chunked format.
+
+    The checksum of every chunk is verified as it is read.
+
+    Parameters
+    ----------
+    path: str
+        The path to the parameter file to load from.
+
+    names: Optional[List[str]]
+        The parameters to load. All parameters are loaded when not specified.
+
+    device: Optional[Device]
+        The device to place the parameters on, defaults to CPU.
+
+    Returns
+    -------
+    params : dict of str to NDArray
+        The parameter dictionary.
+    """
+    if device is None:
+        device = ndarray.cpu(0)
+    return _ffi_api.LoadParamsChunked(path, names, device)
+
+
+def list_param_dict_chunked(path):
+    """List the parameter names stored in a chunked parameter file.
+
+    Only the index of the file is read.
+
+    Parameters
+    ----------
+    path: str
+        The path to the parameter file.
+
+    Returns
+    -------
+    names : List[str]
+        The parameter names.
+    """
+    return [str(name) for name in _ffi_api.ListParamsChunked(path)]
+
+
+def validate_param_dict_chunked(path):
+    """Verify the checksums of a chunked parameter file without loading it.
+
+    Parameters
+    ----------
+    path: str
+        The path to the parameter file.
+
+    Returns
+    -------
+    corrupted : List[str]
+        The names of the parameters whose data does not match its checksums.
+    """
+    return [str(name) for name in _ffi_api.ValidateParamsChunked(path)]
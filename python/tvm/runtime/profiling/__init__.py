@@ -16,7 +16,8 @@
 # under the License.
 """Registration of profiling objects in python."""
 
-from typing import Dict, Sequence, Optional
+import json
+from typing import Any, Dict, List, Sequence, Optional
 from ... import _ffi
 from . import _ffi_api
 from .. import Object, Device
@@ -291,3 +292,112 @@ if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=T
             for dev, names in metric_names.items():
                 wrapped[DeviceWrapper(dev)] = names
             self.__init_handle_by_constructor__(_ffi_api.PAPIMetricCollector, wrapped)
+
+
+# We only enable this class when TVM is build with CUPTI support
+if _ffi.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is not None:
+
+    @_ffi.register_object("runtime.profiling.CUPTIMetricCollector")
+    class CUPTIMetricCollector(MetricCollector):
+        """Collects the hardware counters of the CUDA kernels launched by each
+        call using the CUDA Profiling Tools Interface (CUPTI).
+
+        The kernels are replayed to collect the counters, so the durations of
+        the calls are not meaningful when this collector is used.
+        """
+
+        def __init__(self, metric_names: Optional[Sequence[str]] = None):
+            """
+            Parameters
+            ----------
+            metric_names : Optional[Sequence[str]]
+                List of metrics to collect, which are summed over the kernels of a call
+                for `.sum` metrics and averaged weighted by the kernel durations
+                otherwise. You can find a list of valid metrics by running
+                `ncu --query-metrics` from the command line. Defaults to the achieved
+                occupancy, the SM efficiency, the DRAM bytes and the FP32 instructions.
+            """
+            metric_names = [] if metric_names is None else list(metric_names)
+            self.__init_handle_by_constructor__(_ffi_api.CUPTIMetricCollector, metric_names)
+
+
+def flush_device_cache(dev: Device) -> None:
+    """Flush the caches of a device, so that the next function running on it starts cold.
+
+    Parameters
+    ----------
+    dev: Device
+        The device whose caches are flushed.
+    """
+    _ffi_api.FlushDeviceCache(dev)
+
+
+def check_measurement_env(dev: Device) -> List[str]:
+    """Check whether the timings on a device could be unstable, e.g. because its clock is not
+    pinned and scales with the load or the temperature.
+
+    Parameters
+    ----------
+    dev: Device
+        The device to be checked.
+
+    Returns
+    -------
+    warnings: List[str]
+        The reasons why the timings could be unstable, empty if none is detected.
+    """
+    return [str(warning) for warning in _ffi_api.CheckMeasurementEnv(dev)]
+
+
+def configure_sampling(period: int, capacity: int = 65536, sync_device: bool = False) -> None:
+    """Configure the always-on sampling profiler of the Relax VM.
+
+    One in every `period` invocations of a VM function is sampled, together with all the calls
+    made within it. The samples are kept in a lock-free ring buffer until they are drained. The
+    period can also be set by the environment variable `TVM_PROFILING_SAMPLE_PERIOD`.
+
+    Parameters
+    ----------
+    period: int
+        The sampling period, 0 disables sampling.
+
+    capacity: int
+        The number of samples kept before the oldest are lost, rounded up to a power of 2. The
+        ring buffer is never shrunk.
+
+    sync_device: bool
+        Whether to synchronize the device after the sampled calls, so that their durations
+        include the device time rather than only the launch time.
+    """
+    _ffi_api.ConfigureSampling(period, capacity, sync_device)
+
+
+def drain_samples() -> Dict[str, Any]:
+    """Drain the samples recorded by the sampling profiler, e.g. to be scraped by a monitor.
+
+    Returns
+    -------
+    samples: Dict[str, Any]
+        The samples under "samples", each with its "invocation", "name", "device", "depth",
+        "begin_ns" and "duration_ns", and the number of samples lost under "num_lost".
+    """
+    return json.loads(_ffi_api.DrainSamples())
+
+
+def start_trace() -> None:
+    """Start recording the timelines of the process: the host threads, including the workers of
+    the thread pools, and the kernels of the Relax VM on each device. See `stop_trace`."""
+    _ffi_api.StartTrace()
+
+
+def stop_trace() -> str:
+    """Stop recording the timelines of the process and export them.
+
+    Returns
+    -------
+    trace: str
+        The trace in the Trace Event Format, which can be opened by chrome://tracing or Perfetto.
+        The timestamps are relative to the time the trace started.
+    """
+    _ffi_api.StopTrace()
+    return _ffi_api.DumpTrace(-1)
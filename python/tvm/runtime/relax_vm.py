@@ -17,7 +17,7 @@
 # pylint: disable=invalid-name, redefined-builtin, no-else-return, consider-using-dict-items
 """The Relax virtual machine."""
 from enum import IntEnum
-from typing import Any, Callable, Dict, List, Optional, Tuple, Union
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple, Union
 
 import numpy as np  # type: ignore
 
@@ -25,7 +25,7 @@ import tvm
 from tvm._ffi import base as _base
 from tvm._ffi import register_func
 from tvm.runtime import Device, Object, PackedFunc
-from tvm.runtime.profiling import Report
+from tvm.runtime.profiling import MetricCollector, Report
 
 from ..rpc.base import RPC_SESS_MASK
 
@@ -36,11 +36,36 @@ class VMInstrumentReturnKind(IntEnum):
     SKIP_RUN = 1
 
 
+@tvm._ffi.register_object("relax.vm.Future")
+class VMFuture(Object):
+    """The result of :py:func:`VirtualMachine.invoke_async`."""
+
+    def done(self) -> bool:
+        """Whether the host side of the invocation has finished.
+
+        The device work queued on the stream may still be running.
+        """
+        return bool(tvm.get_global_func("relax.VMFutureIsDone")(self))
+
+    def result(self) -> Any:
+        """Wait for the invocation and synchronize its stream.
+
+        Returns
+        -------
+        ret: Any
+            The return value of the function. Raises the error of the
+            invocation if it failed.
+        """
+        return tvm.get_global_func("relax.VMFutureWait")(self)
+
+
 class VirtualMachine(object):
     """Relax VM runtime."""
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    BUCKETED_ALLOCATOR = 3
+    STREAM_ORDERED_ALLOCATOR = 5
 
     def __init__(
         self,
@@ -62,11 +87,12 @@ class VirtualMachine(object):
 
         memory_cfg : Optional[Union[str, Dict[Device, str]]]
             Config the type of memory allocator. The allocator type can be ["naive",
-            "pooled"]. If memory_cfg is None, all devices will use pooled allocator
-            by default. If memory_cfg is string, all devices will use the specified
-            allocator type. If memory_cfg is a dict, each device uses the allocator
+            "pooled", "bucketed", "stream_ordered"]. If memory_cfg is None, all devices will use
+            pooled allocator by default. If memory_cfg is string, all devices will use the
+            specified allocator type. If memory_cfg is a dict, each device uses the allocator
             type specified in the dict, or pooled allocator if not specified in the
-            dict.
+            dict. The "stream_ordered" allocator allocates from the memory pool of the CUDA
+            driver on the current stream, and the CPU keeps using the pooled allocator with it.
 
         profile : Optional[bool]
             Whether or not to enable profiling.
@@ -84,7 +110,12 @@ class VirtualMachine(object):
                 raise ValueError("Expect the rt_mod to be an runtime.Module")
 
         load_exec = "vm_profiler_load_executable" if profile else "vm_load_executable"
-        self.module = rt_mod[load_exec]()
+        self._setup_module(rt_mod[load_exec]())
+        self._setup_device(device, memory_cfg)
+
+    def _setup_module(self, module: tvm.runtime.Module) -> None:
+        """Bind the functions of a loaded VM module."""
+        self.module = module
         self._invoke_closure = self.module["invoke_closure"]
         self._save_function = self.module["save_function"]
         self._set_input = self.module["set_input"]
@@ -94,7 +125,6 @@ class VirtualMachine(object):
         self._get_function_arity = self.module["get_function_arity"]
         self._get_function_param_name = self.module["get_function_param_name"]
         self._set_instrument = self.module["set_instrument"]
-        self._setup_device(device, memory_cfg)
 
     def _setup_device(self, dev: Device, memory_cfg: Union[str, Dict[Device, str]]) -> None:
         """init devices and allocators."""
@@ -115,9 +145,13 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
+            assert memory_cfg in ["naive", "pooled", "bucketed", "stream_ordered"]
             if memory_cfg == "naive":
                 default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            elif memory_cfg == "bucketed":
+                default_alloc_type = VirtualMachine.BUCKETED_ALLOCATOR
+            elif memory_cfg == "stream_ordered":
+                default_alloc_type = VirtualMachine.STREAM_ORDERED_ALLOCATOR
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -129,6 +163,12 @@ class VirtualMachine(object):
             init_args.append(device.device_type % RPC_SESS_MASK)
             init_args.append(device.device_id)
             alloc_type = memory_cfg[device] if device in memory_cfg else default_alloc_type
+            if (
+                alloc_type == VirtualMachine.STREAM_ORDERED_ALLOCATOR
+                and device.device_type % RPC_SESS_MASK == tvm.cpu().device_type
+            ):
+                # The host has no stream-ordered memory pool
+                alloc_type = VirtualMachine.POOLED_ALLOCATOR
             init_args.append(alloc_type)
         self.module["vm_initialization"](*init_args)
 
@@ -303,6 +343,37 @@ class VirtualMachine(object):
         """
         self._invoke_stateful(func_name)
 
+    def set_output_zero_copy(self, func_name: str, index: int, arr: tvm.runtime.NDArray) -> None:
+        """Bind an output of a function to a user-provided tensor for `invoke_stateful`.
+
+        When the output is a tensor allocated by the function, the VM writes it
+        directly into ``arr`` instead of allocating it. Otherwise the output is
+        copied into ``arr`` after the call. Either way, ``get_outputs`` returns
+        ``arr`` for the bound output.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the function.
+
+        index: int
+            The index of the output, 0 if the function returns a single tensor.
+
+        arr: tvm.runtime.NDArray
+            A contiguous tensor with the shape, dtype and device of the output.
+        """
+        self.module["set_output_zero_copy"](func_name, index, arr)
+
+    def clear_output_zero_copy(self, func_name: str) -> None:
+        """Remove the outputs bound by `set_output_zero_copy` for a function.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the function.
+        """
+        self.module["clear_output_zero_copy"](func_name)
+
     def get_outputs(self, func_name: str) -> Union[tvm.Object, Tuple[Any]]:
         """
         Get the value output by the function by the given name
@@ -374,6 +445,104 @@ class VirtualMachine(object):
         """
         self._set_instrument(instrument)
 
+    def set_thread_pool(self, name: str) -> None:
+        """Run the parallel loops of this VM in a named thread pool.
+
+        Parameters
+        ----------
+        name: str
+            The name of a pool created with ``runtime.create_threadpool``,
+            or the empty string to use the thread pool of the calling thread.
+        """
+        self.module["set_thread_pool"](name)
+
+    def invoke_async(
+        self, func_name: str, *args: Any, stream: Optional[Any] = None
+    ) -> VMFuture:
+        """Invoke a function asynchronously.
+
+        The function runs on a worker thread of this VM, one invocation at a
+        time in the order they are made, with ``stream`` as the current stream
+        of the first device of the VM. This call returns as soon as the
+        invocation is queued, which lets the host prepare the next inputs while
+        the device runs, and lets independent VMs share a device on separate
+        streams.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args: List of NDArray or other objects supported by PackedFunc.
+            The arguments to the function.
+
+        stream : Optional[Any]
+            The stream handle, e.g. from ``Device.create_raw_stream``. The
+            default stream is used if it is None.
+
+        Returns
+        -------
+        future: VMFuture
+            The future of the return value.
+        """
+        cargs: List[Any] = []
+        for arg in args:
+            self._convert(arg, cargs)
+        return self.module["invoke_async"](func_name, stream, *cargs)
+
+    def create_context(self) -> "VirtualMachine":
+        """Create an execution context that shares the loaded program of this VM.
+
+        The context shares the devices, allocators, constants and function pool
+        with this VM, so creating it is cheap, and has its own call stack,
+        inputs and outputs. Different contexts can run on different threads
+        at the same time, e.g. to serve concurrent requests.
+
+        Returns
+        -------
+        ctx: VirtualMachine
+            The execution context.
+        """
+        ctx = VirtualMachine.__new__(VirtualMachine)
+        ctx._setup_module(self.module["create_context"]())
+        return ctx
+
+    def start_trace(self) -> None:
+        """Start tracing the calls made by this VM.
+
+        While the trace runs, every call instruction records its host time
+        and the device time of the device of its tensor arguments. Unlike
+        :py:func:`profile`, this does not need a VM created with ``profile=True``.
+
+        See Also
+        --------
+        stop_trace: stop the trace and get the report.
+        """
+        self.module["start_trace"]()
+
+    def stop_trace(self) -> Report:
+        """Stop the trace started by :py:func:`start_trace`.
+
+        Returns
+        -------
+        report: tvm.runtime.profiling.Report
+            The recorded calls aggregated by callee name and device. "Duration (us)"
+            is the device time and "Host Duration (us)" the host time of the calls.
+        """
+        self.module["stop_trace"]()
+        return Report.from_json(self.module["get_trace_report"]())
+
+    def chrome_trace(self) -> str:
+        """Get the calls recorded by the last trace as a Chrome trace.
+
+        Returns
+        -------
+        trace: str
+            The trace in the Trace Event Format in JSON, which can be loaded into
+            chrome://tracing or Perfetto.
+        """
+        return self.module["get_chrome_trace"]()
+
     def time_evaluator(
         self,
         func_name: str,
@@ -483,7 +652,9 @@ class VirtualMachine(object):
             f_preproc=f_preproc,
         )
 
-    def profile(self, func_name: str, *args):
+    def profile(
+        self, func_name: str, *args, collectors: Optional[Sequence[MetricCollector]] = None
+    ):
         """Profile a function call.
 
         Parameters
@@ -494,6 +665,10 @@ class VirtualMachine(object):
         args: List of NDArray or other objects supported by PackedFunc.
             The arguments to the function.
 
+        collectors : Optional[Sequence[MetricCollector]]
+            Extra metrics to collect of each call, e.g. the hardware counters of
+            :py:class:`tvm.runtime.profiling.CUPTIMetricCollector`. Not supported over RPC.
+
         Returns
         -------
         report: tvm.runtime.profiling.Report
@@ -504,7 +679,10 @@ class VirtualMachine(object):
         for arg in args:
             self._convert(arg, cargs)
 
-        report_json = self.module["profile"](func_name, *cargs)
+        if collectors:
+            report_json = self.module["profile_with_collectors"](func_name, collectors, *cargs)
+        else:
+            report_json = self.module["profile"](func_name, *cargs)
         return Report.from_json(report_json)
 
 
@@ -1926,11 +1926,16 @@ ptx_mma_sp = _dtype_forward(_tir_op.ptx_mma_sp)
 ptx_ldmatrix = _dtype_forward(_tir_op.ptx_ldmatrix)
 ptx_cp_async = _dtype_forward(_tir_op.ptx_cp_async)
 ptx_cp_async_bulk = _dtype_forward(_tir_op.ptx_cp_async_bulk)
+ptx_ld_shared_cluster = _dtype_forward(_tir_op.ptx_ld_shared_cluster)
 mma_store = _dtype_forward(_tir_op.mma_store)
 mma_fill = _dtype_forward(_tir_op.mma_fill)
 vectorlow = _dtype_forward(_tir_op.vectorlow)
 vectorhigh = _dtype_forward(_tir_op.vectorhigh)
 vectorcombine = _dtype_forward(_tir_op.vectorcombine)
+vector_reduce_add = _dtype_forward(_tir_op.vector_reduce_add)
+vector_reduce_mul = _dtype_forward(_tir_op.vector_reduce_mul)
+vector_reduce_min = _dtype_forward(_tir_op.vector_reduce_min)
+vector_reduce_max = _dtype_forward(_tir_op.vector_reduce_max)
 get_active_lane_mask = _dtype_forward(_tir_op.get_active_lane_mask)
 dp4a = _dtype_forward(_tir_op.dp4a)
 
@@ -2187,11 +2192,16 @@ __all__ = [
     "simdgroup_store",
     "simdgroup_multiply_accumulate",
     "create_barriers",
+    "ptx_ld_shared_cluster",
     "mma_store",
     "mma_fill",
     "vectorlow",
     "vectorhigh",
     "vectorcombine",
+    "vector_reduce_add",
+    "vector_reduce_mul",
+    "vector_reduce_min",
+    "vector_reduce_max",
     "dp4a",
     "assume",
     "undef",
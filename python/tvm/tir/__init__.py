@@ -72,6 +72,7 @@ from .op import (
     ptx_arrive_barrier_expect_tx,
     ptx_wait_barrier,
     create_barriers,
+    ptx_ld_shared_cluster,
 )
 from .op import (
     make_filled_simdgroup_matrix,
@@ -80,6 +81,7 @@ from .op import (
     simdgroup_store,
 )
 from .op import vectorlow, vectorhigh, vectorcombine
+from .op import vector_reduce_add, vector_reduce_mul, vector_reduce_min, vector_reduce_max
 from .op import infinity, reinterpret
 from .op import exp, exp2, exp10, log, log2, log10, log1p, ldexp, clz
 from .op import sin, sinh, asin, asinh
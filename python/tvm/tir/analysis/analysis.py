@@ -262,6 +262,49 @@ def estimate_tir_flops(stmt_or_mod: Union[Stmt, IRModule]) -> float:
     return _ffi_api.EstimateTIRFlops(stmt_or_mod)  # type: ignore # pylint: disable=no-member
 
 
+def estimate_register_usage(func_or_stmt: Union[PrimFunc, Stmt]) -> int:
+    """Estimate the number of 32-bit registers that each thread of a GPU kernel keeps live.
+
+    The estimate counts the local buffers live at the same time, the share of each thread in the
+    warp-level buffers, and the values loaded by the iterations of unrolled loops.
+
+    Parameters
+    ----------
+    func_or_stmt: Union[PrimFunc, Stmt]
+        The lowered kernel to be estimated.
+
+    Returns
+    -------
+    registers: int
+        The estimated number of registers per thread, of the kernel using the most registers.
+    """
+    return _ffi_api.estimate_register_usage(func_or_stmt)  # type: ignore
+
+
+def detect_shared_memory_bank_conflicts(func: PrimFunc) -> Dict[Var, int]:
+    """Detect the bank conflicts of the accesses to shared memory.
+
+    The indices that the lanes of the first warp access at once are evaluated, taking the loop
+    variables as zero.
+
+    Parameters
+    ----------
+    func: tvm.tir.PrimFunc
+        The function, either scheduled or lowered to thread_extent attributes.
+
+    Returns
+    -------
+    result : Dict[Var, int]
+        The worst conflict degree of the accesses to each shared memory buffer, by its data
+        variable, 1 for the buffers free of conflicts. The buffers accessed through pointers or in
+        vectorized loops are left out.
+    """
+    return {
+        var: int(degree)
+        for var, degree in _ffi_api.detect_shared_memory_bank_conflicts(func).items()
+    }
+
+
 # NOTE: relay_func_type in the following two functions should be relay.FuncType however that would
 # introduce a cycling dependency. We make do with Object.
 
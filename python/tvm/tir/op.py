@@ -1534,7 +1534,7 @@ def ptx_arrive_barrier_expect_tx(barrier_id, byte_count):
     return call_intrin("", "tir.ptx_arrive_barrier_expect_tx", barrier_id, byte_count)
 
 
-def ptx_wait_barrier(barrier_id):
+def ptx_wait_barrier(barrier_id, phase_bit=None):
     """TVM intrinsic for ptx barrier wait using mbarrier.try_wait
     https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-mbarrier-test-wait-mbarrier-try-wait
 
@@ -1543,12 +1543,17 @@ def ptx_wait_barrier(barrier_id):
     barrier_id : int
         The ID of the barrier shared memory pointer.
 
+    phase_bit : Optional[int]
+        The parity of the phase of the barrier to wait for, 0 by default.
+
     Returns
     -------
     call : PrimExpr
         The call expression.
     """
-    return call_intrin("", "tir.ptx_wait_barrier", barrier_id)
+    if phase_bit is None:
+        return call_intrin("", "tir.ptx_wait_barrier", barrier_id)
+    return call_intrin("", "tir.ptx_wait_barrier", barrier_id, phase_bit)
 
 
 def create_barriers(barrier_count):
@@ -1567,6 +1572,32 @@ def create_barriers(barrier_count):
     return call_intrin("", "tir.create_barriers", barrier_count)
 
 
+def ptx_ld_shared_cluster(dtype, shared_ptr, offset, block_rank):
+    """TVM intrinsic for loading from the shared memory of another thread block in the cluster
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-mapa
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result.
+
+    shared_ptr : Var
+        The shared memory pointer variable.
+
+    offset : Expr
+        The offset of the element to load.
+
+    block_rank : Expr
+        The rank of the thread block in the cluster to load from.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.ptx_ld_shared_cluster", shared_ptr, offset, block_rank)
+
+
 def make_filled_simdgroup_matrix(
     d: Var,
     index: PrimExpr,
@@ -1813,6 +1844,82 @@ def vectorcombine(dtype, vec1, vec2):
     return call_intrin(dtype, "tir.vectorcombine", vec1, vec2)
 
 
+
+def vector_reduce_add(dtype, vec):
+    """Reduce the lanes of a vector by addition
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_add", vec)
+
+
+def vector_reduce_mul(dtype, vec):
+    """Reduce the lanes of a vector by multiplication
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_mul", vec)
+
+
+def vector_reduce_min(dtype, vec):
+    """Reduce the lanes of a vector to their minimum
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_min", vec)
+
+
+def vector_reduce_max(dtype, vec):
+    """Reduce the lanes of a vector to their maximum
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_max", vec)
+
 def dp4a(vec1, vec2, acc=0):
     """Dot product of two int8x4 vectors and add an optional accumulator
 
@@ -1235,8 +1235,11 @@ class Schedule(Object):
         2) All the blocks under the loop are complete blocks or reduction blocks, and have affine
         bindings
         3) For each block under the loop, if the thread axis starts with "threadIdx`, the loop can
-        only be contained in data-parallel block iter and reduction block iters' bindings. Otherwise
-        the loop can only be contained in data-parallel block iters' bindings
+        only be contained in data-parallel block iter and reduction block iters' bindings. If the
+        thread axis starts with "blockIdx" and the loop has a constant extent of at most 8, the
+        reduction block iters are reduced across the thread blocks of a cluster, which requires
+        CUDA sm_90 or later. Otherwise the loop can only be contained in data-parallel block iters'
+        bindings
 
         Parameters
         ----------
@@ -2341,6 +2344,75 @@ class Schedule(Object):
         # pylint: disable-next=no-member
         _ffi_api.ScheduleReverseComputeInline(self, block)  # type: ignore
 
+    @type_checked
+    def fuse_epilogue(self, block: Union[BlockRV, str]) -> None:
+        """Fuse the elementwise epilogue of a block into it. The only consumer of the block is
+        inlined into it by reverse-compute-inline, as long as it can be inlined, and so on with the
+        consumer of the result. The epilogue is then computed on the values that the block holds,
+        e.g. in the registers of the accumulator fragments of a tensor core GEMM, instead of being
+        read back from the buffer. It is a no-op if the consumer cannot be inlined.
+
+        Parameters
+        ----------
+        block : Union[BlockRV, str]
+            The block storing the result that the epilogue consumes
+
+        Examples
+        --------
+
+        Before fuse-epilogue, in TensorIR, the IR is:
+
+        .. code-block:: python
+
+            @T.prim_func
+            def before_fuse_epilogue(
+                A: T.Buffer((128, 128), "float32"),
+                bias: T.Buffer((128,), "float32"),
+                D: T.Buffer((128, 128), "float32"),
+            ) -> None:
+                B = T.alloc_buffer((128, 128))
+                C = T.alloc_buffer((128, 128))
+                for i, j in T.grid(128, 128):
+                    with T.block("B"):
+                        vi, vj = T.axis.remap("SS", [i, j])
+                        B[vi, vj] = A[vi, vj] * 2.0
+                for i, j in T.grid(128, 128):
+                    with T.block("C"):
+                        vi, vj = T.axis.remap("SS", [i, j])
+                        C[vi, vj] = B[vi, vj] + bias[vj]
+                for i, j in T.grid(128, 128):
+                    with T.block("D"):
+                        vi, vj = T.axis.remap("SS", [i, j])
+                        D[vi, vj] = T.max(C[vi, vj], 0.0)
+
+        Create the schedule and do fuse-epilogue:
+
+        .. code-block:: python
+
+            sch = tir.Schedule(before_fuse_epilogue)
+            sch.fuse_epilogue(sch.get_block("B"))
+            print(sch.mod["main"].script())
+
+        After applying fuse-epilogue, the IR becomes:
+
+        .. code-block:: python
+
+            @T.prim_func
+            def after_fuse_epilogue(
+                A: T.Buffer((128, 128), "float32"),
+                bias: T.Buffer((128,), "float32"),
+                D: T.Buffer((128, 128), "float32"),
+            ) -> None:
+                for i, j in T.grid(128, 128):
+                    with T.block("B"):
+                        vi, vj = T.axis.remap("SS", [i, j])
+                        D[vi, vj] = T.max(A[vi, vj] * 2.0 + bias[vj], 0.0)
+
+        """
+        block = self._normalize_block_arg(block)
+        # pylint: disable-next=no-member
+        _ffi_api.ScheduleFuseEpilogue(self, block)  # type: ignore
+
     ########## Schedule: Reduction ##########
 
     @type_checked
@@ -169,6 +169,143 @@ def get_dotprod_intrin(in_dtype, out_dtype):
     return dot_prod_desc, dot_prod_impl
 
 
+def get_mmla_4x4_intrin(lhs_dtype, rhs_dtype, out_dtype):
+    """
+    Create a TensorIntrin computing a 4x4 block of a matrix multiplication
+    C[i, j] += A[i, k] * B[j, k] with the matrix multiply-accumulate instructions
+    (SMMLA, UMMLA and USMMLA of I8MM for 8 bit integers, BFMMLA of BF16).
+
+    Each instruction multiplies the two 64 bit rows of A by the two 64 bit rows of
+    B into a 2x2 block of C, so that the 4x4 block is computed in four accumulators
+    over a reduction of 128 bits, i.e. 16 int8 or 8 bfloat16 elements. The rows of
+    A, B and C are strided, so that plain row-major operands are tensorized without
+    any layout transformation:
+
+    .. code-block:: c
+
+        for (int p = 0; p < 2; ++p) {
+          for (int q = 0; q < 2; ++q) {
+            acc[q] = {C[2p][2q:2q+2], C[2p+1][2q:2q+2]};
+            for (int s = 0; s < 2; ++s)
+              acc[q] = mmla(acc[q], {A[2p][s*K/2:], A[2p+1][s*K/2:]},
+                                    {B[2q][s*K/2:], B[2q+1][s*K/2:]});
+          }
+          C[2p][0:4] = {acc[0][0:2], acc[1][0:2]};
+          C[2p+1][0:4] = {acc[0][2:4], acc[1][2:4]};
+        }
+
+    Parameters
+    ----------
+    lhs_dtype: str
+        The dtype of A, one of int8, uint8 and bfloat16.
+    rhs_dtype: str
+        The dtype of B, int8 or uint8 along with an 8 bit A, bfloat16 otherwise.
+    out_dtype: str
+        The dtype of C, int32 along with an 8 bit A, float32 otherwise.
+
+    Returns
+    -------
+    intrin : (PrimFunc, PrimFunc)
+        The description and the implementation of the TensorIntrin.
+    """
+    if lhs_dtype == "bfloat16":
+        assert rhs_dtype == "bfloat16" and out_dtype == "float32"
+        instr = "llvm.aarch64.neon.bfmmla"
+        # The bfloat16 arithmetic would be legalized to float32, the rows are kept as raw bits
+        storage_dtype = "uint16"
+    else:
+        assert out_dtype == "int32"
+        instr = {
+            ("int8", "int8"): "llvm.aarch64.neon.smmla",
+            ("uint8", "uint8"): "llvm.aarch64.neon.ummla",
+            ("uint8", "int8"): "llvm.aarch64.neon.usmmla",
+        }[(lhs_dtype, rhs_dtype)]
+        storage_dtype = None
+    # The number of elements in the 128 bits of a row of A and B
+    lanes = 8 if lhs_dtype == "bfloat16" else 16
+    K = lanes
+    # The reduction extent of one instruction, i.e. the elements in 64 bits
+    instr_k = lanes // 2
+
+    @T.prim_func
+    def desc(a: T.handle, b: T.handle, c: T.handle) -> None:
+        A = T.match_buffer(a, (4, K), lhs_dtype, offset_factor=1)
+        B = T.match_buffer(b, (4, K), rhs_dtype, offset_factor=1)
+        C = T.match_buffer(c, (4, 4), out_dtype, offset_factor=1)
+        with T.block("root"):
+            T.reads(C[0:4, 0:4], A[0:4, 0:K], B[0:4, 0:K])
+            T.writes(C[0:4, 0:4])
+            for i, j, k in T.grid(4, 4, K):
+                with T.block("update"):
+                    vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                    C[vi, vj] = C[vi, vj] + T.cast(A[vi, vk], out_dtype) * T.cast(
+                        B[vj, vk], out_dtype
+                    )
+
+    def load_rows(buf):
+        rows = []
+        for r in range(4):
+            row = tir.BufferLoad(buf, [r, tir.Ramp(0, 1, lanes)])
+            if storage_dtype is not None:
+                row = tir.reinterpret(f"{storage_dtype}x{lanes}", row)
+            rows.append(row)
+        return rows
+
+    def row_pair(rows, p, s):
+        # The two 64 bit halves of rows 2p and 2p+1 at step s of the reduction
+        first = [s * instr_k + t for t in range(instr_k)]
+        second = [lanes + s * instr_k + t for t in range(instr_k)]
+        return tir.Shuffle([rows[2 * p], rows[2 * p + 1]], first + second)
+
+    def impl():
+        with IRBuilder() as ib:
+            with build_prim_func():
+                a = T.arg("a", T.handle())
+                b = T.arg("b", T.handle())
+                c = T.arg("c", T.handle())
+                A = T.match_buffer(a, (4, K), lhs_dtype, offset_factor=1, strides=[T.int32(), 1])
+                B = T.match_buffer(b, (4, K), rhs_dtype, offset_factor=1, strides=[T.int32(), 1])
+                C = T.match_buffer(c, (4, 4), out_dtype, offset_factor=1, strides=[T.int32(), 1])
+                with T.block("root"):
+                    T.reads(C[0:4, 0:4], A[0:4, 0:K], B[0:4, 0:K])
+                    T.writes(C[0:4, 0:4])
+                    a_rows = load_rows(A)
+                    b_rows = load_rows(B)
+                    c_rows = [tir.BufferLoad(C, [r, tir.Ramp(0, 1, 4)]) for r in range(4)]
+                    for p in range(2):
+                        accs = []
+                        for q in range(2):
+                            acc = tir.Shuffle(
+                                [c_rows[2 * p], c_rows[2 * p + 1]],
+                                [2 * q, 2 * q + 1, 4 + 2 * q, 4 + 2 * q + 1],
+                            )
+                            for s in range(2):
+                                acc = T.call_llvm_pure_intrin(
+                                    f"{out_dtype}x4",
+                                    instr,
+                                    T.uint32(3),
+                                    acc,
+                                    row_pair(a_rows, p, s),
+                                    row_pair(b_rows, q, s),
+                                )
+                            accs.append(acc)
+                        # Both accumulators are bound before rows 2p and 2p+1 of C are overwritten
+                        with T.LetStmt(accs[0]) as acc_0:
+                            with T.LetStmt(accs[1]) as acc_1:
+                                for half in range(2):
+                                    T.buffer_store(
+                                        C,
+                                        tir.Shuffle(
+                                            [acc_0, acc_1],
+                                            [2 * half, 2 * half + 1, 4 + 2 * half, 5 + 2 * half],
+                                        ),
+                                        [2 * p + half, tir.Ramp(0, 1, 4)],
+                                    )
+        return ib.get()
+
+    return desc, impl()
+
+
 def _create_ptrue_mask(dtype):
     """
     Creates a mask that enables all lanes of a scalable vector.
@@ -769,6 +906,24 @@ TensorIntrin.register(ARM_DOT_4x4_i8_SDOT_INTRIN, *get_dotprod_intrin("int8", "i
 TensorIntrin.register(ARM_DOT_4x4_u8_UDOT_INTRIN, *get_dotprod_intrin("uint8", "uint32"))
 TensorIntrin.register(ARM_DOT_4x4_u8_HDOT_INTRIN, *get_dotprod_intrin("uint8", "int32"))
 
+ARM_MMLA_4x4x16_i8_SMMLA_INTRIN = "mmla_4x4x16_i8i8s32_smmla"
+ARM_MMLA_4x4x16_u8_UMMLA_INTRIN = "mmla_4x4x16_u8u8s32_ummla"
+ARM_MMLA_4x4x16_u8i8_USMMLA_INTRIN = "mmla_4x4x16_u8i8s32_usmmla"
+ARM_MMLA_4x4x8_bf16_BFMMLA_INTRIN = "mmla_4x4x8_bf16bf16f32_bfmmla"
+
+TensorIntrin.register(
+    ARM_MMLA_4x4x16_i8_SMMLA_INTRIN, *get_mmla_4x4_intrin("int8", "int8", "int32")
+)
+TensorIntrin.register(
+    ARM_MMLA_4x4x16_u8_UMMLA_INTRIN, *get_mmla_4x4_intrin("uint8", "uint8", "int32")
+)
+TensorIntrin.register(
+    ARM_MMLA_4x4x16_u8i8_USMMLA_INTRIN, *get_mmla_4x4_intrin("uint8", "int8", "int32")
+)
+TensorIntrin.register(
+    ARM_MMLA_4x4x8_bf16_BFMMLA_INTRIN, *get_mmla_4x4_intrin("bfloat16", "bfloat16", "float32")
+)
+
 ARM_SME_INIT = "sme_init"
 ARM_SME_2SVLx2SVL_FP32_TRANSPOSE_INTERLEAVE = "sme_2svlx2svl_fp32_transpose_interleave"
 ARM_SME_BLOCK2_2SVLx1SVL_FP16_TRANSPOSE_INTERLEAVE = (
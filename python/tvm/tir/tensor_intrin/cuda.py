@@ -121,10 +121,12 @@ def get_ldmatrix_intrin(
         # TODO(yixin): Support TN and TT matmul for int8
         assert (
             matrix_name == "B" or not transposed
-        ), "Now only B matrix can be transposed for int8 matmul"
-        assert (
-            k_dim == 32 and dtype == "int8"
-        ), "Only k_dim == 16 (float16) or k_dim == 32 (int8) supported for now"
+        ), "Now only B matrix can be transposed for 8-bit matmul"
+        assert k_dim == 32 and dtype in [
+            "int8",
+            "e4m3_float8",
+            "e5m2_float8",
+        ], "Only k_dim == 16 (float16) or k_dim == 32 (int8 or float8) supported for now"
 
         if matrix_name == "B" and not transposed:
             index_map = shared_32x16_to_ldmatrix_32x16_layout
@@ -260,8 +262,21 @@ TensorIntrin.register(LDMATRIX_i8_B_INTRIN, *get_ldmatrix_intrin(32, "int8", "B"
 LDMATRIX_i8_B_TRANS_INTRIN = "mma_ldmatrix_i8_b_trans"
 TensorIntrin.register(LDMATRIX_i8_B_TRANS_INTRIN, *get_ldmatrix_intrin(32, "int8", "B", True))
 
+# FP8 fragments share the layouts of int8 ones, as both have 8-bit elements
+for _fp8_dtype, _fp8_abbrv in [("e4m3_float8", "e4m3"), ("e5m2_float8", "e5m2")]:
+    for _matrix_name, _transposed in [("A", False), ("B", False), ("B", True)]:
+        _intrin_name = f"mma_ldmatrix_{_fp8_abbrv}_{_matrix_name.lower()}"
+        _intrin_name += "_trans" if _transposed else ""
+        TensorIntrin.register(
+            _intrin_name, *get_ldmatrix_intrin(32, _fp8_dtype, _matrix_name, _transposed)
+        )
+        TensorIntrin.register(
+            _intrin_name + "_dyn",
+            *get_ldmatrix_intrin(32, _fp8_dtype, _matrix_name, _transposed, "shared.dyn"),
+        )
 
-def get_mma_intrin(k_dim, out_dtype, a_transposed, b_transposed):
+
+def get_mma_intrin(k_dim, out_dtype, a_transposed, b_transposed, in_dtype=None):
     local_size = (M_DIM * k_dim) // WARP_SIZE
     local_size_out = (M_DIM * N_DIM) // 32
 
@@ -283,12 +298,14 @@ def get_mma_intrin(k_dim, out_dtype, a_transposed, b_transposed):
 
     out_dtype_abbrv = {"float16": "fp16", "float32": "fp32", "int32": "int32"}[out_dtype]
 
-    if out_dtype in ["float16", "float32"]:
-        in_dtype = "float16"
-        in_dtype_abbrv = "fp16"
-    else:
-        in_dtype = "int8"
-        in_dtype_abbrv = "int8"
+    if in_dtype is None:
+        in_dtype = "float16" if out_dtype in ["float16", "float32"] else "int8"
+    in_dtype_abbrv = {
+        "float16": "fp16",
+        "int8": "int8",
+        "e4m3_float8": "e4m3",
+        "e5m2_float8": "e5m2",
+    }[in_dtype]
 
     def cast_to_out_dtype(v):
         if out_dtype in ["float32", "int32"]:
@@ -469,6 +486,27 @@ TensorIntrin.register(MMA_i8i8i32_INTRIN, *get_mma_intrin(32, "int32", False, Fa
 MMA_i8i8i32_TRANS_B_INTRIN = "mma_i8i8i32_trans_b"
 TensorIntrin.register(MMA_i8i8i32_TRANS_B_INTRIN, *get_mma_intrin(32, "int32", False, True))
 
+# FP8 MMA requires sm_89 or higher
+MMA_e4m3e4m3f32_INTRIN = "mma_e4m3e4m3f32"
+TensorIntrin.register(
+    MMA_e4m3e4m3f32_INTRIN, *get_mma_intrin(32, "float32", False, False, "e4m3_float8")
+)
+
+MMA_e4m3e4m3f32_TRANS_B_INTRIN = "mma_e4m3e4m3f32_trans_b"
+TensorIntrin.register(
+    MMA_e4m3e4m3f32_TRANS_B_INTRIN, *get_mma_intrin(32, "float32", False, True, "e4m3_float8")
+)
+
+MMA_e5m2e5m2f32_INTRIN = "mma_e5m2e5m2f32"
+TensorIntrin.register(
+    MMA_e5m2e5m2f32_INTRIN, *get_mma_intrin(32, "float32", False, False, "e5m2_float8")
+)
+
+MMA_e5m2e5m2f32_TRANS_B_INTRIN = "mma_e5m2e5m2f32_trans_b"
+TensorIntrin.register(
+    MMA_e5m2e5m2f32_TRANS_B_INTRIN, *get_mma_intrin(32, "float32", False, True, "e5m2_float8")
+)
+
 
 def get_mma_fill_intrin(dtype, local_size):
     zero = IntImm("int32", 0).astype(dtype)
@@ -631,7 +669,7 @@ TensorIntrin.register(
 def get_mma_intrin_group(
     load_scope: Literal["shared", "shared.dyn"],
     store_scope: Literal["global", "shared", "shared.dyn"],
-    in_dtype: Literal["float16", "int8"],
+    in_dtype: Literal["float16", "int8", "e4m3_float8", "e5m2_float8"],
     out_dtype: Literal["float16", "float32", "int32"],
     trans_a: bool,
     trans_b: bool,
@@ -678,12 +716,20 @@ def get_mma_intrin_group(
     """
     assert load_scope in ["shared", "shared.dyn"]
     assert store_scope in ["global", "shared", "shared.dyn"]
-    assert in_dtype in ["float16", "int8"]
+    assert in_dtype in ["float16", "int8", "e4m3_float8", "e5m2_float8"]
     assert out_dtype in ["float16", "float32", "int32"]
+    assert "float8" not in in_dtype or out_dtype == "float32", "FP8 MMA accumulates in float32"
 
     shape = "16x16"
 
-    dtype_mapping = {"float16": "f16", "float32": "f32", "int8": "i8", "int32": "i32"}
+    dtype_mapping = {
+        "float16": "f16",
+        "float32": "f32",
+        "int8": "i8",
+        "int32": "i32",
+        "e4m3_float8": "e4m3",
+        "e5m2_float8": "e5m2",
+    }
     in_dtype = dtype_mapping[in_dtype]
     out_dtype = dtype_mapping[out_dtype]
 
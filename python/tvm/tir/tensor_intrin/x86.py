@@ -17,6 +17,9 @@
 # pylint: disable=invalid-name,missing-function-docstring
 """Intrinsics for x86 tensorization."""
 from tvm.script import tir as T
+from tvm.script.ir_builder import IRBuilder
+from tvm.script.ir_builder.tir import prim_func as build_prim_func
+
 from .. import TensorIntrin
 
 
@@ -112,3 +115,139 @@ AVX512_DOT_16x4_INTRIN = "dot_16x4_avx512"
 TensorIntrin.register(
     AVX512_DOT_16x4_INTRIN, dot_product_16x4_u8i8i32_desc, dot_product_16x4_u8i8i32_avx512
 )
+
+
+@T.prim_func
+def dot_product_32x32x128_u8i8i32_desc(
+    A: T.Buffer((32, 128), "uint8", offset_factor=1),
+    B: T.Buffer((2, 32, 16, 4), "int8", offset_factor=1),
+    C: T.Buffer((32, 32), "int32", offset_factor=1),
+) -> None:
+    with T.block("root"):
+        T.reads(C[0:32, 0:32], A[0:32, 0:128], B[0:2, 0:32, 0:16, 0:4])
+        T.writes(C[0:32, 0:32])
+        for i, j, k in T.grid(32, 32, 128):
+            with T.block("update"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                C[vi, vj] = C[vi, vj] + T.cast(A[vi, vk], "int32") * T.cast(
+                    B[vj // 16, vk // 4, vj % 16, vk % 4], "int32"
+                )
+
+
+def get_dot_product_32x32x128_u8i8i32_amx():
+    """The AMX implementation of the 32x32x128 int8 dot product, on the weights packed in the
+    NC16n4c layout of the VNNI schedules, like the TE intrinsic in topi/x86/tensor_intrin.py.
+
+    The four 16x16 accumulators stay in tmm0-3 over the whole reduction, with the rows of the data
+    in tmm4-5 and the columns of the weights in tmm6-7. Unlike the TE intrinsic, the palette of 16
+    rows by 64 bytes is loaded by the intrinsic itself, as the tile configuration is per thread and
+    is lost across the workers of the thread pool.
+    """
+    with IRBuilder() as ib:
+        with build_prim_func():
+            a = T.arg("a", T.handle())
+            b = T.arg("b", T.handle())
+            c = T.arg("c", T.handle())
+            A = T.match_buffer(a, (32, 128), "uint8", offset_factor=1, strides=[T.int32(), 1])
+            B = T.match_buffer(
+                b,
+                (2, 32, 16, 4),
+                "int8",
+                offset_factor=1,
+                strides=[T.int32(), T.int32(), 4, 1],
+            )
+            C = T.match_buffer(c, (32, 32), "int32", offset_factor=1, strides=[T.int32(), 1])
+
+            with T.block("root"):
+                T.reads(C[0:32, 0:32], A[0:32, 0:128], B[0:2, 0:32, 0:16, 0:4])
+                T.writes(C[0:32, 0:32])
+
+                # The 64-byte tile configuration: palette 1, and every tile 16 rows by 64 bytes
+                config_words = [1, 0, 0, 0] + [0x00400040] * 4 + [0] * 4
+                config_words += [0x10101010] * 2 + [0] * 2
+                with T.decl_buffer((16,), "int32", scope="local") as config:
+                    for i, word in enumerate(config_words):
+                        T.buffer_store(config, T.int32(word), [i])
+                    T.evaluate(
+                        T.call_llvm_intrin(
+                            "void", "llvm.x86.ldtilecfg", T.uint32(1), config.access_ptr("r")
+                        )
+                    )
+
+                    def _tile(m_acc, n_acc):
+                        return T.uint8(m_acc * 2 + n_acc)
+
+                    def _c_offset(m_acc, n_acc):
+                        return m_acc * 16 * C.strides[0] + n_acc * 16
+
+                    c_stride = T.uint64(C.strides[0] * 4)
+                    for m_acc in range(2):
+                        for n_acc in range(2):
+                            T.evaluate(
+                                T.call_llvm_intrin(
+                                    "void",
+                                    "llvm.x86.tileloadd64",
+                                    T.uint32(3),
+                                    _tile(m_acc, n_acc),
+                                    C.access_ptr("r", offset=_c_offset(m_acc, n_acc)),
+                                    c_stride,
+                                )
+                            )
+                    for k_tile in range(2):
+                        for n_acc in range(2):
+                            b_offset = n_acc * B.strides[0] + k_tile * 16 * B.strides[1]
+                            T.evaluate(
+                                T.call_llvm_intrin(
+                                    "void",
+                                    "llvm.x86.tileloadd64",
+                                    T.uint32(3),
+                                    T.uint8(n_acc + 6),
+                                    B.access_ptr("r", offset=b_offset),
+                                    T.uint64(B.strides[1]),
+                                )
+                            )
+                        for m_acc in range(2):
+                            a_offset = m_acc * 16 * A.strides[0] + k_tile * 64
+                            T.evaluate(
+                                T.call_llvm_intrin(
+                                    "void",
+                                    "llvm.x86.tileloadd64",
+                                    T.uint32(3),
+                                    T.uint8(m_acc + 4),
+                                    A.access_ptr("r", offset=a_offset),
+                                    T.uint64(A.strides[0]),
+                                )
+                            )
+                            for n_acc in range(2):
+                                T.evaluate(
+                                    T.call_llvm_intrin(
+                                        "void",
+                                        "llvm.x86.tdpbusd",
+                                        T.uint32(3),
+                                        _tile(m_acc, n_acc),
+                                        T.uint8(m_acc + 4),
+                                        T.uint8(n_acc + 6),
+                                    )
+                                )
+                    for m_acc in range(2):
+                        for n_acc in range(2):
+                            T.evaluate(
+                                T.call_llvm_intrin(
+                                    "void",
+                                    "llvm.x86.tilestored64",
+                                    T.uint32(3),
+                                    _tile(m_acc, n_acc),
+                                    C.access_ptr("w", offset=_c_offset(m_acc, n_acc)),
+                                    c_stride,
+                                )
+                            )
+    return ib.get()
+
+
+AMX_DOT_32x32x128_INTRIN = "dot_32x32x128_amx"
+
+TensorIntrin.register(
+    AMX_DOT_32x32x128_INTRIN,
+    dot_product_32x32x128_u8i8i32_desc,
+    get_dot_product_32x32x128_u8i8i32_amx(),
+)
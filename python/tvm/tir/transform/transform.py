@@ -59,6 +59,22 @@ def InjectPrefetch():
     return _ffi_api.InjectPrefetch()  # type: ignore
 
 
+def InjectSoftwarePrefetch():
+    """Inject software prefetches for the streaming accesses of the innermost loops on CPU
+    targets.
+
+    The lookahead distance in bytes is given by the "tir.software_prefetch_distance" config,
+    and overridden by the "pragma_software_prefetch_distance" attribute of the enclosing
+    scopes. A distance of 0 disables the prefetches.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()  # type: ignore
+
+
 def ApplyLayoutTransforms():
     """Reshape buffers that appear in the "layout_transform_map"
     fucntion attribute.
@@ -967,6 +983,34 @@ def FlattenBuffer():
     return _ffi_api.FlattenBuffer()  # type: ignore
 
 
+def InjectSharedMemorySwizzle():
+    """Choose a layout free of bank conflicts for the shared memory buffers, either by XOR
+    swizzling their columns with their rows or by padding their rows, as estimated from the
+    indices that the lanes of a warp access. It applies to the N-d buffers after
+    LowerOpaqueBlock.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSharedMemorySwizzle()  # type: ignore
+
+
+def SpecializeDynamicShape():
+    """Split off a fast path of a dynamic-shape function, specialized for the shape values that
+    are multiples of the tiles inferred from the ceil divisions on them, in which the boundary
+    predicates that always hold are removed. The fast path and the original body are dispatched
+    on the shape values at runtime. It applies after LowerOpaqueBlock.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.SpecializeDynamicShape()  # type: ignore
+
+
 def TransformMmaBufferLayout():
     """Transform mma buffer layout
 
@@ -1045,6 +1089,19 @@ def InjectSoftwarePipeline():
     return _ffi_api.InjectSoftwarePipeline()  # type: ignore
 
 
+def InjectWarpSpecialization():
+    """Lower the software pipelines annotated with `software_pipeline_warp_specialize` into warp
+    specialized pipelines, where additional producer warps run the first stage and hand the
+    versions of the staged buffers over to the consumer warps with mbarriers.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectWarpSpecialization()  # type: ignore
+
+
 def ExtractPrimFuncConstants():
     """Collects and unificates tir non-scalar constants to module's attr 'Constants' array.
 
@@ -305,7 +305,7 @@ def scan_thrust(
     workspace: Optional[tvm.te.Tensor]
         A buffer to store intermediate results. The size of the workspace should be sufficiently
         large, this can be obtained by overestimation or memory usage profiling. If None, it will
-        fallback to use thrust internal memory allocation.
+        fallback to the workspace pool of the device.
 
     Returns
     -------
@@ -391,7 +391,7 @@ def exclusive_scan(
     workspace: Optional[tvm.te.Tensor]
         A buffer to store intermediate results if thrust is enabled. The size of the workspace
         should be sufficiently large, this can be obtained by overestimation or memory usage
-        profiling. If None, it will fallback to use thrust internal memory allocation.
+        profiling. If None, it will fallback to the workspace pool of the device.
 
     Returns
     -------
@@ -516,7 +516,7 @@ def inclusive_scan(
     workspace: Optional[tvm.te.Tensor]
         A buffer to store intermediate results if thrust is enabled. The size of the workspace
         should be sufficiently large, this can be obtained by overestimation or memory usage
-        profiling. If None, it will fallback to use thrust internal memory allocation.
+        profiling. If None, it will fallback to the workspace pool of the device.
 
     Returns
     -------
@@ -692,7 +692,7 @@ def cumsum(
     workspace: Optional[tvm.te.Tensor]
         A buffer to store intermediate results if thrust is enabled. The size of the workspace
         should be sufficiently large, this can be obtained by overestimation or memory usage
-        profiling. If None, it will fallback to use thrust internal memory allocation.
+        profiling. If None, it will fallback to the workspace pool of the device.
 
     Returns
     -------
@@ -742,7 +742,7 @@ def cumprod(
     workspace: Optional[tvm.te.Tensor]
         A buffer to store intermediate results if thrust is enabled. The size of the workspace
         should be sufficiently large, this can be obtained by overestimation or memory usage
-        profiling. If None, it will fallback to use thrust internal memory allocation.
+        profiling. If None, it will fallback to the workspace pool of the device.
 
     Returns
     -------
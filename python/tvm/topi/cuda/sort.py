@@ -697,7 +697,7 @@ def sort_thrust(data, axis=-1, is_ascend=1, workspace=None):
     workspace: Optional[tvm.te.Tensor]
         A buffer to store intermediate results. The size of the workspace should be sufficiently
         large, this can be obtained by overestimation or memory usage profiling. If None, it will
-        fallback to use thrust internal memory allocation.
+        fallback to the workspace pool of the device.
 
 
     Returns
@@ -835,7 +835,7 @@ def argsort_thrust(data, axis=-1, is_ascend=1, dtype="float32", ret_type="indice
     workspace : Optional[tvm.te.Tensor]
         A buffer to store intermediate results. The size of the workspace should be sufficiently
         large, this can be obtained by overestimation or memory usage profiling. If None, it will
-        fallback to use thrust internal memory allocation.
+        fallback to the workspace pool of the device.
 
     Returns
     -------
@@ -1016,7 +1016,7 @@ def topk_thrust(
     workspace : Optional[tvm.te.Tensor]
         A buffer to store intermediate results. The size of the workspace should be sufficiently
         large, this can be obtained by overestimation or memory usage profiling. If None, it will
-        fallback to use thrust internal memory allocation.
+        fallback to the workspace pool of the device.
 
     Returns
     -------
@@ -1173,7 +1173,7 @@ def stable_sort_by_key_thrust(keys, values, for_scatter=False, workspace=None):
     workspace : Optional[tvm.te.Tensor]
         A buffer to store intermediate results. The size of the workspace should be sufficiently
         large, this can be obtained by overestimation or memory usage profiling. If None, it will
-        fallback to use thrust internal memory allocation.
+        fallback to the workspace pool of the device.
 
     Returns
     -------
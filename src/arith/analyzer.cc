@@ -21,6 +21,7 @@
  * \file tvm/arith/analyzer.cc
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
@@ -32,12 +33,24 @@
 namespace tvm {
 namespace arith {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.simplify_step_budget", Integer);
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
       rewrite_simplify(this),
       canonical_simplify(this),
-      int_set(this) {}
+      int_set(this) {
+  // The budget keeps the passes from spending unbounded time on pathological expressions
+  int64_t step_budget = transform::PassContext::Current()
+                            ->GetConfig<Integer>("tir.simplify_step_budget", Integer(0))
+                            .value()
+                            ->value;
+  if (step_budget > 0) {
+    rewrite_simplify.SetStepBudget(step_budget);
+    canonical_simplify.SetStepBudget(step_budget);
+  }
+}
 
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   PrimExpr new_expr = expr;
@@ -306,6 +319,20 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "canonical_simplify") {
       return PackedFunc(
           [self](TVMArgs args, TVMRetValue* ret) { *ret = self->canonical_simplify(args[0]); });
+    } else if (name == "get_canonical_simplify_stats") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
+        *ret = self->canonical_simplify.GetStatsCounters();
+      });
+    } else if (name == "reset_canonical_simplify_stats") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
+        self->canonical_simplify.ResetStatsCounters();
+      });
+    } else if (name == "set_simplify_step_budget") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
+        int64_t budget = args[0];
+        self->rewrite_simplify.SetStepBudget(budget);
+        self->canonical_simplify.SetStepBudget(budget);
+      });
     } else if (name == "int_set") {
       return PackedFunc(
           [self](TVMArgs args, TVMRetValue* ret) { *ret = self->int_set(args[0], args[1]); });
@@ -1438,6 +1438,7 @@ PrimExpr CanonicalSimplifier::Impl::VisitExpr_(const LTNode* op) {
 }
 
 PrimExpr CanonicalSimplifier::operator()(const PrimExpr& expr) {
+  RewriteSimplifier::Impl::StepBudgetScope budget(impl_, expr);
   return impl_->CanonicalSimplify(expr);
 }
 
@@ -1445,6 +1446,12 @@ void CanonicalSimplifier::Update(const Var& var, const PrimExpr& info, bool over
   impl_->Update(var, info, override);
 }
 
+ObjectRef CanonicalSimplifier::GetStatsCounters() const { return impl_->GetStatsCounters(); }
+
+void CanonicalSimplifier::ResetStatsCounters() { impl_->ResetStatsCounters(); }
+
+void CanonicalSimplifier::SetStepBudget(int64_t budget) { impl_->SetStepBudget(budget); }
+
 CanonicalSimplifier::CanonicalSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
 
 CanonicalSimplifier::~CanonicalSimplifier() { delete impl_; }
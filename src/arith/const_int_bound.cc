@@ -27,6 +27,8 @@
 
 #include <algorithm>
 #include <optional>
+#include <unordered_map>
+#include <utility>
 
 #include "constraint_extract.h"
 #include "int_operator.h"
@@ -130,6 +132,7 @@ class ConstIntBoundAnalyzer::Impl
       }
     }
     var_map_[var] = info;
+    memo_.clear();
   }
 
   Entry VisitExpr_(const LetNode* op) final {
@@ -137,8 +140,10 @@ class ConstIntBoundAnalyzer::Impl
     // if the var has not been binded, update the info.
     if (it == var_map_.end()) {
       var_map_[op->var] = this->VisitExpr(op->value);
+      memo_.clear();
       Entry ret = VisitExpr(op->body);
       var_map_.erase(op->var);
+      memo_.clear();
       return ret;
     } else {
       return VisitExpr(op->body);
@@ -155,6 +160,18 @@ class ConstIntBoundAnalyzer::Impl
   }
 
   Entry VisitExpr(const PrimExpr& expr) final {
+    // Leaves are cheaper to analyze than to memoize
+    bool use_memo = bound_ == nullptr && !expr->IsInstance<IntImmNode>() &&
+                    !expr->IsInstance<VarNode>();
+    if (use_memo) {
+      auto it = memo_.find(expr);
+      if (it != memo_.end()) {
+        ++memo_hits_;
+        return it->second;
+      }
+      ++memo_misses_;
+    }
+    int64_t num_uncacheable = num_uncacheable_;
     Entry res = ExprFunctor::VisitExpr(expr);
     tir::ExprDeepEqual equal;
     // a linear search over additional info
@@ -176,6 +193,12 @@ class ConstIntBoundAnalyzer::Impl
       }
       (*bound_)[expr] = ConstIntBound(res.min_value, res.max_value);
     }
+    if (use_memo && num_uncacheable == num_uncacheable_) {
+      if (memo_.size() >= kMaxMemoSize) {
+        memo_.clear();
+      }
+      memo_[expr] = res;
+    }
     return res;
   }
 
@@ -370,7 +393,12 @@ class ConstIntBoundAnalyzer::Impl
       return VisitLeftShift(op);
     } else if (op->op.same_as(tir::builtin::bitwise_and())) {
       return VisitBitwiseAnd(op);
-    } else if (op->op.same_as(tir::builtin::vscale()) && TargetHasSVE(Target::Current())) {
+    } else if (op->op.same_as(tir::builtin::vscale())) {
+      // The bound depends on the current target
+      ++num_uncacheable_;
+      if (!TargetHasSVE(Target::Current())) {
+        return Everything(op->dtype);
+      }
       unsigned int max_val =
           *std::max_element(kAArch64VScaleValues.begin(), kAArch64VScaleValues.end());
       return MakeBound(1, max_val);
@@ -441,10 +469,12 @@ class ConstIntBoundAnalyzer::Impl
     if (info.size() == 0) return nullptr;
     size_t old_size = additional_info_.size();
     additional_info_.insert(additional_info_.end(), info.begin(), info.end());
+    memo_.clear();
     size_t new_size = old_size + info.size();
     auto frecover = [old_size, new_size, this]() {
       ICHECK_EQ(additional_info_.size(), new_size);
       additional_info_.resize(old_size);
+      memo_.clear();
     };
     return frecover;
   }
@@ -457,6 +487,15 @@ class ConstIntBoundAnalyzer::Impl
   std::vector<BoundInfo> additional_info_;
   // look up table for memorization
   BoundMapType* bound_{nullptr};
+  // The bounds of the expressions analyzed since the state last changed, keyed by object
+  std::unordered_map<PrimExpr, Entry, ObjectPtrHash, ObjectPtrEqual> memo_;
+  // The number of memoized bounds that were reused and computed
+  int64_t memo_hits_{0};
+  int64_t memo_misses_{0};
+  // The number of bounds that depended on state outside of the analyzer, e.g. the target
+  int64_t num_uncacheable_{0};
+  // The memo is dropped when it grows beyond this size, bounding the expressions it keeps alive
+  static constexpr size_t kMaxMemoSize = 16384;
   // constants: the limit value means umlimited
   // NOTE: kNegInf/kPosInf are used to represent infinity.
   static const constexpr int64_t kNegInf = ConstIntBound::kNegInf;
@@ -796,6 +835,15 @@ std::function<void()> ConstIntBoundAnalyzer::EnterConstraint(const PrimExpr& con
   return impl_->EnterConstraint(constraint);
 }
 
+std::pair<int64_t, int64_t> ConstIntBoundAnalyzer::GetMemoStats() const {
+  return {impl_->memo_hits_, impl_->memo_misses_};
+}
+
+void ConstIntBoundAnalyzer::ResetMemoStats() {
+  impl_->memo_hits_ = 0;
+  impl_->memo_misses_ = 0;
+}
+
 ConstIntBoundAnalyzer::ConstIntBoundAnalyzer(Analyzer* parent) : impl_(new Impl()) {}
 
 ConstIntBoundAnalyzer::~ConstIntBoundAnalyzer() { delete impl_; }
@@ -111,6 +111,7 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
       }
     }
     var_map_[var] = Entry(info->coeff, info->base);
+    memo_.clear();
   }
 
   // Detect useful constraints and use them in the analysis scope.
@@ -130,6 +131,28 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
     return nullptr;
   }
 
+  Entry VisitExpr(const PrimExpr& expr) final {
+    // Leaves are cheaper to analyze than to memoize
+    if (expr->IsInstance<IntImmNode>() || expr->IsInstance<VarNode>()) {
+      return ExprFunctor::VisitExpr(expr);
+    }
+    auto it = memo_.find(expr);
+    if (it != memo_.end()) {
+      ++memo_hits_;
+      return it->second;
+    }
+    ++memo_misses_;
+    int64_t num_uncacheable = num_uncacheable_;
+    Entry res = ExprFunctor::VisitExpr(expr);
+    if (num_uncacheable == num_uncacheable_) {
+      if (memo_.size() >= kMaxMemoSize) {
+        memo_.clear();
+      }
+      memo_[expr] = res;
+    }
+    return res;
+  }
+
   // Override visitor behaviors
   Entry VisitExprDefault_(const Object* op) final { return Everything(); }
 
@@ -138,8 +161,10 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
     // if the var has not been binded, update the info.
     if (it == var_map_.end()) {
       var_map_[op->var] = this->VisitExpr(op->value);
+      memo_.clear();
       Entry ret = VisitExpr(op->body);
       var_map_.erase(op->var);
+      memo_.clear();
       return ret;
     } else {
       return VisitExpr(op->body);
@@ -188,7 +213,7 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
       }
       // positive division have a clear rounding mode.
       // Only handle case where we clearly know we need to round down.
-      if (a.base > 0 && val > 0 && (round_down || parent_->CanProveGreaterEqual(lhs, 0))) {
+      if (a.base > 0 && val > 0 && (round_down || ProveNonNegative(lhs))) {
         return Entry(a.coeff / val, a.base / val);
       }
     }
@@ -234,7 +259,7 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
     ICHECK_NE(val, 0);
     int64_t coeff = ZeroAwareGCD(a.coeff, val);
     if (a.base % coeff == 0 ||
-        (a.base > 0 && (round_down || parent_->CanProveGreaterEqual(lhs, 0)))) {
+        (a.base > 0 && (round_down || ProveNonNegative(lhs)))) {
       return Entry(coeff, a.base % coeff);
     }
     return Everything();
@@ -299,10 +324,30 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
   }
 
  private:
+  friend class ModularSetAnalyzer;
   /*! \brief pointer to parent. */
   Analyzer* parent_{nullptr};
   // internal variable map
   std::unordered_map<Var, Entry> var_map_;
+  // The sets of the expressions analyzed since the state last changed, keyed by object
+  std::unordered_map<PrimExpr, Entry, ObjectPtrHash, ObjectPtrEqual> memo_;
+  // The number of memoized sets that were reused and computed
+  int64_t memo_hits_{0};
+  int64_t memo_misses_{0};
+  // The number of sets that depended on the state of the parent analyzer
+  int64_t num_uncacheable_{0};
+  // The memo is dropped when it grows beyond this size, bounding the expressions it keeps alive
+  static constexpr size_t kMaxMemoSize = 16384;
+  /*!
+   * \brief Prove that an expression is non-negative with the parent analyzer.
+   * \param expr The expression.
+   * \return Whether the expression is proven to be non-negative.
+   */
+  bool ProveNonNegative(const PrimExpr& expr) {
+    // The parent analyzer can change without notifying this one
+    ++num_uncacheable_;
+    return parent_->CanProveGreaterEqual(expr, 0);
+  }
   /*!
    * \brief Update var by intersecting entry with var's current set.
    * \param var The variable.
@@ -316,8 +361,12 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
       old = it->second;
     }
     var_map_[var] = Intersect(old, entry);
+    memo_.clear();
     // reover function.
-    return [this, old, var]() { var_map_[var] = old; };
+    return [this, old, var]() {
+      var_map_[var] = old;
+      memo_.clear();
+    };
   }
   /*!
    * \brief Create union of two sets.
@@ -391,6 +440,15 @@ std::function<void()> ModularSetAnalyzer::EnterConstraint(const PrimExpr& constr
   return impl_->EnterConstraint(constraint);
 }
 
+std::pair<int64_t, int64_t> ModularSetAnalyzer::GetMemoStats() const {
+  return {impl_->memo_hits_, impl_->memo_misses_};
+}
+
+void ModularSetAnalyzer::ResetMemoStats() {
+  impl_->memo_hits_ = 0;
+  impl_->memo_misses_ = 0;
+}
+
 ModularSetAnalyzer::ModularSetAnalyzer(Analyzer* parent) : impl_(new Impl(parent)) {}
 
 ModularSetAnalyzer::~ModularSetAnalyzer() { delete impl_; }
@@ -367,6 +367,9 @@ CompareResult RewriteSimplifier::Impl::TryCompare(const PrimExpr& x, int64_t val
 
 PrimExpr RewriteSimplifier::Impl::VisitExpr(const PrimExpr& e) {
   stats_.nodes_visited++;
+  if (CountStep()) {
+    return e;
+  }
   return IRMutatorWithAnalyzer::VisitExpr(e);
 }
 
@@ -2394,6 +2397,7 @@ PrimExpr RewriteSimplifier::Impl::VisitExpr_(const LetNode* op) {
 
 PrimExpr RewriteSimplifier::operator()(const PrimExpr& expr) {
   // Run simplification in post order
+  Impl::StepBudgetScope budget(impl_, expr);
   PrimExpr res = expr;
   int max_iter = 2;
   for (int i = 0; i < max_iter; ++i) {
@@ -2427,6 +2431,8 @@ void RewriteSimplifier::SetMaximumRewriteSteps(int64_t maximum) {
   impl_->SetMaximumRewriteSteps(maximum);
 }
 
+void RewriteSimplifier::SetStepBudget(int64_t budget) { impl_->SetStepBudget(budget); }
+
 RewriteSimplifier::RewriteSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
 
 RewriteSimplifier::~RewriteSimplifier() { delete impl_; }
@@ -2441,7 +2447,8 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
                 << ", rewrites_attempted = " << ptr->rewrites_attempted
                 << ", rewrites_performed = " << ptr->rewrites_performed
                 << ", max_recursive_depth = " << ptr->max_recursive_depth
-                << ", num_recursive_rewrites = " << ptr->num_recursive_rewrites << ")";
+                << ", num_recursive_rewrites = " << ptr->num_recursive_rewrites
+                << ", budget_exceeded = " << ptr->budget_exceeded << ")";
     });
 
 }  // namespace arith
@@ -28,6 +28,7 @@
 #include <tvm/tir/op.h>
 
 #include <algorithm>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -52,6 +53,14 @@ struct RewriteSimplifierStatsNode : Object {
   int64_t rewrites_performed{0};
   int64_t max_recursive_depth{0};
   int64_t num_recursive_rewrites{0};
+  int64_t const_int_bound_memo_hits{0};
+  int64_t const_int_bound_memo_misses{0};
+  int64_t modular_set_memo_hits{0};
+  int64_t modular_set_memo_misses{0};
+  /*! \brief The number of simplifications stopped by the step budget. */
+  int64_t budget_exceeded{0};
+  /*! \brief The first expressions whose simplification was stopped by the step budget. */
+  Array<PrimExpr> budget_exceeded_exprs;
 
   void VisitAttrs(AttrVisitor* v) {
     v->Visit("nodes_visited", &nodes_visited);
@@ -60,6 +69,12 @@ struct RewriteSimplifierStatsNode : Object {
     v->Visit("rewrites_performed", &rewrites_performed);
     v->Visit("max_recursive_depth", &max_recursive_depth);
     v->Visit("num_recursive_rewrites", &num_recursive_rewrites);
+    v->Visit("const_int_bound_memo_hits", &const_int_bound_memo_hits);
+    v->Visit("const_int_bound_memo_misses", &const_int_bound_memo_misses);
+    v->Visit("modular_set_memo_hits", &modular_set_memo_hits);
+    v->Visit("modular_set_memo_misses", &modular_set_memo_misses);
+    v->Visit("budget_exceeded", &budget_exceeded);
+    v->Visit("budget_exceeded_exprs", &budget_exceeded_exprs);
   }
 
   static constexpr const char* _type_key = "arith.RewriteSimplifierStats";
@@ -125,19 +140,89 @@ class RewriteSimplifier::Impl : public IRMutatorWithAnalyzer {
   /*! \brief Return the currently enabled extensions */
   Extension GetEnabledExtensions() const;
 
-  RewriteSimplifierStats GetStatsCounters() const { return RewriteSimplifierStats(stats_); }
+  RewriteSimplifierStats GetStatsCounters() const {
+    RewriteSimplifierStatsNode stats = stats_;
+    std::tie(stats.const_int_bound_memo_hits, stats.const_int_bound_memo_misses) =
+        analyzer_->const_int_bound.GetMemoStats();
+    std::tie(stats.modular_set_memo_hits, stats.modular_set_memo_misses) =
+        analyzer_->modular_set.GetMemoStats();
+    return RewriteSimplifierStats(stats);
+  }
 
-  void ResetStatsCounters() { stats_ = {}; }
+  void ResetStatsCounters() {
+    stats_ = {};
+    analyzer_->const_int_bound.ResetMemoStats();
+    analyzer_->modular_set.ResetMemoStats();
+  }
 
   void SetMaximumRewriteSteps(int64_t maximum) { maximum_rewrite_steps_ = maximum; }
 
+  void SetStepBudget(int64_t budget) { step_budget_ = budget; }
+
+  /*!
+   * \brief The scope of a top-level simplification, to which the step budget applies.
+   *
+   * Once the budget is exhausted, the remaining subexpressions are returned unchanged, and the
+   * expression that was being simplified is reported in the stats when the scope exits.
+   */
+  class StepBudgetScope {
+   public:
+    StepBudgetScope(Impl* self, const PrimExpr& expr) : self_(self), expr_(expr) {
+      if (self_->budget_depth_++ == 0) {
+        self_->num_steps_ = 0;
+      }
+    }
+    ~StepBudgetScope() {
+      if (--self_->budget_depth_ == 0 && self_->budget_exhausted_) {
+        self_->budget_exhausted_ = false;
+        self_->RecordBudgetExceeded(expr_);
+      }
+    }
+
+   private:
+    Impl* self_;
+    const PrimExpr& expr_;
+  };
+
  protected:
   int64_t maximum_rewrite_steps_{0};
   RewriteSimplifierStatsNode stats_;
 
+  /*! \brief The maximum number of steps of a top-level simplification, or 0 for no limit. */
+  int64_t step_budget_{0};
+  /*! \brief The steps taken by the current top-level simplification. */
+  int64_t num_steps_{0};
+  /*! \brief The number of nested StepBudgetScope. */
+  int budget_depth_{0};
+  /*! \brief Whether the current top-level simplification has exhausted the step budget. */
+  bool budget_exhausted_{false};
+
+  /*! \brief The number of expressions reported in budget_exceeded_exprs. */
+  static constexpr size_t kMaxReportedBudgetExceeded = 16;
+
+  /*! \brief Count a step, returning true if the step budget is exhausted. */
+  bool CountStep() {
+    if (step_budget_ <= 0 || budget_depth_ == 0) {
+      return false;
+    }
+    if (budget_exhausted_ || ++num_steps_ > step_budget_) {
+      budget_exhausted_ = true;
+    }
+    return budget_exhausted_;
+  }
+
+  void RecordBudgetExceeded(const PrimExpr& expr) {
+    stats_.budget_exceeded++;
+    if (stats_.budget_exceeded_exprs.size() < kMaxReportedBudgetExceeded) {
+      stats_.budget_exceeded_exprs.push_back(expr);
+    }
+    VLOG(1) << "Simplification stopped after " << step_budget_ << " steps: " << expr;
+  }
+
   void RecordAttemptedRewrite() { stats_.rewrites_attempted++; }
   void RecordRewrite() {
     stats_.rewrites_performed++;
+    CountStep();
 
     ICHECK(maximum_rewrite_steps_ <= 0 || stats_.rewrites_performed <= maximum_rewrite_steps_)
         << "RewriteSimplifier exceeded maximum number of rewrites allowed ("
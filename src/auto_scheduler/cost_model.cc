@@ -23,6 +23,16 @@
  */
 
 #include <tvm/auto_scheduler/cost_model.h>
+#include <tvm/auto_scheduler/feature.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../support/tree_ensemble.h"
 
 namespace tvm {
 namespace auto_scheduler {
@@ -145,6 +155,120 @@ void PythonBasedModelNode::PredictStages(const SearchTask& task, const Array<Sta
   }
 }
 
+/*!
+ * \brief A cost model predicting with a tree ensemble natively, trained on the python side. The
+ * scores of the states are predicted as in XGBModel: the sum of the predictions for their stores.
+ */
+class TreeEnsembleModelNode : public CostModelNode {
+ public:
+  using FUpdate = TypedPackedFunc<Optional<Array<runtime::NDArray>>(const Array<MeasureInput>&,
+                                                                     const Array<MeasureResult>&)>;
+
+  /*! \brief The number of buffers whose features are extracted, as DEFAULT_MAX_N_BUFS in python. */
+  static constexpr int kMaxNumBuffers = 5;
+
+  /*! \brief The packed function updating the trainer, returning the retrained ensemble if any. */
+  FUpdate f_update;
+
+  void Update(const Array<MeasureInput>& inputs, const Array<MeasureResult>& results) final {
+    if (Optional<Array<runtime::NDArray>> ensemble = f_update(inputs, results)) {
+      ensemble_.Set(ensemble);
+    }
+  }
+
+  void Predict(const SearchTask& task, const Array<State>& states,
+               std::vector<float>* scores) final {
+    int n = states.size();
+    std::vector<std::vector<float>> features;
+    GetPerStoreFeaturesFromStates(states, task, 0, kMaxNumBuffers, &features);
+    scores->assign(n, 0.0f);
+    if (ensemble_.empty()) {
+      // Not trained yet, the search is guided by random scores as in XGBModel
+      std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+      for (float& score : *scores) {
+        score = dist(rand_gen_);
+      }
+    }
+    // Step 1. Flatten the feature vectors of the stores, in the format of
+    // GetPerStoreFeaturesFromStates: the number of stores followed by their feature vectors
+    std::vector<const float*> rows;
+    std::vector<int> row_begin(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+      const std::vector<float>& feature = features[i];
+      row_begin[i + 1] = rows.size();
+      // The states that failed to be lowered have no features
+      if (feature.empty() ||
+          std::all_of(feature.begin() + 1, feature.end(), [](float x) { return x == 0.0f; })) {
+        (*scores)[i] = -std::numeric_limits<float>::infinity();
+        continue;
+      }
+      if (ensemble_.empty()) {
+        continue;
+      }
+      int num_stores = static_cast<int>(feature[0] + 0.5f);
+      int length = (feature.size() - 1) / num_stores;
+      ICHECK_EQ(length * num_stores + 1, feature.size());
+      ICHECK_GT(length, ensemble_.max_feature())
+          << "ValueError: The tree ensemble splits on feature " << ensemble_.max_feature()
+          << ", but the feature vectors have length " << length;
+      for (int r = 0; r < num_stores; ++r) {
+        rows.push_back(feature.data() + 1 + r * length);
+      }
+      row_begin[i + 1] = rows.size();
+    }
+    // Step 2. Predict blocks of feature vectors in parallel
+    int num_rows = rows.size();
+    constexpr int kRowsPerBlock = support::TreeEnsemble::kRowsPerBlock;
+    int num_blocks = (num_rows + kRowsPerBlock - 1) / kRowsPerBlock;
+    std::vector<float> row_scores(num_rows, 0.0f);
+    support::parallel_for(0, num_blocks, [&](int block) {
+      int begin = block * kRowsPerBlock;
+      int end = std::min(begin + kRowsPerBlock, num_rows);
+      ensemble_.PredictRows(rows.data() + begin, end - begin, row_scores.data() + begin);
+    });
+    // Step 3. Sum up the predictions of each state
+    for (int i = 0; i < n; ++i) {
+      if (row_begin[i] == row_begin[i + 1]) {
+        continue;
+      }
+      float score = 0.0f;
+      for (int r = row_begin[i]; r < row_begin[i + 1]; ++r) {
+        score += row_scores[r];
+      }
+      (*scores)[i] = score;
+    }
+  }
+
+  /*! \brief Replace the tree ensemble, see support::TreeEnsemble for the format. */
+  void SetEnsemble(const Optional<Array<runtime::NDArray>>& ensemble) { ensemble_.Set(ensemble); }
+
+  static constexpr const char* _type_key = "auto_scheduler.TreeEnsembleModel";
+  TVM_DECLARE_FINAL_OBJECT_INFO(TreeEnsembleModelNode, CostModelNode);
+
+ private:
+  /*! \brief The tree ensemble, empty if the model is not trained. */
+  support::TreeEnsemble ensemble_;
+  /*! \brief The random generator of the predictions before training. */
+  std::mt19937 rand_gen_{std::random_device()()};
+};
+
+TVM_REGISTER_OBJECT_TYPE(TreeEnsembleModelNode);
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TreeEnsembleModel")
+    .set_body_typed([](TreeEnsembleModelNode::FUpdate f_update) {
+      ObjectPtr<TreeEnsembleModelNode> node = make_object<TreeEnsembleModelNode>();
+      node->f_update = std::move(f_update);
+      return CostModel(node);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TreeEnsembleModelSetEnsemble")
+    .set_body_typed([](CostModel model, Optional<Array<runtime::NDArray>> ensemble) {
+      const auto* node = model.as<TreeEnsembleModelNode>();
+      ICHECK(node != nullptr) << "TypeError: Expect a TreeEnsembleModel, but got "
+                              << model->GetTypeKey();
+      const_cast<TreeEnsembleModelNode*>(node)->SetEnsemble(ensemble);
+    });
+
 TVM_REGISTER_GLOBAL("auto_scheduler.RandomModel").set_body_typed([]() { return RandomModel(); });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.PythonBasedModel")
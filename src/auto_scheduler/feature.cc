@@ -22,6 +22,7 @@
  * \brief Feature extraction for the cost model
  */
 
+#include <dmlc/json.h>
 #include <tvm/arith/analyzer.h>
 #include <tvm/auto_scheduler/feature.h>
 #include <tvm/auto_scheduler/measure.h>
@@ -40,8 +41,13 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <list>
+#include <mutex>
 #include <numeric>
+#include <sstream>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "search_policy/utils.h"
@@ -1360,8 +1366,114 @@ void GetPerStoreFeatureName(int max_n_bufs, std::vector<std::string>* ret) {
   // section total : 3
 }
 
-void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, int max_n_bufs,
-                                   std::vector<float>* feature, std::atomic<int>* error_ct) {
+/*!
+ * \brief The features of the states extracted recently, shared by all the searches of the process.
+ * The evolutionary search scores the same states over and over as its population carries over
+ * from one iteration to the next, and lowering a state dominates the cost of its features.
+ */
+class FeatureCache {
+ public:
+  /*! \brief The number of states whose features are kept. */
+  static constexpr size_t kCapacity = 4096;
+
+  static FeatureCache* Global() {
+    static FeatureCache inst;
+    return &inst;
+  }
+
+  /*!
+   * \brief Describe everything that the features of a state depend on. The compute DAG is
+   * described by its printout, as tasks created by hand may share a workload key across DAGs.
+   */
+  static std::string Key(const SearchTask& task, const State& state, int max_n_bufs) {
+    auto pass_ctx = tvm::transform::PassContext::Current();
+    bool disable_vectorize =
+        pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
+    bool instrument_bound_checkers =
+        pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
+    const HardwareParams& hardware_params = task->hardware_params;
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginArray(false);
+    writer.WriteArrayItem(std::string(task->compute_dag.PrintDAG()));
+    // The printout of the DAG omits the data types
+    std::ostringstream dtypes;
+    for (const te::Operation& op : task->compute_dag->ops) {
+      for (int i = 0; i < op->num_outputs(); ++i) {
+        dtypes << op.output(i)->dtype << ",";
+      }
+    }
+    writer.WriteArrayItem(dtypes.str());
+    writer.WriteArrayItem(std::string(task->target->str()));
+    writer.WriteArrayItem(hardware_params->vector_unit_bytes);
+    writer.WriteArrayItem(hardware_params->cache_line_bytes);
+    writer.WriteArrayItem(hardware_params->max_shared_memory_per_block);
+    writer.WriteArrayItem(hardware_params->max_local_memory_per_block);
+    writer.WriteArrayItem(hardware_params->max_threads_per_block);
+    writer.WriteArrayItem(hardware_params->max_vthread_extent);
+    writer.WriteArrayItem(max_n_bufs);
+    writer.WriteArrayItem(static_cast<int>(disable_vectorize));
+    writer.WriteArrayItem(static_cast<int>(instrument_bound_checkers));
+    writer.WriteArraySeperator();
+    writer.BeginArray(false);
+    for (const Step& step : state->transform_steps) {
+      writer.WriteArraySeperator();
+      writer.BeginArray(false);
+      step->WriteToRecord(&writer);
+      writer.EndArray();
+    }
+    writer.EndArray();
+    writer.EndArray();
+    return os.str();
+  }
+
+  /*! \brief Look up the features of a state, returning whether they are cached. */
+  bool Get(const std::string& key, std::vector<float>* feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    *feature = it->second->second;
+    return true;
+  }
+
+  /*! \brief Cache the features of a state, evicting the least recently used ones. */
+  void Set(const std::string& key, const std::vector<float>& feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+    entries_.emplace_front(key, feature);
+    index_.emplace(key, entries_.begin());
+    if (entries_.size() > kCapacity) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  /*! \brief Drop all the cached features. */
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+  }
+
+ private:
+  std::mutex mutex_;
+  /*! \brief The cached features, the most recently used first. */
+  std::list<std::pair<std::string, std::vector<float>>> entries_;
+  /*! \brief The entry of each key. */
+  std::unordered_map<std::string, std::list<std::pair<std::string, std::vector<float>>>::iterator>
+      index_;
+};
+
+/*! \brief Lower a state and extract its features, leaving them empty if the lowering fails. */
+static void ExtractPerStoreFeatures(const SearchTask& task, const State& state, int max_n_bufs,
+                                    std::vector<float>* feature, std::atomic<int>* error_ct) {
   auto [sch, tensors] = task->compute_dag.ApplySteps(state->transform_steps);
 
   // When inlining, replace const matrices with const values.
@@ -1420,6 +1532,16 @@ void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, i
   }
 }
 
+void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, int max_n_bufs,
+                                   std::vector<float>* feature, std::atomic<int>* error_ct) {
+  std::string cache_key = FeatureCache::Key(task, state, max_n_bufs);
+  if (FeatureCache::Global()->Get(cache_key, feature)) {
+    return;
+  }
+  ExtractPerStoreFeatures(task, state, max_n_bufs, feature, error_ct);
+  FeatureCache::Global()->Set(cache_key, *feature);
+}
+
 void GetPerStoreFeaturesFromStates(const Array<State>& states, const SearchTask& task,
                                    int skip_first_n_feature_extraction, int max_n_bufs,
                                    std::vector<std::vector<float>>* features) {
@@ -1741,6 +1863,10 @@ TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeatureNames")
       *ret = arr;
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.ClearFeatureCache").set_body_typed([]() {
+  FeatureCache::Global()->Clear();
+});
+
 TVM_REGISTER_GLOBAL("auto_scheduler.FeaturesFromPrimFunc")
     .set_body_typed([](const PrimFunc& func, int cache_line_size, int max_n_bufs, bool log_scale) {
       std::vector<float> vec;
@@ -0,0 +1,209 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file build_cache.cc
+ * \brief The on-disk cache of the modules built by TIRToRuntime.
+ *
+ * Each entry is a single file named after the hash of its key, holding
+ *  - the version of TVM and the canonical key, checked on load against hash collisions;
+ *  - the input modules in JSON, checked on load to be structurally equal to the inputs;
+ *  - the host module followed by its import tree, each module saved by SaveToBinary and
+ *    restored by "runtime.module.loadbinary_<type_key>".
+ * Entries are written to a temporary file and renamed, so that concurrent builds sharing a cache
+ * directory never observe a partial entry.
+ */
+#include <dmlc/memory_io.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/serialization.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../runtime/library_module.h"
+#include "../support/utils.h"
+#include "internal_driver_api.h"
+
+namespace tvm {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.build_cache_dir", String);
+
+/*! \brief The magic number at the beginning of every cache file. */
+constexpr uint64_t kBuildCacheMagic = 0x54564D4255494C44;
+
+/*! \brief Whether every module of an import tree can be restored from its binary. */
+static bool IsSerializable(const runtime::Module& mod) {
+  if (!runtime::Registry::Get("runtime.module.loadbinary_" + std::string(mod->type_key()))) {
+    return false;
+  }
+  for (const runtime::Module& import : mod->imports()) {
+    if (!IsSerializable(import)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*! \brief Save a module followed by its imports, recursively. */
+static void SaveModuleTree(const runtime::Module& mod, dmlc::Stream* stream) {
+  stream->Write(std::string(mod->type_key()));
+  const_cast<runtime::ModuleNode*>(mod.operator->())->SaveToBinary(stream);
+  stream->Write(static_cast<uint64_t>(mod->imports().size()));
+  for (const runtime::Module& import : mod->imports()) {
+    SaveModuleTree(import, stream);
+  }
+}
+
+/*! \brief Load a module saved by SaveModuleTree. */
+static runtime::Module LoadModuleTree(dmlc::Stream* stream) {
+  std::string type_key;
+  uint64_t num_imports = 0;
+  ICHECK(stream->Read(&type_key)) << "Corrupted build cache file";
+  runtime::Module mod = runtime::LoadModuleFromBinary(type_key, stream);
+  ICHECK(stream->Read(&num_imports)) << "Corrupted build cache file";
+  for (uint64_t i = 0; i < num_imports; ++i) {
+    mod.Import(LoadModuleTree(stream));
+  }
+  return mod;
+}
+
+std::optional<BuildCacheEntry> BuildCacheEntry::Create(const Map<Target, IRModule>& inputs,
+                                                       const Target& target_host) {
+  transform::PassContext pass_ctx = transform::PassContext::Current();
+  std::string cache_dir = pass_ctx->GetConfig<String>("tir.build_cache_dir", String("")).value();
+  if (cache_dir.empty()) {
+    const char* env_cache_dir = std::getenv("TVM_BUILD_CACHE_DIR");
+    if (env_cache_dir == nullptr || *env_cache_dir == '\0') {
+      return std::nullopt;
+    }
+    cache_dir = env_cache_dir;
+  }
+  // The custom lowering passes cannot be compared across processes
+  if (pass_ctx->config.count("tir.add_lower_pass")) {
+    return std::nullopt;
+  }
+  // Step 1. Order the inputs by their targets, as the map is ordered by address
+  std::vector<std::pair<std::string, IRModule>> ordered_inputs;
+  for (const auto& kv : inputs) {
+    if (kv.second.defined()) {
+      ordered_inputs.emplace_back(kv.first->str(), kv.second);
+    }
+  }
+  std::stable_sort(ordered_inputs.begin(), ordered_inputs.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+  // Step 2. Describe everything else that the build depends on
+  Array<ObjectRef> key;
+  key.push_back(String(TVM_VERSION));
+  key.push_back(String(target_host->str()));
+  for (const auto& kv : ordered_inputs) {
+    key.push_back(String(kv.first));
+  }
+  key.push_back(Integer(pass_ctx->opt_level));
+  key.push_back(pass_ctx->required_pass);
+  key.push_back(pass_ctx->disabled_pass);
+  std::vector<std::pair<String, ObjectRef>> config(pass_ctx->config.begin(),
+                                                   pass_ctx->config.end());
+  std::sort(config.begin(), config.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (const auto& kv : config) {
+    if (kv.first != "tir.build_cache_dir") {
+      key.push_back(Array<ObjectRef>{kv.first, kv.second});
+    }
+  }
+  // Step 3. Hash the key and the inputs into the name of the cache file
+  BuildCacheEntry entry;
+  entry.key_ = SaveJSON(key);
+  uint64_t hash = std::hash<std::string>()(entry.key_);
+  for (const auto& kv : ordered_inputs) {
+    hash = support::HashCombine(hash, StructuralHash()(kv.second));
+    entry.inputs_.push_back(kv.second);
+  }
+  std::ostringstream os;
+  os << cache_dir << "/" << std::hex << hash << ".tvmbuild";
+  entry.path_ = os.str();
+  return entry;
+}
+
+Optional<runtime::Module> BuildCacheEntry::Load() const {
+  std::ifstream fs(path_, std::ios::in | std::ios::binary);
+  if (!fs) {
+    return NullOpt;
+  }
+  std::string data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  dmlc::MemoryStringStream reader(&data);
+  dmlc::Stream* stream = &reader;
+  uint64_t magic = 0;
+  std::string key, inputs_json;
+  if (!stream->Read(&magic) || magic != kBuildCacheMagic || !stream->Read(&key) || key != key_ ||
+      !stream->Read(&inputs_json)) {
+    return NullOpt;
+  }
+  Array<IRModule> inputs = Downcast<Array<IRModule>>(LoadJSON(inputs_json));
+  if (!StructuralEqual()(inputs, inputs_)) {
+    return NullOpt;
+  }
+  return LoadModuleTree(stream);
+}
+
+void BuildCacheEntry::Save(const runtime::Module& mod) const {
+  if (!IsSerializable(mod)) {
+    return;
+  }
+  std::string data;
+  dmlc::MemoryStringStream writer(&data);
+  dmlc::Stream* stream = &writer;
+  stream->Write(kBuildCacheMagic);
+  stream->Write(key_);
+  stream->Write(SaveJSON(inputs_));
+  SaveModuleTree(mod, stream);
+  // A failure to write the cache never fails the build
+  std::ostringstream tmp_path;
+  tmp_path << path_ << ".tmp" << std::random_device()();
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the build cache file " << tmp_path.str();
+      return;
+    }
+    fs.write(data.data(), data.size());
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the build cache file " << tmp_path.str();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path_.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the build cache file " << path_;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
+}  // namespace tvm
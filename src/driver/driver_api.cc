@@ -34,8 +34,11 @@
 
 #include <algorithm>
 #include <mutex>
+#include <optional>
 #include <stack>
 
+#include "internal_driver_api.h"
+
 namespace tvm {
 
 // Register build pipeline related options
@@ -57,6 +60,8 @@ TVM_REGISTER_PASS_CONFIG_OPTION("tir.merge_static_smem", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_lwp", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.vtcm_capacity", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.ptx_ldg32", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.auto_swizzle_shared_memory", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.specialize_dynamic_shape", Bool);
 
 // WARNING: May cause coherency issues resulting data miscompares
 // Experimental feature that, when enabled by the runtime, bypasses the cache when using DMA. When
@@ -155,6 +160,10 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
       pass_ctx->GetConfig<Bool>("tir.enable_equiv_terms_in_cse_tir", Bool(false)).value();
 
   bool ptx_ldg32 = pass_ctx->GetConfig<Bool>("tir.ptx_ldg32", Bool(false)).value();
+  bool auto_swizzle_shared_memory =
+      pass_ctx->GetConfig<Bool>("tir.auto_swizzle_shared_memory", Bool(false)).value();
+  bool specialize_dynamic_shape =
+      pass_ctx->GetConfig<Bool>("tir.specialize_dynamic_shape", Bool(false)).value();
 
   // Get any user-added passes
   Array<Array<ObjectRef>> add_lower_pass =
@@ -213,9 +222,16 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   pass_list.push_back(tir::transform::Simplify());
   pass_list.push_back(tir::transform::InjectPermutedLayout());
   pass_list.push_back(tir::transform::Simplify());
+  pass_list.push_back(tir::transform::InjectWarpSpecialization());
   pass_list.push_back(tir::transform::InjectSoftwarePipeline());
   pass_list.push_back(tir::transform::TransformMmaBufferLayout());
   pass_list.push_back(tir::transform::LowerOpaqueBlock());
+  if (auto_swizzle_shared_memory) {
+    pass_list.push_back(tir::transform::InjectSharedMemorySwizzle());
+  }
+  if (specialize_dynamic_shape) {
+    pass_list.push_back(tir::transform::SpecializeDynamicShape());
+  }
   pass_list.push_back(tir::transform::FlattenBuffer());
   pass_list.push_back(tir::transform::BF16ComputeLegalize());
   pass_list.push_back(tir::transform::NarrowDataType(32));
@@ -477,6 +493,13 @@ runtime::Module TIRToRuntime(const Map<Target, IRModule>& inputs_arg,
   // Update target host for all targets
   CheckAndUpdateHostConsistency(&inputs, &target_host);
 
+  std::optional<BuildCacheEntry> cache_entry = BuildCacheEntry::Create(inputs, target_host);
+  if (cache_entry) {
+    if (Optional<runtime::Module> cached = cache_entry->Load()) {
+      return cached.value();
+    }
+  }
+
   // Take the attrs from the first module so the eventual modules have them.
   // Ideally this would just be one unified module all the way through;
   IRModule first_module = (*inputs.begin()).second;
@@ -522,6 +545,9 @@ runtime::Module TIRToRuntime(const Map<Target, IRModule>& inputs_arg,
     }
   }
 
+  if (cache_entry) {
+    cache_entry->Save(mhost);
+  }
   return mhost;
 }
 
@@ -579,6 +605,9 @@ transform::Sequential MixedModulePassManager(IRModule mixed_mod, Target target)
 
   mixed_pass_list.push_back(tir::transform::VerifyMemory());
 
+  // InjectSoftwarePrefetch uses the target attrs added by BindTarget to only apply to CPUs
+  mixed_pass_list.push_back(tir::transform::InjectSoftwarePrefetch());
+
   mixed_pass_list.push_back(tir::transform::AnnotateEntryFunc());
 
   bool detect_global_barrier =
@@ -30,6 +30,9 @@
 #include <tvm/ir/module.h>
 #include <tvm/target/target.h>
 
+#include <optional>
+#include <string>
+
 namespace tvm {
 
 /*!
@@ -43,6 +46,38 @@ namespace tvm {
  */
 runtime::Module TIRToRuntime(const Map<Target, IRModule>& input, const Target& target_host);
 
+/*!
+ * \brief An entry of the on-disk cache of the modules built by TIRToRuntime.
+ *
+ * The cache is enabled by the pass config "tir.build_cache_dir", or otherwise by the environment
+ * variable TVM_BUILD_CACHE_DIR, naming an existing directory. An entry is keyed on the structural
+ * hash of the input modules, the targets, the pass context and the version of TVM. A hit skips
+ * both lowering and code generation, and is verified to be structurally equal to the input.
+ */
+class BuildCacheEntry {
+ public:
+  /*!
+   * \brief Create the cache entry of a build.
+   * \param inputs The map from each target to its IRModule.
+   * \param target_host The target for building host code.
+   * \return The entry, or std::nullopt if the cache is disabled or the build cannot be cached.
+   */
+  static std::optional<BuildCacheEntry> Create(const Map<Target, IRModule>& inputs,
+                                               const Target& target_host);
+  /*! \brief Load the cached module, or return NullOpt on a miss. */
+  Optional<runtime::Module> Load() const;
+  /*! \brief Store the built module, if all of its parts can be serialized. */
+  void Save(const runtime::Module& mod) const;
+
+ private:
+  /*! \brief The path of the cache file. */
+  std::string path_;
+  /*! \brief The canonical description of the targets and the pass context. */
+  std::string key_;
+  /*! \brief The input modules, ordered by their targets. */
+  Array<IRModule> inputs_;
+};
+
 }  // namespace tvm
 
 #endif  // TVM_DRIVER_INTERNAL_DRIVER_API_H_
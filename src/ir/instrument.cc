@@ -21,13 +21,25 @@
  * \file src/ir/instrument.cc
  * \brief Infrastructure for instrumentation.
  */
+#include <dmlc/json.h>
 #include <dmlc/thread_local.h>
 #include <tvm/ir/instrument.h>
 #include <tvm/ir/transform.h>
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <stack>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
 
 namespace tvm {
 namespace instrument {
@@ -334,5 +346,277 @@ TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
                             run_before_pass, run_after_pass);
 });
 
+/*! \brief Count the distinct nodes reachable from an object, following the reflected fields. */
+class NodeCounter : public AttrVisitor {
+ public:
+  static int64_t Count(const ObjectRef& root) {
+    NodeCounter counter;
+    counter.Push(root);
+    while (!counter.stack_.empty()) {
+      const Object* node = counter.stack_.back();
+      counter.stack_.pop_back();
+      if (node->IsInstance<ArrayNode>()) {
+        for (const ObjectRef& elem : *static_cast<const ArrayNode*>(node)) counter.Push(elem);
+      } else if (node->IsInstance<MapNode>()) {
+        for (const auto& kv : *static_cast<const MapNode*>(node)) {
+          counter.Push(kv.first);
+          counter.Push(kv.second);
+        }
+      } else {
+        ReflectionVTable::Global()->VisitAttrs(const_cast<Object*>(node), &counter);
+      }
+    }
+    return counter.visited_.size();
+  }
+
+  void Visit(const char* key, double* value) final {}
+  void Visit(const char* key, int64_t* value) final {}
+  void Visit(const char* key, uint64_t* value) final {}
+  void Visit(const char* key, int* value) final {}
+  void Visit(const char* key, bool* value) final {}
+  void Visit(const char* key, std::string* value) final {}
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, DataType* value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final {}
+  void Visit(const char* key, ObjectRef* value) final { Push(*value); }
+
+ private:
+  void Push(const ObjectRef& ref) {
+    if (ref.defined() && visited_.insert(ref.get()).second) {
+      stack_.push_back(ref.get());
+    }
+  }
+
+  std::unordered_set<const Object*> visited_;
+  std::vector<const Object*> stack_;
+};
+
+/*! \brief The resident set size of the process in bytes, or 0 if unknown. */
+static int64_t CurrentRSSBytes() {
+#if defined(__linux__)
+  std::ifstream fin("/proc/self/statm");
+  int64_t pages = 0, resident = 0;
+  if (fin >> pages >> resident) {
+    return resident * sysconf(_SC_PAGESIZE);
+  }
+#endif
+  return 0;
+}
+
+/*! \brief The peak resident set size of the process in bytes, since the last reset. */
+static int64_t PeakRSSBytes() {
+#if defined(__linux__)
+  std::ifstream fin("/proc/self/status");
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return std::stoll(line.substr(6)) << 10;
+    }
+  }
+#endif
+  return 0;
+}
+
+/*! \brief Reset the peak resident set size of the process to the current one, if supported. */
+static void ResetPeakRSS() {
+#if defined(__linux__)
+  std::ofstream fout("/proc/self/clear_refs");
+  if (fout) {
+    fout << "5";
+  }
+#endif
+}
+
+/*!
+ * \brief A pass instrument collecting the statistics of every pass run, including the nested ones:
+ * its wall time, the resident memory of the process before, after and at its peak during the pass,
+ * the number of IR nodes of the module before and after, and the number of functions it added,
+ * removed or changed.
+ *
+ * The peak memory of each pass is accurate on Linux, where the peak of the process is reset at the
+ * beginning of every pass. The statistics are kept after the pass context exits, until the
+ * instrument enters a pass context again.
+ */
+class PassStatisticsInstrumentNode : public PassInstrumentNode {
+ public:
+  /*! \brief The statistics of a pass run. */
+  struct Record {
+    String name;
+    /*! \brief The nesting depth of the pass, 0 for the passes run directly. */
+    int depth;
+    double duration_ms = 0;
+    int64_t rss_before = 0;
+    int64_t rss_after = 0;
+    int64_t peak_rss = 0;
+    int64_t nodes_before = 0;
+    int64_t nodes_after = 0;
+    int64_t functions_changed = 0;
+    /*! \brief Whether the pass has completed. */
+    bool completed = false;
+  };
+
+  /*! \brief Whether to count the IR nodes, which traverses the whole module twice per pass. */
+  bool count_nodes = true;
+
+  void VisitAttrs(AttrVisitor* v) {
+    PassInstrumentNode::VisitAttrs(v);
+    v->Visit("count_nodes", &count_nodes);
+  }
+
+  void EnterPassContext() const final {
+    records_.clear();
+    running_.clear();
+  }
+
+  void ExitPassContext() const final {}
+
+  bool ShouldRun(const IRModule& mod, const transform::PassInfo& info) const final { return true; }
+
+  void RunBeforePass(const IRModule& mod, const transform::PassInfo& info) const final {
+    UpdatePeakRSS();
+    Running running;
+    running.record = records_.size();
+    running.start = std::chrono::steady_clock::now();
+    running.functions = mod->functions;
+    Record record;
+    record.name = info->name;
+    record.depth = running_.size();
+    record.rss_before = CurrentRSSBytes();
+    record.nodes_before = count_nodes ? NodeCounter::Count(mod) : 0;
+    records_.push_back(std::move(record));
+    running_.push_back(std::move(running));
+    ResetPeakRSS();
+    running_.back().start = std::chrono::steady_clock::now();
+  }
+
+  void RunAfterPass(const IRModule& mod, const transform::PassInfo& info) const final {
+    auto end = std::chrono::steady_clock::now();
+    UpdatePeakRSS();
+    ICHECK(!running_.empty()) << "mismatched before/after pass for pass statistics";
+    Running running = std::move(running_.back());
+    running_.pop_back();
+    Record& record = records_[running.record];
+    record.duration_ms = std::chrono::duration<double, std::milli>(end - running.start).count();
+    record.rss_after = CurrentRSSBytes();
+    record.nodes_after = count_nodes ? NodeCounter::Count(mod) : 0;
+    for (const auto& [gvar, func] : mod->functions) {
+      auto it = running.functions.find(gvar);
+      if (it == running.functions.end() || !(*it).second.same_as(func)) {
+        ++record.functions_changed;
+      }
+    }
+    for (const auto& [gvar, func] : running.functions) {
+      if (!mod->functions.count(gvar)) {
+        ++record.functions_changed;
+      }
+    }
+    record.completed = true;
+    ResetPeakRSS();
+  }
+
+  /*! \brief Render the statistics as a table, the nested passes indented below their parents. */
+  String RenderTable() const {
+    constexpr double kMB = 1 << 20;
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2);
+    os << std::left << std::setw(48) << "Pass" << std::right << std::setw(12) << "Time(ms)"
+       << std::setw(14) << "RSS delta(MB)" << std::setw(14) << "Peak RSS(MB)" << std::setw(12)
+       << "Nodes" << std::setw(12) << "Node delta" << std::setw(11) << "Functions" << "\n";
+    for (const Record& record : records_) {
+      std::string name = std::string(record.depth * 2, ' ') + record.name;
+      if (!record.completed) name += " (incomplete)";
+      os << std::left << std::setw(48) << name << std::right << std::setw(12)
+         << record.duration_ms << std::setw(14) << (record.rss_after - record.rss_before) / kMB
+         << std::setw(14) << record.peak_rss / kMB << std::setw(12) << record.nodes_after
+         << std::setw(12) << (record.nodes_after - record.nodes_before) << std::setw(11)
+         << record.functions_changed << "\n";
+    }
+    return os.str();
+  }
+
+  /*! \brief Render the statistics as a JSON array of objects, in the order the passes began. */
+  String RenderJSON() const {
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginArray();
+    for (const Record& record : records_) {
+      writer.WriteArrayItem(JSONRecord{&record});
+    }
+    writer.EndArray();
+    return os.str();
+  }
+
+  static constexpr const char* _type_key = "instrument.PassStatisticsInstrument";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PassStatisticsInstrumentNode, PassInstrumentNode);
+
+ private:
+  /*! \brief The state of a pass that is running. */
+  struct Running {
+    size_t record;
+    std::chrono::steady_clock::time_point start;
+    Map<GlobalVar, BaseFunc> functions;
+  };
+
+  /*! \brief The adapter writing a record with dmlc::JSONWriter. */
+  struct JSONRecord {
+    const Record* record;
+
+    void Save(dmlc::JSONWriter* writer) const {
+      writer->BeginObject();
+      writer->WriteObjectKeyValue("name", std::string(record->name));
+      writer->WriteObjectKeyValue("depth", record->depth);
+      writer->WriteObjectKeyValue("duration_ms", record->duration_ms);
+      writer->WriteObjectKeyValue("rss_before", record->rss_before);
+      writer->WriteObjectKeyValue("rss_after", record->rss_after);
+      writer->WriteObjectKeyValue("peak_rss", record->peak_rss);
+      writer->WriteObjectKeyValue("nodes_before", record->nodes_before);
+      writer->WriteObjectKeyValue("nodes_after", record->nodes_after);
+      writer->WriteObjectKeyValue("functions_changed", record->functions_changed);
+      writer->WriteObjectKeyValue("completed", record->completed);
+      writer->EndObject();
+    }
+  };
+
+  /*! \brief Fold the peak memory since the last reset into all the running passes. */
+  void UpdatePeakRSS() const {
+    int64_t peak = std::max(PeakRSSBytes(), CurrentRSSBytes());
+    for (const Running& running : running_) {
+      Record& record = records_[running.record];
+      record.peak_rss = std::max(record.peak_rss, peak);
+    }
+  }
+
+  mutable std::vector<Record> records_;
+  mutable std::vector<Running> running_;
+};
+
+/*!
+ * \brief Managed reference class for PassStatisticsInstrumentNode
+ * \sa PassStatisticsInstrumentNode
+ */
+class PassStatisticsInstrument : public PassInstrument {
+ public:
+  explicit PassStatisticsInstrument(bool count_nodes) {
+    ObjectPtr<PassStatisticsInstrumentNode> n = make_object<PassStatisticsInstrumentNode>();
+    n->name = "PassStatisticsInstrument";
+    n->count_nodes = count_nodes;
+    data_ = std::move(n);
+  }
+
+  TVM_DEFINE_OBJECT_REF_METHODS(PassStatisticsInstrument, PassInstrument,
+                                PassStatisticsInstrumentNode);
+};
+
+TVM_REGISTER_NODE_TYPE(PassStatisticsInstrumentNode);
+
+TVM_REGISTER_GLOBAL("instrument.MakePassStatisticsInstrument").set_body_typed([](bool count_nodes) {
+  return PassStatisticsInstrument(count_nodes);
+});
+
+TVM_REGISTER_GLOBAL("instrument.RenderPassStatistics")
+    .set_body_typed([](PassStatisticsInstrument instrument, bool as_json) {
+      return as_json ? instrument->RenderJSON() : instrument->RenderTable();
+    });
+
 }  // namespace instrument
 }  // namespace tvm
@@ -24,13 +24,19 @@
 #include <tvm/ir/module.h>
 #include <tvm/ir/type_functor.h>
 #include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <sstream>
 #include <unordered_set>
 
+#include "../support/utils.h"
+
 namespace tvm {
 
 IRModule::IRModule(tvm::Map<GlobalVar, BaseFunc> functions,
@@ -152,6 +158,113 @@ void IRModuleNode::SHashReduce(SHashReducer hash_reduce) const {
   hash_reduce(this->global_infos);
 }
 
+namespace {
+
+/*!
+ * \brief Hash handler that reduces a GlobalVar to its name.
+ *
+ * Within IRModuleNode::SHashReduce the GlobalVars are DefHash-ed in the name order of the
+ * whole module, which ties the hash of each function to its siblings. Hashing them by name
+ * keeps the hash of a function self-contained so that functions can be hashed independently.
+ */
+class SHashHandlerGlobalVarByName : public SHashHandlerDefault {
+ protected:
+  void DispatchSHash(const ObjectRef& object, bool map_free_vars) final {
+    if (const auto* gvar = object.as<GlobalVarNode>()) {
+      SHashReducer hash_reduce(this, map_free_vars);
+      hash_reduce(gvar->name_hint);
+    } else {
+      SHashHandlerDefault::DispatchSHash(object, map_free_vars);
+    }
+  }
+};
+
+/*! \brief Equality handler that matches GlobalVars by name, see SHashHandlerGlobalVarByName. */
+class SEqualHandlerGlobalVarByName : public SEqualHandlerDefault {
+ public:
+  SEqualHandlerGlobalVarByName() : SEqualHandlerDefault(false, nullptr, false) {}
+
+ protected:
+  bool DispatchSEqualReduce(const ObjectRef& lhs, const ObjectRef& rhs, bool map_free_vars,
+                            const Optional<ObjectPathPair>& current_paths) final {
+    const auto* lhs_gvar = lhs.as<GlobalVarNode>();
+    const auto* rhs_gvar = rhs.as<GlobalVarNode>();
+    if (lhs_gvar && rhs_gvar) {
+      return lhs_gvar->name_hint == rhs_gvar->name_hint;
+    }
+    return SEqualHandlerDefault::DispatchSEqualReduce(lhs, rhs, map_free_vars, current_paths);
+  }
+};
+
+int ResolveNumThreads(int num_threads) {
+  return num_threads > 0 ? num_threads : runtime::threading::MaxConcurrency();
+}
+
+}  // namespace
+
+uint64_t ParallelStructuralHash(const IRModule& mod, int num_threads) {
+  // Type definitions may refer to each other through GlobalTypeVars, so such
+  // modules are not split into independent pieces.
+  if (!mod->type_definitions.empty()) {
+    return StructuralHash()(mod);
+  }
+  std::vector<std::pair<String, BaseFunc>> funcs;
+  funcs.reserve(mod->functions.size());
+  for (const auto& kv : mod->functions) {
+    funcs.emplace_back(kv.first->name_hint, kv.second);
+  }
+  std::sort(funcs.begin(), funcs.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+  std::vector<uint64_t> func_hashes(funcs.size());
+  support::parallel_for_dynamic(
+      0, static_cast<int>(funcs.size()), ResolveNumThreads(num_threads),
+      [&](int thread_id, int task_id) {
+        func_hashes[task_id] = SHashHandlerGlobalVarByName().Hash(funcs[task_id].second, false);
+      });
+
+  // Combine in name order so that the result does not depend on the scheduling.
+  uint64_t result = support::HashCombine(0, funcs.size());
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    const String& name = funcs[i].first;
+    result = support::HashCombine(result, String::StableHashBytes(name.data(), name.size()));
+    result = support::HashCombine(result, func_hashes[i]);
+  }
+  result = support::HashCombine(result, SHashHandlerGlobalVarByName().Hash(mod->attrs, false));
+  result =
+      support::HashCombine(result, SHashHandlerGlobalVarByName().Hash(mod->global_infos, false));
+  return result;
+}
+
+bool ParallelStructuralEqual(const IRModule& lhs, const IRModule& rhs, int num_threads) {
+  if (!lhs->type_definitions.empty() || !rhs->type_definitions.empty()) {
+    return StructuralEqual()(lhs, rhs);
+  }
+  if (lhs->functions.size() != rhs->functions.size()) return false;
+  if (!SEqualHandlerGlobalVarByName().Equal(lhs->attrs, rhs->attrs, false) ||
+      !SEqualHandlerGlobalVarByName().Equal(lhs->global_infos, rhs->global_infos, false)) {
+    return false;
+  }
+  std::vector<std::pair<BaseFunc, BaseFunc>> pairs;
+  pairs.reserve(lhs->functions.size());
+  for (const auto& kv : lhs->functions) {
+    if (!rhs->ContainGlobalVar(kv.first->name_hint)) return false;
+    pairs.emplace_back(kv.second, rhs->Lookup(kv.first->name_hint));
+  }
+
+  std::atomic<bool> equal{true};
+  support::parallel_for_dynamic(
+      0, static_cast<int>(pairs.size()), ResolveNumThreads(num_threads),
+      [&](int thread_id, int task_id) {
+        if (!equal.load(std::memory_order_relaxed)) return;
+        if (!SEqualHandlerGlobalVarByName().Equal(pairs[task_id].first, pairs[task_id].second,
+                                                  false)) {
+          equal.store(false, std::memory_order_relaxed);
+        }
+      });
+  return equal.load();
+}
+
 bool IRModuleNode::ContainGlobalVar(const String& name) const {
   return global_var_map_.find(name) != global_var_map_.end();
 }
@@ -544,4 +657,14 @@ TVM_REGISTER_GLOBAL("ir.Module_GetAttr").set_body_typed([](IRModule mod, String
   return mod->GetAttr<ObjectRef>(key);
 });
 
+TVM_REGISTER_GLOBAL("ir.Module_ParallelStructuralHash")
+    .set_body_typed([](IRModule mod, int num_threads) -> int64_t {
+      return static_cast<int64_t>(ParallelStructuralHash(mod, num_threads));
+    });
+
+TVM_REGISTER_GLOBAL("ir.Module_ParallelStructuralEqual")
+    .set_body_typed([](IRModule lhs, IRModule rhs, int num_threads) {
+      return ParallelStructuralEqual(lhs, rhs, num_threads);
+    });
+
 }  // namespace tvm
@@ -29,7 +29,10 @@
 #include <tvm/relax/tuning_api.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <stack>
@@ -46,6 +49,7 @@ using tvm::runtime::TVMArgs;
 using tvm::runtime::TVMRetValue;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("testing.immutable_module", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("ir.num_function_pass_threads", Integer);
 
 struct PassContextThreadLocalEntry {
   /*! \brief The default pass context. */
@@ -379,15 +383,50 @@ class ModulePass : public Pass {
 };
 
 PassInfo::PassInfo(int opt_level, String name, tvm::Array<runtime::String> required,
-                   bool traceable) {
+                   bool traceable, bool thread_safe) {
   auto pass_info = make_object<PassInfoNode>();
   pass_info->opt_level = opt_level;
   pass_info->name = std::move(name);
   pass_info->required = std::move(required);
   pass_info->traceable = std::move(traceable);
+  pass_info->thread_safe = thread_safe;
   data_ = std::move(pass_info);
 }
 
+int NumFunctionPassThreads(const PassInfo& pass_info, const PassContext& pass_ctx) {
+  if (!pass_info->thread_safe) {
+    return 1;
+  }
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("ir.num_function_pass_threads", Integer(1)).value()->value;
+  return num_threads > 0 ? num_threads : runtime::threading::MaxConcurrency();
+}
+
+void ParallelForFunctions(int num_tasks, int num_threads, const PassContext& pass_ctx,
+                          const std::function<void(int)>& ftask) {
+  num_threads = std::min(num_threads, num_tasks);
+  if (num_threads <= 1) {
+    for (int i = 0; i < num_tasks; ++i) {
+      ftask(i);
+    }
+    return;
+  }
+  // The workers of the pool outlive the pass, so the context is pushed for each task only, and
+  // without EnterWithScope, which would run the instruments again.
+  struct ThreadPassContextScope {
+    explicit ThreadPassContextScope(const PassContext& pass_ctx)
+        : entry(RelayPassContextThreadLocalStore::Get()) {
+      entry->context_stack.push(pass_ctx);
+    }
+    ~ThreadPassContextScope() { entry->context_stack.pop(); }
+    PassContextThreadLocalEntry* entry;
+  };
+  support::parallel_for_dynamic(0, num_tasks, num_threads, [&](int thread_id, int task_id) {
+    ThreadPassContextScope scope(pass_ctx);
+    ftask(task_id);
+  });
+}
+
 ModulePass::ModulePass(runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func,
                        PassInfo pass_info) {
   auto n = make_object<ModulePassNode>();
@@ -536,8 +575,9 @@ Pass CreateModulePass(const runtime::TypedPackedFunc<IRModule(IRModule, PassCont
 TVM_REGISTER_NODE_TYPE(PassInfoNode);
 
 TVM_REGISTER_GLOBAL("transform.PassInfo")
-    .set_body_typed([](int opt_level, String name, tvm::Array<String> required, bool traceable) {
-      return PassInfo(opt_level, name, required, traceable);
+    .set_body_typed([](int opt_level, String name, tvm::Array<String> required, bool traceable,
+                       bool thread_safe) {
+      return PassInfo(opt_level, name, required, traceable, thread_safe);
     });
 
 TVM_REGISTER_GLOBAL("transform.Info").set_body([](TVMArgs args, TVMRetValue* ret) {
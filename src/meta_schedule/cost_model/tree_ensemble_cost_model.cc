@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../../support/tree_ensemble.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief A cost model predicting with a tree ensemble natively, trained on the python side. */
+class TreeEnsembleCostModelNode : public CostModelNode {
+ public:
+  using FLoad = runtime::TypedPackedFunc<Optional<Array<runtime::NDArray>>(String)>;
+  using FSave = runtime::TypedPackedFunc<void(String)>;
+  using FUpdate = runtime::TypedPackedFunc<Optional<Array<runtime::NDArray>>(
+      const TuneContext&, const Array<MeasureCandidate>&, const Array<RunnerResult>&)>;
+
+  /*! \brief The feature extractor. */
+  FeatureExtractor extractor{nullptr};
+  /*! \brief The packed function loading the trainer state. */
+  FLoad f_load;
+  /*! \brief The packed function saving the trainer state. */
+  FSave f_save;
+  /*! \brief The packed function updating the trainer. */
+  FUpdate f_update;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("extractor", &extractor);
+    // `f_load` is not visited
+    // `f_save` is not visited
+    // `f_update` is not visited
+  }
+
+  void Load(const String& path) final {
+    ICHECK(f_load != nullptr) << "TreeEnsembleCostModel's Load method not implemented!";
+    SetEnsemble(f_load(path));
+  }
+
+  void Save(const String& path) final {
+    ICHECK(f_save != nullptr) << "TreeEnsembleCostModel's Save method not implemented!";
+    f_save(path);
+  }
+
+  void Update(const TuneContext& context, const Array<MeasureCandidate>& candidates,
+              const Array<RunnerResult>& results) final {
+    ICHECK(f_update != nullptr) << "TreeEnsembleCostModel's Update method not implemented!";
+    if (Optional<Array<runtime::NDArray>> ensemble = f_update(context, candidates, results)) {
+      SetEnsemble(ensemble);
+    }
+  }
+
+  std::vector<double> Predict(const TuneContext& context,
+                              const Array<MeasureCandidate>& candidates) final {
+    int n = candidates.size();
+    std::vector<double> result(n, 0.0);
+    if (ensemble_.empty()) {
+      // Not trained yet, the search is guided by random scores as in the python models
+      support::LinearCongruentialEngine rand(&rand_state_);
+      std::uniform_real_distribution<double> dist(0.0, 1.0);
+      for (double& score : result) {
+        score = dist(rand);
+      }
+      return result;
+    }
+    Array<runtime::NDArray> features = extractor->ExtractFrom(context, candidates);
+    ICHECK_EQ(features.size(), candidates.size());
+    // Step 1. Flatten the feature vectors of all the candidates
+    std::vector<const double*> rows;
+    std::vector<int> row_begin(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+      const runtime::NDArray& feature = features[i];
+      ICHECK(feature->ndim == 2 && DataType(feature->dtype) == DataType::Float(64) &&
+             feature.IsContiguous() && feature->device.device_type == kDLCPU)
+          << "ValueError: The features must be contiguous 2-d float64 arrays on CPU";
+      int64_t num_rows = feature->shape[0];
+      int64_t length = feature->shape[1];
+      ICHECK(num_rows == 0 || length > ensemble_.max_feature())
+          << "ValueError: The tree ensemble splits on feature " << ensemble_.max_feature()
+          << ", but the feature vectors have length " << length;
+      const double* data = static_cast<const double*>(feature->data);
+      for (int64_t r = 0; r < num_rows; ++r) {
+        rows.push_back(data + r * length);
+      }
+      row_begin[i + 1] = rows.size();
+    }
+    // Step 2. Predict blocks of feature vectors in parallel
+    int num_rows = rows.size();
+    constexpr int kRowsPerBlock = support::TreeEnsemble::kRowsPerBlock;
+    int num_blocks = (num_rows + kRowsPerBlock - 1) / kRowsPerBlock;
+    std::vector<float> row_scores(num_rows, 0.0f);
+    support::parallel_for_dynamic(0, num_blocks, context->num_threads,
+                                  [&](int, int block) -> void {
+                                    int begin = block * kRowsPerBlock;
+                                    int end = std::min(begin + kRowsPerBlock, num_rows);
+                                    ensemble_.PredictRows(rows.data() + begin, end - begin,
+                                                          row_scores.data() + begin);
+                                  });
+    // Step 3. Sum up the predictions of each candidate
+    for (int i = 0; i < n; ++i) {
+      double score = 0.0;
+      for (int r = row_begin[i]; r < row_begin[i + 1]; ++r) {
+        score += row_scores[r];
+      }
+      result[i] = score;
+    }
+    return result;
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.TreeEnsembleCostModel";
+  TVM_DECLARE_FINAL_OBJECT_INFO(TreeEnsembleCostModelNode, CostModelNode);
+
+ private:
+  /*! \brief Replace the tree ensemble, see CostModel::TreeEnsemble for the format. */
+  void SetEnsemble(const Optional<Array<runtime::NDArray>>& opt_ensemble) {
+    ensemble_.Set(opt_ensemble);
+  }
+
+  /*! \brief The tree ensemble, empty if the model is not trained. */
+  support::TreeEnsemble ensemble_;
+  /*! \brief The random state of the predictions before training. */
+  support::LinearCongruentialEngine::TRandState rand_state_ =
+      support::LinearCongruentialEngine::DeviceRandom();
+};
+
+CostModel CostModel::TreeEnsemble(FeatureExtractor extractor,
+                                  TreeEnsembleCostModelNode::FLoad f_load,
+                                  TreeEnsembleCostModelNode::FSave f_save,
+                                  TreeEnsembleCostModelNode::FUpdate f_update) {
+  ObjectPtr<TreeEnsembleCostModelNode> n = make_object<TreeEnsembleCostModelNode>();
+  n->extractor = std::move(extractor);
+  n->f_load = std::move(f_load);
+  n->f_save = std::move(f_save);
+  n->f_update = std::move(f_update);
+  return CostModel(n);
+}
+
+TVM_REGISTER_NODE_TYPE(TreeEnsembleCostModelNode);
+TVM_REGISTER_GLOBAL("meta_schedule.CostModelTreeEnsemble").set_body_typed(CostModel::TreeEnsemble);
+
+}  // namespace meta_schedule
+}  // namespace tvm
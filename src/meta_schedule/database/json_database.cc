@@ -16,9 +16,14 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <algorithm>
+#include <cstdio>
 #include <set>
+#include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "../module_equality.h"
 #include "../utils.h"
@@ -65,6 +70,27 @@ void JSONFileAppendLine(const String& path, const std::string& line) {
   os << line << std::endl;
 }
 
+/*!
+ * \brief Replace the content of a json file atomically, so that readers see either the old file or
+ * the new one, but never a partially written one.
+ * \param path The path to the json file.
+ * \param lines The new lines of the file.
+ */
+void JSONFileRewriteLines(const String& path, const std::vector<std::string>& lines) {
+  std::string tmp_path = std::string(path) + ".tmp";
+  {
+    std::ofstream os(tmp_path, std::ofstream::trunc);
+    CHECK(os.good()) << "ValueError: Cannot open the file to write: " << tmp_path;
+    for (const std::string& line : lines) {
+      os << line << "\n";
+    }
+    os.flush();
+    CHECK(os.good()) << "ValueError: Cannot write the file: " << tmp_path;
+  }
+  CHECK_EQ(std::rename(tmp_path.c_str(), path.c_str()), 0)
+      << "ValueError: Cannot replace " << path << " with " << tmp_path;
+}
+
 /*! \brief The default database implementation, which mimics two database tables with two files. */
 class JSONDatabaseNode : public DatabaseNode {
  public:
@@ -80,12 +106,26 @@ class JSONDatabaseNode : public DatabaseNode {
   std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
   /*! \brief All the tuning records in the database */
   std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> tuning_records_;
+  /*!
+   * \brief The valid tuning records of each workload, indexed by the workload index, so that
+   * the best records of a workload are found without scanning the others.
+   */
+  std::vector<std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs>> valid_records_;
+  /*!
+   * \brief The number of records kept per workload and target on commit, or -1 to keep all of
+   * them. When it is set, invalid records and duplicated traces are not kept either.
+   */
+  int retention_top_k = -1;
+  /*! \brief The number of lines in the tuning record file that are no longer kept in memory. */
+  int64_t num_stale_lines_ = 0;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("path_workload", &path_workload);
     v->Visit("path_tuning_record", &path_tuning_record);
+    v->Visit("retention_top_k", &retention_top_k);
     // `workloads2idx_` is not visited
     // `tuning_records_` is not visited
+    // `valid_records_` is not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.JSONDatabase";
@@ -105,18 +145,77 @@ class JSONDatabaseNode : public DatabaseNode {
     // If `mod` is new in `workloads2idx_`, append it to the workload file
     if (inserted) {
       it->second = static_cast<int>(this->workloads2idx_.size()) - 1;
+      this->valid_records_.emplace_back();
       JSONFileAppendLine(this->path_workload, JSONDumps(workload->AsJSON()));
     }
     return it->first;
   }
 
   void CommitTuningRecord(const TuningRecord& record) {
+    int workload_index = this->workloads2idx_.at(record->workload);
+    bool is_valid = record->IsValid();
+    if (this->retention_top_k >= 0 && !is_valid) {
+      return;
+    }
+    this->AddTuningRecord(record, workload_index, is_valid);
+    JSONFileAppendLine(this->path_tuning_record, TuningRecordLine(record, workload_index));
+    if (this->retention_top_k >= 0) {
+      // Only the records of the committed target can be affected
+      std::vector<TuningRecord> dropped =
+          this->PruneRecords(workload_index, this->retention_top_k, String(TargetKey(record)));
+      for (const TuningRecord& r : dropped) {
+        this->EraseTuningRecord(r);
+      }
+      this->num_stale_lines_ += dropped.size();
+      // Rewriting the files costs as much as the kept records, so amortize it over as many commits
+      if (this->num_stale_lines_ > std::max<int64_t>(this->Size(), 64)) {
+        this->Compact(this->retention_top_k);
+      }
+    }
+  }
+
+  /*!
+   * \brief Drop the dominated records, and rewrite the workload and tuning record files to hold
+   * only the records kept.
+   * \param top_k The number of records kept per workload and target, or -1 to keep all of them.
+   * Invalid records and duplicated traces, except the fastest one, are dropped regardless.
+   */
+  void Compact(int top_k) {
+    int n = this->valid_records_.size();
+    std::vector<Workload> workloads(n, Workload{nullptr});
+    for (const auto& kv : this->workloads2idx_) {
+      workloads.at(kv.second) = kv.first;
+    }
+    std::vector<std::string> workload_lines;
+    std::vector<std::string> record_lines;
+    workload_lines.reserve(n);
+    this->tuning_records_.clear();
+    for (int i = 0; i < n; ++i) {
+      workload_lines.push_back(JSONDumps(workloads[i]->AsJSON()));
+      for (const TuningRecord& record : this->PruneRecords(i, top_k, NullOpt)) {
+        this->valid_records_[i].erase(FindTuningRecord(&this->valid_records_[i], record));
+      }
+      for (const TuningRecord& record : this->valid_records_[i]) {
+        this->tuning_records_.insert(record);
+        record_lines.push_back(TuningRecordLine(record, i));
+      }
+    }
+    JSONFileRewriteLines(this->path_workload, workload_lines);
+    JSONFileRewriteLines(this->path_tuning_record, record_lines);
+    this->num_stale_lines_ = 0;
+  }
+
+  /*!
+   * \brief Add a tuning record to the in-memory tables.
+   * \param record The tuning record.
+   * \param workload_index The index of the workload of the record.
+   * \param is_valid Whether the record is valid, i.e. has been measured successfully.
+   */
+  void AddTuningRecord(const TuningRecord& record, int workload_index, bool is_valid) {
     this->tuning_records_.insert(record);
-    JSONFileAppendLine(this->path_tuning_record,
-                       JSONDumps(Array<ObjectRef>{
-                           /*workload_index=*/Integer(this->workloads2idx_.at(record->workload)),
-                           /*tuning_record=*/record->AsJSON()  //
-                       }));
+    if (is_valid) {
+      this->valid_records_.at(workload_index).insert(record);
+    }
   }
 
   Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
@@ -124,19 +223,17 @@ class JSONDatabaseNode : public DatabaseNode {
     if (top_k == 0) {
       return {};
     }
+    auto it = this->workloads2idx_.find(workload);
+    if (it == this->workloads2idx_.end()) {
+      return {};
+    }
+    const auto& records = this->valid_records_.at(it->second);
     Array<TuningRecord> results;
-    results.reserve(top_k);
-    for (const TuningRecord& record : this->tuning_records_) {
-      auto run_secs = record->run_secs;
-      if (!record->IsValid()) {
-        continue;
-      }
-      if (record->workload.same_as(workload) ||
-          WorkloadEqual(GetModuleEquality())(record->workload, workload)) {
-        results.push_back(record);
-        if (results.size() == static_cast<size_t>(top_k)) {
-          break;
-        }
+    results.reserve(std::min<size_t>(top_k, records.size()));
+    for (const TuningRecord& record : records) {
+      results.push_back(record);
+      if (results.size() == static_cast<size_t>(top_k)) {
+        break;
       }
     }
     return results;
@@ -152,10 +249,72 @@ class JSONDatabaseNode : public DatabaseNode {
   }
 
   int64_t Size() { return tuning_records_.size(); }
+
+  /*!
+   * \brief Find the valid records of a workload that are not retained, i.e. beyond the `top_k`
+   * fastest ones of their target, or slower than a record of the same trace and target.
+   * \param workload_index The index of the workload.
+   * \param top_k The number of records retained per target, or -1 to retain all of them.
+   * \param target_key If defined, only the records of this target are considered.
+   * \return The records not retained.
+   */
+  std::vector<TuningRecord> PruneRecords(int workload_index, int top_k,
+                                         const Optional<String>& target_key) const {
+    std::vector<TuningRecord> dropped;
+    std::unordered_map<std::string, int> num_kept;
+    std::unordered_set<std::string> traces;
+    for (const TuningRecord& record : this->valid_records_.at(workload_index)) {
+      std::string target = TargetKey(record);
+      if (target_key.defined() && target != target_key.value()) {
+        continue;
+      }
+      int& kept = num_kept[target];
+      bool is_new_trace =
+          traces.insert(target + "\n" + JSONDumps(record->trace->AsJSON(false))).second;
+      if (is_new_trace && (top_k < 0 || kept < top_k)) {
+        ++kept;
+      } else {
+        dropped.push_back(record);
+      }
+    }
+    return dropped;
+  }
+
+ private:
+  using RecordSet = std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs>;
+
+  /*! \brief The line of a tuning record in the tuning record file. */
+  static std::string TuningRecordLine(const TuningRecord& record, int workload_index) {
+    return JSONDumps(Array<ObjectRef>{
+        /*workload_index=*/Integer(workload_index),
+        /*tuning_record=*/record->AsJSON()  //
+    });
+  }
+
+  /*! \brief The key telling apart the targets that records are tuned for. */
+  static std::string TargetKey(const TuningRecord& record) {
+    return record->target.defined() ? std::string(record->target.value()->str()) : "";
+  }
+
+  /*! \brief Find a record in a set of records with the same run time, by identity. */
+  static RecordSet::iterator FindTuningRecord(RecordSet* records, const TuningRecord& record) {
+    auto [begin, end] = records->equal_range(record);
+    auto it = std::find_if(begin, end, [&](const TuningRecord& r) { return r.same_as(record); });
+    ICHECK(it != end);
+    return it;
+  }
+
+  /*! \brief Remove a valid record from the in-memory tables. */
+  void EraseTuningRecord(const TuningRecord& record) {
+    int workload_index = this->workloads2idx_.at(record->workload);
+    this->valid_records_[workload_index].erase(
+        FindTuningRecord(&this->valid_records_[workload_index], record));
+    this->tuning_records_.erase(FindTuningRecord(&this->tuning_records_, record));
+  }
 };
 
 Database Database::JSONDatabase(String path_workload, String path_tuning_record, bool allow_missing,
-                                String mod_eq_name) {
+                                String mod_eq_name, int retention_top_k) {
   int num_threads = std::thread::hardware_concurrency();
   ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>(mod_eq_name);
   // Load `n->workloads2idx_` from `path_workload`
@@ -178,6 +337,7 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
       n->workloads2idx_.emplace(workload, i);
       workloads.push_back(workload);
     }
+    n->valid_records_.resize(n_objs);
   }
   // Load `n->tuning_records_` from `path_tuning_record`
   {
@@ -185,6 +345,9 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
         JSONFileReadLines(path_tuning_record, num_threads, allow_missing);
     std::vector<TuningRecord> records;
     records.resize(json_objs.size(), TuningRecord{nullptr});
+    std::vector<int> workload_indices(json_objs.size(), -1);
+    // Validity takes a pass over the trace, so it is computed along with the parsing.
+    std::vector<char> is_valid(json_objs.size(), false);
     support::parallel_for_dynamic(
         0, json_objs.size(), num_threads, [&](int thread_id, int task_id) {
           const ObjectRef& json_obj = json_objs[task_id];
@@ -192,8 +355,10 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
           try {
             const ArrayNode* arr = json_obj.as<ArrayNode>();
             ICHECK_EQ(arr->size(), 2);
-            workload = workloads[Downcast<Integer>(arr->at(0)).IntValue()];
+            workload_indices[task_id] = Downcast<Integer>(arr->at(0)).IntValue();
+            workload = workloads[workload_indices[task_id]];
             records[task_id] = TuningRecord::FromJSON(arr->at(1), workload);
+            is_valid[task_id] = records[task_id]->IsValid();
           } catch (std::runtime_error& e) {
             LOG(FATAL) << "ValueError: Unable to parse TuningRecord, on line " << (task_id + 1)
                        << " of file " << path_tuning_record << ". The workload is:\n"
@@ -203,17 +368,36 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
                        << e.what();
           }
         });
-    for (const TuningRecord& record : records) {
-      n->tuning_records_.insert(record);
+    for (size_t i = 0; i < records.size(); ++i) {
+      n->AddTuningRecord(records[i], workload_indices[i], is_valid[i]);
     }
   }
   n->path_workload = path_workload;
   n->path_tuning_record = path_tuning_record;
+  n->retention_top_k = retention_top_k;
+  if (retention_top_k >= 0) {
+    // The files are only rewritten if anything loaded is not retained
+    int64_t num_retained = 0;
+    for (int i = 0, n_workloads = n->valid_records_.size(); i < n_workloads; ++i) {
+      num_retained += n->valid_records_[i].size() -
+                      n->PruneRecords(i, retention_top_k, NullOpt).size();
+    }
+    if (num_retained != n->Size()) {
+      n->Compact(retention_top_k);
+    }
+  }
   return Database(n);
 }
 
 TVM_REGISTER_NODE_TYPE(JSONDatabaseNode);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseJSONDatabase").set_body_typed(Database::JSONDatabase);
+TVM_REGISTER_GLOBAL("meta_schedule.JSONDatabaseCompact")
+    .set_body_typed([](Database database, int top_k) {
+      const auto* node = database.as<JSONDatabaseNode>();
+      CHECK(node) << "TypeError: Only JSONDatabase can be compacted, but got "
+                  << database->GetTypeKey();
+      const_cast<JSONDatabaseNode*>(node)->Compact(top_k);
+    });
 
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -0,0 +1,326 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifdef TVM_USE_SQLITE
+
+#include <sqlite3.h>
+
+#include <mutex>
+#include <unordered_map>
+
+#include "../module_equality.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+#define TVM_SQLITE_CALL(db, func)                                             \
+  {                                                                           \
+    int e = (func);                                                           \
+    CHECK(e == SQLITE_OK || e == SQLITE_ROW || e == SQLITE_DONE)              \
+        << "SQLiteError: " << sqlite3_errstr(e) << ": " << sqlite3_errmsg(db); \
+  }
+
+/*! \brief A prepared statement, finalized on destruction. */
+class SQLiteStatement {
+ public:
+  SQLiteStatement(sqlite3* db, const char* sql) : db_(db) {
+    TVM_SQLITE_CALL(db_, sqlite3_prepare_v2(db_, sql, -1, &stmt_, nullptr));
+  }
+  ~SQLiteStatement() { sqlite3_finalize(stmt_); }
+  SQLiteStatement(const SQLiteStatement&) = delete;
+  SQLiteStatement& operator=(const SQLiteStatement&) = delete;
+
+  SQLiteStatement& Bind(int index, int64_t value) {
+    TVM_SQLITE_CALL(db_, sqlite3_bind_int64(stmt_, index, value));
+    return *this;
+  }
+  SQLiteStatement& Bind(int index, double value) {
+    TVM_SQLITE_CALL(db_, sqlite3_bind_double(stmt_, index, value));
+    return *this;
+  }
+  SQLiteStatement& Bind(int index, const std::string& value) {
+    TVM_SQLITE_CALL(db_, sqlite3_bind_text(stmt_, index, value.data(),
+                                           static_cast<int>(value.size()), SQLITE_TRANSIENT));
+    return *this;
+  }
+  /*! \return Whether a row is available. */
+  bool Step() {
+    int e = sqlite3_step(stmt_);
+    TVM_SQLITE_CALL(db_, e);
+    return e == SQLITE_ROW;
+  }
+  int64_t ColumnInt(int index) { return sqlite3_column_int64(stmt_, index); }
+  std::string ColumnText(int index) {
+    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, index));
+    return std::string(text, sqlite3_column_bytes(stmt_, index));
+  }
+
+ private:
+  sqlite3* db_;
+  sqlite3_stmt* stmt_{nullptr};
+};
+
+/*!
+ * \brief A database backed by an SQLite file, which can be shared by concurrent tuning jobs.
+ *
+ * The workloads and tuning records are two tables, and the records are indexed by
+ * workload, validity and mean running time, so that the top-K query of a workload
+ * reads K rows. Nothing is loaded when the database is opened: workloads are parsed
+ * the first time they are looked up, and records when they are queried.
+ *
+ * The file is in write-ahead-log mode so that readers do not block the writer, and
+ * writers of different processes wait for each other up to a timeout.
+ */
+class SQLiteDatabaseNode : public DatabaseNode {
+ public:
+  explicit SQLiteDatabaseNode(String mod_eq_name = "structural")
+      : DatabaseNode(mod_eq_name),
+        workloads2id_(/*bucket_count*/ 0, WorkloadHash(), WorkloadEqual(GetModuleEquality())) {}
+
+  ~SQLiteDatabaseNode() {
+    if (db_ != nullptr) {
+      sqlite3_close(db_);
+    }
+  }
+
+  /*! \brief The path to the database file */
+  String path;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("path", &path);
+    // `db_` is not visited
+    // `workloads2id_` is not visited
+    // `id2workload_` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.SQLiteDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(SQLiteDatabaseNode, DatabaseNode);
+
+ public:
+  /*!
+   * \brief Open the database file, creating the tables if needed.
+   * \param path The path to the database file.
+   * \param busy_timeout_ms How long to wait for the writers of other processes.
+   */
+  void Open(const String& path, int busy_timeout_ms) {
+    this->path = path;
+    int e = sqlite3_open_v2(path.c_str(), &db_,
+                            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+                            nullptr);
+    CHECK_EQ(e, SQLITE_OK) << "ValueError: Cannot open database " << path << ": "
+                           << sqlite3_errstr(e);
+    TVM_SQLITE_CALL(db_, sqlite3_busy_timeout(db_, busy_timeout_ms));
+    Exec("PRAGMA journal_mode=WAL");
+    Exec("PRAGMA synchronous=NORMAL");
+    Exec(
+        "CREATE TABLE IF NOT EXISTS workloads ("
+        "  id INTEGER PRIMARY KEY,"
+        "  shash INTEGER NOT NULL,"
+        "  json TEXT NOT NULL)");
+    Exec("CREATE INDEX IF NOT EXISTS workloads_by_shash ON workloads (shash)");
+    Exec(
+        "CREATE TABLE IF NOT EXISTS tuning_records ("
+        "  id INTEGER PRIMARY KEY,"
+        "  workload_id INTEGER NOT NULL REFERENCES workloads (id),"
+        "  is_valid INTEGER NOT NULL,"
+        "  mean_run_secs REAL NOT NULL,"
+        "  json TEXT NOT NULL)");
+    Exec(
+        "CREATE INDEX IF NOT EXISTS tuning_records_by_workload "
+        "ON tuning_records (workload_id, is_valid, mean_run_secs, id)");
+  }
+
+  bool HasWorkload(const IRModule& mod) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FindWorkload(Workload(mod, GetModuleEquality().Hash(mod))) != -1;
+  }
+
+  Workload CommitWorkload(const IRModule& mod) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Workload workload(mod, GetModuleEquality().Hash(mod));
+    if (int64_t id = FindWorkload(workload); id != -1) {
+      return id2workload_.at(id);
+    }
+    // Look up again in a write transaction, the workload may have been committed by
+    // another process in between.
+    Exec("BEGIN IMMEDIATE");
+    int64_t id = -1;
+    try {
+      id = FindWorkload(workload);
+      if (id == -1) {
+        SQLiteStatement stmt(db_, "INSERT INTO workloads (shash, json) VALUES (?, ?)");
+        stmt.Bind(1, static_cast<int64_t>(workload->shash))
+            .Bind(2, JSONDumps(workload->AsJSON()))
+            .Step();
+        id = sqlite3_last_insert_rowid(db_);
+        AddWorkload(id, workload);
+      }
+      Exec("COMMIT");
+    } catch (...) {
+      sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+      throw;
+    }
+    return id2workload_.at(id);
+  }
+
+  void CommitTuningRecord(const TuningRecord& record) {
+    int64_t workload_id = -1;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      workload_id = FindWorkload(record->workload);
+    }
+    if (workload_id == -1) {
+      CommitWorkload(record->workload->mod);
+      std::lock_guard<std::mutex> lock(mutex_);
+      workload_id = FindWorkload(record->workload);
+    }
+    double mean_run_secs = SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value_or({}));
+    std::string json = JSONDumps(record->AsJSON());
+    std::lock_guard<std::mutex> lock(mutex_);
+    SQLiteStatement stmt(db_,
+                         "INSERT INTO tuning_records (workload_id, is_valid, mean_run_secs, json) "
+                         "VALUES (?, ?, ?, ?)");
+    stmt.Bind(1, workload_id)
+        .Bind(2, static_cast<int64_t>(record->IsValid()))
+        .Bind(3, mean_run_secs)
+        .Bind(4, json)
+        .Step();
+  }
+
+  Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    if (top_k == 0) {
+      return {};
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t workload_id = FindWorkload(workload);
+    if (workload_id == -1) {
+      return {};
+    }
+    SQLiteStatement stmt(db_,
+                         "SELECT json FROM tuning_records "
+                         "WHERE workload_id = ? AND is_valid = 1 "
+                         "ORDER BY mean_run_secs, id LIMIT ?");
+    stmt.Bind(1, workload_id).Bind(2, static_cast<int64_t>(top_k));
+    Array<TuningRecord> results;
+    while (stmt.Step()) {
+      results.push_back(
+          TuningRecord::FromJSON(JSONLoads(stmt.ColumnText(0)), id2workload_.at(workload_id)));
+    }
+    return results;
+  }
+
+  Array<TuningRecord> GetAllTuningRecords() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SQLiteStatement stmt(db_,
+                         "SELECT workload_id, json FROM tuning_records "
+                         "ORDER BY mean_run_secs, id");
+    Array<TuningRecord> results;
+    while (stmt.Step()) {
+      Workload workload = LoadWorkload(stmt.ColumnInt(0));
+      results.push_back(TuningRecord::FromJSON(JSONLoads(stmt.ColumnText(1)), workload));
+    }
+    return results;
+  }
+
+  int64_t Size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SQLiteStatement stmt(db_, "SELECT COUNT(*) FROM tuning_records");
+    ICHECK(stmt.Step());
+    return stmt.ColumnInt(0);
+  }
+
+ private:
+  void Exec(const char* sql) {
+    TVM_SQLITE_CALL(db_, sqlite3_exec(db_, sql, nullptr, nullptr, nullptr));
+  }
+
+  /*!
+   * \brief Find the id of a workload, parsing the stored workloads of the same hash on demand.
+   * \return The id, or -1 if the workload is not in the database.
+   */
+  int64_t FindWorkload(const Workload& workload) {
+    auto it = workloads2id_.find(workload);
+    if (it != workloads2id_.end()) {
+      return it->second;
+    }
+    SQLiteStatement stmt(db_, "SELECT id FROM workloads WHERE shash = ? ORDER BY id");
+    stmt.Bind(1, static_cast<int64_t>(workload->shash));
+    std::vector<int64_t> ids;
+    while (stmt.Step()) {
+      ids.push_back(stmt.ColumnInt(0));
+    }
+    for (int64_t id : ids) {
+      LoadWorkload(id);
+    }
+    it = workloads2id_.find(workload);
+    return it != workloads2id_.end() ? it->second : -1;
+  }
+
+  /*! \brief Get a workload by id, parsing it if it has not been loaded yet. */
+  Workload LoadWorkload(int64_t id) {
+    auto it = id2workload_.find(id);
+    if (it != id2workload_.end()) {
+      return it->second;
+    }
+    SQLiteStatement stmt(db_, "SELECT json FROM workloads WHERE id = ?");
+    stmt.Bind(1, id);
+    CHECK(stmt.Step()) << "ValueError: Workload " << id << " is missing from " << path;
+    Workload workload = Workload::FromJSON(JSONLoads(stmt.ColumnText(0)));
+    // Rehash with the module equality of this database, the stored hash may have
+    // been computed in another environment.
+    auto recalc_hash = GetModuleEquality().Hash(workload->mod);
+    if (recalc_hash != workload->shash) {
+      ObjectPtr<WorkloadNode> wkl = make_object<WorkloadNode>(*workload.get());
+      wkl->shash = recalc_hash;
+      workload = Workload(wkl);
+    }
+    return AddWorkload(id, workload);
+  }
+
+  Workload AddWorkload(int64_t id, const Workload& workload) {
+    auto [it, inserted] = workloads2id_.emplace(workload, id);
+    // Duplicates committed concurrently by other processes resolve to the first one.
+    Workload canonical = inserted ? workload : id2workload_.at(it->second);
+    id2workload_.emplace(id, canonical);
+    return canonical;
+  }
+
+  /*! \brief The lock serializing the use of the connection and of the caches. */
+  std::mutex mutex_;
+  /*! \brief The connection to the database. */
+  sqlite3* db_{nullptr};
+  /*! \brief The loaded workloads. */
+  std::unordered_map<Workload, int64_t, WorkloadHash, WorkloadEqual> workloads2id_;
+  /*! \brief The loaded workloads by id. */
+  std::unordered_map<int64_t, Workload> id2workload_;
+};
+
+TVM_REGISTER_NODE_TYPE(SQLiteDatabaseNode);
+TVM_REGISTER_GLOBAL("meta_schedule.DatabaseSQLiteDatabase")
+    .set_body_typed([](String path, int busy_timeout_ms, String mod_eq_name) -> Database {
+      ObjectPtr<SQLiteDatabaseNode> n = make_object<SQLiteDatabaseNode>(mod_eq_name);
+      n->Open(path, busy_timeout_ms);
+      return Database(n);
+    });
+
+}  // namespace meta_schedule
+}  // namespace tvm
+
+#endif  // TVM_USE_SQLITE
@@ -19,13 +19,16 @@
 #include <tvm/tir/transform.h>
 
 #include <cmath>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "../module_equality.h"
 #include "../utils.h"
 
 namespace tvm {
@@ -298,25 +301,108 @@ Pass SimplifyForFeatureExtraction() {
   return CreatePrimFuncPass(pass_func, 0, "tir.SimplifyForFeatureExtraction", {});
 }
 
+/*!
+ * \brief The constructs of a scheduled module that only some of the preprocessing passes lower.
+ * Scheduled modules rarely contain all of them, e.g. CPU schedules bind no threads, and the
+ * passes that would leave the module unchanged are skipped.
+ */
+struct FeatureLoweringNeeds {
+  /*! \brief Whether there is a block annotated as weight layout rewrite preprocessing */
+  bool layout_rewrite = false;
+  /*! \brief Whether there are loops bound to threads */
+  bool thread_binding = false;
+  /*! \brief Whether there is a block annotated with auto copy */
+  bool auto_copy = false;
+  /*! \brief Whether there is a block matching buffers */
+  bool match_buffer = false;
+
+  static FeatureLoweringNeeds Detect(const IRModule& mod) {
+    FeatureLoweringNeeds needs;
+    auto f_visit = [&needs](const ObjectRef& obj) -> bool {
+      if (obj->IsInstance<PrimExprNode>()) {
+        return false;
+      }
+      if (const auto* loop = obj.as<ForNode>()) {
+        needs.thread_binding |= loop->kind == ForKind::kThreadBinding;
+      } else if (const auto* attr = obj.as<AttrStmtNode>()) {
+        needs.thread_binding |=
+            attr->attr_key == attr::thread_extent || attr->attr_key == attr::virtual_thread;
+      } else if (const auto* block = obj.as<BlockNode>()) {
+        needs.layout_rewrite |=
+            block->annotations.count(attr::meta_schedule_layout_rewrite_preproc);
+        needs.auto_copy |= block->annotations.count(attr::auto_copy);
+        needs.match_buffer |= !block->match_buffers.empty();
+      }
+      return true;
+    };
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<PrimFuncNode>()) {
+        PreOrderVisit(func->body, f_visit);
+      }
+    }
+    return needs;
+  }
+
+  /*! \brief The index of the pass list in a table of all combinations */
+  int Index() const {
+    return layout_rewrite | thread_binding << 1 | auto_copy << 2 | match_buffer << 3;
+  }
+};
+
 /*!
  * \brief Create a list of passes that preprocesses the IR for feature extraction
+ * \param needs The constructs to be lowered
  * \return The list of passes created
  */
-Sequential PassListForPerStoreFeature() {
-  return Sequential({
-      tir::transform::RemoveWeightLayoutRewriteBlock(/*skip_ndarray_rewrite*/ true),
-      tir::transform::SimplifyForFeatureExtraction(),
-      tir::transform::LowerCrossThreadReduction(),
-      tir::transform::LowerInitBlock(),
-      tir::transform::PlanAndUpdateBufferAllocationLocation(),
-      tir::transform::ConvertBlocksToOpaque(),
-      tir::transform::CompactBufferAllocation(),
-      tir::transform::Simplify(),
-      tir::transform::LowerAutoCopy(),
-      tir::transform::UnifyThreadBinding(),
-      tir::transform::LowerMatchBuffer(),
-      tir::transform::Simplify(),
-  });
+Sequential PassListForPerStoreFeature(const FeatureLoweringNeeds& needs) {
+  Array<Pass> passes;
+  if (needs.layout_rewrite) {
+    passes.push_back(tir::transform::RemoveWeightLayoutRewriteBlock(/*skip_ndarray_rewrite*/ true));
+  }
+  passes.push_back(tir::transform::SimplifyForFeatureExtraction());
+  if (needs.thread_binding) {
+    passes.push_back(tir::transform::LowerCrossThreadReduction());
+  }
+  passes.push_back(tir::transform::LowerInitBlock());
+  passes.push_back(tir::transform::PlanAndUpdateBufferAllocationLocation());
+  passes.push_back(tir::transform::ConvertBlocksToOpaque());
+  passes.push_back(tir::transform::CompactBufferAllocation());
+  passes.push_back(tir::transform::Simplify());
+  if (needs.auto_copy) {
+    passes.push_back(tir::transform::LowerAutoCopy());
+  }
+  if (needs.thread_binding) {
+    passes.push_back(tir::transform::UnifyThreadBinding());
+  }
+  if (needs.match_buffer) {
+    passes.push_back(tir::transform::LowerMatchBuffer());
+  }
+  if (needs.auto_copy || needs.thread_binding || needs.match_buffer) {
+    passes.push_back(tir::transform::Simplify());
+  }
+  return Sequential(passes);
+}
+
+/*!
+ * \brief Preprocess a scheduled module for feature extraction
+ * \param mod The module to be preprocessed
+ * \return The preprocessed module
+ */
+IRModule LowerForPerStoreFeature(IRModule mod) {
+  static const std::vector<Sequential> pass_lists = []() {
+    std::vector<Sequential> result;
+    for (int i = 0; i < 16; ++i) {
+      FeatureLoweringNeeds needs;
+      needs.layout_rewrite = i & 1;
+      needs.thread_binding = i & 2;
+      needs.auto_copy = i & 4;
+      needs.match_buffer = i & 8;
+      result.push_back(PassListForPerStoreFeature(needs));
+    }
+    return result;
+  }();
+  const Sequential& passes = pass_lists[FeatureLoweringNeeds::Detect(mod).Index()];
+  return passes(std::move(mod));
 }
 
 }  // namespace transform
@@ -1372,8 +1458,7 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
   }
 
   void ExtractSingle(IRModule mod, bool is_gpu, std::vector<std::vector<double>>* results) {
-    static transform::Sequential passes = tir::transform::PassListForPerStoreFeature();
-    mod = passes(std::move(mod));
+    mod = tir::transform::LowerForPerStoreFeature(std::move(mod));
     std::vector<tir::Feature> features = tir::PerStoreFeatureCollector::Collect(
         is_gpu, this->cache_line_bytes, this->arith_intensity_curve_num_samples, mod);
     int n_features = features.size();
@@ -1395,20 +1480,29 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     bool is_gpu = tune_context->target.value()->kind->name == "cuda";
     std::vector<runtime::NDArray> results;
     results.resize(candidates.size());
+    Optional<IRModule> workload = NullOpt;
     std::unique_ptr<tir::group6::Feature> feature_group6 = nullptr;
     if (extract_workload) {
-      feature_group6 = std::make_unique<tir::group6::Feature>(tune_context->mod.value());
+      workload = tune_context->mod.value();
+      feature_group6 = std::make_unique<tir::group6::Feature>(workload.value());
     }
-    auto f = [this, is_gpu, &feature_group6, &candidates, &results](int, int task_id) -> void {
-      const auto& candidate = candidates[task_id];
+    auto f = [this, is_gpu, &workload, &feature_group6, &candidates,
+              &results](int, int task_id) -> void {
+      IRModule mod = candidates[task_id]->sch->mod();
+      size_t hash = mod_eq_->Hash(mod);
+      if (Optional<runtime::NDArray> cached = LookupFeature(hash, mod, is_gpu, workload)) {
+        results[task_id] = cached.value();
+        return;
+      }
       std::vector<std::vector<double>> features;
-      ExtractSingle(DeepCopyIRModule(candidate->sch->mod()), is_gpu, &features);
+      ExtractSingle(DeepCopyIRModule(mod), is_gpu, &features);
       if (extract_workload) {
         for (auto& feature : features) {
           feature_group6->Export(&feature);
         }
       }
       results[task_id] = tir::utils::AsNDArray(features, this->feature_vector_length);
+      InsertFeature(hash, mod, is_gpu, workload, results[task_id]);
     };
     support::parallel_for_dynamic(0, candidates.size(), tune_context->num_threads, f);
     return results;
@@ -1416,6 +1510,80 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
 
   static constexpr const char* _type_key = "meta_schedule.PerStoreFeature";
   TVM_DECLARE_FINAL_OBJECT_INFO(PerStoreFeatureNode, FeatureExtractorNode);
+
+ private:
+  /*! \brief A feature tensor extracted from a scheduled module. */
+  struct CachedFeature {
+    size_t hash;
+    IRModule mod;
+    bool is_gpu;
+    Optional<IRModule> workload;
+    runtime::NDArray features;
+  };
+  using CacheList = std::list<CachedFeature>;
+
+  /*! \brief The maximum number of feature tensors kept in the feature cache. */
+  static constexpr size_t kFeatureCacheCapacity = 4096;
+
+  /*!
+   * \brief Find the cached feature tensor of a scheduled module and mark it as recently used.
+   * \note Measured candidates are usually extracted twice, once when the cost model ranks them in
+   * the evolutionary search and once when the cost model is updated with their run time, and the
+   * surviving population is extracted again in every round.
+   */
+  Optional<runtime::NDArray> LookupFeature(size_t hash, const IRModule& mod, bool is_gpu,
+                                           const Optional<IRModule>& workload) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto range = cache_index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      CacheList::iterator entry = it->second;
+      if (entry->is_gpu != is_gpu || !SameWorkload(entry->workload, workload)) {
+        continue;
+      }
+      if (entry->mod.same_as(mod) || mod_eq_->Equal(entry->mod, mod)) {
+        cache_list_.splice(cache_list_.end(), cache_list_, entry);
+        return entry->features;
+      }
+    }
+    return NullOpt;
+  }
+
+  /*! \brief Add a feature tensor to the cache, evicting the least recently used ones. */
+  void InsertFeature(size_t hash, const IRModule& mod, bool is_gpu,
+                     const Optional<IRModule>& workload, const runtime::NDArray& features) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_index_.emplace(hash, cache_list_.insert(cache_list_.end(),
+                                                  CachedFeature{hash, mod, is_gpu, workload,
+                                                                features}));
+    while (cache_list_.size() > kFeatureCacheCapacity) {
+      CacheList::iterator victim = cache_list_.begin();
+      auto range = cache_index_.equal_range(victim->hash);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == victim) {
+          cache_index_.erase(it);
+          break;
+        }
+      }
+      cache_list_.pop_front();
+    }
+  }
+
+  /*! \brief Whether two feature tensors were extracted against the same workload, if any. */
+  bool SameWorkload(const Optional<IRModule>& lhs, const Optional<IRModule>& rhs) const {
+    if (!lhs.defined() || !rhs.defined()) {
+      return !lhs.defined() && !rhs.defined();
+    }
+    return lhs.same_as(rhs) || mod_eq_->Equal(lhs.value(), rhs.value());
+  }
+
+  /*! \brief The module equality keying the feature cache, the default one of the databases. */
+  std::unique_ptr<ModuleEquality> mod_eq_ = ModuleEquality::Create("structural");
+  /*! \brief The mutex guarding the feature cache. */
+  std::mutex cache_mutex_;
+  /*! \brief The cached feature tensors, from the least to the most recently used. */
+  CacheList cache_list_;
+  /*! \brief The module hash of the cached feature tensors. */
+  std::unordered_multimap<size_t, CacheList::iterator> cache_index_;
 };
 
 FeatureExtractor FeatureExtractor::PerStoreFeature(int buffers_per_store,
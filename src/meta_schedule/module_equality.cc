@@ -32,8 +32,23 @@ namespace meta_schedule {
 
 class ModuleEqualityStructural : public ModuleEquality {
  public:
-  size_t Hash(IRModule mod) const { return tvm::StructuralHash()(mod); }
-  bool Equal(IRModule lhs, IRModule rhs) const { return tvm::StructuralEqual()(lhs, rhs); }
+  // Modules with at least this many functions are hashed and compared function-by-function in
+  // parallel. Equal modules have the same number of functions, hence the same choice is made for
+  // both sides and Hash stays consistent with Equal.
+  static constexpr size_t kParallelMinNumFunctions = 16;
+
+  size_t HashImpl(IRModule mod) const {
+    if (mod->functions.size() >= kParallelMinNumFunctions) {
+      return ParallelStructuralHash(mod);
+    }
+    return tvm::StructuralHash()(mod);
+  }
+  bool Equal(IRModule lhs, IRModule rhs) const {
+    if (lhs->functions.size() >= kParallelMinNumFunctions) {
+      return ParallelStructuralEqual(lhs, rhs);
+    }
+    return tvm::StructuralEqual()(lhs, rhs);
+  }
   String GetName() const { return "structural"; }
 };
 
@@ -56,7 +71,7 @@ class SEqualHandlerIgnoreNDArray : public SEqualHandlerDefault {
 
 class ModuleEqualityIgnoreNDArray : public ModuleEquality {
  public:
-  size_t Hash(IRModule mod) const { return SHashHandlerIgnoreNDArray().Hash(mod, false); }
+  size_t HashImpl(IRModule mod) const { return SHashHandlerIgnoreNDArray().Hash(mod, false); }
   bool Equal(IRModule lhs, IRModule rhs) const {
     return SEqualHandlerIgnoreNDArray().Equal(lhs, rhs, false);
   }
@@ -66,12 +81,12 @@ class ModuleEqualityIgnoreNDArray : public ModuleEquality {
 // The NDArray-ignoring variant of structural equal / hash is used for the module equality
 // on the extracted anchor blocks.
 class ModuleEqualityAnchorBlock : public ModuleEquality {
-  size_t Hash(IRModule mod) const {
+  size_t HashImpl(IRModule mod) const {
     auto anchor_block = tir::FindAnchorBlock(mod);
     if (anchor_block) {
       return SHashHandlerIgnoreNDArray().Hash(GetRef<tir::Block>(anchor_block), false);
     }
-    return ModuleEqualityIgnoreNDArray().Hash(mod);
+    return ModuleEqualityIgnoreNDArray().HashImpl(mod);
   }
   bool Equal(IRModule lhs, IRModule rhs) const {
     auto anchor_block_lhs = tir::FindAnchorBlock(lhs);
@@ -20,6 +20,7 @@
 #define TVM_META_SCHEDULE_MODULE_EQUALITY_H_
 
 #include <tvm/ir/module.h>
+#include <tvm/node/structural_hash.h>
 
 #include <memory>
 #include <string>
@@ -32,7 +33,17 @@ class ModuleEquality {
  public:
   virtual ~ModuleEquality() = default;
 
-  virtual size_t Hash(IRModule mod) const = 0;
+  /*!
+   * \brief Hash a module.
+   * \note The hash values are memoized per module, tuning hashes the same modules many times.
+   */
+  size_t Hash(IRModule mod) const {
+    return hash_cache_.Hash(mod, [this](const ObjectRef& obj) {
+      return this->HashImpl(Downcast<IRModule>(obj));
+    });
+  }
+  /*! \brief Compute the hash value of a module, without memoization. */
+  virtual size_t HashImpl(IRModule mod) const = 0;
   virtual bool Equal(IRModule lhs, IRModule rhs) const = 0;
   virtual String GetName() const = 0;
 
@@ -50,6 +61,10 @@ class ModuleEquality {
    * \return An owning pointer to the created instance
    */
   static std::unique_ptr<ModuleEquality> Create(const std::string& mod_eq_name);
+
+ private:
+  /*! \brief The memoized hash values. */
+  mutable StructuralHashCache hash_cache_;
 };
 
 /*! \brief Functor to compute hash a module using the provided method. */
@@ -56,6 +56,7 @@ Array<Postproc> Postproc::DefaultLLVM() {
       Postproc::RewriteParallelVectorizeUnroll(),
       Postproc::RewriteReductionBlock(),
       Postproc::RewriteLayout(),
+      Postproc::RewriteSoftwarePipeline(),
   };
 }
 
@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*!
+ * \brief Find the loops whose body packs tiles of the inputs and then computes on them, which can
+ * be software pipelined so that the tile of the next iteration is packed during the computation on
+ * the tile of the current one.
+ */
+class PackedComputeLoopFinder : private StmtVisitor {
+ public:
+  /*! \brief A loop to be pipelined. */
+  struct Candidate {
+    /*! \brief The loop. */
+    const ForNode* loop;
+    /*! \brief The name of a block under the loop, used to retrieve it from the schedule. */
+    String block_name;
+    /*! \brief The number of statements in the body of the loop. */
+    int num_stmts;
+  };
+
+  static std::vector<Candidate> Find(const PrimFunc& func) {
+    PackedComputeLoopFinder finder;
+    // Count the blocks accessing each buffer, to check that the packed buffers are local to a loop
+    PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+      if (const auto* block = obj.as<BlockNode>()) {
+        for (const BufferNode* buffer : GetAccessedBuffers(block)) {
+          ++finder.num_accessing_blocks_[buffer];
+        }
+      }
+    });
+    for (const auto& kv : func->buffer_map) {
+      finder.param_buffers_.insert(kv.second.get());
+    }
+    finder(func->body);
+    return std::move(finder.candidates_);
+  }
+
+ private:
+  using BufferSet = std::unordered_set<const BufferNode*>;
+
+  static BufferSet GetAccessedBuffers(const BlockNode* block) {
+    BufferSet buffers;
+    for (const BufferRegion& region : block->reads) buffers.insert(region->buffer.get());
+    for (const BufferRegion& region : block->writes) buffers.insert(region->buffer.get());
+    return buffers;
+  }
+
+  static std::vector<const BlockNode*> CollectBlocks(const Stmt& stmt) {
+    std::vector<const BlockNode*> blocks;
+    PostOrderVisit(stmt, [&](const ObjectRef& obj) {
+      if (const auto* block = obj.as<BlockNode>()) {
+        blocks.push_back(block);
+      }
+    });
+    return blocks;
+  }
+
+  /*! \brief Get the buffer packed by a statement, if it is a loop nest around a single copy. */
+  const BufferNode* GetPackedBuffer(const Stmt& stmt) const {
+    std::vector<const BlockNode*> blocks = CollectBlocks(stmt);
+    if (blocks.size() != 1 || blocks[0]->writes.size() != 1 || blocks[0]->reads.size() != 1) {
+      return nullptr;
+    }
+    const auto* store = blocks[0]->body.as<BufferStoreNode>();
+    if (store == nullptr || !store->value->IsInstance<BufferLoadNode>()) {
+      return nullptr;
+    }
+    const BufferNode* buffer = store->buffer.get();
+    if (param_buffers_.count(buffer)) {
+      return nullptr;
+    }
+    return buffer;
+  }
+
+  bool IsPackedCompute(const SeqStmtNode* seq) const {
+    // Step 1. Collect the accesses of the computation, i.e. the last statement
+    std::vector<const BlockNode*> compute_blocks = CollectBlocks(seq->seq.back());
+    if (compute_blocks.empty()) {
+      return false;
+    }
+    BufferSet compute_reads, compute_writes;
+    for (const BlockNode* block : compute_blocks) {
+      for (const BufferRegion& region : block->reads) compute_reads.insert(region->buffer.get());
+      for (const BufferRegion& region : block->writes) compute_writes.insert(region->buffer.get());
+    }
+    // Step 2. Check that every other statement packs a buffer only used by the loop for the
+    // computation, from inputs that the computation does not write
+    std::unordered_map<const BufferNode*, int> num_uses_in_loop;
+    for (const BlockNode* block : compute_blocks) {
+      for (const BufferNode* buffer : GetAccessedBuffers(block)) {
+        ++num_uses_in_loop[buffer];
+      }
+    }
+    for (int i = 0, n = seq->seq.size(); i + 1 < n; ++i) {
+      const BufferNode* packed = GetPackedBuffer(seq->seq[i]);
+      if (packed == nullptr || !compute_reads.count(packed) || compute_writes.count(packed)) {
+        return false;
+      }
+      const BlockNode* pack_block = CollectBlocks(seq->seq[i])[0];
+      if (compute_writes.count(pack_block->reads[0]->buffer.get())) {
+        return false;
+      }
+      ++num_uses_in_loop[packed];
+    }
+    // Step 3. The packed buffers are versioned only if they are allocated under the loop
+    for (int i = 0, n = seq->seq.size(); i + 1 < n; ++i) {
+      const BufferNode* packed = GetPackedBuffer(seq->seq[i]);
+      if (num_uses_in_loop.at(packed) != num_accessing_blocks_.at(packed)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void VisitStmt_(const ForNode* loop) final {
+    const auto* extent = loop->extent.as<IntImmNode>();
+    const auto* seq = loop->body.as<SeqStmtNode>();
+    if (loop->kind == ForKind::kSerial && extent != nullptr && extent->value > 1 &&
+        seq != nullptr && seq->seq.size() >= 2 &&
+        !loop->annotations.count(attr::software_pipeline_stage) && IsPackedCompute(seq)) {
+      candidates_.push_back(Candidate{loop, CollectBlocks(seq->seq.back())[0]->name_hint,
+                                      static_cast<int>(seq->seq.size())});
+      return;
+    }
+    StmtVisitor::VisitStmt_(loop);
+  }
+
+  /*! \brief The buffers of the parameters of the function. */
+  BufferSet param_buffers_;
+  /*! \brief The number of blocks accessing each buffer in the function. */
+  std::unordered_map<const BufferNode*, int> num_accessing_blocks_;
+  /*! \brief The loops found. */
+  std::vector<Candidate> candidates_;
+};
+
+}  // namespace tir
+
+namespace meta_schedule {
+
+using tir::Schedule;
+
+/*!
+ * \brief Software pipeline the loops that pack the tiles of their inputs before computing on them,
+ * so that on CPUs the packing of the next tile overlaps with the computation on the current one.
+ */
+class RewriteSoftwarePipelineNode : public PostprocNode {
+ public:
+  // Inherited from PostprocNode
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    ICHECK(context->target.defined());
+    // GPUs pipeline the copies to shared memory asynchronously in MultiLevelTiling instead
+    enabled_ = context->target.value()->GetTargetDeviceType() == kDLCPU;
+  }
+
+  // Inherited from PostprocNode
+  bool Apply(const Schedule& sch) final {
+    if (!enabled_) {
+      return true;
+    }
+    for (const auto& kv : sch->mod()->functions) {
+      const GlobalVar& g_var = kv.first;
+      const auto* prim_func = kv.second.as<tir::PrimFuncNode>();
+      if (prim_func == nullptr) {
+        continue;
+      }
+      using Candidate = tir::PackedComputeLoopFinder::Candidate;
+      for (const Candidate& candidate :
+           tir::PackedComputeLoopFinder::Find(GetRef<tir::PrimFunc>(prim_func))) {
+        tir::BlockRV block_rv = sch->GetBlock(candidate.block_name, g_var->name_hint);
+        for (const tir::LoopRV& loop_rv : sch->GetLoops(block_rv)) {
+          if (sch->GetSRef(loop_rv)->stmt != candidate.loop) {
+            continue;
+          }
+          // The packing is the first stage, and the computation is the second stage
+          Array<Integer> stages(candidate.num_stmts - 1, Integer(0));
+          Array<Integer> orders;
+          for (int i = 0; i < candidate.num_stmts; ++i) {
+            orders.push_back(Integer(i));
+          }
+          stages.push_back(Integer(1));
+          sch->Annotate(loop_rv, tir::attr::software_pipeline_stage, stages);
+          sch->Annotate(loop_rv, tir::attr::software_pipeline_order, orders);
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Inherited from PostprocNode
+  Postproc Clone() const {
+    ObjectPtr<RewriteSoftwarePipelineNode> n = make_object<RewriteSoftwarePipelineNode>(*this);
+    return Postproc(n);
+  }
+
+  void VisitAttrs(tvm::AttrVisitor* v) {}
+
+  static constexpr const char* _type_key = "meta_schedule.RewriteSoftwarePipeline";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RewriteSoftwarePipelineNode, PostprocNode);
+
+ private:
+  /*! \brief Whether the target is a CPU. */
+  bool enabled_ = false;
+};
+
+Postproc Postproc::RewriteSoftwarePipeline() {
+  ObjectPtr<RewriteSoftwarePipelineNode> n = make_object<RewriteSoftwarePipelineNode>();
+  return Postproc(n);
+}
+
+TVM_REGISTER_NODE_TYPE(RewriteSoftwarePipelineNode);
+TVM_REGISTER_GLOBAL("meta_schedule.PostprocRewriteSoftwarePipeline")
+    .set_body_typed(Postproc::RewriteSoftwarePipeline);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -110,6 +110,18 @@ Integer Extract(const Target& target, const char* name) {
   throw;
 }
 
+/*! \brief The number of registers a thread can address on a CUDA target. */
+int64_t MaxRegistersPerThread(const Target& target) {
+  String arch = target->GetAttr<String>("arch").value_or("");
+  if (arch.size() > 3 && std::string(arch).substr(0, 3) == "sm_") {
+    // Kepler GK10x and the earlier architectures address 63 registers, the later ones 255
+    if (std::atoi(std::string(arch).substr(3).c_str()) < 32) {
+      return 63;
+    }
+  }
+  return 255;
+}
+
 /*! \brief Verify the correctness of the generated GPU code. */
 class VerifyGPUCodeNode : public PostprocNode {
  public:
@@ -126,6 +138,15 @@ class VerifyGPUCodeNode : public PostprocNode {
         {"max_vthread", Integer(8)},
         {"max_vector_bytes", Integer(16)},
     };
+    // Reject the candidates that are bound to spill registers before measuring them
+    if (this->target_->kind->name == "cuda") {
+      this->target_constraints_.Set("max_registers_per_thread",
+                                    Integer(MaxRegistersPerThread(this->target_)));
+      if (Optional<Integer> registers_per_block =
+              this->target_->GetAttr<Integer>("registers_per_block")) {
+        this->target_constraints_.Set("max_registers_per_block", registers_per_block.value());
+      }
+    }
     thread_warp_size_ = Extract(this->target_, "thread_warp_size").IntValue();
   }
 
@@ -168,6 +189,7 @@ class VerifyGPUCodeNode : public PostprocNode {
           pass_list.push_back(tir::transform::LowerAutoCopy());
           pass_list.push_back(tir::transform::UnifyThreadBinding());
           pass_list.push_back(tir::transform::LowerMatchBuffer());
+          pass_list.push_back(tir::transform::InjectWarpSpecialization());
           pass_list.push_back(tir::transform::InjectSoftwarePipeline());
           pass_list.push_back(tir::transform::LowerOpaqueBlock());
           pass_list.push_back(tir::transform::FlattenBuffer());
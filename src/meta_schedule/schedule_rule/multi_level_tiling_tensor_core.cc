@@ -510,8 +510,11 @@ std::vector<State> MultiLevelTilingTensorCoreNode::TransformIntermediateOutputLa
 std::vector<State> MultiLevelTilingTensorCoreNode::AddWriteReuseTensorCore(
     TensorCoreState state) const {
   if (state->is_mma) {
-    state->sch->WriteAt(state->tiles[2].back(), state->block_rv, 0, "m16n8k8.matrixC");
+    BlockRV store =
+        state->sch->WriteAt(state->tiles[2].back(), state->block_rv, 0, "m16n8k8.matrixC");
     state->sch->ReverseComputeInline(state->tensor_core_reindex_store);
+    // The elementwise epilogue is computed on the accumulators in registers
+    state->sch->FuseEpilogue(store);
     return {state};
   }
   // Add the cache write stage for Tensor Core
@@ -577,6 +580,9 @@ std::vector<State> MultiLevelTilingTensorCoreNode::AddWriteReuseTensorCore(
   sch->Fuse(Array<LoopRV>{buffer_loops.end() - 5,  // The src shmem is always 2D
                           buffer_loops.end()});
   AnnotateCooperativeFetching(&sch, state->write_reuse[0]);
+  // The wmma fragments are opaque, so the elementwise epilogue is computed on the way out of the
+  // shared memory
+  sch->FuseEpilogue(state->write_reuse[0]);
   return {state};
 }
 
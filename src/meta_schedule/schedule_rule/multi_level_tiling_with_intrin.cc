@@ -47,6 +47,11 @@ Optional<tir::BlockRV> TileForIntrin(tir::Schedule sch, tir::BlockRV block,
 class MultiLevelTilingWithIntrinNode : public MultiLevelTilingNode {
  protected:
   Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final {
+    // The block has been tiled for another intrinsic by a preceding rule
+    if (tir::GetAnn<String>(sch->GetSRef(block_rv), tir::attr::meta_schedule_tiling_structure)
+            .defined()) {
+      return {sch};
+    }
     auto desc_func = tir::TensorIntrin::Get(intrin_name).value()->desc;
     if (!CheckAutoTensorizeApplicable(sch, block_rv, desc_func)) {
       TVM_PY_LOG(INFO, logger) << "The workload cannot be tensorized.";
@@ -86,9 +86,12 @@ Array<ScheduleRule> ScheduleRule::DefaultLLVM() {
 }
 
 Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
-  static const Map<String, String> intrins = {{"vnni", "dot_16x4_vnni"},
-                                              {"avx512", "dot_16x4_avx512"}};
-  return {
+  // AMX only tensorizes the workloads divisible into 32x32x128 blocks, the others fall back to VNNI
+  static const Map<String, Array<String>> intrins = {
+      {"vnni", {"dot_16x4_vnni"}},
+      {"avx512", {"dot_16x4_avx512"}},
+      {"amx", {"dot_32x32x128_amx", "dot_16x4_vnni"}}};
+  Array<ScheduleRule> rules{
       ScheduleRule::ApplyCustomRule(),
       ScheduleRule::InlineConstantScalars(),
       ScheduleRule::AutoInline(
@@ -102,52 +105,60 @@ Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
       ScheduleRule::AddRFactor(
           /*max_jobs_per_core=*/16,
           /*max_innermost_factor=*/Integer(64)),
-      ScheduleRule::MultiLevelTilingWithIntrin(
-          /*intrin_name=*/intrins[type],
-          /*structure=*/"SSRSRS",
-          /*tile_binds=*/NullOpt,
-          /*max_innermost_factor=*/Integer(64),
-          /*vector_load_lens=*/NullOpt,
-          /*reuse_read=*/NullOpt,
-          /*reuse_write=*/
-          Map<String, ObjectRef>{{"req", String("may")},
-                                 {"levels", Array<Integer>{1, 2}},
-                                 {"scope", String("global")}}),
-      ScheduleRule::MultiLevelTiling(
-          /*structure=*/"SSRSRS",
-          /*tile_binds=*/NullOpt,
-          /*max_innermost_factor=*/Integer(64),
-          /*vector_load_lens=*/NullOpt,
-          /*reuse_read=*/NullOpt,
-          /*reuse_write=*/
-          Map<String, ObjectRef>{{"req", String("may")},
-                                 {"levels", Array<Integer>{1, 2}},
-                                 {"scope", String("global")}}),
-      ScheduleRule::ParallelizeVectorizeUnroll(
-          /*max_jobs_per_core=*/16,
-          /*max_vectorize_extent=*/64,
-          /*unroll_max_steps=*/Array<Integer>{0, 16, 64, 512},
-          /*unroll_explicit=*/true),
-      ScheduleRule::RandomComputeLocation(),
   };
+  for (const String& intrin_name : intrins.at(type)) {
+    rules.push_back(ScheduleRule::MultiLevelTilingWithIntrin(
+        /*intrin_name=*/intrin_name,
+        /*structure=*/"SSRSRS",
+        /*tile_binds=*/NullOpt,
+        /*max_innermost_factor=*/Integer(64),
+        /*vector_load_lens=*/NullOpt,
+        /*reuse_read=*/NullOpt,
+        /*reuse_write=*/
+        Map<String, ObjectRef>{{"req", String("may")},
+                               {"levels", Array<Integer>{1, 2}},
+                               {"scope", String("global")}}));
+  }
+  rules.push_back(ScheduleRule::MultiLevelTiling(
+      /*structure=*/"SSRSRS",
+      /*tile_binds=*/NullOpt,
+      /*max_innermost_factor=*/Integer(64),
+      /*vector_load_lens=*/NullOpt,
+      /*reuse_read=*/NullOpt,
+      /*reuse_write=*/
+      Map<String, ObjectRef>{{"req", String("may")},
+                             {"levels", Array<Integer>{1, 2}},
+                             {"scope", String("global")}}));
+  rules.push_back(ScheduleRule::ParallelizeVectorizeUnroll(
+      /*max_jobs_per_core=*/16,
+      /*max_vectorize_extent=*/64,
+      /*unroll_max_steps=*/Array<Integer>{0, 16, 64, 512},
+      /*unroll_explicit=*/true));
+  rules.push_back(ScheduleRule::RandomComputeLocation());
+  return rules;
 }
 
 Array<ScheduleRule> ScheduleRule::DefaultCUDA() {
+  ScheduleRule multi_level_tiling = ScheduleRule::MultiLevelTiling(
+      /*structure=*/"SSSRRSRS",
+      /*tile_binds=*/Array<String>{"blockIdx.x", "vthread.x", "threadIdx.x"},
+      /*max_innermost_factor=*/Integer(64),
+      /*vector_load_lens=*/Array<Integer>{1, 2, 3, 4, 8, 16},
+      /*reuse_read=*/
+      Map<String, ObjectRef>{{"req", String("must")},
+                             {"levels", Array<Integer>{4}},  //
+                             {"scope", String("shared")}},
+      /*reuse_write=*/
+      Map<String, ObjectRef>{{"req", String("must")},
+                             {"levels", Array<Integer>{3}},  //
+                             {"scope", String("local")}});
   return {
       ScheduleRule::ApplyCustomRule(),
-      ScheduleRule::MultiLevelTiling(
-          /*structure=*/"SSSRRSRS",
-          /*tile_binds=*/Array<String>{"blockIdx.x", "vthread.x", "threadIdx.x"},
-          /*max_innermost_factor=*/Integer(64),
-          /*vector_load_lens=*/Array<Integer>{1, 2, 3, 4, 8, 16},
-          /*reuse_read=*/
-          Map<String, ObjectRef>{{"req", String("must")},
-                                 {"levels", Array<Integer>{4}},  //
-                                 {"scope", String("shared")}},
-          /*reuse_write=*/
-          Map<String, ObjectRef>{{"req", String("must")},
-                                 {"levels", Array<Integer>{3}},  //
-                                 {"scope", String("local")}}),
+      ScheduleRule::SplitK(
+          /*split_factors=*/Array<Integer>{2, 4, 8, 16},
+          /*max_spatial_extent=*/4096,
+          /*tiling=*/multi_level_tiling->Clone()),
+      multi_level_tiling,
       ScheduleRule::InlineConstantScalars(),
       ScheduleRule::AutoInline(
           /*into_producer=*/true,
@@ -381,6 +392,28 @@ Array<ScheduleRule> GetARMDotprodSpecificRules() {
   };
 }
 
+Array<ScheduleRule> GetARMI8MMSpecificRules() {
+  // The MMLA instructions tensorize row-major operands, so that they take precedence over the
+  // dot products working on packed weights
+  Array<ScheduleRule> rules;
+  for (const char* intrin_name :
+       {"mmla_4x4x16_i8i8s32_smmla", "mmla_4x4x16_u8u8s32_ummla", "mmla_4x4x16_u8i8s32_usmmla",
+        "mmla_4x4x8_bf16bf16f32_bfmmla"}) {
+    rules.push_back(ScheduleRule::MultiLevelTilingWithIntrin(
+        /*intrin_name=*/String(intrin_name),
+        /*structure=*/"SSRSRS",
+        /*tile_binds=*/NullOpt,
+        /*max_innermost_factor=*/Integer(32),
+        /*vector_load_lens=*/NullOpt,
+        /*reuse_read=*/NullOpt,
+        /*reuse_write=*/
+        Map<String, ObjectRef>{{"req", String("may")},
+                               {"levels", Array<Integer>{1, 2}},
+                               {"scope", String("global")}}));
+  }
+  return rules;
+}
+
 Array<ScheduleRule> ScheduleRule::DefaultARM(const String& type) {
   return Array<ScheduleRule>::Agregate(
       ScheduleRule::ApplyCustomRule(), ScheduleRule::InlineConstantScalars(),
@@ -396,7 +429,8 @@ Array<ScheduleRule> ScheduleRule::DefaultARM(const String& type) {
           /*max_jobs_per_core=*/8,
           /*max_innermost_factor=*/Integer(32)),
       "neon" == type ? GetARMNeonSpecificRules() : Array<ScheduleRule>{},
-      "dotprod" == type ? GetARMDotprodSpecificRules() : Array<ScheduleRule>{},
+      "i8mm" == type ? GetARMI8MMSpecificRules() : Array<ScheduleRule>{},
+      "dotprod" == type || "i8mm" == type ? GetARMDotprodSpecificRules() : Array<ScheduleRule>{},
       ScheduleRule::MultiLevelTiling(
           /*structure=*/"SSRSRS",
           /*tile_binds=*/NullOpt,
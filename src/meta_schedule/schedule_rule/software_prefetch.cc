@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class SoftwarePrefetchNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {}
+
+  // Inherited from ScheduleRuleNode
+  Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final {
+    // Only mark the root block, the pragma applies to all the loops under it
+    if (sch->GetSRef(block_rv)->parent != nullptr || distances.empty()) {
+      return {sch};
+    }
+    int n = distances.size();
+    Array<FloatImm> probs(n, FloatImm(DataType::Float(64), 1.0 / n));
+    PrimExpr distance = sch->SampleCategorical(distances, probs);
+    sch->Annotate(block_rv, tir::attr::pragma_software_prefetch_distance, distance);
+    return {sch};
+  }
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<SoftwarePrefetchNode> n = make_object<SoftwarePrefetchNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ public:
+  /*! \brief The candidates of the lookahead distance in bytes, 0 for no prefetch. */
+  Array<Integer> distances;
+
+  void VisitAttrs(tvm::AttrVisitor* v) { v->Visit("distances", &distances); }
+
+  static constexpr const char* _type_key = "meta_schedule.SoftwarePrefetch";
+  TVM_DECLARE_FINAL_OBJECT_INFO(SoftwarePrefetchNode, ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::SoftwarePrefetch(Array<Integer> distances) {
+  for (const Integer& distance : distances) {
+    CHECK_GE(distance->value, 0)
+        << "ValueError: The prefetch distance must be non-negative, but got " << distance;
+  }
+  ObjectPtr<SoftwarePrefetchNode> n = make_object<SoftwarePrefetchNode>();
+  n->distances = std::move(distances);
+  return ScheduleRule(n);
+}
+
+TVM_REGISTER_NODE_TYPE(SoftwarePrefetchNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleSoftwarePrefetch")
+    .set_body_typed(ScheduleRule::SoftwarePrefetch);
+
+}  // namespace meta_schedule
+}  // namespace tvm
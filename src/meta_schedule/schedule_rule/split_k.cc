@@ -0,0 +1,203 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class SplitKNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    tiling->InitializeWithTuneContext(context);
+  }
+
+  // Inherited from ScheduleRuleNode
+  Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final;
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<SplitKNode> n = make_object<SplitKNode>(*this);
+    n->tiling = tiling->Clone();
+    return ScheduleRule(n);
+  }
+
+ private:
+  /*!
+   * \brief Get the split factors that are applicable to a block, i.e. that divide its reduction
+   * loops evenly and leave enough work to each split.
+   * \param sch The schedule
+   * \param block_rv The block to be split
+   * \return The applicable split factors, empty if the block is not a skinny GEMM-like block.
+   */
+  Array<Integer> GetApplicableFactors(const tir::Schedule& sch, const tir::BlockRV& block_rv);
+
+  /*!
+   * \brief Fuse the chain of elementwise consumers of the block reducing the partial sums into its
+   * loop nest, so that the epilogue does not launch another kernel.
+   * \param sch The schedule
+   * \param block_rv The block reducing the partial sums
+   * \param num_spatial_loops The number of spatial loops outside the block
+   */
+  void FuseReductionEpilogue(const tir::Schedule& sch, const tir::BlockRV& block_rv,
+                             size_t num_spatial_loops);
+
+ public:
+  /*! \brief Candidates of the number of splits of the reduction loops. */
+  Array<Integer> split_factors;
+  /*! \brief The largest spatial extent of the blocks that are split. */
+  int64_t max_spatial_extent;
+  /*! \brief The rule that tiles the block computing the partial sums. */
+  ScheduleRule tiling{nullptr};
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("split_factors", &split_factors);
+    v->Visit("max_spatial_extent", &max_spatial_extent);
+    v->Visit("tiling", &tiling);
+  }
+
+  /*!
+   * \brief The minimal extent of the reduction in each split, below which writing the partial sums
+   * costs more than the parallelism gained.
+   */
+  static constexpr int64_t kMinReductionPerSplit = 64;
+
+  static constexpr const char* _type_key = "meta_schedule.SplitK";
+  TVM_DECLARE_FINAL_OBJECT_INFO(SplitKNode, ScheduleRuleNode);
+};
+
+Array<Integer> SplitKNode::GetApplicableFactors(const tir::Schedule& sch,
+                                                const tir::BlockRV& block_rv) {
+  tir::StmtSRef block_sref = sch->GetSRef(block_rv);
+  // Only GEMM-like blocks are split, the other reductions are left to CrossThreadReduction
+  if (!tir::NeedsMultiLevelTiling(sch->state(), block_sref) ||
+      !tir::IsTrivialBinding(sch->state(), block_sref)) {
+    return {};
+  }
+  int64_t spatial_extent = 1;
+  int64_t reduction_extent = 1;
+  Array<tir::StmtSRef> loops = tir::GetLoops(block_sref);
+  for (size_t i = 0; i < loops.size(); ++i) {
+    const tir::ForNode* loop = TVM_SREF_TO_FOR(loops[i]);
+    const int64_t* extent = tir::GetLoopIntExtent(loop);
+    // The loops must be perfectly nested to be reordered and fused
+    const tir::StmtNode* child = i + 1 < loops.size()
+                                     ? loops[i + 1]->stmt
+                                     : tir::GetBlockRealize(sch->state(), block_sref).get();
+    if (extent == nullptr || loop->body.get() != child) {
+      return {};
+    }
+    tir::IterVarType type = tir::GetLoopIterType(loops[i]);
+    if (type == tir::kDataPar) {
+      spatial_extent *= *extent;
+    } else if (type == tir::kCommReduce) {
+      reduction_extent *= *extent;
+    } else {
+      return {};
+    }
+  }
+  // Enough blocks are launched over the spatial loops alone
+  if (spatial_extent > max_spatial_extent) {
+    return {};
+  }
+  Array<Integer> factors;
+  for (const Integer& factor : split_factors) {
+    if (reduction_extent % factor->value == 0 &&
+        reduction_extent / factor->value >= kMinReductionPerSplit) {
+      factors.push_back(factor);
+    }
+  }
+  return factors;
+}
+
+void SplitKNode::FuseReductionEpilogue(const tir::Schedule& sch, const tir::BlockRV& block_rv,
+                                       size_t num_spatial_loops) {
+  Array<tir::LoopRV> loops = sch->GetLoops(block_rv);
+  ICHECK_GT(loops.size(), num_spatial_loops);
+  if (num_spatial_loops == 0) {
+    return;
+  }
+  tir::LoopRV fused = num_spatial_loops == 1
+                          ? loops[0]
+                          : sch->Fuse({loops.begin(), loops.begin() + num_spatial_loops});
+  tir::BlockRV producer = block_rv;
+  for (;;) {
+    Array<tir::BlockRV> consumers = sch->GetConsumers(producer);
+    if (consumers.size() != 1 || !tir::IsSpatial(sch->GetSRef(consumers[0]))) {
+      break;
+    }
+    try {
+      sch->ReverseComputeAt(consumers[0], fused, /*preserve_unit_loops=*/true);
+    } catch (const tvm::runtime::Error& e) {
+      break;
+    }
+    producer = consumers[0];
+  }
+}
+
+Array<tir::Schedule> SplitKNode::Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) {
+  Array<Integer> factors = GetApplicableFactors(sch, block_rv);
+  if (factors.empty()) {
+    return {sch};
+  }
+  // Step 1. Make a copy of the original schedule. The new copy is used for scheduling.
+  tir::Schedule tmp_sch = sch->Copy();
+  tmp_sch->Seed(sch->ForkSeed());
+  // Step 2. Reorder the reduction loops innermost and fuse them, then split off the outer loop
+  // enumerating the splits.
+  size_t num_spatial_loops;
+  tir::LoopRV fused_reduce_loop;
+  ReorderAndFuseReductionLoops(tmp_sch, block_rv, &fused_reduce_loop, &num_spatial_loops);
+  int n_candidate = static_cast<int>(factors.size());
+  Array<FloatImm> probs(n_candidate, FloatImm(DataType::Float(64), 1.0 / n_candidate));
+  tir::ExprRV factor = tmp_sch->SampleCategorical(factors, probs);
+  Array<tir::LoopRV> split_loops = tmp_sch->Split(fused_reduce_loop, {factor, NullOpt});
+  // Step 3. Compute the partial sum of each split in a new block, where the splits are a spatial
+  // axis that is tiled and bound to blockIdx along with the others.
+  tir::BlockRV block_rf{nullptr};
+  try {
+    block_rf = tmp_sch->RFactor(split_loops[0], /*factor_axis=*/0);
+  } catch (const tvm::runtime::Error& e) {
+    return {sch};
+  }
+  // Step 4. The original block now reduces the partial sums, fuse the epilogue into it.
+  FuseReductionEpilogue(tmp_sch, block_rv, num_spatial_loops);
+  Array<tir::Schedule> results = tiling->Apply(tmp_sch, block_rf);
+  results.push_back(sch);
+  return results;
+}
+
+ScheduleRule ScheduleRule::SplitK(Array<Integer> split_factors, int64_t max_spatial_extent,
+                                  ScheduleRule tiling) {
+  for (const Integer& factor : split_factors) {
+    CHECK(factor->value > 1) << "ValueError: The candidates of split factor must be larger than 1";
+  }
+  CHECK(tiling.defined()) << "ValueError: The tiling rule of SplitK is not defined";
+  ObjectPtr<SplitKNode> n = make_object<SplitKNode>();
+  n->split_factors = std::move(split_factors);
+  n->max_spatial_extent = max_spatial_extent;
+  n->tiling = std::move(tiling);
+  return ScheduleRule(n);
+}
+
+TVM_REGISTER_NODE_TYPE(SplitKNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleSplitK").set_body_typed(ScheduleRule::SplitK);
+
+}  // namespace meta_schedule
+}  // namespace tvm
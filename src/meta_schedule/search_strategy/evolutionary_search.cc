@@ -18,6 +18,7 @@
  */
 
 #include "../module_equality.h"
+#include "../trace_apply.h"
 #include "../utils.h"
 
 #define TVM_META_SCHEDULE_CHECK_PROB_RANGE(p, name)                               \
@@ -31,37 +32,100 @@ using tir::Schedule;
 
 /**************** Data Structure ****************/
 
-/*! \brief An auxiliary data structure to help deduplicate IRModules */
-class IRModuleSet {
+/*!
+ * \brief Compute a fingerprint of a trace from its instructions and decisions, with the random
+ * variables numbered in the order they are defined. Replaying equal traces on the same module
+ * gives equal modules, so the fingerprint tells apart most schedules at a fraction of the cost of
+ * hashing their modules.
+ */
+size_t TraceFingerprint(const tir::Trace& trace) {
+  // Tells apart the random variables from the constants that could hash the same
+  constexpr uint64_t kRandomVariableSalt = 0x9e3779b97f4a7c15;
+  std::unordered_map<const Object*, int64_t> rv_index;
+  StructuralHash f_hash;
+  std::function<uint64_t(const ObjectRef&)> f_input = [&](const ObjectRef& obj) -> uint64_t {
+    if (!obj.defined()) {
+      return 0;
+    }
+    if (const auto* arr = obj.as<ArrayNode>()) {
+      uint64_t result = arr->size();
+      for (const ObjectRef& elem : *arr) {
+        result = support::HashCombine(result, f_input(elem));
+      }
+      return result;
+    }
+    auto it = rv_index.find(obj.get());
+    if (it != rv_index.end()) {
+      return support::HashCombine(kRandomVariableSalt, it->second);
+    }
+    return f_hash(obj);
+  };
+  uint64_t result = trace->insts.size();
+  for (const tir::Instruction& inst : trace->insts) {
+    result = support::HashCombine(result, std::hash<const Object*>()(inst->kind.get()));
+    for (const ObjectRef& input : inst->inputs) {
+      result = support::HashCombine(result, f_input(input));
+    }
+    result = support::HashCombine(result, f_hash(inst->attrs));
+    if (Optional<ObjectRef> decision = trace->decisions.Get(inst)) {
+      result = support::HashCombine(result, f_hash(decision.value()));
+    }
+    for (const ObjectRef& output : inst->outputs) {
+      int64_t index = rv_index.size();
+      rv_index.emplace(output.get(), index);
+    }
+  }
+  return result;
+}
+
+/*!
+ * \brief An auxiliary data structure to help deduplicate schedules. The modules are only hashed
+ * for the schedules whose traces are not seen yet, and only the hash values are kept, so that the
+ * set of measured schedules stays small over a long tuning. A hash collision at worst drops a new
+ * candidate, but never measures a duplicated one.
+ */
+class ScheduleSet {
  public:
-  explicit IRModuleSet(const ModuleEquality& mod_eq)
-      : tab_(/*bucket_count*/ 0, ItemHash(), ItemEqual(mod_eq)) {}
+  /*!
+   * \brief Constructor.
+   * \param mod_eq The module equality to hash the modules with.
+   * \param base If not null, the schedules in it are considered in the set as well, without
+   * being copied.
+   */
+  explicit ScheduleSet(const ModuleEquality& mod_eq, const ScheduleSet* base = nullptr)
+      : mod_eq_(mod_eq), base_(base) {}
 
-  /*! \brief Add an IRModule to the set */
-  void Add(const IRModule& mod, size_t shash) { tab_.insert(Item{mod, shash}); }
-  /*! \brief Check if the IRModule is in the set */
-  bool Has(const IRModule& mod, size_t shash) const { return tab_.count(Item{mod, shash}); }
+  /*!
+   * \brief Add a schedule to the set.
+   * \return Whether the schedule is not in the set before.
+   */
+  bool Insert(const Schedule& sch) {
+    size_t trace_hash = TraceFingerprint(sch->trace().value());
+    if (HasTrace(trace_hash)) {
+      return false;
+    }
+    trace_hashes_.insert(trace_hash);
+    size_t mod_hash = mod_eq_.Hash(sch->mod());
+    if (HasModule(mod_hash)) {
+      return false;
+    }
+    mod_hashes_.insert(mod_hash);
+    return true;
+  }
 
  private:
-  struct Item {
-    IRModule mod;
-    size_t shash;
-  };
-  struct ItemHash {
-    size_t operator()(const Item& hash) const { return hash.shash; }
-  };
-  struct ItemEqual {
-    explicit ItemEqual(const ModuleEquality& mod_eq) : mod_eq_(mod_eq) {}
-    ItemEqual& operator=(const ItemEqual& other) { return *this; }
-
-    bool operator()(const Item& lhs, const Item& rhs) const {
-      return lhs.shash == rhs.shash && mod_eq_.Equal(lhs.mod, rhs.mod);
-    }
+  bool HasTrace(size_t trace_hash) const {
+    return trace_hashes_.count(trace_hash) || (base_ != nullptr && base_->HasTrace(trace_hash));
+  }
 
-    const ModuleEquality& mod_eq_;
-  };
+  bool HasModule(size_t mod_hash) const {
+    return mod_hashes_.count(mod_hash) || (base_ != nullptr && base_->HasModule(mod_hash));
+  }
 
-  std::unordered_set<Item, ItemHash, ItemEqual> tab_;
+  const ModuleEquality& mod_eq_;
+  const ScheduleSet* base_;
+  std::unordered_set<size_t> trace_hashes_;
+  std::unordered_set<size_t> mod_hashes_;
 };
 
 /*!
@@ -109,11 +173,24 @@ class SizedHeap {
   std::vector<Item> heap;
 };
 
+/*!
+ * \brief A schedule replaying a prefix of a trace in the population, which the traces mutated
+ * after the prefix copy instead of replaying the prefix again.
+ */
+struct TracePrefix {
+  /*! \brief The schedule replaying the prefix, never modified */
+  Schedule sch{nullptr};
+  /*! \brief The mapping from the random variables of the trace to those of the schedule */
+  std::unordered_map<const Object*, const Object*> rv_map;
+};
+
 struct PerThreadData {
   IRModule mod{nullptr};
   TRandState rand_state{-1};
   std::function<int32_t()> trace_sampler = nullptr;
   std::function<Optional<Mutator>()> mutator_sampler = nullptr;
+  /*! \brief The replayed prefixes, indexed by the trace in the population and the prefix length */
+  std::map<std::pair<int, int>, TracePrefix> trace_prefixes;
 
   /*!
    * \brief Set the value for the trace and mutator samplers per thread.
@@ -125,6 +202,49 @@ struct PerThreadData {
            const Map<Mutator, FloatImm>& mutator_probs) {
     trace_sampler = tir::MakeMultinomialSampler(&rand_state, scores);
     mutator_sampler = MakeMutatorSampler(genetic_mutate_prob, mutator_probs, &rand_state);
+    trace_prefixes.clear();
+  }
+
+  /*!
+   * \brief Replay a trace mutated from a trace in the population. The instructions before the
+   * first mutated decision are not replayed again if another mutation of the same trace has
+   * replayed them, the schedule replaying them is copied instead.
+   * \param trace_id The index of the trace in the population
+   * \param trace The trace in the population
+   * \param new_trace The mutated trace
+   * \return The schedule where the mutated trace is replayed, without postprocessing
+   */
+  Schedule ReplayMutatedTrace(int trace_id, const tir::Trace& trace, const tir::Trace& new_trace) {
+    const Array<tir::Instruction>& insts = new_trace->insts;
+    int n = tir::GetNumValidInstructions(insts, /*remove_postproc=*/true);
+    int prefix_len = 0;
+    for (int n_old = trace->insts.size(); prefix_len < n && prefix_len < n_old; ++prefix_len) {
+      const tir::Instruction& inst = insts[prefix_len];
+      if (!inst.same_as(trace->insts[prefix_len]) ||
+          !new_trace->GetDecision(inst).same_as(trace->GetDecision(inst))) {
+        break;
+      }
+    }
+    Schedule sch{nullptr};
+    std::unordered_map<const Object*, const Object*> rv_map;
+    auto it = trace_prefixes.find({trace_id, prefix_len});
+    if (it != trace_prefixes.end()) {
+      sch = it->second.sch->Copy();
+      sch->Seed(ForkSeed(&rand_state));
+      rv_map = it->second.rv_map;
+    } else {
+      sch = Schedule::Traced(mod,
+                             /*rand_state=*/ForkSeed(&rand_state),
+                             /*debug_mode=*/0,
+                             /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+      ReplayInstructions(new_trace, 0, prefix_len, sch, &rv_map);
+      if (prefix_len > 0) {
+        trace_prefixes.emplace(std::make_pair(trace_id, prefix_len),
+                               TracePrefix{sch->Copy(), rv_map});
+      }
+    }
+    ReplayInstructions(new_trace, prefix_len, n, sch, &rv_map);
+    return sch;
   }
 
  private:
@@ -133,6 +253,17 @@ struct PerThreadData {
    * \param rand_state The random state for sampling
    * \return The sampler created
    */
+  static void ReplayInstructions(const tir::Trace& trace, int begin, int end, const Schedule& sch,
+                                 std::unordered_map<const Object*, const Object*>* rv_map) {
+    for (int i = begin; i < end; ++i) {
+      const tir::Instruction& inst = trace->insts[i];
+      Array<ObjectRef> inputs = tir::TranslateInputRVs(inst->inputs, *rv_map);
+      Array<ObjectRef> outputs =
+          inst->kind->f_apply_to_schedule(sch, inputs, inst->attrs, trace->GetDecision(inst));
+      tir::TranslateAddOutputRVs(inst->outputs, outputs, rv_map);
+    }
+  }
+
   static std::function<Optional<Mutator>()> MakeMutatorSampler(
       double genetic_mutate_prob,                   //
       const Map<Mutator, FloatImm>& mutator_probs,  //
@@ -266,13 +397,18 @@ class EvolutionarySearchNode : public SearchStrategyNode {
      * \brief The workloads that are already measured.
      * TODO(junrushao1994): add records from the database to avoid re-measuring.
      * */
-    IRModuleSet measured_workloads_;
+    ScheduleSet measured_workloads_;
     /*! \brief A Database for selecting useful candidates. */
     Database database_{nullptr};
     /*! \brief A cost model helping to explore the search space */
     CostModel cost_model_{nullptr};
     /*! \brief The token registered for the given workload in database. */
     Workload token_{nullptr};
+    /*!
+     * \brief The traces transferred from the records of similar workloads, already refitted to the
+     * workload being tuned, from the most to the least promising.
+     */
+    std::vector<tir::Trace> transferred_traces_;
 
     explicit State(EvolutionarySearchNode* self, int max_trials, int num_trials_per_iter,
                    Array<Schedule> design_space_schedules, Database database, CostModel cost_model)
@@ -305,6 +441,18 @@ class EvolutionarySearchNode : public SearchStrategyNode {
      * \return The picked best candidates.
      */
     inline std::vector<Schedule> PickBestFromDatabase(int num);
+    /*!
+     * \brief Warm start the search from the records of workloads of the same structure but of
+     * different shapes. The cost model is pretrained on their records, and their best traces are
+     * transferred to the workload being tuned.
+     */
+    inline void WarmStart();
+    /*!
+     * \brief Pick up the candidates transferred from similar workloads.
+     * \param num The number of traces to produce.
+     * \return The picked transferred candidates.
+     */
+    inline std::vector<Schedule> PickTransferred(int num);
     /*!
      * \brief Sample the initial population from previous measured results and randomly generated
      *  traces via trace replaying.
@@ -333,12 +481,6 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     /*! \brief An interface method to be called by it's counterpart in EvolutionarySearchNode */
     inline void NotifyRunnerResults(const Array<MeasureCandidate>& measure_candidates,
                                     const Array<RunnerResult>& results);
-    /*!
-     * \brief Compute the hash for the given module.
-     * \param mod The input TIR module.
-     * \return The calculated hash.
-     */
-    inline size_t ModuleHash(const IRModule& mod) const;
   };
 
   /*! \brief The tuning context of the evolutionary search strategy. */
@@ -363,6 +505,11 @@ class EvolutionarySearchNode : public SearchStrategyNode {
   /*** Configuration: the initial population ***/
   /*! \brief The ratio of measured states used in the initial population */
   double init_measured_ratio;
+  /*!
+   * \brief The ratio of the initial population seeded from the states of similar workloads, when
+   * there are not enough measured states. Zero disables the warm start from similar workloads.
+   */
+  double init_transferred_ratio;
   /*! \brief The minimal size of unmeasured population in the initial sampling.*/
   int init_min_unmeasured;
   /*! \brief The maximum number of failure during initial sampling. */
@@ -388,6 +535,7 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     v->Visit("num_empty_iters_before_early_stop", &num_empty_iters_before_early_stop);
     /*** Configuration: the initial population ***/
     v->Visit("init_measured_ratio", &init_measured_ratio);
+    v->Visit("init_transferred_ratio", &init_transferred_ratio);
     v->Visit("init_min_unmeasured", &init_min_unmeasured);
     v->Visit("max_fail_count", &max_fail_count);
     /*** Configuration: evolution ***/
@@ -434,6 +582,9 @@ class EvolutionarySearchNode : public SearchStrategyNode {
         << "ValueError: `PreTuning` is already invoked without corresponding `PostTuning`.";
     this->state_ = std::make_unique<State>(this, max_trials, num_trials_per_iter, design_spaces,
                                            database.value(), cost_model.value());
+    if (this->init_transferred_ratio > 0.0) {
+      this->state_->WarmStart();
+    }
   }
 
   void PostTuning() final {
@@ -458,6 +609,7 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     n->population_size = this->population_size;
     n->num_empty_iters_before_early_stop = this->num_empty_iters_before_early_stop;
     n->init_measured_ratio = this->init_measured_ratio;
+    n->init_transferred_ratio = this->init_transferred_ratio;
     n->init_min_unmeasured = this->init_min_unmeasured;
     n->max_fail_count = this->max_fail_count;
     n->genetic_num_iters = this->genetic_num_iters;
@@ -501,6 +653,138 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickBestFromDatabase(int nu
   return results;
 }
 
+void EvolutionarySearchNode::State::WarmStart() {
+  auto _ = Profiler::TimedScope("EvoSearch/WarmStart");
+  const TuneContextNode* ctx = self->ctx_;
+  IRModule mod = ctx->mod.value();
+  size_t key = WorkloadStructuralKey(mod);
+  const ModuleEquality& mod_eq = database_->GetModuleEquality();
+  // Step 1. Collect the valid records of the similar workloads, tuned for the same kind of target
+  struct SimilarWorkload {
+    IRModule mod;
+    double distance;
+    std::vector<TuningRecord> records;
+  };
+  std::vector<SimilarWorkload> similar;
+  std::unordered_map<const WorkloadNode*, int> workload_index;
+  for (const TuningRecord& record : database_->GetAllTuningRecords()) {
+    if (!record->IsValid()) {
+      continue;
+    }
+    if (record->target.defined() && ctx->target.defined() &&
+        record->target.value()->kind->name != ctx->target.value()->kind->name) {
+      continue;
+    }
+    const WorkloadNode* workload = record->workload.get();
+    auto it = workload_index.find(workload);
+    if (it == workload_index.end()) {
+      int index = -1;
+      bool same_workload = workload->shash == token_->shash && mod_eq.Equal(workload->mod, mod);
+      if (!same_workload && WorkloadStructuralKey(workload->mod) == key) {
+        index = similar.size();
+        similar.push_back(SimilarWorkload{workload->mod, WorkloadShapeDistance(mod, workload->mod),
+                                          std::vector<TuningRecord>()});
+      }
+      it = workload_index.emplace(workload, index).first;
+    }
+    if (it->second != -1) {
+      similar[it->second].records.push_back(record);
+    }
+  }
+  if (similar.empty()) {
+    return;
+  }
+  // Step 2. Rank the workloads by the distance of shapes, and their records by the run time
+  std::stable_sort(similar.begin(), similar.end(),
+                   [](const SimilarWorkload& a, const SimilarWorkload& b) {
+                     return a.distance < b.distance;
+                   });
+  for (SimilarWorkload& workload : similar) {
+    std::stable_sort(workload.records.begin(), workload.records.end(),
+                     SortTuningRecordByMeanRunSecs());
+  }
+  // Step 3. Pretrain the cost model, with one tuning context per workload so that the run time of
+  // each workload is normalized separately
+  int num_pretrain = self->population_size;
+  for (const SimilarWorkload& workload : similar) {
+    if (num_pretrain <= 0) {
+      break;
+    }
+    int n = std::min<int>(num_pretrain, workload.records.size());
+    num_pretrain -= n;
+    Array<MeasureCandidate> candidates;
+    Array<RunnerResult> results;
+    candidates.reserve(n);
+    results.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      const TuningRecord& record = workload.records[i];
+      candidates.push_back(record->AsMeasureCandidate());
+      results.push_back(RunnerResult(record->run_secs, NullOpt));
+    }
+    TuneContext context(workload.mod, ctx->target, NullOpt, NullOpt, ctx->task_name,
+                        ctx->num_threads, ForkSeed(&self->rand_state_), ctx->logger);
+    cost_model_->Update(context, candidates, results);
+  }
+  // Step 4. Transfer the best traces to the workload being tuned, the closest workloads first
+  int num_transfer = self->population_size * self->init_transferred_ratio;
+  std::vector<tir::Trace> traces;
+  traces.reserve(num_transfer);
+  for (const SimilarWorkload& workload : similar) {
+    for (const TuningRecord& record : workload.records) {
+      if (static_cast<int>(traces.size()) >= num_transfer) {
+        break;
+      }
+      traces.push_back(record->trace);
+    }
+  }
+  ThreadedTraceApply pp(self->postprocs_);
+  std::vector<Optional<tir::Trace>> results(traces.size(), NullOpt);
+  auto f_transfer = [this, &traces, &results, &pp](int thread_id, int trace_id) -> void {
+    PerThreadData& data = this->per_thread_data_.at(thread_id);
+    const tir::Trace& trace = traces.at(trace_id);
+    try {
+      Optional<Schedule> sch = pp.Apply(data.mod, &data.rand_state, [&trace](const Schedule& sch) {
+        ApplyTraceAcrossShapes(sch, trace);
+      });
+      if (sch.defined()) {
+        results.at(trace_id) = sch.value()->trace();
+      }
+    } catch (const std::exception&) {
+      // The trace does not apply to the workload being tuned, e.g. the loops it relies on are
+      // eliminated because of the shapes
+    }
+  };
+  support::parallel_for_dynamic(0, traces.size(), ctx->num_threads, f_transfer);
+  for (const Optional<tir::Trace>& trace : results) {
+    if (trace.defined()) {
+      transferred_traces_.push_back(trace.value());
+    }
+  }
+  TVM_PY_LOG(INFO, ctx->logger) << "Warm started from " << similar.size()
+                                << " similar workload(s), transferring "
+                                << transferred_traces_.size() << " out of " << traces.size()
+                                << " trace(s)";
+}
+
+std::vector<Schedule> EvolutionarySearchNode::State::PickTransferred(int num) {
+  auto _ = Profiler::TimedScope("EvoSearch/PickTransferred");
+  int actual_num = std::min<int>(std::max(num, 0), transferred_traces_.size());
+  ThreadedTraceApply pp(self->postprocs_);
+  std::vector<Schedule> results(actual_num, Schedule{nullptr});
+  auto f_proc_transferred = [this, &results, &pp](int thread_id, int trace_id) -> void {
+    PerThreadData& data = this->per_thread_data_.at(thread_id);
+    if (Optional<Schedule> sch =
+            pp.Apply(data.mod, this->transferred_traces_.at(trace_id), &data.rand_state)) {
+      results.at(trace_id) = sch.value();
+    }
+  };
+  support::parallel_for_dynamic(0, actual_num, self->ctx_->num_threads, f_proc_transferred);
+  results.erase(std::remove_if(results.begin(), results.end(),
+                               [](const Schedule& sch) { return !sch.defined(); }),
+                results.end());
+  return results;
+}
+
 std::vector<Schedule> EvolutionarySearchNode::State::SampleInitPopulation(int num) {
   auto _ = Profiler::TimedScope("EvoSearch/SampleInitPopulation");
   ThreadedTraceApply pp(self->postprocs_);
@@ -538,13 +822,9 @@ std::vector<Schedule> EvolutionarySearchNode::State::SampleInitPopulation(int nu
 
 std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
     std::vector<Schedule> population, int num) {
-  IRModuleSet exists(database_->GetModuleEquality());
-  {
-    auto _ = Profiler::TimedScope("EvoSearch/Evolve/Misc/CopyMeasuredWorkloads");
-    ICHECK_GT(num, 0);
-    // The heap to record best schedule, we do not consider schedules that are already measured
-    exists = this->measured_workloads_;
-  }
+  ICHECK_GT(num, 0);
+  // The heap to record best schedule, we do not consider schedules that are already measured
+  ScheduleSet exists(database_->GetModuleEquality(), &this->measured_workloads_);
   SizedHeap heap(num);
   for (int iter = 0;; ++iter) {
     // Predict normalized score with the cost model,
@@ -555,13 +835,9 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
       auto _ = Profiler::TimedScope("EvoSearch/Evolve/Misc");
       ICHECK_EQ(scores.size(), population.size());
       for (int i = 0, n = population.size(); i < n; ++i) {
-        Schedule sch = population.at(i);
-        IRModule mod = sch->mod();
-        size_t shash = ModuleHash(mod);
-        double score = scores.at(i);
-        if (!exists.Has(mod, shash)) {
-          exists.Add(mod, shash);
-          heap.Push(sch, score);
+        const Schedule& sch = population.at(i);
+        if (exists.Insert(sch)) {
+          heap.Push(sch, scores.at(i));
         }
       }
       // Discontinue once it reaches end of search
@@ -584,7 +860,6 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
         // Prepare samplers
         PerThreadData& data = this->per_thread_data_.at(thread_id);
         TRandState* rand_state = &data.rand_state;
-        const IRModule& mod = data.mod;
         std::function<int()>& trace_sampler = data.trace_sampler;
         std::function<Optional<Mutator>()>& mutator_sampler = data.mutator_sampler;
         Schedule& result = next_population.at(trace_id);
@@ -597,7 +872,9 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
             // Decision: mutate
             Mutator mutator = opt_mutator.value();
             if (Optional<tir::Trace> new_trace = mutator->Apply(trace, rand_state)) {
-              if (Optional<Schedule> sch = pp.Apply(mod, new_trace.value(), rand_state)) {
+              Schedule replayed =
+                  data.ReplayMutatedTrace(sampled_trace_id, trace, new_trace.value());
+              if (Optional<Schedule> sch = pp.ApplyPostprocs(replayed)) {
                 // note that sch's trace is different from new_trace
                 // because it contains post-processing information
                 result = sch.value();
@@ -661,7 +938,7 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickWithEpsGreedy(
       tir::SampleWithoutReplacement(&self->rand_state_, unmeasured.size(), unmeasured.size());
   std::vector<Schedule> results;
   results.reserve(num);
-  IRModuleSet& measured_workloads = this->measured_workloads_;
+  ScheduleSet& measured_workloads = this->measured_workloads_;
   for (int i = 0, i_bests = 0, i_rands = 0; i < num; ++i) {
     bool has_best = i_bests < static_cast<int>(bests.size());
     bool has_rand = i_rands < static_cast<int>(rands.size());
@@ -686,10 +963,7 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickWithEpsGreedy(
         break;
       }
     }
-    IRModule mod = sch->mod();
-    size_t shash = ModuleHash(mod);
-    if (!measured_workloads.Has(mod, shash)) {
-      measured_workloads.Add(mod, shash);
+    if (measured_workloads.Insert(sch)) {
       results.push_back(sch);
     }
   }
@@ -714,7 +988,15 @@ Optional<Array<MeasureCandidate>> EvolutionarySearchNode::State::GenerateMeasure
   std::vector<Schedule> measured = PickBestFromDatabase(pop * self->init_measured_ratio);
   TVM_PY_LOG(INFO, self->ctx_->logger)
       << "Picked top " << measured.size() << " candidate(s) from database";
-  std::vector<Schedule> unmeasured = SampleInitPopulation(pop - measured.size());
+  std::vector<Schedule> transferred =
+      PickTransferred(static_cast<int>(pop * self->init_transferred_ratio) -
+                      static_cast<int>(measured.size()));
+  if (!transferred.empty()) {
+    TVM_PY_LOG(INFO, self->ctx_->logger)
+        << "Picked " << transferred.size() << " candidate(s) transferred from similar workloads";
+  }
+  std::vector<Schedule> unmeasured =
+      SampleInitPopulation(pop - measured.size() - transferred.size());
   if (static_cast<int>(unmeasured.size()) < self->init_min_unmeasured) {
     TVM_PY_LOG(WARNING, self->ctx_->logger)
         << "Cannot sample enough initial population, evolutionary search failed.";
@@ -722,6 +1004,7 @@ Optional<Array<MeasureCandidate>> EvolutionarySearchNode::State::GenerateMeasure
   }
   TVM_PY_LOG(INFO, self->ctx_->logger) << "Sampled " << unmeasured.size() << " candidate(s)";
   inits.insert(inits.end(), measured.begin(), measured.end());
+  inits.insert(inits.end(), transferred.begin(), transferred.end());
   inits.insert(inits.end(), unmeasured.begin(), unmeasured.end());
   std::vector<Schedule> bests = EvolveWithCostModel(inits, sample_num);
   TVM_PY_LOG(INFO, self->ctx_->logger)
@@ -744,10 +1027,6 @@ void EvolutionarySearchNode::State::NotifyRunnerResults(
   ed += results.size();
 }
 
-size_t EvolutionarySearchNode::State::ModuleHash(const IRModule& mod) const {
-  return database_->GetModuleEquality().Hash(mod);
-}
-
 SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,         //
                                                   double init_measured_ratio,  //
                                                   int init_min_unmeasured,     //
@@ -755,14 +1034,17 @@ SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,         /
                                                   int genetic_num_iters,       //
                                                   double genetic_mutate_prob,  //
                                                   int genetic_max_fail_count,  //
-                                                  double eps_greedy) {
+                                                  double eps_greedy,           //
+                                                  double init_transferred_ratio) {
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(init_measured_ratio, "Initial measured ratio");
+  TVM_META_SCHEDULE_CHECK_PROB_RANGE(init_transferred_ratio, "Initial transferred ratio");
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(genetic_mutate_prob, "Mutation probability");
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(eps_greedy, "Greedy pick probability");
   ObjectPtr<EvolutionarySearchNode> n = make_object<EvolutionarySearchNode>();
   n->population_size = population_size;
   n->num_empty_iters_before_early_stop = 5;
   n->init_measured_ratio = init_measured_ratio;
+  n->init_transferred_ratio = init_transferred_ratio;
   n->init_min_unmeasured = init_min_unmeasured;
   n->max_fail_count = max_fail_count;
   n->genetic_num_iters = genetic_num_iters;
@@ -790,10 +1072,7 @@ Array<Schedule> EvolutionarySearchEvolveWithCostModel(EvolutionarySearch self,
       std::vector<Schedule>(population.begin(), population.end());
   std::vector<Schedule> schs = self->state_->EvolveWithCostModel(population_vec, num);
   for (Schedule sch : schs) {
-    IRModule mod = sch->mod();
-    size_t shash = self->state_->ModuleHash(mod);
-    if (!self->state_->measured_workloads_.Has(mod, shash)) {
-      self->state_->measured_workloads_.Add(mod, shash);
+    if (self->state_->measured_workloads_.Insert(sch)) {
       result.push_back(sch);
     }
   }
@@ -28,6 +28,9 @@ String GetRuleKindFromTarget(const Target& target) {
         runtime::Registry::Get("target.target_has_feature");
     ICHECK(target_has_feature_fn_ptr != nullptr)
         << "The `target.target_has_feature` func is not in tvm registry.";
+    if ((*target_has_feature_fn_ptr)("amx-int8", target)) {
+      return "amx";
+    }
     bool have_avx512vnni = (*target_has_feature_fn_ptr)("avx512vnni", target);
     bool have_avxvnni = (*target_has_feature_fn_ptr)("avxvnni", target);
     if (have_avx512vnni || have_avxvnni) {
@@ -43,6 +46,11 @@ String GetRuleKindFromTarget(const Target& target) {
     TargetJSON target_json = target::parsers::aprofile::ParseTarget(target->Export());
     TargetFeatures afeatures = Downcast<TargetFeatures>(target_json.at("features"));
 
+    // I8MM and BF16 are both mandatory from Armv8.6-A, the MMLA rules use them together
+    if (Downcast<Bool>(afeatures.at("has_matmul_i8")) && Downcast<Bool>(afeatures.at("has_bf16")) &&
+        Downcast<Bool>(afeatures.at("has_dotprod"))) {
+      return "i8mm";
+    }
     if (Downcast<Bool>(afeatures.at("has_dotprod"))) {
       return "dotprod";
     }
@@ -113,6 +121,10 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
       default_sch_rules = ScheduleRule::DefaultX86("vnni");
       default_postprocs = Postproc::DefaultCPUTensorization();
       default_mutator_probs = Mutator::DefaultLLVM();
+    } else if (kind == "amx") {
+      default_sch_rules = ScheduleRule::DefaultX86("amx");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else if (kind == "avx512") {
       default_sch_rules = ScheduleRule::DefaultX86("avx512");
       default_postprocs = Postproc::DefaultCPUTensorization();
@@ -129,6 +141,10 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
       default_sch_rules = ScheduleRule::DefaultARM("dotprod");
       default_postprocs = Postproc::DefaultCPUTensorization();
       default_mutator_probs = Mutator::DefaultLLVM();
+    } else if (kind == "i8mm") {
+      default_sch_rules = ScheduleRule::DefaultARM("i8mm");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else {
       LOG(FATAL) << "Unsupported kind: " << kind;
       throw;
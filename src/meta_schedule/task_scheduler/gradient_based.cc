@@ -26,6 +26,10 @@ class GradientBasedNode final : public TaskSchedulerNode {
  public:
   double alpha;
   int window_size;
+  /*! \brief The number of rounds without improvement to retire a task, or 0 to never retire. */
+  int early_stop_rounds;
+  /*! \brief The relative improvement of the best latency below which a round does not count. */
+  double early_stop_min_improvement;
   support::LinearCongruentialEngine::TRandState rand_state;
 
   int round_robin_rounds_;
@@ -35,6 +39,8 @@ class GradientBasedNode final : public TaskSchedulerNode {
     TaskSchedulerNode::VisitAttrs(v);
     v->Visit("alpha", &alpha);
     v->Visit("window_size", &window_size);
+    v->Visit("early_stop_rounds", &early_stop_rounds);
+    v->Visit("early_stop_min_improvement", &early_stop_min_improvement);
     // `rand_state` is not visited.
     // `num_rounds_already_` is not visited.
     // `best_latency_history_` is not visited.
@@ -74,13 +80,21 @@ class GradientBasedNode final : public TaskSchedulerNode {
       }
       ++round_robin_rounds_;
     }
-    // Step 2. Collect the tasks that are not terminated yet
+    // Step 2. Collect the tasks that are not terminated yet, and retire those converged, leaving
+    // their share of the global budget to the others
     std::vector<int> tasks_alive;
     {
       tasks_alive.reserve(n_tasks);
       for (int i = 0; i < n_tasks; ++i) {
         this->TouchTask(i);
-        if (!this->tasks_[i]->is_terminated) {
+        TaskRecordNode* task = this->tasks_[i].get();
+        if (!task->is_terminated && !task->runner_futures.defined() && IsConverged(i)) {
+          TVM_PY_LOG(INFO, this->logger)
+              << "Task #" << i << " has not improved in " << this->early_stop_rounds
+              << " round(s), retiring it early";
+          this->TerminateTask(i);
+        }
+        if (!task->is_terminated) {
           tasks_alive.push_back(i);
         }
       }
@@ -132,14 +146,44 @@ class GradientBasedNode final : public TaskSchedulerNode {
     }
     return results;
   }
+
+ private:
+  /*!
+   * \brief Check if the best latency of a task has not improved for `early_stop_rounds` rounds.
+   * \param task_id The task to be checked.
+   * \return Whether the task is converged.
+   */
+  bool IsConverged(int task_id) const {
+    if (this->early_stop_rounds <= 0) {
+      return false;
+    }
+    const std::vector<double>& best_latency = this->best_latency_history_.at(task_id);
+    int n = best_latency.size();
+    if (n <= this->early_stop_rounds) {
+      return false;
+    }
+    double best = best_latency[n - 1];
+    double prev = best_latency[n - 1 - this->early_stop_rounds];
+    if (best >= 1e9) {
+      // No valid measurement yet, keep trying
+      return false;
+    }
+    return prev - best <= this->early_stop_min_improvement * prev;
+  }
 };
 
 TaskScheduler TaskScheduler::GradientBased(PackedFunc logger, double alpha, int window_size,
-                                           support::LinearCongruentialEngine::TRandState seed) {
+                                           support::LinearCongruentialEngine::TRandState seed,
+                                           int early_stop_rounds,
+                                           double early_stop_min_improvement) {
+  CHECK_GE(early_stop_rounds, 0) << "ValueError: `early_stop_rounds` must be non-negative, but got "
+                                 << early_stop_rounds;
   ObjectPtr<GradientBasedNode> n = make_object<GradientBasedNode>();
   n->logger = logger;
   n->alpha = alpha;
   n->window_size = window_size;
+  n->early_stop_rounds = early_stop_rounds;
+  n->early_stop_min_improvement = early_stop_min_improvement;
   n->rand_state = support::LinearCongruentialEngine::NormalizeSeed(seed);
   return TaskScheduler(n);
 }
@@ -16,6 +16,13 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "../utils.h"
 
 namespace tvm {
@@ -38,23 +45,19 @@ TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   this->data_ = std::move(n);
 }
 
-void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
-  auto _ = Profiler::TimedScope("SendToBuilder");
-  Array<MeasureCandidate> candidates = self->measure_candidates.value();
-  Target target = self->ctx->target.value();
+Array<BuilderResult> BuildCandidates(const Array<MeasureCandidate>& candidates,
+                                     const Target& target, const Builder& builder) {
   Array<BuilderInput> inputs;
   inputs.reserve(candidates.size());
   for (const MeasureCandidate& candidate : candidates) {
     inputs.push_back(BuilderInput(candidate->sch->mod(), target));
   }
-  self->builder_results = builder->Build(inputs);
+  return builder->Build(inputs);
 }
 
-void SendToRunner(TaskRecordNode* self, const Runner& runner) {
-  auto _ = Profiler::TimedScope("SendToRunner");
-  Array<MeasureCandidate> candidates = self->measure_candidates.value();
-  Array<BuilderResult> builder_results = self->builder_results.value();
-  Target target = self->ctx->target.value();
+Array<RunnerFuture> RunCandidates(const Array<MeasureCandidate>& candidates,
+                                  const Array<BuilderResult>& builder_results,
+                                  const Target& target, const Runner& runner) {
   ICHECK_EQ(candidates.size(), builder_results.size());
   int n = candidates.size();
   int n_build_errors = 0;
@@ -73,8 +76,7 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
   }
   Array<RunnerFuture> futures = runner->Run(inputs);
   if (n_build_errors == 0) {
-    self->runner_futures = futures;
-    return;
+    return futures;
   }
   Array<RunnerFuture> results;
   results.reserve(n);
@@ -91,9 +93,203 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
       results.push_back(futures[j++]);
     }
   }
-  self->runner_futures = results;
+  return results;
+}
+
+void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
+  auto _ = Profiler::TimedScope("SendToBuilder");
+  self->builder_results =
+      BuildCandidates(self->measure_candidates.value(), self->ctx->target.value(), builder);
+}
+
+void SendToRunner(TaskRecordNode* self, const Runner& runner) {
+  auto _ = Profiler::TimedScope("SendToRunner");
+  self->runner_futures = RunCandidates(self->measure_candidates.value(),
+                                       self->builder_results.value(), self->ctx->target.value(),
+                                       runner);
 }
 
+/*!
+ * \brief Builds the measurement batches and sends them to the runner on a background thread, in
+ * the order they are submitted, so that the tuning loop generates the next batches meanwhile.
+ * \note Except for the background thread, the pipeline is only used by the tuning loop.
+ */
+class MeasurePipeline {
+ public:
+  explicit MeasurePipeline(Builder builder, Runner runner)
+      : builder_(std::move(builder)), runner_(std::move(runner)), worker_([this]() { Loop(); }) {}
+
+  ~MeasurePipeline() {
+    std::deque<std::shared_ptr<Batch>> cancelled;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+      cancelled.swap(queue_);
+    }
+    cv_.notify_all();
+    worker_.join();
+    for (const std::shared_ptr<Batch>& batch : cancelled) {
+      batch->Finish(std::make_exception_ptr(runtime::Error(
+          "RuntimeError: The measurement pipeline stopped before building the batch")));
+    }
+  }
+
+  /*!
+   * \brief Submit a batch of measure candidates
+   * \param task_id The task the candidates belong to, which has no other batch in flight
+   * \param candidates The measure candidates
+   * \param target The target to build for
+   * \return The futures of the runner results, available once the batch is built and run
+   */
+  Array<RunnerFuture> Submit(int task_id, const Array<MeasureCandidate>& candidates,
+                             const Target& target) {
+    ICHECK(FindBatch(task_id) == inflight_.end());
+    auto batch = std::make_shared<Batch>();
+    batch->task_id = task_id;
+    batch->candidates = candidates;
+    batch->target = target;
+    inflight_.push_back(batch);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(batch);
+    }
+    cv_.notify_one();
+    Array<RunnerFuture> futures;
+    futures.reserve(candidates.size());
+    for (int i = 0, n = candidates.size(); i < n; ++i) {
+      futures.push_back(RunnerFuture(
+          /*f_done=*/
+          [batch, i]() -> bool {
+            return batch->Ready() && (batch->error != nullptr || batch->runner_futures[i]->Done());
+          },
+          /*f_result=*/
+          [batch, i]() -> RunnerResult {
+            batch->Wait();
+            return batch->runner_futures[i]->Result();
+          }));
+    }
+    return futures;
+  }
+
+  /*! \brief Whether a task has a batch in flight */
+  bool HasBatch(int task_id) const { return FindBatch(task_id) != inflight_.end(); }
+
+  /*!
+   * \brief Take the batch of a task out of the pipeline, waiting until it is built
+   * \param task_id The task
+   * \return The building results of the batch
+   */
+  Array<BuilderResult> Take(int task_id) {
+    auto it = FindBatch(task_id);
+    ICHECK(it != inflight_.end());
+    std::shared_ptr<Batch> batch = *it;
+    inflight_.erase(it);
+    batch->Wait();
+    return batch->builder_results;
+  }
+
+  /*! \brief The number of batches in flight */
+  int NumInflight() const { return inflight_.size(); }
+
+  /*! \brief The task of the oldest batch in flight */
+  int OldestTaskId() const {
+    ICHECK(!inflight_.empty());
+    return inflight_.front()->task_id;
+  }
+
+ private:
+  /*! \brief A batch of measure candidates in flight */
+  struct Batch {
+    /*! \brief The task the candidates belong to */
+    int task_id;
+    /*! \brief The measure candidates */
+    Array<MeasureCandidate> candidates;
+    /*! \brief The target to build for */
+    Target target;
+    /*! \brief The building results, written by the background thread before `ready` */
+    Array<BuilderResult> builder_results;
+    /*! \brief The runner futures, written by the background thread before `ready` */
+    Array<RunnerFuture> runner_futures;
+    /*! \brief The error in building or running, written by the background thread before `ready` */
+    std::exception_ptr error = nullptr;
+
+    bool Ready() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return ready;
+    }
+
+    void Wait() {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [this]() { return ready; });
+      if (error != nullptr) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    void Finish(std::exception_ptr err) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = err;
+        ready = true;
+      }
+      cv.notify_all();
+    }
+
+   private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool ready = false;
+  };
+
+  std::deque<std::shared_ptr<Batch>>::const_iterator FindBatch(int task_id) const {
+    return std::find_if(inflight_.begin(), inflight_.end(),
+                        [task_id](const std::shared_ptr<Batch>& batch) {
+                          return batch->task_id == task_id;
+                        });
+  }
+
+  void Loop() {
+    while (true) {
+      std::shared_ptr<Batch> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (stop_) {
+          return;
+        }
+        batch = queue_.front();
+        queue_.pop_front();
+      }
+      std::exception_ptr error = nullptr;
+      try {
+        batch->builder_results = BuildCandidates(batch->candidates, batch->target, builder_);
+        batch->runner_futures =
+            RunCandidates(batch->candidates, batch->builder_results, batch->target, runner_);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      batch->Finish(error);
+    }
+  }
+
+  /*! \brief The builder */
+  Builder builder_;
+  /*! \brief The runner */
+  Runner runner_;
+  /*! \brief The batches in flight from the oldest to the newest, used by the tuning loop only */
+  std::deque<std::shared_ptr<Batch>> inflight_;
+  /*! \brief The mutex guarding the fields below */
+  std::mutex mutex_;
+  /*! \brief Signals new batches or stopping to the background thread */
+  std::condition_variable cv_;
+  /*! \brief The batches to be built */
+  std::deque<std::shared_ptr<Batch>> queue_;
+  /*! \brief Whether the background thread should stop */
+  bool stop_ = false;
+  /*! \brief The background thread, started after all the fields above */
+  std::thread worker_;
+};
+
 void TaskCleanUp(TaskRecordNode* self, int task_id, const Array<RunnerResult>& results) {
   ICHECK_EQ(self->builder_results.value().size(), results.size());
   ICHECK_EQ(self->runner_futures.value().size(), results.size());
@@ -147,6 +343,9 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
                              Optional<CostModel> cost_model) {
   CHECK_EQ(ctxs.size(), task_weights.size()) << "ValueError: `task_weights` must have the same "
                                                 "length as `ctxs`";
+  CHECK_GE(this->max_inflight_batches, 1)
+      << "ValueError: `max_inflight_batches` must be positive, but got "
+      << this->max_inflight_batches;
   int n_tasks = this->remaining_tasks_ = ctxs.size();
   this->measure_callbacks_ = measure_callbacks;
   this->database_ = database;
@@ -174,6 +373,10 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
     ctx->search_strategy.value()->PreTuning(max_trials_per_task, num_trials_per_iter, design_spaces,
                                             database, cost_model);
   }
+  this->pipeline_ = nullptr;
+  if (this->max_inflight_batches > 1) {
+    this->pipeline_ = std::make_shared<MeasurePipeline>(builder, runner);
+  }
 
   int num_trials_already = 0;
   for (int task_id; num_trials_already < max_trials_global && (task_id = NextTaskId()) != -1;) {
@@ -190,10 +393,21 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
             task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
       int num_candidates = candidates.value().size();
       num_trials_already += num_candidates;
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
-      SendToBuilder(task, builder);
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
-      SendToRunner(task, runner);
+      if (this->pipeline_ != nullptr) {
+        // Bound the number of batches whose results the database and the cost model have not seen
+        while (this->pipeline_->NumInflight() >= this->max_inflight_batches) {
+          JoinRunningTask(this->pipeline_->OldestTaskId());
+        }
+        TVM_PY_LOG(INFO, this->logger)
+            << "Sending " << num_candidates << " sample(s) to the measurement pipeline";
+        task->runner_futures =
+            this->pipeline_->Submit(task_id, candidates.value(), task->ctx->target.value());
+      } else {
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
+        SendToBuilder(task, builder);
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
+        SendToRunner(task, runner);
+      }
     } else {
       TerminateTask(task_id);
     }
@@ -208,11 +422,15 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
     }
     task->ctx->search_strategy.value()->PostTuning();
   }
+  this->pipeline_ = nullptr;
 }
 
 Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
   TaskRecordNode* task = this->tasks_[task_id].get();
   ICHECK(task->runner_futures.defined());
+  if (this->pipeline_ != nullptr && this->pipeline_->HasBatch(task_id)) {
+    task->builder_results = this->pipeline_->Take(task_id);
+  }
   Array<RunnerResult> results;
   {
     auto _ = Profiler::TimedScope("JoinRunnerFutures");
@@ -378,6 +596,13 @@ TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerTouchTask")
     .set_body_method<TaskScheduler>(&TaskSchedulerNode::TouchTask);
 TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerPrintTuningStatistics")
     .set_body_method<TaskScheduler>(&TaskSchedulerNode::PrintTuningStatistics);
+TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerSetMaxInflightBatches")
+    .set_body_typed([](TaskScheduler self, int max_inflight_batches) -> void {
+      CHECK_GE(max_inflight_batches, 1)
+          << "ValueError: `max_inflight_batches` must be positive, but got "
+          << max_inflight_batches;
+      self->max_inflight_batches = max_inflight_batches;
+    });
 
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -21,6 +21,9 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -254,8 +257,126 @@ void ScheduleUsingAnchorTrace(Schedule sch, const Trace& anchor_trace, const tvm
   }
 }
 
+// Collect the blocks of the PrimFuncs in a module, in the order of the function names
+std::vector<const BlockNode*> CollectWorkloadBlocks(const IRModule& mod) {
+  std::vector<std::pair<std::string, PrimFunc>> funcs;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<PrimFuncNode>()) {
+      funcs.emplace_back(kv.first->name_hint, GetRef<PrimFunc>(func));
+    }
+  }
+  std::sort(funcs.begin(), funcs.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  std::vector<const BlockNode*> blocks;
+  for (const auto& kv : funcs) {
+    PreOrderVisit(kv.second->body, [&blocks](const ObjectRef& obj) -> bool {
+      if (const auto* block = obj.as<BlockNode>()) {
+        blocks.push_back(block);
+      }
+      return !obj->IsInstance<PrimExprNode>();
+    });
+  }
+  return blocks;
+}
+
+size_t WorkloadStructuralKey(const IRModule& mod) {
+  uint64_t key = 0;
+  auto f_hash_buffer = [&key](const Buffer& buffer) {
+    key = support::HashCombine(key, static_cast<int>(buffer->dtype.code()));
+    key = support::HashCombine(key, buffer->dtype.bits());
+    key = support::HashCombine(key, buffer->dtype.lanes());
+    key = support::HashCombine(key, buffer->shape.size());
+  };
+  for (const BlockNode* block : CollectWorkloadBlocks(mod)) {
+    key = support::HashCombine(key, std::hash<std::string>()(block->name_hint));
+    for (const IterVar& iter : block->iter_vars) {
+      key = support::HashCombine(key, static_cast<int>(iter->iter_type));
+    }
+    for (const BufferRegion& region : block->reads) {
+      f_hash_buffer(region->buffer);
+    }
+    for (const BufferRegion& region : block->writes) {
+      f_hash_buffer(region->buffer);
+    }
+    // The kinds of the nodes in the body tell the computation apart, while the values of the
+    // constants, which carry the shapes, are left out
+    PostOrderVisit(block->body, [&key](const ObjectRef& obj) {
+      key = support::HashCombine(key, obj->type_index());
+    });
+  }
+  return key;
+}
+
+double WorkloadShapeDistance(const IRModule& a, const IRModule& b) {
+  std::vector<const BlockNode*> a_blocks = CollectWorkloadBlocks(a);
+  std::vector<const BlockNode*> b_blocks = CollectWorkloadBlocks(b);
+  if (a_blocks.size() != b_blocks.size()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  auto f_log_extent = [](const IterVar& iter) -> double {
+    const int64_t* extent = as_const_int(iter->dom->extent);
+    return extent != nullptr && *extent > 1 ? std::log(static_cast<double>(*extent)) : 0.0;
+  };
+  double distance = 0.0;
+  for (size_t i = 0; i < a_blocks.size(); ++i) {
+    const Array<IterVar>& a_iters = a_blocks[i]->iter_vars;
+    const Array<IterVar>& b_iters = b_blocks[i]->iter_vars;
+    if (a_iters.size() != b_iters.size()) {
+      return std::numeric_limits<double>::infinity();
+    }
+    for (size_t j = 0; j < a_iters.size(); ++j) {
+      distance += std::abs(f_log_extent(a_iters[j]) - f_log_extent(b_iters[j]));
+    }
+  }
+  return distance;
+}
+
+// Refit the tile sizes to a new loop extent from the innermost tile outwards, taking for each
+// inner tile the largest divisor of the remaining extent that does not exceed the old factor
+Array<Integer> RefitPerfectTile(const Array<Integer>& factors, int64_t extent,
+                                int64_t max_innermost_factor) {
+  int n = factors.size();
+  std::vector<int64_t> result(n, 1);
+  int64_t len = extent;
+  for (int i = n - 1; i > 0; --i) {
+    int64_t factor = std::max<int64_t>(factors[i]->value, 1);
+    if (i == n - 1 && max_innermost_factor != -1) {
+      factor = std::min(factor, max_innermost_factor);
+    }
+    factor = std::min(factor, len);
+    while (len % factor != 0) {
+      --factor;
+    }
+    result[i] = factor;
+    len /= factor;
+  }
+  result[0] = len;
+  return support::AsArray<int64_t, Integer>(result);
+}
+
+void ApplyTraceAcrossShapes(Schedule sch, const Trace& trace) {
+  static const InstructionKind& kind_sample_perfect_tile =
+      InstructionKind::Get("SamplePerfectTile");
+  trace->ApplyToSchedule(
+      sch, /*remove_postproc=*/true,
+      [&sch](const Instruction& inst, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs,
+             const Optional<ObjectRef>& decision) -> ObjectRef {
+        if (!inst->kind.same_as(kind_sample_perfect_tile) || !decision.defined()) {
+          return decision;
+        }
+        const int64_t* extent = as_const_int(sch->Get(Downcast<LoopRV>(inputs[0]))->extent);
+        if (extent == nullptr) {
+          return decision;
+        }
+        Array<Integer> factors = Downcast<Array<Integer>>(decision.value());
+        int64_t max_innermost_factor = Downcast<Integer>(attrs[1])->value;
+        return RefitPerfectTile(factors, *extent, max_innermost_factor);
+      });
+}
+
 TVM_REGISTER_GLOBAL("meta_schedule.ScheduleUsingAnchorTrace")
     .set_body_typed(ScheduleUsingAnchorTrace);
+TVM_REGISTER_GLOBAL("meta_schedule.ApplyTraceAcrossShapes").set_body_typed(ApplyTraceAcrossShapes);
 
 }  // namespace meta_schedule
 }  // namespace tvm
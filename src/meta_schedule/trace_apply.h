@@ -42,6 +42,34 @@ namespace meta_schedule {
 void ScheduleUsingAnchorTrace(tir::Schedule sch, const tir::Trace& anchor_trace,
                               const tvm::Target& target);
 
+/*!
+ * \brief Compute a key of a TIR module that ignores its shapes. Workloads of the same operator
+ * that differ only in shapes, e.g. matmuls of different sizes, share the key, so that the traces
+ * tuned on one of them can be transferred to the others via ApplyTraceAcrossShapes.
+ * \param mod The TIR module.
+ * \return The shape-agnostic structural key.
+ */
+size_t WorkloadStructuralKey(const IRModule& mod);
+
+/*!
+ * \brief Measure how far apart the shapes of two workloads sharing the structural key are, as the
+ * sum of the absolute log-ratios of their block iteration extents.
+ * \param a The first TIR module.
+ * \param b The second TIR module.
+ * \return The distance, or infinity if the blocks of the two modules do not match.
+ */
+double WorkloadShapeDistance(const IRModule& a, const IRModule& b);
+
+/*!
+ * \brief Apply a trace tuned on a workload of the same structure but of different shapes. The
+ * sampled tile sizes that no longer divide the loop extents are refitted, keeping every inner
+ * factor as large as possible without exceeding its original value.
+ * \param sch The schedule to apply the trace.
+ * \param trace The trace tuned on the other workload.
+ * \note An error is thrown if the trace cannot be applied to the schedule.
+ */
+void ApplyTraceAcrossShapes(tir::Schedule sch, const tir::Trace& trace);
+
 }  // namespace meta_schedule
 }  // namespace tvm
 
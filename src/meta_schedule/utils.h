@@ -43,6 +43,7 @@
 #include <tvm/tir/transform.h>
 
 #include <algorithm>
+#include <functional>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -324,13 +325,36 @@ struct ThreadedTraceApply {
    */
   Optional<tir::Schedule> Apply(const IRModule& mod, const tir::Trace& trace,
                                 TRandState* rand_state) {
+    return Apply(mod, rand_state, [&trace](const tir::Schedule& sch) {
+      trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+    });
+  }
+
+  /*!
+   * \brief Replay a trace in a customized way, then apply the postprocessors to an IRModule
+   * \param mod The IRModule to be applied
+   * \param rand_state The random seed
+   * \param f_replay The function replaying the trace onto the schedule
+   * \return The schedule created, or NullOpt if any postprocessor fails
+   */
+  Optional<tir::Schedule> Apply(const IRModule& mod, TRandState* rand_state,
+                                const std::function<void(const tir::Schedule&)>& f_replay) {
     tir::Schedule sch =
         tir::Schedule::Traced(mod,
                               /*rand_state=*/ForkSeed(rand_state),
                               /*debug_mode=*/0,
                               /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
 
-    trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+    f_replay(sch);
+    return ApplyPostprocs(sch);
+  }
+
+  /*!
+   * \brief Apply the postprocessors to a schedule where the trace has been replayed
+   * \param sch The schedule
+   * \return The schedule, or NullOpt if any postprocessor fails
+   */
+  Optional<tir::Schedule> ApplyPostprocs(const tir::Schedule& sch) {
     sch->EnterPostproc();
 
     for (int i = 0; i < n_; ++i) {
@@ -28,11 +28,14 @@
 #include <tvm/node/serialization.h>
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <map>
 #include <string>
 
@@ -434,40 +437,83 @@ class JSONAttrSetter : public AttrVisitor {
     if (jnode->repr_bytes.length() > 0 || reflection_->GetReprBytes(node->get(), nullptr)) {
       return;
     }
+    if (SetContainer(node, *jnode, *node_list_)) return;
+    jnode_ = jnode;
+    reflection_->VisitAttrs(node->get(), this);
+  }
+
+  // Rebuild an Array or Map from the node indices, returns false for other nodes.
+  static bool SetContainer(ObjectPtr<Object>* node, const JSONNode& jnode,
+                           const std::vector<ObjectPtr<Object>>& node_list) {
     // handling Array
-    if (jnode->type_key == ArrayNode::_type_key) {
+    if (jnode.type_key == ArrayNode::_type_key) {
       std::vector<ObjectRef> container;
-      for (auto index : jnode->data) {
-        container.push_back(ObjectRef(node_list_->at(index)));
+      for (auto index : jnode.data) {
+        container.push_back(ObjectRef(node_list.at(index)));
       }
       Array<ObjectRef> array(container);
       *node = runtime::ObjectInternal::MoveObjectPtr(&array);
-      return;
+      return true;
     }
     // handling Map
-    if (jnode->type_key == MapNode::_type_key) {
+    if (jnode.type_key == MapNode::_type_key) {
       std::unordered_map<ObjectRef, ObjectRef, ObjectHash, ObjectEqual> container;
-      if (jnode->keys.empty()) {
-        ICHECK_EQ(jnode->data.size() % 2, 0U);
-        for (size_t i = 0; i < jnode->data.size(); i += 2) {
-          container[ObjectRef(node_list_->at(jnode->data[i]))] =
-              ObjectRef(node_list_->at(jnode->data[i + 1]));
+      if (jnode.keys.empty()) {
+        ICHECK_EQ(jnode.data.size() % 2, 0U);
+        for (size_t i = 0; i < jnode.data.size(); i += 2) {
+          container[ObjectRef(node_list.at(jnode.data[i]))] =
+              ObjectRef(node_list.at(jnode.data[i + 1]));
         }
       } else {
-        ICHECK_EQ(jnode->data.size(), jnode->keys.size());
-        for (size_t i = 0; i < jnode->data.size(); ++i) {
-          container[String(jnode->keys[i])] = ObjectRef(node_list_->at(jnode->data[i]));
+        ICHECK_EQ(jnode.data.size(), jnode.keys.size());
+        for (size_t i = 0; i < jnode.data.size(); ++i) {
+          container[String(jnode.keys[i])] = ObjectRef(node_list.at(jnode.data[i]));
         }
       }
       Map<ObjectRef, ObjectRef> map(container);
       *node = runtime::ObjectInternal::MoveObjectPtr(&map);
-      return;
+      return true;
     }
-    jnode_ = jnode;
-    reflection_->VisitAttrs(node->get(), this);
+    return false;
   }
 };
 
+// Topological order of the nodes, children first.
+std::vector<size_t> TopoSortNodes(const std::vector<JSONNode>& nodes) {
+  size_t n_nodes = nodes.size();
+  std::vector<size_t> topo_order;
+  std::vector<size_t> in_degree(n_nodes, 0);
+  for (const JSONNode& jnode : nodes) {
+    for (size_t i : jnode.data) {
+      ++in_degree[i];
+    }
+    for (size_t i : jnode.fields) {
+      ++in_degree[i];
+    }
+  }
+  for (size_t i = 0; i < n_nodes; ++i) {
+    if (in_degree[i] == 0) {
+      topo_order.push_back(i);
+    }
+  }
+  for (size_t p = 0; p < topo_order.size(); ++p) {
+    const JSONNode& jnode = nodes[topo_order[p]];
+    for (size_t i : jnode.data) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+    for (size_t i : jnode.fields) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+  }
+  ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in JSON file";
+  std::reverse(std::begin(topo_order), std::end(topo_order));
+  return topo_order;
+}
+
 // json graph structure to store node
 struct JSONGraph {
   // the root of the graph
@@ -527,40 +573,7 @@ struct JSONGraph {
     return g;
   }
 
-  std::vector<size_t> TopoSort() const {
-    size_t n_nodes = nodes.size();
-    std::vector<size_t> topo_order;
-    std::vector<size_t> in_degree(n_nodes, 0);
-    for (const JSONNode& jnode : nodes) {
-      for (size_t i : jnode.data) {
-        ++in_degree[i];
-      }
-      for (size_t i : jnode.fields) {
-        ++in_degree[i];
-      }
-    }
-    for (size_t i = 0; i < n_nodes; ++i) {
-      if (in_degree[i] == 0) {
-        topo_order.push_back(i);
-      }
-    }
-    for (size_t p = 0; p < topo_order.size(); ++p) {
-      const JSONNode& jnode = nodes[topo_order[p]];
-      for (size_t i : jnode.data) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-      for (size_t i : jnode.fields) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-    }
-    ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in JSON file";
-    std::reverse(std::begin(topo_order), std::end(topo_order));
-    return topo_order;
-  }
+  std::vector<size_t> TopoSort() const { return TopoSortNodes(nodes); }
 };
 
 std::string SaveJSON(const ObjectRef& n) {
@@ -622,7 +635,510 @@ ObjectRef LoadJSON(std::string json_str) {
   return ObjectRef(nodes.at(jgraph.root));
 }
 
+/*!
+ * \brief Binary graph format.
+ *
+ *  The graph has the same nodes as the JSON graph, but the values are stored in binary and
+ *  the field names once per schema. Each node refers to a schema giving its type key and the
+ *  names and kinds of its fields, in visiting order. NDArray data is stored inline, aligned to
+ *  kAllocAlignment from the beginning of the blob, so a blob mapped in memory can be read
+ *  in place.
+ *
+ *  All values are stored in native byte order, and loading on a machine with a different
+ *  byte order is rejected.
+ */
+namespace binary_graph {
+
+constexpr uint64_t kMagic = 0x5450524756544254;  // "TBTVGRPT"
+constexpr uint64_t kVersion = 1;
+
+/*! \brief How a node is stored. */
+enum NodeKind : uint8_t {
+  kNodeObject = 0,
+  kNodeRepr = 1,
+  kNodeArray = 2,
+  kNodeStrMap = 3,
+  kNodeMap = 4,
+};
+
+/*! \brief The kind of a field value, all but strings are stored in 8 bytes. */
+enum FieldKind : uint8_t {
+  kDouble = 0,
+  kInt64 = 1,
+  kUInt64 = 2,
+  kInt = 3,
+  kBool = 4,
+  kString = 5,
+  kDataType = 6,
+  kNDArray = 7,
+  kObjectRef = 8,
+};
+
+/*! \brief Type key and field layout shared by nodes. */
+struct Schema {
+  std::string type_key;
+  NodeKind node_kind;
+  std::vector<std::string> keys;
+  std::vector<FieldKind> kinds;
+};
+
+/*! \brief Append-only writer. */
+class Writer {
+ public:
+  explicit Writer(std::string* buf) : buf_(buf) {}
+  void Write(const void* data, size_t size) {
+    buf_->append(static_cast<const char*>(data), size);
+  }
+  template <typename T>
+  void WritePOD(T value) {
+    Write(&value, sizeof(T));
+  }
+  void WriteString(const std::string& value) {
+    WritePOD<uint64_t>(value.size());
+    Write(value.data(), value.size());
+  }
+  // pad with zeros to an offset multiple of alignment
+  void Align(size_t alignment) {
+    buf_->resize((buf_->size() + alignment - 1) / alignment * alignment);
+  }
+
+ private:
+  std::string* buf_;
+};
+
+/*! \brief Bounds checked reader. */
+class Reader {
+ public:
+  Reader(const char* data, size_t size) : data_(data), size_(size) {}
+  const char* Read(size_t size) {
+    ICHECK_LE(size, size_ - pos_) << "Binary graph is truncated";
+    const char* ptr = data_ + pos_;
+    pos_ += size;
+    return ptr;
+  }
+  template <typename T>
+  T ReadPOD() {
+    T value;
+    std::memcpy(&value, Read(sizeof(T)), sizeof(T));
+    return value;
+  }
+  std::string ReadString() {
+    uint64_t size = ReadPOD<uint64_t>();
+    return std::string(Read(size), size);
+  }
+  void Align(size_t alignment) {
+    size_t pos = (pos_ + alignment - 1) / alignment * alignment;
+    ICHECK_LE(pos, size_) << "Binary graph is truncated";
+    pos_ = pos;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t pos_{0};
+};
+
+inline uint64_t PackDataType(DataType dtype) {
+  DLDataType t = dtype;
+  return static_cast<uint64_t>(t.code) | (static_cast<uint64_t>(t.bits) << 8) |
+         (static_cast<uint64_t>(t.lanes) << 16);
+}
+
+inline DataType UnpackDataType(uint64_t value) {
+  DLDataType t;
+  t.code = static_cast<uint8_t>(value & 0xFF);
+  t.bits = static_cast<uint8_t>((value >> 8) & 0xFF);
+  t.lanes = static_cast<uint16_t>((value >> 16) & 0xFFFF);
+  return DataType(t);
+}
+
+template <typename T>
+inline uint64_t ToBits(T value) {
+  uint64_t bits = 0;
+  static_assert(sizeof(T) <= sizeof(uint64_t));
+  std::memcpy(&bits, &value, sizeof(T));
+  return bits;
+}
+
+template <typename T>
+inline T FromBits(uint64_t bits) {
+  T value;
+  std::memcpy(&value, &bits, sizeof(T));
+  return value;
+}
+
+// Collects the fields of a node along with their values.
+class AttrGetter : public AttrVisitor {
+ public:
+  const std::unordered_map<Object*, size_t>* node_index_;
+  const std::unordered_map<DLTensor*, size_t>* tensor_index_;
+  Schema* schema_;
+  Writer* writer_;
+
+  void Visit(const char* key, double* value) final { Put(key, kDouble, ToBits(*value)); }
+  void Visit(const char* key, int64_t* value) final { Put(key, kInt64, ToBits(*value)); }
+  void Visit(const char* key, uint64_t* value) final { Put(key, kUInt64, *value); }
+  void Visit(const char* key, int* value) final {
+    Put(key, kInt, ToBits(static_cast<int64_t>(*value)));
+  }
+  void Visit(const char* key, bool* value) final { Put(key, kBool, *value ? 1 : 0); }
+  void Visit(const char* key, std::string* value) final {
+    schema_->keys.push_back(key);
+    schema_->kinds.push_back(kString);
+    writer_->WriteString(*value);
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    Put(key, kDataType, PackDataType(*value));
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    Put(key, kNDArray, tensor_index_->at(const_cast<DLTensor*>((*value).operator->())));
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    Put(key, kObjectRef, node_index_->at(const_cast<Object*>(value->get())));
+  }
+
+ private:
+  void Put(const char* key, FieldKind kind, uint64_t value) {
+    schema_->keys.push_back(key);
+    schema_->kinds.push_back(kind);
+    writer_->WritePOD<uint64_t>(value);
+  }
+};
+
+// Sets the fields of a node from the decoded values.
+class AttrSetter : public AttrVisitor {
+ public:
+  const std::vector<ObjectPtr<Object>>* node_list_;
+  const std::vector<runtime::NDArray>* tensor_list_;
+  const Schema* schema_;
+  const std::vector<uint64_t>* values_;
+  const std::vector<std::string>* strings_;
+
+  void Visit(const char* key, double* value) final { *value = FromBits<double>(Get(key, kDouble)); }
+  void Visit(const char* key, int64_t* value) final {
+    *value = FromBits<int64_t>(Get(key, kInt64));
+  }
+  void Visit(const char* key, uint64_t* value) final { *value = Get(key, kUInt64); }
+  void Visit(const char* key, int* value) final {
+    *value = static_cast<int>(FromBits<int64_t>(Get(key, kInt)));
+  }
+  void Visit(const char* key, bool* value) final { *value = Get(key, kBool) != 0; }
+  void Visit(const char* key, std::string* value) final {
+    *value = strings_->at(Get(key, kString));
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to deserialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    *value = UnpackDataType(Get(key, kDataType));
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    *value = tensor_list_->at(Get(key, kNDArray));
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    *value = ObjectRef(node_list_->at(Get(key, kObjectRef)));
+  }
+  void Set(Object* node) {
+    next_field_ = 0;
+    ReflectionVTable::Global()->VisitAttrs(node, this);
+  }
+
+ private:
+  uint64_t Get(const char* key, FieldKind kind) {
+    size_t index = next_field_;
+    // the fields are usually visited in the saved order
+    if (index >= schema_->keys.size() || schema_->keys[index] != key) {
+      auto it = std::find(schema_->keys.begin(), schema_->keys.end(), key);
+      if (it == schema_->keys.end()) {
+        LOG(FATAL) << "BinaryGraphReader: cannot find field " << key << " of "
+                   << schema_->type_key;
+      }
+      index = it - schema_->keys.begin();
+    }
+    ICHECK_EQ(schema_->kinds[index], kind)
+        << "BinaryGraphReader: field " << key << " of " << schema_->type_key
+        << " was saved with a different type";
+    next_field_ = index + 1;
+    return (*values_)[index];
+  }
+
+  size_t next_field_{0};
+};
+
+void SaveTensor(Writer* writer, DLTensor* tensor) {
+  runtime::NDArray cpu_copy;
+  if (tensor->device.device_type != kDLCPU || !runtime::IsContiguous(*tensor)) {
+    std::vector<int64_t> shape(tensor->shape, tensor->shape + tensor->ndim);
+    cpu_copy = runtime::NDArray::Empty(shape, tensor->dtype, {kDLCPU, 0});
+    cpu_copy.CopyFrom(tensor);
+    tensor = const_cast<DLTensor*>(cpu_copy.operator->());
+  }
+  writer->WritePOD<int32_t>(tensor->ndim);
+  writer->WritePOD<uint64_t>(PackDataType(DataType(tensor->dtype)));
+  for (int i = 0; i < tensor->ndim; ++i) {
+    writer->WritePOD<int64_t>(tensor->shape[i]);
+  }
+  uint64_t nbytes = runtime::GetDataSize(*tensor);
+  writer->WritePOD<uint64_t>(nbytes);
+  writer->Align(runtime::kAllocAlignment);
+  writer->Write(static_cast<const char*>(tensor->data) + tensor->byte_offset, nbytes);
+}
+
+runtime::NDArray LoadTensor(Reader* reader) {
+  int32_t ndim = reader->ReadPOD<int32_t>();
+  DataType dtype = UnpackDataType(reader->ReadPOD<uint64_t>());
+  std::vector<int64_t> shape(ndim);
+  for (int32_t i = 0; i < ndim; ++i) {
+    shape[i] = reader->ReadPOD<int64_t>();
+  }
+  uint64_t nbytes = reader->ReadPOD<uint64_t>();
+  reader->Align(runtime::kAllocAlignment);
+  runtime::NDArray tensor = runtime::NDArray::Empty(shape, dtype, {kDLCPU, 0});
+  ICHECK_EQ(nbytes, runtime::GetDataSize(*tensor.operator->()))
+      << "BinaryGraphReader: tensor size mismatch";
+  std::memcpy(tensor->data, reader->Read(nbytes), nbytes);
+  return tensor;
+}
+
+std::string Save(const ObjectRef& root) {
+  NodeIndexer indexer;
+  indexer.MakeIndex(const_cast<Object*>(root.get()));
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+
+  // nodes are written first to collect the schemas they use
+  std::vector<Schema> schemas;
+  std::unordered_map<std::string, uint32_t> schema_index;
+  std::string node_blob;
+  Writer node_writer(&node_blob);
+  AttrGetter getter;
+  getter.node_index_ = &indexer.node_index_;
+  getter.tensor_index_ = &indexer.tensor_index_;
+  std::string field_blob;
+  Writer field_writer(&field_blob);
+  getter.writer_ = &field_writer;
+
+  for (Object* node : indexer.node_list_) {
+    if (node == nullptr) {
+      node_writer.WritePOD<uint32_t>(0);
+      continue;
+    }
+    Schema schema;
+    schema.type_key = node->GetTypeKey();
+    std::string repr_bytes;
+    field_blob.clear();
+    if (reflection->GetReprBytes(node, &repr_bytes)) {
+      schema.node_kind = kNodeRepr;
+      field_writer.WriteString(repr_bytes);
+    } else if (node->IsInstance<ArrayNode>()) {
+      schema.node_kind = kNodeArray;
+      ArrayNode* n = static_cast<ArrayNode*>(node);
+      field_writer.WritePOD<uint64_t>(n->size());
+      for (const ObjectRef& elem : *n) {
+        field_writer.WritePOD<uint64_t>(indexer.node_index_.at(const_cast<Object*>(elem.get())));
+      }
+    } else if (node->IsInstance<MapNode>()) {
+      MapNode* n = static_cast<MapNode*>(node);
+      bool is_str_map = std::all_of(n->begin(), n->end(), [](const auto& v) {
+        return v.first->template IsInstance<StringObj>();
+      });
+      schema.node_kind = is_str_map ? kNodeStrMap : kNodeMap;
+      field_writer.WritePOD<uint64_t>(n->size());
+      for (const auto& kv : *n) {
+        if (is_str_map) {
+          field_writer.WriteString(Downcast<String>(kv.first));
+        } else {
+          field_writer.WritePOD<uint64_t>(
+              indexer.node_index_.at(const_cast<Object*>(kv.first.get())));
+        }
+        field_writer.WritePOD<uint64_t>(
+            indexer.node_index_.at(const_cast<Object*>(kv.second.get())));
+      }
+    } else {
+      schema.node_kind = kNodeObject;
+      getter.schema_ = &schema;
+      reflection->VisitAttrs(node, &getter);
+    }
+    // dedup schemas by type key, node kind and fields
+    std::string signature = schema.type_key;
+    signature.push_back(static_cast<char>(schema.node_kind));
+    for (size_t i = 0; i < schema.keys.size(); ++i) {
+      signature.push_back('\0');
+      signature += schema.keys[i];
+      signature.push_back(static_cast<char>(schema.kinds[i]));
+    }
+    auto it = schema_index.find(signature);
+    if (it == schema_index.end()) {
+      it = schema_index.emplace(signature, static_cast<uint32_t>(schemas.size())).first;
+      schemas.emplace_back(std::move(schema));
+    }
+    // schema ids are offset by one, zero is the null node
+    node_writer.WritePOD<uint32_t>(it->second + 1);
+    node_writer.Write(field_blob.data(), field_blob.size());
+  }
+
+  std::string blob;
+  Writer writer(&blob);
+  writer.WritePOD<uint64_t>(kMagic);
+  writer.WritePOD<uint64_t>(kVersion);
+  writer.WriteString(TVM_VERSION);
+  writer.WritePOD<uint64_t>(schemas.size());
+  for (const Schema& schema : schemas) {
+    writer.WriteString(schema.type_key);
+    writer.WritePOD<uint8_t>(schema.node_kind);
+    writer.WritePOD<uint64_t>(schema.keys.size());
+    for (size_t i = 0; i < schema.keys.size(); ++i) {
+      writer.WriteString(schema.keys[i]);
+      writer.WritePOD<uint8_t>(schema.kinds[i]);
+    }
+  }
+  writer.WritePOD<uint64_t>(indexer.node_list_.size());
+  writer.Write(node_blob.data(), node_blob.size());
+  writer.WritePOD<uint64_t>(indexer.node_index_.at(const_cast<Object*>(root.get())));
+  writer.WritePOD<uint64_t>(indexer.tensor_list_.size());
+  for (DLTensor* tensor : indexer.tensor_list_) {
+    SaveTensor(&writer, tensor);
+  }
+  return blob;
+}
+
+ObjectRef Load(const char* data, size_t size) {
+  Reader reader(data, size);
+  uint64_t magic = reader.ReadPOD<uint64_t>();
+  if (magic != kMagic) {
+    uint64_t swapped = 0;
+    for (int i = 0; i < 8; ++i) {
+      swapped = (swapped << 8) | ((magic >> (8 * i)) & 0xFF);
+    }
+    ICHECK_NE(swapped, kMagic) << "Binary graph was saved on a machine with another byte order";
+    LOG(FATAL) << "Invalid binary graph";
+  }
+  uint64_t version = reader.ReadPOD<uint64_t>();
+  ICHECK_LE(version, kVersion) << "Binary graph version " << version << " is not supported";
+  reader.ReadString();  // tvm_version
+
+  std::vector<Schema> schemas(reader.ReadPOD<uint64_t>());
+  for (Schema& schema : schemas) {
+    schema.type_key = reader.ReadString();
+    schema.node_kind = static_cast<NodeKind>(reader.ReadPOD<uint8_t>());
+    uint64_t num_fields = reader.ReadPOD<uint64_t>();
+    for (uint64_t i = 0; i < num_fields; ++i) {
+      schema.keys.push_back(reader.ReadString());
+      schema.kinds.push_back(static_cast<FieldKind>(reader.ReadPOD<uint8_t>()));
+    }
+  }
+
+  // The JSON nodes hold the type keys, repr bytes and dependencies.
+  uint64_t n_nodes = reader.ReadPOD<uint64_t>();
+  std::vector<JSONNode> jnodes(n_nodes);
+  std::vector<const Schema*> node_schemas(n_nodes, nullptr);
+  std::vector<std::vector<uint64_t>> values(n_nodes);
+  std::vector<std::string> strings;
+  auto read_index = [&reader, n_nodes]() {
+    uint64_t index = reader.ReadPOD<uint64_t>();
+    ICHECK_LT(index, n_nodes) << "BinaryGraphReader: invalid node index";
+    return static_cast<size_t>(index);
+  };
+  for (uint64_t i = 0; i < n_nodes; ++i) {
+    uint32_t schema_id = reader.ReadPOD<uint32_t>();
+    if (schema_id == 0) continue;
+    ICHECK_LE(schema_id, schemas.size()) << "BinaryGraphReader: invalid schema index";
+    const Schema& schema = schemas[schema_id - 1];
+    JSONNode& jnode = jnodes[i];
+    node_schemas[i] = &schema;
+    jnode.type_key = schema.type_key;
+    switch (schema.node_kind) {
+      case kNodeRepr:
+        jnode.repr_bytes = reader.ReadString();
+        break;
+      case kNodeArray:
+      case kNodeMap: {
+        uint64_t num_elems = reader.ReadPOD<uint64_t>();
+        if (schema.node_kind == kNodeMap) num_elems *= 2;
+        for (uint64_t j = 0; j < num_elems; ++j) {
+          jnode.data.push_back(read_index());
+        }
+        break;
+      }
+      case kNodeStrMap: {
+        uint64_t num_elems = reader.ReadPOD<uint64_t>();
+        for (uint64_t j = 0; j < num_elems; ++j) {
+          jnode.keys.push_back(reader.ReadString());
+          jnode.data.push_back(read_index());
+        }
+        break;
+      }
+      case kNodeObject: {
+        for (FieldKind kind : schema.kinds) {
+          if (kind == kString) {
+            values[i].push_back(strings.size());
+            strings.push_back(reader.ReadString());
+          } else if (kind == kObjectRef) {
+            size_t index = read_index();
+            values[i].push_back(index);
+            jnode.fields.push_back(index);
+          } else {
+            values[i].push_back(reader.ReadPOD<uint64_t>());
+          }
+        }
+        break;
+      }
+      default:
+        LOG(FATAL) << "BinaryGraphReader: invalid node kind " << static_cast<int>(schema.node_kind);
+    }
+  }
+  size_t root = read_index();
+  std::vector<runtime::NDArray> tensors(reader.ReadPOD<uint64_t>());
+  for (runtime::NDArray& tensor : tensors) {
+    tensor = LoadTensor(&reader);
+  }
+
+  // Same passes as LoadJSON, the field dependencies are known from the schemas.
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  std::vector<ObjectPtr<Object>> nodes(n_nodes, nullptr);
+  for (size_t i = 0; i < n_nodes; ++i) {
+    if (node_schemas[i] != nullptr) {
+      nodes[i] = reflection->CreateInitObject(jnodes[i].type_key, jnodes[i].repr_bytes);
+    }
+  }
+  AttrSetter setter;
+  setter.node_list_ = &nodes;
+  setter.tensor_list_ = &tensors;
+  setter.strings_ = &strings;
+  for (size_t i : TopoSortNodes(jnodes)) {
+    const Schema* schema = node_schemas[i];
+    if (schema == nullptr || schema->node_kind == kNodeRepr) continue;
+    if (JSONAttrSetter::SetContainer(&nodes[i], jnodes[i], nodes)) continue;
+    setter.schema_ = schema;
+    setter.values_ = &values[i];
+    setter.Set(nodes[i].get());
+  }
+  return ObjectRef(nodes.at(root));
+}
+
+}  // namespace binary_graph
+
+std::string SaveBinaryGraph(const ObjectRef& node) { return binary_graph::Save(node); }
+
+ObjectRef LoadBinaryGraph(const std::string& blob) {
+  return binary_graph::Load(blob.data(), blob.size());
+}
+
 TVM_REGISTER_GLOBAL("node.SaveJSON").set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON").set_body_typed(LoadJSON);
+
+TVM_REGISTER_GLOBAL("node.SaveBinaryGraph").set_body([](TVMArgs args, TVMRetValue* rv) {
+  std::string blob = SaveBinaryGraph(args[0]);
+  TVMByteArray arr;
+  arr.data = blob.data();
+  arr.size = blob.size();
+  *rv = arr;
+});
+
+TVM_REGISTER_GLOBAL("node.LoadBinaryGraph").set_body_typed([](std::string blob) {
+  return LoadBinaryGraph(blob);
+});
 }  // namespace tvm
@@ -31,6 +31,8 @@
 #include <tvm/target/codegen.h>
 
 #include <algorithm>
+#include <deque>
+#include <mutex>
 #include <unordered_map>
 
 #include "../support/base64.h"
@@ -298,6 +300,67 @@ uint64_t StructuralHash::operator()(const ObjectRef& object) const {
   return SHashHandlerDefault().Hash(object, false);
 }
 
+class StructuralHashCache::Impl {
+ public:
+  explicit Impl(size_t capacity) : capacity_(capacity) {}
+
+  uint64_t Hash(const ObjectRef& object, const std::function<uint64_t(const ObjectRef&)>& fhash) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = memo_.find(object.get());
+      if (it != memo_.end()) {
+        return it->second;
+      }
+    }
+    // Hash outside the lock, concurrent misses on the same object compute the same value.
+    uint64_t hash_value = fhash(object);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || memo_.count(object.get())) {
+      return hash_value;
+    }
+    if (order_.size() == capacity_) {
+      memo_.erase(order_.front().get());
+      order_.pop_front();
+    }
+    order_.push_back(object);
+    memo_[object.get()] = hash_value;
+    return hash_value;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memo_.clear();
+    order_.clear();
+  }
+
+ private:
+  // The maximum number of entries.
+  size_t capacity_;
+  // Guards the fields below.
+  std::mutex mutex_;
+  // The cached objects from oldest to newest, holding them keeps them unchanged.
+  std::deque<ObjectRef> order_;
+  // The hash value of each cached object.
+  std::unordered_map<const Object*, uint64_t> memo_;
+};
+
+StructuralHashCache::StructuralHashCache(size_t capacity) : impl_(new Impl(capacity)) {}
+StructuralHashCache::~StructuralHashCache() { delete impl_; }
+
+uint64_t StructuralHashCache::Hash(const ObjectRef& object,
+                                   const std::function<uint64_t(const ObjectRef&)>& fhash) {
+  if (!object.defined()) {
+    return fhash(object);
+  }
+  return impl_->Hash(object, fhash);
+}
+
+uint64_t StructuralHashCache::operator()(const ObjectRef& object) {
+  return Hash(object, [](const ObjectRef& obj) { return StructuralHash()(obj); });
+}
+
+void StructuralHashCache::Clear() { impl_->Clear(); }
+
 void SHashHandlerIgnoreNDArray::DispatchSHash(const ObjectRef& object, bool map_free_vars) {
   ICHECK(object.defined());
   if (auto ndarray = object.as<runtime::NDArray::Container>()) {
@@ -162,6 +162,7 @@ class JSONSerializer : public relax::MemoizedExprTranslator<NodeEntries> {
     // First we convert all the parameters into input nodes.
     for (const auto& param : func->params) {
       auto node_ptr = std::make_shared<JSONGraphNode>(param->name_hint(), "input" /* op_type_ */);
+      SetInputAttributes(param, node_ptr);
       memo_[param] = AddNode(node_ptr, param);
     }
     heads_ = VisitExpr(func->body);
@@ -179,6 +180,13 @@ class JSONSerializer : public relax::MemoizedExprTranslator<NodeEntries> {
   }
 
  protected:
+  /*!
+   * \brief Attach the attributes that a backend needs to the input node of a parameter.
+   * \param param The parameter of the function.
+   * \param node The input node of the parameter.
+   */
+  virtual void SetInputAttributes(const Var& param, JSONGraphObjectPtr node) {}
+
   /*!
    * \brief Add a node to graph.
    *
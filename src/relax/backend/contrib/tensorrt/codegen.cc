@@ -50,6 +50,7 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
   bool remove_no_mac_subgraphs;
   bool use_fp16;
   bool use_uint8;
+  Map<String, Array<Integer>> shape_profiles;
 
   TVM_DECLARE_ATTRS(TensorRTCompilerConfigNode, "relax.ext.attrs.TensorRTCompilerConfigNode") {
     TVM_ATTR_FIELD(tensorrt_version)
@@ -60,6 +61,11 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
     TVM_ATTR_FIELD(remove_no_mac_subgraphs).set_default(false);
     TVM_ATTR_FIELD(use_fp16).set_default(false);
     TVM_ATTR_FIELD(use_uint8).set_default(false);
+    TVM_ATTR_FIELD(shape_profiles)
+        .describe(
+            "The (min, opt, max) of the symbolic variables of the input shapes, which the engines "
+            "are optimized for in explicit batch mode.")
+        .set_default(Map<String, Array<Integer>>());
   }
 };
 
@@ -115,8 +121,9 @@ class CollectFromCompositeFunctionBody : public ExprVisitor {
  */
 class TensorRTJSONSerializer : public JSONSerializer {
  public:
-  explicit TensorRTJSONSerializer(Map<Constant, String> constant_names, Map<Var, Expr> bindings)
-      : JSONSerializer(constant_names), bindings_(bindings) {}
+  explicit TensorRTJSONSerializer(Map<Constant, String> constant_names, Map<Var, Expr> bindings,
+                                  Map<String, Array<Integer>> shape_ranges)
+      : JSONSerializer(constant_names), bindings_(bindings), shape_ranges_(shape_ranges) {}
 
   using JSONSerializer::VisitExpr_;
 
@@ -191,11 +198,78 @@ class TensorRTJSONSerializer : public JSONSerializer {
     node->SetAttr("use_uint8", use_uint8_attr);
   }
 
+ protected:
+  /*!
+   * \brief Record the optimization profile of an input whose shape is symbolic, as the min, opt
+   * and max shapes, so that a single engine serves the whole range of shapes. The inputs with a
+   * symbolic variable of unknown range get no profile.
+   */
+  void SetInputAttributes(const Var& param, JSONGraphObjectPtr node) final {
+    const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(param);
+    if (tensor_sinfo == nullptr || !tensor_sinfo->shape.defined()) return;
+    const auto* shape = tensor_sinfo->shape.as<ShapeExprNode>();
+    if (shape == nullptr) return;
+    std::vector<std::string> profile(3);
+    bool is_dynamic = false;
+    for (size_t i = 0; i < shape->values.size(); ++i) {
+      const PrimExpr& dim = shape->values[i];
+      Array<Integer> range;
+      if (const int64_t* value = tir::as_const_int(dim)) {
+        range = {Integer(*value), Integer(*value), Integer(*value)};
+      } else if (const auto* var = dim.as<tir::VarNode>()) {
+        if (!shape_ranges_.count(var->name_hint)) return;
+        range = shape_ranges_[var->name_hint];
+        is_dynamic = true;
+      } else {
+        return;
+      }
+      for (int k = 0; k < 3; ++k) {
+        profile[k] += (i == 0 ? "" : ",") + std::to_string(range[k]->value);
+      }
+    }
+    if (!is_dynamic) return;
+    const char* keys[] = {"profile_min", "profile_opt", "profile_max"};
+    for (int k = 0; k < 3; ++k) {
+      std::vector<dmlc::any> attr;
+      attr.emplace_back(std::vector<std::string>{profile[k]});
+      node->SetAttr(keys[k], attr);
+    }
+  }
+
  private:
   /*! \brief The bindings to look up composite functions. */
   Map<Var, Expr> bindings_;
+  /*! \brief The (min, opt, max) of the symbolic variables of the input shapes. */
+  Map<String, Array<Integer>> shape_ranges_;
 };
 
+/*!
+ * \brief Collect the ranges of the symbolic variables of a function, from the "shape_profiles"
+ * option first, then from the bounds annotated on the function, optimizing for the upper bound.
+ */
+Map<String, Array<Integer>> GetShapeRanges(const Function& func) {
+  auto cfg = transform::PassContext::Current()->GetConfig<TensorRTCompilerConfig>(
+      "relax.ext.tensorrt.options");
+  if (!cfg.defined()) {
+    cfg = AttrsWithDefaultValues<TensorRTCompilerConfig>();
+  }
+  Map<String, Array<Integer>> ranges;
+  for (const auto& [name, range] : cfg.value()->shape_profiles) {
+    CHECK(range.size() == 3 && range[0]->value >= 1 && range[0]->value <= range[1]->value &&
+          range[1]->value <= range[2]->value)
+        << "ValueError: The shape profile of `" << name
+        << "` must be (min, opt, max) with 1 <= min <= opt <= max, but got " << range;
+    ranges.Set(name, range);
+  }
+  auto upper_bounds = func->GetAttr<Map<String, IntImm>>("tir_var_upper_bound");
+  for (const auto& [name, upper_bound] : upper_bounds.value_or({})) {
+    if (!ranges.count(name)) {
+      ranges.Set(name, {Integer(1), Integer(upper_bound->value), Integer(upper_bound->value)});
+    }
+  }
+  return ranges;
+}
+
 void CollectFromCompositeFunctionBody::VisitExpr_(const ConstantNode* constant_node) {
   for (const auto& entry : serializer_->VisitExpr(GetRef<Constant>(constant_node))) {
     args_.emplace_back(entry);
@@ -218,7 +292,8 @@ Array<runtime::Module> TensorRTCompiler(Array<Function> functions,
   Array<runtime::Module> compiled_functions;
   for (const auto& func : functions) {
     VLOG(1) << "TensorRT partition:" << std::endl << func;
-    TensorRTJSONSerializer serializer(constant_names, AnalyzeVar2Value(func));
+    TensorRTJSONSerializer serializer(constant_names, AnalyzeVar2Value(func),
+                                      GetShapeRanges(func));
     serializer.serialize(func);
     std::string graph_json = serializer.GetJSON();
     VLOG(1) << "TensorRT JSON:" << std::endl << graph_json;
@@ -22,7 +22,13 @@
  */
 #include <tvm/relax/exec_builder.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
 #include <sstream>
+#include <unordered_set>
+#include <utility>
 
 namespace tvm {
 namespace relax {
@@ -42,6 +48,7 @@ Executable* ExecBuilderNode::exec() const { return exec_.get(); }
 ObjectPtr<Executable> ExecBuilderNode::Get() {
   this->Formalize();
   this->CheckExecutable();
+  this->AllocateRegisters();
   return exec_;
 }
 
@@ -331,6 +338,197 @@ void ExecBuilderNode::Formalize() {
   }
 }
 
+void ExecBuilderNode::AllocateRegisters() {
+  // A linear scan allocation over the instructions of each function. The live range of a
+  // register is approximated by the interval between the first and the last instruction it is
+  // live out of or defined at, which preserves the interference of the registers across jumps.
+  using Bits = std::vector<uint64_t>;
+  auto is_reg = [](RegName reg) { return reg >= 0 && reg < Instruction::kBeginSpecialReg; };
+
+  for (auto it = exec_->func_table.begin(); it != exec_->func_table.end(); ++it) {
+    if (it->kind != VMFuncInfo::FuncKind::kVMFunc) continue;
+    const Index num_inputs = it->num_args;
+    const Index num_regs = it->register_file_size;
+    const Index begin = it->start_instr;
+    const Index num_instrs = it->end_instr - it->start_instr;
+    const size_t num_words = (num_regs + 63) / 64;
+
+    // Step 1. Collect the registers used and defined by each instruction, and split the
+    // instructions into basic blocks.
+    std::vector<std::vector<RegName>> uses(num_instrs);
+    std::vector<RegName> defs(num_instrs, Instruction::kVoidRegister);
+    std::vector<Index> jump_targets(num_instrs, -1);
+    std::vector<bool> falls_through(num_instrs, true);
+    std::vector<bool> is_leader(num_instrs + 1, false);
+    is_leader[0] = true;
+    auto add_jump = [&](Index idx, Index offset) {
+      Index target = idx + offset;
+      ICHECK(target >= 0 && target < num_instrs)
+          << "Instruction " << idx << " of VM function \"" << it->name
+          << "\" jumps out of the function";
+      jump_targets[idx] = target;
+      is_leader[target] = true;
+      is_leader[idx + 1] = true;
+    };
+    for (Index idx = 0; idx < num_instrs; ++idx) {
+      Instruction instr = exec_->GetInstruction(begin + idx);
+      switch (instr.op) {
+        case Opcode::Call: {
+          for (int i = 0; i < instr.num_args; ++i) {
+            if (instr.args[i].kind() == Instruction::ArgKind::kRegister &&
+                is_reg(instr.args[i].value())) {
+              uses[idx].push_back(instr.args[i].value());
+            }
+          }
+          if (is_reg(instr.dst)) defs[idx] = instr.dst;
+          break;
+        }
+        case Opcode::Ret: {
+          if (is_reg(instr.result)) uses[idx].push_back(instr.result);
+          falls_through[idx] = false;
+          is_leader[idx + 1] = true;
+          break;
+        }
+        case Opcode::Goto: {
+          falls_through[idx] = false;
+          add_jump(idx, instr.pc_offset);
+          break;
+        }
+        case Opcode::If: {
+          if (is_reg(instr.cond)) uses[idx].push_back(instr.cond);
+          add_jump(idx, instr.false_offset);
+          break;
+        }
+        default:
+          LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
+          break;
+      }
+    }
+    std::vector<Index> block_begin;
+    std::vector<Index> block_of(num_instrs);
+    for (Index idx = 0; idx < num_instrs; ++idx) {
+      if (is_leader[idx]) block_begin.push_back(idx);
+      block_of[idx] = block_begin.size() - 1;
+    }
+    const size_t num_blocks = block_begin.size();
+    block_begin.push_back(num_instrs);
+
+    // Step 2. Compute the registers live in and out of each block.
+    std::vector<Bits> gen(num_blocks, Bits(num_words, 0)), kill(num_blocks, Bits(num_words, 0));
+    std::vector<std::vector<size_t>> succs(num_blocks);
+    auto test = [](const Bits& bits, RegName reg) { return (bits[reg / 64] >> (reg % 64)) & 1; };
+    auto set = [](Bits* bits, RegName reg) { (*bits)[reg / 64] |= uint64_t(1) << (reg % 64); };
+    for (size_t b = 0; b < num_blocks; ++b) {
+      for (Index idx = block_begin[b]; idx < block_begin[b + 1]; ++idx) {
+        for (RegName reg : uses[idx]) {
+          if (!test(kill[b], reg)) set(&gen[b], reg);
+        }
+        if (defs[idx] != Instruction::kVoidRegister) set(&kill[b], defs[idx]);
+      }
+      Index last = block_begin[b + 1] - 1;
+      if (falls_through[last] && last + 1 < num_instrs) succs[b].push_back(block_of[last + 1]);
+      if (jump_targets[last] >= 0) succs[b].push_back(block_of[jump_targets[last]]);
+    }
+    std::vector<Bits> live_in(num_blocks, Bits(num_words, 0));
+    std::vector<Bits> live_out(num_blocks, Bits(num_words, 0));
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (size_t b = num_blocks; b-- > 0;) {
+        for (size_t s : succs[b]) {
+          for (size_t w = 0; w < num_words; ++w) live_out[b][w] |= live_in[s][w];
+        }
+        for (size_t w = 0; w < num_words; ++w) {
+          uint64_t in = gen[b][w] | (live_out[b][w] & ~kill[b][w]);
+          changed |= in != live_in[b][w];
+          live_in[b][w] = in;
+        }
+      }
+    }
+
+    // Step 3. Compute the live interval of each register, where the inputs are live from the
+    // entry of the function.
+    const Index kUnused = std::numeric_limits<Index>::max();
+    std::vector<Index> start(num_regs, kUnused), end(num_regs, -1);
+    auto extend = [&](RegName reg, Index idx) {
+      start[reg] = std::min(start[reg], idx);
+      end[reg] = std::max(end[reg], idx);
+    };
+    for (RegName reg = 0; reg < num_inputs; ++reg) extend(reg, -1);
+    for (size_t b = 0; b < num_blocks; ++b) {
+      for (RegName reg = 0; reg < num_regs; ++reg) {
+        if (test(live_in[b], reg)) extend(reg, block_begin[b]);
+        if (test(live_out[b], reg)) extend(reg, block_begin[b + 1] - 1);
+      }
+      for (Index idx = block_begin[b]; idx < block_begin[b + 1]; ++idx) {
+        // A register whose last use is the instruction is free to hold its result
+        for (RegName reg : uses[idx]) extend(reg, std::max(idx - 1, block_begin[b]));
+        if (defs[idx] != Instruction::kVoidRegister) extend(defs[idx], idx);
+      }
+    }
+
+    // Step 4. Assign the registers in the order of their intervals, reusing the lowest register
+    // whose interval has ended. The inputs keep their registers.
+    std::vector<RegName> order;
+    for (RegName reg = num_inputs; reg < num_regs; ++reg) {
+      if (start[reg] != kUnused) order.push_back(reg);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](RegName lhs, RegName rhs) { return start[lhs] < start[rhs]; });
+    std::vector<RegName> assigned(num_regs, Instruction::kVoidRegister);
+    std::priority_queue<std::pair<Index, RegName>, std::vector<std::pair<Index, RegName>>,
+                        std::greater<>>
+        active;
+    std::priority_queue<RegName, std::vector<RegName>, std::greater<>> free_regs;
+    for (RegName reg = 0; reg < num_inputs; ++reg) {
+      assigned[reg] = reg;
+      active.emplace(end[reg], reg);
+    }
+    RegName register_file_size = num_inputs;
+    for (RegName reg : order) {
+      while (!active.empty() && active.top().first < start[reg]) {
+        free_regs.push(active.top().second);
+        active.pop();
+      }
+      if (free_regs.empty()) {
+        assigned[reg] = register_file_size++;
+      } else {
+        assigned[reg] = free_regs.top();
+        free_regs.pop();
+      }
+      active.emplace(end[reg], assigned[reg]);
+    }
+
+    // Step 5. Rewrite the registers of the instructions.
+    for (Index idx = 0; idx < num_instrs; ++idx) {
+      Instruction instr = exec_->GetInstruction(begin + idx);
+      Index offset = exec_->instr_offset[begin + idx];
+      switch (instr.op) {
+        case Opcode::Call: {
+          for (int i = 0; i < instr.num_args; ++i) {
+            if (instr.args[i].kind() == Instruction::ArgKind::kRegister &&
+                is_reg(instr.args[i].value())) {
+              exec_->instr_data[offset + 4 + i] = assigned[instr.args[i].value()];
+            }
+          }
+          if (is_reg(instr.dst)) exec_->instr_data[offset + 1] = assigned[instr.dst];
+          break;
+        }
+        case Opcode::Ret: {
+          if (is_reg(instr.result)) exec_->instr_data[offset + 1] = assigned[instr.result];
+          break;
+        }
+        case Opcode::If: {
+          if (is_reg(instr.cond)) exec_->instr_data[offset + 1] = assigned[instr.cond];
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    it->register_file_size = register_file_size;
+  }
+}
+
 TVM_REGISTER_GLOBAL("relax.ExecBuilderCreate").set_body_typed(ExecBuilderNode::Create);
 
 TVM_REGISTER_GLOBAL("relax.ExecBuilderConvertConstant")
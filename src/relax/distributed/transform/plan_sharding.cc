@@ -0,0 +1,388 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/distributed/transform/plan_sharding.cc
+ * \brief Pass for planning the tensor-parallel sharding of a model.
+ *
+ * The planner looks for groups of matmuls by weights that can be split in the Megatron style: a
+ * row-parallel matmul, whose weight is split along its reduction axis, and the column-parallel
+ * matmuls whose outputs, split along their last axis, reach the input of the row-parallel matmul
+ * through elementwise ops only. Such a group computes on shards without communication, until the
+ * partial results of the row-parallel matmul are summed up by an allreduce.
+ *
+ * Each group is sharded if the time saved by splitting its matmuls across the devices of the
+ * mesh exceeds the time of the allreduce. The ops around the groups, e.g. the norms, are left
+ * replicated. The plan is emitted as sharding annotations on the weights of the matmuls, which
+ * PropagateSharding propagates to the rest of the function.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/distributed.h>
+#include <tvm/relax/distributed/transform.h>
+#include <tvm/relax/expr_functor.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../op/distributed/distributed.h"
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+
+/*! \brief The time model of the computation and communication over a device mesh axis. */
+struct ShardingCostModel {
+  /*! \brief The number of devices the tensors are split across. */
+  int64_t num_shards;
+  /*! \brief The throughput of each device, in flop/s. */
+  double device_flops;
+  /*! \brief The bandwidth of each link between the devices, in bytes/s. */
+  double link_bandwidth;
+  /*! \brief The latency of each link between the devices, in seconds. */
+  double link_latency;
+
+  /*! \brief The time saved by splitting a computation across the devices. */
+  double SplitSaving(double flops) const {
+    return flops * (1.0 - 1.0 / num_shards) / device_flops;
+  }
+
+  /*! \brief The time of a ring allreduce. */
+  double AllReduceTime(double bytes) const {
+    return 2.0 * (num_shards - 1) * (link_latency + bytes / num_shards / link_bandwidth);
+  }
+};
+
+/*! \brief The static number of elements of a tensor, or -1 if it is not static. */
+int64_t GetNumElements(const TensorStructInfoNode* sinfo) {
+  const auto* shape = sinfo ? sinfo->shape.as<ShapeExprNode>() : nullptr;
+  if (shape == nullptr) {
+    return -1;
+  }
+  int64_t num_elements = 1;
+  for (const PrimExpr& dim : shape->values) {
+    const auto* int_dim = dim.as<IntImmNode>();
+    if (int_dim == nullptr) {
+      return -1;
+    }
+    num_elements *= int_dim->value;
+  }
+  return num_elements;
+}
+
+/*!
+ * \brief Plan the sharding of the matmuls of a function, see the file comment.
+ */
+class ShardingPlanner : public ExprVisitor {
+ public:
+  /*!
+   * \brief Plan the sharding of a function.
+   * \return The placement of the weight of each sharded matmul.
+   */
+  static std::unordered_map<const VarBindingNode*, Placement> Plan(const Function& func,
+                                                                    const DeviceMesh& mesh,
+                                                                    const ShardingCostModel& cost) {
+    ShardingPlanner planner;
+    planner.VisitExpr(func);
+    for (const VarBindingNode* binding : planner.binding_order_) {
+      if (planner.IsWeightMatmul(binding)) {
+        planner.matmuls_.push_back(binding);
+      }
+    }
+    return planner.PlanGroups(mesh, cost);
+  }
+
+ private:
+  /*! \brief A row-parallel matmul with the column-parallel matmuls producing its input. */
+  struct Group {
+    const VarBindingNode* row;
+    std::vector<const VarBindingNode*> columns;
+    double gain;
+  };
+
+  /*! \brief How an expression depends on the column-parallel matmuls. */
+  enum class Source {
+    /*! \brief It is split along its last axis by the column-parallel matmuls. */
+    kColumn,
+    /*! \brief It is a parameter or scalar that can be split along with the columns. */
+    kLeaf,
+    /*! \brief It cannot be split. */
+    kInvalid,
+  };
+
+  void VisitExpr_(const FunctionNode* func) final {
+    for (const Var& param : func->params) {
+      params_.insert(param.get());
+    }
+    ExprVisitor::VisitExpr_(func);
+  }
+
+  void VisitExpr_(const VarNode* var) final { ++num_uses_[var]; }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    bindings_[binding->var.get()] = binding;
+    binding_order_.push_back(binding);
+    ExprVisitor::VisitBinding_(binding);
+  }
+
+  /*!
+   * \brief Whether the binding is a matmul by a 2-d static weight, as a parameter or its
+   * transpose used by the matmul only, with a static input and output.
+   */
+  bool IsWeightMatmul(const VarBindingNode* binding) const {
+    static const Op& matmul_op = Op::Get("relax.matmul");
+    static const Op& permute_dims_op = Op::Get("relax.permute_dims");
+    const auto* call = binding->value.as<CallNode>();
+    if (call == nullptr || !call->op.same_as(matmul_op)) {
+      return false;
+    }
+    Expr weight = call->args[1];
+    if (!weight->IsInstance<VarNode>() || num_uses_.at(weight.get()) != 1) {
+      return false;
+    }
+    if (const auto* var = weight.as<VarNode>(); bindings_.count(var)) {
+      const auto* permute = bindings_.at(var)->value.as<CallNode>();
+      if (permute == nullptr || !permute->op.same_as(permute_dims_op)) {
+        return false;
+      }
+      weight = permute->args[0];
+    }
+    const auto* weight_sinfo = GetStructInfoAs<TensorStructInfoNode>(weight);
+    return params_.count(weight.get()) && weight_sinfo && weight_sinfo->ndim == 2 &&
+           GetNumElements(weight_sinfo) > 0 &&
+           GetNumElements(GetStructInfoAs<TensorStructInfoNode>(call->args[0])) > 0 &&
+           GetNumElements(GetStructInfoAs<TensorStructInfoNode>(binding->var)) > 0;
+  }
+
+  /*!
+   * \brief Find the column-parallel matmuls producing an expression through elementwise ops.
+   * \param expr The expression.
+   * \param row The row-parallel matmul, which is not a column-parallel one.
+   * \param columns The column-parallel matmuls found.
+   */
+  Source TraceColumns(const Expr& expr, const VarBindingNode* row,
+                      std::vector<const VarBindingNode*>* columns) const {
+    if (const auto* constant = expr.as<ConstantNode>()) {
+      // The constants cannot be sharded, so only the scalars can be broadcast to the shards
+      return constant->data->ndim == 0 ? Source::kLeaf : Source::kInvalid;
+    }
+    const auto* var = expr.as<VarNode>();
+    if (var == nullptr) {
+      return Source::kInvalid;
+    }
+    if (params_.count(var)) {
+      return Source::kLeaf;
+    }
+    auto it = bindings_.find(var);
+    // The intermediate results are only seen split by the group
+    if (it == bindings_.end() || num_uses_.at(var) != 1) {
+      return Source::kInvalid;
+    }
+    const VarBindingNode* binding = it->second;
+    if (binding != row && IsWeightMatmul(binding)) {
+      columns->push_back(binding);
+      return Source::kColumn;
+    }
+    const auto* call = binding->value.as<CallNode>();
+    const auto* op = call ? call->op.as<OpNode>() : nullptr;
+    if (op == nullptr || !(UnaryOps().count(op->name) || BinaryOps().count(op->name))) {
+      return Source::kInvalid;
+    }
+    Source source = Source::kLeaf;
+    for (const Expr& arg : call->args) {
+      // The attributes given as arguments, e.g. the bounds of clip
+      if (!GetStructInfoAs<TensorStructInfoNode>(arg)) {
+        continue;
+      }
+      Source arg_source = TraceColumns(arg, row, columns);
+      if (arg_source == Source::kInvalid) {
+        return Source::kInvalid;
+      }
+      if (arg_source == Source::kColumn) {
+        source = Source::kColumn;
+      }
+    }
+    return source == Source::kColumn ? Source::kColumn : Source::kInvalid;
+  }
+
+  /*! \brief The elementwise unary ops whose axes are joined by PropagateSharding. */
+  static const std::unordered_set<std::string>& UnaryOps() {
+    static const std::unordered_set<std::string> ops = {
+        "relax.abs",     "relax.ceil",     "relax.cos",     "relax.exp",   "relax.floor",
+        "relax.log",     "relax.negative", "relax.nn.relu", "relax.round", "relax.rsqrt",
+        "relax.sigmoid", "relax.sign",     "relax.sin",     "relax.square", "relax.sqrt",
+        "relax.tanh",    "relax.clip",     "relax.erf",     "relax.nn.gelu"};
+    return ops;
+  }
+
+  /*! \brief The elementwise binary ops whose axes are joined by PropagateSharding. */
+  static const std::unordered_set<std::string>& BinaryOps() {
+    static const std::unordered_set<std::string> ops = {
+        "relax.add",   "relax.subtract", "relax.multiply", "relax.divide",
+        "relax.power", "relax.minimum",  "relax.maximum"};
+    return ops;
+  }
+
+  /*! \brief The number of flops of a matmul. */
+  static double GetFlops(const VarBindingNode* matmul) {
+    const auto* call = matmul->value.as<CallNode>();
+    const auto* input_sinfo = GetStructInfoAs<TensorStructInfoNode>(call->args[0]);
+    PrimExpr reduction = input_sinfo->GetShape().value().back();
+    return 2.0 * GetNumElements(GetStructInfoAs<TensorStructInfoNode>(matmul->var)) *
+           Downcast<IntImm>(reduction)->value;
+  }
+
+  std::unordered_map<const VarBindingNode*, Placement> PlanGroups(
+      const DeviceMesh& mesh, const ShardingCostModel& cost) const {
+    // Step 1. Find the groups led by each row-parallel matmul, and their gain
+    std::vector<Group> groups;
+    for (const VarBindingNode* row : matmuls_) {
+      Group group{row, {}, 0.0};
+      const auto* call = row->value.as<CallNode>();
+      if (TraceColumns(call->args[0], row, &group.columns) != Source::kColumn) {
+        continue;
+      }
+      double flops = GetFlops(row);
+      for (const VarBindingNode* column : group.columns) {
+        flops += GetFlops(column);
+      }
+      const auto* out_sinfo = GetStructInfoAs<TensorStructInfoNode>(row->var);
+      double out_bytes = GetNumElements(out_sinfo) * out_sinfo->dtype.bytes();
+      group.gain = cost.SplitSaving(flops) - cost.AllReduceTime(out_bytes);
+      if (group.gain > 0) {
+        groups.push_back(std::move(group));
+      }
+    }
+    // Step 2. Shard the most profitable groups first, as a matmul is in at most one group
+    std::stable_sort(groups.begin(), groups.end(),
+                     [](const Group& a, const Group& b) { return a.gain > b.gain; });
+    std::unordered_map<const VarBindingNode*, Placement> plan;
+    std::unordered_set<const VarBindingNode*> planned;
+    auto f_placement = [&](int axis) {
+      Array<PlacementSpec> dim_specs(mesh->shape.size(), PlacementSpec::Replica());
+      dim_specs.Set(0, PlacementSpec::Sharding(axis));
+      return Placement(dim_specs);
+    };
+    for (const Group& group : groups) {
+      bool overlapped = planned.count(group.row);
+      for (const VarBindingNode* column : group.columns) {
+        overlapped = overlapped || planned.count(column);
+      }
+      if (overlapped) {
+        continue;
+      }
+      // The weights are split along the output axis of the column-parallel matmuls, and along
+      // the reduction axis of the row-parallel one
+      plan.emplace(group.row, f_placement(0));
+      planned.insert(group.row);
+      for (const VarBindingNode* column : group.columns) {
+        plan.emplace(column, f_placement(1));
+        planned.insert(column);
+      }
+    }
+    return plan;
+  }
+
+  /*! \brief The parameters of the function. */
+  std::unordered_set<const Object*> params_;
+  /*! \brief The binding of each variable. */
+  std::unordered_map<const Object*, const VarBindingNode*> bindings_;
+  /*! \brief The number of uses of each variable. */
+  std::unordered_map<const Object*, int> num_uses_;
+  /*! \brief The variable bindings, in program order. */
+  std::vector<const VarBindingNode*> binding_order_;
+  /*! \brief The matmuls by weights, in program order. */
+  std::vector<const VarBindingNode*> matmuls_;
+};
+
+/*!
+ * \brief Annotate the sharding of the weights of the planned matmuls.
+ */
+class ShardingPlanAnnotator : public ExprMutator {
+ public:
+  static IRModule Annotate(IRModule mod, int mesh_index, const ShardingCostModel& cost_template) {
+    Optional<Array<GlobalInfo>> meshes = mod->global_infos.Get("mesh");
+    CHECK(meshes.defined() && mesh_index >= 0 &&
+          mesh_index < static_cast<int>(meshes.value().size()))
+        << "ValueError: PlanSharding requires the device mesh " << mesh_index
+        << " in the global infos of the module";
+    DeviceMesh mesh = Downcast<DeviceMesh>(meshes.value()[mesh_index]);
+    ShardingCostModel cost = cost_template;
+    cost.num_shards = mesh->shape[0];
+    if (cost.num_shards <= 1) {
+      return mod;
+    }
+    ShardingPlanAnnotator annotator(mod, mesh);
+    for (const auto& [gv, base_func] : mod->functions) {
+      const auto* func = base_func.as<FunctionNode>();
+      // The functions annotated by the user are left to them
+      if (func == nullptr || IsShardingAnnotatedFunc(GetRef<Function>(func)) ||
+          IsDistIRFunc(GetRef<Function>(func))) {
+        continue;
+      }
+      annotator.plan_ = ShardingPlanner::Plan(GetRef<Function>(func), mesh, cost);
+      if (annotator.plan_.empty()) {
+        continue;
+      }
+      Function new_func = Downcast<Function>(annotator.VisitExpr(GetRef<Function>(func)));
+      annotator.builder_->UpdateFunction(gv, new_func);
+    }
+    return annotator.builder_->GetContextIRModule();
+  }
+
+ private:
+  ShardingPlanAnnotator(IRModule mod, DeviceMesh mesh) : ExprMutator(mod), mesh_(mesh) {}
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
+    auto it = plan_.find(binding);
+    if (it == plan_.end()) {
+      ExprMutator::VisitBinding_(binding, call);
+      return;
+    }
+    Var weight = builder_->Emit(annotate_sharding(VisitExpr(call->args[1]), mesh_, it->second));
+    ObjectPtr<CallNode> new_call = make_object<CallNode>(*call);
+    new_call->args = {VisitExpr(call->args[0]), weight};
+    ReEmitBinding(binding, builder_->Normalize(Call(new_call)));
+  }
+
+  /*! \brief The device mesh to shard the weights across. */
+  DeviceMesh mesh_;
+  /*! \brief The placement of the weight of each sharded matmul. */
+  std::unordered_map<const VarBindingNode*, Placement> plan_;
+};
+
+namespace transform {
+
+Pass PlanSharding(int mesh_index, double device_flops, double link_bandwidth,
+                  double link_latency) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) {
+        ShardingCostModel cost{/*num_shards=*/1, device_flops, link_bandwidth, link_latency};
+        return ShardingPlanAnnotator::Annotate(m, mesh_index, cost);
+      };
+  return CreateModulePass(pass_func, 1, "PlanSharding", {});
+}
+TVM_REGISTER_GLOBAL("relax.distributed.transform.PlanSharding").set_body_typed(PlanSharding);
+}  // namespace transform
+
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
@@ -144,11 +144,16 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   for (const auto& it : updated_mod->functions) {
     // only picks up relax::Function
     if (auto* n = it.second.as<FunctionNode>()) {
-      Function func = GetRef<Function>(n);
-      auto updated_func = SkipFunction(func) ? func : pass_func(func, updated_mod, pass_ctx);
-      updates.push_back({it.first, updated_func});
+      updates.push_back({it.first, GetRef<Function>(n)});
     }
   }
+  int num_threads = tvm::transform::NumFunctionPassThreads(pass_info, pass_ctx);
+  tvm::transform::ParallelForFunctions(updates.size(), num_threads, pass_ctx, [&](int i) {
+    Function& func = updates[i].second;
+    if (!SkipFunction(func)) {
+      func = pass_func(func, updated_mod, pass_ctx);
+    }
+  });
 
   for (const auto& pair : updates) {
     updated_mod->Add(pair.first, pair.second, true);
@@ -173,8 +178,8 @@ bool FunctionPassNode::SkipFunction(const Function& func) const {
 
 Pass CreateFunctionPass(
     const runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable) {
-  PassInfo pass_info = PassInfo(opt_level, name, required, traceable);
+    int opt_level, String name, tvm::Array<String> required, bool traceable, bool thread_safe) {
+  PassInfo pass_info = PassInfo(opt_level, name, required, traceable, thread_safe);
   return FunctionPass(pass_func, pass_info);
 }
 
@@ -0,0 +1,282 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/checkpoint_activations.cc
+ * \brief Select the forward activations to be recomputed by Gradient under a memory budget.
+ *
+ * Every activation that is not recomputed stays alive until the backward pass uses it. The pass
+ * estimates the bytes of each activation and the FLOPs of recomputing it, counted on the PrimFunc
+ * that the operator is legalized to, and greedily recomputes the activations freeing the most bytes
+ * per recomputed FLOP until the kept activations fit in the budget. Recomputing an activation also
+ * recomputes its recomputed inputs, which is accounted in its cost. The selection is marked with
+ * start_checkpoint and end_checkpoint, so that Gradient keeps the inputs of the recomputed
+ * activations and recomputes the activations themselves in the backward pass.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/tir/analysis.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The number of bytes of a tensor of static shape, or -1 if it is not such a tensor. */
+static int64_t GetStaticTensorBytes(const StructInfo& sinfo) {
+  const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+  if (tensor_sinfo == nullptr || tensor_sinfo->IsUnknownDtype()) {
+    return -1;
+  }
+  Optional<Array<PrimExpr>> shape = tensor_sinfo->GetShape();
+  if (!shape.defined()) {
+    return -1;
+  }
+  int64_t bytes = tensor_sinfo->dtype.bytes() * tensor_sinfo->dtype.lanes();
+  for (const PrimExpr& dim : shape.value()) {
+    const auto* int_dim = dim.as<IntImmNode>();
+    if (int_dim == nullptr) {
+      return -1;
+    }
+    bytes *= int_dim->value;
+  }
+  return bytes;
+}
+
+/*!
+ * \brief Estimate the FLOPs of a call, on the callee of call_tir or on the PrimFunc that the
+ * operator is legalized to.
+ * \return The FLOPs, or 0 if they are unknown.
+ */
+static double EstimateCallFlops(const IRModule& mod, const Call& call) {
+  static const Op& call_tir_op = Op::Get("relax.call_tir");
+  static const auto& legalize_map = Op::GetAttrMap<FLegalize>("FLegalize");
+  try {
+    if (call->op.same_as(call_tir_op)) {
+      GlobalVar gvar = Downcast<GlobalVar>(call->args[0]);
+      if (Optional<BaseFunc> func = mod->functions.Get(gvar)) {
+        return tir::EstimateTIRFlops(IRModule({{gvar, func.value()}}));
+      }
+    } else if (Optional<Op> op = call->op.as<Op>(); op && legalize_map.count(op.value())) {
+      BlockBuilder bb = BlockBuilder::Create(NullOpt);
+      bb->BeginDataflowBlock();
+      bb->Normalize(legalize_map[op.value()](bb, call));
+      bb->EndBlock();
+      return tir::EstimateTIRFlops(bb->GetContextIRModule());
+    }
+  } catch (const tvm::Error& e) {
+    // The operator cannot be legalized on its arguments, which leaves the FLOPs unknown
+  }
+  return 0;
+}
+
+/*!
+ * \brief Select the activations to recompute in the dataflow block of a function, and mark them
+ * with start_checkpoint and end_checkpoint.
+ */
+class ActivationCheckpointer : public ExprMutator {
+ public:
+  static Function Transform(const IRModule& mod, const Function& func, int64_t memory_budget) {
+    const auto* seq = func->body.as<SeqExprNode>();
+    CHECK(seq != nullptr && seq->blocks.size() == 1 &&
+          seq->blocks[0]->IsInstance<DataflowBlockNode>())
+        << "ValueError: CheckpointActivations requires the function to have exactly one dataflow "
+           "block, as Gradient does";
+    ActivationCheckpointer mutator(mod);
+    if (!mutator.SelectRecomputed(seq->blocks[0], memory_budget)) {
+      return func;
+    }
+    return Downcast<Function>(mutator.VisitExpr(func));
+  }
+
+ private:
+  explicit ActivationCheckpointer(IRModule mod) : ExprMutator(mod), mod_(std::move(mod)) {}
+
+  /*! \brief An activation that can be recomputed. */
+  struct Activation {
+    /*! \brief The var of the activation. */
+    const VarNode* var;
+    /*! \brief The number of bytes of the activation. */
+    int64_t bytes;
+    /*! \brief The estimated FLOPs of computing the activation from its inputs. */
+    double flops;
+    /*! \brief The indices of the activations among the inputs. */
+    std::vector<int> inputs;
+  };
+
+  /*!
+   * \brief Select the activations to recompute so that the kept ones fit in the budget.
+   * \return Whether any activation is to be recomputed.
+   */
+  bool SelectRecomputed(const BindingBlock& block, int64_t memory_budget) {
+    static const Op& start_cp_op = Op::Get("relax.grad.start_checkpoint");
+    static const Op& end_cp_op = Op::Get("relax.grad.end_checkpoint");
+    // Step 1. Collect the tensors computed by calls from other vars. The outputs of the block
+    // are kept, as they outlive the function.
+    std::vector<Activation> activations;
+    std::unordered_map<const VarNode*, int> var2index;
+    int64_t kept_bytes = 0;
+    for (const Binding& binding : block->bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      const auto* call = var_binding != nullptr ? var_binding->value.as<CallNode>() : nullptr;
+      if (call != nullptr && (call->op.same_as(start_cp_op) || call->op.same_as(end_cp_op))) {
+        // The checkpoints are already marked by hand
+        return false;
+      }
+      if (call == nullptr || !binding->var->IsInstance<DataflowVarNode>()) {
+        continue;
+      }
+      int64_t bytes = GetStaticTensorBytes(GetStructInfo(binding->var));
+      Array<Var> free_vars = FreeVars(var_binding->value);
+      if (bytes <= 0 || free_vars.empty()) {
+        continue;
+      }
+      const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(binding->var);
+      int64_t num_elements = bytes / (tensor_sinfo->dtype.bytes() * tensor_sinfo->dtype.lanes());
+      Activation activation{binding->var.get(), bytes, 0.0, {}};
+      // Reading the inputs costs at least one operation per output element
+      activation.flops = std::max(EstimateCallFlops(mod_, GetRef<Call>(call)),
+                                  static_cast<double>(num_elements));
+      for (const Var& input : free_vars) {
+        auto it = var2index.find(input.get());
+        if (it != var2index.end()) {
+          activation.inputs.push_back(it->second);
+        }
+      }
+      var2index[binding->var.get()] = activations.size();
+      activations.push_back(std::move(activation));
+      kept_bytes += bytes;
+    }
+    // Step 2. Greedily recompute the activation freeing the most bytes per recomputed FLOP. The
+    // activations are in topological order, so that the recomputed inputs are costed first.
+    int n = activations.size();
+    std::vector<bool> recomputed(n, false);
+    std::vector<double> recompute_flops(n, 0.0);
+    while (kept_bytes > memory_budget) {
+      int best = -1;
+      double best_score = 0.0;
+      for (int i = 0; i < n; ++i) {
+        recompute_flops[i] = activations[i].flops;
+        for (int input : activations[i].inputs) {
+          if (recomputed[input]) {
+            recompute_flops[i] += recompute_flops[input];
+          }
+        }
+        double score = activations[i].bytes / recompute_flops[i];
+        if (!recomputed[i] && score > best_score) {
+          best = i;
+          best_score = score;
+        }
+      }
+      if (best == -1) {
+        LOG(WARNING) << "The activations take " << kept_bytes
+                     << " bytes even when every activation is recomputed, which exceeds the memory "
+                        "budget of "
+                     << memory_budget << " bytes";
+        break;
+      }
+      recomputed[best] = true;
+      recomputed_vars_.insert(activations[best].var);
+      kept_bytes -= activations[best].bytes;
+    }
+    return !recomputed_vars_.empty();
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    // A recomputed activation starts from its kept inputs, and a kept binding ends the
+    // recomputation of its recomputed inputs.
+    bool is_recomputed = recomputed_vars_.count(binding->var.get());
+    Array<Var> inputs = FreeVars(binding->value);
+    bool has_recomputed_input = std::any_of(inputs.begin(), inputs.end(), [this](const Var& var) {
+      return recomputed_vars_.count(var.get()) != 0;
+    });
+    Map<Var, Expr> markers;
+    for (const Var& input : inputs) {
+      if (is_recomputed && !has_recomputed_input) {
+        markers.Set(input, GetMarker(input, /*is_start=*/true));
+      } else if (!is_recomputed && recomputed_vars_.count(input.get())) {
+        markers.Set(input, GetMarker(input, /*is_start=*/false));
+      }
+    }
+    if (markers.empty()) {
+      ExprMutator::VisitBinding_(binding);
+      return;
+    }
+    ReEmitBinding(binding, builder_->Normalize(Bind(binding->value, markers)));
+  }
+
+  /*! \brief Get the var of start_checkpoint or end_checkpoint of a var, emitting it at most once. */
+  Var GetMarker(const Var& var, bool is_start) {
+    static const Op& start_cp_op = Op::Get("relax.grad.start_checkpoint");
+    static const Op& end_cp_op = Op::Get("relax.grad.end_checkpoint");
+    std::unordered_map<const VarNode*, Var>& markers = is_start ? start_markers_ : end_markers_;
+    auto it = markers.find(var.get());
+    if (it != markers.end()) {
+      return it->second;
+    }
+    Var marker = builder_->Emit(Call(is_start ? start_cp_op : end_cp_op, {var}),
+                                var->name_hint() + (is_start ? "_scp" : "_ecp"));
+    markers[var.get()] = marker;
+    return marker;
+  }
+
+  /*! \brief The module, for the callees of call_tir. */
+  IRModule mod_;
+  /*! \brief The activations to recompute. */
+  std::unordered_set<const VarNode*> recomputed_vars_;
+  /*! \brief The start_checkpoint of each kept input of the recomputed activations. */
+  std::unordered_map<const VarNode*, Var> start_markers_;
+  /*! \brief The end_checkpoint of each recomputed activation used by a kept one. */
+  std::unordered_map<const VarNode*, Var> end_markers_;
+};
+
+namespace transform {
+
+Pass CheckpointActivations(String func_name, int64_t memory_budget) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    Optional<Function> func = mod->Lookup(func_name).as<Function>();
+    CHECK(func.defined()) << "ValueError: " << func_name << " is not a Relax Function";
+    Function new_func = ActivationCheckpointer::Transform(mod, func.value(), memory_budget);
+    if (!new_func.same_as(func.value())) {
+      GlobalVar gvar = mod->GetGlobalVar(func_name);
+      mod.CopyOnWrite()->Update(gvar, new_func);
+    }
+    return mod;
+  };
+  return CreateModulePass(/*pass_function=*/pass_func,
+                          /*opt_level=*/0,
+                          /*pass_name=*/"CheckpointActivations",
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.CheckpointActivations")
+    .set_body_typed(CheckpointActivations);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
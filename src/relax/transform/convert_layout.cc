@@ -21,11 +21,16 @@
  * \brief Automatic layout conversion pass, especially for axis swapping.
  */
 
+#include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/nested_msg.h>
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "../op/tensor/manipulate.h"
 #include "infer_layout_utils.h"
 #include "utils.h"
@@ -71,11 +76,25 @@ using tir::Layout;
  *
  * Note that currently the layout conversion of conv2d only support axis swapping, such as NCHW to
  * NWHC. Packed layout such as NCHW to NCHW4c is not supported now.
+ *
+ * The ops with a desired layout are called anchors. An anchor in followed_anchors does not use its
+ * desired layout, but follows the layout of its inputs as when it has no desired layout. While
+ * rewriting, the mutator also accounts for the cost of the result, see Cost(), which is used by
+ * LayoutPlanner to choose the anchors to follow.
  */
 class LayoutConvertMutator : public ExprMutator {
  public:
-  explicit LayoutConvertMutator(const Map<String, Array<String>>& desired_layouts)
-      : desired_layouts_(desired_layouts) {}
+  explicit LayoutConvertMutator(const Map<String, Array<String>>& desired_layouts,
+                                std::unordered_set<Var> followed_anchors = {})
+      : desired_layouts_(desired_layouts), followed_anchors_(std::move(followed_anchors)) {}
+
+  /*!
+   * \brief The cost of the rewritten block: the number of elements of all the tensors transposed,
+   * except the constants which are folded at compile time, minus the number of elements of the
+   * outputs of the anchors in their desired layouts. The latter models that an anchor in its
+   * desired layout saves as much as transposing its output.
+   */
+  double Cost() const { return transpose_cost_ - anchor_gain_; }
 
  private:
   Array<Integer> LayoutToIntegers(const Layout& layout) {
@@ -99,6 +118,9 @@ class LayoutConvertMutator : public ExprMutator {
       ICHECK(tensor != nullptr) << "Expect a tensor, but got: " << expr;
       Layout axes = TransposeLike(InitialLayoutDecision(tensor->ndim)->layout,
                                   from.LeafValue()->layout, to.LeafValue()->layout);
+      if (!expr->IsInstance<ConstantNode>()) {
+        transpose_cost_ += NumElements(GetStructInfo(expr));
+      }
       return permute_dims(expr, LayoutToIntegers(axes));
     };
     return TransformTupleLeaf<LayoutDecision>(
@@ -180,8 +202,9 @@ class LayoutConvertMutator : public ExprMutator {
   }
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* call_node) final {
-    Optional<InferLayoutOutput> res =
-        GetInferLayoutInfo(call_node, desired_layouts_, var_layout_map_);
+    bool is_followed = followed_anchors_.count(binding->var);
+    Optional<InferLayoutOutput> res = GetInferLayoutInfo(
+        call_node, is_followed ? Map<String, Array<String>>() : desired_layouts_, var_layout_map_);
     ObjectPtr<CallNode> new_call = make_object<CallNode>(*call_node);
     new_call->struct_info_ = NullOpt;
     if (!res.defined() ||
@@ -206,6 +229,9 @@ class LayoutConvertMutator : public ExprMutator {
       new_call->args = std::move(new_args);
 
       new_call->attrs = std::move(res.value()->new_attrs);
+      if (!is_followed && !NoDesiredLayout(GetRef<Call>(call_node), desired_layouts_)) {
+        anchor_gain_ += NumElements(GetStructInfo(binding->var));
+      }
       Expr cur_call = builder_->Normalize(Call(new_call));
       if (binding->var->IsInstance<DataflowVarNode>()) {
         // Dataflow var, we emit the rewritten call.
@@ -296,22 +322,176 @@ class LayoutConvertMutator : public ExprMutator {
     }
   }
 
+  /*! \brief The number of elements of the tensors, where symbolic extents count as one. */
+  static double NumElements(const StructInfo& sinfo) {
+    if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+      double num_elements = 0;
+      for (const StructInfo& field : tuple->fields) {
+        num_elements += NumElements(field);
+      }
+      return num_elements;
+    }
+    const auto* tensor = sinfo.as<TensorStructInfoNode>();
+    if (tensor == nullptr || !tensor->shape.defined()) return 0;
+    const auto* shape = tensor->shape.value().as<ShapeExprNode>();
+    if (shape == nullptr) return 0;
+    double num_elements = 1;
+    for (const PrimExpr& extent : shape->values) {
+      if (const auto* imm = extent.as<IntImmNode>()) {
+        num_elements *= imm->value;
+      }
+    }
+    return num_elements;
+  }
+
   std::unordered_map<Var, NLayout> var_layout_map_;
   Map<String, Array<String>> desired_layouts_;
+  std::unordered_set<Var> followed_anchors_;
+  double transpose_cost_ = 0;
+  double anchor_gain_ = 0;
 };  // namespace relax
 
+/*!
+ * \brief Plan the layouts of a dataflow block globally, choosing the anchors to convert to their
+ * desired layouts so as to minimize LayoutConvertMutator::Cost.
+ *
+ * Converting an anchor alone pays for transposing its inputs and outputs, which chains of anchors
+ * connected through layout-following ops share. The anchors are therefore grouped into the
+ * connected components of the dataflow graph restricted to such ops, and a local search toggles
+ * first whole components, then single anchors between converted and followed, keeping every
+ * toggle that lowers the cost, until no toggle does. It starts from converting every anchor, the
+ * assignment of the plain pass, so that the plan is never more costly than it.
+ */
+class LayoutPlanner {
+ public:
+  static std::unordered_set<Var> Plan(const DataflowBlock& block,
+                                      const Map<String, Array<String>>& desired_layouts) {
+    LayoutPlanner planner(block, desired_layouts);
+    return planner.Run();
+  }
+
+ private:
+  LayoutPlanner(const DataflowBlock& block, const Map<String, Array<String>>& desired_layouts)
+      : block_(block), desired_layouts_(desired_layouts) {}
+
+  /*! \brief The maximum number of rounds of the local search. */
+  static constexpr int kMaxRounds = 4;
+
+  const VarNode* FindRoot(const VarNode* var) {
+    auto it = parent_.find(var);
+    if (it == parent_.end() || it->second == var) return var;
+    return it->second = FindRoot(it->second);
+  }
+
+  void Union(const VarNode* a, const VarNode* b) { parent_[FindRoot(a)] = FindRoot(b); }
+
+  /*! \brief Group the anchors into components connected through layout-following ops. */
+  std::vector<std::vector<Var>> GroupAnchors() {
+    const auto& infer_layout_map = Op::GetAttrMap<FRelaxInferLayout>("FRelaxInferLayout");
+    std::vector<Var> anchors;
+    for (const Binding& binding : block_->bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      if (var_binding == nullptr) continue;
+      const VarNode* var = binding->var.get();
+      parent_[var] = var;
+      Array<Expr> args;
+      if (const auto* call = var_binding->value.as<CallNode>()) {
+        const auto* op = call->op.as<OpNode>();
+        if (op == nullptr || !infer_layout_map.count(GetRef<Op>(op))) continue;
+        if (!NoDesiredLayout(GetRef<Call>(call), desired_layouts_)) {
+          anchors.push_back(binding->var);
+        }
+        args = call->args;
+      } else if (const auto* tuple = var_binding->value.as<TupleNode>()) {
+        args = tuple->fields;
+      } else if (const auto* get_item = var_binding->value.as<TupleGetItemNode>()) {
+        args = {get_item->tuple};
+      }
+      for (const Var& used : FreeVars(Tuple(args))) {
+        if (parent_.count(used.get())) Union(var, used.get());
+      }
+    }
+    std::unordered_map<const VarNode*, size_t> component_index;
+    std::vector<std::vector<Var>> components;
+    for (const Var& anchor : anchors) {
+      const VarNode* root = FindRoot(anchor.get());
+      auto it = component_index.find(root);
+      if (it == component_index.end()) {
+        it = component_index.emplace(root, components.size()).first;
+        components.emplace_back();
+      }
+      components[it->second].push_back(anchor);
+    }
+    return components;
+  }
+
+  double Evaluate(const std::unordered_set<Var>& followed) {
+    LayoutConvertMutator mutator(desired_layouts_, followed);
+    mutator.VisitBindingBlock(block_);
+    return mutator.Cost();
+  }
+
+  std::unordered_set<Var> Run() {
+    std::vector<std::vector<Var>> moves = GroupAnchors();
+    std::unordered_set<Var> followed;
+    if (moves.empty()) return followed;
+    size_t num_components = moves.size();
+    for (size_t i = 0; i < num_components; ++i) {
+      if (moves[i].size() > 1) {
+        for (const Var& anchor : moves[i]) {
+          moves.push_back({anchor});
+        }
+      }
+    }
+    double best = Evaluate(followed);
+    bool improved = true;
+    for (int round = 0; round < kMaxRounds && improved; ++round) {
+      improved = false;
+      for (const std::vector<Var>& move : moves) {
+        // Toggle the anchors of the move as a whole, and revert unless the cost is lowered
+        bool follow = !followed.count(move[0]);
+        std::unordered_set<Var> toggled = followed;
+        for (const Var& anchor : move) {
+          if (follow) {
+            toggled.insert(anchor);
+          } else {
+            toggled.erase(anchor);
+          }
+        }
+        double cost = Evaluate(toggled);
+        if (cost < best) {
+          best = cost;
+          followed = std::move(toggled);
+          improved = true;
+        }
+      }
+    }
+    return followed;
+  }
+
+  DataflowBlock block_;
+  Map<String, Array<String>> desired_layouts_;
+  std::unordered_map<const VarNode*, const VarNode*> parent_;
+};
+
 DataflowBlock ConvertLayoutPass(const DataflowBlock& df_block,
-                                Map<String, Array<String>> desired_layouts) {
-  LayoutConvertMutator mutator(desired_layouts);
+                                Map<String, Array<String>> desired_layouts,
+                                bool minimize_transposes) {
+  std::unordered_set<Var> followed_anchors;
+  if (minimize_transposes) {
+    followed_anchors = LayoutPlanner::Plan(df_block, desired_layouts);
+  }
+  LayoutConvertMutator mutator(desired_layouts, std::move(followed_anchors));
   return Downcast<DataflowBlock>(mutator.VisitBindingBlock(df_block));
 }
 
 namespace transform {
 
-Pass ConvertLayout(Map<String, Array<String>> desired_layouts) {
+Pass ConvertLayout(Map<String, Array<String>> desired_layouts, bool minimize_transposes) {
   runtime::TypedPackedFunc<DataflowBlock(DataflowBlock, IRModule, PassContext)> pass_func =
       [=](DataflowBlock df_block, IRModule m, PassContext pc) {
-        return Downcast<DataflowBlock>(ConvertLayoutPass(df_block, desired_layouts));
+        return Downcast<DataflowBlock>(
+            ConvertLayoutPass(df_block, desired_layouts, minimize_transposes));
       };
   return CreateDataflowBlockPass(pass_func, 0, "ConvertLayout", {});
 }
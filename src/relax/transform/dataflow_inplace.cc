@@ -19,8 +19,8 @@
  */
 /*!
  * \file src/relax/transform/dataflow_inplace.cc
- * \brief Pass that converts eligible operator calls in dataflow blocks
- *   into in-place versions.
+ * \brief Passes that convert eligible operator calls in dataflow blocks,
+ *   or across whole functions, into in-place versions.
  */
 
 #include <tvm/ir/transform.h>
@@ -30,24 +30,40 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/utils.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "utils.h"
 
 namespace tvm {
 namespace relax {
 
-// Perform liveness analysis on a dataflow block, returning a map of vars to
+// Perform liveness analysis on a sequence of bindings, returning a map of vars to
 // pairs of indices (the liveness interval, from the starting index to the end index).
-// A starting index of -1 means the var is defined before the block starts and an end index
-// of block->bindings.size() (one past the last index) means it is live after the block ends.
-std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock& block) {
+// A starting index of -1 means the var is defined before the bindings start and an end index
+// of bindings.size() (one past the last index) means it is live after the bindings end,
+// as decided by `is_live_after`.
+std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(
+    const Array<Binding>& bindings, const std::function<bool(const Var&)>& is_live_after) {
+  static const Op& mem_kill_tensor_op = Op::Get("relax.memory.kill_tensor");
+  static const Op& mem_kill_storage_op = Op::Get("relax.memory.kill_storage");
+  static const Op& vm_kill_object_op = Op::Get("relax.vm.kill_object");
   std::unordered_map<Var, std::pair<int, int>> ret;
-  for (int i = block->bindings.size() - 1; i >= 0; i--) {
-    Binding b = block->bindings[i];
+  for (int i = bindings.size() - 1; i >= 0; i--) {
+    Binding b = bindings[i];
     Var defined_var = b->var;
     Expr value = GetBoundValue(b);
     Array<Var> used_vars;
+    const auto* call_node = value.as<CallNode>();
     // for a function literal, we consider only the free vars
     // (those captured from the outer scope)
     if (value.as<FunctionNode>()) {
@@ -58,16 +74,19 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
       // create tuples to be done in-place (otherwise, any index of the tuple
       // would be considered a use and so the tuple would be live later).
       // Hence we keep the array empty.
+    } else if (call_node && (call_node->op.same_as(mem_kill_tensor_op) ||
+                             call_node->op.same_as(mem_kill_storage_op) ||
+                             call_node->op.same_as(vm_kill_object_op))) {
+      // The kill points inserted by KillAfterLastUse only drop the reference held by the
+      // var, so they are not a use of its memory.
     } else {
       used_vars = AllVars(value);
     }
 
     for (auto var : used_vars) {
       int range_end = i;
-      // if the var is not a dataflow var, then it is live
-      // after the block (we are not checking later blocks)
-      if (!var.as<DataflowVarNode>()) {
-        range_end = block->bindings.size();
+      if (is_live_after(var)) {
+        range_end = bindings.size();
       }
       if (!ret.count(var)) {
         ret[var] = {-1, range_end};
@@ -75,9 +94,8 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
     }
 
     if (!ret.count(defined_var)) {
-      // if it's an output, then it lives past the end of the block
-      if (!defined_var.as<DataflowVarNode>()) {
-        ret[defined_var] = {i, block->bindings.size()};
+      if (is_live_after(defined_var)) {
+        ret[defined_var] = {i, bindings.size()};
       } else {
         // otherwise, it's live only here
         ret[defined_var] = {i, i};
@@ -93,6 +111,18 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
   return ret;
 }
 
+// Perform liveness analysis on a dataflow block, where the non-dataflow vars are live
+// after the block (we are not checking later blocks).
+std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock& block) {
+  return AnalyzeLiveness(block->bindings,
+                         [](const Var& var) { return !var.as<DataflowVarNode>(); });
+}
+
+// the ops whose results may share memory with their arguments
+static std::unordered_set<std::string> ALIASING_OPS = {"relax.reshape", "relax.memory.view",
+                                                       "relax.call_tir_inplace",
+                                                       "relax.call_inplace_packed"};
+
 class AliasAnalyzer {
  public:
   AliasAnalyzer() : alias_map_(), tuple_map_(), mem_idx_(0) {}
@@ -105,6 +135,12 @@ class AliasAnalyzer {
   std::pair<std::unordered_map<Var, std::unordered_set<int>>,
             std::unordered_map<int, std::vector<std::unordered_set<int>>>>
   Analyze(const DataflowBlock& block, const Array<Var>& inputs) {
+    return Analyze(block->bindings, inputs);
+  }
+
+  std::pair<std::unordered_map<Var, std::unordered_set<int>>,
+            std::unordered_map<int, std::vector<std::unordered_set<int>>>>
+  Analyze(const Array<Binding>& bindings, const Array<Var>& inputs) {
     for (auto input : inputs) {
       int curr_idx = get_fresh_idx();
       alias_map_[input] = {curr_idx};
@@ -113,7 +149,7 @@ class AliasAnalyzer {
       }
     }
 
-    for (const Binding& binding : block->bindings) {
+    for (const Binding& binding : bindings) {
       Var current_var = binding->var;
       Expr value = GetBoundValue(binding);
       alias_map_[current_var] = GetAliasSet(value, current_var);
@@ -206,6 +242,24 @@ class AliasAnalyzer {
     return ret;
   }
 
+  // Conservative assumption for values with nested scopes (if-expressions, closures):
+  // the result may be a fresh value or an alias of any var they capture from the outer scope.
+  std::unordered_set<int> HandleNestedScope(const Expr& value, const Var& bound_var) {
+    std::unordered_set<int> ret;
+    int res_idx = get_fresh_idx();
+    if (auto* tup_info_node = GetStructInfoAs<TupleStructInfoNode>(bound_var)) {
+      InsertFreshTuple(res_idx, tup_info_node);
+    }
+    AddCapturedIndices(&ret, res_idx);
+    for (const Var& free_var : FreeVars(value)) {
+      for (int alias_idx : GetAliasSet(free_var, bound_var)) {
+        AddCapturedIndices(&ret, alias_idx);
+      }
+    }
+    UpdateTupleComponents(res_idx, ret);
+    return ret;
+  }
+
   // given the expression value, return the set of memory locations corresponding to it
   // (the var the expression is being bound to is needed for struct info)
   std::unordered_set<int> GetAliasSet(const Expr& value, const Var& bound_var) {
@@ -222,9 +276,11 @@ class AliasAnalyzer {
     // function constant: give them a fresh index (TODO: we can handle in more detail if this is a
     // case we need to support) prim value: fresh index if node: should not happen inside dataflow
     // block
-    if (value.as<ConstantNode>() || value.as<PrimValueNode>() || value.as<FunctionNode>()) {
-      // TODO(@slyubomirsky): We will probably want special handling for closures
+    if (value.as<ConstantNode>() || value.as<PrimValueNode>()) {
       ret.insert(get_fresh_idx());
+    } else if (value.as<FunctionNode>() || value.as<IfNode>() || value.as<SeqExprNode>()) {
+      // a closure may read the values it captures whenever it is called
+      return HandleNestedScope(value, bound_var);
     } else if (auto* target_var_node = value.as<VarNode>()) {
       auto target_var = GetRef<Var>(target_var_node);
       if (alias_map_.count(target_var)) {
@@ -263,6 +319,9 @@ class AliasAnalyzer {
         // call_pure_packed: treat as non-op call
         if (op_node->name == "relax.call_pure_packed") {
           return HandleMysteryCall(call_node, bound_var, true);
+        } else if (ALIASING_OPS.count(op_node->name)) {
+          // views and in-place calls: the result shares memory with the arguments
+          return HandleMysteryCall(call_node, bound_var);
         } else if (op_node->name == "relax.call_tir") {
           // call_tir: can potentially return a tuple
           if (auto* tuple_struct_info = call_node->sinfo_args[0].as<TupleStructInfoNode>()) {
@@ -547,25 +606,174 @@ class InplaceOpportunity : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(InplaceOpportunity, ObjectRef, InplaceOpportunityNode);
 };
 
+// Check whether a PrimFunc reads its input at `input_idx` only at the element it writes to its
+// output at `output_idx`, right before writing it, so that the output can be written over the
+// input. This holds for the elementwise PrimFuncs: a single store of the output in a block of
+// data-parallel iter vars, indexed by those iter vars, whose value is the only reader of the input,
+// at the indices of the store.
+bool IsElementwiseWrt(const tir::PrimFunc& func, int input_idx, int output_idx) {
+  class ElementwiseChecker : public tir::StmtExprVisitor {
+   public:
+    ElementwiseChecker(const tir::Buffer& input, const tir::Buffer& output)
+        : input_(input), output_(output) {}
+
+    bool Check(const tir::Stmt& body) {
+      VisitStmt(body);
+      return ok_ && store_indices_.defined();
+    }
+
+   private:
+    void VisitStmt_(const tir::BlockNode* op) final {
+      for (const tir::MatchBufferRegion& match_buffer : op->match_buffers) {
+        if (IsCheckedBuffer(match_buffer->source->buffer)) {
+          ok_ = false;
+        }
+      }
+      const tir::BlockNode* outer_block = block_;
+      block_ = op;
+      tir::StmtExprVisitor::VisitStmt_(op);
+      block_ = outer_block;
+    }
+
+    void VisitStmt_(const tir::DeclBufferNode* op) final {
+      if (IsCheckedBuffer(op->buffer)) {
+        ok_ = false;
+      }
+      tir::StmtExprVisitor::VisitStmt_(op);
+    }
+
+    void VisitStmt_(const tir::BufferStoreNode* op) final {
+      if (op->buffer.same_as(input_) || (op->buffer.same_as(output_) && store_indices_.defined())) {
+        ok_ = false;
+        return;
+      }
+      if (!op->buffer.same_as(output_)) {
+        tir::StmtExprVisitor::VisitStmt_(op);
+        return;
+      }
+      // every element is written once, by a distinct instance of a data-parallel block
+      if (block_ == nullptr || block_->iter_vars.size() != op->indices.size()) {
+        ok_ = false;
+        return;
+      }
+      std::unordered_set<const tir::VarNode*> iter_vars;
+      for (const tir::IterVar& iter_var : block_->iter_vars) {
+        if (iter_var->iter_type != tir::kDataPar) {
+          ok_ = false;
+          return;
+        }
+        iter_vars.insert(iter_var->var.get());
+      }
+      for (const PrimExpr& index : op->indices) {
+        const auto* index_var = index.as<tir::VarNode>();
+        if (index_var == nullptr || !iter_vars.erase(index_var)) {
+          ok_ = false;
+          return;
+        }
+      }
+      store_indices_ = op->indices;
+      in_store_value_ = true;
+      VisitExpr(op->value);
+      in_store_value_ = false;
+    }
+
+    void VisitExpr_(const tir::BufferLoadNode* op) final {
+      if (op->buffer.same_as(output_)) {
+        ok_ = false;
+        return;
+      }
+      if (op->buffer.same_as(input_)) {
+        if (!in_store_value_ || op->indices.size() != store_indices_.size()) {
+          ok_ = false;
+          return;
+        }
+        for (size_t i = 0; i < op->indices.size(); i++) {
+          if (!op->indices[i].same_as(store_indices_[i])) {
+            ok_ = false;
+            return;
+          }
+        }
+      }
+      tir::StmtExprVisitor::VisitExpr_(op);
+    }
+
+    void VisitExpr_(const tir::VarNode* op) final {
+      // the data pointers may only be accessed through the buffers
+      if (op == input_->data.get() || op == output_->data.get()) {
+        ok_ = false;
+      }
+    }
+
+    bool IsCheckedBuffer(const tir::Buffer& buffer) {
+      return buffer->data.same_as(input_->data) || buffer->data.same_as(output_->data);
+    }
+
+    const tir::Buffer& input_;
+    const tir::Buffer& output_;
+    const tir::BlockNode* block_ = nullptr;
+    Array<PrimExpr> store_indices_{nullptr};
+    bool in_store_value_ = false;
+    bool ok_ = true;
+  };
+
+  if (input_idx >= static_cast<int>(func->params.size()) ||
+      output_idx >= static_cast<int>(func->params.size())) {
+    return false;
+  }
+  auto input = func->buffer_map.Get(func->params[input_idx]);
+  auto output = func->buffer_map.Get(func->params[output_idx]);
+  if (!input.defined() || !output.defined() || input.value()->dtype != output.value()->dtype) {
+    return false;
+  }
+  return ElementwiseChecker(input.value(), output.value()).Check(func->body);
+}
+
+// Check whether the struct info is a tensor of static shape and known dtype, as needed to
+// declare the buffers of the in-place wrapper of a packed function.
+bool IsStaticTensor(const StructInfo& sinfo) {
+  const auto* tensor_info = sinfo.as<TensorStructInfoNode>();
+  if (!tensor_info || tensor_info->dtype.is_void()) {
+    return false;
+  }
+  const auto* shape = tensor_info->shape.as<ShapeExprNode>();
+  if (!shape) {
+    return false;
+  }
+  for (const PrimExpr& dim : shape->values) {
+    if (!dim.as<IntImmNode>()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Check for in-place eligibility:
 //  1. see if there's an arg big enough to hold the result
 //  2. see if the arg is live past the call
 //  3. see if the arg has an alias that's live past the call
 // If the conditions are met, record the index of that binding.
+// Besides the supported ops, the eligible calls are `call_tir` of elementwise PrimFuncs and
+// `call_dps_packed` of the packed functions in `inplace_packed_funcs`, for the arguments that
+// match the shape of the result exactly (as required by `call_tir_inplace`).
 // Returns two lists of lists:
 // 1. A list of bindings where at least one argument meets the in-place conditions and the *size*
 //    matches the size of the result.
 // 2. A list of bindings where at least one argument meets the in-place conditions
 //    and *exactly* matches the shape of the result.
 // For both lists, each element is a list of ints of the following format:
-//   The first element is the index of the *binding* in the block.
-//   All remaining elements are the indices of *eligible arguments* in that call.
+//   The first element is the index of the *binding* in the bindings.
+//   All remaining elements are the indices of *eligible arguments* in that call
+//   (for call_tir and call_dps_packed, the indices in the tuple of arguments).
 std::pair<std::vector<InplaceOpportunity>, std::vector<InplaceOpportunity>>
-FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
-                         const BlockBuilder& ctx) {
-  auto live_ranges = AnalyzeLiveness(block);
+FindInplaceOpportunities(const Array<Binding>& bindings, const Array<Var>& inputs,
+                         const BlockBuilder& ctx,
+                         const std::function<bool(const Var&)>& is_live_after,
+                         const Array<String>& inplace_packed_funcs = {}) {
+  static const Op& call_tir_op = Op::Get("relax.call_tir");
+  static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+  auto live_ranges = AnalyzeLiveness(bindings, is_live_after);
   AliasAnalyzer analyzer;
-  auto alias_info = analyzer.Analyze(block, inputs);
+  auto alias_info = analyzer.Analyze(bindings, inputs);
   auto alias_sets = alias_info.first;
   auto tuple_map = alias_info.second;
 
@@ -582,10 +790,35 @@ FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
               return live_ranges[var1].first < live_ranges[var2].first;
             });
 
+  // whether another argument may share memory with the given one, which the callee could read
+  // after it is overwritten
+  auto f_aliased_by_other_arg = [&alias_sets](const Array<Expr>& args, int idx) -> bool {
+    const auto* target = args[idx].as<VarNode>();
+    if (!target || !alias_sets.count(GetRef<Var>(target))) {
+      return true;
+    }
+    const auto& target_aliases = alias_sets.at(GetRef<Var>(target));
+    for (int i = 0; i < static_cast<int>(args.size()); i++) {
+      const auto* other = args[i].as<VarNode>();
+      if (i == idx || !other || other == target) {
+        continue;
+      }
+      if (!alias_sets.count(GetRef<Var>(other))) {
+        return true;
+      }
+      for (int alias_idx : alias_sets.at(GetRef<Var>(other))) {
+        if (target_aliases.count(alias_idx)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+
   std::unordered_set<Var> currently_live;
   int last_live = 0;
 
-  for (size_t i = 0; i < block->bindings.size(); i++) {
+  for (size_t i = 0; i < bindings.size(); i++) {
     // include all vars that are currently live
     for (int j = last_live; j < static_cast<int>(live_order.size()); j++) {
       auto live_var = live_order[j];
@@ -610,87 +843,146 @@ FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
     }
 
     // if we reach a binding check the conditions
-    Binding b = block->bindings[i];
+    Binding b = bindings[i];
     Var defined_var = b->var;
     Expr value = GetBoundValue(b);
 
-    if (auto* call_node = value.as<CallNode>()) {
-      if (auto* op_node = call_node->op.as<OpNode>()) {
-        if (!OpSupportsInplace(GetRef<Op>(op_node))) {
-          continue;
+    auto* call_node = value.as<CallNode>();
+    auto* op_node = call_node ? call_node->op.as<OpNode>() : nullptr;
+    if (!op_node) {
+      continue;
+    }
+    // the arguments that may be written over
+    Array<Expr> call_args;
+    // the kind-specific check of an argument, for the DPS calls
+    std::function<bool(int)> f_arg_eligible = nullptr;
+    if (OpSupportsInplace(GetRef<Op>(op_node))) {
+      call_args = call_node->args;
+    } else if (call_node->op.same_as(call_tir_op) && call_node->args[1].as<TupleNode>() &&
+               call_node->sinfo_args[0].as<TensorStructInfoNode>()) {
+      auto gv = Downcast<GlobalVar>(call_node->args[0]);
+      auto opt_func = ctx->GetContextIRModule()->functions.Get(gv);
+      if (!opt_func || !opt_func.value().as<tir::PrimFuncNode>()) {
+        continue;
+      }
+      auto func = Downcast<tir::PrimFunc>(opt_func.value());
+      call_args = Downcast<Tuple>(call_node->args[1])->fields;
+      int output_idx = call_args.size();
+      f_arg_eligible = [func, output_idx, &call_args, &f_aliased_by_other_arg](int j) {
+        if (f_aliased_by_other_arg(call_args, j)) {
+          return false;
+        }
+        // the other occurrences of the same var are overwritten as well
+        for (int k = 0; k < static_cast<int>(call_args.size()); k++) {
+          if (call_args[k].same_as(call_args[j]) && !IsElementwiseWrt(func, k, output_idx)) {
+            return false;
+          }
         }
+        return true;
+      };
+    } else if (call_node->op.same_as(call_dps_packed_op) && call_node->args[1].as<TupleNode>() &&
+               call_node->sinfo_args[0].as<TensorStructInfoNode>()) {
+      auto* extern_func = call_node->args[0].as<ExternFuncNode>();
+      if (!extern_func ||
+          std::find(inplace_packed_funcs.begin(), inplace_packed_funcs.end(),
+                    extern_func->global_symbol) == inplace_packed_funcs.end()) {
+        continue;
+      }
+      call_args = Downcast<Tuple>(call_node->args[1])->fields;
+      bool all_static = IsStaticTensor(call_node->sinfo_args[0]);
+      for (const Expr& arg : call_args) {
+        all_static = all_static && IsStaticTensor(GetStructInfo(arg));
+      }
+      if (!all_static) {
+        continue;
+      }
+      f_arg_eligible = [&call_args, &f_aliased_by_other_arg](int j) {
+        return !f_aliased_by_other_arg(call_args, j);
+      };
+    } else {
+      continue;
+    }
 
-        std::unordered_set<int> candidates;
-        std::unordered_set<int> exact_match_candidates;
+    std::unordered_set<int> candidates;
+    std::unordered_set<int> exact_match_candidates;
 
-        auto target_sinfo = GatherCandidateSinfo(GetStructInfo(defined_var));
-        // can't be done in-place, ignore
-        if (target_sinfo.empty()) {
-          continue;
-        }
+    auto target_sinfo = GatherCandidateSinfo(GetStructInfo(defined_var));
+    // can't be done in-place, ignore
+    if (target_sinfo.empty()) {
+      continue;
+    }
 
-        // Check that at least one argument matches size with the result
-        for (size_t j = 0; j < call_node->args.size(); j++) {
-          auto arg = call_node->args[j];
-          for (auto target : target_sinfo) {
-            auto [matches_size, matches_exactly] = SizeMatches(target, GetStructInfo(arg), ctx);
-            if (matches_size) {
-              candidates.insert(static_cast<int>(j));
-              if (matches_exactly) {
-                exact_match_candidates.insert(static_cast<int>(j));
-              }
-            }
+    // Check that at least one argument matches size with the result
+    for (size_t j = 0; j < call_args.size(); j++) {
+      auto arg = call_args[j];
+      for (auto target : target_sinfo) {
+        auto [matches_size, matches_exactly] = SizeMatches(target, GetStructInfo(arg), ctx);
+        // the DPS calls can only be made in-place for exact matches
+        if (matches_size && (matches_exactly || f_arg_eligible == nullptr)) {
+          candidates.insert(static_cast<int>(j));
+          if (matches_exactly) {
+            exact_match_candidates.insert(static_cast<int>(j));
           }
         }
-        if (candidates.empty()) {
-          continue;
-        }
+      }
+    }
+    if (candidates.empty()) {
+      continue;
+    }
 
-        // Make sure at least one candidate is not live past this point and does not have an alias
-        // live past this point
-        std::unordered_set<int> remove_candidates;
-        for (auto candidate : candidates) {
-          if (!InplaceConditionsMet(live_ranges, alias_sets, tuple_map, currently_live,
-                                    call_node->args[candidate], i)) {
-            remove_candidates.insert(candidate);
-          }
-        }
-        // (remove now to avoid modifying the list as we iterate on it)
-        for (auto candidate : remove_candidates) {
-          candidates.erase(candidate);
-        }
+    // Make sure at least one candidate is not live past this point and does not have an alias
+    // live past this point
+    std::unordered_set<int> remove_candidates;
+    for (auto candidate : candidates) {
+      if (!InplaceConditionsMet(live_ranges, alias_sets, tuple_map, currently_live,
+                                call_args[candidate], i) ||
+          (f_arg_eligible != nullptr && !f_arg_eligible(candidate))) {
+        remove_candidates.insert(candidate);
+      }
+    }
+    // (remove now to avoid modifying the list as we iterate on it)
+    for (auto candidate : remove_candidates) {
+      candidates.erase(candidate);
+    }
 
-        // if we have a candidate, then this can be made in-place. Report the appropriate candidates
-        if (candidates.empty()) {
-          continue;
-        }
+    // if we have a candidate, then this can be made in-place. Report the appropriate candidates
+    if (candidates.empty()) {
+      continue;
+    }
 
-        // produce a list of candidates for this index
-        Array<Integer> size_candidate_list;
-        for (auto candidate : candidates) {
-          size_candidate_list.push_back(Integer(candidate));
-        }
-        size_match_list.push_back(InplaceOpportunity(Integer(i), size_candidate_list));
+    // produce a list of candidates for this index
+    Array<Integer> size_candidate_list;
+    for (auto candidate : candidates) {
+      size_candidate_list.push_back(Integer(candidate));
+    }
+    size_match_list.push_back(InplaceOpportunity(Integer(i), size_candidate_list));
 
-        // also gather up the exact match candidates if there are any
-        Array<Integer> exact_candidate_list;
-        for (auto candidate : candidates) {
-          if (!exact_match_candidates.count(candidate)) {
-            continue;
-          }
-          exact_candidate_list.push_back(Integer(candidate));
-        }
-        if (exact_candidate_list.empty()) {
-          continue;
-        }
-        exact_match_list.push_back(InplaceOpportunity(Integer(i), exact_candidate_list));
+    // also gather up the exact match candidates if there are any
+    Array<Integer> exact_candidate_list;
+    for (auto candidate : candidates) {
+      if (!exact_match_candidates.count(candidate)) {
+        continue;
       }
+      exact_candidate_list.push_back(Integer(candidate));
     }
+    if (exact_candidate_list.empty()) {
+      continue;
+    }
+    exact_match_list.push_back(InplaceOpportunity(Integer(i), exact_candidate_list));
   }
 
   return {size_match_list, exact_match_list};
 }
 
+// Find the in-place opportunities in a dataflow block, see above.
+std::pair<std::vector<InplaceOpportunity>, std::vector<InplaceOpportunity>>
+FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
+                         const BlockBuilder& ctx, const Array<String>& inplace_packed_funcs = {}) {
+  return FindInplaceOpportunities(
+      block->bindings, inputs, ctx, [](const Var& var) { return !var.as<DataflowVarNode>(); },
+      inplace_packed_funcs);
+}
+
 // Replace buffers in a PrimFunc according to the mapping.
 tir::Stmt RemapBuffers(const tir::Stmt& stmt, const Map<tir::Buffer, tir::Buffer>& buffer_map) {
   class BufferMapper : public tir::StmtExprMutator {
@@ -771,9 +1063,119 @@ tir::Stmt RemapBuffers(const tir::Stmt& stmt, const Map<tir::Buffer, tir::Buffer
   return ret;
 }
 
+// Make a PrimFunc write its outputs over the inputs given by the in-place indices, removing the
+// parameters of those outputs. The parameters are the `num_inputs` inputs, then the outputs
+// (one per in-place index), then possibly the symbolic vars.
+tir::PrimFunc MakeInplacePrimFunc(const tir::PrimFunc& old_primfunc, size_t num_inputs,
+                                  const Array<Integer>& inplace_indices) {
+  tir::Stmt new_body = old_primfunc->body;
+
+  size_t num_outs = inplace_indices.size();
+
+  // the replacement we must make:
+  // 1. For each output var, replace its corresponding buffers with the corresponding inplace
+  // index
+  //    var's buffers
+  // 2. For each output var, replace its instances with the corresponding inplace index var
+  // 3. Do the same for the *buffer vars* corresponding to the output vars
+  // 4. Remove the output vars from the param list and buffer map
+  Map<tir::Buffer, tir::Buffer> buffer_subst_map;
+  Map<tir::Var, tir::Var> var_subst_map;
+  for (size_t i = 0; i < num_outs; i++) {
+    if (inplace_indices[i].IntValue() == -1) {
+      continue;
+    }
+    // we will substitute output i with the corresponding param indicated by inplace indices
+    auto output_var = old_primfunc->params[num_inputs + i];
+    auto inplace_var = old_primfunc->params[inplace_indices[i].IntValue()];
+    var_subst_map.Set(output_var, inplace_var);
+
+    // also do the same with the buffer vars
+    auto output_buffer = old_primfunc->buffer_map.at(output_var);
+    auto inplace_buffer = old_primfunc->buffer_map.at(inplace_var);
+    var_subst_map.Set(output_buffer->data, inplace_buffer->data);
+    buffer_subst_map.Set(output_buffer, inplace_buffer);
+  }
+
+  // apply substitutions
+  new_body = RemapBuffers(new_body, buffer_subst_map);
+  new_body = tir::Substitute(new_body, [&var_subst_map](const tir::Var& v) -> Optional<PrimExpr> {
+    if (var_subst_map.count(v)) {
+      return var_subst_map.at(v);
+    }
+    return Optional<PrimExpr>();
+  });
+
+  // remove the now-unused outputs from the buffer map and the params
+  // (couldn't do earlier or else it would have thrown off the indexing)
+  auto new_buffer_map = old_primfunc->buffer_map;
+  Array<tir::Var> new_params;
+  for (size_t i = 0; i < old_primfunc->params.size(); i++) {
+    const tir::Var& param = old_primfunc->params[i];
+    if (i >= num_inputs && i < num_inputs + num_outs &&
+        inplace_indices[i - num_inputs].IntValue() != -1) {
+      new_buffer_map.erase(param);
+      continue;
+    }
+    new_params.push_back(param);
+  }
+
+  // the in-place version is an internal function, even if the original one is exposed
+  DictAttrs new_attrs = old_primfunc->attrs;
+  if (new_attrs.defined()) {
+    Map<String, ObjectRef> attr_dict = new_attrs->dict;
+    attr_dict.erase(tvm::attr::kGlobalSymbol);
+    new_attrs = DictAttrs(attr_dict);
+  }
+
+  return tir::PrimFunc(new_params, new_body, old_primfunc->ret_type, new_buffer_map, new_attrs,
+                       old_primfunc->span);
+}
+
+// Make a PrimFunc calling a packed function in destination-passing style with every argument,
+// passing the argument at `inplace_index` as the output. The arguments must be tensors of static
+// shapes, see IsStaticTensor.
+tir::PrimFunc MakeInplacePackedWrapper(const String& global_symbol, const Array<Expr>& args,
+                                       int inplace_index) {
+  Array<tir::Var> params;
+  Map<tir::Var, tir::Buffer> buffer_map;
+  Array<PrimExpr> packed_args = {tir::StringImm(global_symbol)};
+  auto f_pack_buffer = [](const tir::Buffer& buffer) -> PrimExpr {
+    // same as `tvm.tir.call_packed` for buffer arguments
+    PrimExpr shape = tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_shape(),
+                               buffer->shape);
+    return tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_array(),
+                     {buffer->data, shape, IntImm(DataType::Int(32), 0),
+                      IntImm(DataType::Int(32), buffer->shape.size()),
+                      tir::make_zero(buffer->dtype), buffer->elem_offset});
+  };
+  for (size_t i = 0; i < args.size(); i++) {
+    auto* tensor_info = GetStructInfoAs<TensorStructInfoNode>(args[i]);
+    ICHECK(tensor_info);
+    std::string name = "arg" + std::to_string(i);
+    tir::Var param(name, DataType::Handle());
+    tir::Buffer buffer = tir::decl_buffer(Downcast<ShapeExpr>(tensor_info->shape)->values,
+                                          tensor_info->dtype, name);
+    params.push_back(param);
+    buffer_map.Set(param, buffer);
+    packed_args.push_back(f_pack_buffer(buffer));
+  }
+  packed_args.push_back(f_pack_buffer(buffer_map.at(params[inplace_index])));
+  tir::Stmt body = tir::Evaluate(
+      tir::Call(DataType::Int(32), tir::builtin::tvm_call_packed(), packed_args));
+  return tir::PrimFunc(params, body, VoidType(), buffer_map);
+}
+
 class ModuleInplaceTransformer : public ExprMutator {
  public:
-  explicit ModuleInplaceTransformer(const IRModule& mod) : mod_(mod) {
+  // In the whole-function mode, the calls are made in-place in every binding block of the
+  // functions, with the liveness and aliases analyzed across the bindings of each sequence
+  // expression. Otherwise, only the dataflow blocks are considered, one at a time.
+  explicit ModuleInplaceTransformer(const IRModule& mod, bool whole_function = false,
+                                    Array<String> inplace_packed_funcs = {})
+      : mod_(mod),
+        whole_function_(whole_function),
+        inplace_packed_funcs_(std::move(inplace_packed_funcs)) {
     builder_ = BlockBuilder::Create(mod);
   }
 
@@ -804,16 +1206,47 @@ class ModuleInplaceTransformer : public ExprMutator {
     return ret;
   }
 
+  Expr VisitExpr_(const SeqExprNode* op) override {
+    if (!whole_function_) {
+      return ExprMutator::VisitExpr_(op);
+    }
+    Array<Binding> bindings;
+    std::unordered_set<Var> defined_vars;
+    for (const BindingBlock& block : op->blocks) {
+      for (const Binding& binding : block->bindings) {
+        bindings.push_back(binding);
+        defined_vars.insert(binding->var);
+      }
+    }
+    // The vars used by the result of the sequence, and those defined outside of it (which may be
+    // used after it), are live after the bindings.
+    Array<Var> body_vars = FreeVars(op->body);
+    std::unordered_set<Var> live_after(body_vars.begin(), body_vars.end());
+    auto is_live_after = [&live_after, &defined_vars](const Var& var) {
+      return live_after.count(var) || !defined_vars.count(var);
+    };
+    // Note: Not passing any input values, as we can't make any assumptions about them.
+    auto matches_found =
+        FindInplaceOpportunities(bindings, {}, builder_, is_live_after, inplace_packed_funcs_);
+    for (auto match : matches_found.second) {
+      inplace_idxs.Set(bindings[match->binding_idx.IntValue()], match->arg_idxs);
+    }
+    return ExprMutator::VisitExpr_(op);
+  }
+
   // the only case we will override: we will visit all binding blocks
   // and replace any valid calls in them
   BindingBlock VisitBindingBlock_(const DataflowBlockNode* op) override {
+    if (whole_function_) {
+      return ExprMutator::VisitBindingBlock_(op);
+    }
     auto block = GetRef<DataflowBlock>(op);
     auto old_idxs = inplace_idxs;
 
     // For now, only handle exact match cases.
     // Note: Not passing any input values for now, as we can't make any assumptions
     // about them.
-    auto matches_found = FindInplaceOpportunities(block, {}, builder_);
+    auto matches_found = FindInplaceOpportunities(block, {}, builder_, inplace_packed_funcs_);
     Map<Binding, Array<Integer>> new_idxs;
     for (auto match : matches_found.second) {
       new_idxs.Set(block->bindings[match->binding_idx.IntValue()], match->arg_idxs);
@@ -826,11 +1259,20 @@ class ModuleInplaceTransformer : public ExprMutator {
   }
 
   Expr ReplaceBoundCall(const Binding& binding) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
     // can just pick the first index arbitrarily (only using one output for now too)
     // now replace the binding appropriately
     auto arg_idxs = inplace_idxs.at(binding);
     auto target = Downcast<Call>(GetBoundValue(binding));
-    auto new_call = CreateInplaceCall(target, {arg_idxs[0]});
+    Call new_call;
+    if (target->op.same_as(call_tir_op)) {
+      new_call = CreateInplaceCallTIR(target, {arg_idxs[0]});
+    } else if (target->op.same_as(call_dps_packed_op)) {
+      new_call = CreateInplacePackedCall(target, arg_idxs[0]);
+    } else {
+      new_call = CreateInplaceCall(target, {arg_idxs[0]});
+    }
     return builder_->Normalize(new_call);
   }
 
@@ -860,87 +1302,65 @@ class ModuleInplaceTransformer : public ExprMutator {
   // (Made public for testing.)
   Call CreateInplaceCall(const Call& call, const Array<Integer>& inplace_indices) {
     static const auto& legalize_map = Op::GetAttrMap<FLegalize>("FLegalize");
-    static const auto& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
 
     auto op = Downcast<Op>(call->op);
     auto legalized_call = Downcast<Call>(legalize_map[op](builder_, call));
-    auto* legalized_call_cow = legalized_call.CopyOnWrite();
 
     // The legalized call should be call_tir. We will replace it with call_tir_inplace
     // and replace the called PrimFunc with an inplace version
     auto legal_op = Downcast<GlobalVar>(legalized_call->args[0]);
     legalizers_added.push_back(legal_op);
+    // note: this might be a good time to get rid of the old legalized function, but we don't do it
+    // now because later ops might need the same one. Instead, we will clean up at the end
+    return CreateInplaceCallTIR(legalized_call, inplace_indices);
+  }
+
+  // Replace a call_tir with a call_tir_inplace of an in-place version of the PrimFunc.
+  // (The original PrimFunc is kept, it may have other callers.)
+  Call CreateInplaceCallTIR(const Call& call, const Array<Integer>& inplace_indices) {
+    static const auto& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
+
+    auto legal_op = Downcast<GlobalVar>(call->args[0]);
     auto inline_legal_op_name = legal_op->name_hint + "_inplace";
 
     auto mod = builder_->GetContextIRModule();
     auto old_primfunc = Downcast<tir::PrimFunc>(mod->Lookup(legal_op));
-
-    tir::Stmt new_body = old_primfunc->body;
-
-    size_t num_outs = inplace_indices.size();
-    size_t num_params = old_primfunc->params.size();
-
-    // the replacement we must make:
-    // 1. For each output var, replace its corresponding buffers with the corresponding inplace
-    // index
-    //    var's buffers
-    // 2. For each output var, replace its instances with the corresponding inplace index var
-    // 3. Do the same for the *buffer vars* corresponding to the output vars
-    // 4. Remove the output vars from the param list and buffer map
-    Map<tir::Buffer, tir::Buffer> buffer_subst_map;
-    Map<tir::Var, tir::Var> var_subst_map;
-    for (size_t i = 0; i < num_outs; i++) {
-      // we will substitute output i with the corresponding param indicated by inplace indices
-      auto output_var = old_primfunc->params[num_params - num_outs + i];
-      auto inplace_var = old_primfunc->params[inplace_indices[i].IntValue()];
-      var_subst_map.Set(output_var, inplace_var);
-
-      // also do the same with the buffer vars
-      auto output_buffer = old_primfunc->buffer_map.at(output_var);
-      auto inplace_buffer = old_primfunc->buffer_map.at(inplace_var);
-      var_subst_map.Set(output_buffer->data, inplace_buffer->data);
-      buffer_subst_map.Set(output_buffer, inplace_buffer);
-    }
-
-    // apply substitutions
-    new_body = RemapBuffers(new_body, buffer_subst_map);
-    new_body = tir::Substitute(new_body, [&var_subst_map](const tir::Var& v) -> Optional<PrimExpr> {
-      if (var_subst_map.count(v)) {
-        return var_subst_map.at(v);
-      }
-      return Optional<PrimExpr>();
-    });
-
-    // remove the now-unused outputs from the buffer map
-    auto new_buffer_map = old_primfunc->buffer_map;
-    for (size_t i = 0; i < num_outs; i++) {
-      new_buffer_map.erase(old_primfunc->params[num_params - num_outs + i]);
-    }
-
-    // now get rid of the last num_outputs arguments
-    // (couldn't do earlier or else it would have thrown off the indexing)
-    Array<tir::Var> new_params(old_primfunc->params.begin(),
-                               old_primfunc->params.begin() + (num_params - num_outs));
-
-    tir::PrimFunc new_primfunc(new_params, new_body, old_primfunc->ret_type, new_buffer_map,
-                               old_primfunc->attrs, old_primfunc->span);
-
-    // note: this might be a good time to get rid of the old legalized function, but we don't do it
-    // now because later ops might need the same one. Instead, we will clean up at the end
+    size_t num_inputs = Downcast<Tuple>(call->args[1])->fields.size();
+    tir::PrimFunc new_primfunc = MakeInplacePrimFunc(old_primfunc, num_inputs, inplace_indices);
     auto new_gv = builder_->AddFunction(new_primfunc, inline_legal_op_name);
 
     // update the call (change the op, update the argument, change the attrs)
-    legalized_call_cow->op = call_tir_inplace_op;
+    Call new_call = call;
+    auto* new_call_cow = new_call.CopyOnWrite();
+    new_call_cow->op = call_tir_inplace_op;
 
-    Array<Expr> new_args(legalized_call->args.begin(), legalized_call->args.end());
+    Array<Expr> new_args(call->args.begin(), call->args.end());
     new_args.Set(0, new_gv);
-    legalized_call_cow->args = new_args;
+    new_call_cow->args = new_args;
 
     ObjectPtr<CallTIRInplaceAttrs> attrs = make_object<CallTIRInplaceAttrs>();
     attrs->inplace_indices = inplace_indices;
-    legalized_call_cow->attrs = Attrs(attrs);
+    new_call_cow->attrs = Attrs(attrs);
 
-    return legalized_call;
+    return new_call;
+  }
+
+  // Replace a call_dps_packed with a call_tir_inplace of a PrimFunc passing the argument at
+  // `inplace_index` as the output of the packed function.
+  Call CreateInplacePackedCall(const Call& call, const Integer& inplace_index) {
+    static const auto& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
+
+    auto extern_func = Downcast<ExternFunc>(call->args[0]);
+    auto args = Downcast<Tuple>(call->args[1]);
+    tir::PrimFunc wrapper = MakeInplacePackedWrapper(extern_func->global_symbol, args->fields,
+                                                     inplace_index.IntValue());
+    std::string name = extern_func->global_symbol;
+    std::replace(name.begin(), name.end(), '.', '_');
+    auto new_gv = builder_->AddFunction(wrapper, name + "_inplace");
+
+    ObjectPtr<CallTIRInplaceAttrs> attrs = make_object<CallTIRInplaceAttrs>();
+    attrs->inplace_indices = {inplace_index};
+    return Call(call_tir_inplace_op, {new_gv, args}, Attrs(attrs), call->sinfo_args, call->span);
   }
 
   // Made public for testing.
@@ -948,6 +1368,10 @@ class ModuleInplaceTransformer : public ExprMutator {
 
  private:
   const IRModule& mod_;
+  // Whether to make the calls in-place across whole functions.
+  bool whole_function_;
+  // The packed functions that may write their output over any input of the same shape.
+  Array<String> inplace_packed_funcs_;
   // Keep track of legalizers we add so we can clean up at the end.
   Array<GlobalVar> legalizers_added;
   // The current function's params will be treated as non-aliased
@@ -1007,6 +1431,15 @@ tvm::transform::Pass DataflowUseInplaceCalls() {
       0, "DataflowInsertInPlaceCalls", {}, false);
 }
 
+tvm::transform::Pass UseInplaceCalls(Array<String> inplace_packed_funcs) {
+  return tvm::transform::CreateModulePass(
+      [=](const IRModule& mod, const PassContext& ctx) -> IRModule {
+        ModuleInplaceTransformer transformer(mod, /*whole_function=*/true, inplace_packed_funcs);
+        return transformer.Transform();
+      },
+      0, "UseInplaceCalls", {}, false);
+}
+
 Array<Array<InplaceOpportunity>> DataflowInplaceAnalysis(const DataflowBlock& block,
                                                          const Array<Var>& inputs,
                                                          const IRModule& mod) {
@@ -1033,6 +1466,7 @@ TVM_REGISTER_GLOBAL("relax.testing.transform.SingleInplaceCall")
 // actually exposed
 TVM_REGISTER_GLOBAL("relax.transform.DataflowUseInplaceCalls")
     .set_body_typed(DataflowUseInplaceCalls);
+TVM_REGISTER_GLOBAL("relax.transform.UseInplaceCalls").set_body_typed(UseInplaceCalls);
 
 }  // namespace transform
 }  // namespace relax
@@ -27,6 +27,12 @@
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace tvm {
 namespace relax {
 
@@ -34,8 +40,12 @@ class ConstantFolder : public ExprMutator {
  public:
   static Function Fold(Function func, IRModule ctx_module) {
     ConstantFolder folder(std::move(ctx_module));
-    func = Downcast<Function>(RemoveAllUnused(folder(func)));
-    return func;
+    // Each round defers the foldable call_tir, which are built together and evaluated after the
+    // round, and replaced by the next one. The rounds end once no more call can be folded.
+    do {
+      func = Downcast<Function>(folder(func));
+    } while (folder.EvaluatePendingCalls());
+    return Downcast<Function>(RemoveAllUnused(func));
   }
 
  private:
@@ -68,20 +78,6 @@ class ConstantFolder : public ExprMutator {
     return runtime::ShapeTuple(shape_values.begin(), shape_values.end());
   }
 
-  /*!
-   * \brief Pattern match op to constant array arguments.
-   * \return The constant array arguments, or nullopt if match fails.
-   */
-  static Optional<Array<runtime::NDArray>> MatchConstArrayArgs(const Array<Expr>& args) {
-    Array<runtime::NDArray> res;
-    for (auto arg : args) {
-      auto* ptr = arg.as<relax::ConstantNode>();
-      if (!ptr) return NullOpt;
-      res.push_back(ptr->data);
-    }
-    return res;
-  }
-
   /*!
    * \brief Pattern match op to a TIR function and look it up.
    * \return The TIR function, or nullopt if pattern match fails.
@@ -96,13 +92,53 @@ class ConstantFolder : public ExprMutator {
     return NullOpt;
   }
 
+  /*!
+   * \brief Build the functions not built yet into a single module, and cache them.
+   * \note A function that cannot be lowered is skipped, and if the module fails to build, the
+   * functions are built one by one, so that only the failing ones are skipped.
+   */
+  void BuildAll(const std::vector<tir::PrimFunc>& funcs) {
+    Target eval_cpu_target{"llvm"};
+    IRModule mod;
+    std::vector<std::pair<tir::PrimFunc, std::string>> lowered;
+    std::unordered_set<tir::PrimFunc, StructuralHash, StructuralEqual> visited;
+    for (const tir::PrimFunc& func : funcs) {
+      if (func_build_cache_.count(func) || !visited.insert(func).second) {
+        continue;
+      }
+      std::string name = "tir_function_" + std::to_string(lowered.size());
+      try {
+        mod->Update(LowerPrimFunc(func, name));
+        lowered.emplace_back(func, name);
+      } catch (const tvm::Error& err) {
+        DLOG(WARNING) << "Lowering failure for function " << func
+                      << ", Error message: " << err.what();
+        func_build_cache_[func] = NullOpt;
+      }
+    }
+    if (lowered.empty()) {
+      return;
+    }
+    try {
+      runtime::Module rt_module = build(mod, eval_cpu_target, eval_cpu_target);
+      for (const auto& kv : lowered) {
+        func_build_cache_[kv.first] = rt_module.GetFunction(kv.second);
+      }
+    } catch (const tvm::Error& err) {
+      // build failure may happen in which case we skip, or build the functions separately
+      DLOG(WARNING) << "Build failure for " << lowered.size()
+                    << " functions, Error message: " << err.what();
+      if (lowered.size() == 1) {
+        func_build_cache_[lowered[0].first] = NullOpt;
+      }
+    }
+  }
+
   /*!
    * \brief Get a cached build version of func
    * \return The cached func, nullopt if func cannot be built.
    */
   Optional<PackedFunc> GetCachedBuild(tir::PrimFunc func) {
-    // TODO(tvm-team): consider another way of bulk extract and build PrimFunc once
-    // would be helpful for future cases where PrimFunc recursively call into each other
     Target eval_cpu_target{"llvm"};
 
     auto it = func_build_cache_.find(func);
@@ -140,14 +176,9 @@ class ConstantFolder : public ExprMutator {
     return true;
   }
 
-  // Try constant evaluate the function call
-  // if failed return NullOpt
-  Optional<Expr> ConstEvaluateCallTIR(tir::PrimFunc tir_func, Array<runtime::NDArray> arr_args,
-                                      runtime::ShapeTuple shape, DataType ret_type) {
-    // obtain function from the cache.
-    Optional<PackedFunc> func = GetCachedBuild(tir_func);
-    if (!func) return NullOpt;
-
+  // Constant evaluate the function call
+  runtime::NDArray ConstEvaluateCallTIR(PackedFunc func, Array<runtime::NDArray> arr_args,
+                                        runtime::ShapeTuple shape, DataType ret_type) {
     // here the vector size has an additional + 1 because we need to put ret_tensor at the end
     std::vector<TVMValue> values(arr_args.size() + 1);
     std::vector<int> type_codes(arr_args.size() + 1);
@@ -168,30 +199,124 @@ class ConstantFolder : public ExprMutator {
 
     TVMRetValue ret;
     // invoke
-    func.value().CallPacked(TVMArgs(values.data(), type_codes.data(), values.size()), &ret);
-    return Constant(ret_tensor);
+    func.CallPacked(TVMArgs(values.data(), type_codes.data(), values.size()), &ret);
+    return ret_tensor;
+  }
+
+  /*! \brief A call_tir to be evaluated after the current round. */
+  struct PendingCall {
+    /*! \brief The function to call. */
+    tir::PrimFunc func;
+    /*! \brief The constant arguments, undefined for the results of other pending calls. */
+    std::vector<runtime::NDArray> args;
+    /*! \brief The index of the pending call computing each argument, -1 for constants. */
+    std::vector<int> arg_calls;
+    /*! \brief The shape of the result. */
+    runtime::ShapeTuple shape;
+    /*! \brief The dtype of the result. */
+    DataType dtype;
+    /*! \brief The expression to restore if the call cannot be evaluated. */
+    Expr fallback;
+  };
+
+  /*!
+   * \brief Build the functions of the pending calls at once, and evaluate the calls in the order
+   * they were deferred, which respects their dependencies.
+   * \return Whether there were pending calls, to be replaced by the next round.
+   */
+  bool EvaluatePendingCalls() {
+    evaluated_.clear();
+    if (pending_calls_.empty()) {
+      return false;
+    }
+    std::vector<tir::PrimFunc> funcs;
+    for (const PendingCall& pending : pending_calls_) {
+      funcs.push_back(pending.func);
+    }
+    BuildAll(funcs);
+
+    std::vector<runtime::NDArray> results(pending_calls_.size());
+    for (size_t i = 0; i < pending_calls_.size(); ++i) {
+      const PendingCall& pending = pending_calls_[i];
+      Optional<PackedFunc> func = GetCachedBuild(pending.func);
+      Array<runtime::NDArray> args;
+      for (size_t j = 0; func && j < pending.args.size(); ++j) {
+        runtime::NDArray arg =
+            pending.arg_calls[j] >= 0 ? results[pending.arg_calls[j]] : pending.args[j];
+        if (!arg.defined()) {
+          // The argument could not be evaluated
+          func = NullOpt;
+        }
+        args.push_back(arg);
+      }
+      Call call = pending_call_exprs_[i];
+      if (func) {
+        results[i] = ConstEvaluateCallTIR(func.value(), args, pending.shape, pending.dtype);
+        evaluated_[call] = Constant(results[i]);
+      } else {
+        evaluated_[call] = pending.fallback;
+      }
+    }
+    pending_calls_.clear();
+    pending_call_exprs_.clear();
+    pending_index_.clear();
+    return true;
   }
 
-  // Returns the folded expr if the call is successfully folded to constant, otherwise null.
-  Optional<Expr> VisitCallTIR(Call call) {
+  /*!
+   * \brief Defer the evaluation of the call to the end of the round, if it is foldable.
+   * \param call The call_tir.
+   * \param fallback The expression to restore if the call cannot be evaluated.
+   * \return The call if it is deferred, otherwise null.
+   */
+  Optional<Expr> VisitCallTIR(Call call, Expr fallback) {
     // call_tir needs to have at least three arguments
     ICHECK_GE(call->args.size(), 2);
     Optional<tir::PrimFunc> func = MatchPrimFunc(call->args[0]);
     ICHECK(call->args[1].as<TupleNode>()) << "call_tir.args[1] must be Tuple";
-    Optional<Array<runtime::NDArray>> arr_args =
-        MatchConstArrayArgs(call->args[1].as<TupleNode>()->fields);
     ICHECK_EQ(call->sinfo_args.size(), 1) << "call_tir should have exactly one sinfo arg";
     Optional<runtime::ShapeTuple> shape = MatchConstShape(call->sinfo_args[0]);
     bool output_not_tuple = call->sinfo_args.size() == 1;
     // Pattern 0: call constant function, const argument with const shape.
-    if (func && arr_args && shape && output_not_tuple) {
-      DynTensorType ret_type = Downcast<DynTensorType>(call->checked_type());
-      // value_or will return value if it is not null, otherwise return or
-      return ConstEvaluateCallTIR(func.value(), arr_args.value(), shape.value(), ret_type->dtype)
-          .value_or({});
-    }
     // TODO(hongyi): support const-fold tuple outputs
-    return {};
+    if (!func || !shape || !output_not_tuple) {
+      return {};
+    }
+    // Skip the functions known to fail building
+    auto it = func_build_cache_.find(func.value());
+    if (it != func_build_cache_.end() && !it->second) {
+      return {};
+    }
+    PendingCall pending;
+    // The arguments are either constants, or the results of the calls deferred before
+    for (const Expr& arg : call->args[1].as<TupleNode>()->fields) {
+      if (const auto* constant = arg.as<ConstantNode>()) {
+        pending.args.push_back(constant->data);
+        pending.arg_calls.push_back(-1);
+        continue;
+      }
+      Optional<Expr> value = NullOpt;
+      if (const auto* var = arg.as<VarNode>()) {
+        value = LookupBinding(GetRef<Var>(var));
+      }
+      auto arg_call = pending_index_.end();
+      if (const auto* value_call = value.as<CallNode>()) {
+        arg_call = pending_index_.find(GetRef<Call>(value_call));
+      }
+      if (arg_call == pending_index_.end()) {
+        return {};
+      }
+      pending.args.push_back(runtime::NDArray());
+      pending.arg_calls.push_back(arg_call->second);
+    }
+    pending.func = func.value();
+    pending.shape = shape.value();
+    pending.dtype = Downcast<DynTensorType>(call->checked_type())->dtype;
+    pending.fallback = std::move(fallback);
+    pending_index_[call] = pending_calls_.size();
+    pending_calls_.push_back(std::move(pending));
+    pending_call_exprs_.push_back(call);
+    return call;
   }
 
   using ExprMutator::VisitExpr_;
@@ -201,6 +326,15 @@ class ConstantFolder : public ExprMutator {
   // Until then, DecomposeOps() should be applied after
   // this pass to fold `tensor_to_shape` op.
   Expr VisitExpr_(const CallNode* call) final {
+    // The call_tir deferred by the previous round, replaced by its result or its fallback, whose
+    // arguments are visited again like any other expression
+    auto it = evaluated_.find(GetRef<Call>(call));
+    if (it != evaluated_.end()) {
+      Expr replacement = it->second;
+      evaluated_.erase(it);
+      return VisitExpr(replacement);
+    }
+
     // post-order mutation
     Call post_call = Downcast<Call>(VisitExprPostOrder_(call));
 
@@ -218,7 +352,7 @@ class ConstantFolder : public ExprMutator {
     auto op = GetRef<Op>(op_node);
 
     if (op.same_as(call_tir_op)) {
-      return VisitCallTIR(post_call).value_or(post_call);
+      return VisitCallTIR(post_call, post_call).value_or(post_call);
     }
 
     // Special logic to fold ShapeExpr between operators
@@ -253,7 +387,7 @@ class ConstantFolder : public ExprMutator {
         // If the legalized expression is call_tir, try to fold it.
         const CallNode* call = legalized_expr.as<CallNode>();
         if (call && call->op.same_as(call_tir_op)) {
-          return VisitCallTIR(GetRef<Call>(call)).value_or(post_call);
+          return VisitCallTIR(GetRef<Call>(call), post_call).value_or(post_call);
         }
       } else if (op->name == "relax.tensor_to_shape") {
         // Special handling for composite op "relax.tensor_to_shape"
@@ -317,6 +451,12 @@ class ConstantFolder : public ExprMutator {
   // cache for function build, via structural equality
   std::unordered_map<tir::PrimFunc, Optional<runtime::PackedFunc>, StructuralHash, StructuralEqual>
       func_build_cache_;
+  // the calls deferred in the current round, in post order
+  std::vector<PendingCall> pending_calls_;
+  std::vector<Call> pending_call_exprs_;
+  std::unordered_map<Call, int, ObjectPtrHash, ObjectPtrEqual> pending_index_;
+  // the results of the calls deferred by the previous round, or their fallback expressions
+  std::unordered_map<Call, Expr, ObjectPtrHash, ObjectPtrEqual> evaluated_;
 };
 
 namespace transform {
@@ -33,12 +33,17 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/struct_info.h>
 #include <tvm/relax/transform.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/expr_functor.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "../../relay/analysis/graph_partitioner.h"
 #include "../../support/arena.h"
@@ -96,6 +101,7 @@ using support::LinkNode;
 constexpr uint32_t kMaxFusedOps = 256;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.max_depth", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.cost_estimator", String);
 
 class GraphCreator : public ExprVisitor {
  public:
@@ -1033,15 +1039,94 @@ class OperatorFusor : public ExprMutator {
   bool lift_constants_{true};
 };
 
-IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth) {
+/*!
+ * \brief Accept the fusions that do not increase the estimated cost. The cost of a group is given
+ * by a user estimator of its bindings, and a fusion is committed only if the cost of the merged
+ * group is at most the total cost of the groups being merged.
+ */
+class CostGuidedFusion {
+ public:
+  using FEstimate = runtime::TypedPackedFunc<double(Array<Binding>)>;
+
+  CostGuidedFusion(const IRModule& mod, FEstimate f_estimate) : f_estimate_(f_estimate) {
+    for (const auto& [var, value] : AnalyzeVar2Value(mod)) {
+      bindings_.emplace(var.get(), VarBinding(var, value));
+    }
+  }
+
+  bool operator()(const std::vector<std::vector<const Object*>>& groups) {
+    std::vector<const Object*> merged;
+    double separate_cost = 0;
+    for (const std::vector<const Object*>& group : groups) {
+      separate_cost += Estimate(group);
+      merged.insert(merged.end(), group.begin(), group.end());
+    }
+    // Keep the bindings of the merged group in the order of the graph
+    std::sort(merged.begin(), merged.end(), [this](const Object* a, const Object* b) {
+      return order_.at(a) < order_.at(b);
+    });
+    return Estimate(merged) <= separate_cost;
+  }
+
+  /*! \brief Record the order of the nodes in the graph. */
+  void SetOrder(const IndexedForwardGraph& graph) {
+    for (size_t i = 0; i < graph.post_dfs_order.size(); ++i) {
+      order_[graph.post_dfs_order[i]->ref] = i;
+    }
+  }
+
+ private:
+  double Estimate(const std::vector<const Object*>& nodes) {
+    auto it = cost_cache_.find(nodes);
+    if (it != cost_cache_.end()) {
+      return it->second;
+    }
+    Array<Binding> bindings;
+    for (const Object* node : nodes) {
+      // Skip the function parameters and the constants
+      auto binding_it = bindings_.find(node);
+      if (binding_it != bindings_.end()) {
+        bindings.push_back(binding_it->second);
+      }
+    }
+    double cost = bindings.empty() ? 0 : f_estimate_(bindings);
+    cost_cache_.emplace(nodes, cost);
+    return cost;
+  }
+
+  /*! \brief The estimator of the cost of a group. */
+  FEstimate f_estimate_;
+  /*! \brief The binding of each variable. */
+  std::unordered_map<const Object*, Binding> bindings_;
+  /*! \brief The index of each node in the post-DFS order of the graph. */
+  std::unordered_map<const Object*, size_t> order_;
+  /*! \brief The estimated cost of each group. */
+  std::map<std::vector<const Object*>, double> cost_cache_;
+};
+
+IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth,
+                 Optional<String> cost_estimator) {
   support::Arena arena;
 
   // Step 1. Create the indexed-forward graph according to the input IRModule.
   IndexedForwardGraph graph = GraphCreator::Create(mod, &arena);
 
-  // Step 2. Partition the graph by applying the fusion algorithm.
+  // Step 2. Partition the graph by applying the fusion algorithm, optionally guided by the
+  // estimated cost of the fused groups.
+  GraphPartitioner::FAcceptFuse faccept_fuse = nullptr;
+  if (cost_estimator) {
+    const runtime::PackedFunc* f_estimate = runtime::Registry::Get(cost_estimator.value());
+    CHECK(f_estimate) << "ValueError: The cost estimator " << cost_estimator.value()
+                      << " of FuseOps is not a registered function";
+    auto guide = std::make_shared<CostGuidedFusion>(mod, *f_estimate);
+    guide->SetOrder(graph);
+    faccept_fuse = [guide](const std::vector<std::vector<const Object*>>& groups) {
+      return (*guide)(groups);
+    };
+  }
   std::vector<GraphPartitioner::Group*> groups =
-      GraphPartitioner(&arena, opt_level, max_fuse_depth, /*max_function_args=*/0).Partition(graph);
+      GraphPartitioner(&arena, opt_level, max_fuse_depth, /*max_function_args=*/0, faccept_fuse)
+          .Partition(graph);
 
   // Step 3. Transform the IRModule by fusing the operators in accordance with the graph partition
   // results.
@@ -1430,7 +1515,8 @@ Pass FuseOps(int fuse_opt_level) {
       [=](IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relax.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue());
+        auto cost_estimator = pc->GetConfig<String>("relax.FuseOps.cost_estimator");
+        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue(), cost_estimator);
       };
   return CreateModulePass(/*pass_function=*/pass_func,  //
                           /*opt_level=*/0,              //
@@ -0,0 +1,368 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/horizontal_fuse_tir.cc
+ * \brief Fuse independent call_tir of scheduled kernels into one kernel launch.
+ *
+ * A kernel is a scheduled PrimFunc whose body is a single loop bound to blockIdx.x. Kernels
+ * using the same threadIdx extents are packed into one PrimFunc, whose blockIdx.x range is the
+ * concatenation of theirs, each range dispatching to the body of one kernel:
+ *
+ *   for bx in T.thread_binding(n0 + n1, thread="blockIdx.x"):
+ *     if bx < n0:
+ *       body0[bx]
+ *     else:
+ *       body1[bx - n0]
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../support/utils.h"
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The structure of a PrimFunc launching a single kernel. */
+struct KernelInfo {
+  /*! \brief The loop bound to blockIdx.x. */
+  tir::For block_loop;
+  /*! \brief The root block, or null if the function is not in block form. */
+  Optional<tir::Block> root_block;
+  /*! \brief The extent of each threadIdx used by the kernel. */
+  std::map<std::string, int64_t> thread_extents;
+
+  /*! \brief Whether the kernels can be launched with the same threads. */
+  bool IsCompatibleWith(const KernelInfo& other) const {
+    auto f_root_annotations = [](const KernelInfo& info) {
+      return info.root_block ? info.root_block.value()->annotations : Map<String, ObjectRef>();
+    };
+    return thread_extents == other.thread_extents &&
+           block_loop->loop_var.dtype() == other.block_loop->loop_var.dtype() &&
+           StructuralEqual()(f_root_annotations(*this), f_root_annotations(other));
+  }
+};
+
+/*!
+ * \brief Analyze the kernel launched by a scheduled PrimFunc.
+ * \return The kernel, or std::nullopt if the PrimFunc does not launch a single kernel with
+ * blockIdx.x as its only block index and constant thread extents.
+ */
+std::optional<KernelInfo> AnalyzeKernel(const tir::PrimFunc& func) {
+  KernelInfo info;
+  tir::Stmt body = func->body;
+  if (const auto* realize = body.as<tir::BlockRealizeNode>()) {
+    const tir::Block& root = realize->block;
+    if (!root->iter_vars.empty() || root->init.defined() || !root->match_buffers.empty()) {
+      return std::nullopt;
+    }
+    info.root_block = root;
+    body = root->body;
+  }
+  const auto* loop = body.as<tir::ForNode>();
+  if (loop == nullptr || loop->kind != tir::ForKind::kThreadBinding ||
+      loop->thread_binding.value()->thread_tag != "blockIdx.x" || !tir::is_zero(loop->min) ||
+      !loop->extent->IsInstance<IntImmNode>()) {
+    return std::nullopt;
+  }
+  info.block_loop = GetRef<tir::For>(loop);
+  bool valid = true;
+  tir::PostOrderVisit(loop->body, [&](const ObjectRef& obj) {
+    if (const auto* inner = obj.as<tir::ForNode>()) {
+      if (inner->kind != tir::ForKind::kThreadBinding) {
+        return;
+      }
+      std::string thread_tag = inner->thread_binding.value()->thread_tag;
+      const auto* extent = inner->extent.as<IntImmNode>();
+      if (!support::StartsWith(thread_tag, "threadIdx.") || extent == nullptr) {
+        valid = false;
+        return;
+      }
+      auto [it, inserted] = info.thread_extents.emplace(thread_tag, extent->value);
+      valid = valid && (inserted || it->second == extent->value);
+    } else if (const auto* attr = obj.as<tir::AttrStmtNode>()) {
+      // the threads launched outside of the loops
+      valid = valid && attr->attr_key != tir::attr::thread_extent;
+    }
+  });
+  if (!valid) {
+    return std::nullopt;
+  }
+  return info;
+}
+
+/*!
+ * \brief Pack the kernels into one PrimFunc, see the file comment. The parameters are the inputs
+ * of every kernel, then the outputs of every kernel.
+ * \param funcs The PrimFuncs of the kernels, which must be compatible.
+ * \param num_inputs The number of inputs of each kernel.
+ */
+tir::PrimFunc PackKernels(const std::vector<tir::PrimFunc>& funcs,
+                          const std::vector<size_t>& num_inputs) {
+  Array<tir::Var> inputs, outputs;
+  Map<tir::Var, tir::Buffer> buffer_map;
+  Array<tir::Buffer> alloc_buffers;
+  std::vector<tir::Stmt> bodies;
+  std::vector<int64_t> offsets;
+  Optional<tir::Block> root_block;
+  int64_t num_blocks = 0;
+  DataType dtype;
+  tir::Var block_idx;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    // The same PrimFunc may be packed more than once
+    tir::PrimFunc func = tir::RenewDefs(funcs[i]);
+    KernelInfo info = AnalyzeKernel(func).value();
+    if (i == 0) {
+      dtype = info.block_loop->loop_var.dtype();
+      block_idx = tir::Var("blockIdx_x", dtype);
+      root_block = info.root_block;
+    }
+    for (size_t j = 0; j < func->params.size(); ++j) {
+      const tir::Var& param = func->params[j];
+      (j < num_inputs[i] ? inputs : outputs).push_back(param);
+      if (auto buffer = func->buffer_map.Get(param)) {
+        buffer_map.Set(param, buffer.value());
+      }
+    }
+    if (info.root_block) {
+      const Array<tir::Buffer>& root_alloc_buffers = info.root_block.value()->alloc_buffers;
+      alloc_buffers.insert(alloc_buffers.end(), root_alloc_buffers.begin(),
+                           root_alloc_buffers.end());
+      root_block = info.root_block;
+    }
+    PrimExpr local_block_idx = block_idx;
+    if (num_blocks != 0) {
+      local_block_idx = block_idx - IntImm(dtype, num_blocks);
+    }
+    Map<tir::Var, PrimExpr> vmap{{info.block_loop->loop_var, local_block_idx}};
+    bodies.push_back(tir::Substitute(info.block_loop->body, vmap));
+    offsets.push_back(num_blocks);
+    num_blocks += Downcast<IntImm>(info.block_loop->extent)->value;
+  }
+  // Step 1. Dispatch on the ranges of blockIdx.x
+  tir::Stmt body = bodies.back();
+  for (int i = static_cast<int>(bodies.size()) - 2; i >= 0; --i) {
+    body = tir::IfThenElse(block_idx < IntImm(dtype, offsets[i + 1]), bodies[i], body);
+  }
+  body = tir::For(block_idx, IntImm(dtype, 0), IntImm(dtype, num_blocks),
+                  tir::ForKind::kThreadBinding, body,
+                  tir::IterVar(Range(nullptr), tir::Var("blockIdx.x", dtype), tir::kThreadIndex,
+                               "blockIdx.x"));
+  // Step 2. Merge the root blocks
+  if (root_block) {
+    tir::Block root(/*iter_vars=*/{}, /*reads=*/{}, /*writes=*/{}, /*name_hint=*/"root", body,
+                    /*init=*/NullOpt, alloc_buffers, /*match_buffers=*/{},
+                    root_block.value()->annotations);
+    body = tir::BlockRealize({}, Bool(true), root);
+  }
+  Array<tir::Var> params = inputs;
+  params.insert(params.end(), outputs.begin(), outputs.end());
+  tir::PrimFunc packed(params, body, VoidType(), buffer_map, funcs[0]->attrs);
+  return WithoutAttr(std::move(packed), tvm::attr::kGlobalSymbol);
+}
+
+/*!
+ * \brief Fuse the independent call_tir of compatible kernels in the dataflow blocks.
+ *
+ * The calls of a group are emitted together where the last one was, so a group is closed by
+ * any binding using one of its results. Every call between is either independent of the group,
+ * and packed with it, or another binding that does not use the group and is left as is.
+ */
+class HorizontalKernelFuser : public ExprMutator {
+ public:
+  explicit HorizontalKernelFuser(const IRModule& mod) : ExprMutator(mod), mod_(mod) {}
+
+  IRModule Transform() {
+    for (const auto& [gv, func] : mod_->functions) {
+      if (const auto* relax_func = func.as<FunctionNode>()) {
+        Function new_func = Downcast<Function>(VisitExpr(GetRef<Function>(relax_func)));
+        builder_->UpdateFunction(gv, new_func);
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  /*! \brief A call_tir that can be packed. */
+  struct Candidate {
+    const VarBindingNode* binding;
+    tir::PrimFunc func;
+    KernelInfo kernel;
+  };
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    std::vector<Candidate> group;
+    std::unordered_set<const VarNode*> group_vars;
+    auto f_close_group = [&]() {
+      if (group.size() > 1) {
+        for (size_t i = 0; i + 1 < group.size(); ++i) {
+          packed_.insert(group[i].binding);
+        }
+        groups_[group.back().binding] = group;
+      }
+      group.clear();
+      group_vars.clear();
+    };
+    for (const Binding& binding : block->bindings) {
+      bool uses_group = false;
+      for (const Var& var : FreeVars(GetBoundValue(binding))) {
+        uses_group = uses_group || group_vars.count(var.get());
+      }
+      if (uses_group) {
+        f_close_group();
+      }
+      std::optional<Candidate> candidate = GetCandidate(binding);
+      if (!candidate) {
+        continue;
+      }
+      if (!group.empty() && !IsPackable(group[0], candidate.value())) {
+        f_close_group();
+      }
+      group.push_back(candidate.value());
+      group_vars.insert(binding->var.get());
+    }
+    f_close_group();
+    return ExprMutator::VisitBindingBlock_(block);
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    if (packed_.count(binding)) {
+      return;
+    }
+    auto it = groups_.find(binding);
+    if (it == groups_.end()) {
+      ExprMutator::VisitBinding_(binding);
+      return;
+    }
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const std::vector<Candidate>& group = it->second;
+    std::vector<tir::PrimFunc> funcs;
+    std::vector<size_t> num_inputs;
+    Array<Expr> args;
+    Array<StructInfo> out_sinfo;
+    std::string name = "horizontal_fused";
+    for (const Candidate& candidate : group) {
+      const auto* call = candidate.binding->value.as<CallNode>();
+      Array<Expr> call_args = Downcast<Tuple>(call->args[1])->fields;
+      funcs.push_back(candidate.func);
+      num_inputs.push_back(call_args.size());
+      for (const Expr& arg : call_args) {
+        args.push_back(VisitExpr(arg));
+      }
+      if (const auto* tuple_sinfo = call->sinfo_args[0].as<TupleStructInfoNode>()) {
+        out_sinfo.insert(out_sinfo.end(), tuple_sinfo->fields.begin(), tuple_sinfo->fields.end());
+      } else {
+        out_sinfo.push_back(call->sinfo_args[0]);
+      }
+      name += "_" + Downcast<GlobalVar>(call->args[0])->name_hint;
+    }
+    GlobalVar gv = builder_->AddFunction(PackKernels(funcs, num_inputs), name);
+    Var packed = builder_->Emit(
+        Call(call_tir_op, {gv, Tuple(args)}, Attrs(), {TupleStructInfo(out_sinfo)}), name);
+    // Rebind the results of the calls to the fields of the packed results
+    int field = 0;
+    for (const Candidate& candidate : group) {
+      const auto* call = candidate.binding->value.as<CallNode>();
+      Expr value;
+      if (const auto* tuple_sinfo = call->sinfo_args[0].as<TupleStructInfoNode>()) {
+        Array<Expr> fields;
+        for (size_t i = 0; i < tuple_sinfo->fields.size(); ++i) {
+          fields.push_back(TupleGetItem(packed, field++));
+        }
+        value = Tuple(fields);
+      } else {
+        value = TupleGetItem(packed, field++);
+      }
+      ReEmitBinding(candidate.binding, builder_->Normalize(value));
+    }
+  }
+
+  /*! \brief Get the call_tir of a kernel bound by the binding. */
+  std::optional<Candidate> GetCandidate(const Binding& binding) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const auto* var_binding = binding.as<VarBindingNode>();
+    const auto* call = var_binding ? var_binding->value.as<CallNode>() : nullptr;
+    if (!call || !call->op.same_as(call_tir_op) || call->args.size() != 2 ||
+        !call->args[1]->IsInstance<TupleNode>()) {
+      return std::nullopt;
+    }
+    auto opt_func = mod_->functions.Get(Downcast<GlobalVar>(call->args[0]));
+    if (!opt_func || !opt_func.value()->IsInstance<tir::PrimFuncNode>()) {
+      return std::nullopt;
+    }
+    auto func = Downcast<tir::PrimFunc>(opt_func.value());
+    std::optional<KernelInfo> kernel = AnalyzeKernel(func);
+    if (!kernel) {
+      return std::nullopt;
+    }
+    return Candidate{var_binding, func, kernel.value()};
+  }
+
+  /*! \brief Whether a call can be packed with the group led by the other one. */
+  static bool IsPackable(const Candidate& lead, const Candidate& candidate) {
+    auto f_vdevice = [](const Candidate& candidate) -> Optional<VDevice> {
+      if (const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(
+              candidate.binding->var)) {
+        return tensor_sinfo->vdevice;
+      }
+      return NullOpt;
+    };
+    return lead.kernel.IsCompatibleWith(candidate.kernel) &&
+           StructuralEqual()(lead.func->GetAttr<Target>(tvm::attr::kTarget),
+                             candidate.func->GetAttr<Target>(tvm::attr::kTarget)) &&
+           StructuralEqual()(f_vdevice(lead), f_vdevice(candidate));
+  }
+
+  /*! \brief The module being transformed. */
+  IRModule mod_;
+  /*! \brief The bindings of the calls packed into a later call. */
+  std::unordered_set<const VarBindingNode*> packed_;
+  /*! \brief The groups of calls, by the binding of their last call. */
+  std::unordered_map<const VarBindingNode*, std::vector<Candidate>> groups_;
+};
+
+namespace transform {
+
+Pass HorizontalFuseTIR() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) { return HorizontalKernelFuser(mod).Transform(); };
+  return CreateModulePass(/*pass_function=*/pass_func,
+                          /*opt_level=*/0,
+                          /*pass_name=*/"HorizontalFuseTIR",
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.HorizontalFuseTIR").set_body_typed(HorizontalFuseTIR);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -23,9 +23,15 @@
 #include <tvm/relax/expr.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/runtime/device_api.h>
 
+#include <algorithm>
+#include <limits>
 #include <optional>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "utils.h"
 
@@ -226,6 +232,292 @@ class LazyOutputMutator : public ExprMutator {
   };
   std::optional<FunctionPlan> plan_;
 };
+
+/*! \brief The number of bytes of a tensor of static shape, or -1 if it is not such a tensor. */
+int64_t GetStaticTensorBytes(const StructInfo& sinfo) {
+  const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+  if (tensor_sinfo == nullptr || tensor_sinfo->IsUnknownDtype()) {
+    return -1;
+  }
+  Optional<Array<PrimExpr>> shape = tensor_sinfo->GetShape();
+  if (!shape.defined()) {
+    return -1;
+  }
+  int64_t bytes = tensor_sinfo->dtype.bytes() * tensor_sinfo->dtype.lanes();
+  for (const PrimExpr& dim : shape.value()) {
+    const auto* int_dim = dim.as<IntImmNode>();
+    if (int_dim == nullptr) {
+      return -1;
+    }
+    bytes *= int_dim->value;
+  }
+  return bytes;
+}
+
+/*! \brief Whether the var of a binding may share the memory of the vars that it uses. */
+bool MayAliasInputs(const Binding& binding) {
+  static const Op& reshape_op = Op::Get("relax.reshape");
+  static const Op& view_op = Op::Get("relax.memory.view");
+  static const Op& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
+  const auto* var_binding = binding.as<VarBindingNode>();
+  const auto* call = var_binding != nullptr ? var_binding->value.as<CallNode>() : nullptr;
+  if (call == nullptr) {
+    // Aliases, tuples, tuple items and match casts
+    return true;
+  }
+  return call->op.same_as(reshape_op) || call->op.same_as(view_op) ||
+         call->op.same_as(call_tir_inplace_op);
+}
+
+/*!
+ * \brief Stream the lazily fetched parameters to the device, see
+ * src/runtime/relax_vm/param_stream.cc for the runtime.
+ *
+ * The parameters fetched at the top level of the function are packed in the order of their
+ * fetches into groups of at most `group_bytes` bytes, which are copied into two device slots in
+ * turn. A group is waited for right before its first fetch, which is also where the next group
+ * is prefetched into the other slot, replacing the group before. So a parameter is only streamed
+ * if it is no longer used when the next group is waited for, and otherwise fetched as before.
+ */
+class LazyInputPrefetcher : public ExprMutator {
+ public:
+  static Function Transform(Function func, int64_t runtime_device_index, int64_t group_bytes) {
+    LazyInputPrefetcher mutator(runtime_device_index);
+    Function non_dataflow_func = Downcast<Function>(ToNonDataflow(func));
+    if (!mutator.Plan(non_dataflow_func, group_bytes)) {
+      return func;
+    }
+    Function new_func = Downcast<Function>(mutator.VisitExpr(non_dataflow_func));
+    // The prefetches are effects ordered with the computation.
+    new_func.CopyOnWrite()->is_pure = false;
+    return new_func;
+  }
+
+ private:
+  explicit LazyInputPrefetcher(int64_t runtime_device_index)
+      : runtime_device_index_(runtime_device_index) {}
+
+  /*! \brief A parameter fetched at the top level of the function. */
+  struct FetchedParam {
+    /*! \brief The binding of the fetch. */
+    const VarBindingNode* binding;
+    /*! \brief The index of the parameter. */
+    int64_t index;
+    /*! \brief The name of the parameter. */
+    String name;
+    /*! \brief The position of the fetch among the bindings. */
+    int64_t pos;
+    /*! \brief The number of bytes of the parameter. */
+    int64_t bytes;
+    /*! \brief The position of the last binding using the parameter or its aliases. */
+    int64_t last_use;
+    /*! \brief The byte offset of the parameter in its slot. */
+    int64_t offset{0};
+  };
+
+  /*!
+   * \brief Plan the groups of the streamed parameters.
+   * \return Whether any parameter is streamed.
+   */
+  bool Plan(const Function& func, int64_t group_bytes) {
+    const auto* seq = func->body.as<SeqExprNode>();
+    if (seq == nullptr) {
+      return false;
+    }
+    std::vector<Binding> bindings;
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        bindings.push_back(binding);
+      }
+    }
+    std::unordered_set<const VarNode*> params;
+    for (const Var& param : func->params) {
+      params.insert(param.get());
+    }
+    // Step 1. Collect the fetches of the parameters, the callbacks with an index and a name.
+    std::vector<FetchedParam> fetches;
+    std::unordered_map<int64_t, int> index2num_fetches;
+    std::unordered_map<const VarNode*, const MatchCastNode*> untyped2cast;
+    for (int64_t pos = 0; pos < static_cast<int64_t>(bindings.size()); ++pos) {
+      if (const auto* match_cast = bindings[pos].as<MatchCastNode>()) {
+        if (const auto* untyped = match_cast->value.as<VarNode>()) {
+          untyped2cast[untyped] = match_cast;
+        }
+        continue;
+      }
+      const auto* binding = bindings[pos].as<VarBindingNode>();
+      const auto* call = binding->value.as<CallNode>();
+      if (call == nullptr || call->args.size() != 2) {
+        continue;
+      }
+      const auto* fget_param = call->op.as<VarNode>();
+      const auto* index = call->args[0].as<PrimValueNode>();
+      const auto* name = call->args[1].as<StringImmNode>();
+      if (fget_param == nullptr || !params.count(fget_param) || index == nullptr ||
+          !index->value->IsInstance<IntImmNode>() || name == nullptr ||
+          (fget_param_.defined() && fget_param_.get() != fget_param)) {
+        continue;
+      }
+      fget_param_ = GetRef<Var>(fget_param);
+      int64_t param_index = Downcast<IntImm>(index->value)->value;
+      ++index2num_fetches[param_index];
+      fetches.push_back({binding, param_index, name->value, pos, -1, -1});
+    }
+    // Step 2. Find the last use of each var, following the bindings that may alias their inputs.
+    std::unordered_map<const VarNode*, int64_t> last_use;
+    constexpr int64_t kOutlivesFunction = std::numeric_limits<int64_t>::max();
+    for (const Var& var : FreeVars(seq->body)) {
+      last_use[var.get()] = kOutlivesFunction;
+    }
+    for (int64_t pos = static_cast<int64_t>(bindings.size()) - 1; pos >= 0; --pos) {
+      const Binding& binding = bindings[pos];
+      int64_t use = pos;
+      if (MayAliasInputs(binding)) {
+        auto it = last_use.find(binding->var.get());
+        if (it != last_use.end()) {
+          use = std::max(use, it->second);
+        }
+      }
+      Expr value = binding.as<VarBindingNode>() ? binding.as<VarBindingNode>()->value
+                                                : binding.as<MatchCastNode>()->value;
+      for (const Var& var : FreeVars(value)) {
+        int64_t& var_last_use = last_use[var.get()];
+        var_last_use = std::max(var_last_use, use);
+      }
+    }
+    // Step 3. Keep the parameters of static shapes fetched once that do not outlive the function.
+    std::vector<FetchedParam> candidates;
+    for (FetchedParam& fetch : fetches) {
+      auto it_cast = untyped2cast.find(fetch.binding->var.get());
+      auto it_use = last_use.find(fetch.binding->var.get());
+      if (index2num_fetches[fetch.index] != 1 || it_cast == untyped2cast.end() ||
+          it_use == last_use.end() || it_use->second == kOutlivesFunction) {
+        continue;
+      }
+      fetch.bytes = GetStaticTensorBytes(it_cast->second->struct_info);
+      fetch.last_use = it_use->second;
+      if (fetch.bytes > 0) {
+        candidates.push_back(fetch);
+      }
+    }
+    // Step 4. Pack the parameters into groups, dropping those still in use when the next group is
+    // waited for until every group is valid.
+    std::vector<std::vector<FetchedParam>> groups;
+    while (true) {
+      groups.clear();
+      int64_t bytes = 0;
+      for (FetchedParam& fetch : candidates) {
+        int64_t aligned_bytes = (fetch.bytes + runtime::kAllocAlignment - 1) /
+                                runtime::kAllocAlignment * runtime::kAllocAlignment;
+        if (groups.empty() || bytes + aligned_bytes > group_bytes) {
+          groups.emplace_back();
+          bytes = 0;
+        }
+        fetch.offset = bytes;
+        groups.back().push_back(fetch);
+        bytes += aligned_bytes;
+      }
+      std::unordered_set<const VarBindingNode*> dropped;
+      for (size_t k = 0; k + 1 < groups.size(); ++k) {
+        for (const FetchedParam& fetch : groups[k]) {
+          if (fetch.last_use >= groups[k + 1][0].pos) {
+            dropped.insert(fetch.binding);
+          }
+        }
+      }
+      if (dropped.empty()) {
+        break;
+      }
+      candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                      [&dropped](const FetchedParam& fetch) {
+                                        return dropped.count(fetch.binding);
+                                      }),
+                       candidates.end());
+    }
+    if (groups.empty()) {
+      return false;
+    }
+    // Step 5. Size the slots for the groups used in turn.
+    slot_bytes_.resize(std::min<size_t>(groups.size(), 2), 0);
+    for (size_t k = 0; k < groups.size(); ++k) {
+      const FetchedParam& last = groups[k].back();
+      slot_bytes_[k % 2] = std::max(slot_bytes_[k % 2], last.offset + last.bytes);
+      group_begin_[groups[k][0].binding] = k;
+      for (const FetchedParam& fetch : groups[k]) {
+        streamed_[fetch.binding] = fetch.index;
+      }
+    }
+    groups_ = std::move(groups);
+    return true;
+  }
+
+  void VisitBinding(const Binding& binding) final {
+    if (!param_stream_.defined()) {
+      // The stream is created and the first group prefetched at the beginning of the function.
+      static const Op& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
+      static const ExternFunc builtin_create("vm.builtin.param_stream_create");
+      Array<PrimExpr> slot_bytes;
+      for (int64_t bytes : slot_bytes_) {
+        slot_bytes.push_back(IntImm(DataType::Int(64), bytes));
+      }
+      param_stream_ = builder_->Emit(
+          Call(call_builtin_with_ctx_op,
+               {builtin_create, Tuple({VisitExpr(fget_param_),
+                                       PrimValue::Int64(runtime_device_index_),
+                                       ShapeExpr(slot_bytes)})},
+               Attrs(), {ObjectStructInfo()}),
+          "param_stream");
+      EmitPrefetch(0);
+    }
+    if (const auto* var_binding = binding.as<VarBindingNode>()) {
+      if (auto it = group_begin_.find(var_binding); it != group_begin_.end()) {
+        static const ExternFunc builtin_wait("vm.builtin.param_stream_wait");
+        builder_->Emit(Call(builtin_wait, {param_stream_.value()}, Attrs(),
+                            {TupleStructInfo(Array<StructInfo>{})}),
+                       "_");
+        if (it->second + 1 < groups_.size()) {
+          EmitPrefetch(it->second + 1);
+        }
+      }
+      if (auto it = streamed_.find(var_binding); it != streamed_.end()) {
+        static const ExternFunc builtin_get("vm.builtin.param_stream_get");
+        Call get(builtin_get, {param_stream_.value(), PrimValue::Int64(it->second)}, Attrs(),
+                 {ObjectStructInfo()});
+        ReEmitBinding(var_binding, builder_->Normalize(get));
+        return;
+      }
+    }
+    ExprMutator::VisitBinding(binding);
+  }
+
+  /*! \brief Emit the prefetch of a group into its slot. */
+  void EmitPrefetch(size_t group) {
+    static const ExternFunc builtin_prefetch("vm.builtin.param_stream_prefetch");
+    Array<Expr> args = {param_stream_.value(), PrimValue::Int64(group % 2)};
+    for (const FetchedParam& fetch : groups_[group]) {
+      args.push_back(PrimValue::Int64(fetch.index));
+      args.push_back(StringImm(fetch.name));
+      args.push_back(PrimValue::Int64(fetch.offset));
+    }
+    builder_->Emit(Call(builtin_prefetch, args, Attrs(), {TupleStructInfo(Array<StructInfo>{})}),
+                   "_");
+  }
+
+  /*! \brief The runtime device index that the parameters are streamed to. */
+  int64_t runtime_device_index_;
+  /*! \brief The callback fetching the parameters. */
+  Var fget_param_;
+  /*! \brief The groups of the streamed parameters. */
+  std::vector<std::vector<FetchedParam>> groups_;
+  /*! \brief The number of bytes of each slot. */
+  std::vector<int64_t> slot_bytes_;
+  /*! \brief The group of which each fetch is the first. */
+  std::unordered_map<const VarBindingNode*, size_t> group_begin_;
+  /*! \brief The index of the parameter of each streamed fetch. */
+  std::unordered_map<const VarBindingNode*, int64_t> streamed_;
+  /*! \brief The var of the stream. */
+  Optional<Var> param_stream_;
+};
 }  // namespace
 
 Function WithLazyInputs(Function func) {
@@ -276,6 +568,21 @@ Pass LazySetOutput() {
 
 TVM_REGISTER_GLOBAL("relax.transform.LazySetOutput").set_body_typed(LazySetOutput);
 
+Pass PrefetchLazyInput(int64_t runtime_device_index, int64_t group_bytes) {
+  auto pass_func = [=](Function func, IRModule, PassContext) -> Function {
+    if (!func->GetAttr<String>(tvm::attr::kGlobalSymbol).defined()) {
+      return func;
+    }
+    return LazyInputPrefetcher::Transform(func, runtime_device_index, group_bytes);
+  };
+  return CreateFunctionPass(/*pass_function=*/pass_func,
+                            /*opt_level=*/0,
+                            /*pass_name=*/"PrefetchLazyInput",
+                            /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.PrefetchLazyInput").set_body_typed(PrefetchLazyInput);
+
 }  // namespace transform
 }  // namespace relax
 }  // namespace tvm
@@ -24,8 +24,14 @@
 #include <tvm/meta_schedule/database.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/tuning_api.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/transform.h>
 
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "../src/meta_schedule/module_equality.h"
 #include "../src/meta_schedule/trace_apply.h"
 
@@ -121,18 +127,48 @@ Pass MetaScheduleApplyDatabase(Optional<String> work_dir, bool enable_warning =
       database = meta_schedule::Database::JSONDatabase(path_workload, path_tuning_record, true);
     }
 
-    Map<GlobalVar, BaseFunc> result;
+    // Step 1. Query the database for each PrimFunc. The queries may call back into python, so
+    // they are done serially, while the functions of the same workload share one replay.
+    using ReplayCache = std::unordered_map<IRModule, int, meta_schedule::ModuleHash,
+                                           meta_schedule::ModuleEqual>;
     auto mod_eq_structural = meta_schedule::ModuleEquality::Create("ignore-ndarray");
+    ReplayCache replay_index(/*bucket_count=*/0, meta_schedule::ModuleHash(*mod_eq_structural),
+                             meta_schedule::ModuleEqual(*mod_eq_structural));
+    std::vector<IRModule> replay_mods;
+    std::vector<meta_schedule::TuningRecord> replay_records;
+    std::vector<std::pair<GlobalVar, int>> replayed_funcs;
+    Map<GlobalVar, BaseFunc> result;
     for (const auto& iter : mod->functions) {
       GlobalVar gv = iter.first;
       BaseFunc base_func = iter.second;
-      if (const auto* prim_func_node = base_func.as<tir::PrimFuncNode>()) {
-        tir::PrimFunc prim_func = GetRef<tir::PrimFunc>(prim_func_node);
-
-        IRModule tir_mod = (*normalize_mod_func_)(prim_func);
-        if (Optional<meta_schedule::TuningRecord> opt_record =
-                database->QueryTuningRecord(tir_mod, target, gv->name_hint)) {
-          meta_schedule::TuningRecord record = opt_record.value();
+      result.Set(gv, base_func);
+      if (!base_func->IsInstance<tir::PrimFuncNode>()) {
+        continue;
+      }
+      IRModule tir_mod = (*normalize_mod_func_)(Downcast<tir::PrimFunc>(base_func));
+      auto it = replay_index.find(tir_mod);
+      if (it == replay_index.end()) {
+        Optional<meta_schedule::TuningRecord> opt_record =
+            database->QueryTuningRecord(tir_mod, target, gv->name_hint);
+        if (!opt_record.defined()) {
+          if (enable_warning) {
+            LOG(WARNING) << "Tuning record is not found for primfunc: " << gv->name_hint;
+          }
+          continue;
+        }
+        it = replay_index.emplace(tir_mod, replay_mods.size()).first;
+        replay_mods.push_back(tir_mod);
+        replay_records.push_back(opt_record.value());
+      }
+      replayed_funcs.emplace_back(gv, it->second);
+    }
+    // Step 2. Replay the traces of the distinct workloads in parallel
+    int num_replays = replay_mods.size();
+    std::vector<tir::PrimFunc> tuned_prim_funcs(num_replays, tir::PrimFunc{nullptr});
+    support::parallel_for_dynamic(
+        0, num_replays, std::thread::hardware_concurrency(), [&](int, int task_id) {
+          const IRModule& tir_mod = replay_mods[task_id];
+          const meta_schedule::TuningRecord& record = replay_records[task_id];
           tir::Schedule sch{nullptr};
           if (!mod_eq_structural->Equal(tir_mod, record->workload->mod)) {
             // When the database lookup succeeds while structural equality check fails,
@@ -152,21 +188,20 @@ Pass MetaScheduleApplyDatabase(Optional<String> work_dir, bool enable_warning =
           ICHECK_EQ(new_mod->functions.size(), 1);
           BaseFunc new_base_func = (*new_mod->functions.begin()).second;
           ICHECK(new_base_func->IsInstance<tir::PrimFuncNode>());
-          tir::PrimFunc tuned_prim_func = Downcast<tir::PrimFunc>(new_base_func);
-          // maintain the original attributes
-          tir::PrimFunc new_prim_func = tir::PrimFunc(/*params=*/tuned_prim_func->params,
-                                                      /*body=*/tuned_prim_func->body,
-                                                      /*ret_type=*/tuned_prim_func->ret_type,
-                                                      /*buffer_map=*/tuned_prim_func->buffer_map,
-                                                      /*attrs=*/prim_func->attrs);
-          new_prim_func = WithAttr(std::move(new_prim_func), tir::attr::kIsScheduled, Bool(true));
-          result.Set(gv, new_prim_func);
-          continue;
-        } else if (enable_warning) {
-          LOG(WARNING) << "Tuning record is not found for primfunc: " << gv->name_hint;
-        }
-      }
-      result.Set(gv, base_func);
+          tuned_prim_funcs[task_id] = Downcast<tir::PrimFunc>(new_base_func);
+        });
+    // Step 3. Replace the PrimFuncs with the tuned ones
+    for (const auto& [gv, task_id] : replayed_funcs) {
+      const tir::PrimFunc& tuned_prim_func = tuned_prim_funcs[task_id];
+      tir::PrimFunc prim_func = Downcast<tir::PrimFunc>(mod->Lookup(gv));
+      // maintain the original attributes
+      tir::PrimFunc new_prim_func = tir::PrimFunc(/*params=*/tuned_prim_func->params,
+                                                  /*body=*/tuned_prim_func->body,
+                                                  /*ret_type=*/tuned_prim_func->ret_type,
+                                                  /*buffer_map=*/tuned_prim_func->buffer_map,
+                                                  /*attrs=*/prim_func->attrs);
+      new_prim_func = WithAttr(std::move(new_prim_func), tir::attr::kIsScheduled, Bool(true));
+      result.Set(gv, new_prim_func);
     }
     return IRModule(result,       // functions
                     {},           // type_definitions
@@ -0,0 +1,293 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/overlap_collectives.cc
+ * \brief Schedule the collectives to overlap with the computation.
+ *
+ * The pure bindings of each block are reordered so that every collective starts as soon as its
+ * input is ready, and the consumers of its result come after all the computation that does not
+ * depend on a pending collective.
+ *
+ * Outside of the dataflow blocks, the legalized allreduce and allgather are moreover started
+ * asynchronously on the communication stream of disco, and waited for right before their first
+ * consumer:
+ *
+ *   y = R.builtin.alloc_tensor(shape, dtype, device_index, "global")
+ *   handle = R.call_packed("runtime.disco.allreduce_async", x, kind, in_group, y)
+ *   ... independent computation ...
+ *   _ = R.call_packed("runtime.disco.wait_collective", handle, x, y)
+ *   z = consumer(y)
+ *
+ * The buffers of the collective are passed to the wait, so that the memory planning keeps them
+ * alive until the collective completes.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The asynchronous version of each legalized collective. */
+static const std::unordered_map<std::string, std::string>& AsyncCollectives() {
+  static const std::unordered_map<std::string, std::string> collectives = {
+      {"runtime.disco.allreduce", "runtime.disco.allreduce_async"},
+      {"runtime.disco.allgather", "runtime.disco.allgather_async"},
+  };
+  return collectives;
+}
+
+/*! \brief Get the legalized collective bound by a binding, or return nullptr. */
+static const CallNode* GetLegalizedCollective(const Binding& binding) {
+  static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+  const auto* var_binding = binding.as<VarBindingNode>();
+  const auto* call = var_binding ? var_binding->value.as<CallNode>() : nullptr;
+  if (!call || !call->op.same_as(call_dps_packed_op)) {
+    return nullptr;
+  }
+  const auto* func = call->args[0].as<ExternFuncNode>();
+  const auto* out_sinfo = call->sinfo_args[0].as<TensorStructInfoNode>();
+  if (!func || !AsyncCollectives().count(func->global_symbol) || !out_sinfo ||
+      !out_sinfo->shape.defined() || !call->args[1]->IsInstance<TupleNode>()) {
+    return nullptr;
+  }
+  return call;
+}
+
+/*! \brief Whether a binding starts a collective, legalized or not. */
+static bool IsCollective(const Binding& binding) {
+  static const Op& allreduce_op = Op::Get("relax.ccl.allreduce");
+  static const Op& allgather_op = Op::Get("relax.ccl.allgather");
+  if (GetLegalizedCollective(binding)) {
+    return true;
+  }
+  const auto* var_binding = binding.as<VarBindingNode>();
+  const auto* call = var_binding ? var_binding->value.as<CallNode>() : nullptr;
+  return call && (call->op.same_as(allreduce_op) || call->op.same_as(allgather_op));
+}
+
+/*!
+ * \brief Reorder the pure bindings between two impure ones, see the file comment. Among the
+ * bindings whose inputs are ready, the collectives come first, then the bindings that do not
+ * consume a pending collective, then the others, each in their original order.
+ */
+static std::vector<Binding> ScheduleSegment(const std::vector<Binding>& bindings) {
+  int n = bindings.size();
+  std::unordered_map<const VarNode*, int> index;
+  for (int i = 0; i < n; ++i) {
+    index[bindings[i]->var.get()] = i;
+  }
+  std::vector<std::vector<int>> deps(n);
+  std::vector<bool> is_collective(n);
+  for (int i = 0; i < n; ++i) {
+    for (const Var& var : FreeVars(GetBoundValue(bindings[i]))) {
+      auto it = index.find(var.get());
+      if (it != index.end()) {
+        deps[i].push_back(it->second);
+      }
+    }
+    is_collective[i] = IsCollective(bindings[i]);
+  }
+  std::vector<bool> scheduled(n, false);
+  // Whether the result of a scheduled collective has not been consumed yet
+  std::vector<bool> pending(n, false);
+  std::vector<Binding> schedule;
+  for (int step = 0; step < n; ++step) {
+    int best = -1;
+    int best_priority = 0;
+    for (int i = 0; i < n; ++i) {
+      if (scheduled[i]) {
+        continue;
+      }
+      bool ready = true;
+      bool consumes_pending = false;
+      for (int dep : deps[i]) {
+        ready = ready && scheduled[dep];
+        consumes_pending = consumes_pending || pending[dep];
+      }
+      if (!ready) {
+        continue;
+      }
+      int priority = is_collective[i] ? 0 : (consumes_pending ? 2 : 1);
+      if (best == -1 || priority < best_priority) {
+        best = i;
+        best_priority = priority;
+      }
+    }
+    ICHECK_NE(best, -1) << "InternalError: The bindings are not in SSA form";
+    scheduled[best] = true;
+    pending[best] = is_collective[best];
+    for (int dep : deps[best]) {
+      pending[dep] = false;
+    }
+    schedule.push_back(bindings[best]);
+  }
+  return schedule;
+}
+
+/*! \brief Reorder the bindings of a block, keeping the impure ones in place. */
+static std::vector<Binding> ScheduleBindings(const Array<Binding>& bindings) {
+  std::vector<Binding> schedule;
+  std::vector<Binding> segment;
+  auto f_flush = [&]() {
+    std::vector<Binding> segment_schedule = ScheduleSegment(segment);
+    schedule.insert(schedule.end(), segment_schedule.begin(), segment_schedule.end());
+    segment.clear();
+  };
+  for (const Binding& binding : bindings) {
+    if (ContainsImpureCall(GetBoundValue(binding))) {
+      f_flush();
+      schedule.push_back(binding);
+    } else {
+      segment.push_back(binding);
+    }
+  }
+  f_flush();
+  return schedule;
+}
+
+class CollectiveOverlapper : public ExprMutator {
+ public:
+  explicit CollectiveOverlapper(const IRModule& mod) : ExprMutator(mod), mod_(mod) {}
+
+  IRModule Transform() {
+    for (const auto& [gv, base_func] : mod_->functions) {
+      const auto* func = base_func.as<FunctionNode>();
+      if (func == nullptr) {
+        continue;
+      }
+      num_async_ = 0;
+      Function new_func = Downcast<Function>(VisitExpr(GetRef<Function>(func)));
+      // The asynchronous collectives are impure calls
+      if (num_async_ > 0 && new_func->is_pure && !new_func->HasNonzeroAttr(attr::kForcePure)) {
+        new_func = WithAttr(new_func, attr::kForcePure, Bool(true));
+      }
+      if (!new_func.same_as(base_func)) {
+        builder_->UpdateFunction(gv, new_func);
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    std::vector<Binding> schedule = ScheduleBindings(block->bindings);
+    return ExprMutator::VisitBindingBlock_(DataflowBlock(schedule, block->span).get());
+  }
+
+  BindingBlock VisitBindingBlock_(const BindingBlockNode* block) final {
+    std::vector<Binding> schedule = ScheduleBindings(block->bindings);
+    builder_->BeginBindingBlock();
+    for (const Binding& binding : schedule) {
+      WaitForInputs(GetBoundValue(binding));
+      if (const CallNode* collective = GetLegalizedCollective(binding)) {
+        StartAsync(binding.as<VarBindingNode>(), collective);
+      } else {
+        VisitBinding(binding);
+      }
+    }
+    // The results may be used by the following blocks
+    for (const Binding& binding : schedule) {
+      if (pending_.count(binding->var.get())) {
+        WaitFor(binding->var.get());
+      }
+    }
+    return builder_->EndBlock();
+  }
+
+  /*! \brief Start a legalized collective asynchronously. */
+  void StartAsync(const VarBindingNode* binding, const CallNode* collective) {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    const auto* out_sinfo = collective->sinfo_args[0].as<TensorStructInfoNode>();
+    int device_index = 0;
+    if (out_sinfo->vdevice.defined()) {
+      device_index = GetDeviceIndex(mod_, out_sinfo->vdevice.value());
+    }
+    Expr alloc = Call(alloc_tensor_op,
+                      {Downcast<ShapeExpr>(out_sinfo->shape.value()), DataTypeImm(out_sinfo->dtype),
+                       PrimValue::Int64(device_index), StringImm("global")},
+                      Attrs());
+    ReEmitBinding(binding, builder_->Normalize(alloc));
+    Var out = Downcast<Var>(VisitExpr(binding->var));
+    const String& name = Downcast<ExternFunc>(collective->args[0])->global_symbol;
+    Array<Expr> args;
+    for (const Expr& arg : Downcast<Tuple>(collective->args[1])->fields) {
+      args.push_back(VisitExpr(arg));
+    }
+    Expr send = args[0];
+    args.push_back(out);
+    Var handle = builder_->Emit(Call(ExternFunc(AsyncCollectives().at(name)), args, Attrs(),
+                                     {ObjectStructInfo()}),
+                                "handle");
+    pending_.emplace(binding->var.get(), std::vector<Expr>{handle, send, out});
+    ++num_async_;
+  }
+
+  /*! \brief Wait for the pending collectives whose results are used by an expression. */
+  void WaitForInputs(const Expr& expr) {
+    if (pending_.empty()) {
+      return;
+    }
+    for (const Var& var : FreeVars(expr)) {
+      if (pending_.count(var.get())) {
+        WaitFor(var.get());
+      }
+    }
+  }
+
+  void WaitFor(const VarNode* var) {
+    std::vector<Expr> args = pending_.at(var);
+    pending_.erase(var);
+    builder_->Emit(Call(ExternFunc("runtime.disco.wait_collective"), args, Attrs(),
+                        {ObjectStructInfo()}),
+                   "_");
+  }
+
+  /*! \brief The module being transformed. */
+  IRModule mod_;
+  /*! \brief The handle and buffers of each pending collective, by the variable of its result. */
+  std::unordered_map<const VarNode*, std::vector<Expr>> pending_;
+  /*! \brief The number of collectives started asynchronously in the current function. */
+  int num_async_ = 0;
+};
+
+namespace transform {
+
+Pass OverlapCollectives() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) { return CollectiveOverlapper(mod).Transform(); };
+  return CreateModulePass(/*pass_function=*/pass_func,
+                          /*opt_level=*/0,
+                          /*pass_name=*/"OverlapCollectives",
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.OverlapCollectives").set_body_typed(OverlapCollectives);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/specialize_shape_buckets.cc
+ * \brief Specialize dynamic-shape functions for the hot values of their symbolic variables.
+ *
+ * For each bucket, a copy of the function is made with the symbolic variables of the bucket bound
+ * to their values, so that the kernels legalized from it are static. The function itself becomes a
+ * dispatcher, which matches the symbolic variables defined by its parameters against the buckets
+ * and calls either a specialized copy or the generic one:
+ *
+ *   def main(x: R.Tensor(("n", 64))):
+ *       if R.prim_value(n == 128):
+ *           x_1 = R.match_cast(x, R.Tensor((128, 64)))
+ *           out_1 = main_n128(x_1)
+ *           out = R.match_cast(out_1, R.Tensor((n, 64)))
+ *       else:
+ *           out = main_generic(x)
+ *       return out
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+// Defined in bind_symbolic_vars.cc
+Function FunctionBindSymbolicVars(Function func, Map<ObjectRef, PrimExpr> obj_remap);
+
+namespace {
+
+using Bucket = Map<String, PrimExpr>;
+
+/*! \brief Copy a function to be called by the dispatcher only. */
+Function MakePrivateCopy(const Function& func) {
+  return WithoutAttr(CopyWithNewVars(func), tvm::attr::kGlobalSymbol);
+}
+
+/*! \brief The name of the copy of a function specialized for a bucket. */
+std::string BucketFuncName(const std::string& func_name, const Bucket& bucket) {
+  std::ostringstream os;
+  os << func_name;
+  for (const auto& [name, value] : bucket) {
+    os << "_" << name;
+    if (const auto* imm = value.as<IntImmNode>()) {
+      os << imm->value;
+    }
+  }
+  return os.str();
+}
+
+/*!
+ * \brief Emit a call to a function from the dispatcher, casting the arguments to the parameters
+ * of the callee and the result back to the return type of the dispatcher.
+ */
+Expr EmitDispatchedCall(const BlockBuilder& builder, const GlobalVar& gvar, const Function& callee,
+                        const Array<Var>& params, const StructInfo& ret_struct_info) {
+  builder->BeginBindingBlock();
+  Array<Expr> args;
+  for (size_t i = 0; i < params.size(); ++i) {
+    StructInfo param_sinfo = GetStructInfo(callee->params[i]);
+    if (StructuralEqual()(GetStructInfo(params[i]), param_sinfo)) {
+      args.push_back(params[i]);
+    } else {
+      args.push_back(builder->EmitMatchCast(params[i], param_sinfo));
+    }
+  }
+  Expr out = builder->Emit(Call(gvar, args));
+  if (!StructuralEqual()(GetStructInfo(out), ret_struct_info)) {
+    out = builder->EmitMatchCast(out, ret_struct_info);
+  }
+  return SeqExpr({builder->EndBlock()}, out);
+}
+
+Function SpecializeFunction(const BlockBuilder& builder, const GlobalVar& gvar,
+                            const Function& func, const Array<Bucket>& buckets) {
+  std::unordered_map<std::string, tir::Var> symbolic_vars;
+  for (const tir::Var& var : DefinedSymbolicVars(func)) {
+    symbolic_vars[var->name_hint] = var;
+  }
+  std::vector<PrimExpr> conds;
+  std::vector<GlobalVar> bucket_gvars;
+  std::vector<Function> bucket_funcs;
+  for (const Bucket& bucket : buckets) {
+    CHECK(!bucket.empty()) << "ValueError: The shape buckets of " << gvar->name_hint
+                           << " must bind at least one symbolic variable";
+    PrimExpr cond;
+    Map<ObjectRef, PrimExpr> binding_map;
+    for (const auto& [name, value] : bucket) {
+      auto it = symbolic_vars.find(name);
+      CHECK(it != symbolic_vars.end())
+          << "ValueError: Function " << gvar->name_hint << " does not define symbolic variable "
+          << name << " in the signature, so it cannot be dispatched on";
+      CHECK(value->IsInstance<IntImmNode>())
+          << "ValueError: The value of " << name
+          << " in a shape bucket must be an integer, but got " << value;
+      IntImm bound_value(it->second->dtype, Downcast<IntImm>(value)->value);
+      cond = cond.defined() ? (cond && it->second == bound_value) : (it->second == bound_value);
+      binding_map.Set(name, bound_value);
+    }
+    Function specialized = MakePrivateCopy(FunctionBindSymbolicVars(func, binding_map));
+    bucket_gvars.push_back(
+        builder->AddFunction(specialized, BucketFuncName(gvar->name_hint, bucket)));
+    bucket_funcs.push_back(specialized);
+    conds.push_back(cond);
+  }
+  Function generic = MakePrivateCopy(func);
+  GlobalVar generic_gvar = builder->AddFunction(generic, gvar->name_hint + "_generic");
+
+  // The dispatcher keeps the signature and the attributes of the original function
+  Function dispatcher = CopyWithNewVars(func);
+  StructInfo ret_struct_info = dispatcher->ret_struct_info;
+  builder->BeginScope(dispatcher->params);
+  Expr body = EmitDispatchedCall(builder, generic_gvar, generic, dispatcher->params,
+                                 ret_struct_info);
+  for (int i = static_cast<int>(buckets.size()) - 1; i >= 0; --i) {
+    Expr then_branch = EmitDispatchedCall(builder, bucket_gvars[i], bucket_funcs[i],
+                                          dispatcher->params, ret_struct_info);
+    body = If(PrimValue(conds[i]), then_branch, body);
+  }
+  builder->BeginBindingBlock();
+  Var out = builder->Emit(body);
+  BindingBlock block = builder->EndBlock();
+  builder->EndScope();
+  return Function(dispatcher->params, SeqExpr({block}, out), ret_struct_info,
+                  dispatcher->is_pure, dispatcher->attrs, dispatcher->span);
+}
+
+}  // namespace
+
+namespace transform {
+
+Pass SpecializeShapeBuckets(Map<String, Array<Map<String, PrimExpr>>> buckets) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    BlockBuilder builder = BlockBuilder::Create(mod);
+    for (const auto& [func_name, func_buckets] : buckets) {
+      if (func_buckets.empty()) continue;
+      GlobalVar gvar = mod->GetGlobalVar(func_name);
+      auto func = mod->Lookup(gvar).as<Function>();
+      CHECK(func.defined()) << "ValueError: " << func_name << " is not a Relax function";
+      builder->UpdateFunction(gvar, SpecializeFunction(builder, gvar, func.value(), func_buckets));
+    }
+    return builder->GetContextIRModule();
+  };
+  return CreateModulePass(pass_func, 0, "SpecializeShapeBuckets", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.SpecializeShapeBuckets")
+    .set_body_typed(SpecializeShapeBuckets);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
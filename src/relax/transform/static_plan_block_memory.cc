@@ -46,6 +46,20 @@
  * - Insert `memory.alloc_tensor` at the site of the
  *   `builtin.alloc_tensor` that it replaces.
  *
+ * When the pass config "relax.memory_plan_arena" is enabled, the second stage
+ * does not reuse whole tokens among the constant-sized tensors of "global"
+ * scope. Instead, each binding block gets one arena per device, and every such
+ * tensor is assigned a byte offset inside the arena of its block, such that the
+ * tensors alive at the same time never overlap. Unlike the token reuse, a small
+ * tensor can then live in the free tail of a large dead one. The offsets are
+ * planned greedily, by decreasing sizes and by the allocation order, keeping the
+ * smaller arena of the two. Dynamic-shape tensors take part through the
+ * upper bounds of their shapes described below. The arenas of the blocks in the
+ * branches of an If are placed at the same offset of the arena of the enclosing
+ * block, which reserves the size of the largest one for the whole If. The private
+ * functions are inlined into their callers beforehand, so that a subroutine also
+ * allocates from the arena of its caller.
+ *
  * We do not insert `memory.kill_storage` or `memory.kill_tensor`, as
  * these are handled in the later `KillAfterLastUse` lowering pass.
  * This ensures that all tensors are killed after their last use,
@@ -70,8 +84,10 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/nested_msg.h>
 #include <tvm/relax/transform.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <vector>
@@ -79,6 +95,8 @@
 namespace tvm {
 namespace relax {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.memory_plan_arena", Bool);
+
 /*!
  * \brief A representation of a block of reusable memory required at runtime.
  * \details Only the tensors whose memory can be "possibly reused" will have
@@ -687,8 +705,8 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
 class StorageAllocator : public StorageAllocatorBaseVisitor {
  public:
   explicit StorageAllocator(std::unordered_map<const ExprNode*, Tokens> token_map,
-                            arith::Analyzer* analyzer)
-      : allocator_(analyzer) {
+                            arith::Analyzer* analyzer, bool plan_arena)
+      : allocator_(analyzer), plan_arena_(plan_arena) {
     this->token_map_ = std::move(token_map);
   }
 
@@ -700,6 +718,8 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
       }
       // Clear the allocator to make the planning of different functions independent.
       allocator_.Clear();
+      token2lifetime_.clear();
+      token2arena_member_.clear();
       this->VisitExpr_(func);
     }
   }
@@ -711,6 +731,17 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
   std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token;
   /*! \brief The mapping from each binding block to the storage tokens that are create inside. */
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens;
+  /*!
+   * \brief The byte offset of each `builtin.alloc_tensor` in the arena that it is planned into.
+   * The tensors that are not planned into an arena are at offset 0 of their storage.
+   */
+  std::unordered_map<const ExprNode*, int64_t> alloc_tensor2offset;
+  /*!
+   * \brief The arenas and their device indices that the branches of each If allocate from, which
+   * are to be allocated before the If.
+   */
+  std::unordered_map<const VarBindingNode*, std::vector<std::pair<StorageToken, PrimValue>>>
+      if_binding2arenas;
 
  private:
   using ExprVisitor::VisitBinding_;
@@ -723,10 +754,15 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
     for (const StorageTokenNode* token : block2tokens[block]) {
       ICHECK_EQ(token->ref_counter, 0);
     }
+    if (plan_arena_) {
+      PlanArenas(block);
+    }
   }
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
     static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    // The bindings are numbered to record the lifetime of the tokens in an arena.
+    ++n_binding_;
     if (call->op == alloc_tensor_op) {
       auto it = token_map_.find(call);
       ICHECK(it != token_map_.end());
@@ -741,6 +777,11 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
       // Record that this alloc_tensor is using the token.
       alloc_tensor2token.insert({call, new_token});
+      if (token2lifetime_.count(new_token.get())) {
+        ArenaMember& member = token2arena_member_[new_token.get()];
+        member.alloc_tensors.emplace_back(call, 0);
+        member.device_index = Downcast<PrimValue>(call->args[2]);
+      }
       token2cur_tensor_[new_token.get()].push_back(binding->var);
       SetTokens(call, Tokens(new_token));
       // Record that the token is allocated in the current block.
@@ -777,8 +818,37 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
     }
   }
 
+  void VisitBinding_(const VarBindingNode* binding, const IfNode* if_node) final {
+    if (!plan_arena_) {
+      ExprVisitor::VisitBinding_(binding, if_node);
+      return;
+    }
+    // The arenas of the branches are planned into one token of the current block per device,
+    // which is as large as the largest of them and alive during the whole If.
+    int begin = ++n_binding_;
+    if_regions_.emplace_back();
+    ExprVisitor::VisitBinding_(binding, if_node);
+    std::map<int64_t, IfRegion> regions = std::move(if_regions_.back());
+    if_regions_.pop_back();
+    ICHECK(!block_stack_.empty());
+    for (auto& [device_index, region] : regions) {
+      StorageToken token({IntImm(DataType::Int(64), region.bytes)}, DataType::UInt(8), "global");
+      token = allocator_.Alloc(token, this->n_storage_++);
+      token2lifetime_[token.get()] = {begin, n_binding_};
+      token2arena_member_[token.get()] = {std::move(region.alloc_tensors), region.device_index,
+                                          binding};
+      block2tokens[block_stack_.back()].push_back(token.get());
+    }
+  }
+
   /*! \brief Request a storage reuse, or allocate storage if no appropriate storage is reusable. */
   StorageToken RequestReuseOrAlloc(StorageToken prototype) {
+    // The tokens of an arena are never reused. Instead, the arena packs them by their lifetimes.
+    if (plan_arena_ && prototype->storage_scope == "global" && prototype->const_bytes() != -1) {
+      StorageToken token = allocator_.Alloc(prototype, this->n_storage_++);
+      token2lifetime_[token.get()] = {n_binding_, n_binding_};
+      return token;
+    }
     Optional<StorageToken> token = allocator_.RequestReuse(prototype);
     if (!token.defined()) {
       return allocator_.Alloc(prototype, this->n_storage_++);
@@ -797,17 +867,162 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
     ICHECK_GE(token->ref_counter, 0);
 
     if (token->ref_counter == 0) {
-      allocator_.Release(token);
+      auto it_lifetime = token2lifetime_.find(token.get());
+      if (it_lifetime != token2lifetime_.end()) {
+        it_lifetime->second.second = n_binding_;
+      } else {
+        allocator_.Release(token);
+      }
       auto it = token2cur_tensor_.find(token.get());
       ICHECK(it != token2cur_tensor_.end());
       token2cur_tensor_.erase(it);
     }
   }
 
+  /*!
+   * \brief Place the arena tokens created in a binding block into one arena per device. Inside
+   * the branches of an If, the arenas are passed to the enclosing block instead.
+   * \param block The binding block whose tokens are all released.
+   */
+  void PlanArenas(const BindingBlockNode* block) {
+    std::vector<const StorageTokenNode*>& block_tokens = block2tokens[block];
+    std::map<int64_t, std::vector<const StorageTokenNode*>> device2members;
+    std::vector<const StorageTokenNode*> new_block_tokens;
+    for (const StorageTokenNode* token : block_tokens) {
+      auto it = token2arena_member_.find(token);
+      if (it != token2arena_member_.end()) {
+        device2members[GetDeviceIndex(it->second.device_index)].push_back(token);
+      } else {
+        new_block_tokens.push_back(token);
+      }
+    }
+    for (auto& [device_index, members] : device2members) {
+      // Step 1. Plan the offsets both by decreasing sizes and by the allocation order.
+      std::vector<const StorageTokenNode*> by_size = members;
+      std::stable_sort(by_size.begin(), by_size.end(),
+                       [](const StorageTokenNode* a, const StorageTokenNode* b) {
+                         return a->const_bytes() > b->const_bytes();
+                       });
+      std::unordered_map<const StorageTokenNode*, int64_t> offsets;
+      int64_t arena_bytes = PlaceGreedily(by_size, &offsets);
+      std::unordered_map<const StorageTokenNode*, int64_t> offsets_in_order;
+      int64_t arena_bytes_in_order = PlaceGreedily(members, &offsets_in_order);
+      if (arena_bytes_in_order < arena_bytes) {
+        arena_bytes = arena_bytes_in_order;
+        offsets = std::move(offsets_in_order);
+      }
+      // Step 2. The blocks of the branches run one after another and release all their tokens,
+      // so that they share one region in the arena of the enclosing block.
+      if (!if_regions_.empty()) {
+        IfRegion& region = if_regions_.back()[device_index];
+        region.bytes = std::max(region.bytes, arena_bytes);
+        region.device_index = token2arena_member_[members[0]].device_index;
+        for (const StorageTokenNode* token : members) {
+          for (const auto& [alloc_tensor, offset] : token2arena_member_[token].alloc_tensors) {
+            region.alloc_tensors.emplace_back(alloc_tensor, offsets[token] + offset);
+          }
+        }
+        continue;
+      }
+      // Step 3. Redirect the alloc_tensors to the arena.
+      StorageToken arena({IntImm(DataType::Int(64), arena_bytes)}, DataType::UInt(8), "global");
+      arena = allocator_.Alloc(arena, this->n_storage_++);
+      for (const StorageTokenNode* token : members) {
+        const ArenaMember& member = token2arena_member_[token];
+        for (const auto& [alloc_tensor, offset] : member.alloc_tensors) {
+          alloc_tensor2token.at(alloc_tensor) = arena;
+          alloc_tensor2offset[alloc_tensor] = offsets[token] + offset;
+        }
+        if (member.if_binding != nullptr) {
+          if_binding2arenas[member.if_binding].emplace_back(arena, member.device_index);
+        }
+      }
+      new_block_tokens.push_back(arena.get());
+    }
+    block_tokens = std::move(new_block_tokens);
+  }
+
+  /*!
+   * \brief Place each token at the lowest offset where it overlaps none of the tokens placed
+   * before it and alive at the same time.
+   * \param tokens The tokens in the order to be placed.
+   * \param offsets The offset of each token to be set.
+   * \return The number of bytes of the arena.
+   */
+  int64_t PlaceGreedily(const std::vector<const StorageTokenNode*>& tokens,
+                        std::unordered_map<const StorageTokenNode*, int64_t>* offsets) {
+    auto f_aligned_bytes = [](const StorageTokenNode* token) {
+      int64_t alignment = runtime::kAllocAlignment;
+      return (token->const_bytes() + alignment - 1) / alignment * alignment;
+    };
+    int64_t arena_bytes = 0;
+    std::vector<const StorageTokenNode*> placed;
+    for (const StorageTokenNode* token : tokens) {
+      auto [begin, end] = token2lifetime_.at(token);
+      std::vector<std::pair<int64_t, int64_t>> conflicts;
+      for (const StorageTokenNode* other : placed) {
+        auto [other_begin, other_end] = token2lifetime_.at(other);
+        if (begin <= other_end && other_begin <= end) {
+          int64_t other_offset = offsets->at(other);
+          conflicts.emplace_back(other_offset, other_offset + f_aligned_bytes(other));
+        }
+      }
+      std::sort(conflicts.begin(), conflicts.end());
+      int64_t bytes = f_aligned_bytes(token);
+      int64_t offset = 0;
+      for (const auto& [conflict_begin, conflict_end] : conflicts) {
+        if (offset + bytes <= conflict_begin) {
+          break;
+        }
+        offset = std::max(offset, conflict_end);
+      }
+      (*offsets)[token] = offset;
+      arena_bytes = std::max(arena_bytes, offset + bytes);
+      placed.push_back(token);
+    }
+    return arena_bytes;
+  }
+
+  /*! \brief Get the constant device index of a `builtin.alloc_tensor`. */
+  static int64_t GetDeviceIndex(const PrimValue& runtime_device_index) {
+    const auto* index = runtime_device_index->value.as<IntImmNode>();
+    ICHECK(index != nullptr)
+        << "The runtime device index of alloc_tensor is expected to be constant";
+    return index->value;
+  }
+
   /*! \brief Number of allocated storages. */
   int n_storage_{0};
+  /*! \brief Number of visited bindings. */
+  int n_binding_{0};
   /*! \brief The 1D memory allocator. */
   TokenAllocator1D allocator_;
+  /*! \brief Whether to plan the constant-sized tokens into arenas. */
+  bool plan_arena_;
+  /*! \brief The first and the last binding where each arena token is alive. */
+  std::unordered_map<const StorageTokenNode*, std::pair<int, int>> token2lifetime_;
+  /*! \brief The alloc_tensors that an arena token stands for. */
+  struct ArenaMember {
+    /*! \brief The alloc_tensors and their offsets relative to the token. */
+    std::vector<std::pair<const ExprNode*, int64_t>> alloc_tensors;
+    /*! \brief The runtime device index of the alloc_tensors. */
+    PrimValue device_index;
+    /*! \brief The binding of the If whose branches are planned into the token, if any. */
+    const VarBindingNode* if_binding{nullptr};
+  };
+  /*! \brief The arenas planned in the branches of an If on one device. */
+  struct IfRegion {
+    /*! \brief The number of bytes of the largest arena. */
+    int64_t bytes{0};
+    /*! \brief The alloc_tensors of all the arenas and their offsets relative to the region. */
+    std::vector<std::pair<const ExprNode*, int64_t>> alloc_tensors;
+    /*! \brief The runtime device index of the alloc_tensors. */
+    PrimValue device_index;
+  };
+  /*! \brief The alloc_tensors of each arena token. */
+  std::unordered_map<const StorageTokenNode*, ArenaMember> token2arena_member_;
+  /*! \brief The regions of the Ifs being visited, per device index. */
+  std::vector<std::map<int64_t, IfRegion>> if_regions_;
   /*! \brief The mapping from each token to the tensors that are currently using it. */
   std::unordered_map<const StorageTokenNode*, std::vector<Var>> token2cur_tensor_;
 };
@@ -823,10 +1038,15 @@ class StorageAllocationRewriter : public ExprMutator {
   explicit StorageAllocationRewriter(
       IRModule mod, std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token,
       std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>>
-          block2tokens)
+          block2tokens,
+      std::unordered_map<const ExprNode*, int64_t> alloc_tensor2offset,
+      std::unordered_map<const VarBindingNode*, std::vector<std::pair<StorageToken, PrimValue>>>
+          if_binding2arenas)
       : ExprMutator(std::move(mod)),
         alloc_tensor2token_(std::move(alloc_tensor2token)),
-        block2tokens_(std::move(block2tokens)) {}
+        block2tokens_(std::move(block2tokens)),
+        alloc_tensor2offset_(std::move(alloc_tensor2offset)),
+        if_binding2arenas_(std::move(if_binding2arenas)) {}
 
   IRModule Rewrite() {
     const IRModule& mod = builder_->GetContextIRModule();
@@ -852,8 +1072,42 @@ class StorageAllocationRewriter : public ExprMutator {
   }
 
  private:
+  using ExprMutator::VisitBinding_;
   using ExprMutator::VisitExpr_;
 
+  void VisitBinding_(const VarBindingNode* binding, const IfNode* if_node) final {
+    // The arenas shared by the branches are allocated before the If, so that they are visible in
+    // both branches.
+    auto it = if_binding2arenas_.find(binding);
+    if (it != if_binding2arenas_.end()) {
+      for (const auto& [arena, device_index] : it->second) {
+        GetOrAllocStorage(arena, device_index);
+      }
+    }
+    ExprMutator::VisitBinding_(binding, if_node);
+  }
+
+  /*!
+   * rief Get the storage var of a token, creating a `memory.alloc_storage` for it if the token
+   * is visited for the first time.
+   */
+  Var GetOrAllocStorage(const StorageToken& token, const PrimValue& virtual_device_index) {
+    static const Op& mem_alloc_storage = Op::Get("relax.memory.alloc_storage");
+    auto it_token = token2storage_var_.find(token.get());
+    if (it_token != token2storage_var_.end()) {
+      return it_token->second;
+    }
+    ShapeExpr size({token->bytes});
+    DataType dtype = token->dtype;
+    Call alloc_storage(mem_alloc_storage,
+                       {std::move(size), virtual_device_index, StringImm(token->storage_scope),
+                        DataTypeImm(dtype)},
+                       Attrs());
+    Var storage_var = builder_->Emit(alloc_storage, "storage");
+    token2storage_var_[token.get()] = storage_var;
+    return storage_var;
+  }
+
   Expr VisitExpr_(const CallNode* call) final {
     static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
     static const Op& mem_alloc_storage = Op::Get("relax.memory.alloc_storage");
@@ -869,25 +1123,12 @@ class StorageAllocationRewriter : public ExprMutator {
 
       // If the token is visited for the first time, create a storage variable using
       // `memory.alloc_storage` for it.
-      StorageToken token = it->second;
-      Var storage_var{nullptr};
-      auto it_token = token2storage_var_.find(token.get());
-      if (it_token == token2storage_var_.end()) {
-        ShapeExpr size({token->bytes});
-        PrimValue virtual_device_index = runtime_device_index;
-        DataType dtype = token->dtype;
-        Call alloc_storage(mem_alloc_storage,
-                           {std::move(size), virtual_device_index, StringImm(token->storage_scope),
-                            DataTypeImm(dtype)},
-                           Attrs());
-        storage_var = builder_->Emit(alloc_storage, "storage");
-        token2storage_var_[token.get()] = storage_var;
-      } else {
-        storage_var = it_token->second;
-      }
+      Var storage_var = GetOrAllocStorage(it->second, runtime_device_index);
 
       // And always create a `memory.alloc_tensor` for the old `builtin.alloc_tensor`.
-      PrimValue offset = PrimValue::Int64(0);
+      auto it_offset = alloc_tensor2offset_.find(call);
+      PrimValue offset =
+          PrimValue::Int64(it_offset != alloc_tensor2offset_.end() ? it_offset->second : 0);
       DataType dtype = sinfo->dtype;
       return Call(mem_alloc_tensor, {storage_var, offset, sinfo->shape.value(), DataTypeImm(dtype)},
                   Attrs());
@@ -940,23 +1181,36 @@ class StorageAllocationRewriter : public ExprMutator {
   std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token_;
   /*! \brief The mapping from each binding block to the storage tokens that are create inside. */
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens_;
+  /*! \brief The byte offset of each `builtin.alloc_tensor` planned into an arena. */
+  std::unordered_map<const ExprNode*, int64_t> alloc_tensor2offset_;
+  /*! \brief The arenas to be allocated before each If. */
+  std::unordered_map<const VarBindingNode*, std::vector<std::pair<StorageToken, PrimValue>>>
+      if_binding2arenas_;
   /*! \brief The mapping from each token to its corresponding storage var in each function. */
   std::unordered_map<const StorageTokenNode*, Var> token2storage_var_;
 };
 
-IRModule StaticPlanBlockMemory(IRModule mod) {
+IRModule StaticPlanBlockMemory(IRModule mod, bool plan_arena) {
   arith::Analyzer ana;
 
+  // Step 0. Inline the private functions, so that their intermediate tensors are planned into the
+  // arenas of the callers.
+  if (plan_arena) {
+    mod = transform::InlinePrivateFunctions()(std::move(mod));
+  }
+
   // Step 1. Initialize.
   std::unordered_map<const ExprNode*, Tokens> token_map =
       StorageAllocatorInit::Initialize(mod, &ana);
   // Step 2. Collect the memory allocation info.
-  StorageAllocator allocator(std::move(token_map), &ana);
+  StorageAllocator allocator(std::move(token_map), &ana, plan_arena);
   allocator.Allocate(mod);
   // Step 3. Rewrite the function.
   StorageAllocationRewriter rewriter(std::move(mod),  //
                                      std::move(allocator.alloc_tensor2token),
-                                     std::move(allocator.block2tokens));
+                                     std::move(allocator.block2tokens),
+                                     std::move(allocator.alloc_tensor2offset),
+                                     std::move(allocator.if_binding2arenas));
   return rewriter.Rewrite();
 }
 
@@ -964,7 +1218,10 @@ namespace transform {
 
 Pass StaticPlanBlockMemory() {
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
-      [=](IRModule m, PassContext pc) { return relax::StaticPlanBlockMemory(std::move(m)); };
+      [=](IRModule m, PassContext pc) {
+        bool plan_arena = pc->GetConfig<Bool>("relax.memory_plan_arena", Bool(false)).value();
+        return relax::StaticPlanBlockMemory(std::move(m), plan_arena);
+      };
   return CreateModulePass(pass_func, /*opt_level=*/0, "StaticPlanBlockMemory", {});
 }
 
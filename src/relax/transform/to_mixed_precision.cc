@@ -26,12 +26,18 @@
 #include <tvm/relax/transform.h>
 
 #include <array>
+#include <cmath>
 #include <cstdint>
+#include <string>
 #include <unordered_set>
+#include <utility>
 
 #include "../op/nn/convolution.h"
+#include "../op/tensor/binary.h"
 #include "../op/tensor/datatype.h"
 #include "../op/tensor/linear_algebra.h"
+#include "../op/tensor/statistical.h"
+#include "../op/tensor/unary.h"
 #include "infer_amp_utils.h"
 #include "utils.h"
 
@@ -50,6 +56,19 @@ int GetMixedPrecisionInfo(const CallNode* call_node) {
   return attr_map.count(op) ? attr_map[op] : MixedPrecisionPolicyKind::kNever;
 }
 
+/*!
+ * \brief Get the policy of a binding, where the ops bound to the vars in fp32_var_names, e.g. those
+ * found numerically sensitive by calibration, are kept in fp32.
+ */
+int GetMixedPrecisionInfo(const VarBindingNode* binding, const CallNode* call_node,
+                          const std::unordered_set<std::string>& fp32_var_names) {
+  int policy = GetMixedPrecisionInfo(call_node);
+  if (policy != -1 && fp32_var_names.count(binding->var->name_hint())) {
+    return MixedPrecisionPolicyKind::kNever;
+  }
+  return policy;
+}
+
 /*!
  * \brief Main logic to automatically cast fp32 input modules to fp16 for certain ops.
  *
@@ -78,6 +97,16 @@ int GetMixedPrecisionInfo(const CallNode* call_node) {
  * Note that in this case, we will actively cast the arg to fp16 only when it's used in kAlways.
  * This is to ensure that we have numerical stability to the best effort.
  *
+ * The policy of an op can be overridden per binding: the ops bound to the vars named in
+ * fp32_var_names are kNever. The names are usually the ones found numerically sensitive on sample
+ * data by tvm.relax.transform.calibrate_mixed_precision, which keeps just enough ops in fp32 to
+ * meet an accuracy budget instead of relying on the fixed per-op policies alone.
+ *
+ * When matmul_dtype is a float8 type, the kAlways matmuls are further quantized to float8, each
+ * input with a per-tensor scale amax(|x|) / max(float8). The matmul accumulates in output_dtype
+ * and its result is multiplied by the product of the two scales, so that the float8 matmul is a
+ * drop-in replacement of the fp16 one.
+ *
  * DTypeDecisionCollector:
  *   Note that if some tensor is only used in kAlways ops, we can store it in fp16 without worsening
  *   numerical stability or using more storage. We use a backward propagation pass to detect such
@@ -116,10 +145,13 @@ int GetMixedPrecisionInfo(const CallNode* call_node) {
  */
 class DTypeDecisionCollector : public ExprVisitor {
  public:
-  explicit DTypeDecisionCollector(DataType output_dtype) : output_dtype_(output_dtype) {}
+  explicit DTypeDecisionCollector(DataType output_dtype,
+                                  const std::unordered_set<std::string>& fp32_var_names)
+      : output_dtype_(output_dtype), fp32_var_names_(fp32_var_names) {}
 
-  static VarDTypeMap Collect(Function func, DataType output_dtype) {
-    DTypeDecisionCollector collector(output_dtype);
+  static VarDTypeMap Collect(Function func, DataType output_dtype,
+                             const std::unordered_set<std::string>& fp32_var_names) {
+    DTypeDecisionCollector collector(output_dtype, fp32_var_names);
     collector.VisitExpr(func);
     return std::move(collector.only_fp16_map_);
   }
@@ -191,7 +223,7 @@ class DTypeDecisionCollector : public ExprVisitor {
   void VisitExpr_(const VarNode* op) final { VisitVars_(op); }
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* call_node) final {
-    auto policy = GetMixedPrecisionInfo(call_node);
+    auto policy = GetMixedPrecisionInfo(binding, call_node, fp32_var_names_);
     if (policy == -1) {
       ExprVisitor::VisitBinding_(binding, call_node);
       return;
@@ -267,16 +299,21 @@ class DTypeDecisionCollector : public ExprVisitor {
   DataType fp16_ = DataType(DataType::TypeCode::kFloat, 16, 1);
   DataType fp32_ = DataType(DataType::TypeCode::kFloat, 32, 1);
   DataType output_dtype_;
+  const std::unordered_set<std::string>& fp32_var_names_;
   VarDTypeMap only_fp16_map_;
 };
 
 class ToMixedPrecisionRewriter : public ExprMutator {
  public:
   explicit ToMixedPrecisionRewriter(const VarDTypeMap* only_fp16_map, DataType output_dtype,
-                                    const std::unordered_set<std::string>& fp16_input_names)
+                                    const std::unordered_set<std::string>& fp16_input_names,
+                                    const std::unordered_set<std::string>& fp32_var_names,
+                                    DataType matmul_dtype)
       : only_fp16_map_(only_fp16_map),
         output_dtype_(output_dtype),
-        fp16_input_names_(fp16_input_names) {}
+        fp16_input_names_(fp16_input_names),
+        fp32_var_names_(fp32_var_names),
+        matmul_dtype_(matmul_dtype) {}
 
  private:
   Var GetRemapped(const Var& var) {
@@ -431,6 +468,37 @@ class ToMixedPrecisionRewriter : public ExprMutator {
     }
   }
 
+  /*!
+   * \brief Quantize a tensor to matmul_dtype_ with a per-tensor scale.
+   * \return The quantized tensor, and its fp32 scalar scale.
+   */
+  std::pair<Expr, Expr> QuantizeToFP8(const Expr& x) {
+    DataType dtype = GetStructInfoAs<TensorStructInfoNode>(x)->dtype;
+    double fp8_max = matmul_dtype_.is_e4m3_float8() ? 448.0 : 57344.0;
+    // Keep all-zero tensors from dividing by zero, 2^-14 is the smallest normal fp16
+    Expr amax = builder_->Emit(astype(max(abs(x), NullOpt, false), fp32_));
+    Expr min_amax = MakeConstantScalar(std::ldexp(1.0, -14), fp32_);
+    Expr scale =
+        builder_->Emit(divide(maximum(amax, min_amax), MakeConstantScalar(fp8_max, fp32_)));
+    Expr scaled = divide(x, astype(scale, dtype));
+    // Rounding may push the largest elements just beyond the range of float8
+    Expr clipped = clip(scaled, PrimValue(FloatImm(dtype, -fp8_max)),
+                        PrimValue(FloatImm(dtype, fp8_max)));
+    return {builder_->Emit(astype(clipped, matmul_dtype_)), scale};
+  }
+
+  /*! \brief Rewrite a matmul to quantize its inputs to float8 and dequantize its output. */
+  Expr RewriteMatmulToFP8(const Call& call) {
+    auto [lhs, lhs_scale] = QuantizeToFP8(call->args[0]);
+    auto [rhs, rhs_scale] = QuantizeToFP8(call->args[1]);
+    Expr out = builder_->Emit(matmul(lhs, rhs, output_dtype_));
+    Expr scale = multiply(lhs_scale, rhs_scale);
+    if (output_dtype_ != fp32_) {
+      scale = astype(scale, output_dtype_);
+    }
+    return builder_->Normalize(multiply(out, scale));
+  }
+
   Expr VisitVar_(const Var& var) {
     // We rewrite the remapped var to the original dtype
     auto it = var_remap_.find(var->vid);
@@ -460,7 +528,7 @@ class ToMixedPrecisionRewriter : public ExprMutator {
       ExprMutator::VisitBinding_(binding, call_node);
       return;
     }
-    auto policy = GetMixedPrecisionInfo(call_node);
+    auto policy = GetMixedPrecisionInfo(binding, call_node, fp32_var_names_);
     if (policy == -1) {
       // not an op call
       ExprMutator::VisitBinding_(binding, call_node);
@@ -495,7 +563,12 @@ class ToMixedPrecisionRewriter : public ExprMutator {
     }
     new_call->args = std::move(RewriteArgs(new_call->args, to));
     new_call->struct_info_ = NullOpt;
-    Expr new_value = builder_->Normalize(Call(new_call));
+    Expr new_value;
+    if (policy == kAlways && matmul_dtype_.is_float8() && op.same_as(matmul_op)) {
+      new_value = RewriteMatmulToFP8(Call(new_call));
+    } else {
+      new_value = builder_->Normalize(Call(new_call));
+    }
     if (policy == kAlways && binding->var->IsInstance<DataflowVarNode>()) {
       // kAlways: store the tensors to fp16
       // But global vars will be stored to the original dtype anyway (see below)
@@ -577,27 +650,47 @@ class ToMixedPrecisionRewriter : public ExprMutator {
   DataType output_dtype_;
   Array<Var> params_;
   std::unordered_set<std::string> fp16_input_names_;
+  const std::unordered_set<std::string>& fp32_var_names_;
+  DataType matmul_dtype_;
 
   const Op& wrap_param_op = Op::Get("relax.wrap_param");
+  const Op& matmul_op = Op::Get("relax.matmul");
 };
 
 Expr ToMixedPrecision(const Function& f, const DataType& out_dtype,
-                      Optional<Array<String>> fp16_input_names) {
-  VarDTypeMap only_fp16_map = std::move(DTypeDecisionCollector::Collect(f, out_dtype));
+                      Optional<Array<String>> fp16_input_names,
+                      Optional<Array<String>> fp32_var_names, Optional<String> matmul_dtype) {
   std::unordered_set<std::string> fp16_input_names_set;
   if (fp16_input_names) {
     fp16_input_names_set.insert(fp16_input_names.value().begin(), fp16_input_names.value().end());
   }
-  ToMixedPrecisionRewriter mutator(&only_fp16_map, out_dtype, fp16_input_names_set);
+  std::unordered_set<std::string> fp32_var_names_set;
+  if (fp32_var_names) {
+    fp32_var_names_set.insert(fp32_var_names.value().begin(), fp32_var_names.value().end());
+  }
+  DataType matmul_dtype_value = DataType::Float(16);
+  if (matmul_dtype) {
+    matmul_dtype_value = DataType(String2DLDataType(matmul_dtype.value()));
+    CHECK(matmul_dtype_value == DataType::Float(16) || matmul_dtype_value.is_float8())
+        << "ValueError: The matmul dtype of ToMixedPrecision must be float16, e4m3_float8 or "
+           "e5m2_float8, but got "
+        << matmul_dtype.value();
+  }
+  VarDTypeMap only_fp16_map =
+      std::move(DTypeDecisionCollector::Collect(f, out_dtype, fp32_var_names_set));
+  ToMixedPrecisionRewriter mutator(&only_fp16_map, out_dtype, fp16_input_names_set,
+                                   fp32_var_names_set, matmul_dtype_value);
   return mutator(f);
 }
 
 namespace transform {
 
-Pass ToMixedPrecision(const DataType& out_dtype, Optional<Array<String>> fp16_input_names) {
+Pass ToMixedPrecision(const DataType& out_dtype, Optional<Array<String>> fp16_input_names,
+                      Optional<Array<String>> fp32_var_names, Optional<String> matmul_dtype) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(ToMixedPrecision(f, out_dtype, fp16_input_names));
+        return Downcast<Function>(
+            ToMixedPrecision(f, out_dtype, fp16_input_names, fp32_var_names, matmul_dtype));
       };
   return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {});
 }
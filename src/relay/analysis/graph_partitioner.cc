@@ -19,6 +19,8 @@
 
 #include "./graph_partitioner.h"
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 
 namespace tvm {
@@ -100,6 +102,7 @@ DominatorTree::Node* DominatorTree::GetNode(support::Arena* arena,
 
 std::vector<GraphPartitioner::Group*> GraphPartitioner::Partition(
     const IndexedForwardGraph& graph) {
+  graph_ = &graph;
   this->InitGroups(graph);
   if (opt_level_ == 0) return std::move(groups_);
   // get post dominator tree
@@ -197,7 +200,36 @@ void GraphPartitioner::CommitFuse_(IndexedForwardGraph::Node* src, IndexedForwar
   }
 }
 
+bool GraphPartitioner::AcceptFuse(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink) {
+  // Step 1. Collect the groups on the paths from src to sink, as merged by CommitFuse_
+  std::vector<Group*> roots{groups_[sink->index]->FindRoot()};
+  std::function<void(IndexedForwardGraph::Node*)> f_collect = [&](IndexedForwardGraph::Node* node) {
+    if (node == sink || visited_.count(node)) return;
+    visited_.insert(node);
+    Group* root = groups_[node->index]->FindRoot();
+    if (std::find(roots.begin(), roots.end(), root) == roots.end()) {
+      roots.push_back(root);
+    }
+    for (auto link = node->outputs.head; link != nullptr; link = link->next) {
+      f_collect(link->value.node);
+    }
+  };
+  visited_.clear();
+  f_collect(src);
+  // Step 2. Collect the nodes of each group
+  std::vector<std::vector<const tvm::Object*>> members(roots.size());
+  for (size_t nid = 0; nid < groups_.size(); ++nid) {
+    auto it = std::find(roots.begin(), roots.end(), groups_[nid]->FindRoot());
+    if (it != roots.end()) {
+      members[it - roots.begin()].push_back(graph_->post_dfs_order[nid]->ref);
+    }
+  }
+  return faccept_fuse_(members);
+}
+
 void GraphPartitioner::CommitFuse(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink) {
+  // The postponed fusion is decided when it is committed
+  if (faccept_fuse_ != nullptr && postpone_node_ == nullptr && !AcceptFuse(src, sink)) return;
   Group* target = groups_[sink->index];
   visited_.clear();
   ICHECK(src != sink);
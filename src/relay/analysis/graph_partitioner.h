@@ -27,6 +27,7 @@
 
 #include <tvm/relay/op_attr_types.h>
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -162,12 +163,19 @@ class DominatorTree {
  */
 class GraphPartitioner {
  public:
+  /*!
+   * \brief The function deciding whether to commit a fusion. It is given the nodes of each group
+   * to be merged, in post-DFS order, the group of the post-dominator being the first one.
+   */
+  using FAcceptFuse = std::function<bool(const std::vector<std::vector<const tvm::Object*>>&)>;
+
   explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth,
-                            size_t max_function_args)
+                            size_t max_function_args, FAcceptFuse faccept_fuse = nullptr)
       : arena_(arena),
         opt_level_(opt_level),
         max_fuse_depth_(max_fuse_depth),
-        max_function_args_(max_function_args) {}
+        max_function_args_(max_function_args),
+        faccept_fuse_(std::move(faccept_fuse)) {}
   /*!
    * \brief Group as a union find data structure.
    */
@@ -215,6 +223,10 @@ class GraphPartitioner {
   size_t max_fuse_depth_;
   /*! \brief The maximum number of arguments in one fused function */
   size_t max_function_args_;
+  /*! \brief The function deciding whether to commit a fusion, or null to always commit. */
+  FAcceptFuse faccept_fuse_;
+  /*! \brief The graph being partitioned. */
+  const IndexedForwardGraph* graph_{nullptr};
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
   /*! \brief internal field used for deduplication */
@@ -254,6 +266,14 @@ class GraphPartitioner {
    */
   void MergeFromTo(Group* child, Group* parent);
 
+  /*!
+   * \brief Check whether faccept_fuse_ accepts the fusion of src into sink.
+   * \param src The source node.
+   * \param sink The termination node.
+   * \note sink must be a post-dominator of src.
+   */
+  bool AcceptFuse(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink);
+
   // Internal implementation of CommitFuse
   void CommitFuse_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink, Group* target);
 
@@ -390,6 +390,14 @@ class TECompilerImpl : public TECompilerNode {
     With<Target> target_scope(key->target);
 
     ICHECK(!value->cached_func.defined());
+    std::optional<CCacheDiskEntry> disk_entry = CCacheDiskEntry::Create(key);
+    if (disk_entry) {
+      if (Optional<CachedFunc> cached_func = disk_entry->Load(key, global_var_supply)) {
+        VLOG(1) << "loaded from the disk cache";
+        value->cached_func = cached_func.value();
+        return value;
+      }
+    }
     value->cached_func =
         PrimFuncFor(key->source_func, key->target, global_var_supply, constant_name_supply_);
 
@@ -464,6 +472,9 @@ class TECompilerImpl : public TECompilerNode {
             << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
             << "with definitions:" << std::endl
             << PrettyPrint(value->cached_func->funcs);
+    if (disk_entry) {
+      disk_entry->Save(key, value->cached_func, global_var_supply);
+    }
 
     return value;
   }
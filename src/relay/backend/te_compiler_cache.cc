@@ -19,11 +19,13 @@
 
 #include "./te_compiler_cache.h"
 
+#include <dmlc/memory_io.h>
 #include <tvm/arith/analyzer.h>
 #include <tvm/driver/driver_api.h>
 #include <tvm/ir/name_supply.h>
 #include <tvm/ir/type_functor.h>
 #include <tvm/meta_schedule/database.h>
+#include <tvm/node/serialization.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/device_copy.h>
 #include <tvm/relay/expr.h>
@@ -32,6 +34,7 @@
 #include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/op_strategy.h>
 #include <tvm/runtime/builtin_fp16.h>
+#include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/te/operation.h>
@@ -44,10 +47,17 @@
 #include <tvm/tir/transform.h>
 #include <tvm/topi/tags.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <random>
+#include <sstream>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -56,6 +66,7 @@
 #include "../op/memory/memory.h"
 #include "../src/meta_schedule/module_equality.h"
 #include "../src/meta_schedule/trace_apply.h"
+#include "../../support/utils.h"
 #include "../transforms/meta_schedule_layout_rewrite.h"
 #include "utils.h"
 
@@ -68,6 +79,11 @@ TVM_REGISTER_NODE_TYPE(CachedFuncNode);
 TVM_REGISTER_NODE_TYPE(CCacheKeyNode);
 TVM_REGISTER_NODE_TYPE(CCacheValueNode);
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.te_compiler_cache_dir", String);
+
+/*! \brief The magic number at the beginning of every TE compiler cache file. */
+constexpr uint64_t kTECompilerCacheMagic = 0x54564D5445434348;
+
 LoweredOutput::LoweredOutput(tvm::Array<te::Tensor> outputs, OpImplementation impl) {
   auto n = make_object<LoweredOutputNode>();
   n->outputs = std::move(outputs);
@@ -1088,6 +1104,131 @@ CachedFunc ShapeFuncFor(const Function& prim_func, const Target& target,
   return MakeShapeFunc().Create(prim_func, target, global_var_supply);
 }
 
+std::optional<CCacheDiskEntry> CCacheDiskEntry::Create(const CCacheKey& key) {
+  transform::PassContext pass_ctx = transform::PassContext::Current();
+  std::string cache_dir =
+      pass_ctx->GetConfig<String>("relay.backend.te_compiler_cache_dir", String("")).value();
+  if (cache_dir.empty()) {
+    const char* env_cache_dir = std::getenv("TVM_TE_COMPILER_CACHE_DIR");
+    if (env_cache_dir == nullptr || *env_cache_dir == '\0') {
+      return std::nullopt;
+    }
+    cache_dir = env_cache_dir;
+  }
+  // The custom lowering passes cannot be compared across processes, and the schedule records are
+  // not kept in the cache
+  if (pass_ctx->config.count("tir.add_lower_pass") ||
+      pass_ctx->GetConfig<Bool>("te.keep_schedule_record", Bool(false)).value()) {
+    return std::nullopt;
+  }
+  // Step 1. Describe everything but the primitive function that the lowering depends on
+  Array<ObjectRef> desc;
+  desc.push_back(String(TVM_VERSION));
+  desc.push_back(String(key->target->str()));
+  desc.push_back(key->virtual_device->memory_scope);
+  for (const Var& param : key->source_func->params) {
+    desc.push_back(param->virtual_device()->memory_scope);
+  }
+  desc.push_back(Integer(pass_ctx->opt_level));
+  desc.push_back(pass_ctx->required_pass);
+  desc.push_back(pass_ctx->disabled_pass);
+  std::vector<std::pair<String, ObjectRef>> config(pass_ctx->config.begin(),
+                                                   pass_ctx->config.end());
+  std::sort(config.begin(), config.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (const auto& kv : config) {
+    if (kv.first != "relay.backend.te_compiler_cache_dir" && kv.first != "tir.build_cache_dir") {
+      desc.push_back(Array<ObjectRef>{kv.first, kv.second});
+    }
+  }
+  // Step 2. Hash the description and the primitive function into the name of the cache file
+  CCacheDiskEntry entry;
+  entry.key_ = SaveJSON(desc);
+  uint64_t hash = support::HashCombine(std::hash<std::string>()(entry.key_),
+                                       StructuralHash()(key->source_func));
+  std::ostringstream os;
+  os << cache_dir << "/" << std::hex << hash << ".tvmte";
+  entry.path_ = os.str();
+  return entry;
+}
+
+Optional<CachedFunc> CCacheDiskEntry::Load(const CCacheKey& key,
+                                           GlobalVarSupply global_var_supply) const {
+  std::ifstream fs(path_, std::ios::in | std::ios::binary);
+  if (!fs) {
+    return NullOpt;
+  }
+  std::string data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  dmlc::MemoryStringStream reader(&data);
+  dmlc::Stream* stream = &reader;
+  uint64_t magic = 0;
+  std::string desc, source_json, name, funcs_json;
+  if (!stream->Read(&magic) || magic != kTECompilerCacheMagic || !stream->Read(&desc) ||
+      desc != key_ || !stream->Read(&source_json) || !stream->Read(&name) ||
+      !stream->Read(&funcs_json)) {
+    return NullOpt;
+  }
+  if (!StructuralEqual()(LoadJSON(source_json), key->source_func)) {
+    return NullOpt;
+  }
+  IRModule funcs = Downcast<IRModule>(LoadJSON(funcs_json));
+  if (funcs->functions.size() != 1) {
+    return NullOpt;
+  }
+  // The lowered function is renamed, so that it stays unique in the module being compiled
+  tir::PrimFunc prim_func = Downcast<tir::PrimFunc>((*funcs->functions.begin()).second);
+  GlobalVar prim_fn_var = global_var_supply->FreshGlobal(name);
+  prim_fn_var->checked_type_ = key->source_func->checked_type();
+  prim_func = WithAttr(std::move(prim_func), tvm::attr::kGlobalSymbol, prim_fn_var->name_hint);
+  IRModule lowered(Map<GlobalVar, BaseFunc>({}));
+  lowered->Add(prim_fn_var, prim_func);
+  return CachedFunc(key->target, prim_fn_var, {}, {}, te::Schedule{nullptr},
+                    tir::PrimFunc{nullptr}, {}, lowered);
+}
+
+void CCacheDiskEntry::Save(const CCacheKey& key, const CachedFunc& cached_func,
+                           GlobalVarSupply global_var_supply) const {
+  // The names of the bound constants are only unique within a compilation
+  if (cached_func->funcs->functions.size() != 1 || !cached_func->constant_tensors.empty() ||
+      !cached_func->funcs->Lookup(cached_func->prim_fn_var).as<tir::PrimFuncNode>()) {
+    return;
+  }
+  // Store the name without the prefix of the module, which is added back on load
+  std::string name = cached_func->prim_fn_var->name_hint;
+  std::string prefix = global_var_supply->name_supply_->prefix_;
+  if (!prefix.empty() && name.compare(0, prefix.size() + 1, prefix + "_") == 0) {
+    name = name.substr(prefix.size() + 1);
+  }
+  std::string data;
+  dmlc::MemoryStringStream writer(&data);
+  dmlc::Stream* stream = &writer;
+  stream->Write(kTECompilerCacheMagic);
+  stream->Write(key_);
+  stream->Write(SaveJSON(key->source_func));
+  stream->Write(name);
+  stream->Write(SaveJSON(cached_func->funcs));
+  // A failure to write the cache never fails the compilation
+  std::ostringstream tmp_path;
+  tmp_path << path_ << ".tmp" << std::random_device()();
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the TE compiler cache file " << tmp_path.str();
+      return;
+    }
+    fs.write(data.data(), data.size());
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the TE compiler cache file " << tmp_path.str();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path_.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the TE compiler cache file " << path_;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
 std::tuple<Array<te::Tensor>, Array<runtime::NDArray>, std::string> LowerTECompute(
     const Function& source_func, Target target, NameSupply constant_name_supply,
     bool return_inputs) {
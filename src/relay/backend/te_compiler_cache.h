@@ -36,6 +36,7 @@
 #include <tvm/topi/elemwise.h>
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -257,6 +258,49 @@ inline CachedFunc PrimFuncFor(const Function& source_func, const Target& target)
 CachedFunc ShapeFuncFor(const Function& prim_func, const Target& target,
                         GlobalVarSupply global_var_supply);
 
+/*!
+ * \brief An entry of the on-disk cache of the primitive functions lowered by the TE compiler,
+ * which is shared across compilations and processes.
+ *
+ * The cache is enabled by the pass config "relay.backend.te_compiler_cache_dir", or otherwise by
+ * the environment variable TVM_TE_COMPILER_CACHE_DIR, naming an existing directory. An entry is
+ * keyed on the structural hash of the primitive function, the target, the memory scopes, the pass
+ * context and the version of TVM, and holds the lowered PrimFunc. A hit skips the TE compute, the
+ * scheduling and the lowering, and is verified to be structurally equal to the primitive function.
+ * \note The tuning records applied while scheduling are not part of the key, so the cache
+ * directory has to be changed along with them.
+ */
+class CCacheDiskEntry {
+ public:
+  /*!
+   * \brief Create the cache entry of a primitive function.
+   * \param key The key of the function in the in-memory cache.
+   * \return The entry, or std::nullopt if the cache is disabled.
+   */
+  static std::optional<CCacheDiskEntry> Create(const CCacheKey& key);
+  /*!
+   * \brief Load the cached lowered function.
+   * \param key The key the entry was created from.
+   * \param global_var_supply The supply of the name of the lowered function.
+   * \return The lowered function, or NullOpt on a miss.
+   */
+  Optional<CachedFunc> Load(const CCacheKey& key, GlobalVarSupply global_var_supply) const;
+  /*!
+   * \brief Store a lowered function, if it consists of a single PrimFunc.
+   * \param key The key the entry was created from.
+   * \param cached_func The lowered function.
+   * \param global_var_supply The supply the name of the lowered function was taken from.
+   */
+  void Save(const CCacheKey& key, const CachedFunc& cached_func,
+            GlobalVarSupply global_var_supply) const;
+
+ private:
+  /*! \brief The path of the cache file. */
+  std::string path_;
+  /*! \brief The canonical description of the target, memory scopes and pass context. */
+  std::string key_;
+};
+
 // implementations
 inline size_t CCacheKeyNode::Hash() const {
   if (hash_ != 0) return hash_;
@@ -24,10 +24,35 @@
 
 #include "./candidate_function_cache.h"
 
+#include <dmlc/memory_io.h>
+#include <tvm/node/serialization.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include "../../support/utils.h"
+
 namespace tvm {
 namespace relay {
 namespace collage {
 
+/*! \brief The magic number at the beginning of every cost cache file. */
+constexpr uint64_t kCollageCostCacheMagic = 0x54564D434F535431;
+
+namespace {
+
+/*! \brief Returns the key of the costs of a target, checked on load against hash collisions. */
+std::string CostCacheKey(const Target& target, const std::string& cost_estimator_key) {
+  return std::string(TVM_VERSION) + "\n" + target->str() + "\n" + cost_estimator_key;
+}
+
+}  // namespace
+
 CandidateFunctionCache::Entry& CandidateFunctionCache::GetEntry(const std::string& label,
                                                                 const Function& function) {
   auto itr = cache_.find(function);
@@ -44,6 +69,78 @@ GlobalVar CandidateFunctionCache::GetGlobalSymbol(const Function& function) {
   return GetEntry(/*label=*/"", function).global_symbol;
 }
 
+std::string CandidateFunctionCache::CostCachePath(const Function& function,
+                                                  const std::string& key) const {
+  uint64_t hash = support::HashCombine(std::hash<std::string>()(key), StructuralHash()(function));
+  std::ostringstream os;
+  os << cost_cache_dir_ << "/" << std::hex << hash << ".tvmcost";
+  return os.str();
+}
+
+Cost CandidateFunctionCache::LoadCost(const Function& function, const Target& target) const {
+  if (cost_cache_dir_.empty()) {
+    return Cost::Unknown();
+  }
+  std::string key = CostCacheKey(target, cost_estimator_key_);
+  std::ifstream fs(CostCachePath(function, key), std::ios::in | std::ios::binary);
+  if (!fs) {
+    return Cost::Unknown();
+  }
+  std::string data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  dmlc::MemoryStringStream reader(&data);
+  dmlc::Stream* stream = &reader;
+  uint64_t magic = 0;
+  std::string saved_key, function_json;
+  double value = 0.0;
+  if (!stream->Read(&magic) || magic != kCollageCostCacheMagic || !stream->Read(&saved_key) ||
+      saved_key != key || !stream->Read(&function_json) || !stream->Read(&value) ||
+      std::isnan(value) || value < 0.0) {
+    return Cost::Unknown();
+  }
+  if (!StructuralEqual()(LoadJSON(function_json), function)) {
+    return Cost::Unknown();
+  }
+  return std::isinf(value) ? Cost::Invalid() : Cost::Value(value);
+}
+
+void CandidateFunctionCache::SaveCost(const Function& function, const Target& target,
+                                      Cost cost) const {
+  if (cost_cache_dir_.empty() || cost.is_unknown()) {
+    return;
+  }
+  std::string key = CostCacheKey(target, cost_estimator_key_);
+  std::string data;
+  dmlc::MemoryStringStream writer(&data);
+  dmlc::Stream* stream = &writer;
+  stream->Write(kCollageCostCacheMagic);
+  stream->Write(key);
+  stream->Write(SaveJSON(function));
+  // Invalid costs are persisted as infinity
+  stream->Write(cost.is_value() ? cost.value() : std::numeric_limits<double>::infinity());
+  // A failure to write the cache never fails the partitioning, and the file is renamed into
+  // place so that concurrent runs sharing the directory never observe a partial file.
+  std::string path = CostCachePath(function, key);
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp" << std::random_device()();
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the Collage cost cache file " << tmp_path.str();
+      return;
+    }
+    fs.write(data.data(), data.size());
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the Collage cost cache file " << tmp_path.str();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the Collage cost cache file " << path;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
 }  // namespace collage
 }  // namespace relay
 }  // namespace tvm
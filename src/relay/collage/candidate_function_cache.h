@@ -26,6 +26,7 @@
 #define TVM_RELAY_COLLAGE_CANDIDATE_FUNCTION_CACHE_H_
 
 #include <tvm/relay/function.h>
+#include <tvm/target/target.h>
 
 #include <memory>
 #include <string>
@@ -49,8 +50,17 @@ namespace collage {
  */
 class CandidateFunctionCache : public transform::GlobalSymbolCache {
  public:
-  explicit CandidateFunctionCache(std::shared_ptr<NameSupply> name_supply)
-      : name_supply_(std::move(name_supply)) {}
+  /*!
+   * \brief Creates the cache. If \p cost_cache_dir is not empty the estimated costs are also
+   * persisted in that directory, keyed by the structural hash of the function, the target and
+   * \p cost_estimator_key, so that they are reused across runs.
+   */
+  explicit CandidateFunctionCache(std::shared_ptr<NameSupply> name_supply,
+                                  std::string cost_cache_dir = "",
+                                  std::string cost_estimator_key = "")
+      : name_supply_(std::move(name_supply)),
+        cost_cache_dir_(std::move(cost_cache_dir)),
+        cost_estimator_key_(std::move(cost_estimator_key)) {}
 
   struct Entry {
     GlobalVar global_symbol;
@@ -67,8 +77,25 @@ class CandidateFunctionCache : public transform::GlobalSymbolCache {
 
   GlobalVar GetGlobalSymbol(const Function& function) final;
 
+  /*!
+   * \brief Returns the cost of \p function on \p target persisted in the cost cache directory,
+   * or Cost::Unknown() if there is none.
+   */
+  Cost LoadCost(const Function& function, const Target& target) const;
+
+  /*!
+   * \brief Persists the \p cost of \p function on \p target in the cost cache directory, if any.
+   * Unknown costs are not persisted.
+   */
+  void SaveCost(const Function& function, const Target& target, Cost cost) const;
+
  private:
+  /*! \brief Returns the path of the file persisting the cost of \p function on \p target. */
+  std::string CostCachePath(const Function& function, const std::string& key) const;
+
   std::shared_ptr<NameSupply> name_supply_;
+  std::string cost_cache_dir_;
+  std::string cost_estimator_key_;
   std::unordered_map<Function, Entry, StructuralHash, StructuralEqual> cache_;
 };
 
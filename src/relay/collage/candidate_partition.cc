@@ -167,37 +167,9 @@ Cost CandidatePartitionNode::EstimatedCost(
     const DataflowGraph& dataflow_graph, const CostEstimator& cost_estimator,
     const std::shared_ptr<CandidateFunctionCache>& cache) const {
   if (cost_.is_unknown()) {
-    VLOG_CONTEXT << "spec " << partition_spec_name();
-    Function extracted_function = sub_graph_->ExtractAsFunction(dataflow_graph);
-    VLOG(2) << "Extracted function:" << std::endl << PrettyPrint(extracted_function);
-    extracted_function = EtaExpandTuples(extracted_function);
-    VLOG(2) << "Validating function:" << std::endl << PrettyPrint(extracted_function);
-    String error = partition_spec()->validate_sub_graph_func_(extracted_function);
-    if (!error.empty()) {
-      cost_ = Cost::Invalid();
-      VLOG(1) << "Unable to rewrite function: " << error;
-    } else {
-      // The extracted function may be the eta-expansion of a "Primitive" function.
-      // If so we want the cached external name and cost to be w.r.t. that function
-      // rather than the outer so that we'll get a cache hit when we outline functions
-      // in the final program.
-      Function primitive_function = GetPrimitiveFunction(extracted_function);
-      CandidateFunctionCache::Entry& entry =
-          cache->GetEntry(sub_graph_->label_, primitive_function);
-      if (entry.cost.is_unknown()) {
-        IRModule mod = IRModule::FromExpr(extracted_function);
-        VLOG(1) << "Outlining:" << std::endl << PrettyPrint(mod);
-        mod = OutlineCompilerFunctions(cache)(mod);
-        VLOG(1) << "Estimating cost of:" << std::endl
-                << PrettyPrint(mod) << std::endl
-                << "using target " << target()->ToDebugString();
-        entry.cost = cost_estimator->Estimate(mod, target());
-        VLOG(1) << "Measured cost as " << entry.cost.ToString();
-      } else {
-        VLOG(1) << "Reusing cost " << entry.cost.ToString()
-                << " cached in candidate function cache";
-      }
-      cost_ = entry.cost;
+    if (std::optional<CandidateCostEstimate> estimate = PrepareEstimate(dataflow_graph, cache)) {
+      VLOG_CONTEXT << "spec " << partition_spec_name();
+      FinishEstimate(*estimate, cost_estimator->Estimate(estimate->mod, estimate->target), cache);
     }
   } else {
     VLOG(1) << "Reusing cost " << cost_.ToString() << " cached in candidate";
@@ -205,6 +177,61 @@ Cost CandidatePartitionNode::EstimatedCost(
   return cost_;
 }
 
+std::optional<CandidateCostEstimate> CandidatePartitionNode::PrepareEstimate(
+    const DataflowGraph& dataflow_graph,
+    const std::shared_ptr<CandidateFunctionCache>& cache) const {
+  if (!cost_.is_unknown()) {
+    return std::nullopt;
+  }
+  VLOG_CONTEXT << "spec " << partition_spec_name();
+  Function extracted_function = sub_graph_->ExtractAsFunction(dataflow_graph);
+  VLOG(2) << "Extracted function:" << std::endl << PrettyPrint(extracted_function);
+  extracted_function = EtaExpandTuples(extracted_function);
+  VLOG(2) << "Validating function:" << std::endl << PrettyPrint(extracted_function);
+  String error = partition_spec()->validate_sub_graph_func_(extracted_function);
+  if (!error.empty()) {
+    cost_ = Cost::Invalid();
+    VLOG(1) << "Unable to rewrite function: " << error;
+    return std::nullopt;
+  }
+  // The extracted function may be the eta-expansion of a "Primitive" function.
+  // If so we want the cached external name and cost to be w.r.t. that function
+  // rather than the outer so that we'll get a cache hit when we outline functions
+  // in the final program.
+  Function primitive_function = GetPrimitiveFunction(extracted_function);
+  CandidateFunctionCache::Entry& entry = cache->GetEntry(sub_graph_->label_, primitive_function);
+  if (entry.cost.is_unknown()) {
+    entry.cost = cache->LoadCost(primitive_function, target());
+    if (!entry.cost.is_unknown()) {
+      VLOG(1) << "Loaded cost " << entry.cost.ToString() << " from the cost cache directory";
+    }
+  } else {
+    VLOG(1) << "Reusing cost " << entry.cost.ToString() << " cached in candidate function cache";
+  }
+  if (!entry.cost.is_unknown()) {
+    cost_ = entry.cost;
+    return std::nullopt;
+  }
+  IRModule mod = IRModule::FromExpr(extracted_function);
+  VLOG(1) << "Outlining:" << std::endl << PrettyPrint(mod);
+  mod = OutlineCompilerFunctions(cache)(mod);
+  VLOG(1) << "Estimating cost of:" << std::endl
+          << PrettyPrint(mod) << std::endl
+          << "using target " << target()->ToDebugString();
+  return CandidateCostEstimate{primitive_function, mod, target(), &entry};
+}
+
+void CandidatePartitionNode::FinishEstimate(
+    const CandidateCostEstimate& estimate, Cost cost,
+    const std::shared_ptr<CandidateFunctionCache>& cache) const {
+  VLOG(1) << "Measured cost as " << cost.ToString();
+  if (estimate.entry->cost.is_unknown()) {
+    estimate.entry->cost = cost;
+    cache->SaveCost(estimate.function, estimate.target, cost);
+  }
+  cost_ = estimate.entry->cost;
+}
+
 CandidatePartition::CandidatePartition(String rule_name, SubGraph sub_graph,
                                        ObjectRef /* actually PartitionSpec */ spec, Cost cost) {
   auto node = runtime::make_object<CandidatePartitionNode>();
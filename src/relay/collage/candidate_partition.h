@@ -29,6 +29,7 @@
 #include <tvm/target/compilation_config.h>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,21 @@ namespace collage {
 
 class PartitionSpec;
 
+/*!
+ * \brief A pending estimation of the cost of a candidate partition function, prepared
+ * sequentially so that the cost estimator can then be run on many of them in parallel.
+ */
+struct CandidateCostEstimate {
+  /*! \brief The function whose cost is cached in the candidate function cache. */
+  Function function;
+  /*! \brief The module to estimate, with its "Compiler" functions outlined. */
+  IRModule mod;
+  /*! \brief The target to estimate the module on. */
+  Target target;
+  /*! \brief The entry of the candidate function cache to be filled in with the cost. */
+  CandidateFunctionCache::Entry* entry;
+};
+
 /*!
  * \brief A candidate partition w.r.t. the overall Relay model.
  *
@@ -103,6 +119,22 @@ class CandidatePartitionNode : public Object {
   Cost EstimatedCost(const DataflowGraph& dataflow_graph, const CostEstimator& cost_estimator,
                      const std::shared_ptr<CandidateFunctionCache>& cache) const;
 
+  /*!
+   * \brief Prepares the estimation of the cost of the candidate partition. Returns the pending
+   * estimation, or std::nullopt if the cost is already known, in which case it is cached in the
+   * candidate. This must not be called concurrently, as it updates \p cache.
+   */
+  std::optional<CandidateCostEstimate> PrepareEstimate(
+      const DataflowGraph& dataflow_graph,
+      const std::shared_ptr<CandidateFunctionCache>& cache) const;
+
+  /*!
+   * \brief Records the \p cost measured for \p estimate, as returned by PrepareEstimate, in the
+   * candidate and in \p cache.
+   */
+  void FinishEstimate(const CandidateCostEstimate& estimate, Cost cost,
+                      const std::shared_ptr<CandidateFunctionCache>& cache) const;
+
   /*!
    * \brief Returns a brief description of candidate suitable for debugging output.
    */
@@ -24,6 +24,15 @@
 
 #include "./candidate_partition_index.h"
 
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "./gather_partition_specs.h"
 #include "./prune_candidates.h"
 #include "./utils.h"
@@ -51,17 +60,41 @@ void CandidatePartitionIndex::Index(const Array<PartitionSpec>& partition_specs)
 }
 
 void CandidatePartitionIndex::EstimateAllCosts(
-    const CostEstimator cost_estimator, const std::shared_ptr<CandidateFunctionCache>& cache) {
-  size_t n = 0;
+    const CostEstimator cost_estimator, const std::shared_ptr<CandidateFunctionCache>& cache,
+    int num_threads) {
+  // Step 1. Prepare the estimates sequentially, as the cache is shared by all the candidates.
+  // Candidates sharing a cache entry share its estimate.
+  std::vector<std::pair<CandidatePartition, size_t>> pending_candidates;
+  std::vector<CandidateCostEstimate> estimates;
+  std::unordered_map<const CandidateFunctionCache::Entry*, size_t> entry_to_estimate;
   for (PostDfsIndex index = 0; index < dataflow_graph_->size(); ++index) {
     for (const auto& candidate : first_inside_index_to_candidates_[index]) {
-      LOG(INFO) << "Estimating cost of candidate " << candidate->ToSummary(*dataflow_graph_) << " ["
-                << n++ << "/" << size_ << "]";
-      // Cost will be cached in candidate as a side effect.
-      Cost cost = candidate->EstimatedCost(*dataflow_graph_, cost_estimator, cache);
-      LOG(INFO) << "Candidate has cost " << cost.ToString();
+      if (std::optional<CandidateCostEstimate> estimate =
+              candidate->PrepareEstimate(*dataflow_graph_, cache)) {
+        auto itr = entry_to_estimate.emplace(estimate->entry, estimates.size()).first;
+        if (itr->second == estimates.size()) {
+          estimates.emplace_back(std::move(*estimate));
+        }
+        pending_candidates.emplace_back(candidate, itr->second);
+      }
     }
   }
+  // Step 2. Run the estimator, which may build and measure each module.
+  LOG(INFO) << "Estimating the costs of " << estimates.size() << " distinct candidates out of "
+            << size_ << " using " << num_threads << " threads";
+  std::vector<Cost> costs(estimates.size(), Cost::Unknown());
+  std::atomic<size_t> num_finished{0};
+  support::parallel_for_dynamic(
+      0, estimates.size(), std::max(num_threads, 1), [&](int, int i) {
+        costs[i] = cost_estimator->Estimate(estimates[i].mod, estimates[i].target);
+        LOG(INFO) << "Candidate " << estimates[i].entry->global_symbol->name_hint << " has cost "
+                  << costs[i].ToString() << " [" << ++num_finished << "/" << estimates.size()
+                  << "]";
+      });
+  // Step 3. Cache the costs in the candidates.
+  for (const auto& kv : pending_candidates) {
+    kv.first->FinishEstimate(estimates[kv.second], costs[kv.second], cache);
+  }
 }
 
 std::string CandidatePartitionIndex::ToSummary() const {
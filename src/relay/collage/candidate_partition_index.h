@@ -57,9 +57,12 @@ class CandidatePartitionIndex {
     return first_inside_index_to_candidates_[index];
   }
 
-  /*! \brief Estimates the casts of all candidates in the index. Each candidate caches its cost. */
+  /*!
+   * \brief Estimates the casts of all candidates in the index. Each candidate caches its cost.
+   * The distinct candidate functions are estimated by \p num_threads threads at the same time.
+   */
   void EstimateAllCosts(const CostEstimator cost_estimator,
-                        const std::shared_ptr<CandidateFunctionCache>& cache);
+                        const std::shared_ptr<CandidateFunctionCache>& cache, int num_threads = 1);
 
   size_t size() const { return size_; }
 
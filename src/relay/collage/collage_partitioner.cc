@@ -33,6 +33,9 @@
 #include <tvm/relay/transform.h>
 #include <tvm/target/target.h>
 
+#include <cstdlib>
+#include <string>
+
 #include "../ir/dataflow_matcher_impl.h"
 #include "../transforms/compiler_function_utils.h"
 #include "../transforms/device_aware_visitors.h"
@@ -56,6 +59,8 @@ namespace {
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.tvm_max_depth", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.byoc_max_depth", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.byoc_fusion_style", Array<String>);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.num_estimator_threads", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.cost_cache_dir", String);
 /*!
  * \brief Represents the overall expression after some number of non-overlapping candidate
  * partitions have been applied.
@@ -126,12 +131,13 @@ class Partitioner {
   explicit Partitioner(Array<PartitionSpec> partition_specs,
                        const std::unordered_map<const ExprNode*, VirtualDevice>* virtual_devices,
                        CostEstimator cost_estimator, std::shared_ptr<CandidateFunctionCache> cache,
-                       Expr expr)
+                       Expr expr, int num_estimator_threads = 1)
       : partition_specs_(std::move(partition_specs)),
         virtual_devices_(virtual_devices),
         cost_estimator_(std::move(cost_estimator)),
         cache_(std::move(cache)),
-        expr_(std::move(expr)) {}
+        expr_(std::move(expr)),
+        num_estimator_threads_(num_estimator_threads) {}
 
   Expr Partition() {
     // Establish core data structures.
@@ -150,10 +156,10 @@ class Partitioner {
     //  - There are no paths in which the candidate does not intersect candidates already
     //    applied on the path.
     //  - The Dijkstra search terminates early with a least cost path.
-    // So eager may result in more estimation overhead. However, eager could be made
-    // embarrassingly parallel.
+    // So eager may result in more estimation overhead. However, eager is embarrassingly
+    // parallel, see "relay.collage.num_estimator_threads".
     VLOG(1) << "Beginning eager cost estimation";
-    index_->EstimateAllCosts(cost_estimator_, cache_);
+    index_->EstimateAllCosts(cost_estimator_, cache_, num_estimator_threads_);
     VLOG(1) << "Finished eager cost estimation";
 
     // Setup initial state.
@@ -300,6 +306,8 @@ class Partitioner {
   std::shared_ptr<CandidateFunctionCache> cache_;
   /*! \brief The expression we will be partitioning. */
   Expr expr_;
+  /*! \brief Number of candidates to estimate at the same time. */
+  int num_estimator_threads_;
   /*! \brief Dataflow graph for overall expression. */
   std::unique_ptr<DataflowGraph> dataflow_graph_;
   /*! \brief Index of all avoilable candidates we are searching over. */
@@ -322,8 +330,24 @@ transform::Pass CollagePartition(CompilationConfig config, CostEstimator cost_es
         Array<PartitionSpec> partition_specs = GatherPartitionSpecs(config);
         VLOG(1) << "Gathered " << partition_specs.size() << " partition specs";
 
-        auto cache =
-            std::make_shared<CandidateFunctionCache>(std::make_shared<NameSupply>("collage"));
+        // Measurements on the same device disturb each other, so the candidates are estimated
+        // one at a time unless the estimator places them on distinct devices or workers.
+        int num_estimator_threads =
+            ctxt->GetConfig<Integer>("relay.collage.num_estimator_threads", Integer(1))
+                .value()
+                .IntValue();
+        CHECK_GT(num_estimator_threads, 0)
+            << "ValueError: relay.collage.num_estimator_threads must be positive";
+        std::string cost_cache_dir =
+            ctxt->GetConfig<String>("relay.collage.cost_cache_dir", String("")).value();
+        if (cost_cache_dir.empty()) {
+          if (const char* env_cost_cache_dir = std::getenv("TVM_COLLAGE_COST_CACHE_DIR")) {
+            cost_cache_dir = env_cost_cache_dir;
+          }
+        }
+        auto cache = std::make_shared<CandidateFunctionCache>(
+            std::make_shared<NameSupply>("collage"), cost_cache_dir,
+            cost_estimator->GetTypeKey());
 
         IRModule out_mod = mod->ShallowCopy();
         for (const auto& kv : mod->functions) {
@@ -332,7 +356,7 @@ transform::Pass CollagePartition(CompilationConfig config, CostEstimator cost_es
             std::unordered_map<const ExprNode*, VirtualDevice> virtual_devices =
                 transform::RecoverVirtualDeviceMap(mod, function);
             Partitioner partitioner(partition_specs, &virtual_devices, cost_estimator, cache,
-                                    function);
+                                    function, num_estimator_threads);
             Function result = Downcast<Function>(partitioner.Partition());
             out_mod->Add(kv.first, result);
           }
@@ -81,10 +81,10 @@ class MockEstimationVisitor : private ExprVisitor {
 
 Cost MockCostEstimatorNode::Estimate(const IRModule& mod, const Target& target) const {
   // Limit the number of estimations.
-  ICHECK(max_estimates_->value == 0 || num_estimates_ < static_cast<size_t>(max_estimates_->value))
+  size_t num_estimates = num_estimates_++;
+  ICHECK(max_estimates_->value == 0 || num_estimates < static_cast<size_t>(max_estimates_->value))
       << "At most " << max_estimates_->value
       << " non-trivial distinct candidates should have been generated.";
-  ++num_estimates_;
   double op_cost = static_cast<double>(target_costs_.at(target->kind->name)->value);
   double cost = 0.0;
   for (const auto& kv : mod->functions) {
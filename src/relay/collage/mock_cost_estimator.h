@@ -27,6 +27,8 @@
 
 #include <tvm/relay/function.h>
 
+#include <atomic>
+
 #include "./cost.h"
 #include "./cost_estimator.h"
 
@@ -71,8 +73,8 @@ class MockCostEstimatorNode : public CostEstimatorNode {
    */
   Integer max_estimates_;
 
-  /*! \brief Number of calls to Estimate. */
-  mutable size_t num_estimates_ = 0;
+  /*! \brief Number of calls to Estimate, which may be made from several threads. */
+  mutable std::atomic<size_t> num_estimates_{0};
 
   friend class MockCostEstimator;
 };
@@ -27,6 +27,7 @@
 
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/name_transforms.h>
 
 #include <limits>
@@ -38,7 +39,9 @@ namespace tvm {
 namespace runtime {
 
 AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>& devs)
-    : module_{module}, devices_{devs} {
+    : module_{module},
+      devices_{devs},
+      workspace_pools_{std::make_shared<std::vector<NDArray>>()} {
   auto fmetadata = module->GetFunction("get_metadata");
   CHECK(fmetadata != nullptr) << "Expected a module with PackedFunc get_metadata";
   auto ret_value = fmetadata();
@@ -84,13 +87,18 @@ AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>&
     // Emplace constant node pool only if workspace pools supplied
     args_.emplace_back(ci);
 
-    int32_t pool_len = 0;
     for (auto pool : metadata_->workspace_pools()) {
-      pool_len =
-          GetDataSize(*NDArray::Empty({pool->shape()}, pool->dtype(), devices_[0]).operator->());
-      args_.emplace_back(NDArray::Empty({pool_len}, DataType::UInt(8), devices_[0]));
+      std::vector<int64_t> shape(pool->shape().begin(), pool->shape().end());
+      // Only the shape and dtype matter to compute the size, no need to allocate it twice.
+      DLTensor pool_tensor{};
+      pool_tensor.ndim = static_cast<int32_t>(shape.size());
+      pool_tensor.shape = shape.data();
+      pool_tensor.dtype = pool->dtype();
+      int64_t pool_len = static_cast<int64_t>(GetDataSize(pool_tensor));
+      workspace_pools_->emplace_back(NDArray::Empty({pool_len}, DataType::UInt(8), devices_[0]));
     }
   }
+  zero_copy_data_.resize(metadata_->num_inputs() + metadata_->num_outputs(), nullptr);
 }
 
 PackedFunc AotExecutor::GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) {
@@ -158,6 +166,13 @@ PackedFunc AotExecutor::GetFunction(const String& name, const ObjectPtr<Object>&
   } else if (name == "get_input_name") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetInputName(args[0]); });
+  } else if (name == "share_workspace") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      Module other = args[0];
+      CHECK_EQ(other->type_key(), std::string(this->type_key()))
+          << "Workspace can only be shared with another AotExecutor";
+      this->ShareWorkspace(static_cast<AotExecutor*>(other.operator->()));
+    });
   } else {
     return PackedFunc();
   }
@@ -169,12 +184,14 @@ void AotExecutor::Run() {
       true /* query_imports */);
   ICHECK(pf != nullptr) << "Module entrypoint is not defined";
 
-  const int num_args = args_.size();
+  // Shared pools may outnumber the ones this module uses, only pass its own.
+  const int num_args = args_.size() + metadata_->workspace_pools().size();
+  std::vector<DLTensor> call_tensors(num_args);
   auto call_values = ::std::make_unique<TVMValue[]>(num_args);
   auto call_type_codes = ::std::make_unique<int[]>(num_args);
   for (int i = 0; i < num_args; ++i) {
-    auto managed = args_[i].ToDLPack();
-    call_values.get()[i].v_handle = &managed->dl_tensor;
+    call_tensors[i] = GetArgTensor(i);
+    call_values.get()[i].v_handle = &call_tensors[i];
     call_type_codes.get()[i] = kTVMDLTensorHandle;
   }
 
@@ -210,12 +227,67 @@ int AotExecutor::GetOutputIndex(const std::string& name) {
 
 void AotExecutor::SetInput(int index, DLTensor* data_ref) { args_[index].CopyFrom(data_ref); }
 
+void AotExecutor::CheckExternalDLTensor(const DLTensor* external, int arg_index) const {
+  const DLTensor* internal = args_[arg_index].operator->();
+
+  ICHECK_EQ(reinterpret_cast<size_t>(static_cast<char*>(external->data) + external->byte_offset) %
+                kAllocAlignment,
+            0);
+  ICHECK(runtime::TypeEqual(internal->dtype, external->dtype))
+      << "Expected " << DLDataType2String(internal->dtype) << " but got "
+      << DLDataType2String(external->dtype);
+  ICHECK_EQ(internal->ndim, external->ndim);
+  ICHECK_EQ(internal->device.device_type, external->device.device_type);
+  ICHECK_EQ(internal->device.device_id, external->device.device_id);
+  for (auto i = 0; i < external->ndim; ++i) {
+    ICHECK_EQ(internal->shape[i], external->shape[i]);
+  }
+  ICHECK(external->strides == nullptr || runtime::IsContiguous(*external))
+      << "Zero-copy tensors must be compact";
+}
+
+DLTensor AotExecutor::GetArgTensor(int arg_index) const {
+  const int num_args = args_.size();
+  if (arg_index >= num_args) {
+    return *(*workspace_pools_)[arg_index - num_args].operator->();
+  }
+  DLTensor tensor = *args_[arg_index].operator->();
+  if (arg_index < static_cast<int>(zero_copy_data_.size()) &&
+      zero_copy_data_[arg_index] != nullptr) {
+    tensor.data = zero_copy_data_[arg_index];
+    tensor.byte_offset = 0;
+  }
+  return tensor;
+}
+
 void AotExecutor::SetInputZeroCopy(int index, DLTensor* data_ref) {
-  ICHECK(false) << "not implemented";
+  ICHECK_LT(index, NumInputs());
+  CheckExternalDLTensor(data_ref, index);
+  zero_copy_data_[index] = static_cast<char*>(data_ref->data) + data_ref->byte_offset;
 }
 
 void AotExecutor::SetOutputZeroCopy(int index, DLTensor* data_ref) {
-  ICHECK(false) << "not implemented";
+  ICHECK_LT(index, NumOutputs());
+  int arg_index = metadata_->num_inputs() + index;
+  CheckExternalDLTensor(data_ref, arg_index);
+  zero_copy_data_[arg_index] = static_cast<char*>(data_ref->data) + data_ref->byte_offset;
+}
+
+void AotExecutor::ShareWorkspace(AotExecutor* other) {
+  if (other->workspace_pools_ == workspace_pools_) return;
+  ICHECK_EQ(devices_[0].device_type, other->devices_[0].device_type);
+  ICHECK_EQ(devices_[0].device_id, other->devices_[0].device_id);
+  std::vector<NDArray>& shared = *other->workspace_pools_;
+  for (size_t i = 0; i < workspace_pools_->size(); ++i) {
+    NDArray& pool = (*workspace_pools_)[i];
+    if (i == shared.size()) {
+      shared.push_back(pool);
+    } else if (shared[i].Shape()[0] < pool.Shape()[0]) {
+      // Workspace contents do not outlive a run, keep the larger buffer.
+      shared[i] = pool;
+    }
+  }
+  workspace_pools_ = other->workspace_pools_;
 }
 
 int AotExecutor::NumOutputs() const { return metadata_->num_outputs(); }
@@ -226,7 +298,10 @@ NDArray AotExecutor::GetInput(int index) const { return args_[index]; }
 
 NDArray AotExecutor::GetOutput(int index) const { return args_[metadata_->num_inputs() + index]; }
 
-void AotExecutor::CopyOutputTo(int index, DLTensor* data_out) { GetOutput(index).CopyTo(data_out); }
+void AotExecutor::CopyOutputTo(int index, DLTensor* data_out) {
+  DLTensor output = GetArgTensor(metadata_->num_inputs() + index);
+  NDArray::CopyFromTo(&output, data_out);
+}
 
 }  // namespace runtime
 }  // namespace tvm
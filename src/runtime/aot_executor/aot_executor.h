@@ -30,6 +30,7 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -95,15 +96,27 @@ class TVM_DLL AotExecutor : public ModuleNode {
   /*!
    * \brief set index-th input to the graph without copying the data
    * \param index The input index.
-   * \param data_ref The input data that is referred.
+   * \param data_ref The input data that is referred. It must stay alive while it is bound.
    */
   void SetInputZeroCopy(int index, DLTensor* data_ref);
   /*!
    * \brief set index-th output to the graph without copying the data.
+   *
+   * Run writes the output into data_ref; GetOutput keeps returning the internal buffer.
+   *
    * \param index The output index.
-   * \param data_ref The output data that is referred.
+   * \param data_ref The output data that is referred. It must stay alive while it is bound.
    */
   void SetOutputZeroCopy(int index, DLTensor* data_ref);
+  /*!
+   * \brief Make this executor use the workspace pools of another one.
+   *
+   * The shared pools grow to the largest size needed by any executor in the group, so the
+   * executors must not run concurrently.
+   *
+   * \param other The executor whose workspace pools are shared.
+   */
+  void ShareWorkspace(AotExecutor* other);
   /*!
    * \brief Get the number of outputs
    *
@@ -147,8 +160,28 @@ class TVM_DLL AotExecutor : public ModuleNode {
   /*! \brief The devices which should be used to execute the computations. */
   std::vector<Device> devices_;
 
-  /*! \brief Holds one NDArray per function argument in the same order. */
+  /*!
+   * \brief Check that an external tensor can be bound in place of an argument.
+   * \param external The external tensor.
+   * \param arg_index The index of the argument in args_.
+   */
+  void CheckExternalDLTensor(const DLTensor* external, int arg_index) const;
+
+  /*! \brief Get the tensor passed as the arg_index-th argument of the entrypoint. */
+  DLTensor GetArgTensor(int arg_index) const;
+
+  /*!
+   * \brief Holds one NDArray per function argument in the same order, up to the constant pool.
+   */
   std::vector<NDArray> args_;
+
+  /*! \brief Data bound by SetInputZeroCopy or SetOutputZeroCopy per argument, or nullptr. */
+  std::vector<void*> zero_copy_data_;
+
+  /*!
+   * \brief The workspace pools passed after args_, possibly shared with other executors.
+   */
+  std::shared_ptr<std::vector<NDArray>> workspace_pools_;
 };
 
 }  // namespace runtime
@@ -215,6 +215,21 @@ TVMStreamHandle DeviceAPI::GetCurrentStream(Device dev) { return nullptr; }
 void DeviceAPI::SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst) {
 }
 
+TVMEventHandle DeviceAPI::CreateEvent(Device dev) { return nullptr; }
+
+void DeviceAPI::FreeEvent(Device dev, TVMEventHandle event) {}
+
+void DeviceAPI::RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) {
+  // Without native events, the work has to complete before the event is recorded.
+  StreamSync(dev, stream);
+}
+
+void DeviceAPI::EventSync(Device dev, TVMEventHandle event) {}
+
+bool DeviceAPI::EventQuery(Device dev, TVMEventHandle event) { return true; }
+
+void DeviceAPI::StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event) {}
+
 //--------------------------------------------------------
 // Error handling mechanism
 // -------------------------------------------------------
@@ -0,0 +1,416 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file chunked_params.cc
+ * \brief Streaming parameter files with per-chunk checksums.
+ *
+ * The file layout is
+ *
+ *   header: magic, version, chunk size                        (3 x uint64)
+ *   data:   raw bytes of every tensor, each aligned to kAllocAlignment
+ *   index:  the ChunkedParamEntry list, serialized with dmlc::Stream
+ *   footer: index offset, index size (uint64), index CRC, reserved (uint32), magic (uint64)
+ *
+ * Every tensor is split into chunks of the header's chunk size and each chunk
+ * carries a CRC-32 (the zlib polynomial) in the index. Tensors are moved between
+ * the device and the file one chunk at a time through a host staging buffer, so
+ * neither saving nor loading needs a full host copy of a tensor.
+ */
+#include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/serializer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "file_utils.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+constexpr uint64_t kChunkedParamsVersion = 1;
+constexpr uint64_t kChunkedParamsHeaderSize = 3 * sizeof(uint64_t);
+constexpr uint64_t kChunkedParamsFooterSize = 4 * sizeof(uint64_t);
+
+/*! \brief Update a CRC-32 (IEEE 802.3, as used by zlib) with a buffer. */
+uint32_t CRC32(uint32_t crc, const void* data, size_t size) {
+  static const auto table = []() {
+    std::vector<uint32_t> table(256);
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+      }
+      table[i] = c;
+    }
+    return table;
+  }();
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+/*! \brief Index entry of a single tensor. */
+struct ChunkedParamEntry {
+  std::string name;
+  DLDataType dtype;
+  std::vector<int64_t> shape;
+  /*! \brief Offset of the tensor data from the beginning of the file. */
+  uint64_t offset;
+  uint64_t nbytes;
+  std::vector<uint32_t> chunk_crcs;
+
+  void Save(dmlc::Stream* strm) const {
+    strm->Write(name);
+    strm->Write(dtype);
+    strm->Write(shape);
+    strm->Write(offset);
+    strm->Write(nbytes);
+    strm->Write(chunk_crcs);
+  }
+
+  bool Load(dmlc::Stream* strm) {
+    return strm->Read(&name) && strm->Read(&dtype) && strm->Read(&shape) &&
+           strm->Read(&offset) && strm->Read(&nbytes) && strm->Read(&chunk_crcs);
+  }
+};
+
+/*! \brief RAII wrapper of a std::FILE with 64-bit seek and checked I/O. */
+class ChunkedParamsFile {
+ public:
+  ChunkedParamsFile(const std::string& path, const char* mode) : path_(path) {
+    fp_ = std::fopen(path.c_str(), mode);
+    CHECK(fp_ != nullptr) << "Unable to open file " << path;
+  }
+  ~ChunkedParamsFile() {
+    if (fp_ != nullptr) std::fclose(fp_);
+  }
+
+  void Seek(uint64_t pos) {
+#ifdef _WIN32
+    int err = _fseeki64(fp_, static_cast<int64_t>(pos), SEEK_SET);
+#else
+    int err = fseeko(fp_, static_cast<off_t>(pos), SEEK_SET);
+#endif
+    CHECK_EQ(err, 0) << "Failed to seek to offset " << pos << " in " << path_;
+  }
+  uint64_t Size() {
+#ifdef _WIN32
+    CHECK_EQ(_fseeki64(fp_, 0, SEEK_END), 0);
+    return static_cast<uint64_t>(_ftelli64(fp_));
+#else
+    CHECK_EQ(fseeko(fp_, 0, SEEK_END), 0);
+    return static_cast<uint64_t>(ftello(fp_));
+#endif
+  }
+  void Read(void* ptr, size_t size) {
+    CHECK_EQ(std::fread(ptr, 1, size, fp_), size) << "Unexpected end of file " << path_;
+  }
+  void Write(const void* ptr, size_t size) {
+    CHECK_EQ(std::fwrite(ptr, 1, size, fp_), size) << "Failed to write to " << path_;
+  }
+  void Close() {
+    int err = std::fclose(fp_);
+    fp_ = nullptr;
+    CHECK_EQ(err, 0) << "Failed to close " << path_;
+  }
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+  std::FILE* fp_{nullptr};
+};
+
+/*! \brief The parsed header and index of a chunked parameter file. */
+struct ChunkedParamsIndex {
+  uint64_t chunk_size;
+  std::vector<ChunkedParamEntry> entries;
+};
+
+ChunkedParamsIndex ReadIndex(ChunkedParamsFile* file) {
+  uint64_t file_size = file->Size();
+  CHECK_GE(file_size, kChunkedParamsHeaderSize + kChunkedParamsFooterSize)
+      << "Invalid chunked parameter file " << file->path();
+  uint64_t header[3];
+  file->Seek(0);
+  file->Read(header, sizeof(header));
+  CHECK(header[0] == kTVMChunkedParamsMagic)
+      << "Invalid chunked parameter file " << file->path();
+  CHECK_EQ(header[1], kChunkedParamsVersion)
+      << "Unsupported chunked parameter file version in " << file->path();
+
+  uint64_t index_offset, index_size, magic;
+  uint32_t index_crc, reserved;
+  file->Seek(file_size - kChunkedParamsFooterSize);
+  file->Read(&index_offset, sizeof(index_offset));
+  file->Read(&index_size, sizeof(index_size));
+  file->Read(&index_crc, sizeof(index_crc));
+  file->Read(&reserved, sizeof(reserved));
+  file->Read(&magic, sizeof(magic));
+  CHECK(magic == kTVMChunkedParamsMagic && index_offset + index_size <= file_size)
+      << "Truncated or corrupted chunked parameter file " << file->path();
+
+  std::string blob(index_size, '\0');
+  file->Seek(index_offset);
+  file->Read(&blob[0], blob.size());
+  CHECK_EQ(CRC32(0, blob.data(), blob.size()), index_crc)
+      << "Checksum mismatch in the index of " << file->path();
+
+  ChunkedParamsIndex index;
+  index.chunk_size = header[2];
+  dmlc::MemoryStringStream mstrm(&blob);
+  dmlc::Stream* strm = &mstrm;
+  uint64_t num_entries;
+  CHECK(strm->Read(&num_entries)) << "Invalid chunked parameter file " << file->path();
+  index.entries.resize(num_entries);
+  for (ChunkedParamEntry& entry : index.entries) {
+    CHECK(entry.Load(strm)) << "Invalid chunked parameter file " << file->path();
+  }
+  return index;
+}
+
+/*!
+ * \brief Allocate the host buffer chunks are staged in, using pinned memory when
+ *  the device has a host-pinned allocator so the copies can run at full bandwidth.
+ */
+NDArray AllocStagingBuffer(Device dev, uint64_t chunk_size) {
+  Device host{kDLCPU, 0};
+  if (dev.device_type == kDLCUDA && Registry::Get("device_api.cuda_host") != nullptr) {
+    host = Device{kDLCUDAHost, 0};
+  } else if (dev.device_type == kDLROCM && Registry::Get("device_api.rocm_host") != nullptr) {
+    host = Device{kDLROCMHost, 0};
+  }
+  return NDArray::Empty({static_cast<int64_t>(chunk_size)}, DataType::UInt(8), host);
+}
+
+/*! \brief Copy nbytes between the staging buffer and the tensor at a byte offset. */
+void CopyChunk(const DLTensor* tensor, uint64_t offset, const NDArray& staging, uint64_t nbytes,
+               bool to_device) {
+  int64_t shape = static_cast<int64_t>(nbytes);
+  DLTensor device_view = *tensor;
+  device_view.ndim = 1;
+  device_view.shape = &shape;
+  device_view.strides = nullptr;
+  device_view.dtype = DLDataType{kDLUInt, 8, 1};
+  device_view.byte_offset = tensor->byte_offset + offset;
+  DLTensor host_view = *staging.operator->();
+  host_view.shape = &shape;
+  if (to_device) {
+    NDArray::CopyFromTo(&host_view, &device_view);
+  } else {
+    NDArray::CopyFromTo(&device_view, &host_view);
+  }
+  // The staging buffer is reused by the next chunk.
+  DeviceAPI::Get(tensor->device)->StreamSync(tensor->device, nullptr);
+}
+
+bool IsHostAccessible(Device dev) {
+  return dev.device_type == kDLCPU || dev.device_type == kDLCUDAHost ||
+         dev.device_type == kDLROCMHost;
+}
+
+}  // namespace
+
+void SaveParamsChunked(const std::string& path, const Map<String, NDArray>& params,
+                       uint64_t chunk_size) {
+  CHECK_GT(chunk_size, 0) << "chunk_size must be positive";
+  // Sort by name so that the file content does not depend on the map iteration order.
+  std::vector<std::pair<std::string, NDArray>> sorted;
+  for (const auto& kv : params) {
+    sorted.emplace_back(kv.first, kv.second);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  ChunkedParamsFile file(path, "wb");
+  uint64_t header[3] = {kTVMChunkedParamsMagic, kChunkedParamsVersion, chunk_size};
+  file.Write(header, sizeof(header));
+  uint64_t pos = sizeof(header);
+
+  NDArray staging;
+  std::vector<ChunkedParamEntry> entries;
+  const std::vector<char> padding(kAllocAlignment, 0);
+  for (const auto& kv : sorted) {
+    const DLTensor* tensor = kv.second.operator->();
+    CHECK(IsContiguous(*tensor)) << "Parameter " << kv.first << " is not contiguous";
+    uint64_t pad = (kAllocAlignment - pos % kAllocAlignment) % kAllocAlignment;
+    file.Write(padding.data(), pad);
+    pos += pad;
+
+    ChunkedParamEntry entry;
+    entry.name = kv.first;
+    entry.dtype = tensor->dtype;
+    entry.shape.assign(tensor->shape, tensor->shape + tensor->ndim);
+    entry.offset = pos;
+    entry.nbytes = GetDataSize(*tensor);
+    bool direct = IsHostAccessible(tensor->device);
+    if (!direct && !staging.defined()) {
+      staging = AllocStagingBuffer(tensor->device, chunk_size);
+    }
+    for (uint64_t begin = 0; begin < entry.nbytes; begin += chunk_size) {
+      uint64_t nbytes = std::min(chunk_size, entry.nbytes - begin);
+      const char* src;
+      if (direct) {
+        src = static_cast<const char*>(tensor->data) + tensor->byte_offset + begin;
+      } else {
+        CopyChunk(tensor, begin, staging, nbytes, /*to_device=*/false);
+        src = static_cast<const char*>(staging->data);
+      }
+      entry.chunk_crcs.push_back(CRC32(0, src, nbytes));
+      file.Write(src, nbytes);
+    }
+    pos += entry.nbytes;
+    entries.push_back(std::move(entry));
+  }
+
+  std::string blob;
+  {
+    dmlc::MemoryStringStream mstrm(&blob);
+    dmlc::Stream* strm = &mstrm;
+    strm->Write(static_cast<uint64_t>(entries.size()));
+    for (const ChunkedParamEntry& entry : entries) {
+      entry.Save(strm);
+    }
+  }
+  file.Write(blob.data(), blob.size());
+  uint64_t index_size = blob.size();
+  uint32_t index_crc = CRC32(0, blob.data(), blob.size()), reserved = 0;
+  uint64_t magic = kTVMChunkedParamsMagic;
+  file.Write(&pos, sizeof(pos));
+  file.Write(&index_size, sizeof(index_size));
+  file.Write(&index_crc, sizeof(index_crc));
+  file.Write(&reserved, sizeof(reserved));
+  file.Write(&magic, sizeof(magic));
+  file.Close();
+}
+
+Map<String, NDArray> LoadParamsChunked(const std::string& path, Optional<Array<String>> names,
+                                       Device dev) {
+  ChunkedParamsFile file(path, "rb");
+  ChunkedParamsIndex index = ReadIndex(&file);
+
+  std::vector<const ChunkedParamEntry*> selected;
+  if (names.defined()) {
+    std::unordered_map<std::string, const ChunkedParamEntry*> by_name;
+    for (const ChunkedParamEntry& entry : index.entries) {
+      by_name[entry.name] = &entry;
+    }
+    for (const String& name : names.value()) {
+      auto it = by_name.find(name);
+      CHECK(it != by_name.end()) << "Parameter " << name << " is not found in " << path;
+      selected.push_back(it->second);
+    }
+  } else {
+    for (const ChunkedParamEntry& entry : index.entries) {
+      selected.push_back(&entry);
+    }
+  }
+
+  // Tensors on the host are read in place, everything else goes through the staging buffer.
+  bool direct = IsHostAccessible(dev);
+  NDArray staging;
+  if (!direct) {
+    staging = AllocStagingBuffer(dev, index.chunk_size);
+  }
+  Map<String, NDArray> params;
+  for (const ChunkedParamEntry* entry : selected) {
+    NDArray arr = NDArray::Empty(ShapeTuple(entry->shape), entry->dtype, dev);
+    CHECK_EQ(GetDataSize(*arr.operator->()), entry->nbytes)
+        << "Invalid size of parameter " << entry->name << " in " << path;
+    file.Seek(entry->offset);
+    size_t chunk = 0;
+    for (uint64_t begin = 0; begin < entry->nbytes; begin += index.chunk_size, ++chunk) {
+      uint64_t nbytes = std::min(index.chunk_size, entry->nbytes - begin);
+      char* dst = direct ? static_cast<char*>(arr->data) + begin
+                         : static_cast<char*>(staging->data);
+      file.Read(dst, nbytes);
+      CHECK(chunk < entry->chunk_crcs.size() && CRC32(0, dst, nbytes) == entry->chunk_crcs[chunk])
+          << "Checksum mismatch in chunk " << chunk << " of parameter " << entry->name << " in "
+          << path;
+      if (!direct) {
+        CopyChunk(arr.operator->(), begin, staging, nbytes, /*to_device=*/true);
+      }
+    }
+    params.Set(entry->name, arr);
+  }
+  return params;
+}
+
+Array<String> ListParamsChunked(const std::string& path) {
+  ChunkedParamsFile file(path, "rb");
+  Array<String> names;
+  for (const ChunkedParamEntry& entry : ReadIndex(&file).entries) {
+    names.push_back(entry.name);
+  }
+  return names;
+}
+
+Array<String> ValidateParamsChunked(const std::string& path) {
+  ChunkedParamsFile file(path, "rb");
+  ChunkedParamsIndex index = ReadIndex(&file);
+  std::vector<char> buffer(index.chunk_size);
+  Array<String> corrupted;
+  for (const ChunkedParamEntry& entry : index.entries) {
+    file.Seek(entry.offset);
+    bool ok = true;
+    size_t chunk = 0;
+    for (uint64_t begin = 0; ok && begin < entry.nbytes; begin += index.chunk_size, ++chunk) {
+      uint64_t nbytes = std::min(index.chunk_size, entry.nbytes - begin);
+      file.Read(buffer.data(), nbytes);
+      ok = chunk < entry.chunk_crcs.size() &&
+           CRC32(0, buffer.data(), nbytes) == entry.chunk_crcs[chunk];
+    }
+    if (!ok) corrupted.push_back(entry.name);
+  }
+  return corrupted;
+}
+
+TVM_REGISTER_GLOBAL("runtime.SaveParamsChunked")
+    .set_body_typed([](const Map<String, NDArray>& params, const String& path,
+                       int64_t chunk_size) {
+      CHECK_GT(chunk_size, 0) << "chunk_size must be positive";
+      SaveParamsChunked(path, params, static_cast<uint64_t>(chunk_size));
+    });
+
+TVM_REGISTER_GLOBAL("runtime.LoadParamsChunked")
+    .set_body_typed([](const String& path, Optional<Array<String>> names, Device dev) {
+      return LoadParamsChunked(path, names, dev);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.ListParamsChunked").set_body_typed([](const String& path) {
+  return ListParamsChunked(path);
+});
+
+TVM_REGISTER_GLOBAL("runtime.ValidateParamsChunked").set_body_typed([](const String& path) {
+  return ValidateParamsChunked(path);
+});
+
+}  // namespace runtime
+}  // namespace tvm
@@ -20,11 +20,22 @@
 /*!
  * \file Use external cblas library call.
  */
+#include <dmlc/thread_local.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 #include "../../3rdparty/compiler-rt/builtin_fp16.h"
+#include "../../cuda/cuda_common.h"
 #include "../cblas/gemm_common.h"
 #include "cublas_utils.h"
 
@@ -135,6 +146,141 @@ int roundoff(int v, int d) { return (v + d - 1) / d * d; }
 
 #if CUDART_VERSION >= 10010
 
+/*! \brief The problem that a cuBLASLt matmul plan is made for. */
+struct CublasLtMatmulKey {
+  int device_id = 0;
+  cudaDataType_t ab_type = CUDA_R_32F;
+  cudaDataType_t c_type = CUDA_R_32F;
+  bool transa = false;
+  bool transb = false;
+  cublasLtEpilogue_t epilogue = CUBLASLT_EPILOGUE_DEFAULT;
+  bool has_bias = false;
+  bool has_scale = false;
+  int M = 0;
+  int N = 0;
+  int K = 0;
+  /*! \brief The batch counts, all 0 for a regular GEMM. */
+  int64_t batch_count_A = 0;
+  int64_t batch_count_B = 0;
+  int64_t batch_count_C = 0;
+  size_t workspace_size = 0;
+
+  auto AsTuple() const {
+    return std::make_tuple(device_id, ab_type, c_type, transa, transb, epilogue, has_bias,
+                           has_scale, M, N, K, batch_count_A, batch_count_B, batch_count_C,
+                           workspace_size);
+  }
+
+  bool operator==(const CublasLtMatmulKey& other) const { return AsTuple() == other.AsTuple(); }
+};
+
+struct CublasLtMatmulKeyHash {
+  size_t operator()(const CublasLtMatmulKey& key) const {
+    size_t hash = 0;
+    auto f_combine = [&hash](int64_t value) {
+      hash ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    std::apply([&](auto... fields) { (f_combine(static_cast<int64_t>(fields)), ...); },
+               key.AsTuple());
+    return hash;
+  }
+};
+
+/*!
+ * \brief The descriptors and the algorithm of a cuBLASLt matmul. Creating them and querying the
+ *  heuristic costs about as much as a small GEMM, so they are made once per problem.
+ */
+struct CublasLtMatmulPlan {
+  cublasLtMatmulDesc_t op_desc{nullptr};
+  cublasLtMatrixLayout_t A_desc{nullptr};
+  cublasLtMatrixLayout_t B_desc{nullptr};
+  cublasLtMatrixLayout_t C_desc{nullptr};
+  cublasLtMatmulAlgo_t algo{};
+  bool algo_selected{false};
+
+  ~CublasLtMatmulPlan() {
+    if (op_desc) cublasLtMatmulDescDestroy(op_desc);
+    if (A_desc) cublasLtMatrixLayoutDestroy(A_desc);
+    if (B_desc) cublasLtMatrixLayoutDestroy(B_desc);
+    if (C_desc) cublasLtMatrixLayoutDestroy(C_desc);
+  }
+};
+
+/*! \brief The per-thread cache of the cuBLASLt matmul plans, like the handles. */
+struct CublasLtPlanCache {
+  /*! \brief The number of plans above which the cache is cleared, bounding dynamic shapes. */
+  static constexpr size_t kMaxPlans = 1024;
+
+  std::unordered_map<CublasLtMatmulKey, std::unique_ptr<CublasLtMatmulPlan>, CublasLtMatmulKeyHash>
+      plans;
+
+  static CublasLtPlanCache* ThreadLocal() {
+    return dmlc::ThreadLocalStore<CublasLtPlanCache>::Get();
+  }
+};
+
+/*!
+ * \brief The number of algorithms returned by the heuristic that are timed on the first call of
+ *  each problem, set by the environment variable TVM_CUBLASLT_AUTOTUNE. At most 1, the default,
+ *  takes the best algorithm of the heuristic without timing.
+ */
+int GetCublasLtAutotuneCandidates() {
+  static int num_candidates = [] {
+    const char* value = std::getenv("TVM_CUBLASLT_AUTOTUNE");
+    return value == nullptr ? 0 : std::max(std::atoi(value), 0);
+  }();
+  return num_candidates;
+}
+
+/*!
+ * \brief Select the fastest of the algorithms returned by the heuristic.
+ * \param candidates The heuristic results, best first.
+ * \param stream The stream that the matmul runs on.
+ * \param f_matmul Run the matmul with an algorithm, returning its status.
+ * \return The fastest algorithm, or the first one if they cannot be timed.
+ */
+cublasLtMatmulAlgo_t SelectCublasLtAlgo(
+    const std::vector<cublasLtMatmulHeuristicResult_t>& candidates, cudaStream_t stream,
+    const std::function<cublasStatus_t(const cublasLtMatmulAlgo_t*)>& f_matmul) {
+  if (candidates.size() == 1) {
+    return candidates[0].algo;
+  }
+  // Timing synchronizes the stream, which is not allowed while it is captured into a CUDA graph
+  cudaStreamCaptureStatus capture_status = cudaStreamCaptureStatusNone;
+  CUDA_CALL(cudaStreamIsCapturing(stream, &capture_status));
+  if (capture_status != cudaStreamCaptureStatusNone) {
+    return candidates[0].algo;
+  }
+  constexpr int kRepeat = 5;
+  cudaEvent_t start, stop;
+  CUDA_CALL(cudaEventCreate(&start));
+  CUDA_CALL(cudaEventCreate(&stop));
+  size_t best = 0;
+  float best_time = std::numeric_limits<float>::infinity();
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    const cublasLtMatmulAlgo_t* algo = &candidates[i].algo;
+    // The first run warms up, and skips the algorithms that fail on this problem
+    if (candidates[i].state != CUBLAS_STATUS_SUCCESS || f_matmul(algo) != CUBLAS_STATUS_SUCCESS) {
+      continue;
+    }
+    CUDA_CALL(cudaEventRecord(start, stream));
+    for (int r = 0; r < kRepeat; ++r) {
+      f_matmul(algo);
+    }
+    CUDA_CALL(cudaEventRecord(stop, stream));
+    CUDA_CALL(cudaEventSynchronize(stop));
+    float time = 0.0f;
+    CUDA_CALL(cudaEventElapsedTime(&time, start, stop));
+    if (time < best_time) {
+      best = i;
+      best_time = time;
+    }
+  }
+  CUDA_CALL(cudaEventDestroy(start));
+  CUDA_CALL(cudaEventDestroy(stop));
+  return candidates[best].algo;
+}
+
 void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
                   cublasLtMatmulPreference_t matmul_pref_desc, const DLTensor* A, const DLTensor* B,
                   const DLTensor* bias, const DLTensor* scaleA, const DLTensor* scaleB,
@@ -179,35 +325,6 @@ void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
     beta = &zero_i32;
   }
 
-  cublasLtMatmulDesc_t op_desc;
-  cublasOperation_t op_transa = CUBLASBooleanToTranspose(transa);
-  cublasOperation_t op_transb = CUBLASBooleanToTranspose(transb);
-
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&op_desc, compute_type, scale_type));
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSA,
-                                                    &op_transb, sizeof(op_transb)));
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSB,
-                                                    &op_transa, sizeof(op_transa)));
-
-  if (bias != nullptr) {
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
-                                                      &bias->data, sizeof(float*)));
-  }
-
-  if (scaleA != nullptr && scaleB != nullptr) {
-    auto scaleA_data = static_cast<char*>(scaleA->data) + scaleA->byte_offset;
-    auto scaleB_data = static_cast<char*>(scaleB->data) + scaleB->byte_offset;
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER,
-                                                      &scaleA_data, sizeof(float*)));
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER,
-                                                      &scaleB_data, sizeof(float*)));
-  }
-
-  if (epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
-                                                      &epilogue, sizeof(epilogue)));
-  }
-
   int batch_offset_A = A->ndim - 2;
   int batch_offset_B = B->ndim - 2;
 
@@ -230,73 +347,127 @@ void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
     use_batched_gemm = false;
   }
 
-  int lda = transb ? K : M;
-  int ldb = transa ? N : K;
-  int ldc = M;
-
-  cublasLtMatrixLayout_t A_desc, B_desc, C_desc;
-  CHECK_CUBLAS_ERROR(
-      cublasLtMatrixLayoutCreate(&A_desc, ab_type, !transb ? M : K, !transb ? K : M, lda));
-  CHECK_CUBLAS_ERROR(
-      cublasLtMatrixLayoutCreate(&B_desc, ab_type, !transa ? K : N, !transa ? N : K, ldb));
-  CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&C_desc, c_type, M, N, ldc));
-
+  auto get_batch_count = [](int64_t* shape, int batch_offset) {
+    int64_t count = 1;
+    for (int i = 0; i < batch_offset; ++i) {
+      count *= shape[i];
+    }
+    return count;
+  };
+
+  CublasLtMatmulKey key;
+  CUDA_CALL(cudaGetDevice(&key.device_id));
+  key.ab_type = ab_type;
+  key.c_type = c_type;
+  key.transa = transa;
+  key.transb = transb;
+  key.epilogue = epilogue;
+  key.has_bias = bias != nullptr;
+  key.has_scale = scaleA != nullptr && scaleB != nullptr;
+  key.M = M;
+  key.N = N;
+  key.K = K;
   if (use_batched_gemm) {
-    auto get_batch_count = [](int64_t* shape, int batch_offset) {
-      int64_t count = 1;
-      for (int i = 0; i < batch_offset; ++i) {
-        count *= shape[i];
-      }
-      return count;
-    };
-    auto set_batch = [](cublasLtMatrixLayout_t mat_desc, int batch_count, int64_t batch_stride) {
-      CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
-          mat_desc, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
-      CHECK_CUBLAS_ERROR(
-          cublasLtMatrixLayoutSetAttribute(mat_desc, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET,
-                                           &batch_stride, sizeof(batch_stride)));
-    };
-
-    int batch_count_A = get_batch_count(A->shape, batch_offset_A);
-    int batch_count_B = get_batch_count(B->shape, batch_offset_B);
-    int batch_count_C = get_batch_count(C->shape, C->ndim - 2);
-    int64_t batch_stride_A = M * K;
-    int64_t batch_stride_B = K * N;
-    int64_t batch_stride_C = M * N;
-
+    key.batch_count_A = get_batch_count(A->shape, batch_offset_A);
+    key.batch_count_B = get_batch_count(B->shape, batch_offset_B);
+    key.batch_count_C = get_batch_count(C->shape, C->ndim - 2);
     // cuBLASLt does not seem to support batched GEMM with one of matrices having
     // one batch (with batch_stride 0).
-    ICHECK_EQ(batch_count_A, batch_count_B);
-
-    set_batch(A_desc, batch_count_A, batch_stride_A);
-    set_batch(B_desc, batch_count_B, batch_stride_B);
-    set_batch(C_desc, batch_count_C, batch_stride_C);
+    ICHECK_EQ(key.batch_count_A, key.batch_count_B);
   }
+  key.workspace_size = workspace_size;
 
   auto A_data = static_cast<char*>(A->data) + A->byte_offset;
   auto B_data = static_cast<char*>(B->data) + B->byte_offset;
   auto C_data = static_cast<char*>(C->data) + C->byte_offset;
 
-  cublasLtMatmulPreferenceSetAttribute(matmul_pref_desc, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
-                                       &workspace_size, sizeof(size_t));
+  CublasLtPlanCache* cache = CublasLtPlanCache::ThreadLocal();
+  auto it = cache->plans.find(key);
+  CublasLtMatmulPlan* plan = it != cache->plans.end() ? it->second.get() : nullptr;
+  if (plan == nullptr) {
+    if (cache->plans.size() >= CublasLtPlanCache::kMaxPlans) {
+      cache->plans.clear();
+    }
+    auto new_plan = std::make_unique<CublasLtMatmulPlan>();
+    plan = new_plan.get();
+    cache->plans.emplace(key, std::move(new_plan));
+
+    cublasOperation_t op_transa = CUBLASBooleanToTranspose(transa);
+    cublasOperation_t op_transb = CUBLASBooleanToTranspose(transb);
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&plan->op_desc, compute_type, scale_type));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan->op_desc, CUBLASLT_MATMUL_DESC_TRANSA,
+                                                      &op_transb, sizeof(op_transb)));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan->op_desc, CUBLASLT_MATMUL_DESC_TRANSB,
+                                                      &op_transa, sizeof(op_transa)));
+    if (epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
+      CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+          plan->op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE, &epilogue, sizeof(epilogue)));
+    }
 
-  cublasLtMatmulHeuristicResult_t heuristic_result = {};
-  int returned_result = 0;
-  CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(hdl, op_desc, A_desc, B_desc, C_desc, C_desc,
-                                                    matmul_pref_desc, 1, &heuristic_result,
-                                                    &returned_result));
-  if (returned_result == 0) {
-    CHECK_CUBLAS_ERROR(CUBLAS_STATUS_NOT_SUPPORTED);
+    int lda = transb ? K : M;
+    int ldb = transa ? N : K;
+    int ldc = M;
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->A_desc, ab_type, !transb ? M : K,
+                                                  !transb ? K : M, lda));
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->B_desc, ab_type, !transa ? K : N,
+                                                  !transa ? N : K, ldb));
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->C_desc, c_type, M, N, ldc));
+
+    if (use_batched_gemm) {
+      auto set_batch = [](cublasLtMatrixLayout_t mat_desc, int batch_count, int64_t batch_stride) {
+        CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
+            mat_desc, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
+        CHECK_CUBLAS_ERROR(
+            cublasLtMatrixLayoutSetAttribute(mat_desc, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET,
+                                             &batch_stride, sizeof(batch_stride)));
+      };
+      set_batch(plan->A_desc, key.batch_count_A, static_cast<int64_t>(M) * K);
+      set_batch(plan->B_desc, key.batch_count_B, static_cast<int64_t>(K) * N);
+      set_batch(plan->C_desc, key.batch_count_C, static_cast<int64_t>(M) * N);
+    }
   }
 
-  CHECK_CUBLAS_ERROR(cublasLtMatmul(hdl, op_desc, alpha, B_data, A_desc, A_data, B_desc, beta,
-                                    C_data, C_desc, C_data, C_desc, &heuristic_result.algo,
-                                    workspace_ptr, workspace_size, stream));
+  // The pointers change from call to call, so they are not part of the plan
+  if (bias != nullptr) {
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan->op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias->data, sizeof(float*)));
+  }
+
+  if (scaleA != nullptr && scaleB != nullptr) {
+    auto scaleA_data = static_cast<char*>(scaleA->data) + scaleA->byte_offset;
+    auto scaleB_data = static_cast<char*>(scaleB->data) + scaleB->byte_offset;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan->op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER, &scaleA_data, sizeof(float*)));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan->op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER, &scaleB_data, sizeof(float*)));
+  }
+
+  auto f_matmul = [&](const cublasLtMatmulAlgo_t* algo) {
+    return cublasLtMatmul(hdl, plan->op_desc, alpha, B_data, plan->A_desc, A_data, plan->B_desc,
+                          beta, C_data, plan->C_desc, C_data, plan->C_desc, algo, workspace_ptr,
+                          workspace_size, stream);
+  };
+
+  if (!plan->algo_selected) {
+    cublasLtMatmulPreferenceSetAttribute(matmul_pref_desc,
+                                         CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_size,
+                                         sizeof(size_t));
+    int num_candidates = std::max(GetCublasLtAutotuneCandidates(), 1);
+    std::vector<cublasLtMatmulHeuristicResult_t> heuristic_results(num_candidates);
+    int returned_result = 0;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(
+        hdl, plan->op_desc, plan->A_desc, plan->B_desc, plan->C_desc, plan->C_desc,
+        matmul_pref_desc, num_candidates, heuristic_results.data(), &returned_result));
+    if (returned_result == 0) {
+      cache->plans.erase(key);
+      CHECK_CUBLAS_ERROR(CUBLAS_STATUS_NOT_SUPPORTED);
+    }
+    heuristic_results.resize(returned_result);
+    plan->algo = SelectCublasLtAlgo(heuristic_results, stream, f_matmul);
+    plan->algo_selected = true;
+  }
 
-  cublasLtMatmulDescDestroy(op_desc);
-  cublasLtMatrixLayoutDestroy(A_desc);
-  cublasLtMatrixLayoutDestroy(B_desc);
-  cublasLtMatrixLayoutDestroy(C_desc);
+  CHECK_CUBLAS_ERROR(f_matmul(&plan->algo));
 }
 
 inline void CallLtIgemm(TVMArgs args, TVMRetValue* ret, cublasLtHandle_t hdl, cudaStream_t stream) {
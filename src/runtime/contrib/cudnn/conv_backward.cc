@@ -64,6 +64,17 @@ void BackwardDataFindAlgo(int format, int dims, int groups, const int pad[], con
                           const int dilation[], const int dy_dim[], const int w_dim[],
                           const int dx_dim[], const std::string& data_dtype,
                           const std::string& conv_dtype, bool verbose, TVMRetValue* ret) {
+  ConvAlgoCache* cache = ConvAlgoCache::Global();
+  std::string key = cache->MakeKey("bwd_data", format, dims, groups, pad, stride, dilation,
+                                   dy_dim, w_dim, dx_dim, data_dtype, conv_dtype);
+  int cached_algo = cache->Get(key);
+  if (cached_algo >= 0) {
+    if (verbose) {
+      LOG(INFO) << "\tCUDNN uses the cached bwd data algorithm " << cached_algo;
+    }
+    ret[0] = cached_algo;
+    return;
+  }
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal();
   const int full_dims = dims + 2;
   std::vector<int64_t> dy_dim_int64(full_dims);
@@ -104,6 +115,7 @@ void BackwardDataFindAlgo(int format, int dims, int groups, const int pad[], con
                 << ", Memory: " << perf_results[i].memory;
     }
   }
+  cache->Set(key, best_algo);
   ret[0] = best_algo;
 }
 
@@ -141,6 +153,17 @@ void BackwardFilterFindAlgo(int format, int dims, int groups, const int pad[], c
                             const int dilation[], const int dy_dim[], const int x_dim[],
                             const int dw_dim[], const std::string& data_dtype,
                             const std::string& conv_dtype, bool verbose, TVMRetValue* ret) {
+  ConvAlgoCache* cache = ConvAlgoCache::Global();
+  std::string key = cache->MakeKey("bwd_filter", format, dims, groups, pad, stride, dilation,
+                                   dy_dim, x_dim, dw_dim, data_dtype, conv_dtype);
+  int cached_algo = cache->Get(key);
+  if (cached_algo >= 0) {
+    if (verbose) {
+      LOG(INFO) << "\tCUDNN uses the cached bwd filter algorithm " << cached_algo;
+    }
+    ret[0] = cached_algo;
+    return;
+  }
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal();
   const int full_dims = dims + 2;
   std::vector<int64_t> x_dim_int64(full_dims);
@@ -182,6 +205,7 @@ void BackwardFilterFindAlgo(int format, int dims, int groups, const int pad[], c
                 << ", Memory: " << perf_results[i].memory;
     }
   }
+  cache->Set(key, best_algo);
   ret[0] = best_algo;
 }
 
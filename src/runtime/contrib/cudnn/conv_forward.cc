@@ -109,6 +109,17 @@ void FindAlgo(int format, int dims, int groups, const int pad[], const int strid
               const int dilation[], const int x_dim[], const int w_dim[], const int y_dim[],
               const std::string& data_dtype, const std::string& conv_dtype, bool verbose,
               TVMRetValue* ret) {
+  ConvAlgoCache* cache = ConvAlgoCache::Global();
+  std::string key = cache->MakeKey("fwd", format, dims, groups, pad, stride, dilation,
+                                   x_dim, w_dim, y_dim, data_dtype, conv_dtype);
+  int cached_algo = cache->Get(key);
+  if (cached_algo >= 0) {
+    if (verbose) {
+      LOG(INFO) << "\tCUDNN uses the cached fwd algorithm " << cached_algo;
+    }
+    ret[0] = cached_algo;
+    return;
+  }
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal();
   const int full_dims = dims + 2;
   std::vector<int64_t> x_dim_int64(full_dims);
@@ -150,6 +161,7 @@ void FindAlgo(int format, int dims, int groups, const int pad[], const int strid
     }
   }
 
+  cache->Set(key, best_algo);
   ret[0] = best_algo;
 }
 
@@ -27,25 +27,38 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
 #include "../../../cuda/cuda_common.h"
 #include "../cudnn_utils.h"
 
 namespace tvm {
 namespace contrib {
 
+/*!
+ * \brief The graphs built in the process, keyed by the device and the attention they compute.
+ * Building a graph queries the heuristics and compiles its execution plan, which takes much longer
+ * than running it, so the runners of the same attention share one graph.
+ */
+struct SDPAGraphCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<cudnn_frontend::graph::Graph>> graphs;
+
+  static SDPAGraphCache* Global() {
+    static SDPAGraphCache* inst = new SDPAGraphCache();
+    return inst;
+  }
+};
+
 void CuDNNSDPARunnerNode::Init(int64_t batch, int64_t seq_len, int64_t num_heads,
                                int64_t num_kv_heads, int64_t head_size, int64_t head_size_v,
                                double scale, const DLDataType& data_type,
                                const std::string& layout) {
-  graph_ = std::make_unique<cudnn_frontend::graph::Graph>();
-
   CHECK(data_type.code == DLDataTypeCode::kDLFloat && data_type.bits == 16)
       << "Only float16 is supported";
 
-  graph_->set_io_data_type(cudnn_frontend::DataType_t::HALF)
-      .set_intermediate_data_type(cudnn_frontend::DataType_t::FLOAT)
-      .set_compute_data_type(cudnn_frontend::DataType_t::FLOAT);
-
   auto q_desc = cudnn_frontend::graph::Tensor_attributes().set_name("Q").set_uid(kTensorIDQ);
   auto k_desc = cudnn_frontend::graph::Tensor_attributes().set_name("K").set_uid(kTensorIDK);
   auto v_desc = cudnn_frontend::graph::Tensor_attributes().set_name("V").set_uid(kTensorIDV);
@@ -82,6 +95,26 @@ void CuDNNSDPARunnerNode::Init(int64_t batch, int64_t seq_len, int64_t num_heads
     LOG(FATAL) << "Unsupported layout: " << layout;
   }
 
+  int device_id = 0;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  std::ostringstream key_os;
+  key_os.precision(17);
+  key_os << device_id << "," << batch << "," << seq_len << "," << num_heads << "," << num_kv_heads
+         << "," << head_size << "," << head_size_v << "," << scale << "," << layout;
+  std::string key = key_os.str();
+  SDPAGraphCache* cache = SDPAGraphCache::Global();
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  auto it = cache->graphs.find(key);
+  if (it != cache->graphs.end()) {
+    graph_ = it->second;
+    return;
+  }
+
+  graph_ = std::make_shared<cudnn_frontend::graph::Graph>();
+  graph_->set_io_data_type(cudnn_frontend::DataType_t::HALF)
+      .set_intermediate_data_type(cudnn_frontend::DataType_t::FLOAT)
+      .set_compute_data_type(cudnn_frontend::DataType_t::FLOAT);
+
   q_desc = q_desc.set_dim({batch, num_heads, seq_len, head_size}).set_stride(q_stride);
   k_desc = k_desc.set_dim({batch, num_kv_heads, seq_len, head_size}).set_stride(k_stride);
   v_desc = v_desc.set_dim({batch, num_kv_heads, seq_len, head_size_v}).set_stride(v_stride);
@@ -100,6 +133,7 @@ void CuDNNSDPARunnerNode::Init(int64_t batch, int64_t seq_len, int64_t num_heads
   o->set_output(true).set_dim({batch, num_heads, seq_len, head_size_v}).set_stride(o_stride);
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal();
   CUDNN_FRONTEND_CALL(graph_->build(entry_ptr->handle, {cudnn_frontend::HeurMode_t::A}));
+  cache->graphs.emplace(key, graph_);
 }
 
 void CuDNNSDPARunnerNode::Run(const DLTensor* qkv, DLTensor* workspace, DLTensor* out) {
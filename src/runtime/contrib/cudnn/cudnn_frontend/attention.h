@@ -60,7 +60,8 @@ class CuDNNSDPARunnerNode : public tvm::runtime::Object {
   static constexpr int kTensorIDOut = 4;
 
  private:
-  std::unique_ptr<cudnn_frontend::graph::Graph> graph_{nullptr};
+  /*! \brief The built graph, shared by the runners of the same attention. */
+  std::shared_ptr<cudnn_frontend::graph::Graph> graph_{nullptr};
   int64_t offset_q_{0};
   int64_t offset_k_{0};
   int64_t offset_v_{0};
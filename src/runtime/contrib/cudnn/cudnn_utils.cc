@@ -27,6 +27,10 @@
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -259,6 +263,86 @@ void SetConvDescriptors(CuDNNThreadEntry* entry_ptr, int format, int dims, int g
   }
 }
 
+// ConvAlgoCache
+
+ConvAlgoCache* ConvAlgoCache::Global() {
+  static ConvAlgoCache* inst = new ConvAlgoCache();
+  return inst;
+}
+
+std::string ConvAlgoCache::MakeKey(const std::string& kind, int format, int dims, int groups,
+                                   const int pad[], const int stride[], const int dilation[],
+                                   const int x_dim[], const int w_dim[], const int y_dim[],
+                                   const std::string& data_dtype, const std::string& conv_dtype) {
+  int device_id = 0;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  std::string device_name;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = device_names_.find(device_id);
+    if (it == device_names_.end()) {
+      cudaDeviceProp prop;
+      CUDA_CALL(cudaGetDeviceProperties(&prop, device_id));
+      std::string name = std::string(prop.name) + "_sm" + std::to_string(prop.major) +
+                         std::to_string(prop.minor);
+      std::replace(name.begin(), name.end(), ' ', '_');
+      it = device_names_.emplace(device_id, name).first;
+    }
+    device_name = it->second;
+  }
+  std::ostringstream os;
+  auto f_print = [&os](const char* name, const int* values, int n) {
+    os << "," << name;
+    for (int i = 0; i < n; ++i) {
+      os << (i == 0 ? "=" : "x") << values[i];
+    }
+  };
+  os << kind << "," << device_name << ",format=" << format << ",groups=" << groups;
+  f_print("pad", pad, dims);
+  f_print("stride", stride, dims);
+  f_print("dilation", dilation, dims);
+  f_print("x", x_dim, dims + 2);
+  f_print("w", w_dim, dims + 2);
+  f_print("y", y_dim, dims + 2);
+  os << "," << data_dtype << "," << conv_dtype;
+  return os.str();
+}
+
+void ConvAlgoCache::LoadFromDisk() {
+  if (loaded_) return;
+  loaded_ = true;
+  const char* cache_dir = std::getenv("TVM_CUDNN_CACHE_DIR");
+  if (cache_dir == nullptr || *cache_dir == '\0') return;
+  path_ = std::string(cache_dir) + "/cudnn_conv_algos_v" + std::to_string(cudnnGetVersion()) +
+          ".txt";
+  std::ifstream fin(path_);
+  std::string key;
+  int algo = -1;
+  while (fin >> key >> algo) {
+    algos_[key] = algo;
+  }
+}
+
+int ConvAlgoCache::Get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadFromDisk();
+  auto it = algos_.find(key);
+  return it == algos_.end() ? -1 : it->second;
+}
+
+void ConvAlgoCache::Set(const std::string& key, int algo) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadFromDisk();
+  algos_[key] = algo;
+  if (path_.empty()) return;
+  // Every entry is a single short line appended at once, so that concurrent processes sharing the
+  // file do not corrupt it
+  std::ofstream fout(path_, std::ios::app);
+  if (!(fout << key + " " + std::to_string(algo) + "\n")) {
+    LOG(WARNING) << "Cannot write the cuDNN algorithm cache file " << path_;
+  }
+}
+
 // SoftmaxEntry
 
 SoftmaxEntry::SoftmaxEntry() { CUDNN_CALL(cudnnCreateTensorDescriptor(&shape_desc)); }
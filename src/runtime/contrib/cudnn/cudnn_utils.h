@@ -28,7 +28,9 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "../../cuda/cuda_common.h"
 
@@ -114,6 +116,49 @@ void SetConvDescriptors(CuDNNThreadEntry* entry_ptr, int format, int dims, int g
                         int64_t w_dim[], int64_t y_dim[], DLDataType data_dtype,
                         const std::string& conv_dtype);
 
+/*!
+ * \brief The cache of the convolution algorithms found by cuDNN, which benchmarks every algorithm
+ * of a convolution. It is kept in memory for the lifetime of the process and, when the environment
+ * variable TVM_CUDNN_CACHE_DIR is set, in a file of that directory shared by all the processes, so
+ * that each convolution is benchmarked only once per GPU and cuDNN version.
+ */
+class ConvAlgoCache {
+ public:
+  /*! \brief The cache of the process. */
+  static ConvAlgoCache* Global();
+
+  /*!
+   * \brief Make the key of a convolution on the current GPU.
+   * \param kind The kind of the convolution, "fwd", "bwd_data" or "bwd_filter".
+   * \return The key, which has no whitespace.
+   */
+  std::string MakeKey(const std::string& kind, int format, int dims, int groups, const int pad[],
+                      const int stride[], const int dilation[], const int x_dim[],
+                      const int w_dim[], const int y_dim[], const std::string& data_dtype,
+                      const std::string& conv_dtype);
+
+  /*! \brief Get the algorithm cached for a key, or -1 if there is none. */
+  int Get(const std::string& key);
+
+  /*! \brief Cache the algorithm found for a key. */
+  void Set(const std::string& key, int algo);
+
+ private:
+  /*! \brief Load the algorithms cached on disk, once. The mutex must be held. */
+  void LoadFromDisk();
+
+  /*! \brief The mutex guarding the cache. */
+  std::mutex mutex_;
+  /*! \brief Whether the cache file was loaded. */
+  bool loaded_{false};
+  /*! \brief The path of the cache file, empty if the cache is in memory only. */
+  std::string path_;
+  /*! \brief The cached algorithm of each key. */
+  std::unordered_map<std::string, int> algos_;
+  /*! \brief The description of each GPU, as part of the keys. */
+  std::unordered_map<int, std::string> device_names_;
+};
+
 void FindAlgo(int format, int dims, int groups, const int pad[], const int stride[],
               const int dilation[], const int x_dim[], const int w_dim[], const int y_dim[],
               const std::string& data_dtype, const std::string& conv_dtype, bool verbose,
@@ -0,0 +1,536 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <cuda.h>
+#include <cuda_runtime.h>
+#include <cupti_profiler_target.h>
+#include <cupti_target.h>
+#include <nvperf_cuda_host.h>
+#include <nvperf_host.h>
+#include <nvperf_target.h>
+#include <tvm/runtime/contrib/cupti.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#define CUPTI_CALL(func)                                                      \
+  {                                                                           \
+    CUptiResult e = (func);                                                   \
+    if (e != CUPTI_SUCCESS) {                                                 \
+      const char* msg = "";                                                   \
+      cuptiGetResultString(e, &msg);                                          \
+      LOG(FATAL) << "CUPTIError: in function " #func " " << e << " " << msg; \
+    }                                                                         \
+  }
+
+#define NVPW_CALL(func)                                         \
+  {                                                             \
+    NVPA_Status e = (func);                                     \
+    if (e != NVPA_STATUS_SUCCESS) {                             \
+      LOG(FATAL) << "NVPWError: in function " #func " " << e; \
+    }                                                           \
+  }
+
+/*!
+ * \brief The default metrics, which place a kernel on the roofline: the achieved occupancy, the
+ * SM efficiency, the DRAM traffic and the FP32 instructions.
+ */
+static const std::vector<std::string> default_metric_names = {
+    "sm__warps_active.avg.pct_of_peak_sustained_active",
+    "smsp__cycles_active.avg.pct_of_peak_sustained_elapsed",
+    "dram__bytes_read.sum",
+    "dram__bytes_write.sum",
+    "smsp__sass_thread_inst_executed_op_fadd_pred_on.sum",
+    "smsp__sass_thread_inst_executed_op_fmul_pred_on.sum",
+    "smsp__sass_thread_inst_executed_op_ffma_pred_on.sum"};
+
+/*! \brief The metric weighting the averages over the kernels of a call. */
+static const char* kDurationMetric = "gpu__time_duration.sum";
+
+/*! \brief Object that holds the first kernel profiled in a function call. */
+struct CUPTIRangeNode : public Object {
+  /*! \brief The index of the first range, i.e. kernel, of the call in the counter data. */
+  size_t begin;
+  /*! \brief The device these counters are for. */
+  Device dev;
+
+  explicit CUPTIRangeNode(size_t begin, Device dev) : begin(begin), dev(dev) {}
+
+  static constexpr const char* _type_key = "CUPTIRangeNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTIRangeNode, Object);
+};
+
+/*! \brief MetricCollectorNode for CUPTI metrics.
+ *
+ * The kernels are profiled in a CUPTI session with automatic ranges and kernel
+ * replay, so every kernel is a range of the counter data, replayed as many
+ * times as its metrics need passes. A session spans the outermost call on a
+ * device, and the metrics of a call are evaluated over the ranges of the
+ * kernels it launched. The metrics of the kernels are summed for the `.sum`
+ * metrics, and averaged weighted by the kernel durations for the others.
+ *
+ * Since the kernels are replayed, the durations of the profiled calls are not
+ * meaningful when this collector is used.
+ */
+struct CUPTIMetricCollectorNode final : public MetricCollectorNode {
+  /*! \brief Construct a metric collector that collects a specific set of metrics.
+   *
+   * \param metrics The metrics that should be collected on the CUDA devices.
+   */
+  explicit CUPTIMetricCollectorNode(Array<String> metrics) {
+    for (const String& metric : metrics) {
+      metric_names.push_back(metric);
+    }
+    if (metric_names.empty()) {
+      metric_names = default_metric_names;
+    }
+    num_reported_metrics = metric_names.size();
+    if (std::find(metric_names.begin(), metric_names.end(), kDurationMetric) ==
+        metric_names.end()) {
+      metric_names.push_back(kDurationMetric);
+    }
+    for (const std::string& metric : metric_names) {
+      metric_name_ptrs.push_back(metric.c_str());
+    }
+  }
+
+  /*! \brief Initialization call.
+   * \param devices The devices this collector will be running on
+   */
+  void Init(Array<DeviceWrapper> devices) {
+    bool initialized = false;
+    for (auto wrapped_device : devices) {
+      Device device = wrapped_device->device;
+      if (device.device_type != kDLCUDA) {
+        continue;
+      }
+      if (!initialized) {
+        CUpti_Profiler_Initialize_Params initialize_params = {
+            CUpti_Profiler_Initialize_Params_STRUCT_SIZE};
+        CUPTI_CALL(cuptiProfilerInitialize(&initialize_params));
+        NVPW_InitializeHost_Params initialize_host_params = {
+            NVPW_InitializeHost_Params_STRUCT_SIZE};
+        NVPW_CALL(NVPW_InitializeHost(&initialize_host_params));
+        initialized = true;
+      }
+      sessions[device.device_id].Init(device.device_id, metric_names);
+    }
+  }
+
+  /*! \brief Called right before a function call. Begins the profiling session
+   * if the call is the outermost one on the device.
+   *
+   * \param dev The device the function will be run on.
+   * \returns A `CUPTIRangeNode` containing the first kernel of the call.
+   * Passed to a corresponding `Stop` call.
+   */
+  ObjectRef Start(Device dev) final {
+    auto it = sessions.find(dev.device_id);
+    if (dev.device_type != kDLCUDA || it == sessions.end()) {
+      return ObjectRef(nullptr);
+    }
+    Session& session = it->second;
+    size_t begin = session.depth == 0 ? session.Begin() : session.NumRanges();
+    ++session.depth;
+    return ObjectRef(make_object<CUPTIRangeNode>(begin, dev));
+  }
+
+  /*! \brief Called right after a function call. Evaluates the metrics of the
+   * kernels launched since the corresponding `Start` call.
+   *
+   * \param obj `CUPTIRangeNode` created by a call to `Start`.
+   * \returns A mapping from metric name to value.
+   */
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    const CUPTIRangeNode* range_node = obj.as<CUPTIRangeNode>();
+    Session& session = sessions.at(range_node->dev.device_id);
+    size_t end = session.NumRanges();
+    std::vector<double> sums(metric_names.size(), 0.0);
+    std::vector<double> values(metric_names.size());
+    size_t duration_index =
+        std::find(metric_names.begin(), metric_names.end(), kDurationMetric) - metric_names.begin();
+    double total_duration = 0.0;
+    for (size_t range = range_node->begin; range < end; ++range) {
+      session.Evaluate(range, metric_name_ptrs, values.data());
+      double duration = values[duration_index];
+      total_duration += duration;
+      for (size_t i = 0; i < metric_names.size(); ++i) {
+        sums[i] += IsSum(metric_names[i]) ? values[i] : values[i] * duration;
+      }
+    }
+    if (--session.depth == 0) {
+      session.End();
+    }
+
+    std::unordered_map<String, ObjectRef> reported_metrics;
+    if (end == range_node->begin) {
+      // No kernel was launched by the call
+      return reported_metrics;
+    }
+    for (size_t i = 0; i < num_reported_metrics; ++i) {
+      const std::string& name = metric_names[i];
+      if (IsSum(name)) {
+        reported_metrics[name] = ObjectRef(make_object<CountNode>(std::llround(sums[i])));
+      } else {
+        double value = total_duration > 0 ? sums[i] / total_duration : 0.0;
+        if (name.find(".pct") != std::string::npos) {
+          reported_metrics[name] = ObjectRef(make_object<PercentNode>(value));
+        } else {
+          reported_metrics[name] = ObjectRef(make_object<RatioNode>(value));
+        }
+      }
+    }
+    return reported_metrics;
+  }
+
+  ~CUPTIMetricCollectorNode() final {
+    for (auto& p : sessions) {
+      if (p.second.depth > 0) {
+        p.second.End();
+      }
+    }
+  }
+
+  /*! \brief The profiling session and the images of the metrics on a device. */
+  struct Session {
+    Session() = default;
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    /*! \brief The context of the device. */
+    CUcontext ctx{nullptr};
+    /*! \brief The number of calls in flight on the device. */
+    int depth{0};
+    /*! \brief The configuration of the counters to collect. */
+    std::vector<uint8_t> config_image;
+    /*! \brief The prefix of the counter data image. */
+    std::vector<uint8_t> counter_data_prefix;
+    /*! \brief The counter data of the kernels profiled in the session. */
+    std::vector<uint8_t> counter_data_image;
+    /*! \brief The scratch buffer of the counter data image. */
+    std::vector<uint8_t> scratch_buffer;
+    /*! \brief The context evaluating the metrics from the counter data. */
+    NVPA_MetricsContext* metrics_context{nullptr};
+
+    /*! \brief Build the images collecting the given metrics on the device. */
+    void Init(int device_id, const std::vector<std::string>& metric_names) {
+      // Retain the primary context, which the kernels are launched in
+      CUDA_CALL(cudaSetDevice(device_id));
+      CUDA_CALL(cudaFree(nullptr));
+      CUDA_DRIVER_CALL(cuCtxGetCurrent(&ctx));
+
+      CUpti_Device_GetChipName_Params chip_name_params = {
+          CUpti_Device_GetChipName_Params_STRUCT_SIZE};
+      chip_name_params.deviceIndex = device_id;
+      CUPTI_CALL(cuptiDeviceGetChipName(&chip_name_params));
+      const char* chip_name = chip_name_params.pChipName;
+
+      CUpti_Profiler_GetCounterAvailability_Params availability_params = {
+          CUpti_Profiler_GetCounterAvailability_Params_STRUCT_SIZE};
+      availability_params.ctx = ctx;
+      CUPTI_CALL(cuptiProfilerGetCounterAvailability(&availability_params));
+      std::vector<uint8_t> availability_image(availability_params.counterAvailabilityImageSize);
+      availability_params.pCounterAvailabilityImage = availability_image.data();
+      CUPTI_CALL(cuptiProfilerGetCounterAvailability(&availability_params));
+
+      NVPW_CUDA_MetricsContext_Create_Params metrics_context_params = {
+          NVPW_CUDA_MetricsContext_Create_Params_STRUCT_SIZE};
+      metrics_context_params.pChipName = chip_name;
+      NVPW_CALL(NVPW_CUDA_MetricsContext_Create(&metrics_context_params));
+      metrics_context = metrics_context_params.pMetricsContext;
+
+      // Collect the raw counters the metrics are computed from
+      std::vector<std::string> raw_metric_names;
+      for (const std::string& metric : metric_names) {
+        NVPW_MetricsContext_GetMetricProperties_Begin_Params begin_params = {
+            NVPW_MetricsContext_GetMetricProperties_Begin_Params_STRUCT_SIZE};
+        begin_params.pMetricsContext = metrics_context;
+        begin_params.pMetricName = metric.c_str();
+        if (NVPW_MetricsContext_GetMetricProperties_Begin(&begin_params) != NVPA_STATUS_SUCCESS) {
+          LOG(FATAL) << "CUPTIError: Unknown metric " << metric
+                     << ". Available metrics are listed by `ncu --query-metrics`.";
+        }
+        for (const char** dep = begin_params.ppRawMetricDependencies; *dep != nullptr; ++dep) {
+          raw_metric_names.push_back(*dep);
+        }
+        NVPW_MetricsContext_GetMetricProperties_End_Params end_params = {
+            NVPW_MetricsContext_GetMetricProperties_End_Params_STRUCT_SIZE};
+        end_params.pMetricsContext = metrics_context;
+        NVPW_CALL(NVPW_MetricsContext_GetMetricProperties_End(&end_params));
+      }
+      std::vector<NVPA_RawMetricRequest> raw_metric_requests;
+      for (const std::string& name : raw_metric_names) {
+        NVPA_RawMetricRequest request = {NVPA_RAW_METRIC_REQUEST_STRUCT_SIZE};
+        request.pMetricName = name.c_str();
+        request.isolated = true;
+        request.keepInstances = true;
+        raw_metric_requests.push_back(request);
+      }
+
+      // The configuration image
+      NVPW_CUDA_RawMetricsConfig_Create_V2_Params config_params = {
+          NVPW_CUDA_RawMetricsConfig_Create_V2_Params_STRUCT_SIZE};
+      config_params.activityKind = NVPA_ACTIVITY_KIND_PROFILER;
+      config_params.pChipName = chip_name;
+      config_params.pCounterAvailabilityImage = availability_image.data();
+      NVPW_CALL(NVPW_CUDA_RawMetricsConfig_Create_V2(&config_params));
+      NVPA_RawMetricsConfig* raw_config = config_params.pRawMetricsConfig;
+      NVPW_RawMetricsConfig_SetCounterAvailability_Params set_availability_params = {
+          NVPW_RawMetricsConfig_SetCounterAvailability_Params_STRUCT_SIZE};
+      set_availability_params.pRawMetricsConfig = raw_config;
+      set_availability_params.pCounterAvailabilityImage = availability_image.data();
+      NVPW_CALL(NVPW_RawMetricsConfig_SetCounterAvailability(&set_availability_params));
+      NVPW_RawMetricsConfig_BeginPassGroup_Params begin_group_params = {
+          NVPW_RawMetricsConfig_BeginPassGroup_Params_STRUCT_SIZE};
+      begin_group_params.pRawMetricsConfig = raw_config;
+      NVPW_CALL(NVPW_RawMetricsConfig_BeginPassGroup(&begin_group_params));
+      NVPW_RawMetricsConfig_AddMetrics_Params config_add_params = {
+          NVPW_RawMetricsConfig_AddMetrics_Params_STRUCT_SIZE};
+      config_add_params.pRawMetricsConfig = raw_config;
+      config_add_params.pRawMetricRequests = raw_metric_requests.data();
+      config_add_params.numMetricRequests = raw_metric_requests.size();
+      NVPW_CALL(NVPW_RawMetricsConfig_AddMetrics(&config_add_params));
+      NVPW_RawMetricsConfig_EndPassGroup_Params end_group_params = {
+          NVPW_RawMetricsConfig_EndPassGroup_Params_STRUCT_SIZE};
+      end_group_params.pRawMetricsConfig = raw_config;
+      NVPW_CALL(NVPW_RawMetricsConfig_EndPassGroup(&end_group_params));
+      NVPW_RawMetricsConfig_GenerateConfigImage_Params generate_params = {
+          NVPW_RawMetricsConfig_GenerateConfigImage_Params_STRUCT_SIZE};
+      generate_params.pRawMetricsConfig = raw_config;
+      NVPW_CALL(NVPW_RawMetricsConfig_GenerateConfigImage(&generate_params));
+      NVPW_RawMetricsConfig_GetConfigImage_Params get_config_params = {
+          NVPW_RawMetricsConfig_GetConfigImage_Params_STRUCT_SIZE};
+      get_config_params.pRawMetricsConfig = raw_config;
+      NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&get_config_params));
+      config_image.resize(get_config_params.bytesCopied);
+      get_config_params.bytesAllocated = config_image.size();
+      get_config_params.pBuffer = config_image.data();
+      NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&get_config_params));
+      NVPW_RawMetricsConfig_Destroy_Params config_destroy_params = {
+          NVPW_RawMetricsConfig_Destroy_Params_STRUCT_SIZE};
+      config_destroy_params.pRawMetricsConfig = raw_config;
+      NVPW_CALL(NVPW_RawMetricsConfig_Destroy(&config_destroy_params));
+
+      // The prefix of the counter data image
+      NVPW_CUDA_CounterDataBuilder_Create_Params builder_params = {
+          NVPW_CUDA_CounterDataBuilder_Create_Params_STRUCT_SIZE};
+      builder_params.pChipName = chip_name;
+      NVPW_CALL(NVPW_CUDA_CounterDataBuilder_Create(&builder_params));
+      NVPW_CounterDataBuilder_AddMetrics_Params builder_add_params = {
+          NVPW_CounterDataBuilder_AddMetrics_Params_STRUCT_SIZE};
+      builder_add_params.pCounterDataBuilder = builder_params.pCounterDataBuilder;
+      builder_add_params.pRawMetricRequests = raw_metric_requests.data();
+      builder_add_params.numMetricRequests = raw_metric_requests.size();
+      NVPW_CALL(NVPW_CounterDataBuilder_AddMetrics(&builder_add_params));
+      NVPW_CounterDataBuilder_GetCounterDataPrefix_Params prefix_params = {
+          NVPW_CounterDataBuilder_GetCounterDataPrefix_Params_STRUCT_SIZE};
+      prefix_params.pCounterDataBuilder = builder_params.pCounterDataBuilder;
+      NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&prefix_params));
+      counter_data_prefix.resize(prefix_params.bytesCopied);
+      prefix_params.bytesAllocated = counter_data_prefix.size();
+      prefix_params.pBuffer = counter_data_prefix.data();
+      NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&prefix_params));
+      NVPW_CounterDataBuilder_Destroy_Params builder_destroy_params = {
+          NVPW_CounterDataBuilder_Destroy_Params_STRUCT_SIZE};
+      builder_destroy_params.pCounterDataBuilder = builder_params.pCounterDataBuilder;
+      NVPW_CALL(NVPW_CounterDataBuilder_Destroy(&builder_destroy_params));
+    }
+
+    /*! \brief Begin a profiling session with an empty counter data image. */
+    size_t Begin() {
+      CUpti_Profiler_CounterDataImageOptions options;
+      options.structSize = CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+      options.pPriv = nullptr;
+      options.pCounterDataPrefix = counter_data_prefix.data();
+      options.counterDataPrefixSize = counter_data_prefix.size();
+      options.maxNumRanges = kMaxNumRanges;
+      options.maxNumRangeTreeNodes = kMaxNumRanges;
+      options.maxRangeNameLength = 64;
+      CUpti_Profiler_CounterDataImage_CalculateSize_Params size_params = {
+          CUpti_Profiler_CounterDataImage_CalculateSize_Params_STRUCT_SIZE};
+      size_params.pOptions = &options;
+      size_params.sizeofCounterDataImageOptions =
+          CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+      CUPTI_CALL(cuptiProfilerCounterDataImageCalculateSize(&size_params));
+      counter_data_image.resize(size_params.counterDataImageSize);
+      CUpti_Profiler_CounterDataImage_Initialize_Params image_params = {
+          CUpti_Profiler_CounterDataImage_Initialize_Params_STRUCT_SIZE};
+      image_params.sizeofCounterDataImageOptions =
+          CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+      image_params.pOptions = &options;
+      image_params.counterDataImageSize = counter_data_image.size();
+      image_params.pCounterDataImage = counter_data_image.data();
+      CUPTI_CALL(cuptiProfilerCounterDataImageInitialize(&image_params));
+      CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params scratch_size_params = {
+          CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params_STRUCT_SIZE};
+      scratch_size_params.counterDataImageSize = counter_data_image.size();
+      scratch_size_params.pCounterDataImage = counter_data_image.data();
+      CUPTI_CALL(cuptiProfilerCounterDataImageCalculateScratchBufferSize(&scratch_size_params));
+      scratch_buffer.resize(scratch_size_params.counterDataScratchBufferSize);
+      CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params scratch_params = {
+          CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params_STRUCT_SIZE};
+      scratch_params.counterDataImageSize = counter_data_image.size();
+      scratch_params.pCounterDataImage = counter_data_image.data();
+      scratch_params.counterDataScratchBufferSize = scratch_buffer.size();
+      scratch_params.pCounterDataScratchBuffer = scratch_buffer.data();
+      CUPTI_CALL(cuptiProfilerCounterDataImageInitializeScratchBuffer(&scratch_params));
+
+      CUpti_Profiler_BeginSession_Params session_params = {
+          CUpti_Profiler_BeginSession_Params_STRUCT_SIZE};
+      session_params.ctx = ctx;
+      session_params.counterDataImageSize = counter_data_image.size();
+      session_params.pCounterDataImage = counter_data_image.data();
+      session_params.counterDataScratchBufferSize = scratch_buffer.size();
+      session_params.pCounterDataScratchBuffer = scratch_buffer.data();
+      session_params.range = CUPTI_AutoRange;
+      session_params.replayMode = CUPTI_KernelReplay;
+      session_params.maxRangesPerPass = kMaxNumRanges;
+      session_params.maxLaunchesPerPass = kMaxNumRanges;
+      CUPTI_CALL(cuptiProfilerBeginSession(&session_params));
+      CUpti_Profiler_SetConfig_Params config_params = {CUpti_Profiler_SetConfig_Params_STRUCT_SIZE};
+      config_params.ctx = ctx;
+      config_params.pConfig = config_image.data();
+      config_params.configSize = config_image.size();
+      config_params.passIndex = 0;
+      config_params.minNestingLevel = 1;
+      config_params.numNestingLevels = 1;
+      config_params.targetNestingLevel = 1;
+      CUPTI_CALL(cuptiProfilerSetConfig(&config_params));
+      CUpti_Profiler_EnableProfiling_Params enable_params = {
+          CUpti_Profiler_EnableProfiling_Params_STRUCT_SIZE};
+      enable_params.ctx = ctx;
+      CUPTI_CALL(cuptiProfilerEnableProfiling(&enable_params));
+      return 0;
+    }
+
+    /*! \brief The number of kernels profiled so far in the session. */
+    size_t NumRanges() {
+      CUDA_CALL(cudaDeviceSynchronize());
+      CUpti_Profiler_FlushCounterData_Params flush_params = {
+          CUpti_Profiler_FlushCounterData_Params_STRUCT_SIZE};
+      flush_params.ctx = ctx;
+      CUPTI_CALL(cuptiProfilerFlushCounterData(&flush_params));
+      if (flush_params.numRangesDropped > 0) {
+        LOG(WARNING) << "CUPTI dropped the metrics of " << flush_params.numRangesDropped
+                     << " kernels, profile fewer kernels at once.";
+      }
+      NVPW_CounterData_GetNumRanges_Params num_ranges_params = {
+          NVPW_CounterData_GetNumRanges_Params_STRUCT_SIZE};
+      num_ranges_params.pCounterDataImage = counter_data_image.data();
+      NVPW_CALL(NVPW_CounterData_GetNumRanges(&num_ranges_params));
+      return num_ranges_params.numRanges;
+    }
+
+    /*! \brief Evaluate the metrics of a kernel profiled in the session. */
+    void Evaluate(size_t range, const std::vector<const char*>& metric_names, double* values) {
+      NVPW_MetricsContext_SetCounterData_Params counter_data_params = {
+          NVPW_MetricsContext_SetCounterData_Params_STRUCT_SIZE};
+      counter_data_params.pMetricsContext = metrics_context;
+      counter_data_params.pCounterDataImage = counter_data_image.data();
+      counter_data_params.isolated = true;
+      counter_data_params.rangeIndex = range;
+      NVPW_CALL(NVPW_MetricsContext_SetCounterData(&counter_data_params));
+      NVPW_MetricsContext_EvaluateToGpuValues_Params evaluate_params = {
+          NVPW_MetricsContext_EvaluateToGpuValues_Params_STRUCT_SIZE};
+      evaluate_params.pMetricsContext = metrics_context;
+      evaluate_params.numMetrics = metric_names.size();
+      evaluate_params.ppMetricNames = metric_names.data();
+      evaluate_params.pMetricValues = values;
+      NVPW_CALL(NVPW_MetricsContext_EvaluateToGpuValues(&evaluate_params));
+    }
+
+    /*! \brief End the profiling session. */
+    void End() {
+      CUpti_Profiler_DisableProfiling_Params disable_params = {
+          CUpti_Profiler_DisableProfiling_Params_STRUCT_SIZE};
+      disable_params.ctx = ctx;
+      CUPTI_CALL(cuptiProfilerDisableProfiling(&disable_params));
+      CUpti_Profiler_UnsetConfig_Params unset_params = {
+          CUpti_Profiler_UnsetConfig_Params_STRUCT_SIZE};
+      unset_params.ctx = ctx;
+      CUPTI_CALL(cuptiProfilerUnsetConfig(&unset_params));
+      CUpti_Profiler_EndSession_Params end_params = {CUpti_Profiler_EndSession_Params_STRUCT_SIZE};
+      end_params.ctx = ctx;
+      CUPTI_CALL(cuptiProfilerEndSession(&end_params));
+      depth = 0;
+    }
+
+    ~Session() {
+      if (metrics_context != nullptr) {
+        NVPW_MetricsContext_Destroy_Params destroy_params = {
+            NVPW_MetricsContext_Destroy_Params_STRUCT_SIZE};
+        destroy_params.pMetricsContext = metrics_context;
+        NVPW_MetricsContext_Destroy(&destroy_params);
+      }
+    }
+  };
+
+  /*! \brief Whether the metric is summed over the kernels of a call rather than averaged. */
+  static bool IsSum(const std::string& name) {
+    return name.size() >= 4 && name.compare(name.size() - 4, 4, ".sum") == 0;
+  }
+
+  /*! \brief The maximum number of kernels profiled in a session. */
+  static constexpr int kMaxNumRanges = 4096;
+
+  /*! \brief Device-specific profiling sessions, keyed by the device id. */
+  std::unordered_map<int, Session> sessions;
+  /*! \brief The collected metrics. The first `num_reported_metrics` are reported. */
+  std::vector<std::string> metric_names;
+  /*! \brief The metric names as passed to CUPTI. */
+  std::vector<const char*> metric_name_ptrs;
+  /*! \brief The number of metrics requested by the user. */
+  size_t num_reported_metrics;
+
+  static constexpr const char* _type_key = "runtime.profiling.CUPTIMetricCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTIMetricCollectorNode, MetricCollectorNode);
+};
+
+/*! \brief Wrapper for `CUPTIMetricCollectorNode`. */
+class CUPTIMetricCollector : public MetricCollector {
+ public:
+  explicit CUPTIMetricCollector(Array<String> metrics) {
+    data_ = make_object<CUPTIMetricCollectorNode>(metrics);
+  }
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CUPTIMetricCollector, MetricCollector,
+                                        CUPTIMetricCollectorNode);
+};
+
+MetricCollector CreateCUPTIMetricCollector(Array<String> metrics) {
+  return CUPTIMetricCollector(metrics);
+}
+
+TVM_REGISTER_OBJECT_TYPE(CUPTIRangeNode);
+TVM_REGISTER_OBJECT_TYPE(CUPTIMetricCollectorNode);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.CUPTIMetricCollector")
+    .set_body_typed([](Array<String> metrics) { return CUPTIMetricCollector(metrics); });
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
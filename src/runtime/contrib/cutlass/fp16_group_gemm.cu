@@ -37,8 +37,8 @@ struct KernelTraits<cutlass::half_t> {
 namespace tvm {
 namespace runtime {
 
-template <typename ElementA, typename ElementB, typename ElementC>
-void tvm_cutlass_group_gemm_sm90(NDArray x, NDArray weight, NDArray indptr, NDArray workspace,
+template <typename ElementA, typename ElementB, typename ElementC, GroupRowsFormat kRowsFormat>
+void tvm_cutlass_group_gemm_sm90(NDArray x, NDArray weight, NDArray group_rows, NDArray workspace,
                                  NDArray out) {
   // Workspace is used for storing device-side group gemm arguments and cutlass internal workspace.
   // Recommened size is 4MB.
@@ -46,7 +46,9 @@ void tvm_cutlass_group_gemm_sm90(NDArray x, NDArray weight, NDArray indptr, NDAr
   ICHECK(func != nullptr);
   CHECK_EQ(x->ndim, 2);
   CHECK_EQ(weight->ndim, 3);
-  CHECK_EQ(indptr->ndim, 1);
+  CHECK_EQ(group_rows->ndim, 1);
+  CHECK(group_rows->dtype.code == kDLInt && group_rows->dtype.bits == 64)
+      << "The group rows must be int64";
   CHECK_EQ(workspace->ndim, 1);
   CHECK_EQ(out->ndim, 2);
   int num_groups = weight->shape[0];
@@ -56,13 +58,19 @@ void tvm_cutlass_group_gemm_sm90(NDArray x, NDArray weight, NDArray indptr, NDAr
   float beta = 0.0f;
   cudaStream_t stream = static_cast<cudaStream_t>((*func)().operator void*());
   cutlass_group_gemm(static_cast<ElementA*>(x->data), static_cast<ElementB*>(weight->data),
-                     static_cast<int64_t*>(indptr->data), static_cast<uint8_t*>(workspace->data),
-                     workspace->shape[0], n, k, num_groups, alpha, beta,
+                     static_cast<int64_t*>(group_rows->data), kRowsFormat,
+                     static_cast<uint8_t*>(workspace->data), workspace->shape[0], n, k, num_groups,
+                     alpha, beta,
                      static_cast<ElementC*>(out->data), stream);
 }
 
 TVM_REGISTER_GLOBAL("cutlass.group_gemm_fp16_sm90")
-    .set_body_typed(tvm_cutlass_group_gemm_sm90<cutlass::half_t, cutlass::half_t, cutlass::half_t>);
+    .set_body_typed(tvm_cutlass_group_gemm_sm90<cutlass::half_t, cutlass::half_t, cutlass::half_t,
+                                                GroupRowsFormat::kIndptr>);
+
+TVM_REGISTER_GLOBAL("cutlass.group_gemm_fp16_sm90_counts")
+    .set_body_typed(tvm_cutlass_group_gemm_sm90<cutlass::half_t, cutlass::half_t, cutlass::half_t,
+                                                GroupRowsFormat::kCounts>);
 
 }  // namespace runtime
 }  // namespace tvm
@@ -40,8 +40,8 @@ struct KernelTraits<cutlass::float_e5m2_t> : KernelTraits<cutlass::float_e4m3_t>
 namespace tvm {
 namespace runtime {
 
-template <typename ElementA, typename ElementB, typename ElementC>
-void tvm_cutlass_fp8_group_gemm(NDArray x, NDArray weight, NDArray indptr, NDArray workspace,
+template <typename ElementA, typename ElementB, typename ElementC, GroupRowsFormat kRowsFormat>
+void tvm_cutlass_fp8_group_gemm(NDArray x, NDArray weight, NDArray group_rows, NDArray workspace,
                                 NDArray alpha, NDArray out) {
   // Workspace is used for storing device-side group gemm arguments and cutlass internal workspace.
   // Recommened size is 4MB.
@@ -49,7 +49,9 @@ void tvm_cutlass_fp8_group_gemm(NDArray x, NDArray weight, NDArray indptr, NDArr
   ICHECK(func != nullptr);
   CHECK_EQ(x->ndim, 2);
   CHECK_EQ(weight->ndim, 3);
-  CHECK_EQ(indptr->ndim, 1);
+  CHECK_EQ(group_rows->ndim, 1);
+  CHECK(group_rows->dtype.code == kDLInt && group_rows->dtype.bits == 64)
+      << "The group rows must be int64";
   CHECK_EQ(workspace->ndim, 1);
   CHECK_EQ(out->ndim, 2);
   CHECK_EQ(alpha->dtype.code, kDLFloat);
@@ -62,22 +64,35 @@ void tvm_cutlass_fp8_group_gemm(NDArray x, NDArray weight, NDArray indptr, NDArr
   const float* beta = nullptr;
   cudaStream_t stream = static_cast<cudaStream_t>((*func)().operator void*());
   cutlass_group_gemm(static_cast<ElementA*>(x->data), static_cast<ElementB*>(weight->data),
-                     static_cast<int64_t*>(indptr->data), static_cast<uint8_t*>(workspace->data),
-                     workspace->shape[0], n, k, num_groups, static_cast<float*>(alpha->data), beta,
+                     static_cast<int64_t*>(group_rows->data), kRowsFormat,
+                     static_cast<uint8_t*>(workspace->data), workspace->shape[0], n, k, num_groups,
+                     static_cast<float*>(alpha->data), beta,
                      static_cast<ElementC*>(out->data), stream);
 }
 
 TVM_REGISTER_GLOBAL("cutlass.group_gemm_e5m2_e5m2_fp16")
-    .set_body_typed(
-        tvm_cutlass_fp8_group_gemm<cutlass::float_e5m2_t, cutlass::float_e5m2_t, cutlass::half_t>);
+    .set_body_typed(tvm_cutlass_fp8_group_gemm<cutlass::float_e5m2_t, cutlass::float_e5m2_t,
+                                               cutlass::half_t, GroupRowsFormat::kIndptr>);
+
+TVM_REGISTER_GLOBAL("cutlass.group_gemm_e5m2_e5m2_fp16_counts")
+    .set_body_typed(tvm_cutlass_fp8_group_gemm<cutlass::float_e5m2_t, cutlass::float_e5m2_t,
+                                               cutlass::half_t, GroupRowsFormat::kCounts>);
 
 TVM_REGISTER_GLOBAL("cutlass.group_gemm_e5m2_e4m3_fp16")
-    .set_body_typed(
-        tvm_cutlass_fp8_group_gemm<cutlass::float_e5m2_t, cutlass::float_e4m3_t, cutlass::half_t>);
+    .set_body_typed(tvm_cutlass_fp8_group_gemm<cutlass::float_e5m2_t, cutlass::float_e4m3_t,
+                                               cutlass::half_t, GroupRowsFormat::kIndptr>);
+
+TVM_REGISTER_GLOBAL("cutlass.group_gemm_e5m2_e4m3_fp16_counts")
+    .set_body_typed(tvm_cutlass_fp8_group_gemm<cutlass::float_e5m2_t, cutlass::float_e4m3_t,
+                                               cutlass::half_t, GroupRowsFormat::kCounts>);
 
 TVM_REGISTER_GLOBAL("cutlass.group_gemm_e4m3_e4m3_fp16")
-    .set_body_typed(
-        tvm_cutlass_fp8_group_gemm<cutlass::float_e4m3_t, cutlass::float_e4m3_t, cutlass::half_t>);
+    .set_body_typed(tvm_cutlass_fp8_group_gemm<cutlass::float_e4m3_t, cutlass::float_e4m3_t,
+                                               cutlass::half_t, GroupRowsFormat::kIndptr>);
+
+TVM_REGISTER_GLOBAL("cutlass.group_gemm_e4m3_e4m3_fp16_counts")
+    .set_body_typed(tvm_cutlass_fp8_group_gemm<cutlass::float_e4m3_t, cutlass::float_e4m3_t,
+                                               cutlass::half_t, GroupRowsFormat::kCounts>);
 
 }  // namespace runtime
 }  // namespace tvm
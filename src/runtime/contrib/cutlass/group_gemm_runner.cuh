@@ -57,6 +57,14 @@ inline size_t aligned(size_t value, size_t alignment = 16) {
 template <typename T>
 struct KernelTraits;
 
+/*! \brief How the device tensor describing the rows of each group is laid out. */
+enum class GroupRowsFormat : int {
+  /*! \brief The end row of each group, i.e. the inclusive prefix sum of the row counts. */
+  kIndptr = 0,
+  /*! \brief The row count of each group, e.g. the expert token counts computed by a MoE router. */
+  kCounts = 1,
+};
+
 template <typename ElementA, typename ElementB, typename ElementC,
           typename LayoutA = cutlass::layout::RowMajor,
           typename LayoutB = cutlass::layout::ColumnMajor,
@@ -154,23 +162,36 @@ __global__ void prepare_group_gemm_arguments(
     const ElementA** ptr_A, const ElementB** ptr_B, ElementC** ptr_D,
     typename ProblemShape::UnderlyingProblemShape* problem_sizes, StrideA* stride_A,
     StrideB* stride_B, StrideC* stride_D, const ElementA* x, const ElementB* weight, ElementC* out,
-    int64_t* indptr, int64_t n, int64_t k, int64_t num_groups) {
+    const int64_t* group_rows, GroupRowsFormat rows_format, int64_t n, int64_t k,
+    int64_t num_groups) {
   int group_id = threadIdx.x;
   if (group_id >= num_groups) return;
-  int prev_rows = group_id == 0 ? 0 : indptr[group_id - 1];
+  // The group sizes are only read on the device, so that they can be produced by a preceding
+  // kernel without synchronizing the stream
+  int64_t prev_rows = 0;
+  int64_t rows = 0;
+  if (rows_format == GroupRowsFormat::kCounts) {
+    for (int i = 0; i < group_id; ++i) {
+      prev_rows += group_rows[i];
+    }
+    rows = group_rows[group_id];
+  } else {
+    prev_rows = group_id == 0 ? 0 : group_rows[group_id - 1];
+    rows = group_rows[group_id] - prev_rows;
+  }
   ptr_A[group_id] = x + prev_rows * k;
   ptr_B[group_id] = weight + group_id * k * n;
   ptr_D[group_id] = out + prev_rows * n;
-  problem_sizes[group_id] = {static_cast<int>(indptr[group_id] - prev_rows), static_cast<int>(n),
-                             static_cast<int>(k)};
+  problem_sizes[group_id] = {static_cast<int>(rows), static_cast<int>(n), static_cast<int>(k)};
   stride_A[group_id] = cute::make_stride(k, Int<1>{}, int64_t{0});
   stride_B[group_id] = cute::make_stride(k, Int<1>{}, int64_t{0});
   stride_D[group_id] = cute::make_stride(n, Int<1>{}, int64_t{0});
 }
 
 template <typename ElementA, typename ElementB, typename ElementC>
-void cutlass_group_gemm(ElementA* x, ElementB* weight, int64_t* indptr, uint8_t* workspace,
-                        int64_t workspace_size, int64_t n, int64_t k, int64_t num_groups,
+void cutlass_group_gemm(ElementA* x, ElementB* weight, const int64_t* group_rows,
+                        GroupRowsFormat rows_format, uint8_t* workspace, int64_t workspace_size,
+                        int64_t n, int64_t k, int64_t num_groups,
                         std::variant<float, const float*> alpha,
                         std::variant<float, const float*> beta, ElementC* out,
                         cudaStream_t stream) {
@@ -179,6 +200,8 @@ void cutlass_group_gemm(ElementA* x, ElementB* weight, int64_t* indptr, uint8_t*
   using StrideB = typename Runner::StrideB;
   using StrideC = typename Runner::StrideC;
 
+  // The arguments of all the groups are prepared by a single thread block
+  CHECK_LE(num_groups, 1024) << "The number of groups must not exceed 1024";
   Runner runner;
   std::ptrdiff_t offset = 0;
   const ElementA** ptr_A = reinterpret_cast<const ElementA**>(workspace + offset);
@@ -196,9 +219,9 @@ void cutlass_group_gemm(ElementA* x, ElementB* weight, int64_t* indptr, uint8_t*
   offset += aligned(sizeof(StrideB) * num_groups);
   StrideC* stride_D = reinterpret_cast<StrideC*>(workspace + offset);
   offset += aligned(sizeof(StrideC) * num_groups);
-  prepare_group_gemm_arguments<<<1, num_groups, 0, stream>>>(ptr_A, ptr_B, ptr_D, problem_sizes,
-                                                             stride_A, stride_B, stride_D, x,
-                                                             weight, out, indptr, n, k, num_groups);
+  prepare_group_gemm_arguments<<<1, num_groups, 0, stream>>>(
+      ptr_A, ptr_B, ptr_D, problem_sizes, stride_A, stride_B, stride_D, x, weight, out, group_rows,
+      rows_format, n, k, num_groups);
   offset = aligned(offset, 256);
   runner.run_group_gemm(ptr_A, ptr_B, const_cast<const ElementC**>(ptr_D), ptr_D, problem_sizes,
                         nullptr, stride_A, stride_B, stride_D, stride_D, workspace + offset,
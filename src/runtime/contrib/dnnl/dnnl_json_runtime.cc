@@ -26,7 +26,10 @@
 #include <tvm/runtime/registry.h>
 
 #include <cstddef>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../../../runtime/regex.h"
@@ -75,27 +78,54 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   void Run(const TVMArgs& args) const {
     auto arg_data_provider = makeIODataProvider(args);
     auto mem_solver = tensor_registry_.MakeSolver(arg_data_provider);
-    // Execute primitives one by one
-    for (const auto& act : net_) {
-      auto prim = std::get<0>(act);
-      auto arg_reqs = std::get<1>(act);
-
-      // Find proper dnnl::memory buffers
-      std::unordered_map<int, dnnl::memory> mem_args;
-      for (const auto& kvp : arg_reqs) mem_args[kvp.first] = mem_solver(kvp.second);
-
-      // skip the reorder if src==dst to enable inplace operation
-      if (prim.get_kind() == dnnl::primitive::kind::reorder) {
-        const auto& mem_src = mem_args.at(DNNL_ARG_SRC);
-        const auto& mem_dst = mem_args.at(DNNL_ARG_DST);
-        if ((mem_src.get_desc() == mem_dst.get_desc()) &&
-            (mem_src.get_data_handle() == mem_dst.get_data_handle())) {
-          continue;
-        }
+    if (worker_streams_.empty()) {
+      // Execute primitives one by one
+      for (const auto& act : net_) {
+        Execute(act, mem_solver, stream_, nullptr);
+      }
+      return;
+    }
+    // Execute independent primitives concurrently, each worker with its own stream and scratchpad
+    std::vector<dnnl::memory> scratchpads;
+    for (size_t i = 0; i < worker_streams_.size(); ++i) {
+      scratchpads.emplace_back(tensor_registry_.ScratchpadDesc(), engine_);
+    }
+    scheduler_.Run(worker_streams_.size() + 1, [&](int worker_id, uint32_t task) {
+      dnnl::stream stream = worker_id == 0 ? stream_ : worker_streams_[worker_id - 1];
+      Execute(net_[task], mem_solver, stream,
+              worker_id == 0 ? nullptr : &scratchpads[worker_id - 1]);
+      // The primitives that depend on this one may run on other streams
+      stream.wait();
+    });
+  }
+
+  /* Execute an action, with the provided scratchpad instead of the shared one if not null. */
+  void Execute(const TensorRegistry::Action& act, const TensorRegistry::MemSolver& mem_solver,
+               const dnnl::stream& stream, const dnnl::memory* scratchpad) const {
+    auto prim = std::get<0>(act);
+    auto arg_reqs = std::get<1>(act);
+
+    // Find proper dnnl::memory buffers
+    std::unordered_map<int, dnnl::memory> mem_args;
+    for (const auto& kvp : arg_reqs) {
+      mem_args[kvp.first] = mem_solver(kvp.second);
+      if (scratchpad != nullptr && tensor_registry_.IsScratchpad(kvp.second)) {
+        mem_args[kvp.first] = dnnl::memory(mem_args[kvp.first].get_desc(), engine_,
+                                           scratchpad->get_data_handle());
       }
+    }
 
-      prim.execute(stream_, mem_args);
+    // skip the reorder if src==dst to enable inplace operation
+    if (prim.get_kind() == dnnl::primitive::kind::reorder) {
+      const auto& mem_src = mem_args.at(DNNL_ARG_SRC);
+      const auto& mem_dst = mem_args.at(DNNL_ARG_DST);
+      if ((mem_src.get_desc() == mem_dst.get_desc()) &&
+          (mem_src.get_data_handle() == mem_dst.get_data_handle())) {
+        return;
+      }
     }
+
+    prim.execute(stream, mem_args);
   }
 
   /* Override GetFunction to reimplement Run method */
@@ -297,6 +327,52 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         }
       }
     }
+    BuildScheduler();
+  }
+
+  /*!
+   * \brief Find the dependencies of the primitives from the buffers they read and write, to run
+   * the independent branches of the subgraph concurrently when TVM_JSON_RUNTIME_NUM_THREADS is set.
+   */
+  void BuildScheduler() {
+    int num_threads = DependencyScheduler::NumWorkerThreads();
+    if (num_threads <= 1 || net_.size() <= 1) return;
+    // The last writer and the readers since then of each buffer
+    std::unordered_map<int64_t, std::pair<int, std::vector<uint32_t>>> accesses;
+    std::vector<std::vector<uint32_t>> deps(net_.size());
+    bool has_parallel_branches = false;
+    for (uint32_t i = 0; i < net_.size(); ++i) {
+      std::set<uint32_t> task_deps;
+      for (const auto& kvp : std::get<1>(net_[i])) {
+        int64_t buffer = tensor_registry_.BufferId(kvp.second);
+        // The scratchpad is private to each worker
+        if (buffer < 0 || tensor_registry_.IsScratchpad(kvp.second)) continue;
+        auto it = accesses.emplace(buffer, std::make_pair(-1, std::vector<uint32_t>())).first;
+        int& last_writer = it->second.first;
+        std::vector<uint32_t>& readers = it->second.second;
+        if (last_writer >= 0) task_deps.insert(last_writer);
+        if (IsOutputArg(kvp.first)) {
+          task_deps.insert(readers.begin(), readers.end());
+          readers.clear();
+          last_writer = i;
+        } else {
+          readers.push_back(i);
+        }
+      }
+      task_deps.erase(i);
+      deps[i].assign(task_deps.begin(), task_deps.end());
+      has_parallel_branches |= i > 0 && !task_deps.count(i - 1);
+    }
+    if (!has_parallel_branches) return;
+    scheduler_ = DependencyScheduler(deps);
+    for (int i = 1; i < num_threads; ++i) {
+      worker_streams_.emplace_back(engine_);
+    }
+  }
+
+  /*! \brief Whether a primitive argument is written by the primitive. */
+  static bool IsOutputArg(int arg) {
+    return (arg >= DNNL_ARG_DST_0 && arg <= DNNL_ARG_DST_2) || arg == DNNL_ARG_WORKSPACE;
   }
 
   void Convolution(const size_t& nid) {
@@ -920,6 +996,10 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   dnnl::stream stream_;
   /* The network layers that are represented in dnnl primitives. */
   TensorRegistry::ActionQue net_;
+  /* The dependencies of the primitives in net_, to run independent ones concurrently. */
+  DependencyScheduler scheduler_;
+  /* The dnnl streams of the workers but the first one, empty to run the primitives in order. */
+  std::vector<dnnl::stream> worker_streams_;
   /* Storage for all memory objects */
   TensorRegistry tensor_registry_;
   /* Generator of new unique eid which doesn't match with existing data entry */
@@ -539,11 +539,22 @@ class TensorRegistry {
    * \return associated ArgId. Should be used as argument for MemSolver.
    */
   ArgId Register(const TensorRequisite& tr, ActionQue* action) {
-    // 1) Constant tensor. Direct reference
-    if (auto const_data = tr.GetConstData()) {
-      auto idx = const_mem_collection_.size();
-      const_mem_collection_.push_back(const_data);
-      return MakeArgReq(ArgReqFlag::CONST, static_cast<uint32_t>(idx));
+    // 1) Constant tensor. Direct reference. A constant transformed the same way for several
+    // primitives, e.g. weights reordered to the same blocked layout, is transformed only once and
+    // kept for the lifetime of the registry.
+    if (tr.IsConstant()) {
+      auto key = MakeConstKey(tr);
+      for (size_t idx = 0; idx < const_mem_keys_.size(); ++idx) {
+        if (const_mem_keys_[idx] == key) {
+          return MakeArgReq(ArgReqFlag::CONST, static_cast<uint32_t>(idx));
+        }
+      }
+      if (auto const_data = tr.GetConstData()) {
+        auto idx = const_mem_collection_.size();
+        const_mem_collection_.push_back(const_data);
+        const_mem_keys_.push_back(std::move(key));
+        return MakeArgReq(ArgReqFlag::CONST, static_cast<uint32_t>(idx));
+      }
     }
 
     // 2) EID mapped tensor. Direct reference
@@ -603,6 +614,36 @@ class TensorRegistry {
                          tmp_mem_collection_, tmp_mem_mapping_);
   }
 
+  /*!
+   * \brief Identify the memory buffer that an argument refers to, so that the order of the actions
+   * accessing a buffer can be kept when independent actions run concurrently.
+   * \param ar the argument
+   * \return -1 for constants, which are never written, and a unique non-negative id otherwise
+   */
+  int64_t BufferId(const ArgId& ar) const {
+    switch (ar.flag_) {
+      case CONST:
+        return -1;
+      case TMP_STORAGE: {
+        size_t idx = ar.idx_;
+        for (auto it = tmp_mem_mapping_.find(idx); it != tmp_mem_mapping_.end();
+             it = tmp_mem_mapping_.find(idx)) {
+          idx = it->second;
+        }
+        return static_cast<int64_t>(idx) * 2;
+      }
+      case EXT_EID:
+        return static_cast<int64_t>(ext_mem_collection_[ar.idx_].first) * 2 + 1;
+    }
+    return -1;
+  }
+
+  /*! \brief Whether an argument is the scratchpad, which is shared by all the primitives. */
+  bool IsScratchpad(const ArgId& ar) const { return ar.flag_ == TMP_STORAGE && BufferId(ar) == 0; }
+
+  /*! \brief The descriptor of the scratchpad, large enough for every primitive. */
+  const dnnl::memory::desc& ScratchpadDesc() const { return tmp_mem_collection_[0]; }
+
   void MarkInplace(const TensorRequisite& tr, const TensorRequisite& shared) {
     const auto tr_id = tr.eid();
     ICHECK(tr_id != TensorRequisite::kUndefinedTid);
@@ -711,9 +752,27 @@ class TensorRegistry {
 
   ArgId MakeArgReq(ArgReqFlag flag, uint32_t idx) { return {flag, idx}; }
 
+  /*! \brief The key of a constant TR: its source data and the transformations applied to it. */
+  using ConstKey = std::pair<void*, std::vector<std::pair<dnnl::memory::desc, bool>>>;
+
+  static ConstKey MakeConstKey(const TensorRequisite& tr) {
+    ConstKey key;
+    const TensorRequisite* cur = &tr;
+    while (cur->orig_) {
+      key.second.emplace_back(cur->t_desc_, cur->reinterpret_);
+      cur = cur->orig_.get();
+    }
+    key.first = cur->mem_.get_data_handle();
+    key.second.emplace_back(cur->t_desc_, false);
+    return key;
+  }
+
   /* Collection of const memory objects. */
   std::vector<dnnl::memory> const_mem_collection_;
 
+  /* The keys of the const memory objects, to share the transformed constants. */
+  std::vector<ConstKey> const_mem_keys_;
+
   /* Collection of intermediate memory descriptors. Zero position is reserved for scratchpads. */
   std::vector<dnnl::memory::desc> tmp_mem_collection_;
 
@@ -25,10 +25,18 @@
 #ifndef TVM_RUNTIME_CONTRIB_JSON_JSON_RUNTIME_H_
 #define TVM_RUNTIME_CONTRIB_JSON_JSON_RUNTIME_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -42,6 +50,123 @@ namespace tvm {
 namespace runtime {
 namespace json {
 
+/*!
+ * \brief A scheduler running the tasks of a dependency graph on the threads of the TVM thread
+ * pool, each task as soon as all the tasks it depends on are done. It is shared by the json
+ * runtimes to run the independent branches of a subgraph concurrently.
+ */
+class DependencyScheduler {
+ public:
+  DependencyScheduler() = default;
+
+  /*!
+   * \brief Construct the scheduler of a dependency graph.
+   * \param deps The tasks that each task depends on, which must all come before it.
+   */
+  explicit DependencyScheduler(const std::vector<std::vector<uint32_t>>& deps)
+      : users_(deps.size()), num_deps_(deps.size(), 0) {
+    for (size_t i = 0; i < deps.size(); ++i) {
+      for (uint32_t dep : deps[i]) {
+        ICHECK_LT(dep, i) << "The tasks must be in a topological order";
+        users_[dep].push_back(i);
+        ++num_deps_[i];
+      }
+    }
+  }
+
+  /*! \brief The number of tasks. */
+  size_t NumTasks() const { return num_deps_.size(); }
+
+  /*!
+   * \brief Run all the tasks.
+   * \param num_workers The number of threads to run the tasks on. With a single thread the tasks
+   * run in order on the calling thread.
+   * \param f The function running a task, called with the worker id and the task id.
+   * \note The first error thrown by a task is rethrown once the running tasks are done, and the
+   * tasks not started yet are skipped.
+   */
+  void Run(int num_workers, const std::function<void(int, uint32_t)>& f) const {
+    uint32_t num_tasks = NumTasks();
+    num_workers = std::min<int>(num_workers, num_tasks);
+    if (num_workers <= 1) {
+      for (uint32_t i = 0; i < num_tasks; ++i) {
+        f(0, i);
+      }
+      return;
+    }
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint32_t> ready;
+    std::vector<int> num_deps = num_deps_;
+    for (uint32_t i = 0; i < num_tasks; ++i) {
+      if (num_deps[i] == 0) ready.push_back(i);
+    }
+    // Tasks are taken from the back, so the first ones are the last in the list
+    std::reverse(ready.begin(), ready.end());
+    uint32_t num_finished = 0;
+    int num_running = 0;
+    std::exception_ptr error = nullptr;
+    // A worker only waits while another one is running a task, so that the tasks are all run even
+    // if the thread pool runs the workers one after another.
+    auto fworker = [&](int worker_id, int) {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        cv.wait(lock, [&] { return !ready.empty() || num_running == 0; });
+        if (ready.empty() || error != nullptr) break;
+        uint32_t task = ready.back();
+        ready.pop_back();
+        ++num_running;
+        lock.unlock();
+        std::exception_ptr task_error = nullptr;
+        try {
+          f(worker_id, task);
+        } catch (...) {
+          task_error = std::current_exception();
+        }
+        lock.lock();
+        --num_running;
+        ++num_finished;
+        if (task_error != nullptr && error == nullptr) {
+          error = task_error;
+          ready.clear();
+        }
+        if (error == nullptr) {
+          for (uint32_t user : users_[task]) {
+            if (--num_deps[user] == 0) ready.push_back(user);
+          }
+        }
+        cv.notify_all();
+      }
+    };
+    TVMBackendParallelLaunch(
+        detail::ParallelForWithThreadingBackendLambdaInvoker<decltype(fworker)>::
+            TVMParallelLambdaInvoke,
+        &fworker, num_workers);
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+    ICHECK_EQ(num_finished, num_tasks) << "The dependency graph has a cycle";
+  }
+
+  /*!
+   * \brief The number of threads that the independent nodes of the json runtimes run on, set by
+   * the environment variable TVM_JSON_RUNTIME_NUM_THREADS. It is 1 by default, which runs the
+   * nodes in order, and all the threads of the thread pool if not positive.
+   */
+  static int NumWorkerThreads() {
+    const char* env = std::getenv("TVM_JSON_RUNTIME_NUM_THREADS");
+    if (env == nullptr || *env == '\0') return 1;
+    int num_threads = std::atoi(env);
+    return num_threads > 0 ? num_threads : threading::MaxConcurrency();
+  }
+
+ private:
+  /*! \brief The tasks that depend on each task. */
+  std::vector<std::vector<uint32_t>> users_;
+  /*! \brief The number of tasks that each task depends on. */
+  std::vector<int> num_deps_;
+};
+
 /*!
  * \brief A json runtime that executes the serialized JSON format. This runtime
  * can be extended by user defined runtime for execution.
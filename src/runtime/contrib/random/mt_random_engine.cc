@@ -19,26 +19,33 @@
 
 /*!
  * \file random/mt_random_engine.cc
- * \brief mt19937 random engine
+ * \brief Counter-based random engine, filling tensors in parallel.
  */
 #include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
 #include <ctime>
-#include <random>
+#include <string>
 #include <thread>
 
 #include "../3rdparty/compiler-rt/builtin_fp16.h"
+#include "philox.h"
 
 namespace tvm {
 namespace contrib {
 
 /*!
  * \brief An interface for generating [tensors of] random numbers.
+ *
+ * The engine is a Philox4x32-10 generator keyed by the seed. Every call draws a fresh
+ * range of counters, and element i of the call uses word i % 4 of counter
+ * (offset + i / 4). The output is thus independent of the thread pool configuration
+ * and of the device the tensor resides on.
  */
 class RandomEngine {
  public:
@@ -56,8 +63,8 @@ class RandomEngine {
    * \brief Seeds the underlying RNG, if possible.
    */
   inline void Seed(unsigned seed) {
-    rnd_engine_.seed(seed);
     this->rseed_ = static_cast<unsigned>(seed);
+    this->offset_ = 0;
   }
 
   /*!
@@ -68,7 +75,42 @@ class RandomEngine {
   /*!
    * \return a random integer sampled from the RNG.
    */
-  inline unsigned GetRandInt() { return rnd_engine_(); }
+  inline unsigned GetRandInt() {
+    uint32_t words[philox::kWordsPerCounter];
+    philox::Generate(rseed_, offset_++, words);
+    return words[0];
+  }
+
+  /*!
+   * \brief Generate size random words in parallel and hand them to ftransform.
+   *
+   * The range is split into fixed-size grains, so the work division does not depend
+   * on the number of threads.
+   *
+   * \param size The number of words to generate.
+   * \param ftransform Called as ftransform(words, begin, n) for the words of
+   *    elements [begin, begin + n), with n at most philox::kBatchWords.
+   */
+  template <typename FTransform>
+  void ParallelFill(int64_t size, FTransform ftransform) {
+    const uint64_t seed = rseed_;
+    const uint64_t offset = offset_;
+    int64_t num_grains = (size + kFillGrain - 1) / kFillGrain;
+    auto fgrain = [&](int64_t grain) {
+      int64_t end = std::min((grain + 1) * kFillGrain, size);
+      uint32_t words[philox::kBatchWords];
+      for (int64_t i = grain * kFillGrain; i < end; i += philox::kBatchWords) {
+        philox::GenerateBatch(seed, offset + i / philox::kWordsPerCounter, words);
+        ftransform(words, i, std::min<int64_t>(philox::kBatchWords, end - i));
+      }
+    };
+    if (num_grains <= 1) {
+      if (num_grains == 1) fgrain(0);
+    } else {
+      runtime::parallel_for_with_threading_backend(fgrain, 0, num_grains);
+    }
+    offset_ += NumCounters(size);
+  }
 
   /*!
    * \brief Fills a tensor with values drawn from Unif(low, high)
@@ -78,19 +120,20 @@ class RandomEngine {
     ICHECK(data->strides == nullptr);
 
     DLDataType dtype = data->dtype;
-    int64_t size = 1;
-    for (int i = 0; i < data->ndim; ++i) {
-      size *= data->shape[i];
-    }
+    int64_t size = GetSize(data);
 
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::uniform_real_distribution<float> uniform_dist(low, high);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return uniform_dist(rnd_engine_); });
-    } else {
-      LOG(FATAL) << "Do not support random.uniform on this device yet";
+      float scale = high - low;
+      float* ptr = static_cast<float*>(data->data);
+      ParallelFill(size, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+          ptr[begin + i] = low + scale * philox::ToUniform(words[i]);
+        }
+      });
+    } else if (!DispatchDevice("Uniform", data, low, high)) {
+      SampleOnHost(data, [&](DLTensor* local) { SampleUniform(local, low, high); });
     }
   }
 
@@ -102,19 +145,25 @@ class RandomEngine {
     ICHECK(data->strides == nullptr);
 
     DLDataType dtype = data->dtype;
-    int64_t size = 1;
-    for (int i = 0; i < data->ndim; ++i) {
-      size *= data->shape[i];
-    }
+    int64_t size = GetSize(data);
 
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::normal_distribution<float> normal_dist(loc, scale);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return normal_dist(rnd_engine_); });
-    } else {
-      LOG(FATAL) << "Do not support random.normal on this device yet";
+      float* ptr = static_cast<float*>(data->data);
+      // Box-Muller consumes pairs of words, so round the word count up to be even.
+      ParallelFill(size + (size & 1), [&](const uint32_t* words, int64_t begin, int64_t n) {
+        float z[philox::kBatchWords];
+        for (int64_t i = 0; i < n; i += 2) {
+          philox::ToNormal(words[i], words[i + 1], &z[i], &z[i + 1]);
+        }
+        n = std::min(n, size - begin);
+        for (int64_t i = 0; i < n; ++i) {
+          ptr[begin + i] = loc + scale * z[i];
+        }
+      });
+    } else if (!DispatchDevice("Normal", data, loc, scale)) {
+      SampleOnHost(data, [&](DLTensor* local) { SampleNormal(local, loc, scale); });
     }
   }
 
@@ -122,113 +171,106 @@ class RandomEngine {
     if (data->device.device_type == kDLCPU) {
       FillData(data);
     } else {
-      runtime::NDArray local = runtime::NDArray::Empty(
-          std::vector<int64_t>{data->shape, data->shape + data->ndim}, data->dtype, {kDLCPU, 0});
-      DLTensor* tensor = const_cast<DLTensor*>(local.operator->());
-      FillData(tensor);
-      runtime::NDArray::CopyFromTo(tensor, data);
+      SampleOnHost(data, [&](DLTensor* local) { FillData(local); });
     }
   }
 
-  void RandomFillForMeasure(DLTensor* data) {
-    if (data->device.device_type == kDLCPU) {
-      FillDataForMeasure(data);
-    } else {
-      runtime::NDArray local = runtime::NDArray::Empty(
-          std::vector<int64_t>{data->shape, data->shape + data->ndim}, data->dtype, {kDLCPU, 0});
-      DLTensor* tensor = const_cast<DLTensor*>(local.operator->());
-      FillDataForMeasure(tensor);
-      runtime::NDArray::CopyFromTo(tensor, data);
+  void RandomFillForMeasure(DLTensor* data) { RandomFill(data); }
+
+ private:
+  /*! \brief The number of elements generated by one parallel task. */
+  static constexpr int64_t kFillGrain = 1 << 16;
+  static_assert(kFillGrain % philox::kBatchWords == 0,
+                "grains must start at the beginning of a counter batch");
+
+  static int64_t GetSize(const DLTensor* data) {
+    int64_t size = 1;
+    for (int i = 0; i < data->ndim; ++i) {
+      size *= data->shape[i];
     }
+    return size;
   }
 
- private:
-  void FillDataImpl(void* data, int64_t st, int64_t ed, DLDataType dtype) {
+  static uint64_t NumCounters(int64_t size) {
+    return static_cast<uint64_t>((size + philox::kWordsPerCounter - 1) /
+                                 philox::kWordsPerCounter);
+  }
+
+  /*!
+   * \brief Run the device kernel of a distribution if one is registered.
+   * \return Whether the tensor has been filled.
+   */
+  bool DispatchDevice(const std::string& dist, DLTensor* data, float a, float b) {
+    if (data->device.device_type != kDLCUDA) return false;
+    const runtime::PackedFunc* fkernel =
+        runtime::Registry::Get("runtime.contrib.random.Philox" + dist + "CUDA");
+    if (fkernel == nullptr) return false;
+    int64_t size = GetSize(data);
+    // Keep the counter layout of the host path, including the padding of normal samples.
+    int64_t num_words = dist == "Normal" ? size + (size & 1) : size;
+    (*fkernel)(data, static_cast<int64_t>(rseed_), static_cast<int64_t>(offset_),
+               static_cast<double>(a), static_cast<double>(b));
+    offset_ += NumCounters(num_words);
+    return true;
+  }
+
+  /*! \brief Run fsample on a host tensor and copy the result to data. */
+  template <typename FSample>
+  void SampleOnHost(DLTensor* data, FSample fsample) {
+    runtime::NDArray local = runtime::NDArray::Empty(
+        std::vector<int64_t>{data->shape, data->shape + data->ndim}, data->dtype, {kDLCPU, 0});
+    DLTensor* tensor = const_cast<DLTensor*>(local.operator->());
+    fsample(tensor);
+    runtime::NDArray::CopyFromTo(tensor, data);
+  }
+
+  void FillData(DLTensor* tensor) {
+    DLDataType dtype = tensor->dtype;
+    void* data = tensor->data;
+    int64_t size = GetSize(tensor);
     // Make the value be 1.0 - 10.0, not (0.0 - 1.0) so that we could satisfy
     // quantized dtype (uint8 / int8) data non-empty requirement
-    std::uniform_real_distribution<> dist(1.0, 10.0);
+    auto fvalue = [](uint32_t word) { return 1.0f + 9.0f * philox::ToUniform(word); };
     // Use float representation could make us work well on float / int type too.
     if (dtype.bits == 1) {
-      std::generate_n(static_cast<bool*>(data) + st, ed - st, [&]() { return dist(rnd_engine_); });
+      ParallelFill(size, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        std::transform(words, words + n, static_cast<bool*>(data) + begin, fvalue);
+      });
     } else if (dtype.bits == 4) {
       // For uint4/int4 we pack two values into a single byte.
       // Thus, to ensure both values are non-zero, we use a distribution of 17 - 30.
-      std::uniform_real_distribution<> packed_dist(17.0, 30.0);
-      std::generate_n(reinterpret_cast<uint8_t*>(data) + st, ed - st,
-                      [&]() { return packed_dist(rnd_engine_); });
+      int64_t num_bytes = (size * dtype.lanes + 1) / 2;
+      ParallelFill(num_bytes, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        std::transform(words, words + n, static_cast<uint8_t*>(data) + begin,
+                       [](uint32_t word) { return 17.0f + 13.0f * philox::ToUniform(word); });
+      });
     } else if (dtype.bits == 8) {
-      std::generate_n(static_cast<uint8_t*>(data) + st, ed - st,
-                      [&]() { return dist(rnd_engine_); });
+      ParallelFill(size, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        std::transform(words, words + n, static_cast<uint8_t*>(data) + begin, fvalue);
+      });
     } else if (dtype.bits == 16) {
-      std::generate_n(static_cast<uint16_t*>(data) + st, ed - st, [&]() {
-        return __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(
-            static_cast<float>(dist(rnd_engine_)));
+      ParallelFill(size, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        std::transform(words, words + n, static_cast<uint16_t*>(data) + begin, [&](uint32_t word) {
+          return __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(fvalue(word));
+        });
       });
     } else if (dtype.bits == 32) {
-      std::generate_n(static_cast<float*>(data) + st, ed - st, [&]() { return dist(rnd_engine_); });
+      ParallelFill(size, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        std::transform(words, words + n, static_cast<float*>(data) + begin, fvalue);
+      });
     } else if (dtype.bits == 64) {
-      std::generate_n(static_cast<double*>(data) + st, ed - st,
-                      [&]() { return dist(rnd_engine_); });
-    } else {
-      LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
-    }
-  }
-
-  void FillData(DLTensor* tensor) {
-    int64_t size = 1;
-    for (int i = 0; i < tensor->ndim; ++i) {
-      size *= tensor->shape[i];
-    }
-    DLDataType dtype = tensor->dtype;
-    if (dtype.bits == 1 || dtype.bits == 4 || dtype.bits == 8 || dtype.bits == 16 ||
-        dtype.bits == 32 || dtype.bits == 64) {
-      FillDataImpl(tensor->data, 0, size, dtype);
-    } else {
-      LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
-    }
-  }
-
-  void FillDataForMeasure(DLTensor* tensor) {
-    struct ParallelTask {
-      static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
-        ParallelTask* task = static_cast<ParallelTask*>(cdata);
-        task->Run(task_id, penv->num_task);
-        return 0;
-      }
-
-      void Run(int i, int num_tasks) {
-        int64_t chunk_size = size / num_tasks;
-        int64_t st = i * chunk_size;
-        int64_t ed = std::min(st + chunk_size, size);
-        self->FillDataImpl(data, st, ed, dtype);
-      }
-
-      RandomEngine* self;
-      void* data;
-      int64_t size;
-      DLDataType dtype;
-    };
-
-    ParallelTask task;
-    task.self = this;
-    task.data = tensor->data;
-    DLDataType dtype = task.dtype = tensor->dtype;
-    int64_t& size = task.size = 1;
-    for (int i = 0; i < tensor->ndim; ++i) {
-      size *= tensor->shape[i];
-    }
-    if (dtype.bits == 1 || dtype.bits == 4 || dtype.bits == 8 || dtype.bits == 16 ||
-        dtype.bits == 32 || dtype.bits == 64) {
-      int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
-      ICHECK_EQ(res, 0) << "RandomFillForMeasure: TVMBackendParallelLaunch failed";
+      ParallelFill(size, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        std::transform(words, words + n, static_cast<double*>(data) + begin, fvalue);
+      });
     } else {
       LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
     }
   }
 
  private:
-  std::mt19937 rnd_engine_;
   unsigned rseed_;
+  /*! \brief The first counter value not consumed yet. */
+  uint64_t offset_;
 };
 
 }  // namespace contrib
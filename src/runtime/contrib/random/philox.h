@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file random/philox.h
+ * \brief The Philox4x32-10 counter-based generator, shared by the host and CUDA code.
+ *
+ * Each 64-bit counter value is mapped to four independent 32-bit words, so element i
+ * of a tensor is a pure function of (seed, offset + i / 4). Any partition of a tensor
+ * across threads, blocks or devices therefore produces the same values.
+ *
+ * Reference: Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+#define TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+
+#include <cmath>
+#include <cstdint>
+
+#ifdef __CUDACC__
+#define TVM_PHILOX_FUNC __host__ __device__ __forceinline__
+#else
+#define TVM_PHILOX_FUNC inline
+#endif
+
+namespace tvm {
+namespace contrib {
+namespace philox {
+
+constexpr uint32_t kMul0 = 0xD2511F53;
+constexpr uint32_t kMul1 = 0xCD9E8D57;
+constexpr uint32_t kWeyl0 = 0x9E3779B9;
+constexpr uint32_t kWeyl1 = 0xBB67AE85;
+constexpr int kRounds = 10;
+/*! \brief The number of 32-bit words produced per counter value. */
+constexpr int kWordsPerCounter = 4;
+/*! \brief The number of counters processed together by GenerateBatch. */
+constexpr int kBatchCounters = 8;
+/*! \brief The number of 32-bit words produced by GenerateBatch. */
+constexpr int kBatchWords = kWordsPerCounter * kBatchCounters;
+
+/*!
+ * \brief Compute the four random words of a counter value.
+ * \param seed The key of the generator.
+ * \param counter The counter value.
+ * \param out The four output words.
+ */
+TVM_PHILOX_FUNC void Generate(uint64_t seed, uint64_t counter, uint32_t out[kWordsPerCounter]) {
+  uint32_t c0 = static_cast<uint32_t>(counter);
+  uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+  uint32_t c2 = 0, c3 = 0;
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+  for (int r = 0; r < kRounds; ++r) {
+    uint64_t p0 = static_cast<uint64_t>(kMul0) * c0;
+    uint64_t p1 = static_cast<uint64_t>(kMul1) * c2;
+    uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c1 = static_cast<uint32_t>(p1);
+    c3 = static_cast<uint32_t>(p0);
+    c0 = n0;
+    c2 = n2;
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+/*!
+ * \brief Compute the random words of kBatchCounters consecutive counter values.
+ *
+ * The rounds are applied lane-wise on structure-of-arrays state, which the compiler
+ * turns into SIMD multiplies. The output is identical to calling Generate on each
+ * counter and concatenating the results.
+ *
+ * \param seed The key of the generator.
+ * \param counter The first counter value.
+ * \param out The kBatchWords output words, in counter order.
+ */
+inline void GenerateBatch(uint64_t seed, uint64_t counter, uint32_t out[kBatchWords]) {
+  uint32_t c0[kBatchCounters], c1[kBatchCounters], c2[kBatchCounters], c3[kBatchCounters];
+  for (int l = 0; l < kBatchCounters; ++l) {
+    c0[l] = static_cast<uint32_t>(counter + l);
+    c1[l] = static_cast<uint32_t>((counter + l) >> 32);
+    c2[l] = 0;
+    c3[l] = 0;
+  }
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+  for (int r = 0; r < kRounds; ++r) {
+    for (int l = 0; l < kBatchCounters; ++l) {
+      uint64_t p0 = static_cast<uint64_t>(kMul0) * c0[l];
+      uint64_t p1 = static_cast<uint64_t>(kMul1) * c2[l];
+      uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+      uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+      c1[l] = static_cast<uint32_t>(p1);
+      c3[l] = static_cast<uint32_t>(p0);
+      c0[l] = n0;
+      c2[l] = n2;
+    }
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+  for (int l = 0; l < kBatchCounters; ++l) {
+    out[l * kWordsPerCounter + 0] = c0[l];
+    out[l * kWordsPerCounter + 1] = c1[l];
+    out[l * kWordsPerCounter + 2] = c2[l];
+    out[l * kWordsPerCounter + 3] = c3[l];
+  }
+}
+
+/*! \brief Map a random word to a float in [0, 1). */
+TVM_PHILOX_FUNC float ToUniform(uint32_t x) {
+  return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+/*! \brief Map a random word to a float in (0, 1]. */
+TVM_PHILOX_FUNC float ToUniformPositive(uint32_t x) {
+  return static_cast<float>((x >> 8) + 1) * (1.0f / 16777216.0f);
+}
+
+/*!
+ * \brief Map two random words to two independent standard normal samples (Box-Muller).
+ */
+TVM_PHILOX_FUNC void ToNormal(uint32_t a, uint32_t b, float* z0, float* z1) {
+  float radius = sqrtf(-2.0f * logf(ToUniformPositive(a)));
+  float theta = 6.28318530717958647692f * ToUniform(b);
+  *z0 = radius * cosf(theta);
+  *z1 = radius * sinf(theta);
+}
+
+}  // namespace philox
+}  // namespace contrib
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file random/philox_kernels.cu
+ * \brief CUDA kernels of the Philox random engine.
+ *
+ * Each thread expands one counter into four elements, following the same counter
+ * layout as the host engine in mt_random_engine.cc.
+ */
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include "../../cuda/cuda_common.h"
+#include "philox.h"
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+
+namespace {
+
+constexpr int kPhiloxThreads = 256;
+
+__global__ void PhiloxUniformKernel(float* out, int64_t size, uint64_t seed, uint64_t offset,
+                                    float low, float scale) {
+  int64_t counter = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  int64_t begin = counter * philox::kWordsPerCounter;
+  if (begin >= size) return;
+  uint32_t words[philox::kWordsPerCounter];
+  philox::Generate(seed, offset + counter, words);
+#pragma unroll
+  for (int i = 0; i < philox::kWordsPerCounter; ++i) {
+    if (begin + i < size) out[begin + i] = low + scale * philox::ToUniform(words[i]);
+  }
+}
+
+__global__ void PhiloxNormalKernel(float* out, int64_t size, uint64_t seed, uint64_t offset,
+                                   float loc, float scale) {
+  int64_t counter = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  int64_t begin = counter * philox::kWordsPerCounter;
+  if (begin >= size) return;
+  uint32_t words[philox::kWordsPerCounter];
+  float z[philox::kWordsPerCounter];
+  philox::Generate(seed, offset + counter, words);
+  philox::ToNormal(words[0], words[1], &z[0], &z[1]);
+  philox::ToNormal(words[2], words[3], &z[2], &z[3]);
+#pragma unroll
+  for (int i = 0; i < philox::kWordsPerCounter; ++i) {
+    if (begin + i < size) out[begin + i] = loc + scale * z[i];
+  }
+}
+
+template <typename Kernel>
+void LaunchPhilox(Kernel kernel, DLTensor* out, int64_t seed, int64_t offset, double a,
+                  double b) {
+  ICHECK(out->device.device_type == kDLCUDA);
+  ICHECK(out->dtype.code == kDLFloat && out->dtype.bits == 32 && out->dtype.lanes == 1);
+  ICHECK(out->strides == nullptr);
+  int64_t size = 1;
+  for (int i = 0; i < out->ndim; ++i) {
+    size *= out->shape[i];
+  }
+  if (size == 0) return;
+  int64_t num_counters = (size + philox::kWordsPerCounter - 1) / philox::kWordsPerCounter;
+  int64_t num_blocks = (num_counters + kPhiloxThreads - 1) / kPhiloxThreads;
+  float* data = reinterpret_cast<float*>(static_cast<char*>(out->data) + out->byte_offset);
+  CUDA_CALL(cudaSetDevice(out->device.device_id));
+  kernel<<<num_blocks, kPhiloxThreads, 0, GetCUDAStream()>>>(
+      data, size, static_cast<uint64_t>(seed), static_cast<uint64_t>(offset),
+      static_cast<float>(a), static_cast<float>(b));
+  CUDA_CALL(cudaGetLastError());
+}
+
+}  // namespace
+
+TVM_REGISTER_GLOBAL("runtime.contrib.random.PhiloxUniformCUDA")
+    .set_body_typed([](DLTensor* out, int64_t seed, int64_t offset, double low, double high) {
+      LaunchPhilox(PhiloxUniformKernel, out, seed, offset, low, high - low);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.contrib.random.PhiloxNormalCUDA")
+    .set_body_typed([](DLTensor* out, int64_t seed, int64_t offset, double loc, double scale) {
+      LaunchPhilox(PhiloxNormalKernel, out, seed, offset, loc, scale);
+    });
+
+}  // namespace contrib
+}  // namespace tvm
@@ -69,6 +69,10 @@ RandomThreadLocalEntry* RandomThreadLocalEntry::ThreadLocal() {
   return RandomThreadLocalStore::Get();
 }
 
+TVM_REGISTER_GLOBAL("tvm.contrib.random.seed").set_body_typed([](int64_t seed) {
+  RandomThreadLocalEntry::ThreadLocal()->random_engine.Seed(static_cast<unsigned>(seed));
+});
+
 TVM_REGISTER_GLOBAL("tvm.contrib.random.randint").set_body([](TVMArgs args, TVMRetValue* ret) {
   RandomThreadLocalEntry* entry = RandomThreadLocalEntry::ThreadLocal();
   int64_t low = args[0];
@@ -92,9 +96,11 @@ TVM_REGISTER_GLOBAL("tvm.contrib.random.randint").set_body([](TVMArgs args, TVMR
 
     if (out->device.device_type == kDLCPU) {
       // file the data with random byte
-      std::generate_n(static_cast<DType*>(out->data), size, [&]() {
-        unsigned rint = entry->random_engine.GetRandInt();
-        return low + rint % (high - low);
+      DType* ptr = static_cast<DType*>(out->data);
+      entry->random_engine.ParallelFill(size, [&](const uint32_t* words, int64_t begin, int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+          ptr[begin + i] = static_cast<DType>(low + words[i] % (high - low));
+        }
       });
     } else {
       LOG(FATAL) << "Do not support random.randint on this device yet";
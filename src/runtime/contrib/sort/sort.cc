@@ -23,8 +23,10 @@
 
 #include <dlpack/dlpack.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "../../../../3rdparty/compiler-rt/builtin_fp16.h"
@@ -70,6 +72,132 @@ struct float16 {
   inline bool operator>=(const float16& rhs) const { return to_float() >= rhs.to_float(); }
 };
 
+/*! \brief The minimum number of elements to sort before the slices are split across threads. */
+constexpr int64_t kMinParallelSortElements = 1 << 14;
+/*! \brief The minimum slice length from which radix sort beats std::stable_sort. */
+constexpr size_t kMinRadixSortLength = 256;
+/*! \brief Top-k keeps a heap of the k elements when the slice is longer than k times this. */
+constexpr int64_t kTopKHeapRatio = 16;
+
+/*!
+ * \brief Call fslice(i, j) for every slice along the sort axis, where i indexes the
+ *  axes before the sort axis and j the axes after it. The slices are processed in
+ *  parallel with the TVM threading backend when there is enough work.
+ */
+template <typename FSlice>
+void ForEachSlice(int64_t axis_mul_before, int64_t axis_mul_after, int64_t axis_len,
+                  FSlice fslice) {
+  int64_t num_slices = axis_mul_before * axis_mul_after;
+  auto fbody = [&fslice, axis_mul_after](int64_t s) {
+    fslice(s / axis_mul_after, s % axis_mul_after);
+  };
+  if (num_slices > 1 && num_slices * axis_len >= kMinParallelSortElements) {
+    parallel_for_with_threading_backend(fbody, 0, num_slices);
+  } else {
+    for (int64_t s = 0; s < num_slices; ++s) {
+      fbody(s);
+    }
+  }
+}
+
+/*!
+ * \brief Map of sort keys to unsigned integers of the same order, for radix sort.
+ *  Only defined for the types with kSupported set.
+ */
+template <typename DType>
+struct RadixKey {
+  static constexpr bool kSupported = false;
+};
+
+template <>
+struct RadixKey<int32_t> {
+  static constexpr bool kSupported = true;
+  using Type = uint32_t;
+  static Type Get(int32_t v) { return static_cast<uint32_t>(v) ^ 0x80000000U; }
+};
+
+template <>
+struct RadixKey<int64_t> {
+  static constexpr bool kSupported = true;
+  using Type = uint64_t;
+  static Type Get(int64_t v) { return static_cast<uint64_t>(v) ^ 0x8000000000000000ULL; }
+};
+
+template <>
+struct RadixKey<float> {
+  static constexpr bool kSupported = true;
+  using Type = uint32_t;
+  static Type Get(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    // -0.0 and 0.0 compare equal, they must keep their relative order.
+    if (bits == 0x80000000U) bits = 0;
+    return (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+  }
+};
+
+template <>
+struct RadixKey<double> {
+  static constexpr bool kSupported = true;
+  using Type = uint64_t;
+  static Type Get(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    if (bits == 0x8000000000000000ULL) bits = 0;
+    return (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+  }
+};
+
+/*!
+ * \brief Stable LSD radix sort of the (index, value) pairs by value, 8 bits per pass.
+ *  Produces the same order as std::stable_sort with CompareAscend/CompareDescend.
+ */
+template <typename DataType>
+void RadixSort(std::vector<std::pair<int64_t, DataType>>* sorter, bool is_ascend) {
+  using Key = typename RadixKey<DataType>::Type;
+  size_t n = sorter->size();
+  std::vector<Key> keys(n), keys_tmp(n);
+  std::vector<std::pair<int64_t, DataType>> sorter_tmp(n);
+  for (size_t i = 0; i < n; ++i) {
+    Key key = RadixKey<DataType>::Get((*sorter)[i].second);
+    keys[i] = is_ascend ? key : ~key;
+  }
+  for (size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+    size_t offset[257] = {0};
+    for (size_t i = 0; i < n; ++i) {
+      ++offset[((keys[i] >> shift) & 0xFF) + 1];
+    }
+    // Skip the pass if all the keys share this digit.
+    if (offset[((keys[0] >> shift) & 0xFF) + 1] == n) continue;
+    for (int d = 0; d < 256; ++d) {
+      offset[d + 1] += offset[d];
+    }
+    for (size_t i = 0; i < n; ++i) {
+      size_t pos = offset[(keys[i] >> shift) & 0xFF]++;
+      keys_tmp[pos] = keys[i];
+      sorter_tmp[pos] = (*sorter)[i];
+    }
+    keys.swap(keys_tmp);
+    sorter->swap(sorter_tmp);
+  }
+}
+
+/*! \brief Stable sort of the (index, value) pairs of one slice by value. */
+template <typename DataType>
+void SortSlice(std::vector<std::pair<int64_t, DataType>>* sorter, bool is_ascend) {
+  if constexpr (RadixKey<DataType>::kSupported) {
+    if (sorter->size() >= kMinRadixSortLength) {
+      RadixSort(sorter, is_ascend);
+      return;
+    }
+  }
+  if (is_ascend) {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareAscend<DataType>);
+  } else {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareDescend<DataType>);
+  }
+}
+
 // Argsort implemented C library sort for nms.
 // Return indices of sorted tensor.
 // By default, the last axis will be used to sort.
@@ -87,7 +215,6 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
   auto dtype = input->dtype;
   auto data_ptr = static_cast<float*>(input->data);
   auto sort_num_ptr = static_cast<int32_t*>(sort_num->data);
-  std::vector<std::pair<int32_t, float>> sorter;
   int64_t axis_mul_before = 1;
   int64_t axis_mul_after = 1;
 
@@ -114,42 +241,33 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
     }
   }
 
-  for (int64_t i = 0; i < axis_mul_before; ++i) {
-    for (int64_t j = 0; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < current_sort_num; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
-      }
-      if (is_ascend) {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<__fp16>);
-        } else {
-#endif
-          std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<float>);
+  ForEachSlice(axis_mul_before, axis_mul_after, input->shape[axis], [&](int64_t i, int64_t j) {
+    std::vector<std::pair<int64_t, float>> sorter;
+    int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
+    int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
+    sorter.reserve(std::max(current_sort_num, 0));
+    for (int64_t k = 0; k < current_sort_num; ++k) {
+      int64_t full_idx = base_idx + k * axis_mul_after;
+      sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
+    }
 #if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
+    if (dtype.bits == 16) {
+      if (is_ascend) {
+        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<__fp16>);
       } else {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
-        } else {
-#endif
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
-      }
-      for (int32_t k = 0; k < input->shape[axis]; ++k) {
-        *(static_cast<int32_t*>(output->data) + base_idx + k * axis_mul_after) =
-            k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
+        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
       }
+    } else {
+      SortSlice(&sorter, is_ascend);
     }
-  }
+#else
+    SortSlice(&sorter, is_ascend);
+#endif
+    for (int32_t k = 0; k < input->shape[axis]; ++k) {
+      *(static_cast<int32_t*>(output->data) + base_idx + k * axis_mul_after) =
+          k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
+    }
+  });
 });
 
 template <typename DataType, typename OutType>
@@ -158,10 +276,9 @@ void sort_impl(
     std::function<void(OutType*, size_t, const std::pair<int64_t, DataType>&)> epilogue) {
   auto data_ptr = static_cast<DataType*>(input->data);
   auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
 
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
       axis_mul_before *= input->shape[i];
@@ -170,24 +287,19 @@ void sort_impl(
     }
   }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
-      }
+  ForEachSlice(axis_mul_before, axis_mul_after, input->shape[axis], [&](int64_t i, int64_t j) {
+    std::vector<std::pair<int64_t, DataType>> sorter;
+    sorter.reserve(input->shape[axis]);
+    int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
+    for (int64_t k = 0; k < input->shape[axis]; ++k) {
+      int64_t full_idx = base_idx + k * axis_mul_after;
+      sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
     }
-  }
+    SortSlice(&sorter, is_ascend);
+    for (int64_t k = 0; k < input->shape[axis]; ++k) {
+      epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
+    }
+  });
 }
 
 template <typename DataType, typename OutType>
@@ -355,14 +467,8 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
   IndicesType* indices_ptr =
       (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
 
-  // Maintain a min/max containing the top-k elements
-  std::vector<std::pair<int64_t, DataType>> running_heap;
-
-  // Need +1 when inserting new element before maintaining heap invariant
-  running_heap.reserve(k + 1);
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
       axis_mul_before *= input->shape[i];
@@ -370,66 +476,70 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
       axis_mul_after *= input->shape[i];
     }
   }
+  int64_t axis_len = input->shape[axis];
   if (k < 1) {
-    k = input->shape[axis];
+    k = axis_len;
   }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      running_heap.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
-      int64_t dst_base_idx = i * k * axis_mul_after + j;
-
-      // Start by creating min/max heap with fixed-k elements
-      int cur_axis_index = 0;
-      for (; cur_axis_index < k && cur_axis_index < input->shape[axis]; cur_axis_index++) {
+  ForEachSlice(axis_mul_before, axis_mul_after, axis_len, [&](int64_t i, int64_t j) {
+    // The comparisons break ties by index so that every strategy selects
+    // the same elements in the same order.
+    auto fcompare = [is_ascend](const std::pair<int64_t, DataType>& lhs,
+                                const std::pair<int64_t, DataType>& rhs) {
+      return is_ascend ? CompareAscend<DataType, true>(lhs, rhs)
+                       : CompareDescend<DataType, true>(lhs, rhs);
+    };
+    int64_t src_base_idx = i * axis_len * axis_mul_after + j;
+    int64_t dst_base_idx = i * k * axis_mul_after + j;
+    std::vector<std::pair<int64_t, DataType>> candidates;
+
+    if (static_cast<int64_t>(k) * kTopKHeapRatio < axis_len) {
+      // Few elements are kept: maintain a min/max heap containing the top-k
+      // elements, most elements are rejected by one comparison with its root.
+      // Need +1 when inserting new element before maintaining heap invariant
+      candidates.reserve(k + 1);
+      int64_t cur_axis_index = 0;
+      for (; cur_axis_index < k; cur_axis_index++) {
         int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
-        running_heap.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
+        candidates.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
       }
-      if (!is_ascend) {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-      } else {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-      }
-
-      // Iterate through all elements, adding to heap along the way
-      for (; cur_axis_index < input->shape[axis]; cur_axis_index++) {
+      std::make_heap(candidates.begin(), candidates.end(), fcompare);
+      for (; cur_axis_index < axis_len; cur_axis_index++) {
         int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
         std::pair<int64_t, DataType> cur_val = {cur_axis_index, data_ptr[full_idx]};
-
-        // Eq. to cur_val.second > running_heap.second
-        if (!is_ascend && CompareDescend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          running_heap.pop_back();
-        } else if (is_ascend && CompareAscend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          running_heap.pop_back();
+        if (fcompare(cur_val, candidates[0])) {
+          candidates.push_back(cur_val);
+          std::push_heap(candidates.begin(), candidates.end(), fcompare);
+          std::pop_heap(candidates.begin(), candidates.end(), fcompare);
+          candidates.pop_back();
         }
       }
-
-      // finally sort heap and deliver results
-      if (is_ascend) {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-      } else {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
+    } else {
+      // Many elements are kept: partition around the k-th element in linear time.
+      candidates.reserve(axis_len);
+      for (int64_t cur_axis_index = 0; cur_axis_index < axis_len; cur_axis_index++) {
+        int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
+        candidates.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
+      }
+      if (k < axis_len) {
+        std::nth_element(candidates.begin(), candidates.begin() + k, candidates.end(), fcompare);
+        candidates.resize(k);
       }
+    }
 
-      for (uint32_t kk = 0; kk < running_heap.size(); ++kk) {
-        if (indices_ptr != nullptr) {
-          indices_ptr[dst_base_idx + kk * axis_mul_after] =
-              static_cast<IndicesType>(running_heap[kk].first);
-        }
-        if (values_ptr != nullptr) {
-          values_ptr[dst_base_idx + kk * axis_mul_after] =
-              static_cast<DataType>(running_heap[kk].second);
-        }
+    // finally sort the selected elements and deliver results
+    std::sort(candidates.begin(), candidates.end(), fcompare);
+    for (size_t kk = 0; kk < candidates.size(); ++kk) {
+      if (indices_ptr != nullptr) {
+        indices_ptr[dst_base_idx + kk * axis_mul_after] =
+            static_cast<IndicesType>(candidates[kk].first);
+      }
+      if (values_ptr != nullptr) {
+        values_ptr[dst_base_idx + kk * axis_mul_after] =
+            static_cast<DataType>(candidates[kk].second);
       }
     }
-  }
+  });
 }
 
 // Argsort implemented C library sort.
@@ -77,6 +77,16 @@ nvinfer1::DataType DLDataType2NVDataType(DLDataType data_type) {
   return (data_type.bits == 16) ? nvinfer1::DataType::kHALF : nvinfer1::DataType::kFLOAT;
 }
 
+/*! \brief Whether a shape is between the min and max shapes of an optimization profile. */
+static bool IsShapeInProfile(const std::vector<int64_t>& shape,
+                             const std::array<std::vector<int64_t>, 3>& profile) {
+  if (shape.size() != profile[0].size()) return false;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] < profile[0][i] || shape[i] > profile[2][i]) return false;
+  }
+  return true;
+}
+
 void TensorRTBuilder::AddInput(int nid, uint32_t entry_id, const JSONGraphNode& node) {
   auto node_name = node.GetOpName();
   auto shapes = node.GetOpShape();
@@ -92,6 +102,15 @@ void TensorRTBuilder::AddInput(int nid, uint32_t entry_id, const JSONGraphNode&
     }
     nvinfer1::Dims dims = VectorToTrtDims(shape);
     auto input_tensor = network_->addInput(name.c_str(), DLDataType2NVDataType(dtypes[i]), dims);
+    // The optimization profile of an input of symbolic shape, set by the relax codegen.
+    if (!use_implicit_batch_ && node.HasAttr("profile_min")) {
+      std::array<std::vector<int64_t>, 3>& profile = input_profiles_[name];
+      const char* keys[] = {"profile_min", "profile_opt", "profile_max"};
+      for (int k = 0; k < 3; ++k) {
+        profile[k] = ParseProfileShape(node.GetAttr<std::vector<std::string>>(keys[k])[i]);
+        ICHECK_EQ(profile[k].size(), shape.size()) << "Invalid shape profile of " << name;
+      }
+    }
     node_output_map_[nid].push_back(TensorRTOpInput(input_tensor));
     network_input_names_.push_back(name);
     entry_id_map_[name] = entry_id + i;
@@ -190,6 +209,17 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
       const uint32_t entry_id = entry_id_map_[name];
       std::vector<int64_t> shape(data_entry_[entry_id]->shape,
                                  data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
+      auto it = input_profiles_.find(name);
+      if (it != input_profiles_.end() && IsShapeInProfile(shape, it->second)) {
+        // A single engine serves every shape between the min and max of the profile.
+        profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN,
+                               VectorToTrtDims(it->second[0]));
+        profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT,
+                               VectorToTrtDims(it->second[1]));
+        profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX,
+                               VectorToTrtDims(it->second[2]));
+        continue;
+      }
       auto dims = VectorToTrtDims(shape);
 
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT, dims);
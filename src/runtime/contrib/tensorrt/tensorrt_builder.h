@@ -27,6 +27,7 @@
 
 #include <tvm/runtime/ndarray.h>
 
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -144,6 +145,9 @@ class TensorRTBuilder {
   /*! \brief Map TensorRT binding name to index in data_entry_. */
   std::unordered_map<std::string, uint32_t> entry_id_map_;
 
+  /*! \brief Map TensorRT input name to the min, opt and max shapes of its profile. */
+  std::unordered_map<std::string, std::array<std::vector<int64_t>, 3>> input_profiles_;
+
   /*! \brief Max workspace size in bytes for TRT. */
   size_t max_workspace_size_;
 
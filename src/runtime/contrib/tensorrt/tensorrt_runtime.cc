@@ -26,10 +26,18 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../../file_utils.h"
@@ -37,6 +45,8 @@
 #include "../json/json_runtime.h"
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+#include <cuda_runtime_api.h>
+
 #include "NvInfer.h"
 #include "tensorrt_builder.h"
 #include "tensorrt_calibrator.h"
@@ -112,8 +122,9 @@ class TensorRTRuntime : public JSONRuntimeBase {
     ICHECK_EQ(consts.size(), const_idx_.size())
         << "The number of input constants must match the number of required.";
     LoadGlobalAttributes();
+    LoadShapeProfiles();
     SetupConstants(consts);
-    GetCachedEnginesFromDisk();
+    GetCachedEnginesFromDisk(consts);
   }
 
   void LoadGlobalAttributes() {
@@ -140,6 +151,50 @@ class TensorRTRuntime : public JSONRuntimeBase {
   }
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+  /*! \brief In explicit batch mode, if every input of symbolic shape has an optimization profile
+   * set by the codegen, a single engine is built for the whole range of shapes of the profiles.
+   */
+  void LoadShapeProfiles() {
+    use_shape_profiles_ = false;
+    profile_ranges_.clear();
+    if (use_implicit_batch_ || dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false)) return;
+    for (uint32_t nid : input_nodes_) {
+      const auto& node = nodes_[nid];
+      if (node.GetOpType() != "input") continue;
+      const auto& shapes = node.GetOpShape();
+      bool is_dynamic = false;
+      for (const auto& shape : shapes) {
+        is_dynamic |= std::any_of(shape.begin(), shape.end(), [](int64_t dim) { return dim < 0; });
+      }
+      if (!is_dynamic) continue;
+      if (!node.HasAttr("profile_min") || !node.HasAttr("profile_max")) {
+        profile_ranges_.clear();
+        return;
+      }
+      const auto& min_shapes = node.GetAttr<std::vector<std::string>>("profile_min");
+      const auto& max_shapes = node.GetAttr<std::vector<std::string>>("profile_max");
+      for (size_t j = 0; j < shapes.size(); ++j) {
+        profile_ranges_[EntryID(nid, j)] = {ParseProfileShape(min_shapes[j]),
+                                            ParseProfileShape(max_shapes[j])};
+      }
+    }
+    use_shape_profiles_ = !profile_ranges_.empty();
+  }
+
+  /*! \brief Whether the runtime input shapes are in the ranges of the optimization profiles. */
+  bool InputShapesInProfiles() const {
+    for (const auto& it : profile_ranges_) {
+      const DLTensor* tensor = data_entry_[it.first];
+      const std::vector<int64_t>& min_shape = it.second.first;
+      const std::vector<int64_t>& max_shape = it.second.second;
+      if (static_cast<size_t>(tensor->ndim) != min_shape.size()) return false;
+      for (int i = 0; i < tensor->ndim; ++i) {
+        if (tensor->shape[i] < min_shape[i] || tensor->shape[i] > max_shape[i]) return false;
+      }
+    }
+    return true;
+  }
+
   /*! \brief Destroy engines and contexts. */
   void DestroyEngines() {
     for (auto& it : trt_engine_cache_) {
@@ -156,6 +211,9 @@ class TensorRTRuntime : public JSONRuntimeBase {
   ~TensorRTRuntime() override {
     VLOG(1) << "Destroying TensorRT runtime";
     DestroyEngines();
+    if (trt_runtime_ != nullptr) {
+      trt_runtime_->destroy();
+    }
     VLOG(1) << "Destroyed TensorRT runtime";
   }
 
@@ -280,6 +338,21 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * already built, do nothing.
    */
   TensorRTEngineAndContext& GetOrBuildEngine() {
+    if (use_shape_profiles_) {
+      if (InputShapesInProfiles()) {
+        auto key = std::make_pair(symbol_name_, kShapeProfileEngine);
+        if (!trt_engine_cache_.count(key) && !LoadEngineFromDisk(kShapeProfileEngine)) {
+          DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_
+                     << " with the shape profiles of its inputs";
+          BuildEngineFromJson(kShapeProfileEngine);
+          CacheEngineToDisk(kShapeProfileEngine);
+        }
+        return trt_engine_cache_.at(key);
+      }
+      LOG(WARNING) << "The input shapes of TensorRT subgraph " << symbol_name_
+                   << " are out of the ranges of their shape profiles, building an engine for "
+                   << "the shapes instead";
+    }
     int batch_size = GetBatchSize();
     int compatible_engine_batch_size = -1;
     bool find_engine_flag = FindCompatibleEngine(batch_size, &compatible_engine_batch_size);
@@ -297,6 +370,11 @@ class TensorRTRuntime : public JSONRuntimeBase {
       DestroyEngines();
       max_batch_size_ = batch_size;
     }
+    // The engines built before for this batch size are loaded, unless an int8 engine is being
+    // calibrated.
+    if (calibrator_ == nullptr && LoadEngineFromDisk(batch_size)) {
+      return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
+    }
     DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_
                << " with batch size " << batch_size;
 
@@ -317,7 +395,10 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
     VLOG(1) << "Finished building TensorRT engine for subgraph " << symbol_name_
             << " with batch size " << batch_size;
-    CacheEngineToDisk();
+    // The engines that only collect the int8 calibration data are not kept.
+    if (calibrator_ == nullptr) {
+      CacheEngineToDisk(batch_size);
+    }
     return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
   }
 
@@ -356,40 +437,77 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for
    * already built TRT engines and load into trt_engine_cache_ so they don't
-   * have to be built at first inference.
+   * have to be built at first inference. The engine of the batch size of the
+   * graph is loaded here, the engines of other batch sizes when they are first
+   * needed.
    */
-  bool GetCachedEnginesFromDisk() {
-    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
-    if (cache_dir.empty()) return false;
-    std::string key = GetSubgraphKey();
-    std::string path = cache_dir + "/" + key + ".plan";
-    // Check if engine is in the cache.
-    std::ifstream infile(path, std::ios::binary);
-    if (!infile.good()) return false;
-    LOG(INFO) << "Loading cached TensorRT engine from " << path;
-    infile.close();
-    std::string serialized_engine;
-    LoadBinaryFromFile(path, &serialized_engine);
-    // Deserialize engine
-    nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger_);
+  bool GetCachedEnginesFromDisk(const Array<NDArray>& consts) {
+    engine_cache_dir_ = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
+    if (engine_cache_dir_.empty()) return false;
+    engine_cache_key_ = GetSubgraphKey(consts);
+    if (use_shape_profiles_) {
+      return LoadEngineFromDisk(kShapeProfileEngine);
+    }
+    for (uint32_t nid : input_nodes_) {
+      if (nodes_[nid].GetOpType() == "input") {
+        const std::vector<int64_t>& shape = nodes_[nid].GetOpShape()[0];
+        int batch_size = shape.empty() ? 1 : shape[0];
+        return batch_size > 0 && LoadEngineFromDisk(batch_size);
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Load the engine of a batch size from TVM_TENSORRT_CACHE_DIR, if it was built before. */
+  bool LoadEngineFromDisk(int batch_size) {
+    if (engine_cache_dir_.empty()) return false;
+    std::string path = GetEngineCachePath(batch_size);
+    // Load metadata, which is written after the engine
+    std::ifstream meta_file(path + ".meta", std::ios::binary);
+    if (!meta_file) return false;
+    std::string serialized_meta((std::istreambuf_iterator<char>(meta_file)),
+                                std::istreambuf_iterator<char>());
     TensorRTEngineAndContext engine_and_context;
-    engine_and_context.engine =
-        runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
+    std::string key;
+    int meta_batch_size = -1;
+    try {
+      std::istringstream is(serialized_meta);
+      dmlc::JSONReader reader(&is);
+      dmlc::JSONObjectReadHelper helper;
+      helper.DeclareField("key", &key);
+      helper.DeclareField("inputs", &engine_and_context.inputs);
+      helper.DeclareField("outputs", &engine_and_context.outputs);
+      helper.DeclareField("batch_size", &meta_batch_size);
+      helper.ReadAllFields(&reader);
+    } catch (const std::exception&) {
+      LOG(WARNING) << "Ignoring the corrupted TensorRT engine cache file " << path << ".meta";
+      return false;
+    }
+    // Guard against hash collisions
+    if (key != engine_cache_key_ || meta_batch_size != batch_size) return false;
+    std::ifstream plan_file(path + ".plan", std::ios::binary);
+    if (!plan_file) return false;
+    std::string serialized_engine((std::istreambuf_iterator<char>(plan_file)),
+                                  std::istreambuf_iterator<char>());
+    if (serialized_engine.empty()) return false;
+    LOG(INFO) << "Loading cached TensorRT engine from " << path << ".plan";
+    // Deserialize engine
+    if (trt_runtime_ == nullptr) {
+      trt_runtime_ = nvinfer1::createInferRuntime(logger_);
+    }
+    engine_and_context.engine = trt_runtime_->deserializeCudaEngine(
+        &serialized_engine[0], serialized_engine.size(), nullptr);
+    if (engine_and_context.engine == nullptr) {
+      LOG(WARNING) << "Cannot deserialize the cached TensorRT engine " << path << ".plan";
+      return false;
+    }
     engine_and_context.context = engine_and_context.engine->createExecutionContext();
-    // Load metadata
-    std::string meta_path = cache_dir + "/" + key + ".meta";
-    std::string serialized_meta;
-    LoadBinaryFromFile(meta_path, &serialized_meta);
-    std::istringstream is(serialized_meta);
-    dmlc::JSONReader reader(&is);
-    dmlc::JSONObjectReadHelper helper;
-    int batch_size;
-    helper.DeclareField("inputs", &engine_and_context.inputs);
-    helper.DeclareField("outputs", &engine_and_context.outputs);
-    helper.DeclareField("batch_size", &batch_size);
-    helper.ReadAllFields(&reader);
     trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
-    max_batch_size_ = batch_size;
+    if (!multi_engine_mode_ && batch_size != kShapeProfileEngine) {
+      max_batch_size_ = batch_size;
+    }
+    // An int8 engine in the cache is calibrated already
+    num_calibration_batches_remaining_ = 0;
     LOG(INFO) << "finished loading engine and context ... ";
     return true;
   }
@@ -397,38 +515,95 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine to that
    * directory so it can be loaded later.
    */
-  void CacheEngineToDisk() {
-    int batch_size = GetBatchSize();
-    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
-    if (cache_dir.empty()) return;
-    std::string key = GetSubgraphKey();
-    std::string path = cache_dir + "/" + key + ".plan";
-    DLOG(INFO) << "Caching TensorRT engine to " << path;
+  void CacheEngineToDisk(int batch_size) {
+    if (engine_cache_dir_.empty()) return;
+    const TensorRTEngineAndContext& engine_and_context =
+        trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
+    std::string path = GetEngineCachePath(batch_size);
+    DLOG(INFO) << "Caching TensorRT engine to " << path << ".plan";
     // Serialize engine to disk
-    nvinfer1::IHostMemory* serialized_engine =
-        trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].engine->serialize();
-    SaveBinaryToFile(path, std::string(static_cast<const char*>(serialized_engine->data()),
-                                       serialized_engine->size()));
+    nvinfer1::IHostMemory* serialized_engine = engine_and_context.engine->serialize();
+    bool saved = SaveFileAtomically(
+        path + ".plan", std::string(static_cast<const char*>(serialized_engine->data()),
+                                    serialized_engine->size()));
     serialized_engine->destroy();
+    if (!saved) return;
     // Serialize metadata
     std::ostringstream os;
     dmlc::JSONWriter writer(&os);
     writer.BeginObject();
-    writer.WriteObjectKeyValue("inputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].inputs);
-    writer.WriteObjectKeyValue("outputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].outputs);
+    writer.WriteObjectKeyValue("key", engine_cache_key_);
+    writer.WriteObjectKeyValue("inputs", engine_and_context.inputs);
+    writer.WriteObjectKeyValue("outputs", engine_and_context.outputs);
     writer.WriteObjectKeyValue("batch_size", batch_size);
     writer.EndObject();
-    std::string meta_path = cache_dir + "/" + key + ".meta";
-    SaveBinaryToFile(meta_path, os.str());
+    SaveFileAtomically(path + ".meta", os.str());
   }
 
-  std::string GetSubgraphKey() {
-    // Using this key will only allow a single model per TVM_TENSORRT_CACHE_DIR directory. We could
-    // instead use a hash of graph_json and all weights to allow many models in the same directory,
-    // but the cost of computing the hash is high.
-    return symbol_name_ + (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32");
+  /*!
+   * \brief Write a file through a temporary one, so that the processes sharing the cache directory
+   * never read a partial file. A failure only disables the cache.
+   */
+  static bool SaveFileAtomically(const std::string& path, const std::string& data) {
+    std::ostringstream tmp_path;
+    tmp_path << path << ".tmp" << std::random_device()();
+    {
+      std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+      fs.write(data.data(), data.size());
+      if (!fs) {
+        LOG(WARNING) << "Cannot write the TensorRT engine cache file " << tmp_path.str();
+        std::remove(tmp_path.str().c_str());
+        return false;
+      }
+    }
+    if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+      LOG(WARNING) << "Cannot write the TensorRT engine cache file " << path;
+      std::remove(tmp_path.str().c_str());
+      return false;
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Describe everything that the engines of the subgraph depend on but the batch size, so
+   * that many models and GPUs can share a TVM_TENSORRT_CACHE_DIR directory. The constants are
+   * hashed as they are embedded in the engines, which is only paid for when the cache is enabled.
+   */
+  std::string GetSubgraphKey(const Array<NDArray>& consts) {
+    const bool use_int8 = dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
+    const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_;
+    int device_id = 0;
+    cudaDeviceProp prop;
+    ICHECK_EQ(cudaGetDevice(&device_id), cudaSuccess);
+    ICHECK_EQ(cudaGetDeviceProperties(&prop, device_id), cudaSuccess);
+    uint64_t consts_hash = 0;
+    for (const NDArray& data : consts) {
+      NDArray cpu_data = data->device.device_type == kDLCPU ? data : data.CopyTo({kDLCPU, 0});
+      uint64_t hash = String::StableHashBytes(static_cast<const char*>(cpu_data->data),
+                                              GetDataSize(*cpu_data.operator->()));
+      consts_hash ^= hash + 0x9e3779b9 + (consts_hash << 6) + (consts_hash >> 2);
+    }
+    std::ostringstream os;
+    os << "symbol=" << symbol_name_ << ";tensorrt=" << getInferLibVersion() << ";gpu=" << prop.name
+       << ";sm=" << prop.major << prop.minor
+       << ";precision=" << (use_int8 ? "int8" : (use_fp16 ? "fp16" : "fp32"))
+       << ";implicit_batch=" << use_implicit_batch_ << ";workspace=" << max_workspace_size_
+       << std::hex << ";graph=" << String::StableHashBytes(graph_json_.data(), graph_json_.size())
+       << ";consts=" << consts_hash;
+    return os.str();
+  }
+
+  /*! \brief The path of the cached engine of a batch size, without extension. */
+  std::string GetEngineCachePath(int batch_size) const {
+    std::ostringstream os;
+    os << engine_cache_dir_ << "/" << symbol_name_ << "_" << std::hex
+       << String::StableHashBytes(engine_cache_key_.data(), engine_cache_key_.size()) << std::dec;
+    if (batch_size == kShapeProfileEngine) {
+      os << "_profile";
+    } else {
+      os << "_b" << batch_size;
+    }
+    return os.str();
   }
 
   /*! \brief Retreive a GPU buffer for input or output or allocate if needed. */
@@ -436,14 +611,20 @@ class TensorRTRuntime : public JSONRuntimeBase {
     std::vector<int64_t> shape(data_entry_[entry_id]->shape,
                                data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
     if (device_buffers_.count(binding_index)) {
-      // Buffer is already initialized.
-      if (shape[0] > device_buffers_[binding_index]->shape[0]) {
+      // Buffer is already initialized. With shape profiles any dimension can change, so the
+      // buffers are compared by their number of elements.
+      const NDArray& buffer = device_buffers_[binding_index];
+      std::vector<int64_t> buffer_shape(buffer->shape, buffer->shape + buffer->ndim);
+      auto f_num_elements = [](const std::vector<int64_t>& dims) {
+        return std::accumulate(dims.begin(), dims.end(), int64_t(1), std::multiplies<int64_t>());
+      };
+      if (f_num_elements(shape) > f_num_elements(buffer_shape)) {
         // Buffer is too small. Need to allocate bigger buffer.
         device_buffers_[binding_index] =
             runtime::NDArray::Empty(shape, data_entry_[entry_id]->dtype, {kDLCUDA, 0});
-      } else if (shape[0] < device_buffers_[binding_index]->shape[0]) {
+      } else if (shape != buffer_shape) {
         // Buffer is too large. Create view.
-        return device_buffers_[binding_index].CreateView(shape, data_entry_[entry_id]->dtype);
+        return buffer.CreateView(shape, data_entry_[entry_id]->dtype);
       }
     } else {
       // Buffer not initialized yet.
@@ -480,6 +661,19 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*! \brief TensorRT logger. */
   TensorRTLogger logger_;
 
+  /*! \brief The runtime deserializing the cached engines, created on first use. */
+  nvinfer1::IRuntime* trt_runtime_{nullptr};
+
+  /*! \brief The directory of the engine cache, empty if disabled. */
+  std::string engine_cache_dir_;
+
+  /*! \brief The description of the engines of the subgraph, see GetSubgraphKey. */
+  std::string engine_cache_key_;
+
+  /*! \brief The min and max shapes of the optimization profile of each dynamic input entry. */
+  std::unordered_map<uint32_t, std::pair<std::vector<int64_t>, std::vector<int64_t>>>
+      profile_ranges_;
+
 #else   // TVM_GRAPH_EXECUTOR_TENSORRT
   void Run() override {
     LOG(FATAL) << "TensorRT runtime is not enabled. "
@@ -491,9 +685,9 @@ class TensorRTRuntime : public JSONRuntimeBase {
                  << "Please build with USE_TENSORRT_RUNTIME.";
   }
 
-  bool GetCachedEnginesFromDisk() { return false; }
+  void LoadShapeProfiles() {}
 
-  void CacheEngineToDisk() {}
+  bool GetCachedEnginesFromDisk(const Array<NDArray>& consts) { return false; }
 #endif  // TVM_GRAPH_EXECUTOR_TENSORRT
 
   bool use_implicit_batch_;
@@ -516,6 +710,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   /*! \brief Use auto-conversion to fp16 */
   bool use_fp16_;
+
+  /*! \brief The key in trt_engine_cache_ of the engine built for the shape profiles. */
+  static constexpr int kShapeProfileEngine = -1;
+
+  /*! \brief Whether a single engine is built for the shape profiles of the inputs, which serves
+   * every input shape in their ranges. */
+  bool use_shape_profiles_ = false;
 };
 
 runtime::Module TensorRTRuntimeCreate(const String& symbol_name, const String& graph_json,
@@ -25,6 +25,7 @@
 #ifndef TVM_RUNTIME_CONTRIB_TENSORRT_TENSORRT_UTILS_H_
 #define TVM_RUNTIME_CONTRIB_TENSORRT_TENSORRT_UTILS_H_
 
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -67,6 +68,21 @@ inline std::vector<int> TrtDimsToVector(const nvinfer1::Dims& dims) {
   return std::vector<int>(dims.d, dims.d + dims.nbDims);
 }
 
+/*!
+ * \brief Helper function to parse a shape of an optimization profile, e.g. "1,3,224,224".
+ * \param str The comma-separated dimensions.
+ * \return Vector.
+ */
+inline std::vector<int64_t> ParseProfileShape(const std::string& str) {
+  std::vector<int64_t> shape;
+  std::istringstream is(str);
+  std::string dim;
+  while (std::getline(is, dim, ',')) {
+    shape.push_back(std::stoll(dim));
+  }
+  return shape;
+}
+
 }  // namespace contrib
 }  // namespace runtime
 }  // namespace tvm
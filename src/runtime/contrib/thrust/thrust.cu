@@ -25,38 +25,40 @@
 #include <thrust/device_ptr.h>
 #include <thrust/device_vector.h>
 #include <thrust/gather.h>
-#include <thrust/mr/device_memory_resource.h>
-#include <thrust/mr/disjoint_tls_pool.h>
 #include <thrust/mr/memory_resource.h>
 #include <thrust/scan.h>
 #include <thrust/sequence.h>
 #include <thrust/sort.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <vector>
 
+#if !defined(__HIPCC__)
+#include <cub/device/device_segmented_radix_sort.cuh>
+#endif
+
 #include "../../cuda/cuda_common.h"
 namespace tvm {
 namespace contrib {
 
 using namespace runtime;
 
-/*! \brief Memory resource backed by pre-allocated workspace. */
+/*!
+ * \brief Memory resource backed by pre-allocated workspace, or by the workspace pool of the device
+ * when no workspace is provided.
+ */
 class WorkspaceMemoryResource : public thrust::mr::memory_resource<void*> {
  public:
-  explicit WorkspaceMemoryResource(DLTensor* workspace) {
+  WorkspaceMemoryResource(DLTensor* workspace, Device device) : device(device) {
     if (workspace != nullptr) {
       this->workspace = workspace->data;
       CHECK(workspace->ndim == 1 && workspace->dtype.code == kDLUInt && workspace->dtype.bits == 8);
       this->workspace_size = workspace->shape[0];
-    } else {
-      // Fallback to thrust TLS caching allocator if workspace is not provided.
-      thrust_pool_ = &thrust::mr::tls_disjoint_pool(
-          thrust::mr::get_global_resource<thrust::device_memory_resource>(),
-          thrust::mr::get_global_resource<thrust::mr::new_delete_resource>());
     }
   }
 
@@ -69,161 +71,247 @@ class WorkspaceMemoryResource : public thrust::mr::memory_resource<void*> {
       workspace_size -= bytes;
       return result;
     }
-    return thrust_pool_->do_allocate(bytes, alignment).get();
+    // The workspace pool keeps the freed temporary storage for the later calls, so repeated sorts
+    // and scans do not pay a cudaMalloc each
+    void* result = DeviceAPI::Get(device)->AllocWorkspace(device, bytes);
+    CHECK(reinterpret_cast<uintptr_t>(result) % alignment == 0)
+        << "Failed to allocate " << bytes << " bytes with alignment " << alignment << " bytes.";
+    return result;
   }
 
   void do_deallocate(void* p, size_t bytes, size_t alignment) override {
     if (workspace != nullptr) {
       // No-op
     } else {
-      thrust_pool_->do_deallocate(thrust::device_memory_resource::pointer(p), bytes, alignment);
+      DeviceAPI::Get(device)->FreeWorkspace(device, p);
     }
   }
 
-  thrust::mr::disjoint_unsynchronized_pool_resource<thrust::device_memory_resource,
-                                                    thrust::mr::new_delete_resource>* thrust_pool_ =
-      nullptr;
-
+  Device device;
   void* workspace = nullptr;
   size_t workspace_size = 0;
 };
 
-auto get_thrust_exec_policy(WorkspaceMemoryResource* memory_resouce) {
-  return thrust::cuda::par_nosync(memory_resouce).on(GetCUDAStream());
+auto get_thrust_exec_policy(WorkspaceMemoryResource* memory_resouce, cudaStream_t stream) {
+  return thrust::cuda::par_nosync(memory_resouce).on(stream);
+}
+
+/*!
+ * \brief Get the optional workspace and stream arguments starting at `index`; a null workspace
+ * falls back to the workspace pool, and the stream defaults to the current CUDA stream.
+ */
+void GetWorkspaceAndStream(TVMArgs args, int index, DLTensor** workspace, cudaStream_t* stream) {
+  *workspace = nullptr;
+  *stream = GetCUDAStream();
+  if (args.num_args > index && args[index].type_code() != kTVMNullptr) {
+    *workspace = args[index];
+  }
+  if (args.num_args > index + 1 && args[index + 1].type_code() != kTVMNullptr) {
+    *stream = static_cast<cudaStream_t>(args[index + 1].operator void*());
+  }
 }
 
 // Performs sorting along axis -1 and returns both sorted values and indices.
 template <typename DataType, typename IndicesType>
 void thrust_sort(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, bool is_ascend,
-                 int n_values, DLTensor* workspace) {
+                 int n_values, DLTensor* workspace, cudaStream_t stream) {
   thrust::device_ptr<DataType> data_ptr(static_cast<DataType*>(input->data));
   thrust::device_ptr<DataType> values_ptr(static_cast<DataType*>(out_values->data));
   thrust::device_ptr<IndicesType> indices_ptr(static_cast<IndicesType*>(out_indices->data));
 
-  WorkspaceMemoryResource mr(workspace);
-  auto policy = get_thrust_exec_policy(&mr);
+  WorkspaceMemoryResource mr(workspace, input->device);
+  auto policy = get_thrust_exec_policy(&mr, stream);
 
   size_t size = 1;
   for (int i = 0; i < input->ndim; ++i) {
     size *= input->shape[i];
   }
-  thrust::copy(policy, data_ptr, data_ptr + size, values_ptr);
+  if (size == 0) return;
 
   if (size == static_cast<size_t>(input->shape[input->ndim - 1])) {
     // A fast path for single segment case
-    thrust::sequence(indices_ptr, indices_ptr + n_values);
+    thrust::copy(policy, data_ptr, data_ptr + size, values_ptr);
+    thrust::sequence(policy, indices_ptr, indices_ptr + n_values);
     if (is_ascend) {
       thrust::sort_by_key(policy, values_ptr, values_ptr + n_values, indices_ptr);
     } else {
       thrust::sort_by_key(policy, values_ptr, values_ptr + n_values, indices_ptr,
                           thrust::greater<DataType>());
     }
-  } else {
-    // segmented sort by key
-    // Follow the back-to-back stable_sort_by_key strategy explained below
-    // https://groups.google.com/g/thrust-users/c/BoLsxO6b4FY
-    thrust::device_ptr<int64_t> argsort_order(
-        static_cast<int64_t*>(mr.do_allocate(sizeof(int64_t) * size, sizeof(int64_t))));
-    thrust::sequence(argsort_order, argsort_order + size);
-
-    // First, sort values and store the sorted order in argsort_order.
-    if (is_ascend) {
-      thrust::stable_sort_by_key(policy, values_ptr, values_ptr + size, argsort_order);
-    } else {
-      thrust::stable_sort_by_key(policy, values_ptr, values_ptr + size, argsort_order,
-                                 thrust::greater<DataType>());
-    }
+    return;
+  }
 
-    // The following is to create the indices array 0, 1, 2, 0, 1, 2 ... 0, 1, 2
-    // without materializing it
-    auto counting_iter = thrust::counting_iterator<int64_t>(0);
-    auto linear_index_to_sort_axis_index = [n_values] __host__ __device__(int64_t i) {
-      return i % n_values;
-    };  // NOLINT(*)
-    auto init_indices_iter =
-        thrust::make_transform_iterator(counting_iter, linear_index_to_sort_axis_index);
+  // The following is to create the indices array 0, 1, 2, 0, 1, 2 ... 0, 1, 2
+  // without materializing it
+  auto counting_iter = thrust::counting_iterator<int64_t>(0);
+  auto linear_index_to_sort_axis_index = [n_values] __host__ __device__(int64_t i) {
+    return static_cast<IndicesType>(i % n_values);
+  };  // NOLINT(*)
+  auto init_indices_iter =
+      thrust::make_transform_iterator(counting_iter, linear_index_to_sort_axis_index);
+
+#if !defined(__HIPCC__)
+  if (size <= static_cast<size_t>(std::numeric_limits<int>::max())) {
+    // Sort all the rows at once with a segmented radix sort, one thread block per row. The radix
+    // sort is stable, so the equal values of a row keep the order of their indices.
+    int num_segments = size / n_values;
+    thrust::device_ptr<int> offsets(
+        static_cast<int*>(mr.do_allocate(sizeof(int) * (num_segments + 1), sizeof(int))));
+    thrust::sequence(policy, offsets, offsets + num_segments + 1, 0, n_values);
+    thrust::device_ptr<IndicesType> init_indices(static_cast<IndicesType*>(
+        mr.do_allocate(sizeof(IndicesType) * size, sizeof(IndicesType))));
+    thrust::copy(policy, init_indices_iter, init_indices_iter + size, init_indices);
+
+    const DataType* keys_in = data_ptr.get();
+    DataType* keys_out = values_ptr.get();
+    const IndicesType* indices_in = init_indices.get();
+    IndicesType* indices_out = indices_ptr.get();
+    const int* begin_offsets = offsets.get();
+    const int* end_offsets = begin_offsets + 1;
+    auto segmented_sort = [&](void* temp_storage, size_t& temp_storage_bytes) {
+      if (is_ascend) {
+        CUDA_CALL(cub::DeviceSegmentedRadixSort::SortPairs(
+            temp_storage, temp_storage_bytes, keys_in, keys_out, indices_in, indices_out,
+            static_cast<int>(size), num_segments, begin_offsets, end_offsets, 0,
+            sizeof(DataType) * 8, stream));
+      } else {
+        CUDA_CALL(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+            temp_storage, temp_storage_bytes, keys_in, keys_out, indices_in, indices_out,
+            static_cast<int>(size), num_segments, begin_offsets, end_offsets, 0,
+            sizeof(DataType) * 8, stream));
+      }
+    };
+    size_t temp_storage_bytes = 0;
+    segmented_sort(nullptr, temp_storage_bytes);
+    void* temp_storage = mr.do_allocate(temp_storage_bytes, 256);
+    segmented_sort(temp_storage, temp_storage_bytes);
+
+    mr.do_deallocate(temp_storage, temp_storage_bytes, 256);
+    mr.do_deallocate(init_indices.get(), sizeof(IndicesType) * size, sizeof(IndicesType));
+    mr.do_deallocate(offsets.get(), sizeof(int) * (num_segments + 1), sizeof(int));
+    return;
+  }
+#endif
 
-    // This will reorder indices 0, 1, 2 ... in the sorted order of values_ptr
-    thrust::gather(policy, argsort_order, argsort_order + size, init_indices_iter, indices_ptr);
+  // segmented sort by key
+  // Follow the back-to-back stable_sort_by_key strategy explained below
+  // https://groups.google.com/g/thrust-users/c/BoLsxO6b4FY
+  thrust::copy(policy, data_ptr, data_ptr + size, values_ptr);
+  thrust::device_ptr<int64_t> argsort_order(
+      static_cast<int64_t*>(mr.do_allocate(sizeof(int64_t) * size, sizeof(int64_t))));
+  thrust::sequence(policy, argsort_order, argsort_order + size);
 
-    thrust::device_ptr<int> segment_ids(
-        static_cast<int*>(mr.do_allocate(sizeof(int) * size, sizeof(int))));
-    auto linear_index_to_segment_id = [n_values] __host__ __device__(int64_t i) {
-      return i / n_values;
-    };  // NOLINT(*)
-    // We also reorder segment indices 0, 0, 0, 1, 1, 1 ... in the order of values_ptr
-    thrust::transform(policy, argsort_order, argsort_order + size, segment_ids,
-                      linear_index_to_segment_id);
-
-    // The second sort key-ed by segment_ids would bring segment_ids back to 0, 0, 0, 1, 1, 1 ...
-    // values_ptr and indices_ptr will also be sorted in the order of segmend_ids above
-    // Since sorting has been done in a stable way, relative orderings of values and indices
-    // in the segment do not change and hence they remain sorted.
-    auto key_val_zip = thrust::make_zip_iterator(thrust::make_tuple(values_ptr, indices_ptr));
-    thrust::stable_sort_by_key(policy, segment_ids, segment_ids + size, key_val_zip);
+  // First, sort values and store the sorted order in argsort_order.
+  if (is_ascend) {
+    thrust::stable_sort_by_key(policy, values_ptr, values_ptr + size, argsort_order);
+  } else {
+    thrust::stable_sort_by_key(policy, values_ptr, values_ptr + size, argsort_order,
+                               thrust::greater<DataType>());
   }
+
+  // This will reorder indices 0, 1, 2 ... in the sorted order of values_ptr
+  thrust::gather(policy, argsort_order, argsort_order + size, init_indices_iter, indices_ptr);
+
+  thrust::device_ptr<int> segment_ids(
+      static_cast<int*>(mr.do_allocate(sizeof(int) * size, sizeof(int))));
+  auto linear_index_to_segment_id = [n_values] __host__ __device__(int64_t i) {
+    return i / n_values;
+  };  // NOLINT(*)
+  // We also reorder segment indices 0, 0, 0, 1, 1, 1 ... in the order of values_ptr
+  thrust::transform(policy, argsort_order, argsort_order + size, segment_ids,
+                    linear_index_to_segment_id);
+
+  // The second sort key-ed by segment_ids would bring segment_ids back to 0, 0, 0, 1, 1, 1 ...
+  // values_ptr and indices_ptr will also be sorted in the order of segmend_ids above
+  // Since sorting has been done in a stable way, relative orderings of values and indices
+  // in the segment do not change and hence they remain sorted.
+  auto key_val_zip = thrust::make_zip_iterator(thrust::make_tuple(values_ptr, indices_ptr));
+  thrust::stable_sort_by_key(policy, segment_ids, segment_ids + size, key_val_zip);
+
+  mr.do_deallocate(segment_ids.get(), sizeof(int) * size, sizeof(int));
+  mr.do_deallocate(argsort_order.get(), sizeof(int64_t) * size, sizeof(int64_t));
 }
 
 void thrust_sort_common(DLTensor* input, DLTensor* values_out, DLTensor* indices_out,
                         bool is_ascend, int sort_len, std::string data_dtype, std::string out_dtype,
-                        DLTensor* workspace) {
+                        DLTensor* workspace, cudaStream_t stream) {
   if (data_dtype == "float16") {
     if (out_dtype == "int32") {
-      thrust_sort<half, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<half, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                 stream);
     } else if (out_dtype == "int64") {
-      thrust_sort<half, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<half, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                 stream);
     } else if (out_dtype == "float32") {
-      thrust_sort<half, float>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<half, float>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                               stream);
     } else if (out_dtype == "float64") {
-      thrust_sort<half, double>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<half, double>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
   } else if (data_dtype == "float32") {
     if (out_dtype == "int32") {
-      thrust_sort<float, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<float, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                  stream);
     } else if (out_dtype == "int64") {
-      thrust_sort<float, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<float, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                  stream);
     } else if (out_dtype == "float32") {
-      thrust_sort<float, float>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<float, float>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                stream);
     } else if (out_dtype == "float64") {
-      thrust_sort<float, double>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<float, double>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                 stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
   } else if (data_dtype == "float64") {
     if (out_dtype == "int32") {
-      thrust_sort<double, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<double, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                   stream);
     } else if (out_dtype == "int64") {
-      thrust_sort<double, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<double, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                   stream);
     } else if (out_dtype == "float32") {
-      thrust_sort<double, float>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<double, float>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                 stream);
     } else if (out_dtype == "float64") {
-      thrust_sort<double, double>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<double, double>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                  stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
   } else if (data_dtype == "int32") {
     if (out_dtype == "int32") {
-      thrust_sort<int32_t, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int32_t, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                    stream);
     } else if (out_dtype == "int64") {
-      thrust_sort<int32_t, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int32_t, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                    stream);
     } else if (out_dtype == "float32") {
-      thrust_sort<int32_t, float>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int32_t, float>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                  stream);
     } else if (out_dtype == "float64") {
-      thrust_sort<int32_t, double>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int32_t, double>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                   stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
   } else if (data_dtype == "int64") {
     if (out_dtype == "int32") {
-      thrust_sort<int64_t, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int64_t, int32_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                    stream);
     } else if (out_dtype == "int64") {
-      thrust_sort<int64_t, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int64_t, int64_t>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                    stream);
     } else if (out_dtype == "float32") {
-      thrust_sort<int64_t, float>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int64_t, float>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                  stream);
     } else if (out_dtype == "float64") {
-      thrust_sort<int64_t, double>(input, values_out, indices_out, is_ascend, sort_len, workspace);
+      thrust_sort<int64_t, double>(input, values_out, indices_out, is_ascend, sort_len, workspace,
+                                   stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
     }
@@ -238,31 +326,30 @@ TVM_REGISTER_GLOBAL("tvm.contrib.thrust.sort").set_body([](TVMArgs args, TVMRetV
   DLTensor* values_out = args[1];
   DLTensor* indices_out = args[2];
   bool is_ascend = args[3];
-  DLTensor* workspace = nullptr;
-  if (args.num_args == 5) {
-    workspace = args[4];
-  }
+  DLTensor* workspace;
+  cudaStream_t stream;
+  GetWorkspaceAndStream(args, 4, &workspace, &stream);
 
   auto data_dtype = DLDataType2String(input->dtype);
   auto out_dtype = DLDataType2String(indices_out->dtype);
 
   int n_values = input->shape[input->ndim - 1];
   thrust_sort_common(input, values_out, indices_out, is_ascend, n_values, data_dtype, out_dtype,
-                     workspace);
+                     workspace, stream);
 });
 
 template <typename KeyType, typename ValueType>
 void thrust_stable_sort_by_key(DLTensor* keys_in, DLTensor* values_in, DLTensor* keys_out,
-                               DLTensor* values_out, bool for_scatter,
-                               DLTensor* workspace = nullptr) {
+                               DLTensor* values_out, bool for_scatter, DLTensor* workspace,
+                               cudaStream_t stream) {
   const auto size = keys_in->shape[0];
   thrust::device_ptr<KeyType> keys_in_ptr(static_cast<KeyType*>(keys_in->data));
   thrust::device_ptr<ValueType> values_in_ptr(static_cast<ValueType*>(values_in->data));
   thrust::device_ptr<KeyType> keys_out_ptr(static_cast<KeyType*>(keys_out->data));
   thrust::device_ptr<ValueType> values_out_ptr(static_cast<ValueType*>(values_out->data));
 
-  WorkspaceMemoryResource mr(workspace);
-  auto policy = get_thrust_exec_policy(&mr);
+  WorkspaceMemoryResource mr(workspace, keys_in->device);
+  auto policy = get_thrust_exec_policy(&mr, stream);
 
   if (for_scatter) {
     thrust::transform(policy, keys_in_ptr, keys_in_ptr + size, keys_out_ptr,
@@ -286,10 +373,9 @@ TVM_REGISTER_GLOBAL("tvm.contrib.thrust.stable_sort_by_key")
       DLTensor* keys_out = args[2];
       DLTensor* values_out = args[3];
       bool for_scatter = args[4];
-      DLTensor* workspace = nullptr;
-      if (args.num_args == 6) {
-        workspace = args[5];
-      }
+      DLTensor* workspace;
+      cudaStream_t stream;
+      GetWorkspaceAndStream(args, 5, &workspace, &stream);
 
       auto key_dtype = DLDataType2String(keys_in->dtype);
       auto value_dtype = DLDataType2String(values_in->dtype);
@@ -297,39 +383,39 @@ TVM_REGISTER_GLOBAL("tvm.contrib.thrust.stable_sort_by_key")
       if (key_dtype == "int32") {
         if (value_dtype == "int32") {
           thrust_stable_sort_by_key<int, int>(keys_in, values_in, keys_out, values_out, for_scatter,
-                                              workspace);
+                                              workspace, stream);
         } else if (value_dtype == "int64") {
           thrust_stable_sort_by_key<int, int64_t>(keys_in, values_in, keys_out, values_out,
-                                                  for_scatter, workspace);
+                                                  for_scatter, workspace, stream);
         } else if (value_dtype == "float32") {
           thrust_stable_sort_by_key<int, float>(keys_in, values_in, keys_out, values_out,
-                                                for_scatter, workspace);
+                                                for_scatter, workspace, stream);
         } else {
           LOG(FATAL) << "Unsupported value dtype: " << value_dtype;
         }
       } else if (key_dtype == "int64") {
         if (value_dtype == "int32") {
           thrust_stable_sort_by_key<int64_t, int>(keys_in, values_in, keys_out, values_out,
-                                                  for_scatter, workspace);
+                                                  for_scatter, workspace, stream);
         } else if (value_dtype == "int64") {
           thrust_stable_sort_by_key<int64_t, int64_t>(keys_in, values_in, keys_out, values_out,
-                                                      for_scatter, workspace);
+                                                      for_scatter, workspace, stream);
         } else if (value_dtype == "float32") {
           thrust_stable_sort_by_key<int64_t, float>(keys_in, values_in, keys_out, values_out,
-                                                    for_scatter, workspace);
+                                                    for_scatter, workspace, stream);
         } else {
           LOG(FATAL) << "Unsupported value dtype: " << value_dtype;
         }
       } else if (key_dtype == "float32") {
         if (value_dtype == "int32") {
           thrust_stable_sort_by_key<float, int>(keys_in, values_in, keys_out, values_out,
-                                                for_scatter, workspace);
+                                                for_scatter, workspace, stream);
         } else if (value_dtype == "int64") {
           thrust_stable_sort_by_key<float, int64_t>(keys_in, values_in, keys_out, values_out,
-                                                    for_scatter, workspace);
+                                                    for_scatter, workspace, stream);
         } else if (value_dtype == "float32") {
           thrust_stable_sort_by_key<float, float>(keys_in, values_in, keys_out, values_out,
-                                                  for_scatter, workspace);
+                                                  for_scatter, workspace, stream);
         } else {
           LOG(FATAL) << "Unsupported value dtype: " << value_dtype;
         }
@@ -339,9 +425,10 @@ TVM_REGISTER_GLOBAL("tvm.contrib.thrust.stable_sort_by_key")
     });
 
 template <typename InType, typename OutType>
-void thrust_scan(DLTensor* data, DLTensor* output, bool exclusive, DLTensor* workspace) {
-  WorkspaceMemoryResource mr(workspace);
-  auto policy = get_thrust_exec_policy(&mr);
+void thrust_scan(DLTensor* data, DLTensor* output, bool exclusive, DLTensor* workspace,
+                 cudaStream_t stream) {
+  WorkspaceMemoryResource mr(workspace, data->device);
+  auto policy = get_thrust_exec_policy(&mr, stream);
 
   thrust::device_ptr<InType> data_ptr(static_cast<InType*>(data->data));
   thrust::device_ptr<OutType> output_ptr(static_cast<OutType*>(output->data));
@@ -394,72 +481,71 @@ void thrust_scan(DLTensor* data, DLTensor* output, bool exclusive, DLTensor* wor
 }
 
 TVM_REGISTER_GLOBAL("tvm.contrib.thrust.sum_scan").set_body([](TVMArgs args, TVMRetValue* ret) {
-  ICHECK(args.num_args == 2 || args.num_args == 3 || args.num_args == 4);
+  ICHECK(args.num_args >= 2 && args.num_args <= 5);
   DLTensor* data = args[0];
   DLTensor* output = args[1];
   bool exclusive = false;
-  DLTensor* workspace = nullptr;
+  DLTensor* workspace;
+  cudaStream_t stream;
 
   if (args.num_args >= 3) {
     exclusive = args[2];
   }
 
-  if (args.num_args == 4) {
-    workspace = args[3];
-  }
+  GetWorkspaceAndStream(args, 3, &workspace, &stream);
 
   auto in_dtype = DLDataType2String(data->dtype);
   auto out_dtype = DLDataType2String(output->dtype);
 
   if (in_dtype == "bool") {
     if (out_dtype == "int32") {
-      thrust_scan<bool, int>(data, output, exclusive, workspace);
+      thrust_scan<bool, int>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "int64") {
-      thrust_scan<bool, int64_t>(data, output, exclusive, workspace);
+      thrust_scan<bool, int64_t>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "float32") {
-      thrust_scan<bool, float>(data, output, exclusive, workspace);
+      thrust_scan<bool, float>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "float64") {
-      thrust_scan<bool, double>(data, output, exclusive, workspace);
+      thrust_scan<bool, double>(data, output, exclusive, workspace, stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype
                  << ". Supported output dtypes are int32, int64, float32, and float64";
     }
   } else if (in_dtype == "int32") {
     if (out_dtype == "int32") {
-      thrust_scan<int, int>(data, output, exclusive, workspace);
+      thrust_scan<int, int>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "int64") {
-      thrust_scan<int, int64_t>(data, output, exclusive, workspace);
+      thrust_scan<int, int64_t>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "float32") {
-      thrust_scan<int, float>(data, output, exclusive, workspace);
+      thrust_scan<int, float>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "float64") {
-      thrust_scan<int, double>(data, output, exclusive, workspace);
+      thrust_scan<int, double>(data, output, exclusive, workspace, stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype
                  << ". Supported output dtypes are int32, int64, float32, and float64";
     }
   } else if (in_dtype == "int64") {
     if (out_dtype == "int64") {
-      thrust_scan<int64_t, int64_t>(data, output, exclusive, workspace);
+      thrust_scan<int64_t, int64_t>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "float32") {
-      thrust_scan<int64_t, float>(data, output, exclusive, workspace);
+      thrust_scan<int64_t, float>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "float64") {
-      thrust_scan<int64_t, double>(data, output, exclusive, workspace);
+      thrust_scan<int64_t, double>(data, output, exclusive, workspace, stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype
                  << ". Supported output dtypes are int64, float32, and float64";
     }
   } else if (in_dtype == "float32") {
     if (out_dtype == "float32") {
-      thrust_scan<float, float>(data, output, exclusive, workspace);
+      thrust_scan<float, float>(data, output, exclusive, workspace, stream);
     } else if (out_dtype == "float64") {
-      thrust_scan<float, double>(data, output, exclusive, workspace);
+      thrust_scan<float, double>(data, output, exclusive, workspace, stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype
                  << ". Supported output dtypes are float32, and float64";
     }
   } else if (in_dtype == "float64") {
     if (out_dtype == "float64") {
-      thrust_scan<double, double>(data, output, exclusive, workspace);
+      thrust_scan<double, double>(data, output, exclusive, workspace, stream);
     } else {
       LOG(FATAL) << "Unsupported output dtype: " << out_dtype
                  << ". Supported output dtype is float64";
@@ -72,9 +72,13 @@ inline __device__ float block_sum(float* red_smem, float sum) {
 }
 
 // TODO(woosuk): Merge the last two dimensions of the grid.
-// Grid: (num_heads, num_seqs, max_num_partitions).
+// Grid: (num_heads / NUM_QUERIES_PER_BLOCK, num_seqs, max_num_partitions).
+// With grouped-query attention, a thread block may process NUM_QUERIES_PER_BLOCK query heads
+// sharing the same KV head. Every key and value is then loaded once into registers and used for
+// all the heads of the block, instead of once per query head.
 template <typename scalar_t, int HEAD_SIZE, int BLOCK_SIZE, int NUM_THREADS,
-          int PARTITION_SIZE = 0>  // Zero means no partitioning.
+          int PARTITION_SIZE = 0,  // Zero means no partitioning.
+          int NUM_QUERIES_PER_BLOCK = 1>
 __device__ void paged_attention_kernel(
     float* __restrict__ exp_sums,          // [num_seqs, num_heads, max_num_partitions]
     float* __restrict__ max_logits,        // [num_seqs, num_heads, max_num_partitions]
@@ -88,6 +92,7 @@ __device__ void paged_attention_kernel(
     const int max_num_blocks_per_seq,
     const float* __restrict__ alibi_slopes,  // [num_heads]
     const int q_stride, const int kv_block_stride, const int kv_head_stride) {
+  constexpr int G = NUM_QUERIES_PER_BLOCK;
   const int seq_idx = blockIdx.y;
   const int partition_idx = blockIdx.z;
   const int max_num_partitions = gridDim.z;
@@ -122,11 +127,17 @@ __device__ void paged_attention_kernel(
   const int warp_idx = thread_idx / WARP_SIZE;
   const int lane = thread_idx % WARP_SIZE;
 
-  const int head_idx = blockIdx.x;
-  const int num_heads = gridDim.x;
+  // The block processes the query heads [head_base_idx, head_base_idx + G), which all belong to
+  // the same KV head since G divides the number of query heads per KV head.
+  const int head_base_idx = blockIdx.x * G;
+  const int num_heads = gridDim.x * G;
   const int num_queries_per_kv = num_heads / num_kv_heads;
-  const int kv_head_idx = head_idx / num_queries_per_kv;
-  const float alibi_slope = alibi_slopes == nullptr ? 0.f : alibi_slopes[head_idx];
+  const int kv_head_idx = head_base_idx / num_queries_per_kv;
+  float alibi_slopes_g[G];
+#pragma unroll
+  for (int g = 0; g < G; g++) {
+    alibi_slopes_g[g] = alibi_slopes == nullptr ? 0.f : alibi_slopes[head_base_idx + g];
+  }
 
   // A vector type to store a part of a key or a query.
   // The vector size is configured in such a way that the threads in a thread group
@@ -149,12 +160,16 @@ __device__ void paged_attention_kernel(
   // has 0, 4, 8, ... th vectors of the query, and the second thread has 1, 5, 9, ...
   // th vectors of the query, and so on.
   // NOTE(woosuk): Because q is split from a qkv tensor, it may not be contiguous.
-  const scalar_t* q_ptr = q + seq_idx * q_stride + head_idx * HEAD_SIZE;
-  __shared__ Q_vec q_vecs[THREAD_GROUP_SIZE][NUM_VECS_PER_THREAD];
+  __shared__ Q_vec q_vecs[G][THREAD_GROUP_SIZE][NUM_VECS_PER_THREAD];
 #pragma unroll
-  for (int i = thread_group_idx; i < NUM_VECS_PER_THREAD; i += NUM_THREAD_GROUPS) {
-    const int vec_idx = thread_group_offset + i * THREAD_GROUP_SIZE;
-    q_vecs[thread_group_offset][i] = *reinterpret_cast<const Q_vec*>(q_ptr + vec_idx * VEC_SIZE);
+  for (int g = 0; g < G; g++) {
+    const scalar_t* q_ptr = q + seq_idx * q_stride + (head_base_idx + g) * HEAD_SIZE;
+#pragma unroll
+    for (int i = thread_group_idx; i < NUM_VECS_PER_THREAD; i += NUM_THREAD_GROUPS) {
+      const int vec_idx = thread_group_offset + i * THREAD_GROUP_SIZE;
+      q_vecs[g][thread_group_offset][i] =
+          *reinterpret_cast<const Q_vec*>(q_ptr + vec_idx * VEC_SIZE);
+    }
   }
   __syncthreads();  // TODO(naed90): possible speedup if this is replaced with a memory wall right
                     // before we use q_vecs
@@ -162,14 +177,20 @@ __device__ void paged_attention_kernel(
   // Memory planning.
   extern __shared__ char shared_mem[];
   // NOTE(woosuk): We use FP32 for the softmax logits for better accuracy.
+  // The logits of the query head g start at logits + g * logits_stride.
   float* logits = reinterpret_cast<float*>(shared_mem);
+  const int logits_stride = num_blocks * BLOCK_SIZE;
   // Workspace for reduction.
-  __shared__ float red_smem[2 * NUM_WARPS];
+  __shared__ float red_smem[G][2 * NUM_WARPS];
 
   // x == THREAD_GROUP_SIZE * VEC_SIZE
   // Each thread group fetches x elements from the key at a time.
   constexpr int x = 16 / sizeof(scalar_t);
-  float qk_max = -FLT_MAX;
+  float qk_max[G];
+#pragma unroll
+  for (int g = 0; g < G; g++) {
+    qk_max[g] = -FLT_MAX;
+  }
 
   // Iterate over the key blocks.
   // Each warp fetches a block of keys for each iteration.
@@ -203,20 +224,23 @@ __device__ void paged_attention_kernel(
         k_vecs[j] = *reinterpret_cast<const K_vec*>(k_ptr + offset1 * BLOCK_SIZE * x + offset2);
       }
 
-      // Compute dot product.
-      // This includes a reduction across the threads in the same thread group.
-      float qk =
-          scale * Qk_dot<scalar_t, THREAD_GROUP_SIZE>::dot(q_vecs[thread_group_offset], k_vecs);
-      // Add the ALiBi bias if slopes are given.
-      qk += (alibi_slope != 0) ? alibi_slope * (token_idx - context_len + 1) : 0;
-
-      if (thread_group_offset == 0) {
-        // Store the partial reductions to shared memory.
-        // NOTE(woosuk): It is required to zero out the masked logits.
-        const bool mask = token_idx >= context_len;
-        logits[token_idx - start_token_idx] = mask ? 0.f : qk;
-        // Update the max value.
-        qk_max = mask ? qk_max : fmaxf(qk_max, qk);
+      const bool mask = token_idx >= context_len;
+#pragma unroll
+      for (int g = 0; g < G; g++) {
+        // Compute dot product.
+        // This includes a reduction across the threads in the same thread group.
+        float qk = scale *
+                   Qk_dot<scalar_t, THREAD_GROUP_SIZE>::dot(q_vecs[g][thread_group_offset], k_vecs);
+        // Add the ALiBi bias if slopes are given.
+        qk += (alibi_slopes_g[g] != 0) ? alibi_slopes_g[g] * (token_idx - context_len + 1) : 0;
+
+        if (thread_group_offset == 0) {
+          // Store the partial reductions to shared memory.
+          // NOTE(woosuk): It is required to zero out the masked logits.
+          logits[g * logits_stride + token_idx - start_token_idx] = mask ? 0.f : qk;
+          // Update the max value.
+          qk_max[g] = mask ? qk_max[g] : fmaxf(qk_max[g], qk);
+        }
       }
     }
   }
@@ -225,48 +249,65 @@ __device__ void paged_attention_kernel(
   // max qk value for each "warp" (not across the thread block yet).
   // The 0-th thread of each thread group already has its max qk value.
 #pragma unroll
-  for (int mask = WARP_SIZE / 2; mask >= THREAD_GROUP_SIZE; mask /= 2) {
-    qk_max = fmaxf(qk_max, __shfl_xor_sync(uint32_t(-1), qk_max, mask));
-  }
-  if (lane == 0) {
-    red_smem[warp_idx] = qk_max;
+  for (int g = 0; g < G; g++) {
+#pragma unroll
+    for (int mask = WARP_SIZE / 2; mask >= THREAD_GROUP_SIZE; mask /= 2) {
+      qk_max[g] = fmaxf(qk_max[g], __shfl_xor_sync(uint32_t(-1), qk_max[g], mask));
+    }
+    if (lane == 0) {
+      red_smem[g][warp_idx] = qk_max[g];
+    }
   }
   __syncthreads();
 
   // TODO(woosuk): Refactor this part.
   // Get the max qk value for the sequence.
-  qk_max = lane < NUM_WARPS ? red_smem[lane] : -FLT_MAX;
 #pragma unroll
-  for (int mask = NUM_WARPS / 2; mask >= 1; mask /= 2) {
-    qk_max = fmaxf(qk_max, __shfl_xor_sync(uint32_t(-1), qk_max, mask));
+  for (int g = 0; g < G; g++) {
+    qk_max[g] = lane < NUM_WARPS ? red_smem[g][lane] : -FLT_MAX;
+#pragma unroll
+    for (int mask = NUM_WARPS / 2; mask >= 1; mask /= 2) {
+      qk_max[g] = fmaxf(qk_max[g], __shfl_xor_sync(uint32_t(-1), qk_max[g], mask));
+    }
+    // Broadcast the max qk value to all threads.
+    qk_max[g] = __shfl_sync(uint32_t(-1), qk_max[g], 0);
   }
-  // Broadcast the max qk value to all threads.
-  qk_max = __shfl_sync(uint32_t(-1), qk_max, 0);
 
   // Get the sum of the exp values.
-  float exp_sum = 0.f;
-  for (int i = thread_idx; i < num_tokens; i += NUM_THREADS) {
-    float val = __expf(logits[i] - qk_max);
-    logits[i] = val;
-    exp_sum += val;
+  float exp_sum[G];
+#pragma unroll
+  for (int g = 0; g < G; g++) {
+    exp_sum[g] = 0.f;
+    for (int i = thread_idx; i < num_tokens; i += NUM_THREADS) {
+      float val = __expf(logits[g * logits_stride + i] - qk_max[g]);
+      logits[g * logits_stride + i] = val;
+      exp_sum[g] += val;
+    }
+    exp_sum[g] = block_sum<NUM_WARPS>(&red_smem[g][NUM_WARPS], exp_sum[g]);
   }
-  exp_sum = block_sum<NUM_WARPS>(&red_smem[NUM_WARPS], exp_sum);
 
   // Compute softmax.
-  const float inv_sum = __fdividef(1.f, exp_sum + 1e-6f);
-  for (int i = thread_idx; i < num_tokens; i += NUM_THREADS) {
-    logits[i] *= inv_sum;
+#pragma unroll
+  for (int g = 0; g < G; g++) {
+    const float inv_sum = __fdividef(1.f, exp_sum[g] + 1e-6f);
+    for (int i = thread_idx; i < num_tokens; i += NUM_THREADS) {
+      logits[g * logits_stride + i] *= inv_sum;
+    }
   }
   __syncthreads();
 
   // If partitioning is enabled, store the max logit and exp_sum.
   if (USE_PARTITIONING && thread_idx == 0) {
-    float* max_logits_ptr = max_logits + seq_idx * num_heads * max_num_partitions +
+#pragma unroll
+    for (int g = 0; g < G; g++) {
+      const int head_idx = head_base_idx + g;
+      float* max_logits_ptr = max_logits + seq_idx * num_heads * max_num_partitions +
+                              head_idx * max_num_partitions + partition_idx;
+      *max_logits_ptr = qk_max[g];
+      float* exp_sums_ptr = exp_sums + seq_idx * num_heads * max_num_partitions +
                             head_idx * max_num_partitions + partition_idx;
-    *max_logits_ptr = qk_max;
-    float* exp_sums_ptr = exp_sums + seq_idx * num_heads * max_num_partitions +
-                          head_idx * max_num_partitions + partition_idx;
-    *exp_sums_ptr = exp_sum;
+      *exp_sums_ptr = exp_sum[g];
+    }
   }
 
   // Each thread will fetch 16 bytes from the value cache at a time.
@@ -280,10 +321,13 @@ __device__ void paged_attention_kernel(
   constexpr int NUM_ROWS_PER_THREAD = DIVIDE_ROUND_UP(HEAD_SIZE, NUM_ROWS_PER_ITER);
 
   // NOTE(woosuk): We use FP32 for the accumulator for better accuracy.
-  float accs[NUM_ROWS_PER_THREAD];
+  float accs[G][NUM_ROWS_PER_THREAD];
+#pragma unroll
+  for (int g = 0; g < G; g++) {
 #pragma unroll
-  for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
-    accs[i] = 0.f;
+    for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
+      accs[g][i] = 0.f;
+    }
   }
 
   scalar_t zero_value;
@@ -296,8 +340,12 @@ __device__ void paged_attention_kernel(
     const int64_t physical_block_number = static_cast<int64_t>(block_table[block_idx]);
     const int physical_block_offset = (lane % NUM_V_VECS_PER_ROW) * V_VEC_SIZE;
     const int token_idx = block_idx * BLOCK_SIZE + physical_block_offset;
-    L_vec logits_vec;
-    from_float(logits_vec, *reinterpret_cast<Float_L_vec*>(logits + token_idx - start_token_idx));
+    L_vec logits_vecs[G];
+#pragma unroll
+    for (int g = 0; g < G; g++) {
+      from_float(logits_vecs[g], *reinterpret_cast<Float_L_vec*>(logits + g * logits_stride +
+                                                                 token_idx - start_token_idx));
+    }
 
     const scalar_t* v_ptr =
         v_cache + physical_block_number * kv_block_stride + kv_head_idx * kv_head_stride;
@@ -317,20 +365,26 @@ __device__ void paged_attention_kernel(
             v_vec_ptr[j] = token_idx + j < context_len ? v_vec_ptr[j] : zero_value;
           }
         }
-        accs[i] += dot(logits_vec, v_vec);
+#pragma unroll
+        for (int g = 0; g < G; g++) {
+          accs[g][i] += dot(logits_vecs[g], v_vec);
+        }
       }
     }
   }
 
   // Perform reduction within each warp.
 #pragma unroll
-  for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
-    float acc = accs[i];
+  for (int g = 0; g < G; g++) {
+#pragma unroll
+    for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
+      float acc = accs[g][i];
 #pragma unroll
-    for (int mask = NUM_V_VECS_PER_ROW / 2; mask >= 1; mask /= 2) {
-      acc += __shfl_xor_sync(uint32_t(-1), acc, mask);
+      for (int mask = NUM_V_VECS_PER_ROW / 2; mask >= 1; mask /= 2) {
+        acc += __shfl_xor_sync(uint32_t(-1), acc, mask);
+      }
+      accs[g][i] = acc;
     }
-    accs[i] = acc;
   }
 
   // NOTE(woosuk): A barrier is required because the shared memory space for logits
@@ -344,12 +398,15 @@ __device__ void paged_attention_kernel(
     int mid = i / 2;
     // Upper warps write to shared memory.
     if (warp_idx >= mid && warp_idx < i) {
-      float* dst = &out_smem[(warp_idx - mid) * HEAD_SIZE];
 #pragma unroll
-      for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
-        const int row_idx = lane / NUM_V_VECS_PER_ROW + i * NUM_ROWS_PER_ITER;
-        if (row_idx < HEAD_SIZE && lane % NUM_V_VECS_PER_ROW == 0) {
-          dst[row_idx] = accs[i];
+      for (int g = 0; g < G; g++) {
+        float* dst = &out_smem[((warp_idx - mid) * G + g) * HEAD_SIZE];
+#pragma unroll
+        for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
+          const int row_idx = lane / NUM_V_VECS_PER_ROW + i * NUM_ROWS_PER_ITER;
+          if (row_idx < HEAD_SIZE && lane % NUM_V_VECS_PER_ROW == 0) {
+            dst[row_idx] = accs[g][i];
+          }
         }
       }
     }
@@ -357,12 +414,15 @@ __device__ void paged_attention_kernel(
 
     // Lower warps update the output.
     if (warp_idx < mid) {
-      const float* src = &out_smem[warp_idx * HEAD_SIZE];
 #pragma unroll
-      for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
-        const int row_idx = lane / NUM_V_VECS_PER_ROW + i * NUM_ROWS_PER_ITER;
-        if (row_idx < HEAD_SIZE && lane % NUM_V_VECS_PER_ROW == 0) {
-          accs[i] += src[row_idx];
+      for (int g = 0; g < G; g++) {
+        const float* src = &out_smem[(warp_idx * G + g) * HEAD_SIZE];
+#pragma unroll
+        for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
+          const int row_idx = lane / NUM_V_VECS_PER_ROW + i * NUM_ROWS_PER_ITER;
+          if (row_idx < HEAD_SIZE && lane % NUM_V_VECS_PER_ROW == 0) {
+            accs[g][i] += src[row_idx];
+          }
         }
       }
     }
@@ -371,13 +431,17 @@ __device__ void paged_attention_kernel(
 
   // Write the final output.
   if (warp_idx == 0) {
-    scalar_t* out_ptr = out + seq_idx * num_heads * max_num_partitions * HEAD_SIZE +
-                        head_idx * max_num_partitions * HEAD_SIZE + partition_idx * HEAD_SIZE;
 #pragma unroll
-    for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
-      const int row_idx = lane / NUM_V_VECS_PER_ROW + i * NUM_ROWS_PER_ITER;
-      if (row_idx < HEAD_SIZE && lane % NUM_V_VECS_PER_ROW == 0) {
-        from_float(*(out_ptr + row_idx), accs[i]);
+    for (int g = 0; g < G; g++) {
+      const int head_idx = head_base_idx + g;
+      scalar_t* out_ptr = out + seq_idx * num_heads * max_num_partitions * HEAD_SIZE +
+                          head_idx * max_num_partitions * HEAD_SIZE + partition_idx * HEAD_SIZE;
+#pragma unroll
+      for (int i = 0; i < NUM_ROWS_PER_THREAD; i++) {
+        const int row_idx = lane / NUM_V_VECS_PER_ROW + i * NUM_ROWS_PER_ITER;
+        if (row_idx < HEAD_SIZE && lane % NUM_V_VECS_PER_ROW == 0) {
+          from_float(*(out_ptr + row_idx), accs[g][i]);
+        }
       }
     }
   }
@@ -403,9 +467,9 @@ __global__ void paged_attention_v1_kernel(
       kv_block_stride, kv_head_stride);
 }
 
-// Grid: (num_heads, num_seqs, max_num_partitions).
-template <typename scalar_t, int HEAD_SIZE, int BLOCK_SIZE, int NUM_THREADS,
-          int PARTITION_SIZE>
+// Grid: (num_heads / NUM_QUERIES_PER_BLOCK, num_seqs, max_num_partitions).
+template <typename scalar_t, int HEAD_SIZE, int BLOCK_SIZE, int NUM_THREADS, int PARTITION_SIZE,
+          int NUM_QUERIES_PER_BLOCK>
 __global__ void paged_attention_v2_kernel(
     float* __restrict__ exp_sums,          // [num_seqs, num_heads, max_num_partitions]
     float* __restrict__ max_logits,        // [num_seqs, num_heads, max_num_partitions]
@@ -419,7 +483,8 @@ __global__ void paged_attention_v2_kernel(
     const int max_num_blocks_per_seq,
     const float* __restrict__ alibi_slopes,  // [num_heads]
     const int q_stride, const int kv_block_stride, const int kv_head_stride) {
-  paged_attention_kernel<scalar_t, HEAD_SIZE, BLOCK_SIZE, NUM_THREADS, PARTITION_SIZE>(
+  paged_attention_kernel<scalar_t, HEAD_SIZE, BLOCK_SIZE, NUM_THREADS, PARTITION_SIZE,
+                         NUM_QUERIES_PER_BLOCK>(
       exp_sums, max_logits, tmp_out, q, k_cache, v_cache, num_kv_heads, scale, block_tables,
       context_lens, max_num_blocks_per_seq, alibi_slopes, q_stride, kv_block_stride,
       kv_head_stride);
@@ -607,7 +672,8 @@ void paged_attention_v1_launcher(DLTensor* out, const DLTensor* query, const DLT
                                              block_tables, context_lens, max_context_len);
 
 #define LAUNCH_PAGED_ATTENTION_V2(HEAD_SIZE)                                                    \
-  vllm::paged_attention_v2_kernel<T, HEAD_SIZE, BLOCK_SIZE, NUM_THREADS, PARTITION_SIZE>        \
+  vllm::paged_attention_v2_kernel<T, HEAD_SIZE, BLOCK_SIZE, NUM_THREADS, PARTITION_SIZE,        \
+                                  NUM_QUERIES_PER_BLOCK>                                        \
       <<<grid, block, shared_mem_size, stream>>>(                                               \
           exp_sums_ptr, max_logits_ptr, tmp_out_ptr, query_ptr, key_cache_ptr, value_cache_ptr, \
           num_kv_heads, scale, block_tables_ptr, context_lens_ptr, max_num_blocks_per_seq,      \
@@ -617,7 +683,8 @@ void paged_attention_v1_launcher(DLTensor* out, const DLTensor* query, const DLT
           out_ptr, exp_sums_ptr, max_logits_ptr, tmp_out_ptr, context_lens_ptr,                 \
           max_num_partitions);
 
-template <typename T, int BLOCK_SIZE, int NUM_THREADS = 128, int PARTITION_SIZE = 512>
+template <typename T, int BLOCK_SIZE, int NUM_QUERIES_PER_BLOCK = 1, int NUM_THREADS = 128,
+          int PARTITION_SIZE = 512>
 void paged_attention_v2_launcher(
 
     DLTensor* out, DLTensor* exp_sums, DLTensor* max_logits, DLTensor* tmp_out,
@@ -650,11 +717,12 @@ void paged_attention_v2_launcher(
 
   constexpr int NUM_WARPS = NUM_THREADS / WARP_SIZE;
   int max_num_partitions = DIVIDE_ROUND_UP(max_context_len, PARTITION_SIZE);
-  int logits_size = PARTITION_SIZE * sizeof(float);
-  int outputs_size = (NUM_WARPS / 2) * head_size * sizeof(float);
+  // Each thread block keeps the logits and the outputs of all its query heads.
+  int logits_size = NUM_QUERIES_PER_BLOCK * PARTITION_SIZE * sizeof(float);
+  int outputs_size = NUM_QUERIES_PER_BLOCK * (NUM_WARPS / 2) * head_size * sizeof(float);
 
   // For paged attention v2 kernel.
-  dim3 grid(num_heads, num_seqs, max_num_partitions);
+  dim3 grid(num_heads / NUM_QUERIES_PER_BLOCK, num_seqs, max_num_partitions);
   int shared_mem_size = std::max(logits_size, outputs_size);
   // For paged attention v2 reduce kernel.
   dim3 reduce_grid(num_heads, num_seqs);
@@ -690,10 +758,40 @@ void paged_attention_v2_launcher(
   }
 }
 
-#define CALL_V2_LAUNCHER(T, BLOCK_SIZE)                                                            \
-  paged_attention_v2_launcher<T, BLOCK_SIZE>(out, exp_sums, max_logits, tmp_out, query, key_cache, \
-                                             value_cache, scale, block_tables, context_lens,       \
-                                             max_context_len);
+#define CALL_V2_LAUNCHER_GQA(T, BLOCK_SIZE, NUM_QUERIES_PER_BLOCK)                            \
+  paged_attention_v2_launcher<T, BLOCK_SIZE, NUM_QUERIES_PER_BLOCK>(                           \
+      out, exp_sums, max_logits, tmp_out, query, key_cache, value_cache, scale, block_tables, \
+      context_lens, max_context_len);
+
+#define CALL_V2_LAUNCHER(T, BLOCK_SIZE)               \
+  switch (GetNumQueriesPerBlock(query, key_cache)) {  \
+    case 8:                                           \
+      CALL_V2_LAUNCHER_GQA(T, BLOCK_SIZE, 8);         \
+      break;                                          \
+    case 4:                                           \
+      CALL_V2_LAUNCHER_GQA(T, BLOCK_SIZE, 4);         \
+      break;                                          \
+    case 2:                                           \
+      CALL_V2_LAUNCHER_GQA(T, BLOCK_SIZE, 2);         \
+      break;                                          \
+    default:                                          \
+      CALL_V2_LAUNCHER_GQA(T, BLOCK_SIZE, 1);         \
+      break;                                          \
+  }
+
+/*!
+ * \brief The number of query heads a thread block of paged attention v2 processes, which is the
+ * largest supported divisor of the number of query heads per KV head.
+ */
+int GetNumQueriesPerBlock(const DLTensor* query, const DLTensor* key_cache) {
+  int num_queries_per_kv = query->shape[1] / key_cache->shape[1];
+  for (int num_queries_per_block : {8, 4, 2}) {
+    if (num_queries_per_kv % num_queries_per_block == 0) {
+      return num_queries_per_block;
+    }
+  }
+  return 1;
+}
 
 void single_query_cached_kv_attention_v1(
     const DLTensor* query, const DLTensor* key_cache, const DLTensor* value_cache,
@@ -746,8 +844,10 @@ TVM_REGISTER_GLOBAL("tvm.contrib.vllm.single_query_cached_kv_attention")
       int max_context_len = static_cast<int*>(max_context_len_tensor->data)[0];
       const int PARTITION_SIZE = 512;
       int max_num_partitions = DIVIDE_ROUND_UP(max_context_len, PARTITION_SIZE);
-      bool use_v1 =
-          max_context_len <= 8192 && (max_num_partitions == 1 || num_seqs * num_heads > 512);
+      // With grouped-query attention, v2 reads the KV cache once for all the query heads of a
+      // KV head, while v1 reads it once per query head.
+      bool use_v1 = GetNumQueriesPerBlock(query, key_cache) == 1 && max_context_len <= 8192 &&
+                    (max_num_partitions == 1 || num_seqs * num_heads > 512);
       if (use_v1) {
         single_query_cached_kv_attention_v1(query, key_cache, value_cache, block_tables,
                                             context_lens, block_size, max_context_len_tensor, out);
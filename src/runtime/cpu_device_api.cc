@@ -24,7 +24,9 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 
@@ -36,6 +38,24 @@
 
 namespace tvm {
 namespace runtime {
+
+/*!
+ * \brief Whether to first touch new allocations from the worker threads.
+ *
+ * Linux places a page on the NUMA node of the CPU that first writes it, so
+ * touching a buffer from the thread pool, in the same contiguous chunks a
+ * statically scheduled parallel loop uses, places each chunk on the node of
+ * the worker that is going to access it. Can be enabled by setting the
+ * environment variable TVM_NUMA_FIRST_TOUCH=1.
+ */
+static std::atomic<bool> numa_first_touch{[] {
+  const char* val = getenv("TVM_NUMA_FIRST_TOUCH");
+  return val != nullptr && atoi(val) != 0;
+}()};
+
+/*! \brief Allocations smaller than this are left to the caller to touch. */
+constexpr size_t kNUMAFirstTouchMinBytes = 1 << 20;
+
 class CPUDeviceAPI final : public DeviceAPI {
  public:
   void SetDevice(Device dev) final {}
@@ -57,6 +77,9 @@ class CPUDeviceAPI final : public DeviceAPI {
     int ret = posix_memalign(&ptr, alignment, nbytes);
     if (ret != 0) throw std::bad_alloc();
 #endif
+    if (nbytes >= kNUMAFirstTouchMinBytes && numa_first_touch.load(std::memory_order_relaxed)) {
+      FirstTouch(ptr, nbytes);
+    }
     return ptr;
   }
 
@@ -86,6 +109,19 @@ class CPUDeviceAPI final : public DeviceAPI {
                       TVMStreamHandle stream) final {
     memcpy(static_cast<char*>(to) + to_offset, static_cast<const char*>(from) + from_offset, size);
   }
+
+ private:
+  // Write one byte of every page from the worker threads of the calling thread.
+  static void FirstTouch(void* ptr, size_t nbytes) {
+    // Workspaces requested by a running task cannot launch another parallel loop.
+    if (threading::InParallelRegion()) return;
+    constexpr size_t kPageSize = 4096;
+    char* data = static_cast<char*>(ptr);
+    int64_t num_pages = (nbytes + kPageSize - 1) / kPageSize;
+    parallel_for_with_threading_backend(
+        [data](int64_t i) { static_cast<volatile char*>(data)[i * kPageSize] = 0; }, 0,
+        num_pages);
+  }
 };
 
 struct CPUWorkspacePool : public WorkspacePool {
@@ -100,6 +136,10 @@ void CPUDeviceAPI::FreeWorkspace(Device dev, void* data) {
   dmlc::ThreadLocalStore<CPUWorkspacePool>::Get()->FreeWorkspace(dev, data);
 }
 
+TVM_REGISTER_GLOBAL("device_api.cpu.set_numa_first_touch").set_body_typed([](bool enable) {
+  return numa_first_touch.exchange(enable);
+});
+
 TVM_REGISTER_GLOBAL("device_api.cpu").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = CPUDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
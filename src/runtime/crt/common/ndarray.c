@@ -69,7 +69,8 @@ int TVMNDArray_Empty(int32_t ndim, const tvm_index_t* shape, DLDataType dtype, D
   return 0;
 }
 
-int TVMNDArray_Load(TVMNDArray* ret, const char** strm) {
+/*! \brief Load an NDArray from the stream, aliasing its data in the stream if `in_place`. */
+static int Load(TVMNDArray* ret, const char** strm, uint8_t in_place) {
   int32_t status = 0;
   uint64_t header, reserved;
   memcpy(&header, *strm, sizeof(header));
@@ -105,7 +106,11 @@ int TVMNDArray_Load(TVMNDArray* ret, const char** strm) {
       *strm += sizeof(shape[idx]);
     }
   }
-  status = TVMNDArray_Empty(ndim, shape, dtype, dev, ret);
+  if (in_place) {
+    status = Create(ndim, shape, dtype, dev, ret);
+  } else {
+    status = TVMNDArray_Empty(ndim, shape, dtype, dev, ret);
+  }
   if (status != 0) {
     return status;
   }
@@ -124,12 +129,20 @@ int TVMNDArray_Load(TVMNDArray* ret, const char** strm) {
             (int)data_byte_size, (int)(num_elems * elem_bytes));  // NOLINT(*)
     status = -1;
   }
-  memcpy(ret->dl_tensor.data, *strm, data_byte_size);
+  if (in_place) {
+    ret->dl_tensor.data = (void*)*strm;  // NOLINT(*)
+  } else {
+    memcpy(ret->dl_tensor.data, *strm, data_byte_size);
+  }
   *strm += data_byte_size;
 
   return status;
 }
 
+int TVMNDArray_Load(TVMNDArray* ret, const char** strm) { return Load(ret, strm, 0); }
+
+int TVMNDArray_LoadInPlace(TVMNDArray* ret, const char** strm) { return Load(ret, strm, 1); }
+
 int TVMNDArray_CreateView(TVMNDArray* arr, const tvm_index_t* shape, int32_t ndim, DLDataType dtype,
                           TVMNDArray* array_view) {
   int status = Create(ndim, shape, dtype, arr->dl_tensor.device, array_view);
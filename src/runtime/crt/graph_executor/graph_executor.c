@@ -33,6 +33,11 @@
 
 #include "crt_config.h"
 
+#ifndef TVM_CRT_PARAM_ALIGNMENT_BYTES
+/*! \brief The alignment of the parameters used in place, by default that of the allocations. */
+#define TVM_CRT_PARAM_ALIGNMENT_BYTES 16
+#endif  // TVM_CRT_PARAM_ALIGNMENT_BYTES
+
 #ifndef MAX
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 #endif  // MAX
@@ -771,15 +776,61 @@ void TVMGraphExecutor_SetInput(TVMGraphExecutor* executor, const char* name, DLT
   executor->data_entry[eid].dl_tensor.data = data_in->data;
 }
 
+/*!
+ * \brief Use the data of a parameter in the blob directly when it is aligned, releasing the
+ * storage planned for it, or copy the data into the planned storage otherwise.
+ * \param executor The graph executor.
+ * \param eid The entry id of the parameter.
+ * \param strm The stream of the parameter in the blob.
+ * \return The result of this function execution.
+ */
+static int TVMGraphExecutor_LoadParamInPlace(TVMGraphExecutor* executor, uint32_t eid,
+                                             const char** strm) {
+  DLDevice dev = {kDLCPU, 0};
+  TVMNDArray* entry = &(executor->data_entry[eid]);
+  TVMGraphExecutorStorageEntry* storage =
+      &(executor->storage_pool[executor->attrs.storage_id[eid]]);
+  TVMNDArray param;
+  int status = TVMNDArray_LoadInPlace(&param, strm);
+  if (param.dl_tensor.shape == NULL) {
+    return status;
+  }
+  int64_t size = TVMNDArray_DataSizeBytes(&param);
+  if (size != TVMNDArray_DataSizeBytes(entry)) {
+    fprintf(stderr, "Invalid parameter size %d, while %d bytes are planned.\n", (int)size,
+            (int)TVMNDArray_DataSizeBytes(entry));  // NOLINT(*)
+    status = -1;
+  } else if ((uintptr_t)param.dl_tensor.data % TVM_CRT_PARAM_ALIGNMENT_BYTES == 0) {
+    if (!storage->is_linked_param) {
+      status |= TVMNDArray_Release(&(storage->array));
+      // The storage is not owned any more, as the storage of linked parameters.
+      storage->is_linked_param = 1;
+    }
+    storage->array.dl_tensor.data = param.dl_tensor.data;
+    entry->dl_tensor.data = param.dl_tensor.data;
+  } else if (!storage->is_linked_param) {
+    memcpy(entry->dl_tensor.data, param.dl_tensor.data, size);
+  } else {
+    fprintf(stderr, "Cannot copy a misaligned parameter into storage in read-only memory.\n");
+    status = -1;
+  }
+  tvm_crt_error_t err = TVMPlatformMemoryFree(param.dl_tensor.shape, dev);
+  if (err != kTvmErrorNoError) {
+    status = -1;
+  }
+  return status;
+}
+
 /*!
  * \brief Load parameters from parameter blob.
  * \param executor The graph executor.
  * \param param_blob A binary blob of parameter.
  * \param param_size The parameter size.
+ * \param in_place Whether to use the parameters in the blob in place.
  * \return The result of this function execution.
  */
-int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_blob,
-                                const uint32_t param_size) {
+static int TVMGraphExecutor_LoadParamsImpl(TVMGraphExecutor* executor, const char* param_blob,
+                                           const uint32_t param_size, uint8_t in_place) {
   int status = 0;
   const char* bptr = param_blob;
   uint64_t header, reserved;
@@ -841,21 +892,25 @@ int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_bl
       status = -1;
     }
 
-    if (executor->data_entry[eid].dl_tensor.shape) {
-      err = TVMPlatformMemoryFree(executor->data_entry[eid].dl_tensor.shape, dev);
-      if (err != kTvmErrorNoError) {
-        status = -1;
+    if (in_place) {
+      status |= TVMGraphExecutor_LoadParamInPlace(executor, eid, &bptr);
+    } else {
+      if (executor->data_entry[eid].dl_tensor.shape) {
+        err = TVMPlatformMemoryFree(executor->data_entry[eid].dl_tensor.shape, dev);
+        if (err != kTvmErrorNoError) {
+          status = -1;
+        }
+        executor->data_entry[eid].dl_tensor.shape = 0;
       }
-      executor->data_entry[eid].dl_tensor.shape = 0;
-    }
-    if (executor->data_entry[eid].dl_tensor.data) {
-      err = TVMPlatformMemoryFree(executor->data_entry[eid].dl_tensor.data, dev);
-      if (err != kTvmErrorNoError) {
-        status = -1;
+      if (executor->data_entry[eid].dl_tensor.data) {
+        err = TVMPlatformMemoryFree(executor->data_entry[eid].dl_tensor.data, dev);
+        if (err != kTvmErrorNoError) {
+          status = -1;
+        }
+        executor->data_entry[eid].dl_tensor.data = 0;
       }
-      executor->data_entry[eid].dl_tensor.data = 0;
+      status |= TVMNDArray_Load(&(executor->data_entry[eid]), &bptr);
     }
-    status |= TVMNDArray_Load(&(executor->data_entry[eid]), &bptr);
 #if TVM_CRT_DEBUG
     TVMNDArray* entry = &(executor->data_entry[eid]);
     printf("loading: param %s loaded, in_idx=%d, eid=%d, ndim=%d, data[0]=%f\n",
@@ -874,6 +929,16 @@ int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_bl
   return status;
 }
 
+int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_blob,
+                                const uint32_t param_size) {
+  return TVMGraphExecutor_LoadParamsImpl(executor, param_blob, param_size, 0);
+}
+
+int TVMGraphExecutor_LoadParamsInPlace(TVMGraphExecutor* executor, const char* param_blob,
+                                       const uint32_t param_size) {
+  return TVMGraphExecutor_LoadParamsImpl(executor, param_blob, param_size, 1);
+}
+
 /*!
  * \brief Run all the operations one by one.
  * \param executor The graph executor.
@@ -57,6 +57,16 @@ int TVMNDArray_Empty(int32_t ndim, const tvm_index_t* shape, DLDataType dtype, D
 
 int TVMNDArray_Load(TVMNDArray* ret, const char** strm);
 
+/*!
+ * \brief Load an NDArray whose data stays in the stream, e.g. a blob in flash.
+ * The array owns its shape but not its data, so it must not be released
+ * with TVMNDArray_Release, and the stream must outlive it.
+ * \param ret The loaded array.
+ * \param strm The stream, advanced past the array.
+ * \return 0 on success.
+ */
+int TVMNDArray_LoadInPlace(TVMNDArray* ret, const char** strm);
+
 int TVMNDArray_CreateView(TVMNDArray* arr, const tvm_index_t* shape, int32_t ndim, DLDataType dtype,
                           TVMNDArray* array_view);
 
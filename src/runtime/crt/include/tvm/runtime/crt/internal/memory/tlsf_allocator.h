@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/crt/include/tvm/runtime/crt/internal/memory/tlsf_allocator.h
+ * \brief Defines data types used in the TLSF memory manager.
+ *     Exposed for testing.
+ */
+
+#ifndef TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#include "crt_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief log2 of the alignment, in bytes, of the returned pointers. */
+#ifndef TVM_CRT_TLSF_ALIGNMENT_LOG2
+#define TVM_CRT_TLSF_ALIGNMENT_LOG2 4
+#endif
+
+/*! \brief log2 of the number of second-level size classes per power of two. */
+#ifndef TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2
+#define TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2 4
+#endif
+
+/*! \brief log2 of the upper bound, in bytes, on the size of a single allocation. */
+#ifndef TVM_CRT_TLSF_FL_INDEX_MAX
+#define TVM_CRT_TLSF_FL_INDEX_MAX 30
+#endif
+
+#if TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2 > 5
+#error "TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2 must fit the 32-bit second-level bitmap"
+#endif
+
+#if TVM_CRT_TLSF_FL_INDEX_MAX > 31
+#error "TVM_CRT_TLSF_FL_INDEX_MAX must fit the 32-bit first-level bitmap"
+#endif
+
+#define TLSF_ALIGN_SIZE (1 << TVM_CRT_TLSF_ALIGNMENT_LOG2)
+#define TLSF_SL_INDEX_COUNT (1 << TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2)
+#define TLSF_FL_INDEX_SHIFT (TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2 + TVM_CRT_TLSF_ALIGNMENT_LOG2)
+#define TLSF_FL_INDEX_COUNT (TVM_CRT_TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+// Blocks below this size are all kept in the first-level list 0, one class per alignment step.
+#define TLSF_SMALL_BLOCK_SIZE (1 << TLSF_FL_INDEX_SHIFT)
+
+/*!
+ * \brief Header of a block of the pool.
+ *
+ * `prev_phys` and `size` are always valid; the free list links are only valid while the block
+ * is free and overlap with its payload otherwise.
+ */
+typedef struct TLSFBlock {
+  /*! \brief The block right before this one in memory, NULL for the first block. */
+  struct TLSFBlock* prev_phys;
+  /*! \brief Size of the payload in bytes; the lowest bit is set while the block is free. */
+  size_t size;
+  /*! \brief Next block in the same free list. */
+  struct TLSFBlock* next_free;
+  /*! \brief Previous block in the same free list. */
+  struct TLSFBlock* prev_free;
+} TLSFBlock;
+
+/*!
+ * \brief TLSF memory manager
+ *  Free blocks are kept in segregated lists indexed by a power of two (first level) and a
+ *  linear subdivision of it (second level). Bitmaps of the non-empty lists let both
+ *  allocation and free run in constant time.
+ */
+typedef struct TLSFMemoryManager {
+  // Public interface for this object.
+  MemoryManagerInterface interface;
+  // Bit i is set when any list of first level i is non-empty.
+  uint32_t fl_bitmap;
+  // Bit j of entry i is set when the list (i, j) is non-empty.
+  uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+  // Heads of the free lists.
+  TLSFBlock* blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+  // Number of payload bytes of the pool when nothing is allocated.
+  size_t pool_size_bytes;
+} TLSFMemoryManager;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
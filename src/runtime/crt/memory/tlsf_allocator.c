@@ -0,0 +1,299 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// LINT_C_FILE
+
+/*!
+ * \file tlsf_allocator.c
+ * \brief Two-level segregated fit memory manager
+ *
+ * To maximize portability, thread-safe feature has been dropped for now.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/logging.h>
+#include <tvm/runtime/crt/platform.h>
+
+#define TLSF_ROUND_UP(qty, modulo) (((qty) + ((modulo)-1)) / (modulo) * (modulo))
+
+#define TLSF_BLOCK_FREE_BIT ((size_t)1)
+
+// Offset of the payload from the start of a block.
+#define TLSF_BLOCK_HEADER_SIZE TLSF_ROUND_UP(offsetof(TLSFBlock, next_free), TLSF_ALIGN_SIZE)
+
+// Smallest payload; a free block must be large enough to hold the free list links.
+#define TLSF_MIN_BLOCK_SIZE                                                       \
+  (sizeof(TLSFBlock) > TLSF_BLOCK_HEADER_SIZE + TLSF_ALIGN_SIZE                   \
+       ? TLSF_ROUND_UP(sizeof(TLSFBlock) - TLSF_BLOCK_HEADER_SIZE, TLSF_ALIGN_SIZE) \
+       : TLSF_ALIGN_SIZE)
+
+// Largest payload; the first-level index of any block must stay in range.
+#define TLSF_MAX_BLOCK_SIZE ((((size_t)1) << TVM_CRT_TLSF_FL_INDEX_MAX) - TLSF_ALIGN_SIZE)
+
+// index of the most significant set bit, x must be non-zero
+static int TLSF_Fls(size_t x) {
+  int bit = 0;
+#if defined(__GNUC__) || defined(__clang__)
+  if (sizeof(size_t) == sizeof(unsigned long long)) {  // NOLINT(runtime/int)
+    bit = 8 * (int)sizeof(unsigned long long) - 1 - __builtin_clzll(x);  // NOLINT(runtime/int)
+  } else {
+    bit = 8 * (int)sizeof(unsigned long) - 1 - __builtin_clzl(x);  // NOLINT(runtime/int)
+  }
+#else
+  while (x >>= 1) {
+    bit++;
+  }
+#endif
+  return bit;
+}
+
+// index of the least significant set bit, x must be non-zero
+static int TLSF_Ffs(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(x);
+#else
+  int bit = 0;
+  while ((x & 1) == 0) {
+    x >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+static size_t TLSF_BlockSize(const TLSFBlock* block) { return block->size & ~TLSF_BLOCK_FREE_BIT; }
+
+static bool TLSF_BlockIsFree(const TLSFBlock* block) {
+  return (block->size & TLSF_BLOCK_FREE_BIT) != 0;
+}
+
+static TLSFBlock* TLSF_NextPhys(const TLSFBlock* block) {
+  return (TLSFBlock*)((uint8_t*)block + TLSF_BLOCK_HEADER_SIZE + TLSF_BlockSize(block));
+}
+
+// the list a block of the given size is kept in
+static void TLSF_MappingInsert(size_t size, int* fl, int* sl) {
+  if (size < TLSF_SMALL_BLOCK_SIZE) {
+    *fl = 0;
+    *sl = (int)(size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT));
+  } else {
+    int bit = TLSF_Fls(size);
+    *sl = (int)(size >> (bit - TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+    *fl = bit - (TLSF_FL_INDEX_SHIFT - 1);
+  }
+}
+
+// the first list whose blocks are all large enough for the given size
+static void TLSF_MappingSearch(size_t size, int* fl, int* sl) {
+  if (size >= TLSF_SMALL_BLOCK_SIZE) {
+    size += (((size_t)1) << (TLSF_Fls(size) - TVM_CRT_TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+  }
+  TLSF_MappingInsert(size, fl, sl);
+}
+
+static void TLSF_InsertFree(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSF_MappingInsert(TLSF_BlockSize(block), &fl, &sl);
+  TLSFBlock* head = mgr->blocks[fl][sl];
+  block->next_free = head;
+  block->prev_free = NULL;
+  if (head != NULL) {
+    head->prev_free = block;
+  }
+  mgr->blocks[fl][sl] = block;
+  mgr->fl_bitmap |= (1U << fl);
+  mgr->sl_bitmap[fl] |= (1U << sl);
+}
+
+static void TLSF_RemoveFree(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSF_MappingInsert(TLSF_BlockSize(block), &fl, &sl);
+  if (block->prev_free != NULL) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    mgr->blocks[fl][sl] = block->next_free;
+  }
+  if (block->next_free != NULL) {
+    block->next_free->prev_free = block->prev_free;
+  }
+  if (mgr->blocks[fl][sl] == NULL) {
+    mgr->sl_bitmap[fl] &= ~(1U << sl);
+    if (mgr->sl_bitmap[fl] == 0) {
+      mgr->fl_bitmap &= ~(1U << fl);
+    }
+  }
+}
+
+// find a free block of at least the given size, NULL if there is none
+static TLSFBlock* TLSF_FindFree(TLSFMemoryManager* mgr, size_t size) {
+  int fl, sl;
+  TLSF_MappingSearch(size, &fl, &sl);
+  if (fl < TLSF_FL_INDEX_COUNT) {
+    uint32_t sl_map = mgr->sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+      uint32_t fl_map = fl + 1 < TLSF_FL_INDEX_COUNT ? mgr->fl_bitmap & (~0U << (fl + 1)) : 0;
+      if (fl_map != 0) {
+        fl = TLSF_Ffs(fl_map);
+        sl_map = mgr->sl_bitmap[fl];
+      }
+    }
+    if (sl_map != 0) {
+      return mgr->blocks[fl][TLSF_Ffs(sl_map)];
+    }
+  }
+  // The search skips the list of the requested size, whose blocks may be too small. Its head
+  // can still fit, e.g. when the last free block has exactly the requested size.
+  TLSF_MappingInsert(size, &fl, &sl);
+  TLSFBlock* head = mgr->blocks[fl][sl];
+  if (head != NULL && TLSF_BlockSize(head) >= size) {
+    return head;
+  }
+  return NULL;
+}
+
+/*!
+ * \brief Allocate memory from manager
+ * \param interface Pointer to this structure.
+ * \param num_bytes Number of bytes requested.
+ * \param dev Execution device that will be used with the allocated memory. Must be {kDLCPU, 0}.
+ * \param out_ptr A pointer to which is written a pointer to the newly-allocated memory.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TLSFMemoryManager_Allocate(MemoryManagerInterface* interface, size_t num_bytes,
+                                           DLDevice dev, void** out_ptr) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+
+  *out_ptr = 0;
+  if (num_bytes > TLSF_MAX_BLOCK_SIZE) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  size_t size = TLSF_ROUND_UP(num_bytes, TLSF_ALIGN_SIZE);
+  if (size < TLSF_MIN_BLOCK_SIZE) {
+    size = TLSF_MIN_BLOCK_SIZE;
+  }
+
+  TLSFBlock* block = TLSF_FindFree(mgr, size);
+  if (block == NULL) {
+#if TVM_CRT_DEBUG > 1
+    TVMLogf("insufficient memory, size=%zu", size);
+#endif
+    return kTvmErrorPlatformNoMemory;
+  }
+  TLSF_RemoveFree(mgr, block);
+
+  // return the remainder to the pool when it can form a block
+  size_t block_size = TLSF_BlockSize(block);
+  if (block_size >= size + TLSF_BLOCK_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE) {
+    TLSFBlock* rest = (TLSFBlock*)((uint8_t*)block + TLSF_BLOCK_HEADER_SIZE + size);
+    rest->prev_phys = block;
+    rest->size = (block_size - size - TLSF_BLOCK_HEADER_SIZE) | TLSF_BLOCK_FREE_BIT;
+    TLSF_NextPhys(rest)->prev_phys = rest;
+    TLSF_InsertFree(mgr, rest);
+    block_size = size;
+  }
+  block->size = block_size;
+  *out_ptr = (uint8_t*)block + TLSF_BLOCK_HEADER_SIZE;
+  mgr->interface.vleak_size++;
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("allocate: addr=%p, size=%zu, vleak=%d\n", *out_ptr, block_size,
+          mgr->interface.vleak_size);
+#endif  // TVM_CRT_DEBUG
+  return kTvmErrorNoError;
+}
+
+/*!
+ * \brief Free the memory.
+ * \param interface Pointer to this structure.
+ * \param ptr A pointer returned from TVMPlatformMemoryAllocate which should be free'd.
+ * \param dev Execution device passed to TVMPlatformMemoryAllocate. Fixed to {kDLCPU, 0}.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TLSFMemoryManager_Free(MemoryManagerInterface* interface, void* ptr, DLDevice dev) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+
+  if (ptr == NULL) {
+    return kTvmErrorNoError;
+  }
+  TLSFBlock* block = (TLSFBlock*)((uint8_t*)ptr - TLSF_BLOCK_HEADER_SIZE);
+  if (TLSF_BlockIsFree(block)) {
+    TVMLogf("double free of %p", ptr);
+    return kTvmErrorPlatformCheckFailure;
+  }
+
+  // merge with the free neighbours
+  TLSFBlock* prev = block->prev_phys;
+  if (prev != NULL && TLSF_BlockIsFree(prev)) {
+    TLSF_RemoveFree(mgr, prev);
+    prev->size = TLSF_BlockSize(prev) + TLSF_BLOCK_HEADER_SIZE + TLSF_BlockSize(block);
+    block = prev;
+  }
+  TLSFBlock* next = TLSF_NextPhys(block);
+  if (TLSF_BlockIsFree(next)) {
+    TLSF_RemoveFree(mgr, next);
+    block->size = TLSF_BlockSize(block) + TLSF_BLOCK_HEADER_SIZE + TLSF_BlockSize(next);
+  }
+  TLSF_NextPhys(block)->prev_phys = block;
+  block->size |= TLSF_BLOCK_FREE_BIT;
+  TLSF_InsertFree(mgr, block);
+  mgr->interface.vleak_size--;
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("release: addr=%p, vleak=%d", ptr, mgr->interface.vleak_size);
+#endif  // TVM_CRT_DEBUG
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TLSFMemoryManagerCreate(MemoryManagerInterface** interface, uint8_t* memory_pool,
+                                        size_t memory_pool_size_bytes) {
+  uintptr_t pool_begin = (uintptr_t)memory_pool;
+  uintptr_t pool_end = (pool_begin + memory_pool_size_bytes) / TLSF_ALIGN_SIZE * TLSF_ALIGN_SIZE;
+  uintptr_t blocks_begin =
+      TLSF_ROUND_UP(TLSF_ROUND_UP(pool_begin, TLSF_ALIGN_SIZE) + sizeof(TLSFMemoryManager),
+                    TLSF_ALIGN_SIZE);
+  // room for the first block and the sentinel block that ends the pool
+  if (pool_end < blocks_begin + 2 * TLSF_BLOCK_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE) {
+    return kTvmErrorPlatformNoMemory;
+  }
+
+  TLSFMemoryManager* manager = (TLSFMemoryManager*)TLSF_ROUND_UP(pool_begin, TLSF_ALIGN_SIZE);
+  memset(manager, 0, sizeof(TLSFMemoryManager));
+  *interface = &manager->interface;
+  manager->interface.Allocate = TLSFMemoryManager_Allocate;
+  manager->interface.Free = TLSFMemoryManager_Free;
+
+  size_t size = pool_end - blocks_begin - 2 * TLSF_BLOCK_HEADER_SIZE;
+  if (size > TLSF_MAX_BLOCK_SIZE) {
+    size = TLSF_MAX_BLOCK_SIZE;
+  }
+  manager->pool_size_bytes = size;
+
+  TLSFBlock* block = (TLSFBlock*)blocks_begin;
+  block->prev_phys = NULL;
+  block->size = size | TLSF_BLOCK_FREE_BIT;
+  // a used block of size zero, so that no block is merged past the end of the pool
+  TLSFBlock* sentinel = TLSF_NextPhys(block);
+  sentinel->prev_phys = block;
+  sentinel->size = 0;
+  TLSF_InsertFree(manager, block);
+  return kTvmErrorNoError;
+}
@@ -227,6 +227,7 @@ class CUDADeviceAPI final : public DeviceAPI {
   void FreeStream(Device dev, TVMStreamHandle stream) {
     CUDA_CALL(cudaSetDevice(dev.device_id));
     cudaStream_t cu_stream = static_cast<cudaStream_t>(stream);
+    CUDAThreadEntry::ThreadLocal()->pool.ReleaseStream(dev, stream);
     CUDA_CALL(cudaStreamDestroy(cu_stream));
   }
 
@@ -241,9 +242,46 @@ class CUDADeviceAPI final : public DeviceAPI {
     CUDA_CALL(cudaEventDestroy(evt));
   }
 
+  TVMEventHandle CreateEvent(Device dev) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    cudaEvent_t evt;
+    CUDA_CALL(cudaEventCreateWithFlags(&evt, cudaEventDisableTiming));
+    return static_cast<TVMEventHandle>(evt);
+  }
+
+  void FreeEvent(Device dev, TVMEventHandle event) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaEventDestroy(static_cast<cudaEvent_t>(event)));
+  }
+
+  void RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(event), static_cast<cudaStream_t>(stream)));
+  }
+
+  void EventSync(Device dev, TVMEventHandle event) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaEventSynchronize(static_cast<cudaEvent_t>(event)));
+  }
+
+  bool EventQuery(Device dev, TVMEventHandle event) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    cudaError_t err = cudaEventQuery(static_cast<cudaEvent_t>(event));
+    if (err == cudaErrorNotReady) return false;
+    CUDA_CALL(err);
+    return true;
+  }
+
+  void StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaStreamWaitEvent(static_cast<cudaStream_t>(stream),
+                                  static_cast<cudaEvent_t>(event), 0));
+  }
+
   void StreamSync(Device dev, TVMStreamHandle stream) final {
     CUDA_CALL(cudaSetDevice(dev.device_id));
     CUDA_CALL(cudaStreamSynchronize(static_cast<cudaStream_t>(stream)));
+    CUDAThreadEntry::ThreadLocal()->pool.SyncStream(dev, stream);
   }
 
   void SetStream(Device dev, TVMStreamHandle stream) final {
@@ -255,7 +293,8 @@ class CUDADeviceAPI final : public DeviceAPI {
   }
 
   void* AllocWorkspace(Device dev, size_t size, DLDataType type_hint) final {
-    return CUDAThreadEntry::ThreadLocal()->pool.AllocWorkspace(dev, size);
+    CUDAThreadEntry* entry = CUDAThreadEntry::ThreadLocal();
+    return entry->pool.AllocWorkspace(dev, size, static_cast<TVMStreamHandle>(entry->stream));
   }
 
   void FreeWorkspace(Device dev, void* data) final {
@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cuda_ipc_ndarray.cc
+ * \brief Share NDArrays on CUDA devices with other processes through CUDA IPC handles.
+ */
+#include <cuda.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace cuda {
+
+/*! \brief The IPC handle of an NDArray, which may begin anywhere inside a CUDA allocation. */
+struct NDArrayIPCHandle {
+  /*! \brief The handle of the whole allocation. */
+  cudaIpcMemHandle_t handle;
+  /*! \brief The offset of the NDArray data in the allocation. */
+  int64_t offset;
+};
+
+/*!
+ * \brief The allocations opened from IPC handles in this process.
+ *
+ * An allocation can be opened only once per process, while it may hold several NDArrays,
+ * so the mappings are shared and closed with the last NDArray using them.
+ */
+class IPCMappings {
+ public:
+  static IPCMappings* Global() {
+    static IPCMappings* inst = new IPCMappings();
+    return inst;
+  }
+
+  /*! \return The base address of the allocation of the handle, opened on the current device. */
+  void* Open(const cudaIpcMemHandle_t& handle) {
+    std::string key(handle.reserved, sizeof(handle.reserved));
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = mappings_.find(key);
+    if (it == mappings_.end()) {
+      void* base = nullptr;
+      CUDA_CALL(cudaIpcOpenMemHandle(&base, handle, cudaIpcMemLazyEnablePeerAccess));
+      it = mappings_.emplace(std::move(key), std::make_pair(base, 0)).first;
+      bases_.emplace(base, it->first);
+    }
+    ++it->second.second;
+    return it->second.first;
+  }
+
+  void Close(void* base) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = mappings_.find(bases_.at(base));
+    if (--it->second.second == 0) {
+      CUDA_CALL(cudaIpcCloseMemHandle(base));
+      bases_.erase(base);
+      mappings_.erase(it);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  /*! \brief The base address and the number of NDArrays of each opened handle. */
+  std::unordered_map<std::string, std::pair<void*, int>> mappings_;
+  /*! \brief The handle of each base address. */
+  std::unordered_map<void*, std::string> bases_;
+};
+
+/*! \brief The context of an NDArray opened from an IPC handle. */
+struct IPCNDArrayContext {
+  /*! \brief The base address of the opened allocation. */
+  void* base;
+  /*! \brief The device the allocation is opened on. */
+  int device_id;
+};
+
+static void IPCNDArrayDeleter(Object* obj) {
+  auto* ptr = static_cast<NDArray::Container*>(obj);
+  auto* ctx = static_cast<IPCNDArrayContext*>(ptr->manager_ctx);
+  CUDA_CALL(cudaSetDevice(ctx->device_id));
+  IPCMappings::Global()->Close(ctx->base);
+  delete ctx;
+  delete ptr;
+}
+
+TVM_REGISTER_GLOBAL("runtime.cuda.GetIPCMemHandle").set_body([](TVMArgs args, TVMRetValue* rv) {
+  NDArray arr = args[0];
+  ICHECK_EQ(arr->device.device_type, kDLCUDA)
+      << "ValueError: Expect an array on CUDA, but got one on " << arr->device;
+  CUDA_CALL(cudaSetDevice(arr->device.device_id));
+  CUdeviceptr data = reinterpret_cast<CUdeviceptr>(arr->data) + arr->byte_offset;
+  CUdeviceptr base;
+  size_t size;
+  CUDA_DRIVER_CALL(cuMemGetAddressRange(&base, &size, data));
+  NDArrayIPCHandle ipc;
+  CUDA_CALL(cudaIpcGetMemHandle(&ipc.handle, reinterpret_cast<void*>(base)));
+  ipc.offset = static_cast<int64_t>(data - base);
+  *rv = TVMByteArray{reinterpret_cast<const char*>(&ipc), sizeof(ipc)};
+});
+
+TVM_REGISTER_GLOBAL("runtime.cuda.OpenIPCNDArray")
+    .set_body_typed([](std::string bytes, ShapeTuple shape, DataType dtype, int device_id) {
+      ICHECK_EQ(bytes.size(), sizeof(NDArrayIPCHandle))
+          << "ValueError: Malformed IPC handle of " << bytes.size() << " bytes";
+      NDArrayIPCHandle ipc;
+      std::memcpy(&ipc, bytes.data(), sizeof(ipc));
+      CUDA_CALL(cudaSetDevice(device_id));
+      void* base = IPCMappings::Global()->Open(ipc.handle);
+      NDArray::Container* container = new NDArray::Container(
+          static_cast<char*>(base) + ipc.offset, shape, dtype, Device{kDLCUDA, device_id});
+      container->SetDeleter(IPCNDArrayDeleter);
+      container->manager_ctx = new IPCNDArrayContext{base, device_id};
+      return NDArray(GetObjectPtr<Object>(container));
+    });
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cuda_stream_ordered_allocator.cc
+ * \brief The memory::kStreamOrdered allocator of CUDA, backed by cudaMallocAsync.
+ */
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/registry.h>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace cuda {
+
+using memory::Allocator;
+using memory::Buffer;
+using memory::kStreamOrdered;
+
+#if CUDART_VERSION >= 11020
+
+/*!
+ * \brief An allocator serving requests from a memory pool of the CUDA driver.
+ *
+ * Buffers are allocated and freed with cudaMallocFromPoolAsync/cudaFreeAsync on the current
+ * stream of the calling thread, i.e. the stream the VM launches its kernels on. A freed buffer
+ * can be reused by later work on the same stream without any synchronization, and the driver
+ * keeps up to the release threshold of freed memory in the pool instead of returning it to the
+ * system at each synchronization. Buffers must not be used on another stream after they are
+ * freed unless that stream is synchronized with the current one.
+ */
+class CUDAStreamOrderedAllocator final : public Allocator {
+ public:
+  explicit CUDAStreamOrderedAllocator(Device dev) : Allocator(kStreamOrdered), device_(dev) {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    cudaMemPoolProps props = {};
+    props.allocType = cudaMemAllocationTypePinned;
+    props.handleTypes = cudaMemHandleTypeNone;
+    props.location.type = cudaMemLocationTypeDevice;
+    props.location.id = dev.device_id;
+    CUDA_CALL(cudaMemPoolCreate(&pool_, &props));
+    // Keep all the freed memory cached by default, as the pooled allocator does
+    SetReleaseThreshold(std::numeric_limits<uint64_t>::max());
+  }
+
+  ~CUDAStreamOrderedAllocator() {
+    // The pool may be destroyed with buffers allocated, they are released along with it
+    cudaMemPoolDestroy(pool_);
+  }
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    ICHECK(dev.device_type == kDLCUDA && dev.device_id == device_.device_id)
+        << "ValueError: The allocator of " << device_ << " cannot allocate memory for " << dev;
+    // Pool allocations are aligned the same way as cudaMalloc
+    ICHECK_EQ(256 % alignment, 0U) << "CUDA space is aligned at 256 bytes";
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    Buffer buf;
+    buf.device = dev;
+    buf.size = nbytes;
+    buf.alloc_type = kStreamOrdered;
+    CUDA_CALL(cudaMallocFromPoolAsync(&buf.data, nbytes, pool_, GetCUDAStream()));
+    used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    return buf;
+  }
+
+  Buffer Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
+               const std::string& mem_scope) final {
+    // The base class redirects the flat memory scopes to the allocation above
+    return Allocator::Alloc(dev, shape, type_hint, mem_scope);
+  }
+
+  void Free(const Buffer& buffer) final {
+    CUDA_CALL(cudaSetDevice(buffer.device.device_id));
+    CUDA_CALL(cudaFreeAsync(buffer.data, GetCUDAStream()));
+    used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+  }
+
+  void Clear() final {
+    // Wait for the pending frees before returning all the unused memory of the pool
+    CUDA_CALL(cudaSetDevice(device_.device_id));
+    CUDA_CALL(cudaStreamSynchronize(GetCUDAStream()));
+    CUDA_CALL(cudaMemPoolTrimTo(pool_, 0));
+  }
+
+  size_t UsedMemory() const final { return used_memory_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Set the amount of freed memory the pool keeps instead of releasing it to the system
+   * when a stream, event or device is synchronized.
+   */
+  void SetReleaseThreshold(uint64_t threshold) {
+    CUDA_CALL(cudaMemPoolSetAttribute(pool_, cudaMemPoolAttrReleaseThreshold, &threshold));
+  }
+
+ private:
+  /*! \brief The device of the pool. */
+  Device device_;
+  /*! \brief The memory pool of the device. */
+  cudaMemPool_t pool_{nullptr};
+  /*! \brief The amount of memory currently allocated. */
+  std::atomic<size_t> used_memory_{0};
+};
+
+TVM_REGISTER_GLOBAL("runtime.memory.stream_ordered_allocator.cuda")
+    .set_body_typed([](Device dev) -> void* {
+      int supported = 0;
+      CUDA_CALL(cudaDeviceGetAttribute(&supported, cudaDevAttrMemoryPoolsSupported, dev.device_id));
+      ICHECK(supported) << "ValueError: " << dev << " does not support stream-ordered allocation";
+      return new CUDAStreamOrderedAllocator(dev);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.cuda.SetStreamOrderedReleaseThreshold")
+    .set_body_typed([](Device dev, int64_t threshold) {
+      ICHECK_GE(threshold, 0) << "ValueError: The release threshold must be non-negative";
+      auto* alloc = static_cast<CUDAStreamOrderedAllocator*>(
+          memory::MemoryManager::GetOrCreateAllocator(dev, kStreamOrdered));
+      alloc->SetReleaseThreshold(static_cast<uint64_t>(threshold));
+    });
+
+#endif  // CUDART_VERSION >= 11020
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace tvm
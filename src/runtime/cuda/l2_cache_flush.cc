@@ -38,5 +38,11 @@ TVM_REGISTER_GLOBAL("l2_cache_flush_cuda").set_body([](TVMArgs args, TVMRetValue
   L2Flush::ThreadLocal()->Flush(stream);
 });
 
+// The CUDA implementation of the cache flush in the measurement environment
+TVM_REGISTER_GLOBAL("device_api.cuda.flush_cache").set_body_typed([](Device dev) {
+  CUDA_CALL(cudaSetDevice(dev.device_id));
+  L2Flush::ThreadLocal()->Flush(CUDAThreadEntry::ThreadLocal()->stream);
+});
+
 }  // namespace runtime
 }  // namespace tvm
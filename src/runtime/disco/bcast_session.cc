@@ -22,6 +22,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <sstream>
 
 namespace tvm {
@@ -35,7 +36,13 @@ struct BcastSessionObj::Internal {
     TVMValue values[kNumArgs];
     int type_codes[kNumArgs];
     PackArgs(values, type_codes, static_cast<int>(action), reg_id, std::forward<Args>(args)...);
-    self->BroadcastPacked(TVMArgs(values, type_codes, kNumArgs));
+    if (action == DiscoAction::kSyncWorker || action == DiscoAction::kShutDown) {
+      // These commands wait for a reply or end the session, so they cannot be queued.
+      self->FlushBatch();
+      self->BroadcastPacked(TVMArgs(values, type_codes, kNumArgs));
+    } else {
+      self->BroadcastOrQueue(TVMArgs(values, type_codes, kNumArgs));
+    }
   }
 
   static DRef MakeDRef(int reg_id, Session session) {
@@ -85,6 +92,75 @@ void BcastSessionObj::SyncWorker(int worker_id) {
   ICHECK_EQ(ret_worker_id, worker_id);
 }
 
+void BcastSessionObj::BeginBatch() { ++batch_depth_; }
+
+void BcastSessionObj::EndBatch() {
+  CHECK_GT(batch_depth_, 0) << "ValueError: EndBatch is called without a matching BeginBatch";
+  if (--batch_depth_ == 0) {
+    this->FlushBatch();
+  }
+}
+
+void BcastSessionObj::BroadcastOrQueue(const TVMArgs& args) {
+  if (batch_depth_ == 0) {
+    this->BroadcastPacked(args);
+    return;
+  }
+  TVMValue num_args;
+  num_args.v_int64 = args.num_args;
+  batch_values_.push_back(num_args);
+  batch_type_codes_.push_back(kDLInt);
+  for (int i = 0; i < args.num_args; ++i) {
+    TVMValue value = args.values[i];
+    int type_code = args.type_codes[i];
+    // The caller may release its arguments before the batch is flushed.
+    if (type_code == kTVMStr) {
+      batch_strings_.emplace_back(value.v_str);
+      value.v_str = batch_strings_.back().c_str();
+    } else if (type_code == kTVMBytes) {
+      const TVMByteArray* bytes = static_cast<const TVMByteArray*>(value.v_handle);
+      batch_strings_.emplace_back(bytes->data, bytes->size);
+      batch_bytes_.push_back(TVMByteArray{batch_strings_.back().data(), bytes->size});
+      value.v_handle = &batch_bytes_.back();
+    } else if (type_code == kTVMObjectHandle) {
+      batch_objects_.push_back(GetRef<ObjectRef>(static_cast<Object*>(value.v_handle)));
+    } else {
+      CHECK(type_code == kDLInt || type_code == kDLUInt || type_code == kDLFloat ||
+            type_code == kTVMDataType || type_code == kDLDevice ||
+            type_code == kTVMOpaqueHandle || type_code == kTVMNullptr)
+          << "ValueError: Argument #" << i << " of type " << ArgTypeCode2Str(type_code)
+          << " cannot be batched";
+    }
+    batch_values_.push_back(value);
+    batch_type_codes_.push_back(type_code);
+  }
+  ++batch_num_commands_;
+}
+
+void BcastSessionObj::FlushBatch() {
+  if (batch_num_commands_ == 0) {
+    return;
+  }
+  std::vector<TVMValue> values(batch_values_.size() + 2);
+  std::vector<int> type_codes(batch_type_codes_.size() + 2);
+  PackArgs(values.data(), type_codes.data(), static_cast<int>(DiscoAction::kBatch),
+           batch_num_commands_);
+  std::copy(batch_values_.begin(), batch_values_.end(), values.begin() + 2);
+  std::copy(batch_type_codes_.begin(), batch_type_codes_.end(), type_codes.begin() + 2);
+  // Reset the queue before broadcasting, because releasing the queued objects afterwards may
+  // deallocate registers, which queues new commands.
+  std::deque<std::string> strings;
+  std::deque<TVMByteArray> bytes;
+  std::vector<ObjectRef> objects;
+  strings.swap(batch_strings_);
+  bytes.swap(batch_bytes_);
+  objects.swap(batch_objects_);
+  batch_values_.clear();
+  batch_type_codes_.clear();
+  batch_num_commands_ = 0;
+  this->BroadcastPacked(TVMArgs(values.data(), type_codes.data(), values.size()));
+}
+
 DRef BcastSessionObj::CallWithPacked(const TVMArgs& args) {
   TVMValue* values = const_cast<TVMValue*>(args.values);
   int* type_codes = const_cast<int*>(args.type_codes);
@@ -115,7 +191,7 @@ DRef BcastSessionObj::CallWithPacked(const TVMArgs& args) {
       LOG(FATAL) << "CallWithPacked() does not support " << cnt << " argument(s):" << os.str();
     }
   }
-  this->BroadcastPacked(TVMArgs(values, type_codes, num_args));
+  this->BroadcastOrQueue(TVMArgs(values, type_codes, num_args));
   return BcastSessionObj::Internal::MakeDRef(reg_id, GetRef<Session>(this));
 }
 
@@ -22,6 +22,7 @@
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/disco/session.h>
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -41,6 +42,8 @@ class BcastSessionObj : public SessionObj {
   void CopyToWorker0(const NDArray& host_array, const DRef& remote_array) override;
   void SyncWorker(int worker_id) override;
   void Shutdown() override;
+  void BeginBatch() override;
+  void EndBatch() override;
   void InitCCL(String ccl, IntTuple device_ids) override;
   TVMRetValue DebugGetFromRemote(int64_t reg_id, int worker_id) override = 0;
   void DebugSetRegister(int64_t reg_id, TVMArgValue value, int worker_id) override = 0;
@@ -84,12 +87,34 @@ class BcastSessionObj : public SessionObj {
    */
   virtual TVMArgs RecvReplyPacked(int worker_id) = 0;
 
+  /*!
+   * \brief Broadcast a command, or append it to the open batch.
+   * \param args The packed sequence of the command, which is copied if it is queued.
+   */
+  void BroadcastOrQueue(const TVMArgs& args);
+  /*!
+   * \brief Broadcast the queued commands as one DiscoAction::kBatch packet. Sessions call it before
+   * talking to a single worker, so that the worker observes all the commands issued before.
+   */
+  void FlushBatch();
+
   /*! \brief A side channel to communicate with worker-0 */
   WorkerZeroData worker_zero_data_;
   /*! \brief Number of registers used, including those in `free_regs_` */
   int reg_count_ = 1;
   /*! \brief The regsiter ids that have been deallocated */
   std::vector<int64_t> free_regs_;
+  /*! \brief The nesting depth of BeginBatch */
+  int batch_depth_ = 0;
+  /*! \brief The number of queued commands */
+  int64_t batch_num_commands_ = 0;
+  /*! \brief The queued commands, each prefixed by its number of arguments */
+  std::vector<TVMValue> batch_values_;
+  std::vector<int> batch_type_codes_;
+  /*! \brief Owned copies of the strings, bytes and objects referenced by the queued commands */
+  std::deque<std::string> batch_strings_;
+  std::deque<TVMByteArray> batch_bytes_;
+  std::vector<ObjectRef> batch_objects_;
 
   struct Internal;
   friend struct Internal;
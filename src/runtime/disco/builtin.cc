@@ -27,6 +27,7 @@
 
 #include <sstream>
 
+#include "../trace_recorder.h"
 #include "./utils.h"
 
 namespace tvm {
@@ -87,6 +88,16 @@ void AllGather(NDArray send, bool in_group, NDArray recv) {
   GetCCLFunc("allgather")(send, in_group, recv);
 }
 
+ObjectRef AllReduceAsync(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+  return GetCCLFunc("allreduce_async")(send, static_cast<int>(reduce_kind), in_group, recv);
+}
+
+ObjectRef AllGatherAsync(NDArray send, bool in_group, NDArray recv) {
+  return GetCCLFunc("allgather_async")(send, in_group, recv);
+}
+
+void WaitCollective(ObjectRef handle) { GetCCLFunc("wait_collective")(handle); }
+
 TVM_DLL void BroadcastFromWorker0(NDArray send, bool in_group, NDArray recv) {
   GetCCLFunc("broadcast_from_worker0")(send, in_group, recv);
 }
@@ -144,6 +155,19 @@ TVM_REGISTER_GLOBAL("runtime.disco.allreduce")
       AllReduce(send, static_cast<ReduceKind>(kind), in_group, recv);
     });
 TVM_REGISTER_GLOBAL("runtime.disco.allgather").set_body_typed(AllGather);
+TVM_REGISTER_GLOBAL("runtime.disco.allreduce_async")
+    .set_body_typed([](NDArray send, ShapeTuple reduce_kind, bool in_group, NDArray recv) {
+      int kind = IntegerFromShapeTuple(reduce_kind);
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      return AllReduceAsync(send, static_cast<ReduceKind>(kind), in_group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco.allgather_async").set_body_typed(AllGatherAsync);
+// The arguments after the handle are the buffers of the collective, passed by the compiled code
+// so that the memory planning keeps them alive until the collective completes.
+TVM_REGISTER_GLOBAL("runtime.disco.wait_collective").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK_GE(args.size(), 1) << "ValueError: wait_collective expects the handle of a collective";
+  WaitCollective(args[0]);
+});
 TVM_REGISTER_GLOBAL("runtime.disco.broadcast_from_worker0").set_body_typed(BroadcastFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco.scatter_from_worker0").set_body_typed(ScatterFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco.gather_to_worker0").set_body_typed(GatherToWorker0);
@@ -161,6 +185,9 @@ TVM_REGISTER_GLOBAL("runtime.disco.worker_rank").set_body_typed([]() -> int64_t
 TVM_REGISTER_GLOBAL("runtime.disco.device").set_body_typed([]() -> Device {
   return DiscoWorker::ThreadLocal()->default_device;
 });
+TVM_REGISTER_GLOBAL("runtime.disco.dump_trace").set_body_typed([]() -> String {
+  return profiling::TraceRecorder::Global()->Dump(WorkerId() + 1);
+});
 TVM_REGISTER_GLOBAL("runtime.disco.bind_worker_to_cpu_core").set_body_typed([](IntTuple cpu_ids) {
   int worker_id = WorkerId();
   ICHECK_LT(worker_id, static_cast<int>(cpu_ids.size()));
@@ -22,6 +22,15 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "../../../../3rdparty/tensorrt_llm/custom_allreduce_kernels.h"
 #include "../nccl/nccl_context.h"
 
@@ -57,30 +66,91 @@ inline bool CanApplyTwoShotAllReduce(int64_t num_elements, DLDataType dtype, int
 }
 
 /*!
- * \brief Customized all-reduce kernel backed by CUDA IPC memory.
- * \param send The input tensor of all-reduce.
- * \param strategy The all-reduce strategy. See AllReduceStrategyType for detail.
- * \param recv The output tensor of all-reduce.
+ * \brief The tuned all-reduce strategy for each message-size bucket.
+ * A message of `n` bytes uses the strategy of the first bucket whose
+ * upper bound is no less than `n`, and falls back to the heuristic in
+ * `tensorrt_llm::SelectImplementation` when it exceeds all buckets.
  */
-void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
-  int64_t num_elements = TensorSize(send);
-  nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
-  CHECK_EQ(ctx->worker->num_groups, 1)
-      << "Custom AllReduce for multiple group is not yet implemented.";
+struct AllReduceTuningTable {
+  /*! \brief The pairs of (bucket upper bound in bytes, strategy), in ascending bound order. */
+  std::vector<std::pair<int64_t, tensorrt_llm::AllReduceStrategyType>> buckets;
 
-  tensorrt_llm::AllReduceStrategyType strategy_ =
-      static_cast<tensorrt_llm::AllReduceStrategyType>(strategy);
-  if (strategy_ == tensorrt_llm::AllReduceStrategyType::AUTO) {
-    strategy_ = tensorrt_llm::SelectImplementation(
-        num_elements * ((send->dtype.bits * send->dtype.lanes + 7) / 8), ctx->worker->num_workers);
+  /*! \brief Look up the strategy for the message size. */
+  tensorrt_llm::AllReduceStrategyType Select(int64_t message_size, int num_workers) const {
+    auto it = std::lower_bound(
+        buckets.begin(), buckets.end(), message_size,
+        [](const auto& bucket, int64_t size) { return bucket.first < size; });
+    if (it == buckets.end()) {
+      return tensorrt_llm::SelectImplementation(message_size, num_workers);
+    }
+    return it->second;
+  }
+};
+
+/*!
+ * \brief The global cache of tuning tables, keyed by topology and buckets so
+ * that sessions created later in the process on the same topology skip tuning.
+ * Entries are never replaced, as workers keep pointers to them.
+ */
+class AllReduceTuningCache {
+ public:
+  static AllReduceTuningCache* Global() {
+    static AllReduceTuningCache* cache = new AllReduceTuningCache();
+    return cache;
   }
 
-  if (strategy_ == tensorrt_llm::AllReduceStrategyType::RING ||
-      !CanApplyCustomAllReduce(num_elements, send->dtype)) {
+  const AllReduceTuningTable* Find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tables_.find(key);
+    return it == tables_.end() ? nullptr : it->second.get();
+  }
+
+  const AllReduceTuningTable* Insert(const std::string& key, AllReduceTuningTable table) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<AllReduceTuningTable>& entry = tables_[key];
+    if (entry == nullptr) {
+      entry = std::make_unique<AllReduceTuningTable>(std::move(table));
+    }
+    return entry.get();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<AllReduceTuningTable>> tables_;
+};
+
+/*! \brief The tuning table used by the current worker, or nullptr if not tuned. */
+thread_local const AllReduceTuningTable* worker_tuning_table = nullptr;
+
+/*! \brief The key describing the topology that the current worker runs on. */
+std::string GetTopologyKey(nccl::CCLThreadLocalContext* ctx) {
+  cudaDeviceProp prop;
+  CUDA_CALL(cudaGetDeviceProperties(&prop, ctx->device_id));
+  bool all_peer_accessible = true;
+  int num_devices = 0;
+  CUDA_CALL(cudaGetDeviceCount(&num_devices));
+  for (int i = 0; i < num_devices; ++i) {
+    if (i != ctx->device_id && !nccl::DeviceCanAccessPeer(ctx->device_id, i)) {
+      all_peer_accessible = false;
+    }
+  }
+  return std::string(prop.name) + "/workers=" + std::to_string(ctx->worker->num_workers) +
+         "/p2p=" + std::to_string(all_peer_accessible);
+}
+
+/*!
+ * \brief Launch the all-reduce with the given concrete strategy.
+ * Falls back to nccl when the customized kernels cannot apply.
+ */
+void LaunchAllReduce(nccl::CCLThreadLocalContext* ctx, void* send, void* recv,
+                     int64_t num_elements, DLDataType dtype,
+                     tensorrt_llm::AllReduceStrategyType strategy) {
+  deviceStream_t stream = ctx->GetDefaultStream();
+  if (strategy == tensorrt_llm::AllReduceStrategyType::RING ||
+      !CanApplyCustomAllReduce(num_elements, dtype)) {
     // Dispatch to nccl AllReduce if the customized all-reduce cannot apply.
-    deviceStream_t stream = ctx->GetDefaultStream();
-    NCCL_CALL(ncclAllReduce(send->data, recv->data, num_elements,
-                            /*datatype=*/nccl::AsNCCLDataType(DataType(send->dtype)),
+    NCCL_CALL(ncclAllReduce(send, recv, num_elements,
+                            /*datatype=*/nccl::AsNCCLDataType(DataType(dtype)),
                             /*op=*/ncclSum, ctx->global_comm, stream));
     return;
   }
@@ -90,7 +160,7 @@ void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
   params.ranks_per_node = ctx->worker->num_workers;
   params.rank = ctx->worker->worker_id;
   params.local_rank = ctx->worker->worker_id;
-  CUDAIPCMemory ipc_memory = CUDAIPCMemory::GetIPCMemoryFromDevicePtr(send->data);
+  CUDAIPCMemory ipc_memory = CUDAIPCMemory::GetIPCMemoryFromDevicePtr(send);
   params.barrier_flag = ipc_memory->barrier_flag++;
   for (int i = 0; i < ctx->worker->num_workers; ++i) {
     params.peer_comm_buffer_ptrs[i] = ipc_memory->remote_data[i];
@@ -102,18 +172,160 @@ void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
     params.peer_barrier_ptrs_out[i] = reinterpret_cast<uint32_t*>(ipc_memory->barrier_out[i]);
   }
 
-  if (!CanApplyTwoShotAllReduce(num_elements, send->dtype, ctx->worker->num_workers)) {
+  if (!CanApplyTwoShotAllReduce(num_elements, dtype, ctx->worker->num_workers)) {
     // Two-shot all-reduce does not support this case.
     // So we fallback to the one-shot strategy.
-    strategy_ = tensorrt_llm::AllReduceStrategyType::ONESHOT;
+    strategy = tensorrt_llm::AllReduceStrategyType::ONESHOT;
   }
 
-  tensorrt_llm::customAllReduce(params, recv->data, num_elements, send->dtype, strategy_,
-                                ctx->GetDefaultStream());
+  tensorrt_llm::customAllReduce(params, recv, num_elements, dtype, strategy, stream);
+}
+
+/*!
+ * \brief Customized all-reduce kernel backed by CUDA IPC memory.
+ * \param send The input tensor of all-reduce.
+ * \param strategy The all-reduce strategy. See AllReduceStrategyType for detail.
+ * When it is AUTO, the strategy tuned by "tune_custom_allreduce" is used if present.
+ * \param recv The output tensor of all-reduce.
+ */
+void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
+  int64_t num_elements = TensorSize(send);
+  nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
+  CHECK_EQ(ctx->worker->num_groups, 1)
+      << "Custom AllReduce for multiple group is not yet implemented.";
+
+  tensorrt_llm::AllReduceStrategyType strategy_ =
+      static_cast<tensorrt_llm::AllReduceStrategyType>(strategy);
+  if (strategy_ == tensorrt_llm::AllReduceStrategyType::AUTO) {
+    int64_t message_size = num_elements * ((send->dtype.bits * send->dtype.lanes + 7) / 8);
+    strategy_ = worker_tuning_table != nullptr
+                    ? worker_tuning_table->Select(message_size, ctx->worker->num_workers)
+                    : tensorrt_llm::SelectImplementation(message_size, ctx->worker->num_workers);
+  }
+  LaunchAllReduce(ctx, send->data, recv->data, num_elements, send->dtype, strategy_);
+}
+
+/*!
+ * \brief Benchmark the nccl, one-shot and two-shot all-reduce for each
+ * message-size bucket, and let the AUTO strategy of "custom_allreduce"
+ * pick the fastest one afterwards. It must be called on all workers.
+ * The result is cached per topology in the process.
+ * \param bucket_sizes The ascending upper bounds (in bytes) of the buckets.
+ * Each bucket is benchmarked at its upper bound.
+ * \param num_iters The number of timed iterations per strategy and bucket.
+ * \return The selected strategy of each bucket.
+ */
+ShapeTuple TuneCustomAllReduce(ShapeTuple bucket_sizes, int num_iters) {
+  using tensorrt_llm::AllReduceStrategyType;
+  nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
+  CHECK_EQ(ctx->worker->num_groups, 1)
+      << "Custom AllReduce for multiple group is not yet implemented.";
+  CHECK(std::is_sorted(bucket_sizes.begin(), bucket_sizes.end()))
+      << "The bucket sizes are expected to be in ascending order.";
+  CHECK_GT(num_iters, 0);
+  int num_workers = ctx->worker->num_workers;
+  int64_t num_buckets = bucket_sizes.size();
+  deviceStream_t stream = ctx->GetDefaultStream();
+
+  // All workers must agree on whether to reuse the cached table, since
+  // benchmarking issues collectives that every worker has to join.
+  std::string key = GetTopologyKey(ctx) + "/buckets=";
+  for (int64_t size : bucket_sizes) {
+    key += std::to_string(size) + ",";
+  }
+  const AllReduceTuningTable* cached = AllReduceTuningCache::Global()->Find(key);
+  float* d_scratch;
+  CUDA_CALL(cudaMalloc(&d_scratch, sizeof(float) * std::max<int64_t>(num_buckets * 3, 1)));
+  float hit = cached != nullptr;
+  CUDA_CALL(cudaMemcpyAsync(d_scratch, &hit, sizeof(float), cudaMemcpyHostToDevice, stream));
+  NCCL_CALL(ncclAllReduce(d_scratch, d_scratch, 1, ncclFloat32, ncclMin, ctx->global_comm, stream));
+  CUDA_CALL(cudaMemcpyAsync(&hit, d_scratch, sizeof(float), cudaMemcpyDeviceToHost, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+
+  if (hit == 0.0f) {
+    // Benchmark in float16, the common activation dtype.
+    DLDataType dtype = DataType::Float(16);
+    int64_t max_elements = 0;
+    for (int64_t size : bucket_sizes) {
+      max_elements = std::max(max_elements, size / 2);
+    }
+    // Round up so that both customized kernels apply at every benchmarked size.
+    int64_t align = 8 * num_workers;
+    max_elements = std::max<int64_t>((max_elements + align - 1) / align * align, align);
+    Device device{kDLCUDA, ctx->device_id};
+    memory::Allocator* allocator = CUDAIPCMemory::GlobalAllocator();
+    memory::Buffer send = allocator->Alloc(device, ShapeTuple({max_elements}), dtype,
+                                           /*mem_scope=*/"ipc_memory");
+    void* recv;
+    CUDA_CALL(cudaMalloc(&recv, max_elements * 2));
+    CUDA_CALL(cudaMemsetAsync(send.data, 0, max_elements * 2, stream));
+
+    cudaEvent_t start, stop;
+    CUDA_CALL(cudaEventCreate(&start));
+    CUDA_CALL(cudaEventCreate(&stop));
+    const AllReduceStrategyType strategies[3] = {AllReduceStrategyType::RING,
+                                                 AllReduceStrategyType::ONESHOT,
+                                                 AllReduceStrategyType::TWOSHOT};
+    std::vector<float> elapsed(num_buckets * 3, 0.0f);
+    size_t max_workspace = tensorrt_llm::GetMaxRequiredWorkspaceSize(num_workers);
+    for (int64_t i = 0; i < num_buckets; ++i) {
+      int64_t num_elements = std::max<int64_t>((bucket_sizes[i] / 2 + align - 1) / align * align,
+                                               align);
+      for (int j = 0; j < 3; ++j) {
+        if (j != 0 && static_cast<size_t>(num_elements * 2) > max_workspace) {
+          // The customized kernels cannot exceed the workspace size.
+          elapsed[i * 3 + j] = std::numeric_limits<float>::infinity();
+          continue;
+        }
+        // Warm up once before timing.
+        LaunchAllReduce(ctx, send.data, recv, num_elements, dtype, strategies[j]);
+        CUDA_CALL(cudaEventRecord(start, stream));
+        for (int k = 0; k < num_iters; ++k) {
+          LaunchAllReduce(ctx, send.data, recv, num_elements, dtype, strategies[j]);
+        }
+        CUDA_CALL(cudaEventRecord(stop, stream));
+        CUDA_CALL(cudaEventSynchronize(stop));
+        CUDA_CALL(cudaEventElapsedTime(&elapsed[i * 3 + j], start, stop));
+      }
+    }
+    CUDA_CALL(cudaEventDestroy(start));
+    CUDA_CALL(cudaEventDestroy(stop));
+    CUDA_CALL(cudaFree(recv));
+    allocator->Free(send);
+
+    // Take the slowest worker's time so that every worker selects the same strategy.
+    CUDA_CALL(cudaMemcpyAsync(d_scratch, elapsed.data(), sizeof(float) * elapsed.size(),
+                              cudaMemcpyHostToDevice, stream));
+    NCCL_CALL(ncclAllReduce(d_scratch, d_scratch, elapsed.size(), ncclFloat32, ncclMax,
+                            ctx->global_comm, stream));
+    CUDA_CALL(cudaMemcpyAsync(elapsed.data(), d_scratch, sizeof(float) * elapsed.size(),
+                              cudaMemcpyDeviceToHost, stream));
+    CUDA_CALL(cudaStreamSynchronize(stream));
+
+    AllReduceTuningTable table;
+    for (int64_t i = 0; i < num_buckets; ++i) {
+      int best = std::min_element(elapsed.begin() + i * 3, elapsed.begin() + i * 3 + 3) -
+                 (elapsed.begin() + i * 3);
+      table.buckets.emplace_back(bucket_sizes[i], strategies[best]);
+    }
+    cached = AllReduceTuningCache::Global()->Insert(key, std::move(table));
+  }
+  CUDA_CALL(cudaFree(d_scratch));
+  worker_tuning_table = cached;
+
+  std::vector<int64_t> selected;
+  selected.reserve(cached->buckets.size());
+  for (const auto& bucket : cached->buckets) {
+    selected.push_back(static_cast<int64_t>(bucket.second));
+  }
+  return ShapeTuple(selected);
 }
 
 TVM_REGISTER_GLOBAL("runtime.disco.cuda_ipc.custom_allreduce").set_body_typed(CustomAllReduce);
 
+TVM_REGISTER_GLOBAL("runtime.disco.cuda_ipc.tune_custom_allreduce")
+    .set_body_typed(TuneCustomAllReduce);
+
 }  // namespace cuda_ipc
 }  // namespace nccl
 }  // namespace runtime
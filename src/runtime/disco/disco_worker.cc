@@ -22,7 +22,11 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <optional>
+#include <string>
+
 #include "../../support/process_id.h"
+#include "../trace_recorder.h"
 #include "./protocol.h"
 
 namespace tvm {
@@ -49,57 +53,91 @@ void DiscoWorker::SetRegister(int reg_id, TVMArgValue value) {
 struct DiscoWorker::Impl {
   static void MainLoop(DiscoWorker* self) {
     ThreadLocalDiscoWorker::Get()->worker = self;
+    // Worker i records on process i + 1 of the trace, the controller being process 0.
+    std::string name = "disco worker " + std::to_string(self->worker_id);
+    profiling::TraceRecorder::SetCurrentThread(self->worker_id + 1, name);
+    profiling::TraceRecorder::Global()->SetProcessName(self->worker_id + 1, name);
     while (true) {
       TVMArgs args = self->channel->Recv();
-      DiscoAction action = static_cast<DiscoAction>(args[0].operator int());
-      int64_t reg_id = args[1];
-      switch (action) {
-        case DiscoAction::kShutDown: {
-          Shutdown(self);
-          return;
-        }
-        case DiscoAction::kKillReg: {
-          GetReg(self, reg_id) = nullptr;
-          break;
-        }
-        case DiscoAction::kGetGlobalFunc: {
-          GetGlobalFunc(self, reg_id, args[2]);
-          break;
-        }
-        case DiscoAction::kCallPacked: {
-          int func_reg_id = args[2];
-          CHECK_LT(func_reg_id, self->register_file.size());
-          PackedFunc func = GetReg(self, func_reg_id);
-          CHECK(func.defined());
-          CallPacked(self, reg_id, func,
-                     TVMArgs(args.values + 3, args.type_codes + 3, args.num_args - 3));
-          break;
-        }
-        case DiscoAction::kCopyFromWorker0: {
-          CopyFromWorker0(self, reg_id);
-          break;
-        }
-        case DiscoAction::kCopyToWorker0: {
-          CopyToWorker0(self, reg_id);
-          break;
-        }
-        case DiscoAction::kSyncWorker: {
-          SyncWorker(self, reg_id);
-          break;
-        }
-        case DiscoAction::kDebugGetFromRemote: {
-          int worker_id = args[2];
-          DebugGetFromRemote(self, reg_id, worker_id);
-          break;
-        }
-        case DiscoAction::kDebugSetRegister: {
-          int worker_id = args[2];
-          TVMArgValue value = args[3];
-          DebugSetRegister(self, reg_id, worker_id, value);
-          break;
+      if (!HandleAction(self, args)) {
+        return;
+      }
+    }
+  }
+
+  /*!
+   * \brief Execute one command received from the controler.
+   * \return false if the worker should shut down.
+   */
+  static bool HandleAction(DiscoWorker* self, TVMArgs args) {
+    DiscoAction action = static_cast<DiscoAction>(args[0].operator int());
+    int64_t reg_id = args[1];
+    // The commands of a batch are recorded one by one.
+    std::optional<profiling::TraceScope> trace_scope;
+    if (action != DiscoAction::kBatch && profiling::TraceRecorder::Global()->enabled()) {
+      trace_scope.emplace(DiscoAction2String(action), "disco");
+    }
+    switch (action) {
+      case DiscoAction::kShutDown: {
+        Shutdown(self);
+        return false;
+      }
+      case DiscoAction::kKillReg: {
+        GetReg(self, reg_id) = nullptr;
+        break;
+      }
+      case DiscoAction::kGetGlobalFunc: {
+        GetGlobalFunc(self, reg_id, args[2]);
+        break;
+      }
+      case DiscoAction::kCallPacked: {
+        int func_reg_id = args[2];
+        CHECK_LT(func_reg_id, self->register_file.size());
+        PackedFunc func = GetReg(self, func_reg_id);
+        CHECK(func.defined());
+        CallPacked(self, reg_id, func,
+                   TVMArgs(args.values + 3, args.type_codes + 3, args.num_args - 3));
+        break;
+      }
+      case DiscoAction::kCopyFromWorker0: {
+        CopyFromWorker0(self, reg_id);
+        break;
+      }
+      case DiscoAction::kCopyToWorker0: {
+        CopyToWorker0(self, reg_id);
+        break;
+      }
+      case DiscoAction::kSyncWorker: {
+        SyncWorker(self, reg_id);
+        break;
+      }
+      case DiscoAction::kDebugGetFromRemote: {
+        int worker_id = args[2];
+        DebugGetFromRemote(self, reg_id, worker_id);
+        break;
+      }
+      case DiscoAction::kDebugSetRegister: {
+        int worker_id = args[2];
+        TVMArgValue value = args[3];
+        DebugSetRegister(self, reg_id, worker_id, value);
+        break;
+      }
+      case DiscoAction::kBatch: {
+        // The second element is the number of commands, each prefixed by its number of arguments.
+        int offset = 2;
+        for (int64_t i = 0; i < reg_id; ++i) {
+          int num_args = args[offset];
+          ICHECK_LE(offset + 1 + num_args, args.num_args);
+          TVMArgs command(args.values + offset + 1, args.type_codes + offset + 1, num_args);
+          offset += 1 + num_args;
+          if (!HandleAction(self, command)) {
+            return false;
+          }
         }
+        break;
       }
     }
+    return true;
   }
 
   static void Shutdown(DiscoWorker* self) {}
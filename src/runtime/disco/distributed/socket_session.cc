@@ -99,6 +99,7 @@ class SocketSessionObj : public BcastSessionObj {
   int64_t GetNumWorkers() final { return num_nodes_ * num_workers_per_node_; }
 
   TVMRetValue DebugGetFromRemote(int64_t reg_id, int worker_id) final {
+    this->FlushBatch();
     int node_id = worker_id / num_workers_per_node_;
     if (node_id == 0) {
       return local_session_->DebugGetFromRemote(reg_id, worker_id);
@@ -119,6 +120,7 @@ class SocketSessionObj : public BcastSessionObj {
   }
 
   void DebugSetRegister(int64_t reg_id, TVMArgValue value, int worker_id) final {
+    this->FlushBatch();
     int node_id = worker_id / num_workers_per_node_;
     if (node_id == 0) {
       local_session_->DebugSetRegister(reg_id, value, worker_id);
@@ -323,6 +325,13 @@ TVM_REGISTER_GLOBAL("runtime.disco.socket_session_init_workers")
       LOG(INFO) << "Initializing worker group with " << num_nodes << " nodes, "
                 << num_workers_per_node << " workers per node, and " << num_groups << " groups.";
       DiscoWorker* worker = DiscoWorker::ThreadLocal();
+      int group_size = num_nodes * num_workers_per_node / num_groups;
+      if (worker->worker_id == 0 && group_size % num_workers_per_node != 0 &&
+          num_workers_per_node % group_size != 0) {
+        LOG(WARNING) << "Worker groups of size " << group_size << " do not align with the "
+                     << num_workers_per_node << " workers per node, so the in-group collectives "
+                     << "of some groups have to cross nodes";
+      }
       worker->num_groups = num_groups;
       worker->worker_id = worker->worker_id + node_id * num_workers_per_node;
       worker->num_workers = num_nodes * num_workers_per_node;
@@ -126,6 +126,16 @@ class ShardLoaderObj : public Object {
   /*! \brief Load all the parameters */
   Array<NDArray> LoadAll() const;
 
+  /*!
+   * \brief Load the i-th parameter on the current worker only, without any communication.
+   * Each worker reads the parameter from its own mapping of the file, applies the shard
+   * functions, and keeps its own shard. It requires every worker to have access to the files.
+   */
+  NDArray LoadLocal(int weight_index) const;
+
+  /*! \brief Load all the parameters on each worker in parallel, see LoadLocal */
+  Array<NDArray> LoadAllLocal() const;
+
   NDArray ApplyShardFunc(const ShardInfo::ShardFunc& shard_func, const NDArray& param) const;
 
   /*! \brief Load all the pre-sharded parameters */
@@ -158,7 +168,7 @@ class ShardLoaderObj : public Object {
   /*! \brief The current file opened to load weights in it */
   mutable const FileRecord* current_file_;
   /*! \brief The context of the current file to be loaded from */
-  mutable std::string current_file_stream_;
+  mutable MappedFile current_file_stream_;
 
  private:
   /*! \brief Load the i-th parameter without post-processing
@@ -252,9 +262,10 @@ NDArray ShardLoaderObj::LoadParamOnWorker0(int weight_index) const {
     if (file != current_file_) {
       current_file_ = file;
       std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-      LoadBinaryFromFile(file_name, &this->current_file_stream_);
+      this->current_file_stream_ = MappedFile::Open(file_name);
     }
-    return param->Load(device, &this->current_file_stream_);
+    return param->Load(device, this->current_file_stream_->data(), nullptr,
+                       this->current_file_stream_);
   };
 
   if (worker_id == 0) {
@@ -299,9 +310,9 @@ NDArray ShardLoaderObj::LoadDirect(int weight_index) const {
   if (file != current_file_) {
     current_file_ = file;
     std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-    LoadBinaryFromFile(file_name, &this->current_file_stream_);
+    current_file_stream_ = MappedFile::Open(file_name);
   }
-  return param->Load(device, &this->current_file_stream_);
+  return param->Load(device, current_file_stream_->data(), nullptr, current_file_stream_);
 }
 
 NDArray ShardLoaderObj::Load(int weight_index) const {
@@ -357,6 +368,49 @@ Array<NDArray> ShardLoaderObj::LoadAll() const {
   return shards;
 }
 
+NDArray ShardLoaderObj::LoadLocal(int weight_index) const {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  int worker_id = worker->worker_id;
+  int num_shards = worker->num_workers;
+  Device device = worker->default_device;
+  const ParamInfo& param_info = param_info_.at(weight_index);
+
+  NDArray w = LoadDirect(weight_index);
+  if (param_info.shard_info.funcs.empty()) {
+    return w;
+  }
+  for (const ShardInfo::ShardFunc& shard_func : param_info.shard_info.funcs) {
+    w = this->ApplyShardFunc(shard_func, w);
+  }
+  ShapeTuple shape = w.Shape();
+  ICHECK(shape.size() >= 1 && shape[0] == num_shards)
+      << "ValueError: The first dimension of the "
+      << "output shape must be equal to the "
+      << "number of shards, but got: " << shape << " and num_shards = " << num_shards;
+  // The shards are laid out contiguously along the first dimension, so the shard of this worker
+  // is a sub-tensor at a byte offset.
+  NDArray recv = NDArray::Empty(ShapeTuple(shape.begin() + 1, shape.end()), w.DataType(), device);
+  DLTensor shard = *w.operator->();
+  shard.ndim -= 1;
+  shard.shape += 1;
+  shard.byte_offset += static_cast<uint64_t>(worker_id) * GetDataSize(*recv.operator->());
+  recv.CopyFrom(&shard);
+  return recv;
+}
+
+Array<NDArray> ShardLoaderObj::LoadAllLocal() const {
+  int n = static_cast<int>(param_info_.size());
+  Array<NDArray> shards;
+  shards.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    std::string param_name = "param_" + std::to_string(i);
+    ICHECK(this->param_name_to_index_.count(param_name));
+    int shard_id = this->param_name_to_index_.at(param_name);
+    shards.push_back(this->LoadLocal(shard_id));
+  }
+  return shards;
+}
+
 NDArray ShardLoaderObj::LoadPresharded(int weight_index) const {
   DiscoWorker* worker = DiscoWorker::ThreadLocal();
   int worker_id = worker->worker_id;
@@ -429,6 +483,22 @@ TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadAll").set_body_typed([](Object
   return loader->LoadAll();
 });
 
+TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadLocal")
+    .set_body_typed([](ObjectRef loader_obj, ShapeTuple weight_index) {
+      const auto* loader = loader_obj.as<ShardLoaderObj>();
+      CHECK(loader != nullptr) << "TypeError: Expected ShardLoaderObj, but gets: "
+                               << loader_obj->GetTypeKey();
+      return loader->LoadLocal(IntegerFromShapeTuple(weight_index));
+    });
+
+TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadAllLocal")
+    .set_body_typed([](ObjectRef loader_obj) {
+      const auto* loader = loader_obj.as<ShardLoaderObj>();
+      CHECK(loader != nullptr) << "TypeError: Expected ShardLoaderObj, but gets: "
+                               << loader_obj->GetTypeKey();
+      return loader->LoadAllLocal();
+    });
+
 TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadAllPresharded")
     .set_body_typed([](ObjectRef loader_obj) {
       const auto* loader = loader_obj.as<ShardLoaderObj>();
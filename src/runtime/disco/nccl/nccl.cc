@@ -17,6 +17,7 @@
  * under the License.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <mutex>
 #include <sstream>
@@ -63,6 +64,42 @@ void InitCCL(Session sess, IntTuple device_ids) {
   sess->CallPacked(func, device_ids, array);
 }
 
+IntTuple GroupDevicesByTopology(IntTuple device_ids, int group_size) {
+  CHECK_GT(group_size, 0) << "ValueError: The group size must be positive, but got " << group_size;
+  // Split the devices into islands in which every pair has peer access, e.g. over NVLink.
+  std::vector<std::vector<int64_t>> islands;
+  for (int64_t device_id : device_ids) {
+    bool placed = false;
+    for (std::vector<int64_t>& island : islands) {
+      bool connected = std::all_of(island.begin(), island.end(), [&](int64_t peer) {
+        return DeviceCanAccessPeer(device_id, peer) && DeviceCanAccessPeer(peer, device_id);
+      });
+      if (connected) {
+        island.push_back(device_id);
+        placed = true;
+        break;
+      }
+    }
+    if (!placed) {
+      islands.push_back({device_id});
+    }
+  }
+  // Place the largest islands first, so that as many groups as possible fit in one island.
+  std::stable_sort(islands.begin(), islands.end(),
+                   [](const auto& a, const auto& b) { return a.size() > b.size(); });
+  std::vector<int64_t> result;
+  result.reserve(device_ids.size());
+  for (const std::vector<int64_t>& island : islands) {
+    if (island.size() % group_size != 0) {
+      LOG(WARNING) << "The " << island.size() << " devices connected by peer access cannot be "
+                   << "split into groups of " << group_size
+                   << ", so some groups communicate across the host interconnect";
+    }
+    result.insert(result.end(), island.begin(), island.end());
+  }
+  return IntTuple(result);
+}
+
 void InitCCLPerWorker(IntTuple device_ids, std::string unique_id_bytes) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   DiscoWorker* worker = DiscoWorker::ThreadLocal();
@@ -126,6 +163,46 @@ void AllGather(NDArray send, bool in_group, NDArray recv) {
                           in_group ? ctx->group_comm : ctx->global_comm, stream));
 }
 
+/*! \brief Record the completion of a collective just issued on the communication stream. */
+ObjectRef MakePending(CCLThreadLocalContext* ctx, Array<NDArray> buffers) {
+  ObjectPtr<CCLPendingObj> pending = make_object<CCLPendingObj>();
+  EventCreate(&pending->done_event);
+  EventRecord(pending->done_event, ctx->comm_stream);
+  pending->buffers = std::move(buffers);
+  return ObjectRef(pending);
+}
+
+ObjectRef AllReduceAsync(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  ShapeTuple shape = send.Shape();
+  int64_t numel = shape->Product();
+  deviceStream_t stream = ctx->GetCommStream();
+  NCCL_CALL(ncclAllReduce(send->data, recv->data, numel,
+                          /*datatype=*/AsNCCLDataType(DataType(send->dtype)),
+                          /*op=*/AsNCCLRedOp(reduce_kind),
+                          in_group ? ctx->group_comm : ctx->global_comm, stream));
+  return MakePending(ctx, {send, recv});
+}
+
+ObjectRef AllGatherAsync(NDArray send, bool in_group, NDArray recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  ShapeTuple shape = send.Shape();
+  int64_t numel = shape->Product();
+  deviceStream_t stream = ctx->GetCommStream();
+  NCCL_CALL(ncclAllGather(send->data, recv->data, numel,
+                          /*datatype=*/AsNCCLDataType(DataType(send->dtype)),
+                          in_group ? ctx->group_comm : ctx->global_comm, stream));
+  return MakePending(ctx, {send, recv});
+}
+
+void WaitCollective(ObjectRef handle) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  const auto* pending = handle.as<CCLPendingObj>();
+  CHECK(pending != nullptr) << "TypeError: Expect a handle returned by an async collective, but got "
+                            << handle->GetTypeKey();
+  StreamWaitEvent(ctx->GetDefaultStream(), pending->done_event);
+}
+
 void BroadcastFromWorker0(Optional<NDArray> send, bool in_group, NDArray recv) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   int worker_id = ctx->worker->worker_id;
@@ -310,12 +387,20 @@ void SyncWorker() {
   ICHECK(ctx->worker != nullptr);
   deviceStream_t stream = ctx->GetDefaultStream();
   StreamSynchronize(stream);
+  if (ctx->comm_stream) {
+    // Async collectives that nobody waited on must still be done when the worker is synced.
+    StreamSynchronize(ctx->comm_stream);
+  }
 }
 
+TVM_REGISTER_OBJECT_TYPE(CCLPendingObj);
+
 TVM_REGISTER_GLOBAL("runtime.disco.compiled_ccl").set_body_typed([]() -> String {
   return TVM_DISCO_CCL_NAME;
 });
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".init_ccl").set_body_typed(InitCCL);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".group_devices_by_topology")
+    .set_body_typed(GroupDevicesByTopology);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".init_ccl_per_worker")
     .set_body_typed(InitCCLPerWorker);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce")
@@ -327,6 +412,15 @@ TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allgather")
     .set_body_typed([](NDArray send, bool in_group, NDArray recv) {
       nccl::AllGather(send, in_group, recv);
     });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce_async")
+    .set_body_typed([](NDArray send, int kind, bool in_group, NDArray recv) {
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      return nccl::AllReduceAsync(send, static_cast<ReduceKind>(kind), in_group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allgather_async")
+    .set_body_typed(AllGatherAsync);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".wait_collective")
+    .set_body_typed(WaitCollective);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".broadcast_from_worker0")
     .set_body_typed(BroadcastFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".scatter_from_worker0")
@@ -22,8 +22,10 @@
 
 #include <dlpack/dlpack.h>
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/container/array.h>
 #include <tvm/runtime/disco/builtin.h>
 #include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
 #include "../../../support/process_id.h"
@@ -66,6 +68,26 @@ inline void SetDevice(int device_id) { CUDA_CALL(cudaSetDevice(device_id)); }
 inline void StreamSynchronize(deviceStream_t stream) { CUDA_CALL(cudaStreamSynchronize(stream)); }
 inline void StreamCreate(deviceStream_t* stream) { CUDA_CALL(cudaStreamCreate(stream)); }
 inline void StreamDestroy(deviceStream_t stream) { CUDA_CALL(cudaStreamDestroy(stream)); }
+inline void StreamCreateNonBlocking(deviceStream_t* stream) {
+  CUDA_CALL(cudaStreamCreateWithFlags(stream, cudaStreamNonBlocking));
+}
+inline bool DeviceCanAccessPeer(int device_id, int peer_device_id) {
+  int can_access = 0;
+  CUDA_CALL(cudaDeviceCanAccessPeer(&can_access, device_id, peer_device_id));
+  return can_access != 0;
+}
+
+using deviceEvent_t = cudaEvent_t;
+inline void EventCreate(deviceEvent_t* event) {
+  CUDA_CALL(cudaEventCreateWithFlags(event, cudaEventDisableTiming));
+}
+inline void EventDestroy(deviceEvent_t event) { CUDA_CALL(cudaEventDestroy(event)); }
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  CUDA_CALL(cudaEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  CUDA_CALL(cudaStreamWaitEvent(stream, event, 0));
+}
 
 #else
 
@@ -78,6 +100,26 @@ inline void SetDevice(int device_id) { ROCM_CALL(hipSetDevice(device_id)); }
 inline void StreamSynchronize(deviceStream_t stream) { ROCM_CALL(hipStreamSynchronize(stream)); }
 inline void StreamCreate(deviceStream_t* stream) { ROCM_CALL(hipStreamCreate(stream)); }
 inline void StreamDestroy(deviceStream_t stream) { ROCM_CALL(hipStreamDestroy(stream)); }
+inline void StreamCreateNonBlocking(deviceStream_t* stream) {
+  ROCM_CALL(hipStreamCreateWithFlags(stream, hipStreamNonBlocking));
+}
+inline bool DeviceCanAccessPeer(int device_id, int peer_device_id) {
+  int can_access = 0;
+  ROCM_CALL(hipDeviceCanAccessPeer(&can_access, device_id, peer_device_id));
+  return can_access != 0;
+}
+
+using deviceEvent_t = hipEvent_t;
+inline void EventCreate(deviceEvent_t* event) {
+  ROCM_CALL(hipEventCreateWithFlags(event, hipEventDisableTiming));
+}
+inline void EventDestroy(deviceEvent_t event) { ROCM_CALL(hipEventDestroy(event)); }
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  ROCM_CALL(hipEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  ROCM_CALL(hipStreamWaitEvent(stream, event, 0));
+}
 
 #endif
 
@@ -117,10 +159,35 @@ inline ncclDataType_t AsNCCLDataType(runtime::DataType dtype) {
   throw;
 }
 
+/*!
+ * \brief A collective started on the communication stream, returned by the async built-ins.
+ * It keeps the buffers of the collective alive until it is destructed.
+ */
+class CCLPendingObj : public Object {
+ public:
+  /*! \brief Recorded on the communication stream after the collective. */
+  deviceEvent_t done_event = nullptr;
+  /*! \brief The buffers used by the collective. */
+  Array<NDArray> buffers;
+
+  ~CCLPendingObj() {
+    if (done_event) {
+      EventDestroy(done_event);
+    }
+  }
+
+  static constexpr const char* _type_key = "runtime.disco." TVM_DISCO_CCL_NAME ".Pending";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CCLPendingObj, Object);
+};
+
 struct CCLThreadLocalContext {
   DiscoWorker* worker = nullptr;
   int device_id;
   deviceStream_t default_stream = nullptr;
+  /*! \brief The stream on which the async collectives run, created on first use. */
+  deviceStream_t comm_stream = nullptr;
+  /*! \brief Records the compute stream before an async collective, to order it after. */
+  deviceEvent_t comm_ready_event = nullptr;
   ncclComm_t global_comm = nullptr;
   ncclComm_t group_comm = nullptr;
 
@@ -139,6 +206,14 @@ struct CCLThreadLocalContext {
       StreamDestroy(default_stream);
       default_stream = nullptr;
     }
+    if (comm_ready_event) {
+      EventDestroy(comm_ready_event);
+      comm_ready_event = nullptr;
+    }
+    if (comm_stream) {
+      StreamDestroy(comm_stream);
+      comm_stream = nullptr;
+    }
     worker = nullptr;
   }
 
@@ -149,6 +224,20 @@ struct CCLThreadLocalContext {
     return stream == nullptr ? default_stream : stream;
   }
 
+  /*!
+   * \brief Get the communication stream, ordered after the work queued so far on the compute
+   * stream.
+   */
+  deviceStream_t GetCommStream() {
+    if (comm_stream == nullptr) {
+      StreamCreateNonBlocking(&comm_stream);
+      EventCreate(&comm_ready_event);
+    }
+    EventRecord(comm_ready_event, GetDefaultStream());
+    StreamWaitEvent(comm_stream, comm_ready_event);
+    return comm_stream;
+  }
+
   static CCLThreadLocalContext* Get();
 };
 
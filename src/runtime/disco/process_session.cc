@@ -22,8 +22,10 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <cstdlib>
 #include <memory>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -33,6 +35,7 @@
 #include "./disco_worker_thread.h"
 #include "./message_queue.h"
 #include "./protocol.h"
+#include "./shm_message_queue.h"
 
 namespace tvm {
 namespace runtime {
@@ -43,20 +46,105 @@ class DiscoProcessChannel final : public DiscoChannel {
       : controller_to_worker_pipe_(controler_to_worker_fd),
         worker_to_controller_pipe_(worker_to_controler_fd),
         controler_to_worker_(&controller_to_worker_pipe_),
-        worker_to_controler_(&worker_to_controller_pipe_) {}
+        worker_to_controler_(&worker_to_controller_pipe_),
+        controler_to_worker_fd_(controler_to_worker_fd),
+        worker_to_controler_fd_(worker_to_controler_fd) {}
 
   DiscoProcessChannel(DiscoProcessChannel&& other) = delete;
   DiscoProcessChannel(const DiscoProcessChannel& other) = delete;
 
-  void Send(const TVMArgs& args) { controler_to_worker_.Send(args); }
-  TVMArgs Recv() { return controler_to_worker_.Recv(); }
-  void Reply(const TVMArgs& args) { worker_to_controler_.Send(args); }
-  TVMArgs RecvReply() { return worker_to_controler_.Recv(); }
+  void Send(const TVMArgs& args) { ToWorker()->Send(args); }
+  TVMArgs Recv() { return ToWorker()->Recv(); }
+  void Reply(const TVMArgs& args) { ToController()->Send(args); }
+  TVMArgs RecvReply() { return ToController()->Recv(); }
+
+  /*!
+   * \brief Controller side of the transport handshake. Offers a shared memory channel to the
+   * worker, or an empty path if it is unavailable or disabled by `TVM_DISCO_SHM=0`.
+   * It must be followed by FinishTransportHandshake.
+   * \param worker_id The id of the worker at the other end.
+   */
+  void OfferTransport(int worker_id) {
+    std::string path;
+#ifdef __linux__
+    const char* env = std::getenv("TVM_DISCO_SHM");
+    if (env == nullptr || std::string(env) != "0") {
+      shm_ = ShmChannel::Create(worker_id, worker_to_controler_fd_);
+      if (shm_ != nullptr) path = shm_->path();
+    }
+#endif
+    TVMValue value;
+    int type_code;
+    TVMArgsSetter(&value, &type_code)(0, path);
+    controler_to_worker_.Send(TVMArgs(&value, &type_code, 1));
+  }
+
+  /*! \brief Wait for the worker to accept or decline the offered transport. */
+  void FinishTransportHandshake() {
+    TVMArgs reply = worker_to_controler_.Recv();
+    bool accepted = reply.size() == 1 && reply[0].operator bool();
+#ifdef __linux__
+    if (shm_ != nullptr) {
+      // Both sides hold a mapping by now, so the file is no longer needed.
+      unlink(shm_->path().c_str());
+      if (accepted) {
+        UseSharedMemory(/*is_controller=*/true);
+      } else {
+        shm_.reset();
+      }
+    }
+#endif
+  }
+
+  /*! \brief Worker side of the transport handshake. */
+  void AcceptTransport() {
+    std::string path = controler_to_worker_.Recv()[0].operator std::string();
+    bool accepted = false;
+#ifdef __linux__
+    if (!path.empty()) {
+      shm_ = ShmChannel::Open(path, controler_to_worker_fd_);
+      accepted = shm_ != nullptr;
+    }
+#endif
+    TVMValue value;
+    int type_code;
+    TVMArgsSetter(&value, &type_code)(0, accepted);
+    worker_to_controler_.Send(TVMArgs(&value, &type_code, 1));
+#ifdef __linux__
+    if (accepted) UseSharedMemory(/*is_controller=*/false);
+#endif
+  }
+
+ private:
+  DiscoStreamMessageQueue* ToWorker() {
+    return shm_controler_to_worker_ ? shm_controler_to_worker_.get() : &controler_to_worker_;
+  }
+
+  DiscoStreamMessageQueue* ToController() {
+    return shm_worker_to_controler_ ? shm_worker_to_controler_.get() : &worker_to_controler_;
+  }
+
+#ifdef __linux__
+  void UseSharedMemory(bool is_controller) {
+    ShmRingStream* to_worker = is_controller ? shm_->send_stream() : shm_->recv_stream();
+    ShmRingStream* to_controller = is_controller ? shm_->recv_stream() : shm_->send_stream();
+    shm_controler_to_worker_ = std::make_unique<DiscoStreamMessageQueue>(to_worker);
+    shm_worker_to_controler_ = std::make_unique<DiscoStreamMessageQueue>(to_controller);
+  }
+#endif
 
   support::Pipe controller_to_worker_pipe_;
   support::Pipe worker_to_controller_pipe_;
   DiscoStreamMessageQueue controler_to_worker_;
   DiscoStreamMessageQueue worker_to_controler_;
+  int64_t controler_to_worker_fd_;
+  int64_t worker_to_controler_fd_;
+#ifdef __linux__
+  /*! \brief The shared memory transport, which replaces the pipes once the handshake succeeds. */
+  std::unique_ptr<ShmChannel> shm_;
+#endif
+  std::unique_ptr<DiscoStreamMessageQueue> shm_controler_to_worker_;
+  std::unique_ptr<DiscoStreamMessageQueue> shm_worker_to_controler_;
 };
 
 class ProcessSessionObj final : public BcastSessionObj {
@@ -78,6 +166,10 @@ class ProcessSessionObj final : public BcastSessionObj {
     }
     for (int i = 0; i < num_workers - 1; ++i) {
       workers_.emplace_back(std::make_unique<DiscoProcessChannel>(write_fds[i], read_fds[i]));
+      workers_.back()->OfferTransport(i + 1);
+    }
+    for (std::unique_ptr<DiscoProcessChannel>& channel : workers_) {
+      channel->FinishTransportHandshake();
     }
   }
 
@@ -95,6 +187,7 @@ class ProcessSessionObj final : public BcastSessionObj {
   int64_t GetNumWorkers() { return workers_.size() + 1; }
 
   TVMRetValue DebugGetFromRemote(int64_t reg_id, int worker_id) {
+    this->FlushBatch();
     if (worker_id == 0) {
       this->SyncWorker(worker_id);
       return worker_0_->worker->register_file.at(reg_id);
@@ -115,6 +208,7 @@ class ProcessSessionObj final : public BcastSessionObj {
   }
 
   void DebugSetRegister(int64_t reg_id, TVMArgValue value, int worker_id) {
+    this->FlushBatch();
     if (worker_id == 0) {
       this->SyncWorker(worker_id);
       worker_0_->worker->SetRegister(reg_id, value);
@@ -198,6 +292,7 @@ void WorkerProcess(int worker_id, int num_workers, int num_group, int64_t read_f
   CHECK_EQ(num_workers % num_group, 0)
       << "The number of workers should be divisible by the number of worker group.";
   DiscoProcessChannel channel(read_fd, write_fd);
+  channel.AcceptTransport();
   DiscoWorker worker(worker_id, num_workers, num_group, nullptr, &channel);
   worker.MainLoop();
 }
@@ -56,6 +56,10 @@ TVM_REGISTER_GLOBAL("runtime.disco.SessionCallPacked").set_body([](TVMArgs args,
 });
 TVM_REGISTER_GLOBAL("runtime.disco.SessionShutdown")
     .set_body_method<Session>(&SessionObj::Shutdown);
+TVM_REGISTER_GLOBAL("runtime.disco.SessionBeginBatch")
+    .set_body_method<Session>(&SessionObj::BeginBatch);
+TVM_REGISTER_GLOBAL("runtime.disco.SessionEndBatch")
+    .set_body_method<Session>(&SessionObj::EndBatch);
 
 }  // namespace runtime
 }  // namespace tvm
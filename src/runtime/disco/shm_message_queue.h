@@ -0,0 +1,328 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file shm_message_queue.h
+ * \brief Shared-memory byte streams between the controller and a worker process on the same host.
+ *
+ * Each direction is a single-producer single-consumer ring buffer living in a file under
+ * /dev/shm that both processes map. The producer copies bytes into the ring and only issues a
+ * futex wake when the consumer is parked, so a steady stream of messages costs no syscalls.
+ * The consumer spins briefly before parking on the futex, and periodically checks the original
+ * pipe for a hang-up so that it notices a peer that exited without closing the ring.
+ */
+#ifndef TVM_RUNTIME_DISCO_SHM_MESSAGE_QUEUE_H_
+#define TVM_RUNTIME_DISCO_SHM_MESSAGE_QUEUE_H_
+
+#ifdef __linux__
+#include <dmlc/io.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <tvm/runtime/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief The control block of one direction of the shared memory channel.
+ * The producer-owned and consumer-owned fields live on separate cache lines.
+ */
+struct ShmRingHeader {
+  /*! \brief Total number of bytes ever written, owned by the producer. */
+  alignas(64) std::atomic<uint64_t> write_pos;
+  /*! \brief Futex word bumped by the producer when it wakes a parked consumer. */
+  std::atomic<uint32_t> write_seq;
+  /*! \brief Nonzero when the producer closed the ring. */
+  std::atomic<uint32_t> closed;
+  /*! \brief Total number of bytes ever read, owned by the consumer. */
+  alignas(64) std::atomic<uint64_t> read_pos;
+  /*! \brief Futex word bumped by the consumer when it wakes a parked producer. */
+  std::atomic<uint32_t> read_seq;
+  /*! \brief Nonzero when the consumer is parked, or about to park, on write_seq. */
+  alignas(64) std::atomic<uint32_t> consumer_waiting;
+  /*! \brief Nonzero when the producer is parked, or about to park, on read_seq. */
+  std::atomic<uint32_t> producer_waiting;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "The shared memory ring requires address-free atomics");
+
+/*!
+ * \brief One direction of the shared memory channel, exposed as a blocking byte stream.
+ * Only one side may write and only the other side may read.
+ */
+class ShmRingStream : public dmlc::Stream {
+ public:
+  /*!
+   * \param header The control block inside the shared mapping.
+   * \param data The data area inside the shared mapping.
+   * \param capacity The size of the data area in bytes.
+   * \param peer_fd The pipe to the peer, polled for a hang-up while waiting.
+   */
+  ShmRingStream(ShmRingHeader* header, char* data, uint64_t capacity, int peer_fd)
+      : header_(header), data_(data), capacity_(capacity), peer_fd_(peer_fd) {}
+
+  using Stream::Read;
+  using Stream::Write;
+
+  /*!
+   * \brief Read exactly `size` bytes, blocking until they are available.
+   * \return The number of bytes read, which is only short if the producer is gone.
+   */
+  size_t Read(void* ptr, size_t size) final {
+    char* dst = static_cast<char*>(ptr);
+    size_t nread = 0;
+    uint64_t read_pos = header_->read_pos.load(std::memory_order_relaxed);
+    while (nread < size) {
+      uint64_t avail = header_->write_pos.load(std::memory_order_acquire) - read_pos;
+      if (avail == 0) {
+        if (!WaitFor([&]() {
+              return header_->write_pos.load(std::memory_order_seq_cst) != read_pos;
+            }, &header_->consumer_waiting, &header_->write_seq)) {
+          break;
+        }
+        continue;
+      }
+      uint64_t n = std::min<uint64_t>(avail, size - nread);
+      CopyOut(read_pos, dst + nread, n);
+      read_pos += n;
+      nread += n;
+      header_->read_pos.store(read_pos, std::memory_order_seq_cst);
+      Notify(&header_->producer_waiting, &header_->read_seq);
+    }
+    return nread;
+  }
+
+  /*! \brief Write all `size` bytes, blocking while the ring is full. */
+  size_t Write(const void* ptr, size_t size) final {
+    const char* src = static_cast<const char*>(ptr);
+    size_t nwrite = 0;
+    uint64_t write_pos = header_->write_pos.load(std::memory_order_relaxed);
+    while (nwrite < size) {
+      uint64_t space = capacity_ - (write_pos - header_->read_pos.load(std::memory_order_acquire));
+      if (space == 0) {
+        CHECK(WaitFor([&]() {
+          return header_->read_pos.load(std::memory_order_seq_cst) + capacity_ != write_pos;
+        }, &header_->producer_waiting, &header_->read_seq))
+            << "Disco worker process exited while a message was being sent";
+        continue;
+      }
+      uint64_t n = std::min<uint64_t>(space, size - nwrite);
+      CopyIn(write_pos, src + nwrite, n);
+      write_pos += n;
+      nwrite += n;
+      header_->write_pos.store(write_pos, std::memory_order_seq_cst);
+      Notify(&header_->consumer_waiting, &header_->write_seq);
+    }
+    return nwrite;
+  }
+
+  /*! \brief Mark the ring closed and wake the consumer, called by the producer. */
+  void Close() {
+    header_->closed.store(1, std::memory_order_seq_cst);
+    header_->write_seq.fetch_add(1, std::memory_order_seq_cst);
+    FutexWake(&header_->write_seq);
+  }
+
+ private:
+  void CopyIn(uint64_t pos, const char* src, uint64_t n) {
+    uint64_t offset = pos % capacity_;
+    uint64_t first = std::min(n, capacity_ - offset);
+    std::memcpy(data_ + offset, src, first);
+    std::memcpy(data_, src + first, n - first);
+  }
+
+  void CopyOut(uint64_t pos, char* dst, uint64_t n) {
+    uint64_t offset = pos % capacity_;
+    uint64_t first = std::min(n, capacity_ - offset);
+    std::memcpy(dst, data_ + offset, first);
+    std::memcpy(dst + first, data_, n - first);
+  }
+
+  /*!
+   * \brief Wait until `ready()` holds, spinning first and then parking on `seq`.
+   * \return false if the peer closed the ring or hung up the pipe before `ready()` held.
+   */
+  template <typename FReady>
+  bool WaitFor(FReady ready, std::atomic<uint32_t>* waiting, std::atomic<uint32_t>* seq) {
+    // Spinning only pays off when the peer can run concurrently.
+    static const int spin_count = std::thread::hardware_concurrency() > 1 ? 4096 : 0;
+    for (int i = 0; i < spin_count; ++i) {
+      if (ready()) return true;
+    }
+    while (true) {
+      uint32_t cur_seq = seq->load(std::memory_order_seq_cst);
+      waiting->store(1, std::memory_order_seq_cst);
+      // Re-check after announcing the wait, so that a concurrent update either is visible here
+      // or observes `waiting` and bumps `seq`.
+      if (ready()) {
+        waiting->store(0, std::memory_order_relaxed);
+        return true;
+      }
+      if (header_->closed.load(std::memory_order_acquire) || PeerHungUp()) {
+        waiting->store(0, std::memory_order_relaxed);
+        return false;
+      }
+      FutexWait(seq, cur_seq);
+      waiting->store(0, std::memory_order_relaxed);
+      if (ready()) return true;
+    }
+  }
+
+  static void Notify(std::atomic<uint32_t>* waiting, std::atomic<uint32_t>* seq) {
+    if (waiting->load(std::memory_order_seq_cst)) {
+      seq->fetch_add(1, std::memory_order_seq_cst);
+      FutexWake(seq);
+    }
+  }
+
+  static void FutexWait(std::atomic<uint32_t>* addr, uint32_t expected) {
+    // Bounded so that a peer that died without closing the ring is noticed through the pipe.
+    struct timespec timeout {0, 100 * 1000 * 1000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected, &timeout, nullptr,
+            0);
+  }
+
+  static void FutexWake(std::atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+  }
+
+  bool PeerHungUp() const {
+    struct pollfd pfd{peer_fd_, POLLIN, 0};
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL));
+  }
+
+  ShmRingHeader* header_;
+  char* data_;
+  uint64_t capacity_;
+  int peer_fd_;
+};
+
+/*!
+ * \brief A pair of shared memory rings between the controller and one worker process.
+ *
+ * The controller creates the backing file and sends its path to the worker over the pipe, the
+ * worker maps it, and the controller unlinks the file once the worker has replied.
+ */
+class ShmChannel {
+ public:
+  /*! \brief The size of the data area of each direction. */
+  static constexpr uint64_t kRingCapacity = 1 << 20;
+
+  /*!
+   * \brief Create and map a new backing file.
+   * \param worker_id The worker this channel is for, used to make the path unique.
+   * \param peer_fd The pipe read end from the worker, polled for a hang-up while waiting.
+   * \return The channel, or nullptr if shared memory is unavailable.
+   */
+  static std::unique_ptr<ShmChannel> Create(int worker_id, int peer_fd) {
+    static std::atomic<int> counter{0};
+    std::string path = "/dev/shm/tvm-disco-" + std::to_string(getpid()) + "-" +
+                       std::to_string(worker_id) + "-" + std::to_string(counter++);
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0) return nullptr;
+    if (ftruncate(fd, kMappingSize) != 0) {
+      close(fd);
+      unlink(path.c_str());
+      return nullptr;
+    }
+    std::unique_ptr<ShmChannel> channel = Map(fd, path, /*is_controller=*/true, peer_fd);
+    if (channel == nullptr) {
+      unlink(path.c_str());
+      return nullptr;
+    }
+    // The file is zero-filled by ftruncate, which is the initial state of both rings.
+    return channel;
+  }
+
+  /*!
+   * \brief Map a backing file created by the controller.
+   * \param path The path received from the controller.
+   * \param peer_fd The pipe read end from the controller, polled for a hang-up while waiting.
+   * \return The channel, or nullptr if the file cannot be mapped.
+   */
+  static std::unique_ptr<ShmChannel> Open(const std::string& path, int peer_fd) {
+    int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    return Map(fd, path, /*is_controller=*/false, peer_fd);
+  }
+
+  ~ShmChannel() {
+    send_->Close();
+    munmap(base_, kMappingSize);
+  }
+
+  /*! \brief The path of the backing file. */
+  const std::string& path() const { return path_; }
+  /*! \brief The stream this side writes to. */
+  ShmRingStream* send_stream() { return send_.get(); }
+  /*! \brief The stream this side reads from. */
+  ShmRingStream* recv_stream() { return recv_.get(); }
+
+ private:
+  static constexpr uint64_t kRingSize = sizeof(ShmRingHeader) + kRingCapacity;
+  static constexpr uint64_t kMappingSize = 2 * kRingSize;
+
+  static std::unique_ptr<ShmChannel> Map(int fd, const std::string& path, bool is_controller,
+                                         int peer_fd) {
+    void* base = mmap(nullptr, kMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return nullptr;
+    std::unique_ptr<ShmChannel> channel(new ShmChannel());
+    channel->base_ = base;
+    channel->path_ = path;
+    char* bytes = static_cast<char*>(base);
+    // The first ring carries controller-to-worker traffic, the second worker-to-controller.
+    auto make_ring = [&](int index) {
+      char* ring = bytes + index * kRingSize;
+      return std::make_unique<ShmRingStream>(reinterpret_cast<ShmRingHeader*>(ring),
+                                             ring + sizeof(ShmRingHeader), kRingCapacity, peer_fd);
+    };
+    channel->send_ = make_ring(is_controller ? 0 : 1);
+    channel->recv_ = make_ring(is_controller ? 1 : 0);
+    return channel;
+  }
+
+  ShmChannel() = default;
+
+  void* base_{nullptr};
+  std::string path_;
+  std::unique_ptr<ShmRingStream> send_;
+  std::unique_ptr<ShmRingStream> recv_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // __linux__
+#endif  // TVM_RUNTIME_DISCO_SHM_MESSAGE_QUEUE_H_
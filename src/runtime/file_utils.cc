@@ -32,6 +32,14 @@
 #include <unordered_map>
 #include <vector>
 
+#if !defined(_WIN32) && !defined(__hexagon__)
+#define TVM_MAPPED_FILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace tvm {
 namespace runtime {
 
@@ -127,6 +135,60 @@ void LoadBinaryFromFile(const std::string& file_name, std::string* data) {
   fs.read(&(*data)[0], size);
 }
 
+MappedFileObj::~MappedFileObj() {
+#ifdef TVM_MAPPED_FILE_USE_MMAP
+  if (mapped_) {
+    munmap(data_, size_);
+  }
+#endif
+}
+
+void MappedFileObj::Prefault() const {
+#ifdef TVM_MAPPED_FILE_USE_MMAP
+  if (!mapped_) return;
+  madvise(data_, size_, MADV_WILLNEED);
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  volatile char sink = 0;
+  for (size_t offset = 0; offset < size_; offset += page_size) {
+    sink = sink + data_[offset];
+  }
+  (void)sink;
+#endif
+}
+
+MappedFile MappedFile::Open(const std::string& file_name, bool sequential) {
+  ObjectPtr<MappedFileObj> n = make_object<MappedFileObj>();
+#ifdef TVM_MAPPED_FILE_USE_MMAP
+  int fd = open(file_name.c_str(), O_RDONLY);
+  ICHECK_GE(fd, 0) << "Cannot open " << file_name;
+  struct stat st;
+  ICHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << file_name;
+  size_t size = static_cast<size_t>(st.st_size);
+  if (size != 0) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      if (sequential) {
+        madvise(addr, size, MADV_SEQUENTIAL);
+      }
+      n->data_ = static_cast<char*>(addr);
+      n->size_ = size;
+      n->mapped_ = true;
+    }
+  }
+  close(fd);
+  if (n->mapped_ || size == 0) {
+    return MappedFile(n);
+  }
+  LOG(WARNING) << "Failed to mmap " << file_name << ", falling back to reading it into memory";
+#endif
+  LoadBinaryFromFile(file_name, &n->buffer_);
+  n->data_ = n->buffer_.data();
+  n->size_ = n->buffer_.size();
+  return MappedFile(n);
+}
+
+TVM_REGISTER_OBJECT_TYPE(MappedFileObj);
+
 void SaveBinaryToFile(const std::string& file_name, const std::string& data) {
   std::ofstream fs(file_name, std::ios::out | std::ios::binary);
   ICHECK(!fs.fail()) << "Cannot open " << file_name;
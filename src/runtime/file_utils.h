@@ -24,7 +24,9 @@
 #ifndef TVM_RUNTIME_FILE_UTILS_H_
 #define TVM_RUNTIME_FILE_UTILS_H_
 
+#include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/optional.h>
 #include <tvm/runtime/container/string.h>
 
 #include <string>
@@ -67,6 +69,56 @@ std::string GetFileBasename(const std::string& file_name);
  */
 void LoadBinaryFromFile(const std::string& file_name, std::string* data);
 
+/*!
+ * \brief A read-only view of the content of a file, mapped into memory when the
+ *  platform supports it and loaded into a host buffer otherwise.
+ *
+ * The pages are mapped copy-on-write, so writes through data() are allowed
+ * and are never reflected in the file.
+ */
+class MappedFileObj : public Object {
+ public:
+  /*! \return The pointer to the beginning of the file content. */
+  const char* data() const { return data_; }
+  /*! \return The size of the file in bytes. */
+  size_t size() const { return size_; }
+  /*!
+   * \brief Fault in every page of the mapping, so that later reads do not block on disk I/O.
+   * \note This is meant to be called from a background thread ahead of the reads.
+   */
+  void Prefault() const;
+
+  ~MappedFileObj();
+
+  static constexpr const char* _type_key = "runtime.MappedFile";
+  TVM_DECLARE_FINAL_OBJECT_INFO(MappedFileObj, Object);
+
+ private:
+  friend class MappedFile;
+  /*! \brief The beginning of the file content. */
+  char* data_{nullptr};
+  /*! \brief The size of the file content. */
+  size_t size_{0};
+  /*! \brief Whether data_ points to a memory mapping. */
+  bool mapped_{false};
+  /*! \brief The file content when it cannot be mapped. */
+  std::string buffer_;
+};
+
+/*! \brief Reference to MappedFileObj. */
+class MappedFile : public ObjectRef {
+ public:
+  /*!
+   * \brief Map a file into memory.
+   * \param file_name The name of the file.
+   * \param sequential Whether to hint the OS that the file will be read sequentially.
+   * \return The mapped file.
+   */
+  static MappedFile Open(const std::string& file_name, bool sequential = true);
+
+  TVM_DEFINE_OBJECT_REF_METHODS(MappedFile, ObjectRef, MappedFileObj);
+};
+
 /*!
  * \brief Load binary file into a in-memory buffer.
  * \param file_name The name of the file.
@@ -130,6 +182,43 @@ std::string SaveParams(const Map<String, NDArray>& params);
  */
 void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
 
+constexpr uint64_t kTVMChunkedParamsMagic = 0xF7E58D4F05049CB8;
+/*!
+ * \brief Write parameters to a file in the chunked format.
+ *
+ * Tensors are streamed chunk by chunk through a host staging buffer, and every
+ * chunk is protected by a CRC-32. An index footer records the location, type and
+ * checksums of each tensor so that readers can load them selectively.
+ *
+ * \param path The file to write.
+ * \param params Parameters to save, may reside on any device.
+ * \param chunk_size The number of bytes per chunk.
+ */
+void SaveParamsChunked(const std::string& path, const Map<String, NDArray>& params,
+                       uint64_t chunk_size);
+/*!
+ * \brief Load parameters from a file in the chunked format.
+ * \param path The file to read.
+ * \param names The parameters to load, or NullOpt to load all of them.
+ * \param dev The device to place the loaded parameters on.
+ * \return Map of parameter name to parameter value.
+ * \note The checksum of every chunk is verified while loading.
+ */
+Map<String, NDArray> LoadParamsChunked(const std::string& path, Optional<Array<String>> names,
+                                       Device dev);
+/*!
+ * \brief List the parameter names of a chunked parameter file, reading only the index.
+ * \param path The file to read.
+ * \return The parameter names, in file order.
+ */
+Array<String> ListParamsChunked(const std::string& path);
+/*!
+ * \brief Verify all chunk checksums of a chunked parameter file without allocating tensors.
+ * \param path The file to read.
+ * \return The names of the parameters that failed verification.
+ */
+Array<String> ValidateParamsChunked(const std::string& path);
+
 /*!
  * \brief A dmlc stream which wraps standard file operations.
  */
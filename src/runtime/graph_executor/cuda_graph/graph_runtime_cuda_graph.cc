@@ -21,8 +21,12 @@
  * \file graph_executor_cuda_graph.cc
  */
 
+#include <cuda.h>
 #include <tvm/runtime/registry.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "../../cuda/cuda_common.h"
 #include "../graph_executor.h"
 
@@ -38,9 +42,18 @@ namespace runtime {
  *  (1) Using CUDA stream capture API to capture a series of operations on
  *  CUDA stream, and automatically generates a graph (2) Building a graph
  *  using CUDA graph API manually. This implementation uses stream capture.
+ *
+ *  The inputs and outputs bound with set_input_zero_copy / set_output_zero_copy
+ *  after the capture are patched into the parameters of the kernel, memcpy and
+ *  memset nodes of the instantiated graph before its next launch.
  */
 class GraphExecutorCudaGraph : public GraphExecutor {
  public:
+  ~GraphExecutorCudaGraph() {
+    if (cuda_graph_exec_) cudaGraphExecDestroy(cuda_graph_exec_);
+    if (cuda_graph_) cudaGraphDestroy(cuda_graph_);
+  }
+
   /*!
    * \brief Begin CUDA graph capture on stream, the stream enters capture mode.
    */
@@ -58,6 +71,8 @@ class GraphExecutorCudaGraph : public GraphExecutor {
    * \brief Launch the instantiated graph on stream
    */
   void RunCudaGraph() {
+    ICHECK(cuda_graph_exec_ != nullptr) << "The CUDA graph must be captured before it is run";
+    this->UpdateBoundPointers();
     cudaStream_t cuStream = static_cast<cudaStream_t>(capture_stream_);
     CUDA_CALL(cudaGraphLaunch(cuda_graph_exec_, cuStream));
     CUDA_CALL(cudaStreamSynchronize(cuStream));
@@ -76,7 +91,12 @@ class GraphExecutorCudaGraph : public GraphExecutor {
     CUDA_CALL(cudaGraphGetNodes(graph, nodes, &numNodes));
     LOG(INFO) << "Num of nodes in the cuda graph created using stream capture API = " << numNodes;
 
+    if (cuda_graph_exec_) CUDA_CALL(cudaGraphExecDestroy(cuda_graph_exec_));
+    if (cuda_graph_) CUDA_CALL(cudaGraphDestroy(cuda_graph_));
     CUDA_CALL(cudaGraphInstantiate(&cuda_graph_exec_, graph, NULL, NULL, 0));
+    // The graph is kept to read the node parameters when rebinding the inputs and outputs.
+    cuda_graph_ = graph;
+    captured_pointers_ = this->GetBoundPointers();
   }
 
   /*!
@@ -87,10 +107,149 @@ class GraphExecutorCudaGraph : public GraphExecutor {
   PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self);
 
  private:
+  /*!
+   * \brief Get the data pointers of the graph inputs followed by the graph outputs,
+   *  as currently used by the operators.
+   */
+  std::vector<void*> GetBoundPointers() const {
+    auto first_data = [](const std::vector<DLTensor*>& tensors) -> void* {
+      return tensors.empty() ? nullptr : tensors[0]->data;
+    };
+    std::vector<void*> pointers;
+    for (uint32_t nid : input_nodes_) {
+      pointers.push_back(first_data(input_dltensors_[entry_id(nid, 0)]));
+    }
+    for (const NodeEntry& output : outputs_) {
+      uint32_t eid = entry_id(output);
+      const Node& node = nodes_[output.node_id];
+      if (node.op_type == "tvm_op" && node.param.func_name == "__nop") {
+        auto it = node_output_dltensors_.find(entry_id(node.inputs[0]));
+        pointers.push_back(it == node_output_dltensors_.end() ? nullptr : first_data(it->second));
+      } else {
+        pointers.push_back(first_data(output_dltensors_[eid]));
+      }
+    }
+    return pointers;
+  }
+
+  /*!
+   * \brief Patch the pointers rebound since the capture into the instantiated graph.
+   *  The graph is captured again when some node cannot be patched.
+   */
+  void UpdateBoundPointers() {
+    std::vector<void*> current = this->GetBoundPointers();
+    std::unordered_map<void*, void*> remap;
+    for (size_t i = 0; i < current.size(); ++i) {
+      void* old_ptr = captured_pointers_[i];
+      if (old_ptr == nullptr || old_ptr == current[i]) continue;
+      auto [it, inserted] = remap.emplace(old_ptr, current[i]);
+      CHECK(inserted || it->second == current[i])
+          << "Cannot rebind the CUDA graph: two bindings captured with the same buffer were "
+          << "rebound to different buffers";
+    }
+    if (remap.empty()) return;
+    if (!this->PatchGraphNodes(remap)) {
+      LOG(WARNING) << "The CUDA graph nodes cannot be patched, capturing the graph again";
+      this->StartCapture();
+      this->Run();
+      this->EndCapture();
+      return;
+    }
+    captured_pointers_ = current;
+  }
+
+  /*!
+   * \brief Replace the pointers of the nodes of the captured graph.
+   * \param remap The new value of each pointer to replace.
+   * \return Whether all the parameters of the graph could be inspected.
+   */
+  bool PatchGraphNodes(const std::unordered_map<void*, void*>& remap) {
+    size_t num_nodes = 0;
+    CUDA_CALL(cudaGraphGetNodes(cuda_graph_, nullptr, &num_nodes));
+    std::vector<cudaGraphNode_t> nodes(num_nodes);
+    CUDA_CALL(cudaGraphGetNodes(cuda_graph_, nodes.data(), &num_nodes));
+    auto lookup = [&remap](void* ptr, void** out) {
+      auto it = remap.find(ptr);
+      if (it == remap.end()) return false;
+      *out = it->second;
+      return true;
+    };
+    // Check all the kernels can be inspected before modifying any node.
+    for (cudaGraphNode_t node : nodes) {
+      cudaGraphNodeType type;
+      CUDA_CALL(cudaGraphNodeGetType(node, &type));
+      if (type == cudaGraphNodeTypeKernel) {
+#if CUDA_VERSION >= 12040
+        CUDA_KERNEL_NODE_PARAMS params;
+        CUDA_DRIVER_CALL(cuGraphKernelNodeGetParams(node, &params));
+        if (params.func == nullptr || params.kernelParams == nullptr) return false;
+#else
+        // The parameter layout of the kernels is only known from CUDA 12.4.
+        return false;
+#endif
+      } else if (type != cudaGraphNodeTypeMemcpy && type != cudaGraphNodeTypeMemset &&
+                 type != cudaGraphNodeTypeEmpty) {
+        return false;
+      }
+    }
+    for (cudaGraphNode_t node : nodes) {
+      cudaGraphNodeType type;
+      CUDA_CALL(cudaGraphNodeGetType(node, &type));
+      if (type == cudaGraphNodeTypeKernel) {
+#if CUDA_VERSION >= 12040
+        CUDA_KERNEL_NODE_PARAMS params;
+        CUDA_DRIVER_CALL(cuGraphKernelNodeGetParams(node, &params));
+        std::vector<void*> kernel_params;
+        std::vector<void*> patched_values;
+        bool patched = false;
+        size_t offset, size;
+        for (size_t i = 0; cuFuncGetParamInfo(params.func, i, &offset, &size) == CUDA_SUCCESS;
+             ++i) {
+          kernel_params.push_back(params.kernelParams[i]);
+        }
+        // Stable addresses for the patched values referenced by kernel_params.
+        patched_values.reserve(kernel_params.size());
+        for (size_t i = 0; i < kernel_params.size(); ++i) {
+          CUDA_DRIVER_CALL(cuFuncGetParamInfo(params.func, i, &offset, &size));
+          void* new_ptr;
+          if (size == sizeof(void*) && lookup(*static_cast<void**>(kernel_params[i]), &new_ptr)) {
+            patched_values.push_back(new_ptr);
+            kernel_params[i] = &patched_values.back();
+            patched = true;
+          }
+        }
+        if (!patched) continue;
+        params.kernelParams = kernel_params.data();
+        CUDA_DRIVER_CALL(cuGraphExecKernelNodeSetParams(cuda_graph_exec_, node, &params));
+        CUDA_DRIVER_CALL(cuGraphKernelNodeSetParams(node, &params));
+#endif
+      } else if (type == cudaGraphNodeTypeMemcpy) {
+        cudaMemcpy3DParms params;
+        CUDA_CALL(cudaGraphMemcpyNodeGetParams(node, &params));
+        bool patched = lookup(params.srcPtr.ptr, &params.srcPtr.ptr);
+        patched = lookup(params.dstPtr.ptr, &params.dstPtr.ptr) || patched;
+        if (!patched) continue;
+        CUDA_CALL(cudaGraphExecMemcpyNodeSetParams(cuda_graph_exec_, node, &params));
+        CUDA_CALL(cudaGraphMemcpyNodeSetParams(node, &params));
+      } else if (type == cudaGraphNodeTypeMemset) {
+        cudaMemsetParams params;
+        CUDA_CALL(cudaGraphMemsetNodeGetParams(node, &params));
+        if (!lookup(params.dst, &params.dst)) continue;
+        CUDA_CALL(cudaGraphExecMemsetNodeSetParams(cuda_graph_exec_, node, &params));
+        CUDA_CALL(cudaGraphMemsetNodeSetParams(node, &params));
+      }
+    }
+    return true;
+  }
+
   /*! \brief The Cuda stream on which to capture a CUDA graph. */
   TVMStreamHandle capture_stream_;
+  /*! \brief The captured CUDA graph, nullptr before the capture. */
+  cudaGraph_t cuda_graph_{nullptr};
   /*! \brief The captured CUDA graph will be instantiated to this. */
-  cudaGraphExec_t cuda_graph_exec_;
+  cudaGraphExec_t cuda_graph_exec_{nullptr};
+  /*! \brief The bound pointers at the time of the capture, see GetBoundPointers. */
+  std::vector<void*> captured_pointers_;
 };
 
 PackedFunc GraphExecutorCudaGraph::GetFunction(const String& name,
@@ -31,12 +31,19 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -56,15 +63,163 @@ constexpr auto Is2DStorage = IsTextureStorage;
 }  // namespace details
 
 /*!
- * \brief Run all the operations one by one.
+ * \brief Runs the operators of an executor along its dependency DAG on a group of threads.
+ *
+ * The calling thread of Run takes part in the execution, so the group has
+ * num_workers - 1 threads of its own. They wait on a condition variable between
+ * the runs. The first error raised by an operator stops the scheduling of new
+ * operators and is rethrown by Run once the running ones finished.
+ */
+class GraphExecutor::BranchScheduler {
+ public:
+  BranchScheduler(const GraphExecutor* exec, int num_workers) : exec_(exec) {
+    for (int i = 1; i < num_workers; ++i) {
+      workers_.emplace_back([this]() { this->WorkerLoop(); });
+    }
+  }
+
+  ~BranchScheduler() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    remaining_deps_ = exec_->op_num_deps_;
+    ready_.clear();
+    num_pending_ = 0;
+    for (uint32_t nid = 0; nid < exec_->op_execs_.size(); ++nid) {
+      if (!exec_->op_execs_[nid]) continue;
+      ++num_pending_;
+      if (remaining_deps_[nid] == 0) ready_.push_back(nid);
+    }
+    // Pop the operators in topological order when nothing else is ready.
+    std::reverse(ready_.begin(), ready_.end());
+    error_ = nullptr;
+    pool_name_ = exec_->thread_pool_name_;
+    ++generation_;
+    cv_.notify_all();
+    this->Work(&lock);
+    cv_.wait(lock, [this]() { return num_in_flight_ == 0; });
+    if (error_ != nullptr) {
+      std::exception_ptr error = std::move(error_);
+      error_ = nullptr;
+      lock.unlock();
+      std::rethrow_exception(error);
+    }
+  }
+
+ private:
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t seen_generation = 0;
+    while (true) {
+      cv_.wait(lock, [&]() { return shutdown_ || generation_ != seen_generation; });
+      if (shutdown_) return;
+      seen_generation = generation_;
+      std::string pool_name = pool_name_;
+      lock.unlock();
+      threading::ThreadPoolScope pool_scope(pool_name);
+      lock.lock();
+      this->Work(&lock);
+    }
+  }
+
+  /*! \brief Run the ready operators until the current run has nothing left to schedule. */
+  void Work(std::unique_lock<std::mutex>* lock) {
+    while (true) {
+      cv_.wait(*lock, [this]() {
+        return !ready_.empty() || num_pending_ == 0 || error_ != nullptr || shutdown_;
+      });
+      if (ready_.empty()) return;
+      uint32_t nid = ready_.back();
+      ready_.pop_back();
+      ++num_in_flight_;
+      lock->unlock();
+      std::exception_ptr error = nullptr;
+      try {
+        exec_->op_execs_[nid]();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock->lock();
+      --num_in_flight_;
+      if (error != nullptr) {
+        if (error_ == nullptr) error_ = std::move(error);
+        ready_.clear();
+      } else if (error_ == nullptr) {
+        --num_pending_;
+        for (uint32_t succ : exec_->op_successors_[nid]) {
+          if (--remaining_deps_[succ] == 0) ready_.push_back(succ);
+        }
+      }
+      if (!ready_.empty() || num_in_flight_ == 0) cv_.notify_all();
+    }
+  }
+
+  /*! \brief The executor whose operators are run. */
+  const GraphExecutor* exec_;
+  /*! \brief The threads besides the one calling Run. */
+  std::vector<std::thread> workers_;
+  /*! \brief Protects all the fields below. */
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /*! \brief The number of unfinished dependencies of each operator in the current run. */
+  std::vector<uint32_t> remaining_deps_;
+  /*! \brief The operators whose dependencies all finished. */
+  std::vector<uint32_t> ready_;
+  /*! \brief The number of operators of the current run that did not finish. */
+  size_t num_pending_{0};
+  /*! \brief The number of operators being executed. */
+  size_t num_in_flight_{0};
+  /*! \brief The first error of the current run. */
+  std::exception_ptr error_{nullptr};
+  /*! \brief The named thread pool of the current run. */
+  std::string pool_name_;
+  /*! \brief Incremented by each run to wake up the workers. */
+  uint64_t generation_{0};
+  bool shutdown_{false};
+};
+
+/*!
+ * \brief Run all the operations one by one, or along their dependencies
+ *  when the branches run concurrently.
  */
 void GraphExecutor::Run() {
+  threading::ThreadPoolScope pool_scope(thread_pool_name_);
+  if (num_branch_workers_ > 1) {
+    if (branch_scheduler_ == nullptr) {
+      branch_scheduler_ = std::make_shared<BranchScheduler>(this, num_branch_workers_);
+    }
+    branch_scheduler_->Run();
+    return;
+  }
   // setup the array and requirements.
   for (size_t i = 0; i < op_execs_.size(); ++i) {
     if (op_execs_[i]) op_execs_[i]();
   }
 }
 
+void GraphExecutor::SetNumBranchWorkers(int num_workers) {
+  ICHECK_GE(num_workers, 1) << "The number of branch workers must be positive";
+  if (num_workers > 1) {
+    for (const Device& dev : devices_) {
+      CHECK_EQ(dev.device_type, kDLCPU)
+          << "Running the branches of a graph concurrently is only supported on CPU, but the "
+          << "executor uses " << DLDeviceType2Str(static_cast<int>(dev.device_type));
+    }
+  }
+  CHECK(num_workers == 1 || !storage_arena_)
+      << "The branches of a graph cannot run concurrently when its storages are packed into an "
+      << "arena, which overlaps them along the topological order";
+  if (num_workers != num_branch_workers_) branch_scheduler_ = nullptr;
+  num_branch_workers_ = num_workers;
+}
+
 /*!
  * \brief Initialize the graph executor with graph and device.
  * \param graph_json The execution graph.
@@ -458,15 +613,30 @@ void GraphExecutor::SetupStorage() {
   }
 
   // Allocate the space.
+  std::vector<Device> pool_devices;
   for (const auto& pit : pool_entry) {
     // This for loop is very fast since there are usually only a couple of
     // devices available on the same hardware.
     const auto& cit = std::find_if(devices_.begin(), devices_.end(), [&pit](const Device& d) {
       return pit.device_type == static_cast<int>(d.device_type);
     });
-    Device dev = cit == devices_.end() ? devices_[0] : *cit;
-    if (pit.linked_param.defined()) {
-      storage_pool_.push_back(pit.linked_param);
+    pool_devices.push_back(cit == devices_.end() ? devices_[0] : *cit);
+  }
+  std::vector<bool> in_arena(pool_entry.size(), false);
+  const char* arena_env = std::getenv("TVM_GRAPH_EXECUTOR_STORAGE_ARENA");
+  storage_arena_ = arena_env != nullptr && std::atoi(arena_env) != 0;
+  if (storage_arena_) {
+    SetupStorageArena(pool_entry, pool_devices, &in_arena);
+  } else {
+    storage_pool_.resize(pool_entry.size());
+  }
+  for (size_t sid = 0; sid < pool_entry.size(); ++sid) {
+    const PoolEntry& pit = pool_entry[sid];
+    Device dev = pool_devices[sid];
+    if (in_arena[sid]) {
+      continue;
+    } else if (pit.linked_param.defined()) {
+      storage_pool_[sid] = pit.linked_param;
     } else {
       std::vector<int64_t> shape = pit.shape;
       if (shape.size() == 1) {
@@ -476,8 +646,8 @@ void GraphExecutor::SetupStorage() {
       if (!pit.scope.empty()) {
         mem_scope = String(pit.scope);
       }
-      storage_pool_.push_back(MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kNaive)
-                                  ->Empty(shape, pit.dtype, dev, mem_scope));
+      storage_pool_[sid] = MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kNaive)
+                               ->Empty(shape, pit.dtype, dev, mem_scope);
     }
   }
 
@@ -501,6 +671,95 @@ void GraphExecutor::SetupStorage() {
   }
 }
 
+void GraphExecutor::SetupStorageArena(const std::vector<PoolEntry>& pool_entry,
+                                      const std::vector<Device>& pool_devices,
+                                      std::vector<bool>* in_arena) {
+  storage_pool_.resize(pool_entry.size());
+  // Step 1. The range of operators each storage is live across. The inputs, the parameters and
+  // the outputs of the graph are live across the whole graph.
+  uint32_t num_nodes = this->GetNumOfNodes();
+  std::vector<std::pair<uint32_t, uint32_t>> live(pool_entry.size(), {num_nodes, 0});
+  auto f_use = [&](uint32_t eid, uint32_t begin, uint32_t end) {
+    std::pair<uint32_t, uint32_t>& range = live[attrs_.storage_id[eid]];
+    range.first = std::min(range.first, begin);
+    range.second = std::max(range.second, end);
+  };
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    const auto& inode = nodes_[nid];
+    bool whole_graph = inode.op_type == "null";
+    for (const auto& e : inode.inputs) {
+      f_use(this->entry_id(e), nid, nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      f_use(this->entry_id(nid, index), whole_graph ? 0 : nid, whole_graph ? num_nodes : nid);
+    }
+  }
+  for (const auto& e : outputs_) {
+    f_use(this->entry_id(e), 0, num_nodes);
+  }
+  // Step 2. Pack the flat storages of each device, the largest first, each at the lowest aligned
+  // offset that is not used by the storages packed before it during its live range. Only the
+  // devices whose data pointers support arithmetic are packed.
+  std::unordered_map<int, std::vector<uint32_t>> device_sids;
+  for (uint32_t sid = 0; sid < pool_entry.size(); ++sid) {
+    const PoolEntry& pit = pool_entry[sid];
+    DLDeviceType device_type = pool_devices[sid].device_type;
+    bool flat_pointer = device_type == kDLCPU || device_type == kDLCUDA ||
+                        device_type == kDLCUDAHost || device_type == kDLCUDAManaged ||
+                        device_type == kDLROCM || device_type == kDLROCMHost;
+    if (flat_pointer && !pit.linked_param.defined() && pit.shape.size() == 1 &&
+        (pit.scope.empty() || pit.scope == "global") && live[sid].first <= live[sid].second) {
+      device_sids[static_cast<int>(device_type)].push_back(sid);
+    }
+  }
+  auto f_align = [](int64_t bytes) {
+    return (bytes + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+  };
+  for (auto& kv : device_sids) {
+    std::vector<uint32_t>& sids = kv.second;
+    std::stable_sort(sids.begin(), sids.end(), [&pool_entry](uint32_t a, uint32_t b) {
+      return pool_entry[a].shape[0] > pool_entry[b].shape[0];
+    });
+    std::vector<int64_t> offsets(pool_entry.size(), 0);
+    std::vector<uint32_t> packed;
+    int64_t arena_bytes = 0;
+    for (uint32_t sid : sids) {
+      int64_t bytes = f_align(pool_entry[sid].shape[0]);
+      // The intervals taken during the live range of the storage, ordered by offset
+      std::vector<std::pair<int64_t, int64_t>> taken;
+      for (uint32_t other : packed) {
+        if (live[other].first <= live[sid].second && live[sid].first <= live[other].second) {
+          taken.emplace_back(offsets[other], offsets[other] + f_align(pool_entry[other].shape[0]));
+        }
+      }
+      std::sort(taken.begin(), taken.end());
+      int64_t offset = 0;
+      for (const auto& interval : taken) {
+        if (offset + bytes <= interval.first) break;
+        offset = std::max(offset, interval.second);
+      }
+      offsets[sid] = offset;
+      arena_bytes = std::max(arena_bytes, offset + bytes);
+      packed.push_back(sid);
+    }
+    if (arena_bytes == 0) continue;
+    // Step 3. Allocate the arena and view each storage at its offset, with the offset folded
+    // into the data pointer as the kernels expect a zero byte offset
+    Device dev = pool_devices[sids[0]];
+    DLDataType dtype{kDLFloat, 32, 1};
+    NDArray arena = MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kNaive)
+                        ->Empty({arena_bytes / 4}, dtype, dev);
+    for (uint32_t sid : sids) {
+      NDArray view = arena.CreateView({(pool_entry[sid].shape[0] + 3) / 4}, dtype, offsets[sid]);
+      DLTensor* tensor = const_cast<DLTensor*>(view.operator->());
+      tensor->data = static_cast<char*>(tensor->data) + tensor->byte_offset;
+      tensor->byte_offset = 0;
+      storage_pool_[sid] = view;
+      (*in_arena)[sid] = true;
+    }
+  }
+}
+
 void GraphExecutor::SetupOpExecs() {
   op_execs_.resize(this->GetNumOfNodes());
   input_dltensors_.resize(num_node_entries());
@@ -579,6 +838,56 @@ void GraphExecutor::SetupOpExecs() {
       }
     }
   }
+  this->SetupOpDependencies();
+}
+
+void GraphExecutor::SetupOpDependencies() {
+  uint32_t num_nodes = this->GetNumOfNodes();
+  std::vector<std::vector<uint32_t>> preds(num_nodes);
+  // The memory plan reuses the storage of an entry once its readers ran in topological order,
+  // so the accesses of each storage are ordered like the data flow.
+  std::unordered_map<int64_t, uint32_t> last_writer;
+  std::unordered_map<int64_t, std::vector<uint32_t>> readers;
+  auto storage_key = [this](uint32_t eid) -> int64_t {
+    int sid = attrs_.storage_id[eid];
+    return sid >= 0 ? sid : -static_cast<int64_t>(eid) - 1;
+  };
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    if (!op_execs_[nid]) continue;
+    const auto& inode = nodes_[nid];
+    std::vector<uint32_t>& deps = preds[nid];
+    for (const auto& e : inode.inputs) {
+      auto it = last_writer.find(storage_key(this->entry_id(e)));
+      if (it != last_writer.end()) deps.push_back(it->second);
+    }
+    for (uint32_t dep : inode.control_deps) {
+      if (op_execs_[dep]) deps.push_back(dep);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int64_t key = storage_key(this->entry_id(nid, index));
+      auto it = last_writer.find(key);
+      if (it != last_writer.end()) deps.push_back(it->second);
+      const std::vector<uint32_t>& key_readers = readers[key];
+      deps.insert(deps.end(), key_readers.begin(), key_readers.end());
+    }
+    for (const auto& e : inode.inputs) {
+      readers[storage_key(this->entry_id(e))].push_back(nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int64_t key = storage_key(this->entry_id(nid, index));
+      last_writer[key] = nid;
+      readers[key].clear();
+    }
+    std::sort(deps.begin(), deps.end());
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+    deps.erase(std::remove(deps.begin(), deps.end(), nid), deps.end());
+  }
+  op_successors_.assign(num_nodes, {});
+  op_num_deps_.assign(num_nodes, 0);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    op_num_deps_[nid] = preds[nid].size();
+    for (uint32_t dep : preds[nid]) op_successors_[dep].push_back(nid);
+  }
 }
 
 std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs>> GraphExecutor::CreateTVMOp(
@@ -728,6 +1037,17 @@ PackedFunc GraphExecutor::GetFunction(const String& name, const ObjectPtr<Object
           }
           *rv = outputs;
         });
+  } else if (name == "set_thread_pool") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string pool_name = args[0];
+      // Fail early on unknown pools instead of at the next run.
+      { threading::ThreadPoolScope check(pool_name); }
+      this->thread_pool_name_ = pool_name;
+    });
+  } else if (name == "set_num_branch_workers") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetNumBranchWorkers(args[0]);
+    });
   } else if (name == "load_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       this->LoadParams(args[0].operator std::string());
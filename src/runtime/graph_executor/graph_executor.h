@@ -93,6 +93,18 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   const char* type_key() const final { return "GraphExecutor"; }
   void Run();
 
+  /*!
+   * \brief Set the number of threads that run independent branches of the graph concurrently.
+   *
+   * The operators are scheduled along the dependency DAG built by SetupOpExecs, which
+   * also orders the operators sharing a storage of the memory plan. Only supported when
+   * every device of the executor is a CPU.
+   *
+   * \param num_workers The number of threads including the calling one, 1 runs the
+   *  operators one by one in topological order.
+   */
+  void SetNumBranchWorkers(int num_workers);
+
   /*! \brief Get the property of the runtime module .*/
   int GetPropertyMask() const final { return ModulePropertyMask::kRunnable; }
 
@@ -426,8 +438,24 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   static void LinkedNDArrayDeleter(Object* container);
   /*! \brief Setup the temporal storage */
   void SetupStorage();
+  /*!
+   * \brief Pack the storages of each device into a single allocation, where the storages that are
+   *  never live at the same time overlap. Enabled by the environment variable
+   *  TVM_GRAPH_EXECUTOR_STORAGE_ARENA=1. Linked parameters and the storages with a memory scope
+   *  keep their own allocations.
+   * \param pool_entry The storages.
+   * \param pool_devices The device of each storage.
+   * \param in_arena Whether each storage was packed, to be written.
+   */
+  void SetupStorageArena(const std::vector<PoolEntry>& pool_entry,
+                         const std::vector<Device>& pool_devices, std::vector<bool>* in_arena);
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*!
+   * \brief Build the dependency DAG of the operators, including the write-after-read and
+   *  write-after-write orders of the entries sharing a storage id.
+   */
+  void SetupOpDependencies();
   /*!
    * \brief Check the legality of external DLTensor*.
    * \param external The external DLTensor*.
@@ -495,6 +523,19 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * When the module does not include linked parmeters, module_lookup_linked_param_ will be nullptr.
    */
   bool module_lookup_linked_param_valid_;
+  /*! \brief The named thread pool Run uses for the parallel loops, empty for none. */
+  std::string thread_pool_name_;
+  /*! \brief The operators each operator must run before, indexed by node id. */
+  std::vector<std::vector<uint32_t>> op_successors_;
+  /*! \brief The number of operators each operator must run after, indexed by node id. */
+  std::vector<uint32_t> op_num_deps_;
+  /*! \brief The scheduler of the concurrent branches, nullptr when running sequentially. */
+  class BranchScheduler;
+  std::shared_ptr<BranchScheduler> branch_scheduler_;
+  /*! \brief The number of threads running the branches, see SetNumBranchWorkers. */
+  int num_branch_workers_{1};
+  /*! \brief Whether the storages are packed into arenas, see SetupStorageArena. */
+  bool storage_arena_{false};
 };
 
 std::vector<Device> GetAllDevice(const TVMArgs& args, int dev_start_arg);
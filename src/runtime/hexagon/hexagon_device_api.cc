@@ -30,6 +30,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <sstream>
 
 #include "../workspace_pool.h"
 #include "hexagon_common.h"
@@ -298,12 +299,37 @@ TVM_REGISTER_GLOBAL("device_api.hexagon.release_resources")
       api->ReleaseResources();
     });
 
+TVM_REGISTER_GLOBAL("device_api.hexagon.parallel_workers").set_body_typed([]() -> int {
+  HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
+  return api->HasThreadManager() ? api->ThreadManager()->NumParallelWorkers() : 1;
+});
+
+TVM_REGISTER_GLOBAL("device_api.hexagon.parallel_for")
+    .set_body_typed([](int num_tasks, TypedPackedFunc<void(int)> f) {
+      HexagonThreadManager* thread_manager = HexagonDeviceAPI::Global()->ThreadManager();
+      thread_manager->ParallelFor(num_tasks, [&f](int task, int, void*) { f(task); });
+    });
+
 TVM_REGISTER_GLOBAL("device_api.hexagon.vtcm_device_bytes")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
       HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
       *rv = static_cast<int32_t>(api->VtcmPool()->VtcmDeviceBytes());
     });
 
+TVM_REGISTER_GLOBAL("device_api.hexagon.vtcm_pool_stats")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
+      HexagonVtcmPoolStats stats = api->VtcmPool()->GetStats();
+      std::ostringstream os;
+      os << "{\"num_allocations\": " << stats.num_allocations
+         << ", \"num_failures\": " << stats.num_failures << ", \"used_bytes\": " << stats.used_bytes
+         << ", \"peak_used_bytes\": " << stats.peak_used_bytes
+         << ", \"free_bytes\": " << stats.free_bytes
+         << ", \"num_free_segments\": " << stats.num_free_segments
+         << ", \"largest_free_segment\": " << stats.largest_free_segment << "}";
+      *rv = String(os.str());
+    });
+
 TVM_REGISTER_GLOBAL("device_api.hexagon").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = HexagonDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
@@ -148,6 +148,9 @@ class HexagonDeviceAPI final : public DeviceAPI {
    */
   void CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHandle stream) final;
 
+  //! \brief Whether the thread manager exists, i.e. the resources of a session are acquired.
+  bool HasThreadManager() const { return runtime_threads != nullptr; }
+
   HexagonThreadManager* ThreadManager() {
     CHECK(runtime_threads) << "runtime_threads has not been created";
     return runtime_threads.get();
@@ -19,6 +19,8 @@
 
 #include "hexagon_thread_manager.h"
 
+#include <algorithm>
+
 namespace tvm {
 namespace runtime {
 namespace hexagon {
@@ -41,6 +43,20 @@ HexagonThreadManager::HexagonThreadManager(unsigned num_threads, unsigned thread
   hw_resources_ = hw_resources;
   CheckResources();
 
+  // Parallel-for runs on the threads locking an HVX instance, or on every thread when no hardware
+  // resources are requested
+  for (unsigned i = 0; i < nthreads_; i++) {
+    HardwareResourceType type = hw_resources_.empty() ? NONE : hw_resources_[i];
+    if ((type == HVX_0) || (type == HVX_1) || (type == HVX_2) || (type == HVX_3)) {
+      parallel_workers_.push_back(i);
+    }
+  }
+  if (parallel_workers_.empty() && !create_resource_managers_) {
+    for (unsigned i = 0; i < nthreads_; i++) {
+      parallel_workers_.push_back(i);
+    }
+  }
+
   if (create_resource_managers_) {
     DLOG(INFO) << "Initialize hardware resource managers";
     // This creates the manager objects, which reserves (acquires) the resources.
@@ -264,6 +280,77 @@ void HexagonThreadManager::WaitOnThreads() {
   }
 }
 
+unsigned HexagonThreadManager::NumParallelWorkers() {
+  // A worker waiting on the other workers would deadlock on its own pipe, so run nested
+  // parallel-fors serially
+  qurt_thread_t self = qurt_thread_get_id();
+  for (unsigned i : parallel_workers_) {
+    if (threads_[i] == self) {
+      return 1;
+    }
+  }
+  return std::max<unsigned>(parallel_workers_.size(), 1);
+}
+
+void HexagonThreadManager::ParallelFor(int num_tasks, const std::function<void(int, int, void*)>& f,
+                                       size_t scratch_bytes) {
+  CHECK_GE(num_tasks, 0) << "ValueError: The number of tasks must be non-negative";
+  if (num_tasks == 0) {
+    return;
+  }
+  int num_workers = std::min<int>(NumParallelWorkers(), num_tasks);
+
+  // Carve one VTCM allocation into an aligned slice per worker
+  size_t align = VTCM_SCRATCH_ALIGNMENT;
+  size_t slice_bytes = (scratch_bytes + align - 1) / align * align;
+  char* scratch = nullptr;
+  if (slice_bytes) {
+    scratch = static_cast<char*>(hexbuffs_.AllocateHexagonBuffer(
+        slice_bytes * num_workers, align, String("global.vtcm")));
+  }
+
+  std::vector<ParallelForWorker> workers(num_workers);
+  for (int w = 0; w < num_workers; w++) {
+    workers[w].f = &f;
+    workers[w].worker = w;
+    workers[w].num_workers = num_workers;
+    workers[w].num_tasks = num_tasks;
+    workers[w].scratch = scratch ? scratch + w * slice_bytes : nullptr;
+    qurt_sem_init_val(&workers[w].finished, 0);
+  }
+
+  if (num_workers == 1) {
+    thread_parallel_for(&workers[0]);
+  } else {
+    // In case Start() was never explicitly called, call it now to prevent deadlock
+    if (qurt_sem_get_val(&start_semaphore_) == 0) {
+      Start();
+    }
+    for (int w = 0; w < num_workers; w++) {
+      TVMStreamHandle stream = reinterpret_cast<TVMStreamHandle>(parallel_workers_[w]);
+      bool success = Dispatch(stream, thread_parallel_for, &workers[w]);
+      while (!success) {
+        success = Dispatch(stream, thread_parallel_for, &workers[w]);
+      }
+    }
+  }
+
+  std::exception_ptr error;
+  for (int w = 0; w < num_workers; w++) {
+    thread_wait(&workers[w].finished);
+    qurt_sem_destroy(&workers[w].finished);
+    if (!error) {
+      error = workers[w].error;
+    }
+  }
+  if (scratch) {
+    hexbuffs_.FreeHexagonBuffer(scratch);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 void HexagonThreadManager::CheckSemaphore(unsigned syncID) {
   // We want the success case to be fast, so do not lock the mutex
   if (semaphores_.find(syncID) == semaphores_.end()) {
@@ -321,6 +408,18 @@ void HexagonThreadManager::thread_wait_free(void* semaphore) {
   free(semaphore);
 }
 
+void HexagonThreadManager::thread_parallel_for(void* worker) {
+  ParallelForWorker* w = static_cast<ParallelForWorker*>(worker);
+  try {
+    for (int task = w->worker; task < w->num_tasks; task += w->num_workers) {
+      (*w->f)(task, w->worker, w->scratch);
+    }
+  } catch (...) {
+    w->error = std::current_exception();
+  }
+  thread_signal(&w->finished);
+}
+
 void HexagonThreadManager::thread_exit(void* context) {
   ThreadContext* tc = static_cast<ThreadContext*>(context);
   unsigned index = tc->index;
@@ -24,6 +24,8 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <exception>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -66,6 +68,8 @@ class HexagonThreadManager {
   const unsigned MIN_PIPE_SIZE_WORDS = 10;
   //! \brief Maximum pipe (or command buffer) size in words (or commands) per thread.
   const unsigned MAX_PIPE_SIZE_WORDS = 0x10000;  // 64K words
+  //! \brief Alignment of the VTCM scratch slice of each `ParallelFor` worker.
+  const unsigned VTCM_SCRATCH_ALIGNMENT = 2048;
 
  public:
   /*!
@@ -145,6 +149,28 @@ class HexagonThreadManager {
   //! call to wait until all threads have empty pipes.
   void WaitOnThreads();
 
+  /*!
+   * \brief Number of threads `ParallelFor` distributes its tasks to when called from the current
+   * thread; this is 1 when called from one of those threads, where `ParallelFor` runs serially.
+   */
+  unsigned NumParallelWorkers();
+
+  /*!
+   * \brief Blocking parallel-for on the threads holding an HVX instance, or on all the threads if
+   * the manager was created without hardware resources.
+   *
+   * Worker `w` runs the tasks `w`, `w + n`, `w + 2 * n`, ... for `n` workers, so when `num_tasks`
+   * does not exceed `NumParallelWorkers()` every task runs concurrently on its own thread. The
+   * tasks run after any work already dispatched to the worker threads.
+   * \param num_tasks Number of tasks.
+   * \param f Function called as `f(task, worker, scratch)` for each task; an exception thrown by
+   * a task is rethrown to the caller once all the workers finish.
+   * \param scratch_bytes Bytes of VTCM given to each worker; `scratch` is the private slice of
+   * the worker running the task, or null when `scratch_bytes` is 0.
+   */
+  void ParallelFor(int num_tasks, const std::function<void(int, int, void*)>& f,
+                   size_t scratch_bytes = 0);
+
  private:
   struct ThreadContext {
     qurt_pipe_t* pipe;
@@ -181,6 +207,20 @@ class HexagonThreadManager {
   //! `SyncFromTo`.
   static void thread_wait_free(void* semaphore);
 
+  //! \brief The tasks of one `ParallelFor` worker; passed to `thread_parallel_for`.
+  struct ParallelForWorker {
+    const std::function<void(int, int, void*)>* f;
+    int worker;
+    int num_workers;
+    int num_tasks;
+    void* scratch;
+    std::exception_ptr error;
+    qurt_sem_t finished;
+  };
+
+  //! \brief Void function executed by a thread to run the tasks of a `ParallelForWorker`.
+  static void thread_parallel_for(void* worker);
+
   //! \brief Void function executed by a thread to exit at time of destruction.
   static void thread_exit(void* context);
 
@@ -207,6 +247,9 @@ class HexagonThreadManager {
   //! \brief QURT pipe (or command buffer) structure for each spawned thread.
   std::vector<qurt_pipe_t> pipes_;
 
+  //! \brief Indices of the threads `ParallelFor` distributes its tasks to.
+  std::vector<unsigned> parallel_workers_;
+
   //! \brief Thread context passed into each `thread_main` function.
   std::vector<ThreadContext*> contexts_;
 
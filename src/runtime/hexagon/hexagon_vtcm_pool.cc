@@ -18,6 +18,9 @@
  */
 #include "hexagon_vtcm_pool.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "HAP_compute_res.h"
 #include "hexagon_common.h"
 
@@ -68,42 +71,61 @@ void* HexagonVtcmPool::Allocate(size_t nbytes) {
   CHECK(nbytes >= 0x80) << "Minimum VTCM alloation must be 128 bytes - nbytes " << nbytes;
 
   // If this is not aligned on a 2k block, allocate from the end to avoid fragmentation
-  if (nbytes & size_t(0x7FF)) {
-    DLOG(INFO) << "VTCM nbytes requested: " << nbytes << " allocate from the end";
-    auto last_free_entry = free_.end();
-    last_free_entry--;
-    CHECK(last_free_entry->second >= nbytes)
-        << "Not enough contiguous VTCM space at the end to allocate";
-    char* ptr = last_free_entry->first + (last_free_entry->second - nbytes);
-    allocations_.emplace_back(std::pair<char*, size_t>(ptr, nbytes));
-    last_free_entry->second -= nbytes;
-    if (last_free_entry->second == 0) {
-      free_.erase(last_free_entry);
-    }
-    // DebugDump();
-    return ptr;
-  }
-
-  auto entry_to_allocate = free_.begin();
+  bool from_end = (nbytes & size_t(0x7FF)) != 0;
+  auto front_padding = [](char* ptr) -> size_t {
+    return (0x800 - (reinterpret_cast<uintptr_t>(ptr) & 0x7FF)) & 0x7FF;
+  };
+
+  // Best fit: the free segment that leaves the least space. Ties go to the lowest segment for
+  // allocations from the front and to the highest one for allocations from the end.
+  auto entry_to_allocate = free_.end();
+  size_t best_slack = 0;
   for (auto it = free_.begin(); it != free_.end(); it++) {
-    if ((entry_to_allocate->second < nbytes || it->second < entry_to_allocate->second) &&
-        it->second >= nbytes) {
+    size_t padding = from_end ? 0 : front_padding(it->first);
+    if (it->second < nbytes + padding) continue;
+    size_t slack = it->second - nbytes - padding;
+    if (entry_to_allocate == free_.end() || slack < best_slack ||
+        (from_end && slack == best_slack)) {
       entry_to_allocate = it;
-      if (entry_to_allocate->second == nbytes) {
-        break;
-      }
+      best_slack = slack;
     }
   }
-  CHECK(entry_to_allocate->second >= nbytes) << "Not enough contiguous VTCM space to allocate";
-  char* ptr = entry_to_allocate->first;
-  allocations_.emplace(allocations_.end(), std::pair<char*, size_t>(ptr, nbytes));
+  if (entry_to_allocate == free_.end()) {
+    ++num_failures_;
+    LOG(FATAL) << "Not enough contiguous VTCM space to allocate " << nbytes
+               << " bytes, largest free segment is " << CollectStats().largest_free_segment
+               << " bytes";
+  }
 
-  if (entry_to_allocate->second == nbytes) {
-    free_.erase(entry_to_allocate);
+  char* ptr;
+  if (from_end) {
+    DLOG(INFO) << "VTCM nbytes requested: " << nbytes << " allocate from the end";
+    ptr = entry_to_allocate->first + (entry_to_allocate->second - nbytes);
+    entry_to_allocate->second -= nbytes;
+    if (entry_to_allocate->second == 0) {
+      free_.erase(entry_to_allocate);
+    }
   } else {
-    entry_to_allocate->first = entry_to_allocate->first + nbytes;
-    entry_to_allocate->second = entry_to_allocate->second - nbytes;
+    size_t padding = front_padding(entry_to_allocate->first);
+    ptr = entry_to_allocate->first + padding;
+    size_t tail = entry_to_allocate->second - padding - nbytes;
+    if (padding == 0) {
+      entry_to_allocate->first += nbytes;
+      entry_to_allocate->second = tail;
+      if (tail == 0) {
+        free_.erase(entry_to_allocate);
+      }
+    } else {
+      // Keep the padding in front of the aligned block free
+      entry_to_allocate->second = padding;
+      if (tail != 0) {
+        free_.emplace(std::next(entry_to_allocate), std::pair<char*, size_t>(ptr + nbytes, tail));
+      }
+    }
   }
+  allocations_.emplace_back(std::pair<char*, size_t>(ptr, nbytes));
+  used_bytes_ += nbytes;
+  peak_used_bytes_ = std::max(peak_used_bytes_, used_bytes_);
   // DebugDump();
   return ptr;
 }
@@ -117,6 +139,7 @@ void HexagonVtcmPool::Free(void* ptr, size_t nbytes) {
   CHECK(it != allocations_.end()) << "Attempted to free a pointer that had not been allocated";
   CHECK(it->second == nbytes) << "Attempted to free a different size than was allocated";
   allocations_.erase(it);
+  used_bytes_ -= nbytes;
 
   it = std::lower_bound(free_.begin(), free_.end(), std::pair<char*, size_t>(ptr_to_free, nbytes),
                         [](auto p, auto q) { return p.first <= q.first; });
@@ -151,8 +174,29 @@ void HexagonVtcmPool::Free(void* ptr, size_t nbytes) {
   // DebugDump();
 }
 
+HexagonVtcmPoolStats HexagonVtcmPool::CollectStats() const {
+  HexagonVtcmPoolStats stats;
+  stats.num_allocations = allocations_.size();
+  stats.num_failures = num_failures_;
+  stats.used_bytes = used_bytes_;
+  stats.peak_used_bytes = peak_used_bytes_;
+  stats.num_free_segments = free_.size();
+  for (auto entry : free_) {
+    stats.free_bytes += entry.second;
+    stats.largest_free_segment = std::max(stats.largest_free_segment, entry.second);
+  }
+  return stats;
+}
+
+HexagonVtcmPoolStats HexagonVtcmPool::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return CollectStats();
+}
+
 void HexagonVtcmPool::DebugDump() {
-  LOG(INFO) << "VTCM list state";
+  HexagonVtcmPoolStats stats = CollectStats();
+  LOG(INFO) << "VTCM list state: used " << stats.used_bytes << " free " << stats.free_bytes
+            << " largest free " << stats.largest_free_segment;
   for (auto entry : allocations_) {
     LOG(INFO) << "VTCM alloc: " << static_cast<void*>(entry.first) << " " << entry.second;
   }
@@ -33,6 +33,24 @@ namespace tvm {
 namespace runtime {
 namespace hexagon {
 
+//! \brief Usage statistics of the VTCM pool.
+struct HexagonVtcmPoolStats {
+  //! \brief Number of live allocations.
+  size_t num_allocations{0};
+  //! \brief Number of allocation requests that could not be served.
+  size_t num_failures{0};
+  //! \brief Bytes held by live allocations.
+  size_t used_bytes{0};
+  //! \brief Largest number of bytes held by live allocations at once.
+  size_t peak_used_bytes{0};
+  //! \brief Bytes of the free segments.
+  size_t free_bytes{0};
+  //! \brief Number of free segments.
+  size_t num_free_segments{0};
+  //! \brief Size of the largest free segment, the largest allocation that can succeed.
+  size_t largest_free_segment{0};
+};
+
 class HexagonVtcmPool {
  public:
   //! \brief Allocates all of VTCM memory, and manages allocations from the runtime
@@ -54,6 +72,10 @@ class HexagonVtcmPool {
   HexagonVtcmPool& operator=(HexagonVtcmPool&&) = delete;
 
   /* \brief Allocate memory from the VTCM manager
+   *
+   * The smallest free segment that can hold the request is used. Sizes that are a
+   * multiple of 2k are placed 2k aligned at the front of the segment, other sizes
+   * at its back, so small blocks do not split the space of large ones.
    *
    * \param nbytes The number of bytes to allocate.
    */
@@ -73,6 +95,9 @@ class HexagonVtcmPool {
   //! \brief Returns the total number of bytes in this pool
   size_t VtcmAllocatedBytes() { return reinterpret_cast<size_t>(vtcm_allocated_size_); }
 
+  //! \brief Returns the usage statistics of the pool
+  HexagonVtcmPoolStats GetStats();
+
   bool IsVtcm(void* ptr, unsigned size) {
     auto char_ptr = static_cast<char*>(ptr);
     CHECK(char_ptr != nullptr);
@@ -107,6 +132,18 @@ class HexagonVtcmPool {
   //! \brief Mutext to protect access to the lists
   std::mutex mutex_;
 
+  //! \brief Number of failed allocation requests
+  size_t num_failures_{0};
+
+  //! \brief Bytes held by live allocations
+  size_t used_bytes_{0};
+
+  //! \brief Peak of used_bytes_
+  size_t peak_used_bytes_{0};
+
+  //! \brief Collect the statistics, the caller must hold mutex_
+  HexagonVtcmPoolStats CollectStats() const;
+
   //! \brief Debug only dump of the state of the lists
   void DebugDump();
 };
@@ -27,6 +27,7 @@
 #include <cassert>
 #include <cinttypes>
 
+#include "../hexagon_device_api.h"
 #include "conv2d.h"
 
 // Current limitations:
@@ -373,7 +374,10 @@ void conv_layer_fp16_hvx(DLTensor& cr_out, const DLTensor& cr_act,  // NOLINT(*)
     }
   };
 
-  for (int out_c = 0; out_c < cr_filt.shape[3]; ++out_c) {
+  // Each task computes the output blocks of one channel chunk, so the chunks are computed in
+  // parallel on the HVX threads of the runtime
+  HexagonThreadManager* thread_manager = HexagonDeviceAPI::Global()->ThreadManager();
+  thread_manager->ParallelFor(o_depth, [&](int out_c, int, void*) {
     for (int out_act_y = 0; out_act_y < out_height / 8; ++out_act_y) {
       int out_y = out_act_y;
       for (int out_act_x = 0; out_act_x < out_width / 4; ++out_act_x) {
@@ -396,7 +400,7 @@ void conv_layer_fp16_hvx(DLTensor& cr_out, const DLTensor& cr_act,  // NOLINT(*)
       }
       computePartialWidth(out_y, out_c, h);
     }
-  }
+  });
 }
 }  // namespace hexagon
 }  // namespace runtime
@@ -23,6 +23,7 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/device_api.h>
 
+#include "../hexagon_device_api.h"
 #include "conv2d.h"
 
 extern "C" int conv2d_packed_quant(TVMValue* args, int* type_codes, int num_args, TVMValue* out_val,
@@ -180,7 +181,10 @@ void conv_layer_int8_hvx_whole(DLTensor& cr_out, const DLTensor& cr_act,  // NOL
     *out_vec_ptr = out_vec;
   };
 
-  for (int out_c = 0; out_c < o_depth; ++out_c) {
+  // Each task computes the output blocks of one channel chunk, so the chunks are computed in
+  // parallel on the HVX threads of the runtime
+  HexagonThreadManager* thread_manager = HexagonDeviceAPI::Global()->ThreadManager();
+  thread_manager->ParallelFor(o_depth, [&](int out_c, int, void*) {
     for (int out_h = 0; out_h < o_height; ++out_h) {
       int max_y = std::min(8, out_height - out_h * 8);
       for (int out_w = 0; out_w < o_width; ++out_w) {
@@ -223,7 +227,7 @@ void conv_layer_int8_hvx_whole(DLTensor& cr_out, const DLTensor& cr_act,  // NOL
         }
       }
     }
-  }
+  });
 }
 
 }  // namespace hexagon
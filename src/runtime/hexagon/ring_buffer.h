@@ -99,12 +99,19 @@ class QueuedRingBuffer : RingBuffer<T> {
   QueuedRingBuffer(uint32_t max_queues, uint32_t ring_buff_size, std::function<bool(T*)> in_flight)
       : RingBuffer<T>(ring_buff_size, in_flight), max_queues_(max_queues) {
     queue_descriptors_.resize(max_queues_);
+    queue_ids_.resize(ring_buff_size);
   }
 
-  //! \brief Returns pointer to next T; add the queue ID for tracking
+  //! \brief Returns pointer to next T; null if ring buffer is full; add the queue ID for tracking
   T* Next(uint32_t queue_id) {
     CHECK_LT(queue_id, max_queues_);
-    queue_ids_.push_back(queue_id);
+    T* next = RingBuffer<T>::Next();
+    // nothing is tracked when full, so the caller can retry
+    if (next == nullptr) {
+      return nullptr;
+    }
+    queue_ids_[id_next_ % queue_ids_.size()] = queue_id;
+    id_next_++;
     queue_descriptor* d = &queue_descriptors_[queue_id];
     if (d->group_started) {
       // if we have a group started just update then pending count
@@ -114,7 +121,7 @@ class QueuedRingBuffer : RingBuffer<T> {
       d->groups.push(1);
       d->pending_total++;
     }
-    return RingBuffer<T>::Next();
+    return next;
   }
 
   //! \brief Returns the number of groups of Ts in flight for a given queue ID
@@ -125,9 +132,9 @@ class QueuedRingBuffer : RingBuffer<T> {
 
     uint32_t in_flight = 0;
     // look at the queue IDs for the RingBuffer entries in flight
-    for (size_t i = queue_ids_.size() - RingBuffer<T>::InFlight(); i < queue_ids_.size(); ++i) {
+    for (uint32_t i = id_next_ - RingBuffer<T>::InFlight(); i != id_next_; ++i) {
       // increment return value if in flight queue ID matches
-      if (queue_ids_[i] == queue_id) {
+      if (queue_ids_[i % queue_ids_.size()] == queue_id) {
         in_flight++;
       }
     }
@@ -180,7 +187,10 @@ class QueuedRingBuffer : RingBuffer<T> {
   };
 
   const int max_queues_;
+  //! \brief Queue IDs of the Ts, indexed like the ring buffer
   std::vector<int> queue_ids_;
+  //! \brief Tracks the ID of the next T, matching the one of the ring buffer
+  uint32_t id_next_ = 0;
   std::vector<queue_descriptor> queue_descriptors_;
 };
 
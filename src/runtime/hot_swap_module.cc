@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file hot_swap_module.cc
+ * \brief A module whose implementation can be replaced while it serves requests.
+ *
+ * Rolling out a new build of a model only takes loading the new library next to
+ * the old one and swapping it in. Calls that started before the swap finish on the
+ * old implementation, which is released once the last of them returns; calls that
+ * start after the swap run on the new one.
+ */
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "file_utils.h"
+
+namespace tvm {
+namespace runtime {
+
+class HotSwapModuleNode : public ModuleNode {
+ public:
+  explicit HotSwapModuleNode(Module mod) : mod_(std::move(mod)) {}
+
+  const char* type_key() const final { return "hot_swap"; }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "swap") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->Swap(args[0]); });
+    } else if (name == "load_and_swap") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK(args.size() == 1 || args.size() == 2)
+            << "load_and_swap expects the library path and an optional initializer";
+        Optional<PackedFunc> finit = args.size() == 2 ? args[1] : Optional<PackedFunc>(NullOpt);
+        *rv = this->LoadAndSwap(args[0], finit);
+      });
+    } else if (name == "get_current") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->Current().first; });
+    } else if (name == "get_version") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->Current().second; });
+    }
+    if (Current().first->GetFunction(name, /*query_imports=*/true) == nullptr) {
+      return PackedFunc();
+    }
+    return Forward(name, sptr_to_self);
+  }
+
+  /*!
+   * \brief Replace the implementation.
+   * \param mod The new implementation.
+   * \return The version number of the new implementation.
+   */
+  int64_t Swap(Module mod) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    mod_ = std::move(mod);
+    return ++version_;
+  }
+
+  /*!
+   * \brief Load a library and swap it in.
+   *
+   * The loader returns the library that is already open for a path, so shared
+   * libraries are loaded from a private copy placed next to the original.
+   *
+   * \param path The path to the library.
+   * \param finit When defined, maps the loaded library to the new implementation,
+   *  e.g. creating and initializing a VM. The old implementation keeps serving meanwhile.
+   * \return The version number of the new implementation.
+   */
+  int64_t LoadAndSwap(const std::string& path, Optional<PackedFunc> finit) {
+    // Serialize the rollouts, so that the last one requested wins.
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    Module lib = LoadSideBySide(path);
+    if (finit.defined()) {
+      Module mod = finit.value()(lib);
+      return Swap(mod);
+    }
+    return Swap(lib);
+  }
+
+ private:
+  /*! \return The current implementation and its version number. */
+  std::pair<Module, int64_t> Current() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {mod_, version_};
+  }
+
+  /*!
+   * \brief Create a function calling `name` on the implementation that is current when
+   *  it is invoked. The lookup is cached until the next swap.
+   */
+  PackedFunc Forward(const String& name, const ObjectPtr<Object>& sptr_to_self) {
+    struct FuncCache {
+      std::mutex mutex;
+      int64_t version{-1};
+      PackedFunc func;
+    };
+    auto cache = std::make_shared<FuncCache>();
+    return PackedFunc([sptr_to_self, this, name, cache](TVMArgs args, TVMRetValue* rv) {
+      auto [mod, version] = this->Current();
+      PackedFunc func;
+      {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        if (cache->version != version) {
+          cache->func = mod->GetFunction(name, /*query_imports=*/true);
+          cache->version = version;
+        }
+        func = cache->func;
+      }
+      ICHECK(func != nullptr) << "Function " << name << " is not available in version " << version
+                              << " of the hot swap module";
+      func.CallPacked(args, rv);
+    });
+  }
+
+  static Module LoadSideBySide(const std::string& path) {
+    std::string fmt = GetFileFormat(path, "");
+    if (fmt != "so" && fmt != "dll" && fmt != "dylib" && fmt != "dso") {
+      return Module::LoadFromFile(path, fmt);
+    }
+    static std::atomic<int64_t> counter{0};
+    size_t ext_pos = path.rfind('.');
+    std::string copy = path.substr(0, ext_pos) + ".hotswap" + std::to_string(counter++) +
+                       path.substr(ext_pos);
+    CopyFile(path, copy);
+    Module lib;
+    try {
+      lib = Module::LoadFromFile(copy, fmt);
+    } catch (...) {
+      RemoveFile(copy);
+      throw;
+    }
+#ifndef _WIN32
+    // The mapping outlives the file, the copy can be removed right away.
+    RemoveFile(copy);
+#endif
+    return lib;
+  }
+
+  /*! \brief The lock protecting mod_ and version_. */
+  mutable std::mutex mutex_;
+  /*! \brief The lock serializing LoadAndSwap. */
+  std::mutex load_mutex_;
+  /*! \brief The current implementation. */
+  Module mod_;
+  /*! \brief The number of swaps so far. */
+  int64_t version_{0};
+};
+
+TVM_REGISTER_GLOBAL("runtime.HotSwapModule").set_body_typed([](Module mod) {
+  return Module(make_object<HotSwapModuleNode>(mod));
+});
+
+}  // namespace runtime
+}  // namespace tvm
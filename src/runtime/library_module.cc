@@ -26,8 +26,16 @@
 #include <dmlc/memory_io.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -127,6 +135,135 @@ Module LoadModuleFromBinary(const std::string& type_key, dmlc::Stream* stream) {
   return (*f)(static_cast<void*>(stream));
 }
 
+/*!
+ * \brief Placeholder of an import whose deserialization is deferred to its first use.
+ *
+ * The payload is referenced in place, the object that owns the memory (e.g. the library
+ * containing the module blob) is kept alive by the placeholder.
+ */
+class LazyImportModuleNode final : public ModuleNode {
+ public:
+  LazyImportModuleNode(std::string type_key, int property_mask, const char* data, size_t size,
+                       ObjectPtr<Object> data_owner)
+      : type_key_(std::move(type_key)),
+        property_mask_(property_mask),
+        data_(data),
+        size_(size),
+        data_owner_(std::move(data_owner)) {}
+
+  const char* type_key() const final { return type_key_.c_str(); }
+
+  int GetPropertyMask() const final { return property_mask_; }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    return Materialize().GetFunction(name);
+  }
+
+  void SaveToBinary(dmlc::Stream* stream) final {
+    // The payload is exactly what SaveToBinary of the underlying module produced.
+    stream->Write(data_, size_);
+  }
+
+  void SaveToFile(const String& file_name, const String& format) final {
+    Materialize()->SaveToFile(file_name, format);
+  }
+
+  String GetSource(const String& format) final { return Materialize()->GetSource(format); }
+
+  String GetFormat() final { return Materialize()->GetFormat(); }
+
+  bool ImplementsFunction(const String& name, bool query_imports) final {
+    return Materialize()->ImplementsFunction(name, query_imports);
+  }
+
+  /*! \return Whether the underlying module has been deserialized. */
+  bool IsMaterialized() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return module_.defined();
+  }
+
+  /*! \brief Deserialize the underlying module if it has not been done yet. */
+  Module Materialize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!module_.defined()) {
+      dmlc::MemoryFixedSizeStream fs(const_cast<char*>(data_), size_);
+      Module mod = LoadModuleFromBinary(type_key_, &fs);
+      // The import tree was attached to the placeholder, hand it over.
+      auto* mod_imports = ModuleInternal::GetImportsAddr(mod.operator->());
+      mod_imports->insert(mod_imports->end(), imports_.begin(), imports_.end());
+      module_ = mod;
+    }
+    return module_;
+  }
+
+ private:
+  std::string type_key_;
+  int property_mask_;
+  const char* data_;
+  size_t size_;
+  ObjectPtr<Object> data_owner_;
+  std::mutex mutex_;
+  Module module_;
+};
+
+/*!
+ * \brief Run f(i) for every i in [0, n) on a group of threads, rethrowing the first error.
+ *
+ * Dedicated threads are used instead of the runtime thread pool, so that this function can be
+ * called from within a parallel region.
+ */
+void ParallelLoad(size_t n, const std::function<void(size_t)>& f) {
+  size_t num_threads = std::min(n, static_cast<size_t>(std::max(threading::MaxConcurrency(), 1)));
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < n; ++i) f(i);
+    return;
+  }
+  std::atomic<size_t> next{0};
+  std::vector<std::exception_ptr> errors(n);
+  auto worker = [&]() {
+    for (size_t i = next++; i < n; i = next++) {
+      try {
+        f(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) t.join();
+  for (const auto& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+bool LazyImportEnabled() {
+  const char* val = std::getenv("TVM_MODULE_LAZY_IMPORT");
+  return val == nullptr || std::string(val) != "0";
+}
+
+void MaterializeLazyImports(const Module& mod) {
+  std::vector<LazyImportModuleNode*> pending;
+  std::unordered_set<const ModuleNode*> visited{mod.operator->()};
+  std::vector<ModuleNode*> stack{const_cast<ModuleNode*>(mod.operator->())};
+  while (!stack.empty()) {
+    ModuleNode* node = stack.back();
+    stack.pop_back();
+    if (auto* lazy = dynamic_cast<LazyImportModuleNode*>(node)) {
+      if (!lazy->IsMaterialized()) pending.push_back(lazy);
+    }
+    for (const Module& m : node->imports()) {
+      if (visited.insert(m.operator->()).second) {
+        stack.push_back(const_cast<ModuleNode*>(m.operator->()));
+      }
+    }
+  }
+  ParallelLoad(pending.size(), [&](size_t i) { pending[i]->Materialize(); });
+}
+
 /*!
  * \brief Load and append module blob to module list
  * \param mblob The module blob.
@@ -152,6 +289,15 @@ void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib,
   std::vector<uint64_t> import_tree_row_ptr;
   std::vector<uint64_t> import_tree_child_indices;
   int num_dso_module = 0;
+  // The sized imports that are not yet deserialized.
+  struct SizedImport {
+    size_t module_index;
+    std::string type_key;
+    int property_mask;
+    const char* data;
+    uint64_t size;
+  };
+  std::vector<SizedImport> sized_imports;
 
   for (uint64_t i = 0; i < size; ++i) {
     std::string tkey;
@@ -168,12 +314,44 @@ void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib,
     } else if (tkey == "_import_tree") {
       ICHECK(stream->Read(&import_tree_row_ptr));
       ICHECK(stream->Read(&import_tree_child_indices));
+    } else if (tkey == kSizedImportKey) {
+      SizedImport entry;
+      entry.module_index = modules.size();
+      ICHECK(stream->Read(&entry.type_key));
+      ICHECK(stream->Read(&entry.property_mask));
+      ICHECK(stream->Read(&entry.size));
+      // Reference the payload in place and skip over it.
+      size_t offset = fs.Tell();
+      ICHECK_LE(offset + entry.size, nbytes);
+      entry.data = mblob + sizeof(nbytes) + offset;
+      fs.Seek(offset + entry.size);
+      sized_imports.emplace_back(std::move(entry));
+      modules.emplace_back(Module());
     } else {
       auto m = LoadModuleFromBinary(tkey, stream);
       modules.emplace_back(m);
     }
   }
 
+  // Sized imports are only deserialized when they are used, except for the root module, which
+  // is returned to the user as is. When lazy loading is disabled, they are deserialized in
+  // parallel.
+  bool lazy = LazyImportEnabled();
+  std::vector<const SizedImport*> eager_imports;
+  for (const SizedImport& entry : sized_imports) {
+    if (lazy && entry.module_index != 0) {
+      modules[entry.module_index] = Module(make_object<LazyImportModuleNode>(
+          entry.type_key, entry.property_mask, entry.data, entry.size, lib));
+    } else {
+      eager_imports.push_back(&entry);
+    }
+  }
+  ParallelLoad(eager_imports.size(), [&](size_t i) {
+    const SizedImport* entry = eager_imports[i];
+    dmlc::MemoryFixedSizeStream entry_stream(const_cast<char*>(entry->data), entry->size);
+    modules[entry->module_index] = LoadModuleFromBinary(entry->type_key, &entry_stream);
+  });
+
   // if we are using old dll, we don't have import tree
   // so that we can't reconstruct module relationship using import tree
   if (import_tree_row_ptr.empty()) {
@@ -225,5 +403,7 @@ Module CreateModuleFromLibrary(ObjectPtr<Library> lib, PackedFuncWrapper packed_
 
   return root_mod;
 }
+
+TVM_REGISTER_GLOBAL("runtime.ModuleMaterializeLazyImports").set_body_typed(MaterializeLazyImports);
 }  // namespace runtime
 }  // namespace tvm
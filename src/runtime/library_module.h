@@ -35,6 +35,15 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief Key of a serialized import that records the byte size of its payload.
+ *
+ * The entry is laid out as: key, type key, property mask, payload (as a sized string).
+ * Knowing the payload size up front allows the loader to skip over the entry and
+ * deserialize it on first use, or to deserialize several entries in parallel.
+ */
+constexpr const char* kSizedImportKey = "_sized_import";
+
 /*! \brief Load a module with the given type key directly from the stream.
  *  This function wraps the registry mechanism used to store type based deserializers
  *  for each runtime::Module sub-class.
@@ -119,6 +128,17 @@ ObjectPtr<Library> CreateDSOLibraryObject(std::string library_path);
  *       by parsing the binary blob section of the library.
  */
 Module CreateModuleFromLibrary(ObjectPtr<Library> lib, PackedFuncWrapper wrapper = WrapPackedFunc);
+
+/*!
+ * \brief Deserialize, in parallel, all the imports of mod whose loading was deferred.
+ *
+ * Imports stored with kSizedImportKey are loaded lazily on their first use unless the
+ * environment variable TVM_MODULE_LAZY_IMPORT is set to 0. This function can be used to
+ * move the deserialization cost ahead of the first invocation.
+ *
+ * \param mod The root of the import tree.
+ */
+void MaterializeLazyImports(const Module& mod);
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_LIBRARY_MODULE_H_
@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file measurement_env.cc
+ * \brief Control of the environment that kernels are timed in: flushing the device caches so that
+ *  every timed run starts cold, and checking that the clocks do not scale during the measurement.
+ *
+ * A backend customizes the behavior by registering
+ *  - "device_api.<device>.flush_cache": void(Device), flushing the caches of the device;
+ *  - "device_api.<device>.check_measurement_env": Array<String>(Device), reporting the reasons
+ *    why the timings on the device could be unstable.
+ * Otherwise the caches are flushed by copying through device buffers twice as large as the L2
+ * cache, which works on every device.
+ */
+#include <dmlc/thread_local.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief The number of bytes to flush when the device does not report its L2 cache size. */
+constexpr int64_t kDefaultCacheFlushBytes = 64 << 20;
+
+/*! \brief Read the first line of a file, or return an empty string if it cannot be read. */
+static std::string ReadFirstLine(const std::string& path) {
+  std::ifstream fin(path);
+  std::string line;
+  if (fin) {
+    std::getline(fin, line);
+  }
+  return line;
+}
+
+/*! \brief The per-thread device buffers used to flush the caches of each device. */
+struct CacheFlushBuffers {
+  std::map<std::pair<int, int>, std::pair<NDArray, NDArray>> buffers;
+
+  static CacheFlushBuffers* ThreadLocal() {
+    return dmlc::ThreadLocalStore<CacheFlushBuffers>::Get();
+  }
+};
+
+/*! \brief The number of bytes that are needed to evict the caches of a device. */
+static int64_t GetCacheFlushBytes(Device dev) {
+  if (dev.device_type == kDLCPU) {
+#ifdef __linux__
+    // The last level cache, as shared by the cores of the first processor
+    std::string size = ReadFirstLine("/sys/devices/system/cpu/cpu0/cache/index3/size");
+    if (!size.empty()) {
+      int64_t bytes = std::stoll(size);
+      if (size.back() == 'K') bytes <<= 10;
+      if (size.back() == 'M') bytes <<= 20;
+      return bytes * 2;
+    }
+#endif
+    return kDefaultCacheFlushBytes;
+  }
+  TVMRetValue l2_size;
+  DeviceAPI::Get(dev)->GetAttr(dev, kL2CacheSizeBytes, &l2_size);
+  if (l2_size.type_code() == kDLInt && l2_size.operator int64_t() > 0) {
+    return l2_size.operator int64_t() * 2;
+  }
+  return kDefaultCacheFlushBytes;
+}
+
+void FlushDeviceCache(Device dev) {
+  std::string name = DLDeviceType2Str(static_cast<int>(dev.device_type));
+  if (const PackedFunc* f = Registry::Get("device_api." + name + ".flush_cache")) {
+    (*f)(dev);
+    return;
+  }
+  std::pair<NDArray, NDArray>& buffers =
+      CacheFlushBuffers::ThreadLocal()->buffers[{static_cast<int>(dev.device_type), dev.device_id}];
+  if (!buffers.first.defined()) {
+    int64_t n = GetCacheFlushBytes(dev) / 4;
+    buffers.first = NDArray::Empty({n}, {kDLInt, 32, 1}, dev);
+    buffers.second = NDArray::Empty({n}, {kDLInt, 32, 1}, dev);
+  }
+  buffers.first.CopyFrom(buffers.second);
+}
+
+Array<String> CheckMeasurementEnv(Device dev) {
+  std::string name = DLDeviceType2Str(static_cast<int>(dev.device_type));
+  if (const PackedFunc* f = Registry::Get("device_api." + name + ".check_measurement_env")) {
+    return (*f)(dev);
+  }
+  Array<String> warnings;
+  if (dev.device_type != kDLCPU) {
+    return warnings;
+  }
+#ifdef __linux__
+  for (int cpu = 0;; ++cpu) {
+    std::string prefix = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    if (ReadFirstLine(prefix + "/topology/core_id").empty()) {
+      break;
+    }
+    std::string governor = ReadFirstLine(prefix + "/cpufreq/scaling_governor");
+    if (!governor.empty() && governor != "performance") {
+      warnings.push_back("The frequency governor of cpu" + std::to_string(cpu) + " is `" +
+                         governor + "` instead of `performance`, so its clock could scale");
+      break;
+    }
+  }
+  if (ReadFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo") == "0" ||
+      ReadFirstLine("/sys/devices/system/cpu/cpufreq/boost") == "1") {
+    warnings.push_back("Turbo boost is enabled, so the clock depends on the temperature");
+  }
+#endif
+  return warnings;
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.FlushDeviceCache").set_body_typed(FlushDeviceCache);
+TVM_REGISTER_GLOBAL("runtime.profiling.CheckMeasurementEnv").set_body_typed(CheckMeasurementEnv);
+
+// The preprocessing function of the time evaluator flushing the caches of the device of the
+// arguments. On CPU only the arguments but the first are flushed, line by line, which is much
+// cheaper than evicting the whole last level cache.
+TVM_REGISTER_GLOBAL("cache_flush_device").set_body([](TVMArgs args, TVMRetValue* rv) {
+  for (int i = 0; i < args.num_args; ++i) {
+    if (args.type_codes[i] != kTVMDLTensorHandle && args.type_codes[i] != kTVMNDArrayHandle) {
+      continue;
+    }
+    Device dev = args[i].operator DLTensor*()->device;
+    if (dev.device_type == kDLCPU) {
+      static const PackedFunc* f_cpu = Registry::Get("cache_flush_cpu_non_first_arg");
+      if (f_cpu != nullptr) {
+        f_cpu->CallPacked(args, rv);
+        return;
+      }
+    }
+    FlushDeviceCache(dev);
+    return;
+  }
+});
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
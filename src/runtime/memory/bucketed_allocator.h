@@ -0,0 +1,216 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/memory/bucketed_allocator.h
+ * \brief Allocator that rounds requests to geometric size classes and
+ *  reuses cached blocks by best fit.
+ */
+#ifndef TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
+#define TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+/*!
+ * \brief A caching allocator for workloads with varying allocation sizes.
+ *
+ * Unlike PooledAllocator, which only reuses a cached block of exactly the
+ * same page-rounded size, this allocator rounds every request up to a
+ * geometric size class (four classes per power of two, so at most 25% slack)
+ * and serves it from the smallest cached block that is large enough, as long
+ * as that block is not more than `max_reuse_ratio` times the request.
+ *
+ * Blocks are never split or merged because the data pointer of a Buffer is an
+ * opaque handle on several backends (e.g. OpenCL, Vulkan, Metal).
+ */
+class BucketedAllocator : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+  static constexpr size_t kDefaultMaxReuseRatio = 2;
+
+  /*! \brief Counters describing the state of the allocator. */
+  struct Stats {
+    /*! \brief Bytes of blocks currently handed out. */
+    size_t bytes_in_use = 0;
+    /*! \brief Bytes of blocks cached in the free lists. */
+    size_t bytes_cached = 0;
+    /*! \brief Bytes actually requested by the live allocations. */
+    size_t bytes_requested = 0;
+    /*! \brief Number of calls into the device allocation API. */
+    size_t num_device_allocs = 0;
+    /*! \brief Number of requests served from the free lists. */
+    size_t num_reuses = 0;
+    /*!
+     * \brief Fraction of the device memory held by the allocator that is
+     *  not backing requested bytes, including both rounding slack and cache.
+     */
+    double FragmentationRatio() const {
+      size_t held = bytes_in_use + bytes_cached;
+      if (held == 0) return 0.0;
+      return 1.0 - static_cast<double>(bytes_requested) / static_cast<double>(held);
+    }
+  };
+
+  explicit BucketedAllocator(size_t page_size = kDefaultPageSize,
+                             size_t max_reuse_ratio = kDefaultMaxReuseRatio)
+      : Allocator(kBucketed), page_size_(page_size), max_reuse_ratio_(max_reuse_ratio) {
+    ICHECK_GT(page_size_, 0);
+    ICHECK_GE(max_reuse_ratio_, 1);
+  }
+
+  ~BucketedAllocator() { ReleaseAll(); }
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    size_t size = SizeClass(nbytes);
+    auto it = free_blocks_.lower_bound(size);
+    if (it != free_blocks_.end() && it->first <= size * max_reuse_ratio_) {
+      Buffer ret = it->second;
+      free_blocks_.erase(it);
+      stats_.bytes_cached -= ret.size;
+      stats_.num_reuses += 1;
+      OnHandOut(ret, nbytes);
+      return ret;
+    }
+    Buffer buf;
+    buf.device = dev;
+    buf.size = size;
+    buf.alloc_type = kBucketed;
+    try {
+      buf.data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "BucketedAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all unused memory and reallocate...";
+      ReleaseAll();
+      buf.data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    }
+    stats_.num_device_allocs += 1;
+    OnHandOut(buf, nbytes);
+    VLOG(1) << "allocate " << size << " B for a request of " << nbytes << " B, used memory "
+            << UsedMemory() << " B";
+    return buf;
+  }
+
+  Buffer Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
+               const std::string& mem_scope) override {
+    if (AllowMemoryScope(mem_scope)) {
+      return Allocator::Alloc(dev, shape, type_hint, mem_scope);
+    }
+    LOG(FATAL) << "This alloc should be implemented";
+    return {};
+  }
+
+  void Free(const Buffer& buffer) override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    auto it = live_requested_.find(buffer.data);
+    if (it != live_requested_.end()) {
+      stats_.bytes_requested -= it->second;
+      live_requested_.erase(it);
+    }
+    stats_.bytes_in_use -= buffer.size;
+    stats_.bytes_cached += buffer.size;
+    free_blocks_.emplace(buffer.size, buffer);
+    VLOG(1) << "reclaim buffer " << buffer.size;
+  }
+
+  void Clear() override { ReleaseAll(); }
+
+  size_t UsedMemory() const override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    return stats_.bytes_in_use + stats_.bytes_cached;
+  }
+
+  /*! \return A snapshot of the allocator counters. */
+  Stats GetStats() const {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    return stats_;
+  }
+
+  /*!
+   * \brief Round a request up to its size class.
+   * \param nbytes The requested number of bytes.
+   * \return The number of bytes that will be allocated for the request.
+   */
+  size_t SizeClass(size_t nbytes) const {
+    size_t pages = std::max<size_t>((nbytes + page_size_ - 1) / page_size_, 1);
+    if (pages <= kClassesPerDoubling) return pages * page_size_;
+    // Keep the top log2(kClassesPerDoubling) + 1 bits of the page count and round up the rest.
+    size_t msb = 0;
+    while ((pages >> (msb + 1)) != 0) ++msb;
+    size_t step = size_t(1) << (msb - 2);
+    return (pages + step - 1) / step * step * page_size_;
+  }
+
+ protected:
+  virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
+                                     DLDataType type_hint) {
+    return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
+  }
+
+  virtual void DeviceFreeDataSpace(Device dev, void* ptr) {
+    DeviceAPI::Get(dev)->FreeDataSpace(dev, ptr);
+  }
+
+  /*! \brief Release all the cached blocks back to the device. */
+  virtual void ReleaseAll() {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    for (auto const& it : free_blocks_) {
+      DeviceFreeDataSpace(it.second.device, it.second.data);
+    }
+    free_blocks_.clear();
+    stats_.bytes_cached = 0;
+    VLOG(1) << "release all cached buffers";
+  }
+
+ private:
+  /*! \brief Number of size classes between two consecutive powers of two. */
+  static constexpr size_t kClassesPerDoubling = 4;
+
+  void OnHandOut(const Buffer& buf, size_t nbytes) {
+    stats_.bytes_in_use += buf.size;
+    stats_.bytes_requested += nbytes;
+    live_requested_[buf.data] = nbytes;
+  }
+
+  size_t page_size_;
+  size_t max_reuse_ratio_;
+  /*! \brief Cached blocks ordered by size, for best-fit lookup. */
+  std::multimap<size_t, Buffer> free_blocks_;
+  /*! \brief The requested size of each live block. */
+  std::unordered_map<void*, size_t> live_requested_;
+  Stats stats_;
+  mutable std::recursive_mutex mu_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
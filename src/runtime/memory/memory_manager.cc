@@ -22,12 +22,16 @@
  * \brief Allocate and manage memory for the runtime.
  */
 #include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
 #include <memory>
+#include <string>
 #include <utility>
 
+#include "bucketed_allocator.h"
 #include "naive_allocator.h"
+#include "pinned_allocator.h"
 #include "pooled_allocator.h"
 
 namespace tvm {
@@ -103,9 +107,12 @@ NDArray StorageObj::AllocNDArray(int64_t offset, ShapeTuple shape, DLDataType dt
   // buffer intact.
   container->manager_ctx = reinterpret_cast<void*>(this);
 
-  if (this->buffer.device.device_type == kDLHexagon) {
-    // For Hexagon, non-zero offset support simply requires adjusting the
-    // beginning of data pointer
+  DLDeviceType device_type = this->buffer.device.device_type;
+  if (device_type == kDLHexagon || device_type == kDLCPU || device_type == kDLCUDA ||
+      device_type == kDLCUDAHost || device_type == kDLCUDAManaged || device_type == kDLROCM ||
+      device_type == kDLROCMHost) {
+    // For the devices whose buffers are plain pointers, non-zero offset support simply requires
+    // adjusting the beginning of data pointer, as the kernels expect a zero byte offset
     auto offset_ptr = reinterpret_cast<uint8_t*>(this->buffer.data) + offset;
     container->dl_tensor.data = reinterpret_cast<void*>(offset_ptr);
     container->dl_tensor.byte_offset = 0;
@@ -147,6 +154,28 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
         alloc.reset(new PooledAllocator());
         break;
       }
+      case kBucketed: {
+        VLOG(1) << "New bucketed allocator for " << dev;
+        alloc.reset(new BucketedAllocator());
+        break;
+      }
+      case kPinned: {
+        VLOG(1) << "New pinned allocator for " << dev;
+        alloc.reset(new PinnedAllocator());
+        break;
+      }
+      case kStreamOrdered: {
+        VLOG(1) << "New stream-ordered allocator for " << dev;
+        // The pools are specific to the device API, which creates the allocator
+        std::string name = "runtime.memory.stream_ordered_allocator." +
+                           std::string(DLDeviceType2Str(dev.device_type));
+        const PackedFunc* f_create = Registry::Get(name);
+        ICHECK(f_create != nullptr)
+            << "ValueError: Stream-ordered allocation is not supported for " << dev;
+        void* ptr = (*f_create)(dev);
+        alloc.reset(static_cast<Allocator*>(ptr));
+        break;
+      }
       default:
         LOG(FATAL) << "Unknown allocator type: " << type;
     }
@@ -201,6 +230,8 @@ NDArray Allocator::Empty(ShapeTuple shape, DLDataType dtype, DLDevice dev,
   }
   container->manager_ctx = reinterpret_cast<void*>(buffer);
   container->dl_tensor.data = buffer->data;
+  // Allocators such as kPinned place the buffer on a device other than the requested one.
+  container->dl_tensor.device = buffer->device;
   return NDArray(GetObjectPtr<Object>(container));
 }
 
@@ -230,6 +261,24 @@ void Allocator::Clear() {
 
 TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.clear").set_body_typed(MemoryManager::Clear);
 
+TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.bucketed_allocator_stats")
+    .set_body_typed([](Device dev) {
+      auto* alloc = static_cast<BucketedAllocator*>(MemoryManager::GetAllocator(dev, kBucketed));
+      BucketedAllocator::Stats stats = alloc->GetStats();
+      auto count = [](size_t value) {
+        return ObjectRef(make_object<profiling::CountNode>(static_cast<int64_t>(value)));
+      };
+      Map<String, ObjectRef> ret;
+      ret.Set("bytes_in_use", count(stats.bytes_in_use));
+      ret.Set("bytes_cached", count(stats.bytes_cached));
+      ret.Set("bytes_requested", count(stats.bytes_requested));
+      ret.Set("num_device_allocs", count(stats.num_device_allocs));
+      ret.Set("num_reuses", count(stats.num_reuses));
+      ret.Set("fragmentation_ratio",
+              ObjectRef(make_object<profiling::RatioNode>(stats.FragmentationRatio())));
+      return ret;
+    });
+
 }  // namespace memory
 }  // namespace runtime
 }  // namespace tvm
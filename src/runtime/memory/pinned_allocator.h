@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/memory/pinned_allocator.h
+ */
+#ifndef TVM_RUNTIME_MEMORY_PINNED_ALLOCATOR_H_
+#define TVM_RUNTIME_MEMORY_PINNED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include "pooled_allocator.h"
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+/*!
+ * \brief An allocator of page-locked host memory for the accelerator of a device.
+ *
+ * Requests for a CUDA or ROCm device are served with cudaHostAlloc/hipHostMalloc
+ * memory on the corresponding host device type, which the accelerator can copy
+ * from and to asynchronously. Pinning is expensive, so freed buffers are cached
+ * the same way as in PooledAllocator. Requests for the CPU are served with
+ * ordinary host memory.
+ */
+class PinnedAllocator final : public PooledAllocator {
+ public:
+  PinnedAllocator() : PooledAllocator(kPinned, kDefaultPageSize, GetDefaultThreadCacheBytes()) {}
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    return PooledAllocator::Alloc(GetPinnedDevice(dev), nbytes, alignment, type_hint);
+  }
+
+  /*! \return The host device whose memory is pinned for the given device. */
+  static Device GetPinnedDevice(Device dev) {
+    switch (dev.device_type) {
+      case kDLCPU:
+      case kDLCUDAHost:
+      case kDLROCMHost:
+        return dev;
+      case kDLCUDA:
+        return Device{kDLCUDAHost, dev.device_id};
+      case kDLROCM:
+        return Device{kDLROCMHost, dev.device_id};
+      default:
+        LOG(FATAL) << "Pinned memory is not supported for " << dev;
+        return dev;
+    }
+  }
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_MEMORY_PINNED_ALLOCATOR_H_
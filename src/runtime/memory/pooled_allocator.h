@@ -27,6 +27,8 @@
 #include <tvm/runtime/memory/memory_manager.h>
 
 #include <atomic>
+#include <cstdlib>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -36,18 +38,52 @@ namespace tvm {
 namespace runtime {
 namespace memory {
 
+/*!
+ * \brief An allocator that caches freed buffers by page-rounded size.
+ *
+ * In front of the shared pool, every thread keeps a small cache of freed
+ * buffers, so that the alloc/free pairs issued by one thread do not contend
+ * on the pool mutex. The bytes cached by each thread are capped, and each
+ * cache is periodically flushed to the shared pool so that buffers freed by
+ * one thread become visible to the others.
+ */
 class PooledAllocator : public Allocator {
  public:
   static constexpr size_t kDefaultPageSize = 4096;
+  /*! \brief The default cap of the bytes cached by each thread. */
+  static constexpr size_t kDefaultThreadCacheBytes = 64 << 20;
+  /*! \brief The number of frees after which a thread cache is flushed. */
+  static constexpr size_t kThreadCacheFlushInterval = 4096;
 
-  explicit PooledAllocator(size_t page_size = kDefaultPageSize)
-      : Allocator(kPooled), page_size_(page_size), used_memory_(0) {}
+  /*!
+   * \brief Construct a pooled allocator.
+   * \param page_size The granularity of the allocation sizes.
+   * \param thread_cache_bytes The maximum bytes cached by each thread, zero disables
+   *  the thread caches. Defaults to the value of the environment variable
+   *  TVM_POOLED_ALLOCATOR_THREAD_CACHE_BYTES, or kDefaultThreadCacheBytes if unset.
+   */
+  explicit PooledAllocator(size_t page_size = kDefaultPageSize,
+                           size_t thread_cache_bytes = GetDefaultThreadCacheBytes())
+      : PooledAllocator(kPooled, page_size, thread_cache_bytes) {}
 
-  ~PooledAllocator() { ReleaseAll(); }
+  ~PooledAllocator() {
+    DrainThreadCaches(/*detach=*/true);
+    ReleaseAll();
+  }
 
   Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
     size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
+    if (ThreadCache* cache = GetThreadCache()) {
+      std::lock_guard<std::mutex> cache_lock(cache->mu);
+      auto it = cache->pool.find(size);
+      if (it != cache->pool.end() && !it->second.empty()) {
+        auto ret = it->second.back();
+        it->second.pop_back();
+        cache->cached_bytes -= size;
+        return ret;
+      }
+    }
+    std::unique_lock<std::recursive_mutex> lock(mu_);
     auto&& it = memory_pool_.find(size);
     if (it != memory_pool_.end() && !it->second.empty()) {
       auto&& pool = it->second;
@@ -58,13 +94,16 @@ class PooledAllocator : public Allocator {
     Buffer buf;
     buf.device = dev;
     buf.size = size;
-    buf.alloc_type = kPooled;
+    buf.alloc_type = type();
     try {
       buf.data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
     } catch (InternalError& err) {
       LOG(WARNING) << "PooledAllocator got InternalError during allocation: " << err.message();
       LOG(WARNING) << "Trying to release all unused memory and reallocate...";
+      // The thread caches must not be locked while holding the pool mutex.
+      lock.unlock();
       ReleaseAll();
+      lock.lock();
       buf.data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
     }
 
@@ -83,6 +122,18 @@ class PooledAllocator : public Allocator {
   }
 
   void Free(const Buffer& buffer) override {
+    if (ThreadCache* cache = GetThreadCache()) {
+      std::lock_guard<std::mutex> cache_lock(cache->mu);
+      if (buffer.size <= thread_cache_bytes_) {
+        if (cache->cached_bytes + buffer.size > thread_cache_bytes_ ||
+            ++cache->num_frees >= kThreadCacheFlushInterval) {
+          FlushThreadCache(cache);
+        }
+        cache->pool[buffer.size].push_back(buffer);
+        cache->cached_bytes += buffer.size;
+        return;
+      }
+    }
     std::lock_guard<std::recursive_mutex> lock(mu_);
     if (memory_pool_.find(buffer.size) == memory_pool_.end()) {
       memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
@@ -96,6 +147,22 @@ class PooledAllocator : public Allocator {
   size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
 
  protected:
+  /*! \brief Construct a pooled allocator reported as another allocator type. */
+  PooledAllocator(AllocatorType type, size_t page_size, size_t thread_cache_bytes)
+      : Allocator(type),
+        page_size_(page_size),
+        used_memory_(0),
+        thread_cache_bytes_(thread_cache_bytes),
+        id_(NextAllocatorId()) {}
+
+  static size_t GetDefaultThreadCacheBytes() {
+    const char* val = getenv("TVM_POOLED_ALLOCATOR_THREAD_CACHE_BYTES");
+    if (!val) {
+      return kDefaultThreadCacheBytes;
+    }
+    return std::strtoull(val, nullptr, 10);
+  }
+
   virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
                                      DLDataType type_hint) {
     return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
@@ -106,6 +173,7 @@ class PooledAllocator : public Allocator {
   }
 
   virtual void ReleaseAll() {
+    DrainThreadCaches(/*detach=*/false);
     std::lock_guard<std::recursive_mutex> lock(mu_);
     for (auto const& it : memory_pool_) {
       auto const& pool = it.second;
@@ -118,11 +186,112 @@ class PooledAllocator : public Allocator {
     VLOG(1) << "release all buffers";
   }
 
+ private:
+  /*!
+   * \brief The free buffers cached by one thread.
+   * \note Lock order: a cache mutex may be held while acquiring the pool
+   *  mutex, never the other way around.
+   */
+  struct ThreadCache {
+    std::mutex mu;
+    /*! \brief The allocator this cache belongs to, nullptr once it is destroyed. */
+    PooledAllocator* owner{nullptr};
+    std::unordered_map<size_t, std::vector<Buffer>> pool;
+    size_t cached_bytes{0};
+    size_t num_frees{0};
+  };
+
+  /*! \brief Owns the caches of the current thread and flushes them at thread exit. */
+  struct ThreadCacheRegistry {
+    std::unordered_map<uint64_t, std::shared_ptr<ThreadCache>> caches;
+
+    ~ThreadCacheRegistry() {
+      for (auto& kv : caches) {
+        ThreadCache* cache = kv.second.get();
+        std::lock_guard<std::mutex> cache_lock(cache->mu);
+        if (cache->owner != nullptr) {
+          cache->owner->FlushThreadCache(cache);
+          cache->owner->UnregisterThreadCache(cache);
+          cache->owner = nullptr;
+        }
+      }
+    }
+  };
+
+  static uint64_t NextAllocatorId() {
+    static std::atomic<uint64_t> next_id{0};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /*! \return The cache of the current thread, or nullptr if thread caching is disabled. */
+  ThreadCache* GetThreadCache() {
+    if (thread_cache_bytes_ == 0) return nullptr;
+    static thread_local ThreadCacheRegistry registry;
+    auto it = registry.caches.find(id_);
+    if (it != registry.caches.end()) return it->second.get();
+    auto cache = std::make_shared<ThreadCache>();
+    cache->owner = this;
+    {
+      std::lock_guard<std::recursive_mutex> lock(mu_);
+      thread_caches_.push_back(cache);
+    }
+    return registry.caches.emplace(id_, std::move(cache)).first->second.get();
+  }
+
+  /*! \brief Move all buffers of a cache to the shared pool. Requires cache->mu to be held. */
+  void FlushThreadCache(ThreadCache* cache) {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    for (auto& kv : cache->pool) {
+      auto& pool = memory_pool_[kv.first];
+      pool.insert(pool.end(), kv.second.begin(), kv.second.end());
+    }
+    cache->pool.clear();
+    cache->cached_bytes = 0;
+    cache->num_frees = 0;
+  }
+
+  void UnregisterThreadCache(ThreadCache* cache) {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    for (auto it = thread_caches_.begin(); it != thread_caches_.end(); ++it) {
+      if (it->get() == cache) {
+        thread_caches_.erase(it);
+        break;
+      }
+    }
+  }
+
+  /*!
+   * \brief Flush the caches of all threads to the shared pool.
+   * \param detach Whether to disconnect the caches from this allocator.
+   */
+  void DrainThreadCaches(bool detach) {
+    std::vector<std::shared_ptr<ThreadCache>> caches;
+    {
+      std::lock_guard<std::recursive_mutex> lock(mu_);
+      caches = thread_caches_;
+      if (detach) thread_caches_.clear();
+    }
+    for (const auto& cache : caches) {
+      std::lock_guard<std::mutex> cache_lock(cache->mu);
+      if (cache->owner == nullptr) continue;
+      FlushThreadCache(cache.get());
+      if (detach) cache->owner = nullptr;
+    }
+  }
+
  protected:
   size_t page_size_;
   std::atomic<size_t> used_memory_;
   std::unordered_map<size_t, std::vector<Buffer>> memory_pool_;
   std::recursive_mutex mu_;
+
+ private:
+  /*! \brief The maximum bytes cached by each thread. */
+  size_t thread_cache_bytes_;
+  /*! \brief The unique id of this allocator, used to look up the thread caches. */
+  uint64_t id_;
+  /*! \brief The caches of all threads that have used this allocator. */
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
 };
 
 }  // namespace memory
@@ -28,6 +28,7 @@
 #import <Metal/MTLBuffer.h>
 #import <Metal/MTLCommandBuffer.h>
 #import <Metal/MTLCommandQueue.h>
+#import <Metal/MTLComputeCommandEncoder.h>
 #import <Metal/MTLDevice.h>
 #import <Metal/MTLLibrary.h>
 #include <tvm/runtime/c_runtime_api.h>
@@ -35,8 +36,11 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -107,8 +111,16 @@ class AutoReleasePoolWrapper {
  */
 class Stream {
  public:
-  explicit Stream(id<MTLDevice> device) { queue_ = [device newCommandQueue]; }
-  ~Stream() { [queue_ release]; }
+  explicit Stream(id<MTLDevice> device) {
+    queue_ = [device newCommandQueue];
+    if (const char* env = std::getenv("TVM_METAL_MAX_DISPATCH_BATCH")) {
+      max_pending_dispatches_ = std::max(1, std::atoi(env));
+    }
+  }
+  ~Stream() {
+    FlushCommandBuffer();
+    [queue_ release];
+  }
   id<MTLCommandBuffer> GetCommandBuffer(std::string label = "", bool attach_error_callback = true) {
     id<MTLCommandBuffer> cb = [queue_ commandBuffer];
     if (!label.empty()) {
@@ -123,6 +135,64 @@ class Stream {
     return cb;
   }
 
+  /*!
+   * \brief Get the compute encoder that kernel launches are grouped into.
+   *
+   * Kernels launched on the stream are encoded into one compute encoder of a
+   * pending command buffer, which is committed by FlushCommandBuffer.  The
+   * encoder uses serial dispatch, so launches keep their stream order.
+   * \param kernel_name The name of the kernel, used in the error message.
+   * \return The pending compute encoder.
+   */
+  id<MTLComputeCommandEncoder> GetPendingComputeEncoder(const std::string& kernel_name) {
+    if (pending_command_buffer_ == nil) {
+      pending_command_buffer_ = [[queue_ commandBuffer] retain];
+      pending_command_buffer_.label = @"TVMKernels";
+      pending_compute_encoder_ = [[pending_command_buffer_ computeCommandEncoder] retain];
+    }
+    pending_kernel_names_.push_back(kernel_name);
+    return pending_compute_encoder_;
+  }
+
+  /*!
+   * \brief Mark the end of a kernel launch on the pending encoder.
+   *  Commits the pending command buffer once the dispatch batch is full,
+   *  so the GPU does not stay idle until the next synchronization.
+   */
+  void FinishDispatch() {
+    if (pending_kernel_names_.size() >= static_cast<size_t>(max_pending_dispatches_)) {
+      FlushCommandBuffer();
+    }
+  }
+
+  /*!
+   * \brief End the pending compute encoder and commit its command buffer.
+   *  Must be called before any other command buffer is committed to the queue.
+   */
+  void FlushCommandBuffer() {
+    if (pending_command_buffer_ == nil) return;
+    [pending_compute_encoder_ endEncoding];
+    std::vector<std::string> kernel_names = std::move(pending_kernel_names_);
+    pending_kernel_names_.clear();
+    [pending_command_buffer_ addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+      if (buffer.status == MTLCommandBufferStatusError) {
+        ICHECK(buffer.error != nil);
+        std::ostringstream os;
+        os << "GPUError happens after running ";
+        for (size_t i = 0; i < kernel_names.size(); ++i) {
+          os << (i == 0 ? "" : ", ") << kernel_names[i];
+        }
+        os << ": " << buffer.error.localizedDescription.UTF8String;
+        this->SetError(os.str());
+      }
+    }];
+    [pending_command_buffer_ commit];
+    [pending_compute_encoder_ release];
+    [pending_command_buffer_ release];
+    pending_compute_encoder_ = nil;
+    pending_command_buffer_ = nil;
+  }
+
   void SetError(std::string error_description) {
     error_happened_ = true;
     error_description_ = std::move(error_description);
@@ -135,6 +205,14 @@ class Stream {
  private:
   // Queue
   id<MTLCommandQueue> queue_;
+  // Command buffer holding the grouped kernel launches, nil if none is pending
+  id<MTLCommandBuffer> pending_command_buffer_{nil};
+  // Compute encoder of the pending command buffer
+  id<MTLComputeCommandEncoder> pending_compute_encoder_{nil};
+  // Names of the kernels encoded in the pending command buffer
+  std::vector<std::string> pending_kernel_names_;
+  // Maximum number of grouped launches before the pending command buffer is committed
+  int max_pending_dispatches_{32};
   // Check if error happened in one previous run
   bool error_happened_{false};
   // error description
@@ -170,6 +248,12 @@ class MetalWorkspace final : public DeviceAPI {
   void StreamSync(Device dev, TVMStreamHandle stream) final;
   void SetStream(Device dev, TVMStreamHandle stream) final;
   TVMStreamHandle GetCurrentStream(Device dev) final;
+  TVMEventHandle CreateEvent(Device dev) final;
+  void FreeEvent(Device dev, TVMEventHandle event) final;
+  void RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) final;
+  void EventSync(Device dev, TVMEventHandle event) final;
+  bool EventQuery(Device dev, TVMEventHandle event) final;
+  void StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event) final;
   void* AllocWorkspace(Device dev, size_t size, DLDataType type_hint) final;
   void FreeWorkspace(Device dev, void* data) final;
   void ReinitializeDefaultStreams();
@@ -227,6 +227,8 @@ void MetalWorkspace::CopyDataFromTo(const void* from, size_t from_offset, void*
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "GPUError: " << s->ErrorDescription();
     }
+    // keep the copy ordered after the kernels grouped on the stream
+    s->FlushCommandBuffer();
     id<MTLCommandBuffer> cb = s->GetCommandBuffer(/*label=*/"TVMCopyDataFromTo");
     int from_dev_type = static_cast<int>(dev_from.device_type);
     int to_dev_type = static_cast<int>(dev_to.device_type);
@@ -299,6 +301,7 @@ void MetalWorkspace::FreeStream(Device dev, TVMStreamHandle stream) {
 void MetalWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   AUTORELEASEPOOL {
     Stream* s = CastStreamOrGetDefault(stream, dev.device_id);
+    s->FlushCommandBuffer();
     // commit an empty command buffer and wait until it completes.
     id<MTLCommandBuffer> cb = s->GetCommandBuffer(/*label=*/"TVMStreamSync");
     [cb commit];
@@ -320,6 +323,72 @@ TVMStreamHandle MetalWorkspace::GetCurrentStream(Device dev) {
   return MetalThreadEntry::ThreadLocal()->stream[dev.device_id];
 }
 
+/*!
+ * \brief A device event, backed by a shared event that is signaled with an
+ *  increasing value each time the event is recorded.
+ */
+struct MetalEvent {
+  id<MTLSharedEvent> event;
+  // The value signaled by the latest recording.
+  uint64_t value{0};
+  // The command buffer that signals the latest recording.
+  id<MTLCommandBuffer> signal_cb{nil};
+};
+
+TVMEventHandle MetalWorkspace::CreateEvent(Device dev) {
+  MetalEvent* evt = new MetalEvent();
+  evt->event = [GetDevice(dev) newSharedEvent];
+  return static_cast<TVMEventHandle>(evt);
+}
+
+void MetalWorkspace::FreeEvent(Device dev, TVMEventHandle event) {
+  MetalEvent* evt = static_cast<MetalEvent*>(event);
+  if (evt->signal_cb != nil) [evt->signal_cb release];
+  [evt->event release];
+  delete evt;
+}
+
+void MetalWorkspace::RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) {
+  AUTORELEASEPOOL {
+    MetalEvent* evt = static_cast<MetalEvent*>(event);
+    Stream* s = CastStreamOrGetDefault(stream, dev.device_id);
+    // The kernels batched in the pending command buffer are part of the recorded work.
+    s->FlushCommandBuffer();
+    id<MTLCommandBuffer> cb = s->GetCommandBuffer(/*label=*/"TVMRecordEvent");
+    [cb encodeSignalEvent:evt->event value:++evt->value];
+    [cb commit];
+    if (evt->signal_cb != nil) [evt->signal_cb release];
+    evt->signal_cb = [cb retain];
+  };
+}
+
+void MetalWorkspace::EventSync(Device dev, TVMEventHandle event) {
+  MetalEvent* evt = static_cast<MetalEvent*>(event);
+  if (evt->signal_cb == nil) return;
+  [evt->signal_cb waitUntilCompleted];
+  if (evt->signal_cb.status == MTLCommandBufferStatusError) {
+    LOG(FATAL) << "GPUError: " << evt->signal_cb.error.localizedDescription.UTF8String;
+  }
+}
+
+bool MetalWorkspace::EventQuery(Device dev, TVMEventHandle event) {
+  MetalEvent* evt = static_cast<MetalEvent*>(event);
+  return evt->event.signaledValue >= evt->value;
+}
+
+void MetalWorkspace::StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event) {
+  AUTORELEASEPOOL {
+    MetalEvent* evt = static_cast<MetalEvent*>(event);
+    if (evt->value == 0) return;
+    Stream* s = CastStreamOrGetDefault(stream, dev.device_id);
+    // The wait must come before the kernels launched after this call.
+    s->FlushCommandBuffer();
+    id<MTLCommandBuffer> cb = s->GetCommandBuffer(/*label=*/"TVMStreamWaitEvent");
+    [cb encodeWaitForEvent:evt->event value:evt->value];
+    [cb commit];
+  };
+}
+
 void* MetalWorkspace::AllocWorkspace(Device dev, size_t size, DLDataType type_hint) {
   return MetalThreadEntry::ThreadLocal()->pool.AllocWorkspace(dev, size);
 }
@@ -328,6 +328,29 @@ void NDArray::CopyFromTo(const DLTensor* from, DLTensor* to, TVMStreamHandle str
   DeviceAPI::Get(dev)->CopyDataFromTo(const_cast<DLTensor*>(from), to, stream);
 }
 
+/*! \brief The device whose stream carries out a copy between the two tensors. */
+static Device GetCopyDevice(const DLTensor* from, const DLTensor* to) {
+  auto is_host = [](const Device& dev) {
+    return dev.device_type == kDLCPU || dev.device_type == kDLCUDAHost ||
+           dev.device_type == kDLROCMHost;
+  };
+  return is_host(from->device) ? to->device : from->device;
+}
+
+DeviceEvent NDArray::CopyFromAsync(const NDArray& other, TVMStreamHandle stream) {
+  ICHECK(data_ != nullptr);
+  ICHECK(other.data_ != nullptr);
+  const DLTensor* from = &(other.get_mutable()->dl_tensor);
+  DLTensor* to = &(get_mutable()->dl_tensor);
+  CopyFromTo(from, to, stream);
+  return DeviceEvent::Record(GetCopyDevice(from, to), stream);
+}
+
+DeviceEvent NDArray::CopyToAsync(const NDArray& other, TVMStreamHandle stream) const {
+  ICHECK(other.defined());
+  return const_cast<NDArray&>(other).CopyFromAsync(*this, stream);
+}
+
 ShapeTuple NDArray::Shape() const {
   return static_cast<const NDArray::Container*>(data_.get())->shape_;
 }
@@ -351,6 +374,42 @@ bool NDArray::IsAligned(const DLTensor& tensor) {
 
 TVM_REGISTER_OBJECT_TYPE(NDArray::Container);
 
+DeviceEventObj::~DeviceEventObj() {
+  if (handle != nullptr) {
+    DeviceAPI::Get(device)->FreeEvent(device, handle);
+  }
+}
+
+DeviceEvent DeviceEvent::Record(Device dev, TVMStreamHandle stream) {
+  DeviceAPI* api = DeviceAPI::Get(dev);
+  ObjectPtr<DeviceEventObj> n = make_object<DeviceEventObj>();
+  n->device = dev;
+  n->handle = api->CreateEvent(dev);
+  api->RecordEvent(dev, n->handle, stream);
+  return DeviceEvent(n);
+}
+
+void DeviceEvent::Synchronize() const {
+  const DeviceEventObj* n = operator->();
+  if (n->handle != nullptr) {
+    DeviceAPI::Get(n->device)->EventSync(n->device, n->handle);
+  }
+}
+
+bool DeviceEvent::Query() const {
+  const DeviceEventObj* n = operator->();
+  return n->handle == nullptr || DeviceAPI::Get(n->device)->EventQuery(n->device, n->handle);
+}
+
+void DeviceEvent::StreamWait(TVMStreamHandle stream) const {
+  const DeviceEventObj* n = operator->();
+  if (n->handle != nullptr) {
+    DeviceAPI::Get(n->device)->StreamWaitEvent(n->device, stream, n->handle);
+  }
+}
+
+TVM_REGISTER_OBJECT_TYPE(DeviceEventObj);
+
 }  // namespace runtime
 }  // namespace tvm
 
@@ -386,6 +445,15 @@ TVM_REGISTER_GLOBAL("runtime.TVMArrayAllocWithScope").set_body_typed(NDArray::Em
 
 TVM_REGISTER_GLOBAL("runtime.TVMArrayCreateView").set_body_method(&NDArray::CreateView);
 
+TVM_REGISTER_GLOBAL("runtime.TVMArrayCopyFromAsync")
+    .set_body_typed([](NDArray to, NDArray from, void* stream) {
+      return to.CopyFromAsync(from, stream);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.DeviceEventSynchronize").set_body_method(&DeviceEvent::Synchronize);
+
+TVM_REGISTER_GLOBAL("runtime.DeviceEventQuery").set_body_method(&DeviceEvent::Query);
+
 int TVMArrayFree(TVMArrayHandle handle) {
   API_BEGIN();
   NDArray::Internal::FFIDecRef(handle);
@@ -21,11 +21,13 @@
  * \brief Object type management system.
  */
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/registry.h>
 
 #include <iostream>
 #include <mutex>
+#include <new>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -227,6 +229,113 @@ uint32_t Object::TypeKey2Index(const std::string& key) {
   return TypeContext::Global()->TypeKey2Index(key);
 }
 
+namespace detail {
+
+/*!
+ * \brief Per-thread cache of small blocks, one free list per size class.
+ *
+ * Every block starts with a header of kPoolAllocAlignment bytes that records its size
+ * class, so that a block can be released without knowing its size.
+ */
+class PoolThreadCache {
+ public:
+  /*! \brief The size granularity of the size classes. */
+  static constexpr size_t kGranularity = kPoolAllocAlignment;
+  /*! \brief The number of size classes, larger blocks are not cached. */
+  static constexpr uint32_t kNumSizeClasses = 16;
+  /*! \brief The size class of the blocks that are not cached. */
+  static constexpr uint32_t kUncached = kNumSizeClasses;
+#if defined(__SANITIZE_ADDRESS__)
+  // Keep use-after-free detectable by the address sanitizer.
+  static constexpr size_t kMaxCachedBlocks = 0;
+#else
+  /*! \brief The maximum number of cached blocks per size class. */
+  static constexpr size_t kMaxCachedBlocks = 256;
+#endif
+
+  ~PoolThreadCache() {
+    for (FreeList& list : free_lists_) {
+      while (list.head != nullptr) {
+        FreeBlock* next = list.head->next;
+        ::operator delete(list.head, std::align_val_t(kPoolAllocAlignment));
+        list.head = next;
+      }
+    }
+    destroyed_ = true;
+  }
+
+  /*! \return The cache of the calling thread, nullptr if it has been destroyed. */
+  static PoolThreadCache* Get() {
+    if (destroyed_) return nullptr;
+    static thread_local PoolThreadCache cache;
+    return &cache;
+  }
+
+  static void* Alloc(size_t nbytes) {
+    size_t block_size = nbytes + kPoolAllocAlignment;
+    uint32_t size_class = static_cast<uint32_t>((block_size + kGranularity - 1) / kGranularity - 1);
+    void* block = nullptr;
+    if (size_class < kNumSizeClasses) {
+      block_size = (size_class + 1) * kGranularity;
+      if (PoolThreadCache* cache = Get()) {
+        FreeList& list = cache->free_lists_[size_class];
+        if (list.head != nullptr) {
+          block = list.head;
+          list.head = list.head->next;
+          --list.count;
+        }
+      }
+    } else {
+      size_class = kUncached;
+    }
+    if (block == nullptr) {
+      block = ::operator new(block_size, std::align_val_t(kPoolAllocAlignment));
+    }
+    *static_cast<uint32_t*>(block) = size_class;
+    return static_cast<char*>(block) + kPoolAllocAlignment;
+  }
+
+  static void Free(void* ptr) {
+    void* block = static_cast<char*>(ptr) - kPoolAllocAlignment;
+    uint32_t size_class = *static_cast<uint32_t*>(block);
+    if (size_class < kNumSizeClasses) {
+      if (PoolThreadCache* cache = Get()) {
+        FreeList& list = cache->free_lists_[size_class];
+        if (list.count < kMaxCachedBlocks) {
+          FreeBlock* free_block = static_cast<FreeBlock*>(block);
+          free_block->next = list.head;
+          list.head = free_block;
+          ++list.count;
+          return;
+        }
+      }
+    }
+    ::operator delete(block, std::align_val_t(kPoolAllocAlignment));
+  }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  struct FreeList {
+    FreeBlock* head{nullptr};
+    size_t count{0};
+  };
+  static_assert(sizeof(FreeBlock) <= kPoolAllocAlignment);
+
+  FreeList free_lists_[kNumSizeClasses];
+  // Trivially destructible, hence still valid while the other thread locals are destroyed.
+  static thread_local bool destroyed_;
+};
+
+thread_local bool PoolThreadCache::destroyed_ = false;
+
+void* PoolAlloc(size_t nbytes) { return PoolThreadCache::Alloc(nbytes); }
+
+void PoolFree(void* ptr) { PoolThreadCache::Free(ptr); }
+
+}  // namespace detail
+
 TVM_REGISTER_GLOBAL("runtime.ObjectPtrHash").set_body_typed([](ObjectRef obj) {
   return static_cast<int64_t>(ObjectPtrHash()(obj));
 });
@@ -176,6 +176,17 @@ inline const char* CLGetErrorString(cl_int error) {
   }
 }
 
+std::string GetPlatformInfo(cl_platform_id pid, cl_platform_info param_name);
+std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
+
+/*!
+ * \brief The directory of the on-disk cache of compiled OpenCL programs.
+ *
+ *  Initialized from the TVM_OPENCL_PROGRAM_CACHE_DIR environment variable, caching is disabled
+ *  when empty.
+ */
+std::string GetProgramCacheDir();
+
 inline cl_channel_type DTypeToOpenCLChannelType(DLDataType data_type) {
   DataType dtype(data_type);
   if (dtype == DataType::Float(32)) {
@@ -480,6 +491,16 @@ class OpenCLModuleNode : public OpenCLModuleNodeBase {
                           const std::string& func_name, const KTRefEntry& e) override;
 
  private:
+  // Return the file caching the binary of a kernel for a device, empty when caching is disabled.
+  std::string GetProgramCachePath(cl::OpenCLWorkspace* w, const std::string& func_name,
+                                  int device_id);
+  // Create and build the program of a kernel from a cached binary, return false on failure.
+  bool LoadCachedProgram(cl::OpenCLWorkspace* w, const std::string& path,
+                         const std::string& func_name, int device_id);
+  // Save the binary of a built program into the cache.
+  void SaveCachedProgram(cl::OpenCLWorkspace* w, const std::string& path,
+                         const std::string& func_name, int device_id);
+
   // the binary data
   std::string data_;
   // The format
@@ -594,6 +594,22 @@ TVM_REGISTER_GLOBAL("device_api.opencl.free_nd").set_body([](TVMArgs args, TVMRe
   *rv = static_cast<int32_t>(0);
 });
 
+// The texture pools are thread local, these functions act on the pool of the calling thread.
+TVM_REGISTER_GLOBAL("device_api.opencl.set_texture_pool_budget")
+    .set_body_typed([](int64_t budget_bytes) {
+      CHECK_GE(budget_bytes, 0) << "The texture pool budget must be non-negative";
+      OpenCLWorkspace::Global()->GetThreadEntry()->texture_pool.SetMemoryBudget(budget_bytes);
+    });
+
+TVM_REGISTER_GLOBAL("device_api.opencl.get_texture_pool_stats").set_body_typed([](Device dev) {
+  TexturePoolStats stats = OpenCLWorkspace::Global()->GetThreadEntry()->texture_pool.GetStats(dev);
+  std::ostringstream os;
+  os << "{\"num_hits\": " << stats.num_hits << ", \"num_misses\": " << stats.num_misses
+     << ", \"num_trims\": " << stats.num_trims << ", \"allocated_bytes\": " << stats.allocated_bytes
+     << ", \"free_bytes\": " << stats.free_bytes << "}";
+  return String(os.str());
+});
+
 TVM_REGISTER_GLOBAL("device_api.opencl").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = OpenCLWorkspace::Global();
   *rv = static_cast<void*>(ptr);
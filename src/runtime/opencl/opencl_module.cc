@@ -23,9 +23,16 @@
 #include "opencl_module.h"
 
 #include <dmlc/memory_io.h>
+#include <dmlc/parameter.h>
 #include <tvm/runtime/registry.h>
 
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -226,6 +233,13 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   int device_id = t->device.device_id;
   auto did = w->GetCLDeviceID(device_id);
   auto platform = w->device_to_platform[did];
+  std::string cache_path;
+  if (!IsProgramCreated(func_name, device_id) && fmt_ == "cl") {
+    cache_path = GetProgramCachePath(w, func_name, device_id);
+    if (!cache_path.empty() && LoadCachedProgram(w, cache_path, func_name, device_id)) {
+      cache_path.clear();
+    }
+  }
   if (!IsProgramCreated(func_name, device_id)) {
     // create program
     if (fmt_ == "cl") {
@@ -262,6 +276,9 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
                  << "\nError: " << cl::CLGetErrorString(err) << "\n"
                  << log;
     }
+    if (!cache_path.empty()) {
+      SaveCachedProgram(w, cache_path, func_name, device_id);
+    }
   }
   // build kernel
   cl_int err;
@@ -273,6 +290,134 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   return kernel;
 }
 
+namespace {
+// Identifies the cache files, bumped when their layout changes.
+constexpr uint64_t kProgramCacheMagic = 0x54564d434c430001ULL;
+
+std::mutex program_cache_mutex;
+std::string program_cache_dir = dmlc::GetEnv("TVM_OPENCL_PROGRAM_CACHE_DIR", std::string());
+
+// FNV-1a, stable across builds unlike std::hash.
+uint64_t StableHash(const std::string& data, uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (unsigned char c : data) {
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+struct ProgramCacheHeader {
+  std::string device_name;
+  std::string driver_version;
+  uint64_t source_hash;
+};
+
+ProgramCacheHeader MakeProgramCacheHeader(cl_device_id dev, const std::string& source) {
+  return {cl::GetDeviceInfo(dev, CL_DEVICE_NAME), cl::GetDeviceInfo(dev, CL_DRIVER_VERSION),
+          StableHash(source)};
+}
+}  // namespace
+
+namespace cl {
+std::string GetProgramCacheDir() {
+  std::lock_guard<std::mutex> lock(program_cache_mutex);
+  return program_cache_dir;
+}
+}  // namespace cl
+
+std::string OpenCLModuleNode::GetProgramCachePath(cl::OpenCLWorkspace* w,
+                                                  const std::string& func_name, int device_id) {
+  std::string dir = cl::GetProgramCacheDir();
+  if (dir.empty()) return std::string();
+  ProgramCacheHeader header =
+      MakeProgramCacheHeader(w->GetCLDeviceID(device_id), parsed_kernels_[func_name]);
+  uint64_t key = StableHash(header.driver_version, StableHash(header.device_name));
+  key = StableHash(std::to_string(header.source_hash), key);
+  std::ostringstream os;
+  os << dir << "/" << std::hex << key << ".clbin";
+  return os.str();
+}
+
+bool OpenCLModuleNode::LoadCachedProgram(cl::OpenCLWorkspace* w, const std::string& path,
+                                         const std::string& func_name, int device_id) {
+  std::ifstream fs(path, std::ios::in | std::ios::binary);
+  if (fs.fail()) return false;
+  std::string data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  dmlc::MemoryStringStream reader(&data);
+  dmlc::Stream* strm = &reader;
+  cl_device_id dev = w->GetCLDeviceID(device_id);
+  ProgramCacheHeader expected = MakeProgramCacheHeader(dev, parsed_kernels_[func_name]);
+  uint64_t magic = 0;
+  ProgramCacheHeader header;
+  std::vector<unsigned char> binary;
+  // A stale or truncated file is ignored, and overwritten once the program is built.
+  if (!strm->Read(&magic) || magic != kProgramCacheMagic || !strm->Read(&header.device_name) ||
+      !strm->Read(&header.driver_version) || !strm->Read(&header.source_hash) ||
+      !strm->Read(&binary) || header.device_name != expected.device_name ||
+      header.driver_version != expected.driver_version ||
+      header.source_hash != expected.source_hash || binary.empty()) {
+    return false;
+  }
+  auto platform = w->device_to_platform[dev];
+  size_t binary_size = binary.size();
+  const unsigned char* binary_data = binary.data();
+  cl_int binary_status = CL_SUCCESS;
+  cl_int err = CL_SUCCESS;
+  cl_program program = clCreateProgramWithBinary(w->contexts[platform], 1, &dev, &binary_size,
+                                                 &binary_data, &binary_status, &err);
+  if (err != CL_SUCCESS || binary_status != CL_SUCCESS) {
+    if (program != nullptr) clReleaseProgram(program);
+    return false;
+  }
+  if (clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr) != CL_SUCCESS) {
+    clReleaseProgram(program);
+    return false;
+  }
+  programs_[func_name][device_id] = program;
+  return true;
+}
+
+void OpenCLModuleNode::SaveCachedProgram(cl::OpenCLWorkspace* w, const std::string& path,
+                                         const std::string& func_name, int device_id) {
+  cl_program program = programs_[func_name][device_id];
+  size_t size = 0;
+  if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &size, nullptr) !=
+          CL_SUCCESS ||
+      size == 0) {
+    return;
+  }
+  std::vector<unsigned char> binary(size);
+  unsigned char* binary_data = binary.data();
+  if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &binary_data,
+                       nullptr) != CL_SUCCESS) {
+    return;
+  }
+  ProgramCacheHeader header =
+      MakeProgramCacheHeader(w->GetCLDeviceID(device_id), parsed_kernels_[func_name]);
+  std::string data;
+  dmlc::MemoryStringStream writer(&data);
+  dmlc::Stream* strm = &writer;
+  strm->Write(kProgramCacheMagic);
+  strm->Write(header.device_name);
+  strm->Write(header.driver_version);
+  strm->Write(header.source_hash);
+  strm->Write(binary);
+  // Writing to a temporary file first, so that concurrent readers never see a partial file.
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (fs.fail()) {
+      LOG(WARNING) << "Cannot write the OpenCL program cache file " << tmp_path.str();
+      return;
+    }
+    fs.write(data.data(), data.size());
+    if (fs.fail()) return;
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
 void OpenCLModuleNode::SetPreCompiledPrograms(const std::string& bytes) {
   workspace_->Init();
   std::string data = bytes;
@@ -389,6 +534,11 @@ Module OpenCLModuleLoadBinary(void* strm) {
   return OpenCLModuleCreate(data, fmt, fmap, std::string());
 }
 
+TVM_REGISTER_GLOBAL("device_api.opencl.set_program_cache_dir").set_body_typed([](String dir) {
+  std::lock_guard<std::mutex> lock(program_cache_mutex);
+  program_cache_dir = dir;
+});
+
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_cl").set_body_typed(OpenCLModuleLoadFile);
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_clbin").set_body_typed(OpenCLModuleLoadFile);
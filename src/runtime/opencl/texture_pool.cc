@@ -21,92 +21,93 @@
  * \file texture_pool.h
  * \brief Texture pool utility.
  */
-#include <limits>
 #include <memory>
+#include <vector>
 
 #include "../texture.h"
 
 namespace tvm {
 namespace runtime {
 
+size_t Pool2D::SizeClass(size_t extent) {
+  if (extent <= 4) {
+    return extent;
+  }
+  size_t shift = 0;
+  for (size_t v = (extent - 1) >> 3; v > 0; v >>= 1) {
+    ++shift;
+  }
+  return (((extent - 1) >> shift) + 1) << shift;
+}
+
+size_t Pool2D::EntryBytes(const Entry& e) {
+  // Each texel holds four elements.
+  return e.x * e.y * 4 * ((e.type.bits * e.type.lanes + 7) / 8);
+}
+
 void* Pool2D::Alloc(Device dev, DeviceAPI* device, size_t width, size_t height,
                     DLDataType type_hint) {
-  Entry e;
-  Entry new_mem;
-  // Processed several experiments and found that when we are trying to fit
-  // small texture to too big texture then it may lead to the performance
-  // degradation.
-  // Coefficient at 5 looks like robust variant for reusing textures.
-  const int64_t max_ratio = 5;
-  e.data = nullptr;
-  std::vector<Entry>::iterator best_mem;
-  if (free_list_.size() != 0) {
-    int64_t min_added_size_x = std::numeric_limits<int64_t>::max();
-    int64_t min_added_size_y = std::numeric_limits<int64_t>::max();
-    int64_t min_wasted_size_x = std::numeric_limits<int64_t>::max();
-    int64_t min_wasted_size_y = std::numeric_limits<int64_t>::max();
-    for (auto it = free_list_.begin(); it != free_list_.end(); ++it) {
-      if (it->type.code != type_hint.code) {
-        continue;
-      }
-      // avoid reusing too small and too big textures
-      if (width / it->x > max_ratio || it->x / width > max_ratio || height / it->y > max_ratio ||
-          it->y / height > max_ratio) {
-        continue;
-      }
-      int64_t new_width = std::max(it->x, width);
-      int64_t new_height = std::max(it->y, height);
-      int64_t added_size_x = new_width - it->x;
-      int64_t added_size_y = new_height - it->y;
-      int64_t wasted_size_x = new_width - width;
-      int64_t wasted_size_y = new_height - height;
-      // Minimize added size first and wasted size thereafter
-      if ((min_added_size_x > 0 && added_size_x < min_added_size_x) ||
-          (min_added_size_y > 0 && added_size_y < min_added_size_y) ||
-          (min_added_size_x == added_size_x && wasted_size_x < min_wasted_size_x) ||
-          (min_added_size_y == added_size_y && wasted_size_y < min_wasted_size_y)) {
-        min_added_size_x = added_size_x;
-        min_added_size_y = added_size_y;
-        min_wasted_size_x = wasted_size_x;
-        min_wasted_size_y = wasted_size_y;
-        best_mem = it;
-        new_mem.x = new_width;
-        new_mem.y = new_height;
-      }
+  // Reusing a texture much bigger than the request wastes memory, and was found to degrade the
+  // performance as well.
+  const size_t max_ratio = 2;
+  const size_t x = SizeClass(width);
+  const size_t y = SizeClass(height);
+  auto best_mem = free_list_.end();
+  for (auto it = free_list_.begin(); it != free_list_.end(); ++it) {
+    if (it->type.code != type_hint.code || it->type.bits != type_hint.bits ||
+        it->type.lanes != type_hint.lanes) {
+      continue;
     }
-
-    if (min_added_size_x == 0 && min_added_size_y == 0) {
-      // use existing block
-      e = *best_mem;
-      free_list_.erase(best_mem);
-    } else if (static_cast<size_t>(min_added_size_x) <= width ||
-               static_cast<size_t>(min_added_size_y) <= height) {
-      // if added size is less or equal to
-      // what is needed by alloc, then grow entry
-      device->FreeDataSpace(dev, best_mem->data);
-      free_list_.erase(best_mem);
-      new_mem.type = type_hint;
-      std::vector<int64_t> shape{int64_t(new_mem.y), int64_t(new_mem.x), 4};
-      new_mem.data = device->AllocDataSpace(dev, shape.size(), shape.data(), new_mem.type,
-                                            Optional<String>("global.texture"));
-      e = new_mem;
+    if (it->x < x || it->y < y || it->x * it->y > max_ratio * x * y) {
+      continue;
+    }
+    // Prefer the smallest texture, and the most recently freed one among those.
+    if (best_mem == free_list_.end() || it->x * it->y <= best_mem->x * best_mem->y) {
+      best_mem = it;
     }
   }
 
-  if (e.data == nullptr) {
-    // create new block
-    std::vector<int64_t> shape{int64_t(height), int64_t(width), 4};
+  Entry e;
+  if (best_mem != free_list_.end()) {
+    e = *best_mem;
+    free_list_.erase(best_mem);
+    stats_.free_bytes -= EntryBytes(e);
+    ++stats_.num_hits;
+  } else {
+    e.x = x;
+    e.y = y;
+    e.type = type_hint;
+    Trim(dev, device, EntryBytes(e));
+    std::vector<int64_t> shape{int64_t(y), int64_t(x), 4};
     e.data = device->AllocDataSpace(dev, shape.size(), shape.data(), type_hint,
                                     Optional<String>("global.texture"));
-    e.x = width;
-    e.y = height;
-    e.type = type_hint;
+    ++stats_.num_misses;
   }
-
+  stats_.allocated_bytes += EntryBytes(e);
   allocated_.push_back(e);
   return e.data;
 }
 
+void Pool2D::Trim(Device dev, DeviceAPI* device, size_t nbytes) {
+  if (budget_ == 0) {
+    return;
+  }
+  size_t num_trims = 0;
+  while (num_trims < free_list_.size() &&
+         stats_.allocated_bytes + stats_.free_bytes + nbytes > budget_) {
+    const Entry& e = free_list_[num_trims++];
+    device->FreeDataSpace(dev, e.data);
+    stats_.free_bytes -= EntryBytes(e);
+  }
+  free_list_.erase(free_list_.begin(), free_list_.begin() + num_trims);
+  stats_.num_trims += num_trims;
+}
+
+void Pool2D::SetMemoryBudget(Device dev, DeviceAPI* device, size_t budget) {
+  budget_ = budget;
+  Trim(dev, device, 0);
+}
+
 void Pool2D::Free(void* data) {
   Entry e;
   if (allocated_.back().data == data) {
@@ -121,6 +122,8 @@ void Pool2D::Free(void* data) {
     e = allocated_[index];
     allocated_.erase(allocated_.begin() + index);
   }
+  stats_.allocated_bytes -= EntryBytes(e);
+  stats_.free_bytes += EntryBytes(e);
   free_list_.push_back(e);
 }
 
@@ -134,6 +137,8 @@ void Pool2D::Release(Device dev, DeviceAPI* device) {
   }
   allocated_.clear();
   free_list_.clear();
+  stats_.allocated_bytes = 0;
+  stats_.free_bytes = 0;
 }
 
 TexturePool::TexturePool(DLDeviceType device_type, DeviceAPI* device)
@@ -157,6 +162,7 @@ void* TexturePool::AllocTexture(Device dev, size_t width, size_t height, DLDataT
   }
   if (array_[dev.device_id] == nullptr) {
     array_[dev.device_id] = new Pool2D();
+    array_[dev.device_id]->SetMemoryBudget(dev, device_, budget_);
   }
   return array_[dev.device_id]->Alloc(dev, device_, width, height, type_hint);
 }
@@ -167,5 +173,24 @@ void TexturePool::FreeTexture(Device dev, void* ptr) {
   array_[dev.device_id]->Free(ptr);
 }
 
+void TexturePool::SetMemoryBudget(size_t budget) {
+  budget_ = budget;
+  for (size_t i = 0; i < array_.size(); ++i) {
+    if (array_[i] != nullptr) {
+      Device dev;
+      dev.device_type = device_type_;
+      dev.device_id = static_cast<int>(i);
+      array_[i]->SetMemoryBudget(dev, device_, budget);
+    }
+  }
+}
+
+TexturePoolStats TexturePool::GetStats(Device dev) const {
+  if (static_cast<size_t>(dev.device_id) >= array_.size() || array_[dev.device_id] == nullptr) {
+    return TexturePoolStats();
+  }
+  return array_[dev.device_id]->GetStats();
+}
+
 }  // namespace runtime
 }  // namespace tvm
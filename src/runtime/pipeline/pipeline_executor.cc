@@ -85,6 +85,18 @@ PackedFunc PipelineExecutor::GetFunction(const String& name,
   } else if (name == "get_execute_count") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetExecutionCount(); });
+  } else if (name == "set_micro_batch") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      pipeline_scheduler_.SetMicroBatch(args[0], args[1]);
+    });
+  } else if (name == "set_queue_depth") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      pipeline_scheduler_.SetQueueDepth(args[0]);
+    });
+  } else if (name == "get_statistics") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = pipeline_scheduler_.GetStatistics();
+    });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
   }
@@ -18,6 +18,7 @@
  */
 #include "pipeline_scheduler.h"
 
+#include <sstream>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -51,6 +52,7 @@ std::shared_ptr<GlobalRuntime> PipelineScheduler::PipelineInit(
     ModuleOutputPair& output_pair = global_output_map[i];
     NDArray output = runtimes[output_pair.first]->CreateFromOutput(output_pair.second);
     output_arrays_.push_back(output);
+    global_output_bindings_.push_back(output_pair);
   }
   // Initializing and then running the worker thread.
   for (auto runtime : runtimes) {
@@ -64,6 +66,10 @@ std::shared_ptr<GlobalRuntime> PipelineScheduler::PipelineInit(
  * \param pipeline_config The dependency configuration of each runtime module.
  */
 void PipelineScheduler::PipelineRun(const std::vector<std::shared_ptr<BackendRuntime>>& runtimes) {
+  if (!started_) {
+    start_time_ = std::chrono::steady_clock::now();
+    started_ = true;
+  }
   runtimes.front()->RunPipeline();
 }
 /*!
@@ -73,5 +79,63 @@ Array<NDArray> PipelineScheduler::PipelineGetOutput() {
   bool ret = global_runtime_->GetOutput(&output_arrays_);
   return ret ? output_arrays_ : Array<NDArray>{};
 }
+/*!
+ * \brief Merge requests into micro-batches in one runtime.
+ * \param runtime_idx The index of the runtime.
+ * \param micro_batch The number of requests merged into one run of the runtime.
+ */
+void PipelineScheduler::SetMicroBatch(int runtime_idx, int micro_batch) {
+  auto runtimes = global_runtime_->GetRuntimeList();
+  ICHECK(runtime_idx >= 0 && runtime_idx < static_cast<int>(runtimes.size()))
+      << "The runtime index " << runtime_idx << " is out of the range.";
+  runtimes[runtime_idx]->SetMicroBatch(micro_batch);
+  // The global outputs hold a single request.
+  for (size_t i = 0; i < global_output_bindings_.size(); ++i) {
+    const ModuleOutputPair& output_pair = global_output_bindings_[i];
+    if (output_pair.first == runtime_idx) {
+      output_arrays_.Set(i, runtimes[runtime_idx]->CreateFromOutput(output_pair.second));
+    }
+  }
+}
+/*!
+ * \brief Set the depth of all the forwarding queues of the pipeline.
+ * \param depth The maximum number of data waiting in each queue.
+ */
+void PipelineScheduler::SetQueueDepth(int depth) {
+  ICHECK_GE(depth, 1) << "The queue depth must be positive";
+  global_runtime_->SetForwardQueueDepth(depth);
+  for (auto runtime : global_runtime_->GetRuntimeList()) {
+    runtime->SetForwardQueueDepth(depth);
+  }
+}
+/*!
+ * \brief Get the statistics of each runtime in JSON format.
+ */
+std::string PipelineScheduler::GetStatistics() {
+  double elapsed =
+      started_ ? std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_)
+                     .count()
+               : 0.0;
+  std::ostringstream os;
+  os << "{\"elapsed_seconds\": " << elapsed
+     << ", \"input_blocked_seconds\": " << global_runtime_->GetBlockedNanoseconds() * 1e-9
+     << ", \"stages\": [";
+  auto runtimes = global_runtime_->GetRuntimeList();
+  for (size_t i = 0; i < runtimes.size(); ++i) {
+    const auto& runtime = runtimes[i];
+    uint64_t num_requests = runtime->GetExecutionCount();
+    uint64_t num_invocations = runtime->GetNumInvocations();
+    double run_seconds = runtime->GetRunNanoseconds() * 1e-9;
+    os << (i ? ", " : "") << "{\"micro_batch\": " << runtime->GetMicroBatch()
+       << ", \"num_requests\": " << num_requests << ", \"num_invocations\": " << num_invocations
+       << ", \"run_seconds\": " << run_seconds
+       << ", \"mean_latency_seconds\": " << (num_invocations ? run_seconds / num_invocations : 0.0)
+       << ", \"max_latency_seconds\": " << runtime->GetMaxRunNanoseconds() * 1e-9
+       << ", \"blocked_seconds\": " << runtime->GetBlockedNanoseconds() * 1e-9
+       << ", \"throughput\": " << (elapsed > 0 ? num_requests / elapsed : 0.0) << "}";
+  }
+  os << "]}";
+  return os.str();
+}
 }  // namespace runtime
 }  // namespace tvm
@@ -22,6 +22,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <chrono>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -53,6 +54,21 @@ class PipelineScheduler {
    * \brief Get a list of outputs.
    */
   Array<NDArray> PipelineGetOutput();
+  /*!
+   * \brief Merge requests into micro-batches in one runtime.
+   * \param runtime_idx The index of the runtime.
+   * \param micro_batch The number of requests merged into one run of the runtime.
+   */
+  void SetMicroBatch(int runtime_idx, int micro_batch);
+  /*!
+   * \brief Set the depth of all the forwarding queues of the pipeline.
+   * \param depth The maximum number of data waiting in each queue.
+   */
+  void SetQueueDepth(int depth);
+  /*!
+   * \brief Get the statistics of each runtime in JSON format.
+   */
+  std::string GetStatistics();
 
  private:
   /*!\brief The list of graph executors.*/
@@ -61,6 +77,12 @@ class PipelineScheduler {
   Array<NDArray> output_arrays_;
   /*!\brief The global runtime to represent the pipeline executor.*/
   std::shared_ptr<GlobalRuntime> global_runtime_;
+  /*!\brief The runtime output bound to each global output.*/
+  std::vector<ModuleOutputPair> global_output_bindings_;
+  /*!\brief The time of the first run of the pipeline.*/
+  std::chrono::steady_clock::time_point start_time_;
+  /*!\brief Whether the pipeline has run.*/
+  bool started_ = false;
 };
 }  // namespace runtime
 }  // namespace tvm
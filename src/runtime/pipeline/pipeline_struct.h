@@ -21,11 +21,13 @@
 #include <assert.h>
 #include <dlpack/dlpack.h>
 #include <dmlc/json.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <limits>
@@ -201,13 +203,23 @@ class QueueData {
     return *this;
   }
   /*!\brief Create a deep copy of the 'DLTensor' data.*/
-  DLTensor* CreateCopyFrom(const DLTensor* from) {
+  DLTensor* CreateCopyFrom(const DLTensor* from) { return CreateCopyFrom(from, from->device); }
+  /*!
+   * \brief Create a deep copy of the 'DLTensor' data on the given device.
+   * \param from The data to copy.
+   * \param device The device of the copy, when this container owns its data.
+   * \param stream The stream issuing the copy, the copy is synchronous when null.
+   */
+  DLTensor* CreateCopyFrom(const DLTensor* from, Device device, TVMStreamHandle stream = nullptr) {
     if (!from) {
       LOG(FATAL) << "the 'from' pointer is a null pointer!";
     }
     size_t fromLen = tvm::runtime::GetDataSize(*from);
     size_t toLen = data_ ? tvm::runtime::GetDataSize(*data_) : 0;
-    if (fromLen != toLen) {
+    bool device_changed = data_ && IsDataOwner() &&
+                          (data_->device.device_type != device.device_type ||
+                           data_->device.device_id != device.device_id);
+    if (fromLen != toLen || device_changed) {
       // If this container ownes the variable 'data_', then recreating the 'data_' variable.
       if (IsDataOwner()) {
         if (data_) {
@@ -215,12 +227,12 @@ class QueueData {
           data_ = nullptr;
         }
         TVMArrayAlloc(from->shape, from->ndim, from->dtype.code, from->dtype.bits,
-                      from->dtype.lanes, from->device.device_type, from->device.device_id, &data_);
+                      from->dtype.lanes, device.device_type, device.device_id, &data_);
       } else {
         LOG(FATAL) << "The 'from' data is not matched with the  'data_'.";
       }
     }
-    TVMArrayCopyFromTo(const_cast<DLTensor*>(from), data_, nullptr);
+    NDArray::CopyFromTo(from, data_, stream);
     return data_;
   }
   /*!\brief Return a pointer to the 'DLTensor' data.*/
@@ -665,8 +677,92 @@ struct ParamConnectionConfig {
 /*!
  * \brief The single consumer single producer queue which is used to forward data between two
  * interfaces of backend cores.
+ *
+ *  The data produced on an accelerator are copied into the queue on a copy stream of the
+ *  producer device, directly onto the device of the consumer when both are devices of the same
+ *  type, e.g. a peer to peer copy between two GPUs. The producer does not wait for the copy, its
+ *  next run is ordered after the copy on the device, and the consumer only waits for the copies
+ *  of the data it loads.
  */
-using ForwardQueue = SPSCLockFreeQueue<QueueData, ModuleInterfaceID>;
+class ForwardQueue : public SPSCLockFreeQueue<QueueData, ModuleInterfaceID> {
+ public:
+  explicit ForwardQueue(ModuleInterfaceID id) : SPSCLockFreeQueue(id) {}
+  ~ForwardQueue() {
+    if (copy_stream_) {
+      DeviceAPI::Get(copy_device_)->FreeStream(copy_device_, copy_stream_);
+    }
+  }
+  /*!\brief Set the device of the input interface consuming the data of this queue.*/
+  void SetDestinationDevice(Device device) {
+    dst_device_ = device;
+    has_dst_device_ = true;
+  }
+  /*!
+   * \brief Copying the data into a slot of the queue. Only the producer calls this function.
+   * \param slot The slot of the queue.
+   * \param from The data produced by the parent interface.
+   */
+  void CopyInto(QueueData* slot, const DLTensor* from) {
+    Device src = from->device;
+    Device dst = has_dst_device_ ? dst_device_ : src;
+    // The host data are copied synchronously, the caller may reuse them right away. So are the
+    // copies between two kinds of devices, which go through the host.
+    if (src.device_type == kDLCPU ||
+        (dst.device_type != src.device_type && dst.device_type != kDLCPU)) {
+      slot->CreateCopyFrom(from);
+      return;
+    }
+    DeviceAPI* api = DeviceAPI::Get(src);
+    if (copy_stream_ == nullptr) {
+      copy_device_ = src;
+      copy_stream_ = api->CreateStream(src);
+    }
+    ICHECK(copy_device_.device_type == src.device_type && copy_device_.device_id == src.device_id)
+        << "The data forwarded through a queue must stay on the same device";
+    TVMStreamHandle compute_stream = api->GetCurrentStream(src);
+    // The copy starts once the producer finished writing the data ...
+    api->SyncStreamFromTo(src, compute_stream, copy_stream_);
+    slot->CreateCopyFrom(from, dst, copy_stream_);
+    // ... and the next run of the producer overwrites the data once the copy is done.
+    api->SyncStreamFromTo(src, copy_stream_, compute_stream);
+  }
+  /*!\brief Waiting for the copies into the queue. Only the consumer calls this function.*/
+  void WaitCopy() {
+    if (copy_stream_) {
+      DeviceAPI::Get(copy_device_)->StreamSync(copy_device_, copy_stream_);
+    }
+  }
+
+ private:
+  /*!\brief The device of the consumer, the data stay on the producer device when not set.*/
+  Device dst_device_;
+  bool has_dst_device_ = false;
+  /*!\brief The stream copying the data produced on an accelerator, created on first use.*/
+  Device copy_device_;
+  TVMStreamHandle copy_stream_ = nullptr;
+};
+/*!\brief The view of the k-th request of a micro-batch, along the first axis of a tensor.*/
+struct MicroBatchSlice {
+  /*!\brief The shape of the view.*/
+  std::vector<int64_t> shape;
+  /*!\brief The view, pointing into the data of the micro-batch.*/
+  DLTensor tensor;
+
+  MicroBatchSlice(const DLTensor& batch, int micro_batch, int k)
+      : shape(batch.shape, batch.shape + batch.ndim) {
+    tensor = batch;
+    tensor.shape = shape.data();
+    if (micro_batch == 1) return;
+    ICHECK(batch.ndim > 0 && shape[0] % micro_batch == 0)
+        << "The first dimension of the tensors of a stage must be a multiple of its "
+        << "micro-batch size " << micro_batch;
+    ICHECK(batch.strides == nullptr) << "Micro-batching needs compact tensors";
+    shape[0] /= micro_batch;
+    tensor.byte_offset += k * GetDataSize(tensor);
+  }
+  MicroBatchSlice(const MicroBatchSlice&) = delete;
+  MicroBatchSlice& operator=(const MicroBatchSlice&) = delete;
+};
 using ForwardQueueMap =
     std::unordered_map<ModuleInterfaceID, std::shared_ptr<ForwardQueue>, ModuleIDHash>;
 /*!\brief The basic class for runtime.*/
@@ -684,6 +780,13 @@ class BasicRuntime {
    * \param input_index The index of an input interface which have data ready.
    */
   virtual void ParentNotify(int input_index) {}
+  /*!
+   * \brief Getting the device of an input interface.
+   * \param index The index of the input interface.
+   * \param device The device of the input.
+   * \return Returning false when the input has no fixed device.
+   */
+  virtual bool GetInputDevice(int index, Device* device) { return false; }
   /*!
    *\brief Creating a parent notification.
    *\param input_index The input index of the 'current runtime'.
@@ -700,6 +803,19 @@ class BasicRuntime {
     parents_notify_[input_index] =
         std::make_shared<DataNotify>(ModuleInterfaceID(parent_idx, parent_output_idx, OUTPUT));
   }
+  /*!
+   * \brief Set the depth of the queues this runtime forwards its outputs into.
+   * \param depth The maximum number of data waiting in each queue.
+   */
+  void SetForwardQueueDepth(size_t depth) {
+    for (auto& queue_map : forward_queue_) {
+      for (auto& queue : queue_map.second) {
+        queue.second->SetCapacity(depth);
+      }
+    }
+  }
+  /*!\brief The time spent waiting for a full forwarding queue, in nanoseconds.*/
+  uint64_t GetBlockedNanoseconds() const { return blocked_ns_.load(std::memory_order_relaxed); }
 
  protected:
   /*!\brief The index of runtime indicates the runtime position in the pipeline.*/
@@ -721,6 +837,8 @@ class BasicRuntime {
   std::unordered_map<int, ForwardQueueMap> forward_queue_;
   /*!\brief The state of the pipeline.*/
   std::atomic<PipelineState> pipeline_state_{STOPPED};
+  /*!\brief The time spent waiting for a full forwarding queue, in nanoseconds.*/
+  std::atomic<uint64_t> blocked_ns_{0};
   /*!
    * \brief Generate the ID of an input queue.
    * \param runtime_index The index of backend runtime.
@@ -749,13 +867,22 @@ class BasicRuntime {
     }
     auto forward_queue = forward_queue_map->at(queue_id);
     // If the queue is full, keep try until the push get success or the pipeline run into
-    // a STOP state.
-    while (!forward_queue->Push<const DLTensor*>(data)) {
-      if (PipelineIsStop()) {
-        LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
-                  << " into stop.";
-        return false;
+    // a STOP state. Blocking here is the backpressure of a slower child runtime.
+    auto fill = [&](QueueData* slot) { forward_queue->CopyInto(slot, data); };
+    if (!forward_queue->PushWith(fill)) {
+      auto start = std::chrono::steady_clock::now();
+      while (!forward_queue->PushWith(fill)) {
+        if (PipelineIsStop()) {
+          LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
+                    << " into stop.";
+          return false;
+        }
+        std::this_thread::yield();
       }
+      blocked_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count(),
+                            std::memory_order_relaxed);
     }
     child_runtime->ParentNotify(child_input_index);
     return true;
@@ -778,6 +905,10 @@ class BasicRuntime {
       return;
     }
     auto queue = std::make_shared<ForwardQueue>(queue_id);
+    Device input_device;
+    if (child_runtime->GetInputDevice(input_index, &input_device)) {
+      queue->SetDestinationDevice(input_device);
+    }
     queue_map[queue_id] = queue;
     // Use the created queue as the consumer queue for the input interface of this forwarding
     // pair.
@@ -810,6 +941,15 @@ class BackendRuntime : public BasicRuntime {
   std::thread thread_;
   /*!\brief The execution count of the 'RunPipeline' function. */
   uint32_t pipeline_execution_count_ = 0;
+  /*!\brief The number of requests merged along the first axis into one run of the module.*/
+  int micro_batch_ = 1;
+  /*!\brief The number of requests loaded into the inputs for the next run of the module.*/
+  int micro_batch_fill_ = 0;
+  /*!\brief The number of runs of the module.*/
+  std::atomic<uint64_t> num_invocations_{0};
+  /*!\brief The total and the maximum time of the runs of the module, in nanoseconds.*/
+  std::atomic<uint64_t> run_ns_{0};
+  std::atomic<uint64_t> max_run_ns_{0};
   /*!
    *\brief In order to transfer data from one backend runtime to another, we need a local
    * tensor variable as a medium. "input_tensor_local_copy_" is a map including
@@ -893,13 +1033,11 @@ class BackendRuntime : public BasicRuntime {
       LOG(FATAL) << "Not finding the associated input queue of the input " << input_index << " !";
     }
     auto queue = input_queue_[input_index];
-    QueueData data;
-    // TODO(huajsj): Doing the 'SetInput' inside the poll function to avoid one time data copy.
-    if (!queue->Poll<QueueData>(&data)) {
-      return false;
-    }
-    SetInput(input_index, data.GetDLData());
-    return true;
+    // Loading the data straight from the queue slot.
+    return queue->PollWith([&](const QueueData& data) {
+      queue->WaitCopy();
+      SetInput(input_index, data.GetDLData());
+    });
   }
   /*!
    * \brief Forwarding the output data into the child runtimes.
@@ -907,20 +1045,23 @@ class BackendRuntime : public BasicRuntime {
    *  reaches some errors. Otherwise, return true.
    */
   bool ForwardingOutputDataToChildren(void) {
-    for (auto child : children_) {
-      auto output_idx = child.first;
-      if (forward_queue_.find(output_idx) == forward_queue_.end()) {
-        LOG(FATAL) << "Not find the forwarding queue map for output(" << output_idx << ")!";
-      }
-      NDArray output = GetOutput(output_idx);
-      auto forward_queue_map = forward_queue_[output_idx];
-      // Notifying the 'children runtime' that the forwarding data are ready.
-      for (auto module_pair : child.second) {
-        auto child_runtime = module_pair.first;
-        auto child_input_index = module_pair.second;
-        auto output_data = const_cast<DLTensor*>(output.operator->());
-        if (!ForwardData(&forward_queue_map, child_runtime, child_input_index, output_data)) {
-          return false;
+    // The requests of a micro-batch are forwarded one by one, in order.
+    for (int k = 0; k < micro_batch_; ++k) {
+      for (auto child : children_) {
+        auto output_idx = child.first;
+        if (forward_queue_.find(output_idx) == forward_queue_.end()) {
+          LOG(FATAL) << "Not find the forwarding queue map for output(" << output_idx << ")!";
+        }
+        NDArray output = GetOutput(output_idx);
+        MicroBatchSlice slice(*output.operator->(), micro_batch_, k);
+        auto forward_queue_map = forward_queue_[output_idx];
+        // Notifying the 'children runtime' that the forwarding data are ready.
+        for (auto module_pair : child.second) {
+          auto child_runtime = module_pair.first;
+          auto child_input_index = module_pair.second;
+          if (!ForwardData(&forward_queue_map, child_runtime, child_input_index, &slice.tensor)) {
+            return false;
+          }
         }
       }
     }
@@ -947,18 +1088,20 @@ class BackendRuntime : public BasicRuntime {
   }
   /*
    *\brief Copying data from one DLTensor to another.
+   *\param key The tensor identifying the CPU bridge tensor of the copy, 'to' when null.
    */
-  void CopyFromTo(DLTensor* from, DLTensor* to) {
+  void CopyFromTo(DLTensor* from, DLTensor* to, DLTensor* key = nullptr) {
+    if (key == nullptr) key = to;
     // When the 'from' device and the 'to' device are not the same, we use a temporary CPU
     // DLTensor as the bridge.
     if (from->device.device_type != to->device.device_type && from->device.device_type != kDLCPU &&
         to->device.device_type != kDLCPU) {
       DLTensor* dltensor_local = nullptr;
-      if (input_tensor_local_copy_.find(to) == input_tensor_local_copy_.end()) {
+      if (input_tensor_local_copy_.find(key) == input_tensor_local_copy_.end()) {
         dltensor_local = CopyDLTensorToCPU(from);
-        input_tensor_local_copy_[to] = dltensor_local;
+        input_tensor_local_copy_[key] = dltensor_local;
       } else {
-        dltensor_local = input_tensor_local_copy_[to];
+        dltensor_local = input_tensor_local_copy_[key];
       }
       TVMArrayCopyFromTo(from, dltensor_local, nullptr);
       from = dltensor_local;
@@ -1059,10 +1202,40 @@ class BackendRuntime : public BasicRuntime {
     }
     notify->second->Notify();
   }
-  /*!\brief Creating a NDArray containing same shape and data type with a module output. */
+  /*!
+   * \brief Creating a NDArray containing same shape and data type with a module output, or
+   *  with one request of the output when the runtime merges requests into micro-batches.
+   */
   NDArray CreateFromOutput(int idx) {
     NDArray data = get_output_(idx);
-    return CreateNDArrayFromDLTensor(const_cast<DLTensor*>(data.operator->()));
+    MicroBatchSlice slice(*data.operator->(), micro_batch_, 0);
+    return CreateNDArrayFromDLTensor(&slice.tensor);
+  }
+  /*!
+   * \brief Merge the given number of requests into each run of the module. The requests are
+   *  concatenated along the first axis of the inputs, and the outputs are split the same way.
+   * \param micro_batch The number of requests, which must divide the first dimension of the
+   *  inputs and the outputs of the module.
+   */
+  void SetMicroBatch(int micro_batch) {
+    CHECK_GE(micro_batch, 1) << "The micro-batch size must be positive";
+    CHECK(pipeline_execution_count_ == 0 && micro_batch_fill_ == 0)
+        << "The micro-batch size of runtime " << runtime_idx_
+        << " must be set before running the pipeline";
+    micro_batch_ = micro_batch;
+  }
+  /*!\brief Get the number of requests merged into each run of the module.*/
+  int GetMicroBatch() const { return micro_batch_; }
+  /*!\brief Get the number of runs of the module.*/
+  uint64_t GetNumInvocations() const { return num_invocations_.load(std::memory_order_relaxed); }
+  /*!\brief Get the total time of the runs of the module, in nanoseconds.*/
+  uint64_t GetRunNanoseconds() const { return run_ns_.load(std::memory_order_relaxed); }
+  /*!\brief Get the longest run of the module, in nanoseconds.*/
+  uint64_t GetMaxRunNanoseconds() const { return max_run_ns_.load(std::memory_order_relaxed); }
+  bool GetInputDevice(int index, Device* device) final {
+    NDArray input = get_input_(index);
+    *device = input->device;
+    return true;
   }
   /*!\brief Return the number of output*/
   int NumOutputs() const { return get_num_output_(); }
@@ -1072,7 +1245,13 @@ class BackendRuntime : public BasicRuntime {
   void SetInput(const int index, DLTensor* data_in) {
     NDArray input = get_input_(index);
     DLTensor* dltensor_input = const_cast<DLTensor*>(input.operator->());
-    CopyFromTo(data_in, dltensor_input);
+    if (micro_batch_ == 1) {
+      CopyFromTo(data_in, dltensor_input);
+      return;
+    }
+    // Loading the request into its slice of the micro-batch.
+    MicroBatchSlice slice(*dltensor_input, micro_batch_, micro_batch_fill_);
+    CopyFromTo(data_in, &slice.tensor, dltensor_input);
   }
   /*!\brief Setting the data to the current runtime moduel via the input name. */
   void SetInput(const std::string name, DLTensor* data_in) {
@@ -1092,10 +1271,23 @@ class BackendRuntime : public BasicRuntime {
    * \return Returning false if the forwarding function failed. Otherwise, returning true.;
    */
   bool RunPipeline() {
+    // Waiting for the other requests of the micro-batch.
+    if (++micro_batch_fill_ < micro_batch_) return true;
+    micro_batch_fill_ = 0;
+    auto start = std::chrono::steady_clock::now();
     Run();
-    bool ret = ForwardingOutputDataToChildren();
-    pipeline_execution_count_++;
-    return ret;
+    uint64_t run_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    // Only the thread of this runtime updates the statistics.
+    run_ns_.fetch_add(run_ns, std::memory_order_relaxed);
+    if (run_ns > max_run_ns_.load(std::memory_order_relaxed)) {
+      max_run_ns_.store(run_ns, std::memory_order_relaxed);
+    }
+    num_invocations_.fetch_add(1, std::memory_order_relaxed);
+    // Counting before forwarding, so that the count covers the outputs read by the caller.
+    pipeline_execution_count_ += micro_batch_;
+    return ForwardingOutputDataToChildren();
   }
 };
 /*!
@@ -1154,6 +1346,7 @@ class GlobalRuntime : public BasicRuntime {
       auto output_index = queue_pair.first;
       auto queue = queue_pair.second;
       QueueData data(const_cast<DLTensor*>(((*outputs)[output_index]).operator->()));
+      queue->WaitCopy();
       if (!queue->Poll<QueueData>(&data)) {
         LOG(FATAL) << "There is no data in the data queue, it should not happen!";
       }
@@ -18,6 +18,9 @@
  */
 #ifndef TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
 #define TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
+#include <tvm/runtime/logging.h>
+
+#include <atomic>
 #include <cstddef>
 #include <thread>
 /*!\brief A single producer and single consumer lock free queue.
@@ -26,6 +29,18 @@ template <typename SlotType, typename IDType = int, int QueueLength = 1024>
 class SPSCLockFreeQueue {
  public:
   explicit SPSCLockFreeQueue(IDType id) : id_(id) {}
+  /*!
+   * \brief Set the maximum number of elements of the queue, the producer blocking on the
+   *  full queue exerts a backpressure on the stages feeding it.
+   * \param capacity The capacity, between 1 and QueueLength - 1.
+   */
+  void SetCapacity(size_t capacity) {
+    ICHECK(capacity >= 1 && capacity < len_)
+        << "The queue depth must be between 1 and " << len_ - 1 << ", but got " << capacity;
+    capacity_.store(capacity, std::memory_order_release);
+  }
+  /*!\brief Get the maximum number of elements of the queue.*/
+  size_t GetCapacity() const { return capacity_.load(std::memory_order_acquire); }
   /*A read barrier enforcing the CPU to performe the reads before this barrier.*/
   inline void read_barrier() { std::atomic_thread_fence(std::memory_order_acquire); }
   /*A write barrier enforcing the CPU to performe the writes before this barrier.*/
@@ -33,7 +48,7 @@ class SPSCLockFreeQueue {
   /*!\brief Checking whether the queue is full.*/
   bool Full() {
     read_barrier();
-    return ((tail_ + 1) % len_) == head_;
+    return (tail_ + len_ - head_) % len_ >= GetCapacity();
   }
   /*!brief Checking whether the queue is empty.*/
   bool Empty() {
@@ -47,8 +62,18 @@ class SPSCLockFreeQueue {
    */
   template <typename data_type>
   bool Push(const data_type& data) {
+    return PushWith([&](SlotType* slot) { *slot = data; });
+  }
+  /*!
+   * \brief Filling the next slot of the queue in place. Only a single producer will call this
+   *  function.
+   * \param fill The function writing the data into the slot.
+   * \return Return false when the queue is full. Otherwise, return true.
+   */
+  template <typename F>
+  bool PushWith(F fill) {
     if (Full()) return false;
-    queue_[tail_] = data;
+    fill(&queue_[tail_]);
     write_barrier();
     tail_ = (tail_ + 1) % len_;
     return true;
@@ -61,8 +86,18 @@ class SPSCLockFreeQueue {
    */
   template <typename data_type>
   bool Poll(data_type* data) {
+    return PollWith([&](const SlotType& slot) { *data = slot; });
+  }
+  /*!
+   * \brief Using the front slot of the queue in place, then removing it. Only the single
+   *  consumer will call this function.
+   * \param use The function reading the data of the slot.
+   * \return Returning false when the queue is empty. Otherwise, return true.
+   */
+  template <typename F>
+  bool PollWith(F use) {
     if (Empty()) return false;
-    *data = queue_[head_];
+    use(queue_[head_]);
     write_barrier();
     head_ = (head_ + 1) % len_;
     return true;
@@ -75,6 +110,8 @@ class SPSCLockFreeQueue {
   size_t tail_ = 0;
   /*!\brief The length of the queue.*/
   size_t len_ = QueueLength;
+  /*!\brief The maximum number of elements in the queue.*/
+  std::atomic<size_t> capacity_{QueueLength - 1};
   /*!\brief The queue used to store the data.*/
   SlotType queue_[QueueLength];
   /*!\brief The ID of the queue.*/
@@ -27,6 +27,7 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -59,6 +60,9 @@ struct Registry::Manager {
 
 Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
   func_ = f;
+  direct_func_ = nullptr;
+  direct_type_ = nullptr;
+  direct_call_ = nullptr;
   return *this;
 }
 
@@ -92,6 +96,27 @@ const PackedFunc* Registry::Get(const String& name) {
   return &(it->second->func_);
 }
 
+void* Registry::GetDirectFunc(const String& name, const char* type_name) {
+  Manager* m = Manager::Global();
+  std::lock_guard<std::mutex> lock(m->mutex);
+  auto it = m->fmap.find(name);
+  if (it == m->fmap.end() || it->second->direct_func_ == nullptr) return nullptr;
+  // Compare the mangled names, as type_info objects may not be unique across libraries.
+  if (std::strcmp(it->second->direct_type_, type_name) != 0) return nullptr;
+  return it->second->direct_func_;
+}
+
+DirectCall Registry::GetDirectCall(const String& name) {
+  Manager* m = Manager::Global();
+  std::lock_guard<std::mutex> lock(m->mutex);
+  auto it = m->fmap.find(name);
+  if (it == m->fmap.end() || it->second->direct_func_ == nullptr) return DirectCall();
+  DirectCall direct;
+  direct.call = it->second->direct_call_;
+  direct.handle = it->second->direct_func_;
+  return direct;
+}
+
 std::vector<String> Registry::ListNames() {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
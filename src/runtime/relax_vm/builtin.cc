@@ -195,7 +195,15 @@ void MakeShape(TVMArgs args, TVMRetValue* rv) {
   int64_t size = args[1];
   const int64_t kBeginCode = 2;
 
-  std::vector<int64_t> shape(size);
+  // Fill the dimensions in a stack buffer, the ShapeTuple then stores them inplace.
+  constexpr int64_t kMaxStackDims = 16;
+  int64_t stack_shape[kMaxStackDims];
+  std::vector<int64_t> heap_shape;
+  int64_t* shape = stack_shape;
+  if (size > kMaxStackDims) {
+    heap_shape.resize(size);
+    shape = heap_shape.data();
+  }
 
   for (int64_t i = 0; i < size; ++i) {
     MakeShapeCode code = static_cast<MakeShapeCode>(args[kBeginCode + i * 2].operator int());
@@ -207,7 +215,7 @@ void MakeShape(TVMArgs args, TVMRetValue* rv) {
       shape[i] = heap_data[reg];
     }
   }
-  *rv = ShapeTuple(std::move(shape));
+  *rv = ShapeTuple(shape, shape + size);
 }
 
 TVM_REGISTER_GLOBAL("vm.builtin.make_shape").set_body(MakeShape);
@@ -26,6 +26,9 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <atomic>
+#include <list>
+
 #include "../../../support/utils.h"
 #include "../../cuda/cuda_common.h"
 namespace tvm {
@@ -78,6 +81,8 @@ struct CUDAGraphCapturedState {
   CUDAGraphCapturedState& operator=(CUDAGraphCapturedState&& other) {
     std::swap(states, other.states);
     std::swap(exec, other.exec);
+    std::swap(nbytes, other.nbytes);
+    std::swap(lru_pos, other.lru_pos);
     return *this;
   }
 
@@ -94,6 +99,29 @@ struct CUDAGraphCapturedState {
   ObjectRef states;
   /*! \brief The instantiated cuda graph */
   cudaGraphExec_t exec = nullptr;
+  /*! \brief The device memory taken by the instantiated graph, as measured after its upload. */
+  size_t nbytes = 0;
+  /*! \brief The position of the graph in the LRU order of the cache. */
+  std::list<CUDAGraphCaptureKey>::iterator lru_pos{};
+};
+
+/*!
+ * \brief The limits of the captured graph cache of each VM, 0 for no limit.
+ *
+ * Functions capturing symbolic variables get one graph per distinct value of
+ * the variables, so the callers usually pad the dynamic dimensions (e.g. the
+ * batch size) to a few buckets. The limits bound the cache when the number of
+ * buckets is not known in advance, the least recently launched graphs being
+ * destroyed first.
+ */
+struct CUDAGraphCacheLimits {
+  std::atomic<int64_t> max_num_graphs{0};
+  std::atomic<int64_t> max_bytes{0};
+
+  static CUDAGraphCacheLimits* Global() {
+    static CUDAGraphCacheLimits inst;
+    return &inst;
+  }
 };
 
 class ScopedCUDAStream {
@@ -153,9 +181,10 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
     CUDAGraphCaptureKey entry_key{entry_index, shape_expr};
     if (auto it = capture_cache_.find(entry_key); it != capture_cache_.end()) {
       // Launch CUDA graph
-      const auto& [states, exec] = it->second;
-      CUDA_CALL(cudaGraphLaunch(exec, CUDAThreadEntry::ThreadLocal()->stream));
-      return states;
+      CUDAGraphCapturedState& entry = it->second;
+      CUDA_CALL(cudaGraphLaunch(entry.exec, CUDAThreadEntry::ThreadLocal()->stream));
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+      return entry.states;
     }
 
     // Set up arguments for the graph execution
@@ -186,12 +215,22 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
 
     CUDAGraphCapturedState entry;
     entry.states = capture_func_rv;
+    size_t free_before = 0, free_after = 0, total = 0;
+    CUDA_CALL(cudaMemGetInfo(&free_before, &total));
     CUDA_CALL(cudaGraphInstantiate(&entry.exec, graph, NULL, NULL, 0));
     CUDA_CALL(cudaGraphDestroy(graph));
+    // Upload the graph so that its device memory is allocated, and accounted, now.
+    CUDA_CALL(cudaGraphUpload(entry.exec, CUDAThreadEntry::ThreadLocal()->stream));
+    CUDA_CALL(cudaMemGetInfo(&free_after, &total));
+    entry.nbytes = free_before > free_after ? free_before - free_after : 0;
 
     ObjectRef states = entry.states;
 
+    lru_.push_front(entry_key);
+    entry.lru_pos = lru_.begin();
+    cached_bytes_ += entry.nbytes;
     capture_cache_[entry_key] = std::move(entry);
+    EvictGraphs();
 
     return states;
   }
@@ -218,6 +257,22 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
   static constexpr const char* _type_key = "relax_vm.CUDAGraphExtension";
 
  private:
+  /*! \brief Destroy the least recently launched graphs until the cache fits in the limits. */
+  void EvictGraphs() {
+    int64_t max_num_graphs = CUDAGraphCacheLimits::Global()->max_num_graphs.load();
+    int64_t max_bytes = CUDAGraphCacheLimits::Global()->max_bytes.load();
+    // The graph just captured is kept even when it alone exceeds the limits.
+    while (lru_.size() > 1 &&
+           ((max_num_graphs > 0 && static_cast<int64_t>(lru_.size()) > max_num_graphs) ||
+            (max_bytes > 0 && static_cast<int64_t>(cached_bytes_) > max_bytes))) {
+      auto it = capture_cache_.find(lru_.back());
+      ICHECK(it != capture_cache_.end());
+      cached_bytes_ -= it->second.nbytes;
+      capture_cache_.erase(it);
+      lru_.pop_back();
+    }
+  }
+
   /*!
    * \brief The cache of captured cuda graphs. The key is a unique index for the capture function.
    * The value is the result of the capture.
@@ -225,6 +280,10 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
   std::unordered_map<CUDAGraphCaptureKey, CUDAGraphCapturedState, CUDAGraphCaptureKeyHash,
                      CUDAGraphCaptureKeyEqual>
       capture_cache_;
+  /*! \brief The keys of the captured graphs, the most recently launched first. */
+  std::list<CUDAGraphCaptureKey> lru_;
+  /*! \brief The total device memory of the captured graphs. */
+  size_t cached_bytes_ = 0;
   /*!
    * \brief The cache of allocations. The key is a unique index for the allocation function.
    * The value is the cached allocations, which is a tuple of storages.
@@ -257,6 +316,18 @@ TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.run_or_capture")
       *rv = extension->RunOrCapture(vm, capture_func, func_args, entry_index, shape_expr);
     });
 
+/*!
+ * \brief Set the maximum number of captured graphs and their maximum total device memory
+ *  kept by each VM, 0 for no limit.
+ */
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.set_cache_limits")
+    .set_body_typed([](int64_t max_num_graphs, int64_t max_bytes) {
+      CHECK_GE(max_num_graphs, 0) << "The maximum number of CUDA graphs cannot be negative";
+      CHECK_GE(max_bytes, 0) << "The maximum memory of the CUDA graphs cannot be negative";
+      CUDAGraphCacheLimits::Global()->max_num_graphs.store(max_num_graphs);
+      CUDAGraphCacheLimits::Global()->max_bytes.store(max_bytes);
+    });
+
 TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.get_cached_alloc")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
       ICHECK_EQ(args.size(), 3);
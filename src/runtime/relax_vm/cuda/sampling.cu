@@ -0,0 +1,356 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/cuda/sampling.cu
+ * \brief Device-side token sampling built-ins for the Relax VM.
+ *
+ * Each row of logits is sampled by one thread block, without sorting and
+ * without copying the logits to the host:
+ *  1. a block reduction computes the max logit and the softmax denominator,
+ *  2. a radix select over the bits of the (unnormalized) probabilities finds the
+ *     smallest probability kept by both the top-k and the top-p constraint,
+ *  3. a block scan over the vocabulary draws the token among the kept ones.
+ * Penalties on the previously generated tokens are optionally applied in place
+ * by the same block before step 1, so one launch covers a whole decode step.
+ */
+#include <cub/block/block_reduce.cuh>
+#include <cub/block/block_scan.cuh>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <climits>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+namespace {
+
+constexpr int kSamplingThreads = 512;
+constexpr int kRadixBits = 8;
+constexpr int kRadixBins = 1 << kRadixBits;
+
+/*! \brief The sampling parameters of one row, either from per-row arrays or scalars. */
+struct SamplingParams {
+  const float* temperature;
+  const float* top_p;
+  const int32_t* top_k;
+  const float* uniform_samples;
+  float temperature_scalar;
+  float top_p_scalar;
+  int32_t top_k_scalar;
+  float uniform_sample_scalar;
+  /*! \brief CSR indptr of the generated tokens of each row, nullptr to skip penalties. */
+  const int32_t* token_indptr;
+  const int32_t* token_ids;
+  const int32_t* token_counts;
+  const float* presence_penalty;
+  const float* frequency_penalty;
+  const float* repetition_penalty;
+};
+
+template <int BLOCK>
+__global__ void SampleFromLogitsKernel(float* logits, int64_t vocab_size,
+                                       SamplingParams params, int32_t* __restrict__ out) {
+  using BlockReduce = cub::BlockReduce<float, BLOCK>;
+  using BlockScan = cub::BlockScan<float, BLOCK>;
+  __shared__ union {
+    typename BlockReduce::TempStorage reduce;
+    typename BlockScan::TempStorage scan;
+  } temp_storage;
+  __shared__ uint32_t hist_count[kRadixBins];
+  __shared__ float hist_mass[kRadixBins];
+  __shared__ float s_max, s_sum, s_kept_sum, s_running;
+  __shared__ uint32_t s_prefix, s_mask, s_count_above;
+  __shared__ float s_mass_above;
+  __shared__ int s_result, s_last;
+
+  const int64_t row = blockIdx.x;
+  const int tid = threadIdx.x;
+
+  // Step 0. penalties. The logits are not restrict-qualified, so the reads
+  // below observe these writes after the barrier.
+  if (params.token_indptr != nullptr) {
+    float* xw = logits + row * vocab_size;
+    float presence = params.presence_penalty ? params.presence_penalty[row] : 0.0f;
+    float frequency = params.frequency_penalty ? params.frequency_penalty[row] : 0.0f;
+    float repetition = params.repetition_penalty ? params.repetition_penalty[row] : 1.0f;
+    for (int32_t j = params.token_indptr[row] + tid; j < params.token_indptr[row + 1]; j += BLOCK) {
+      int32_t token_id = params.token_ids[j];
+      float v = xw[token_id];
+      v = v <= 0.0f ? v * repetition : v / repetition;
+      v -= params.token_counts[j] * frequency + presence;
+      xw[token_id] = v;
+    }
+    __syncthreads();
+  }
+  const float* x = logits + row * vocab_size;
+
+  float temperature = params.temperature ? params.temperature[row] : params.temperature_scalar;
+  float top_p = params.top_p ? params.top_p[row] : params.top_p_scalar;
+  int64_t top_k = params.top_k ? params.top_k[row] : params.top_k_scalar;
+  float uniform =
+      params.uniform_samples ? params.uniform_samples[row] : params.uniform_sample_scalar;
+  // Zero temperature means greedy decoding, which is top-1 sampling.
+  bool greedy = temperature < 1e-6f;
+  float inv_temp = greedy ? 1.0f : 1.0f / temperature;
+  if (greedy) top_k = 1;
+  if (top_k <= 0 || top_k > vocab_size) top_k = vocab_size;
+  if (greedy || top_p <= 0.0f || top_p > 1.0f) top_p = 1.0f;
+
+  // Step 1. max and softmax denominator.
+  float local_max = -INFINITY;
+  for (int64_t i = tid; i < vocab_size; i += BLOCK) local_max = fmaxf(local_max, x[i]);
+  float max_logit = BlockReduce(temp_storage.reduce).Reduce(local_max, cub::Max());
+  if (tid == 0) s_max = max_logit;
+  __syncthreads();
+  max_logit = s_max;
+  auto fexp = [&](int64_t i) { return __expf((x[i] - max_logit) * inv_temp); };
+
+  float local_sum = 0.0f;
+  for (int64_t i = tid; i < vocab_size; i += BLOCK) local_sum += fexp(i);
+  float sum = BlockReduce(temp_storage.reduce).Sum(local_sum);
+  if (tid == 0) {
+    s_sum = sum;
+    s_prefix = 0;
+    s_mask = 0;
+    s_count_above = 0;
+    s_mass_above = 0.0f;
+  }
+  __syncthreads();
+  const float mass_needed = top_p * s_sum;
+
+  // Step 2. radix select. For non-negative floats the order of the bit patterns
+  // matches the order of the values, so we walk the digits from the most significant.
+  for (int shift = 32 - kRadixBits; shift >= 0; shift -= kRadixBits) {
+    for (int b = tid; b < kRadixBins; b += BLOCK) {
+      hist_count[b] = 0;
+      hist_mass[b] = 0.0f;
+    }
+    __syncthreads();
+    uint32_t prefix = s_prefix, mask = s_mask;
+    for (int64_t i = tid; i < vocab_size; i += BLOCK) {
+      float e = fexp(i);
+      uint32_t bits = __float_as_uint(e);
+      if ((bits & mask) == prefix) {
+        uint32_t digit = (bits >> shift) & (kRadixBins - 1);
+        atomicAdd(&hist_count[digit], 1u);
+        atomicAdd(&hist_mass[digit], e);
+      }
+    }
+    __syncthreads();
+    if (tid == 0) {
+      uint32_t count = s_count_above;
+      float mass = s_mass_above;
+      int digit = kRadixBins - 1;
+      // Stop at the first bin whose inclusion satisfies either constraint.
+      for (; digit > 0; --digit) {
+        if (count + hist_count[digit] >= top_k || mass + hist_mass[digit] >= mass_needed) break;
+        count += hist_count[digit];
+        mass += hist_mass[digit];
+      }
+      s_count_above = count;
+      s_mass_above = mass;
+      s_prefix = prefix | (static_cast<uint32_t>(digit) << shift);
+      s_mask = mask | (static_cast<uint32_t>(kRadixBins - 1) << shift);
+    }
+    __syncthreads();
+  }
+  const uint32_t threshold = s_prefix;
+
+  // Step 3. multinomial draw among the kept tokens, in vocabulary order.
+  float local_kept = 0.0f;
+  for (int64_t i = tid; i < vocab_size; i += BLOCK) {
+    float e = fexp(i);
+    if (__float_as_uint(e) >= threshold) local_kept += e;
+  }
+  float kept_sum = BlockReduce(temp_storage.reduce).Sum(local_kept);
+  if (tid == 0) {
+    s_kept_sum = kept_sum;
+    s_running = 0.0f;
+    s_result = INT_MAX;
+    s_last = 0;
+  }
+  __syncthreads();
+  const float target = uniform * s_kept_sum;
+  for (int64_t base = 0; base < vocab_size; base += BLOCK) {
+    int64_t i = base + tid;
+    float e = 0.0f;
+    if (i < vocab_size) {
+      e = fexp(i);
+      if (__float_as_uint(e) < threshold) e = 0.0f;
+    }
+    float inclusive, total;
+    BlockScan(temp_storage.scan).InclusiveSum(e, inclusive, total);
+    float running = s_running;
+    if (e > 0.0f) {
+      atomicMax(&s_last, static_cast<int>(i));
+      if (running + inclusive > target) atomicMin(&s_result, static_cast<int>(i));
+    }
+    __syncthreads();
+    if (s_result != INT_MAX) break;
+    if (tid == 0) s_running = running + total;
+    __syncthreads();
+  }
+  if (tid == 0) {
+    // Rounding may leave the target just above the total kept mass.
+    out[row] = s_result != INT_MAX ? s_result : s_last;
+  }
+}
+
+void LaunchSampleFromLogits(const DLTensor* logits, const SamplingParams& params, int32_t* out) {
+  ICHECK_EQ(logits->device.device_type, kDLCUDA);
+  ICHECK(logits->dtype.code == kDLFloat && logits->dtype.bits == 32)
+      << "TypeError: Logits must be float32";
+  ICHECK_GE(logits->ndim, 1);
+  int64_t vocab_size = logits->shape[logits->ndim - 1];
+  int64_t batch_size = 1;
+  for (int i = 0; i < logits->ndim - 1; ++i) batch_size *= logits->shape[i];
+  CHECK_LE(vocab_size, INT_MAX) << "ValueError: Vocabulary size is too large";
+  float* data = reinterpret_cast<float*>(static_cast<char*>(logits->data) + logits->byte_offset);
+  SampleFromLogitsKernel<kSamplingThreads>
+      <<<batch_size, kSamplingThreads, 0, GetCUDAStream()>>>(data, vocab_size, params, out);
+  CUDA_CALL(cudaGetLastError());
+}
+
+template <typename T>
+const T* OptionalDeviceData(const Optional<NDArray>& arr, int64_t num_elems, const char* name) {
+  if (!arr.defined()) return nullptr;
+  const DLTensor* t = arr.value().operator->();
+  ICHECK_EQ(t->device.device_type, kDLCUDA) << "ValueError: " << name << " must be on CUDA";
+  ICHECK_EQ(GetDataSize(*t), num_elems * sizeof(T))
+      << "ValueError: " << name << " must have " << num_elems << " elements";
+  return reinterpret_cast<const T*>(static_cast<const char*>(t->data) + t->byte_offset);
+}
+
+}  // namespace
+
+/*!
+ * \brief Sample one token per row of logits on the device.
+ * \param logits The logits of shape [batch_size, vocab_size].
+ * \param temperature The per-row temperature of shape [batch_size], 0 for greedy decoding.
+ * \param top_p The per-row top-p of shape [batch_size], 1 to disable.
+ * \param top_k The per-row int32 top-k of shape [batch_size], 0 to disable.
+ * \param uniform_samples The per-row uniform samples in [0, 1) of shape [batch_size].
+ * \return The int32 sampled token ids of shape [batch_size], on the device of the logits.
+ */
+NDArray CUDASampleFromLogitsBatched(NDArray logits, NDArray temperature, NDArray top_p,
+                                    Optional<NDArray> top_k, NDArray uniform_samples) {
+  ICHECK(logits.IsContiguous());
+  ICHECK_EQ(logits->ndim, 2) << "ValueError: Logits must have shape [batch_size, vocab_size]";
+  int64_t batch_size = logits->shape[0];
+  SamplingParams params{};
+  params.temperature = OptionalDeviceData<float>(temperature, batch_size, "temperature");
+  params.top_p = OptionalDeviceData<float>(top_p, batch_size, "top_p");
+  params.top_k = OptionalDeviceData<int32_t>(top_k, batch_size, "top_k");
+  params.uniform_samples =
+      OptionalDeviceData<float>(uniform_samples, batch_size, "uniform_samples");
+  NDArray out = NDArray::Empty({batch_size}, DataType::Int(32), logits->device);
+  LaunchSampleFromLogits(logits.operator->(), params, static_cast<int32_t*>(out->data));
+  return out;
+}
+
+/*!
+ * \brief The device-side counterpart of vm.builtin.sample_top_p_from_logits.
+ * Only the sampled token id is copied back to the host.
+ */
+int CUDASampleTopPFromLogits(NDArray logits, double temperature, double top_p,
+                             double uniform_sample) {
+  ICHECK(logits.IsContiguous());
+  for (int i = 0; i < logits->ndim - 1; ++i) {
+    ICHECK_EQ(logits->shape[i], 1) << "The leading dimensions of logits must be 1";
+  }
+  SamplingParams params{};
+  params.temperature_scalar = static_cast<float>(temperature);
+  params.top_p_scalar = static_cast<float>(top_p);
+  params.top_k_scalar = 0;
+  params.uniform_sample_scalar = static_cast<float>(uniform_sample);
+  NDArray out = NDArray::Empty({1}, DataType::Int(32), logits->device);
+  LaunchSampleFromLogits(logits.operator->(), params, static_cast<int32_t*>(out->data));
+  int32_t token_id;
+  CUDA_CALL(cudaMemcpyAsync(&token_id, out->data, sizeof(int32_t), cudaMemcpyDeviceToHost,
+                            GetCUDAStream()));
+  CUDA_CALL(cudaStreamSynchronize(GetCUDAStream()));
+  return token_id;
+}
+
+/*!
+ * \brief Apply the generation penalties, softmax with temperature and top-k/top-p
+ *  sampling to a batch of logits in one kernel launch.
+ *
+ * The penalties follow vm.builtin.apply_repetition_penalty and
+ * vm.builtin.apply_presence_and_frequency_penalty, and are applied to the logits in place.
+ *
+ * \param logits The logits of shape [batch_size, vocab_size].
+ * \param token_indptr The int32 CSR indptr of shape [batch_size + 1] into token_ids.
+ * \param token_ids The int32 distinct generated token ids of all the rows.
+ * \param token_counts The int32 number of occurrences of each of token_ids.
+ * \param presence_penalty The per-row presence penalty of shape [batch_size].
+ * \param frequency_penalty The per-row frequency penalty of shape [batch_size].
+ * \param repetition_penalty The per-row repetition penalty of shape [batch_size].
+ * \param temperature The per-row temperature of shape [batch_size], 0 for greedy decoding.
+ * \param top_p The per-row top-p of shape [batch_size], 1 to disable.
+ * \param top_k The per-row int32 top-k of shape [batch_size], 0 to disable.
+ * \param uniform_samples The per-row uniform samples in [0, 1) of shape [batch_size].
+ * \return The int32 sampled token ids of shape [batch_size], on the device of the logits.
+ */
+NDArray CUDASampleWithPenaltyBatched(NDArray logits, NDArray token_indptr, NDArray token_ids,
+                                     NDArray token_counts, Optional<NDArray> presence_penalty,
+                                     Optional<NDArray> frequency_penalty,
+                                     Optional<NDArray> repetition_penalty, NDArray temperature,
+                                     NDArray top_p, Optional<NDArray> top_k,
+                                     NDArray uniform_samples) {
+  ICHECK(logits.IsContiguous());
+  ICHECK_EQ(logits->ndim, 2) << "ValueError: Logits must have shape [batch_size, vocab_size]";
+  int64_t batch_size = logits->shape[0];
+  ICHECK_EQ(token_ids->ndim, 1);
+  int64_t num_tokens = token_ids->shape[0];
+  SamplingParams params{};
+  params.token_indptr = OptionalDeviceData<int32_t>(token_indptr, batch_size + 1, "token_indptr");
+  params.token_ids = OptionalDeviceData<int32_t>(token_ids, num_tokens, "token_ids");
+  params.token_counts = OptionalDeviceData<int32_t>(token_counts, num_tokens, "token_counts");
+  params.presence_penalty =
+      OptionalDeviceData<float>(presence_penalty, batch_size, "presence_penalty");
+  params.frequency_penalty =
+      OptionalDeviceData<float>(frequency_penalty, batch_size, "frequency_penalty");
+  params.repetition_penalty =
+      OptionalDeviceData<float>(repetition_penalty, batch_size, "repetition_penalty");
+  params.temperature = OptionalDeviceData<float>(temperature, batch_size, "temperature");
+  params.top_p = OptionalDeviceData<float>(top_p, batch_size, "top_p");
+  params.top_k = OptionalDeviceData<int32_t>(top_k, batch_size, "top_k");
+  params.uniform_samples =
+      OptionalDeviceData<float>(uniform_samples, batch_size, "uniform_samples");
+  NDArray out = NDArray::Empty({batch_size}, DataType::Int(32), logits->device);
+  LaunchSampleFromLogits(logits.operator->(), params, static_cast<int32_t*>(out->data));
+  return out;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda.sample_from_logits_batched")
+    .set_body_typed(CUDASampleFromLogitsBatched);
+TVM_REGISTER_GLOBAL("vm.builtin.cuda.sample_top_p_from_logits")
+    .set_body_typed(CUDASampleTopPFromLogits);
+TVM_REGISTER_GLOBAL("vm.builtin.cuda.sample_with_penalty_batched")
+    .set_body_typed(CUDASampleWithPenaltyBatched);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
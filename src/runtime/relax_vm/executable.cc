@@ -22,12 +22,16 @@
  */
 
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/relax_vm/executable.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <cstring>
 #include <functional>
 #include <sstream>
+#include <string>
+#include <utility>
 
 #include "../file_utils.h"
 
@@ -38,6 +42,12 @@ namespace relax_vm {
 /*! \brief The magic number for the serialized VM bytecode file  */
 constexpr uint64_t kTVMVMBytecodeMagic = 0xD225DE2F4214151D;
 
+/*!
+ * \brief The offset of the code in the files written by SaveToFile, after the size of the code.
+ *  The data of the NDArray constants is aligned in the files, so it can be mapped in place.
+ */
+constexpr size_t kCodeOffsetInFile = sizeof(uint64_t);
+
 /*! \brief Possible types in the constant pool */
 enum ConstantType : int {
   kNDArray = 0,
@@ -201,10 +211,8 @@ void Executable::SaveToFile(const String& file_name, const String& format) {
   runtime::SaveBinaryToFile(file_name, data);
 }
 
-Module Executable::LoadFromBinary(void* stream) {
-  std::string code;
-  static_cast<dmlc::Stream*>(stream)->Read(&code);
-  dmlc::MemoryStringStream strm(&code);
+Module Executable::LoadFromBytes(const char* data, size_t size, ObjectRef owner) {
+  dmlc::MemoryFixedSizeStream strm(const_cast<char*>(data), size);
 
   ObjectPtr<Executable> exec = make_object<Executable>();
 
@@ -215,7 +223,7 @@ Module Executable::LoadFromBinary(void* stream) {
   exec->LoadGlobalSection(&strm);
 
   // Constant section.
-  exec->LoadConstantSection(&strm);
+  exec->LoadConstantSection(&strm, data, size, owner);
 
   // Code section.
   exec->LoadCodeSection(&strm);
@@ -223,15 +231,26 @@ Module Executable::LoadFromBinary(void* stream) {
   return Module(exec);
 }
 
+Module Executable::LoadFromBinary(void* stream) {
+  std::string code;
+  static_cast<dmlc::Stream*>(stream)->Read(&code);
+  // The NDArray constants may alias the code, which is kept alive by them
+  String owner(std::move(code));
+  return LoadFromBytes(owner.data(), owner.size(), owner);
+}
+
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_relax.Executable")
     .set_body_typed(Executable::LoadFromBinary);
 
 Module Executable::LoadFromFile(const String& file_name) {
-  std::string data;
-  runtime::LoadBinaryFromFile(file_name, &data);
-  dmlc::MemoryStringStream reader(&data);
-  dmlc::Stream* strm = &reader;
-  return Executable::LoadFromBinary(reinterpret_cast<void*>(strm));
+  // The file holds the code as written by SaveToFile, preceded by its size. The NDArray
+  // constants alias the mapped file, so their pages are shared by all the processes loading it.
+  MappedFile file = MappedFile::Open(file_name, /*sequential=*/false);
+  uint64_t code_size = 0;
+  STREAM_CHECK(file->size() >= kCodeOffsetInFile, "header");
+  std::memcpy(&code_size, file->data(), sizeof(code_size));
+  STREAM_CHECK(code_size <= file->size() - kCodeOffsetInFile, "header");
+  return LoadFromBytes(file->data() + kCodeOffsetInFile, code_size, file);
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_relax.Executable")
@@ -263,12 +282,81 @@ bool VMFuncInfo::Load(dmlc::Stream* strm) {
 
 void Executable::SaveGlobalSection(dmlc::Stream* strm) { strm->Write(func_table); }
 
-void Executable::SaveConstantSection(dmlc::Stream* strm) {
+/*!
+ * \brief Save an NDArray constant, with its data aligned in the files written by SaveToFile.
+ *
+ * The layout is the ndim, the dtype, the shape and the data size, followed by the number of
+ * padding bytes, the padding and the data.
+ */
+void SaveNDArrayConstant(dmlc::SeekStream* strm, NDArray arr) {
+  if (arr->device.device_type != kDLCPU) {
+    arr = arr.CopyTo(Device{kDLCPU, 0});
+  }
+  ICHECK(arr.IsContiguous()) << "ValueError: The NDArray constants must be contiguous";
+  int32_t ndim = arr->ndim;
+  int64_t nbytes = GetDataSize(*arr.operator->());
+  strm->Write(ndim);
+  strm->Write(arr->dtype);
+  strm->WriteArray(arr->shape, ndim);
+  strm->Write(nbytes);
+  size_t data_offset = kCodeOffsetInFile + strm->Tell() + sizeof(uint64_t);
+  uint64_t padding = (kAllocAlignment - data_offset % kAllocAlignment) % kAllocAlignment;
+  strm->Write(padding);
+  std::string zeros(padding, '\0');
+  strm->Write(zeros.data(), zeros.size());
+  strm->Write(static_cast<const char*>(arr->data) + arr->byte_offset, nbytes);
+}
+
+/*! \brief Deleter of the NDArray constants that alias the serialized executable. */
+static void ConstantAliasDeleter(Object* obj) {
+  auto* ptr = static_cast<NDArray::Container*>(obj);
+  delete static_cast<ObjectRef*>(ptr->manager_ctx);
+  delete ptr;
+}
+
+/*!
+ * \brief Load an NDArray constant saved by SaveNDArrayConstant. Its data is aliased in place
+ *  when it is suitably aligned in memory, and copied otherwise.
+ */
+NDArray LoadNDArrayConstant(dmlc::SeekStream* strm, const char* data, size_t size,
+                            const ObjectRef& owner) {
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t nbytes;
+  uint64_t padding;
+  STREAM_CHECK(strm->Read(&ndim) && ndim >= 0, "constant");
+  STREAM_CHECK(strm->Read(&dtype), "constant");
+  std::vector<ShapeTuple::index_type> shape(ndim);
+  STREAM_CHECK(strm->ReadArray(shape.data(), ndim), "constant");
+  STREAM_CHECK(strm->Read(&nbytes) && nbytes >= 0, "constant");
+  STREAM_CHECK(strm->Read(&padding), "constant");
+  size_t offset = strm->Tell() + padding;
+  STREAM_CHECK(offset <= size && static_cast<uint64_t>(nbytes) <= size - offset, "constant");
+  strm->Seek(offset + nbytes);
+  const char* arr_data = data + offset;
+  NDArray arr;
+  if (reinterpret_cast<uintptr_t>(arr_data) % kAllocAlignment == 0) {
+    NDArray::Container* container = new NDArray::Container(
+        const_cast<char*>(arr_data), ShapeTuple(shape), dtype, Device{kDLCPU, 0});
+    container->SetDeleter(ConstantAliasDeleter);
+    container->manager_ctx = new ObjectRef(owner);
+    arr = NDArray(GetObjectPtr<Object>(container));
+  } else {
+    arr = NDArray::Empty(ShapeTuple(shape), dtype, Device{kDLCPU, 0});
+  }
+  STREAM_CHECK(GetDataSize(*arr.operator->()) == static_cast<size_t>(nbytes), "constant");
+  if (arr->data != arr_data) {
+    std::memcpy(arr->data, arr_data, nbytes);
+  }
+  return arr;
+}
+
+void Executable::SaveConstantSection(dmlc::SeekStream* strm) {
   strm->Write(static_cast<uint64_t>(this->constants.size()));
   for (const auto& it : this->constants) {
     if (it.IsObjectRef<runtime::NDArray>()) {
       strm->Write(ConstantType::kNDArray);
-      runtime::SaveDLTensor(strm, it.operator DLTensor*());
+      SaveNDArrayConstant(strm, it.operator NDArray());
     } else if (it.IsObjectRef<ShapeTuple>()) {
       ShapeTuple shape = it.operator ShapeTuple();
       strm->Write(ConstantType::kShapeTuple);
@@ -314,22 +402,21 @@ void Executable::LoadGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::LoadConstantSection(dmlc::Stream* strm) {
+void Executable::LoadConstantSection(dmlc::SeekStream* strm, const char* data, size_t size,
+                                     const ObjectRef& owner) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
 
-  size_t size = static_cast<size_t>(sz);
-  runtime::NDArray ndarray;
+  size_t num_constants = static_cast<size_t>(sz);
   DLDataType dtype;
   // Load each of the constants.
-  for (size_t i = 0; i < size; i++) {
+  for (size_t i = 0; i < num_constants; i++) {
     int constant_type;
     STREAM_CHECK(strm->Read(&constant_type, sizeof(constant_type)), "constant");
     if (constant_type == ConstantType::kNDArray) {
-      ndarray.Load(strm);
       TVMRetValue cell;
-      cell = ndarray;
+      cell = LoadNDArrayConstant(strm, data, size, owner);
       this->constants.push_back(cell);
     } else if (constant_type == ConstantType::kShapeTuple) {
       uint64_t size;
@@ -60,12 +60,32 @@ TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_enable_sliding_window_for_seq
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::EnableSlidingWindowForSeq);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::CommitAcceptedTokenTreeNodes);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_prefix_cache_insert")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::PrefixCacheInsert);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_prefix_cache_match_and_add_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::PrefixCacheMatchAndAddSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_prefix_cache_evict")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::PrefixCacheEvict);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_swap_out_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::SwapOutSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_swap_in_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::SwapInSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_export_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::ExportSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_import_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::ImportSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_begin_multi_step_decode")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::BeginMultiStepDecode);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_empty")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::Empty);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_num_available_pages")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetNumAvailablePages);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_total_sequence_length")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetTotalSequenceLength);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_page_stats")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetPageStats);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_sequence_num_pages")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetSequenceNumPages);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_query_positions")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetQueryPositions);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_debug_get_kv")
@@ -86,6 +106,8 @@ TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_set")
     });
 TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_debug_get")
     .set_body_method<RNNState>(&RNNStateObj::DebugGet);
+TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_rollback_to_checkpoint")
+    .set_body_method<RNNState>(&RNNStateObj::RollbackToCheckpoint);
 
 }  // namespace relax_vm
 }  // namespace runtime
@@ -134,6 +134,29 @@ class AttentionKVCacheObj : public KVStateObj {
   /*! \brief Get the current total sequence length in the KV cache. */
   virtual int32_t GetTotalSequenceLength() const = 0;
 
+  /*!
+   * \brief Get the page occupancy statistics of the cache. The cost is linear to
+   * the total number of blocks of the sequences, so that it can be polled every step.
+   * \return A tuple with the following entries, in order:
+   * - the number of total pages,
+   * - the number of free pages,
+   * - the number of pages shared by more than one sequence,
+   * - the number of pages only retained by the prefix cache,
+   * - the number of host pages holding swapped-out sequences,
+   * - the number of pages released by sliding window since the last Clear,
+   * - the number of sequences (excluding the ones retained by the prefix cache),
+   * - the number of blocks in use.
+   */
+  virtual IntTuple GetPageStats() const = 0;
+
+  /*!
+   * \brief Get the number of device pages that each given sequence references,
+   * including the pages shared with other sequences.
+   * \param seq_ids The ids of the sequences to query.
+   * \return The number of pages of each sequence.
+   */
+  virtual IntTuple GetSequenceNumPages(const IntTuple& seq_ids) const = 0;
+
   /************** Sequence Management **************/
 
   /*!
@@ -157,6 +180,99 @@ class AttentionKVCacheObj : public KVStateObj {
   virtual void CommitAcceptedTokenTreeNodes(const IntTuple& seq_ids,
                                             const IntTuple& leaf_indices) = 0;
 
+  /************** Prefix Cache **************/
+
+  /*!
+   * \brief Retain the K/V data of the leading tokens of a sequence, so that
+   * later sequences starting with the same tokens can reuse it.
+   * The retained K/V data shares pages with the sequence, and stays in the
+   * cache after the sequence is removed until it is evicted.
+   * \param seq_id The id of the sequence whose K/V data is retained.
+   * \param token_ids The token ids of the sequence. Only whole pages are retained.
+   * \return The number of leading tokens retained.
+   */
+  virtual int64_t PrefixCacheInsert(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /*!
+   * \brief Add a new sequence, reusing the longest retained prefix of its tokens.
+   * \param seq_id The id of the new sequence.
+   * \param token_ids The token ids of the new sequence.
+   * \return The number of leading tokens whose K/V data is reused. The caller
+   * only needs to forward the remaining tokens.
+   */
+  virtual int64_t PrefixCacheMatchAndAddSequence(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /*!
+   * \brief Evict the retained prefixes in least-recently-used order.
+   * Retained prefixes are also evicted automatically in BeginForward
+   * when the free pages may not be enough.
+   * \param num_pages The number of pages to free, or -1 to evict all.
+   * \return The number of pages freed.
+   */
+  virtual int64_t PrefixCacheEvict(int64_t num_pages) = 0;
+
+  /************** Swapping **************/
+
+  /*!
+   * \brief Swap the K/V data of a sequence out to host memory, releasing its pages.
+   * The blocks shared with other sequences stay in the cache. A swapped-out sequence
+   * keeps its length and structure, but cannot be forwarded, forked or popped
+   * until it is swapped in.
+   * \param seq_id The id of the sequence to swap out.
+   * \return The number of pages released.
+   */
+  virtual int32_t SwapOutSequence(int64_t seq_id) = 0;
+
+  /*!
+   * \brief Restore the K/V data of a swapped-out sequence from host memory.
+   * \param seq_id The id of the sequence to swap in.
+   * \throws Error if there are not enough free pages.
+   */
+  virtual void SwapInSequence(int64_t seq_id) = 0;
+
+  /************** Transfer **************/
+
+  /*!
+   * \brief Copy the K/V data of a sequence into standalone arrays on the device of the cache,
+   * so that it can be moved to another KV cache instance, e.g. a decode instance in another
+   * process, with disco's `send_to_worker` or a CUDA IPC handle of the arrays.
+   * The copies run on the copy stream, which the compute stream waits for before any later
+   * work, so the arrays are ready for the work launched on the compute stream afterwards.
+   * \param seq_id The id of the sequence to export. The sequence stays in the cache.
+   * \return The pages of the sequence in order, in shape
+   * (num_layers, num_pages, 2, num_kv_heads, page_size, head_dim), followed by their scales
+   * in shape (num_layers, num_pages, 2, num_kv_heads) when the pages are quantized.
+   */
+  virtual Array<NDArray> ExportSequence(int64_t seq_id) = 0;
+
+  /*!
+   * \brief Add a new sequence with the K/V data exported from another KV cache instance
+   * of the same configuration. The copies into the cache run on the copy stream and
+   * overlap with the pending computation until the next forward of the cache.
+   * \param seq_id The id of the new sequence.
+   * \param seq_length The length of the exported sequence.
+   * \param data The arrays returned by ExportSequence, on any device that can be copied from.
+   * \throws Error if there are not enough free pages.
+   */
+  virtual void ImportSequence(int64_t seq_id, int64_t seq_length, const Array<NDArray>& data) = 0;
+
+  /************** Multi-Step Decode **************/
+
+  /*!
+   * \brief Schedule multiple decode steps of the given sequences at once.
+   * It reserves the pages for `num_steps` tokens of each sequence and prepares
+   * the auxiliary data of all steps with a single host-to-device synchronization.
+   * Each of the following `num_steps` forwards then runs one decode step
+   * (with append length 1 for each sequence) without calling BeginForward,
+   * and EndForward moves to the next step.
+   * The sequence lengths are advanced by `num_steps` at once. Calling BeginForward
+   * before all the steps are done drops the remaining steps, whose tokens can be
+   * removed with PopN.
+   * \param seq_ids The ids of the sequences to decode.
+   * \param num_steps The number of decode steps.
+   */
+  virtual void BeginMultiStepDecode(const IntTuple& seq_ids, int64_t num_steps) = 0;
+
   /************** Attention **************/
 
   /*!
@@ -263,6 +379,18 @@ class RNNStateObj : public KVStateObj {
    */
   virtual NDArray DebugGet(int64_t layer_id, int64_t state_id, int64_t seq_id) = 0;
 
+  /*!
+   * \brief Roll back the trailing `n` tokens of the given sequence to the closest checkpoint
+   * at or before them, unlike PopN which requires a checkpoint right at the new length.
+   * \param seq_id The sequence to roll back.
+   * \param n The number of tokens to roll back.
+   * \return The number of tokens rolled back beyond the `n` ones, which are to be forwarded
+   * again to restore the state.
+   * \throws Error if the given sequence id is not valid, or the sequence has no checkpoint old
+   * enough.
+   */
+  virtual int64_t RollbackToCheckpoint(int64_t seq_id, int64_t n) = 0;
+
   static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
   static constexpr const char* _type_key = "relax.vm.RNNState";
   TVM_DECLARE_BASE_OBJECT_INFO(RNNStateObj, KVStateObj);
@@ -42,8 +42,12 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/relax_vm/vm.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 namespace tvm {
 namespace runtime {
@@ -337,6 +341,135 @@ void AttentionKVCacheArrayClear(Array<AttentionKVCacheLegacy> caches) {
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_array_clear")
     .set_body_typed(AttentionKVCacheArrayClear);
 
+/*!
+ * \brief Draw a token from the top-p nucleus of unnormalized weights.
+ *
+ * Instead of sorting the whole vocabulary, only the elements no smaller than
+ * a cutoff are collected (by pigeonhole there are at most 1024 / top_p of them),
+ * and they are selected with a growing partial sort until the nucleus is covered.
+ * The rare case where the cutoff loses part of the nucleus falls back to
+ * selecting over the whole vocabulary.
+ *
+ * \param weights The non-negative unnormalized probabilities.
+ * \param n The number of weights.
+ * \param total The sum of the weights.
+ * \param top_p The top-p value, the nucleus is not truncated when top_p >= 1.
+ * \param uniform_sample The uniform sample in [0, 1).
+ * \param data The scratch buffer of the candidates.
+ * \return The sampled index, or -1 if no weight is valid.
+ */
+int64_t SampleTopPFromWeights(const float* weights, int64_t n, float total, double top_p,
+                              double uniform_sample, std::vector<std::pair<float, int>>* data) {
+  if (top_p >= 1) {
+    // No truncation, so the draw does not need any ordering.
+    float target = uniform_sample * total;
+    float cum_sum = 0.0f;
+    int64_t last = -1;
+    for (int64_t i = 0; i < n; ++i) {
+      if (!(weights[i] > 0.0f)) continue;
+      cum_sum += weights[i];
+      last = i;
+      if (cum_sum > target) return i;
+    }
+    return last;
+  }
+
+  auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
+    return lhs.first > rhs.first;
+  };
+  const float mass_needed = top_p * total;
+  for (float cutoff : {static_cast<float>(mass_needed / 1024), 0.0f}) {
+    data->clear();
+    for (int64_t i = 0; i < n; ++i) {
+      if (weights[i] >= cutoff) data->emplace_back(weights[i], static_cast<int>(i));
+    }
+    if (data->empty()) continue;
+    // Select the largest candidates in growing batches until they cover the nucleus.
+    size_t num_sorted = 0, num_kept = 0;
+    size_t batch = std::min<size_t>(64, data->size());
+    float top_p_sum = 0.0f;
+    while (num_kept == 0) {
+      std::partial_sort(data->begin() + num_sorted, data->begin() + batch, data->end(), fcmp);
+      for (; num_sorted < batch; ++num_sorted) {
+        top_p_sum += (*data)[num_sorted].first;
+        if (top_p_sum >= mass_needed) {
+          num_kept = num_sorted + 1;
+          break;
+        }
+      }
+      if (num_kept == 0 && batch == data->size()) break;
+      batch = std::min(batch * 2, data->size());
+    }
+    if (num_kept == 0) {
+      // The candidates above the cutoff do not cover the nucleus, retry with all the elements.
+      if (cutoff != 0.0f) continue;
+      // Only reachable through rounding, in which case all the elements are kept.
+      num_kept = data->size();
+    }
+    float target = uniform_sample * top_p_sum;
+    float cum_sum = 0.0f;
+    for (size_t i = 0; i < num_kept; ++i) {
+      cum_sum += (*data)[i].first;
+      if (cum_sum > target) return (*data)[i].second;
+    }
+    return (*data)[num_kept - 1].second;
+  }
+  return -1;
+}
+
+/*!
+ * \brief Sample a token from one row of logits.
+ * \param logits The logits of the row.
+ * \param n The vocabulary size.
+ * \param temperature The temperature, greedy decoding when smaller than 1e-6.
+ * \param top_p The top-p value.
+ * \param uniform_sample The uniform sample in [0, 1).
+ * \param weights The scratch buffer of the unnormalized probabilities.
+ * \param data The scratch buffer of the candidates.
+ */
+int64_t SampleTopPFromLogitsRow(const float* logits, int64_t n, double temperature, double top_p,
+                                double uniform_sample, std::vector<float>* weights,
+                                std::vector<std::pair<float, int>>* data) {
+  ICHECK_GT(n, 0);
+  // argmax
+  if (temperature < 1e-6f) {
+    return std::max_element(logits, logits + n) - logits;
+  }
+  float max_value = *std::max_element(logits, logits + n);
+  float logit_scale = 1.0f / temperature;
+  weights->resize(n);
+  float* w = weights->data();
+  for (int64_t i = 0; i < n; ++i) {
+    w[i] = expf((logits[i] - max_value) * logit_scale);
+  }
+  float sum = 0.0f;
+  for (int64_t i = 0; i < n; ++i) {
+    sum += w[i];
+  }
+  return SampleTopPFromWeights(w, n, sum, top_p, uniform_sample, data);
+}
+
+void CheckSampledIndex(int64_t sampled_index, const float* p, int64_t n) {
+  if (sampled_index >= 0) return;
+  if (std::all_of(p, p + n, [](float x) { return std::isnan(x); })) {
+    LOG(FATAL) << "The output probabilities are all NaNs, can not sample from it";
+  } else {
+    LOG(FATAL) << "Cannot sample from the given probability distribution due to unknown reason";
+  }
+}
+
+/*! \brief Get the per-row float32 sampling parameters on CPU. */
+const float* GetRowParams(NDArray* arr, int64_t batch_size, const char* name) {
+  ICHECK(arr->IsContiguous());
+  ICHECK(arr->DataType() == DataType::Float(32)) << name << " must be float32";
+  ICHECK_EQ(GetDataSize(*arr->operator->()), batch_size * sizeof(float))
+      << name << " must have one element per row";
+  if ((*arr)->device.device_type != kDLCPU) {
+    *arr = arr->CopyTo(DLDevice{kDLCPU, 0});
+  }
+  return static_cast<const float*>((*arr)->data);
+}
+
 // NOTE this is a built-in highly related to LM so we put it here.
 int SampleTopPFromLogits(NDArray logits, double temperature, double top_p, double uniform_sample) {
   ICHECK(logits.IsContiguous());
@@ -352,51 +485,14 @@ int SampleTopPFromLogits(NDArray logits, double temperature, double top_p, doubl
     ICHECK_EQ(logits->shape[i], 1) << "The leading dimensions of logits must be 1";
   }
 
-  std::vector<std::pair<float, int>> data;
-  data.resize(logits->shape[logits->ndim - 1]);
+  int64_t ndata = logits->shape[logits->ndim - 1];
   const float* plogits = static_cast<float*>(logits->data);
-  for (size_t i = 0; i < data.size(); ++i) {
-    data[i] = std::make_pair(plogits[i], static_cast<int>(i));
-  }
-
-  auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
-    return lhs.first > rhs.first;
-  };
-  // sort by logits from largest to smallest
-  std::sort(data.begin(), data.end(), fcmp);
-
-  // argmax
-  if (temperature < 1e-6f) {
-    return data[0].second;
-  }
-
-  // compute expf scaled by temp
-  float sum = 0.0f, logit_scale = 1.0f / temperature;
-  float max_value = data[0].first;
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    it->first = expf((it->first - max_value) * logit_scale);
-    sum += it->first;
-  }
-
-  // do a cumsum in order of data
-  float cum_sum_prob = 0.0f;
-  float top_p_sum = 0.0f;
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    float prob = it->first / sum;
-    if (cum_sum_prob < top_p) {
-      top_p_sum += prob;
-    }
-    cum_sum_prob += prob;
-    it->first = cum_sum_prob;
-  }
-  // pick a number based on random in (0, 1)
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    if (uniform_sample < it->first / top_p_sum) {
-      return it->second;
-    }
-  }
-  ICHECK_LE(uniform_sample, data[0].first);
-  return data[0].second;
+  std::vector<float> weights;
+  std::vector<std::pair<float, int>> data;
+  int64_t sampled_index =
+      SampleTopPFromLogitsRow(plogits, ndata, temperature, top_p, uniform_sample, &weights, &data);
+  CheckSampledIndex(sampled_index, plogits, ndata);
+  return sampled_index;
 }
 
 TVM_REGISTER_GLOBAL("vm.builtin.sample_top_p_from_logits").set_body_typed(SampleTopPFromLogits);
@@ -415,86 +511,102 @@ int SampleTopPFromProb(NDArray prob, double top_p, double uniform_sample) {
     ICHECK_EQ(prob->shape[i], 1) << "The leading dimensions of logits must be 1";
   }
 
-  // Key observation: when we are doing top_p sampling
-  // usually we only need to preserve some of the elements with
-  // high probablities before we do sort
-  std::vector<std::pair<float, int>> data;
   int64_t ndata = prob->shape[prob->ndim - 1];
   const float* p_prob = static_cast<float*>(prob->data);
+  std::vector<std::pair<float, int>> data;
+  int64_t sampled_index = SampleTopPFromWeights(p_prob, ndata, 1.0f, top_p, uniform_sample, &data);
+  CheckSampledIndex(sampled_index, p_prob, ndata);
+  return sampled_index;
+}
 
-  auto sample_top_p_with_filter = [&](float cuttoff) -> int64_t {
-    data.clear();
-    // filter the data with cuttoff
-    for (int64_t i = 0; i < ndata; ++i) {
-      if (p_prob[i] >= cuttoff) {
-        data.emplace_back(std::make_pair(p_prob[i], static_cast<int>(i)));
-      }
-    }
-    if (data.size() == 0) return -1;
-    auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
-      return lhs.first > rhs.first;
-    };
-    std::sort(data.begin(), data.end(), fcmp);
-
-    // short cut, if we know that
-    // uniform sample < p[0] / top_p
-    // we know that unform_sample < p[0] / top_p_sum
-    // because top_p_sum gaurantees to be smaller than top_p
-    // so we can simply return the argmax sample
-    // without computing anything
-    if (uniform_sample < data[0].first / top_p) return data[0].second;
-
-    // compute top_p_sum
-    float cum_sum_prob = 0.0f;
-    float top_p_sum = 0.0f;
-    for (auto it = data.begin(); it != data.end(); ++it) {
-      float prob = it->first;
-      if (cum_sum_prob < top_p) {
-        top_p_sum += prob;
-      } else {
-        // we get to the right cutoff pt
-        break;
-      }
-      cum_sum_prob += prob;
-      it->first = cum_sum_prob;
-    }
-    // we find that the current total sum by the given cutoff
-    // is not sufficient to cover everything
-    // this means we might need to retry a smaller cutoff pt.
-    if (cum_sum_prob < top_p && cuttoff != 0.0f) return -1;
-
-    for (auto it = data.begin(); it != data.end(); ++it) {
-      if (uniform_sample < it->first / top_p_sum) {
-        return it->second;
-      }
-    }
-    return data[data.size() - 1].second;
-  };
+TVM_REGISTER_GLOBAL("vm.builtin.sample_top_p_from_prob").set_body_typed(SampleTopPFromProb);
 
-  auto is_all_nan = [&]() -> bool {
-    return std::all_of(p_prob, p_prob + ndata, [](float x) { return std::isnan(x); });
+/*!
+ * \brief Sample one token for each row of logits, in parallel over the rows.
+ * \param logits The float32 logits whose last dimension is the vocabulary.
+ * \param temperature The float32 temperature of each row.
+ * \param top_p The float32 top-p value of each row.
+ * \param uniform_samples The float32 uniform sample of each row.
+ * \return The int32 sampled token ids of shape [batch_size] on CPU,
+ *  where batch_size is the product of the leading dimensions of logits.
+ */
+NDArray SampleTopPFromLogitsBatched(NDArray logits, NDArray temperature, NDArray top_p,
+                                    NDArray uniform_samples) {
+  ICHECK(logits.IsContiguous());
+  ICHECK(logits.DataType() == DataType::Float(32));
+  if (logits->device.device_type != kDLCPU) {
+    logits = logits.CopyTo(DLDevice{kDLCPU, 0});
+  }
+  int64_t vocab_size = logits->shape[logits->ndim - 1];
+  int64_t batch_size = 1;
+  for (int i = 0; i < logits->ndim - 1; ++i) batch_size *= logits->shape[i];
+  const float* ptemperature = GetRowParams(&temperature, batch_size, "temperature");
+  const float* ptop_p = GetRowParams(&top_p, batch_size, "top_p");
+  const float* psample = GetRowParams(&uniform_samples, batch_size, "uniform_samples");
+  const float* plogits = static_cast<float*>(logits->data);
+
+  NDArray result = NDArray::Empty({batch_size}, DataType::Int(32), DLDevice{kDLCPU, 0});
+  int32_t* presult = static_cast<int32_t*>(result->data);
+  auto fsample = [&](int64_t i) {
+    thread_local std::vector<float> weights;
+    thread_local std::vector<std::pair<float, int>> data;
+    const float* row = plogits + i * vocab_size;
+    int64_t sampled_index = SampleTopPFromLogitsRow(row, vocab_size, ptemperature[i], ptop_p[i],
+                                                    psample[i], &weights, &data);
+    CheckSampledIndex(sampled_index, row, vocab_size);
+    presult[i] = static_cast<int32_t>(sampled_index);
   };
+  if (batch_size == 1) {
+    fsample(0);
+  } else {
+    parallel_for_with_threading_backend(fsample, 0, batch_size);
+  }
+  return result;
+}
 
-  if (top_p < 1) {
-    // sample through cutoff by a number
-    // by pigeonhole principle we will get at most 1024 elements
-    // usually it is much less by applying this filtering(order of 10 - 20)
-    data.reserve(128);
-    int64_t sampled_index = sample_top_p_with_filter(top_p / 1024);
-    if (sampled_index >= 0) return sampled_index;
+TVM_REGISTER_GLOBAL("vm.builtin.sample_top_p_from_logits_batched")
+    .set_body_typed(SampleTopPFromLogitsBatched);
+
+/*!
+ * \brief Sample one token for each row of probabilities, in parallel over the rows.
+ * \param prob The float32 probabilities whose last dimension is the vocabulary.
+ * \param top_p The float32 top-p value of each row.
+ * \param uniform_samples The float32 uniform sample of each row.
+ * \return The int32 sampled token ids of shape [batch_size] on CPU.
+ */
+NDArray SampleTopPFromProbBatched(NDArray prob, NDArray top_p, NDArray uniform_samples) {
+  ICHECK(prob.IsContiguous());
+  ICHECK(prob.DataType() == DataType::Float(32));
+  if (prob->device.device_type != kDLCPU) {
+    prob = prob.CopyTo(DLDevice{kDLCPU, 0});
   }
-  // fallback via full prob, rare case
-  data.reserve(ndata);
-  int64_t sampled_index = sample_top_p_with_filter(0.0f);
-  if (sampled_index < 0 && is_all_nan()) {
-    LOG(FATAL) << "The output probabilities are all NaNs, can not sample from it";
-  } else if (sampled_index < 0) {
-    LOG(FATAL) << "Cannot sample from the given probability distribution due to unknown reason";
+  int64_t vocab_size = prob->shape[prob->ndim - 1];
+  int64_t batch_size = 1;
+  for (int i = 0; i < prob->ndim - 1; ++i) batch_size *= prob->shape[i];
+  const float* ptop_p = GetRowParams(&top_p, batch_size, "top_p");
+  const float* psample = GetRowParams(&uniform_samples, batch_size, "uniform_samples");
+  const float* p_prob = static_cast<float*>(prob->data);
+
+  NDArray result = NDArray::Empty({batch_size}, DataType::Int(32), DLDevice{kDLCPU, 0});
+  int32_t* presult = static_cast<int32_t*>(result->data);
+  auto fsample = [&](int64_t i) {
+    thread_local std::vector<std::pair<float, int>> data;
+    const float* row = p_prob + i * vocab_size;
+    int64_t sampled_index =
+        SampleTopPFromWeights(row, vocab_size, 1.0f, ptop_p[i], psample[i], &data);
+    CheckSampledIndex(sampled_index, row, vocab_size);
+    presult[i] = static_cast<int32_t>(sampled_index);
+  };
+  if (batch_size == 1) {
+    fsample(0);
+  } else {
+    parallel_for_with_threading_backend(fsample, 0, batch_size);
   }
-  return sampled_index;
+  return result;
 }
 
-TVM_REGISTER_GLOBAL("vm.builtin.sample_top_p_from_prob").set_body_typed(SampleTopPFromProb);
+TVM_REGISTER_GLOBAL("vm.builtin.sample_top_p_from_prob_batched")
+    .set_body_typed(SampleTopPFromProbBatched);
 
 NDArray MultinomialFromUniform(NDArray prob, NDArray uniform_sample) {
   ICHECK(prob.IsContiguous());
@@ -0,0 +1,454 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/lora_adapter_pool.cc
+ * \brief Runtime pool of LoRA adapters, applied to batches mixing the adapters of the sequences.
+ *
+ * The adapters share the weight storage on device in pages of one rank each: page p of a LoRA
+ * target keeps row p of A, and row p of the transpose of B. An adapter of rank r holds any r
+ * pages, so that adapters of different ranks are loaded and evicted without fragmentation.
+ *
+ * A forward groups the tokens of consecutive sequences with the same adapter into segments.
+ * Each LoRA target is then applied to the whole batch by two kernels over the segments,
+ * regardless of how many adapters the batch mixes:
+ *  - f_shrink(x, a_pages, seg_token_indptr, seg_page_indptr, page_ids, tmp) computes
+ *    tmp[t, j] = sum_k x[t, k] * a_pages[page_ids[seg_page_indptr[s] + j], k]
+ *    for the tokens t of each segment s and the ranks j of its adapter;
+ *  - f_expand(tmp, b_pages, seg_token_indptr, seg_page_indptr, page_ids, seg_scaling, y)
+ *    accumulates y[t, n] += seg_scaling[s] * sum_j tmp[t, j] * b_pages[page_ids[...], n].
+ * The tokens without adapter are left untouched in y.
+ */
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief A pool of LoRA adapters paged on device. */
+class LoRAAdapterPoolObj : public Object {
+ private:
+  /*! \brief A weight of the base model with LoRA adapters. */
+  struct LoRATarget {
+    /*! \brief The name of the weight, used to look up the adapter weights. */
+    String name;
+    /*! \brief The input features of the weight. */
+    int64_t in_features;
+    /*! \brief The output features of the weight. */
+    int64_t out_features;
+    /*! \brief The rows of A of all adapters, in shape (num_pages, in_features). */
+    NDArray a_pages;
+    /*! \brief The rows of B transposed of all adapters, in shape (num_pages, out_features). */
+    NDArray b_pages;
+  };
+
+  /*! \brief A loaded adapter. */
+  struct Adapter {
+    /*! \brief The pages of the adapter, one per rank. */
+    std::vector<int32_t> pages;
+    /*! \brief The scaling of the adapter output, i.e. lora_alpha / rank. */
+    float scaling;
+    /*! \brief The forward which used the adapter the last, for eviction. */
+    int64_t last_use;
+  };
+
+  /*! \brief The number of pages of each LoRA target. */
+  const int64_t num_pages_;
+  /*! \brief The maximum rank of the adapters. */
+  const int64_t max_rank_;
+  /*! \brief The maximum number of tokens of a forward. */
+  const int64_t max_num_tokens_;
+  /*! \brief The maximum number of sequences of a forward. */
+  const int64_t reserved_num_seqs_;
+  /*! \brief The data type of the adapter weights. */
+  const DLDataType dtype_;
+  /*! \brief The device of the pool. */
+  const Device device_;
+  /*! \brief The weights with LoRA adapters. */
+  std::vector<LoRATarget> targets_;
+  /*! \brief The loaded adapters. */
+  std::unordered_map<int64_t, Adapter> adapters_;
+  /*! \brief The free pages. */
+  std::vector<int32_t> free_page_ids_;
+  /*! \brief The number of forwards so far. */
+  int64_t num_forwards_ = 0;
+
+  /*! \brief The kernel multiplying the inputs with A of the segments. */
+  PackedFunc f_shrink_;
+  /*! \brief The kernel accumulating the products with B of the segments to the outputs. */
+  PackedFunc f_expand_;
+
+  /*! \brief The workspace holding the products with A, in shape (max_num_tokens, max_rank). */
+  NDArray tmp_device_;
+  NDArray seg_token_indptr_device_;
+  NDArray seg_page_indptr_device_;
+  NDArray page_ids_device_;
+  NDArray seg_scaling_device_;
+  NDArray seg_token_indptr_view_;
+  NDArray seg_page_indptr_view_;
+  NDArray page_ids_view_;
+  NDArray seg_scaling_view_;
+  /*! \brief The number of tokens of the current forward. */
+  int64_t cur_num_tokens_ = 0;
+  /*! \brief The number of segments of the current forward. */
+  int64_t cur_num_segs_ = 0;
+
+ public:
+  explicit LoRAAdapterPoolObj(int64_t num_pages, int64_t max_rank, int64_t max_num_tokens,
+                              int64_t reserved_num_seqs, Array<String> target_names,
+                              ShapeTuple in_features, ShapeTuple out_features, DLDataType dtype,
+                              Device device, PackedFunc f_shrink, PackedFunc f_expand)
+      : num_pages_(num_pages),
+        max_rank_(max_rank),
+        max_num_tokens_(max_num_tokens),
+        reserved_num_seqs_(reserved_num_seqs),
+        dtype_(dtype),
+        device_(device),
+        f_shrink_(std::move(f_shrink)),
+        f_expand_(std::move(f_expand)) {
+    for (int i = 0; i < static_cast<int>(target_names.size()); ++i) {
+      LoRATarget target;
+      target.name = target_names[i];
+      target.in_features = in_features[i];
+      target.out_features = out_features[i];
+      target.a_pages = NDArray::Empty({num_pages, in_features[i]}, dtype, device);
+      target.b_pages = NDArray::Empty({num_pages, out_features[i]}, dtype, device);
+      targets_.push_back(std::move(target));
+    }
+    free_page_ids_.reserve(num_pages);
+    for (int32_t page = num_pages - 1; page >= 0; --page) {
+      free_page_ids_.push_back(page);
+    }
+    DLDataType dtype_aux = DLDataType(DataType::Int(32));
+    tmp_device_ = NDArray::Empty({max_num_tokens * max_rank}, dtype, device);
+    seg_token_indptr_device_ = NDArray::Empty({reserved_num_seqs + 1}, dtype_aux, device);
+    seg_page_indptr_device_ = NDArray::Empty({reserved_num_seqs + 1}, dtype_aux, device);
+    page_ids_device_ = NDArray::Empty({reserved_num_seqs * max_rank}, dtype_aux, device);
+    seg_scaling_device_ =
+        NDArray::Empty({reserved_num_seqs}, DLDataType(DataType::Float(32)), device);
+  }
+
+  /*!
+   * \brief Load an adapter into the pool, replacing the adapter of the same id if any.
+   * The least recently used adapters are evicted when the pool runs out of pages.
+   * \param adapter_id The id of the adapter.
+   * \param lora_a A of each LoRA target, in shape (rank, in_features).
+   * \param lora_b B of each LoRA target, in shape (out_features, rank).
+   * \param scaling The scaling of the adapter output.
+   */
+  void Load(int64_t adapter_id, const Array<NDArray>& lora_a, const Array<NDArray>& lora_b,
+            double scaling) {
+    CHECK_GE(adapter_id, 0) << "ValueError: The adapter id must be non-negative, but got "
+                            << adapter_id;
+    CHECK_EQ(lora_a.size(), targets_.size())
+        << "ValueError: The pool has " << targets_.size() << " LoRA targets, but got "
+        << lora_a.size() << " A weights";
+    CHECK_EQ(lora_b.size(), targets_.size())
+        << "ValueError: The pool has " << targets_.size() << " LoRA targets, but got "
+        << lora_b.size() << " B weights";
+    int64_t rank = lora_a.empty() ? 0 : lora_a[0]->shape[0];
+    CHECK(rank > 0 && rank <= max_rank_)
+        << "ValueError: The rank of adapter " << adapter_id << " is " << rank
+        << ", which is not in range [1, " << max_rank_ << "]";
+    for (int i = 0; i < static_cast<int>(targets_.size()); ++i) {
+      const LoRATarget& target = targets_[i];
+      const NDArray& a = lora_a[i];
+      const NDArray& b = lora_b[i];
+      CHECK(a->ndim == 2 && a->shape[0] == rank && a->shape[1] == target.in_features &&
+            b->ndim == 2 && b->shape[0] == target.out_features && b->shape[1] == rank)
+          << "ValueError: The adapter weights of \"" << target.name << "\" are expected in shape ("
+          << rank << ", " << target.in_features << ") and (" << target.out_features << ", "
+          << rank << "), but got " << a.Shape() << " and " << b.Shape();
+      CHECK(a.DataType() == DataType(dtype_) && b.DataType() == DataType(dtype_))
+          << "ValueError: The adapter weights of \"" << target.name << "\" are expected in "
+          << DataType(dtype_) << ", but got " << a.DataType() << " and " << b.DataType();
+    }
+
+    Unload(adapter_id);
+    while (static_cast<int64_t>(free_page_ids_.size()) < rank) {
+      auto it_lru = adapters_.end();
+      for (auto it = adapters_.begin(); it != adapters_.end(); ++it) {
+        if (it_lru == adapters_.end() || it->second.last_use < it_lru->second.last_use) {
+          it_lru = it;
+        }
+      }
+      CHECK(it_lru != adapters_.end())
+          << "ValueError: The pool of " << num_pages_ << " pages cannot hold adapter "
+          << adapter_id << " of rank " << rank;
+      Unload(it_lru->first);
+    }
+    Adapter adapter;
+    adapter.pages.assign(free_page_ids_.end() - rank, free_page_ids_.end());
+    free_page_ids_.resize(free_page_ids_.size() - rank);
+    adapter.scaling = static_cast<float>(scaling);
+    adapter.last_use = num_forwards_;
+
+    // Copy the rows of A and of the transpose of B to the pages, through the host.
+    int elem_bytes = (dtype_.bits * dtype_.lanes + 7) / 8;
+    for (int i = 0; i < static_cast<int>(targets_.size()); ++i) {
+      LoRATarget& target = targets_[i];
+      NDArray a_host = lora_a[i].CopyTo(Device{kDLCPU, 0});
+      NDArray b_host = lora_b[i].CopyTo(Device{kDLCPU, 0});
+      std::vector<char> b_transposed(rank * target.out_features * elem_bytes);
+      const char* b_data = static_cast<const char*>(b_host->data);
+      for (int64_t n = 0; n < target.out_features; ++n) {
+        for (int64_t j = 0; j < rank; ++j) {
+          std::memcpy(b_transposed.data() + (j * target.out_features + n) * elem_bytes,
+                      b_data + (n * rank + j) * elem_bytes, elem_bytes);
+        }
+      }
+      for (int64_t j = 0; j < rank; ++j) {
+        CopyRowToPage(static_cast<const char*>(a_host->data) + j * target.in_features * elem_bytes,
+                      target.a_pages, adapter.pages[j]);
+        CopyRowToPage(b_transposed.data() + j * target.out_features * elem_bytes, target.b_pages,
+                      adapter.pages[j]);
+      }
+    }
+    adapters_[adapter_id] = std::move(adapter);
+  }
+
+  /*!
+   * \brief Load an adapter from the parameters in NDArrayCache, where the weights of LoRA target
+   * "t" are named "{prefix}t.lora_A.weight" and "{prefix}t.lora_B.weight".
+   */
+  void LoadFromCache(int64_t adapter_id, const String& prefix, double scaling) {
+    static const PackedFunc* f_cache_get = Registry::Get("vm.builtin.ndarray_cache.get");
+    ICHECK_NOTNULL(f_cache_get);
+    Array<NDArray> lora_a;
+    Array<NDArray> lora_b;
+    auto f_get = [&](const std::string& name) -> NDArray {
+      Optional<NDArray> weight = (*f_cache_get)(name);
+      CHECK(weight.defined()) << "ValueError: Cannot find parameter in cache: " << name;
+      return weight.value();
+    };
+    for (const LoRATarget& target : targets_) {
+      std::string name = std::string(prefix) + std::string(target.name);
+      lora_a.push_back(f_get(name + ".lora_A.weight"));
+      lora_b.push_back(f_get(name + ".lora_B.weight"));
+    }
+    Load(adapter_id, lora_a, lora_b, scaling);
+  }
+
+  /*! \brief Unload an adapter from the pool, if loaded. */
+  void Unload(int64_t adapter_id) {
+    auto it = adapters_.find(adapter_id);
+    if (it == adapters_.end()) {
+      return;
+    }
+    free_page_ids_.insert(free_page_ids_.end(), it->second.pages.begin(), it->second.pages.end());
+    adapters_.erase(it);
+  }
+
+  /*! \brief Whether an adapter is loaded in the pool. */
+  bool IsLoaded(int64_t adapter_id) const { return adapters_.count(adapter_id); }
+
+  /*! \brief The number of pages no adapter holds. */
+  int64_t GetNumAvailablePages() const { return free_page_ids_.size(); }
+
+  /*!
+   * \brief Mark the start of a forward with the adapter of each sequence in the batch.
+   * \param adapter_ids The adapter of each sequence, or -1 for the base model only.
+   * \param append_lengths The number of tokens of each sequence in the batch.
+   */
+  void BeginForward(const IntTuple& adapter_ids, const IntTuple& append_lengths) {
+    CHECK_EQ(adapter_ids.size(), append_lengths.size())
+        << "ValueError: The adapter ids and the append lengths have different sizes";
+    CHECK_LE(adapter_ids.size(), reserved_num_seqs_)
+        << "ValueError: The batch has " << adapter_ids.size()
+        << " sequences, more than the reserved " << reserved_num_seqs_;
+    ++num_forwards_;
+    std::vector<int32_t> seg_token_indptr{0};
+    std::vector<int32_t> seg_page_indptr{0};
+    std::vector<int32_t> page_ids;
+    std::vector<float> seg_scaling;
+    // The adapter of the last segment and the end of its tokens.
+    int64_t last_adapter_id = -1;
+    int64_t last_seg_end = -1;
+    int64_t num_tokens = 0;
+    for (int i = 0; i < static_cast<int>(adapter_ids.size()); ++i) {
+      int64_t begin = num_tokens;
+      num_tokens += append_lengths[i];
+      if (adapter_ids[i] == -1 || append_lengths[i] == 0) {
+        continue;
+      }
+      auto it = adapters_.find(adapter_ids[i]);
+      CHECK(it != adapters_.end()) << "ValueError: The adapter " << adapter_ids[i]
+                                   << " of sequence " << i << " in the batch is not loaded";
+      it->second.last_use = num_forwards_;
+      if (adapter_ids[i] == last_adapter_id && begin == last_seg_end) {
+        seg_token_indptr.back() = num_tokens;
+      } else {
+        seg_token_indptr.push_back(num_tokens);
+        page_ids.insert(page_ids.end(), it->second.pages.begin(), it->second.pages.end());
+        seg_page_indptr.push_back(page_ids.size());
+        seg_scaling.push_back(it->second.scaling);
+      }
+      last_adapter_id = adapter_ids[i];
+      last_seg_end = num_tokens;
+    }
+    CHECK_LE(num_tokens, max_num_tokens_)
+        << "ValueError: The batch has " << num_tokens << " tokens, more than the maximum "
+        << max_num_tokens_;
+    cur_num_tokens_ = num_tokens;
+    cur_num_segs_ = seg_scaling.size();
+    if (cur_num_segs_ == 0) {
+      return;
+    }
+    seg_token_indptr_view_ = CopyVecToDevice(seg_token_indptr_device_, seg_token_indptr);
+    seg_page_indptr_view_ = CopyVecToDevice(seg_page_indptr_device_, seg_page_indptr);
+    page_ids_view_ = CopyVecToDevice(page_ids_device_, page_ids);
+    seg_scaling_view_ = CopyVecToDevice(seg_scaling_device_, seg_scaling);
+  }
+
+  /*!
+   * \brief Accumulate the adapter outputs of a LoRA target of the current batch in place.
+   * \param target_id The LoRA target.
+   * \param x The input of the target weight, in shape (num_tokens, in_features).
+   * \param y The output of the target weight, in shape (num_tokens, out_features).
+   * \return The updated output.
+   */
+  NDArray Apply(int64_t target_id, NDArray x, NDArray y) {
+    CHECK(target_id >= 0 && target_id < static_cast<int64_t>(targets_.size()))
+        << "ValueError: The LoRA target " << target_id << " is out of range [0, "
+        << targets_.size() << ")";
+    const LoRATarget& target = targets_[target_id];
+    CHECK(x->ndim == 2 && x->shape[0] == cur_num_tokens_ && x->shape[1] == target.in_features)
+        << "ValueError: The input of \"" << target.name << "\" is expected in shape ("
+        << cur_num_tokens_ << ", " << target.in_features << "), but got " << x.Shape();
+    CHECK(y->ndim == 2 && y->shape[0] == cur_num_tokens_ && y->shape[1] == target.out_features)
+        << "ValueError: The output of \"" << target.name << "\" is expected in shape ("
+        << cur_num_tokens_ << ", " << target.out_features << "), but got " << y.Shape();
+    if (cur_num_segs_ == 0) {
+      return y;
+    }
+    NDArray tmp = tmp_device_.CreateView({cur_num_tokens_, max_rank_}, dtype_);
+    f_shrink_(x, target.a_pages, seg_token_indptr_view_, seg_page_indptr_view_, page_ids_view_,
+              tmp);
+    f_expand_(tmp, target.b_pages, seg_token_indptr_view_, seg_page_indptr_view_, page_ids_view_,
+              seg_scaling_view_, y);
+    return y;
+  }
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.LoRAAdapterPool";
+  TVM_DECLARE_FINAL_OBJECT_INFO(LoRAAdapterPoolObj, Object);
+
+ private:
+  /*! \brief Copy a row on host to a page of a weight storage. */
+  void CopyRowToPage(const char* row, const NDArray& pages, int32_t page) {
+    int64_t row_length = pages->shape[1];
+    DLTensor copy_src;
+    copy_src.data = const_cast<char*>(row);
+    copy_src.device = Device{kDLCPU, 0};
+    copy_src.ndim = 1;
+    copy_src.dtype = dtype_;
+    copy_src.shape = &row_length;
+    copy_src.strides = nullptr;
+    copy_src.byte_offset = 0;
+    DLTensor copy_dst = copy_src;
+    copy_dst.data = pages->data;
+    copy_dst.device = pages->device;
+    int64_t row_bytes = row_length * ((dtype_.bits * dtype_.lanes + 7) / 8);
+    copy_dst.byte_offset = pages->byte_offset + page * row_bytes;
+    NDArray::CopyFromTo(&copy_src, &copy_dst);
+  }
+
+  /*! \brief Copy a vector on host to the front of an auxiliary array on device. */
+  template <typename T>
+  NDArray CopyVecToDevice(NDArray array, const std::vector<T>& vec_data) {
+    NDArray view = array.CreateView({static_cast<int64_t>(vec_data.size())}, array->dtype);
+    DLTensor copy_dst = *view.operator->();
+    DLTensor copy_src;
+    copy_src.data = const_cast<T*>(vec_data.data());
+    copy_src.device = Device{kDLCPU, 0};
+    copy_src.ndim = 1;
+    copy_src.dtype = view->dtype;
+    copy_src.shape = view->shape;
+    copy_src.strides = nullptr;
+    copy_src.byte_offset = 0;
+    NDArray::CopyFromTo(&copy_src, &copy_dst);
+    return view;
+  }
+};
+
+/*! \brief Managed reference to LoRAAdapterPoolObj. */
+class LoRAAdapterPool : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(LoRAAdapterPool, ObjectRef, LoRAAdapterPoolObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(LoRAAdapterPoolObj);
+
+//-------------------------------------------------
+//  Register runtime functions
+//-------------------------------------------------
+
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_create")
+    .set_body_typed([](ShapeTuple pool_config, Array<String> target_names, ShapeTuple in_features,
+                       ShapeTuple out_features, NDArray init, PackedFunc f_shrink,
+                       PackedFunc f_expand) {
+      CHECK_EQ(pool_config.size(), 4)
+          << "ValueError: The pool config is expected to be (num_pages, max_rank, "
+             "max_num_tokens, reserved_num_seqs), but got "
+          << pool_config;
+      int64_t num_pages = pool_config[0];
+      int64_t max_rank = pool_config[1];
+      int64_t max_num_tokens = pool_config[2];
+      int64_t reserved_num_seqs = pool_config[3];
+      CHECK(num_pages > 0 && max_rank > 0 && max_num_tokens > 0 && reserved_num_seqs > 0)
+          << "ValueError: The pool config must be positive, but got " << pool_config;
+      CHECK(!target_names.empty()) << "ValueError: The pool has no LoRA target";
+      CHECK(in_features.size() == target_names.size() &&
+            out_features.size() == target_names.size())
+          << "ValueError: The pool has " << target_names.size() << " LoRA targets, but got "
+          << in_features.size() << " input features and " << out_features.size()
+          << " output features";
+      ObjectPtr<LoRAAdapterPoolObj> n = make_object<LoRAAdapterPoolObj>(
+          num_pages, max_rank, max_num_tokens, reserved_num_seqs, std::move(target_names),
+          std::move(in_features), std::move(out_features), init->dtype, init->device,
+          std::move(f_shrink), std::move(f_expand));
+      return LoRAAdapterPool(std::move(n));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_load")
+    .set_body_method<LoRAAdapterPool>(&LoRAAdapterPoolObj::Load);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_load_from_cache")
+    .set_body_method<LoRAAdapterPool>(&LoRAAdapterPoolObj::LoadFromCache);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_unload")
+    .set_body_method<LoRAAdapterPool>(&LoRAAdapterPoolObj::Unload);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_is_loaded")
+    .set_body_method<LoRAAdapterPool>(&LoRAAdapterPoolObj::IsLoaded);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_get_num_available_pages")
+    .set_body_method<LoRAAdapterPool>(&LoRAAdapterPoolObj::GetNumAvailablePages);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_begin_forward")
+    .set_body_method<LoRAAdapterPool>(&LoRAAdapterPoolObj::BeginForward);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_adapter_pool_apply")
+    .set_body_method<LoRAAdapterPool>(&LoRAAdapterPoolObj::Apply);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -39,15 +39,25 @@
 #define __STDC_FORMAT_MACROS
 #endif
 #include <picojson.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/ndarray_cache_support.h>
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "../../support/utils.h"
 #include "../file_utils.h"
+#include "./param_decode.h"
 
 namespace tvm {
 namespace runtime {
@@ -167,22 +177,100 @@ void CopyNDArrayFromBytes(NDArray param, const void* data, size_t nbytes,
 
 NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(
     Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
-  NDArray arr = NDArray::Empty(shape, dtype, device);
-  if (dtype == DataType::Float(32) && format == "f32-to-bf16") {
-    // decode bf16 to f32
-    std::vector<uint16_t> buffer(nbytes / 2);
-    std::vector<uint32_t> decoded(nbytes / 2);
-    std::memcpy(buffer.data(), raw_data->data() + byte_offset, nbytes);
-    for (size_t i = 0; i < buffer.size(); ++i) {
-      decoded[i] = static_cast<uint32_t>(buffer[i]) << 16;
+  return Load(device, raw_data->data(), staging_buffer);
+}
+
+/*! \brief Deleter of the NDArrays that alias a shard in host memory. */
+static void ShardAliasDeleter(Object* obj) {
+  auto* ptr = static_cast<NDArray::Container*>(obj);
+  delete static_cast<ObjectRef*>(ptr->manager_ctx);
+  delete ptr;
+}
+
+/*!
+ * \brief Issue a copy from host bytes to an NDArray on the given stream without synchronizing.
+ * The caller is responsible for keeping `data` alive until the stream is synchronized.
+ */
+void CopyNDArrayFromBytesAsync(NDArray param, const void* data, size_t nbytes,
+                               TVMStreamHandle stream) {
+  ICHECK_EQ(GetDataSize(*param.operator->()), nbytes) << "ValueError: Size mismatch";
+  DLTensor from = *param.operator->();
+  from.data = const_cast<void*>(data);
+  from.device = Device{kDLCPU, 0};
+  from.strides = nullptr;
+  from.byte_offset = 0;
+  NDArray::CopyFromTo(&from, const_cast<DLTensor*>(param.operator->()), stream);
+}
+
+/*!
+ * \brief Load a parameter from a shard in host memory.
+ * \param rec The parameter record.
+ * \param device The device to load the parameter onto.
+ * \param shard_data The pointer to the beginning of the shard.
+ * \param staging_buffer The OpenCL staging buffer, or nullptr.
+ * \param shard_owner The object owning the shard memory, used for zero-copy aliasing on CPU.
+ * \param stream The stream to issue the host-to-device copies on. The copies are
+ *  not synchronized, except for the OpenCL staging path.
+ * \param host_buffers The host temporaries that must outlive the copies are appended here.
+ */
+NDArray LoadParamFromHost(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec, Device device,
+                          const char* shard_data, Optional<NDArray>* staging_buffer,
+                          const ObjectRef& shard_owner, TVMStreamHandle stream,
+                          std::vector<std::vector<uint32_t>>* host_buffers) {
+  const char* data = shard_data + rec.byte_offset;
+  bool use_staging = device.device_type == kDLOpenCL && staging_buffer != nullptr;
+  if (rec.dtype == DataType::Float(32) && IsF32EncodedFormat(rec.format)) {
+    NDArray arr = NDArray::Empty(rec.shape, rec.dtype, device);
+    int64_t num_elems = rec.nbytes / 2;
+    ICHECK_EQ(GetDataSize(*arr.operator->()), num_elems * sizeof(float))
+        << "ValueError: Size mismatch of parameter " << rec.name;
+    if (device.device_type == kDLCPU) {
+      // Decode straight into the parameter, no host temporary needed.
+      DecodeF32Param(rec.format, data, arr->data, num_elems);
+      return arr;
+    }
+    std::vector<uint32_t> decoded(num_elems);
+    DecodeF32Param(rec.format, data, decoded.data(), num_elems);
+    if (use_staging) {
+      CopyNDArrayFromBytes(arr, decoded.data(), decoded.size() * sizeof(uint32_t), staging_buffer);
+    } else {
+      CopyNDArrayFromBytesAsync(arr, decoded.data(), decoded.size() * sizeof(uint32_t), stream);
+      host_buffers->push_back(std::move(decoded));
     }
-    CopyNDArrayFromBytes(arr, decoded.data(), decoded.size() * sizeof(uint32_t), staging_buffer);
+    return arr;
+  }
+  if (shard_owner.defined() && device.device_type == kDLCPU &&
+      reinterpret_cast<uintptr_t>(data) % kAllocAlignment == 0) {
+    // Zero-copy: the parameter aliases the shard, which is kept alive by the NDArray.
+    NDArray::Container* container =
+        new NDArray::Container(const_cast<char*>(data), rec.shape, rec.dtype, device);
+    container->SetDeleter(ShardAliasDeleter);
+    container->manager_ctx = new ObjectRef(shard_owner);
+    NDArray arr(GetObjectPtr<Object>(container));
+    ICHECK_EQ(GetDataSize(*arr.operator->()), rec.nbytes)
+        << "ValueError: Size mismatch of parameter " << rec.name;
+    return arr;
+  }
+  NDArray arr = NDArray::Empty(rec.shape, rec.dtype, device);
+  if (use_staging) {
+    CopyNDArrayFromBytes(arr, data, rec.nbytes, staging_buffer);
   } else {
-    CopyNDArrayFromBytes(arr, raw_data->data() + byte_offset, nbytes, staging_buffer);
+    CopyNDArrayFromBytesAsync(arr, data, rec.nbytes, stream);
   }
   return arr;
 }
 
+NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(Device device, const char* shard_data,
+                                                            Optional<NDArray>* staging_buffer,
+                                                            ObjectRef shard_owner) const {
+  std::vector<std::vector<uint32_t>> host_buffers;
+  NDArray arr = LoadParamFromHost(*this, device, shard_data, staging_buffer, shard_owner,
+                                  /*stream=*/nullptr, &host_buffers);
+  // Synchronize in case data become unavailable later.
+  DeviceAPI::Get(device)->StreamSync(device, nullptr);
+  return arr;
+}
+
 TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::Load(
     Device device,
     const std::string& path_prefix,  //
@@ -201,8 +289,64 @@ TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::Load(
   return result;
 }
 
+/*!
+ * \brief Load all parameters of a mapped shard, issuing the host-to-device copies on
+ *  `stream` and synchronizing it once at the end of the shard.
+ * \param reused When given, the defined entries are returned as is instead of being loaded.
+ */
+Array<NDArray> LoadMappedShard(const NDArrayCacheMetadata::FileRecord& file_rec, Device device,
+                               const MappedFile& shard, Optional<NDArray>* staging_buffer,
+                               TVMStreamHandle stream,
+                               const std::vector<Optional<NDArray>>* reused = nullptr) {
+  CHECK_EQ(file_rec.format, "raw-shard") << "ValueError: Only `raw-shard` format is supported";
+  CHECK_EQ(file_rec.nbytes, shard->size())
+      << "ValueError: Encountered an corrupted parameter shard. It means it is not downloaded "
+         "completely or downloading is interrupted. Please try to download again.";
+  std::vector<std::vector<uint32_t>> host_buffers;
+  Array<NDArray> result;
+  result.reserve(file_rec.records.size());
+  for (size_t i = 0; i < file_rec.records.size(); ++i) {
+    if (reused != nullptr && (*reused)[i].defined()) {
+      result.push_back((*reused)[i].value());
+      continue;
+    }
+    result.push_back(LoadParamFromHost(file_rec.records[i], device, shard->data(), staging_buffer,
+                                       shard, stream, &host_buffers));
+  }
+  DeviceAPI::Get(device)->StreamSync(device, stream);
+  return result;
+}
+
+TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::LoadMapped(
+    Device device, const std::string& path_prefix, Optional<NDArray>* staging_buffer) const {
+  MappedFile shard = MappedFile::Open(path_prefix + "/" + this->data_path);
+  return LoadMappedShard(*this, device, shard, staging_buffer, /*stream=*/nullptr);
+}
+
+/*!
+ * \brief The fingerprint of a parameter in a mapped shard, covering its encoded content,
+ *  its metadata and the device it is loaded onto.
+ */
+uint64_t ParamFingerprint(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec,
+                          const char* shard_data, Device device) {
+  uint64_t hash = std::hash<std::string_view>()(
+      std::string_view(shard_data + rec.byte_offset, static_cast<size_t>(rec.nbytes)));
+  hash = support::HashCombine(hash, std::hash<std::string>()(rec.format));
+  hash = support::HashCombine(hash, rec.dtype.code());
+  hash = support::HashCombine(hash, rec.dtype.bits());
+  hash = support::HashCombine(hash, rec.dtype.lanes());
+  for (ShapeTuple::index_type dim : rec.shape) {
+    hash = support::HashCombine(hash, dim);
+  }
+  hash = support::HashCombine(hash, static_cast<int>(device.device_type));
+  return support::HashCombine(hash, device.device_id);
+}
+
 /*!
  * A NDArray cache to store pre-loaded arrays in the system.
+ *
+ * The cache is shared by all VMs of the process and may be read while it is
+ * reloaded, so every access goes through a lock.
  */
 class NDArrayCache {
  public:
@@ -213,14 +357,17 @@ class NDArrayCache {
 
   static void Update(String name, NDArray arr, bool override) {
     NDArrayCache* pool = Global();
+    std::lock_guard<std::mutex> lock(pool->mutex_);
     if (!override) {
       ICHECK_EQ(pool->pool_.count(name), 0) << "Name " << name << " already exists in the cache";
     }
     pool->pool_.Set(name, arr);
+    pool->fingerprints_.erase(name);
   }
 
   static Optional<NDArray> Get(String name) {
     NDArrayCache* pool = Global();
+    std::lock_guard<std::mutex> lock(pool->mutex_);
     auto it = pool->pool_.find(name);
     if (it != pool->pool_.end()) {
       return (*it).second;
@@ -231,10 +378,17 @@ class NDArrayCache {
 
   static void Remove(String name) {
     NDArrayCache* pool = Global();
+    std::lock_guard<std::mutex> lock(pool->mutex_);
     pool->pool_.erase(name);
+    pool->fingerprints_.erase(name);
   }
 
-  static void Clear() { Global()->pool_.clear(); }
+  static void Clear() {
+    NDArrayCache* pool = Global();
+    std::lock_guard<std::mutex> lock(pool->mutex_);
+    pool->pool_.clear();
+    pool->fingerprints_.clear();
+  }
 
   /*!
    * \brief Load parameters from path and append them.
@@ -243,27 +397,298 @@ class NDArrayCache {
    * \param device_id The device id.
    */
   static void Load(const std::string& cache_path, int device_type, int device_id) {
+    LoadImpl(cache_path, device_type, device_id, /*reuse=*/false);
+  }
+
+  /*!
+   * \brief Load parameters from path, keeping the resident arrays whose content is unchanged.
+   *
+   * A parameter is reused when the cache holds an array of the same name that was loaded
+   * from identical bytes and metadata onto the same device. The new set of parameters is
+   * published at once when all of them are loaded, so a concurrent reader sees either the
+   * old or the new parameters, and VMs created from the old ones keep working.
+   *
+   * \param cache_path The cache to path.
+   * \param device_type The type of device to be loaded.
+   * \param device_id The device id.
+   * \return The number of parameters that were reused.
+   */
+  static int64_t Reload(const std::string& cache_path, int device_type, int device_id) {
+    return LoadImpl(cache_path, device_type, device_id, /*reuse=*/true);
+  }
+
+  /*!
+   * \brief Publish arrays of the cache to the other processes of the host through a segment file.
+   *
+   * The segment is meant to be placed on a shared-memory file system such as /dev/shm, so that
+   * every importer maps the same physical pages. Host arrays are copied into the segment. CUDA
+   * arrays stay where they are and only their IPC handles are written, the exporting process has
+   * to keep them alive as long as they are used by the importers.
+   *
+   * \param path The path of the segment, which is replaced atomically.
+   * \param names The names of the arrays to export, or empty to export the whole cache.
+   */
+  static void ExportShared(const std::string& path, const Array<String>& names) {
+    std::vector<std::pair<String, NDArray>> arrays;
+    {
+      NDArrayCache* pool = Global();
+      std::lock_guard<std::mutex> lock(pool->mutex_);
+      if (names.empty()) {
+        for (const auto& [name, arr] : pool->pool_) {
+          arrays.emplace_back(name, arr);
+        }
+      } else {
+        for (const String& name : names) {
+          auto it = pool->pool_.find(name);
+          CHECK(it != pool->pool_.end()) << "ValueError: Cannot find parameter in cache: " << name;
+          arrays.emplace_back(name, (*it).second);
+        }
+      }
+    }
+    // Step 1. Collect the bytes of each array and index them
+    std::vector<std::string> ipc_handles(arrays.size());
+    picojson::array records;
+    int64_t data_size = 0;
+    for (size_t i = 0; i < arrays.size(); ++i) {
+      const auto& [name, arr] = arrays[i];
+      CHECK(arr.IsContiguous()) << "ValueError: Cannot share the non-contiguous array " << name;
+      picojson::object rec;
+      picojson::array shape;
+      for (ShapeTuple::index_type dim : arr.Shape()) {
+        shape.push_back(picojson::value(static_cast<int64_t>(dim)));
+      }
+      int64_t nbytes;
+      if (arr->device.device_type == kDLCPU) {
+        rec["format"] = picojson::value("raw");
+        nbytes = GetDataSize(*arr.operator->());
+      } else if (arr->device.device_type == kDLCUDA) {
+        static const PackedFunc* f_ipc_handle = Registry::Get("runtime.cuda.GetIPCMemHandle");
+        CHECK(f_ipc_handle != nullptr) << "ValueError: CUDA IPC is not enabled in this runtime";
+        std::string handle = (*f_ipc_handle)(arr);
+        ipc_handles[i] = std::move(handle);
+        rec["format"] = picojson::value("cuda-ipc");
+        rec["deviceId"] = picojson::value(static_cast<int64_t>(arr->device.device_id));
+        nbytes = ipc_handles[i].size();
+      } else {
+        LOG(FATAL) << "ValueError: Cannot share the array " << name << " on " << arr->device
+                   << " across processes";
+      }
+      rec["name"] = picojson::value(std::string(name));
+      rec["shape"] = picojson::value(shape);
+      rec["dtype"] = picojson::value(DLDataType2String(arr->dtype));
+      rec["nbytes"] = picojson::value(nbytes);
+      rec["byteOffset"] = picojson::value(data_size);
+      records.push_back(picojson::value(rec));
+      data_size += RoundUpToAlignment(nbytes);
+    }
+    // Step 2. Write the segment aside and move it in place, so that importers never see a
+    // partially written one and the arrays they have mapped from an older one stay valid.
+    std::string index = picojson::value(records).serialize();
+    uint64_t index_size = index.size();
+    std::string tmp_path = path + ".tmp";
+    {
+      std::ofstream fs(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+      CHECK(!fs.fail()) << "ValueError: Cannot open " << tmp_path;
+      fs.write(kSharedSegmentMagic, sizeof(kSharedSegmentMagic));
+      fs.write(reinterpret_cast<const char*>(&index_size), sizeof(index_size));
+      fs.write(index.data(), index.size());
+      std::string padding(SharedDataBegin(index_size) - static_cast<size_t>(fs.tellp()), '\0');
+      fs.write(padding.data(), padding.size());
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        const NDArray& arr = arrays[i].second;
+        int64_t nbytes;
+        if (arr->device.device_type == kDLCPU) {
+          nbytes = GetDataSize(*arr.operator->());
+          fs.write(static_cast<const char*>(arr->data) + arr->byte_offset, nbytes);
+        } else {
+          nbytes = ipc_handles[i].size();
+          fs.write(ipc_handles[i].data(), nbytes);
+        }
+        padding.assign(RoundUpToAlignment(nbytes) - nbytes, '\0');
+        fs.write(padding.data(), padding.size());
+      }
+      CHECK(!fs.fail()) << "ValueError: Failed to write " << tmp_path;
+    }
+    CHECK_EQ(std::rename(tmp_path.c_str(), path.c_str()), 0)
+        << "ValueError: Cannot move " << tmp_path << " to " << path;
+  }
+
+  /*!
+   * \brief Map the arrays published by ExportShared into the cache, overriding those of the same
+   *  names.
+   *
+   * Host arrays alias the mapped segment, so they must be treated as read-only: the pages are
+   * mapped copy-on-write, and a write would no longer share them with the other processes.
+   *
+   * \param path The path of the segment.
+   * \return The number of arrays imported.
+   */
+  static int64_t ImportShared(const std::string& path) {
+    MappedFile segment = MappedFile::Open(path, /*sequential=*/false);
+    const char* data = segment->data();
+    size_t size = segment->size();
+    uint64_t index_size = 0;
+    CHECK(size >= kSharedHeaderSize &&
+          std::memcmp(data, kSharedSegmentMagic, sizeof(kSharedSegmentMagic)) == 0)
+        << "ValueError: " << path << " is not a segment of shared arrays";
+    std::memcpy(&index_size, data + sizeof(kSharedSegmentMagic), sizeof(index_size));
+    size_t data_begin = SharedDataBegin(index_size);
+    CHECK_LE(data_begin, size) << "ValueError: The segment " << path << " is truncated";
+    picojson::value index;
+    {
+      const char* index_begin = data + kSharedHeaderSize;
+      std::string err = picojson::parse(index, index_begin, index_begin + index_size);
+      CHECK(err.empty() && index.is<picojson::array>())
+          << "ValueError: The segment " << path << " has a malformed index: " << err;
+    }
+    std::vector<std::pair<String, NDArray>> arrays;
+    for (const picojson::value& item : AsType<picojson::array>(index)) {
+      const picojson::object& json = AsType<picojson::object>(item);
+      NDArrayCacheMetadata::FileRecord::ParamRecord rec = JSONAsParamRecord(json);
+      CHECK(rec.byte_offset >= 0 && rec.nbytes >= 0 &&
+            data_begin + rec.byte_offset + rec.nbytes <= size)
+          << "ValueError: The segment " << path << " is truncated";
+      const char* rec_data = data + data_begin + rec.byte_offset;
+      NDArray arr;
+      if (rec.format == "raw") {
+        NDArray::Container* container = new NDArray::Container(
+            const_cast<char*>(rec_data), rec.shape, rec.dtype, Device{kDLCPU, 0});
+        container->SetDeleter(ShardAliasDeleter);
+        container->manager_ctx = new ObjectRef(segment);
+        arr = NDArray(GetObjectPtr<Object>(container));
+        CHECK_EQ(GetDataSize(*arr.operator->()), rec.nbytes)
+            << "ValueError: Size mismatch of parameter " << rec.name;
+      } else if (rec.format == "cuda-ipc") {
+        static const PackedFunc* f_ipc_open = Registry::Get("runtime.cuda.OpenIPCNDArray");
+        CHECK(f_ipc_open != nullptr) << "ValueError: CUDA IPC is not enabled in this runtime";
+        int device_id = GetValue<int64_t>(json, "deviceId");
+        arr = (*f_ipc_open)(TVMByteArray{rec_data, static_cast<size_t>(rec.nbytes)}, rec.shape,
+                            rec.dtype, device_id);
+      } else {
+        LOG(FATAL) << "ValueError: Unknown format of shared parameter " << rec.name << ": "
+                   << rec.format;
+      }
+      arrays.emplace_back(rec.name, arr);
+    }
+    NDArrayCache* pool = Global();
+    std::lock_guard<std::mutex> lock(pool->mutex_);
+    for (const auto& [name, arr] : arrays) {
+      pool->pool_.Set(name, arr);
+      pool->fingerprints_.erase(name);
+    }
+    return arrays.size();
+  }
+
+ private:
+  /*! \brief The magic number at the beginning of the segments of ExportShared. */
+  static constexpr const char kSharedSegmentMagic[8] = {'T', 'V', 'M', 'S', 'H', 'A', 'R', 'E'};
+  /*! \brief The size of the magic number and the index size preceding the index. */
+  static constexpr size_t kSharedHeaderSize = sizeof(kSharedSegmentMagic) + sizeof(uint64_t);
+
+  static int64_t RoundUpToAlignment(int64_t nbytes) {
+    return (nbytes + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+  }
+
+  /*! \brief The offset of the array data in a segment, which begins at a page boundary. */
+  static size_t SharedDataBegin(uint64_t index_size) {
+    constexpr size_t kPageSize = 4096;
+    return (kSharedHeaderSize + index_size + kPageSize - 1) / kPageSize * kPageSize;
+  }
+
+  /*! \brief A mapped shard with the fingerprints of its parameters. */
+  struct PrefetchedShard {
+    MappedFile shard;
+    std::vector<uint64_t> fingerprints;
+  };
+
+  static int64_t LoadImpl(const std::string& cache_path, int device_type, int device_id,
+                          bool reuse) {
     DLDevice device{static_cast<DLDeviceType>(device_type), device_id};
     NDArrayCacheMetadata metadata = NDArrayCacheMetadata::Load(cache_path);
+    const std::vector<NDArrayCacheMetadata::FileRecord>& shards = metadata.records;
+    // While a shard is decoded and copied to the device, the next one is mapped,
+    // faulted in from disk and fingerprinted on a background thread.
+    auto fprefetch = [&cache_path, &shards, device](size_t i) {
+      return std::async(std::launch::async, [path = cache_path + "/" + shards[i].data_path,
+                                             &shard_rec = shards[i], device]() {
+        PrefetchedShard result;
+        result.shard = MappedFile::Open(path);
+        result.shard->Prefault();
+        if (shard_rec.nbytes == static_cast<int64_t>(result.shard->size())) {
+          for (const auto& rec : shard_rec.records) {
+            result.fingerprints.push_back(ParamFingerprint(rec, result.shard->data(), device));
+          }
+        }
+        return result;
+      });
+    };
+    NDArrayCache* pool = Global();
+    DeviceAPI* device_api = DeviceAPI::Get(device);
+    TVMStreamHandle stream = device_api->CreateStream(device);
     Optional<NDArray> staging_buffer;
-    std::string raw_data;
     Array<NDArray> params;
-    for (const NDArrayCacheMetadata::FileRecord& shard_rec : metadata.records) {
+    std::vector<Optional<NDArray>> reused;
+    int64_t num_reused = 0;
+    // The parameters to publish at the end, when reloading.
+    std::vector<std::tuple<String, NDArray, uint64_t>> pending;
+    std::future<PrefetchedShard> next_shard;
+    if (!shards.empty()) next_shard = fprefetch(0);
+    for (size_t i = 0; i < shards.size(); ++i) {
+      const NDArrayCacheMetadata::FileRecord& shard_rec = shards[i];
+      PrefetchedShard prefetched;
       try {
-        params = shard_rec.Load(device, cache_path, &raw_data, &staging_buffer);
+        prefetched = next_shard.get();
+        if (i + 1 < shards.size()) next_shard = fprefetch(i + 1);
+        reused.assign(shard_rec.records.size(), NullOpt);
+        if (reuse && !prefetched.fingerprints.empty()) {
+          std::lock_guard<std::mutex> lock(pool->mutex_);
+          for (size_t j = 0; j < shard_rec.records.size(); ++j) {
+            const std::string& name = shard_rec.records[j].name;
+            auto it = pool->fingerprints_.find(name);
+            if (it != pool->fingerprints_.end() && it->second == prefetched.fingerprints[j]) {
+              reused[j] = pool->pool_.Get(name);
+              num_reused += reused[j].defined();
+            }
+          }
+        }
+        params = LoadMappedShard(shard_rec, device, prefetched.shard, &staging_buffer, stream,
+                                 &reused);
       } catch (const dmlc::Error& e) {
+        device_api->FreeStream(device, stream);
         LOG(FATAL) << "ValueError: Error when loading parameters from " << shard_rec.data_path
                    << ": " << e.what();
       }
       int num_params = params.size();
-      for (int i = 0; i < num_params; ++i) {
-        Update(shard_rec.records[i].name, params[i], true);
+      if (reuse) {
+        for (int j = 0; j < num_params; ++j) {
+          pending.emplace_back(shard_rec.records[j].name, params[j], prefetched.fingerprints[j]);
+        }
+      } else {
+        std::lock_guard<std::mutex> lock(pool->mutex_);
+        for (int j = 0; j < num_params; ++j) {
+          pool->Set(shard_rec.records[j].name, params[j], prefetched.fingerprints[j]);
+        }
       }
     }
+    device_api->FreeStream(device, stream);
+    std::lock_guard<std::mutex> lock(pool->mutex_);
+    for (const auto& [name, arr, fingerprint] : pending) {
+      pool->Set(name, arr, fingerprint);
+    }
+    return num_reused;
   }
 
- private:
+  /*! \brief Insert an array loaded from a cache file, the lock is to be held by the caller. */
+  void Set(const String& name, const NDArray& arr, uint64_t fingerprint) {
+    pool_.Set(name, arr);
+    fingerprints_[name] = fingerprint;
+  }
+
+  /*! \brief The lock protecting the states below. */
+  std::mutex mutex_;
   Map<String, NDArray> pool_;
+  /*! \brief The fingerprints of the arrays loaded from cache files. */
+  std::unordered_map<std::string, uint64_t> fingerprints_;
 };
 
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.get").set_body_typed(NDArrayCache::Get);
@@ -292,6 +717,11 @@ TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.update").set_body([](TVMArgs args,
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.remove").set_body_typed(NDArrayCache::Remove);
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.clear").set_body_typed(NDArrayCache::Clear);
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load").set_body_typed(NDArrayCache::Load);
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.reload").set_body_typed(NDArrayCache::Reload);
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.export_shared")
+    .set_body_typed(NDArrayCache::ExportShared);
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.import_shared")
+    .set_body_typed(NDArrayCache::ImportShared);
 
 // This param module node can be useful to get param dict in RPC mode
 // when the remote already have loaded parameters from file.
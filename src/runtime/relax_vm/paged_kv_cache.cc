@@ -28,6 +28,8 @@
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <limits>
+#include <memory>
 #include <numeric>
 #include <unordered_map>
 #include <utility>
@@ -61,6 +63,15 @@ constexpr const int kTreeAttnMaxTreeSize = 256;
 constexpr const int kAttnWorkspaceByte = 8 * 1024 * 1024;
 /*! \brief The id of the temporary logical page, which is useful for sliding window. */
 constexpr const int kPagedKVCacheTempPageId = -1;
+/*!
+ * \brief The sequence ids at and below this value are reserved for the
+ * sequences retained by the prefix cache.
+ */
+constexpr const int64_t kPrefixCacheSeqIdBase = std::numeric_limits<int64_t>::min() / 2;
+/*! \brief The number of pages in each chunk of host memory for swapped-out sequences. */
+constexpr const int kHostSwapChunkNumPages = 64;
+/*! \brief The maximum number of decode steps scheduled by a multi-step decode. */
+constexpr const int kMaxMultiStepDecodeSteps = 16;
 
 /*!
  * \brief The block structure in paged KV cache with common prefix support.
@@ -112,12 +123,18 @@ struct Block {
    * we do not allow appending new KV values to this block.
    */
   int external_ref_cnt = 0;
+  /*!
+   * \brief The ids of the host pages holding the K/V data of the block
+   * while its sequence is swapped out, in which case `page_ids` is empty.
+   */
+  std::vector<int32_t> host_page_ids;
 
   explicit Block(int32_t index) : index(index) {}
 
   /*! \brief Reset the block data. */
   void Reset() {
     page_ids.clear();
+    host_page_ids.clear();
     seq_length = 0;
     parent_idx = -1;
     external_ref_cnt = 0;
@@ -163,6 +180,11 @@ struct Sequence {
    * this sequence are committed
    */
   bool accepted_indices_committed = true;
+  /*!
+   * \brief Whether the K/V data of the blocks exclusively owned by the sequence
+   * is swapped out to host memory.
+   */
+  bool is_swapped_out = false;
 
   explicit Sequence(std::vector<Block>* global_block_pool, int32_t last_block_idx) {
     ++global_block_pool->at(last_block_idx).external_ref_cnt;
@@ -195,6 +217,180 @@ struct Sequence {
   }
 };
 
+/*!
+ * \brief The radix tree over token ids which indexes the prefixes retained in paged KV cache.
+ * Every node holds the tokens on the edge from its parent, and optionally the id of a
+ * retained sequence whose K/V data covers all the tokens from the root to the node.
+ * Each leaf holds a retained sequence, so every subtree contains at least one of them.
+ */
+class PrefixTree {
+ public:
+  /*!
+   * \brief Find the longest cached prefix of the given tokens.
+   * \param tokens The token ids to match.
+   * \param seq_id The output id of a retained sequence that starts with the matched prefix.
+   * \return The length of the matched prefix, 0 if nothing matches.
+   */
+  int64_t Match(const std::vector<int32_t>& tokens, int64_t* seq_id) {
+    Node* node = &root_;
+    int64_t matched = 0;
+    while (matched < static_cast<int64_t>(tokens.size())) {
+      auto it = node->children.find(tokens[matched]);
+      if (it == node->children.end()) break;
+      Node* child = it->second.get();
+      int64_t n = 0;
+      while (n < static_cast<int64_t>(child->tokens.size()) &&
+             matched + n < static_cast<int64_t>(tokens.size()) &&
+             child->tokens[n] == tokens[matched + n]) {
+        ++n;
+      }
+      matched += n;
+      node = child;
+      if (n < static_cast<int64_t>(child->tokens.size())) break;
+    }
+    if (matched == 0) return 0;
+    // Any retained sequence in the subtree shares the matched prefix.
+    while (node->seq_id == kNoSequence) {
+      ICHECK(!node->children.empty());
+      node = node->children.begin()->second.get();
+    }
+    node->last_access = ++clock_;
+    *seq_id = node->seq_id;
+    return matched;
+  }
+
+  /*! \brief Whether the given tokens are exactly the tokens of a retained sequence. */
+  bool Contains(const std::vector<int32_t>& tokens) const {
+    const Node* node = &root_;
+    size_t pos = 0;
+    while (pos < tokens.size()) {
+      auto it = node->children.find(tokens[pos]);
+      if (it == node->children.end()) return false;
+      node = it->second.get();
+      if (pos + node->tokens.size() > tokens.size() ||
+          !std::equal(node->tokens.begin(), node->tokens.end(), tokens.begin() + pos)) {
+        return false;
+      }
+      pos += node->tokens.size();
+    }
+    return node->seq_id != kNoSequence;
+  }
+
+  /*!
+   * \brief Record a retained sequence for the given tokens.
+   * \note The tokens are required not to be contained by the tree yet.
+   */
+  void Insert(const std::vector<int32_t>& tokens, int64_t seq_id) {
+    ICHECK(!tokens.empty());
+    Node* node = &root_;
+    size_t pos = 0;
+    while (pos < tokens.size()) {
+      auto it = node->children.find(tokens[pos]);
+      if (it == node->children.end()) {
+        auto leaf = std::make_unique<Node>();
+        leaf->tokens.assign(tokens.begin() + pos, tokens.end());
+        leaf->parent = node;
+        Node* leaf_ptr = leaf.get();
+        node->children.emplace(tokens[pos], std::move(leaf));
+        node = leaf_ptr;
+        break;
+      }
+      Node* child = it->second.get();
+      size_t n = 0;
+      while (n < child->tokens.size() && pos + n < tokens.size() &&
+             child->tokens[n] == tokens[pos + n]) {
+        ++n;
+      }
+      if (n < child->tokens.size()) {
+        // Split the edge at the first mismatch.
+        auto mid = std::make_unique<Node>();
+        mid->tokens.assign(child->tokens.begin(), child->tokens.begin() + n);
+        mid->parent = node;
+        std::unique_ptr<Node> child_owner = std::move(it->second);
+        child_owner->tokens.erase(child_owner->tokens.begin(), child_owner->tokens.begin() + n);
+        child_owner->parent = mid.get();
+        mid->children.emplace(child_owner->tokens[0], std::move(child_owner));
+        child = mid.get();
+        it->second = std::move(mid);
+      }
+      pos += n;
+      node = child;
+    }
+    ICHECK_EQ(node->seq_id, kNoSequence);
+    node->seq_id = seq_id;
+    node->last_access = ++clock_;
+    seq_nodes_[seq_id] = node;
+  }
+
+  /*! \brief Remove the retained sequence from the tree. */
+  void Remove(int64_t seq_id) {
+    auto it = seq_nodes_.find(seq_id);
+    ICHECK(it != seq_nodes_.end());
+    Node* node = it->second;
+    seq_nodes_.erase(it);
+    node->seq_id = kNoSequence;
+    // Erase the nodes without any retained sequence, and merge the single-child chains.
+    while (node != &root_ && node->seq_id == kNoSequence && node->children.empty()) {
+      Node* parent = node->parent;
+      parent->children.erase(node->tokens[0]);
+      node = parent;
+    }
+    if (node != &root_ && node->seq_id == kNoSequence && node->children.size() == 1) {
+      std::unique_ptr<Node> child = std::move(node->children.begin()->second);
+      node->children.clear();
+      node->tokens.insert(node->tokens.end(), child->tokens.begin(), child->tokens.end());
+      node->seq_id = child->seq_id;
+      node->last_access = child->last_access;
+      node->children = std::move(child->children);
+      for (auto& kv : node->children) kv.second->parent = node;
+      if (node->seq_id != kNoSequence) seq_nodes_[node->seq_id] = node;
+    }
+  }
+
+  /*! \return The least recently used retained sequence, or kNoSequence if there is none. */
+  int64_t LeastRecentlyUsed() const {
+    int64_t seq_id = kNoSequence;
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (const auto& kv : seq_nodes_) {
+      if (kv.second->last_access < oldest) {
+        oldest = kv.second->last_access;
+        seq_id = kv.first;
+      }
+    }
+    return seq_id;
+  }
+
+  /*! \return The number of retained sequences. */
+  size_t size() const { return seq_nodes_.size(); }
+
+  void Clear() {
+    root_.children.clear();
+    seq_nodes_.clear();
+  }
+
+  /*! \brief The placeholder id of "no retained sequence". */
+  static constexpr int64_t kNoSequence = std::numeric_limits<int64_t>::min();
+
+ private:
+  struct Node {
+    /*! \brief The tokens on the edge from the parent. */
+    std::vector<int32_t> tokens;
+    /*! \brief The children, keyed by the first token on their edge. */
+    std::unordered_map<int32_t, std::unique_ptr<Node>> children;
+    Node* parent = nullptr;
+    /*! \brief The retained sequence ending at this node, or kNoSequence. */
+    int64_t seq_id = kNoSequence;
+    /*! \brief The logical time of the last match or insertion. */
+    uint64_t last_access = 0;
+  };
+
+  Node root_;
+  /*! \brief The node of each retained sequence. */
+  std::unordered_map<int64_t, Node*> seq_nodes_;
+  /*! \brief The logical clock for LRU. */
+  uint64_t clock_ = 0;
+};
+
 /*!
  * \brief The rotary embedding mode adopted by the paged KV cache
  * when computing attention.
@@ -572,6 +768,11 @@ class PlainPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
  * For each `CopyXXXAsync`, it copies the input data to a local cache on host.
  * In `CommitAttnAuxDataCopy`, it copies all the data in the local cache to the device
  * array for a single time, and thus reduce the number of host-to-device copies needed.
+ *
+ * The commit is incremental: the manager remembers the data uploaded by the last
+ * commit, and only copies the ranges that changed since then. In steady decoding the
+ * layout of the local cache stays the same across steps, and only a few elements such
+ * as the last page lengths, the positions and the newly allocated page ids change.
  */
 class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
  public:
@@ -652,20 +853,8 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
   }
 
   void CommitAttnAuxDataCopy() final {
-    std::vector<int64_t> copy_shape{attn_aux_data_copy_offset_};
-    DLTensor copy_dst;
-    copy_dst.data = merged_attn_aux_data_device_->data;
-    copy_dst.device = device_;
-    copy_dst.ndim = 1;
-    copy_dst.dtype = dtype_aux_;
-    copy_dst.shape = copy_shape.data();
-    copy_dst.strides = nullptr;
-    copy_dst.byte_offset = 0;
-
-    DLTensor copy_src = copy_dst;
-    copy_src.data = merged_attn_aux_data_host_.data();
-    copy_src.device = Device{kDLCPU, 0};
-    NDArray::CopyFromTo(&copy_src, &copy_dst, copy_stream_);
+    CommitMergedAuxDataCopy(merged_attn_aux_data_host_, merged_attn_aux_data_device_,
+                            attn_aux_data_copy_offset_, &uploaded_attn_aux_data_);
   }
 
   void ResetCompactKVAuxDataCopy() final { compact_kv_aux_data_copy_offset_ = 0; }
@@ -687,20 +876,8 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
   }
 
   void CommitCompactKVAuxDataCopy() final {
-    std::vector<int64_t> copy_shape{compact_kv_aux_data_copy_offset_};
-    DLTensor copy_dst;
-    copy_dst.data = merged_compact_kv_aux_data_device_->data;
-    copy_dst.device = device_;
-    copy_dst.ndim = 1;
-    copy_dst.dtype = dtype_aux_;
-    copy_dst.shape = copy_shape.data();
-    copy_dst.strides = nullptr;
-    copy_dst.byte_offset = 0;
-
-    DLTensor copy_src = copy_dst;
-    copy_src.data = merged_compact_kv_aux_data_host_.data();
-    copy_src.device = Device{kDLCPU, 0};
-    NDArray::CopyFromTo(&copy_src, &copy_dst, copy_stream_);
+    CommitMergedAuxDataCopy(merged_compact_kv_aux_data_host_, merged_compact_kv_aux_data_device_,
+                            compact_kv_aux_data_copy_offset_, &uploaded_compact_kv_aux_data_);
   }
 
  private:
@@ -771,6 +948,70 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
     return view;
   }
 
+  /*!
+   * \brief Copy the first `num_elem` elements of the host local cache to the device array.
+   * Only the ranges that differ from the previously uploaded data are copied.
+   * \param host The host local cache.
+   * \param device The device array.
+   * \param num_elem The number of elements to commit.
+   * \param uploaded The data currently on the device array, which is updated in place.
+   */
+  void CommitMergedAuxDataCopy(const HostMemoryVector& host, const NDArray& device,
+                               int64_t num_elem, std::vector<int32_t>* uploaded) {
+    const int32_t* data = host.data();
+    int64_t num_compared = std::min(num_elem, static_cast<int64_t>(uploaded->size()));
+    // Collect the changed ranges, merging the ranges with small gaps in between.
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    int64_t i = 0;
+    while (i < num_compared) {
+      if (data[i] == (*uploaded)[i]) {
+        ++i;
+        continue;
+      }
+      int64_t begin = i;
+      int64_t end = ++i;
+      for (; i < num_compared && i - end < kDeltaRangeMergeGap; ++i) {
+        if (data[i] != (*uploaded)[i]) {
+          end = i + 1;
+        }
+      }
+      ranges.emplace_back(begin, end);
+      i = end;
+    }
+    if (num_compared < num_elem) {
+      if (!ranges.empty() && num_compared - ranges.back().second < kDeltaRangeMergeGap) {
+        ranges.back().second = num_elem;
+      } else {
+        ranges.emplace_back(num_compared, num_elem);
+      }
+    }
+    // Too many small copies are slower than a single full copy.
+    if (static_cast<int64_t>(ranges.size()) > kMaxNumDeltaRanges) {
+      ranges = {{0, num_elem}};
+    }
+
+    for (const auto& [begin, end] : ranges) {
+      int64_t copy_size = end - begin;
+      DLTensor copy_dst;
+      copy_dst.data = device->data;
+      copy_dst.device = device_;
+      copy_dst.ndim = 1;
+      copy_dst.dtype = dtype_aux_;
+      copy_dst.shape = &copy_size;
+      copy_dst.strides = nullptr;
+      copy_dst.byte_offset = begin * elem_byte_size_;
+
+      DLTensor copy_src = copy_dst;
+      copy_src.data = host.data();
+      copy_src.device = Device{kDLCPU, 0};
+      NDArray::CopyFromTo(&copy_src, &copy_dst, copy_stream_);
+    }
+    uploaded->resize(num_elem);
+    for (const auto& [begin, end] : ranges) {
+      std::copy(data + begin, data + end, uploaded->begin() + begin);
+    }
+  }
+
   NDArray CopyCompactKVAuxVecToCache(HostMemoryVector* data) {
     int64_t n_elem = data->size();
     std::memcpy(merged_compact_kv_aux_data_host_.data() + compact_kv_aux_data_copy_offset_,
@@ -786,6 +1027,11 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
     return (n + offset_alignment_ - 1) / offset_alignment_ * offset_alignment_;
   }
 
+  /*! \brief The changed ranges separated by fewer elements than this are copied together. */
+  static constexpr int64_t kDeltaRangeMergeGap = 64;
+  /*! \brief The maximum number of copies in an incremental commit. */
+  static constexpr int64_t kMaxNumDeltaRanges = 8;
+
   const int64_t cuda_byte_alignment_ = 16;
   const int64_t elem_byte_size_;
   const int64_t offset_alignment_;
@@ -796,6 +1042,9 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
   HostMemoryVector merged_compact_kv_aux_data_host_;
   NDArray merged_attn_aux_data_device_;
   NDArray merged_compact_kv_aux_data_device_;
+  /*! \brief The data uploaded to the device arrays by the last commit. */
+  std::vector<int32_t> uploaded_attn_aux_data_;
+  std::vector<int32_t> uploaded_compact_kv_aux_data_;
 };
 
 /*!
@@ -834,6 +1083,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   const int64_t num_kv_heads_;
   /*! \brief The number of features each head has. */
   const int64_t head_dim_;
+  /*! \brief The number of sequences the auxiliary data is reserved for. */
+  const int64_t reserved_num_seqs_;
   /*! \brief The number of total pages allocated in KV cache. */
   const int64_t num_total_pages_;
   /*! \brief The maximum total sequence length in a prefill. */
@@ -860,6 +1111,16 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
    * Along on the "2" dimension, index 0 stands for K and 1 stands for V.
    */
   Array<NDArray> pages_;
+  /*!
+   * \brief The float32 dequantization scales of the KV data when the pages are
+   * stored in a quantized dtype (e.g. int8 or e4m3_float8), and empty otherwise.
+   * The array has `num_layers` NDArrays, each of them has layout (num_pages, 2, num_heads),
+   * namely one scale per page and head for K and for V.
+   * The scales are owned by the kernels: every page hook receives the scales of
+   * its layer as the last argument, and the append kernel sets the scales of a
+   * page when writing its first slot.
+   */
+  Array<NDArray> page_scales_;
   /*! \brief The list of ids of released pages for page reuse. */
   std::vector<int32_t> free_page_ids_;
   /*! \brief The mapping from sequence ids to sequences. */
@@ -872,6 +1133,31 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The list of free available blocks (in their indices). */
   std::vector<int32_t> free_block_idx_;
 
+  /********************* Prefix Cache *********************/
+
+  /*! \brief The index from token prefixes to the retained sequences. */
+  PrefixTree prefix_tree_;
+  /*! \brief The number of retained sequences ever created, for id allocation. */
+  int64_t num_retained_seqs_created_ = 0;
+
+  /********************* Host Swap Space *********************/
+
+  /*!
+   * \brief The host memory chunks for swapped-out pages, allocated on demand on the
+   * preferred (pinned) host device. Each of them has layout
+   * (num_layers, kHostSwapChunkNumPages, 2, num_heads, page_size, head_dim).
+   */
+  std::vector<NDArray> host_swap_chunks_;
+  /*!
+   * \brief The host memory chunks for the scales of swapped-out pages when the pages
+   * are quantized. Each of them has layout (num_layers, kHostSwapChunkNumPages, 2, num_heads).
+   */
+  std::vector<NDArray> host_swap_scale_chunks_;
+  /*! \brief The list of ids of the free host pages. */
+  std::vector<int32_t> free_host_page_ids_;
+  /*! \brief The number of pages released by sliding window since the last Clear. */
+  int64_t num_sliding_window_released_pages_ = 0;
+
   /*********** Current Batch Info & Auxiliary Arrays on Device ***********/
   //-------------------------------------------
   // The following fields are auxiliary arrays on device.
@@ -900,9 +1186,65 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   std::vector<bool> use_decode_kernel_;
   /*! \brief Whether the attention request is a decode request, set in BeginForwardFunction. */
   bool is_decode_request_;
+  /*!
+   * \brief The number of decode sequences leading a mixed batch of decodes and prefill chunks,
+   * which attend to the cached KV data with the decode kernel while the prefill kernel computes
+   * the rest of the batch. It is 0 when the batch is not split.
+   */
+  int64_t num_mixed_decode_seqs_ = 0;
+  /*! \brief The views of the auxiliary data of each part of a split mixed batch. */
+  struct MixedBatchViews {
+    NDArray decode_page_indptr;
+    NDArray decode_length_info;
+    NDArray decode_k_rope_pos_offset;
+    NDArray decode_q_rope_position_map;
+    NDArray decode_attn_output;
+    NDArray decode_attn_scores;
+    NDArray prefill_qo_indptr;
+    NDArray prefill_page_indptr;
+    NDArray prefill_length_info;
+    NDArray prefill_k_rope_pos_offset;
+  };
+  MixedBatchViews mixed_batch_views_;
   /*! \brief The auxiliary data manager for attention. */
   std::unique_ptr<PagedKVCacheAuxDataManager> aux_data_manager_;
 
+  /*! \brief The per-step states of a forward round, used by multi-step decode. */
+  struct ForwardStepState {
+    int64_t cur_batch_size;
+    IntTuple cur_seq_ids;
+    IntTuple cur_append_lengths;
+    bool is_chain;
+    int num_depths;
+    bool append_before_attn;
+    std::vector<bool> use_decode_kernel;
+    bool is_decode_request;
+    NDArray cur_append_length_indptr_view;
+    NDArray k_ragged_rope_pos_offset_view;
+    NDArray q_rope_position_map_view;
+    NDArray append_position_map_view;
+    NDArray tree_attn_mask_view;
+    NDArray tree_attn_mn_indptr_view;
+    NDArray temp_attn_output_view;
+    NDArray temp_attn_scores_view;
+    NDArray merged_attn_scores_view;
+    std::vector<NDArray> qo_indptr_on_depths_view;
+    std::vector<NDArray> page_indptr_on_depths_view;
+    std::vector<NDArray> page_indices_on_depths_view;
+    std::vector<NDArray> length_info_on_depths_view;
+    std::vector<NDArray> k_rope_pos_offset_view;
+  };
+  /*! \brief The states of the remaining steps of the current multi-step decode. */
+  std::vector<ForwardStepState> multi_step_states_;
+  /*! \brief The index of the next step in `multi_step_states_`. */
+  size_t multi_step_next_step_ = 0;
+  /*!
+   * \brief The auxiliary data managers of the multi-step decode steps.
+   * Each step owns a manager, so that the device auxiliary data of all the steps
+   * coexist and keep fixed addresses across multi-step decodes.
+   */
+  std::vector<std::unique_ptr<PagedKVCacheAuxDataManager>> multi_step_aux_data_managers_;
+
   // Temporary arrays to store intermediate attention results.
   NDArray temp_attn_q_device_;
   NDArray temp_attn_k_device_;
@@ -987,8 +1329,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       int64_t page_size, int64_t num_layers, int64_t layer_id_begin_offset,  //
       int64_t num_qo_heads, int64_t num_kv_heads, int64_t head_dim, int64_t reserved_num_seqs,
       int64_t num_total_pages, int64_t prefill_chunk_size, bool support_sliding_window,
-      RoPEMode rope_mode, double rotary_scale, double rotary_theta, DLDataType dtype, Device device,
-      PackedFunc f_transpose_append, PackedFunc f_compact_copy, PackedFunc f_attention_prefill,
+      RoPEMode rope_mode, double rotary_scale, double rotary_theta, DLDataType dtype,
+      DLDataType kv_dtype, Device device, PackedFunc f_transpose_append,
+      PackedFunc f_compact_copy, PackedFunc f_attention_prefill,
       PackedFunc f_attention_decode, PackedFunc f_attention_prefill_sliding_window,
       PackedFunc f_attention_decode_sliding_window, PackedFunc f_attention_prefill_ragged,
       PackedFunc f_attention_prefill_with_tree_mask,
@@ -1005,6 +1348,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         num_qo_heads_(num_qo_heads),
         num_kv_heads_(num_kv_heads),
         head_dim_(head_dim),
+        reserved_num_seqs_(reserved_num_seqs),
         num_total_pages_(num_total_pages),
         prefill_chunk_size_(prefill_chunk_size),
         support_sliding_window_(support_sliding_window),
@@ -1034,8 +1378,18 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         device_(device) {
     pages_.reserve(num_layers);
     for (int i = 0; i < num_layers; ++i) {
-      pages_.push_back(
-          NDArray::Empty({num_total_pages, 2, num_kv_heads, page_size, head_dim}, dtype, device));
+      pages_.push_back(NDArray::Empty({num_total_pages, 2, num_kv_heads, page_size, head_dim},
+                                      kv_dtype, device));
+    }
+    if (DataType(kv_dtype) != DataType(dtype)) {
+      CHECK(DataType(kv_dtype) == DataType::Int(8) || DataType(kv_dtype).is_e4m3_float8())
+          << "The quantized KV cache only supports int8 and e4m3_float8, while the given KV dtype "
+          << "is " << DataType(kv_dtype);
+      page_scales_.reserve(num_layers);
+      for (int i = 0; i < num_layers; ++i) {
+        page_scales_.push_back(
+            NDArray::Empty({num_total_pages, 2, num_kv_heads}, DataType::Float(32), device));
+      }
     }
     // Allocate the host memory.
     Device preferred_host_device = GetPreferredHostDevice(device);
@@ -1116,17 +1470,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
 
     // Create the auxiliary data manager for attention.
-    // We only use the merged aux data for CUDA, since direct pointer
-    // operations may have issues on other platforms.
-    if (device_.device_type == DLDeviceType::kDLCUDA) {
-      aux_data_manager_ = std::make_unique<CachedPagedKVCacheAuxDataManager>(
-          reserved_num_seqs, num_total_pages, prefill_chunk_size, dtype_aux_, device,
-          preferred_host_device, copy_stream_);
-    } else {
-      aux_data_manager_ = std::make_unique<PlainPagedKVCacheAuxDataManager>(
-          reserved_num_seqs, num_total_pages, prefill_chunk_size, dtype_aux_, device,
-          preferred_host_device, copy_stream_);
-    }
+    aux_data_manager_ = CreateAuxDataManager();
   }
 
   ~PagedAttentionKVCacheObj() {
@@ -1146,6 +1490,14 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
     global_block_pool_.clear();
     free_block_idx_.clear();
+    prefix_tree_.Clear();
+    free_host_page_ids_.clear();
+    for (int64_t host_page_id = host_swap_chunks_.size() * kHostSwapChunkNumPages - 1;
+         host_page_id >= 0; --host_page_id) {
+      free_host_page_ids_.push_back(host_page_id);
+    }
+    multi_step_states_.clear();
+    num_sliding_window_released_pages_ = 0;
     dirty_aux_data_device_ = false;
   }
 
@@ -1170,6 +1522,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       for (int32_t page_id : global_block_pool_[block_idx].page_ids) {
         free_page_ids_.push_back(page_id);
       }
+      for (int32_t host_page_id : global_block_pool_[block_idx].host_page_ids) {
+        free_host_page_ids_.push_back(host_page_id);
+      }
       free_block_idx_.push_back(block_idx);
       block_idx = global_block_pool_[block_idx].parent_idx;
     }
@@ -1195,6 +1550,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     CHECK(parent_it->second.accepted_indices_committed)
         << "The parent sequence's token tree computed in the last round of forward has not been "
            "committed with accepted nodes.";
+    CHECK(!parent_it->second.is_swapped_out)
+        << "The parent sequence \"" << parent_seq_id << "\" is swapped out and cannot be forked.";
 
     if (fork_pos == -1) {
       fork_pos = parent_it->second.seq_length;
@@ -1303,7 +1660,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       DeviceAPI::Get(device_)->SetStream(device_, copy_stream_);
     }
     for (int layer = 0; layer < num_layers_; ++layer) {
-      f_copy_single_page_(pages_[layer], src_page_id, tgt_page_id, copy_length);
+      CallPageFunc(f_copy_single_page_, layer, pages_[layer], src_page_id, tgt_page_id,
+                   copy_length);
     }
     if (copy_stream_ != compute_stream_) {
       // Set the compute stream back.
@@ -1317,6 +1675,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     if (total_copy_length == 0) {
       return;
     }
+    // The batch of the copy kernel only has the sequences with KV data to move.
+    int64_t num_copy_seqs = static_cast<int64_t>(commit_copy_length_indptr_host_.size()) - 1;
 
     // Copy indptr/src/dst arrays to GPU.
     aux_data_manager_->ResetCompactKVAuxDataCopy();
@@ -1334,8 +1694,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
     ICHECK(f_compact_copy_.defined()) << "Function \"f_compact_copy\" is not defined.";
     for (int layer = 0; layer < num_layers_; ++layer) {
-      f_compact_copy_(pages_[layer], commit_copy_length_indptr_view,
-                      commit_copy_src_dst_pos_in_page_table_view, cur_batch_size_);
+      CallPageFunc(f_compact_copy_, layer, pages_[layer], commit_copy_length_indptr_view,
+                   commit_copy_src_dst_pos_in_page_table_view, num_copy_seqs);
     }
     if (copy_stream_ != compute_stream_) {
       // Set the compute stream back.
@@ -1358,6 +1718,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     CHECK_LT(attn_sink_size, sliding_window_size)
         << "The attn sink size should be less than the sliding window size.";
 
+    CHECK(!it->second.is_swapped_out) << "The sequence \"" << seq_id << "\" is swapped out.";
     // Set the sliding window flag of the sequence.
     CHECK_EQ(it->second.sliding_window_size, -1)
         << "A sequence cannot be enabled twice for sliding window.";
@@ -1378,6 +1739,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     auto it = seq_map_.find(seq_id);
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
 
+    CHECK(!it->second.is_swapped_out)
+        << "The sequence \"" << seq_id << "\" is swapped out. Please swap it in before PopN.";
     CHECK_GE(n, 0) << "The length of popping " << n << " cannot be negative.";
     CHECK_LE(n, it->second.seq_length)
         << "The sequence only has length " << it->second.seq_length
@@ -1434,6 +1797,222 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     dirty_aux_data_device_ = true;
   }
 
+  /************** Prefix Cache **************/
+
+  int64_t PrefixCacheInsert(int64_t seq_id, const IntTuple& token_ids) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK_EQ(it->second.sliding_window_size, -1)
+        << "The sequence \"" << seq_id
+        << "\" is enabled with sliding window and cannot be retained in prefix cache.";
+    CHECK(!it->second.is_swapped_out) << "The sequence \"" << seq_id << "\" is swapped out.";
+    CHECK(it->second.accepted_indices_committed)
+        << "The sequence's token tree computed in the last round of forward has not been "
+           "committed with accepted nodes.";
+    // Only whole pages are retained, since partial pages cannot be shared.
+    int64_t length = std::min<int64_t>(token_ids.size(), it->second.seq_length);
+    length -= length % page_size_;
+    if (length == 0) {
+      return 0;
+    }
+    std::vector<int32_t> tokens(token_ids.begin(), token_ids.begin() + length);
+    if (prefix_tree_.Contains(tokens)) {
+      return length;
+    }
+    int64_t retained_seq_id = kPrefixCacheSeqIdBase - num_retained_seqs_created_++;
+    ForkSequence(seq_id, retained_seq_id, length);
+    prefix_tree_.Insert(tokens, retained_seq_id);
+    return length;
+  }
+
+  int64_t PrefixCacheMatchAndAddSequence(int64_t seq_id, const IntTuple& token_ids) final {
+    CHECK_GT(seq_id, kPrefixCacheSeqIdBase)
+        << "The sequence id " << seq_id << " is reserved for the prefix cache.";
+    CHECK(seq_map_.find(seq_id) == seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is already in the KV cache.";
+    // Leave out the last token, so that at least one position is computed for the output.
+    std::vector<int32_t> tokens(token_ids.begin(), token_ids.end());
+    if (!tokens.empty()) {
+      tokens.pop_back();
+    }
+    int64_t retained_seq_id = PrefixTree::kNoSequence;
+    int64_t matched_length = prefix_tree_.Match(tokens, &retained_seq_id);
+    matched_length -= matched_length % page_size_;
+    if (matched_length == 0) {
+      AddSequence(seq_id);
+      return 0;
+    }
+    ForkSequence(retained_seq_id, seq_id, matched_length);
+    return matched_length;
+  }
+
+  int64_t PrefixCacheEvict(int64_t num_pages) final {
+    int64_t num_freed_pages = 0;
+    while ((num_pages < 0 || num_freed_pages < num_pages) && prefix_tree_.size() > 0) {
+      int64_t retained_seq_id = prefix_tree_.LeastRecentlyUsed();
+      size_t num_free_pages_before = free_page_ids_.size();
+      prefix_tree_.Remove(retained_seq_id);
+      // The pages still shared with live sequences stay until those sequences are removed.
+      RemoveSequence(retained_seq_id);
+      num_freed_pages += free_page_ids_.size() - num_free_pages_before;
+    }
+    return num_freed_pages;
+  }
+
+  /************** Swapping **************/
+
+  int32_t SwapOutSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    Sequence& seq = it->second;
+    CHECK(!seq.is_swapped_out) << "The sequence \"" << seq_id << "\" is already swapped out.";
+    CHECK_EQ(seq.sliding_window_size, -1)
+        << "The sequence \"" << seq_id
+        << "\" is enabled with sliding window and cannot be swapped.";
+    CHECK(seq.accepted_indices_committed)
+        << "The sequence's token tree computed in the last round of forward has not been "
+           "committed with accepted nodes.";
+    // The copies must not start before the pending computation writing the pages.
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    // Only the blocks exclusively owned by the sequence are swapped.
+    // The shared prefix blocks stay on device for the other sequences.
+    int32_t num_swapped_pages = 0;
+    for (int32_t block_idx : GetExclusiveBlocks(seq)) {
+      Block& block = global_block_pool_[block_idx];
+      ICHECK(block.host_page_ids.empty());
+      for (int32_t page_id : block.page_ids) {
+        int32_t host_page_id = GetFreeHostPage();
+        CopyPageAsync(page_id, host_page_id, /*to_host=*/true);
+        block.host_page_ids.push_back(host_page_id);
+        free_page_ids_.push_back(page_id);
+      }
+      num_swapped_pages += block.page_ids.size();
+      block.page_ids.clear();
+    }
+    seq.is_swapped_out = true;
+    // The freed pages are only reused after the compute stream waits for the copy stream.
+    dirty_aux_data_device_ = true;
+    return num_swapped_pages;
+  }
+
+  void SwapInSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    Sequence& seq = it->second;
+    CHECK(seq.is_swapped_out) << "The sequence \"" << seq_id << "\" is not swapped out.";
+    std::vector<int32_t> blocks = GetExclusiveBlocks(seq);
+    size_t num_pages_needed = 0;
+    for (int32_t block_idx : blocks) {
+      num_pages_needed += global_block_pool_[block_idx].host_page_ids.size();
+    }
+    CHECK_LE(num_pages_needed, free_page_ids_.size())
+        << "The KV cache does not have enough free pages to swap in sequence \"" << seq_id
+        << "\": " << num_pages_needed << " pages are needed, while only "
+        << free_page_ids_.size() << " pages are free.";
+    // The copies must not overwrite the pages read by the pending computation.
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    for (int32_t block_idx : blocks) {
+      Block& block = global_block_pool_[block_idx];
+      for (int32_t host_page_id : block.host_page_ids) {
+        int32_t page_id = GetFreePage();
+        CopyPageAsync(page_id, host_page_id, /*to_host=*/false);
+        block.page_ids.push_back(page_id);
+        free_host_page_ids_.push_back(host_page_id);
+      }
+      block.host_page_ids.clear();
+    }
+    seq.is_swapped_out = false;
+    dirty_aux_data_device_ = true;
+  }
+
+  /************** Transfer **************/
+
+  Array<NDArray> ExportSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    const Sequence& seq = it->second;
+    CHECK(!seq.is_swapped_out) << "The sequence \"" << seq_id
+                               << "\" is swapped out. Please swap it in before exporting it.";
+    CHECK_EQ(seq.sliding_window_size, -1)
+        << "The sequence \"" << seq_id
+        << "\" is enabled with sliding window and cannot be exported.";
+    CHECK(seq.accepted_indices_committed)
+        << "The sequence's token tree computed in the last round of forward has not been "
+           "committed with accepted nodes.";
+    // All the blocks but the last one are full, so the pages of the blocks in order
+    // hold the K/V data of the sequence contiguously.
+    std::vector<int32_t> page_ids;
+    for (int32_t block_idx : seq.GetBlockTrace(global_block_pool_)) {
+      const Block& block = global_block_pool_[block_idx];
+      page_ids.insert(page_ids.end(), block.page_ids.begin(), block.page_ids.end());
+    }
+    int64_t num_pages = page_ids.size();
+    Array<NDArray> data{NDArray::Empty(
+        {num_layers_, num_pages, 2, num_kv_heads_, page_size_, head_dim_}, pages_[0]->dtype,
+        device_)};
+    if (!page_scales_.empty()) {
+      data.push_back(NDArray::Empty({num_layers_, num_pages, 2, num_kv_heads_},
+                                    DataType::Float(32), device_));
+    }
+    // The copies must not start before the pending computation writing the pages.
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    for (int64_t i = 0; i < num_pages; ++i) {
+      CopyPageAsync(page_ids[i], data, i, /*to_arrays=*/true);
+    }
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, copy_stream_, compute_stream_);
+    }
+    return data;
+  }
+
+  void ImportSequence(int64_t seq_id, int64_t seq_length, const Array<NDArray>& data) final {
+    CHECK(seq_map_.find(seq_id) == seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is already in the KV cache.";
+    CHECK_GE(seq_length, 0) << "ValueError: The sequence length must be non-negative.";
+    CHECK_EQ(data.size(), page_scales_.empty() ? 1 : 2)
+        << "ValueError: Expect the pages" << (page_scales_.empty() ? "" : " and their scales")
+        << " of the sequence, but got " << data.size() << " arrays.";
+    int64_t num_pages = (seq_length + page_size_ - 1) / page_size_;
+    std::vector<int64_t> shape{num_layers_, num_pages, 2, num_kv_heads_, page_size_, head_dim_};
+    CHECK(data[0].Shape() == ShapeTuple(shape) &&
+          DataType(data[0]->dtype) == DataType(pages_[0]->dtype))
+        << "ValueError: Expect the pages of shape " << ShapeTuple(shape) << " and dtype "
+        << DataType(pages_[0]->dtype) << " for a sequence of length " << seq_length
+        << ", but got shape " << data[0].Shape() << " and dtype " << DataType(data[0]->dtype);
+    if (!page_scales_.empty()) {
+      shape.resize(4);
+      CHECK(data[1].Shape() == ShapeTuple(shape) && DataType(data[1]->dtype) == DataType::Float(32))
+          << "ValueError: Expect the page scales of shape " << ShapeTuple(shape)
+          << " and dtype float32, but got shape " << data[1].Shape() << " and dtype "
+          << DataType(data[1]->dtype);
+    }
+    CHECK_LE(static_cast<size_t>(num_pages), free_page_ids_.size())
+        << "The KV cache does not have enough free pages to import sequence \"" << seq_id
+        << "\": " << num_pages << " pages are needed, while only " << free_page_ids_.size()
+        << " pages are free.";
+    // The copies must not overwrite the pages read by the pending computation.
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    int32_t block_idx = GetFreeBlock();
+    Block& block = global_block_pool_[block_idx];
+    for (int64_t i = 0; i < num_pages; ++i) {
+      int32_t page_id = GetFreePage();
+      CopyPageAsync(page_id, data, i, /*to_arrays=*/false);
+      block.page_ids.push_back(page_id);
+    }
+    block.seq_length = seq_length;
+    seq_map_.insert({seq_id, Sequence(&global_block_pool_, block_idx)});
+    // The compute stream waits for the copies at the next forward.
+    dirty_aux_data_device_ = true;
+  }
+
   /************** Raw Info Query **************/
 
   bool Empty() const final {
@@ -1452,6 +2031,61 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     return total_seq_len;
   }
 
+  IntTuple GetPageStats() const final {
+    // - Count the sequences referencing each block, and the user sequences among them.
+    std::vector<int32_t> num_seqs_of_block(global_block_pool_.size(), 0);
+    std::vector<int32_t> num_user_seqs_of_block(global_block_pool_.size(), 0);
+    int64_t num_user_seqs = 0;
+    for (const auto& [seq_id, seq] : seq_map_) {
+      bool is_user_seq = seq_id > kPrefixCacheSeqIdBase;
+      num_user_seqs += is_user_seq;
+      for (int32_t block_idx = seq.last_block_idx; block_idx != -1;
+           block_idx = global_block_pool_[block_idx].parent_idx) {
+        ++num_seqs_of_block[block_idx];
+        num_user_seqs_of_block[block_idx] += is_user_seq;
+      }
+    }
+    int64_t num_shared_pages = 0;
+    int64_t num_prefix_cache_pages = 0;
+    for (int32_t block_idx = 0; block_idx < static_cast<int32_t>(global_block_pool_.size());
+         ++block_idx) {
+      int64_t num_pages = global_block_pool_[block_idx].page_ids.size();
+      if (num_seqs_of_block[block_idx] > 1) {
+        num_shared_pages += num_pages;
+      }
+      if (num_seqs_of_block[block_idx] > 0 && num_user_seqs_of_block[block_idx] == 0) {
+        num_prefix_cache_pages += num_pages;
+      }
+    }
+    int64_t num_host_pages =
+        host_swap_chunks_.size() * kHostSwapChunkNumPages - free_host_page_ids_.size();
+    return IntTuple{num_total_pages_,
+                    static_cast<int64_t>(free_page_ids_.size()),
+                    num_shared_pages,
+                    num_prefix_cache_pages,
+                    num_host_pages,
+                    num_sliding_window_released_pages_,
+                    num_user_seqs,
+                    static_cast<int64_t>(global_block_pool_.size() - free_block_idx_.size())};
+  }
+
+  IntTuple GetSequenceNumPages(const IntTuple& seq_ids) const final {
+    std::vector<int64_t> num_pages;
+    num_pages.reserve(seq_ids.size());
+    for (int64_t seq_id : seq_ids) {
+      auto it = seq_map_.find(seq_id);
+      CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
+                                  << "\" cannot be found in KV cache.";
+      int64_t seq_num_pages = 0;
+      for (int32_t block_idx = it->second.last_block_idx; block_idx != -1;
+           block_idx = global_block_pool_[block_idx].parent_idx) {
+        seq_num_pages += global_block_pool_[block_idx].page_ids.size();
+      }
+      num_pages.push_back(seq_num_pages);
+    }
+    return IntTuple(num_pages);
+  }
+
   /************** Attention **************/
 
   void BeginForward(const IntTuple& seq_ids, const IntTuple& append_lengths,
@@ -1459,10 +2093,24 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     CHECK_EQ(seq_ids.size(), append_lengths.size())
         << "The seq_ids size (" << seq_ids.size() << ") and append_lengths size ("
         << append_lengths.size() << ") mismatch.";
+    // - Drop the remaining steps of the ongoing multi-step decode, if any.
+    multi_step_states_.clear();
     cur_batch_size_ = seq_ids.size();
     cur_seq_ids_ = seq_ids;
     cur_append_lengths_ = append_lengths;
 
+    if (prefix_tree_.size() > 0) {
+      // - Evict retained prefixes when the appended tokens may not fit into the free pages.
+      int64_t num_pages_needed = 0;
+      for (int i = 0; i < cur_batch_size_; ++i) {
+        num_pages_needed += (append_lengths[i] + page_size_ - 1) / page_size_ + 1;
+      }
+      int64_t num_free_pages = free_page_ids_.size();
+      if (num_pages_needed > num_free_pages) {
+        PrefixCacheEvict(num_pages_needed - num_free_pages);
+      }
+    }
+
     // - Collect sequence/block/page information for attention.
     std::vector<Sequence*> sequences;
     std::vector<int32_t> last_block_length_before_append;
@@ -1474,6 +2122,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       auto it = seq_map_.find(seq_ids[i]);
       CHECK(it != seq_map_.end()) << "The sequence \"" << seq_ids[i]
                                   << "\" cannot be found in KV cache.";
+      CHECK(!it->second.is_swapped_out)
+          << "The sequence \"" << seq_ids[i]
+          << "\" is swapped out. Please swap it in before running forward.";
       sequences.push_back(&it->second);
       last_block_length_before_append.push_back(
           global_block_pool_[it->second.last_block_idx].seq_length);
@@ -1540,6 +2191,24 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       }
     }
 
+    // - Split a mixed batch whose decode sequences come first, so that the decodes do not
+    //   run through the prefill kernel. The kernels planned in BeginForward are planned
+    //   for the whole batch, and the length info under sliding window cannot be viewed
+    //   in parts, so the split only applies to the unplanned kernels without sliding window.
+    num_mixed_decode_seqs_ = 0;
+    if (!is_decode_request_ && num_depths_ == 1 && !support_sliding_window_ &&
+        !f_attention_prefill_begin_forward_.defined() &&
+        !f_attention_decode_begin_forward_.defined() &&
+        static_cast<int64_t>(chunked_block_ids_arr[0].size()) == cur_batch_size_) {
+      int64_t num_decode_seqs = 0;
+      while (num_decode_seqs < cur_batch_size_ && append_lengths[num_decode_seqs] == 1) {
+        ++num_decode_seqs;
+      }
+      if (num_decode_seqs < cur_batch_size_) {
+        num_mixed_decode_seqs_ = num_decode_seqs;
+      }
+    }
+
     for (int d = 0; d < num_depths_; ++d) {
       HostMemoryVector& qo_indptr_h = qo_indptr_on_depths_host_[d];
       HostMemoryVector& page_indptr_h = page_indptr_on_depths_host_[d];
@@ -1662,6 +2331,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void EndForward() final {
+    if (multi_step_next_step_ < multi_step_states_.size()) {
+      // - Move to the next step of the multi-step decode.
+      LoadForwardStepState(multi_step_states_[multi_step_next_step_++]);
+      return;
+    }
+    multi_step_states_.clear();
     if (!f_attention_prefill_end_forward_.defined() || !f_attention_decode_end_forward_.defined() ||
         !f_attention_prefill_ragged_end_forward_.defined()) {
       return;
@@ -1673,15 +2348,70 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
   }
 
+  void BeginMultiStepDecode(const IntTuple& seq_ids, int64_t num_steps) final {
+    CHECK_GE(num_steps, 1) << "The number of decode steps should be positive.";
+    CHECK_LE(num_steps, kMaxMultiStepDecodeSteps)
+        << "At most " << kMaxMultiStepDecodeSteps << " decode steps can be scheduled at once.";
+    CHECK(!f_attention_prefill_begin_forward_.defined() &&
+          !f_attention_decode_begin_forward_.defined() &&
+          !f_attention_prefill_ragged_begin_forward_.defined())
+        << "Multi-step decode does not support the attention kernels that are planned in "
+           "BeginForward.";
+
+    // - Check that the pages of all steps can be reserved.
+    int64_t num_pages_needed = 0;
+    for (int64_t seq_id : seq_ids) {
+      auto it = seq_map_.find(seq_id);
+      CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
+                                  << "\" cannot be found in KV cache.";
+      const Block& block = global_block_pool_[it->second.last_block_idx];
+      int64_t tgt_npage = (block.seq_length - block.sink_length + block.sliding_window_offset +
+                           num_steps + page_size_ - 1) /
+                          page_size_;
+      num_pages_needed += std::max(tgt_npage - static_cast<int64_t>(block.page_ids.size()),
+                                   static_cast<int64_t>(0));
+    }
+    if (num_pages_needed > static_cast<int64_t>(free_page_ids_.size()) &&
+        prefix_tree_.size() > 0) {
+      PrefixCacheEvict(num_pages_needed - free_page_ids_.size());
+    }
+    CHECK_LE(num_pages_needed, free_page_ids_.size())
+        << "There are not enough free pages to decode " << num_steps << " steps: "
+        << num_pages_needed << " pages are needed while " << free_page_ids_.size()
+        << " pages are free.";
+
+    while (static_cast<int64_t>(multi_step_aux_data_managers_.size()) < num_steps) {
+      multi_step_aux_data_managers_.push_back(CreateAuxDataManager());
+    }
+    // - Prepare every step as a normal decode forward, with the auxiliary
+    // data copied into the manager of the step.
+    IntTuple append_lengths(std::vector<int64_t>(seq_ids.size(), 1));
+    std::vector<ForwardStepState> states;
+    states.reserve(num_steps);
+    for (int64_t step = 0; step < num_steps; ++step) {
+      BeginForward(seq_ids, append_lengths, NullOpt);
+      std::swap(aux_data_manager_, multi_step_aux_data_managers_[step]);
+      SyncAuxArrayToDevice();
+      std::swap(aux_data_manager_, multi_step_aux_data_managers_[step]);
+      states.push_back(SaveForwardStepState());
+    }
+    // - Sync the copy stream only once for all the steps.
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, copy_stream_, compute_stream_);
+    }
+    multi_step_states_ = std::move(states);
+    LoadForwardStepState(multi_step_states_[0]);
+    multi_step_next_step_ = 1;
+  }
+
   void AttentionWithFusedQKV(int64_t layer_id, NDArray qkv_data, Optional<NDArray> mask,
                              NDArray o_data, double attn_score_scaling_factor) final {
     // Part 1. Shape and dtype check.
     int64_t local_layer_id = layer_id - layer_id_begin_offset_;
     CHECK_GE(local_layer_id, 0);
     CHECK_LT(local_layer_id, num_layers_);
-    NDArray pages = pages_[local_layer_id];
-    CHECK(qkv_data.DataType() == pages.DataType());
-    CHECK(o_data.DataType() == pages.DataType());
+    CHECK(qkv_data.DataType() == temp_attn_q_device_.DataType());
+    CHECK(o_data.DataType() == temp_attn_q_device_.DataType());
 
     // qkv_data: (num_total_length, num_qo_heads + 2 * num_kv_heads, head_dim)
     // o_data: (num_total_length, num_qo_heads, head_dim)
@@ -1720,13 +2450,15 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
     // Part 3. Append k/v data to kv-cache if flag "append_before_attn" is set.
     if (append_before_attn_) {
-      f_transpose_append_(pages_[local_layer_id], k_data, v_data, append_position_map_view_);
+      CallPageFunc(f_transpose_append_, local_layer_id, pages_[local_layer_id], k_data, v_data,
+                   append_position_map_view_);
     }
     // Part 4: perform attention
     AttentionInternal(layer_id, q_data, k_data, v_data, o_data, attn_score_scaling_factor);
     // Part 5. Append k/v data to kv-cache if flag "append_before_attn" is not set.
     if (!append_before_attn_) {
-      f_transpose_append_(pages_[local_layer_id], k_data, v_data, append_position_map_view_);
+      CallPageFunc(f_transpose_append_, local_layer_id, pages_[local_layer_id], k_data, v_data,
+                   append_position_map_view_);
     }
   }
 
@@ -1736,12 +2468,20 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     int num_seq_to_commit = seq_ids.size();
 
     std::vector<Sequence*> sequences;
+    // The position of each sequence in the batch of the last forward.
+    std::vector<int> batch_indices;
     sequences.reserve(num_seq_to_commit);
+    batch_indices.reserve(num_seq_to_commit);
     for (int i = 0; i < num_seq_to_commit; ++i) {
       auto it = seq_map_.find(seq_ids[i]);
       CHECK(it != seq_map_.end()) << "The sequence \"" << seq_ids[i]
                                   << "\" cannot be found in KV cache.";
       sequences.push_back(&it->second);
+      auto it_batch = std::find(cur_seq_ids_.begin(), cur_seq_ids_.end(), seq_ids[i]);
+      CHECK(it_batch != cur_seq_ids_.end())
+          << "ValueError: The sequence " << seq_ids[i]
+          << " is not in the batch of the last forward, so it has no token tree to commit.";
+      batch_indices.push_back(it_batch - cur_seq_ids_.begin());
       CHECK(!it->second.accepted_indices_committed)
           << "The accepted nodes of sequence " << seq_ids[i] << " are already committed.";
       CHECK_GE(leaf_indices[i], -1)
@@ -1763,6 +2503,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
           // No node is accepted. All nodes in the token tree need to be popped.
           continue;
         }
+        int64_t append_begin = cur_append_lengths_indptr_host_[batch_indices[i]];
 
         // Get the accepted node path on the token tree.
         std::vector<int32_t> path_on_tree;
@@ -1788,18 +2529,22 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
         // Convert the in-sequence src/dst positions to src/dst positions in page table
         // by looking up "append_position_map".
+        // A sequence whose accepted path is already in place contributes no copy, and is left
+        // out of the compaction batch together with the sequences accepting no node.
+        if (path_on_tree.empty()) {
+          continue;
+        }
         for (int p = 0; p < static_cast<int>(path_on_tree.size()); ++p) {
           commit_copy_src_pos_in_page_table_host_.push_back(
-              append_position_map_host_[cur_append_lengths_indptr_host_[i] + path_on_tree[p]]);
+              append_position_map_host_[append_begin + path_on_tree[p]]);
           commit_copy_dst_pos_in_page_table_host_.push_back(
-              append_position_map_host_[cur_append_lengths_indptr_host_[i] +
-                                        copy_dst_pos_in_seq[p]]);
+              append_position_map_host_[append_begin + copy_dst_pos_in_seq[p]]);
         }
         commit_copy_length_indptr_host_.push_back(commit_copy_length_indptr_host_.back() +
                                                   path_on_tree.size());
       }
 
-      // Compact the KV data for each sequence by copying KV data.
+      // Compact the KV data of all the sequences with one copy kernel launch per layer.
       CompactKVCopy();
     }
 
@@ -1809,9 +2554,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     //         we have already launched all copies.
     for (int i = 0; i < num_seq_to_commit; ++i) {
       int64_t length_to_pop =
-          cur_append_lengths_[i] -
+          cur_append_lengths_[batch_indices[i]] -
           (leaf_indices[i] != -1 ? (sequences[i]->token_tree_node_depths[leaf_indices[i]] + 1) : 0);
-      PopN(cur_seq_ids_[i], length_to_pop);
+      PopN(seq_ids[i], length_to_pop);
       // Reset the sequence states.
       sequences[i]->accepted_indices_committed = true;
       sequences[i]->token_tree_parent_ptr.clear();
@@ -1834,6 +2579,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
            "initialization. Please construct the KV cache with `f_debug_get_kv`.";
 
     const Sequence& seq = seq_map_.at(seq_id);
+    CHECK(!seq.is_swapped_out) << "The sequence \"" << seq_id << "\" is swapped out.";
     CHECK_GE(start_pos, 0) << "DebugGetKV does not accept negative start_pos " << start_pos;
     CHECK_LE(end_pos, seq.seq_length) << "DebugGetKV does not accept out-of-range end_pos";
     CHECK_LT(start_pos, end_pos) << "DebugGetKV does not accept \"start_pos >= end_pos\"";
@@ -1872,7 +2618,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         append_position_map.data() + start_pos,
         (end_pos - start_pos) * ((dtype_aux_.bits * dtype_aux_.lanes + 7) / 8));
     for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
-      f_debug_get_kv_.value()(pages_[layer_id], position_map_device, k_data, v_data, layer_id);
+      CallPageFunc(f_debug_get_kv_.value(), layer_id, pages_[layer_id], position_map_device,
+                   k_data, v_data, layer_id);
     }
   }
 
@@ -1909,6 +2656,97 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     return block_idx;
   }
 
+  /*! \brief Get the blocks of the sequence not shared with other sequences, from the last one. */
+  std::vector<int32_t> GetExclusiveBlocks(const Sequence& seq) const {
+    std::vector<int32_t> blocks;
+    int32_t block_idx = seq.last_block_idx;
+    while (block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1) {
+      blocks.push_back(block_idx);
+      block_idx = global_block_pool_[block_idx].parent_idx;
+    }
+    return blocks;
+  }
+
+  /*! \brief Get a free host page for swapping, allocating a new chunk when needed. */
+  int32_t GetFreeHostPage() {
+    if (free_host_page_ids_.empty()) {
+      int64_t chunk_begin = host_swap_chunks_.size() * kHostSwapChunkNumPages;
+      host_swap_chunks_.push_back(NDArray::Empty(
+          {num_layers_, kHostSwapChunkNumPages, 2, num_kv_heads_, page_size_, head_dim_},
+          pages_[0]->dtype, GetPreferredHostDevice(device_)));
+      if (!page_scales_.empty()) {
+        host_swap_scale_chunks_.push_back(
+            NDArray::Empty({num_layers_, kHostSwapChunkNumPages, 2, num_kv_heads_},
+                           DataType::Float(32), GetPreferredHostDevice(device_)));
+      }
+      for (int64_t host_page_id = chunk_begin + kHostSwapChunkNumPages - 1;
+           host_page_id >= chunk_begin; --host_page_id) {
+        free_host_page_ids_.push_back(host_page_id);
+      }
+    }
+    int32_t host_page_id = free_host_page_ids_.back();
+    free_host_page_ids_.pop_back();
+    return host_page_id;
+  }
+
+  /*! \brief Copy one page of all layers between device and host on the copy stream. */
+  void CopyPageAsync(int32_t page_id, int32_t host_page_id, bool to_host) {
+    int64_t chunk_idx = host_page_id / kHostSwapChunkNumPages;
+    Array<NDArray> chunks{host_swap_chunks_[chunk_idx]};
+    if (!page_scales_.empty()) {
+      chunks.push_back(host_swap_scale_chunks_[chunk_idx]);
+    }
+    CopyPageAsync(page_id, chunks, host_page_id % kHostSwapChunkNumPages, to_host);
+  }
+
+  /*!
+   * \brief Copy one page of all layers from/to the `index`-th page of the given arrays of
+   * shape (num_layers, num_pages, ...), which hold the pages followed by their scales
+   * when the pages are quantized, on the copy stream.
+   */
+  void CopyPageAsync(int32_t page_id, const Array<NDArray>& arrays, int64_t index,
+                     bool to_arrays) {
+    int64_t num_pages = arrays[0]->shape[1];
+    for (int64_t layer = 0; layer < num_layers_; ++layer) {
+      CopyPageSliceAsync(pages_[layer], page_id, arrays[0], layer * num_pages + index,
+                         to_arrays);
+      if (!page_scales_.empty()) {
+        CopyPageSliceAsync(page_scales_[layer], page_id, arrays[1], layer * num_pages + index,
+                           to_arrays);
+      }
+    }
+  }
+
+  /*!
+   * \brief Copy the `page_id`-th slice of a device array whose leading dimension
+   * is the page, from/to the `host_slice_id`-th slice of a host or staging array
+   * of the same slice size.
+   */
+  void CopyPageSliceAsync(const NDArray& device_array, int64_t page_id, const NDArray& host_array,
+                          int64_t host_slice_id, bool to_host) {
+    int64_t slice_numel = 1;
+    for (int i = 1; i < device_array->ndim; ++i) {
+      slice_numel *= device_array->shape[i];
+    }
+    int64_t slice_nbytes =
+        slice_numel * ((device_array->dtype.bits * device_array->dtype.lanes + 7) / 8);
+    DLTensor device_view = *device_array.operator->();
+    device_view.ndim = 1;
+    device_view.shape = &slice_numel;
+    device_view.strides = nullptr;
+    device_view.byte_offset += page_id * slice_nbytes;
+    DLTensor host_view = *host_array.operator->();
+    host_view.ndim = 1;
+    host_view.shape = &slice_numel;
+    host_view.strides = nullptr;
+    host_view.byte_offset += host_slice_id * slice_nbytes;
+    if (to_host) {
+      DeviceAPI::Get(device_)->CopyDataFromTo(&device_view, &host_view, copy_stream_);
+    } else {
+      DeviceAPI::Get(device_)->CopyDataFromTo(&host_view, &device_view, copy_stream_);
+    }
+  }
+
   bool ConstructTokenTreeMask(const std::vector<Sequence*>& sequences,
                               const IntTuple& token_tree_parent_ptr) {
     // We check if the token tree deteriorates to a chain,
@@ -2021,13 +2859,18 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     int32_t page_start_offset_after_sliding =
         (block.sliding_window_offset + length_to_slide) % page_size_;
 
-    // - Free the pages that are fully slidden.
-    while (page_idx_after_sliding > num_sink_pages) {
-      if (block.page_ids[num_sink_pages] != kPagedKVCacheTempPageId) {
-        free_page_ids_.push_back(block.page_ids[num_sink_pages]);
+    // - Free the pages that are fully slidden, and remove them from the block at once.
+    if (page_idx_after_sliding > num_sink_pages) {
+      auto slidden_begin = block.page_ids.begin() + num_sink_pages;
+      auto slidden_end = block.page_ids.begin() + page_idx_after_sliding;
+      for (auto it = slidden_begin; it != slidden_end; ++it) {
+        if (*it != kPagedKVCacheTempPageId) {
+          free_page_ids_.push_back(*it);
+          ++num_sliding_window_released_pages_;
+        }
       }
-      block.page_ids.erase(block.page_ids.begin() + num_sink_pages);
-      --page_idx_after_sliding;
+      block.page_ids.erase(slidden_begin, slidden_end);
+      page_idx_after_sliding = num_sink_pages;
     }
     // - The first sliding page after sliding is either the last sink page,
     // or the page next to the last sink page.
@@ -2073,11 +2916,13 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     int64_t tgt_npage = (block.seq_length - block.sink_length + block.sliding_window_offset +
                          append_length + page_size_ - 1) /
                         page_size_;
+    int64_t num_temp_pages = 0;
     for (int64_t page_idx = cur_npage; page_idx < tgt_npage; ++page_idx) {
       // When sliding window is enabled for the seq, we can "borrow temporary pages (-1)",
       // since the pages need to be slidden out might not have been released.
       if (free_page_ids_.empty() && seq->sliding_window_size != -1) {
         block.page_ids.push_back(kPagedKVCacheTempPageId);
+        ++num_temp_pages;
       } else {
         block.page_ids.push_back(GetFreePage());
       }
@@ -2087,10 +2932,15 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     // ==================== Slide ====================
     // Slide the sequences so that the pages exceed the sliding window are released.
     SlideWindowForSequence(seq);
-    for (int i = 0; i < static_cast<int>(block.page_ids.size()); ++i) {
-      if (block.page_ids[i] == kPagedKVCacheTempPageId) {
-        // Re-allocate the temporary pages after sliding window release.
-        block.page_ids[i] = GetFreePage();
+    if (num_temp_pages > 0) {
+      // Re-allocate the temporary pages after sliding window release. The temporary pages
+      // are among the new pages at the end of the block, unless they are slidden out.
+      int num_pages = block.page_ids.size();
+      for (int i = std::max(num_pages - static_cast<int>(tgt_npage - cur_npage), 0);
+           i < num_pages; ++i) {
+        if (block.page_ids[i] == kPagedKVCacheTempPageId) {
+          block.page_ids[i] = GetFreePage();
+        }
       }
     }
 
@@ -2239,6 +3089,19 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
   }
 
+  /*!
+   * \brief Invoke a function operating on the pages of the given layer,
+   * appending the dequantization scales of the layer when the pages are quantized.
+   */
+  template <typename... Args>
+  void CallPageFunc(const PackedFunc& f, int64_t local_layer_id, Args&&... args) {
+    if (page_scales_.empty()) {
+      f(std::forward<Args>(args)...);
+    } else {
+      f(std::forward<Args>(args)..., page_scales_[local_layer_id]);
+    }
+  }
+
   /*!
    * \brief Compute attention for between the input q data and the
    * input k/v data and the k/v data in cache on the given layer.
@@ -2254,7 +3117,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         !support_sliding_window_ ? f_attention_decode_ : f_attention_decode_sliding_window_;
     CHECK_GE(num_depths_, 1) << "The number of effective depths must be greater or equal to 1.";
     if (append_before_attn_) {
-      f_decode(
+      CallPageFunc(
+          f_decode, local_layer_id,
           /*depth=*/0, q_data, pages_[local_layer_id], page_indptr_on_depths_view_[0],
           page_indices_on_depths_view_[0], length_info_on_depths_view_[0],
           k_rope_pos_offset_view_[0], q_rope_position_map_view_, output, merged_attn_scores_view_,
@@ -2288,17 +3152,41 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         if (page_indices_on_depths_view_[d]->shape[0] == 0) {
           continue;
         }
-        if (use_decode_kernel_[d]) {
+        if (d == 0 && num_mixed_decode_seqs_ > 0) {
+          // The leading decode sequences of a mixed batch use the decode kernel,
+          // and the prefill chunks after them use the prefill kernel.
+          const MixedBatchViews& views = mixed_batch_views_;
+          NDArray decode_q_data = q_data.CreateView(
+              {num_mixed_decode_seqs_, q_data->shape[1], q_data->shape[2]}, q_data->dtype);
+          CallPageFunc(f_decode, local_layer_id,
+                       /*depth=*/0, decode_q_data, pages_[local_layer_id],
+                       views.decode_page_indptr, page_indices_on_depths_view_[0],
+                       views.decode_length_info, views.decode_k_rope_pos_offset,
+                       views.decode_q_rope_position_map, views.decode_attn_output,
+                       views.decode_attn_scores,
+                       /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_,
+                       rotary_theta_, attn_score_scaling_factor);
+          CallPageFunc(f_prefill, local_layer_id,
+                       /*depth=*/0, q_data, views.prefill_qo_indptr, pages_[local_layer_id],
+                       views.prefill_page_indptr, page_indices_on_depths_view_[0],
+                       views.prefill_length_info, views.prefill_k_rope_pos_offset,
+                       q_rope_position_map_view_, temp_attn_output_view_, temp_attn_scores_view_,
+                       /*causal=*/0,
+                       /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_,
+                       rotary_theta_, attn_score_scaling_factor);
+        } else if (use_decode_kernel_[d]) {
           // Use decode kernel for depth d
-          f_decode(/*depth=*/d, q_data, pages_[local_layer_id], page_indptr_on_depths_view_[d],
-                   page_indices_on_depths_view_[d], length_info_on_depths_view_[d],
-                   k_rope_pos_offset_view_[d], q_rope_position_map_view_, temp_attn_output_view_,
-                   temp_attn_scores_view_,
-                   /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_, rotary_theta_,
-                   attn_score_scaling_factor);
+          CallPageFunc(f_decode, local_layer_id,
+                       /*depth=*/d, q_data, pages_[local_layer_id], page_indptr_on_depths_view_[d],
+                       page_indices_on_depths_view_[d], length_info_on_depths_view_[d],
+                       k_rope_pos_offset_view_[d], q_rope_position_map_view_,
+                       temp_attn_output_view_, temp_attn_scores_view_,
+                       /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_,
+                       rotary_theta_, attn_score_scaling_factor);
         } else {
           // Use prefill kernel for depth d
-          f_prefill(
+          CallPageFunc(
+              f_prefill, local_layer_id,
               /*depth=*/d, q_data, qo_indptr_on_depths_view_[d], pages_[local_layer_id],
               page_indptr_on_depths_view_[d], page_indices_on_depths_view_[d],
               length_info_on_depths_view_[d], k_rope_pos_offset_view_[d], q_rope_position_map_view_,
@@ -2313,6 +3201,79 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
   }
 
+  /*!
+   * \brief Create an auxiliary data manager for attention.
+   * We only use the merged aux data for CUDA, since direct pointer
+   * operations may have issues on other platforms.
+   */
+  std::unique_ptr<PagedKVCacheAuxDataManager> CreateAuxDataManager() {
+    Device preferred_host_device = GetPreferredHostDevice(device_);
+    if (device_.device_type == DLDeviceType::kDLCUDA) {
+      return std::make_unique<CachedPagedKVCacheAuxDataManager>(
+          reserved_num_seqs_, num_total_pages_, prefill_chunk_size_, dtype_aux_, device_,
+          preferred_host_device, copy_stream_);
+    } else {
+      return std::make_unique<PlainPagedKVCacheAuxDataManager>(
+          reserved_num_seqs_, num_total_pages_, prefill_chunk_size_, dtype_aux_, device_,
+          preferred_host_device, copy_stream_);
+    }
+  }
+
+  /*! \brief Save the state of the current forward round that attention depends on. */
+  ForwardStepState SaveForwardStepState() const {
+    return ForwardStepState{cur_batch_size_,
+                            cur_seq_ids_,
+                            cur_append_lengths_,
+                            is_chain_,
+                            num_depths_,
+                            append_before_attn_,
+                            use_decode_kernel_,
+                            is_decode_request_,
+                            cur_append_length_indptr_view_,
+                            k_ragged_rope_pos_offset_view_,
+                            q_rope_position_map_view_,
+                            append_position_map_view_,
+                            tree_attn_mask_view_,
+                            tree_attn_mn_indptr_view_,
+                            temp_attn_output_view_,
+                            temp_attn_scores_view_,
+                            merged_attn_scores_view_,
+                            qo_indptr_on_depths_view_,
+                            page_indptr_on_depths_view_,
+                            page_indices_on_depths_view_,
+                            length_info_on_depths_view_,
+                            k_rope_pos_offset_view_};
+  }
+
+  /*! \brief Restore a saved forward round state, whose auxiliary data is on device. */
+  void LoadForwardStepState(const ForwardStepState& state) {
+    cur_batch_size_ = state.cur_batch_size;
+    cur_seq_ids_ = state.cur_seq_ids;
+    cur_append_lengths_ = state.cur_append_lengths;
+    is_chain_ = state.is_chain;
+    num_depths_ = state.num_depths;
+    append_before_attn_ = state.append_before_attn;
+    use_decode_kernel_ = state.use_decode_kernel;
+    is_decode_request_ = state.is_decode_request;
+    cur_append_length_indptr_view_ = state.cur_append_length_indptr_view;
+    k_ragged_rope_pos_offset_view_ = state.k_ragged_rope_pos_offset_view;
+    q_rope_position_map_view_ = state.q_rope_position_map_view;
+    append_position_map_view_ = state.append_position_map_view;
+    tree_attn_mask_view_ = state.tree_attn_mask_view;
+    tree_attn_mn_indptr_view_ = state.tree_attn_mn_indptr_view;
+    temp_attn_output_view_ = state.temp_attn_output_view;
+    temp_attn_scores_view_ = state.temp_attn_scores_view;
+    merged_attn_scores_view_ = state.merged_attn_scores_view;
+    qo_indptr_on_depths_view_ = state.qo_indptr_on_depths_view;
+    page_indptr_on_depths_view_ = state.page_indptr_on_depths_view;
+    page_indices_on_depths_view_ = state.page_indices_on_depths_view;
+    length_info_on_depths_view_ = state.length_info_on_depths_view;
+    k_rope_pos_offset_view_ = state.k_rope_pos_offset_view;
+    // Multi-step decode batches are never split.
+    num_mixed_decode_seqs_ = 0;
+    dirty_aux_data_device_ = false;
+  }
+
   /*! \brief Synchronize the copy stream and the compute stream. */
   void ComputeStreamWaitForCopyStream() {
     if (!dirty_aux_data_device_) {
@@ -2427,6 +3388,34 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         {total_append_length, num_qo_heads_}, temp_attn_scores_device_->dtype);
     merged_attn_scores_view_ = merged_attn_scores_device_.CreateView(
         {total_append_length, num_qo_heads_}, merged_attn_scores_device_->dtype);
+    // 12. Create views for the two parts of a split mixed batch.
+    if (num_mixed_decode_seqs_ > 0) {
+      int64_t num_decode = num_mixed_decode_seqs_;
+      int64_t num_prefill = num_sequences - num_decode;
+      int64_t decode_offset = num_decode * (dtype_aux_.bits / 8);
+      auto f_slice = [this](NDArray view, int64_t length, int64_t byte_offset) {
+        return view.CreateView({length}, dtype_aux_, byte_offset);
+      };
+      MixedBatchViews& views = mixed_batch_views_;
+      views.decode_page_indptr = f_slice(page_indptr_on_depths_view_[0], num_decode + 1, 0);
+      views.decode_length_info = f_slice(length_info_on_depths_view_[0], num_decode, 0);
+      views.decode_k_rope_pos_offset = f_slice(k_rope_pos_offset_view_[0], num_decode, 0);
+      views.decode_q_rope_position_map = f_slice(q_rope_position_map_view_, num_decode, 0);
+      views.decode_attn_output = temp_attn_output_device_.CreateView(
+          {num_decode, num_qo_heads_, head_dim_}, temp_attn_output_device_->dtype);
+      views.decode_attn_scores = temp_attn_scores_device_.CreateView(
+          {num_decode, num_qo_heads_}, temp_attn_scores_device_->dtype);
+      views.prefill_qo_indptr =
+          f_slice(qo_indptr_on_depths_view_[0], num_prefill + 1, decode_offset);
+      views.prefill_page_indptr =
+          f_slice(page_indptr_on_depths_view_[0], num_prefill + 1, decode_offset);
+      views.prefill_length_info =
+          f_slice(length_info_on_depths_view_[0], num_prefill, decode_offset);
+      views.prefill_k_rope_pos_offset =
+          f_slice(k_rope_pos_offset_view_[0], num_prefill, decode_offset);
+    } else {
+      mixed_batch_views_ = MixedBatchViews();
+    }
 
     // - Commit the copy.
     aux_data_manager_->CommitAttnAuxDataCopy();
@@ -2443,7 +3432,7 @@ TVM_REGISTER_OBJECT_TYPE(PagedAttentionKVCacheObj);
 
 TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
-      CHECK(args.size() == 25 || args.size() == 26 || args.size() == 27)
+      CHECK(args.size() >= 25 && args.size() <= 28)
           << "Invalid number of KV cache constructor args.";
       ShapeTuple cache_config = args[0];
       ShapeTuple layer_indptr_tuple = args[1];
@@ -2489,6 +3478,10 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
       if (args.size() >= 27) {
         f_attention_prefill_with_tree_mask = args[26].AsObjectRef<PackedFunc>();
       }
+      DLDataType kv_dtype = init->dtype;
+      if (args.size() >= 28) {
+        kv_dtype = args[27].operator DLDataType();
+      }
 
       CHECK_EQ(cache_config.size(), 5);
       int64_t reserved_num_seqs = cache_config[0];
@@ -2504,7 +3497,7 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
       ObjectPtr<PagedAttentionKVCacheObj> n = make_object<PagedAttentionKVCacheObj>(
           page_size, num_layers, layer_id_begin_offset, num_qo_heads, num_kv_heads, head_dim,
           reserved_num_seqs, num_total_pages, prefill_chunk_size, support_sliding_window,
-          RoPEMode(rope_mode), rotary_scale, rotary_theta, init->dtype, init->device,
+          RoPEMode(rope_mode), rotary_scale, rotary_theta, init->dtype, kv_dtype, init->device,
           std::move(f_transpose_append), std::move(f_compact_copy), std::move(f_attention_prefill),
           std::move(f_attention_decode), std::move(f_attention_prefill_sliding_window),
           std::move(f_attention_decode_sliding_window), std::move(f_attention_prefill_ragged),
@@ -2520,7 +3513,7 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
 
 TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
-      CHECK(args.size() == 19 || args.size() == 20 || args.size() == 21)
+      CHECK(args.size() >= 19 && args.size() <= 22)
           << "Invalid number of KV cache constructor args.";
       ShapeTuple cache_config = args[0];
       ShapeTuple layer_indptr_tuple = args[1];
@@ -2560,6 +3553,10 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
       if (args.size() >= 21) {
         f_attention_prefill_with_tree_mask = args[20].AsObjectRef<PackedFunc>();
       }
+      DLDataType kv_dtype = init->dtype;
+      if (args.size() >= 22) {
+        kv_dtype = args[21].operator DLDataType();
+      }
 
       CHECK_EQ(cache_config.size(), 5);
       int64_t reserved_num_seqs = cache_config[0];
@@ -2575,7 +3572,7 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
       ObjectPtr<PagedAttentionKVCacheObj> n = make_object<PagedAttentionKVCacheObj>(
           page_size, num_layers, layer_id_begin_offset, num_qo_heads, num_kv_heads, head_dim,
           reserved_num_seqs, num_total_pages, prefill_chunk_size, support_sliding_window,
-          RoPEMode(rope_mode), rotary_scale, rotary_theta, init->dtype, init->device,
+          RoPEMode(rope_mode), rotary_scale, rotary_theta, init->dtype, kv_dtype, init->device,
           std::move(f_transpose_append), std::move(f_compact_copy), std::move(f_attention_prefill),
           std::move(f_attention_decode), std::move(f_attention_prefill_sliding_window),
           std::move(f_attention_decode_sliding_window), std::move(f_attention_prefill_ragged),
@@ -0,0 +1,167 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/param_decode.h
+ * \brief Decoding kernels for the compressed parameter formats of NDArray cache.
+ *
+ * The kernels use the widest SIMD extension enabled at compile time and
+ * fall back to scalar code otherwise. The source pointer may be unaligned.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_PARAM_DECODE_H_
+#define TVM_RUNTIME_RELAX_VM_PARAM_DECODE_H_
+
+#include <builtin_fp16.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE2__) || defined(__AVX2__) || defined(__AVX512F__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Decode bfloat16 values into the bit patterns of float32.
+ * \param src The bfloat16 values.
+ * \param dst The output float32 bit patterns.
+ * \param n The number of values.
+ */
+inline void DecodeBF16ToF32(const uint16_t* src, uint32_t* dst, int64_t n) {
+  int64_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m512i y = _mm512_slli_epi32(_mm512_cvtepu16_epi32(x), 16);
+    _mm512_storeu_si512(reinterpret_cast<void*>(dst + i), y);
+  }
+#elif defined(__AVX2__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i lo = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(x)), 16);
+    __m256i hi = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1)), 16);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 8), hi);
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= n; i += 8) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Interleaving zeros below each 16-bit lane shifts it into the upper half.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(zero, x));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(zero, x));
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 8 <= n; i += 8) {
+    uint16x8_t x = vld1q_u16(src + i);
+    vst1q_u32(dst + i, vshll_n_u16(vget_low_u16(x), 16));
+    vst1q_u32(dst + i + 4, vshll_n_u16(vget_high_u16(x), 16));
+  }
+#endif
+  for (; i < n; ++i) {
+    uint16_t x;
+    std::memcpy(&x, src + i, sizeof(x));
+    dst[i] = static_cast<uint32_t>(x) << 16;
+  }
+}
+
+/*!
+ * \brief Decode IEEE half precision values into float32.
+ * \param src The float16 values.
+ * \param dst The output float32 values.
+ * \param n The number of values.
+ */
+inline void DecodeF16ToF32(const uint16_t* src, float* dst, int64_t n) {
+  int64_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(x));
+  }
+#elif defined(__F16C__) && defined(__AVX__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(x));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 4 <= n; i += 4) {
+    float16x4_t x = vreinterpret_f16_u16(vld1_u16(src + i));
+    vst1q_f32(dst + i, vcvt_f32_f16(x));
+  }
+#endif
+  for (; i < n; ++i) {
+    uint16_t x;
+    std::memcpy(&x, src + i, sizeof(x));
+    dst[i] = __extendXfYf2__<uint16_t, uint16_t, 10, float, uint32_t, 23>(x);
+  }
+}
+
+/*!
+ * \brief Whether a parameter format stores float32 values in a 16-bit encoding.
+ * \param format The format of the parameter record.
+ */
+inline bool IsF32EncodedFormat(const std::string& format) {
+  return format == "f32-to-bf16" || format == "f32-to-f16";
+}
+
+/*!
+ * \brief Decode 16-bit encoded float32 parameters, in parallel over the TVM thread pool.
+ * \param format The format of the parameter record, see IsF32EncodedFormat.
+ * \param src The encoded values, which may be unaligned.
+ * \param dst The output float32 buffer.
+ * \param n The number of values.
+ */
+inline void DecodeF32Param(const std::string& format, const void* src, void* dst, int64_t n) {
+  bool is_bf16 = format == "f32-to-bf16";
+  ICHECK(is_bf16 || format == "f32-to-f16") << "ValueError: Unknown encoding " << format;
+  const uint16_t* in = static_cast<const uint16_t*>(src);
+  // Small parameters are not worth the thread pool launch overhead.
+  constexpr int64_t kChunkSize = 1 << 16;
+  int64_t num_chunks = (n + kChunkSize - 1) / kChunkSize;
+  auto fdecode = [&](int64_t chunk) {
+    int64_t begin = chunk * kChunkSize;
+    int64_t len = std::min(kChunkSize, n - begin);
+    if (is_bf16) {
+      DecodeBF16ToF32(in + begin, static_cast<uint32_t*>(dst) + begin, len);
+    } else {
+      DecodeF16ToF32(in + begin, static_cast<float*>(dst) + begin, len);
+    }
+  };
+  if (num_chunks <= 1) {
+    if (num_chunks == 1) fdecode(0);
+    return;
+  }
+  parallel_for_with_threading_backend(fdecode, 0, num_chunks);
+}
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_PARAM_DECODE_H_
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/param_stream.cc
+ * \brief Runtime support to stream the lazily fetched parameters to the device.
+ *
+ * The parameters are copied to the device group by group, into two device slots used in turn,
+ * on a dedicated copy stream. The group after the one in use is copied while the current one is
+ * computed, so that only two groups of parameters occupy the device memory at any time. The
+ * copies are ordered with the computation by the stream synchronizations of the device API:
+ *  - a prefetch waits for the computation issued so far, which includes the last use of the
+ *    previous group in its slot;
+ *  - a wait makes the computation wait for the copies issued so far.
+ *
+ * The host arrays returned by `fget_param` are expected to be in pinned memory so that the copies
+ * run asynchronously.
+ */
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+using memory::Allocator;
+using memory::AllocatorType;
+using memory::MemoryManager;
+using memory::Storage;
+
+/*! \brief The state of streaming the lazily fetched parameters to a device. */
+class ParamStreamObj : public Object {
+ public:
+  explicit ParamStreamObj(PackedFunc fget_param, Device device, ShapeTuple slot_bytes)
+      : fget_param_(std::move(fget_param)),
+        device_(device),
+        slot_bytes_(std::move(slot_bytes)),
+        slots_(slot_bytes_.size()),
+        slot_params_(slot_bytes_.size()),
+        slot_host_params_(slot_bytes_.size()) {
+    copy_stream_ = DeviceAPI::Get(device_)->CreateStream(device_);
+  }
+
+  ~ParamStreamObj() {
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+      DeviceAPI::Get(device_)->FreeStream(device_, copy_stream_);
+    }
+  }
+
+  /*!
+   * \brief Copy a group of parameters into a slot, replacing the group previously in the slot.
+   * \param slot The slot to copy into.
+   * \param params The index, the name and the byte offset in the slot of each parameter.
+   */
+  void Prefetch(int64_t slot, const std::vector<std::tuple<int64_t, String, int64_t>>& params) {
+    CHECK(slot >= 0 && slot < static_cast<int64_t>(slots_.size()))
+        << "ValueError: The slot " << slot << " is out of the " << slots_.size() << " slots";
+    DeviceAPI* api = DeviceAPI::Get(device_);
+    if (!slots_[slot].defined()) {
+      Allocator* allocator = MemoryManager::GetOrCreateAllocator(device_, AllocatorType::kNaive);
+      memory::Buffer buffer = allocator->Alloc(device_, slot_bytes_[slot], kAllocAlignment,
+                                               DataType::UInt(8));
+      slots_[slot] = Storage(buffer, allocator);
+    }
+    for (int64_t index : slot_params_[slot]) {
+      params_.erase(index);
+    }
+    slot_params_[slot].clear();
+    slot_host_params_[slot].clear();
+    // The previous group in the slot may still be read by the computation issued so far
+    api->SyncStreamFromTo(device_, api->GetCurrentStream(device_), copy_stream_);
+    for (const auto& [index, name, offset] : params) {
+      NDArray host = fget_param_(index, name);
+      NDArray param = slots_[slot]->AllocNDArray(offset, host.Shape(), host->dtype);
+      NDArray::CopyFromTo(host.operator->(), const_cast<DLTensor*>(param.operator->()),
+                          copy_stream_);
+      params_[index] = param;
+      slot_params_[slot].push_back(index);
+      // The host array is kept alive at least until the slot is refilled
+      slot_host_params_[slot].push_back(host);
+    }
+  }
+
+  /*! \brief Make the computation wait for the copies issued so far. */
+  void Wait() {
+    DeviceAPI* api = DeviceAPI::Get(device_);
+    api->SyncStreamFromTo(device_, copy_stream_, api->GetCurrentStream(device_));
+  }
+
+  /*! \brief Get a parameter on the device, which must have been prefetched and waited for. */
+  NDArray Get(int64_t index) const {
+    auto it = params_.find(index);
+    CHECK(it != params_.end()) << "ValueError: The parameter " << index
+                               << " is not in the device slots";
+    return it->second;
+  }
+
+  static constexpr const char* _type_key = "relax.vm.ParamStream";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ParamStreamObj, Object);
+
+ private:
+  /*! \brief The function fetching a parameter on the host by its index and name. */
+  PackedFunc fget_param_;
+  /*! \brief The device that the parameters are streamed to. */
+  Device device_;
+  /*! \brief The number of bytes of each slot. */
+  ShapeTuple slot_bytes_;
+  /*! \brief The storage of each slot, allocated at the first use. */
+  std::vector<Storage> slots_;
+  /*! \brief The indices of the parameters in each slot. */
+  std::vector<std::vector<int64_t>> slot_params_;
+  /*! \brief The host arrays copied into each slot. */
+  std::vector<std::vector<NDArray>> slot_host_params_;
+  /*! \brief The parameters in the slots by their indices. */
+  std::unordered_map<int64_t, NDArray> params_;
+  /*! \brief The stream of the copies. */
+  TVMStreamHandle copy_stream_{nullptr};
+};
+
+class ParamStream : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(ParamStream, ObjectRef, ParamStreamObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(ParamStreamObj);
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_stream_create")
+    .set_body_typed([](void* ctx_ptr, PackedFunc fget_param, int64_t device_index,
+                       ShapeTuple slot_bytes) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(ctx_ptr);
+      CHECK(device_index >= 0 && device_index < static_cast<int64_t>(vm->devices.size()))
+          << "ValueError: The device index " << device_index
+          << " is out of VM physical devices list";
+      return ParamStream(make_object<ParamStreamObj>(std::move(fget_param),
+                                                     vm->devices[device_index],
+                                                     std::move(slot_bytes)));
+    });
+
+// The arguments are the stream, the slot, followed by the index, the name and the byte offset of
+// each parameter of the group.
+TVM_REGISTER_GLOBAL("vm.builtin.param_stream_prefetch").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK(args.size() >= 2 && args.size() % 3 == 2)
+      << "ValueError: vm.builtin.param_stream_prefetch expects the stream, the slot and the "
+         "(index, name, offset) of each parameter, but got "
+      << args.size() << " arguments";
+  ParamStream stream = args[0];
+  std::vector<std::tuple<int64_t, String, int64_t>> params;
+  for (int i = 2; i < args.size(); i += 3) {
+    params.emplace_back(args[i].operator int64_t(), args[i + 1].operator String(),
+                        args[i + 2].operator int64_t());
+  }
+  stream->Prefetch(args[1], params);
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_stream_wait").set_body_typed([](ParamStream stream) {
+  stream->Wait();
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_stream_get")
+    .set_body_typed([](ParamStream stream, int64_t index) { return stream->Get(index); });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
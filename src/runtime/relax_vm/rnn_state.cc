@@ -21,6 +21,8 @@
  * \brief Runtime RNN state object for space state models.
  */
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -40,28 +42,27 @@ class RNNStateImpObj : public RNNStateObj {
  private:
   /********************* Data Structures *********************/
 
+  /*! \brief A state of a sequence kept in a page of the storage. */
+  struct Checkpoint {
+    /*! \brief The page keeping the state. */
+    int32_t page;
+    /*! \brief The sequence length the state is taken at. */
+    int64_t seq_length;
+  };
+
   /*!
-   * \brief The sequence structure in paged KV cache with common prefix support.
-   * Each sequence contains one or more blocks to support common prefix.
+   * \brief The sequence structure in the paged space state storage.
+   * The checkpoints of a sequence may share pages with other sequences after forking,
+   * and a shared page is copied once a sequence writes its next state.
    */
   struct Sequence {
     /*! \brief The total sequence length of the sequence. */
     int64_t seq_length = 0;
-    /*! \brief The available history length for rolling back. */
-    int64_t available_history_num = 0;
-    /*! \brief The index of history slot in the storage. */
-    int64_t history_slot_id = 0;
-    /*! \brief The index of seq slot in the storage. */
-    int64_t seq_slot_id;
-
-    /*! \brief Constructor. */
-    explicit Sequence(int64_t seq_slot_id) : seq_slot_id(seq_slot_id) {}
-
-    static Sequence Fork(const Sequence& parent, int64_t seq_slot_id) {
-      Sequence child = parent;
-      child.seq_slot_id = seq_slot_id;
-      return child;
-    }
+    /*!
+     * \brief The checkpoints for rolling back, from the oldest to the current state,
+     * which is always the last one.
+     */
+    std::vector<Checkpoint> checkpoints;
   };
 
   /********************* Configuration *********************/
@@ -74,11 +75,18 @@ class RNNStateImpObj : public RNNStateObj {
   const int64_t num_states_per_layer_;
   /*! \brief The max history length for rolling back. */
   const int64_t max_history_ = 1;
+  /*!
+   * \brief The number of tokens between two checkpoints kept for rolling back. The states in
+   * between are released once the next state is written.
+   */
+  const int64_t checkpoint_interval_ = 1;
   /*!
    * \brief The init value for ALL layer in the storage.
    * The array has `num_states_per_layer_` NDArrays
    */
   const Array<NDArray> init_layer_value_;
+  /*! \brief The device of the storage. */
+  const Device device_;
 
   /*! \brief We fix int32 to be the index dtype of auxiliary data. */
   const DLDataType dtype_aux_ = DLDataType(DataType::Int(32, 1));
@@ -91,10 +99,17 @@ class RNNStateImpObj : public RNNStateObj {
    * each of them has layout `(num_seq, max_history, state_size)`.
    * \note As `num_states_per_layer_` may vary for different dtype and shape,
    * we use a 2D array to store the NDArrays for each layer.
+   * \note The storage is a pool of `num_seq * max_history` pages, page `p` being the slot
+   * `(p / max_history, p % max_history)` of all the NDArrays. The state kernels write the
+   * next state of a sequence to the page following the one they read in its slot row.
    */
   Array<Array<NDArray>> storages_;
-  /*! \brief The list of ids of released seq slot for reuse. */
-  std::vector<int64_t> free_slot_ids_;
+  /*! \brief The number of pages in the storage. */
+  const int64_t num_pages_;
+  /*! \brief The number of checkpoints referring to each page, 0 for the free pages. */
+  std::vector<int32_t> page_ref_counts_;
+  /*! \brief The page keeping the init value shared by the new sequences, -1 if none. */
+  int32_t init_page_ = -1;
   /*! \brief The mapping from sequence ids to sequences. */
   std::unordered_map<int64_t, Sequence> seq_map_;
 
@@ -106,6 +121,12 @@ class RNNStateImpObj : public RNNStateObj {
   IntTuple cur_append_lengths_;
   /*! \brief The sequence ids of the current round of forwarding. */
   IntTuple cur_seq_ids_;
+  /*! \brief The pages read in the current round of forwarding. */
+  std::vector<int32_t> cur_read_pages_;
+  /*! \brief The pages written in the current round of forwarding. */
+  std::vector<int32_t> cur_write_pages_;
+  /*! \brief Whether a round of forwarding begins and does not end yet. */
+  bool forward_pending_ = false;
 
   /**************** Auxiliary Arrays on Device *****************/
 
@@ -128,6 +149,13 @@ class RNNStateImpObj : public RNNStateObj {
    * The view is used to reuse the memory but with different shape.
    */
   NDArray history_slot_ids_view_;
+  /*!
+   * \brief The device arrays of the slots the pages are copied from and to,
+   * in the order of the arguments of the state getters and setters.
+   */
+  std::array<NDArray, 4> copy_slot_ids_device_;
+  /*! \brief The staging buffers of the page copies, one for each state of a layer. */
+  std::vector<NDArray> copy_buffers_;
 
   /******************* Interaction Functions *******************/
 
@@ -153,20 +181,26 @@ class RNNStateImpObj : public RNNStateObj {
 
  public:
   /*! \brief Constructor. Take the cache configuration and initialize the NDArrays. */
-  explicit RNNStateImpObj(int64_t num_layers,         //
-                          int64_t reserved_num_seqs,  //
-                          int64_t max_history,        //
-                          DLDevice device,            //
-                          Array<PackedFunc> f_gets,   //
-                          Array<PackedFunc> f_sets,   //
+  explicit RNNStateImpObj(int64_t num_layers,           //
+                          int64_t reserved_num_seqs,    //
+                          int64_t max_history,          //
+                          int64_t checkpoint_interval,  //
+                          DLDevice device,              //
+                          Array<PackedFunc> f_gets,     //
+                          Array<PackedFunc> f_sets,     //
                           Array<NDArray> init_layer_value)
       : num_layers_(num_layers),
         reserved_num_seqs_(reserved_num_seqs),
         num_states_per_layer_(init_layer_value.size()),
         max_history_(max_history),
+        checkpoint_interval_(checkpoint_interval),
         init_layer_value_(init_layer_value),
+        device_(device),
+        num_pages_(reserved_num_seqs * max_history),
         f_gets_(std::move(f_gets)),
         f_sets_(std::move(f_sets)) {
+    CHECK_GT(max_history_, 0) << "At least 1 history slot to store the current state";
+    CHECK_GT(checkpoint_interval_, 0) << "The checkpoint interval should be greater than 0.";
     // Allocate the storage for the space state models.
     storages_.reserve(num_layers_);
     for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
@@ -183,11 +217,13 @@ class RNNStateImpObj : public RNNStateObj {
       storages_.push_back(layer_storages);
     }
 
-    CHECK_GT(max_history_, 0) << "At least 1 history slot to store the current state";
-
     // Allocate the auxiliary arrays on device.
-    seq_slot_ids_device_ = NDArray::Empty({reserved_num_seqs}, dtype_aux_, device);
-    history_slot_ids_device_ = NDArray::Empty({reserved_num_seqs}, dtype_aux_, device);
+    seq_slot_ids_device_ = NDArray::Empty({num_pages_}, dtype_aux_, device);
+    history_slot_ids_device_ = NDArray::Empty({num_pages_}, dtype_aux_, device);
+    for (NDArray& slot_ids : copy_slot_ids_device_) {
+      slot_ids = NDArray::Empty({num_pages_}, dtype_aux_, device);
+    }
+    copy_buffers_.resize(num_states_per_layer_);
 
     Clear();
   }
@@ -196,10 +232,11 @@ class RNNStateImpObj : public RNNStateObj {
   void Clear() final {
     seq_map_.clear();
     ICHECK(!storages_.empty());
-    free_slot_ids_.clear();
-    for (int64_t slot_id = reserved_num_seqs_ - 1; slot_id >= 0; --slot_id) {
-      free_slot_ids_.push_back(slot_id);
-    }
+    page_ref_counts_.assign(num_pages_, 0);
+    init_page_ = -1;
+    cur_read_pages_.clear();
+    cur_write_pages_.clear();
+    forward_pending_ = false;
     dirty_aux_data_device_ = false;
   }
 
@@ -210,6 +247,8 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK_EQ(seq_ids.size(), append_lengths.size())
         << "The seq_ids size (" << seq_ids.size() << ") and append_lengths size ("
         << append_lengths.size() << ") mismatch.";
+    CHECK_LE(seq_ids.size(), num_pages_) << "The batch size " << seq_ids.size()
+                                         << " exceeds the number of pages " << num_pages_;
 
     if (opt_token_tree_parent_ptr.defined()) {
       IntTuple token_tree_parent_ptr = opt_token_tree_parent_ptr.value();
@@ -223,32 +262,91 @@ class RNNStateImpObj : public RNNStateObj {
         }
       }
     }
+    // The pages of a round of forwarding which did not end are dropped.
+    if (forward_pending_) {
+      for (int64_t i = 0; i < cur_batch_size_; ++i) {
+        if (cur_write_pages_[i] != cur_read_pages_[i]) ReleasePage(cur_write_pages_[i]);
+      }
+    }
     cur_batch_size_ = seq_ids.size();
     cur_append_lengths_ = append_lengths;
     cur_seq_ids_ = seq_ids;
 
-    if (dirty_aux_data_device_) {
-      SyncAuxArrayToDevice();
+    // Step 1. Pick the page each sequence writes its next state to. The state kernels write to
+    // the page following the current state, so a sequence whose next page is taken, e.g. by a
+    // sequence it is forked from, first copies its current state next to a pair of free pages.
+    cur_read_pages_.clear();
+    cur_write_pages_.clear();
+    std::vector<int32_t> copy_src_pages;
+    std::vector<int32_t> copy_dst_pages;
+    for (int64_t seq_id : cur_seq_ids_) {
+      auto it = seq_map_.find(seq_id);
+      CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
+                                  << "\" cannot be found in the space state storage.";
+      std::vector<Checkpoint>& checkpoints = it->second.checkpoints;
+      // Keep at most `max_history` states along with the next one.
+      int64_t max_checkpoints = std::max<int64_t>(max_history_ - 1, 1);
+      while (static_cast<int64_t>(checkpoints.size()) > max_checkpoints) {
+        ReleasePage(checkpoints.front().page);
+        checkpoints.erase(checkpoints.begin());
+      }
+      int32_t read_page = checkpoints.back().page;
+      int32_t write_page = NextPage(read_page);
+      bool writable = write_page == read_page ? page_ref_counts_[read_page] == 1
+                                              : page_ref_counts_[write_page] == 0;
+      if (!writable) {
+        int32_t copy_page = FindFreePage(/*with_free_next=*/true);
+        CHECK_GE(copy_page, 0) << "The space state storage is full, cannot fork the state of "
+                                  "sequence \""
+                               << seq_id << "\".";
+        copy_src_pages.push_back(read_page);
+        copy_dst_pages.push_back(copy_page);
+        RetainPage(copy_page);
+        ReleasePage(read_page);
+        checkpoints.back().page = copy_page;
+        read_page = copy_page;
+        write_page = NextPage(copy_page);
+      }
+      if (write_page != read_page) {
+        RetainPage(write_page);
+      } else if (read_page == init_page_) {
+        // The only history slot is overwritten in place.
+        init_page_ = -1;
+      }
+      cur_read_pages_.push_back(read_page);
+      cur_write_pages_.push_back(write_page);
     }
+    forward_pending_ = true;
+
+    // Step 2. Copy the shared states and send the pages to read to device.
+    if (!copy_src_pages.empty()) {
+      CopyPages(copy_src_pages, copy_dst_pages);
+    }
+    SyncAuxArrayToDevice();
   }
 
   void EndForward() final {
+    CHECK(forward_pending_) << "`EndForward` is called without `BeginForward`.";
     for (int64_t i = 0; i < cur_batch_size_; ++i) {
       int64_t seq_id = cur_seq_ids_[i];
-      int64_t seq_length = cur_append_lengths_[i];
       auto it = seq_map_.find(seq_id);
       CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
                                   << "\" cannot be found in the space state storage.";
-      it->second.seq_length += seq_length;
-      if (seq_length > 1) {
-        // We cannot rollback the prefill input
-        it->second.available_history_num = 0;
-      } else {
-        it->second.available_history_num =
-            std::min(it->second.available_history_num + 1, max_history_ - 1);
+      Sequence& seq = it->second;
+      seq.seq_length += cur_append_lengths_[i];
+      if (cur_write_pages_[i] == cur_read_pages_[i]) {
+        seq.checkpoints.back().seq_length = seq.seq_length;
+        continue;
+      }
+      seq.checkpoints.push_back(Checkpoint{cur_write_pages_[i], seq.seq_length});
+      // The state before is kept only if it is a checkpoint.
+      Checkpoint prev = seq.checkpoints[seq.checkpoints.size() - 2];
+      if (prev.seq_length % checkpoint_interval_ != 0) {
+        ReleasePage(prev.page);
+        seq.checkpoints.erase(seq.checkpoints.end() - 2);
       }
-      it->second.history_slot_id = (it->second.history_slot_id + 1) % max_history_;
     }
+    forward_pending_ = false;
     // TODO(Siyuan): We need to update history_slot_id_device_ (on device) as well.
     // There are two ways to do this:
     // 1. Update history_slot_id_device_ on device directly through a explict kernel
@@ -289,12 +387,10 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
                                 << "\" cannot be found in the space state storage.";
     NDArray state = storages_[layer_id][state_id];
-    int64_t seq_slot_id = it->second.seq_slot_id;
-    int64_t history_slot_id = it->second.history_slot_id;
 
     std::vector<int64_t> shape{state.Shape().begin() + 2, state.Shape().end()};
     NDArray result = NDArray::Empty(shape, state->dtype, state->device);
-    DLTensor copy_src = GetStatePtrBySeqHistory(layer_id, state_id, seq_slot_id, history_slot_id);
+    DLTensor copy_src = GetStatePtrByPage(layer_id, state_id, it->second.checkpoints.back().page);
     DLTensor copy_dst = *result.operator->();
 
     NDArray::CopyFromTo(&copy_src, &copy_dst);
@@ -306,18 +402,25 @@ class RNNStateImpObj : public RNNStateObj {
   void AddSequence(int64_t seq_id) final {
     CHECK(seq_map_.find(seq_id) == seq_map_.end())
         << "The sequence \"" << seq_id << "\" is already in the space state storage.";
-    int64_t seq_slot_id = GetFreeSlot();
-    seq_map_.insert({seq_id, Sequence(seq_slot_id)});
-
-    // Initialize the state data with the init value.
-    for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
-      for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
-        DLTensor dst =
-            GetStatePtrBySeqHistory(layer_id, state_id, seq_slot_id, /*history_slot_id=*/0);
-        NDArray init = init_layer_value_[state_id];
-        NDArray::CopyFromTo(init.operator->(), &dst);
+    // The new sequences share the page of the init value until they write their states.
+    if (init_page_ == -1) {
+      int32_t page = FindFreePage(/*with_free_next=*/true);
+      if (page == -1) page = FindFreePage(/*with_free_next=*/false);
+      CHECK_GE(page, 0) << "The space state storage is full, cannot accept new sequence.";
+      // Initialize the state data with the init value.
+      for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
+        for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
+          DLTensor dst = GetStatePtrByPage(layer_id, state_id, page);
+          NDArray init = init_layer_value_[state_id];
+          NDArray::CopyFromTo(init.operator->(), &dst);
+        }
       }
+      init_page_ = page;
     }
+    RetainPage(init_page_);
+    Sequence seq;
+    seq.checkpoints.push_back(Checkpoint{init_page_, 0});
+    seq_map_.insert({seq_id, std::move(seq)});
 
     dirty_aux_data_device_ = true;
   }
@@ -327,7 +430,9 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
                                 << "\" cannot be found in the space state storage.";
 
-    free_slot_ids_.push_back(it->second.seq_slot_id);
+    for (const Checkpoint& checkpoint : it->second.checkpoints) {
+      ReleasePage(checkpoint.page);
+    }
     seq_map_.erase(it);
 
     dirty_aux_data_device_ = true;
@@ -339,20 +444,32 @@ class RNNStateImpObj : public RNNStateObj {
                                        << "\" cannot be found in space state storage.";
     CHECK(seq_map_.find(child_seq_id) == seq_map_.end())
         << "The child sequence \"" << child_seq_id << "\" is already in the space state storage.";
-
-    // Create a child block with the parent block pointer.
-    int64_t child_slot_id = GetFreeSlot();
-    seq_map_.insert({child_seq_id, Sequence::Fork(parent_it->second, child_slot_id)});
-
-    // Copy the parent state data to the child state data.
-    int64_t parent_slot_id = parent_it->second.seq_slot_id;
-    for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
-      for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
-        DLTensor copy_src = GetStatePtrBySeq(layer_id, state_id, parent_slot_id);
-        DLTensor copy_dst = GetStatePtrBySeq(layer_id, state_id, child_slot_id);
-        NDArray::CopyFromTo(&copy_src, &copy_dst);
-      }
+    const Sequence& parent = parent_it->second;
+    if (fork_pos == -1) {
+      fork_pos = parent.seq_length;
+    }
+    CHECK(fork_pos >= 0 && fork_pos <= parent.seq_length)
+        << "The forking position " << fork_pos << " is out of the range [0, "
+        << parent.seq_length << "] of the parent sequence.";
+
+    // The child shares the checkpoints of the parent up to the forking position,
+    // which is copied on write.
+    Sequence child;
+    for (const Checkpoint& checkpoint : parent.checkpoints) {
+      if (checkpoint.seq_length > fork_pos) break;
+      child.checkpoints.push_back(checkpoint);
+    }
+    if (child.checkpoints.empty() || child.checkpoints.back().seq_length != fork_pos) {
+      CHECK_EQ(fork_pos, 0) << "The parent sequence \"" << parent_seq_id
+                            << "\" has no checkpoint at the forking position " << fork_pos;
+      AddSequence(child_seq_id);
+      return;
     }
+    for (const Checkpoint& checkpoint : child.checkpoints) {
+      RetainPage(checkpoint.page);
+    }
+    child.seq_length = fork_pos;
+    seq_map_.insert({child_seq_id, std::move(child)});
     dirty_aux_data_device_ = true;
   }
 
@@ -361,34 +478,87 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
                                 << "\" cannot be found in space state.";
     CHECK_GE(n, 0) << "The length of rolling back " << n << " cannot be negative.";
-    CHECK_LE(n, it->second.available_history_num)
-        << "The sequence only has " << it->second.available_history_num
-        << " available history in the space state storage, while the length of rollback is " << n
-        << " which exceeds the sequence length.";
-
-    it->second.seq_length -= n;
-    it->second.available_history_num -= n;
-    it->second.history_slot_id = (it->second.history_slot_id - n + max_history_) % max_history_;
+    Sequence& seq = it->second;
+    int64_t target_length = seq.seq_length - n;
+    bool found = std::any_of(
+        seq.checkpoints.begin(), seq.checkpoints.end(),
+        [target_length](const Checkpoint& checkpoint) {
+          return checkpoint.seq_length == target_length;
+        });
+    CHECK(found) << "The sequence has no checkpoint in the space state storage at length "
+                 << target_length << " to roll back " << n
+                 << " tokens to. Use `rnn_state_rollback_to_checkpoint` to roll back to the "
+                    "closest checkpoint before.";
+    RollbackToCheckpoint(seq_id, n);
+  }
+
+  int64_t RollbackToCheckpoint(int64_t seq_id, int64_t n) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
+                                << "\" cannot be found in space state.";
+    CHECK_GE(n, 0) << "The length of rolling back " << n << " cannot be negative.";
+    Sequence& seq = it->second;
+    int64_t target_length = seq.seq_length - n;
+    CHECK(target_length >= seq.checkpoints.front().seq_length)
+        << "The oldest checkpoint of the sequence in the space state storage is at length "
+        << seq.checkpoints.front().seq_length << ", while the length of rollback is " << n
+        << " which exceeds the history.";
+    while (seq.checkpoints.back().seq_length > target_length) {
+      ReleasePage(seq.checkpoints.back().page);
+      seq.checkpoints.pop_back();
+    }
+    seq.seq_length = seq.checkpoints.back().seq_length;
     dirty_aux_data_device_ = true;
+    return target_length - seq.seq_length;
   }
 
  private:
-  /*! \brief Get a new free block and return its index. */
-  int32_t GetFreeSlot() {
-    CHECK(!free_slot_ids_.empty()) << "The Sequence slot is full, cannot accept new sequence.";
-    int32_t seq_slot_id = free_slot_ids_.back();
-    free_slot_ids_.pop_back();
-    return seq_slot_id;
+  /*! \brief The page the state kernels write the next state to, after reading a page. */
+  int32_t NextPage(int32_t page) const {
+    int32_t history_slot_id = page % max_history_;
+    return page - history_slot_id + (history_slot_id + 1) % max_history_;
+  }
+
+  /*!
+   * \brief Find a free page.
+   * \param with_free_next Whether the next page of the page is required to be free as well,
+   * so that a state copied to the page can be written next.
+   * \return The page, or -1 if there is none.
+   */
+  int32_t FindFreePage(bool with_free_next) const {
+    // Prefer a free slot row, along which a sequence writes its states without copying.
+    for (int32_t row_begin = 0; row_begin < num_pages_; row_begin += max_history_) {
+      auto row_it = page_ref_counts_.begin() + row_begin;
+      if (std::all_of(row_it, row_it + max_history_, [](int32_t count) { return count == 0; })) {
+        return row_begin;
+      }
+    }
+    for (int32_t page = 0; page < num_pages_; ++page) {
+      if (page_ref_counts_[page] != 0) continue;
+      int32_t next_page = NextPage(page);
+      if (!with_free_next || next_page == page || page_ref_counts_[next_page] == 0) {
+        return page;
+      }
+    }
+    return -1;
+  }
+
+  void RetainPage(int32_t page) { ++page_ref_counts_[page]; }
+
+  void ReleasePage(int32_t page) {
+    ICHECK_GT(page_ref_counts_[page], 0);
+    if (--page_ref_counts_[page] == 0 && page == init_page_) {
+      init_page_ = -1;
+    }
   }
 
-  DLTensor GetStatePtrBySeqHistory(int64_t layer_id, int64_t state_id, int64_t seq_slot_id,
-                                   int64_t history_slot_id) {
+  DLTensor GetStatePtrByPage(int64_t layer_id, int64_t state_id, int64_t page) {
     NDArray state = storages_[layer_id][state_id];
     int64_t state_size = 1;
     for (int64_t i = 2; i < state->ndim; ++i) {
       state_size *= state->shape[i];
     }
-    int64_t elem_offset = (seq_slot_id * max_history_ + history_slot_id) * state_size;
+    int64_t elem_offset = page * state_size;
     // Create a new DLTensor with the same shape and dtype as the state.
     DLTensor _state = *(state.operator->());
     _state.byte_offset = elem_offset * state->dtype.bits / 8;
@@ -397,19 +567,57 @@ class RNNStateImpObj : public RNNStateObj {
     return _state;
   }
 
-  DLTensor GetStatePtrBySeq(int64_t layer_id, int64_t state_id, int64_t seq_slot_id) {
-    NDArray state = storages_[layer_id][state_id];
-    int64_t state_size = 1;
-    for (int64_t i = 1; i < state->ndim; ++i) {
-      state_size *= state->shape[i];
+  /*! \brief Copy a host vector to the beginning of a device array, and return the view. */
+  NDArray CopyVecToDevice(NDArray array, const std::vector<int32_t>& vec_data) {
+    NDArray view = array.CreateView({static_cast<int64_t>(vec_data.size())}, dtype_aux_);
+    DLTensor copy_dst = *view.operator->();
+    DLTensor copy_src;
+    copy_src.data = const_cast<int32_t*>(vec_data.data());
+    copy_src.device = Device{kDLCPU, 0};
+    copy_src.ndim = 1;
+    copy_src.dtype = view->dtype;
+    copy_src.shape = view->shape;
+    copy_src.strides = nullptr;
+    copy_src.byte_offset = 0;
+    NDArray::CopyFromTo(&copy_src, &copy_dst);
+    return view;
+  }
+
+  /*!
+   * \brief Copy the states of pages to other pages for all the layers, by gathering them with
+   * the state getters and scattering them with the state setters.
+   */
+  void CopyPages(const std::vector<int32_t>& src_pages, const std::vector<int32_t>& dst_pages) {
+    int64_t num_copies = src_pages.size();
+    std::array<std::vector<int32_t>, 4> slot_ids;
+    for (int64_t i = 0; i < num_copies; ++i) {
+      slot_ids[0].push_back(src_pages[i] / max_history_);
+      slot_ids[1].push_back(src_pages[i] % max_history_);
+      // The setters write to the history slot after the given one.
+      slot_ids[2].push_back(dst_pages[i] / max_history_);
+      slot_ids[3].push_back((dst_pages[i] % max_history_ + max_history_ - 1) % max_history_);
+    }
+    std::array<NDArray, 4> slot_ids_view;
+    for (int i = 0; i < 4; ++i) {
+      slot_ids_view[i] = CopyVecToDevice(copy_slot_ids_device_[i], slot_ids[i]);
+    }
+    for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
+      ShapeTuple state_shape = init_layer_value_[state_id].Shape();
+      NDArray& buffer = copy_buffers_[state_id];
+      if (!buffer.defined() || buffer->shape[0] < num_copies) {
+        std::vector<int64_t> buffer_shape{std::max(num_copies, reserved_num_seqs_)};
+        buffer_shape.insert(buffer_shape.end(), state_shape.begin(), state_shape.end());
+        buffer = NDArray::Empty(buffer_shape, init_layer_value_[state_id].DataType(), device_);
+      }
+      std::vector<int64_t> view_shape{num_copies};
+      view_shape.insert(view_shape.end(), state_shape.begin(), state_shape.end());
+      NDArray buffer_view = buffer.CreateView(view_shape, buffer->dtype);
+      for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
+        NDArray state = storages_[layer_id][state_id];
+        f_gets_[state_id](state, slot_ids_view[0], slot_ids_view[1], buffer_view);
+        f_sets_[state_id](state, slot_ids_view[2], slot_ids_view[3], buffer_view);
+      }
     }
-    int64_t elem_offset = seq_slot_id * state_size;
-    // Create a new DLTensor with the same shape and dtype as the state.
-    DLTensor _state = *(state.operator->());
-    _state.byte_offset = elem_offset * state->dtype.bits / 8;
-    _state.ndim = state->ndim - 1;
-    _state.shape = const_cast<int64_t*>(_state.shape + 1);
-    return _state;
   }
 
   /*!
@@ -418,36 +626,16 @@ class RNNStateImpObj : public RNNStateObj {
    * invoked before running attention computation on device.
    */
   void SyncAuxArrayToDevice() {
-    auto fcopy_from_vec = [](NDArray array, std::vector<int32_t> vec_data) {
-      DLTensor copy_dst = *array.operator->();
-      DLTensor copy_src;
-      copy_src.data = vec_data.data();
-      copy_src.device = Device{kDLCPU, 0};
-      copy_src.ndim = 1;
-      copy_src.dtype = array->dtype;
-      copy_src.shape = array->shape;
-      copy_src.strides = nullptr;
-      copy_src.byte_offset = 0;
-      NDArray::CopyFromTo(&copy_src, &copy_dst);
-    };
-
     std::vector<int32_t> seq_slot_ids;
     std::vector<int32_t> history_slot_ids;
     seq_slot_ids.reserve(cur_batch_size_);
     history_slot_ids.reserve(cur_batch_size_);
-    for (int64_t seq_id : cur_seq_ids_) {
-      auto it = seq_map_.find(seq_id);
-      CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
-                                  << "\" cannot be found in the space state storage.";
-      const Sequence& seq = it->second;
-      seq_slot_ids.push_back(seq.seq_slot_id);
-      history_slot_ids.push_back(seq.history_slot_id);
+    for (int32_t page : cur_read_pages_) {
+      seq_slot_ids.push_back(page / max_history_);
+      history_slot_ids.push_back(page % max_history_);
     }
-    seq_slot_ids_view_ = seq_slot_ids_device_.CreateView({cur_batch_size_}, dtype_aux_);
-    history_slot_ids_view_ = history_slot_ids_device_.CreateView({cur_batch_size_}, dtype_aux_);
-
-    fcopy_from_vec(seq_slot_ids_view_, seq_slot_ids);
-    fcopy_from_vec(history_slot_ids_view_, history_slot_ids);
+    seq_slot_ids_view_ = CopyVecToDevice(seq_slot_ids_device_, seq_slot_ids);
+    history_slot_ids_view_ = CopyVecToDevice(history_slot_ids_device_, history_slot_ids);
 
     // Reset the dirty flag to false.
     dirty_aux_data_device_ = false;
@@ -465,36 +653,40 @@ TVM_REGISTER_OBJECT_TYPE(RNNStateImpObj);
 //  Register runtime functions
 //-------------------------------------------------
 
-TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_create")
-    .set_body_typed([](int64_t num_layers,         //
-                       int64_t reserved_num_seqs,  //
-                       int64_t max_history,        //
-                       Array<PackedFunc> f_gets,   //
-                       Array<PackedFunc> f_sets,   //
-                       Array<NDArray> init_layer_value) {
-      CHECK_GT(num_layers, 0) << "The number of layers should be greater than 0.";
-      CHECK_GT(reserved_num_seqs, 0)
-          << "The number of reserved sequences should be greater than 0.";
-      CHECK_GE(max_history, 0) << "The maximum history length should be greater or equal than 0.";
-      CHECK_GT(init_layer_value.size(), 0)
-          << "The number of states per layer should be greater than 0.";
-      Device device = init_layer_value[0]->device;
-      for (const NDArray& state : init_layer_value) {
-        CHECK(state->device.device_type == device.device_type &&
-              state->device.device_id == device.device_id)
-            << "The device type of all states should be the same.";
-      }
-      CHECK_EQ(f_gets.size(), init_layer_value.size())
-          << "The number of state getters should be the same as the number of states per layer, "
-          << "but got " << f_gets.size() << " and " << init_layer_value.size() << " respectively.";
-      CHECK_EQ(f_sets.size(), init_layer_value.size())
-          << "The number of state setters should be the same as the number of states per layer, "
-          << "but got " << f_sets.size() << " and " << init_layer_value.size() << " respectively.";
-      ObjectPtr<RNNStateImpObj> n =
-          make_object<RNNStateImpObj>(num_layers, reserved_num_seqs, max_history, device,
-                                      std::move(f_gets), std::move(f_sets), init_layer_value);
-      return RNNState(std::move(n));
-    });
+TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_create").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK(args.size() == 6 || args.size() == 7) << "Invalid number of RNN state constructor args.";
+  int64_t num_layers = args[0];
+  int64_t reserved_num_seqs = args[1];
+  int64_t max_history = args[2];
+  Array<PackedFunc> f_gets = args[3];
+  Array<PackedFunc> f_sets = args[4];
+  Array<NDArray> init_layer_value = args[5];
+  int64_t checkpoint_interval = 1;
+  if (args.size() == 7) {
+    checkpoint_interval = args[6];
+  }
+  CHECK_GT(num_layers, 0) << "The number of layers should be greater than 0.";
+  CHECK_GT(reserved_num_seqs, 0) << "The number of reserved sequences should be greater than 0.";
+  CHECK_GE(max_history, 0) << "The maximum history length should be greater or equal than 0.";
+  CHECK_GT(init_layer_value.size(), 0)
+      << "The number of states per layer should be greater than 0.";
+  Device device = init_layer_value[0]->device;
+  for (const NDArray& state : init_layer_value) {
+    CHECK(state->device.device_type == device.device_type &&
+          state->device.device_id == device.device_id)
+        << "The device type of all states should be the same.";
+  }
+  CHECK_EQ(f_gets.size(), init_layer_value.size())
+      << "The number of state getters should be the same as the number of states per layer, "
+      << "but got " << f_gets.size() << " and " << init_layer_value.size() << " respectively.";
+  CHECK_EQ(f_sets.size(), init_layer_value.size())
+      << "The number of state setters should be the same as the number of states per layer, "
+      << "but got " << f_sets.size() << " and " << init_layer_value.size() << " respectively.";
+  ObjectPtr<RNNStateImpObj> n = make_object<RNNStateImpObj>(
+      num_layers, reserved_num_seqs, max_history, checkpoint_interval, device, std::move(f_gets),
+      std::move(f_sets), init_layer_value);
+  *rv = RNNState(std::move(n));
+});
 
 }  // namespace relax_vm
 }  // namespace runtime
@@ -21,19 +21,119 @@
  * \file src/runtime/relax_vm/vm.cc
  */
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/relax_vm/vm.h>
-
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <sstream>
 #include <thread>
+#include <vector>
+
+#include "../../support/str_escape.h"
+#include "../sampling_profiler.h"
+#include "../trace_recorder.h"
 
 namespace tvm {
 namespace runtime {
 namespace relax_vm {
 
+//---------------------------------------------
+// Call argument arena
+//---------------------------------------------
+/*!
+ * \brief A bump-pointer arena for the temporary buffers of VM calls.
+ *
+ * The buffers are released in LIFO order by Scope, which restores the bump
+ * pointer on exit, so the nested calls of an invocation reuse the blocks kept
+ * by the arena instead of going through the system allocator. When the
+ * top-level invocation exits, the blocks are merged into one that fits all of
+ * it, so the next invocation does not need to grow the arena again.
+ */
+class CallArgArena {
+ public:
+  /*! \brief RAII scope releasing the buffers allocated within it. */
+  class Scope {
+   public:
+    explicit Scope(CallArgArena* arena)
+        : arena_(arena), block_(arena->block_), offset_(arena->offset_) {}
+    ~Scope() { arena_->Release(block_, offset_); }
+
+   private:
+    CallArgArena* arena_;
+    size_t block_;
+    size_t offset_;
+  };
+
+  /*!
+   * \brief Allocate uninitialized space for count objects of type T.
+   * \param count The number of objects.
+   * \return The allocated space, valid until the enclosing scope exits.
+   */
+  template <typename T>
+  T* Alloc(size_t count) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Too large alignment");
+    size_t nbytes = sizeof(T) * count;
+    size_t offset = (offset_ + alignof(T) - 1) / alignof(T) * alignof(T);
+    if (blocks_.empty() || offset + nbytes > blocks_[block_].size) {
+      NextBlock(nbytes);
+      offset = 0;
+    }
+    offset_ = offset + nbytes;
+    return reinterpret_cast<T*>(blocks_[block_].data.get() + offset);
+  }
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  static constexpr size_t kMinBlockSize = 4096;
+
+  void NextBlock(size_t nbytes) {
+    // The blocks after the current one are free, reuse the next one if it fits.
+    size_t next = blocks_.empty() ? 0 : block_ + 1;
+    if (next < blocks_.size() && blocks_[next].size >= nbytes) {
+      block_ = next;
+      return;
+    }
+    size_t size = std::max(kMinBlockSize, nbytes);
+    if (!blocks_.empty()) size = std::max(size, blocks_[block_].size * 2);
+    blocks_.insert(blocks_.begin() + next, Block{std::make_unique<char[]>(size), size});
+    block_ = next;
+  }
+
+  void Release(size_t block, size_t offset) {
+    block_ = block;
+    offset_ = offset;
+    if (block == 0 && offset == 0 && blocks_.size() > 1) {
+      size_t total = 0;
+      for (const Block& b : blocks_) total += b.size;
+      blocks_.clear();
+      blocks_.push_back(Block{std::make_unique<char[]>(total), total});
+    }
+  }
+
+  std::vector<Block> blocks_;
+  /*! \brief The block the next buffer is allocated from. */
+  size_t block_{0};
+  /*! \brief The bump pointer inside the current block. */
+  size_t offset_{0};
+};
+
 //---------------------------------------------
 // VM Closure object
 //---------------------------------------------
@@ -54,18 +154,123 @@ VMClosure::VMClosure(String func_name, PackedFunc impl) {
  */
 PackedFunc VMClosure::BindLastArgs(PackedFunc func, std::vector<TVMRetValue> last_args) {
   return PackedFunc([func, last_args](TVMArgs args, TVMRetValue* rv) {
-    std::vector<TVMValue> values(args.size() + last_args.size());
-    std::vector<int> tcodes(args.size() + last_args.size());
-    runtime::TVMArgsSetter setter(values.data(), tcodes.data());
-    std::copy(args.values, args.values + args.size(), values.data());
-    std::copy(args.type_codes, args.type_codes + args.size(), tcodes.data());
+    // The bound function is not tied to a VM instance, so it uses an arena per thread.
+    static thread_local CallArgArena arena;
+    CallArgArena::Scope arena_scope(&arena);
+    int num_args = args.size() + last_args.size();
+    TVMValue* values = arena.Alloc<TVMValue>(num_args);
+    int* tcodes = arena.Alloc<int>(num_args);
+    runtime::TVMArgsSetter setter(values, tcodes);
+    std::copy(args.values, args.values + args.size(), values);
+    std::copy(args.type_codes, args.type_codes + args.size(), tcodes);
     for (size_t i = 0; i < last_args.size(); ++i) {
       setter(i + args.size(), last_args[i]);
     }
-    func.CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), rv);
+    func.CallPacked(TVMArgs(values, tcodes, num_args), rv);
   });
 }
 
+//---------------------------------------------
+// VM Future object
+//---------------------------------------------
+TVM_REGISTER_OBJECT_TYPE(VMFutureObj);
+
+bool VMFutureObj::IsDone() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return done_;
+}
+
+TVMRetValue VMFutureObj::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return done_; });
+  if (error_) std::rethrow_exception(error_);
+  if (!stream_synced_) {
+    DeviceAPI::Get(device)->StreamSync(device, stream);
+    stream_synced_ = true;
+  }
+  return value_;
+}
+
+void VMFutureObj::SetValue(TVMRetValue value) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    value_ = std::move(value);
+    done_ = true;
+  }
+  cv_.notify_all();
+}
+
+void VMFutureObj::SetError(std::exception_ptr error) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = error;
+    done_ = true;
+  }
+  cv_.notify_all();
+}
+
+TVM_REGISTER_GLOBAL("relax.VMFutureWait").set_body_typed([](VMFuture future) {
+  return future->Wait();
+});
+
+TVM_REGISTER_GLOBAL("relax.VMFutureIsDone").set_body_typed([](VMFuture future) {
+  return future->IsDone();
+});
+
+/*!
+ * \brief A thread that runs the asynchronous invocations of a VM in FIFO order.
+ *
+ * The destructor runs the queued invocations before joining the thread, so
+ * every future handed out is finished.
+ */
+class AsyncWorker {
+ public:
+  AsyncWorker() : thread_([this] { this->Run(); }) {}
+
+  ~AsyncWorker() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  /*!
+   * \brief Queue a task.
+   * \param task The task, which must not throw.
+   */
+  void Push(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void Run() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) return;
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_{false};
+  // Declared last so that it starts after the other members are constructed.
+  std::thread thread_;
+};
+
 //-----------------------------------------------------------
 // Utility functions.
 //-----------------------------------------------------------
@@ -207,6 +412,9 @@ class VirtualMachineImpl : public VirtualMachine {
   void InvokeClosurePacked(const ObjectRef& closure_or_packedfunc, TVMArgs args,
                            TVMRetValue* rv) final;
   void SetInstrument(PackedFunc instrument) final { this->instrument_ = instrument; }
+  ObjectPtr<VirtualMachine> CreateContext() final;
+  VMFuture InvokeClosureAsync(const ObjectRef& closure_or_packedfunc, TVMArgs args,
+                              TVMStreamHandle stream) final;
 
   //---------------------------------------------------
   // Functions in the vtable of Module
@@ -215,7 +423,16 @@ class VirtualMachineImpl : public VirtualMachine {
   void _SaveClosure(TVMArgs args, TVMRetValue* rv);
   void _InvokeClosure(TVMArgs args, TVMRetValue* rv);
   void _InvokeClosureStateful(std::string func_name);
+  void _SetOutputZeroCopy(std::string func_name, int index, NDArray arr);
+  void _ClearOutputZeroCopy(std::string func_name);
+  void _InvokeAsync(TVMArgs args, TVMRetValue* rv);
   void _SetInstrument(TVMArgs args, TVMRetValue* rv);
+  void _SetThreadPool(std::string name);
+  Module _CreateContext();
+  void _StartTrace();
+  void _StopTrace();
+  std::string _GetTraceReport();
+  std::string _GetChromeTrace();
   void _GetOutputArity(TVMArgs args, TVMRetValue* rv);
   void _GetOutput(TVMArgs args, TVMRetValue* rv);
   void _SetInputWithoutParamModule(TVMArgs args, TVMRetValue* rv);
@@ -229,7 +446,16 @@ class VirtualMachineImpl : public VirtualMachine {
   TVM_MODULE_VTABLE_ENTRY_PACKED("save_function", &VirtualMachineImpl::_SaveClosure);
   TVM_MODULE_VTABLE_ENTRY_PACKED("invoke_closure", &VirtualMachineImpl::_InvokeClosure);
   TVM_MODULE_VTABLE_ENTRY("invoke_stateful", &VirtualMachineImpl::_InvokeClosureStateful);
+  TVM_MODULE_VTABLE_ENTRY("set_output_zero_copy", &VirtualMachineImpl::_SetOutputZeroCopy);
+  TVM_MODULE_VTABLE_ENTRY("clear_output_zero_copy", &VirtualMachineImpl::_ClearOutputZeroCopy);
+  TVM_MODULE_VTABLE_ENTRY_PACKED("invoke_async", &VirtualMachineImpl::_InvokeAsync);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_instrument", &VirtualMachineImpl::_SetInstrument);
+  TVM_MODULE_VTABLE_ENTRY("set_thread_pool", &VirtualMachineImpl::_SetThreadPool);
+  TVM_MODULE_VTABLE_ENTRY("create_context", &VirtualMachineImpl::_CreateContext);
+  TVM_MODULE_VTABLE_ENTRY("start_trace", &VirtualMachineImpl::_StartTrace);
+  TVM_MODULE_VTABLE_ENTRY("stop_trace", &VirtualMachineImpl::_StopTrace);
+  TVM_MODULE_VTABLE_ENTRY("get_trace_report", &VirtualMachineImpl::_GetTraceReport);
+  TVM_MODULE_VTABLE_ENTRY("get_chrome_trace", &VirtualMachineImpl::_GetChromeTrace);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output_arity", &VirtualMachineImpl::_GetOutputArity);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output", &VirtualMachineImpl::_GetOutput);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_input", &VirtualMachineImpl::_SetInputWithoutParamModule);
@@ -304,7 +530,7 @@ class VirtualMachineImpl : public VirtualMachine {
    * \param args The arguments to the function.
    * \return The object representing the result.
    */
-  RegType InvokeBytecode(Index fidx, const std::vector<RegType>& args);
+  RegType InvokeBytecode(Index fidx, TVMArgs args);
 
  protected:
   /*!
@@ -400,9 +626,126 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   virtual void RunInstrCall(VMFrame* curr_frame, Instruction inst);
 
+  /*!
+   * \brief Run call instruction and record it in the execution trace.
+   * \param curr_frame The current frame.
+   * \param inst The call instruction.
+   */
+  void RunInstrCallTraced(VMFrame* curr_frame, Instruction inst);
+
+  /*!
+   * \brief Run call instruction and record it as a sample of the sampling profiler.
+   * \param curr_frame The current frame.
+   * \param inst The call instruction.
+   */
+  void RunInstrCallSampled(VMFrame* curr_frame, Instruction inst);
+
+  /*!
+   * \brief Run call instruction and record it on the trace of the process.
+   * \param curr_frame The current frame.
+   * \param inst The call instruction.
+   */
+  void RunInstrCallRecorded(VMFrame* curr_frame, Instruction inst);
+
+  /*!
+   * \brief Get the device a call instruction runs on.
+   * \param curr_frame The current frame.
+   * \param inst The call instruction.
+   * \return The device of the tensor arguments, CPU if there is none.
+   */
+  Device GetCallDevice(VMFrame* curr_frame, Instruction inst);
+
   /*! \brief Run VM dispatch loop. */
   void RunLoop();
 
+  //-------------------------------------------------
+  // Pre-decoded execution.
+  //-------------------------------------------------
+  /*! \brief The opcodes of the pre-decoded program. */
+  enum class DecodedOp : uint8_t {
+    kCall = 0,
+    /*! \brief vm.builtin.alloc_tensor followed by another call, run with one dispatch. */
+    kAllocTensorCall = 1,
+    /*! \brief vm.builtin.alloc_tensor of a function output, which can be bound by the user. */
+    kOutputAllocTensor = 2,
+    kRet = 3,
+    kGoto = 4,
+    kIf = 5,
+    /*! \brief Sentinel past the last instruction. */
+    kInvalid = 6,
+  };
+  /*! \brief A call instruction whose arguments are resolved ahead of time. */
+  struct DecodedCall {
+    /*! \brief The destination register. */
+    RegName dst;
+    /*! \brief The index into the function pool. */
+    Index func_idx;
+    /*! \brief The callee if it is a PackedFunc, which is called directly. */
+    const PackedFuncObj* packed;
+    /*! \brief The direct call of the callee if it is a typed global function. */
+    DirectCall direct;
+    /*! \brief The offset of the argument template in VMProgram::decoded_arg_values/tcodes. */
+    size_t arg_begin;
+    /*! \brief The number of arguments. */
+    int num_args;
+    /*! \brief The offset of the register arguments in VMProgram::decoded_reg_args. */
+    size_t reg_arg_begin;
+    /*! \brief The number of register arguments. */
+    int num_reg_args;
+  };
+  /*! \brief An argument read from a register at run time. */
+  struct DecodedRegArg {
+    /*! \brief The position of the argument. */
+    int arg_index;
+    /*! \brief The register to read. */
+    RegName reg;
+  };
+  /*! \brief A pre-decoded instruction, at the same index as the bytecode instruction. */
+  struct DecodedInstr {
+    DecodedOp op;
+    /*! \brief Index into VMProgram::decoded_calls for calls. */
+    uint32_t call;
+    /*! \brief The result register of Ret, or the condition register of If. */
+    RegName reg;
+    /*! \brief The pc offset of Goto, the false offset of If, or the output index of
+     *  OutputAllocTensor. */
+    Index offset;
+  };
+
+  /*!
+   * \brief Decode the bytecode into the form run by RunDecodedLoop.
+   *
+   * Constants, function pool entries, immediates and special registers
+   * are resolved into per-call argument templates, so only the register
+   * arguments are filled in at run time.
+   */
+  void DecodeProgram();
+
+  /*!
+   * \brief Find the vm.builtin.alloc_tensor calls whose result is returned by the
+   *  function, directly or as a field of the returned tuple, see output_alloc_index.
+   */
+  void FindOutputAllocs();
+
+  /*!
+   * \brief Write the output bound by set_output_zero_copy for an output tensor allocation.
+   * \param curr_frame The current frame.
+   * \param instr The vm.builtin.alloc_tensor call.
+   * \param output_index The index of the function output the allocation is returned as.
+   * \return Whether an output was bound, otherwise the allocation must be run.
+   */
+  bool BindOutput(VMFrame* curr_frame, const Instruction& instr, int output_index);
+
+  /*! \brief Run the dispatch loop over the pre-decoded program. */
+  void RunDecodedLoop();
+
+  /*!
+   * \brief Run a pre-decoded call.
+   * \param curr_frame The current frame.
+   * \param call The call.
+   */
+  void RunDecodedCall(VMFrame* curr_frame, const DecodedCall& call);
+
   /*!
    * \brief Retrieve the name of the function identified by the given index.
    * \param idx The index into the VM executable function table.
@@ -424,14 +767,41 @@ class VirtualMachineImpl : public VirtualMachine {
   //--------------------------------------------------------
   // Internal states for execution.
   //--------------------------------------------------------
-  /*! \brief The loaded executable. */
-  ObjectPtr<Executable> exec_;
-  /*! \brief The global constant pool */
-  std::vector<TVMRetValue> const_pool_;
   /*!
-   * \brief Function pool to cache functions in func_table
+   * \brief The program state built by Init, which is read-only afterwards and
+   *  shared by the VM and all the execution contexts created from it.
    */
-  std::vector<TVMRetValue> func_pool_;
+  struct VMProgram {
+    /*! \brief The global constant pool */
+    std::vector<TVMRetValue> const_pool;
+    /*!
+     * \brief Function pool to cache functions in func_table
+     */
+    std::vector<TVMRetValue> func_pool;
+    /*!
+     * \brief The direct calls of the functions in func_pool that resolve to typed global
+     *  functions, see Registry::GetDirectCall.
+     */
+    std::vector<DirectCall> direct_pool;
+    /*! \brief The pre-decoded program, one entry per instruction plus a sentinel. */
+    std::vector<DecodedInstr> decoded_program;
+    /*! \brief The pre-decoded calls. */
+    std::vector<DecodedCall> decoded_calls;
+    /*! \brief The argument templates of the pre-decoded calls. */
+    std::vector<TVMValue> decoded_arg_values;
+    std::vector<int> decoded_arg_tcodes;
+    /*! \brief The register arguments of the pre-decoded calls. */
+    std::vector<DecodedRegArg> decoded_reg_args;
+    /*!
+     * \brief For each instruction, the index of the function output it allocates,
+     *  or -1 if it is not an output allocation.
+     */
+    std::vector<int> output_alloc_index;
+  };
+  /*! \brief The loaded executable. */
+  ObjectPtr<Executable> exec_;
+  /*! \brief The shared program state. */
+  std::shared_ptr<VMProgram> program_;
   //--------------------------------------------------------
   // Executor interface support
   //--------------------------------------------------------
@@ -441,6 +811,10 @@ class VirtualMachineImpl : public VirtualMachine {
   std::unordered_map<std::string, RegType> outputs_;
   /*! \brief A store of closures created by `save_function`. */
   std::unordered_map<std::string, VMClosure> saved_closures_;
+  /*! \brief The function name to the outputs bound by `set_output_zero_copy`. */
+  std::unordered_map<std::string, std::vector<NDArray>> output_bindings_;
+  /*! \brief The bound outputs of the running `invoke_stateful`, nullptr for none. */
+  const std::vector<NDArray>* active_output_bindings_{nullptr};
   //------------------------------------------------------------
   // VM Instruction execution.
   //------------------------------------------------------------
@@ -460,6 +834,52 @@ class VirtualMachineImpl : public VirtualMachine {
   RegType return_value_;
   /*!\ brief instrument function. */
   PackedFunc instrument_ = nullptr;
+  /*! \brief The arena of the temporary argument buffers and TIR register files of calls. */
+  CallArgArena arg_arena_;
+  /*! \brief The named thread pool the invocations run their parallel loops in, empty for none. */
+  std::string thread_pool_name_;
+  /*!
+   * \brief Whether to run the pre-decoded program when no instrument is set.
+   *  Subclasses that override RunInstrCall must disable it.
+   */
+  bool decoded_dispatch_{true};
+  //------------------------------------------------------------
+  // Execution trace.
+  //------------------------------------------------------------
+  /*! \brief A call instruction recorded by the execution trace. */
+  struct TraceEvent {
+    /*! \brief The index of the callee in the function table. */
+    Index func_idx;
+    /*! \brief The device of the tensor arguments, CPU if there is none. */
+    Device dev;
+    /*! \brief The host time the call starts, relative to the start of the trace. */
+    int64_t host_begin_ns;
+    /*! \brief The host time spent in the call. */
+    int64_t host_duration_ns;
+    /*! \brief The device timer, which is synchronized when the trace stops. */
+    Timer timer;
+    /*! \brief The device time spent in the call, valid after the trace stops. */
+    int64_t device_duration_ns;
+  };
+  /*! \brief Whether the call instructions are being traced. */
+  bool tracing_{false};
+  /*! \brief The host time the trace started and stopped. */
+  std::chrono::steady_clock::time_point trace_begin_, trace_end_;
+  /*! \brief The calls recorded by the trace, in the order they start. */
+  std::vector<TraceEvent> trace_events_;
+  /*! \brief Whether the current invocation is recorded on the trace of the process. */
+  bool recording_{false};
+  /*! \brief Whether the current invocation is sampled by the sampling profiler. */
+  bool sampling_{false};
+  /*! \brief The id of the sampled invocation. */
+  uint64_t sample_invocation_{0};
+  //------------------------------------------------------------
+  // Asynchronous invocation, created on first use.
+  //------------------------------------------------------------
+  /*! \brief The execution context the asynchronous invocations run in. */
+  ObjectPtr<VirtualMachine> async_context_;
+  /*! \brief The worker thread, destroyed before the context it runs on. */
+  std::unique_ptr<AsyncWorker> async_worker_;
 };
 
 void VirtualMachineImpl::LoadExecutable(ObjectPtr<Executable> exec) {
@@ -479,16 +899,63 @@ void VirtualMachineImpl::Init(const std::vector<Device>& devices,
     this->allocators.push_back(alloc);
   }
   // Setup constant sections.
-  this->const_pool_.reserve(exec_->constants.size());
+  program_ = std::make_shared<VMProgram>();
+  program_->const_pool.reserve(exec_->constants.size());
   for (const auto& constant : exec_->constants) {
     if (constant.type_code() != kTVMNDArrayHandle) {
-      this->const_pool_.push_back(constant);
+      program_->const_pool.push_back(constant);
     } else {
-      this->const_pool_.push_back(ConvertRegToDevice(constant, devices[0], allocators[0]));
+      program_->const_pool.push_back(ConvertRegToDevice(constant, devices[0], allocators[0]));
     }
   }
   // Setup function sections.
   this->InitFuncPool();
+  this->FindOutputAllocs();
+  this->DecodeProgram();
+}
+
+ObjectPtr<VirtualMachine> VirtualMachineImpl::CreateContext() {
+  ICHECK(program_ != nullptr) << "The VM must be initialized before creating contexts";
+  ObjectPtr<VirtualMachineImpl> ctx = make_object<VirtualMachineImpl>();
+  ctx->exec_ = exec_;
+  ctx->imports_ = imports_;
+  ctx->devices = devices;
+  ctx->allocators = allocators;
+  ctx->program_ = program_;
+  ctx->thread_pool_name_ = thread_pool_name_;
+  return ctx;
+}
+
+VMFuture VirtualMachineImpl::InvokeClosureAsync(const ObjectRef& closure_or_packedfunc,
+                                               TVMArgs args, TVMStreamHandle stream) {
+  if (async_worker_ == nullptr) {
+    async_context_ = this->CreateContext();
+    async_worker_ = std::make_unique<AsyncWorker>();
+  }
+  ObjectPtr<VMFutureObj> future = make_object<VMFutureObj>();
+  future->device = devices[0];
+  future->stream = stream;
+  std::vector<RegType> inputs(args.size());
+  for (int i = 0; i < args.size(); ++i) {
+    inputs[i] = args[i];
+  }
+  auto* ctx = static_cast<VirtualMachineImpl*>(async_context_.get());
+  async_worker_->Push([ctx, func = closure_or_packedfunc, inputs = std::move(inputs), future,
+                       pool_name = thread_pool_name_]() {
+    threading::ThreadPoolScope pool_scope(pool_name);
+    Device dev = future->device;
+    DeviceAPI* api = DeviceAPI::Get(dev);
+    // The current stream is thread local, so only the worker thread sees the switch.
+    TVMStreamHandle prev_stream = api->GetCurrentStream(dev);
+    api->SetStream(dev, future->stream);
+    try {
+      future->SetValue(ctx->InvokeClosureInternal(func, inputs));
+    } catch (...) {
+      future->SetError(std::current_exception());
+    }
+    api->SetStream(dev, prev_stream);
+  });
+  return VMFuture(future);
 }
 
 VMFuncInfo VirtualMachineImpl::LookupVMFuncInfo(const std::string& func_name) {
@@ -544,18 +1011,19 @@ void VirtualMachineImpl::InvokeClosurePacked(const ObjectRef& closure_or_packedf
   auto* clo = closure_or_packedfunc.as<VMClosureObj>();
   ICHECK(clo != nullptr) << "Function expects a closure or PackedFunc ";
 
-  std::vector<TVMValue> values(args.size() + 1);
-  std::vector<int> tcodes(args.size() + 1);
-  runtime::TVMArgsSetter setter(values.data(), tcodes.data());
+  CallArgArena::Scope arena_scope(&arg_arena_);
+  TVMValue* values = arg_arena_.Alloc<TVMValue>(args.size() + 1);
+  int* tcodes = arg_arena_.Alloc<int>(args.size() + 1);
+  runtime::TVMArgsSetter setter(values, tcodes);
   // per convention, ctx ptr must be VirtualMachine* casted to void.
   // this and VirtualMachine* may or maynot be the same
   // do first cast to VirtualMachine* then to void*
   setter(0, static_cast<void*>(static_cast<VirtualMachine*>(this)));
-  std::copy(args.values, args.values + args.size(), values.begin() + 1);
-  std::copy(args.type_codes, args.type_codes + args.size(), tcodes.begin() + 1);
+  std::copy(args.values, args.values + args.size(), values + 1);
+  std::copy(args.type_codes, args.type_codes + args.size(), tcodes + 1);
   {
     NVTXScopedRange scope("RelaxVM: " + clo->func_name);
-    clo->impl.CallPacked(TVMArgs(values.data(), tcodes.data(), args.size() + 1), rv);
+    clo->impl.CallPacked(TVMArgs(values, tcodes, args.size() + 1), rv);
   }
 }
 
@@ -566,9 +1034,11 @@ RegType VirtualMachineImpl::InvokeClosureInternal(const ObjectRef& closure_or_pa
   auto* packed = closure_or_packed.as<PackedFunc::ContainerType>();
   auto* clo = closure_or_packed.as<VMClosureObj>();
   int clo_offset = clo != nullptr ? 1 : 0;
-  std::vector<TVMValue> values(args.size() + clo_offset);
-  std::vector<int> tcodes(args.size() + clo_offset);
-  runtime::TVMArgsSetter setter(values.data(), tcodes.data());
+  int num_args = args.size() + clo_offset;
+  CallArgArena::Scope arena_scope(&arg_arena_);
+  TVMValue* values = arg_arena_.Alloc<TVMValue>(num_args);
+  int* tcodes = arg_arena_.Alloc<int>(num_args);
+  runtime::TVMArgsSetter setter(values, tcodes);
 
   if (clo != nullptr) {
     setter(0, static_cast<void*>(static_cast<VirtualMachine*>(this)));
@@ -578,10 +1048,10 @@ RegType VirtualMachineImpl::InvokeClosureInternal(const ObjectRef& closure_or_pa
   }
 
   if (packed != nullptr) {
-    packed->CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &ret);
+    packed->CallPacked(TVMArgs(values, tcodes, num_args), &ret);
   } else {
     ICHECK(clo != nullptr);
-    clo->impl.CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &ret);
+    clo->impl.CallPacked(TVMArgs(values, tcodes, num_args), &ret);
   }
   return ret;
 }
@@ -624,11 +1094,7 @@ Optional<VMClosure> VirtualMachineImpl::GetClosureInternal(const String& func_na
     auto impl = PackedFunc([gf_idx](TVMArgs args, TVMRetValue* rv) {
       // Per convention, ctx ptr is a VirtualMachine*
       VirtualMachine* ctx_ptr = static_cast<VirtualMachine*>(args[0].operator void*());
-
-      std::vector<RegType> inputs(args.size() - 1);
-      for (size_t i = 0; i < inputs.size(); ++i) {
-        inputs[i] = args[i + 1];
-      }
+      TVMArgs inputs(args.values + 1, args.type_codes + 1, args.size() - 1);
       *rv = static_cast<VirtualMachineImpl*>(ctx_ptr)->InvokeBytecode(gf_idx, inputs);
     });
     return VMClosure(func_name, impl);
@@ -638,24 +1104,37 @@ Optional<VMClosure> VirtualMachineImpl::GetClosureInternal(const String& func_na
     PackedFunc tir_func = GetFuncFromImports("__vmtir__" + finfo.name);
     ICHECK(tir_func != nullptr) << "Cannot find underlying compiled tir function of VMTIRFunc "
                                 << finfo.name;
-    auto impl = PackedFunc([this, finfo, tir_func](TVMArgs args, TVMRetValue* rv) {
+    // NOTE: run on the calling VM, which can be any execution context sharing the program.
+    auto impl = PackedFunc([finfo, tir_func](TVMArgs args, TVMRetValue* rv) {
       // Per convention, ctx ptr is a VirtualMachine*
       VirtualMachine* ctx_ptr = static_cast<VirtualMachine*>(args[0].operator void*());
-      ICHECK(ctx_ptr == this);
+      auto* self = static_cast<VirtualMachineImpl*>(ctx_ptr);
       ICHECK_EQ(args.size() - 1, finfo.num_args)
           << "Function " << finfo.name << " expects " << finfo.num_args << " arguments";
       ICHECK_GE(finfo.register_file_size, finfo.num_args + 1);
-      std::vector<TVMRetValue> reg_file(finfo.register_file_size);
+      // The register file lives in the arena and is destroyed with the scope.
+      struct RegFile {
+        TVMRetValue* regs;
+        int64_t size;
+        ~RegFile() {
+          for (int64_t i = 0; i < size; ++i) regs[i].~TVMRetValue();
+        }
+      };
+      CallArgArena::Scope arena_scope(&self->arg_arena_);
+      RegFile reg_file{self->arg_arena_.Alloc<TVMRetValue>(finfo.register_file_size), 0};
+      for (; reg_file.size < finfo.register_file_size; ++reg_file.size) {
+        new (reg_file.regs + reg_file.size) TVMRetValue();
+      }
       for (int64_t i = 0; i < finfo.num_args; ++i) {
-        reg_file[i] = args[i + 1];
+        reg_file.regs[i] = args[i + 1];
       }
-      void* reg_anylist_handle = reg_file.data();
-      void* const_anylist_handle = this->const_pool_.data();
-      void* func_anylist_handle = this->func_pool_.data();
+      void* reg_anylist_handle = reg_file.regs;
+      void* const_anylist_handle = self->program_->const_pool.data();
+      void* func_anylist_handle = self->program_->func_pool.data();
       tir_func(static_cast<void*>(ctx_ptr), reg_anylist_handle, const_anylist_handle,
                func_anylist_handle);
       // Return value always stored after inputs.
-      *rv = reg_file[finfo.num_args];
+      *rv = reg_file.regs[finfo.num_args];
     });
     return VMClosure(func_name, impl);
   }
@@ -664,7 +1143,7 @@ Optional<VMClosure> VirtualMachineImpl::GetClosureInternal(const String& func_na
 //--------------------------------------------------------------------
 // Instruction interpretations.
 //--------------------------------------------------------------------
-RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegType>& args) {
+RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, TVMArgs args) {
   const VMFuncInfo& gfunc = exec_->func_table[gf_idx];
   ICHECK(gfunc.kind == VMFuncInfo::FuncKind::kVMFunc);
 
@@ -678,9 +1157,8 @@ RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegTy
   }
 
   // load arguments to the register file
-  ICHECK_EQ(static_cast<size_t>(gfunc.num_args), args.size()) << "ValueError: Invoking function "
-                                                              << gfunc.name << " expects "
-                                                              << gfunc.num_args << " arguments" <<
+  ICHECK_EQ(gfunc.num_args, args.size()) << "ValueError: Invoking function " << gfunc.name
+                                         << " expects " << gfunc.num_args << " arguments" <<
       [&]() {
         std::stringstream ss;
         if (gfunc.param_names.size()) {
@@ -695,17 +1173,49 @@ RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegTy
         }
         return ss.str();
       }() << ", but " << args.size() << " arguments were provided.";
-  for (size_t i = 0; i < args.size(); ++i) {
-    WriteRegister(frames_.back().get(), i, args[i]);
+  for (int i = 0; i < args.size(); ++i) {
+    curr_frame->register_file[i] = args[i];
   }
   // set program counter
   pc_ = gfunc.start_instr;
+  // Record or sample the invocations entering the VM, including the calls within them.
+  bool recorded = false;
+  int64_t record_begin_ns = 0;
+  bool sampled = false;
+  std::chrono::system_clock::time_point sample_begin;
+  if (frames_.size() == 1) {
+    recording_ = !tracing_ && profiling::TraceRecorder::Global()->enabled();
+    if (recording_) {
+      recorded = true;
+      record_begin_ns = profiling::TraceRecorder::NowNs();
+    }
+    sampling_ =
+        !tracing_ && !recording_ && profiling::SamplingProfiler::Global()->ShouldSample();
+    if (sampling_) {
+      sampled = true;
+      sample_invocation_ = profiling::SamplingProfiler::Global()->NewInvocation();
+      sample_begin = std::chrono::system_clock::now();
+    }
+  }
   RunLoop();
+  if (recorded) {
+    profiling::TraceRecorder::Global()->AddHostEvent(
+        gfunc.name, "vm_function", record_begin_ns,
+        profiling::TraceRecorder::NowNs() - record_begin_ns);
+    recording_ = false;
+  }
+  if (sampled) {
+    profiling::SamplingProfiler::Global()->Record(sample_invocation_, gfunc.name,
+                                                  Device{kDLCPU, 0}, 0, sample_begin,
+                                                  std::chrono::system_clock::now());
+    sampling_ = false;
+  }
   return return_value_;
 }
 
 void VirtualMachineImpl::InitFuncPool() {
-  func_pool_.resize(exec_->func_table.size());
+  program_->func_pool.resize(exec_->func_table.size());
+  program_->direct_pool.assign(exec_->func_table.size(), DirectCall());
 
   for (size_t func_index = 0; func_index < exec_->func_table.size(); ++func_index) {
     const VMFuncInfo& info = exec_->func_table[func_index];
@@ -714,19 +1224,22 @@ void VirtualMachineImpl::InitFuncPool() {
       PackedFunc func = GetFuncFromImports(info.name);
       if (!func.defined()) {
         const PackedFunc* p_func = Registry::Get(info.name);
-        if (p_func != nullptr) func = *(p_func);
+        if (p_func != nullptr) {
+          func = *(p_func);
+          program_->direct_pool[func_index] = Registry::GetDirectCall(info.name);
+        }
       }
       ICHECK(func.defined())
           << "Error: Cannot find PackedFunc " << info.name
           << " in either Relax VM kernel library, or in TVM runtime PackedFunc registry, or in "
              "global Relax functions of the VM executable";
-      func_pool_[func_index] = func;
+      program_->func_pool[func_index] = func;
 
     } else {
       ICHECK(info.kind == VMFuncInfo::FuncKind::kVMFunc ||
              info.kind == VMFuncInfo::FuncKind::kVMTIRFunc);
       auto clo = this->GetClosure(info.name);
-      func_pool_[func_index] = clo;
+      program_->func_pool[func_index] = clo;
     }
   }
 }
@@ -758,12 +1271,12 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
         break;
       }
       case Instruction::ArgKind::kConstIdx: {
-        setter(arg_index, this->const_pool_[arg.value()]);
+        setter(arg_index, program_->const_pool[arg.value()]);
         break;
       }
       case Instruction::ArgKind::kFuncIdx: {
-        ICHECK_LT(static_cast<size_t>(arg.value()), this->func_pool_.size());
-        setter(arg_index, this->func_pool_[arg.value()]);
+        ICHECK_LT(static_cast<size_t>(arg.value()), program_->func_pool.size());
+        setter(arg_index, program_->func_pool[arg.value()]);
         break;
       }
       default: {
@@ -775,13 +1288,13 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
                instr.num_args);
   TVMRetValue ret;
 
-  ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
+  ICHECK_LT(static_cast<size_t>(instr.func_idx), program_->func_pool.size());
 
   if (instrument_ == nullptr) {
-    this->InvokeClosurePacked(func_pool_[instr.func_idx], args, &ret);
+    this->InvokeClosurePacked(program_->func_pool[instr.func_idx], args, &ret);
   } else {
     // insert light-weight instrument callback
-    setter(0, func_pool_[instr.func_idx]);
+    setter(0, program_->func_pool[instr.func_idx]);
     setter(1, GetFuncName(instr.func_idx));
     setter(2, true);
     setter(3, nullptr);
@@ -801,7 +1314,7 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
       ret_kind = rv;
     }
     if (ret_kind != static_cast<int>(VMInstrumentReturnKind::kSkipRun)) {
-      this->InvokeClosurePacked(func_pool_[instr.func_idx], args, &ret);
+      this->InvokeClosurePacked(program_->func_pool[instr.func_idx], args, &ret);
       setter(2, false);
       setter(3, ret);
       instrument_.CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &rv);
@@ -817,7 +1330,77 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   pc_++;
 }
 
+Device VirtualMachineImpl::GetCallDevice(VMFrame* curr_frame, Instruction instr) {
+  Device dev{kDLCPU, 0};
+  for (Index i = 0; i < instr.num_args; ++i) {
+    Instruction::Arg arg = instr.args[i];
+    const TVMRetValue* val = nullptr;
+    TVMRetValue reg;
+    if (arg.kind() == Instruction::ArgKind::kRegister) {
+      reg = ReadRegister(curr_frame, arg.value());
+      val = &reg;
+    } else if (arg.kind() == Instruction::ArgKind::kConstIdx) {
+      val = &program_->const_pool[arg.value()];
+    }
+    if (val != nullptr && val->type_code() == kTVMNDArrayHandle) {
+      dev = val->operator NDArray()->device;
+    }
+  }
+  return dev;
+}
+
+void VirtualMachineImpl::RunInstrCallSampled(VMFrame* curr_frame, Instruction instr) {
+  profiling::SamplingProfiler* sampler = profiling::SamplingProfiler::Global();
+  Device dev = GetCallDevice(curr_frame, instr);
+  int depth = frames_.size();
+  auto begin = std::chrono::system_clock::now();
+  this->RunInstrCall(curr_frame, instr);
+  if (dev.device_type != kDLCPU && sampler->sync_device()) {
+    DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+  }
+  sampler->Record(sample_invocation_, GetFuncName(instr.func_idx), dev, depth, begin,
+                  std::chrono::system_clock::now());
+}
+
+void VirtualMachineImpl::RunInstrCallRecorded(VMFrame* curr_frame, Instruction instr) {
+  profiling::TraceRecorder* recorder = profiling::TraceRecorder::Global();
+  const VMFuncInfo& info = exec_->func_table[instr.func_idx];
+  bool is_vm_func = info.kind == VMFuncInfo::FuncKind::kVMFunc;
+  Device dev = GetCallDevice(curr_frame, instr);
+  // The calls into VM functions are covered by the kernels they launch.
+  bool on_device = !is_vm_func && dev.device_type != kDLCPU;
+  int64_t begin_ns = profiling::TraceRecorder::NowNs();
+  Timer timer = on_device ? Timer::Start(dev) : Timer(nullptr);
+  this->RunInstrCall(curr_frame, instr);
+  if (on_device) timer->Stop();
+  recorder->AddHostEvent(info.name, is_vm_func ? "vm_function" : "call", begin_ns,
+                         profiling::TraceRecorder::NowNs() - begin_ns);
+  if (on_device) recorder->AddDeviceEvent(info.name, dev, begin_ns, std::move(timer));
+}
+
+void VirtualMachineImpl::RunInstrCallTraced(VMFrame* curr_frame, Instruction instr) {
+  Device dev = GetCallDevice(curr_frame, instr);
+  size_t index = trace_events_.size();
+  trace_events_.push_back(TraceEvent{instr.func_idx, dev, 0, 0, Timer(), 0});
+  auto host_begin = std::chrono::steady_clock::now();
+  Timer timer = Timer::Start(dev);
+  this->RunInstrCall(curr_frame, instr);
+  timer->Stop();
+  auto host_end = std::chrono::steady_clock::now();
+  // Nested VM functions may have grown the event list, so index it again.
+  TraceEvent& event = trace_events_[index];
+  event.host_begin_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(host_begin - trace_begin_).count();
+  event.host_duration_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(host_end - host_begin).count();
+  event.timer = std::move(timer);
+}
+
 void VirtualMachineImpl::RunLoop() {
+  if (decoded_dispatch_ && instrument_ == nullptr && !tracing_ && !recording_ && !sampling_) {
+    RunDecodedLoop();
+    return;
+  }
   VMFrame* curr_frame = frames_.back().get();
 
   while (true) {
@@ -825,7 +1408,20 @@ void VirtualMachineImpl::RunLoop() {
     Instruction instr = exec_->GetInstruction(pc_);
     switch (instr.op) {
       case Opcode::Call: {
-        this->RunInstrCall(curr_frame, instr);
+        if (active_output_bindings_ != nullptr && program_->output_alloc_index[pc_] >= 0 &&
+            BindOutput(curr_frame, instr, program_->output_alloc_index[pc_])) {
+          pc_++;
+          break;
+        }
+        if (tracing_) {
+          this->RunInstrCallTraced(curr_frame, instr);
+        } else if (recording_) {
+          this->RunInstrCallRecorded(curr_frame, instr);
+        } else if (sampling_) {
+          this->RunInstrCallSampled(curr_frame, instr);
+        } else {
+          this->RunInstrCall(curr_frame, instr);
+        }
         break;
       }
       case Opcode::Ret: {
@@ -862,6 +1458,317 @@ void VirtualMachineImpl::RunLoop() {
   }
 }
 
+void VirtualMachineImpl::DecodeProgram() {
+  Index num_instrs = exec_->instr_offset.size();
+  VMProgram& program = *program_;
+  program.decoded_program.clear();
+  program.decoded_calls.clear();
+  program.decoded_arg_values.clear();
+  program.decoded_arg_tcodes.clear();
+  program.decoded_reg_args.clear();
+  // Superinstructions cannot span an instruction that is jumped to.
+  std::vector<bool> is_jump_target(num_instrs + 1, false);
+  for (const VMFuncInfo& info : exec_->func_table) {
+    if (info.kind == VMFuncInfo::FuncKind::kVMFunc) is_jump_target[info.start_instr] = true;
+  }
+  for (Index pc = 0; pc < num_instrs; ++pc) {
+    Instruction instr = exec_->GetInstruction(pc);
+    Index target = -1;
+    if (instr.op == Opcode::Goto) {
+      target = pc + instr.pc_offset;
+    } else if (instr.op == Opcode::If) {
+      target = pc + instr.false_offset;
+    }
+    if (target != -1) {
+      ICHECK(target >= 0 && target < num_instrs) << "Instruction " << pc << " jumps out of range";
+      is_jump_target[target] = true;
+    }
+  }
+
+  for (Index pc = 0; pc < num_instrs; ++pc) {
+    Instruction instr = exec_->GetInstruction(pc);
+    DecodedInstr decoded{DecodedOp::kInvalid, 0, 0, 0};
+    switch (instr.op) {
+      case Opcode::Call: {
+        ICHECK_LT(static_cast<size_t>(instr.func_idx), program.func_pool.size());
+        DecodedCall call;
+        call.dst = instr.dst;
+        call.func_idx = instr.func_idx;
+        ObjectRef callee = program.func_pool[instr.func_idx];
+        call.packed = callee.as<PackedFunc::ContainerType>();
+        call.direct = program.direct_pool[instr.func_idx];
+        call.arg_begin = program.decoded_arg_values.size();
+        call.num_args = instr.num_args;
+        call.reg_arg_begin = program.decoded_reg_args.size();
+        program.decoded_arg_values.resize(call.arg_begin + call.num_args);
+        program.decoded_arg_tcodes.resize(call.arg_begin + call.num_args);
+        runtime::TVMArgsSetter setter(program.decoded_arg_values.data() + call.arg_begin,
+                                      program.decoded_arg_tcodes.data() + call.arg_begin);
+        for (Index i = 0; i < instr.num_args; ++i) {
+          Instruction::Arg arg = instr.args[i];
+          switch (arg.kind()) {
+            case Instruction::ArgKind::kRegister: {
+              // The VM register is per execution context, so it is read at run time too.
+              if (arg.value() < Instruction::kBeginSpecialReg ||
+                  arg.value() == Instruction::kVMRegister) {
+                program.decoded_reg_args.push_back(DecodedRegArg{static_cast<int>(i), arg.value()});
+              } else {
+                setter(i, ReadRegister(nullptr, arg.value()));
+              }
+              break;
+            }
+            case Instruction::ArgKind::kImmediate: {
+              setter(i, arg.value());
+              break;
+            }
+            case Instruction::ArgKind::kConstIdx: {
+              setter(i, program.const_pool[arg.value()]);
+              break;
+            }
+            case Instruction::ArgKind::kFuncIdx: {
+              ICHECK_LT(static_cast<size_t>(arg.value()), program.func_pool.size());
+              setter(i, program.func_pool[arg.value()]);
+              break;
+            }
+            default: {
+              LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+            }
+          }
+        }
+        call.num_reg_args = program.decoded_reg_args.size() - call.reg_arg_begin;
+        decoded.op = DecodedOp::kCall;
+        if (program.output_alloc_index[pc] >= 0) {
+          decoded.op = DecodedOp::kOutputAllocTensor;
+          decoded.offset = program.output_alloc_index[pc];
+        }
+        decoded.call = program.decoded_calls.size();
+        program.decoded_calls.push_back(call);
+        break;
+      }
+      case Opcode::Ret: {
+        decoded.op = DecodedOp::kRet;
+        decoded.reg = instr.result;
+        break;
+      }
+      case Opcode::Goto: {
+        decoded.op = DecodedOp::kGoto;
+        decoded.offset = instr.pc_offset;
+        break;
+      }
+      case Opcode::If: {
+        ICHECK_GT(instr.false_offset, 1);
+        decoded.op = DecodedOp::kIf;
+        decoded.reg = instr.cond;
+        decoded.offset = instr.false_offset;
+        break;
+      }
+    }
+    program.decoded_program.push_back(decoded);
+  }
+  program.decoded_program.push_back(DecodedInstr{DecodedOp::kInvalid, 0, 0, 0});
+
+  // Fuse every tensor allocation with the call that follows it, which is
+  // usually the call_tir consuming the allocated tensor.
+  for (Index pc = 0; pc + 1 < num_instrs; ++pc) {
+    DecodedInstr& decoded = program.decoded_program[pc];
+    if (decoded.op != DecodedOp::kCall ||
+        program.decoded_program[pc + 1].op != DecodedOp::kCall || is_jump_target[pc + 1]) {
+      continue;
+    }
+    const DecodedCall& call = program.decoded_calls[decoded.call];
+    if (GetFuncName(call.func_idx) == "vm.builtin.alloc_tensor") {
+      decoded.op = DecodedOp::kAllocTensorCall;
+    }
+  }
+}
+
+void VirtualMachineImpl::FindOutputAllocs() {
+  VMProgram& program = *program_;
+  program.output_alloc_index.assign(exec_->instr_offset.size(), -1);
+  for (const VMFuncInfo& info : exec_->func_table) {
+    if (info.kind != VMFuncInfo::FuncKind::kVMFunc) continue;
+    // Only registers written once can be bound, as the binding replaces the write.
+    std::unordered_map<RegName, std::vector<Index>> writers;
+    std::vector<Index> rets;
+    for (Index pc = info.start_instr; pc < info.end_instr; ++pc) {
+      Instruction instr = exec_->GetInstruction(pc);
+      if (instr.op == Opcode::Call && instr.dst < Instruction::kBeginSpecialReg) {
+        writers[instr.dst].push_back(pc);
+      } else if (instr.op == Opcode::Ret) {
+        rets.push_back(pc);
+      }
+    }
+    if (rets.size() != 1) continue;
+    auto f_single_writer = [&](RegName reg, const char* func_name) -> Index {
+      auto it = writers.find(reg);
+      if (it == writers.end() || it->second.size() != 1) return -1;
+      Index pc = it->second[0];
+      return GetFuncName(exec_->GetInstruction(pc).func_idx) == func_name ? pc : -1;
+    };
+    RegName result = exec_->GetInstruction(rets[0]).result;
+    if (Index pc = f_single_writer(result, "vm.builtin.alloc_tensor"); pc != -1) {
+      program.output_alloc_index[pc] = 0;
+    } else if (Index pc = f_single_writer(result, "vm.builtin.make_tuple"); pc != -1) {
+      Instruction make_tuple = exec_->GetInstruction(pc);
+      for (Index i = 0; i < make_tuple.num_args; ++i) {
+        Instruction::Arg arg = make_tuple.args[i];
+        if (arg.kind() != Instruction::ArgKind::kRegister) continue;
+        Index alloc_pc = f_single_writer(arg.value(), "vm.builtin.alloc_tensor");
+        // A tensor returned as several fields is bound to the first of them.
+        if (alloc_pc != -1 && program.output_alloc_index[alloc_pc] == -1) {
+          program.output_alloc_index[alloc_pc] = i;
+        }
+      }
+    }
+  }
+}
+
+bool VirtualMachineImpl::BindOutput(VMFrame* curr_frame, const Instruction& instr,
+                                    int output_index) {
+  // The bindings are for the outputs of the invoked function, not of its callees.
+  if (active_output_bindings_ == nullptr || frames_.size() != 1 ||
+      static_cast<size_t>(output_index) >= active_output_bindings_->size()) {
+    return false;
+  }
+  const NDArray& out = (*active_output_bindings_)[output_index];
+  if (!out.defined()) return false;
+  auto f_read_arg = [&](Instruction::Arg arg) -> RegType {
+    if (arg.kind() == Instruction::ArgKind::kRegister) return ReadRegister(curr_frame, arg.value());
+    if (arg.kind() == Instruction::ArgKind::kConstIdx) return program_->const_pool[arg.value()];
+    RegType ret;
+    ret = arg.value();
+    return ret;
+  };
+  // vm.builtin.alloc_tensor(storage, offset, shape, dtype)
+  ICHECK_EQ(instr.num_args, 4);
+  Storage storage = f_read_arg(instr.args[0]);
+  ShapeTuple shape = f_read_arg(instr.args[2]);
+  DataType dtype = f_read_arg(instr.args[3]).operator DataType();
+  CHECK(std::equal(shape.begin(), shape.end(), out->shape, out->shape + out->ndim) &&
+        static_cast<size_t>(out->ndim) == shape.size() && DataType(out->dtype) == dtype)
+      << "ValueError: Output " << output_index << " is bound to a " << DataType(out->dtype)
+      << out.Shape() << " tensor, but the function produces " << dtype << shape;
+  CHECK(out->device.device_type == storage->buffer.device.device_type &&
+        out->device.device_id == storage->buffer.device.device_id)
+      << "ValueError: Output " << output_index << " is bound to a tensor on " << out->device
+      << ", but the function produces it on " << storage->buffer.device;
+  CHECK(out.IsContiguous()) << "ValueError: Output " << output_index
+                            << " must be bound to a contiguous tensor";
+  if (instr.dst < Instruction::kBeginSpecialReg) {
+    curr_frame->register_file[instr.dst] = out;
+  }
+  return true;
+}
+
+void VirtualMachineImpl::RunDecodedCall(VMFrame* curr_frame, const DecodedCall& call) {
+  DLOG(INFO) << "\n  pc = " << pc_ << ", execute: " << GetFuncName(call.func_idx);
+  // Reuse the call arg stack of the current frame, see RunInstrCall.
+  curr_frame->call_arg_values.resize(call.num_args);
+  curr_frame->call_arg_tcodes.resize(call.num_args);
+  TVMValue* values = curr_frame->call_arg_values.data();
+  int* tcodes = curr_frame->call_arg_tcodes.data();
+  std::copy_n(program_->decoded_arg_values.data() + call.arg_begin, call.num_args, values);
+  std::copy_n(program_->decoded_arg_tcodes.data() + call.arg_begin, call.num_args, tcodes);
+  runtime::TVMArgsSetter setter(values, tcodes);
+  const DecodedRegArg* reg_args = program_->decoded_reg_args.data() + call.reg_arg_begin;
+  for (int i = 0; i < call.num_reg_args; ++i) {
+    RegName reg = reg_args[i].reg;
+    if (reg == Instruction::kVMRegister) {
+      setter(reg_args[i].arg_index, static_cast<void*>(static_cast<VirtualMachine*>(this)));
+    } else {
+      setter(reg_args[i].arg_index, curr_frame->register_file[reg]);
+    }
+  }
+  TVMArgs args(values, tcodes, call.num_args);
+  TVMRetValue ret;
+  if (call.direct) {
+    call.direct(args, &ret);
+  } else if (call.packed != nullptr) {
+    call.packed->CallPacked(args, &ret);
+  } else {
+    this->InvokeClosurePacked(program_->func_pool[call.func_idx], args, &ret);
+  }
+  // saving to special register is a NOP
+  if (call.dst < Instruction::kBeginSpecialReg) {
+    WriteRegister(curr_frame, call.dst, ret);
+  }
+}
+
+// Dispatch with computed goto where the compiler supports it.
+#if defined(__GNUC__) || defined(__clang__)
+#define TVM_RELAX_VM_COMPUTED_GOTO 1
+#else
+#define TVM_RELAX_VM_COMPUTED_GOTO 0
+#endif
+
+void VirtualMachineImpl::RunDecodedLoop() {
+  VMFrame* curr_frame = frames_.back().get();
+  const DecodedInstr* program = program_->decoded_program.data();
+#if TVM_RELAX_VM_COMPUTED_GOTO
+  // Must be in the order of DecodedOp.
+  static const void* dispatch_table[] = {
+      &&op_kCall, &&op_kAllocTensorCall, &&op_kOutputAllocTensor, &&op_kRet,
+      &&op_kGoto, &&op_kIf,              &&op_kInvalid,
+  };
+#define TVM_RELAX_VM_DISPATCH() goto* dispatch_table[static_cast<int>(program[pc_].op)]
+#define TVM_RELAX_VM_CASE(name) op_##name:
+  TVM_RELAX_VM_DISPATCH();
+#else
+#define TVM_RELAX_VM_DISPATCH() break
+#define TVM_RELAX_VM_CASE(name) case DecodedOp::name:
+  while (true) {
+    switch (program[pc_].op) {
+#endif
+  TVM_RELAX_VM_CASE(kCall) {
+    RunDecodedCall(curr_frame, program_->decoded_calls[program[pc_].call]);
+    pc_++;
+    TVM_RELAX_VM_DISPATCH();
+  }
+  TVM_RELAX_VM_CASE(kAllocTensorCall) {
+    RunDecodedCall(curr_frame, program_->decoded_calls[program[pc_].call]);
+    pc_++;
+    RunDecodedCall(curr_frame, program_->decoded_calls[program[pc_].call]);
+    pc_++;
+    TVM_RELAX_VM_DISPATCH();
+  }
+  TVM_RELAX_VM_CASE(kOutputAllocTensor) {
+    if (active_output_bindings_ == nullptr ||
+        !BindOutput(curr_frame, exec_->GetInstruction(pc_), program[pc_].offset)) {
+      RunDecodedCall(curr_frame, program_->decoded_calls[program[pc_].call]);
+    }
+    pc_++;
+    TVM_RELAX_VM_DISPATCH();
+  }
+  TVM_RELAX_VM_CASE(kRet) {
+    // Same as Opcode::Ret in RunLoop.
+    return_value_ = ReadRegister(curr_frame, program[pc_].reg);
+    if (frames_.size() > 1) {
+      VMFrame* parent_frame = frames_.end()[-2].get();
+      WriteRegister(parent_frame, curr_frame->caller_return_register, return_value_);
+    }
+    return;
+  }
+  TVM_RELAX_VM_CASE(kGoto) {
+    pc_ += program[pc_].offset;
+    TVM_RELAX_VM_DISPATCH();
+  }
+  TVM_RELAX_VM_CASE(kIf) {
+    int64_t cond_val = ReadRegister(curr_frame, program[pc_].reg);
+    pc_ += cond_val != 0 ? 1 : program[pc_].offset;
+    TVM_RELAX_VM_DISPATCH();
+  }
+  TVM_RELAX_VM_CASE(kInvalid) {
+    LOG(FATAL) << "run into invalid section";
+    return;
+  }
+#if !TVM_RELAX_VM_COMPUTED_GOTO
+    }
+  }
+#endif
+#undef TVM_RELAX_VM_DISPATCH
+#undef TVM_RELAX_VM_CASE
+}
+
 ObjectPtr<VirtualMachine> VirtualMachine::Create() { return make_object<VirtualMachineImpl>(); }
 
 //--------------------------------------------------------------------
@@ -890,10 +1797,23 @@ void VirtualMachineImpl::_SaveClosure(TVMArgs args, TVMRetValue* rv) {
 }
 
 void VirtualMachineImpl::_InvokeClosure(TVMArgs args, TVMRetValue* rv) {
+  threading::ThreadPoolScope pool_scope(thread_pool_name_);
   this->InvokeClosurePacked(args[0], TVMArgs(args.values + 1, args.type_codes + 1, args.size() - 1),
                             rv);
 }
 
+void VirtualMachineImpl::_InvokeAsync(TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.size(), 2) << "invoke_async expects the function and the stream";
+  ObjectRef func;
+  if (args[0].type_code() == kTVMStr) {
+    func = this->GetClosure(args[0].operator String());
+  } else {
+    func = args[0].operator ObjectRef();
+  }
+  *rv = this->InvokeClosureAsync(
+      func, TVMArgs(args.values + 2, args.type_codes + 2, args.size() - 2), args[1]);
+}
+
 void VirtualMachineImpl::_InvokeClosureStateful(std::string func_name) {
   const std::unordered_map<std::string, Index>& m = this->exec_->func_map;
   if (m.find(func_name) == m.end()) {
@@ -904,8 +1824,54 @@ void VirtualMachineImpl::_InvokeClosureStateful(std::string func_name) {
                << "; use `set_input` first.";
     return;
   }
-  outputs_[func_name] =
-      this->InvokeClosureInternal(func_pool_[m.at(func_name)], inputs_[func_name]);
+  threading::ThreadPoolScope pool_scope(thread_pool_name_);
+  auto bind_it = output_bindings_.find(func_name);
+  active_output_bindings_ = bind_it != output_bindings_.end() ? &bind_it->second : nullptr;
+  try {
+    outputs_[func_name] =
+        this->InvokeClosureInternal(program_->func_pool[m.at(func_name)], inputs_[func_name]);
+  } catch (...) {
+    active_output_bindings_ = nullptr;
+    throw;
+  }
+  active_output_bindings_ = nullptr;
+  if (bind_it != output_bindings_.end()) {
+    // Copy the outputs the function did not write in place, e.g. views or outputs of
+    // VMTIRFuncs, so that the bound tensors always hold the outputs.
+    std::vector<NDArray>& bindings = bind_it->second;
+    auto f_bind = [&](ObjectRef value, size_t index) -> ObjectRef {
+      if (index >= bindings.size() || !bindings[index].defined()) return value;
+      if (const auto* arr = value.as<NDArray::ContainerType>()) {
+        if (arr->dl_tensor.data != bindings[index]->data) {
+          bindings[index].CopyFrom(GetRef<NDArray>(arr));
+        }
+        return bindings[index];
+      }
+      return value;
+    };
+    ObjectRef out = outputs_[func_name].AsObjectRef<ObjectRef>();
+    if (const auto* tuple = out.as<ArrayNode>()) {
+      Array<ObjectRef> fields;
+      for (size_t i = 0; i < tuple->size(); ++i) {
+        fields.push_back(f_bind(tuple->at(i), i));
+      }
+      outputs_[func_name] = fields;
+    } else {
+      outputs_[func_name] = f_bind(out, 0);
+    }
+  }
+}
+
+void VirtualMachineImpl::_SetOutputZeroCopy(std::string func_name, int index, NDArray arr) {
+  LookupVMFuncInfo(func_name);
+  CHECK_GE(index, 0) << "ValueError: Invalid output index " << index;
+  std::vector<NDArray>& bindings = output_bindings_[func_name];
+  if (bindings.size() <= static_cast<size_t>(index)) bindings.resize(index + 1);
+  bindings[index] = arr;
+}
+
+void VirtualMachineImpl::_ClearOutputZeroCopy(std::string func_name) {
+  output_bindings_.erase(func_name);
 }
 
 void VirtualMachineImpl::_SetInstrument(TVMArgs args, TVMRetValue* rv) {
@@ -921,6 +1887,115 @@ void VirtualMachineImpl::_SetInstrument(TVMArgs args, TVMRetValue* rv) {
   }
 }
 
+void VirtualMachineImpl::_SetThreadPool(std::string name) {
+  // Fail early on unknown pools instead of at the next invocation.
+  { threading::ThreadPoolScope check(name); }
+  thread_pool_name_ = std::move(name);
+}
+
+void VirtualMachineImpl::_StartTrace() {
+  trace_events_.clear();
+  trace_begin_ = std::chrono::steady_clock::now();
+  tracing_ = true;
+}
+
+void VirtualMachineImpl::_StopTrace() {
+  ICHECK(tracing_) << "The trace is not started, call `start_trace` first";
+  tracing_ = false;
+  trace_end_ = std::chrono::steady_clock::now();
+  // Synchronize once at the end, and release the device timers.
+  for (TraceEvent& event : trace_events_) {
+    event.device_duration_ns = event.timer->SyncAndGetElapsedNanos();
+    event.timer = Timer();
+  }
+}
+
+std::string VirtualMachineImpl::_GetTraceReport() {
+  ICHECK(!tracing_) << "The trace is still running, call `stop_trace` first";
+  using profiling::CountNode;
+  using profiling::DurationNode;
+  using profiling::PercentNode;
+  struct Row {
+    std::string name;
+    Device dev;
+    int64_t count = 0;
+    int64_t host_ns = 0;
+    int64_t device_ns = 0;
+  };
+  // Aggregate by callee and device, in the order of the first call.
+  std::vector<Row> rows;
+  std::unordered_map<std::string, size_t> row_index;
+  std::unordered_map<std::string, Row> device_rows;
+  for (const TraceEvent& event : trace_events_) {
+    const VMFuncInfo& info = exec_->func_table[event.func_idx];
+    // Calls into VM functions are covered by the calls they make.
+    if (info.kind == VMFuncInfo::FuncKind::kVMFunc) continue;
+    std::string dev_str = profiling::DeviceString(event.dev);
+    std::string key = info.name + "@" + dev_str;
+    auto it = row_index.find(key);
+    if (it == row_index.end()) {
+      it = row_index.emplace(key, rows.size()).first;
+      rows.push_back(Row{info.name, event.dev});
+    }
+    for (Row* row : {&rows[it->second], &device_rows[dev_str]}) {
+      row->count += 1;
+      row->host_ns += event.host_duration_ns;
+      row->device_ns += event.device_duration_ns;
+    }
+  }
+  double total_us =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(trace_end_ - trace_begin_).count() /
+      1e3;
+  auto f_metrics = [total_us](const Row& row) {
+    Map<String, ObjectRef> metrics;
+    metrics.Set("Count", ObjectRef(make_object<CountNode>(row.count)));
+    metrics.Set("Duration (us)", ObjectRef(make_object<DurationNode>(row.device_ns / 1e3)));
+    metrics.Set("Host Duration (us)", ObjectRef(make_object<DurationNode>(row.host_ns / 1e3)));
+    metrics.Set("Percent", ObjectRef(make_object<PercentNode>(
+                               total_us > 0 ? row.device_ns / 1e3 / total_us * 100 : 0)));
+    return metrics;
+  };
+  Array<Map<String, ObjectRef>> calls;
+  for (const Row& row : rows) {
+    Map<String, ObjectRef> metrics = f_metrics(row);
+    metrics.Set("Name", String(row.name));
+    metrics.Set("Device", String(profiling::DeviceString(row.dev)));
+    calls.push_back(metrics);
+  }
+  Map<String, Map<String, ObjectRef>> device_metrics;
+  for (const auto& kv : device_rows) {
+    device_metrics.Set(kv.first, f_metrics(kv.second));
+  }
+  Map<String, ObjectRef> configuration;
+  configuration.Set("Executor", String("VM"));
+  configuration.Set("Trace Duration (us)", ObjectRef(make_object<DurationNode>(total_us)));
+  // Return the report as json, since profiling::Report object is not supported by RPC
+  return profiling::Report(calls, device_metrics, configuration)->AsJSON();
+}
+
+std::string VirtualMachineImpl::_GetChromeTrace() {
+  ICHECK(!tracing_) << "The trace is still running, call `stop_trace` first";
+  // See the Trace Event Format of chrome://tracing; each call is a complete ("X") event on
+  // the host timeline, and nested VM function calls show up as enclosing events.
+  std::ostringstream os;
+  os << "{\"traceEvents\":[";
+  for (size_t i = 0; i < trace_events_.size(); ++i) {
+    const TraceEvent& event = trace_events_[i];
+    const VMFuncInfo& info = exec_->func_table[event.func_idx];
+    if (i != 0) os << ",";
+    os << "{\"name\":\"" << support::StrEscape(info.name) << "\",\"cat\":\""
+       << (info.kind == VMFuncInfo::FuncKind::kVMFunc ? "vm_function" : "call")
+       << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << event.host_begin_ns / 1e3
+       << ",\"dur\":" << event.host_duration_ns / 1e3 << ",\"args\":{\"device\":\""
+       << profiling::DeviceString(event.dev)
+       << "\",\"device_duration_us\":" << event.device_duration_ns / 1e3 << "}}";
+  }
+  os << "],\"displayTimeUnit\":\"ns\"}";
+  return os.str();
+}
+
+Module VirtualMachineImpl::_CreateContext() { return Module(this->CreateContext()); }
+
 void VirtualMachineImpl::_GetOutputArity(TVMArgs args, TVMRetValue* rv) {
   std::string func_name = args[0];
   RegType out = LookupVMOutput(func_name);
@@ -975,6 +2050,7 @@ PackedFunc VirtualMachineImpl::_LookupFunction(const String& name) {
         [clo = opt.value(), _self = GetRef<Module>(this)](TVMArgs args, TVMRetValue* rv) -> void {
           auto* self = const_cast<VirtualMachineImpl*>(_self.as<VirtualMachineImpl>());
           ICHECK(self);
+          threading::ThreadPoolScope pool_scope(self->thread_pool_name_);
           self->InvokeClosurePacked(clo, args, rv);
         });
   }
@@ -992,57 +2068,79 @@ PackedFunc VirtualMachineImpl::_LookupFunction(const String& name) {
  */
 class VirtualMachineProfiler : public VirtualMachineImpl {
  public:
+  // The profiler instruments RunInstrCall, which the pre-decoded program bypasses.
+  VirtualMachineProfiler() { decoded_dispatch_ = false; }
+
   PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) override {
     if (name == "profile") {
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
-        std::string f_name = args[0];
-        VMClosure clo = this->GetClosure(f_name);
+        *rv = Profile(args[0], {},
+                      TVMArgs(args.values + 1, args.type_codes + 1, args.num_args - 1));
+      });
+    } else if (name == "profile_with_collectors") {
+      // The collectors cannot be sent over RPC, use `profile` on remotes.
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK_GE(args.num_args, 2) << "Expect the function name and the metric collectors";
+        Array<profiling::MetricCollector> collectors = args[1];
+        *rv = Profile(args[0], {collectors.begin(), collectors.end()},
+                      TVMArgs(args.values + 2, args.type_codes + 2, args.num_args - 2));
+      });
+    } else {
+      return VirtualMachineImpl::GetFunction(name, sptr_to_self);
+    }
+  }
 
-        std::vector<Device> devices;
-        for (auto dev : this->devices) {
-          if (dev.device_type > 0) {
-            devices.push_back(dev);
-          }
-        }
+ protected:
+  /*!
+   * \brief Profile a function call, with the inputs given by set_input if \p args is empty.
+   * \param f_name The name of the function.
+   * \param collectors The metric collectors of each call within the function.
+   * \param args The inputs of the function.
+   * \return The report serialized as json.
+   */
+  std::string Profile(const std::string& f_name,
+                      const std::vector<profiling::MetricCollector>& collectors, TVMArgs args) {
+    VMClosure clo = this->GetClosure(f_name);
+
+    std::vector<Device> devices;
+    for (auto dev : this->devices) {
+      if (dev.device_type > 0) {
+        devices.push_back(dev);
+      }
+    }
 
-        prof_ = profiling::Profiler(devices, {}, {{String("Executor"), String("VM")}});
+    prof_ = profiling::Profiler(devices, collectors, {{String("Executor"), String("VM")}});
 
-        auto inputs = GetInputsFor(f_name);
+    auto inputs = GetInputsFor(f_name);
 
-        bool clear_inputs = false;
-        if (inputs.size() == 0) {
-          ICHECK(args.num_args > 1) << "No input is provided";
-          TVMArgs f_args(args.values + 1, args.type_codes + 1, args.num_args - 1);
-          SetInput(f_name, false, TVMArgs(args.values + 1, args.type_codes + 1, args.num_args - 1));
-          inputs = GetInputsFor(f_name);
-          clear_inputs = true;
-        } else {
-          ICHECK_EQ(args.num_args, 1) << "Inputs are already provided by set_input.";
-        }
+    bool clear_inputs = false;
+    if (inputs.size() == 0) {
+      ICHECK(args.num_args > 0) << "No input is provided";
+      SetInput(f_name, false, args);
+      inputs = GetInputsFor(f_name);
+      clear_inputs = true;
+    } else {
+      ICHECK_EQ(args.num_args, 0) << "Inputs are already provided by set_input.";
+    }
 
-        // warmup
-        this->InvokeClosureInternal(clo, inputs);
+    // warmup
+    this->InvokeClosureInternal(clo, inputs);
 
-        prof_->Start();
-        this->InvokeClosureInternal(clo, inputs);
-        prof_->Stop();
+    prof_->Start();
+    this->InvokeClosureInternal(clo, inputs);
+    prof_->Stop();
 
-        // Return the report as json, since profiling::Report object is not supported by RPC
-        std::string report_json = prof_->Report()->AsJSON();
-        *rv = report_json;
+    // Return the report as json, since profiling::Report object is not supported by RPC
+    std::string report_json = prof_->Report()->AsJSON();
 
-        prof_ = std::nullopt;  // releases hardware counters
-        if (clear_inputs) {
-          // SetInput modifies the internal states of VM. Undo the change after profiling.
-          ClearInputsFor(f_name);
-        }
-      });
-    } else {
-      return VirtualMachineImpl::GetFunction(name, sptr_to_self);
+    prof_ = std::nullopt;  // releases hardware counters
+    if (clear_inputs) {
+      // SetInput modifies the internal states of VM. Undo the change after profiling.
+      ClearInputsFor(f_name);
     }
+    return report_json;
   }
 
- protected:
   void RunInstrCall(VMFrame* curr_frame, Instruction inst) override {
     bool profiling = false;
     if (prof_ && prof_->IsRunning()) {
@@ -1064,7 +2162,7 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
           auto reg = ReadRegister(curr_frame, arg.value());
           f_check_ndarray_arg(reg);
         } else if (arg.kind() == Instruction::ArgKind::kConstIdx) {
-          const auto& const_val = this->const_pool_[arg.value()];
+          const auto& const_val = program_->const_pool[arg.value()];
           f_check_ndarray_arg(const_val);
         }
       }
@@ -206,9 +206,46 @@ class ROCMDeviceAPI final : public DeviceAPI {
     }
   }
 
+  TVMEventHandle CreateEvent(Device dev) final {
+    ROCM_CALL(hipSetDevice(dev.device_id));
+    hipEvent_t evt;
+    ROCM_CALL(hipEventCreateWithFlags(&evt, hipEventDisableTiming));
+    return static_cast<TVMEventHandle>(evt);
+  }
+
+  void FreeEvent(Device dev, TVMEventHandle event) final {
+    ROCM_CALL(hipSetDevice(dev.device_id));
+    ROCM_CALL(hipEventDestroy(static_cast<hipEvent_t>(event)));
+  }
+
+  void RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) final {
+    ROCM_CALL(hipSetDevice(dev.device_id));
+    ROCM_CALL(hipEventRecord(static_cast<hipEvent_t>(event), static_cast<hipStream_t>(stream)));
+  }
+
+  void EventSync(Device dev, TVMEventHandle event) final {
+    ROCM_CALL(hipSetDevice(dev.device_id));
+    ROCM_CALL(hipEventSynchronize(static_cast<hipEvent_t>(event)));
+  }
+
+  bool EventQuery(Device dev, TVMEventHandle event) final {
+    ROCM_CALL(hipSetDevice(dev.device_id));
+    hipError_t err = hipEventQuery(static_cast<hipEvent_t>(event));
+    if (err == hipErrorNotReady) return false;
+    ROCM_CALL(err);
+    return true;
+  }
+
+  void StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event) final {
+    ROCM_CALL(hipSetDevice(dev.device_id));
+    ROCM_CALL(
+        hipStreamWaitEvent(static_cast<hipStream_t>(stream), static_cast<hipEvent_t>(event), 0));
+  }
+
   void StreamSync(Device dev, TVMStreamHandle stream) final {
     ROCM_CALL(hipSetDevice(dev.device_id));
     ROCM_CALL(hipStreamSynchronize(static_cast<hipStream_t>(stream)));
+    ROCMThreadEntry::ThreadLocal()->pool.SyncStream(dev, stream);
   }
 
   void SetStream(Device dev, TVMStreamHandle stream) final {
@@ -220,7 +257,8 @@ class ROCMDeviceAPI final : public DeviceAPI {
   }
 
   void* AllocWorkspace(Device dev, size_t size, DLDataType type_hint) final {
-    return ROCMThreadEntry::ThreadLocal()->pool.AllocWorkspace(dev, size);
+    ROCMThreadEntry* entry = ROCMThreadEntry::ThreadLocal();
+    return entry->pool.AllocWorkspace(dev, size, static_cast<TVMStreamHandle>(entry->stream));
   }
 
   void FreeWorkspace(Device dev, void* data) final {
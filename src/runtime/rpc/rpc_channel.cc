@@ -22,6 +22,12 @@
  */
 #include "rpc_channel.h"
 
+#ifdef TVM_RPC_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 namespace tvm {
@@ -49,5 +55,129 @@ size_t CallbackChannel::Recv(void* data, size_t size) {
   return bytes->length();
 }
 
+namespace {
+/*! \brief Frames smaller than this are not worth compressing. */
+constexpr size_t kMinCompressSize = 512;
+/*! \brief Frames skipped after one that does not compress well. */
+constexpr int kIncompressibleBackoff = 16;
+
+void EncodeFrameHeader(uint32_t raw_size, uint32_t payload_size, char* dst) {
+  memcpy(dst, &raw_size, sizeof(raw_size));
+  memcpy(dst + sizeof(raw_size), &payload_size, sizeof(payload_size));
+}
+}  // namespace
+
+CompressedChannel::CompressedChannel(std::unique_ptr<RPCChannel> channel, const std::string& codec)
+    : channel_(std::move(channel)) {
+  CHECK(Supported(codec)) << "RPC compression codec \"" << codec
+                          << "\" is not supported, please build with USE_RPC_COMPRESSION=ON";
+}
+
+bool CompressedChannel::Supported(const std::string& codec) {
+#ifdef TVM_RPC_USE_ZLIB
+  return codec == "zlib";
+#else
+  return false;
+#endif
+}
+
+std::string CompressedChannel::EncodeStoredFrame(const void* data, size_t size) {
+  ICHECK_LE(size, kMaxFrameSize);
+  std::string frame(sizeof(uint32_t) * 2 + size, '\0');
+  EncodeFrameHeader(size, size, &frame[0]);
+  memcpy(&frame[sizeof(uint32_t) * 2], data, size);
+  return frame;
+}
+
+void CompressedChannel::SendAll(const void* data, size_t size) {
+  const char* ptr = static_cast<const char*>(data);
+  while (size != 0) {
+    size_t n = channel_->Send(ptr, size);
+    CHECK_NE(n, 0U) << "CompressedChannel::Send: the channel is closed";
+    ptr += n;
+    size -= n;
+  }
+}
+
+bool CompressedChannel::RecvAll(void* data, size_t size) {
+  char* ptr = static_cast<char*>(data);
+  size_t total = size;
+  while (size != 0) {
+    size_t n = channel_->Recv(ptr, size);
+    if (n == 0) {
+      CHECK_EQ(size, total)
+          << "CompressedChannel::Recv: the channel closed in the middle of a frame";
+      return false;
+    }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+size_t CompressedChannel::Send(const void* data, size_t size) {
+  if (size == 0) return 0;
+  size = std::min(size, kMaxFrameSize);
+  constexpr size_t kHeaderSize = sizeof(uint32_t) * 2;
+  uint32_t payload_size = size;
+#ifdef TVM_RPC_USE_ZLIB
+  if (size >= kMinCompressSize && skip_compress_frames_ == 0) {
+    uLongf bound = compressBound(size);
+    send_buffer_.resize(kHeaderSize + bound);
+    int ret = compress2(reinterpret_cast<Bytef*>(send_buffer_.data() + kHeaderSize), &bound,
+                        static_cast<const Bytef*>(data), size, Z_BEST_SPEED);
+    // Keeps the frame compressed only when it saves at least 1/8 of the bytes,
+    // and otherwise backs off for a while, as the data is likely incompressible.
+    if (ret == Z_OK && bound < size - size / 8) {
+      payload_size = bound;
+    } else {
+      skip_compress_frames_ = kIncompressibleBackoff;
+    }
+  } else if (skip_compress_frames_ > 0) {
+    --skip_compress_frames_;
+  }
+#endif
+  if (payload_size == size) {
+    send_buffer_.resize(kHeaderSize + size);
+    memcpy(send_buffer_.data() + kHeaderSize, data, size);
+  }
+  EncodeFrameHeader(size, payload_size, send_buffer_.data());
+  SendAll(send_buffer_.data(), kHeaderSize + payload_size);
+  return size;
+}
+
+size_t CompressedChannel::Recv(void* data, size_t size) {
+  if (recv_offset_ == recv_buffer_.size()) {
+    uint32_t header[2];
+    if (!RecvAll(header, sizeof(header))) return 0;
+    uint32_t raw_size = header[0], payload_size = header[1];
+    CHECK(raw_size <= kMaxFrameSize && payload_size <= raw_size)
+        << "CompressedChannel::Recv: invalid frame, the peer may not use compression";
+    recv_buffer_.resize(raw_size);
+    recv_offset_ = 0;
+    if (payload_size == raw_size) {
+      CHECK(RecvAll(recv_buffer_.data(), raw_size))
+          << "CompressedChannel::Recv: the channel closed in the middle of a frame";
+    } else {
+      recv_payload_.resize(payload_size);
+      CHECK(RecvAll(recv_payload_.data(), payload_size))
+          << "CompressedChannel::Recv: the channel closed in the middle of a frame";
+#ifdef TVM_RPC_USE_ZLIB
+      uLongf decoded_size = raw_size;
+      int ret = uncompress(reinterpret_cast<Bytef*>(recv_buffer_.data()), &decoded_size,
+                           reinterpret_cast<const Bytef*>(recv_payload_.data()), payload_size);
+      CHECK(ret == Z_OK && decoded_size == raw_size)
+          << "CompressedChannel::Recv: failed to decompress the frame";
+#else
+      LOG(FATAL) << "CompressedChannel::Recv: compression is not supported in this build";
+#endif
+    }
+  }
+  size_t n = std::min(size, recv_buffer_.size() - recv_offset_);
+  memcpy(data, recv_buffer_.data() + recv_offset_, n);
+  recv_offset_ += n;
+  return n;
+}
+
 }  // namespace runtime
 }  // namespace tvm
@@ -26,7 +26,10 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace tvm {
 namespace runtime {
@@ -94,6 +97,57 @@ class CallbackChannel final : public RPCChannel {
   PackedFunc frecv_;
 };
 
+/*!
+ * \brief RPC channel that compresses the traffic of another channel.
+ *
+ * The data is sent as frames of `[raw_size(uint32), payload_size(uint32), payload]`.
+ * The payload is stored as-is when `payload_size == raw_size`, and compressed
+ * otherwise. Small or incompressible data is stored without compression.
+ * Both sides of the connection must agree on the codec during the handshake.
+ */
+class CompressedChannel final : public RPCChannel {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param channel The underlying channel.
+   * \param codec The name of the compression codec. Only "zlib" is supported.
+   */
+  CompressedChannel(std::unique_ptr<RPCChannel> channel, const std::string& codec);
+  /*!
+   * \brief Check whether the compression codec is supported in this build.
+   * \param codec The name of the codec.
+   */
+  static bool Supported(const std::string& codec);
+  /*!
+   * \brief Encode data as a single uncompressed frame.
+   * \param data The data pointer.
+   * \param size The size of the data, at most kMaxFrameSize.
+   * \return The encoded frame.
+   */
+  static std::string EncodeStoredFrame(const void* data, size_t size);
+
+  size_t Send(const void* data, size_t size) final;
+  size_t Recv(void* data, size_t size) final;
+
+  /*! \brief The maximum number of raw bytes in one frame. */
+  static constexpr size_t kMaxFrameSize = 1 << 20;
+
+ private:
+  void SendAll(const void* data, size_t size);
+  bool RecvAll(void* data, size_t size);
+
+  std::unique_ptr<RPCChannel> channel_;
+  /*! \brief The frame being sent. */
+  std::vector<char> send_buffer_;
+  /*! \brief The decoded data of the last received frame. */
+  std::vector<char> recv_buffer_;
+  /*! \brief The payload of the frame being received. */
+  std::vector<char> recv_payload_;
+  size_t recv_offset_{0};
+  /*! \brief The number of upcoming frames stored without trying to compress. */
+  int skip_compress_frames_{0};
+};
+
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_RPC_RPC_CHANNEL_H_
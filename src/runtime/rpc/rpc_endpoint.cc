@@ -31,8 +31,10 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -871,7 +873,8 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_v
   ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
 }
 
-void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                               uint64_t block_size, int window) {
   std::lock_guard<std::mutex> lock(mutex_);
   RPCCode code = RPCCode::kCopyToRemote;
 
@@ -879,19 +882,50 @@ void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes)
   ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
-
-  uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, nbytes);
-  uint64_t packet_nbytes = overhead + nbytes;
-
-  handler_->Write(packet_nbytes);
-  handler_->Write(code);
-  RPCReference::SendDLTensor(handler_, to);
-  handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+  ICHECK_GT(block_size, 0U);
+  ICHECK_GT(window, 0);
+
+  DLTensor block = *to;
+  int num_inflight = 0;
+  try {
+    for (uint64_t offset = 0; offset < nbytes; offset += block_size) {
+      if (num_inflight == window) {
+        ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+        --num_inflight;
+      }
+      uint64_t block_nbytes = std::min(block_size, nbytes - offset);
+      block.byte_offset = to->byte_offset + offset;
+      uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(&block, code, block_nbytes);
+      uint64_t packet_nbytes = overhead + block_nbytes;
+
+      handler_->Write(packet_nbytes);
+      handler_->Write(code);
+      RPCReference::SendDLTensor(handler_, &block);
+      handler_->Write(block_nbytes);
+      handler_->WriteArray(reinterpret_cast<char*>(from_bytes) + offset, block_nbytes);
+      ++num_inflight;
+      // Push the packet out right away so that the remote starts on it
+      // while the next one is being serialized.
+      if (window > 1) {
+        while (writer_.bytes_available() != 0) {
+          writer_.ReadWithCallback(
+              [this](const void* data, size_t size) { return channel_->Send(data, size); },
+              writer_.bytes_available());
+        }
+      }
+    }
+    for (; num_inflight > 0; --num_inflight) {
+      ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+    }
+  } catch (const Error&) {
+    // The failed reply has been consumed, keep the stream in sync for the rest.
+    DrainCopyReplies(num_inflight - 1);
+    throw;
+  }
 }
 
-void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
+void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                 uint64_t block_size, int window) {
   std::lock_guard<std::mutex> lock(mutex_);
   RPCCode code = RPCCode::kCopyFromRemote;
 
@@ -899,18 +933,61 @@ void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes
   ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ICHECK_GT(block_size, 0U);
+  ICHECK_GT(window, 0);
 
-  uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(from, code, nbytes);
-  uint64_t packet_nbytes = overhead;
+  DLTensor block = *from;
+  uint64_t send_offset = 0;
+  auto send_request = [&]() {
+    uint64_t block_nbytes = std::min(block_size, nbytes - send_offset);
+    block.byte_offset = from->byte_offset + send_offset;
+    uint64_t packet_nbytes = RemoteCopyCalculatePacketOverheadSize(&block, code, block_nbytes);
 
-  handler_->Write(packet_nbytes);
-  handler_->Write(code);
-  RPCReference::SendDLTensor(handler_, from);
-  handler_->Write(nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+    handler_->Write(packet_nbytes);
+    handler_->Write(code);
+    RPCReference::SendDLTensor(handler_, &block);
+    handler_->Write(block_nbytes);
+    send_offset += block_nbytes;
+  };
+
+  int num_inflight = 0;
+  try {
+    for (; num_inflight < window && send_offset < nbytes; ++num_inflight) {
+      send_request();
+    }
+    for (uint64_t recv_offset = 0; recv_offset < nbytes;) {
+      uint64_t block_nbytes = std::min(block_size, nbytes - recv_offset);
+      ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+      --num_inflight;
+      handler_->ReadArray(reinterpret_cast<char*>(to_bytes) + recv_offset, block_nbytes);
+      handler_->FinishCopyAck();
+      recv_offset += block_nbytes;
+      if (send_offset < nbytes) {
+        send_request();
+        ++num_inflight;
+      }
+    }
+  } catch (const Error&) {
+    DrainCopyReplies(num_inflight - 1);
+    throw;
+  }
+}
 
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
-  handler_->FinishCopyAck();
+void RPCEndpoint::DrainCopyReplies(int num_replies) {
+  for (int i = 0; i < num_replies; ++i) {
+    try {
+      RPCCode code = HandleUntilReturnEvent(true, [](TVMArgs) {});
+      if (code == RPCCode::kCopyAck) {
+        // Discard the data of the copy.
+        std::vector<char> discard(reader_.bytes_available());
+        handler_->ReadArray(discard.data(), discard.size());
+        handler_->FinishCopyAck();
+      } else if (code == RPCCode::kShutdown) {
+        return;
+      }
+    } catch (const Error&) {
+    }
+  }
 }
 
 // SysCallEventHandler functions
@@ -1067,6 +1144,22 @@ void RPCEndpoint::EventHandler::HandleSyscall(RPCCode code) {
   }
 }
 
+/*!
+ * \brief The process-wide configuration of pipelined remote copies,
+ * set through "rpc.SetCopyPipeline".
+ */
+struct RPCCopyPipelineConfig {
+  /*! \brief The number of data bytes in each packet. */
+  std::atomic<uint64_t> block_size{4 << 20};
+  /*! \brief The number of packets in flight. */
+  std::atomic<int> window{4};
+
+  static RPCCopyPipelineConfig* Global() {
+    static RPCCopyPipelineConfig* config = new RPCCopyPipelineConfig();
+    return config;
+  }
+};
+
 /*!
  * \brief RPC client session that proxies all calls to an endpoint.
  */
@@ -1092,25 +1185,8 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
     uint64_t rpc_max_size = GetRPCMaxTransferSize();
     ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* from_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, remainder_bytes);
-    }
+    const uint64_t block_size = std::min(rpc_max_size - overhead, GetCopyBlockSize());
+    endpoint_->CopyToRemote(local_from_bytes, remote_to, nbytes, block_size, GetCopyWindow());
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
@@ -1118,25 +1194,8 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
     uint64_t rpc_max_size = GetRPCMaxTransferSize();
     ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* to_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, remainder_bytes);
-    }
+    const uint64_t block_size = std::min(rpc_max_size - overhead, GetCopyBlockSize());
+    endpoint_->CopyFromRemote(remote_from, local_to_bytes, nbytes, block_size, GetCopyWindow());
   }
 
   void FreeHandle(void* handle, int type_code) final {
@@ -1232,10 +1291,35 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     return (uint64_t)rpc_chunk_max_size_bytes_;
   }
 
+  uint64_t GetCopyBlockSize() {
+    // Only split the copy when it can be pipelined, or when the remote
+    // limits the packet size, see GetRPCMaxTransferSize.
+    return GetCopyWindow() > 1 ? RPCCopyPipelineConfig::Global()->block_size.load()
+                               : std::numeric_limits<uint64_t>::max();
+  }
+
+  int GetCopyWindow() {
+    if (remote_supports_pipelined_copy_ < 0) {
+      // Servers that process packets in an async event loop (e.g. the web runtime)
+      // may leave queued packets unprocessed, so pipelining requires opt-in.
+      remote_supports_pipelined_copy_ =
+          GetFunction("tvm.rpc.server.SupportPipelinedCopy") != nullptr;
+    }
+    return remote_supports_pipelined_copy_ ? RPCCopyPipelineConfig::Global()->window.load() : 1;
+  }
+
   std::shared_ptr<RPCEndpoint> endpoint_;
   int64_t rpc_chunk_max_size_bytes_ = -1;
+  int remote_supports_pipelined_copy_ = -1;
 };
 
+TVM_REGISTER_GLOBAL("rpc.SetCopyPipeline").set_body_typed([](int64_t block_size, int window) {
+  CHECK_GT(block_size, 0) << "ValueError: The copy block size must be positive";
+  CHECK_GT(window, 0) << "ValueError: The copy window must be positive";
+  RPCCopyPipelineConfig::Global()->block_size = block_size;
+  RPCCopyPipelineConfig::Global()->window = window;
+});
+
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
   return std::make_shared<RPCClientSession>(endpoint);
 }
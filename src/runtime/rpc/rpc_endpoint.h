@@ -142,26 +142,26 @@ class RPCEndpoint {
                 const int* arg_type_codes, int num_args, RPCSession::FEncodeReturn encode_return);
   /*!
    * \brief Copy bytes into remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
+   * \param from_bytes The source host data.
    * \param to The target array.
-   * \param to_offset The byte offset in the to.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_to The target device.
-   * \param type_hint Hint of content data type.
+   * \param block_size The maximum number of data bytes sent in one packet.
+   * \param window The maximum number of packets in flight before waiting for
+   *   an acknowledgement, so that the transfer overlaps with the remote copy.
    */
-  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes, uint64_t block_size,
+                    int window);
   /*!
    * \brief Copy bytes from remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
-   * \param to The target array.
-   * \param to_offset The byte offset in the to.
+   * \param from The source array.
+   * \param to_bytes The target host data.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_from The source device.
-   * \param type_hint Hint of content data type.
+   * \param block_size The maximum number of data bytes received in one packet.
+   * \param window The maximum number of requests in flight before receiving
+   *   the data, so that the transfer overlaps with the remote copy.
    */
-  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
+  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes, uint64_t block_size,
+                      int window);
 
   /*!
    * \brief Call a remote defined system function with arguments.
@@ -189,6 +189,8 @@ class RPCEndpoint {
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
+  // Receive the replies of pipelined copies left in flight after an error.
+  void DrainCopyReplies(int num_replies);
   // Initalization
   void Init();
   // Internal channel.
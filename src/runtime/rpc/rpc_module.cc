@@ -21,6 +21,11 @@
  * \file rpc_module.cc
  * \brief RPC runtime module.
  */
+#define PICOJSON_USE_INT64
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+#include <picojson.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/profiling.h>
@@ -28,8 +33,13 @@
 
 #include <chrono>
 #include <cstring>
+#include <map>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 #if defined(_M_X64) || defined(__x86_64__)
 #include <immintrin.h>
 #endif
@@ -221,6 +231,24 @@ class RPCModuleNode final : public ModuleNode {
     }
   }
 
+  PackedFunc GetBatchTimeEvaluator(const std::string& spec, Device dev, int number, int repeat,
+                                   int min_repeat_ms, int limit_zero_time_iterations,
+                                   int cooldown_interval_ms, int repeats_to_cooldown,
+                                   int cache_flush_bytes, const std::string& f_preproc_name) {
+    InitRemoteFunc(&remote_get_batch_time_evaluator_, "runtime.RPCBatchTimeEvaluator");
+    // Remove session mask because we pass dev by parts.
+    ICHECK_EQ(GetRPCSessionIndex(dev), sess_->table_index())
+        << "ValueError: Need to pass the matched remote device to "
+           "RPCModule.GetBatchTimeEvaluator";
+    dev = RemoveRPCSessionMask(dev);
+    ICHECK(module_handle_ != nullptr)
+        << "ValueError: The batched time evaluator requires a module holding the functions";
+    return remote_get_batch_time_evaluator_(
+        GetRef<Module>(this), spec, static_cast<int>(dev.device_type), dev.device_id, number,
+        repeat, min_repeat_ms, limit_zero_time_iterations, cooldown_interval_ms,
+        repeats_to_cooldown, cache_flush_bytes, f_preproc_name);
+  }
+
   Module LoadModule(std::string name) {
     InitRemoteFunc(&remote_load_module_, "tvm.rpc.server.load_module");
     return remote_load_module_(name);
@@ -258,6 +286,10 @@ class RPCModuleNode final : public ModuleNode {
   TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, int, int, int,
                              int, std::string)>
       remote_get_time_evaluator_;
+  // remote function to get batched time evaluator
+  TypedPackedFunc<PackedFunc(Module, std::string, int, int, int, int, int, int, int, int, int,
+                             std::string)>
+      remote_get_batch_time_evaluator_;
   // remote function getter for modules.
   TypedPackedFunc<PackedFunc(Module, std::string, bool)> remote_mod_get_function_;
   // remote function getter for load module
@@ -423,6 +455,128 @@ TVM_REGISTER_GLOBAL("runtime.RPCTimeEvaluator")
       }
     });
 
+/*!
+ * \brief Time many functions of a module in one call. The arguments of the functions are allocated
+ *  and randomly filled once, and shared by the functions that take the same argument at the same
+ *  position.
+ * \param mod The module holding the functions.
+ * \param spec The functions to be timed and their arguments, in JSON:
+ *  {"funcs": [{"name": "f", "args": [["float32", [128, 128]], ...]}, ...]}
+ * \return A function that, when called without arguments, times all the functions. It returns a
+ *  JSON array with the `repeat` time costs in seconds of each function, or the error message if
+ *  that function fails.
+ * \sa profiling::WrapTimeEvaluator for the rest of the parameters.
+ */
+PackedFunc WrapBatchTimeEvaluator(Module mod, const std::string& spec, Device dev, int number,
+                                  int repeat, int min_repeat_ms, int limit_zero_time_iterations,
+                                  int cooldown_interval_ms, int repeats_to_cooldown,
+                                  int cache_flush_bytes, PackedFunc f_preproc) {
+  struct Candidate {
+    std::string name;
+    std::vector<std::pair<DLDataType, ShapeTuple>> args;
+  };
+  picojson::value json;
+  std::string err = picojson::parse(json, spec);
+  ICHECK(err.empty()) << "ValueError: Malformed spec of the batched time evaluator: " << err;
+  std::vector<Candidate> candidates;
+  for (const picojson::value& func : json.get("funcs").get<picojson::array>()) {
+    Candidate candidate;
+    candidate.name = func.get("name").get<std::string>();
+    for (const picojson::value& arg : func.get("args").get<picojson::array>()) {
+      const picojson::array& arg_info = arg.get<picojson::array>();
+      ICHECK_EQ(arg_info.size(), 2) << "ValueError: An argument is specified by dtype and shape";
+      std::vector<ShapeTuple::index_type> shape;
+      for (const picojson::value& dim : arg_info[1].get<picojson::array>()) {
+        shape.push_back(dim.get<int64_t>());
+      }
+      candidate.args.emplace_back(String2DLDataType(arg_info[0].get<std::string>()),
+                                  ShapeTuple(shape));
+    }
+    candidates.push_back(std::move(candidate));
+  }
+  return PackedFunc([=](TVMArgs args, TVMRetValue* rv) mutable {
+    static const PackedFunc* f_random_fill = [] {
+      const PackedFunc* f = Registry::Get("tvm.contrib.random.random_fill_for_measure");
+      return f != nullptr ? f : Registry::Get("tvm.contrib.random.random_fill");
+    }();
+    // The arguments allocated, keyed by their position, dtype and shape
+    std::map<std::string, NDArray> pool;
+    picojson::array results;
+    for (const Candidate& candidate : candidates) {
+      try {
+        int num_args = candidate.args.size();
+        std::vector<NDArray> arrays;
+        arrays.reserve(num_args);
+        for (int i = 0; i < num_args; ++i) {
+          const auto& [dtype, shape] = candidate.args[i];
+          std::ostringstream key;
+          key << i << ":" << DLDataType2String(dtype);
+          for (ShapeTuple::index_type dim : shape) {
+            key << "," << dim;
+          }
+          NDArray& array = pool[key.str()];
+          if (!array.defined()) {
+            array = NDArray::Empty(shape, dtype, dev);
+            if (f_random_fill != nullptr) {
+              (*f_random_fill)(array);
+            }
+          }
+          arrays.push_back(array);
+        }
+        PackedFunc pf = mod.GetFunction(candidate.name, true);
+        CHECK(pf != nullptr) << "Cannot find " << candidate.name << " in the module";
+        PackedFunc feval = profiling::WrapTimeEvaluator(
+            pf, dev, number, repeat, min_repeat_ms, limit_zero_time_iterations,
+            cooldown_interval_ms, repeats_to_cooldown, cache_flush_bytes, f_preproc);
+        std::vector<TVMValue> values(num_args);
+        std::vector<int> type_codes(num_args);
+        TVMArgsSetter setter(values.data(), type_codes.data());
+        for (int i = 0; i < num_args; ++i) {
+          setter(i, arrays[i]);
+        }
+        TVMRetValue ret;
+        feval.CallPacked(TVMArgs(values.data(), type_codes.data(), num_args), &ret);
+        std::string blob = ret;
+        const double* costs = reinterpret_cast<const double*>(blob.data());
+        picojson::array costs_json;
+        for (size_t r = 0; r < blob.size() / sizeof(double); ++r) {
+          costs_json.push_back(picojson::value(costs[r]));
+        }
+        results.push_back(picojson::value(costs_json));
+      } catch (const std::exception& e) {
+        results.push_back(picojson::value(std::string(e.what())));
+      }
+    }
+    *rv = picojson::value(results).serialize();
+  });
+}
+
+TVM_REGISTER_GLOBAL("runtime.RPCBatchTimeEvaluator")
+    .set_body_typed([](Module mod, std::string spec, int device_type, int device_id, int number,
+                       int repeat, int min_repeat_ms, int limit_zero_time_iterations,
+                       int cooldown_interval_ms, int repeats_to_cooldown, int cache_flush_bytes,
+                       std::string f_preproc_name) {
+      Device dev;
+      dev.device_type = static_cast<DLDeviceType>(device_type);
+      dev.device_id = device_id;
+      if (mod->type_key() == std::string("rpc")) {
+        return static_cast<RPCModuleNode*>(mod.operator->())
+            ->GetBatchTimeEvaluator(spec, dev, number, repeat, min_repeat_ms,
+                                    limit_zero_time_iterations, cooldown_interval_ms,
+                                    repeats_to_cooldown, cache_flush_bytes, f_preproc_name);
+      }
+      PackedFunc f_preproc;
+      if (!f_preproc_name.empty()) {
+        auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
+        ICHECK(pf_preproc != nullptr)
+            << "Cannot find " << f_preproc_name << " in the global function";
+        f_preproc = *pf_preproc;
+      }
+      return WrapBatchTimeEvaluator(mod, spec, dev, number, repeat, min_repeat_ms,
+                                    limit_zero_time_iterations, cooldown_interval_ms,
+                                    repeats_to_cooldown, cache_flush_bytes, f_preproc);
+    });
+
 TVM_REGISTER_GLOBAL("cache_flush_cpu_non_first_arg").set_body([](TVMArgs args, TVMRetValue* rv) {
   CPUCacheFlush(1, args);
 });
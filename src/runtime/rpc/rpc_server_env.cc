@@ -52,6 +52,9 @@ TVM_REGISTER_GLOBAL("tvm.rpc.server.download").set_body([](TVMArgs args, TVMRetV
   *rv = arr;
 });
 
+// Native servers process queued packets in order, so clients may pipeline copies.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.SupportPipelinedCopy").set_body_typed([]() { return true; });
+
 TVM_REGISTER_GLOBAL("tvm.rpc.server.remove").set_body([](TVMArgs args, TVMRetValue* rv) {
   std::string file_name = RPCGetPath(args[0]);
   RemoveFile(file_name);
@@ -24,6 +24,7 @@
 #include <tvm/runtime/registry.h>
 
 #include <memory>
+#include <string>
 
 #include "../../support/socket.h"
 #include "rpc_endpoint.h"
@@ -64,6 +65,18 @@ class SockChannel final : public RPCChannel {
   support::TCPSocket sock_;
 };
 
+/*!
+ * \brief Get the codec of the "-compress=<codec>" option in a handshake key.
+ * \return The codec, or an empty string if the option is absent.
+ */
+std::string GetCompressionOption(const std::string& key) {
+  const std::string option = " -compress=";
+  size_t pos = key.find(option);
+  if (pos == std::string::npos) return "";
+  size_t begin = pos + option.length();
+  return key.substr(begin, key.find(' ', begin) - begin);
+}
+
 std::shared_ptr<RPCEndpoint> RPCConnect(std::string url, int port, std::string key,
                                         bool enable_logging, TVMArgs init_seq) {
   support::TCPSocket sock;
@@ -98,6 +111,11 @@ std::shared_ptr<RPCEndpoint> RPCConnect(std::string url, int port, std::string k
   }
 
   std::unique_ptr<RPCChannel> channel = std::make_unique<SockChannel>(sock);
+  // The server echoes the compression option in its key once it accepts it.
+  std::string codec = GetCompressionOption(key);
+  if (!codec.empty() && GetCompressionOption(remote_key) == codec) {
+    channel = std::make_unique<CompressedChannel>(std::move(channel), codec);
+  }
   if (enable_logging) {
     channel.reset(new RPCChannelLogging(std::move(channel)));
   }
@@ -113,12 +131,18 @@ Module RPCClientConnect(std::string url, int port, std::string key, bool enable_
   return CreateRPCSessionModule(CreateClientSession(endpt));
 }
 
-// TVM_DLL needed for MSVC
-TVM_DLL void RPCServerLoop(int sockfd) {
+void RPCServerLoop(int sockfd, const std::string& codec) {
   support::TCPSocket sock(static_cast<support::TCPSocket::SockType>(sockfd));
-  RPCEndpoint::Create(std::make_unique<SockChannel>(sock), "SockServerLoop", "")->ServerLoop();
+  std::unique_ptr<RPCChannel> channel = std::make_unique<SockChannel>(sock);
+  if (!codec.empty()) {
+    channel = std::make_unique<CompressedChannel>(std::move(channel), codec);
+  }
+  RPCEndpoint::Create(std::move(channel), "SockServerLoop", "")->ServerLoop();
 }
 
+// TVM_DLL needed for MSVC
+TVM_DLL void RPCServerLoop(int sockfd) { RPCServerLoop(sockfd, ""); }
+
 void RPCServerLoop(PackedFunc fsend, PackedFunc frecv) {
   RPCEndpoint::Create(std::make_unique<CallbackChannel>(fsend, frecv), "SockServerLoop", "")
       ->ServerLoop();
@@ -135,7 +159,9 @@ TVM_REGISTER_GLOBAL("rpc.Connect").set_body([](TVMArgs args, TVMRetValue* rv) {
 
 TVM_REGISTER_GLOBAL("rpc.ServerLoop").set_body([](TVMArgs args, TVMRetValue* rv) {
   if (args[0].type_code() == kDLInt) {
-    RPCServerLoop(args[0]);
+    int sockfd = args[0];
+    std::string codec = args.size() > 1 ? args[1].operator std::string() : "";
+    RPCServerLoop(sockfd, codec);
   } else {
     RPCServerLoop(args[0].operator tvm::runtime::PackedFunc(),
                   args[1].operator tvm::runtime::PackedFunc());
@@ -167,10 +193,49 @@ class SimpleSockHandler : public dmlc::Stream {
   support::TCPSocket sock_;
 };
 
-TVM_REGISTER_GLOBAL("rpc.ReturnException").set_body_typed([](int sockfd, String msg) {
-  auto handler = SimpleSockHandler(sockfd);
-  RPCReference::ReturnException(msg.c_str(), &handler);
-  return;
+class BufferStream : public dmlc::Stream {
+ public:
+  using dmlc::Stream::Read;
+  using dmlc::Stream::ReadArray;
+  using dmlc::Stream::Write;
+  using dmlc::Stream::WriteArray;
+
+  // Unused here, implemented for microTVM framing layer.
+  void MessageStart(uint64_t packet_nbytes) {}
+  void MessageDone() {}
+
+  size_t Read(void* data, size_t size) final {
+    LOG(FATAL) << "BufferStream is write only";
+    return 0;
+  }
+  size_t Write(const void* data, size_t size) final {
+    this->data.append(static_cast<const char*>(data), size);
+    return size;
+  }
+
+  std::string data;
+};
+
+TVM_REGISTER_GLOBAL("rpc.ReturnException").set_body([](TVMArgs args, TVMRetValue* rv) {
+  int sockfd = args[0];
+  String msg = args[1];
+  std::string codec = args.size() > 2 ? args[2].operator std::string() : "";
+  if (codec.empty()) {
+    auto handler = SimpleSockHandler(sockfd);
+    RPCReference::ReturnException(msg.c_str(), &handler);
+  } else {
+    // Wrap the message in a frame that the compressed channel of the client can decode.
+    BufferStream buffer;
+    RPCReference::ReturnException(msg.c_str(), &buffer);
+    std::string frame =
+        CompressedChannel::EncodeStoredFrame(buffer.data.data(), buffer.data.size());
+    support::TCPSocket sock(static_cast<support::TCPSocket::SockType>(sockfd));
+    ICHECK_EQ(sock.SendAll(frame.data(), frame.size()), frame.size());
+  }
+});
+
+TVM_REGISTER_GLOBAL("rpc.CompressionSupported").set_body_typed([](std::string codec) {
+  return CompressedChannel::Supported(codec);
 });
 
 }  // namespace runtime
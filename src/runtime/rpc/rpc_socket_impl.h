@@ -24,6 +24,8 @@
 #ifndef TVM_RUNTIME_RPC_RPC_SOCKET_IMPL_H_
 #define TVM_RUNTIME_RPC_RPC_SOCKET_IMPL_H_
 
+#include <string>
+
 namespace tvm {
 namespace runtime {
 
@@ -33,6 +35,13 @@ namespace runtime {
  */
 void RPCServerLoop(int sockfd);
 
+/*!
+ * \brief RPCServerLoop Start the rpc server loop over a compressed channel.
+ * \param sockfd Socket file descriptor
+ * \param codec The compression codec agreed in the handshake, or empty for none.
+ */
+void RPCServerLoop(int sockfd, const std::string& codec);
+
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_RPC_RPC_SOCKET_IMPL_H_
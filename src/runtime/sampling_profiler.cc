@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file sampling_profiler.cc
+ * \brief The always-on sampling profiler.
+ */
+#include "sampling_profiler.h"
+
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "../support/str_escape.h"
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief The number of samples kept by default. */
+static constexpr int64_t kDefaultSampleCapacity = 1 << 16;
+
+SamplingProfiler::SamplingProfiler() {
+  if (const char* period = std::getenv("TVM_PROFILING_SAMPLE_PERIOD")) {
+    Configure(std::atoll(period), kDefaultSampleCapacity, false);
+  }
+}
+
+SamplingProfiler* SamplingProfiler::Global() {
+  static SamplingProfiler* inst = new SamplingProfiler();
+  return inst;
+}
+
+void SamplingProfiler::Record(uint64_t invocation, const std::string& name, Device dev, int depth,
+                              std::chrono::system_clock::time_point begin,
+                              std::chrono::system_clock::time_point end) {
+  support::LockFreeRingBuffer<Sample>* ring = ring_.load(std::memory_order_acquire);
+  if (ring == nullptr) return;
+  Sample sample;
+  sample.invocation = invocation;
+  sample.begin_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(begin.time_since_epoch()).count();
+  sample.duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+  sample.device_type = static_cast<int32_t>(dev.device_type);
+  sample.device_id = dev.device_id;
+  sample.depth = depth;
+  size_t length = std::min(name.size(), sizeof(sample.name) - 1);
+  memcpy(sample.name, name.data(), length);
+  sample.name[length] = '\0';
+  ring->Push(sample);
+}
+
+void SamplingProfiler::Configure(int64_t period, int64_t capacity, bool sync_device) {
+  CHECK_GE(period, 0) << "ValueError: The sampling period must be non-negative, but got "
+                      << period;
+  std::lock_guard<std::mutex> lock(mutex_);
+  support::LockFreeRingBuffer<Sample>* ring = ring_.load(std::memory_order_relaxed);
+  if (period > 0 && (ring == nullptr || ring->capacity() < static_cast<size_t>(capacity))) {
+    CHECK_GT(capacity, 0) << "ValueError: The sample capacity must be positive, but got "
+                          << capacity;
+    rings_.emplace_back(new support::LockFreeRingBuffer<Sample>(capacity));
+    ring_.store(rings_.back().get(), std::memory_order_release);
+  }
+  sync_device_.store(sync_device, std::memory_order_relaxed);
+  period_.store(period, std::memory_order_relaxed);
+}
+
+std::string SamplingProfiler::Drain() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ostringstream os;
+  uint64_t num_lost = 0;
+  os << "{\"samples\":[";
+  if (support::LockFreeRingBuffer<Sample>* ring = ring_.load(std::memory_order_acquire)) {
+    bool first = true;
+    num_lost = ring->Drain([&](const Sample& sample) {
+      if (!first) os << ",";
+      first = false;
+      Device dev{static_cast<DLDeviceType>(sample.device_type), sample.device_id};
+      os << "{\"invocation\":" << sample.invocation << ",\"name\":\""
+         << support::StrEscape(sample.name, strlen(sample.name)) << "\",\"device\":\""
+         << DeviceString(dev) << "\",\"depth\":" << sample.depth
+         << ",\"begin_ns\":" << sample.begin_ns << ",\"duration_ns\":" << sample.duration_ns
+         << "}";
+    });
+  }
+  os << "],\"num_lost\":" << num_lost << "}";
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.ConfigureSampling")
+    .set_body_typed([](int64_t period, int64_t capacity, bool sync_device) {
+      SamplingProfiler::Global()->Configure(period, capacity, sync_device);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.profiling.DrainSamples").set_body_typed([]() {
+  return SamplingProfiler::Global()->Drain();
+});
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file sampling_profiler.h
+ * \brief An always-on profiler recording one in every N invocations of the VM functions.
+ */
+#ifndef TVM_RUNTIME_SAMPLING_PROFILER_H_
+#define TVM_RUNTIME_SAMPLING_PROFILER_H_
+
+#include <tvm/runtime/device_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../support/ring_buffer.h"
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief A sampled invocation of a VM function, or a call within it. */
+struct Sample {
+  /*! \brief The id of the sampled invocation, shared by the calls within it. */
+  uint64_t invocation;
+  /*! \brief The wall clock time the invocation or call starts, since epoch. */
+  int64_t begin_ns;
+  /*! \brief The host time spent, including the device time when the devices are synchronized. */
+  int64_t duration_ns;
+  /*! \brief The device of the tensor arguments, CPU if there is none. */
+  int32_t device_type;
+  int32_t device_id;
+  /*! \brief 0 for the VM function invoked, or the VM frame depth of a call within it. */
+  int32_t depth;
+  /*! \brief The name of the function, truncated. */
+  char name[52];
+};
+
+/*!
+ * \brief The sampling profiler, which keeps the latest samples in a lock-free ring to be scraped.
+ *
+ *  It is disabled unless the sampling period is set, by `runtime.profiling.ConfigureSampling`
+ *  or the environment variable TVM_PROFILING_SAMPLE_PERIOD. The invocations not sampled only
+ *  pay for ShouldSample. The samples are scraped by `runtime.profiling.DrainSamples`.
+ */
+class SamplingProfiler {
+ public:
+  /*! \brief The global sampling profiler. */
+  static SamplingProfiler* Global();
+
+  /*! \brief Whether the next invocation on the calling thread is sampled. */
+  bool ShouldSample() {
+    int64_t period = period_.load(std::memory_order_relaxed);
+    if (period <= 0) return false;
+    thread_local uint64_t count = 0;
+    return ++count % period == 0;
+  }
+  /*! \brief Whether the devices are synchronized after each call of the sampled invocations. */
+  bool sync_device() const { return sync_device_.load(std::memory_order_relaxed); }
+  /*! \brief A new invocation id. */
+  uint64_t NewInvocation() { return next_invocation_.fetch_add(1, std::memory_order_relaxed); }
+  /*!
+   * \brief Record a sample.
+   * \param invocation The id of the sampled invocation.
+   * \param name The name of the function.
+   * \param dev The device of the call.
+   * \param depth 0 for the VM function invoked, or the VM frame depth of the call.
+   * \param begin The time the function or call starts.
+   * \param end The time the function or call ends.
+   */
+  void Record(uint64_t invocation, const std::string& name, Device dev, int depth,
+              std::chrono::system_clock::time_point begin,
+              std::chrono::system_clock::time_point end);
+  /*!
+   * \brief Configure the sampling.
+   * \param period Sample one in every `period` invocations per thread, 0 to disable.
+   * \param capacity The number of latest samples kept between two drains.
+   * \param sync_device Whether to synchronize the devices after each sampled call.
+   */
+  void Configure(int64_t period, int64_t capacity, bool sync_device);
+  /*!
+   * \brief Drain the samples recorded since the last drain.
+   * \return The samples and the number of samples lost, serialized as json.
+   */
+  std::string Drain();
+
+ private:
+  SamplingProfiler();
+
+  /*! \brief The sampling period, 0 if disabled. */
+  std::atomic<int64_t> period_{0};
+  /*! \brief Whether to synchronize the devices after each sampled call. */
+  std::atomic<bool> sync_device_{false};
+  /*! \brief The next invocation id. */
+  std::atomic<uint64_t> next_invocation_{0};
+  /*! \brief The ring of the latest samples. */
+  std::atomic<support::LockFreeRingBuffer<Sample>*> ring_{nullptr};
+  /*! \brief The rings, kept alive since producers may still push to the replaced ones. */
+  std::vector<std::unique_ptr<support::LockFreeRingBuffer<Sample>>> rings_;
+  /*! \brief The mutex of the drain and the configuration. */
+  std::mutex mutex_;
+};
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_SAMPLING_PROFILER_H_
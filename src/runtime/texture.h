@@ -94,6 +94,20 @@ inline bool IsTextureStorage(std::string scope) {
   return scope.find("texture") != std::string::npos;
 }
 
+/*! \brief Statistics of a texture pool. */
+struct TexturePoolStats {
+  /*! \brief The number of allocations served by a pooled texture. */
+  uint64_t num_hits{0};
+  /*! \brief The number of allocations creating a new texture. */
+  uint64_t num_misses{0};
+  /*! \brief The number of pooled textures released to stay within the memory budget. */
+  uint64_t num_trims{0};
+  /*! \brief The number of bytes of the textures in use. */
+  size_t allocated_bytes{0};
+  /*! \brief The number of bytes of the pooled textures. */
+  size_t free_bytes{0};
+};
+
 class TVM_DLL Pool2D {
  public:
   Pool2D() = default;
@@ -101,6 +115,23 @@ class TVM_DLL Pool2D {
   void Free(void* data);
   // Release all resources immediately
   void Release(Device dev, DeviceAPI* device);
+  /*!
+   * \brief Limit the memory held by the pool. Before creating a texture that would exceed the
+   *  budget, the pooled textures are released, least recently freed first.
+   * \param dev The device of the pool.
+   * \param device The device API.
+   * \param budget The budget in bytes, 0 for no limit.
+   */
+  void SetMemoryBudget(Device dev, DeviceAPI* device, size_t budget);
+  /*! \brief Return the statistics of the pool. */
+  const TexturePoolStats& GetStats() const { return stats_; }
+  /*!
+   * \brief Round the extent of a texture up to its size class.
+   *
+   *  There are four size classes per power of two, so rounding wastes less than a quarter of the
+   *  extent and never crosses a power of two, which maximum texture extents usually are.
+   */
+  static size_t SizeClass(size_t extent);
 
  protected:
   struct Entry {
@@ -109,8 +140,15 @@ class TVM_DLL Pool2D {
     size_t y;
     DLDataType type;
   };
+  /*! \brief The number of bytes of a texture. */
+  static size_t EntryBytes(const Entry& e);
+  /*! \brief Release pooled textures until a new texture of the given size fits the budget. */
+  void Trim(Device dev, DeviceAPI* device, size_t nbytes);
+  // The pooled textures, least recently freed first.
   std::vector<Entry> free_list_;
   std::vector<Entry> allocated_;
+  size_t budget_{0};
+  TexturePoolStats stats_;
 };
 
 /*!
@@ -132,13 +170,14 @@ class TVM_DLL TexturePool {
   /*!
    * \brief Allocate a two dimensional temporal texture workspace on device
    *
-   * \note Two dimensional texture workspaces will be grown and reused
-   * according to the following strategy:
-   *  - Choose the workspace which minimizes the amount of memory required to
-   *    grow the workspace to fit the request.
-   *  - If a set of workspaces exist that fit the current request without
-   *    expansion, choose the workspace of that set which most closely
-   *    matches the request size, minimizing wasted space.
+   * \note Two dimensional texture workspaces are reused according to the
+   * following strategy:
+   *  - The width and the height of the request are rounded up to their size
+   *    classes, see Pool2D::SizeClass.
+   *  - Choose the smallest free workspace of the same type holding the rounded
+   *    request, unless it is more than twice as large.
+   *  - Otherwise, create a workspace of the rounded size, after releasing free
+   *    workspaces to stay within the memory budget if one is set.
    *
    * \param dev The context of allocation.
    * \param width The width of the 2d texture to be allocated.
@@ -153,6 +192,16 @@ class TVM_DLL TexturePool {
    * \param ptr The pointer to be freed.
    */
   void FreeTexture(Device dev, void* ptr);
+  /*!
+   * \brief Limit the memory held by the pool of each device.
+   * \param budget The budget in bytes, 0 for no limit.
+   */
+  void SetMemoryBudget(size_t budget);
+  /*!
+   * \brief Return the statistics of the pool of a device.
+   * \param dev The device.
+   */
+  TexturePoolStats GetStats(Device dev) const;
 
  private:
   /*! \brief pool of device local array */
@@ -161,6 +210,8 @@ class TVM_DLL TexturePool {
   DLDeviceType device_type_;
   /*! \brief The device API */
   DeviceAPI* device_;
+  /*! \brief The memory budget of the pool of each device */
+  size_t budget_{0};
 };
 
 }  // namespace runtime
@@ -34,16 +34,20 @@
 #endif
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "../support/utils.h"
+#include "trace_recorder.h"
 const constexpr int kL1CacheBytes = 64;
 
 namespace tvm {
@@ -60,6 +64,95 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+int GetWorkStealingGrains() {
+  const char* val = getenv("TVM_THREAD_POOL_WORK_STEALING_GRAINS");
+  if (!val) {
+    return 0;
+  }
+  return atoi(val);
+}
+
+/*!
+ * \brief The number of tasks per worker in the work-stealing mode, or 0 if disabled.
+ * In the work-stealing mode, a parallel launch is split into finer tasks that
+ * the workers fetch dynamically, so that the workers done with their tasks take
+ * over the remaining ones instead of idling.
+ */
+std::atomic<int> work_stealing_grains{GetWorkStealingGrains()};
+
+/*! \brief The policies deciding how long an idle worker spins before sleeping. */
+enum class SpinPolicyKind : int {
+  /*! \brief Spin a fixed number of iterations, see TVM_THREAD_POOL_SPIN_COUNT. */
+  kFixed = 0,
+  /*! \brief Spin for a duration tuned from the recently observed gaps between tasks. */
+  kAdaptive = 1,
+};
+
+SpinPolicyKind ParseSpinPolicy(const std::string& name) {
+  if (name == "fixed") return SpinPolicyKind::kFixed;
+  if (name == "adaptive") return SpinPolicyKind::kAdaptive;
+  LOG(FATAL) << "ValueError: Unknown thread pool spin policy \"" << name
+             << "\", which should be either \"fixed\" or \"adaptive\"";
+  return SpinPolicyKind::kFixed;
+}
+
+SpinPolicyKind GetSpinPolicy() {
+  const char* val = getenv("TVM_THREAD_POOL_SPIN_POLICY");
+  return val ? ParseSpinPolicy(val) : SpinPolicyKind::kFixed;
+}
+
+std::atomic<SpinPolicyKind> spin_policy{GetSpinPolicy()};
+/*!
+ * \brief Whether the pool is in the low-power idle state, where idle workers
+ * sleep right away instead of spinning. Useful between batches on shared hosts.
+ */
+std::atomic<bool> low_power_idle{false};
+
+/*! \brief The spin state of a worker waiting for tasks. */
+class WorkerSpinState {
+ public:
+  using Clock = std::chrono::steady_clock;
+  /*! \brief The upper bound of the spin duration of the adaptive policy. */
+  static constexpr std::chrono::microseconds kMaxAdaptiveSpin{1000};
+
+  explicit WorkerSpinState(uint32_t spin_count) : spin_count_(spin_count) {}
+
+  /*!
+   * \brief Whether to keep spinning.
+   * \param iter The number of iterations spun so far.
+   * \param start The time the worker became idle.
+   */
+  bool KeepSpinning(uint32_t iter, Clock::time_point start) const {
+    if (low_power_idle.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    if (spin_policy.load(std::memory_order_relaxed) == SpinPolicyKind::kFixed) {
+      return iter < spin_count_;
+    }
+    // Reading the clock is much more expensive than a spin iteration.
+    if (iter % 64 != 0) {
+      return true;
+    }
+    return Clock::now() - start < budget_;
+  }
+
+  /*!
+   * \brief Update the spin budget with the gap between becoming idle and receiving a task.
+   * The worker spins for twice the average gap when it fits in the spin bound, and sleeps
+   * right away otherwise, since spinning is then unlikely to catch the next task.
+   */
+  void OnTaskArrived(Clock::duration gap) {
+    // Exponential moving average with a weight of 1/8 for the new gap.
+    avg_gap_ += (gap - avg_gap_) / 8;
+    budget_ = avg_gap_ * 2 <= kMaxAdaptiveSpin ? avg_gap_ * 2 : Clock::duration::zero();
+  }
+
+ private:
+  uint32_t spin_count_;
+  Clock::duration avg_gap_{Clock::duration::zero()};
+  Clock::duration budget_{kMaxAdaptiveSpin};
+};
+
 }  // namespace
 
 // stride in the page, fit to cache line.
@@ -71,8 +164,11 @@ constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
 class ParallelLauncher {
  public:
   // Reset the task request.
-  void Init(FTVMParallelLambda flambda, void* cdata, int num_task, bool need_sync) {
-    num_pending_.store(num_task);
+  // In the dynamic mode, num_pending is the number of workers fetching the tasks.
+  void Init(FTVMParallelLambda flambda, void* cdata, int num_task, bool need_sync,
+            int num_pending) {
+    num_pending_.store(num_pending);
+    next_task_.store(0);
     this->cdata = cdata;
     this->flambda = flambda;
     this->env.num_task = num_task;
@@ -80,10 +176,11 @@ class ParallelLauncher {
     // reshape
     if (static_cast<size_t>(num_task) > par_errors_.size()) {
       par_errors_.resize(num_task + 1);
-      if (need_sync) {
-        delete[] sync_counter_;
-        sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
-      }
+    }
+    if (need_sync && num_task > sync_counter_size_) {
+      delete[] sync_counter_;
+      sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
+      sync_counter_size_ = num_task;
     }
     if (need_sync) {
       for (int i = 0; i < num_task; ++i) {
@@ -113,12 +210,30 @@ class ParallelLauncher {
   }
   // Signal that one job has finished.
   void SignalJobError(int task_id) {
+    RecordJobError(task_id);
     num_pending_.fetch_sub(1);
+  }
+  // Record the error of a job.
+  void RecordJobError(int task_id) {
     par_errors_[task_id] = TVMGetLastError();
     has_error_.store(true);
   }
+  // Fetch and run the tasks of a dynamic launch until none is left,
+  // then signal that the worker has finished.
+  void RunDynamicTasks() {
+    for (int task_id; (task_id = next_task_.fetch_add(1)) < env.num_task;) {
+      if ((*flambda)(task_id, &env, cdata) != 0) {
+        RecordJobError(task_id);
+      }
+    }
+    SignalJobFinish();
+  }
   // Signal that one job has finished.
   void SignalJobFinish() { num_pending_.fetch_sub(1); }
+  // Whether the thread is running a task, as a worker or as the launching thread.
+  bool InParallelRegion() const {
+    return is_worker || in_inline_task || num_pending_.load() != 0;
+  }
   // Get thread local version of the store.
   static ParallelLauncher* ThreadLocal() { return dmlc::ThreadLocalStore<ParallelLauncher>::Get(); }
   // The parallel lambda
@@ -130,14 +245,20 @@ class ParallelLauncher {
   // Whether this thread is worker of the pool.
   // used to prevent recursive launch.
   bool is_worker{false};
+  // Whether the thread runs a launch inline because there is only one worker.
+  bool in_inline_task{false};
 
  private:
   // The pending jobs.
-  std::atomic<int32_t> num_pending_;
+  std::atomic<int32_t> num_pending_{0};
+  // The next task to fetch in the dynamic mode.
+  std::atomic<int32_t> next_task_{0};
   // Whether error has been countered.
   std::atomic<bool> has_error_;
   // The counter page.
   std::atomic<int32_t>* sync_counter_{nullptr};
+  // The number of tasks the counter page is allocated for.
+  int sync_counter_size_{0};
   // The error message
   std::vector<std::string> par_errors_;
 };
@@ -148,6 +269,7 @@ class SpscTaskQueue {
   /*! \brief The task entry */
   struct Task {
     ParallelLauncher* launcher;
+    /*! \brief The id of the task, or -1 to fetch the tasks dynamically from the launcher. */
     int32_t task_id;
   };
 
@@ -172,14 +294,15 @@ class SpscTaskQueue {
   /*!
    * \brief Pop a task out of the queue and condition wait if no tasks.
    * \param output The pointer to the task to be dequeued.
-   * \param spin_count The number of iterations to spin before sleep.
+   * \param spin_state The spin state of the worker, deciding how long to spin before sleep.
    * \return Whether pop is successful (true) or we need to exit now (false).
    */
-  bool Pop(Task* output, uint32_t spin_count) {
+  bool Pop(Task* output, WorkerSpinState* spin_state) {
     // Busy wait a bit when the queue is empty.
     // If a new task comes to the queue quickly, this wait avoid the worker from sleeping.
     // The default spin count is set by following the typical omp convention
-    for (uint32_t i = 0; i < spin_count && pending_.load() == 0; ++i) {
+    WorkerSpinState::Clock::time_point start = WorkerSpinState::Clock::now();
+    for (uint32_t i = 0; pending_.load() == 0 && spin_state->KeepSpinning(i, start); ++i) {
       tvm::runtime::threading::Yield();
     }
     if (pending_.fetch_sub(1) == 0) {
@@ -189,6 +312,7 @@ class SpscTaskQueue {
     if (exit_now_.load(std::memory_order_relaxed)) {
       return false;
     }
+    spin_state->OnTaskArrived(WorkerSpinState::Clock::now() - start);
     const uint32_t head = head_.load(std::memory_order_relaxed);
     // sanity check if the queue is empty
     ICHECK(tail_.load(std::memory_order_acquire) != head);
@@ -256,6 +380,11 @@ class SpscTaskQueue {
   std::condition_variable cv_;
 };
 
+class ThreadPool;
+// The named pool the calling thread launches into, and its name.
+thread_local std::shared_ptr<ThreadPool> current_named_pool;
+thread_local std::string current_named_pool_name;
+
 // The thread pool
 class ThreadPool {
  public:
@@ -267,6 +396,13 @@ class ThreadPool {
     Init();
   }
 
+  // A named pool with one worker bound to each of the cpus, which runs all the tasks.
+  explicit ThreadPool(const std::vector<unsigned int>& cpus)
+      : num_workers_(cpus.size()), exclude_worker0_(false), cpus_(cpus) {
+    ICHECK(!cpus_.empty()) << "A named thread pool needs at least one CPU";
+    Init();
+  }
+
   ~ThreadPool() {
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
       q->SignalForKill();
@@ -288,6 +424,14 @@ class ThreadPool {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
     ICHECK(!launcher->is_worker)
         << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    // The queues of a named pool are shared by all the threads launching into it.
+    std::unique_lock<std::mutex> lock(launch_mutex_, std::defer_lock);
+    if (!cpus_.empty()) lock.lock();
+    int grains = work_stealing_grains.load(std::memory_order_relaxed);
+    if (grains > 0) {
+      return LaunchDynamic(launcher, flambda, cdata,
+                           num_task == 0 ? num_workers_used_ * grains : num_task);
+    }
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -296,7 +440,7 @@ class ThreadPool {
           << "Request parallel sync task larger than number of threads used "
           << " workers=" << num_workers_used_ << " request=" << num_task;
     }
-    launcher->Init(flambda, cdata, num_task, need_sync != 0);
+    launcher->Init(flambda, cdata, num_task, need_sync != 0, num_task);
     SpscTaskQueue::Task tsk;
     tsk.launcher = launcher;
     // if worker0 is taken by the main, queues_[0] is abandoned
@@ -317,6 +461,27 @@ class ThreadPool {
     return res;
   }
 
+  /*!
+   * \brief Launch the tasks in the work-stealing mode, where every worker
+   * fetches the next task once it is done with the previous one.
+   * The tasks do not run simultaneously, so parallel barriers are not supported.
+   */
+  int LaunchDynamic(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata,
+                    int num_task) {
+    int num_workers = std::min(num_task, num_workers_used_);
+    launcher->Init(flambda, cdata, num_task, /*need_sync=*/false, num_workers);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = launcher;
+    tsk.task_id = -1;
+    for (int i = exclude_worker0_; i < num_workers; ++i) {
+      queues_[i]->Push(tsk);
+    }
+    if (exclude_worker0_) {
+      launcher->RunDynamicTasks();
+    }
+    return launcher->WaitForJobs();
+  }
+
   static ThreadPool* ThreadLocal() { return dmlc::ThreadLocalStore<ThreadPool>::Get(); }
 
   void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads,
@@ -331,6 +496,11 @@ class ThreadPool {
 
   int32_t NumThreads() const { return num_workers_used_; }
 
+  // The pool the calling thread launches into.
+  static ThreadPool* Current() {
+    return current_named_pool ? current_named_pool.get() : ThreadLocal();
+  }
+
  private:
   // Shared initialization code
   void Init() {
@@ -338,10 +508,22 @@ class ThreadPool {
       // The SpscTaskQueue only hosts ONE item at a time
       queues_.emplace_back(std::make_unique<SpscTaskQueue>());
     }
+    // The workers record their tasks on the trace of the thread creating the pool.
+    int trace_pid = profiling::TraceRecorder::CurrentPid();
     threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
-        num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
+        num_workers_,
+        [this, trace_pid](int worker_id) {
+          profiling::TraceRecorder::SetCurrentThread(trace_pid,
+                                                     "tvm worker " + std::to_string(worker_id));
+          this->RunWorker(worker_id);
+        },
         exclude_worker0_ /* include_main_thread */);
-    num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    if (cpus_.empty()) {
+      num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    } else {
+      num_workers_used_ = threads_->Configure(threading::ThreadGroup::kSpecifyOneCorePerThread,
+                                              0, exclude_worker0_, cpus_);
+    }
   }
 
   // Internal worker function.
@@ -353,8 +535,19 @@ class ThreadPool {
     // the global first use of the ThreadPool.
     // TODO(tulloch): should we make this configurable via standard APIs?
     static size_t spin_count = GetSpinCount();
-    while (queue->Pop(&task, spin_count)) {
+    WorkerSpinState spin_state(spin_count);
+    while (queue->Pop(&task, &spin_state)) {
       ICHECK(task.launcher != nullptr);
+      std::optional<profiling::TraceScope> trace_scope;
+      if (profiling::TraceRecorder::Global()->enabled()) {
+        trace_scope.emplace(task.task_id == -1 ? std::string("parallel tasks")
+                                               : "parallel task " + std::to_string(task.task_id),
+                            "thread_pool");
+      }
+      if (task.task_id == -1) {
+        task.launcher->RunDynamicTasks();
+        continue;
+      }
       TVMParallelGroupEnv* penv = &(task.launcher->env);
       void* cdata = task.launcher->cdata;
       if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
@@ -369,10 +562,47 @@ class ThreadPool {
   int num_workers_used_;
   // if or not to exclude worker 0 and use main to run task 0
   bool exclude_worker0_{true};
+  // the CPUs of a named pool, empty for the thread-local pools
+  std::vector<unsigned int> cpus_;
+  // serializes the launches into a named pool
+  std::mutex launch_mutex_;
   std::vector<std::unique_ptr<SpscTaskQueue>> queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
 };
 
+/*! \brief The named thread pools of the process. */
+class ThreadPoolRegistry {
+ public:
+  void Create(const std::string& name, const std::vector<unsigned int>& cpus) {
+    ICHECK(!name.empty()) << "ValueError: The name of a thread pool cannot be empty";
+    std::lock_guard<std::mutex> lock(mutex_);
+    ICHECK(!pools_.count(name)) << "ValueError: Thread pool \"" << name << "\" already exists";
+    pools_.emplace(name, std::make_shared<ThreadPool>(cpus));
+  }
+
+  void Remove(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ICHECK(pools_.erase(name)) << "ValueError: Thread pool \"" << name << "\" does not exist";
+  }
+
+  std::shared_ptr<ThreadPool> Get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pools_.find(name);
+    ICHECK(it != pools_.end()) << "ValueError: Thread pool \"" << name << "\" does not exist";
+    return it->second;
+  }
+
+  static ThreadPoolRegistry* Global() {
+    // NOTE: intentionally leaked so that the workers are not joined at exit.
+    static auto* inst = new ThreadPoolRegistry();
+    return inst;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<ThreadPool>> pools_;
+};
+
 /*!
  * \brief args[0] is the AffinityMode, args[1] is the number of threads.
  *  args2 is a list of CPUs which is used to set the CPU affinity.
@@ -396,6 +626,44 @@ TVM_REGISTER_GLOBAL("runtime.NumThreads").set_body_typed([]() -> int32_t {
   return threading::NumThreads();
 });
 
+/*!
+ * \brief Create a named thread pool with one worker bound to each of the given CPUs.
+ *  Executors attached to the pool with their "set_thread_pool" function only use its CPUs.
+ */
+TVM_REGISTER_GLOBAL("runtime.create_threadpool").set_body_typed([](String name, IntTuple cpus) {
+  threading::CreateThreadPool(name, std::vector<unsigned int>(cpus.begin(), cpus.end()));
+});
+
+TVM_REGISTER_GLOBAL("runtime.remove_threadpool").set_body_typed([](String name) {
+  threading::RemoveThreadPool(name);
+});
+
+/*!
+ * \brief Set the spin policy of the idle thread pool workers, either "fixed" or "adaptive".
+ *  The policy can also be set with the environment variable TVM_THREAD_POOL_SPIN_POLICY.
+ */
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_spin_policy").set_body_typed([](String policy) {
+  spin_policy.store(ParseSpinPolicy(policy));
+});
+
+/*!
+ * \brief Enter (true) or leave (false) the low-power idle state of the thread pool,
+ *  in which the idle workers sleep right away instead of spinning.
+ *  Tasks still run normally, only with the latency of waking up the workers.
+ */
+TVM_REGISTER_GLOBAL("runtime.threadpool_set_low_power_idle").set_body_typed([](bool enable) {
+  low_power_idle.store(enable);
+});
+
+/*!
+ * \brief Set the number of tasks per worker of the work-stealing mode of the thread
+ *  pool (0 disables the mode), and return the previous value.
+ */
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_work_stealing").set_body_typed([](int grains) {
+  ICHECK_GE(grains, 0) << "The number of tasks per worker cannot be negative.";
+  return work_stealing_grains.exchange(grains);
+});
+
 namespace threading {
 
 #if TVM_THREADPOOL_USE_OPENMP
@@ -466,19 +734,99 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
   ConfigureOMP(mode, nthreads, cpus);
 #endif
 }
-int32_t NumThreads() { return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads(); }
+int32_t NumThreads() { return tvm::runtime::ThreadPool::Current()->NumThreads(); }
+
+void CreateThreadPool(const std::string& name, const std::vector<unsigned int>& cpus) {
+  ThreadPoolRegistry::Global()->Create(name, cpus);
+}
+
+void RemoveThreadPool(const std::string& name) { ThreadPoolRegistry::Global()->Remove(name); }
+
+ThreadPoolScope::ThreadPoolScope(const std::string& name) {
+  // Nested invocations of an attached executor stay in the same pool without a lookup.
+  if (name == current_named_pool_name) return;
+  active_ = true;
+  prev_name_ = std::move(current_named_pool_name);
+  prev_pool_ = std::move(current_named_pool);
+  current_named_pool = name.empty() ? nullptr : ThreadPoolRegistry::Global()->Get(name);
+  current_named_pool_name = name;
+}
+
+ThreadPoolScope::~ThreadPoolScope() {
+  if (!active_) return;
+  current_named_pool = std::move(prev_pool_);
+  current_named_pool_name = std::move(prev_name_);
+}
+bool InParallelRegion() {
+#if !TVM_THREADPOOL_USE_OPENMP
+  return tvm::runtime::ParallelLauncher::ThreadLocal()->InParallelRegion();
+#else
+  return omp_in_parallel() || tvm::runtime::ParallelLauncher::ThreadLocal()->in_inline_task;
+#endif
+}
 }  // namespace threading
+
+#if defined(__hexagon__)
+/*!
+ * \brief Launch a parallel loop on the threads of the Hexagon runtime holding the HVX instances,
+ * which the threads of the pool do not lock.
+ * \return Whether the loop was launched; it is not when the resources of the runtime are not
+ * acquired, or when called from one of those threads.
+ */
+bool HexagonParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int* res) {
+  static const PackedFunc* f_workers = Registry::Get("device_api.hexagon.parallel_workers");
+  static const PackedFunc* f_parallel_for = Registry::Get("device_api.hexagon.parallel_for");
+  if (f_workers == nullptr || f_parallel_for == nullptr) return false;
+  int num_workers = (*f_workers)();
+  if (num_workers <= 1) return false;
+  if (num_task == 0) num_task = num_workers;
+  ICHECK_LE(num_task, num_workers)
+      << "Request parallel sync task larger than number of threads used "
+      << " workers=" << num_workers << " request=" << num_task;
+  // Every task runs on its own thread, so the tasks may wait for each other at a barrier
+  std::unique_ptr<std::atomic<int>[]> sync_counter(new std::atomic<int>[num_task * kSyncStride]);
+  for (int i = 0; i < num_task; ++i) {
+    sync_counter[i * kSyncStride].store(0, std::memory_order_relaxed);
+  }
+  std::atomic<bool> failed{false};
+  TypedPackedFunc<void(int)> run_task([&](int task_id) {
+    TVMParallelGroupEnv env;
+    env.num_task = num_task;
+    env.sync_handle = sync_counter.get();
+    if ((*flambda)(task_id, &env, cdata) != 0) {
+      failed.store(true, std::memory_order_relaxed);
+    }
+  });
+  (*f_parallel_for)(num_task, run_task);
+  *res = failed.load(std::memory_order_relaxed) ? -1 : 0;
+  return true;
+}
+#endif  // __hexagon__
+
 }  // namespace runtime
 }  // namespace tvm
 
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  if (tvm::runtime::current_named_pool) {
+    return tvm::runtime::current_named_pool->Launch(flambda, cdata, num_task, 1);
+  }
+#if defined(__hexagon__)
+  int res;
+  if (tvm::runtime::HexagonParallelLaunch(flambda, cdata, num_task, &res)) {
+    return res;
+  }
+#endif
   int num_workers = tvm::runtime::threading::MaxConcurrency();
   if (num_workers == 1) {
     std::atomic<int32_t> sync_counter{0};
     TVMParallelGroupEnv env;
     env.num_task = 1;
     env.sync_handle = &sync_counter;
+    tvm::runtime::ParallelLauncher* launcher = tvm::runtime::ParallelLauncher::ThreadLocal();
+    bool in_inline_task = launcher->in_inline_task;
+    launcher->in_inline_task = true;
     (*flambda)(0, &env, cdata);
+    launcher->in_inline_task = in_inline_task;
     return 0;
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
@@ -503,6 +851,9 @@ int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
 #pragma omp barrier
 #else
   using tvm::runtime::kSyncStride;
+  ICHECK(penv->sync_handle != nullptr)
+      << "TVMBackendParallelBarrier is not supported in the work-stealing mode of the thread "
+      << "pool, please disable it with runtime.config_threadpool_work_stealing(0)";
   int num_task = penv->num_task;
   std::atomic<int>* sync_counter = reinterpret_cast<std::atomic<int>*>(penv->sync_handle);
   int old_counter = sync_counter[task_id * kSyncStride].fetch_add(1, std::memory_order_release);
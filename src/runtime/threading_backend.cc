@@ -47,7 +47,10 @@ extern "C" {
 #define HEXAGON_STACK_ALIGNMENT 32
 #endif
 #include <algorithm>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 #define CURRENT_THREAD_HANDLE (static_cast<std::thread::native_handle_type>(0))
 namespace tvm {
 namespace runtime {
@@ -434,6 +437,127 @@ int MaxConcurrency() {
   return std::max(max_concurrency, 1);
 }
 
+#if defined(__linux__)
+// Parse a sysfs CPU list such as "0-3,8-11".
+static std::vector<unsigned int> ParseCPUList(const std::string& path) {
+  std::vector<unsigned int> cpus;
+  std::ifstream is(path);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    size_t dash = range.find('-');
+    try {
+      unsigned int first = std::stoul(range.substr(0, dash));
+      unsigned int last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+      for (unsigned int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    } catch (const std::logic_error&) {
+      // skip the trailing newline or malformed entries
+    }
+  }
+  return cpus;
+}
+
+static std::vector<std::vector<unsigned int>> DiscoverNUMANodeCPUs() {
+  std::vector<std::vector<unsigned int>> nodes;
+  std::vector<unsigned int> online = ParseCPUList("/sys/devices/system/node/online");
+  if (online.empty()) return nodes;
+  std::vector<unsigned int> node_ids;
+  for (unsigned int node : online) {
+    std::vector<unsigned int> cpus =
+        ParseCPUList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    // Memory-only nodes have no CPU to run workers on.
+    if (cpus.empty()) continue;
+    // Put the first hyper-threading sibling of every core before the others.
+    std::vector<unsigned int> primary, secondary;
+    for (unsigned int cpu : cpus) {
+      std::vector<unsigned int> siblings = ParseCPUList(
+          "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+      if (siblings.empty() || siblings[0] == cpu) {
+        primary.push_back(cpu);
+      } else {
+        secondary.push_back(cpu);
+      }
+    }
+    primary.insert(primary.end(), secondary.begin(), secondary.end());
+    nodes.push_back(std::move(primary));
+  }
+  return nodes;
+}
+#endif
+
+const std::vector<std::vector<unsigned int>>& NUMANodeCPUs() {
+  static const std::vector<std::vector<unsigned int>> nodes = [] {
+    std::vector<std::vector<unsigned int>> nodes;
+#if defined(__linux__)
+    nodes = DiscoverNUMANodeCPUs();
+#endif
+    if (nodes.empty()) {
+      std::vector<unsigned int> cpus;
+      for (unsigned int i = 0; i < std::max(std::thread::hardware_concurrency(), 1U); ++i) {
+        cpus.push_back(i);
+      }
+      nodes.push_back(std::move(cpus));
+    }
+    return nodes;
+  }();
+  return nodes;
+}
+
+int CurrentNUMANode() {
+#if defined(__linux__)
+  int cpu = sched_getcpu();
+  if (cpu < 0) return 0;
+  const auto& nodes = NUMANodeCPUs();
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (std::find(nodes[i].begin(), nodes[i].end(), static_cast<unsigned int>(cpu)) !=
+        nodes[i].end()) {
+      return static_cast<int>(i);
+    }
+  }
+#endif
+  return 0;
+}
+
+void ConfigureNUMANode(int node, int nthreads) {
+  const auto& nodes = NUMANodeCPUs();
+  ICHECK(node >= 0 && node < static_cast<int>(nodes.size()))
+      << "ValueError: NUMA node " << node << " is out of range, the system has " << nodes.size()
+      << " NUMA nodes";
+  std::vector<unsigned int> cpus = nodes[node];
+  int num_cpus = static_cast<int>(cpus.size());
+  ICHECK_GE(nthreads, 0);
+  ICHECK_LE(nthreads, num_cpus) << "ValueError: NUMA node " << node << " only has " << num_cpus
+                                << " CPUs, but " << nthreads << " threads are requested";
+  if (nthreads == 0) {
+    // One thread per physical core, in line with the default of MaxConcurrency.
+    nthreads = num_cpus;
+#if defined(__linux__)
+    for (int i = 0; i < num_cpus; ++i) {
+      std::vector<unsigned int> siblings =
+          ParseCPUList("/sys/devices/system/cpu/cpu" + std::to_string(cpus[i]) +
+                       "/topology/thread_siblings_list");
+      if (!siblings.empty() && siblings[0] != cpus[i]) {
+        nthreads = i;
+        break;
+      }
+    }
+#endif
+  }
+  cpus.resize(std::max(nthreads, 1));
+  Configure(ThreadGroup::kSpecifyOneCorePerThread, 0, cpus);
+}
+
+TVM_REGISTER_GLOBAL("runtime.numa_node_cpus").set_body_typed([]() {
+  Array<IntTuple> result;
+  for (const auto& cpus : NUMANodeCPUs()) {
+    result.push_back(IntTuple(cpus.begin(), cpus.end()));
+  }
+  return result;
+});
+
+TVM_REGISTER_GLOBAL("runtime.current_numa_node").set_body_typed(CurrentNUMANode);
+
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_numa_node").set_body_typed(ConfigureNUMANode);
+
 // This global function can be used by disco runtime to bind processes
 // to CPUs.
 TVM_REGISTER_GLOBAL("tvm.runtime.threading.set_current_thread_affinity")
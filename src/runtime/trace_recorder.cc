@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file trace_recorder.cc
+ * \brief A process-wide recorder of the host threads and device timelines.
+ */
+#include "trace_recorder.h"
+
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+#include "../support/str_escape.h"
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief The first thread id of the device tracks, above the ids of the host threads. */
+static constexpr int kDeviceTrackBegin = 1 << 20;
+
+TraceRecorder* TraceRecorder::Global() {
+  static TraceRecorder* inst = [] {
+    TraceRecorder* recorder = new TraceRecorder();
+    recorder->process_names_[0] = "host";
+    return recorder;
+  }();
+  return inst;
+}
+
+TraceRecorder::ThreadTrack* TraceRecorder::CurrentThread() {
+  static std::atomic<int> next_tid{0};
+  thread_local ThreadTrack track{0, next_tid.fetch_add(1, std::memory_order_relaxed)};
+  return &track;
+}
+
+void TraceRecorder::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (enabled_.load(std::memory_order_relaxed)) return;
+  events_.clear();
+  origin_ns_ = NowNs();
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::Stop() { enabled_.store(false, std::memory_order_relaxed); }
+
+void TraceRecorder::AddHostEvent(std::string name, const char* category, int64_t begin_ns,
+                                 int64_t duration_ns) {
+  if (!enabled()) return;
+  ThreadTrack* track = CurrentThread();
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.push_back(Event{track->pid, track->tid, std::move(name), category, begin_ns,
+                          duration_ns, Device{kDLCPU, 0}, Timer(nullptr)});
+}
+
+void TraceRecorder::AddDeviceEvent(std::string name, Device dev, int64_t launch_ns, Timer timer) {
+  if (!enabled()) return;
+  ThreadTrack* track = CurrentThread();
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.push_back(Event{track->pid, track->tid, std::move(name), "kernel", launch_ns, 0, dev,
+                          std::move(timer)});
+}
+
+void TraceRecorder::SetCurrentThread(int pid, const std::string& name) {
+  ThreadTrack* track = CurrentThread();
+  track->pid = pid;
+  TraceRecorder* recorder = Global();
+  std::lock_guard<std::mutex> lock(recorder->mutex_);
+  recorder->thread_names_[{pid, track->tid}] = name;
+}
+
+int TraceRecorder::CurrentPid() { return CurrentThread()->pid; }
+
+void TraceRecorder::SetProcessName(int pid, const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  process_names_[pid] = name;
+}
+
+std::string TraceRecorder::Dump(int pid) {
+  std::vector<Event> events;
+  std::map<int, std::string> process_names;
+  std::map<std::pair<int, int>, std::string> thread_names;
+  int64_t origin_ns;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::stable_partition(events_.begin(), events_.end(), [pid](const Event& event) {
+      return pid >= 0 && event.pid != pid;
+    });
+    events.assign(std::make_move_iterator(it), std::make_move_iterator(events_.end()));
+    events_.erase(it, events_.end());
+    for (const auto& kv : process_names_) {
+      if (pid < 0 || kv.first == pid) process_names.insert(kv);
+    }
+    for (const auto& kv : thread_names_) {
+      if (pid < 0 || kv.first.first == pid) thread_names.insert(kv);
+    }
+    origin_ns = origin_ns_;
+  }
+  // The timers only measure the durations of the kernels. Each kernel is laid out on the track of
+  // its device once it is launched and the previous kernel of the device is done.
+  std::vector<Event*> kernels;
+  for (Event& event : events) {
+    if (event.timer.defined()) kernels.push_back(&event);
+  }
+  std::stable_sort(kernels.begin(), kernels.end(),
+                   [](const Event* a, const Event* b) { return a->begin_ns < b->begin_ns; });
+  std::map<std::tuple<int, int, int>, int64_t> device_end_ns;
+  for (Event* event : kernels) {
+    Device dev = event->dev;
+    auto key = std::make_tuple(event->pid, static_cast<int>(dev.device_type), dev.device_id);
+    int64_t& end_ns = device_end_ns[key];
+    event->begin_ns = std::max(event->begin_ns, end_ns);
+    event->duration_ns = event->timer->SyncAndGetElapsedNanos();
+    event->tid = kDeviceTrackBegin + static_cast<int>(dev.device_type) * 256 + dev.device_id;
+    end_ns = event->begin_ns + event->duration_ns;
+    thread_names[{event->pid, event->tid}] = DeviceString(dev);
+  }
+
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  auto f_begin_event = [&]() -> std::ostringstream& {
+    if (!first) os << ",";
+    first = false;
+    return os;
+  };
+  std::set<int> pids;
+  for (const Event& event : events) pids.insert(event.pid);
+  for (const auto& kv : thread_names) pids.insert(kv.first.first);
+  for (int p : pids) {
+    auto it = process_names.find(p);
+    if (it == process_names.end()) continue;
+    f_begin_event() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << p
+                    << ",\"args\":{\"name\":\"" << support::StrEscape(it->second) << "\"}}";
+  }
+  for (const auto& kv : thread_names) {
+    f_begin_event() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << kv.first.first
+                    << ",\"tid\":" << kv.first.second << ",\"args\":{\"name\":\""
+                    << support::StrEscape(kv.second) << "\"}}";
+  }
+  for (const Event& event : events) {
+    f_begin_event() << "{\"name\":\"" << support::StrEscape(event.name) << "\",\"cat\":\""
+                    << event.category << "\",\"ph\":\"X\",\"pid\":" << event.pid
+                    << ",\"tid\":" << event.tid
+                    << ",\"ts\":" << (event.begin_ns - origin_ns) / 1e3
+                    << ",\"dur\":" << event.duration_ns / 1e3 << "}";
+  }
+  os << "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"clock_origin_ns\":" << origin_ns << "}}";
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.StartTrace").set_body_typed([]() {
+  TraceRecorder::Global()->Start();
+});
+
+TVM_REGISTER_GLOBAL("runtime.profiling.StopTrace").set_body_typed([]() {
+  TraceRecorder::Global()->Stop();
+});
+
+TVM_REGISTER_GLOBAL("runtime.profiling.DumpTrace").set_body_typed([](int pid) {
+  return TraceRecorder::Global()->Dump(pid);
+});
+
+TVM_REGISTER_GLOBAL("runtime.profiling.TraceClockNs").set_body_typed([]() -> int64_t {
+  return TraceRecorder::NowNs();
+});
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file trace_recorder.h
+ * \brief A process-wide recorder of the host threads and device timelines, exported in the Trace
+ *  Event Format of chrome://tracing, which Perfetto reads as well.
+ *
+ * Every thread records on the track of a process, the controller being process 0 and disco
+ * worker i being process i + 1, so that the traces of all the workers merge into one. The device
+ * kernels are recorded by timers and laid out on a track of their device after the trace stops.
+ */
+#ifndef TVM_RUNTIME_TRACE_RECORDER_H_
+#define TVM_RUNTIME_TRACE_RECORDER_H_
+
+#include <tvm/runtime/profiling.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief A process-wide recorder of the host and device timelines. */
+class TraceRecorder {
+ public:
+  /*! \return The recorder of the process. */
+  static TraceRecorder* Global();
+
+  /*! \return Whether the events are being recorded. */
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /*! \return The clock of the trace, in nanoseconds since the epoch. */
+  static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /*!
+   * \brief Start recording and drop the events not dumped yet, a no-op if the recorder is
+   *  already started, e.g. by another disco worker of the process.
+   */
+  void Start();
+
+  /*! \brief Stop recording, the events are kept until they are dumped. */
+  void Stop();
+
+  /*!
+   * \brief Record a span of the calling thread, dropped if the recorder is not started.
+   * \param name The name of the span.
+   * \param category The category of the span.
+   * \param begin_ns The time the span begins, from NowNs.
+   * \param duration_ns The duration of the span.
+   */
+  void AddHostEvent(std::string name, const char* category, int64_t begin_ns,
+                    int64_t duration_ns);
+
+  /*!
+   * \brief Record a kernel on a device, dropped if the recorder is not started.
+   * \param name The name of the kernel.
+   * \param dev The device the kernel runs on.
+   * \param launch_ns The host time the kernel is launched, from NowNs.
+   * \param timer The stopped timer of the kernel, synchronized when the events are dumped.
+   */
+  void AddDeviceEvent(std::string name, Device dev, int64_t launch_ns, Timer timer);
+
+  /*!
+   * \brief Remove the events of a process and export them.
+   * \param pid The process whose events are exported, or -1 for all of them.
+   * \return The trace in the Trace Event Format. The timestamps are relative to the time the
+   *  recorder started, which is kept as "clock_origin_ns" of "otherData".
+   */
+  std::string Dump(int pid);
+
+  /*!
+   * \brief Move the calling thread to a process track. The workers of the thread pool it
+   *  creates afterwards record on the same process.
+   * \param pid The process of the thread.
+   * \param name The name of the thread.
+   */
+  static void SetCurrentThread(int pid, const std::string& name);
+
+  /*! \return The process track of the calling thread. */
+  static int CurrentPid();
+
+  /*!
+   * \brief Name a process track.
+   * \param pid The process.
+   * \param name The name of the process.
+   */
+  void SetProcessName(int pid, const std::string& name);
+
+ private:
+  /*! \brief A span of a host thread or a kernel of a device. */
+  struct Event {
+    /*! \brief The process track. */
+    int pid;
+    /*! \brief The host thread, unused by the device events. */
+    int tid;
+    /*! \brief The name of the span. */
+    std::string name;
+    /*! \brief The category of the span. */
+    const char* category;
+    /*! \brief The host time it begins, or the time the kernel is launched. */
+    int64_t begin_ns;
+    /*! \brief The host duration, unused by the device events. */
+    int64_t duration_ns;
+    /*! \brief The device of a kernel, CPU for the host events. */
+    Device dev;
+    /*! \brief The timer of a kernel, null for the host events. */
+    Timer timer;
+  };
+  /*! \brief The track of the calling thread. */
+  struct ThreadTrack {
+    int pid;
+    int tid;
+  };
+  static ThreadTrack* CurrentThread();
+
+  /*! \brief Whether the events are being recorded. */
+  std::atomic<bool> enabled_{false};
+  /*! \brief The time the recorder started, from NowNs. */
+  int64_t origin_ns_{0};
+  /*! \brief Guards the fields below. */
+  std::mutex mutex_;
+  /*! \brief The events recorded and not dumped yet. */
+  std::vector<Event> events_;
+  /*! \brief The names of the processes. */
+  std::map<int, std::string> process_names_;
+  /*! \brief The names of the threads, by process and thread. */
+  std::map<std::pair<int, int>, std::string> thread_names_;
+};
+
+/*! \brief Record the lifetime of a scope as a span of the calling thread. */
+class TraceScope {
+ public:
+  TraceScope(std::string name, const char* category)
+      : name_(std::move(name)), category_(category), begin_ns_(TraceRecorder::NowNs()) {}
+  ~TraceScope() {
+    TraceRecorder::Global()->AddHostEvent(std::move(name_), category_, begin_ns_,
+                                          TraceRecorder::NowNs() - begin_ns_);
+  }
+
+ private:
+  std::string name_;
+  const char* category_;
+  int64_t begin_ns_;
+};
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_TRACE_RECORDER_H_
@@ -19,6 +19,7 @@
 
 #include "vulkan_buffer.h"
 
+#include <atomic>
 #include <utility>
 
 #include "vulkan_device_api.h"
@@ -40,6 +41,9 @@ VkBufferCreateInfo MakeBufferCreateInfo(size_t nbytes, VkBufferUsageFlags usage)
 VulkanBuffer::VulkanBuffer(const VulkanDevice& device, size_t nbytes, VkBufferUsageFlags usage,
                            uint32_t mem_type_index)
     : device_(device) {
+  static std::atomic<uint64_t> next_id{1};
+  id = next_id.fetch_add(1, std::memory_order_relaxed);
+
   // Create a buffer
   VkBufferCreateInfo buffer_info = MakeBufferCreateInfo(nbytes, usage);
   VULKAN_CALL(vkCreateBuffer(device, &buffer_info, nullptr, &buffer));
@@ -74,16 +78,18 @@ VulkanBuffer::~VulkanBuffer() {
 }
 
 VulkanBuffer::VulkanBuffer(VulkanBuffer&& other)
-    : device_(other.device_), buffer(other.buffer), memory(other.memory) {
+    : device_(other.device_), buffer(other.buffer), memory(other.memory), id(other.id) {
   other.device_ = VK_NULL_HANDLE;
   other.buffer = VK_NULL_HANDLE;
   other.memory = VK_NULL_HANDLE;
+  other.id = 0;
 }
 
 VulkanBuffer& VulkanBuffer::operator=(VulkanBuffer&& other) {
   std::swap(device_, other.device_);
   std::swap(buffer, other.buffer);
   std::swap(memory, other.memory);
+  std::swap(id, other.id);
   return *this;
 }
 
@@ -103,6 +103,14 @@ class VulkanBuffer {
   //! \brief Handle to the physical device memory
   VkDeviceMemory memory{VK_NULL_HANDLE};
 
+  /*! \brief Process-wide unique identifier of the buffer
+   *
+   * Unlike the VkBuffer handle, which the driver may hand out again
+   * once the buffer is destroyed, the identifier is never reused.
+   * Used as the key of cached descriptor sets.
+   */
+  uint64_t id{0};
+
   friend class VulkanHostVisibleBuffer;
 };
 
@@ -161,6 +161,17 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
   max_per_stage_descriptor_storage_buffer =
       properties.properties.limits.maxPerStageDescriptorStorageBuffers;
   max_shared_memory_per_block = properties.properties.limits.maxComputeSharedMemorySize;
+  timestamp_period = properties.properties.limits.timestampPeriod;
+  {
+    uint32_t queue_prop_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_prop_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_props(queue_prop_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_prop_count,
+                                             dmlc::BeginPtr(queue_props));
+    if (device.queue_family_index < queue_prop_count) {
+      timestamp_valid_bits = queue_props[device.queue_family_index].timestampValidBits;
+    }
+  }
   device_name = properties.properties.deviceName;
   driver_version = properties.properties.driverVersion;
 
@@ -100,6 +100,10 @@ struct VulkanDeviceProperties {
   uint32_t max_storage_buffer_range{1 << 27};
   uint32_t max_per_stage_descriptor_storage_buffer{4};
   uint32_t max_shared_memory_per_block{16384};
+  // Nanoseconds per timestamp tick, and number of meaningful bits of
+  // the timestamps written by the compute queue (0 if unsupported).
+  float timestamp_period{1.0f};
+  uint32_t timestamp_valid_bits{0};
   std::string device_type{"unknown_device_type"};
   std::string device_name{"unknown_device_name"};
   std::string driver_name{"unknown_driver_name"};
@@ -19,6 +19,8 @@
 
 #include "vulkan_device_api.h"
 
+#include <tvm/runtime/profiling.h>
+
 #include <algorithm>
 #include <memory>
 #include <set>
@@ -335,6 +337,54 @@ void VulkanDeviceAPI::SetStream(Device dev, TVMStreamHandle stream) {
 
 TVMStreamHandle VulkanDeviceAPI::GetCurrentStream(Device dev) { return nullptr; }
 
+namespace {
+struct VulkanEvent {
+  // The stream the event was recorded in, nullptr if not recorded.
+  VulkanStream* stream{nullptr};
+  // The number of synchronizations of the stream when the event was recorded.
+  uint64_t num_synchronizations{0};
+
+  bool Completed() const {
+    return stream == nullptr || stream->NumSynchronizations() > num_synchronizations;
+  }
+};
+}  // namespace
+
+TVMEventHandle VulkanDeviceAPI::CreateEvent(Device dev) { return new VulkanEvent(); }
+
+void VulkanDeviceAPI::FreeEvent(Device dev, TVMEventHandle event) {
+  delete static_cast<VulkanEvent*>(event);
+}
+
+void VulkanDeviceAPI::RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) {
+  ICHECK_EQ(stream, static_cast<void*>(nullptr));
+  auto* evt = static_cast<VulkanEvent*>(event);
+  evt->stream = &device(dev.device_id).ThreadLocalStream();
+  evt->num_synchronizations = evt->stream->NumSynchronizations();
+}
+
+void VulkanDeviceAPI::EventSync(Device dev, TVMEventHandle event) {
+  auto* evt = static_cast<VulkanEvent*>(event);
+  if (evt->Completed()) return;
+  // The command buffer of a stream may only be submitted by its own thread.
+  ICHECK(evt->stream == &device(dev.device_id).ThreadLocalStream())
+      << "A pending Vulkan event can only be synchronized by the thread that recorded it";
+  evt->stream->Synchronize();
+}
+
+bool VulkanDeviceAPI::EventQuery(Device dev, TVMEventHandle event) {
+  return static_cast<VulkanEvent*>(event)->Completed();
+}
+
+void VulkanDeviceAPI::StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event) {
+  ICHECK_EQ(stream, static_cast<void*>(nullptr));
+  auto* evt = static_cast<VulkanEvent*>(event);
+  // Commands of the same stream already execute in order.
+  if (evt->stream != &device(dev.device_id).ThreadLocalStream()) {
+    EventSync(dev, event);
+  }
+}
+
 void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to,
                                      size_t to_offset, size_t size, Device dev_from, Device dev_to,
                                      DLDataType type_hint, TVMStreamHandle stream) {
@@ -454,6 +504,86 @@ VulkanDevice& VulkanDeviceAPI::device(size_t device_id) {
   return const_cast<VulkanDevice&>(const_cast<const VulkanDeviceAPI*>(this)->device(device_id));
 }
 
+/*!
+ * \brief Timer measuring the GPU time between Start and Stop with timestamp queries.
+ *
+ * The timestamps are written into the command buffer of the thread-local
+ * stream, after all the commands recorded before them have completed.
+ */
+class VulkanTimerNode : public TimerNode {
+ public:
+  explicit VulkanTimerNode(Device dev) : device_id_(dev.device_id) {
+    const auto& device = VulkanDeviceAPI::Global()->device(device_id_);
+    VkQueryPoolCreateInfo info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    info.queryCount = 2;
+    VULKAN_CALL(vkCreateQueryPool(device, &info, nullptr, &query_pool_));
+  }
+  virtual ~VulkanTimerNode() {
+    auto& device = VulkanDeviceAPI::Global()->device(device_id_);
+    // The command buffer may still reference the query pool.
+    if (stream_ != nullptr && !synchronized_) {
+      stream_->Synchronize();
+    }
+    vkDestroyQueryPool(device, query_pool_, nullptr);
+  }
+  virtual void Start() {
+    auto& device = VulkanDeviceAPI::Global()->device(device_id_);
+    stream_ = &device.ThreadLocalStream();
+    synchronized_ = false;
+    VkQueryPool query_pool = query_pool_;
+    stream_->Launch([query_pool](VulkanStreamState* state) {
+      vkCmdResetQueryPool(state->cmd_buffer_, query_pool, 0, 2);
+      vkCmdWriteTimestamp(state->cmd_buffer_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 0);
+    });
+  }
+  virtual void Stop() {
+    ICHECK(stream_ != nullptr) << "The timer was stopped before it was started";
+    VkQueryPool query_pool = query_pool_;
+    stream_->Launch([query_pool](VulkanStreamState* state) {
+      vkCmdWriteTimestamp(state->cmd_buffer_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 1);
+    });
+  }
+  virtual int64_t SyncAndGetElapsedNanos() {
+    ICHECK(stream_ != nullptr) << "The timer was never started";
+    const auto& device = VulkanDeviceAPI::Global()->device(device_id_);
+    if (!synchronized_) {
+      stream_->Synchronize();
+      synchronized_ = true;
+    }
+    uint64_t timestamps[2];
+    VULKAN_CALL(vkGetQueryPoolResults(device, query_pool_, 0, 2, sizeof(timestamps), timestamps,
+                                      sizeof(uint64_t),
+                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+    uint32_t valid_bits = device.device_properties.timestamp_valid_bits;
+    uint64_t mask = valid_bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << valid_bits) - 1;
+    // The timestamps wrap around after their valid bits.
+    uint64_t ticks = (timestamps[1] - timestamps[0]) & mask;
+    return static_cast<int64_t>(ticks * device.device_properties.timestamp_period);
+  }
+
+  static constexpr const char* _type_key = "VulkanTimerNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(VulkanTimerNode, TimerNode);
+
+ private:
+  size_t device_id_;
+  VkQueryPool query_pool_{VK_NULL_HANDLE};
+  // The stream the timestamps are written into.
+  VulkanStream* stream_{nullptr};
+  bool synchronized_{false};
+};
+
+TVM_REGISTER_OBJECT_TYPE(VulkanTimerNode);
+
+TVM_REGISTER_GLOBAL("profiling.timer.vulkan").set_body_typed([](Device dev) {
+  // Not all compute queues support timestamps, fall back to measuring on the host.
+  if (VulkanDeviceAPI::Global()->device(dev.device_id).device_properties.timestamp_valid_bits ==
+      0) {
+    return DefaultTimer(dev);
+  }
+  return Timer(make_object<VulkanTimerNode>(dev));
+});
+
 TVM_REGISTER_GLOBAL("device_api.vulkan").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = VulkanDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
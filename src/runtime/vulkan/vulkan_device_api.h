@@ -64,6 +64,16 @@ class VulkanDeviceAPI final : public DeviceAPI {
   void SetStream(Device dev, TVMStreamHandle stream) final;
   TVMStreamHandle GetCurrentStream(Device dev) final;
 
+  // Commands are only submitted when the stream synchronizes, so an
+  // event records the position of the thread's stream, and completes
+  // once that stream synchronized past it.
+  TVMEventHandle CreateEvent(Device dev) final;
+  void FreeEvent(Device dev, TVMEventHandle event) final;
+  void RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) final;
+  void EventSync(Device dev, TVMEventHandle event) final;
+  bool EventQuery(Device dev, TVMEventHandle event) final;
+  void StreamWaitEvent(Device dev, TVMStreamHandle stream, TVMEventHandle event) final;
+
  protected:
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
                       Device dev_from, Device dev_to, DLDataType type_hint,
@@ -19,6 +19,8 @@
 
 #include "vulkan_stream.h"
 
+#include <algorithm>
+
 #include "../../support/utils.h"
 #include "vulkan_device.h"
 
@@ -71,7 +73,43 @@ VulkanStream::~VulkanStream() {
   }
 }
 
+void VulkanStreamState::DispatchBarrier(const std::vector<VkBuffer>& buffers) {
+  if (std::any_of(buffers.begin(), buffers.end(),
+                  [&](VkBuffer buffer) { return unsynced_buffers_.count(buffer); })) {
+    FlushDispatchBarrier();
+  }
+  unsynced_buffers_.insert(buffers.begin(), buffers.end());
+}
+
+void VulkanStreamState::FlushDispatchBarrier() {
+  if (unsynced_buffers_.empty()) {
+    return;
+  }
+  VkMemoryBarrier barrier_info;
+  barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier_info.pNext = nullptr;
+  barrier_info.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+  barrier_info.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+  vkCmdPipelineBarrier(cmd_buffer_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                       &barrier_info, 0, nullptr, 0, nullptr);
+  unsynced_buffers_.clear();
+}
+
 void VulkanStream::Launch(const std::function<void(VulkanStreamState*)>& kernel) {
+  if (device_->UseImmediate()) {
+    state_->FlushDispatchBarrier();
+    kernel(state_.get());
+  } else {
+    deferred_kernels_.push_back([kernel](VulkanStreamState* state) {
+      state->FlushDispatchBarrier();
+      kernel(state);
+    });
+  }
+}
+
+void VulkanStream::LaunchDispatch(const std::function<void(VulkanStreamState*)>& kernel) {
   if (device_->UseImmediate()) {
     kernel(state_.get());
   } else {
@@ -128,6 +166,8 @@ void VulkanStream::Synchronize() {
     DCHECK_EQ(deferred_kernels_.size(), 0);
     DCHECK_EQ(deferred_tokens_.size(), 0);
   }
+  // The next command buffer sees the results of this one.
+  state_->FlushDispatchBarrier();
 
   VULKAN_CALL(vkEndCommandBuffer(state_->cmd_buffer_));
   VkSubmitInfo cb_submit;
@@ -163,6 +203,7 @@ void VulkanStream::Synchronize() {
   cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
   cb_begin.pInheritanceInfo = nullptr;
   VULKAN_CALL(vkBeginCommandBuffer(state_->cmd_buffer_, &cb_begin));
+  ++num_synchronizations_;
 }
 
 }  // namespace vulkan
@@ -23,6 +23,7 @@
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "vulkan_amdrgp.h"
@@ -38,6 +39,27 @@ class VulkanStreamState {
  public:
   VkCommandBuffer cmd_buffer_;
   VkFence fence_;
+
+  /*! \brief Record a barrier before a kernel dispatch, if needed.
+   *
+   * Dispatches touching disjoint buffers may run concurrently, so a
+   * barrier is only recorded when the dispatch accesses a buffer that
+   * a dispatch recorded since the last barrier also accessed.  The
+   * shaders do not expose which of their buffers are read and which
+   * are written, so every buffer is assumed to be both.
+   *
+   * \param buffers The buffers bound to the dispatch.
+   */
+  void DispatchBarrier(const std::vector<VkBuffer>& buffers);
+
+  /*! rief Record a barrier making the results of the dispatches
+   * recorded so far visible to the following commands.
+   */
+  void FlushDispatchBarrier();
+
+ private:
+  // The buffers accessed by the dispatches recorded since the last barrier.
+  std::unordered_set<VkBuffer> unsynced_buffers_;
 };
 
 // Used to identify state that should only be used once-per-stream.
@@ -77,9 +99,18 @@ class VulkanStream {
    *
    * Assumes that there are no descriptor sets or buffers accessed by this kernel.
    *
+   * The kernel is ordered after all the dispatches recorded before it.
    */
   void Launch(const std::function<void(VulkanStreamState*)>& kernel);
 
+  /*! \brief Push a kernel dispatch onto the stream's command buffer.
+   *
+   * Same as Launch, except that the dispatch is not ordered after the
+   * previous dispatches.  The kernel must call
+   * VulkanStreamState::DispatchBarrier before dispatching.
+   */
+  void LaunchDispatch(const std::function<void(VulkanStreamState*)>& kernel);
+
   /*! \brief Push the kernel onto the stream's command buffer.
    *
    * Can only be called if device.UseImmediate() is false.  The
@@ -117,6 +148,10 @@ class VulkanStream {
   // Synchronize the current stream `state_` with respect to the host.
   void Synchronize();
 
+  // The number of completed calls to Synchronize, all the commands
+  // queued before a call completed once this number is larger.
+  uint64_t NumSynchronizations() const { return num_synchronizations_; }
+
  private:
   const VulkanDevice* device_;
   std::unique_ptr<VulkanStreamState> state_;
@@ -126,6 +161,7 @@ class VulkanStream {
   std::vector<std::function<void(VulkanStreamState*)>> deferred_kernels_;
   VkCommandPool cmd_pool_;
   VulkanStreamProfiler* profiler_ = nullptr;
+  uint64_t num_synchronizations_{0};
 };
 
 }  // namespace vulkan
@@ -21,6 +21,7 @@
 
 #include <dmlc/memory_io.h>
 
+#include <algorithm>
 #include <utility>
 
 #include "../file_utils.h"
@@ -52,27 +53,30 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
   const auto& pipeline = scache_[device_id];
   ThreadWorkLoad wl = launch_param_config_.Extract(args);
   std::vector<VkDescriptorBufferInfo> descriptor_buffers;
-  descriptor_buffers.resize(num_buffer_args_);
-  for (size_t i = 0; i < num_buffer_args_; ++i) {
-    void* buf = args[static_cast<int>(i)];
+  std::vector<VkBuffer> buffers;
+  std::vector<uint64_t> buffer_ids;
+  auto push_buffer = [&](const VulkanBuffer& buf) {
     VkDescriptorBufferInfo binfo;
-    binfo.buffer = static_cast<VulkanBuffer*>(buf)->buffer;
+    binfo.buffer = buf.buffer;
     binfo.offset = 0;
     binfo.range = VK_WHOLE_SIZE;
-    descriptor_buffers[i] = binfo;
+    descriptor_buffers.push_back(binfo);
+    buffers.push_back(buf.buffer);
+    buffer_ids.push_back(buf.id);
+  };
+  for (size_t i = 0; i < num_buffer_args_; ++i) {
+    void* buf = args[static_cast<int>(i)];
+    push_buffer(*static_cast<VulkanBuffer*>(buf));
   }
   const size_t nbytes_scalars = num_pack_args_ * sizeof(ArgUnion64);
   if (pipeline->use_ubo) {
     auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
-    VkDescriptorBufferInfo binfo;
-    binfo.buffer = ubo.vk_buf.buffer;
-    binfo.offset = 0;
-    binfo.range = VK_WHOLE_SIZE;
-    descriptor_buffers.push_back(binfo);
+    push_buffer(ubo.vk_buf);
   }
   if (device.UseImmediate()) {
     // Can safely capture by reference as this lambda is immediately executed on the calling thread.
-    device.ThreadLocalStream().Launch([&](VulkanStreamState* state) {
+    device.ThreadLocalStream().LaunchDispatch([&](VulkanStreamState* state) {
+      state->DispatchBarrier(buffers);
       vkCmdBindPipeline(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
       ICHECK(pipeline->descriptor_update_template != VK_NULL_HANDLE);
       device.descriptor_template_khr_functions->vkCmdPushDescriptorSetWithTemplateKHR(
@@ -89,15 +93,6 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
       }
 
       vkCmdDispatch(state->cmd_buffer_, wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
-      VkMemoryBarrier barrier_info;
-      barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-      barrier_info.pNext = nullptr;
-      barrier_info.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-      barrier_info.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
-                                    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-      vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
-                           1, &barrier_info, 0, nullptr, 0, nullptr);
 
       if (device.UseDebugUtilsLabel()) {
         VkDebugUtilsLabelEXT dispatch_label = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
@@ -113,13 +108,18 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
 
   // Otherwise, the more expensive deferred path.
   std::vector<ArgUnion64> pack_args_storage(pack_args, pack_args + num_pack_args_);
-  const auto& deferred_initializer = [&device, pipeline, descriptor_buffers]() {
+  bool needs_update = false;
+  VkDescriptorSet descriptor_set = pipeline->GetDescriptorSet(device, buffer_ids, &needs_update);
+  const auto& deferred_initializer = [&device, pipeline, descriptor_buffers, descriptor_set,
+                                      needs_update]() {
+    // The cached descriptor set already binds the buffers.
+    if (!needs_update) return;
     std::vector<VkWriteDescriptorSet> write_descriptor_sets;
     write_descriptor_sets.resize(descriptor_buffers.size());
     for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
       write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
       write_descriptor_sets[i].pNext = nullptr;
-      write_descriptor_sets[i].dstSet = pipeline->descriptor_set;
+      write_descriptor_sets[i].dstSet = descriptor_set;
       write_descriptor_sets[i].dstBinding = i;
       write_descriptor_sets[i].dstArrayElement = 0;
       write_descriptor_sets[i].descriptorCount = 1;
@@ -137,14 +137,14 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0,
                            nullptr);
   };
-  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars,
-                                 device_id](VulkanStreamState* state) {
+  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars, device_id,
+                                 descriptor_set, buffers](VulkanStreamState* state) {
     auto& device = VulkanDeviceAPI::Global()->device(device_id);
 
+    state->DispatchBarrier(buffers);
     vkCmdBindPipeline(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
     vkCmdBindDescriptorSets(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            pipeline->pipeline_layout, 0, 1, &(pipeline->descriptor_set), 0,
-                            nullptr);
+                            pipeline->pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
 
     if (pipeline->use_ubo) {
       auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
@@ -156,22 +156,10 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     }
 
     vkCmdDispatch(state->cmd_buffer_, wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
-    VkMemoryBarrier barrier_info;
-    barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier_info.pNext = nullptr;
-    barrier_info.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-    barrier_info.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
-                                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-    vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
-                         1, &barrier_info, 0, nullptr, 0, nullptr);
   };
   VulkanStreamToken deferred_token;
-  deferred_token.descriptor_set_ = pipeline->descriptor_set;
-  deferred_token.buffers_.resize(descriptor_buffers.size());
-  for (size_t i = 0; i < descriptor_buffers.size(); ++i) {
-    deferred_token.buffers_[i] = descriptor_buffers[i].buffer;
-  }
+  deferred_token.descriptor_set_ = descriptor_set;
+  deferred_token.buffers_ = buffers;
   device.ThreadLocalStream().LaunchDeferred(deferred_initializer, deferred_kernel, deferred_token);
 
   if (device.UseDebugUtilsLabel()) {
@@ -184,6 +172,39 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
   }
 }
 
+VkDescriptorSet VulkanPipeline::GetDescriptorSet(VkDevice device,
+                                                 const std::vector<uint64_t>& buffer_ids,
+                                                 bool* needs_update) {
+  auto it = std::find_if(descriptor_sets_.begin(), descriptor_sets_.end(),
+                         [&](const auto& entry) { return entry.first == buffer_ids; });
+  std::pair<std::vector<uint64_t>, VkDescriptorSet> entry;
+  if (it != descriptor_sets_.end()) {
+    *needs_update = false;
+    entry = std::move(*it);
+    descriptor_sets_.erase(it);
+  } else if (descriptor_sets_.size() < kVulkanMaxCachedDescriptorSets) {
+    *needs_update = true;
+    entry.first = buffer_ids;
+    VkDescriptorSetAllocateInfo alloc_info;
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.pNext = nullptr;
+    alloc_info.descriptorPool = descriptor_pool;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &descriptor_set_layout;
+    VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &entry.second));
+  } else {
+    // Rebinding the least recently used descriptor set.  If a queued
+    // kernel still uses it, VulkanStream::LaunchDeferred synchronizes
+    // the stream before the descriptor set is updated.
+    *needs_update = true;
+    entry.first = buffer_ids;
+    entry.second = descriptor_sets_.front().second;
+    descriptor_sets_.erase(descriptor_sets_.begin());
+  }
+  descriptor_sets_.push_back(std::move(entry));
+  return descriptor_sets_.back().second;
+}
+
 VulkanModuleNode::~VulkanModuleNode() {
   // cleanup vulkan related caches.
   for (size_t device_id = 0; device_id < ecache_.size(); ++device_id) {
@@ -324,19 +345,15 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
     descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     descrip_pool_cinfo.pNext = nullptr;
     descrip_pool_cinfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descrip_pool_cinfo.maxSets = 1;
+    // The descriptor sets are allocated on demand by VulkanPipeline::GetDescriptorSet.
+    for (auto& pool_size : descriptor_set_pool_sizes) {
+      pool_size.descriptorCount *= kVulkanMaxCachedDescriptorSets;
+    }
+    descrip_pool_cinfo.maxSets = kVulkanMaxCachedDescriptorSets;
     descrip_pool_cinfo.poolSizeCount = descriptor_set_pool_sizes.size();
     descrip_pool_cinfo.pPoolSizes = descriptor_set_pool_sizes.data();
     VULKAN_CALL(
         vkCreateDescriptorPool(device, &descrip_pool_cinfo, nullptr, &(pe->descriptor_pool)));
-
-    VkDescriptorSetAllocateInfo alloc_info;
-    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    alloc_info.pNext = nullptr;
-    alloc_info.descriptorPool = pe->descriptor_pool;
-    alloc_info.descriptorSetCount = 1;
-    alloc_info.pSetLayouts = &(pe->descriptor_set_layout);
-    VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &(pe->descriptor_set)));
   }
 
   VkPushConstantRange crange;
@@ -39,16 +39,40 @@ namespace tvm {
 namespace runtime {
 namespace vulkan {
 
+/*! \brief The number of descriptor sets cached by each pipeline when
+ * push descriptors are not available.
+ */
+constexpr uint32_t kVulkanMaxCachedDescriptorSets = 16;
+
 struct VulkanPipeline {
   VulkanDevice* device{nullptr};
   VkShaderModule shader{VK_NULL_HANDLE};
   VkDescriptorSetLayout descriptor_set_layout{VK_NULL_HANDLE};
   VkDescriptorPool descriptor_pool{VK_NULL_HANDLE};
-  VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
   VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
   VkPipeline pipeline{VK_NULL_HANDLE};
   VkDescriptorUpdateTemplateKHR descriptor_update_template{VK_NULL_HANDLE};
   bool use_ubo{false};
+
+  /*! \brief Get a descriptor set for the given buffers.
+   *
+   * The descriptor sets are cached on the identifiers of the buffers
+   * they bind, so that calling a kernel again on the same buffers
+   * neither rewrites a descriptor set nor forces a synchronization of
+   * the stream.  When the cache is full, the least recently used
+   * descriptor set is rebound.
+   *
+   * \param device The device owning the descriptor pool.
+   * \param buffer_ids The identifiers of the buffers to bind.
+   * \param needs_update Set to true if the descriptor set must be
+   * written with the buffers before use.
+   */
+  VkDescriptorSet GetDescriptorSet(VkDevice device, const std::vector<uint64_t>& buffer_ids,
+                                   bool* needs_update);
+
+ private:
+  // The cached descriptor sets and the buffers they bind, least recently used first.
+  std::vector<std::pair<std::vector<uint64_t>, VkDescriptorSet>> descriptor_sets_;
 };
 
 class VulkanModuleNode;
@@ -23,6 +23,7 @@
  */
 #include "workspace_pool.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace tvm {
@@ -133,6 +134,136 @@ class WorkspacePool::Pool {
   std::vector<Entry> allocated_;
 };
 
+class WorkspacePool::StreamArena {
+ public:
+  StreamArena(int device_id, TVMStreamHandle stream) : device_id_(device_id), stream_(stream) {}
+  // allocate from the top of the arena, or from a separate chunk if it is full
+  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
+    nbytes = (nbytes + (kTempAllocaAlignment - 1)) / kTempAllocaAlignment * kTempAllocaAlignment;
+    if (nbytes == 0) nbytes = kTempAllocaAlignment;
+    Entry e;
+    e.freed = false;
+    e.size = nbytes;
+    if (offset_ + nbytes <= capacity_) {
+      e.data = static_cast<char*>(base_) + offset_;
+      offset_ += nbytes;
+      allocated_.push_back(e);
+    } else {
+      // freed chunks are only used by earlier work of this stream, they can be reused
+      auto it = std::find_if(overflow_.begin(), overflow_.end(),
+                             [nbytes](const Entry& c) { return c.freed && c.size >= nbytes; });
+      if (it != overflow_.end()) {
+        it->freed = false;
+        live_bytes_ += it->size;
+        peak_bytes_ = std::max(peak_bytes_, live_bytes_);
+        return it->data;
+      }
+      DLDataType type;
+      type.code = kDLUInt;
+      type.bits = 8;
+      type.lanes = 1;
+      e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
+      overflow_.push_back(e);
+    }
+    live_bytes_ += nbytes;
+    peak_bytes_ = std::max(peak_bytes_, live_bytes_);
+    return e.data;
+  }
+  // free an allocation, returns false if it does not belong to this arena
+  bool Free(void* data) {
+    char* ptr = static_cast<char*>(data);
+    char* base = static_cast<char*>(base_);
+    if (base != nullptr && ptr >= base && ptr < base + capacity_) {
+      int index = static_cast<int>(allocated_.size()) - 1;
+      for (; index >= 0 && allocated_[index].data != data; --index) {
+      }
+      ICHECK(index >= 0 && !allocated_[index].freed)
+          << "trying to free things that has not been allocated";
+      allocated_[index].freed = true;
+      live_bytes_ -= allocated_[index].size;
+      // Later work on this stream is ordered after the current one, the top can be reused.
+      while (!allocated_.empty() && allocated_.back().freed) {
+        offset_ -= allocated_.back().size;
+        allocated_.pop_back();
+      }
+      return true;
+    }
+    for (Entry& e : overflow_) {
+      if (e.data == data && !e.freed) {
+        // The memory may still be used by queued kernels, it is released on sync.
+        e.freed = true;
+        live_bytes_ -= e.size;
+        return true;
+      }
+    }
+    return false;
+  }
+  // all queued work completed, release freed chunks and grow the arena to the peak usage
+  void Sync(Device dev, DeviceAPI* device) {
+    size_t num_live = 0;
+    for (const Entry& e : overflow_) {
+      if (e.freed) {
+        device->FreeDataSpace(dev, e.data);
+      } else {
+        overflow_[num_live++] = e;
+      }
+    }
+    overflow_.resize(num_live);
+    if (allocated_.empty() && overflow_.empty() && peak_bytes_ > capacity_) {
+      if (base_ != nullptr) {
+        device->FreeDataSpace(dev, base_);
+      }
+      DLDataType type;
+      type.code = kDLUInt;
+      type.bits = 8;
+      type.lanes = 1;
+      capacity_ =
+          (peak_bytes_ + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
+      base_ = device->AllocDataSpace(dev, capacity_, kTempAllocaAlignment, type);
+      offset_ = 0;
+    }
+    peak_bytes_ = live_bytes_;
+  }
+  // Release all resources
+  void Release(Device dev, DeviceAPI* device) {
+    for (const Entry& e : overflow_) {
+      device->FreeDataSpace(dev, e.data);
+    }
+    overflow_.clear();
+    allocated_.clear();
+    if (base_ != nullptr) {
+      device->FreeDataSpace(dev, base_);
+      base_ = nullptr;
+    }
+    capacity_ = offset_ = live_bytes_ = peak_bytes_ = 0;
+  }
+
+  int device_id() const { return device_id_; }
+  TVMStreamHandle stream() const { return stream_; }
+
+ private:
+  /*! \brief a single allocation of the arena */
+  struct Entry {
+    void* data;
+    size_t size;
+    bool freed;
+  };
+  /*! \brief the device and stream this arena belongs to */
+  int device_id_;
+  TVMStreamHandle stream_;
+  /*! \brief the arena memory, its size and the bump offset */
+  void* base_{nullptr};
+  size_t capacity_{0};
+  size_t offset_{0};
+  /*! \brief allocations in the arena, in address order */
+  std::vector<Entry> allocated_;
+  /*! \brief allocations that did not fit the arena */
+  std::vector<Entry> overflow_;
+  /*! \brief bytes currently allocated and the peak since the last sync */
+  size_t live_bytes_{0};
+  size_t peak_bytes_{0};
+};
+
 WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
     : device_type_(device_type), device_(device) {}
 
@@ -146,6 +277,13 @@ WorkspacePool::~WorkspacePool() {
       delete array_[i];
     }
   }
+  for (StreamArena* arena : arenas_) {
+    Device dev;
+    dev.device_type = device_type_;
+    dev.device_id = arena->device_id();
+    arena->Release(dev, device_);
+    delete arena;
+  }
 }
 
 void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
@@ -158,10 +296,49 @@ void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
   return array_[dev.device_id]->Alloc(dev, device_, size);
 }
 
+void* WorkspacePool::AllocWorkspace(Device dev, size_t size, TVMStreamHandle stream) {
+  if (stream == nullptr) {
+    return AllocWorkspace(dev, size);
+  }
+  StreamArena* arena = FindArena(dev, stream);
+  if (arena == nullptr) {
+    arena = new StreamArena(dev.device_id, stream);
+    arenas_.push_back(arena);
+  }
+  return arena->Alloc(dev, device_, size);
+}
+
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
+  for (StreamArena* arena : arenas_) {
+    if (arena->device_id() == dev.device_id && arena->Free(ptr)) return;
+  }
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
   array_[dev.device_id]->Free(ptr);
 }
 
+void WorkspacePool::SyncStream(Device dev, TVMStreamHandle stream) {
+  if (StreamArena* arena = FindArena(dev, stream)) {
+    arena->Sync(dev, device_);
+  }
+}
+
+void WorkspacePool::ReleaseStream(Device dev, TVMStreamHandle stream) {
+  for (auto it = arenas_.begin(); it != arenas_.end(); ++it) {
+    if ((*it)->device_id() == dev.device_id && (*it)->stream() == stream) {
+      (*it)->Release(dev, device_);
+      delete *it;
+      arenas_.erase(it);
+      return;
+    }
+  }
+}
+
+WorkspacePool::StreamArena* WorkspacePool::FindArena(Device dev, TVMStreamHandle stream) const {
+  for (StreamArena* arena : arenas_) {
+    if (arena->device_id() == dev.device_id && arena->stream() == stream) return arena;
+  }
+  return nullptr;
+}
+
 }  // namespace runtime
 }  // namespace tvm
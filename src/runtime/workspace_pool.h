@@ -58,6 +58,19 @@ class TVM_DLL WorkspacePool {
    * \param size The size to be allocated.
    */
   void* AllocWorkspace(Device dev, size_t size);
+  /*!
+   * \brief Allocate temporal workspace used by kernels launched on a stream.
+   *
+   *  Workspaces of a non-null stream are bump allocated from an arena owned by that
+   *  stream, so kernels of different streams never share memory. Freed space is only
+   *  reused by later work on the same stream; the arena is resized to its peak usage on
+   *  the next SyncStream once it is empty.
+   *
+   * \param dev The device of allocation.
+   * \param size The size to be allocated.
+   * \param stream The stream the workspace is used on, nullptr for the default pool.
+   */
+  void* AllocWorkspace(Device dev, size_t size, TVMStreamHandle stream);
   /*!
    * \brief Free temporal workspace in backend execution.
    *
@@ -65,11 +78,28 @@ class TVM_DLL WorkspacePool {
    * \param ptr The pointer to be freed.
    */
   void FreeWorkspace(Device dev, void* ptr);
+  /*!
+   * \brief Notify the pool that all work queued on a stream has completed.
+   * \param dev The device of the stream.
+   * \param stream The stream.
+   */
+  void SyncStream(Device dev, TVMStreamHandle stream);
+  /*!
+   * \brief Release the arena of a stream that is about to be destroyed.
+   * \param dev The device of the stream.
+   * \param stream The stream.
+   */
+  void ReleaseStream(Device dev, TVMStreamHandle stream);
 
  private:
   class Pool;
+  class StreamArena;
+  /*! \brief Get the arena of a stream, nullptr if it has none. */
+  StreamArena* FindArena(Device dev, TVMStreamHandle stream) const;
   /*! \brief pool of device local array */
   std::vector<Pool*> array_;
+  /*! \brief arenas of the streams used with this pool */
+  std::vector<StreamArena*> arenas_;
   /*! \brief device type this pool support */
   DLDeviceType device_type_;
   /*! \brief The device API */
@@ -287,6 +287,10 @@ String DocPrinter::GetString() const {
     text.push_back('\n');
   }
 
+  if (underlines_.empty() && !options_->print_line_numbers) {
+    // Nothing to decorate, avoid copying the text line by line
+    return String(std::move(text));
+  }
   return DecorateText(text, line_starts_, options_,
                       MergeAndExemptSpans(underlines_, underlines_exempted_));
 }
@@ -703,7 +703,8 @@ String DocToPythonScript(Doc doc, const PrinterConfig& cfg) {
   while (last_space > 0 && std::isspace(result[last_space - 1])) {
     last_space--;
   }
-  return result.substr(0, last_space);
+  result.resize(last_space);
+  return String(std::move(result));
 }
 
 TVM_REGISTER_GLOBAL("script.printer.DocToPythonScript").set_body_typed(DocToPythonScript);
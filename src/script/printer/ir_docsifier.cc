@@ -21,7 +21,9 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/script/printer/ir_docsifier.h>
 
+#include <algorithm>
 #include <sstream>
+#include <string>
 
 #include "./utils.h"
 
@@ -51,7 +53,7 @@ IdDoc IRDocsifierNode::Define(const ObjectRef& obj, const Frame& frame, const St
     stream << name << "_" << obj.get();
     name = stream.str();
   }
-  name = GenerateUniqueName(name, this->defined_names);
+  name = GenerateUniqueName(name, this->defined_names, &this->next_name_suffix);
   this->defined_names.insert(name);
   DocCreator doc_factory = [name]() { return IdDoc(name); };
   obj2info.insert({obj, VariableInfo{std::move(doc_factory), name}});
@@ -77,11 +79,13 @@ Optional<ExprDoc> IRDocsifierNode::GetVarDoc(const ObjectRef& obj) const {
 ExprDoc IRDocsifierNode::AddMetadata(const ObjectRef& obj) {
   ICHECK(obj.defined()) << "TypeError: Cannot add nullptr to metadata";
   String key = obj->GetTypeKey();
-  Array<ObjectRef>& array = metadata[key];
-  int index = std::find(array.begin(), array.end(), obj) - array.begin();
-  if (index == static_cast<int>(array.size())) {
+  auto [it, inserted] = metadata_index.emplace(obj, 0);
+  if (inserted) {
+    Array<ObjectRef>& array = metadata[key];
+    it->second = array.size();
     array.push_back(obj);
   }
+  int index = it->second;
   return IdDoc("metadata")[{LiteralDoc::Str(key, NullOpt)}][{LiteralDoc::Int(index, NullOpt)}];
 }
 
@@ -97,7 +101,19 @@ void IRDocsifierNode::RemoveVar(const ObjectRef& obj) {
   auto it = obj2info.find(obj);
   ICHECK(it != obj2info.end()) << "No such object: " << obj;
   if (it->second.name.defined()) {
-    defined_names.erase(it->second.name.value());
+    const String& name = it->second.name.value();
+    defined_names.erase(name);
+    // The suffix of the name is free again for the other variables with the same name hint
+    std::string str = name;
+    size_t pos = str.find_last_of('_');
+    size_t num_digits = str.size() - pos - 1;
+    if (pos != std::string::npos && num_digits > 0 && num_digits < 10 &&
+        std::all_of(str.begin() + pos + 1, str.end(), ::isdigit)) {
+      auto suffix_it = next_name_suffix.find(str.substr(0, pos));
+      if (suffix_it != next_name_suffix.end()) {
+        suffix_it->second = std::min(suffix_it->second, std::stoi(str.substr(pos + 1)));
+      }
+    }
   }
   obj2info.erase(it);
 }
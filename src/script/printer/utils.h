@@ -23,6 +23,7 @@
 #include <tvm/script/printer/ir_docsifier.h>
 
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -162,15 +163,30 @@ inline Optional<String> FindFunctionName(const IRDocsifier& d, const BaseFunc& f
 }
 
 inline String GenerateUniqueName(std::string name_hint,
-                                 const std::unordered_set<String>& defined_names) {
+                                 const std::unordered_set<String>& defined_names,
+                                 std::unordered_map<std::string, int>* next_suffix = nullptr) {
   for (char& c : name_hint) {
     if (c != '_' && !std::isalnum(c)) {
       c = '_';
     }
   }
-  std::string name = name_hint;
-  for (int i = 1; defined_names.count(name) > 0; ++i) {
-    name = name_hint + "_" + std::to_string(i);
+  if (defined_names.count(name_hint) == 0) {
+    return name_hint;
+  }
+  // Every suffix below `next_suffix[name_hint]` is in use, start searching from there so that
+  // defining many variables with the same hint is not quadratic
+  int i = 1;
+  if (next_suffix != nullptr) {
+    if (auto it = next_suffix->find(name_hint); it != next_suffix->end()) {
+      i = it->second;
+    }
+  }
+  std::string name = name_hint + "_" + std::to_string(i);
+  while (defined_names.count(name) > 0) {
+    name = name_hint + "_" + std::to_string(++i);
+  }
+  if (next_suffix != nullptr) {
+    (*next_suffix)[name_hint] = i + 1;
   }
   return name;
 }
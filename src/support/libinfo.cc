@@ -43,6 +43,10 @@
 #define TVM_INFO_USE_NVTX "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_CUPTI
+#define TVM_INFO_USE_CUPTI "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_NCCL
 #define TVM_INFO_USE_NCCL "NOT-FOUND"
 #endif
@@ -103,6 +107,10 @@
 #define TVM_INFO_USE_RPC "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_RPC_COMPRESSION
+#define TVM_INFO_USE_RPC_COMPRESSION "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_THREADS
 #define TVM_INFO_USE_THREADS "NOT-FOUND"
 #endif
@@ -219,6 +227,10 @@
 #define TVM_INFO_USE_SORT "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_SQLITE
+#define TVM_INFO_USE_SQLITE "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_NNPACK
 #define TVM_INFO_USE_NNPACK "NOT-FOUND"
 #endif
@@ -315,6 +327,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_CUBLAS", TVM_INFO_USE_CUBLAS},
       {"USE_CUDA", TVM_INFO_USE_CUDA},
       {"USE_NVTX", TVM_INFO_USE_NVTX},
+      {"USE_CUPTI", TVM_INFO_USE_CUPTI},
       {"USE_NCCL", TVM_INFO_USE_NCCL},
       {"USE_MSCCL", TVM_INFO_USE_MSCCL},
       {"USE_CUDNN", TVM_INFO_USE_CUDNN},
@@ -329,6 +342,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_GRAPH_EXECUTOR_CUDA_GRAPH", TVM_INFO_USE_GRAPH_EXECUTOR_CUDA_GRAPH},
       {"USE_GRAPH_EXECUTOR", TVM_INFO_USE_GRAPH_EXECUTOR},
       {"USE_GTEST", TVM_INFO_USE_GTEST},
+      {"USE_GBENCHMARK", TVM_INFO_USE_GBENCHMARK},
       {"USE_HEXAGON", TVM_INFO_USE_HEXAGON},
       {"USE_HEXAGON_RPC", TVM_INFO_USE_HEXAGON_RPC},
       {"USE_HEXAGON_SDK", TVM_INFO_USE_HEXAGON_SDK},
@@ -363,10 +377,12 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_ROCM", TVM_INFO_USE_ROCM},
       {"USE_RCCL", TVM_INFO_USE_RCCL},
       {"USE_RPC", TVM_INFO_USE_RPC},
+      {"USE_RPC_COMPRESSION", TVM_INFO_USE_RPC_COMPRESSION},
       {"USE_RTTI", TVM_INFO_USE_RTTI},
       {"USE_RUST_EXT", TVM_INFO_USE_RUST_EXT},
       {"USE_SORT", TVM_INFO_USE_SORT},
       {"USE_SPIRV_KHR_INTEGER_DOT_PRODUCT", TVM_INFO_USE_SPIRV_KHR_INTEGER_DOT_PRODUCT},
+      {"USE_SQLITE", TVM_INFO_USE_SQLITE},
       {"USE_STACKVM_RUNTIME", TVM_INFO_USE_STACKVM_RUNTIME},
       {"USE_TARGET_ONNX", TVM_INFO_USE_TARGET_ONNX},
       {"USE_TENSORFLOW_PATH", TVM_INFO_USE_TENSORFLOW_PATH},
@@ -24,7 +24,17 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
-#include <future>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -32,6 +42,197 @@
 namespace tvm {
 namespace support {
 
+namespace {
+
+/*!
+ * \brief The process-wide work-stealing thread pool behind parallel_for.
+ *
+ * Each worker owns a task deque: it pushes and pops its own tasks at the back,
+ * and steals from the front of the other deques when its own is empty.
+ * A thread waiting for a group of tasks keeps running the queued tasks instead
+ * of blocking, which makes nested parallel loops safe and deadlock-free.
+ */
+class ParallelForPool {
+ public:
+  /*! \brief The completion state of the tasks of a single parallel loop. */
+  class TaskGroup {
+   public:
+    /*! \param num_tasks The number of tasks that will be submitted to the group. */
+    explicit TaskGroup(int num_tasks) : num_pending_(num_tasks) {}
+
+    /*! \brief Record the error of a task, only the first one is kept. */
+    void SetError(const std::string& error) {
+      std::lock_guard<std::mutex> lock(mu_);
+      if (!has_error_) {
+        has_error_ = true;
+        error_ = error;
+      }
+    }
+
+    /*! \brief Return the first error if any task failed. */
+    bool GetError(std::string* error) {
+      std::lock_guard<std::mutex> lock(mu_);
+      *error = error_;
+      return has_error_;
+    }
+
+   private:
+    friend class ParallelForPool;
+    std::atomic<int> num_pending_;
+    std::mutex mu_;
+    bool has_error_ = false;
+    std::string error_;
+  };
+
+  /*! \brief Get the pool of the current process, creating it on first use. */
+  static ParallelForPool* Global() {
+    static std::mutex mu;
+    // The pool is never destroyed, so that the workers do not race with static destructors
+    // at exit. A forked child process does not inherit the workers and creates a new pool.
+    static ParallelForPool* pool = nullptr;
+    std::lock_guard<std::mutex> lock(mu);
+    if (pool == nullptr || pool->pid_ != CurrentPid()) {
+      pool = new ParallelForPool();
+    }
+    return pool;
+  }
+
+  /*!
+   * \brief Submit a task belonging to the group. It runs on any worker or waiting thread.
+   * \param group The group of the task, signaled when the task finishes.
+   * \param task The task to run.
+   */
+  void Submit(TaskGroup* group, std::function<void()> task) {
+    std::function<void()> wrapped = [this, group, task = std::move(task)]() {
+      try {
+        task();
+      } catch (const std::exception& e) {
+        group->SetError(e.what());
+      }
+      if (--group->num_pending_ == 0) {
+        // Wake up the thread waiting for the group.
+        std::lock_guard<std::mutex> lock(sleep_mu_);
+        sleep_cv_.notify_all();
+      }
+    };
+    int queue_id = worker_id_ >= 0 && worker_pool_ == this
+                       ? worker_id_
+                       : static_cast<int>(next_queue_++ % queues_.size());
+    {
+      std::lock_guard<std::mutex> lock(queues_[queue_id]->mu);
+      queues_[queue_id]->tasks.push_back(std::move(wrapped));
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mu_);
+      ++num_queued_tasks_;
+    }
+    sleep_cv_.notify_one();
+  }
+
+  /*! \brief Run the queued tasks until all the tasks of the group finish. */
+  void Wait(TaskGroup* group) {
+    while (group->num_pending_.load() > 0) {
+      if (RunOneTask()) continue;
+      std::unique_lock<std::mutex> lock(sleep_mu_);
+      sleep_cv_.wait(lock, [&]() {
+        return group->num_pending_.load() == 0 || num_queued_tasks_ > 0;
+      });
+    }
+  }
+
+  /*! \brief The number of threads that run tasks, including the calling thread. */
+  int NumThreads() const { return static_cast<int>(workers_.size()) + 1; }
+
+ private:
+  struct TaskQueue {
+    std::mutex mu;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  ParallelForPool() : pid_(CurrentPid()) {
+    int num_workers = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+    for (int i = 0; i < num_workers; ++i) {
+      queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    for (int i = 0; i < num_workers; ++i) {
+      workers_.emplace_back([this, i]() { WorkerLoop(i); });
+      workers_.back().detach();
+    }
+  }
+
+  static int64_t CurrentPid() {
+#ifndef _WIN32
+    return static_cast<int64_t>(getpid());
+#else
+    return 0;
+#endif
+  }
+
+  void WorkerLoop(int worker_id) {
+    worker_id_ = worker_id;
+    worker_pool_ = this;
+    while (true) {
+      if (RunOneTask()) continue;
+      std::unique_lock<std::mutex> lock(sleep_mu_);
+      sleep_cv_.wait(lock, [this]() { return num_queued_tasks_ > 0; });
+    }
+  }
+
+  /*!
+   * \brief Pop a task from the queue of the current worker, or steal one from the others.
+   * \return Whether a task was run.
+   */
+  bool RunOneTask() {
+    std::function<void()> task;
+    int num_queues = static_cast<int>(queues_.size());
+    int self = worker_id_ >= 0 && worker_pool_ == this ? worker_id_ : -1;
+    if (self >= 0) {
+      std::lock_guard<std::mutex> lock(queues_[self]->mu);
+      if (!queues_[self]->tasks.empty()) {
+        task = std::move(queues_[self]->tasks.back());
+        queues_[self]->tasks.pop_back();
+      }
+    }
+    for (int i = 1; !task && i <= num_queues; ++i) {
+      int victim = ((self >= 0 ? self : 0) + i) % num_queues;
+      std::lock_guard<std::mutex> lock(queues_[victim]->mu);
+      if (!queues_[victim]->tasks.empty()) {
+        task = std::move(queues_[victim]->tasks.front());
+        queues_[victim]->tasks.pop_front();
+      }
+    }
+    if (!task) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mu_);
+      --num_queued_tasks_;
+    }
+    task();
+    return true;
+  }
+
+  /*! \brief The id of the process that created the pool. */
+  const int64_t pid_;
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<uint32_t> next_queue_{0};
+  /*! \brief The number of tasks in all the queues, guarded by sleep_mu_. */
+  int64_t num_queued_tasks_ = 0;
+  std::mutex sleep_mu_;
+  std::condition_variable sleep_cv_;
+
+  /*! \brief The worker index of the current thread, or -1 for non-worker threads. */
+  static thread_local int worker_id_;
+  /*! \brief The pool the current worker thread belongs to. */
+  static thread_local ParallelForPool* worker_pool_;
+};
+
+thread_local int ParallelForPool::worker_id_ = -1;
+thread_local ParallelForPool* ParallelForPool::worker_pool_ = nullptr;
+
+}  // namespace
+
 std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int num_threads) {
   int total_task_count = (end - begin) / step;
   ICHECK_GE(total_task_count, 0) << "Infinite loop condition with begin: " << begin
@@ -49,47 +250,34 @@ std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int n
 
 void parallel_for(int begin, int end, const std::function<void(int)>& f, int step,
                   const PartitionerFuncType partitioner) {
-  static bool GLOBAL_PARALLEL_FOR_FLAG{false};
-  static std::mutex M_GLOBAL_PARALLEL_FOR_FLAG;
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(!GLOBAL_PARALLEL_FOR_FLAG) << "There's another parallel_for running. Maybe you're "
-                                      << "currently inside another parallel_for loop.";
-    GLOBAL_PARALLEL_FOR_FLAG = true;
-  }
-
-  int default_num_threads = std::thread::hardware_concurrency();
-  const auto& run_partitions = partitioner(begin, end, step, default_num_threads);
-
-  std::vector<std::thread> threads;
-  threads.reserve(run_partitions.size());
-  std::vector<std::future<void>> res_vec;
-  res_vec.reserve(run_partitions.size());
-  for (const auto& run_partition : run_partitions) {
-    std::packaged_task<void(const std::vector<int>&, const std::function<void(int)>&)> task(
-        [](const std::vector<int>& run_partition, const std::function<void(int)>& f) {
-          for (const auto& i : run_partition) {
-            f(i);
-          }
-        });
-    res_vec.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), run_partition, f);
-  }
-
-  for (auto&& thread : threads) {
-    thread.join();
-  }
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(GLOBAL_PARALLEL_FOR_FLAG);
-    GLOBAL_PARALLEL_FOR_FLAG = false;
+  ParallelForPool* pool = ParallelForPool::Global();
+  const auto& run_partitions = partitioner(begin, end, step, pool->NumThreads());
+  if (run_partitions.empty()) {
+    return;
   }
+
+  ParallelForPool::TaskGroup group(run_partitions.size() - 1);
+  for (size_t i = 1; i < run_partitions.size(); ++i) {
+    const std::vector<int>* run_partition = &run_partitions[i];
+    pool->Submit(&group, [run_partition, &f]() {
+      for (const auto& i : *run_partition) {
+        f(i);
+      }
+    });
+  }
+  // Run the first partition on the calling thread.
   try {
-    for (auto&& i : res_vec) {
-      i.get();
+    for (const auto& i : run_partitions[0]) {
+      f(i);
     }
   } catch (const std::exception& e) {
-    LOG(FATAL) << "Parallel_for error with " << e.what();
+    group.SetError(e.what());
+  }
+  pool->Wait(&group);
+
+  std::string error;
+  if (group.GetError(&error)) {
+    LOG(FATAL) << "Parallel_for error with " << error;
   }
 }
 
@@ -101,42 +289,31 @@ void parallel_for_dynamic(int begin, int end, int num_threads,
   }
   CHECK_LE(begin, end) << "ValueError: The interval [begin, end) requires `begin <= end`";
   CHECK_GT(num_threads, 0) << "ValueError: `num_threads` should be positive";
-  // Step 2. Launch threads
-  // Step 2.1. Launch worker 1 to worker `num_threads - 1`
+  // Step 2. Launch the workers. Each of the `num_threads` logical threads runs as one task,
+  // so that a thread id is never used by two tasks at the same time.
+  ParallelForPool* pool = ParallelForPool::Global();
   std::atomic<int> counter{begin};
-  std::vector<std::future<void>> futures;
-  std::vector<std::thread> threads;
-  futures.reserve(num_threads - 1);
-  threads.reserve(num_threads - 1);
   auto worker = [end, &counter, &f](int thread_id) -> void {
     for (int task_id; (task_id = counter++) < end;) {
       f(thread_id, task_id);
     }
   };
+  ParallelForPool::TaskGroup group(num_threads - 1);
+  // Step 2.1. Launch worker 1 to worker `num_threads - 1`
   for (int thread_id = 1; thread_id < num_threads; ++thread_id) {
-    std::packaged_task<void(int)> task(worker);
-    futures.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), thread_id);
+    pool->Submit(&group, [thread_id, &worker]() { worker(thread_id); });
   }
   // Step 2.2. Launch worker 0 inplace
   try {
     worker(0);
   } catch (const std::exception& e) {
-    for (auto&& thread : threads) {
-      thread.join();
-    }
-    LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
-  }
-  // Step 3. Join threads and check exceptions
-  for (auto&& thread : threads) {
-    thread.join();
+    group.SetError(e.what());
   }
-  try {
-    for (auto&& future : futures) {
-      future.get();
-    }
-  } catch (const std::exception& e) {
-    LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
+  // Step 3. Wait for the workers and check exceptions
+  pool->Wait(&group);
+  std::string error;
+  if (group.GetError(&error)) {
+    LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << error;
   }
 }
 
@@ -27,7 +27,11 @@
 #include <tvm/runtime/logging.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace tvm {
@@ -190,6 +194,94 @@ class RingBuffer {
   // The internal data ring.
   std::vector<char> ring_;
 };
+
+/*!
+ * \brief A fixed capacity ring of trivially copyable records, pushed by any number of threads
+ *  without locks and drained by a single consumer.
+ *
+ *  Producers never wait: a record overwrites the oldest one once the ring is full, and is
+ *  dropped if another producer is still writing its slot. Each slot carries a sequence number,
+ *  so the consumer skips the records overwritten or in progress while it copies them out.
+ * \tparam T The type of the records.
+ */
+template <typename T>
+class LockFreeRingBuffer {
+  static_assert(std::is_trivially_copyable<T>::value, "The records must be trivially copyable");
+
+ public:
+  /*!
+   * \brief Constructor.
+   * \param capacity The number of records kept, rounded up to a power of two.
+   */
+  explicit LockFreeRingBuffer(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    slots_.reset(new Slot[size]);
+    mask_ = size - 1;
+  }
+  /*! \return The number of records kept. */
+  size_t capacity() const { return mask_ + 1; }
+  /*!
+   * \brief Push a record, wait-free.
+   * \param record The record to be pushed.
+   */
+  void Push(const T& record) {
+    uint64_t ticket = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[ticket & mask_];
+    // Claim the slot, unless a lapped producer is still writing it.
+    uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) || seq > 2 * ticket ||
+        !slot.seq.compare_exchange_strong(seq, 2 * ticket + 1, std::memory_order_acquire)) {
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.record, &record, sizeof(T));
+    slot.seq.store(2 * ticket + 2, std::memory_order_release);
+  }
+  /*!
+   * \brief Copy out the records pushed since the last drain, in order. Single consumer only.
+   * \param fvisit The function called on each record, with signature void(const T&).
+   * \return The number of records lost since the last drain, overwritten or still in progress.
+   */
+  template <typename FVisit>
+  uint64_t Drain(FVisit fvisit) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t begin = std::max(tail_, head > capacity() ? head - capacity() : 0);
+    uint64_t num_lost = begin - tail_;
+    T record;
+    for (uint64_t ticket = begin; ticket < head; ++ticket) {
+      Slot& slot = slots_[ticket & mask_];
+      if (slot.seq.load(std::memory_order_acquire) != 2 * ticket + 2) {
+        ++num_lost;
+        continue;
+      }
+      memcpy(&record, &slot.record, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.seq.load(std::memory_order_relaxed) != 2 * ticket + 2) {
+        ++num_lost;
+        continue;
+      }
+      fvisit(record);
+    }
+    tail_ = head;
+    return num_lost;
+  }
+
+ private:
+  /*! \brief A record and the sequence number of its latest write, odd while being written. */
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    T record;
+  };
+  /*! \brief The slots of the ring. */
+  std::unique_ptr<Slot[]> slots_;
+  /*! \brief The capacity minus one. */
+  uint64_t mask_;
+  /*! \brief The ticket of the next push. */
+  std::atomic<uint64_t> head_{0};
+  /*! \brief The ticket of the next record to drain. */
+  uint64_t tail_{0};
+};
 }  // namespace support
 }  // namespace tvm
 #endif  // TVM_SUPPORT_RING_BUFFER_H_
@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tree_ensemble.h
+ * \brief A tree ensemble trained by XGBoost, walked natively by the tuning cost models.
+ *
+ * The python side exports the trees as four arrays:
+ *  - nodes: int32 [n, 4], the split feature, left child, right child and the child taken by
+ *    missing values of each node, or -1 for the leaves;
+ *  - values: float32 [n], the split threshold of each node, or the value of each leaf;
+ *  - roots: int32 [num_trees], the root node of each tree;
+ *  - base_score: float64 [1], the bias of the prediction of each feature vector.
+ * Comparisons follow XGBoost: the features are compared as float32 and NaN is missing.
+ */
+#ifndef TVM_SUPPORT_TREE_ENSEMBLE_H_
+#define TVM_SUPPORT_TREE_ENSEMBLE_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/optional.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace support {
+
+/*! \brief A tree ensemble predicting blocks of feature vectors. */
+class TreeEnsemble {
+ public:
+  /*!
+   * \brief The number of feature vectors walked down each tree together. Walking the trees one by
+   * one over a block keeps the nodes of a tree in cache while it is shared by the whole block.
+   */
+  static constexpr int kRowsPerBlock = 64;
+
+  /*! \brief Whether the ensemble has no tree, i.e. the model is not trained. */
+  bool empty() const { return roots_.empty(); }
+
+  /*! \brief The largest split feature, or -1 if the ensemble does not split. */
+  int32_t max_feature() const { return max_feature_; }
+
+  /*!
+   * \brief Predict a block of feature vectors.
+   * \param rows The feature vectors.
+   * \param num_rows The number of feature vectors, at most kRowsPerBlock.
+   * \param scores The predictions to be written.
+   */
+  template <typename T>
+  void PredictRows(const T* const* rows, int num_rows, float* scores) const {
+    const TreeNode* nodes = nodes_.data();
+    for (int r = 0; r < num_rows; ++r) {
+      scores[r] = base_score_;
+    }
+    for (int32_t root : roots_) {
+      for (int r = 0; r < num_rows; ++r) {
+        const T* row = rows[r];
+        const TreeNode* node = nodes + root;
+        while (node->left != -1) {
+          float x = static_cast<float>(row[node->feature]);
+          if (std::isnan(x)) {
+            node = nodes + node->missing;
+          } else {
+            node = nodes + (x < node->value ? node->left : node->right);
+          }
+        }
+        scores[r] += node->value;
+      }
+    }
+  }
+
+  /*! \brief Replace the tree ensemble, or clear it if \p opt_ensemble is NullOpt. */
+  void Set(const Optional<Array<runtime::NDArray>>& opt_ensemble) {
+    if (!opt_ensemble.defined()) {
+      nodes_.clear();
+      roots_.clear();
+      return;
+    }
+    Array<runtime::NDArray> ensemble = opt_ensemble.value();
+    ICHECK_EQ(ensemble.size(), 4) << "ValueError: A tree ensemble consists of nodes, values, roots "
+                                     "and base_score, but got "
+                                  << ensemble.size() << " arrays";
+    auto f_check = [](const runtime::NDArray& array, DataType dtype, int ndim, const char* name) {
+      ICHECK(array->device.device_type == kDLCPU) << "ValueError: `" << name << "` must be on CPU";
+      ICHECK(DataType(array->dtype) == dtype && array->ndim == ndim && array.IsContiguous())
+          << "ValueError: `" << name << "` must be a contiguous " << ndim << "-d " << dtype
+          << " array";
+    };
+    const runtime::NDArray& nodes = ensemble[0];
+    const runtime::NDArray& values = ensemble[1];
+    const runtime::NDArray& roots = ensemble[2];
+    const runtime::NDArray& base_score = ensemble[3];
+    f_check(nodes, DataType::Int(32), 2, "nodes");
+    f_check(values, DataType::Float(32), 1, "values");
+    f_check(roots, DataType::Int(32), 1, "roots");
+    f_check(base_score, DataType::Float(64), 1, "base_score");
+    int64_t n = nodes->shape[0];
+    ICHECK_EQ(nodes->shape[1], 4);
+    ICHECK_EQ(values->shape[0], n);
+    ICHECK_EQ(base_score->shape[0], 1);
+    const int32_t* node_data = static_cast<const int32_t*>(nodes->data);
+    const float* value_data = static_cast<const float*>(values->data);
+    std::vector<TreeNode> new_nodes(n);
+    int32_t max_feature = -1;
+    for (int64_t i = 0; i < n; ++i) {
+      TreeNode& node = new_nodes[i];
+      node.value = value_data[i];
+      node.feature = node_data[i * 4 + 0];
+      node.left = node_data[i * 4 + 1];
+      node.right = node_data[i * 4 + 2];
+      node.missing = node_data[i * 4 + 3];
+      if (node.left == -1) {
+        continue;
+      }
+      // Children always come after their parent, so that every walk terminates
+      auto f_valid_child = [i, n](int32_t child) { return child > i && child < n; };
+      ICHECK(node.feature >= 0 && f_valid_child(node.left) && f_valid_child(node.right) &&
+             (node.missing == node.left || node.missing == node.right))
+          << "ValueError: Malformed tree node " << i;
+      max_feature = std::max(max_feature, node.feature);
+    }
+    const int32_t* root_data = static_cast<const int32_t*>(roots->data);
+    std::vector<int32_t> new_roots(root_data, root_data + roots->shape[0]);
+    for (int32_t root : new_roots) {
+      ICHECK(root >= 0 && root < n) << "ValueError: Malformed tree root " << root;
+    }
+    nodes_ = std::move(new_nodes);
+    roots_ = std::move(new_roots);
+    base_score_ = static_cast<const double*>(base_score->data)[0];
+    max_feature_ = max_feature;
+  }
+
+ private:
+  /*! \brief A node of the tree ensemble. */
+  struct TreeNode {
+    /*! \brief The split threshold, or the leaf value */
+    float value;
+    /*! \brief The split feature */
+    int32_t feature;
+    /*! \brief The left child, or -1 for a leaf */
+    int32_t left;
+    /*! \brief The right child */
+    int32_t right;
+    /*! \brief The child taken by missing values */
+    int32_t missing;
+  };
+
+  /*! \brief The nodes of all the trees. */
+  std::vector<TreeNode> nodes_;
+  /*! \brief The root node of each tree, empty if the model is not trained. */
+  std::vector<int32_t> roots_;
+  /*! \brief The bias of the prediction of each feature vector. */
+  float base_score_ = 0.0f;
+  /*! \brief The largest split feature. */
+  int32_t max_feature_ = -1;
+};
+
+}  // namespace support
+}  // namespace tvm
+
+#endif  // TVM_SUPPORT_TREE_ENSEMBLE_H_
@@ -109,17 +109,13 @@ class ModuleSerializer {
           }
         } else if (group[0]->IsBinarySerializable()) {
           ICHECK_EQ(group.size(), 1U) << "Non DSO module is never merged";
-          std::string mod_type_key = group[0]->type_key();
-          stream->Write(mod_type_key);
-          group[0]->SaveToBinary(stream);
+          SerializeSizedImport(stream, group[0]);
         }
       } else {
         ICHECK(group[0]->IsBinarySerializable())
             << group[0]->type_key() << " is not binary serializable.";
         ICHECK_EQ(group.size(), 1U) << "Non DSO module is never merged";
-        std::string mod_type_key = group[0]->type_key();
-        stream->Write(mod_type_key);
-        group[0]->SaveToBinary(stream);
+        SerializeSizedImport(stream, group[0]);
       }
     }
 
@@ -133,6 +129,18 @@ class ModuleSerializer {
   }
 
  private:
+  // Serialize the module along with the size of its payload, which allows the
+  // loader to defer its deserialization, see runtime::kSizedImportKey.
+  void SerializeSizedImport(dmlc::Stream* stream, runtime::ModuleNode* mod) {
+    std::string payload;
+    dmlc::MemoryStringStream payload_stream(&payload);
+    mod->SaveToBinary(&payload_stream);
+    stream->Write(std::string(runtime::kSizedImportKey));
+    stream->Write(std::string(mod->type_key()));
+    stream->Write(mod->GetPropertyMask());
+    stream->Write(payload);
+  }
+
   void Init() {
     CreateModuleIndex();
     CreateImportTree();
@@ -282,6 +290,14 @@ runtime::Module DeserializeModuleFromBytes(std::string blob) {
     if (tkey == "_import_tree") {
       ICHECK(stream->Read(&import_tree_row_ptr));
       ICHECK(stream->Read(&import_tree_child_indices));
+    } else if (tkey == runtime::kSizedImportKey) {
+      std::string type_key, payload;
+      int property_mask;
+      ICHECK(stream->Read(&type_key));
+      ICHECK(stream->Read(&property_mask));
+      ICHECK(stream->Read(&payload));
+      dmlc::MemoryStringStream payload_stream(&payload);
+      modules.emplace_back(runtime::LoadModuleFromBinary(type_key, &payload_stream));
     } else {
       auto m = runtime::LoadModuleFromBinary(tkey, stream);
       modules.emplace_back(m);
@@ -56,6 +56,7 @@
 #include <string>
 #include <utility>
 
+#include "codegen_params.h"
 #include "llvm_instance.h"
 
 namespace tvm {
@@ -72,30 +73,41 @@ std::unique_ptr<llvm::Module> CodeGenBlob(const std::string& data, bool system_l
   module->setTargetTriple(triple.str());
   llvm_target->SetTargetMetadata(module.get());
   module->setDataLayout(tm->createDataLayout());
-  auto* blob_value = llvm::ConstantDataArray::getString(*ctx, data, false);
   std::string mdev_blob_name = c_symbol_prefix + runtime::symbol::tvm_dev_mblob;
 
-  auto* tvm_dev_mblob = new llvm::GlobalVariable(
-      *module, blob_value->getType(), true, llvm::GlobalValue::ExternalLinkage, blob_value,
-      mdev_blob_name, nullptr, llvm::GlobalVariable::NotThreadLocal, 0);
-
-  // If large const data (>2GB) is saved to default .rodata section
-  // then linking it to shared library will fail - relocation truncated to fit: R_X86_64_PC32.
-  // The issue exists on Linux x86_64 platform.
-  // GCC handles this situation by using -mcmodel=medium parameter but LLVM ignores it.
-  // The workaround is to explicitly put large const data to .lrodata section.
-  // Lets put const data which is larger than 1GB to .lrodata section
-  const size_t large_data_threshold = 1 << 30;
-  if (data.size() > large_data_threshold && triple.getArch() == llvm::Triple::x86_64 &&
-      triple.isOSBinFormatELF()) {
-    tvm_dev_mblob->setSection(".lrodata");
+  // A large blob is included in the object file as it is, rather than going through LLVM
+  llvm::GlobalVariable* tvm_dev_mblob = nullptr;
+  int64_t raw_data_section_threshold = GetRawDataSectionThreshold();
+  if (raw_data_section_threshold > 0 &&
+      data.size() >= static_cast<size_t>(raw_data_section_threshold)) {
+    tvm_dev_mblob = EmitRawDataSection(module.get(), mdev_blob_name, data.data(), data.size(),
+                                       /*exported=*/true);
   }
 
+  if (tvm_dev_mblob == nullptr) {
+    auto* blob_value = llvm::ConstantDataArray::getString(*ctx, data, false);
+    tvm_dev_mblob = new llvm::GlobalVariable(
+        *module, blob_value->getType(), true, llvm::GlobalValue::ExternalLinkage, blob_value,
+        mdev_blob_name, nullptr, llvm::GlobalVariable::NotThreadLocal, 0);
+
+    // If large const data (>2GB) is saved to default .rodata section
+    // then linking it to shared library will fail - relocation truncated to fit: R_X86_64_PC32.
+    // The issue exists on Linux x86_64 platform.
+    // GCC handles this situation by using -mcmodel=medium parameter but LLVM ignores it.
+    // The workaround is to explicitly put large const data to .lrodata section.
+    // Lets put const data which is larger than 1GB to .lrodata section
+    const size_t large_data_threshold = 1 << 30;
+    if (data.size() > large_data_threshold && triple.getArch() == llvm::Triple::x86_64 &&
+        triple.isOSBinFormatELF()) {
+      tvm_dev_mblob->setSection(".lrodata");
+    }
+
 #if TVM_LLVM_VERSION >= 100
-  tvm_dev_mblob->setAlignment(llvm::Align(1));
+    tvm_dev_mblob->setAlignment(llvm::Align(1));
 #else
-  tvm_dev_mblob->setAlignment(1);
+    tvm_dev_mblob->setAlignment(1);
 #endif
+  }
 
   if (triple.isOSWindows()) {
     tvm_dev_mblob->setDLLStorageClass(llvm::GlobalVariable::DLLExportStorageClass);
@@ -187,8 +199,8 @@ std::unique_ptr<llvm::Module> CodeGenBlob(const std::string& data, bool system_l
     llvm::SmallVector<llvm::Value*, 2> args;
     args.push_back(llvm::ConstantExpr::getGetElementPtr(tvm_dev_mblob_string_ty,
                                                         tvm_dev_mblob_string, indices));
-    args.push_back(
-        llvm::ConstantExpr::getGetElementPtr(blob_value->getType(), tvm_dev_mblob, indices));
+    args.push_back(llvm::ConstantExpr::getGetElementPtr(tvm_dev_mblob->getValueType(),
+                                                        tvm_dev_mblob, indices));
     auto* tvm_backend_fn_ret_value = ir_builder.CreateCall(tvm_backend_fn, args);
     ir_builder.CreateStore(tvm_backend_fn_ret_value, tvm_dev_mblob_reg);
     ir_builder.CreateRetVoid();
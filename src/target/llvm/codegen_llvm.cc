@@ -179,6 +179,9 @@ void CodeGenLLVM::InitTarget() {
       native_vector_bits_ = 256;
     } else if (arch == llvm::Triple::arm || arch == llvm::Triple::aarch64) {
       native_vector_bits_ = 128;
+    } else if (arch == llvm::Triple::wasm32 || arch == llvm::Triple::wasm64) {
+      // SIMD128
+      native_vector_bits_ = 128;
     } else {
       native_vector_bits_ = 128;
       std::string arch_name = std::string(tm->getTargetTriple().getArchName());
@@ -802,6 +805,37 @@ llvm::Value* CodeGenLLVM::CreateVecPad(llvm::Value* vec, int target_lanes) {
   return builder_->CreateShuffleVector(vec, vec, mask);
 }
 
+llvm::Value* CodeGenLLVM::CreateVecReduce(const Op& op, DataType t, llvm::Value* vec) {
+  if (t.is_float()) {
+    llvm::Type* elem_type = DTypeToLLVMType(t.element_of());
+    llvm::Value* res = nullptr;
+    if (op.same_as(builtin::vector_reduce_add())) {
+      res = builder_->CreateFAddReduce(llvm::ConstantFP::getNegativeZero(elem_type), vec);
+    } else if (op.same_as(builtin::vector_reduce_mul())) {
+      res = builder_->CreateFMulReduce(llvm::ConstantFP::get(elem_type, 1.0), vec);
+    } else if (op.same_as(builtin::vector_reduce_min())) {
+      return builder_->CreateFPMinReduce(vec);
+    } else {
+      ICHECK(op.same_as(builtin::vector_reduce_max()));
+      return builder_->CreateFPMaxReduce(vec);
+    }
+    // The lanes are combined in any order, so that the reduction is lowered to a tree of
+    // shuffles instead of a sequential chain.
+    llvm::cast<llvm::Instruction>(res)->setHasAllowReassoc(true);
+    return res;
+  }
+  if (op.same_as(builtin::vector_reduce_add())) {
+    return builder_->CreateAddReduce(vec);
+  } else if (op.same_as(builtin::vector_reduce_mul())) {
+    return builder_->CreateMulReduce(vec);
+  } else if (op.same_as(builtin::vector_reduce_min())) {
+    return builder_->CreateIntMinReduce(vec, t.is_int());
+  } else {
+    ICHECK(op.same_as(builtin::vector_reduce_max()));
+    return builder_->CreateIntMaxReduce(vec, t.is_int());
+  }
+}
+
 llvm::Value* CodeGenLLVM::CreateVecConcat(std::vector<llvm::Value*> vecs) {
   // To allow creating vectors from scalars, convert any scalars in "vecs" to single-lane
   // LLVM vector types.
@@ -1358,6 +1392,18 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
       }
     }
 
+    // The bfloat16 vectors are legalized into uint16 storage before the codegen, so they are
+    // reinterpreted as the bfloat types taken by the intrinsics.
+    llvm::FunctionType* f_type = f->getFunctionType();
+    for (size_t i = 0; i < arg_value.size() && i < f_type->getNumParams(); ++i) {
+      llvm::Type* param_type = f_type->getParamType(i);
+      llvm::Type* value_type = arg_value[i]->getType();
+      if (param_type != value_type && param_type->isVectorTy() && value_type->isVectorTy() &&
+          param_type->getPrimitiveSizeInBits() == value_type->getPrimitiveSizeInBits()) {
+        arg_value[i] = builder_->CreateBitCast(arg_value[i], param_type);
+      }
+    }
+
     return builder_->CreateCall(f, arg_value);
   } else if (op->op.same_as(builtin::bitwise_and())) {
     return builder_->CreateAnd(MakeValue(op->args[0]), MakeValue(op->args[1]));
@@ -1452,6 +1498,11 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
     llvm::Value* v = MakeValue(op->args[0]);
     int l = GetVectorNumElements(v);
     return CreateVecSlice(v, l / 2, l / 2);
+  } else if (op->op.same_as(builtin::vector_reduce_add()) ||
+             op->op.same_as(builtin::vector_reduce_mul()) ||
+             op->op.same_as(builtin::vector_reduce_min()) ||
+             op->op.same_as(builtin::vector_reduce_max())) {
+    return CreateVecReduce(Downcast<Op>(op->op), op->args[0].dtype(), MakeValue(op->args[0]));
   } else if (op->op.same_as(builtin::vectorcombine())) {
     llvm::Value* v0 = MakeValue(op->args[0]);
     llvm::Value* v1 = MakeValue(op->args[1]);
@@ -2012,10 +2063,14 @@ void CodeGenLLVM::VisitStmt_(const IfThenElseNode* op) {
 void CodeGenLLVM::VisitStmt_(const AllocateConstNode* op) {
   EmitDebugLocation(op);
   auto data = op->data.value();
-  auto array = NDArrayToLLVMArray(llvm_target_->GetContext(), data);
   std::string symbol_name = op->buffer_var->name_hint;
-  llvm::GlobalVariable* param_symbol = new llvm::GlobalVariable(
-      *module_, array->getType(), true, llvm::GlobalValue::InternalLinkage, array, symbol_name);
+  llvm::GlobalVariable* param_symbol =
+      NDArrayToRawDataSection(module_.get(), symbol_name, data, raw_data_section_threshold_);
+  if (param_symbol == nullptr) {
+    auto array = NDArrayToLLVMArray(llvm_target_->GetContext(), data);
+    param_symbol = new llvm::GlobalVariable(*module_, array->getType(), true,
+                                            llvm::GlobalValue::InternalLinkage, array, symbol_name);
+  }
 
   var_map_[op->buffer_var.operator->()] = param_symbol;
   this->VisitStmt(op->body);
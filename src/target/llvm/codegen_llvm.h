@@ -133,6 +133,13 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
    */
   void SetFastMathFlags(llvm::FastMathFlags fmf);
 
+  /*!
+   * \brief Emit the constants of at least the given number of bytes as raw data sections.
+   * \param threshold The size threshold in bytes, 0 to always emit LLVM constants.
+   * \sa NDArrayToRawDataSection
+   */
+  void SetRawDataSectionThreshold(int64_t threshold) { raw_data_section_threshold_ = threshold; }
+
   virtual llvm::Function* DeclareFunction(const GlobalVar& gvar, const PrimFunc& f);
 
   /*!
@@ -481,6 +488,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   llvm::Value* CreateVecFlip(llvm::Value* vec);
   llvm::Value* CreateVecConcat(std::vector<llvm::Value*> vecs);
   llvm::Value* CreateVecPad(llvm::Value* vec, int target_lanes);
+  // Horizontal reduction of the lanes of a vector, by one of the builtin::vector_reduce_* ops.
+  llvm::Value* CreateVecReduce(const Op& op, DataType t, llvm::Value* vec);
   // Create serial for
   void CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Value* stride,
                        const Var& loop_var, const Stmt& body);
@@ -544,6 +553,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   std::vector<std::unique_ptr<llvm::Module>> link_modules_;
   /*! \brief native vector bits of current targetx*/
   int native_vector_bits_{0};
+  /*! \brief The size from which the constants are emitted as raw data sections, 0 if never. */
+  int64_t raw_data_section_threshold_{0};
   /*! \brief the storage scope of allocation */
   std::unordered_map<const VarNode*, StorageInfo> alloc_storage_info_;
   // The definition of local variable.
@@ -25,18 +25,44 @@
 #include "codegen_params.h"
 
 #include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallString.h>
+#if LLVM_VERSION_MAJOR >= 17
+#include <llvm/TargetParser/Triple.h>
+#else
+#include <llvm/ADT/Triple.h>
+#endif
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Mangler.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Module.h>
+#if TVM_LLVM_VERSION >= 100
+#include <llvm/Support/Alignment.h>
+#endif
 #include <llvm/Support/Casting.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SwapByteOrder.h>
+#include <llvm/Support/raw_ostream.h>
+#include <tvm/ir/transform.h>
 
 #include <algorithm>
+#include <sstream>
 #include <type_traits>
 #include <vector>
 
 namespace tvm {
 namespace codegen {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("llvm.raw_data_section_threshold", Integer);
+
+/*! \brief The named metadata listing the files included by the raw data sections. */
+static constexpr const char* kRawDataFiles = "tvm.raw_data_files";
+
+/*! \brief The alignment of the raw data sections, a page. */
+static constexpr int kRawDataAlignmentLog2 = 12;
+
 template <typename T, typename E = void>
 struct LLVMConstantGetter {
   static llvm::Constant* getElement(llvm::Type* ty, T t);
@@ -167,6 +193,7 @@ llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::
           << "CodegenParams: only support 16-bit bfloat; saw " << arr_type.bits() << "-bit array";
       element_type = llvm::Type::getIntNTy(*ctx, arr_type.bits());
       BuildLLVMVector<uint16_t>(element_type, arr->data, num_elements, &elements);
+      break;
 
     default:
       CHECK(false) << "Data type not supported";
@@ -176,6 +203,141 @@ llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::
       llvm::ArrayType::get(element_type, num_elements), llvm::ArrayRef<llvm::Constant*>(elements)));
 }
 
+int64_t GetRawDataSectionThreshold() {
+  int64_t threshold = transform::PassContext::Current()
+                          ->GetConfig<Integer>("llvm.raw_data_section_threshold", Integer(0))
+                          .value()
+                          ->value;
+  CHECK_GE(threshold, 0) << "ValueError: llvm.raw_data_section_threshold must be non-negative, "
+                         << "but got " << threshold;
+  return threshold;
+}
+
+/*! \brief Write the data to a new temporary file, and return its path. */
+static std::string WriteRawDataFile(const char* data, size_t nbytes) {
+  int fd = -1;
+  llvm::SmallString<128> path;
+  std::error_code ec = llvm::sys::fs::createTemporaryFile("tvm_raw_data", "bin", fd, path);
+  CHECK(!ec) << "Cannot create a temporary file for a raw data section: " << ec.message();
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+  os.write(data, nbytes);
+  os.close();
+  CHECK(!os.has_error()) << "Cannot write the raw data section to " << path.str().str();
+  return path.str().str();
+}
+
+/*! \brief Quote a string for the assembler. */
+static std::string QuoteAsmString(const std::string& str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+llvm::GlobalVariable* EmitRawDataSection(llvm::Module* module, const std::string& name,
+                                         const char* data, size_t nbytes, bool exported) {
+  llvm::Triple triple(module->getTargetTriple());
+  if (!triple.isOSBinFormatELF() && !triple.isOSBinFormatMachO()) {
+    return nullptr;
+  }
+  llvm::LLVMContext& ctx = module->getContext();
+  auto* type = llvm::ArrayType::get(llvm::Type::getInt8Ty(ctx), nbytes);
+  auto* decl = new llvm::GlobalVariable(*module, type, true, llvm::GlobalValue::ExternalLinkage,
+                                        nullptr, name);
+#if TVM_LLVM_VERSION >= 100
+  decl->setAlignment(llvm::Align(1ULL << kRawDataAlignmentLog2));
+#else
+  decl->setAlignment(1U << kRawDataAlignmentLog2);
+#endif
+  if (!exported) {
+    decl->setDSOLocal(true);
+  }
+  // The name of the declaration is made unique within the module by LLVM
+  llvm::SmallString<128> mangled;
+  llvm::Mangler().getNameWithPrefix(mangled, decl, false);
+  std::string symbol = QuoteAsmString(mangled.str().str());
+  std::string path = WriteRawDataFile(data, nbytes);
+
+  std::ostringstream os;
+  if (triple.isOSBinFormatMachO()) {
+    os << ".section __TEXT,__const\n";
+  } else if (triple.getArch() == llvm::Triple::x86_64 && nbytes > (1ULL << 30)) {
+    // Keep large data out of the reach of 32-bit relocations, as CodeGenBlob does
+    os << ".section .lrodata,\"a\"\n";
+  } else {
+    os << ".section .rodata,\"a\"\n";
+  }
+  os << ".p2align " << kRawDataAlignmentLog2 << "\n";
+  if (exported) {
+    os << ".globl " << symbol << "\n";
+  }
+  if (triple.isOSBinFormatELF()) {
+    os << ".type " << symbol << ",\"object\"\n";
+    os << ".size " << symbol << ", " << nbytes << "\n";
+  }
+  os << symbol << ":\n";
+  os << ".incbin " << QuoteAsmString(path) << "\n";
+  os << ".text\n";
+  module->appendModuleInlineAsm(os.str());
+
+  llvm::NamedMDNode* files = module->getOrInsertNamedMetadata(kRawDataFiles);
+  files->addOperand(llvm::MDNode::get(ctx, {llvm::MDString::get(ctx, path)}));
+  return decl;
+}
+
+llvm::GlobalVariable* NDArrayToRawDataSection(llvm::Module* module, const std::string& name,
+                                              tvm::runtime::NDArray arr, int64_t threshold) {
+  size_t nbytes = runtime::GetDataSize(*arr.operator->());
+  if (threshold <= 0 || nbytes < static_cast<size_t>(threshold)) {
+    return nullptr;
+  }
+  CHECK(arr.IsContiguous()) << "CodegenParams: only support contiguous arrays";
+  CHECK_EQ(arr->device.device_type, kDLCPU) << "CodegenParams: only support arrays on CPU";
+  // The bytes are copied as they are, which is only valid in the byte order of the host
+  if (module->getDataLayout().isLittleEndian() != llvm::sys::IsLittleEndianHost) {
+    return nullptr;
+  }
+  const char* data = static_cast<const char*>(arr->data) + arr->byte_offset;
+  return EmitRawDataSection(module, name, data, nbytes, /*exported=*/false);
+}
+
+std::vector<std::string> GetRawDataFiles(const llvm::Module& module) {
+  std::vector<std::string> paths;
+  if (llvm::NamedMDNode* files = module.getNamedMetadata(kRawDataFiles)) {
+    for (llvm::MDNode* file : files->operands()) {
+      paths.push_back(llvm::cast<llvm::MDString>(file->getOperand(0))->getString().str());
+    }
+  }
+  return paths;
+}
+
+void RestoreRawDataFiles(llvm::Module* module, const std::vector<std::string>& contents) {
+  std::vector<std::string> paths = GetRawDataFiles(*module);
+  CHECK_EQ(paths.size(), contents.size())
+      << "ValueError: The module includes " << paths.size() << " raw data files, but got "
+      << contents.size();
+  if (paths.empty()) {
+    return;
+  }
+  llvm::LLVMContext& ctx = module->getContext();
+  std::string inline_asm = module->getModuleInlineAsm();
+  llvm::NamedMDNode* files = module->getNamedMetadata(kRawDataFiles);
+  files->clearOperands();
+  for (size_t i = 0; i < paths.size(); ++i) {
+    std::string path = WriteRawDataFile(contents[i].data(), contents[i].size());
+    std::string from = ".incbin " + QuoteAsmString(paths[i]);
+    size_t pos = inline_asm.find(from);
+    CHECK_NE(pos, std::string::npos) << "The module does not include " << paths[i];
+    inline_asm.replace(pos, from.size(), ".incbin " + QuoteAsmString(path));
+    files->addOperand(llvm::MDNode::get(ctx, {llvm::MDString::get(ctx, path)}));
+  }
+  module->setModuleInlineAsm(inline_asm);
+}
+
 }  // namespace codegen
 }  // namespace tvm
 
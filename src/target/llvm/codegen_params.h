@@ -26,9 +26,16 @@
 
 #include <tvm/runtime/ndarray.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace llvm {
 class ConstantArray;
+class GlobalVariable;
 class LLVMContext;
+class Module;
 }  // namespace llvm
 
 namespace tvm {
@@ -45,6 +52,67 @@ namespace codegen {
  */
 llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, tvm::runtime::NDArray arr);
 
+/*!
+ * \brief Get the size from which the constants are emitted as raw data sections.
+ *
+ * \return The "llvm.raw_data_section_threshold" option of the current PassContext in bytes, 0 if
+ *  the constants are always emitted as LLVM constants.
+ */
+int64_t GetRawDataSectionThreshold();
+
+/*!
+ * \brief Emit raw bytes to a section of the object file, bypassing the LLVM constants.
+ *
+ * The bytes are written to a temporary file, included by the module-level assembly through
+ * ".incbin" when the object file is emitted, so only the declaration of the data goes through
+ * LLVM. The data starts at a page boundary, to be mapped from the library file in place. The
+ * temporary file is recorded in the module, see GetRawDataFiles.
+ *
+ * \param module The module to emit the data in.
+ * \param name The symbol of the data.
+ * \param data The bytes of the data.
+ * \param nbytes The number of bytes.
+ * \param exported Whether the symbol is visible outside of the object file.
+ * \return The declaration of the data as an array of i8, nullptr if the object file format of the
+ *  module is neither ELF nor Mach-O.
+ */
+llvm::GlobalVariable* EmitRawDataSection(llvm::Module* module, const std::string& name,
+                                         const char* data, size_t nbytes, bool exported);
+
+/*!
+ * \brief Emit an NDArray as a raw data section internal to the object file, if it is large enough.
+ *
+ * \param module The module to emit the data in.
+ * \param name The symbol of the data.
+ * \param arr NDArray to emit.
+ * \param threshold The size threshold in bytes, 0 to never emit a raw data section.
+ * \return The declaration of the data, nullptr if the array is smaller than the threshold, or is
+ *  not stored in the byte order of the target, or the object file format is not supported.
+ */
+llvm::GlobalVariable* NDArrayToRawDataSection(llvm::Module* module, const std::string& name,
+                                              tvm::runtime::NDArray arr, int64_t threshold);
+
+/*!
+ * \brief Get the temporary files included by the raw data sections of a module.
+ *
+ * The files must outlive the emission of the object file, and are removed by the owner of the
+ * module once it is no longer used.
+ *
+ * \param module The module, possibly linked from several modules with raw data sections.
+ * \return The paths of the files.
+ */
+std::vector<std::string> GetRawDataFiles(const llvm::Module& module);
+
+/*!
+ * \brief Write the contents of the raw data sections of a module to new temporary files.
+ *
+ * This restores a module loaded from bitcode, whose original temporary files may be gone.
+ *
+ * \param module The module.
+ * \param contents The contents of the files, in the order of GetRawDataFiles.
+ */
+void RestoreRawDataFiles(llvm::Module* module, const std::vector<std::string>& contents);
+
 }  // namespace codegen
 }  // namespace tvm
 
@@ -43,6 +43,7 @@
 #include <llvm/IR/Metadata.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/Support/FileSystem.h>
 #if TVM_LLVM_VERSION >= 180
 #include <llvm/TargetParser/Host.h>
@@ -55,6 +56,7 @@
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/relay/runtime.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/string.h>
@@ -64,16 +66,20 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/support/with.h>
 #include <tvm/target/codegen.h>
 #include <tvm/target/target.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <system_error>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -83,6 +89,7 @@
 #include "codegen_blob.h"
 #include "codegen_cpu.h"
 #include "codegen_llvm.h"
+#include "codegen_params.h"
 #include "llvm_instance.h"
 
 namespace tvm {
@@ -113,10 +120,12 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   void Init(const IRModule& mod, const Target& target);
   void Init(std::unique_ptr<llvm::Module> module, std::unique_ptr<LLVMInstance> llvm_instance);
   void LoadIR(const std::string& file_name);
+  static runtime::Module LoadFromBinary(void* strm);
 
   bool ImplementsFunction(const String& name, bool query_imports) final;
 
   void SetJITEngine(const std::string& jit_engine) { jit_engine_ = jit_engine; }
+  bool IsORCJIT() const { return jit_engine_ == "orcjit" || jit_engine_ == "orcjit-lazy"; }
 
  private:
   void InitMCJIT();
@@ -140,6 +149,8 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   /* \brief names of the external functions declared in this module */
   Array<String> function_names_;
   std::string jit_engine_;
+  /* \brief the temporary files included by the raw data sections of the module */
+  std::vector<std::string> raw_data_files_;
 };
 
 LLVMModuleNode::~LLVMModuleNode() {
@@ -156,6 +167,9 @@ LLVMModuleNode::~LLVMModuleNode() {
     orcjit_ee_.reset();
   }
   module_owning_ptr_.reset();
+  for (const std::string& path : raw_data_files_) {
+    llvm::sys::fs::remove(path);
+  }
 }
 
 PackedFunc LLVMModuleNode::GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) {
@@ -184,7 +198,7 @@ PackedFunc LLVMModuleNode::GetFunction(const String& name, const ObjectPtr<Objec
   }
   ICHECK(jit_engine_.size()) << "JIT engine type is missing";
   if ((jit_engine_ == "mcjit") && (mcjit_ee_ == nullptr)) InitMCJIT();
-  if ((jit_engine_ == "orcjit") && (orcjit_ee_ == nullptr)) InitORCJIT();
+  if (IsORCJIT() && (orcjit_ee_ == nullptr)) InitORCJIT();
 
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -275,7 +289,47 @@ void LLVMModuleNode::SaveToFile(const String& file_name_str, const String& forma
 }
 
 void LLVMModuleNode::SaveToBinary(dmlc::Stream* stream) {
-  LOG(FATAL) << "LLVMModule: SaveToBinary not supported";
+  // The module is not advertised as binary serializable, as it is exported as object code into
+  // the shared library. The bitcode is only stored by the build cache.
+  ICHECK(module_ != nullptr) << "LLVMModule: SaveToBinary of an undefined module";
+  std::string bitcode;
+  llvm::raw_string_ostream os(bitcode);
+#if TVM_LLVM_VERSION <= 60
+  llvm::WriteBitcodeToFile(module_, os);
+#else
+  llvm::WriteBitcodeToFile(*module_, os);
+#endif
+  os.flush();
+  std::vector<std::string> function_names(function_names_.begin(), function_names_.end());
+  // The bitcode only refers to the files of the raw data sections, which are saved along with it
+  std::vector<std::string> raw_data(raw_data_files_.size());
+  for (size_t i = 0; i < raw_data_files_.size(); ++i) {
+    runtime::LoadBinaryFromFile(raw_data_files_[i], &raw_data[i]);
+  }
+  stream->Write(bitcode);
+  stream->Write(function_names);
+  stream->Write(jit_engine_);
+  stream->Write(raw_data);
+}
+
+runtime::Module LLVMModuleNode::LoadFromBinary(void* strm) {
+  dmlc::Stream* stream = static_cast<dmlc::Stream*>(strm);
+  std::string bitcode, jit_engine;
+  std::vector<std::string> function_names, raw_data;
+  ICHECK(stream->Read(&bitcode)) << "Loading bitcode failed";
+  ICHECK(stream->Read(&function_names)) << "Loading function names failed";
+  ICHECK(stream->Read(&jit_engine)) << "Loading JIT engine failed";
+  ICHECK(stream->Read(&raw_data)) << "Loading raw data sections failed";
+  auto llvm_instance = std::make_unique<LLVMInstance>();
+  std::unique_ptr<llvm::Module> module = llvm_instance->ParseIR(bitcode);
+  RestoreRawDataFiles(module.get(), raw_data);
+  auto n = make_object<LLVMModuleNode>();
+  n->Init(std::move(module), std::move(llvm_instance));
+  for (const std::string& name : function_names) {
+    n->function_names_.push_back(name);
+  }
+  n->SetJITEngine(jit_engine);
+  return runtime::Module(n);
 }
 
 String LLVMModuleNode::GetSource(const String& format) {
@@ -320,6 +374,96 @@ String LLVMModuleNode::GetSource(const String& format) {
   return "";
 }
 
+TVM_REGISTER_PASS_CONFIG_OPTION("llvm.num_codegen_threads", Integer);
+
+/*!
+ * \brief Split the functions of a module into partitions that can be compiled independently.
+ *
+ * The functions calling each other stay in the same partition, and the partitions are balanced
+ * by the sizes of their functions. The partition holding the entry function comes first.
+ *
+ * \param mod The module to be compiled.
+ * \param max_partitions The maximum number of partitions.
+ * \param entry_func The global symbol of the entry function, or an empty string.
+ * \return The non-empty partitions.
+ */
+static std::vector<std::vector<std::pair<GlobalVar, BaseFunc>>> PartitionCodegenFunctions(
+    const IRModule& mod, int max_partitions, const std::string& entry_func) {
+  std::vector<std::pair<GlobalVar, BaseFunc>> funcs(mod->functions.begin(), mod->functions.end());
+  int n = funcs.size();
+  std::unordered_map<const GlobalVarNode*, int> func_index;
+  for (int i = 0; i < n; ++i) {
+    func_index[funcs[i].first.get()] = i;
+  }
+  // Step 1. Group the functions calling each other with a union-find
+  std::vector<int> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto f_find = [&parent](int i) {
+    while (parent[i] != i) {
+      i = parent[i] = parent[parent[i]];
+    }
+    return i;
+  };
+  std::vector<int64_t> weight(n, 1);
+  for (int i = 0; i < n; ++i) {
+    const auto* prim_func = funcs[i].second.as<PrimFuncNode>();
+    if (prim_func == nullptr) {
+      continue;
+    }
+    tir::PostOrderVisit(prim_func->body, [&](const ObjectRef& node) {
+      ++weight[i];
+      if (const auto* call = node.as<tir::CallNode>()) {
+        if (const auto* callee = call->op.as<GlobalVarNode>()) {
+          auto it = func_index.find(callee);
+          if (it != func_index.end()) {
+            parent[f_find(i)] = f_find(it->second);
+          }
+        }
+      }
+    });
+  }
+  std::unordered_map<int, int> group_index;
+  std::vector<std::vector<int>> groups;
+  std::vector<int64_t> group_weight;
+  for (int i = 0; i < n; ++i) {
+    auto [it, inserted] = group_index.emplace(f_find(i), groups.size());
+    if (inserted) {
+      groups.emplace_back();
+      group_weight.push_back(0);
+    }
+    groups[it->second].push_back(i);
+    group_weight[it->second] += weight[i];
+  }
+  // Step 2. Assign the heaviest groups first, each to the lightest partition so far
+  std::vector<int> order(groups.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&group_weight](int a, int b) { return group_weight[a] > group_weight[b]; });
+  int num_partitions = std::min<int>(max_partitions, groups.size());
+  std::vector<std::vector<std::pair<GlobalVar, BaseFunc>>> partitions(num_partitions);
+  std::vector<int64_t> partition_weight(num_partitions, 0);
+  for (int group : order) {
+    int p = std::min_element(partition_weight.begin(), partition_weight.end()) -
+            partition_weight.begin();
+    partition_weight[p] += group_weight[group];
+    for (int i : groups[group]) {
+      partitions[p].push_back(funcs[i]);
+    }
+  }
+  // Step 3. Move the entry function to the first partition, which defines the main function
+  for (int p = 1; p < num_partitions && !entry_func.empty(); ++p) {
+    bool has_entry = std::any_of(partitions[p].begin(), partitions[p].end(), [&](const auto& kv) {
+      auto global_symbol = kv.second->template GetAttr<String>(tvm::attr::kGlobalSymbol);
+      return global_symbol && global_symbol.value() == entry_func;
+    });
+    if (has_entry) {
+      std::swap(partitions[0], partitions[p]);
+      break;
+    }
+  }
+  return partitions;
+}
+
 void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
   llvm_instance_ = std::make_unique<LLVMInstance>();
   With<LLVMTarget> llvm_target(*llvm_instance_, target);
@@ -360,17 +504,76 @@ void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
   // ICHECK(funcs.size() > 0);
   // TODO(tqchen): remove the entry function behavior as it does not
   // makes sense when we start to use multiple modules.
-  cg->Init("TVMMod", llvm_target.get(), system_lib_prefix, system_lib_prefix.defined(),
-           target_c_runtime);
-  cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
-
-  cg->AddFunctionsOrdered(mod->functions.begin(), mod->functions.end());
-  if (entry_func.length() != 0) {
-    cg->AddMainFunction(entry_func);
+  //
+  // Independent functions may be compiled on several threads, each partition in an LLVM context of
+  // its own, and linked back into one module. The system library and the C runtime register their
+  // symbols from a single startup function, and the command line options of LLVM are global
+  // state, so these are always compiled as a whole.
+  int num_threads = tvm::transform::PassContext::Current()
+                        ->GetConfig<Integer>("llvm.num_codegen_threads", Integer(1))
+                        .value()
+                        ->value;
+  // The PassContext is thread local, so the options are read before the codegen threads start
+  int64_t raw_data_section_threshold = GetRawDataSectionThreshold();
+  std::vector<std::vector<std::pair<GlobalVar, BaseFunc>>> partitions;
+  if (num_threads > 1 && !system_lib_prefix.defined() && !target_c_runtime &&
+      llvm_target->GetCommandLineOptions().empty()) {
+    partitions = PartitionCodegenFunctions(mod, num_threads, entry_func);
   }
+  if (partitions.size() <= 1) {
+    cg->Init("TVMMod", llvm_target.get(), system_lib_prefix, system_lib_prefix.defined(),
+             target_c_runtime);
+    cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
+    cg->SetRawDataSectionThreshold(raw_data_section_threshold);
+
+    cg->AddFunctionsOrdered(mod->functions.begin(), mod->functions.end());
+    if (entry_func.length() != 0) {
+      cg->AddMainFunction(entry_func);
+    }
 
-  module_owning_ptr_ = cg->Finish();
+    module_owning_ptr_ = cg->Finish();
+  } else {
+    int num_partitions = partitions.size();
+    std::vector<std::unique_ptr<LLVMInstance>> part_instances;
+    std::vector<std::unique_ptr<LLVMTarget>> part_targets;
+    for (int i = 1; i < num_partitions; ++i) {
+      part_instances.push_back(std::make_unique<LLVMInstance>());
+      part_targets.push_back(std::make_unique<LLVMTarget>(*part_instances.back(), *llvm_target));
+    }
+    // The other partitions travel to the main context as bitcode
+    std::vector<std::string> part_bitcodes(num_partitions);
+    support::parallel_for_dynamic(0, num_partitions, num_threads, [&](int, int i) -> void {
+      LLVMTarget* part_target = i == 0 ? llvm_target.get() : part_targets[i - 1].get();
+      std::unique_ptr<CodeGenLLVM> part_cg =
+          i == 0 ? std::move(cg) : CodeGenLLVM::Create(part_target);
+      part_cg->Init("TVMMod", part_target, system_lib_prefix, false, target_c_runtime);
+      part_cg->SetFastMathFlags(part_target->GetFastMathFlags());
+      part_cg->SetRawDataSectionThreshold(raw_data_section_threshold);
+      part_cg->AddFunctionsOrdered(partitions[i].begin(), partitions[i].end());
+      if (i == 0 && entry_func.length() != 0) {
+        part_cg->AddMainFunction(entry_func);
+      }
+      std::unique_ptr<llvm::Module> part_module = part_cg->Finish();
+      if (i == 0) {
+        module_owning_ptr_ = std::move(part_module);
+        return;
+      }
+      llvm::raw_string_ostream os(part_bitcodes[i]);
+#if TVM_LLVM_VERSION <= 60
+      llvm::WriteBitcodeToFile(part_module.get(), os);
+#else
+      llvm::WriteBitcodeToFile(*part_module, os);
+#endif
+      os.flush();
+    });
+    for (int i = 1; i < num_partitions; ++i) {
+      ICHECK(!llvm::Linker::linkModules(*module_owning_ptr_,
+                                        llvm_instance_->ParseIR(part_bitcodes[i])))
+          << "Failed to link the separately compiled functions";
+    }
+  }
   module_ = module_owning_ptr_.get();
+  raw_data_files_ = GetRawDataFiles(*module_);
   jit_engine_ = llvm_target->GetJITEngine();
   llvm_target->SetTargetMetadata(module_);
   module_->addModuleFlag(llvm::Module::Override, "Debug Info Version",
@@ -390,6 +593,7 @@ void LLVMModuleNode::Init(std::unique_ptr<llvm::Module> module,
                           std::unique_ptr<LLVMInstance> llvm_instance) {
   module_owning_ptr_ = std::move(module);
   module_ = module_owning_ptr_.get();
+  raw_data_files_ = GetRawDataFiles(*module_);
   llvm_instance_ = std::move(llvm_instance);
 }
 
@@ -497,8 +701,14 @@ void LLVMModuleNode::InitORCJIT() {
       << " and ExecutionEngine (" << layout.getStringRepresentation() << ")";
 
   // compiler
+  // The lazy functions are compiled by the threads calling them for the first time,
+  // which cannot share a target machine.
+  bool lazy = jit_engine_ == "orcjit-lazy";
   const auto compilerBuilder = [&](const llvm::orc::JITTargetMachineBuilder&)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+    if (lazy) {
+      return std::make_unique<llvm::orc::ConcurrentIRCompiler>(tm_builder);
+    }
     return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(tm));
   };
 
@@ -509,16 +719,23 @@ void LLVMModuleNode::InitORCJIT() {
   };
 #endif
 
-  // create LLJIT
-  orcjit_ee_ = llvm::cantFail(llvm::orc::LLJITBuilder()
+  // create LLJIT, or LLLazyJIT which compiles each function on its first call
+  const auto f_create = [&](auto&& builder) -> std::unique_ptr<llvm::orc::LLJIT> {
+    return llvm::cantFail(builder
 #if TVM_LLVM_VERSION >= 110
-                                  .setDataLayout(layout)
+                              .setDataLayout(layout)
 #endif
-                                  .setCompileFunctionCreator(compilerBuilder)
+                              .setCompileFunctionCreator(compilerBuilder)
 #if TVM_LLVM_VERSION >= 130
-                                  .setObjectLinkingLayerCreator(linkerBuilder)
+                              .setObjectLinkingLayerCreator(linkerBuilder)
 #endif
-                                  .create());
+                              .create());
+  };
+  if (lazy) {
+    orcjit_ee_ = f_create(llvm::orc::LLLazyJITBuilder());
+  } else {
+    orcjit_ee_ = f_create(llvm::orc::LLJITBuilder());
+  }
 
   ICHECK(orcjit_ee_ != nullptr) << "Failed to initialize LLVM ORCJIT engine for "
                                 << module_->getTargetTriple();
@@ -540,7 +757,9 @@ void LLVMModuleNode::InitORCJIT() {
 
   // add the llvm module to run
   llvm::orc::ThreadSafeModule tsm(std::move(umod), std::move(uctx));
-  auto err = orcjit_ee_->addIRModule(std::move(tsm));
+  auto err = lazy ? static_cast<llvm::orc::LLLazyJIT*>(orcjit_ee_.get())
+                        ->addLazyIRModule(std::move(tsm))
+                  : orcjit_ee_->addIRModule(std::move(tsm));
   ICHECK(!err) << llvm::toString(std::move(err));
 
   VLOG(2) << "LLVM ORCJIT execute " << module_->getModuleIdentifier() << " for triple `"
@@ -576,7 +795,7 @@ void* LLVMModuleNode::GetGlobalAddr(const std::string& name, const LLVMTarget& l
   if (module_->getGlobalVariable(name) != nullptr) {
     if (jit_engine_ == "mcjit") {
       return reinterpret_cast<void*>(mcjit_ee_->getGlobalValueAddress(name));
-    } else if (jit_engine_ == "orcjit") {
+    } else if (IsORCJIT()) {
 #if TVM_LLVM_VERSION >= 150
       auto addr = llvm::cantFail(orcjit_ee_->lookup(name)).getValue();
 #else
@@ -596,7 +815,7 @@ void* LLVMModuleNode::GetFunctionAddr(const std::string& name,
   if (module_->getFunction(name) != nullptr) {
     if (jit_engine_ == "mcjit") {
       return reinterpret_cast<void*>(mcjit_ee_->getFunctionAddress(name));
-    } else if (jit_engine_ == "orcjit") {
+    } else if (IsORCJIT()) {
 #if TVM_LLVM_VERSION >= 150
       auto addr = llvm::cantFail(orcjit_ee_->lookup(name)).getValue();
 #else
@@ -752,6 +971,9 @@ TVM_REGISTER_GLOBAL("runtime.module.loadfile_ll")
       return runtime::Module(n);
     });
 
+TVM_REGISTER_GLOBAL("runtime.module.loadbinary_llvm")
+    .set_body_typed(LLVMModuleNode::LoadFromBinary);
+
 TVM_REGISTER_GLOBAL("codegen.llvm_target_enabled")
     .set_body_typed([](std::string target_str) -> bool {
       LLVMInstance llvm_instance;
@@ -27,9 +27,20 @@
 #include <sys/stat.h>
 #endif
 #include <cuda_runtime.h>
+#include <dmlc/memory_io.h>
 #include <nvrtc.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "../../runtime/cuda/cuda_common.h"
 #include "../../runtime/cuda/cuda_module.h"
@@ -78,23 +89,34 @@ std::string FindCUDAIncludePath() {
   return cuda_include_path;
 }
 
-std::string NVRTCCompile(const std::string& code, bool include_path = false) {
+std::string NVRTCCompile(const std::string& code, bool include_path, const std::string& arch,
+                         std::string* fmt) {
   std::vector<std::string> compile_params;
   std::vector<const char*> param_cstrings{};
   nvrtcProgram prog;
-  std::string cc = "30";
-  int major, minor;
-  cudaError_t e1 = cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
-  cudaError_t e2 = cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, 0);
+  std::string cc = arch.size() > 3 && arch.compare(0, 3, "sm_") == 0 ? arch.substr(3) : "";
+  if (cc.empty()) {
+    cc = "30";
+    int major, minor;
+    cudaError_t e1 = cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
+    cudaError_t e2 = cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, 0);
 
-  if (e1 == cudaSuccess && e2 == cudaSuccess) {
-    cc = std::to_string(major) + std::to_string(minor);
-  } else {
-    LOG(WARNING) << "cannot detect compute capability from your device, "
-                 << "fall back to compute_30.";
+    if (e1 == cudaSuccess && e2 == cudaSuccess) {
+      cc = std::to_string(major) + std::to_string(minor);
+    } else {
+      LOG(WARNING) << "cannot detect compute capability from your device, "
+                   << "fall back to compute_30.";
+    }
   }
 
+#if CUDART_VERSION >= 11010
+  // Emit the machine code directly, so that loading the module does not JIT compile the PTX
+  compile_params.push_back("-arch=sm_" + cc);
+  *fmt = "cubin";
+#else
   compile_params.push_back("-arch=compute_" + cc);
+  *fmt = "ptx";
+#endif
 
   if (include_path) {
     std::string include_option = "--include-path=" + FindCUDAIncludePath();
@@ -114,22 +136,93 @@ std::string NVRTCCompile(const std::string& code, bool include_path = false) {
   log.resize(log_size);
   NVRTC_CALL(nvrtcGetProgramLog(prog, &log[0]));
   ICHECK_EQ(compile_res, NVRTC_SUCCESS) << log;
+
+  std::string data;
+#if CUDART_VERSION >= 11010
+  size_t cubin_size;
+  NVRTC_CALL(nvrtcGetCUBINSize(prog, &cubin_size));
+  data.resize(cubin_size);
+  NVRTC_CALL(nvrtcGetCUBIN(prog, &data[0]));
+#else
   size_t ptx_size;
   NVRTC_CALL(nvrtcGetPTXSize(prog, &ptx_size));
-
-  std::string ptx;
-  ptx.resize(ptx_size);
-  NVRTC_CALL(nvrtcGetPTX(prog, &ptx[0]));
+  data.resize(ptx_size);
+  NVRTC_CALL(nvrtcGetPTX(prog, &data[0]));
+#endif
   NVRTC_CALL(nvrtcDestroyProgram(&prog));
 
-  return ptx;
+  return data;
+}
+
+/*!
+ * \brief Compile with NVRTC through the persistent kernel cache.
+ *
+ * A cache file holds the source it was compiled from, which is compared on load, so that a hash
+ * collision is only a miss. The files are written to a temporary name and renamed, so that
+ * concurrent builds sharing the directory never observe a partial file.
+ *
+ * \param code The CUDA source.
+ * \param include_path Whether the CUDA headers are needed.
+ * \param arch The target architecture, e.g. "sm_80".
+ * \param cache_dir The cache directory, or empty to disable the cache.
+ * \param fmt The format of the compiled code to be written.
+ * \return The compiled code.
+ */
+std::string NVRTCCompileCached(const std::string& code, bool include_path, const std::string& arch,
+                               const std::string& cache_dir, std::string* fmt) {
+  if (cache_dir.empty()) {
+    return NVRTCCompile(code, include_path, arch, fmt);
+  }
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVRTC_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+  std::ostringstream key;
+  key << "nvrtc-" << nvrtc_major << "." << nvrtc_minor << "-cudart-" << CUDART_VERSION << "-"
+      << arch << "-" << include_path;
+  std::ostringstream path;
+  path << cache_dir << "/" << std::hex << std::hash<std::string>()(key.str() + "\n" + code)
+       << ".tvmkernel";
+
+  std::ifstream fin(path.str(), std::ios::in | std::ios::binary);
+  if (fin) {
+    std::string blob((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    dmlc::MemoryStringStream reader(&blob);
+    dmlc::Stream* stream = &reader;
+    std::string cached_key, cached_code, cached_fmt, data;
+    if (stream->Read(&cached_key) && cached_key == key.str() && stream->Read(&cached_code) &&
+        cached_code == code && stream->Read(&cached_fmt) && stream->Read(&data)) {
+      *fmt = cached_fmt;
+      return data;
+    }
+  }
+
+  std::string data = NVRTCCompile(code, include_path, arch, fmt);
+  std::string blob;
+  dmlc::MemoryStringStream writer(&blob);
+  dmlc::Stream* stream = &writer;
+  stream->Write(key.str());
+  stream->Write(code);
+  stream->Write(*fmt);
+  stream->Write(data);
+  // A failure to write the cache never fails the build
+  std::string tmp_path = path.str() + ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream fout(tmp_path, std::ios::out | std::ios::binary);
+    fout.write(blob.data(), blob.size());
+    if (!fout) {
+      LOG(WARNING) << "Cannot write the CUDA kernel cache file " << tmp_path;
+      std::remove(tmp_path.c_str());
+      return data;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.str().c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+  return data;
 }
 
 runtime::Module BuildCUDA(IRModule mod, Target target) {
   using tvm::runtime::Registry;
   bool output_ssa = false;
-  CodeGenCUDA cg;
-  cg.Init(output_ssa);
 
   Map<GlobalVar, PrimFunc> functions;
   for (auto [gvar, base_func] : mod->functions) {
@@ -141,36 +234,89 @@ runtime::Module BuildCUDA(IRModule mod, Target target) {
     functions.Set(gvar, prim_func);
   }
 
-  for (auto [gvar, prim_func] : functions) {
-    cg.DeclareFunction(gvar, prim_func);
-  }
-  for (auto [gvar, prim_func] : functions) {
-    cg.AddFunction(gvar, prim_func);
+  tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+  const auto* f_compile = Registry::Get("tvm_callback_cuda_compile");
+  bool use_nvrtc =
+      f_compile == nullptr || pass_ctx->GetConfig<Bool>("cuda.use_nvrtc", Bool(false)).value();
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("cuda.num_compile_threads", Integer(1)).value()->value;
+  std::string cache_dir = pass_ctx->GetConfig<String>("cuda.kernel_cache_dir", String("")).value();
+  if (cache_dir.empty()) {
+    if (const char* env_cache_dir = std::getenv("TVM_CUDA_KERNEL_CACHE_DIR")) {
+      cache_dir = env_cache_dir;
+    }
   }
+  std::string arch = target->GetAttr<String>("arch").value_or("");
 
-  std::string code = cg.Finish();
-
-  if (const auto* f = Registry::Get("tvm_callback_cuda_postproc")) {
-    code = (*f)(code, target).operator std::string();
+  // Step 1. Generate the source, one compilation unit per kernel when NVRTC compiles in parallel.
+  // The kernels never call each other, so each one is compiled and cached independently.
+  std::vector<Map<GlobalVar, PrimFunc>> units;
+  if (use_nvrtc && num_threads > 1 && functions.size() > 1) {
+    std::vector<std::pair<std::string, GlobalVar>> ordered;
+    for (auto [gvar, prim_func] : functions) {
+      ordered.emplace_back(gvar->name_hint, gvar);
+    }
+    std::sort(ordered.begin(), ordered.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& kv : ordered) {
+      units.push_back({{kv.second, functions[kv.second]}});
+    }
+  } else {
+    units.push_back(functions);
+  }
+  int num_units = units.size();
+  std::vector<std::string> codes(num_units);
+  std::vector<bool> need_include_path(num_units);
+  for (int i = 0; i < num_units; ++i) {
+    CodeGenCUDA cg;
+    cg.Init(output_ssa);
+    for (auto [gvar, prim_func] : units[i]) {
+      cg.DeclareFunction(gvar, prim_func);
+    }
+    for (auto [gvar, prim_func] : units[i]) {
+      cg.AddFunction(gvar, prim_func);
+    }
+    codes[i] = cg.Finish();
+    need_include_path[i] = cg.need_include_path();
+    if (const auto* f = Registry::Get("tvm_callback_cuda_postproc")) {
+      codes[i] = (*f)(codes[i], target).operator std::string();
+    }
   }
-  std::string fmt = "ptx";
-  std::string ptx;
-  const auto* f_enter = Registry::Get("target.TargetEnterScope");
-  (*f_enter)(target);
-  if (const auto* f = Registry::Get("tvm_callback_cuda_compile")) {
-    ptx = (*f)(code, target).operator std::string();
+
+  // Step 2. Compile the units
+  std::vector<std::string> data(num_units);
+  std::vector<std::string> fmts(num_units, "ptx");
+  if (use_nvrtc) {
+    support::parallel_for_dynamic(0, num_units, std::max(num_threads, 1), [&](int, int i) -> void {
+      data[i] = NVRTCCompileCached(codes[i], need_include_path[i], arch, cache_dir, &fmts[i]);
+    });
+  } else {
+    const auto* f_enter = Registry::Get("target.TargetEnterScope");
+    (*f_enter)(target);
+    data[0] = (*f_compile)(codes[0], target).operator std::string();
     // Dirty matching to check PTX vs cubin.
     // TODO(tqchen) more reliable checks
-    if (ptx[0] != '/') fmt = "cubin";
-  } else {
-    ptx = NVRTCCompile(code, cg.need_include_path());
+    if (data[0][0] != '/') fmts[0] = "cubin";
+    const auto* f_exit = Registry::Get("target.TargetExitScope");
+    (*f_exit)(target);
+  }
+
+  // Step 3. The module of the first unit imports the others
+  auto f_unit_module = [&](int i) {
+    IRModule unit_mod(Map<GlobalVar, BaseFunc>(units[i].begin(), units[i].end()));
+    return CUDAModuleCreate(data[i], fmts[i], ExtractFuncInfo(unit_mod), codes[i]);
+  };
+  runtime::Module result = f_unit_module(0);
+  for (int i = 1; i < num_units; ++i) {
+    result.Import(f_unit_module(i));
   }
-  const auto* f_exit = Registry::Get("target.TargetExitScope");
-  (*f_exit)(target);
-  return CUDAModuleCreate(ptx, fmt, ExtractFuncInfo(mod), code);
+  return result;
 }
 
 TVM_REGISTER_GLOBAL("target.build.cuda").set_body_typed(BuildCUDA);
 TVM_REGISTER_PASS_CONFIG_OPTION("cuda.kernels_output_dir", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("cuda.use_nvrtc", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("cuda.num_compile_threads", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("cuda.kernel_cache_dir", String);
 }  // namespace codegen
 }  // namespace tvm
@@ -112,6 +112,7 @@ static TargetFeatures GetFeatures(TargetJSON target) {
           {"has_dotprod", Bool(has_feature("dotprod"))},
           {"has_matmul_i8", Bool(has_feature("i8mm"))},
           {"has_fp16_simd", Bool(has_feature("fullfp16"))},
+          {"has_bf16", Bool(has_feature("bf16"))},
           {"has_sme", Bool(has_feature("sme"))}};
 #endif
 
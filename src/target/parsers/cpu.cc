@@ -18,8 +18,10 @@
  */
 #include "cpu.h"
 
+#include <algorithm>
 #include <string>
 
+#include "../../support/utils.h"
 #include "aprofile.h"
 #include "mprofile.h"
 
@@ -38,6 +40,24 @@ Optional<String> DetectSystemTriple() {
   return {};
 }
 
+/*!
+ * \brief Enable the SIMD128 extension of WebAssembly unless `-mattr` says otherwise.
+ * All the browsers supporting WebGPU also support SIMD128, without which LLVM scalarizes
+ * every vectorized loop of the CPU kernels.
+ */
+TargetJSON ParseWasmTarget(TargetJSON target) {
+  Array<String> mattr =
+      Downcast<Optional<Array<String>>>(target.Get("mattr")).value_or(Array<String>());
+  bool has_simd_attr = std::any_of(mattr.begin(), mattr.end(), [](const String& attr) {
+    return std::string(attr).find("simd128") != std::string::npos;
+  });
+  if (!has_simd_attr) {
+    mattr.push_back("+simd128");
+    target.Set("mattr", mattr);
+  }
+  return target;
+}
+
 TargetJSON ParseTarget(TargetJSON target) {
   String kind = Downcast<String>(target.Get("kind"));
   Optional<String> mtriple = Downcast<Optional<String>>(target.Get("mtriple"));
@@ -57,6 +77,11 @@ TargetJSON ParseTarget(TargetJSON target) {
     return aprofile::ParseTarget(target);
   }
 
+  mtriple = Downcast<Optional<String>>(target.Get("mtriple"));
+  if (kind == "llvm" && mtriple && support::StartsWith(mtriple.value(), "wasm")) {
+    return ParseWasmTarget(target);
+  }
+
   return target;
 }
 
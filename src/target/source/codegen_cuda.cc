@@ -33,6 +33,7 @@
 #include <utility>
 #include <vector>
 
+#include "../../runtime/thread_storage_scope.h"
 #include "../../tir/transforms/ir_utils.h"
 #include "literal/cuda_half_t.h"
 #include "literal/cuda_int8_t.h"
@@ -92,6 +93,16 @@ class ThreadIdxExtractor : public tir::StmtVisitor {
       if (iv->var->name_hint == "threadIdx.z" || iv->thread_tag == "threadIdx.z") {
         threadIdx_z_ext = op->value;
       }
+    } else if (op->attr_key == tir::attr::cluster_extent) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      runtime::ThreadScope scope = runtime::ThreadScope::Create(iv->thread_tag);
+      ICHECK_EQ(scope.rank, 0) << "The cluster extent is expected on blockIdx, but got " << iv;
+      int extent = static_cast<int>(Downcast<IntImm>(op->value)->value);
+      int& dim = cluster_dims[scope.dim_index];
+      CHECK(dim == 1 || dim == extent)
+          << "ValueError: The kernel uses clusters of both " << dim << " and " << extent
+          << " thread blocks along " << iv->thread_tag;
+      dim = extent;
     }
     StmtVisitor::VisitStmt_(op);
   }
@@ -100,6 +111,7 @@ class ThreadIdxExtractor : public tir::StmtVisitor {
   PrimExpr threadIdx_x_ext = Integer(1);
   PrimExpr threadIdx_y_ext = Integer(1);
   PrimExpr threadIdx_z_ext = Integer(1);
+  int cluster_dims[3] = {1, 1, 1};
 };
 
 void CodeGenCUDA::PrintExtraAttrs(const PrimFunc& f, std::ostream& os) {
@@ -115,6 +127,10 @@ void CodeGenCUDA::PrintExtraAttrs(const PrimFunc& f, std::ostream& os) {
     }
     os << " __launch_bounds__(" << threadIdx_ext_int->value << ")";
   }
+  const int* dims = extractor.cluster_dims;
+  if (dims[0] * dims[1] * dims[2] > 1) {
+    os << " __cluster_dims__(" << dims[0] << ", " << dims[1] << ", " << dims[2] << ")";
+  }
 }
 
 std::string CodeGenCUDA::Finish() {
@@ -170,6 +186,18 @@ std::string CodeGenCUDA::Finish() {
     decl_stream << "#include <mma.h>\n";
   }
 
+  if (need_ld_shared_cluster_) {
+    decl_stream << "template <typename T>\n";
+    decl_stream << "__forceinline__ __device__ T\n";
+    decl_stream << "tvm_ld_shared_cluster(T* smem_ptr, unsigned int block_rank)\n";
+    decl_stream << "{\n";
+    decl_stream << "  T* peer_ptr;\n";
+    decl_stream << "  asm volatile (\"mapa.u64 %0, %1, %2;\"\n";
+    decl_stream << "    : \"=l\"(peer_ptr) : \"l\"(smem_ptr), \"r\"(block_rank));\n";
+    decl_stream << "  return *peer_ptr;\n";
+    decl_stream << "}\n";
+  }
+
   if (need_cast_smem_ptr_to_int_) {
     decl_stream << "__forceinline__ __device__ unsigned int\n";
     decl_stream << "cast_smem_ptr_to_int(const void* const smem_ptr)\n";
@@ -608,6 +636,15 @@ void CodeGenCUDA::PrintStorageSync(const CallNode* op) {
   } else if (sync == "shared" || sync == "shared.dyn") {
     this->PrintIndent();
     this->stream << "__syncthreads();\n";
+  } else if (sync == "cluster") {
+    // barrier of all the threads in the thread block cluster, ordering the accesses to the
+    // distributed shared memory
+    this->PrintIndent();
+    this->stream << "__asm__ __volatile__(\"barrier.cluster.arrive.release.aligned;\" ::: "
+                    "\"memory\");\n";
+    this->PrintIndent();
+    this->stream << "__asm__ __volatile__(\"barrier.cluster.wait.acquire.aligned;\" ::: "
+                    "\"memory\");\n";
   } else if (sync == "global") {
     if (!need_global_barrier_) {
       need_global_barrier_ = true;
@@ -1013,9 +1050,7 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
     std::string src = this->PrintExpr(op->args[2]);
     std::string src_offset = this->PrintExpr(op->args[3]);
     std::string size = this->PrintExpr(op->args[4]);
-    int barrier_id = Downcast<IntImm>(op->args[5])->value;
-    CHECK(barrier_id < barrier_count_);
-    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::string barrier = PrintBarrier(op->args[5]);
     this->stream << PrintCpAsyncBulkAsm(dst, dst_offset, src, src_offset, size, barrier);
   } else if (op->op.same_as(builtin::ptx_commit_group())) {
     this->stream << "__asm__ __volatile__(\"cp.async.commit_group;\");\n\n";
@@ -1024,36 +1059,27 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
     this->stream << "__asm__ __volatile__(\"cp.async.wait_group " << n << ";\");\n\n";
   } else if (op->op.same_as(builtin::ptx_cp_async_barrier())) {
     need_cast_smem_ptr_to_int_ = true;
-    int barrier_id = Downcast<IntImm>(op->args[0])->value;
-    CHECK(barrier_id < barrier_count_);
-    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::string barrier = PrintBarrier(op->args[0]);
     this->stream << PrintCpAsyncBarrierAsm(barrier);
   } else if (op->op.same_as(builtin::ptx_init_barrier_thread_count())) {
     need_cast_smem_ptr_to_int_ = true;
-    int barrier_id = Downcast<IntImm>(op->args[0])->value;
-    CHECK(barrier_id < barrier_count_);
-    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::string barrier = PrintBarrier(op->args[0]);
     std::string thread_count = this->PrintExpr(op->args[1]);
     this->stream << PrintInitBarrierThreadCountAsm(barrier, thread_count);
   } else if (op->op.same_as(builtin::ptx_arrive_barrier())) {
     need_cast_smem_ptr_to_int_ = true;
-    int barrier_id = Downcast<IntImm>(op->args[0])->value;
-    CHECK(barrier_id < barrier_count_);
-    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::string barrier = PrintBarrier(op->args[0]);
     this->stream << PrintArriveBarrierAsm(barrier);
   } else if (op->op.same_as(builtin::ptx_arrive_barrier_expect_tx())) {
     need_cast_smem_ptr_to_int_ = true;
-    int barrier_id = Downcast<IntImm>(op->args[0])->value;
-    CHECK(barrier_id < barrier_count_);
-    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::string barrier = PrintBarrier(op->args[0]);
     std::string byte_count = this->PrintExpr(op->args[1]);
     this->stream << PrintArriveBarrierExpectTxAsm(barrier, byte_count);
   } else if (op->op.same_as(builtin::ptx_wait_barrier())) {
     need_cast_smem_ptr_to_int_ = true;
-    int barrier_id = Downcast<IntImm>(op->args[0])->value;
-    CHECK(barrier_id < barrier_count_);
-    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
-    this->stream << PrintWaitBarrierAsm(barrier);
+    std::string barrier = PrintBarrier(op->args[0]);
+    std::string phase_bit = op->args.size() > 1 ? this->PrintExpr(op->args[1]) : "0";
+    this->stream << PrintWaitBarrierAsm(barrier, phase_bit);
   } else if (op->op.same_as(builtin::create_barriers())) {
     CHECK_EQ(barrier_count_, -1);
     int barrier_count = Downcast<IntImm>(op->args[0])->value;
@@ -1068,6 +1094,12 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
                  << barrier_name_ << "[" << barrier_count << "];\n";
     this->stream << "for (int i = 0; i < " << barrier_count << "; ++i) { " << barrier_name_
                  << "[i] = 0; }\n";
+  } else if (op->op.same_as(builtin::ptx_ld_shared_cluster())) {
+    need_ld_shared_cluster_ = true;
+    std::string smem_ptr = this->PrintExpr(op->args[0]);
+    std::string offset = this->PrintExpr(op->args[1]);
+    std::string block_rank = this->PrintExpr(op->args[2]);
+    os << "tvm_ld_shared_cluster(" << smem_ptr << " + " << offset << ", " << block_rank << ")";
   } else if (op->op.same_as(builtin::ptx_ldg32())) {
     /*
     asm volatile (
@@ -1417,6 +1449,14 @@ void CodeGenCUDA::VisitExpr_(const FloatImmNode* op, std::ostream& os) {  // NOL
   PrintConst(op, os, this);
 }
 
+std::string CodeGenCUDA::PrintBarrier(const PrimExpr& barrier_id) {
+  CHECK_GE(barrier_count_, 0) << "The barriers must be created by `create_barriers` before use";
+  if (const auto* imm = barrier_id.as<IntImmNode>()) {
+    CHECK(imm->value < barrier_count_);
+  }
+  return barrier_name_ + "[" + this->PrintExpr(barrier_id) + "]";
+}
+
 void CodeGenCUDA::PrintWmmaScope(const std::string& scope, DataType t, const VarNode* variable,
                                  std::ostream& os) {
   std::stringstream type;
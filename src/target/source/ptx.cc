@@ -65,13 +65,16 @@ enum class DataType : int {
   kBit16 = 18,
   kBit32 = 19,
   kBit64 = 20,
+  kFloat8E4M3 = 21,
+  kFloat8E5M2 = 22,
 };
 
 static const char* dtype_str[] = {".s4",   ".u4",  ".s8",  ".u8",  ".s16",  ".u16",   ".s32",
                                   ".u32",  ".s64", ".u64", ".f16", ".bf16", ".f16x2", ".f32",
-                                  ".tf32", ".f64", ".b1",  ".b8",  ".b16",  ".b32",   ".b64"};
-static const uint32_t num_bits[] = {4,  4,  8,  8,  16, 16, 32, 32, 64, 64, 16,
-                                    16, 32, 32, 32, 64, 1,  8,  16, 32, 64};
+                                  ".tf32", ".f64", ".b1",  ".b8",  ".b16",  ".b32",   ".b64",
+                                  ".e4m3", ".e5m2"};
+static const uint32_t num_bits[] = {4,  4,  8,  8,  16, 16, 32, 32, 64, 64, 16, 16,
+                                    32, 32, 32, 64, 1,  8,  16, 32, 64, 8,  8};
 
 /*!
  * \brief Create PTX data type from string.
@@ -119,6 +122,10 @@ inline DataType DTypeFromString(const std::string str) {
     return DataType::kBit32;
   } else if (str == ".b64") {
     return DataType::kBit64;
+  } else if (str == "e4m3_float8" || str == "e4m3" || str == ".e4m3") {
+    return DataType::kFloat8E4M3;
+  } else if (str == "e5m2_float8" || str == "e5m2" || str == ".e5m2") {
+    return DataType::kFloat8E5M2;
   } else {
     LOG(FATAL) << "Unrecognized PTX data type " << str;
   }
@@ -215,6 +222,8 @@ const MMAConfig valid_mma_configs[] = {
     MMAConfig(8, 8, 32, DataType::kUInt4, false, false),
     MMAConfig(16, 8, 32, DataType::kUInt4, false, false),
     MMAConfig(16, 8, 64, DataType::kUInt4, false, false),
+    MMAConfig(16, 8, 32, DataType::kFloat8E4M3, false, false),
+    MMAConfig(16, 8, 32, DataType::kFloat8E5M2, false, false),
     MMAConfig(8, 8, 128, DataType::kBit1, true, false),
     MMAConfig(16, 8, 128, DataType::kBit1, true, false),
     MMAConfig(16, 8, 256, DataType::kBit1, true, false),
@@ -263,6 +272,11 @@ void CheckMMADTypeCompatible(DataType dtype_a, DataType dtype_b, DataType dtype_
     case DataType::kUInt8:
       CHECK(dtype_b == DataType::kInt8 || dtype_b == DataType::kUInt8) << ab_not_match_err_str;
       break;
+    case DataType::kFloat8E4M3:
+    case DataType::kFloat8E5M2:
+      CHECK(dtype_b == DataType::kFloat8E4M3 || dtype_b == DataType::kFloat8E5M2)
+          << ab_not_match_err_str;
+      break;
     default:
       CHECK(false) << "Invalid multiplicand data types: " << DTypeToString(dtype_a)
                    << DTypeToString(dtype_b);
@@ -287,6 +301,11 @@ void CheckMMADTypeCompatible(DataType dtype_a, DataType dtype_b, DataType dtype_
       CHECK(dtype_c == DataType::kFloat32)
           << "For multiplicand data type bf16/tf32, accumulator data type can only be f32.";
       break;
+    case DataType::kFloat8E4M3:
+    case DataType::kFloat8E5M2:
+      CHECK(dtype_c == DataType::kFloat32)
+          << "For multiplicand data type e4m3/e5m2, accumulator data type can only be f32.";
+      break;
     case DataType::kFloat64:
       CHECK(dtype_c == DataType::kFloat64)
           << "For multiplicand data type f64, accumulator data type can only be f64.";
@@ -371,6 +390,8 @@ inline FragAttrs GetFragAttrs(DataType dtype) {
     case DataType::kUInt4:
     case DataType::kInt8:
     case DataType::kUInt8:
+    case DataType::kFloat8E4M3:
+    case DataType::kFloat8E5M2:
     case DataType::kBit16:
     case DataType::kFloat16:  // .f16x2 register
     case DataType::kBFloat16:
@@ -809,11 +830,11 @@ std::string PrintArriveBarrierExpectTxAsm(const std::string& barrier,
   return predicated_asm_code;
 }
 
-std::string PrintWaitBarrierAsm(const std::string& barrier) {
+std::string PrintWaitBarrierAsm(const std::string& barrier, const std::string& phase_bit) {
   std::string predicated_asm_code = R"(
   {
     unsigned int barrier_addr_int = cast_smem_ptr_to_int({barrier});
-    constexpr int phase_bit = 0;
+    int phase_bit = {phase_bit};
     __asm__ __volatile__(
       "{ .reg .pred P; WAIT: mbarrier.try_wait.parity.shared.b64 P, [%0], %1; @P bra.uni DONE; bra.uni WAIT; DONE: }"
       :: "r"(barrier_addr_int), "r"(phase_bit)
@@ -823,6 +844,7 @@ std::string PrintWaitBarrierAsm(const std::string& barrier) {
 
   Replacer replacer;
   replacer.register_rule("{barrier}", "&" + barrier);
+  replacer.register_rule("{phase_bit}", phase_bit);
   predicated_asm_code = replacer.rewrite(predicated_asm_code);
   return predicated_asm_code;
 }
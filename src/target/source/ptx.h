@@ -155,8 +155,9 @@ std::string PrintArriveBarrierExpectTxAsm(const std::string& barrier,
 /*!
  * \brief Print ptx barrier wait using mbarrier.try_wait
  * \param barrier: The name of the barrier in shared memory.
+ * \param phase_bit: The parity of the phase of the barrier to wait for.
  */
-std::string PrintWaitBarrierAsm(const std::string& barrier);
+std::string PrintWaitBarrierAsm(const std::string& barrier, const std::string& phase_bit = "0");
 
 }  // namespace codegen
 }  // namespace tvm
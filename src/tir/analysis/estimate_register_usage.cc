@@ -0,0 +1,181 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file estimate_register_usage.cc
+ * \brief Estimate the number of registers that each thread of a GPU kernel keeps live.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+
+#include "../../runtime/thread_storage_scope.h"
+#include "../transforms/ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The registers for the thread indices, the addresses and the loop counters. */
+constexpr int64_t kBaseRegisters = 16;
+/*! \brief The number of threads that share out a warp-level buffer. */
+constexpr int64_t kWarpSize = 32;
+
+class RegisterUsageEstimator : public StmtExprVisitor {
+ public:
+  int64_t Estimate(const Stmt& stmt) {
+    this->VisitStmt(stmt);
+    return kBaseRegisters + peak_;
+  }
+
+ private:
+  /*! \brief The number of 32-bit registers holding `num_elements` values of a type. */
+  static int64_t NumRegisters(DataType dtype, int64_t num_elements) {
+    return (num_elements * dtype.bits() * dtype.lanes() + 31) / 32;
+  }
+
+  /*! \brief Whether a buffer lives in registers, whose loads are already counted. */
+  static bool IsRegisterBuffer(const Var& buffer_var) {
+    runtime::StorageRank rank =
+        runtime::StorageScope::Create(GetPtrStorageScope(buffer_var)).rank;
+    return rank != runtime::StorageRank::kGlobal && rank != runtime::StorageRank::kShared &&
+           rank != runtime::StorageRank::kTexture;
+  }
+
+  /*!
+   * \brief The largest trip count of the loop nests in a statement, or -1 if any loop has a
+   *  symbolic extent.
+   */
+  static int64_t TripCount(const Stmt& stmt) {
+    class OuterLoopVisitor : public StmtVisitor {
+     public:
+      void VisitStmt_(const ForNode* op) final {
+        const auto* extent = op->extent.as<IntImmNode>();
+        int64_t body_trip_count = TripCount(op->body);
+        if (extent == nullptr || body_trip_count < 0) {
+          trip_count = -1;
+        } else if (trip_count >= 0) {
+          trip_count = std::max(trip_count, extent->value * body_trip_count);
+        }
+      }
+      int64_t trip_count = 1;
+    };
+    OuterLoopVisitor visitor;
+    visitor(stmt);
+    return visitor.trip_count;
+  }
+
+  void VisitStmt_(const AllocateNode* op) final {
+    runtime::StorageRank rank =
+        runtime::StorageScope::Create(GetPtrStorageScope(op->buffer_var)).rank;
+    int64_t size = op->ConstantAllocationSize();
+    int64_t registers = 0;
+    if (rank == runtime::StorageRank::kLocal) {
+      registers = NumRegisters(op->dtype, size);
+    } else if (rank == runtime::StorageRank::kWMMAMatrixA ||
+               rank == runtime::StorageRank::kWMMAMatrixB ||
+               rank == runtime::StorageRank::kWMMAAccumulator ||
+               rank == runtime::StorageRank::kMMAMatrixA ||
+               rank == runtime::StorageRank::kMMAMatrixB ||
+               rank == runtime::StorageRank::kMMAMatrixC) {
+      registers = (NumRegisters(op->dtype, size) + kWarpSize - 1) / kWarpSize;
+    }
+    live_ += registers;
+    StmtExprVisitor::VisitStmt_(op);
+    live_ -= registers;
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::pragma_auto_unroll_max_step) {
+      int64_t max_step = Downcast<Integer>(op->value)->value;
+      std::swap(max_step, auto_unroll_max_step_);
+      StmtExprVisitor::VisitStmt_(op);
+      std::swap(max_step, auto_unroll_max_step_);
+    } else {
+      StmtExprVisitor::VisitStmt_(op);
+    }
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    // The loads of the unrolled and vectorized iterations are issued together, and stay live
+    // until they are consumed
+    const auto* extent = op->extent.as<IntImmNode>();
+    bool unrolled = false;
+    if (extent != nullptr) {
+      if (op->kind == ForKind::kUnrolled || op->kind == ForKind::kVectorized) {
+        unrolled = true;
+      } else if (op->kind == ForKind::kSerial) {
+        int64_t trip_count = TripCount(op->body);
+        unrolled = trip_count >= 0 && extent->value * trip_count <= auto_unroll_max_step_;
+      }
+    }
+    int64_t factor = unrolled ? extent->value : 1;
+    unroll_factor_ *= factor;
+    StmtExprVisitor::VisitStmt_(op);
+    unroll_factor_ /= factor;
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    loaded_ = 0;
+    StmtExprVisitor::VisitStmt_(op);
+    peak_ = std::max(peak_, live_ + loaded_ * unroll_factor_);
+  }
+
+  void VisitStmt_(const EvaluateNode* op) final {
+    loaded_ = 0;
+    StmtExprVisitor::VisitStmt_(op);
+    peak_ = std::max(peak_, live_ + loaded_ * unroll_factor_);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    if (!IsRegisterBuffer(op->buffer->data)) {
+      loaded_ += NumRegisters(op->dtype, 1);
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  /*! \brief The registers of the live register buffers. */
+  int64_t live_{0};
+  /*! \brief The registers of the values loaded by the current statement. */
+  int64_t loaded_{0};
+  /*! \brief The number of iterations of the current statement that run together. */
+  int64_t unroll_factor_{1};
+  /*! \brief The largest trip count of the loop nests to be unrolled automatically. */
+  int64_t auto_unroll_max_step_{0};
+  /*! \brief The largest number of live registers. */
+  int64_t peak_{0};
+};
+
+int64_t EstimateRegisterUsage(const Stmt& stmt) { return RegisterUsageEstimator().Estimate(stmt); }
+
+TVM_REGISTER_GLOBAL("tir.analysis.estimate_register_usage")
+    .set_body_typed([](ObjectRef obj) -> int64_t {
+      if (auto func = obj.as<PrimFunc>()) {
+        return EstimateRegisterUsage(func.value()->body);
+      } else if (auto stmt = obj.as<Stmt>()) {
+        return EstimateRegisterUsage(stmt.value());
+      }
+      LOG(FATAL) << "TypeError: Expect the input to be either PrimFunc or Stmt, but gets: "
+                 << obj->GetTypeKey();
+      throw;
+    });
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,307 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file shared_memory_bank_conflict.cc
+ * \brief Detect the bank conflicts of the accesses to shared memory.
+ */
+#include "shared_memory_bank_conflict.h"
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_set>
+#include <utility>
+
+#include "../../runtime/thread_storage_scope.h"
+
+namespace tvm {
+namespace tir {
+
+class SharedMemoryAccessCollector : public StmtExprVisitor {
+ public:
+  std::unordered_map<const VarNode*, SharedMemoryAccesses> Collect(const Stmt& stmt) {
+    this->VisitStmt(stmt);
+    std::unordered_map<const VarNode*, SharedMemoryAccesses> result;
+    arith::Analyzer analyzer;
+    for (const Access& access : accesses_) {
+      const VarNode* data = access.buffer->data.get();
+      if (unanalyzable_.count(data)) {
+        continue;
+      }
+      std::optional<std::vector<std::vector<int64_t>>> lane_indices =
+          EvaluateLanes(access, &analyzer);
+      if (!lane_indices.has_value()) {
+        unanalyzable_.insert(data);
+        continue;
+      }
+      SharedMemoryAccesses& entry = result[data];
+      entry.buffer = access.buffer;
+      entry.lane_indices.push_back(std::move(lane_indices.value()));
+    }
+    for (const VarNode* data : unanalyzable_) {
+      result.erase(data);
+    }
+    return result;
+  }
+
+ private:
+  /*! \brief A thread index in scope, with its dimension and its extent. */
+  struct ThreadIndex {
+    Var var;
+    int dim_index;
+    int64_t extent;
+  };
+
+  /*! \brief An access to a shared memory buffer, with the thread indices in its scope. */
+  struct Access {
+    Buffer buffer;
+    Array<PrimExpr> indices;
+    std::vector<ThreadIndex> threads;
+  };
+
+  /*!
+   * \brief The indices of an access for each lane of the first warp, numbering the lanes with
+   *  threadIdx.x fastest, or nullopt if they are not constant.
+   */
+  static std::optional<std::vector<std::vector<int64_t>>> EvaluateLanes(
+      const Access& access, arith::Analyzer* analyzer) {
+    int64_t extents[3] = {1, 1, 1};
+    for (const ThreadIndex& thread : access.threads) {
+      extents[thread.dim_index] = thread.extent;
+    }
+    int64_t num_lanes = std::min(kNumSharedMemoryBanks, extents[0] * extents[1] * extents[2]);
+    std::vector<std::vector<int64_t>> lane_indices;
+    for (int64_t lane = 0; lane < num_lanes; ++lane) {
+      int64_t thread_index[3] = {lane % extents[0], lane / extents[0] % extents[1],
+                                 lane / extents[0] / extents[1]};
+      Array<PrimExpr> indices =
+          Substitute(access.indices, [&](const Var& var) -> Optional<PrimExpr> {
+            for (const ThreadIndex& thread : access.threads) {
+              if (thread.var.same_as(var)) {
+                return make_const(var.dtype(), thread_index[thread.dim_index]);
+              }
+            }
+            // Every loop iteration and every block runs the same on all the lanes
+            return make_zero(var.dtype());
+          });
+      std::vector<int64_t> values;
+      for (const PrimExpr& index : indices) {
+        const auto* imm = analyzer->Simplify(index).as<IntImmNode>();
+        if (imm == nullptr) {
+          return std::nullopt;
+        }
+        values.push_back(imm->value);
+      }
+      lane_indices.push_back(std::move(values));
+    }
+    return lane_indices;
+  }
+
+  static bool IsShared(const Buffer& buffer) {
+    return runtime::StorageScope::Create(buffer.scope()).rank == runtime::StorageRank::kShared;
+  }
+
+  /*! \brief Whether the layout of a buffer is simple enough to be analyzed and rewritten. */
+  static bool IsAnalyzableBuffer(const Buffer& buffer) {
+    if (buffer->shape.size() < 2 || !buffer->strides.empty() || buffer->dtype.lanes() != 1 ||
+        buffer->dtype.bits() % 8 != 0 || !buffer->axis_separators.empty()) {
+      return false;
+    }
+    return std::all_of(buffer->shape.begin(), buffer->shape.end(),
+                       [](const PrimExpr& dim) { return dim->IsInstance<IntImmNode>(); });
+  }
+
+  void RecordAccess(const Buffer& buffer, const Array<PrimExpr>& indices) {
+    if (!IsShared(buffer)) {
+      return;
+    }
+    const VarNode* data = buffer->data.get();
+    auto it = buffers_.find(data);
+    if (it == buffers_.end()) {
+      buffers_.emplace(data, buffer);
+    } else if (!it->second.same_as(buffer) &&
+               !StructuralEqual()(it->second->shape, buffer->shape)) {
+      unanalyzable_.insert(data);
+    }
+    if (in_vectorized_loop_ || !IsAnalyzableBuffer(buffer) ||
+        std::any_of(indices.begin(), indices.end(),
+                    [](const PrimExpr& index) { return index.dtype().lanes() != 1; }) ||
+        std::any_of(threads_.begin(), threads_.end(),
+                    [](const ThreadIndex& thread) { return thread.extent < 0; })) {
+      unanalyzable_.insert(data);
+      return;
+    }
+    accesses_.push_back(Access{buffer, Substitute(indices, bindings_), threads_});
+  }
+
+  void EnterThread(const IterVar& iter_var, const PrimExpr& extent) {
+    runtime::ThreadScope scope = runtime::ThreadScope::Create(iter_var->thread_tag);
+    if (scope.rank != 1) {
+      return;
+    }
+    // A symbolic extent, with which the lanes of a warp are unknown, is recorded as -1
+    const auto* imm = extent.as<IntImmNode>();
+    threads_.push_back(ThreadIndex{iter_var->var, scope.dim_index, imm ? imm->value : -1});
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent) {
+      size_t num_threads = threads_.size();
+      EnterThread(Downcast<IterVar>(op->node), op->value);
+      StmtExprVisitor::VisitStmt_(op);
+      threads_.resize(num_threads);
+      return;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    if (op->kind == ForKind::kThreadBinding && op->thread_binding.defined()) {
+      size_t num_threads = threads_.size();
+      IterVar iter_var = op->thread_binding.value();
+      EnterThread(IterVar(iter_var->dom, op->loop_var, iter_var->iter_type, iter_var->thread_tag),
+                  op->extent);
+      StmtExprVisitor::VisitStmt_(op);
+      threads_.resize(num_threads);
+      return;
+    }
+    bool outer_vectorized = in_vectorized_loop_;
+    in_vectorized_loop_ = in_vectorized_loop_ || op->kind == ForKind::kVectorized;
+    StmtExprVisitor::VisitStmt_(op);
+    in_vectorized_loop_ = outer_vectorized;
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    bindings_.Set(op->var, Substitute(op->value, bindings_));
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LetNode* op) final {
+    bindings_.Set(op->var, Substitute(op->value, bindings_));
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BlockRealizeNode* op) final {
+    for (size_t i = 0; i < op->iter_values.size(); ++i) {
+      bindings_.Set(op->block->iter_vars[i]->var, Substitute(op->iter_values[i], bindings_));
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    RecordAccess(op->buffer, op->indices);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    RecordAccess(op->buffer, op->indices);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::address_of())) {
+      if (const auto* load = op->args[0].as<BufferLoadNode>()) {
+        unanalyzable_.insert(load->buffer->data.get());
+      }
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const VarNode* op) final {
+    // The data of the buffer is used through a pointer, e.g. by tvm_access_ptr or ptx_cp_async
+    unanalyzable_.insert(op);
+  }
+
+  /*! \brief The accesses to the shared memory buffers, in program order. */
+  std::vector<Access> accesses_;
+  /*! \brief The buffer first seen for each data variable. */
+  std::unordered_map<const VarNode*, Buffer> buffers_;
+  /*! \brief The data variables of the buffers that cannot be analyzed. */
+  std::unordered_set<const VarNode*> unanalyzable_;
+  /*! \brief The thread indices in scope. */
+  std::vector<ThreadIndex> threads_;
+  /*! \brief The values of the variables bound by lets and block realizations. */
+  Map<Var, PrimExpr> bindings_;
+  /*! \brief Whether the visitor is inside a vectorized loop. */
+  bool in_vectorized_loop_ = false;
+};
+
+std::unordered_map<const VarNode*, SharedMemoryAccesses> CollectSharedMemoryAccesses(
+    const Stmt& stmt) {
+  return SharedMemoryAccessCollector().Collect(stmt);
+}
+
+int64_t BankConflictDegree(const std::vector<std::vector<int64_t>>& lane_indices, DataType dtype,
+                           const std::function<int64_t(const std::vector<int64_t>&)>& f_offset) {
+  int64_t bytes = dtype.bytes();
+  // The lanes accessing the same word are served by a broadcast
+  std::map<int64_t, std::set<int64_t>> bank_words;
+  for (const std::vector<int64_t>& indices : lane_indices) {
+    int64_t begin = f_offset(indices) * bytes;
+    for (int64_t byte = begin; byte < begin + bytes; byte += kSharedMemoryBankBytes) {
+      int64_t word = byte / kSharedMemoryBankBytes;
+      bank_words[word % kNumSharedMemoryBanks].insert(word);
+    }
+  }
+  int64_t degree = 1;
+  for (const auto& kv : bank_words) {
+    degree = std::max(degree, static_cast<int64_t>(kv.second.size()));
+  }
+  return degree;
+}
+
+int64_t RowMajorOffset(const Array<PrimExpr>& shape, const std::vector<int64_t>& indices) {
+  int64_t offset = 0;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    offset = offset * Downcast<IntImm>(shape[i])->value + indices[i];
+  }
+  return offset;
+}
+
+Map<Var, Integer> DetectSharedMemoryBankConflicts(const PrimFunc& func) {
+  Map<Var, Integer> result;
+  for (const auto& kv : CollectSharedMemoryAccesses(func->body)) {
+    const Buffer& buffer = kv.second.buffer;
+    int64_t degree = 1;
+    for (const std::vector<std::vector<int64_t>>& lane_indices : kv.second.lane_indices) {
+      degree = std::max(degree, BankConflictDegree(lane_indices, buffer->dtype,
+                                                   [&](const std::vector<int64_t>& indices) {
+                                                     return RowMajorOffset(buffer->shape, indices);
+                                                   }));
+    }
+    result.Set(buffer->data, Integer(degree));
+  }
+  return result;
+}
+
+TVM_REGISTER_GLOBAL("tir.analysis.detect_shared_memory_bank_conflicts")
+    .set_body_typed(DetectSharedMemoryBankConflicts);
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file shared_memory_bank_conflict.h
+ * \brief Detect the bank conflicts of the accesses to shared memory, from the indices that the
+ *  lanes of a warp access at once.
+ */
+#ifndef TVM_TIR_ANALYSIS_SHARED_MEMORY_BANK_CONFLICT_H_
+#define TVM_TIR_ANALYSIS_SHARED_MEMORY_BANK_CONFLICT_H_
+
+#include <tvm/tir/buffer.h>
+#include <tvm/tir/stmt.h>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The number of banks of the shared memory. */
+constexpr int64_t kNumSharedMemoryBanks = 32;
+/*! \brief The width of a bank of the shared memory in bytes. */
+constexpr int64_t kSharedMemoryBankBytes = 4;
+
+/*! \brief The accesses to a shared memory buffer, as seen by the first warp of the kernel. */
+struct SharedMemoryAccesses {
+  /*! \brief The buffer, the same for all the accesses up to its name. */
+  Buffer buffer;
+  /*!
+   * \brief The indices of the buffer accessed by each lane, for each access. The loop variables,
+   *  and the thread indices other than threadIdx, are taken as zero.
+   */
+  std::vector<std::vector<std::vector<int64_t>>> lane_indices;
+};
+
+/*!
+ * \brief Collect the accesses to the shared memory buffers allocated in a statement, after
+ *  LowerOpaqueBlock. The buffers that are accessed through pointers, in vectorized loops, or with
+ *  indices that do not fold to constants for a warp are left out.
+ * \param stmt The statement.
+ * \return The accesses of each buffer, by its data variable.
+ */
+std::unordered_map<const VarNode*, SharedMemoryAccesses> CollectSharedMemoryAccesses(
+    const Stmt& stmt);
+
+/*!
+ * \brief Compute the conflict degree of an access under a layout, i.e. the largest number of
+ *  distinct words that the lanes of the warp access in the same bank.
+ * \param lane_indices The indices accessed by each lane.
+ * \param dtype The data type of the buffer.
+ * \param f_offset The layout, mapping indices to the offset of the element in the buffer.
+ * \return The conflict degree, 1 if the access is free of conflicts.
+ */
+int64_t BankConflictDegree(const std::vector<std::vector<int64_t>>& lane_indices, DataType dtype,
+                           const std::function<int64_t(const std::vector<int64_t>&)>& f_offset);
+
+/*! \brief The row-major layout of a buffer with constant shape. */
+int64_t RowMajorOffset(const Array<PrimExpr>& shape, const std::vector<int64_t>& indices);
+
+}  // namespace tir
+}  // namespace tvm
+
+#endif  // TVM_TIR_ANALYSIS_SHARED_MEMORY_BANK_CONFLICT_H_
@@ -41,7 +41,8 @@ class GPUCodeVerifier : public StmtExprVisitor {
   std::vector<String> Verify(Stmt stmt, int64_t max_local_memory_per_block,
                              int64_t max_shared_memory_per_block, int64_t max_threads_per_block,
                              int64_t max_thread_x, int64_t max_thread_y, int64_t max_thread_z,
-                             int64_t max_vthread, int64_t max_vector_bytes, int64_t max_kernels) {
+                             int64_t max_vthread, int64_t max_vector_bytes, int64_t max_kernels,
+                             int64_t max_registers_per_thread, int64_t max_registers_per_block) {
     max_local_memory_per_block_ = static_cast<size_t>(max_local_memory_per_block);
     max_shared_memory_per_block_ = static_cast<size_t>(max_shared_memory_per_block);
     max_threads_per_block_ = static_cast<size_t>(max_threads_per_block);
@@ -51,6 +52,10 @@ class GPUCodeVerifier : public StmtExprVisitor {
     max_vthread_ = static_cast<size_t>(max_vthread);
     max_vector_bytes_ = static_cast<size_t>(max_vector_bytes);
     max_kernels_ = static_cast<size_t>(max_kernels);
+    max_registers_per_thread_ = static_cast<size_t>(max_registers_per_thread);
+    max_registers_per_block_ = static_cast<size_t>(max_registers_per_block);
+    check_registers_ =
+        max_registers_per_thread != INT64_MAX || max_registers_per_block != INT64_MAX;
     Reset_();
 
     // TODO(jcf94): Add support of detecting CUDA Misaligned Address error
@@ -156,6 +161,11 @@ class GPUCodeVerifier : public StmtExprVisitor {
         err("threads per block", thread_per_block_, max_threads_per_block_);
         err("local memory per block", local_memory_per_block_, max_local_memory_per_block_);
         err("shared memory per block", shared_memory_per_block_, max_shared_memory_per_block_);
+        if (check_registers_) {
+          size_t registers = static_cast<size_t>(EstimateRegisterUsage(GetRef<Stmt>(op)));
+          err("registers per thread", registers, max_registers_per_thread_);
+          err("registers per block", registers * thread_per_block_, max_registers_per_block_);
+        }
 
         if (kernels_launched_ > max_kernels_) {
           std::stringstream s;
@@ -261,6 +271,9 @@ class GPUCodeVerifier : public StmtExprVisitor {
   size_t max_thread_x_, max_thread_y_, max_thread_z_, max_vthread_;
   size_t max_vector_bytes_;
   size_t max_kernels_;
+  size_t max_registers_per_thread_;
+  size_t max_registers_per_block_;
+  bool check_registers_{false};
 
   std::vector<String> errors_;
 
@@ -285,6 +298,8 @@ std::vector<String> VerifyGPUCode_(const PrimFunc& func, Map<String, PrimExpr> c
   int64_t max_vthread = INT64_MAX;
   int64_t max_vector_bytes = INT64_MAX;
   int64_t max_kernels = INT64_MAX;
+  int64_t max_registers_per_thread = INT64_MAX;
+  int64_t max_registers_per_block = INT64_MAX;
 
   for (auto iter : constraints) {
     const IntImmNode* val = iter.second.as<IntImmNode>();
@@ -306,6 +321,10 @@ std::vector<String> VerifyGPUCode_(const PrimFunc& func, Map<String, PrimExpr> c
       max_vector_bytes = val->value;
     } else if (iter.first == "max_kernels") {
       max_kernels = val->value;
+    } else if (iter.first == "max_registers_per_thread") {
+      max_registers_per_thread = val->value;
+    } else if (iter.first == "max_registers_per_block") {
+      max_registers_per_block = val->value;
     } else {
       LOG(FATAL) << "Invalid check item: " << iter.first;
     }
@@ -313,7 +332,8 @@ std::vector<String> VerifyGPUCode_(const PrimFunc& func, Map<String, PrimExpr> c
 
   return verifier.Verify(func->body, max_local_memory_per_block, max_shared_memory_per_block,
                          max_threads_per_block, max_thread_x, max_thread_y, max_thread_z,
-                         max_vthread, max_vector_bytes, max_kernels);
+                         max_vthread, max_vector_bytes, max_kernels, max_registers_per_thread,
+                         max_registers_per_block);
 }
 
 bool VerifyGPUCode(const PrimFunc& func, Map<String, PrimExpr> constraints) {
@@ -432,6 +432,10 @@ PrimFunc Specialize(PrimFunc func, const Map<Var, ObjectRef>& param_map) {
   return PrimFuncSpecializer::Specialize(func, std::move(var_map));
 }
 
+Stmt SpecializeBody(const PrimFunc& func, const Map<Var, PrimExpr>& var_map) {
+  return PrimFuncSpecializer::Specialize(func, VarMap(var_map.begin(), var_map.end()))->body;
+}
+
 /**************** FFI ****************/
 
 TVM_REGISTER_GLOBAL("tir.Specialize").set_body_typed(Specialize);
@@ -90,19 +90,43 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   ICHECK(mod.defined());
   std::vector<GlobalVar> deleted_list;
 
+  int num_threads = tvm::transform::NumFunctionPassThreads(pass_info, pass_ctx);
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
-  // directly loop over the underlying dict
-  for (auto& kv : *func_dict) {
-    // only picks up tir::PrimFunc
-    if (kv.second->IsInstance<PrimFuncNode>()) {
-      // move out the function so that it is the only copy.
-      PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
-      func = pass_func(std::move(func), mod, pass_ctx);
-      kv.second = std::move(func);
-
-      if (!kv.second.defined()) {
-        deleted_list.push_back(Downcast<GlobalVar>(kv.first));
+  if (num_threads > 1) {
+    // The functions stay in the module while the others are transformed, so they are not moved
+    // out, and the results are written back in the order of the module.
+    std::vector<GlobalVar> gvars;
+    std::vector<PrimFunc> funcs;
+    for (const auto& kv : *func_dict) {
+      if (kv.second->IsInstance<PrimFuncNode>()) {
+        gvars.push_back(Downcast<GlobalVar>(kv.first));
+        funcs.push_back(Downcast<PrimFunc>(kv.second));
+      }
+    }
+    tvm::transform::ParallelForFunctions(funcs.size(), num_threads, pass_ctx, [&](int i) {
+      funcs[i] = pass_func(funcs[i], mod, pass_ctx);
+    });
+    for (size_t i = 0; i < funcs.size(); ++i) {
+      if (funcs[i].defined()) {
+        func_dict->at(gvars[i]) = std::move(funcs[i]);
+      } else {
+        deleted_list.push_back(gvars[i]);
+      }
+    }
+  } else {
+    // directly loop over the underlying dict
+    for (auto& kv : *func_dict) {
+      // only picks up tir::PrimFunc
+      if (kv.second->IsInstance<PrimFuncNode>()) {
+        // move out the function so that it is the only copy.
+        PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
+        func = pass_func(std::move(func), mod, pass_ctx);
+        kv.second = std::move(func);
+
+        if (!kv.second.defined()) {
+          deleted_list.push_back(Downcast<GlobalVar>(kv.first));
+        }
       }
     }
   }
@@ -118,8 +142,8 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
 
 Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable) {
-  PassInfo pass_info = PassInfo(opt_level, name, required, traceable);
+    int opt_level, String name, tvm::Array<String> required, bool traceable, bool thread_safe) {
+  PassInfo pass_info = PassInfo(opt_level, name, required, traceable, thread_safe);
   return PrimFuncPass(pass_func, pass_info);
 }
 
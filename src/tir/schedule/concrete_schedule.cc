@@ -825,6 +825,13 @@ void ConcreteScheduleNode::ReverseComputeInline(const BlockRV& block_rv) {
   this->state_->DebugVerify();
 }
 
+void ConcreteScheduleNode::FuseEpilogue(const BlockRV& block_rv) {
+  TVM_TIR_SCHEDULE_BEGIN();
+  tir::FuseEpilogue(state_, this->GetSRef(block_rv));
+  TVM_TIR_SCHEDULE_END("fuse-epilogue", this->error_render_level_);
+  this->state_->DebugVerify();
+}
+
 /******** Schedule: Block Annotation ********/
 
 void ConcreteScheduleNode::StorageAlign(const BlockRV& block_rv, int buffer_index, int axis,
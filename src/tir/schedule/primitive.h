@@ -505,6 +505,13 @@ TVM_DLL void ComputeInline(ScheduleState self, const StmtSRef& block_sref);
  * \param block_sref The sref to the block to be inlined to its producer
  */
 TVM_DLL void ReverseComputeInline(ScheduleState self, const StmtSRef& block_sref);
+/*!
+ * \brief Fuse the elementwise epilogue of a block into it, by inlining its only consumer into it
+ * as long as the consumer can be inlined, and repeating with the consumer of the result.
+ * \param self The state of the schedule
+ * \param block_sref The sref to the block storing the result that the epilogue consumes
+ */
+TVM_DLL void FuseEpilogue(ScheduleState self, const StmtSRef& block_sref);
 /******** Schedule: Reduction ********/
 /*!
  * \brief Decompose a reduction block into two separate blocks.
@@ -954,6 +954,18 @@ void ReverseComputeInline(ScheduleState self, const StmtSRef& consumer_block_sre
   ReverseComputeInlineImpl(self, consumer_block_sref);
 }
 
+void FuseEpilogue(ScheduleState self, const StmtSRef& block_sref) {
+  // The block keeps its sref when a consumer is inlined into it, see ReverseComputeInliner
+  for (;;) {
+    Array<StmtSRef> consumers = GetConsumers(self, block_sref);
+    // Another consumer would still read the buffer the inlined consumer no longer writes
+    if (consumers.size() != 1 || !CanReverseComputeInline(self, consumers[0])) {
+      break;
+    }
+    ReverseComputeInlineImpl(self, consumers[0]);
+  }
+}
+
 /******** InstructionKind Registration ********/
 
 struct ComputeInlineTraits : public UnpackedInstTraits<ComputeInlineTraits> {
@@ -1002,8 +1014,32 @@ struct ReverseComputeInlineTraits : public UnpackedInstTraits<ReverseComputeInli
   friend struct ::tvm::tir::UnpackedInstTraits;
 };
 
+struct FuseEpilogueTraits : public UnpackedInstTraits<FuseEpilogueTraits> {
+  static constexpr const char* kName = "FuseEpilogue";
+  static constexpr bool kIsPure = false;
+
+ private:
+  static constexpr size_t kNumInputs = 1;
+  static constexpr size_t kNumAttrs = 0;
+  static constexpr size_t kNumDecisions = 0;
+
+  static void UnpackedApplyToSchedule(Schedule sch, BlockRV block_rv) {
+    return sch->FuseEpilogue(block_rv);
+  }
+
+  static String UnpackedAsPython(Array<String> outputs, String block_rv) {
+    PythonAPICall py("fuse_epilogue");
+    py.Input("block", block_rv);
+    return py.Str();
+  }
+
+  template <typename>
+  friend struct ::tvm::tir::UnpackedInstTraits;
+};
+
 TVM_REGISTER_INST_KIND_TRAITS(ComputeInlineTraits);
 TVM_REGISTER_INST_KIND_TRAITS(ReverseComputeInlineTraits);
+TVM_REGISTER_INST_KIND_TRAITS(FuseEpilogueTraits);
 
 }  // namespace tir
 }  // namespace tvm
@@ -47,7 +47,9 @@ class WrongBlockIterTypeError : public ScheduleError {
          << loop_var_
          << " does not meet any of the conditions:\n1) the block iter is data parallel;\n2) the "
             "block iter is a reduction block iter, and the thread axis to be bound is "
-            "\"threadIdx.x/y/z\"";
+            "\"threadIdx.x/y/z\";\n3) the block iter is a reduction block iter, the thread axis "
+            "to be bound is \"blockIdx.x/y/z\", and the loop has a constant extent of at most 8, "
+            "so that it is reduced across a thread block cluster";
     }
     return os.str();
   }
@@ -66,11 +68,15 @@ class WrongBlockIterTypeError : public ScheduleError {
  * 2) For each block iter whose binding contains the input loop variable, either
  *   - the block iter is data parallel, or
  *   - the block iter is a reduction block iter, and the input `thread_tag` starts with "threadIdx"
- *   in case of cross-thread reduction.
+ *   in case of cross-thread reduction, or
+ *   - the block iter is a reduction block iter, the input `thread_tag` starts with "blockIdx",
+ *   and the loop has a constant extent of at most 8 in case of reduction across a thread block
+ *   cluster.
  * \param self The schedule state
  * \param for_kind The desired ForKind (only `kParallel`, `kVectorized` and `kThreadBinding` are
  * allowed)
  * \param loop_var The loop variable of the loop to be checked
+ * \param loop_extent The extent of the loop to be checked
  * \param block_realize The block-realize of the block to be checked
  * \param thread_scope The thread scope of the thread axis to be bound, which is an invalid value if
  * the operation is not "bind"
@@ -78,7 +84,8 @@ class WrongBlockIterTypeError : public ScheduleError {
  * the input block
  */
 void CheckLoopParallelizableInBlock(const ScheduleState& self, ForKind for_kind,
-                                    const Var& loop_var, const BlockRealize& block_realize,
+                                    const Var& loop_var, const PrimExpr& loop_extent,
+                                    const BlockRealize& block_realize,
                                     runtime::ThreadScope thread_scope) {
   const Block& block = block_realize->block;
 
@@ -86,7 +93,7 @@ void CheckLoopParallelizableInBlock(const ScheduleState& self, ForKind for_kind,
   // TODO(@automation): fix the check
   // CheckAffineBinding(self, block);
 
-  // Cond 2. For each block iter whose binding contains `loop_var`, only two cases are allowed.
+  // Cond 2. For each block iter whose binding contains `loop_var`, only three cases are allowed.
   ICHECK_EQ(block->iter_vars.size(), block_realize->iter_values.size());
   int n_iters = static_cast<int>(block->iter_vars.size());
   for (int i = 0; i < n_iters; ++i) {
@@ -96,13 +103,19 @@ void CheckLoopParallelizableInBlock(const ScheduleState& self, ForKind for_kind,
     if (!UsesVar(binding, [v = loop_var.get()](const VarNode* var) { return var == v; })) {
       continue;
     }
-    // Only two cases are allowed:
+    // Only three cases are allowed:
     // - The block iter is data parallel, or
     // - The block iter is a reduction block iter, and the `thread_scope` is "threadIdx.x/y/z"
-    // in case of cross-thread reduction.
+    // in case of cross-thread reduction, or
+    // - The block iter is a reduction block iter, and the `thread_scope` is "blockIdx.x/y/z" with
+    // a small constant extent in case of reduction across a thread block cluster.
     IterVarType iter_type = iter_var->iter_type;
+    const auto* extent = loop_extent.as<IntImmNode>();
+    bool is_cluster_reduction = thread_scope.rank == 0 && thread_scope.dim_index != -1 &&
+                                extent != nullptr && extent->value <= 8;
     if (!(iter_type == kDataPar ||
-          (iter_type == kCommReduce && thread_scope.rank == 1 && thread_scope.dim_index != -1))) {
+          (iter_type == kCommReduce && thread_scope.rank == 1 && thread_scope.dim_index != -1) ||
+          (iter_type == kCommReduce && is_cluster_reduction))) {
       throw WrongBlockIterTypeError(self->mod, for_kind, loop_var, block);
     }
   }
@@ -127,8 +140,8 @@ void CheckParallelizability(const ScheduleState& self, const For& loop, ForKind
       if (!self->stmt2ref.count(realize->block.get())) {
         return false;
       }
-      CheckLoopParallelizableInBlock(self, for_kind, loop->loop_var, GetRef<BlockRealize>(realize),
-                                     thread_scope);
+      CheckLoopParallelizableInBlock(self, for_kind, loop->loop_var, loop->extent,
+                                     GetRef<BlockRealize>(realize), thread_scope);
     }
     return true;
   });
@@ -152,7 +165,8 @@ void ParallelizeComputation(const ScheduleState& self, const StmtSRef& loop_sref
    * - 1. the subtree rooted from the input loop in sref tree has compact data flow
    * - 2. all the blocks under the given loop have affine block bindings
    * - 3. the input loop can be only bound to data parallel block iters, or the loop can be bound to
-   * reduction block iter if `thread` is `threadIdx.x/y/z` in case of cross-thread reduction
+   * reduction block iter if `thread` is `threadIdx.x/y/z` in case of cross-thread reduction, or
+   * `blockIdx.x/y/z` in case of reduction across a thread block cluster
    * When the above conditions are all satisfied, this input loop can be
    * parallelized/vectorized/bound.
    */
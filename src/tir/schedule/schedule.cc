@@ -218,6 +218,8 @@ TVM_REGISTER_GLOBAL("tir.schedule.ScheduleComputeInline")
     .set_body_method<Schedule>(&ScheduleNode::ComputeInline);
 TVM_REGISTER_GLOBAL("tir.schedule.ScheduleReverseComputeInline")
     .set_body_method<Schedule>(&ScheduleNode::ReverseComputeInline);
+TVM_REGISTER_GLOBAL("tir.schedule.ScheduleFuseEpilogue")
+    .set_body_method<Schedule>(&ScheduleNode::FuseEpilogue);
 /******** (FFI) Reduction ********/
 TVM_REGISTER_GLOBAL("tir.schedule.ScheduleDecomposeReduction")
     .set_body_method<Schedule>(&ScheduleNode::DecomposeReduction);
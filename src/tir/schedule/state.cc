@@ -172,26 +172,32 @@ class BlockInfoCollector : private StmtVisitor {
   }
 
   void MakeBlockInfo(StmtSRef scope_root) {
-    bool is_root_block = srefs_.empty();
     // Calculate `BlockInfo::scope`
     Array<StmtSRef> child_block_srefs = std::move(block_frames_.back());
     BlockInfo& info = self_->block_info[scope_root] = BlockInfo(BlockScope(child_block_srefs));
+    SetFlagsUnderParentScope(scope_root, &info);
+    // Set `stage_pipeline` and `region_cover` for its intermediate children
+    info.stage_pipeline = CheckRegionCoverAndStagePipeline(info, scope_root, child_block_srefs);
+    info.subtree_intact = true;
+  }
+
+  /*! \brief Set the flags of the block that depend on its parent scope */
+  void SetFlagsUnderParentScope(const StmtSRef& block_sref, BlockInfo* info) {
+    bool is_root_block = srefs_.empty();
     // Set `affine_binding`
     if (is_root_block) {
       // If the block doesn't have outer loops and BlockRealize,
       // then we set the affine binding flag as true only if the block has no block vars
-      const BlockNode* block = TVM_SREF_TO_BLOCK(scope_root);
-      if (block->iter_vars.empty()) info.affine_binding = true;
+      const BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+      if (block->iter_vars.empty()) info->affine_binding = true;
     } else {
-      info.affine_binding =
-          IsAffineBinding(/*realize=*/block2realize_.at(scope_root->stmt),
+      info->affine_binding =
+          IsAffineBinding(/*realize=*/block2realize_.at(block_sref->stmt),
                           /*loop_var_ranges=*/LoopDomainOfSRefTreePath(srefs_.back()),
                           /*analyzer=*/&analyzer_);
     }
     // Set `region_cover` to true, will be updated on its scope block
-    info.region_cover = true;
-    // Set `stage_pipeline` and `region_cover` for its intermediate children
-    info.stage_pipeline = CheckRegionCoverAndStagePipeline(info, scope_root, child_block_srefs);
+    info->region_cover = true;
   }
 
   bool CheckRegionCoverAndStagePipeline(const BlockInfo& info, const StmtSRef& scope_root,
@@ -332,9 +338,20 @@ class BlockInfoCollector : private StmtVisitor {
   }
 
   void VisitStmt_(const BlockRealizeNode* realize) final {
-    block_frames_.emplace_back();
     const BlockNode* block = realize->block.get();
     block2realize_.emplace(block, GetRef<BlockRealize>(realize));
+    // The subtree of an intact block nested in the top level blocks is not visited again,
+    // only its flags that depend on the parent scope are recalculated
+    if (block_frames_.size() > 1) {
+      const StmtSRef& sref = self_->stmt2ref.at(block);
+      auto it = self_->block_info.find(sref);
+      if (it != self_->block_info.end() && it->second.subtree_intact) {
+        SetFlagsUnderParentScope(sref, &it->second);
+        block_frames_.back().push_back(sref);
+        return;
+      }
+    }
+    block_frames_.emplace_back();
     // Recursive visit
     PushSRef(block);
     VisitStmt(block->body);  // `block->init` is not visited
@@ -697,6 +714,7 @@ class SRefUpdater : public StmtVisitor {
       // In this case, we assume that flags are still valid so intentionally keep them unchanged
       new_info.stage_pipeline = info.stage_pipeline;
       info.scope = std::move(new_info.scope);
+      info.subtree_intact = false;
     }
   }
 
@@ -829,6 +847,15 @@ void ScheduleStateNode::Replace(const tir::StmtSRef& _src_sref, const Stmt& tgt_
   if (_src_sref->stmt == tgt_stmt.get()) {
     return;
   }
+  // The subtrees of the ancestor blocks are changed, so are the BlockInfo nested in them
+  for (const StmtSRefNode* p = _src_sref->parent; p != nullptr; p = p->parent) {
+    if (p->stmt->IsInstance<BlockNode>()) {
+      auto it = this->block_info.find(GetRef<StmtSRef>(p));
+      if (it != this->block_info.end()) {
+        it->second.subtree_intact = false;
+      }
+    }
+  }
   // Reset sref as a new sref so that its content won't be affected by subsequent changes
   StmtSRef src_sref(_src_sref->stmt, _src_sref->parent, _src_sref->seq_index);
   Stmt src_stmt = GetRef<Stmt>(src_sref->stmt);
@@ -527,6 +527,16 @@ void TracedScheduleNode::ReverseComputeInline(const BlockRV& block_rv) {
                                       /*outputs=*/{}));
 }
 
+void TracedScheduleNode::FuseEpilogue(const BlockRV& block_rv) {
+  ConcreteScheduleNode::FuseEpilogue(block_rv);
+
+  static const InstructionKind& kind = InstructionKind::Get("FuseEpilogue");
+  trace_->Append(/*inst=*/Instruction(/*kind=*/kind,
+                                      /*inputs=*/{block_rv},
+                                      /*attrs=*/{},
+                                      /*outputs=*/{}));
+}
+
 /******** Schedule: Reduction ********/
 
 BlockRV TracedScheduleNode::DecomposeReduction(const BlockRV& block_rv, const LoopRV& loop_rv) {
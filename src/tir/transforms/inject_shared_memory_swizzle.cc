@@ -0,0 +1,246 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_shared_memory_swizzle.cc
+ * \brief Choose a layout free of bank conflicts for the shared memory buffers, either by XOR
+ *  swizzling the columns with the rows or by padding the rows, from the indices that the lanes of
+ *  a warp access.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../analysis/shared_memory_bank_conflict.h"
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The layout chosen for a shared memory buffer. */
+struct SharedMemoryLayout {
+  enum class Kind : int {
+    /*! \brief The row-major layout. */
+    kIdentity = 0,
+    /*! \brief Groups of `group` columns are XOR-ed with the row modulo `period`. */
+    kSwizzle = 1,
+    /*! \brief The rows are padded by `group` elements. */
+    kPadding = 2,
+  };
+  Kind kind = Kind::kIdentity;
+  /*! \brief The number of consecutive elements in a bank word, kept together. */
+  int64_t group = 1;
+  /*! \brief The period of the XOR swizzle in rows. */
+  int64_t period = 1;
+
+  /*! \brief The offset of an element of a buffer of the given shape. */
+  int64_t Offset(const Array<PrimExpr>& shape, std::vector<int64_t> indices) const {
+    int64_t num_cols = Downcast<IntImm>(shape.back())->value;
+    int64_t row = indices[indices.size() - 2];
+    int64_t& col = indices.back();
+    if (kind == Kind::kSwizzle) {
+      col = ((col / group) ^ (row % period)) * group + col % group;
+    } else if (kind == Kind::kPadding) {
+      // The offset in the padded rows, the leading dimensions are laid out as before
+      int64_t padded_rows = RowMajorOffset(shape, indices) / num_cols;
+      return padded_rows * (num_cols + group) + col;
+    }
+    return RowMajorOffset(shape, indices);
+  }
+};
+
+/*!
+ * \brief Choose the layout of a buffer, minimizing the conflict degrees summed over its accesses.
+ *  The identity is preferred on ties, then the swizzle, which does not use more memory.
+ */
+static SharedMemoryLayout ChooseLayout(const SharedMemoryAccesses& accesses) {
+  const Buffer& buffer = accesses.buffer;
+  int64_t num_cols = Downcast<IntImm>(buffer->shape.back())->value;
+  int64_t group = std::max<int64_t>(1, kSharedMemoryBankBytes / buffer->dtype.bytes());
+  std::vector<SharedMemoryLayout> candidates;
+  candidates.push_back(SharedMemoryLayout());
+  int64_t num_groups = num_cols / group;
+  if (num_cols % group == 0 && num_groups >= 2 && (num_groups & (num_groups - 1)) == 0) {
+    SharedMemoryLayout swizzle;
+    swizzle.kind = SharedMemoryLayout::Kind::kSwizzle;
+    swizzle.group = group;
+    swizzle.period = std::min(num_groups, kNumSharedMemoryBanks);
+    candidates.push_back(swizzle);
+  }
+  SharedMemoryLayout padding;
+  padding.kind = SharedMemoryLayout::Kind::kPadding;
+  padding.group = group;
+  candidates.push_back(padding);
+
+  SharedMemoryLayout best;
+  int64_t best_cost = -1;
+  int64_t max_identity_degree = 1;
+  for (const SharedMemoryLayout& layout : candidates) {
+    int64_t cost = 0;
+    for (const std::vector<std::vector<int64_t>>& lane_indices : accesses.lane_indices) {
+      int64_t degree = BankConflictDegree(lane_indices, buffer->dtype,
+                                          [&](const std::vector<int64_t>& indices) {
+                                            return layout.Offset(buffer->shape, indices);
+                                          });
+      cost += degree;
+      if (layout.kind == SharedMemoryLayout::Kind::kIdentity) {
+        max_identity_degree = std::max(max_identity_degree, degree);
+      }
+    }
+    if (best_cost < 0 || cost < best_cost) {
+      best = layout;
+      best_cost = cost;
+    }
+  }
+  return max_identity_degree > 1 ? best : SharedMemoryLayout();
+}
+
+class SharedMemorySwizzler : public StmtExprMutator {
+ public:
+  static PrimFunc Transform(PrimFunc func) {
+    // The buffers of the blocks are also referred to by their regions, which are not rewritten
+    bool has_block = false;
+    PostOrderVisit(func->body, [&has_block](const ObjectRef& obj) {
+      has_block = has_block || obj->IsInstance<BlockNode>();
+    });
+    if (has_block) {
+      return func;
+    }
+    SharedMemorySwizzler swizzler;
+    for (const auto& kv : CollectSharedMemoryAccesses(func->body)) {
+      SharedMemoryLayout layout = ChooseLayout(kv.second);
+      if (layout.kind != SharedMemoryLayout::Kind::kIdentity) {
+        swizzler.layouts_.emplace(kv.first, layout);
+      }
+    }
+    if (swizzler.layouts_.empty()) {
+      return func;
+    }
+    PrimFuncNode* n = func.CopyOnWrite();
+    n->body = swizzler(std::move(n->body));
+    return func;
+  }
+
+ private:
+  const SharedMemoryLayout* GetLayout(const Var& buffer_var) const {
+    auto it = layouts_.find(buffer_var.get());
+    return it == layouts_.end() ? nullptr : &it->second;
+  }
+
+  /*! \brief The buffer with padded rows, whose strides are used by FlattenBuffer. */
+  Buffer GetPaddedBuffer(const Buffer& buffer, int64_t padding) {
+    auto it = padded_buffers_.find(buffer.get());
+    if (it != padded_buffers_.end()) {
+      return it->second;
+    }
+    int ndim = buffer->shape.size();
+    std::vector<PrimExpr> strides(ndim);
+    int64_t stride = 1;
+    for (int i = ndim - 1; i >= 0; --i) {
+      strides[i] = make_const(buffer->shape[i].dtype(), stride);
+      int64_t dim = Downcast<IntImm>(buffer->shape[i])->value;
+      stride *= i == ndim - 1 ? dim + padding : dim;
+    }
+    Buffer padded = buffer;
+    padded.CopyOnWrite()->strides = Array<PrimExpr>(strides.begin(), strides.end());
+    padded_buffers_.emplace(buffer.get(), padded);
+    return padded;
+  }
+
+  /*! \brief Rewrite the buffer or the indices of an access. */
+  template <typename Node>
+  Node RewriteAccess(Node node) {
+    const SharedMemoryLayout* layout = GetLayout(node->buffer->data);
+    if (layout == nullptr) {
+      return node;
+    }
+    auto* n = node.CopyOnWrite();
+    if (layout->kind == SharedMemoryLayout::Kind::kPadding) {
+      n->buffer = GetPaddedBuffer(n->buffer, layout->group);
+      return node;
+    }
+    PrimExpr row = n->indices[n->indices.size() - 2];
+    PrimExpr col = n->indices.back();
+    DataType dtype = col.dtype();
+    PrimExpr group = make_const(dtype, layout->group);
+    PrimExpr period = make_const(dtype, layout->period);
+    PrimExpr swizzled = (floordiv(col, group) ^ floormod(cast(dtype, row), period)) * group;
+    if (layout->group > 1) {
+      swizzled = swizzled + floormod(col, group);
+    }
+    n->indices.Set(n->indices.size() - 1, swizzled);
+    return node;
+  }
+
+  Stmt VisitStmt_(const AllocateNode* op) final {
+    Allocate allocate = Downcast<Allocate>(StmtExprMutator::VisitStmt_(op));
+    const SharedMemoryLayout* layout = GetLayout(op->buffer_var);
+    if (layout != nullptr && layout->kind == SharedMemoryLayout::Kind::kPadding) {
+      PrimExpr last = allocate->extents.back();
+      allocate.CopyOnWrite()->extents.Set(allocate->extents.size() - 1,
+                                          last + make_const(last.dtype(), layout->group));
+    }
+    return std::move(allocate);
+  }
+
+  Stmt VisitStmt_(const DeclBufferNode* op) final {
+    DeclBuffer decl = Downcast<DeclBuffer>(StmtExprMutator::VisitStmt_(op));
+    const SharedMemoryLayout* layout = GetLayout(op->buffer->data);
+    if (layout != nullptr && layout->kind == SharedMemoryLayout::Kind::kPadding) {
+      decl.CopyOnWrite()->buffer = GetPaddedBuffer(op->buffer, layout->group);
+    }
+    return std::move(decl);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    return RewriteAccess(Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op)));
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    return RewriteAccess(Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op)));
+  }
+
+  /*! \brief The layouts to apply, by the data variable of the buffers. */
+  std::unordered_map<const VarNode*, SharedMemoryLayout> layouts_;
+  /*! \brief The padded copies of the buffers. */
+  std::unordered_map<const BufferNode*, Buffer> padded_buffers_;
+};
+
+namespace transform {
+
+Pass InjectSharedMemorySwizzle() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    return SharedMemorySwizzler::Transform(std::move(f));
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSharedMemorySwizzle", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSharedMemorySwizzle")
+    .set_body_typed(InjectSharedMemorySwizzle);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
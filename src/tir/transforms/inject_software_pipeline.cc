@@ -997,7 +997,14 @@ class PipelineInjector : private StmtExprMutator {
  public:
   static Stmt Inject(const PrimFunc& func) {
     auto global_symbol = func->GetAttr<String>(tvm::attr::kGlobalSymbol);
-    PipelineInjector injector(global_symbol);
+    Optional<Target> target = func->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined()) {
+      target = Target::Current(/*allow_not_defined=*/true);
+    }
+    // CPUs have no asynchronous copies, their pipelines rely on the out-of-order execution of the
+    // producers of the next iteration and the consumers of the current one instead
+    bool support_async = !target.defined() || target.value()->GetTargetDeviceType() != kDLCPU;
+    PipelineInjector injector(global_symbol, support_async);
     for (const auto& kv : func->buffer_map) {
       const Buffer& buffer = kv.second;
       injector.buffer_data_to_buffer_.Set(buffer->data, buffer);
@@ -1007,7 +1014,8 @@ class PipelineInjector : private StmtExprMutator {
   }
 
  private:
-  explicit PipelineInjector(Optional<String> global_symbol) : global_symbol_(global_symbol) {}
+  explicit PipelineInjector(Optional<String> global_symbol, bool support_async)
+      : global_symbol_(global_symbol), support_async_(support_async) {}
 
   /*!
    * \brief Check the pipeline satisfies the following conditions:
@@ -1121,7 +1129,8 @@ class PipelineInjector : private StmtExprMutator {
         << ", but pipeline annotation is " << pipeline_orders << " with different size";
 
     std::unordered_set<int> pipeline_async_stages;
-    if (auto annot = op->annotations.Get(attr::software_pipeline_async_stages)) {
+    auto annot = op->annotations.Get(attr::software_pipeline_async_stages);
+    if (annot && support_async_) {
       for (auto s : Downcast<Array<Integer>>(annot)) {
         pipeline_async_stages.insert(s->value);
       }
@@ -1220,6 +1229,8 @@ class PipelineInjector : private StmtExprMutator {
   std::unordered_map<const VarNode*, FragmentInfo> fragment_info_;
   std::unordered_set<Buffer, ObjectPtrHash, ObjectPtrEqual> double_buffers;
   Optional<String> global_symbol_;
+  /*! \brief Whether the asynchronous stages are supported, they are synchronous otherwise. */
+  bool support_async_;
 };
 
 }  // namespace software_pipeline
@@ -0,0 +1,220 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Inject software prefetches for the streaming accesses of the innermost loops.
+ *
+ * An access streams through memory when its flattened index is linear in the loop variable, with
+ * a constant step of at most kMaxStreamStepBytes. The element `distance` bytes ahead of each
+ * stream is prefetched at the beginning of every iteration, e.g. with a distance of 64 bytes:
+ *
+ * Before:
+ * for i in range(n):
+ *     B[i] = A[i * 2] + 1.0
+ *
+ * After:
+ * for i in range(n):
+ *     T.prefetch(T.address_of(A[i * 2 + 16]), 0, 3, 1)
+ *     T.prefetch(T.address_of(B[i + 16]), 1, 3, 1)
+ *     B[i] = A[i * 2] + 1.0
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <cstdlib>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The largest step per iteration of an access that is prefetched. */
+constexpr int64_t kMaxStreamStepBytes = 256;
+/*! \brief The accesses to a stream within a cache line share their prefetch. */
+constexpr int64_t kCacheLineBytes = 64;
+
+class SoftwarePrefetchInjector : public StmtMutator {
+ public:
+  explicit SoftwarePrefetchInjector(int64_t distance, bool enabled)
+      : distance_(distance), enabled_(enabled) {}
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key != attr::pragma_software_prefetch_distance) {
+      return StmtMutator::VisitStmt_(op);
+    }
+    const auto* distance = op->value.as<IntImmNode>();
+    ICHECK(distance) << "ValueError: " << op->attr_key << " must be a constant integer, but got "
+                     << op->value;
+    int64_t outer_distance = distance_;
+    distance_ = distance->value;
+    Stmt body = this->VisitStmt(op->body);
+    distance_ = outer_distance;
+    return body;
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    has_inner_loop_ = false;
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    bool is_innermost = !has_inner_loop_;
+    has_inner_loop_ = true;
+    if (!enabled_ || !is_innermost || distance_ <= 0 || op->kind != ForKind::kSerial) {
+      return stmt;
+    }
+    For loop = Downcast<For>(stmt);
+    Array<Stmt> seq = MakePrefetches(loop);
+    if (seq.empty()) {
+      return stmt;
+    }
+    seq.push_back(loop->body);
+    loop.CopyOnWrite()->body = SeqStmt(seq);
+    return std::move(loop);
+  }
+
+ private:
+  /*! \brief The accesses to a buffer advancing by the same step in each iteration. */
+  struct Stream {
+    /*! \brief The buffer accessed. */
+    Buffer buffer;
+    /*! \brief The flattened index of the first access. */
+    PrimExpr index;
+    /*! \brief The number of elements advanced in each iteration. */
+    int64_t step;
+    /*! \brief Whether the stream is written. */
+    bool is_write;
+  };
+
+  /*! \brief Make the prefetches of the streams of an innermost loop. */
+  Array<Stmt> MakePrefetches(const For& loop) {
+    // The variables defined in the body cannot be used before it
+    std::unordered_set<const VarNode*> body_vars;
+    PostOrderVisit(loop->body, [&](const ObjectRef& obj) {
+      if (const auto* let = obj.as<LetStmtNode>()) {
+        body_vars.insert(let->var.get());
+      } else if (const auto* let = obj.as<LetNode>()) {
+        body_vars.insert(let->var.get());
+      } else if (const auto* alloc = obj.as<AllocateNode>()) {
+        body_vars.insert(alloc->buffer_var.get());
+      }
+    });
+    auto f_uses_body_var = [&](const PrimExpr& expr) {
+      return UsesVar(expr, [&](const VarNode* var) { return body_vars.count(var) > 0; });
+    };
+    std::vector<Stream> streams;
+    auto f_add_access = [&](const Buffer& buffer, const Array<PrimExpr>& indices, bool is_write) {
+      if (indices.size() != 1 || body_vars.count(buffer->data.get())) {
+        return;
+      }
+      PrimExpr index = indices[0];
+      if (const auto* ramp = index.as<RampNode>()) {
+        index = ramp->base;
+      }
+      if (!index.dtype().is_scalar() || f_uses_body_var(index)) {
+        return;
+      }
+      Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, {loop->loop_var});
+      if (coeffs.empty()) {
+        return;
+      }
+      const auto* step = coeffs[0].as<IntImmNode>();
+      int64_t elem_bytes = buffer->dtype.bytes();
+      if (step == nullptr || step->value == 0 ||
+          std::abs(step->value) * elem_bytes > kMaxStreamStepBytes) {
+        return;
+      }
+      for (Stream& stream : streams) {
+        if (stream.buffer->data.same_as(buffer->data) && stream.step == step->value) {
+          const auto* offset = analyzer_.Simplify(index - stream.index).as<IntImmNode>();
+          if (offset != nullptr && std::abs(offset->value) * elem_bytes < kCacheLineBytes) {
+            stream.is_write = stream.is_write || is_write;
+            return;
+          }
+        }
+      }
+      streams.push_back(Stream{buffer, index, step->value, is_write});
+    };
+    PostOrderVisit(loop->body, [&](const ObjectRef& obj) {
+      if (const auto* load = obj.as<BufferLoadNode>()) {
+        f_add_access(load->buffer, load->indices, false);
+      } else if (const auto* store = obj.as<BufferStoreNode>()) {
+        f_add_access(store->buffer, store->indices, true);
+      }
+    });
+    Array<Stmt> prefetches;
+    const auto* extent = loop->extent.as<IntImmNode>();
+    for (const Stream& stream : streams) {
+      int64_t step_bytes = std::abs(stream.step) * stream.buffer->dtype.bytes();
+      int64_t lookahead = (distance_ + step_bytes - 1) / step_bytes;
+      // The prefetches would only land after the loop
+      if (extent != nullptr && extent->value <= lookahead) {
+        continue;
+      }
+      PrimExpr ahead = loop->loop_var + make_const(loop->loop_var.dtype(), lookahead);
+      PrimExpr index = analyzer_.Simplify(Substitute(stream.index, {{loop->loop_var, ahead}}));
+      PrimExpr address =
+          Call(DataType::Handle(), builtin::address_of(), {BufferLoad(stream.buffer, {index})});
+      prefetches.push_back(Evaluate(Call(stream.buffer->dtype, builtin::prefetch(),
+                                         {address, stream.is_write ? 1 : 0, 3, 1})));
+    }
+    return prefetches;
+  }
+
+  /*! \brief The lookahead distance in bytes in the current scope. */
+  int64_t distance_;
+  /*! \brief Whether the prefetches are injected for the target. */
+  bool enabled_;
+  /*! \brief Whether the loop being visited contains a loop. */
+  bool has_inner_loop_{false};
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.software_prefetch_distance", Integer);
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    int64_t distance =
+        ctx->GetConfig<Integer>("tir.software_prefetch_distance", Integer(0)).value()->value;
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined()) {
+      target = Target::Current(/*allow_not_defined=*/true);
+    }
+    // The prefetches are only lowered by the CPU backend, the pragmas are removed regardless
+    bool enabled = target.defined() && target.value()->kind->name == "llvm";
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePrefetchInjector(distance, enabled)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePrefetch").set_body_typed(InjectSoftwarePrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,416 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_warp_specialization.cc
+ * \brief Lower the software pipelines running their producers and consumers in separate warps.
+ *
+ * For a pipelined loop annotated with `software_pipeline_warp_specialize = S`, whose statements of
+ * stage 0 (the producers) write into buffers of shared memory read by the statements of stage 1
+ * (the consumers), the N threads of the enclosing threadIdx.x loop are doubled into
+ *
+ *   create_barriers(2 * S)
+ *   if threadIdx.x == 0:
+ *     init full[s] and empty[s] with N arrivals, for s in [0, S)
+ *   sync
+ *   if threadIdx.x < N:
+ *     <the original body, the loop being replaced by>
+ *     for k:
+ *       wait(full[k % S], parity=(k / S) % 2)
+ *       consumers, reading version k % S
+ *       arrive(empty[k % S])
+ *   else:
+ *     <the enclosing loops of the loop, threadIdx.x being shifted by N>
+ *     for k:
+ *       if k >= S: wait(empty[k % S], parity=(k / S + 1) % 2)
+ *       async: producers, writing version k % S
+ *       cp_async_barrier(full[k % S]); arrive(full[k % S])
+ *
+ * The producers never join the consumers again, so the kernel is marked as hand threaded and
+ * ThreadSync does not insert any __syncthreads into it.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "./ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+namespace warp_specialization {
+
+using BufferSet = std::unordered_set<Buffer, ObjectPtrHash, ObjectPtrEqual>;
+
+/*! \brief Rewrite the accesses to the staged buffers into the accesses to one of their versions. */
+class StagedBufferRewriter : public StmtExprMutator {
+ public:
+  /*!
+   * \param buffer_remap The map from the staged buffers to their versioned buffers.
+   * \param version The version accessed, or NullOpt to access all the versions in block regions.
+   */
+  StagedBufferRewriter(const Map<Buffer, Buffer>& buffer_remap, Optional<PrimExpr> version)
+      : buffer_remap_(buffer_remap), version_(std::move(version)) {}
+
+ private:
+  BufferRegion RewriteRegion(const BufferRegion& region) const {
+    auto it = buffer_remap_.find(region->buffer);
+    if (it == buffer_remap_.end()) {
+      return region;
+    }
+    const Buffer& new_buffer = (*it).second;
+    Region new_region = region->region;
+    new_region.insert(new_region.begin(), version_.defined()
+                                              ? Range::FromMinExtent(version_.value(), 1)
+                                              : Range::FromMinExtent(0, new_buffer->shape[0]));
+    return BufferRegion(new_buffer, new_region);
+  }
+
+  Stmt VisitStmt_(const BlockNode* op) final {
+    Block block = Downcast<Block>(StmtExprMutator::VisitStmt_(op));
+    BlockNode* n = block.CopyOnWrite();
+    n->reads.MutateByApply([this](const BufferRegion& region) { return RewriteRegion(region); });
+    n->writes.MutateByApply([this](const BufferRegion& region) { return RewriteRegion(region); });
+    return std::move(block);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    BufferStore store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
+    auto it = buffer_remap_.find(store->buffer);
+    if (it == buffer_remap_.end()) {
+      return std::move(store);
+    }
+    ICHECK(version_.defined());
+    BufferStoreNode* n = store.CopyOnWrite();
+    n->buffer = (*it).second;
+    n->indices.insert(n->indices.begin(), version_.value());
+    return std::move(store);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    BufferLoad load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
+    auto it = buffer_remap_.find(load->buffer);
+    if (it == buffer_remap_.end()) {
+      return std::move(load);
+    }
+    ICHECK(version_.defined());
+    BufferLoadNode* n = load.CopyOnWrite();
+    n->buffer = (*it).second;
+    n->indices.insert(n->indices.begin(), version_.value());
+    return std::move(load);
+  }
+
+  const Map<Buffer, Buffer>& buffer_remap_;
+  Optional<PrimExpr> version_;
+};
+
+/*! \brief Replace a loop by another statement. */
+class LoopReplacer : public StmtMutator {
+ public:
+  static Stmt Replace(const Stmt& stmt, const ForNode* loop, const Stmt& replacement) {
+    LoopReplacer replacer(loop, replacement);
+    return replacer(stmt);
+  }
+
+ private:
+  LoopReplacer(const ForNode* loop, const Stmt& replacement)
+      : loop_(loop), replacement_(replacement) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    return op == loop_ ? replacement_ : StmtMutator::VisitStmt_(op);
+  }
+
+  const ForNode* loop_;
+  const Stmt& replacement_;
+};
+
+/*! \brief Check whether a statement contains a loop. */
+bool ContainsLoop(const Stmt& stmt, const ForNode* loop) {
+  bool found = false;
+  PostOrderVisit(stmt, [&](const ObjectRef& obj) { found = found || obj.get() == loop; });
+  return found;
+}
+
+/*!
+ * \brief Extract the statements enclosing a loop, dropping every statement besides them.
+ * \param stmt The statement containing the loop.
+ * \param loop The loop.
+ * \param replacement The statement replacing the loop.
+ * \return The enclosing statements around the replacement.
+ */
+Stmt ExtractEnclosingStmts(const Stmt& stmt, const ForNode* loop, const Stmt& replacement) {
+  if (stmt.get() == loop) {
+    return replacement;
+  }
+  auto f_extract = [&](const Stmt& body) { return ExtractEnclosingStmts(body, loop, replacement); };
+  if (const auto* seq = stmt.as<SeqStmtNode>()) {
+    for (const Stmt& child : seq->seq) {
+      if (ContainsLoop(child, loop)) {
+        return f_extract(child);
+      }
+    }
+  } else if (const auto* for_node = stmt.as<ForNode>()) {
+    For new_for = GetRef<For>(for_node);
+    new_for.CopyOnWrite()->body = f_extract(for_node->body);
+    return std::move(new_for);
+  } else if (const auto* realize = stmt.as<BlockRealizeNode>()) {
+    // The enclosing blocks only keep their control flow, the producers use no other buffer
+    Block block = realize->block;
+    BlockNode* n = block.CopyOnWrite();
+    n->body = f_extract(n->body);
+    n->alloc_buffers.clear();
+    n->reads.clear();
+    n->writes.clear();
+    return BlockRealize(realize->iter_values, realize->predicate, block);
+  } else if (const auto* let = stmt.as<LetStmtNode>()) {
+    return LetStmt(let->var, let->value, f_extract(let->body));
+  } else if (const auto* attr = stmt.as<AttrStmtNode>()) {
+    return AttrStmt(attr->node, attr->attr_key, attr->value, f_extract(attr->body));
+  } else if (const auto* if_then_else = stmt.as<IfThenElseNode>()) {
+    if (ContainsLoop(if_then_else->then_case, loop)) {
+      return IfThenElse(if_then_else->condition, f_extract(if_then_else->then_case));
+    }
+    return IfThenElse(logical_not(if_then_else->condition),
+                      f_extract(if_then_else->else_case.value()));
+  }
+  LOG(FATAL) << "ValueError: The warp specialized pipeline cannot be nested in "
+             << stmt->GetTypeKey();
+  throw;
+}
+
+/*! \brief Collect the buffers read and written by a statement. */
+void CollectAccesses(const Stmt& stmt, BufferSet* reads, BufferSet* writes) {
+  PostOrderVisit(stmt, [&](const ObjectRef& obj) {
+    if (const auto* load = obj.as<BufferLoadNode>()) {
+      reads->insert(load->buffer);
+    } else if (const auto* store = obj.as<BufferStoreNode>()) {
+      writes->insert(store->buffer);
+    } else if (const auto* call = obj.as<CallNode>()) {
+      CHECK(!call->op.same_as(builtin::tvm_access_ptr()))
+          << "ValueError: The opaque accesses in warp specialized pipelines are not supported";
+    }
+  });
+}
+
+class WarpSpecializationInjector : public StmtMutator {
+ private:
+  Stmt VisitStmt_(const ForNode* op) final {
+    if (op->kind == ForKind::kThreadBinding && op->thread_binding.defined() &&
+        op->thread_binding.value()->thread_tag == "threadIdx.x") {
+      std::vector<const ForNode*> loops;
+      PostOrderVisit(op->body, [&](const ObjectRef& obj) {
+        if (const auto* loop = obj.as<ForNode>()) {
+          if (loop->annotations.count(attr::software_pipeline_warp_specialize)) {
+            loops.push_back(loop);
+          }
+        }
+      });
+      if (!loops.empty()) {
+        CHECK_EQ(loops.size(), 1)
+            << "ValueError: A kernel can only have one warp specialized pipeline";
+        return Specialize(op, loops[0]);
+      }
+    }
+    CHECK(!op->annotations.count(attr::software_pipeline_warp_specialize))
+        << "ValueError: The warp specialized pipeline must be nested in a threadIdx.x loop";
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  Stmt Specialize(const ForNode* thread_loop, const ForNode* loop) {
+    // Step 1. Check the annotations and split the pipeline into the producers and consumers
+    const auto* num_threads = thread_loop->extent.as<IntImmNode>();
+    CHECK(num_threads != nullptr && is_zero(thread_loop->min))
+        << "ValueError: The warp specialized pipeline needs a constant number of threads";
+    int num_versions =
+        Downcast<Integer>(loop->annotations.at(attr::software_pipeline_warp_specialize))->value;
+    CHECK_GE(num_versions, 1) << "ValueError: The warp specialized pipeline needs a version";
+    CHECK(loop->annotations.count(attr::software_pipeline_stage))
+        << "ValueError: Stage of the software pipeline is not defined.";
+    Array<Integer> stages =
+        Downcast<Array<Integer>>(loop->annotations.at(attr::software_pipeline_stage));
+    Stmt body = loop->body;
+    Array<Buffer> allocs;
+    if (const auto* realize = body.as<BlockRealizeNode>()) {
+      ICHECK(is_one(realize->predicate));
+      allocs = realize->block->alloc_buffers;
+      body = realize->block->body;
+    }
+    const auto* seq = body.as<SeqStmtNode>();
+    CHECK(seq != nullptr && seq->seq.size() == stages.size())
+        << "ValueError: The body of the software pipeline should be a SeqStmt of " << stages.size()
+        << " statements";
+    Array<Stmt> producers, consumers;
+    for (int i = 0, n = stages.size(); i < n; ++i) {
+      CHECK(stages[i]->value == 0 || stages[i]->value == 1)
+          << "ValueError: The warp specialized pipeline only has the stages 0 and 1, but got "
+          << stages[i];
+      (stages[i]->value == 0 ? producers : consumers).push_back(seq->seq[i]);
+    }
+    CHECK(!producers.empty() && !consumers.empty())
+        << "ValueError: The warp specialized pipeline needs both producers and consumers";
+    // Step 2. Version the buffers handed over from the producers to the consumers
+    BufferSet producer_reads, producer_writes, consumer_reads, consumer_writes;
+    for (const Stmt& stmt : producers) CollectAccesses(stmt, &producer_reads, &producer_writes);
+    for (const Stmt& stmt : consumers) CollectAccesses(stmt, &consumer_reads, &consumer_writes);
+    Map<Buffer, Buffer> buffer_remap;
+    Array<Buffer> consumer_allocs;
+    for (const Buffer& buffer : allocs) {
+      if (!producer_writes.count(buffer)) {
+        consumer_allocs.push_back(buffer);
+        continue;
+      }
+      CHECK(!consumer_writes.count(buffer) && std::string(buffer.scope()).rfind("shared", 0) == 0)
+          << "ValueError: The buffer " << buffer->name
+          << " handed over to the consumers must be in shared memory and read only by them";
+      ObjectPtr<BufferNode> new_buffer = make_object<BufferNode>(*buffer.get());
+      new_buffer->shape.insert(new_buffer->shape.begin(), PrimExpr(num_versions));
+      if (!new_buffer->strides.empty()) {
+        new_buffer->strides.insert(new_buffer->strides.begin(),
+                                   new_buffer->strides[0] * new_buffer->shape[1]);
+      }
+      buffer_remap.Set(buffer, Buffer(new_buffer));
+    }
+    for (const Buffer& buffer : producer_writes) {
+      CHECK(buffer_remap.count(buffer))
+          << "ValueError: The producers can only write the buffers allocated in the pipeline, "
+          << "but " << buffer->name << " is not";
+    }
+    for (const Buffer& buffer : producer_reads) {
+      CHECK(!consumer_writes.count(buffer))
+          << "ValueError: The producers cannot read the buffer " << buffer->name
+          << " written by the consumers";
+    }
+    // Step 3. Make the loops of both sides, handing each version over with a pair of barriers
+    Var thread = thread_loop->loop_var;
+    DataType dtype = loop->loop_var.dtype();
+    PrimExpr iter = loop->loop_var - loop->min;
+    PrimExpr version = floormod(iter, num_versions);
+    PrimExpr phase = floormod(floordiv(iter, num_versions), 2);
+    PrimExpr full = cast(DataType::Int(32), version);
+    PrimExpr empty = cast(DataType::Int(32), version + num_versions);
+    auto f_call = [](const Op& op, Array<PrimExpr> args) {
+      return Evaluate(Call(DataType::Void(), op, std::move(args)));
+    };
+    Map<String, ObjectRef> annotations;
+    for (const auto& kv : loop->annotations) {
+      if (kv.first != attr::software_pipeline_stage && kv.first != attr::software_pipeline_order &&
+          kv.first != attr::software_pipeline_async_stages &&
+          kv.first != attr::software_pipeline_warp_specialize) {
+        annotations.Set(kv.first, kv.second);
+      }
+    }
+    auto f_make_loop = [&](const Array<Stmt>& stmts, const Array<Buffer>& loop_allocs) {
+      Stmt body = StagedBufferRewriter(buffer_remap, version)(SeqStmt::Flatten(stmts));
+      if (!loop_allocs.empty()) {
+        body = BlockRealize({}, Bool(true),
+                            Block({}, {}, {}, "", body, NullOpt, /*alloc_buffers=*/loop_allocs));
+      }
+      For new_loop = GetRef<For>(loop);
+      For::ContainerType* n = new_loop.CopyOnWrite();
+      n->body = body;
+      n->annotations = annotations;
+      return new_loop;
+    };
+    For consumer_loop = f_make_loop(
+        {
+            f_call(builtin::ptx_wait_barrier(), {full, cast(DataType::Int(32), phase)}),
+            SeqStmt::Flatten(consumers),
+            f_call(builtin::ptx_arrive_barrier(), {empty}),
+        },
+        consumer_allocs);
+    // The producers wait for the consumers to release the version, except in the first round
+    PrimExpr release_phase = cast(DataType::Int(32), floormod(phase + 1, 2));
+    Stmt producer_wait = IfThenElse(iter >= make_const(dtype, num_versions),
+                                    f_call(builtin::ptx_wait_barrier(), {empty, release_phase}));
+    Stmt produce =
+        AttrStmt(make_zero(DataType::Int(32)), attr::async_scope, 1, SeqStmt::Flatten(producers));
+    For producer_loop = f_make_loop(
+        {
+            producer_wait,
+            produce,
+            f_call(builtin::ptx_cp_async_barrier(), {full}),
+            f_call(builtin::ptx_arrive_barrier(), {full}),
+        },
+        {});
+    // Step 4. Split the threads, the producers only running the loops enclosing the pipeline
+    PrimExpr n = make_const(thread->dtype, num_threads->value);
+    Stmt consumer_body = LoopReplacer::Replace(thread_loop->body, loop, consumer_loop);
+    Stmt producer_body = ExtractEnclosingStmts(thread_loop->body, loop, producer_loop);
+    producer_body = Substitute(producer_body, {{thread, thread - n}});
+    consumer_body = StagedBufferRewriter(buffer_remap, NullOpt)(consumer_body);
+    Array<Stmt> init;
+    PrimExpr thread_count = make_const(DataType::Int(32), num_threads->value);
+    for (int i = 0; i < num_versions; ++i) {
+      // The full barriers wait for the producers, and the empty barriers for the consumers
+      init.push_back(f_call(builtin::ptx_init_barrier_thread_count(), {i, thread_count}));
+      init.push_back(
+          f_call(builtin::ptx_init_barrier_thread_count(), {i + num_versions, thread_count}));
+    }
+    Stmt new_body = SeqStmt({
+        f_call(builtin::create_barriers(), {2 * num_versions}),
+        IfThenElse(thread == make_zero(thread->dtype), SeqStmt::Flatten(init)),
+        f_call(builtin::tvm_storage_sync(), {StringImm("shared")}),
+        IfThenElse(thread < n, consumer_body, producer_body),
+    });
+    new_body = AttrStmt(make_zero(DataType::Int(32)), attr::hand_threaded, 1, new_body);
+    Array<Buffer> versioned_allocs;
+    for (const Buffer& buffer : allocs) {
+      if (Optional<Buffer> new_buffer = buffer_remap.Get(buffer)) {
+        versioned_allocs.push_back(new_buffer.value());
+      }
+    }
+    new_body = BlockRealize({}, Bool(true),
+                            Block({}, {}, {}, "", new_body, NullOpt, versioned_allocs));
+    For new_thread_loop = GetRef<For>(thread_loop);
+    For::ContainerType* fn = new_thread_loop.CopyOnWrite();
+    fn->extent = make_const(thread_loop->extent.dtype(), num_threads->value * 2);
+    fn->body = new_body;
+    return std::move(new_thread_loop);
+  }
+};
+
+}  // namespace warp_specialization
+
+namespace transform {
+
+Pass InjectWarpSpecialization() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* fptr = f.CopyOnWrite();
+    fptr->body = warp_specialization::WarpSpecializationInjector()(std::move(fptr->body));
+    // The loops of the producers and the consumers share their loop variables
+    fptr->body = ConvertSSA(std::move(fptr->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectWarpSpecialization", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectWarpSpecialization")
+    .set_body_typed(InjectWarpSpecialization);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
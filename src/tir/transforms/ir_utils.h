@@ -363,6 +363,16 @@ std::pair<int32_t, int32_t> GetWmmaFragmentDimSize(const std::string& shape_str,
  */
 std::optional<bool> IsHostFunc(const PrimFunc& func);
 
+/*!
+ * \brief Substitute variables in the body of a function, updating the buffers that it declares
+ *  and the buffers of its signature as done by Specialize. The signature itself is unchanged, so
+ *  that the specialized body can be used within the original function.
+ * \param func The function to be specialized.
+ * \param var_map The values of the variables.
+ * \return The specialized body.
+ */
+Stmt SpecializeBody(const PrimFunc& func, const Map<Var, PrimExpr>& var_map);
+
 }  // namespace tir
 }  // namespace tvm
 #endif  // TVM_TIR_TRANSFORMS_IR_UTILS_H_
@@ -54,7 +54,12 @@ class AsyncDMALowerer : public arith::IRMutatorWithAnalyzer {
     std::optional<tvm::tir::MemCpyDetails> mem_copy = IdentifyMemCpy(GetRef<For>(loop), analyzer_);
     if (!mem_copy.has_value() || mem_copy->dest->region.size() != 1 ||
         mem_copy->source->region.size() != 1) {
-      return arith::IRMutatorWithAnalyzer::VisitStmt_(loop);
+      // A strided copy, e.g. a 2D tile of a larger buffer, is not contiguous as a whole but its
+      // inner loops may be. Those become one DMA per iteration of this loop.
+      loop_depth_++;
+      Stmt result = arith::IRMutatorWithAnalyzer::VisitStmt_(loop);
+      loop_depth_--;
+      return result;
     }
 
     // now that we are about to perform the `copy` transform
@@ -62,6 +67,10 @@ class AsyncDMALowerer : public arith::IRMutatorWithAnalyzer {
     // and, increment the number of DMA copies in the group
     queue_ids_.insert(async_queue_id_.value());
     dmas_in_group_++;
+    // a copy issued from a loop runs several times, which must complete as one group
+    if (loop_depth_ > 0) {
+      dmas_in_group_++;
+    }
 
     tvm::PrimExpr src_min = mem_copy->source->region[0]->min;
     tvm::PrimExpr dst_min = mem_copy->dest->region[0]->min;
@@ -155,6 +164,8 @@ class AsyncDMALowerer : public arith::IRMutatorWithAnalyzer {
 
  private:
   int dmas_in_group_ = 0;
+  // number of enclosing loops inside the current async_commit_queue_scope
+  int loop_depth_ = 0;
   std::set<int> queue_ids_;
   std::optional<int> async_queue_id_ = std::nullopt;
   bool dma_bypass_cache_;
@@ -64,6 +64,20 @@ bool IsBoundToThreadIdx(const ForNode* loop) {
   return scope.rank == 1 && scope.dim_index >= 0;
 }
 
+/*!
+ * \brief Checks if a loop is bound to blockIdx.x/y/z
+ * \brief loop The loop to be checked
+ * \return True if the loop is bound to blockIdx.x/y/z
+ */
+bool IsBoundToBlockIdx(const ForNode* loop) {
+  if (!loop->thread_binding.defined()) {
+    return false;
+  }
+  runtime::ThreadScope scope =
+      runtime::ThreadScope::Create(loop->thread_binding.value()->thread_tag);
+  return scope.rank == 0 && scope.dim_index >= 0;
+}
+
 /*!
  * \brief Check the dominant property of a block:
  * the block is the only writer of its output, dominating the reader of its output buffers
@@ -290,6 +304,8 @@ class InThreadReducerMaker : private StmtMutator {
  * \param reducer The reduction function
  * \param combiner_rhs The RHS values of the combiner
  * \param reduction_loops The reduction loops
+ * \param cluster_loops The reduction loops bound to blockIdx, reduced across the thread blocks of
+ * a cluster
  */
 Stmt TransformReductionBlock(const BlockRealizeNode* realize,            //
                              const Optional<Array<Buffer>>& it_buffers,  //
@@ -298,7 +314,8 @@ Stmt TransformReductionBlock(const BlockRealizeNode* realize,            //
                              const Array<PrimExpr>& old_wb_indices,      //
                              const CommReducer& reducer,                 //
                              const Array<PrimExpr>& combiner_rhs,        //
-                             const std::vector<const ForNode*>& reduction_loops) {
+                             const std::vector<const ForNode*>& reduction_loops,
+                             const std::vector<const ForNode*>& cluster_loops) {
   int n_buffers = wb_buffers.size();
   const BlockNode* block = realize->block.get();
 
@@ -390,6 +407,9 @@ Stmt TransformReductionBlock(const BlockRealizeNode* realize,            //
         parameters.push_back(reduction_loop->loop_var);
       }
     }
+    for (const ForNode* cluster_loop : cluster_loops) {
+      parameters.push_back(cluster_loop->loop_var);
+    }
     // Step 3.2. Create the block and the block-realize.
     Array<IterVar> iter_vars{nullptr};
     Array<PrimExpr> bindings{nullptr};
@@ -471,6 +491,9 @@ Stmt TransformReductionBlock(const BlockRealizeNode* realize,            //
     for (const ForNode* reduction_loop : reduction_loops) {
       reduction_loop_vars.insert(reduction_loop->loop_var.get());
     }
+    for (const ForNode* cluster_loop : cluster_loops) {
+      reduction_loop_vars.insert(cluster_loop->loop_var.get());
+    }
     PostOrderVisit(realize->predicate, [&wb_predicate, &reduction_loop_vars](const ObjectRef& obj) {
       if (const auto* and_node = obj.as<AndNode>()) {
         Array<PrimExpr> sub_exprs = {and_node->a, and_node->b};
@@ -502,6 +525,13 @@ Stmt TransformReductionBlock(const BlockRealizeNode* realize,            //
         }
       }
     }
+    // All the blocks of the cluster get the reduction result, and only one of them needs to write
+    // it to global memory.
+    if (wb_buffers[0].scope() == "global") {
+      for (const ForNode* loop : cluster_loops) {
+        wb_predicate = wb_predicate && (loop->loop_var == IntImm(loop->loop_var->dtype, 0));
+      }
+    }
 
     stmts.push_back(BlockRealize(
         /*iter_values=*/std::move(bindings),
@@ -791,10 +821,57 @@ class CrossThreadReductionTransformer : public StmtMutator {
     return std::move(new_block);
   }
 
+  /*!
+   * \brief Given that the input block has reduction-related loops bound to blockIdx, check if they
+   * can be reduced across the thread blocks of a cluster
+   * \param block The block to be checked
+   * \param cluster_loops The reduction loops bound to blockIdx
+   * \param reduction_loops The other reduction loops above the block
+   */
+  void CheckCanApplyClusterReduction(const BlockNode* block,
+                                     const std::vector<const ForNode*>& cluster_loops,
+                                     const std::vector<const ForNode*>& reduction_loops) const {
+    // Condition 1. The thread blocks take part in the reduction, so part of the reduction should be
+    // done by the loops under each block.
+    CHECK(!reduction_loops.empty())
+        << "ValueError: Reduction across thread blocks requires some of the reduction-related "
+           "loops to be under the thread blocks. However, all the reduction-related loops of block "
+        << block->name_hint << " are bound to blockIdx, which violates the condition.";
+    // Condition 2. The blocks bound to the loops should fit in a cluster.
+    int64_t cluster_size = 1;
+    for (const ForNode* loop : cluster_loops) {
+      const auto* extent = loop->extent.as<IntImmNode>();
+      CHECK(extent) << "ValueError: Reduction across thread blocks requires the reduction-related "
+                       "loops bound to blockIdx to have constant extents. However, loop "
+                    << loop->loop_var->name_hint << " violates the condition.";
+      cluster_size *= extent->value;
+    }
+    CHECK_LE(cluster_size, kMaxClusterSize)
+        << "ValueError: Reduction across thread blocks requires the blocks to fit in a thread "
+           "block cluster of at most "
+        << kMaxClusterSize << " blocks. However, block " << block->name_hint
+        << " is reduced across " << cluster_size << " blocks, which violates the condition.";
+  }
+
   void MakeCrossThreadReduction(const BlockRealizeNode* realize,
-                                const std::vector<const ForNode*> reduction_loops) {
+                                const std::vector<const ForNode*> related_loops) {
     const BlockNode* block = realize->block.get();
 
+    // Step 0. The reduction-related loops bound to blockIdx are reduced across the thread blocks of
+    // a cluster, while the others are reduced within each block.
+    std::vector<const ForNode*> reduction_loops;
+    std::vector<const ForNode*> cluster_loops;
+    for (const ForNode* loop : related_loops) {
+      if (IsBoundToBlockIdx(loop)) {
+        cluster_loops.push_back(loop);
+      } else {
+        reduction_loops.push_back(loop);
+      }
+    }
+    if (!cluster_loops.empty()) {
+      CheckCanApplyClusterReduction(block, cluster_loops, reduction_loops);
+    }
+
     // Step 1. Check whether cross-thread reduction can be applied. If no, throw an exception on
     // which condition the block violates.
     int n_bound_reduction_loops = 0;
@@ -823,7 +900,7 @@ class CrossThreadReductionTransformer : public StmtMutator {
     // Step 4. Transform.
     loop2new_stmt_[reduction_loops[0]] =
         TransformReductionBlock(realize, it_buffers, ct_buffers, reduction_buffers, wb_indices,
-                                reducer, combiner_rhs, reduction_loops);
+                                reducer, combiner_rhs, reduction_loops, cluster_loops);
 
     // Step 5. Record the reduction thread dims for the write-back buffers.
     // The information is used for consumer block broadcasting detection.
@@ -904,6 +981,9 @@ class CrossThreadReductionTransformer : public StmtMutator {
   }
 
  private:
+  // The portable maximum number of thread blocks in a cluster.
+  static constexpr int64_t kMaxClusterSize = 8;
+
   bool has_cross_thread_reduction_ = false;
   std::vector<const StmtNode*> statement_stack_;
   std::vector<const ForNode*> loop_stack_;
@@ -43,7 +43,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   explicit ThreadAllreduceBuilder(const TargetNode* target)
       : target_(target),
         warp_size_(target->GetAttr<Integer>("thread_warp_size", 1).value().IntValue()),
-        max_num_threads_(target->GetAttr<Integer>("max_num_threads", -1).value().IntValue()) {}
+        max_num_threads_(target->GetAttr<Integer>("max_num_threads", -1).value().IntValue()),
+        support_cluster_(SupportCluster(target)) {}
 
   Stmt VisitStmt_(const AttrStmtNode* op) final {
     if (op->attr_key == attr::thread_extent) {
@@ -198,7 +199,7 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     }
 
     size_t nmatch = 0;
-    std::vector<ThreadEntry> vred, vpar;
+    std::vector<ThreadEntry> vred, vpar, vcluster;
     for (const AttrStmtNode* attr : thread_extents_) {
       ThreadEntry e;
       IterVar iv = Downcast<IterVar>(attr->node);
@@ -206,7 +207,16 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       e.iv = iv;
       ICHECK_LE(e.scope.rank, 1);
       ICHECK_GE(e.scope.dim_index, 0) << "vthread do not work with cross thread reduction";
-      if (e.scope.rank == 1) {
+      if (e.scope.rank == 0 && reduce_set.count(iv->var.get())) {
+        // blockIdx in the reduce set are reduced across the blocks of a thread block cluster
+        const auto* ptr = attr->value.as<IntImmNode>();
+        CHECK(ptr) << "ValueError: Need constant extent for the cluster reduce index " << iv;
+        e.extent = static_cast<int>(ptr->value);
+        ++nmatch;
+        if (e.extent > 1) {
+          vcluster.push_back(e);
+        }
+      } else if (e.scope.rank == 1) {
         const auto* ptr = attr->value.as<IntImmNode>();
         ICHECK(ptr) << "Need constant extent for reduce set " << iv;
         e.extent = static_cast<int>(ptr->value);
@@ -226,6 +236,19 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     ICHECK_EQ(nmatch, reduce_set.size()) << "Not all reduce index are presented in the context";
     std::sort(vred.begin(), vred.end());
     std::sort(vpar.begin(), vpar.end());
+    std::sort(vcluster.begin(), vcluster.end());
+    if (!vcluster.empty()) {
+      int cluster_extent = 1;
+      for (const ThreadEntry& e : vcluster) {
+        cluster_extent *= e.extent;
+      }
+      CHECK(support_cluster_) << "ValueError: Reduction across blockIdx requires thread block "
+                                 "clusters, which need a CUDA target of sm_90 or later, but got "
+                              << target_->str();
+      CHECK_LE(cluster_extent, kMaxClusterSize)
+          << "ValueError: Reduction across blockIdx spans " << cluster_extent
+          << " thread blocks, while a thread block cluster has at most " << kMaxClusterSize;
+    }
     // the size of each index.
     int reduce_extent, group_extent;
     PrimExpr reduce_index = FlattenThread(vred, &reduce_extent);
@@ -396,8 +419,15 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       if (reduce_extent == 1) {
         // special case, no reduction is needed.
         std::vector<Stmt> stores;
+        std::vector<BufferLoad> block_results;
         for (size_t i = 0; i < size; ++i) {
           stores.push_back(BufferStore(buffers[i], values[i], {0}));
+          block_results.push_back(BufferLoad(buffers[i], {0}));
+        }
+        if (!vcluster.empty()) {
+          // Only the blocks in the cluster are reduced.
+          stores.push_back(MakeClusterAllreduce(combiner, types, block_results, reduce_index,
+                                                group_index, group_extent, vcluster));
         }
         return SeqStmt::Flatten(stores);
       }
@@ -426,6 +456,16 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       }
     }
 
+    // Reduce the results of the blocks in the cluster in place.
+    if (!vcluster.empty()) {
+      std::vector<BufferLoad> block_results;
+      for (size_t i = 0; i < size; ++i) {
+        block_results.push_back(Downcast<BufferLoad>(load_remap_.at(buffers[i]->data.get())));
+      }
+      seq.push_back(MakeClusterAllreduce(combiner, types, block_results, reduce_index, group_index,
+                                         group_extent, vcluster));
+    }
+
     // Fix all local allocations as all statements are built.
     Stmt body = SeqStmt::Flatten(seq);
     for (Buffer buf : new_alloc_bufs) {
@@ -436,6 +476,101 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     return body;
   }
 
+  /*!
+   * \brief Reduce the results of the blocks of a thread block cluster, and store the reduced
+   *  values back to where the results of each block are.
+   *
+   * Each block stages its results in shared memory. After a cluster barrier, every thread reads
+   * the staged results of all the blocks through distributed shared memory and combines them in
+   * the order of the block ranks, so that all the blocks get the same values. The second barrier
+   * keeps the staging buffers alive until all the blocks are done reading them.
+   */
+  Stmt MakeClusterAllreduce(const CommReducerNode* combiner, const std::vector<DataType>& types,
+                            const std::vector<BufferLoad>& block_results,  //
+                            PrimExpr reduce_index, PrimExpr group_index, int group_extent,
+                            const std::vector<ThreadEntry>& vcluster) {
+    size_t size = types.size();
+    int cluster_extent = 1;
+    for (const ThreadEntry& e : vcluster) {
+      cluster_extent *= e.extent;
+    }
+    PrimExpr zero_index = make_const(reduce_index->dtype, 0);
+    std::vector<Stmt> seq;
+    std::vector<Buffer> staging_bufs, result_bufs;
+    // 1. Stage the results of the block for the other blocks.
+    std::vector<Stmt> stage;
+    for (size_t i = 0; i < size; ++i) {
+      staging_bufs.push_back(decl_buffer({make_const(group_index->dtype, group_extent)}, types[i],
+                                         "red_buf_cluster" + std::to_string(i), "shared"));
+      result_bufs.push_back(
+          decl_buffer({1}, types[i], "red_result_cluster" + std::to_string(i), "local"));
+      stage.push_back(BufferStore(staging_bufs[i], block_results[i], {group_index}));
+    }
+    if (is_zero(reduce_index)) {
+      seq.insert(seq.end(), stage.begin(), stage.end());
+    } else {
+      seq.push_back(IfThenElse(reduce_index == zero_index, SeqStmt::Flatten(stage)));
+    }
+    seq.push_back(SyncThread("cluster"));
+    // 2. Combine the results of all the blocks in the order of the block ranks.
+    for (int rank = 0; rank < cluster_extent; ++rank) {
+      Array<PrimExpr> lhs, rhs;
+      std::vector<PrimExpr> peer_results;
+      for (size_t i = 0; i < size; ++i) {
+        lhs.push_back(BufferLoad(result_bufs[i], {0}));
+        rhs.push_back(Var("red_peer" + std::to_string(i), types[i]));
+        peer_results.push_back(Call(types[i], builtin::ptx_ld_shared_cluster(),
+                                    {staging_bufs[i]->data, group_index, rank}));
+      }
+      Array<PrimExpr> ret = rank == 0 ? rhs : (*combiner)(lhs, rhs);
+      // Bind the combined values before updating any of the results they depend on.
+      std::vector<Var> ret_vars;
+      std::vector<Stmt> updates;
+      for (size_t i = 0; i < size; ++i) {
+        ret_vars.push_back(Var("red_ret" + std::to_string(i), types[i]));
+        updates.push_back(BufferStore(result_bufs[i], ret_vars[i], {0}));
+      }
+      Stmt body = SeqStmt::Flatten(updates);
+      for (size_t i = 0; i < size; ++i) {
+        body = LetStmt(ret_vars[i], ret[i], body);
+      }
+      for (size_t i = 0; i < size; ++i) {
+        body = LetStmt(Downcast<Var>(rhs[i]), peer_results[i], body);
+      }
+      seq.push_back(body);
+    }
+    seq.push_back(SyncThread("cluster"));
+    // 3. Write the reduced values back. The results shared by the threads of a group are written
+    //    by one of them.
+    std::vector<Stmt> local_stores, shared_stores;
+    for (size_t i = 0; i < size; ++i) {
+      Stmt store = BufferStore(block_results[i]->buffer, BufferLoad(result_bufs[i], {0}),
+                               block_results[i]->indices);
+      if (block_results[i]->buffer.scope() == "local") {
+        local_stores.push_back(store);
+      } else {
+        shared_stores.push_back(store);
+      }
+    }
+    seq.insert(seq.end(), local_stores.begin(), local_stores.end());
+    if (!shared_stores.empty()) {
+      seq.push_back(IfThenElse(reduce_index == zero_index, SeqStmt::Flatten(shared_stores)));
+      seq.push_back(SyncThread("shared"));
+    }
+
+    Stmt body = SeqStmt::Flatten(seq);
+    for (const std::vector<Buffer>* bufs : {&staging_bufs, &result_bufs}) {
+      for (const Buffer& buf : *bufs) {
+        body = DeclBuffer(buf, body);
+        body = Allocate(buf->data, buf->dtype, buf->shape, const_true(buf->dtype.lanes()), body);
+      }
+    }
+    for (auto rit = vcluster.rbegin(); rit != vcluster.rend(); ++rit) {
+      body = AttrStmt(rit->iv, attr::cluster_extent, rit->extent, body);
+    }
+    return body;
+  }
+
   std::pair<std::vector<PrimExpr>, std::vector<Buffer>> MakeWarpAllreduce(
       std::vector<PrimExpr> src_values,             //
       std::vector<DataType> dtypes,                 //
@@ -774,6 +909,18 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     }
   }
 
+  // Whether the target supports thread block clusters.
+  static bool SupportCluster(const TargetNode* target) {
+    if (target->kind->name != "cuda") {
+      return false;
+    }
+    std::string arch = target->GetAttr<String>("arch").value_or("");
+    return arch.rfind("sm_", 0) == 0 && std::stoi(arch.substr(3)) >= 90;
+  }
+
+  // The portable maximum number of thread blocks in a cluster.
+  static constexpr int kMaxClusterSize = 8;
+
   // The target.
   const TargetNode* target_ = nullptr;
 
@@ -783,6 +930,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   int max_num_threads_{-1};
   // A boolean indicating if the target supports warp-level masking.
   bool need_warp_shuffle_mask_;
+  // Whether blockIdx can be reduced across the blocks of a thread block cluster.
+  bool support_cluster_{false};
 
   // surrounding scope of thread extent.
   std::vector<const AttrStmtNode*> thread_extents_;
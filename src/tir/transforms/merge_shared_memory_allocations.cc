@@ -23,14 +23,23 @@
  * This pass merges multiple TIR-level dynamic or static shared memory allocations into one
  * allocation.
  */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/int_set.h>
+#include <tvm/arith/iter_affine_map.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <list>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../../runtime/thread_storage_scope.h"
 #include "../../support/arena.h"
@@ -245,6 +254,444 @@ class SharedMemLinearAccessPatternFinder final : public StmtExprVisitor {
   std::vector<StmtEntry> scope_;
 };
 
+/*!
+ * \brief Find the live interval of each shared memory buffer at the granularity of statements,
+ *  together with the block-wide barriers that separate them.
+ *
+ * A buffer is live from its first to its last access, widened to the whole of
+ *  - every nested scope that it is accessed in, as these run several times or not at all;
+ *  - every loop that it may carry a value across, e.g. the versions of a software pipelined
+ *    buffer, written in one iteration and read in a later one;
+ *  - the wait of every asynchronous copy into the buffer, which is still in flight until then.
+ */
+class SharedMemLiveIntervalFinder final : public StmtExprVisitor {
+ public:
+  explicit SharedMemLiveIntervalFinder(bool is_dynamic = true) : is_dynamic_(is_dynamic) {}
+
+  /*! \brief The kind of a nested scope. */
+  enum class ScopeKind : int {
+    kRoot = 0,
+    kLoop = 1,
+    kThread = 2,
+    kCondition = 3,
+  };
+  /*! \brief A nested scope, spanning the positions [begin, end] of the linear order. */
+  struct ScopeEntry {
+    ScopeKind kind;
+    int parent;
+    int64_t begin;
+    int64_t end;
+    // The iteration variable and its domain, undefined for loops other than For
+    Var var;
+    Range dom;
+  };
+  /*! \brief The kind of an access to a buffer. */
+  enum class AccessKind : int {
+    kRead = 0,
+    kWrite = 1,
+    kAsyncWrite = 2,
+    // An access through a pointer, whose region is unknown
+    kOpaque = 3,
+  };
+  /*! \brief An access to a buffer, in the linear order. */
+  struct AccessEntry {
+    AccessKind kind;
+    int64_t pos;
+    int scope;
+    // The flattened index of a read or a write
+    PrimExpr index;
+  };
+  /*! \brief A statement that all the threads of the block run at the same time. */
+  struct BarrierEntry {
+    int64_t pos;
+    int scope;
+  };
+  /*! \brief The live interval of a buffer. */
+  struct Interval {
+    int64_t begin;
+    int64_t end;
+  };
+
+  void operator()(const Stmt& stmt) {
+    scopes_.push_back({ScopeKind::kRoot, -1, Tick(), 0, Var(), Range()});
+    this->VisitStmt(stmt);
+    scopes_[0].end = Tick();
+  }
+
+  /*! \brief Whether the threads of the kernel are partitioned by hand, see attr::hand_threaded. */
+  bool IsHandThreaded() const { return hand_threaded_; }
+
+  /*!
+   * \brief Compute the live interval of a buffer.
+   * \param buffer The buffer variable.
+   * \return The live interval, or std::nullopt if the buffer is never accessed.
+   */
+  std::optional<Interval> GetInterval(const VarNode* buffer) const {
+    auto it = buffers_.find(buffer);
+    if (it == buffers_.end() || it->second.accesses.empty()) {
+      return std::nullopt;
+    }
+    const std::vector<AccessEntry>& accesses = it->second.accesses;
+    Interval interval{accesses.front().pos, accesses.back().pos};
+    for (const AccessEntry& access : accesses) {
+      interval.begin = std::min(interval.begin, access.pos);
+      interval.end = std::max(interval.end, access.pos);
+    }
+    int lca = accesses.front().scope;
+    while (!Encloses(lca, interval.begin) || !Encloses(lca, interval.end)) {
+      lca = scopes_[lca].parent;
+    }
+    // Step 1. Widen to the nested scopes of the accesses
+    for (const AccessEntry& access : accesses) {
+      int scope = access.scope;
+      if (scope == lca) continue;
+      while (scopes_[scope].parent != lca) {
+        scope = scopes_[scope].parent;
+      }
+      interval.begin = std::min(interval.begin, scopes_[scope].begin);
+      interval.end = std::max(interval.end, scopes_[scope].end);
+    }
+    // Step 2. Extend to the waits of the asynchronous copies
+    int64_t last_async = -1;
+    for (const AccessEntry& access : accesses) {
+      if (access.kind == AccessKind::kAsyncWrite) {
+        last_async = std::max(last_async, access.pos);
+      }
+    }
+    if (last_async != -1) {
+      auto f_waits = [&](const BarrierEntry& wait) {
+        return wait.pos > last_async && Encloses(wait.scope, last_async);
+      };
+      auto wait = std::find_if(async_waits_.begin(), async_waits_.end(), f_waits);
+      int64_t wait_pos = wait != async_waits_.end() ? wait->pos : scopes_[0].end;
+      interval.end = std::max(interval.end, wait_pos);
+    }
+    // Step 3. Widen to the loops the buffer may be live across. Loops around the allocation
+    // allocate the buffer anew in each iteration.
+    for (int scope = lca; scope != it->second.alloc_scope && scope > 0;
+         scope = scopes_[scope].parent) {
+      if (scopes_[scope].kind == ScopeKind::kLoop && !IsIterationLocal(accesses, scope)) {
+        interval.begin = std::min(interval.begin, scopes_[scope].begin);
+        interval.end = std::max(interval.end, scopes_[scope].end);
+      }
+    }
+    return interval;
+  }
+
+  /*!
+   * \brief Check whether two buffers can be placed in the same memory. Besides the disjointness
+   *  of their live intervals, all the threads must be done with one buffer before any thread
+   *  starts the other, which requires a barrier in between, and on the back edge of the loop
+   *  running both of them.
+   * \param a The live interval of the first buffer.
+   * \param b The live interval of the second buffer.
+   * \return Whether the two buffers can share memory.
+   */
+  bool CanShare(Interval a, Interval b) const {
+    if (a.begin > b.begin) {
+      std::swap(a, b);
+    }
+    if (a.end >= b.begin) {
+      return false;
+    }
+    // A barrier between two positions runs between them if all its scopes below the positions
+    // always run
+    auto f_separates = [&](int64_t first, int64_t second) {
+      int lca = InnermostScope(first, second);
+      return std::any_of(syncs_.begin(), syncs_.end(), [&](const BarrierEntry& sync) {
+        if (sync.pos <= first || sync.pos >= second) {
+          return false;
+        }
+        for (int scope = sync.scope; scope != lca; scope = scopes_[scope].parent) {
+          if (!AlwaysRuns(scopes_[scope])) {
+            return false;
+          }
+        }
+        return true;
+      });
+    };
+    if (!f_separates(a.end, b.begin)) {
+      return false;
+    }
+    int loop = InnermostScope(a.begin, b.end);
+    while (loop > 0 && scopes_[loop].kind != ScopeKind::kLoop) {
+      loop = scopes_[loop].parent;
+    }
+    if (loop > 0) {
+      const ScopeEntry& s = scopes_[loop];
+      return f_separates(b.end, s.end) || f_separates(s.begin, a.begin);
+    }
+    return true;
+  }
+
+ private:
+  struct BufferEntry {
+    // The scope of the allocation
+    int alloc_scope{0};
+    // The accesses in the linear order
+    std::vector<AccessEntry> accesses;
+  };
+
+  int64_t Tick() { return cur_pos_ = next_pos_++; }
+
+  bool Encloses(int scope, int64_t pos) const {
+    return scopes_[scope].begin <= pos && pos <= scopes_[scope].end;
+  }
+
+  /*! \brief Whether the body of a scope runs at least once whenever the scope is reached. */
+  static bool AlwaysRuns(const ScopeEntry& scope) {
+    if (scope.kind == ScopeKind::kThread) {
+      return true;
+    }
+    if (scope.kind == ScopeKind::kLoop && scope.var.defined()) {
+      const auto* extent = scope.dom->extent.as<IntImmNode>();
+      return extent != nullptr && extent->value > 0;
+    }
+    return false;
+  }
+
+  /*! \brief The innermost scope enclosing the positions [begin, end]. */
+  int InnermostScope(int64_t begin, int64_t end) const {
+    // The scopes are numbered in pre-order, so the innermost one comes last
+    int scope = 0;
+    for (int i = 1; i < static_cast<int>(scopes_.size()); ++i) {
+      if (Encloses(i, begin) && Encloses(i, end)) {
+        scope = i;
+      }
+    }
+    return scope;
+  }
+
+  /*!
+   * \brief Check whether a loop never carries a value of a buffer from one iteration to the next.
+   *  This holds when the first access in each iteration is a write, run by all the threads, that
+   *  covers every element accessed later in the iteration.
+   * \param accesses The accesses to the buffer, all in the loop.
+   * \param loop The loop scope.
+   */
+  bool IsIterationLocal(const std::vector<AccessEntry>& accesses, int loop) const {
+    for (const AccessEntry& access : accesses) {
+      if (access.kind != AccessKind::kRead && access.kind != AccessKind::kWrite) {
+        return false;
+      }
+    }
+    const AccessEntry& first = accesses.front();
+    if (first.kind != AccessKind::kWrite) {
+      return false;
+    }
+    // The nested scopes of the first write must run unconditionally
+    int64_t first_end = first.pos;
+    for (int scope = first.scope; scope != loop; scope = scopes_[scope].parent) {
+      if (scopes_[scope].kind == ScopeKind::kCondition || !scopes_[scope].var.defined()) {
+        return false;
+      }
+      first_end = scopes_[scope].end;
+    }
+    arith::Analyzer analyzer;
+    // Step 1. The first write covers a contiguous range
+    Map<Var, Range> dom;
+    for (const auto& kv : RelaxedDomain(first.scope, loop)) {
+      if (UsesVar(first.index, [&](const VarNode* v) { return v == kv.first.get(); })) {
+        dom.Set(kv.first, kv.second);
+      }
+    }
+    arith::IterMapResult iter_map = arith::DetectIterMap(
+        {first.index}, dom, const_true(), arith::IterMapLevel::Bijective, &analyzer);
+    if (iter_map->indices.size() != 1 || !iter_map->indices[0]->base->IsInstance<IntImmNode>()) {
+      return false;
+    }
+    const arith::IterSumExpr& sum = iter_map->indices[0];
+    PrimExpr extent = 1;
+    if (sum->args.size() == 1) {
+      if (!is_one(sum->args[0]->scale)) {
+        return false;
+      }
+      extent = sum->args[0]->extent;
+    } else if (!sum->args.empty()) {
+      return false;
+    }
+    PrimExpr covered_begin = sum->base;
+    PrimExpr covered_end = sum->base + extent;
+    // Step 2. The later accesses happen after the first write and stay in the covered range
+    for (size_t i = 1; i < accesses.size(); ++i) {
+      const AccessEntry& access = accesses[i];
+      if (access.kind == AccessKind::kRead && access.pos <= first_end) {
+        return false;
+      }
+      Map<Var, arith::IntSet> relaxed;
+      for (const auto& kv : RelaxedDomain(access.scope, loop)) {
+        relaxed.Set(kv.first, arith::IntSet::FromRange(kv.second));
+      }
+      arith::IntSet region = arith::EvalSet(access.index, relaxed);
+      if (!region.HasLowerBound() || !region.HasUpperBound() ||
+          !analyzer.CanProve(region.min() >= covered_begin) ||
+          !analyzer.CanProve(region.max() < covered_end)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The domain of the loops between a scope and a loop, and of all the threads. */
+  std::vector<std::pair<Var, Range>> RelaxedDomain(int scope, int loop) const {
+    std::vector<std::pair<Var, Range>> dom;
+    bool inside = true;
+    for (; scope > 0; scope = scopes_[scope].parent) {
+      if (scope == loop) {
+        inside = false;
+      }
+      const ScopeEntry& s = scopes_[scope];
+      if ((s.kind == ScopeKind::kLoop && inside && s.var.defined()) ||
+          s.kind == ScopeKind::kThread) {
+        dom.emplace_back(s.var, s.dom);
+      }
+    }
+    return dom;
+  }
+
+  template <typename FVisit>
+  void VisitScope(ScopeKind kind, Var var, Range dom, FVisit f_visit) {
+    int parent = cur_scope_;
+    cur_scope_ = scopes_.size();
+    scopes_.push_back({kind, parent, Tick(), 0, std::move(var), std::move(dom)});
+    f_visit();
+    scopes_[cur_scope_].end = Tick();
+    cur_scope_ = parent;
+  }
+
+  void AddAccess(const VarNode* buffer, AccessKind kind, PrimExpr index = PrimExpr()) {
+    auto it = buffers_.find(buffer);
+    if (it == buffers_.end()) {
+      return;
+    }
+    if (!index.defined() && kind != AccessKind::kAsyncWrite) {
+      kind = AccessKind::kOpaque;
+    }
+    it->second.accesses.push_back({kind, cur_pos_, cur_scope_, std::move(index)});
+  }
+
+  template <typename Node>
+  PrimExpr FlatIndex(const Node* op) {
+    return op->indices.size() == 1 ? op->indices[0] : PrimExpr();
+  }
+
+  bool IsAppropriateSharedMemory(const Var& var) {
+    return is_dynamic_ ? IsDynamicSharedMemory(var) : IsStaticSharedMemory(var);
+  }
+
+  void VisitStmt_(const AllocateNode* op) final {
+    if (IsAppropriateSharedMemory(op->buffer_var)) {
+      buffers_[op->buffer_var.get()].alloc_scope = cur_scope_;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    Tick();
+    StmtExprVisitor::VisitStmt_(op);
+    AddAccess(op->buffer->data.get(), AccessKind::kWrite, FlatIndex(op));
+  }
+
+  void VisitStmt_(const EvaluateNode* op) final {
+    Tick();
+    if (const auto* call = op->value.as<CallNode>()) {
+      if (call->op.same_as(builtin::tvm_storage_sync())) {
+        const auto* scope = call->args[0].as<StringImmNode>();
+        if (scope && (scope->value == "shared" || scope->value == "shared.dyn")) {
+          syncs_.push_back({cur_pos_, cur_scope_});
+        }
+      } else if (call->op.same_as(builtin::ptx_wait_group()) && is_zero(call->args[0])) {
+        async_waits_.push_back({cur_pos_, cur_scope_});
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    Tick();
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    VisitScope(ScopeKind::kLoop, op->loop_var, Range::FromMinExtent(op->min, op->extent),
+               [&]() { StmtExprVisitor::VisitStmt_(op); });
+  }
+
+  void VisitStmt_(const WhileNode* op) final {
+    VisitScope(ScopeKind::kLoop, Var(), Range(), [&]() { StmtExprVisitor::VisitStmt_(op); });
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    VisitScope(ScopeKind::kCondition, Var(), Range(), [&]() {
+      this->VisitExpr(op->condition);
+      VisitScope(ScopeKind::kCondition, Var(), Range(), [&]() { this->VisitStmt(op->then_case); });
+      if (op->else_case) {
+        VisitScope(ScopeKind::kCondition, Var(), Range(),
+                   [&]() { this->VisitStmt(op->else_case.value()); });
+      }
+    });
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      VisitScope(ScopeKind::kThread, iv->var, Range::FromMinExtent(0, op->value),
+                 [&]() { StmtExprVisitor::VisitStmt_(op); });
+    } else if (op->attr_key == attr::virtual_thread) {
+      VisitScope(ScopeKind::kLoop, Var(), Range(), [&]() { StmtExprVisitor::VisitStmt_(op); });
+    } else {
+      if (op->attr_key == attr::hand_threaded) {
+        hand_threaded_ = true;
+      }
+      StmtExprVisitor::VisitStmt_(op);
+    }
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    StmtExprVisitor::VisitExpr_(op);
+    AddAccess(op->buffer->data.get(), AccessKind::kRead, FlatIndex(op));
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::address_of())) {
+      const auto* load = op->args[0].as<BufferLoadNode>();
+      ICHECK(load != nullptr);
+      AddAccess(load->buffer->data.get(), AccessKind::kOpaque);
+      for (const PrimExpr& index : load->indices) {
+        this->VisitExpr(index);
+      }
+    } else if (op->op.same_as(builtin::ptx_cp_async())) {
+      AddAccess(op->args[0].as<VarNode>(), AccessKind::kAsyncWrite);
+      for (size_t i = 1; i < op->args.size(); ++i) {
+        this->VisitExpr(op->args[i]);
+      }
+    } else {
+      StmtExprVisitor::VisitExpr_(op);
+    }
+  }
+
+  void VisitExpr_(const VarNode* op) final { AddAccess(op, AccessKind::kOpaque); }
+
+  // Whether to analyze the dynamic shared memory.
+  bool is_dynamic_{true};
+  // Whether the threads are partitioned by hand.
+  bool hand_threaded_{false};
+  // The position of the current statement in the linear order.
+  int64_t cur_pos_{0};
+  // The position of the next statement in the linear order.
+  int64_t next_pos_{0};
+  // The current scope.
+  int cur_scope_{0};
+  // The nested scopes, the root first.
+  std::vector<ScopeEntry> scopes_;
+  // The allocation and the accesses of each buffer.
+  std::unordered_map<const VarNode*, BufferEntry> buffers_;
+  // The barriers of the shared memory.
+  std::vector<BarrierEntry> syncs_;
+  // The waits of all the asynchronous copies.
+  std::vector<BarrierEntry> async_waits_;
+};
+
 /*!
  * \brief merge the buffers whose live range has no intersection and rewrite the body
  */
@@ -268,49 +715,14 @@ class SharedMemoryRewriter : public StmtExprMutator {
     finder(stmt);
     this->LivenessAnalysis(finder.linear_seq_);
     this->PlanMemory(finder.linear_seq_);
+    this->PlanOffsets();
+    this->PlanIntervalColoring(stmt, is_dynamic);
   }
 
  private:
   Stmt VisitStmt_(const AttrStmtNode* op) final {
     if (op->attr_key == attr::thread_extent && !allocated_) {
       // Allocate one dynamic shared memory allocation at the beginning of thread scope
-      int max_layer_num = 0;
-      std::vector<const StorageEntry*> all_entry;
-      for (const auto& e : const_free_map_) {
-        all_entry.push_back(e.second);
-      }
-      for (const StorageEntry* e : sym_free_list_) {
-        all_entry.push_back(e);
-      }
-      for (const StorageEntry* e : all_entry) {
-        max_layer_num = std::max(max_layer_num, static_cast<int>(e->allocs.size()));
-      }
-      // calculate align for each layer of each storage entry.
-      std::vector<int> align(max_layer_num, 0);
-      for (const StorageEntry* e : all_entry) {
-        for (int i = 0; i < static_cast<int>(e->allocs.size()); i++) {
-          for (const VarNode* buffer : e->allocs[i]) {
-            const AllocateNode* alloc = shmem_allocs_[buffer];
-            align[i] = std::max(align[i], alloc->dtype.bytes());
-          }
-        }
-      }
-      // calculate offset for each buffer based on the align of each layer
-      for (const StorageEntry* e : all_entry) {
-        PrimExpr max_inner_offset = 0;
-        for (int i = 0; i < static_cast<int>(e->allocs.size()); i++) {
-          PrimExpr inner_offset = 0;
-          for (const VarNode* buffer : e->allocs[i]) {
-            const AllocateNode* alloc = shmem_allocs_[buffer];
-            buffer_byte_offsets_[buffer] = merged_alloc_size_ + inner_offset;
-            inner_offset += alloc->extents[0] * alloc->dtype.bytes();
-            inner_offset += indexmod(align[i] - indexmod(inner_offset, align[i]), align[i]);
-          }
-          max_inner_offset = max(max_inner_offset, inner_offset);
-        }
-        merged_alloc_size_ += max_inner_offset;
-      }
-
       allocated_ = true;
       Allocate new_body(merged_buf_var_, DataType::UInt(8), {merged_alloc_size_}, const_true(),
                         StmtExprMutator::VisitStmt(op->body));
@@ -423,6 +835,121 @@ class SharedMemoryRewriter : public StmtExprMutator {
     }
   }
 
+  /*!
+   * \brief Compute the offset of each buffer from the storage entries planned by PlanMemory.
+   */
+  void PlanOffsets() {
+    int max_layer_num = 0;
+    std::vector<const StorageEntry*> all_entry;
+    for (const auto& e : const_free_map_) {
+      all_entry.push_back(e.second);
+    }
+    for (const StorageEntry* e : sym_free_list_) {
+      all_entry.push_back(e);
+    }
+    for (const StorageEntry* e : all_entry) {
+      max_layer_num = std::max(max_layer_num, static_cast<int>(e->allocs.size()));
+    }
+    // calculate align for each layer of each storage entry.
+    std::vector<int> align(max_layer_num, 0);
+    for (const StorageEntry* e : all_entry) {
+      for (int i = 0; i < static_cast<int>(e->allocs.size()); i++) {
+        for (const VarNode* buffer : e->allocs[i]) {
+          const AllocateNode* alloc = shmem_allocs_[buffer];
+          align[i] = std::max(align[i], alloc->dtype.bytes());
+        }
+      }
+    }
+    // calculate offset for each buffer based on the align of each layer
+    for (const StorageEntry* e : all_entry) {
+      PrimExpr max_inner_offset = 0;
+      for (int i = 0; i < static_cast<int>(e->allocs.size()); i++) {
+        PrimExpr inner_offset = 0;
+        for (const VarNode* buffer : e->allocs[i]) {
+          const AllocateNode* alloc = shmem_allocs_[buffer];
+          buffer_byte_offsets_[buffer] = merged_alloc_size_ + inner_offset;
+          inner_offset += alloc->extents[0] * alloc->dtype.bytes();
+          inner_offset += indexmod(align[i] - indexmod(inner_offset, align[i]), align[i]);
+        }
+        max_inner_offset = max(max_inner_offset, inner_offset);
+      }
+      merged_alloc_size_ += max_inner_offset;
+    }
+  }
+
+  /*!
+   * \brief Plan the offsets by coloring the live intervals of the buffers, which reuses memory
+   *  within loops, e.g. between the buffers of successive stages of a persistent kernel, and
+   *  keeps the versions of software pipelined buffers apart. Buffers overlap in memory only if a
+   *  barrier separates their live intervals. The plan replaces the one of PlanMemory when it
+   *  needs less memory, and is skipped when the size of any buffer is symbolic.
+   * \param stmt The statement.
+   * \param is_dynamic Whether to plan the dynamic shared memory.
+   */
+  void PlanIntervalColoring(const Stmt& stmt, bool is_dynamic) {
+    using Interval = SharedMemLiveIntervalFinder::Interval;
+    // The alignment of each buffer, enough for vector accesses and asynchronous copies
+    constexpr int64_t kAlign = 16;
+    const auto* planned_size = merged_alloc_size_.as<IntImmNode>();
+    if (planned_size == nullptr) {
+      return;
+    }
+    SharedMemLiveIntervalFinder finder(is_dynamic);
+    finder(stmt);
+    if (finder.IsHandThreaded()) {
+      return;
+    }
+    struct ColoredBuffer {
+      const VarNode* buffer;
+      Interval interval;
+      int64_t bytes;
+      int64_t offset;
+    };
+    std::vector<ColoredBuffer> buffers;
+    for (const auto& kv : shmem_allocs_) {
+      int64_t size = kv.second->ConstantAllocationSize();
+      if (size == 0) {
+        return;
+      }
+      if (std::optional<Interval> interval = finder.GetInterval(kv.first)) {
+        buffers.push_back({kv.first, interval.value(), size * kv.second->dtype.bytes(), 0});
+      }
+    }
+    // Place the largest buffers first, each at the lowest offset free of the buffers it conflicts
+    // with
+    std::sort(buffers.begin(), buffers.end(), [](const ColoredBuffer& a, const ColoredBuffer& b) {
+      if (a.bytes != b.bytes) return a.bytes > b.bytes;
+      if (a.interval.begin != b.interval.begin) return a.interval.begin < b.interval.begin;
+      if (a.interval.end != b.interval.end) return a.interval.end < b.interval.end;
+      return a.buffer->name_hint < b.buffer->name_hint;
+    });
+    int64_t total_bytes = 0;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      std::vector<std::pair<int64_t, int64_t>> occupied;
+      for (size_t j = 0; j < i; ++j) {
+        if (!finder.CanShare(buffers[i].interval, buffers[j].interval)) {
+          occupied.emplace_back(buffers[j].offset, buffers[j].offset + buffers[j].bytes);
+        }
+      }
+      std::sort(occupied.begin(), occupied.end());
+      int64_t offset = 0;
+      for (const auto& range : occupied) {
+        if (range.second <= offset) continue;
+        if (offset + buffers[i].bytes <= range.first) break;
+        offset = (range.second + kAlign - 1) / kAlign * kAlign;
+      }
+      buffers[i].offset = offset;
+      total_bytes = std::max(total_bytes, offset + buffers[i].bytes);
+    }
+    if (total_bytes >= planned_size->value) {
+      return;
+    }
+    for (const ColoredBuffer& b : buffers) {
+      buffer_byte_offsets_[b.buffer] = make_const(DataType::Int(32), b.offset);
+    }
+    merged_alloc_size_ = make_const(DataType::Int(32), total_bytes);
+  }
+
   PrimExpr GetBufferOffset(Var buffer_var, DataType dtype) {
     auto it = buffer_byte_offsets_.find(buffer_var.get());
     ICHECK(it != buffer_byte_offsets_.end());
@@ -356,7 +356,8 @@ Pass Simplify() {
 
     return arith::StmtSimplifier::Apply(f, &analyzer, cfg);
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.Simplify", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.Simplify", {}, /* traceable */ false,
+                            /* thread_safe */ true);
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.Simplify").set_body_typed(Simplify);
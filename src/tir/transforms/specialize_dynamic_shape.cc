@@ -0,0 +1,248 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file specialize_dynamic_shape.cc
+ * \brief Split off a fast path of a dynamic-shape function, specialized for the shape values
+ *  that are multiples of the tiles, in which the boundary predicates are removed.
+ *
+ * The tile of each symbolic shape variable is inferred from the ceil divisions and the modulos on
+ * it, e.g. the extent `(n + 63) // 64` of a loop split by 64. The function body becomes
+ *
+ *   if n % 64 == 0:
+ *     <body with n substituted by n // 64 * 64, without the predicates proven true>
+ *   else:
+ *     <body>
+ *
+ * so that the shape values are dispatched on at runtime, by the host code once the kernels are
+ * split off by SplitHostDevice.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/int_set.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The largest tile a shape variable is specialized for. */
+constexpr int64_t kMaxSpecializedTile = 4096;
+
+/*! \brief Infer the tile of each shape variable from the divisions on it. */
+class ShapeTileCollector : public StmtExprVisitor {
+ public:
+  static std::unordered_map<const VarNode*, int64_t> Collect(
+      const Stmt& stmt, const std::unordered_set<const VarNode*>& shape_vars) {
+    ShapeTileCollector collector(shape_vars);
+    collector(stmt);
+    return std::move(collector.tiles_);
+  }
+
+ private:
+  explicit ShapeTileCollector(const std::unordered_set<const VarNode*>& shape_vars)
+      : shape_vars_(shape_vars) {}
+
+  void Record(const PrimExpr& a, const PrimExpr& b) {
+    const auto* divisor = b.as<IntImmNode>();
+    if (divisor == nullptr || divisor->value <= 1) {
+      return;
+    }
+    // Either `n` or `n + c`, as in the ceil divisions of the split loops
+    const VarNode* var = a.as<VarNode>();
+    if (const auto* add = a.as<AddNode>(); add != nullptr && add->b->IsInstance<IntImmNode>()) {
+      var = add->a.as<VarNode>();
+    }
+    if (var == nullptr || !shape_vars_.count(var)) {
+      return;
+    }
+    auto it = tiles_.find(var);
+    int64_t tile = it == tiles_.end() ? divisor->value : std::lcm(it->second, divisor->value);
+    if (tile <= kMaxSpecializedTile) {
+      tiles_[var] = tile;
+    }
+  }
+
+  void VisitExpr_(const FloorDivNode* op) final {
+    Record(op->a, op->b);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const FloorModNode* op) final {
+    Record(op->a, op->b);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const DivNode* op) final {
+    Record(op->a, op->b);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const ModNode* op) final {
+    Record(op->a, op->b);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  /*! \brief The variables defined by the signature of the function. */
+  const std::unordered_set<const VarNode*>& shape_vars_;
+  /*! \brief The tile of each shape variable. */
+  std::unordered_map<const VarNode*, int64_t> tiles_;
+};
+
+/*! \brief Remove the conditions that are proven true over the iteration domain of the loops. */
+class PredicateEliminator : public StmtExprMutator {
+ public:
+  static Stmt Eliminate(Stmt stmt) { return PredicateEliminator()(std::move(stmt)); }
+
+ private:
+  /*! \brief Whether a condition holds over the whole domain of the loops in scope. */
+  bool ProveTrue(const PrimExpr& cond) {
+    if (const auto* call = cond.as<CallNode>(); call && call->op.same_as(builtin::likely())) {
+      return ProveTrue(call->args[0]);
+    }
+    if (const auto* op = cond.as<AndNode>()) {
+      return ProveTrue(op->a) && ProveTrue(op->b);
+    }
+    // The largest value of `lhs - rhs`, which must be negative for `lhs < rhs`
+    auto f_prove_negative = [this](const PrimExpr& lhs, const PrimExpr& rhs, bool strict) {
+      arith::IntSet diff = arith::EvalSet(lhs - rhs, dom_map_);
+      if (!diff.HasUpperBound()) {
+        return false;
+      }
+      PrimExpr max = diff.max();
+      PrimExpr zero = make_zero(max.dtype());
+      return analyzer_.CanProve(strict ? max < zero : max <= zero);
+    };
+    if (const auto* op = cond.as<LTNode>()) return f_prove_negative(op->a, op->b, true);
+    if (const auto* op = cond.as<LENode>()) return f_prove_negative(op->a, op->b, false);
+    if (const auto* op = cond.as<GTNode>()) return f_prove_negative(op->b, op->a, true);
+    if (const auto* op = cond.as<GENode>()) return f_prove_negative(op->b, op->a, false);
+    return analyzer_.CanProve(cond);
+  }
+
+  void EnterDomain(const Var& var, const PrimExpr& min, const PrimExpr& extent) {
+    dom_map_.Set(var, arith::IntSet::FromMinExtent(min, analyzer_.Simplify(extent)));
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    EnterDomain(op->loop_var, op->min, op->extent);
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      EnterDomain(iv->var, make_zero(op->value.dtype()), op->value);
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const IfThenElseNode* op) final {
+    if (ProveTrue(op->condition)) {
+      return VisitStmt(op->then_case);
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::if_then_else()) && ProveTrue(op->args[0])) {
+      return VisitExpr(op->args[1]);
+    }
+    return StmtExprMutator::VisitExpr_(op);
+  }
+
+  /*! \brief The domains of the loop variables and thread indices in scope. */
+  Map<Var, arith::IntSet> dom_map_;
+  arith::Analyzer analyzer_;
+};
+
+PrimFunc SpecializeDynamicShape(PrimFunc func) {
+  // The buffers of the blocks are specialized separately from their bodies, so the pass only
+  // runs after LowerOpaqueBlock
+  bool has_block = false;
+  PostOrderVisit(func->body, [&has_block](const ObjectRef& obj) {
+    has_block = has_block || obj->IsInstance<BlockNode>();
+  });
+  if (has_block) {
+    return func;
+  }
+  // Step 1. Collect the integer variables of the signature, in order
+  std::vector<Var> shape_vars;
+  std::unordered_set<const VarNode*> shape_var_set;
+  auto f_add_var = [&](const PrimExpr& expr) {
+    if (const auto* var = expr.as<VarNode>();
+        var != nullptr && var->dtype.is_int() && shape_var_set.insert(var).second) {
+      shape_vars.push_back(GetRef<Var>(var));
+    }
+  };
+  for (const Var& param : func->params) {
+    if (auto it = func->buffer_map.find(param); it != func->buffer_map.end()) {
+      for (const PrimExpr& dim : (*it).second->shape) {
+        f_add_var(dim);
+      }
+    } else {
+      f_add_var(param);
+    }
+  }
+  // Step 2. Specialize the variables divided by tiles
+  std::unordered_map<const VarNode*, int64_t> tiles =
+      ShapeTileCollector::Collect(func->body, shape_var_set);
+  if (tiles.empty()) {
+    return func;
+  }
+  Map<Var, PrimExpr> var_map;
+  PrimExpr divisible = Bool(true);
+  for (const Var& var : shape_vars) {
+    if (auto it = tiles.find(var.get()); it != tiles.end()) {
+      PrimExpr tile = make_const(var.dtype(), it->second);
+      var_map.Set(var, floordiv(var, tile) * tile);
+      divisible = divisible && (floormod(var, tile) == make_zero(var.dtype()));
+    }
+  }
+  Stmt fast_path = PredicateEliminator::Eliminate(SpecializeBody(func, var_map));
+  PrimFuncNode* n = func.CopyOnWrite();
+  n->body = ConvertSSA(IfThenElse(divisible, fast_path, n->body));
+  return func;
+}
+
+namespace transform {
+
+Pass SpecializeDynamicShape() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    return tir::SpecializeDynamicShape(std::move(f));
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.SpecializeDynamicShape", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.SpecializeDynamicShape").set_body_typed(SpecializeDynamicShape);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
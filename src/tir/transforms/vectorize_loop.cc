@@ -31,6 +31,9 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <functional>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -72,6 +75,15 @@ inline PrimExpr BroadcastTo(PrimExpr e, int lanes, bool is_scalable) {
   return Broadcast(e, CreateNewLanes(is_scalable, lanes));
 }
 
+/*! \brief Whether the target is an x86 CPU with the masked loads and stores of AVX-512. */
+bool TargetHasAVX512(Target target) {
+  if (!target.defined() || target->kind->name != "llvm") {
+    return false;
+  }
+  const runtime::PackedFunc* f_has_feature = runtime::Registry::Get("target.target_has_feature");
+  return f_has_feature != nullptr && (*f_has_feature)(String("avx512f"), target).operator bool();
+}
+
 bool EnableBufferLevelPredication(Target target) {
   transform::PassContext pass_ctx = transform::PassContext::Current();
   Optional<Bool> enable_buffer_predication =
@@ -80,8 +92,35 @@ bool EnableBufferLevelPredication(Target target) {
     return enable_buffer_predication.value();
   }
 
-  // Use buffer-level predication by default for AArch64 SVE targets
-  return arith::TargetHasSVE(target);
+  // Use buffer-level predication by default for AArch64 SVE and x86 AVX-512 targets
+  return arith::TargetHasSVE(target) || TargetHasAVX512(target);
+}
+
+/*! \brief Whether the lanes of a vector can be reduced by the vector_reduce builtins. */
+bool SupportsVectorReduce(Target target) {
+  return target.defined() && target->kind->name == "llvm";
+}
+
+/*! \brief Whether the call is one of the vector_reduce builtins. */
+bool IsVectorReduce(const CallNode* op) {
+  return op->op.same_as(builtin::vector_reduce_add()) ||
+         op->op.same_as(builtin::vector_reduce_mul()) ||
+         op->op.same_as(builtin::vector_reduce_min()) ||
+         op->op.same_as(builtin::vector_reduce_max());
+}
+
+/*! \brief The value that leaves the result of a vector_reduce builtin unchanged. */
+PrimExpr VectorReduceIdentity(const RelayExpr& op, DataType t) {
+  if (op.same_as(builtin::vector_reduce_add())) {
+    return make_zero(t);
+  } else if (op.same_as(builtin::vector_reduce_mul())) {
+    return make_const(t, 1);
+  } else if (op.same_as(builtin::vector_reduce_min())) {
+    return t.is_float() ? infinity(t) : max_value(t);
+  } else {
+    ICHECK(op.same_as(builtin::vector_reduce_max()));
+    return t.is_float() ? -infinity(t) : min_value(t);
+  }
 }
 
 /*!
@@ -104,6 +143,10 @@ bool EnableBufferLevelPredication(Target target) {
  *  predicate = T.get_active_lane_mask("uint1x4", i_0 * 4, 14)
  *  A_load = T.meta_var(A.vload([T.Ramp(i_0 * 4, 1, 4)], predicate=predicate))
  *  B.vstore([T.Ramp(i_0 * 4, 1, 4)], A_load, predicate=predicate)
+ *
+ * The reductions into a scalar keep the scalar access unpredicated, and replace the
+ * inactive lanes of the reduced vector with the identity of the reduction:
+ *  B[0] = B[0] + T.vector_reduce_add("float32", T.Select(predicate, A_load, T.Broadcast(0, 4)))
  */
 class TryPredicateBufferAccesses : public StmtExprMutator {
  public:
@@ -132,8 +175,15 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
       return {false, stmt};
     }
 
+    // The lanes of the predicate are consecutive values of the loop variable
+    if (!is_one(Downcast<Ramp>(lt->a)->stride)) {
+      return {false, stmt};
+    }
+
     base_ = Downcast<Ramp>(lt->a)->base;
     limit_ = Downcast<Broadcast>(lt->b)->value;
+    lanes_ = lt->a.dtype().get_lanes_or_vscale_factor();
+    is_scalable_ = lt->a.dtype().is_scalable_vector();
 
     // Now we can try to predicate
     Stmt predicated_stmt = StmtExprMutator::operator()(std::move(stmt));
@@ -145,15 +195,54 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
 
  private:
   PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    // The scalar read by a reduction update is accessed by every lane
+    if (reduction_store_ != nullptr && op->buffer.same_as(reduction_store_->buffer) &&
+        IsScalarAccess(op->indices)) {
+      return GetRef<PrimExpr>(op);
+    }
     auto load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
     return TryPredicateBufferAccess(load);
   }
 
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    if (reduction_store_ == nullptr || !IsVectorReduce(op)) {
+      return StmtExprMutator::VisitExpr_(op);
+    }
+    PrimExpr vec = this->VisitExpr(op->args[0]);
+    DataType t = vec.dtype();
+    if (t.get_lanes_or_vscale_factor() != lanes_ || t.is_scalable_vector() != is_scalable_) {
+      // Counted as an access that cannot be predicated
+      num_accesses_analyzed_ += 1;
+      return GetRef<PrimExpr>(op);
+    }
+    DataType mask_dtype = DataType(DataType::kUInt, 1, lanes_, is_scalable_);
+    PrimExpr mask = Call(mask_dtype, builtin::get_active_lane_mask(), {base_, limit_});
+    PrimExpr lanes = CreateNewLanes(t.is_scalable_vector(), t.get_lanes_or_vscale_factor());
+    PrimExpr identity = Broadcast(VectorReduceIdentity(op->op, t.element_of()), lanes);
+    return Call(op->dtype, op->op, {Select(mask, vec, identity)});
+  }
+
   Stmt VisitStmt_(const BufferStoreNode* op) final {
+    if (reduction_store_ == nullptr && IsScalarAccess(op->indices) &&
+        CheckContains::ExprContains(op->value, [](const PrimExpr& e) {
+          const auto* call = e.as<CallNode>();
+          return call != nullptr && IsVectorReduce(call);
+        })) {
+      // A reduction update, which stays correct when all its lanes are inactive
+      reduction_store_ = op;
+      Stmt stmt = StmtExprMutator::VisitStmt_(op);
+      reduction_store_ = nullptr;
+      return stmt;
+    }
     auto store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
     return TryPredicateBufferAccess(store);
   }
 
+  static bool IsScalarAccess(const Array<PrimExpr>& indices) {
+    return std::all_of(indices.begin(), indices.end(),
+                       [](const PrimExpr& index) { return index.dtype().is_scalar(); });
+  }
+
   template <typename AccessNode>
   AccessNode TryPredicateBufferAccess(AccessNode node) {
     num_accesses_analyzed_ += 1;
@@ -165,8 +254,10 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
     }
     Ramp ramp = Downcast<Ramp>(node->indices[0]);
 
-    // The vectorized access pattern must match the base of the predicate
-    if (!tvm::StructuralEqual()(ramp->base, base_)) {
+    // Each lane of the access must be a lane of the predicate, whatever the base of the access,
+    // e.g. in the tail of a row `A[i * n + k_0 * 4 : i * n + k_0 * 4 + 4]` with `k_0 * 4 < n`
+    if (ramp->dtype.get_lanes_or_vscale_factor() != lanes_ ||
+        ramp->dtype.is_scalable_vector() != is_scalable_) {
       return node;
     }
 
@@ -186,10 +277,16 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
   /*! \brief The limit of the predicate. The expr specifies the upper bound of the base's
    * evaluated value. */
   PrimExpr limit_;
+  /*! \brief The lanes of the predicate. */
+  int lanes_ = 0;
+  /*! \brief Whether the predicate is a scalable vector. */
+  bool is_scalable_ = false;
   /*! \brief The number of buffer accesses in the stmt we will analyze. */
   size_t num_accesses_analyzed_ = 0;
   /*! \brief The number of buffer accesses rewritten with predicates. */
   size_t num_accesses_rewritten_ = 0;
+  /*! \brief The reduction update being visited, if any. */
+  const BufferStoreNode* reduction_store_ = nullptr;
 };
 
 // Rewrite vectorized allocation access
@@ -626,6 +723,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   }
   // BufferStore
   Stmt VisitStmt_(const BufferStoreNode* op) final {
+    if (Optional<Stmt> reduction = TryVectorizeReduction(op)) {
+      return reduction.value();
+    }
     auto store = GetRef<BufferStore>(op);
 
     auto fmutate = [this](const PrimExpr& index) { return this->VisitExpr(index); };
@@ -708,8 +808,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
       else_case = this->VisitStmt(op->else_case.value());
     }
     // Check if we can rewrite the condition with predicated buffers
-    if (EnableBufferLevelPredication(target_) &&
-        condition.dtype().is_scalable_or_fixed_length_vector() && !else_case.defined()) {
+    if (condition.dtype().is_scalable_or_fixed_length_vector() && !else_case.defined() &&
+        EnablePredication()) {
       std::pair<bool, Stmt> success_stmt_pair =
           TryPredicateBufferAccesses().Run(then_case, condition);
       bool can_remove_if_then_else = success_stmt_pair.first;
@@ -795,6 +895,98 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     return Allocate(op->buffer_var, op->dtype, extents, condition, body);
   }
 
+  /*!
+   * \brief Try to vectorize the update of a reduction into a scalar, by reducing the lanes of
+   * the vectorized operand horizontally.
+   *
+   * \example
+   * Before:
+   * for k in T.vectorized(4):
+   *     B[i] = B[i] + A[i, k]
+   *
+   * After:
+   * B[i] = B[i] + T.vector_reduce_add("float32", A[i, T.Ramp(0, 1, 4)])
+   *
+   * \return The rewritten store, or NullOpt if the store is not such an update.
+   */
+  Optional<Stmt> TryVectorizeReduction(const BufferStoreNode* op) {
+    if (!SupportsVectorReduce(target_) || op->buffer->dtype.lanes() != 1 ||
+        op->predicate.defined()) {
+      return NullOpt;
+    }
+    auto f_is_self = [&](const PrimExpr& e) {
+      const auto* load = e.as<BufferLoadNode>();
+      return load != nullptr && load->buffer.same_as(op->buffer) && !load->predicate.defined() &&
+             load->indices.size() == op->indices.size() &&
+             std::equal(load->indices.begin(), load->indices.end(), op->indices.begin(),
+                        [this](const PrimExpr& a, const PrimExpr& b) { return deep_equal_(a, b); });
+    };
+    // Step 1. Match `self = combine(self, rhs)`, or `self = self - rhs` as a sum
+    Op reduce_op;
+    PrimExpr rhs;
+    std::function<PrimExpr(PrimExpr, PrimExpr)> f_combine;
+    auto f_match = [&](const auto* node, const Op& node_reduce_op, bool commutative,
+                       std::function<PrimExpr(PrimExpr, PrimExpr)> node_combine) {
+      if (node == nullptr) {
+        return false;
+      }
+      if (f_is_self(node->a)) {
+        rhs = node->b;
+      } else if (commutative && f_is_self(node->b)) {
+        rhs = node->a;
+      } else {
+        return false;
+      }
+      reduce_op = node_reduce_op;
+      f_combine = node_combine;
+      return true;
+    };
+    const PrimExpr& value = op->value;
+    if (!f_match(value.as<AddNode>(), builtin::vector_reduce_add(), true,
+                 [](PrimExpr a, PrimExpr b) { return Add(a, b); }) &&
+        !f_match(value.as<SubNode>(), builtin::vector_reduce_add(), false,
+                 [](PrimExpr a, PrimExpr b) { return Sub(a, b); }) &&
+        !f_match(value.as<MulNode>(), builtin::vector_reduce_mul(), true,
+                 [](PrimExpr a, PrimExpr b) { return Mul(a, b); }) &&
+        !f_match(value.as<MinNode>(), builtin::vector_reduce_min(), true,
+                 [](PrimExpr a, PrimExpr b) { return Min(a, b); }) &&
+        !f_match(value.as<MaxNode>(), builtin::vector_reduce_max(), true,
+                 [](PrimExpr a, PrimExpr b) { return Max(a, b); })) {
+      return NullOpt;
+    }
+    // Step 2. The updated element must not depend on the lanes, nor be read by the operand
+    for (const PrimExpr& index : op->indices) {
+      if (!this->VisitExpr(index).same_as(index)) {
+        return NullOpt;
+      }
+    }
+    bool reads_self = false;
+    PostOrderVisit(rhs, [&](const ObjectRef& obj) {
+      if (const auto* load = obj.as<BufferLoadNode>()) {
+        reads_self = reads_self || load->buffer->data.same_as(op->buffer->data);
+      }
+    });
+    if (reads_self || need_scalarize_) {
+      return NullOpt;
+    }
+    // Step 3. Vectorize the operand, and reduce its lanes
+    PrimExpr vec = this->VisitExpr(rhs);
+    if (need_scalarize_ || !vec.dtype().is_scalable_or_fixed_length_vector()) {
+      return NullOpt;
+    }
+    PrimExpr self = BufferLoad(op->buffer, op->indices);
+    PrimExpr reduced = Call(vec.dtype().element_of(), reduce_op, {vec});
+    return BufferStore(op->buffer, f_combine(self, reduced), op->indices);
+  }
+
+  /*! \brief Whether the vectorized conditions are rewritten as predicated buffer accesses. */
+  bool EnablePredication() {
+    if (!enable_predication_.has_value()) {
+      enable_predication_ = EnableBufferLevelPredication(target_);
+    }
+    return enable_predication_.value();
+  }
+
   // scalarize the statment
   Stmt Scalarize(Stmt stmt) {
     Var idx(var_->name_hint + ".s", var_->dtype);
@@ -825,6 +1017,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   OpAttrMap<TVectorizable> op_vectorizable_ = Op::GetAttrMap<TVectorizable>("TVectorizable");
   /*! \brief The current target context. */
   Target target_;
+  /*! \brief Whether buffer-level predication is enabled for the target, computed lazily. */
+  std::optional<bool> enable_predication_;
 
   // mutate array, with given lane requirement
   // when finished, p_lane updates the lane requirement.
@@ -959,7 +1153,8 @@ Pass VectorizeLoop(bool enable_vectorize) {
     }
     return f;
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.VectorizeLoop", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.VectorizeLoop", {}, /* traceable */ false,
+                            /* thread_safe */ true);
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.VectorizeLoop").set_body_typed(VectorizeLoop);
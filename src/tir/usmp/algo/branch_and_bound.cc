@@ -0,0 +1,313 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/analysis/usmp/algo/branch_and_bound.cc
+ * \brief Implement the exact branch-and-bound memory planning algorithm
+ *
+ * branch_and_bound : any plan can be compacted so that every buffer sits at
+ * the lowest aligned offset left free by its conflicts. Visiting the buffers of
+ * such a plan by increasing offset, placing each one first-fit rebuilds the plan.
+ * The search therefore enumerates the order of placement, keeping the offsets
+ * non-decreasing to visit each compacted plan once, and prunes every partial
+ * plan that cannot beat the best plan found so far. The greedy-by-size plan is
+ * the initial best plan, and the search stops as soon as a plan reaches the
+ * memory pressure, which no plan can go below.
+ *
+ * The search is exponential in the worst case, so it is meant for small graphs.
+ * It stops at kUSMPTimeLimitOption with the best plan found so far.
+ */
+#include <tvm/ir/transform.h>
+#include <tvm/tir/usmp/algo/greedy.h>
+#include <tvm/tir/usmp/algorithms.h>
+#include <tvm/tir/usmp/utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+/*! \brief The default time limit of the search in milliseconds. */
+constexpr int64_t kDefaultBranchAndBoundTimeLimitMs = 1000;
+
+class BranchAndBoundAllocator : public GreedyBase {
+ public:
+  BranchAndBoundAllocator(size_t memory_pressure, int64_t time_limit_ms)
+      : GreedyBase(), memory_pressure_(memory_pressure), time_limit_ms_(time_limit_ms) {}
+
+  Map<BufferInfo, PoolAllocation> PlanMemory(const Array<BufferInfo>& buffer_info_arr) {
+    Map<BufferInfo, PoolAllocation> greedy_plan = GreedyBySize(buffer_info_arr, Integer(0));
+    if (buffer_info_arr.empty()) {
+      return greedy_plan;
+    }
+    // Step 1. Index the buffers, their pools and their conflicts
+    std::unordered_map<const BufferInfoNode*, int> buf_index;
+    std::unordered_map<PoolInfo, int, ObjectPtrHash, ObjectPtrEqual> pool_index;
+    for (const BufferInfo& buf_info : buffer_info_arr) {
+      buf_index.emplace(buf_info.as<BufferInfoNode>(), static_cast<int>(bufs_.size()));
+      BufferEntry buf;
+      buf.size = buf_info->size_bytes.IntValue();
+      buf.alignment = buf_info->alignment.IntValue();
+      for (const PoolInfo& pool_info : buf_info->pool_candidates) {
+        auto it = pool_index.emplace(pool_info, static_cast<int>(pools_.size())).first;
+        if (it->second == static_cast<int>(pools_.size())) {
+          pools_.push_back(pool_info);
+        }
+        buf.pools.push_back(it->second);
+      }
+      bufs_.push_back(std::move(buf));
+    }
+    // The conflicts are made symmetric, as a buffer may be placed before the ones it lists
+    for (const BufferInfo& buf_info : buffer_info_arr) {
+      int i = buf_index.at(buf_info.as<BufferInfoNode>());
+      for (const ObjectRef& conflict : buf_info->conflicts) {
+        auto it = buf_index.find(conflict.as<BufferInfoNode>());
+        if (it != buf_index.end() && it->second != i) {
+          bufs_[i].conflicts.push_back(it->second);
+          bufs_[it->second].conflicts.push_back(i);
+        }
+      }
+    }
+    for (BufferEntry& buf : bufs_) {
+      std::sort(buf.conflicts.begin(), buf.conflicts.end());
+      buf.conflicts.erase(std::unique(buf.conflicts.begin(), buf.conflicts.end()),
+                          buf.conflicts.end());
+    }
+    // Step 2. Start from the greedy plan
+    best_total_ = 0;
+    std::vector<size_t> greedy_pool_sizes(pools_.size(), 0);
+    for (const auto& kv : greedy_plan) {
+      int pool = pool_index.at(kv.second->pool_info);
+      size_t end = kv.second->byte_offset.IntValue() + kv.first->size_bytes.IntValue();
+      greedy_pool_sizes[pool] = std::max(greedy_pool_sizes[pool], end);
+    }
+    for (size_t pool_size : greedy_pool_sizes) {
+      best_total_ += pool_size;
+    }
+    lower_bound_ = memory_pressure_;
+    for (const BufferEntry& buf : bufs_) {
+      lower_bound_ = std::max(lower_bound_, buf.size);
+    }
+    // Step 3. Search for a better plan
+    placements_.assign(bufs_.size(), Placement());
+    pool_sizes_.assign(pools_.size(), 0);
+    deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms_);
+    Search(0, 0, 0, -1);
+    VLOG(1) << "branch_and_bound visited " << num_nodes_ << " nodes"
+            << (timed_out_ ? ", stopped at the time limit" : "") << ", planned size = "
+            << best_total_ << ", lower bound = " << lower_bound_;
+    if (best_placements_.empty()) {
+      return greedy_plan;
+    }
+    Map<BufferInfo, PoolAllocation> result;
+    for (const BufferInfo& buf_info : buffer_info_arr) {
+      const Placement& placement = best_placements_[buf_index.at(buf_info.as<BufferInfoNode>())];
+      result.Set(buf_info, PoolAllocation(pools_[placement.pool],
+                                          Integer(static_cast<int64_t>(placement.offset))));
+    }
+    return result;
+  }
+
+ private:
+  /*! \brief A buffer to be placed. */
+  struct BufferEntry {
+    /*! \brief The size in bytes */
+    size_t size;
+    /*! \brief The byte alignment of the offset */
+    size_t alignment;
+    /*! \brief The indices of the candidate pools, in order of preference */
+    std::vector<int> pools;
+    /*! \brief The indices of the buffers live at the same time */
+    std::vector<int> conflicts;
+  };
+
+  /*! \brief The placement of a buffer, the pool is -1 if the buffer is not placed yet. */
+  struct Placement {
+    int pool = -1;
+    size_t offset = 0;
+  };
+
+  /*! \brief The number of search nodes visited between two checks of the clock. */
+  static constexpr int64_t kNodesPerClockCheck = 1024;
+
+  /*!
+   * \brief Find the lowest aligned offset of a buffer in a pool left free by the placed conflicts.
+   * \return The offset, or the maximum size_t if the buffer does not fit in the pool.
+   */
+  size_t FirstFit(const BufferEntry& buf, int pool) {
+    std::vector<size_t> offsets{0};
+    for (int c : buf.conflicts) {
+      const Placement& placement = placements_[c];
+      if (placement.pool == pool) {
+        offsets.push_back(round_up_to_byte_alignment(placement.offset + bufs_[c].size,
+                                                     static_cast<int>(buf.alignment)));
+      }
+    }
+    std::sort(offsets.begin(), offsets.end());
+    for (size_t offset : offsets) {
+      if (!IsValidPlacement(pools_[pool], offset, buf.size)) {
+        break;
+      }
+      bool overlaps = false;
+      for (int c : buf.conflicts) {
+        const Placement& placement = placements_[c];
+        if (placement.pool == pool && offset < placement.offset + bufs_[c].size &&
+            placement.offset < offset + buf.size) {
+          overlaps = true;
+          break;
+        }
+      }
+      if (!overlaps) {
+        return offset;
+      }
+    }
+    return std::numeric_limits<size_t>::max();
+  }
+
+  /*!
+   * \brief Extend the partial plan by every buffer that can be placed next.
+   * \param num_placed The number of the placed buffers.
+   * \param total The sum of the sizes of the pools of the partial plan.
+   * \param last_offset The offset of the last placed buffer.
+   * \param last_buf The index of the last placed buffer.
+   */
+  void Search(size_t num_placed, size_t total, size_t last_offset, int last_buf) {
+    if (++num_nodes_ % kNodesPerClockCheck == 0 && std::chrono::steady_clock::now() > deadline_) {
+      timed_out_ = true;
+    }
+    if (timed_out_) {
+      return;
+    }
+    if (num_placed == bufs_.size()) {
+      best_total_ = total;
+      best_placements_ = placements_;
+      return;
+    }
+    // Every buffer left ends above the last offset, in some pool
+    size_t bound = total;
+    for (size_t i = 0; i < bufs_.size(); ++i) {
+      if (placements_[i].pool == -1) {
+        bound = std::max(bound, last_offset + bufs_[i].size);
+      }
+    }
+    if (bound >= best_total_) {
+      return;
+    }
+    // Collect the next placements, keeping the plan ordered by offset then by index
+    struct Candidate {
+      size_t total;
+      int buf;
+      int pool;
+      size_t offset;
+    };
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < bufs_.size(); ++i) {
+      if (placements_[i].pool != -1) {
+        continue;
+      }
+      const BufferEntry& buf = bufs_[i];
+      for (int pool : buf.pools) {
+        size_t offset = FirstFit(buf, pool);
+        if (offset == std::numeric_limits<size_t>::max() || offset < last_offset ||
+            (offset == last_offset && static_cast<int>(i) < last_buf)) {
+          continue;
+        }
+        size_t pool_size = std::max(pool_sizes_[pool], offset + buf.size);
+        size_t new_total = total - pool_sizes_[pool] + pool_size;
+        if (new_total < best_total_) {
+          candidates.push_back({new_total, static_cast<int>(i), pool, offset});
+        }
+      }
+    }
+    // Try the cheapest placements first, so that good plans tighten the bound early
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) { return a.total < b.total; });
+    for (const Candidate& candidate : candidates) {
+      if (candidate.total >= best_total_) {
+        continue;
+      }
+      size_t saved_pool_size = pool_sizes_[candidate.pool];
+      placements_[candidate.buf] = {candidate.pool, candidate.offset};
+      pool_sizes_[candidate.pool] =
+          std::max(saved_pool_size, candidate.offset + bufs_[candidate.buf].size);
+      Search(num_placed + 1, candidate.total, candidate.offset, candidate.buf);
+      pool_sizes_[candidate.pool] = saved_pool_size;
+      placements_[candidate.buf] = Placement();
+      if (timed_out_ || best_total_ <= lower_bound_) {
+        return;
+      }
+    }
+  }
+
+  /*! \brief The memory pressure of the buffers. */
+  size_t memory_pressure_;
+  /*! \brief The time limit of the search in milliseconds. */
+  int64_t time_limit_ms_;
+  /*! \brief The buffers to be placed. */
+  std::vector<BufferEntry> bufs_;
+  /*! \brief The pools that the buffers can be placed in. */
+  std::vector<PoolInfo> pools_;
+  /*! \brief The placement of each buffer in the partial plan. */
+  std::vector<Placement> placements_;
+  /*! \brief The size of each pool in the partial plan. */
+  std::vector<size_t> pool_sizes_;
+  /*! \brief The placement of each buffer in the best plan, empty if no plan beat the greedy one. */
+  std::vector<Placement> best_placements_;
+  /*! \brief The total size of the pools in the best plan. */
+  size_t best_total_ = 0;
+  /*! \brief The lower bound of the total size of the pools of any plan. */
+  size_t lower_bound_ = 0;
+  /*! \brief The time at which the search stops. */
+  std::chrono::steady_clock::time_point deadline_;
+  /*! \brief The number of search nodes visited. */
+  int64_t num_nodes_ = 0;
+  /*! \brief Whether the search stopped at the time limit. */
+  bool timed_out_ = false;
+};
+
+Map<BufferInfo, PoolAllocation> BranchAndBound(const Array<BufferInfo>& buffer_info_arr,
+                                               const Integer& memory_pressure) {
+  int64_t time_limit_ms =
+      transform::PassContext::Current()
+          ->GetConfig<Integer>(kUSMPTimeLimitOption, Integer(kDefaultBranchAndBoundTimeLimitMs))
+          .value()
+          .IntValue();
+  if (time_limit_ms <= 0) {
+    time_limit_ms = kDefaultBranchAndBoundTimeLimitMs;
+  }
+  return BranchAndBoundAllocator(memory_pressure.IntValue(), time_limit_ms)
+      .PlanMemory(buffer_info_arr);
+}
+
+TVM_REGISTER_GLOBAL("tir.usmp.algo.branch_and_bound")
+    .set_body_typed([](Array<BufferInfo> buffer_info_arr, Integer memory_pressure) {
+      return BranchAndBound(buffer_info_arr, memory_pressure);
+    });
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
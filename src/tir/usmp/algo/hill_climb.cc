@@ -22,6 +22,7 @@
  * \brief Implement greedy by size memory planning algorithm
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/function.h>
@@ -30,6 +31,7 @@
 #include <tvm/tir/usmp/utils.h>
 
 #include <algorithm>
+#include <chrono>
 #include <numeric>
 #include <sstream>
 
@@ -45,14 +47,18 @@ namespace algo {
  * assessing the result, and introducing permutations to the allocation
  * order which hopefully will led to more 'compact' memory allocation.
  * Do not forget to use srand for repeatable results
+ *
+ * With a positive time limit the permutations are tried until the time runs
+ * out instead of a fixed number of attempts.
  */
 class HillClimbAllocator : public GreedyBase {
  private:
   size_t memory_pressure_ = 0;
+  int64_t time_limit_ms_ = 0;
 
  public:
-  explicit HillClimbAllocator(size_t memory_pressure)
-      : GreedyBase(), memory_pressure_(memory_pressure) {}
+  explicit HillClimbAllocator(size_t memory_pressure, int64_t time_limit_ms = 0)
+      : GreedyBase(), memory_pressure_(memory_pressure), time_limit_ms_(time_limit_ms) {}
 
  protected:
   using alloc_map_t = std::unordered_map<const BufferInfoNode*, PoolAllocation>;
@@ -251,7 +257,16 @@ class HillClimbAllocator : public GreedyBase {
       LOG(FATAL) << "node is not indexed in the _pos_map";
     };
 
-    for (; attempts < _max_attempts; ++attempts) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms_);
+    auto keep_trying = [&]() {
+      if (time_limit_ms_ > 0) {
+        // the first attempt is always made, as it is the greedy-by-size plan
+        return attempts == 0 || std::chrono::steady_clock::now() < deadline;
+      }
+      return attempts < _max_attempts;
+    };
+
+    for (; keep_trying(); ++attempts) {
       rollback_pool_allocations = std::move(pool_allocations);
       bool could_not_fit = false;
       pool_allocations = std::move(greedy(buffer_info_vec, &could_not_fit));
@@ -361,7 +376,12 @@ class HillClimbAllocator : public GreedyBase {
 
 Map<BufferInfo, PoolAllocation> HillClimb(const Array<BufferInfo>& buffer_info_arr,
                                           const Integer& memory_pressure) {
-  return HillClimbAllocator(memory_pressure.IntValue()).PlanMemory(buffer_info_arr);
+  int64_t time_limit_ms = transform::PassContext::Current()
+                              ->GetConfig<Integer>(kUSMPTimeLimitOption, Integer(0))
+                              .value()
+                              .IntValue();
+  return HillClimbAllocator(memory_pressure.IntValue(), time_limit_ms)
+      .PlanMemory(buffer_info_arr);
 }
 
 TVM_REGISTER_GLOBAL("tir.usmp.algo.hill_climb")
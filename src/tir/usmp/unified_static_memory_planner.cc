@@ -35,6 +35,7 @@
 
 #include <algorithm>
 #include <string>
+#include <unordered_map>
 
 namespace tvm {
 
@@ -42,6 +43,7 @@ TVM_REGISTER_PASS_CONFIG_OPTION(kUSMPEnableOption, Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION(kUSMPAlgorithmOption, String);
 TVM_REGISTER_PASS_CONFIG_OPTION(kUSMPUseWorkspaceIO, Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION(kUSMPCustomAlgorithmOption, String);
+TVM_REGISTER_PASS_CONFIG_OPTION(kUSMPTimeLimitOption, Integer);
 
 namespace tir {
 namespace usmp {
@@ -52,7 +54,8 @@ static std::unordered_map<String, std::function<Map<BufferInfo, PoolAllocation>(
                                       const Array<BufferInfo>&, const Integer&)>>
     algorithms{{"greedy_by_size", algo::GreedyBySize},
                {"greedy_by_conflicts", algo::GreedyByConflicts},
-               {"hill_climb", algo::HillClimb}};
+               {"hill_climb", algo::HillClimb},
+               {"branch_and_bound", algo::BranchAndBound}};
 
 IRModule PlanMemory(const IRModule& mod, String algo, bool use_workspace_io,
                     Optional<String> opt_custom_algo) {
@@ -81,6 +84,23 @@ IRModule PlanMemory(const IRModule& mod, String algo, bool use_workspace_io,
   }
   Map<BufferInfo, PoolAllocation> buffer_info_pool_allocations =
       algorithm(buffer_info_arr, buffer_info_analysis->memory_pressure);
+  // The live bytes at the busiest point of the program are a lower bound of any plan
+  std::unordered_map<PoolInfo, size_t, ObjectPtrHash, ObjectPtrEqual> pool_sizes;
+  for (const auto& kv : buffer_info_pool_allocations) {
+    size_t end = kv.second->byte_offset.IntValue() + kv.first->size_bytes.IntValue();
+    pool_sizes[kv.second->pool_info] = std::max(pool_sizes[kv.second->pool_info], end);
+  }
+  size_t planned_size = 0;
+  for (const auto& kv : pool_sizes) {
+    planned_size += kv.second;
+  }
+  int64_t lower_bound = buffer_info_analysis->memory_pressure.IntValue();
+  VLOG(1) << "planned size = " << planned_size << ", lower bound = " << lower_bound
+          << ", gap = "
+          << (lower_bound > 0 ? 100.0 * (static_cast<double>(planned_size) - lower_bound) /
+                                    static_cast<double>(lower_bound)
+                              : 0.0)
+          << "%";
 
   Map<Stmt, PoolAllocation> stmt_pool_allocations = AssignStmtPoolAllocations(
       buffer_info_analysis->buffer_info_stmts, buffer_info_pool_allocations);
@@ -20,6 +20,8 @@
 #include <gtest/gtest.h>
 #include <tvm/runtime/logging.h>
 
+#include <cstring>
+
 #include "../src/runtime/hexagon/hexagon_device_api.h"
 #include "../src/runtime/hexagon/hexagon_thread_manager.h"
 
@@ -359,3 +361,70 @@ TEST_F(HexagonThreadManagerTest, threads_for_resource_types) {
   thread = reinterpret_cast<TVMStreamHandle>(6);
   EXPECT_THROW(thread_manager->GetResourceTypeForStreamHandle(thread), InternalError);
 }
+
+TEST_F(HexagonThreadManagerTest, parallel_for) {
+  // Without hardware resources, every thread is a worker
+  CHECK_EQ(htm->NumParallelWorkers(), threads);
+  std::vector<int> task_worker(100, -1);
+  htm->ParallelFor(task_worker.size(), [&](int task, int worker, void* scratch) {
+    CHECK(scratch == nullptr);
+    task_worker[task] = worker;
+  });
+  for (int i = 0; i < task_worker.size(); ++i) {
+    CHECK_EQ(task_worker[i], i % threads);
+  }
+  // Zero tasks is a no-op
+  htm->ParallelFor(0, [](int, int, void*) { CHECK(false); });
+}
+
+TEST_F(HexagonThreadManagerTest, parallel_for_scratch) {
+  std::vector<char*> scratches(threads, nullptr);
+  const size_t scratch_bytes = 1000;
+  auto fill_scratch = [&](int, int worker, void* scratch) {
+    scratches[worker] = static_cast<char*>(scratch);
+    memset(scratch, worker, scratch_bytes);
+  };
+  htm->ParallelFor(threads, fill_scratch, scratch_bytes);
+  for (int i = 1; i < threads; ++i) {
+    // Each worker gets its own slice of VTCM
+    CHECK_GE(scratches[i] - scratches[i - 1], scratch_bytes);
+  }
+}
+
+TEST_F(HexagonThreadManagerTest, parallel_for_exception) {
+  EXPECT_THROW(htm->ParallelFor(threads,
+                                [](int task, int, void*) {
+                                  if (task == 3) {
+                                    LOG(FATAL) << "Task failed";
+                                  }
+                                }),
+               InternalError);
+  // The workers are still usable
+  int answer = 0;
+  htm->ParallelFor(1, [&answer](int, int, void*) { answer = 42; });
+  CHECK_EQ(answer, 42);
+}
+
+TEST_F(HexagonThreadManagerTest, parallel_for_nested) {
+  std::vector<int> inner_workers(threads, -1);
+  htm->ParallelFor(threads, [&](int task, int, void*) {
+    // Nested parallel-fors run serially on the calling worker
+    CHECK_EQ(htm->NumParallelWorkers(), 1);
+    htm->ParallelFor(1, [&](int, int worker, void*) { inner_workers[task] = worker; });
+  });
+  for (int worker : inner_workers) {
+    CHECK_EQ(worker, 0);
+  }
+}
+
+// Validate parallel-for runs on the threads holding an HVX instance on global manager
+TEST_F(HexagonThreadManagerTest, parallel_for_on_hvx_threads) {
+  HexagonThreadManager* thread_manager = HexagonDeviceAPI::Global()->ThreadManager();
+  CHECK_EQ(thread_manager->NumParallelWorkers(), 4);
+  std::vector<int> task_worker(8, -1);
+  thread_manager->ParallelFor(task_worker.size(),
+                              [&](int task, int worker, void*) { task_worker[task] = worker; });
+  for (int i = 0; i < task_worker.size(); ++i) {
+    CHECK_EQ(task_worker[i], i % 4);
+  }
+}
@@ -285,3 +285,56 @@ TEST_F(HexagonVtcmPoolTest, vtcm_alignment) {
   ptr = vtcm_pool->Allocate(max_bytes);
   vtcm_pool->Free(ptr, max_bytes);
 }
+
+TEST_F(HexagonVtcmPoolTest, best_fit_from_end) {
+  void* ptr1 = vtcm_pool->Allocate(four_k_block);
+  void* ptr2 = vtcm_pool->Allocate(two_k_block);
+  void* ptr3 = vtcm_pool->Allocate(two_k_block);
+  void* ptr4 = vtcm_pool->Allocate(max_bytes - 2 * four_k_block);
+
+  // Leave a 4k and a 2k hole, the last free segment is the smaller one.
+  vtcm_pool->Free(ptr1, four_k_block);
+  vtcm_pool->Free(ptr3, two_k_block);
+
+  // A non 2k aligned block that only fits into the first hole is placed at its end.
+  size_t three_k_block = two_k_block + one_k_block;
+  void* new_ptr = vtcm_pool->Allocate(three_k_block);
+  CHECK(static_cast<char*>(new_ptr) == static_cast<char*>(ptr1) + one_k_block);
+
+  vtcm_pool->Free(new_ptr, three_k_block);
+  vtcm_pool->Free(ptr2, two_k_block);
+  vtcm_pool->Free(ptr4, max_bytes - 2 * four_k_block);
+
+  // Make sure at the end we have the full amount available again
+  ptr1 = vtcm_pool->Allocate(max_bytes);
+  vtcm_pool->Free(ptr1, max_bytes);
+}
+
+TEST_F(HexagonVtcmPoolTest, stats) {
+  HexagonVtcmPoolStats stats = vtcm_pool->GetStats();
+  CHECK_EQ(stats.used_bytes, 0);
+  CHECK_EQ(stats.free_bytes, max_bytes);
+  CHECK_EQ(stats.largest_free_segment, max_bytes);
+  size_t num_failures = stats.num_failures;
+
+  void* ptr1 = vtcm_pool->Allocate(two_k_block);
+  void* ptr2 = vtcm_pool->Allocate(two_k_block);
+  void* ptr3 = vtcm_pool->Allocate(max_bytes - 2 * two_k_block);
+  vtcm_pool->Free(ptr1, two_k_block);
+  EXPECT_THROW(vtcm_pool->Allocate(four_k_block), InternalError);
+
+  stats = vtcm_pool->GetStats();
+  CHECK_EQ(stats.num_allocations, 2);
+  CHECK_EQ(stats.num_failures, num_failures + 1);
+  CHECK_EQ(stats.used_bytes, max_bytes - two_k_block);
+  CHECK_EQ(stats.peak_used_bytes, max_bytes);
+  CHECK_EQ(stats.free_bytes, two_k_block);
+  CHECK_EQ(stats.num_free_segments, 1);
+  CHECK_EQ(stats.largest_free_segment, two_k_block);
+
+  vtcm_pool->Free(ptr2, two_k_block);
+  vtcm_pool->Free(ptr3, max_bytes - 2 * two_k_block);
+  stats = vtcm_pool->GetStats();
+  CHECK_EQ(stats.num_allocations, 0);
+  CHECK_EQ(stats.largest_free_segment, max_bytes);
+}
@@ -411,3 +411,48 @@ TEST_F(QueuedRingBufferTest, two_queues_two_groups_of_two) {
   ASSERT_EQ(queued_ring_buff->InFlight(0), 0);
   ASSERT_EQ(queued_ring_buff->InFlight(1), 0);
 }
+
+TEST_F(QueuedRingBufferTest, full_does_not_count) {
+  std::vector<int*> ptrs;
+  for (uint32_t i = 0; i < size; ++i) {
+    int* ptr = queued_ring_buff->Next(0);
+    *ptr = inflight;
+    ptrs.push_back(ptr);
+  }
+  ASSERT_EQ(queued_ring_buff->InFlight(0), size);
+
+  // full => nothing is queued, retries do not change the count
+  ASSERT_EQ(queued_ring_buff->Next(0), nullptr);
+  ASSERT_EQ(queued_ring_buff->Next(1), nullptr);
+  ASSERT_EQ(queued_ring_buff->InFlight(0), size);
+  ASSERT_EQ(queued_ring_buff->InFlight(1), 0);
+
+  for (int* ptr : ptrs) {
+    *ptr = finished;
+  }
+  ASSERT_EQ(queued_ring_buff->InFlight(0), 0);
+}
+
+TEST_F(QueuedRingBufferTest, grouped_wrap) {
+  // several groups in flight on one queue, wrapping the ring buffer many times
+  for (uint32_t iter = 0; iter < 4 * size; ++iter) {
+    queued_ring_buff->StartGroup(0);
+    int* g0_0 = queued_ring_buff->Next(0);
+    *g0_0 = inflight;
+    int* g0_1 = queued_ring_buff->Next(0);
+    *g0_1 = inflight;
+    queued_ring_buff->EndGroup(0);
+
+    int* q1 = queued_ring_buff->Next(1);
+    *q1 = inflight;
+
+    ASSERT_EQ(queued_ring_buff->InFlight(0), 1);
+    ASSERT_EQ(queued_ring_buff->InFlight(1), 1);
+    *g0_0 = finished;
+    *g0_1 = finished;
+    ASSERT_EQ(queued_ring_buff->InFlight(0), 0);
+    ASSERT_EQ(queued_ring_buff->InFlight(1), 1);
+    *q1 = finished;
+    ASSERT_EQ(queued_ring_buff->InFlight(1), 0);
+  }
+}
@@ -41,7 +41,18 @@ class PoolWrapper : public Pool2D {
   }
 };
 
-TEST(OpenCLTexturePool, textures_reallocation_optimal_size) {
+TEST(OpenCLTexturePool, size_classes) {
+  EXPECT_EQ(Pool2D::SizeClass(4), 4);
+  EXPECT_EQ(Pool2D::SizeClass(9), 10);
+  EXPECT_EQ(Pool2D::SizeClass(100), 112);
+  EXPECT_EQ(Pool2D::SizeClass(768), 768);
+  EXPECT_EQ(Pool2D::SizeClass(1024), 1024);
+  EXPECT_EQ(Pool2D::SizeClass(1025), 1280);
+  EXPECT_EQ(Pool2D::SizeClass(12455), 14336);
+  EXPECT_EQ(Pool2D::SizeClass(16384), 16384);
+}
+
+TEST(OpenCLTexturePool, textures_reuse_size_classes) {
   OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
   OpenCLThreadEntry* t = workspace->GetThreadEntry();
   PoolWrapper pool;
@@ -49,7 +60,7 @@ TEST(OpenCLTexturePool, textures_reallocation_optimal_size) {
   EXPECT_EQ(pool.FreeListSize(), 0);
 
   DLDataType type{kDLFloat, 16, 1};
-  void* data1 = pool.Alloc(t->device, workspace, 1024, 768, type);
+  void* data1 = pool.Alloc(t->device, workspace, 1000, 700, type);
   EXPECT_EQ(pool.AllocatedListSize(), 1);
   EXPECT_EQ(pool.FreeListSize(), 0);
   auto item = pool.AllocatedListItemSize(0);
@@ -61,91 +72,95 @@ TEST(OpenCLTexturePool, textures_reallocation_optimal_size) {
   EXPECT_EQ(pool.FreeListSize(), 0);
   item = pool.AllocatedListItemSize(1);
   EXPECT_EQ(item.first, 64);
-  EXPECT_EQ(item.second, 12455);
+  EXPECT_EQ(item.second, 14336);
 
   pool.Free(data1);
   EXPECT_EQ(pool.AllocatedListSize(), 1);
   EXPECT_EQ(pool.FreeListSize(), 1);
-  item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 64);
-  EXPECT_EQ(item.second, 12455);
   item = pool.FreeListItemSize(0);
   EXPECT_EQ(item.first, 1024);
   EXPECT_EQ(item.second, 768);
 
-  pool.Alloc(t->device, workspace, 768, 1024, type);
+  // The freed texture holds the request.
+  void* data3 = pool.Alloc(t->device, workspace, 1000, 600, type);
+  EXPECT_EQ(data3, data1);
   EXPECT_EQ(pool.AllocatedListSize(), 2);
   EXPECT_EQ(pool.FreeListSize(), 0);
-  item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 64);
-  EXPECT_EQ(item.second, 12455);
+  pool.Free(data3);
+
+  // The freed texture does not hold the request.
+  pool.Alloc(t->device, workspace, 768, 1024, type);
+  EXPECT_EQ(pool.AllocatedListSize(), 2);
+  EXPECT_EQ(pool.FreeListSize(), 1);
   item = pool.AllocatedListItemSize(1);
-  EXPECT_EQ(item.first, 1024);
+  EXPECT_EQ(item.first, 768);
   EXPECT_EQ(item.second, 1024);
+
+  const TexturePoolStats& stats = pool.GetStats();
+  EXPECT_EQ(stats.num_hits, 1);
+  EXPECT_EQ(stats.num_misses, 3);
+  EXPECT_EQ(stats.free_bytes, 1024 * 768 * 4 * 2);
+  pool.Release(t->device, workspace);
 }
 
 TEST(OpenCLTexturePool, avoid_reusing_too_big_textures) {
   OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
   OpenCLThreadEntry* t = workspace->GetThreadEntry();
   PoolWrapper pool;
-  EXPECT_EQ(pool.AllocatedListSize(), 0);
-  EXPECT_EQ(pool.FreeListSize(), 0);
 
   DLDataType type{kDLFloat, 16, 1};
   void* data1 = pool.Alloc(t->device, workspace, 12455, 64, type);
-  EXPECT_EQ(pool.AllocatedListSize(), 1);
-  EXPECT_EQ(pool.FreeListSize(), 0);
-  auto item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 12455);
-  EXPECT_EQ(item.second, 64);
-
   pool.Free(data1);
   EXPECT_EQ(pool.AllocatedListSize(), 0);
   EXPECT_EQ(pool.FreeListSize(), 1);
-  item = pool.FreeListItemSize(0);
-  EXPECT_EQ(item.first, 12455);
-  EXPECT_EQ(item.second, 64);
 
-  pool.Alloc(t->device, workspace, 1024, 768, type);
+  pool.Alloc(t->device, workspace, 1024, 64, type);
   EXPECT_EQ(pool.AllocatedListSize(), 1);
   EXPECT_EQ(pool.FreeListSize(), 1);
-  item = pool.FreeListItemSize(0);
-  EXPECT_EQ(item.first, 12455);
+  auto item = pool.FreeListItemSize(0);
+  EXPECT_EQ(item.first, 14336);
   EXPECT_EQ(item.second, 64);
   item = pool.AllocatedListItemSize(0);
   EXPECT_EQ(item.first, 1024);
-  EXPECT_EQ(item.second, 768);
+  EXPECT_EQ(item.second, 64);
+  pool.Release(t->device, workspace);
 }
 
-TEST(OpenCLTexturePool, avoid_reusing_too_small_textures) {
+TEST(OpenCLTexturePool, avoid_reusing_other_types) {
   OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
   OpenCLThreadEntry* t = workspace->GetThreadEntry();
   PoolWrapper pool;
-  EXPECT_EQ(pool.AllocatedListSize(), 0);
-  EXPECT_EQ(pool.FreeListSize(), 0);
-
-  DLDataType type{kDLFloat, 16, 1};
-  void* data1 = pool.Alloc(t->device, workspace, 1024, 64, type);
-  EXPECT_EQ(pool.AllocatedListSize(), 1);
-  EXPECT_EQ(pool.FreeListSize(), 0);
-  auto item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 1024);
-  EXPECT_EQ(item.second, 64);
 
+  void* data1 = pool.Alloc(t->device, workspace, 1024, 64, DLDataType{kDLFloat, 16, 1});
   pool.Free(data1);
-  EXPECT_EQ(pool.AllocatedListSize(), 0);
+  void* data2 = pool.Alloc(t->device, workspace, 1024, 64, DLDataType{kDLFloat, 32, 1});
+  EXPECT_NE(data1, data2);
   EXPECT_EQ(pool.FreeListSize(), 1);
-  item = pool.FreeListItemSize(0);
-  EXPECT_EQ(item.first, 1024);
-  EXPECT_EQ(item.second, 64);
+  pool.Release(t->device, workspace);
+}
 
-  pool.Alloc(t->device, workspace, 12544, 64, type);
-  EXPECT_EQ(pool.AllocatedListSize(), 1);
+TEST(OpenCLTexturePool, memory_budget_trims_least_recently_freed) {
+  OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
+  OpenCLThreadEntry* t = workspace->GetThreadEntry();
+  PoolWrapper pool;
+
+  DLDataType type{kDLFloat, 16, 1};
+  const size_t texture_bytes = 1024 * 1024 * 4 * 2;
+  void* data1 = pool.Alloc(t->device, workspace, 1024, 1024, type);
+  void* data2 = pool.Alloc(t->device, workspace, 512, 1024, type);
+  pool.Free(data1);
+  pool.Free(data2);
+  EXPECT_EQ(pool.FreeListSize(), 2);
+
+  pool.SetMemoryBudget(t->device, workspace, texture_bytes);
   EXPECT_EQ(pool.FreeListSize(), 1);
-  item = pool.FreeListItemSize(0);
-  EXPECT_EQ(item.first, 1024);
-  EXPECT_EQ(item.second, 64);
-  item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 12544);
-  EXPECT_EQ(item.second, 64);
+  auto item = pool.FreeListItemSize(0);
+  EXPECT_EQ(item.first, 512);
+  EXPECT_EQ(item.second, 1024);
+
+  pool.Alloc(t->device, workspace, 1024, 1024, type);
+  EXPECT_EQ(pool.FreeListSize(), 0);
+  EXPECT_EQ(pool.GetStats().num_trims, 2);
+  EXPECT_EQ(pool.GetStats().allocated_bytes, texture_bytes);
+  pool.Release(t->device, workspace);
 }
@@ -22,6 +22,7 @@
 #include <tvm/runtime/container/adt.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/container/variant.h>
 #include <tvm/tir/function.h>
@@ -33,6 +34,7 @@
 #include <iterator>
 #include <new>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -900,3 +902,34 @@ TEST(Variant, AssignmentFromVariant) {
   ICHECK(variant2.as<String>());
   ICHECK_EQ(variant2.as<String>().value(), "hello");
 }
+
+TEST(ShapeTuple, InplaceStorage) {
+  std::vector<int64_t> dims{1, 2, 3};
+  ShapeTuple inplace(dims.begin(), dims.end());
+  ShapeTuple from_vector(dims);
+  ICHECK_EQ(inplace.size(), 3U);
+  ICHECK_EQ(inplace->Product(), 6);
+  ICHECK(std::equal(inplace.begin(), inplace.end(), from_vector.begin(), from_vector.end()));
+  // The elements are stored right after the object header.
+  ICHECK_EQ(reinterpret_cast<const char*>(inplace.data()),
+            reinterpret_cast<const char*>(inplace.get()) + sizeof(ShapeTupleObj));
+  ShapeTuple empty(dims.begin(), dims.begin());
+  ICHECK(empty.empty());
+}
+
+TEST(PoolObjAllocator, Reuse) {
+  const Object* first = ShapeTuple({1, 2}).get();
+  ShapeTuple second{3, 4};
+#if !defined(__SANITIZE_ADDRESS__)
+  // The block of a released object is reused by the next allocation of the same size.
+  ICHECK_EQ(first, second.get());
+#endif
+  ICHECK_EQ(second[1], 4);
+
+  // Objects can be released on a different thread than the one that created them.
+  Array<ObjectRef> arr{second, String("x")};
+  std::thread([arr = std::move(arr)]() mutable { arr = Array<ObjectRef>(); }).join();
+  Array<ObjectRef> arr2;
+  for (int i = 0; i < 100; ++i) arr2.push_back(ShapeTuple({i}));
+  ICHECK_EQ(arr2.size(), 100U);
+}
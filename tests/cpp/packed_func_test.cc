@@ -319,3 +319,43 @@ TEST(TypedPackedFunc, RValue) {
     tf(1, true);
   }
 }
+
+int64_t DirectCallTestAdd(int64_t a, int64_t b) { return a + b; }
+
+TVM_REGISTER_GLOBAL("testing.direct_call_add").set_body_typed(DirectCallTestAdd);
+TVM_REGISTER_GLOBAL("testing.direct_call_concat")
+    .set_body_typed([](tvm::runtime::String a, tvm::runtime::String b) -> tvm::runtime::String {
+      return a + b;
+    });
+
+TEST(Registry, DirectCall) {
+  using namespace tvm::runtime;
+  auto* fadd = Registry::GetDirect<int64_t(int64_t, int64_t)>("testing.direct_call_add");
+  ASSERT_EQ(fadd, &DirectCallTestAdd);
+  // The signature must match exactly.
+  ASSERT_EQ(Registry::GetDirect<int(int, int)>("testing.direct_call_add"), nullptr);
+  ASSERT_EQ(Registry::GetDirect<int64_t(int64_t, int64_t)>("testing.does_not_exist"), nullptr);
+
+  auto* fconcat = Registry::GetDirect<String(String, String)>("testing.direct_call_concat");
+  ASSERT_NE(fconcat, nullptr);
+  ASSERT_EQ(fconcat("a", "b"), "ab");
+
+  DirectCall direct = Registry::GetDirectCall("testing.direct_call_add");
+  ASSERT_TRUE(direct);
+  TVMValue values[2];
+  int tcodes[2];
+  TVMArgsSetter setter(values, tcodes);
+  setter(0, 1);
+  setter(1, 2);
+  TVMRetValue rv;
+  direct(TVMArgs(values, tcodes, 2), &rv);
+  int64_t ret = rv;
+  ASSERT_EQ(ret, 3);
+  EXPECT_THROW(direct(TVMArgs(values, tcodes, 1), &rv), tvm::Error);
+
+  // Overriding the body with an untyped PackedFunc drops the direct call.
+  Registry::Register("testing.direct_call_concat", true)
+      .set_body([](TVMArgs args, TVMRetValue* rv) { *rv = String("c"); });
+  ASSERT_EQ(Registry::GetDirect<String(String, String)>("testing.direct_call_concat"), nullptr);
+  ASSERT_FALSE(Registry::GetDirectCall("testing.direct_call_concat"));
+}
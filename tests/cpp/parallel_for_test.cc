@@ -22,6 +22,7 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
+#include <atomic>
 #include <thread>
 #include <vector>
 
@@ -92,20 +93,17 @@ TEST(ParallelFor, NestedWithNormalForLoop) {
 }
 
 TEST(ParallelFor, NestedWithParallelFor) {
-  // Currently do not support using nested parallel_for
   using tvm::support::parallel_for;
 
-  bool exception = false;
-  try {
-    parallel_for(0, 100, [](int i) {
-      parallel_for(0, 100, [](int j) {
-        // Blank loop
-      });
-    });
-  } catch (const std::exception& e) {
-    exception = true;
+  int a[100][100];
+  parallel_for(0, 100, [&a](int i) {
+    parallel_for(0, 100, [&a, i](int j) { a[i][j] = i * j; });
+  });
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 100; j++) {
+      ICHECK_EQ(a[i][j], i * j);
+    }
   }
-  ICHECK(exception);
 }
 
 TEST(ParallelFor, Exception) {
@@ -130,6 +128,22 @@ TEST(ParallelForDynamic, Basic) {
   }
 }
 
+TEST(ParallelForDynamic, UniqueThreadId) {
+  using tvm::support::parallel_for_dynamic;
+  int num_threads = 4;
+  std::vector<std::atomic<int>> running(num_threads);
+  std::atomic<bool> overlapped{false};
+  parallel_for_dynamic(0, 1000, num_threads, [&](int thread_id, int task_id) {
+    if (running[thread_id]++ != 0) {
+      overlapped = true;
+    }
+    // The thread may run other queued tasks while waiting for the nested loop.
+    parallel_for_dynamic(0, 4, 2, [](int thread_id, int task_id) {});
+    --running[thread_id];
+  });
+  ICHECK(!overlapped);
+}
+
 TEST(ParallelForDynamic, ExceptionOnMain) {
   using tvm::support::parallel_for_dynamic;
   int num_threads = 1;
@@ -22,7 +22,10 @@
 #include <tvm/runtime/memory/memory_manager.h>
 
 #include <exception>
+#include <thread>
 
+#include "../../../../src/runtime/memory/bucketed_allocator.h"
+#include "../../../../src/runtime/memory/pinned_allocator.h"
 #include "../../../../src/runtime/memory/pooled_allocator.h"
 
 namespace tvm {
@@ -71,6 +74,30 @@ TEST_F(TvmVMMemoryManagerTest, PooledAllocBasic) {
   EXPECT_EQ(allocator->UsedMemory(), size);
 }
 
+TEST_F(TvmVMMemoryManagerTest, PooledThreadCacheFlush) {
+  Device dev = {kDLCPU, 0};
+  size_t page_size = PooledAllocator::kDefaultPageSize;
+  PooledAllocator allocator(page_size, /*thread_cache_bytes=*/page_size);
+  auto a = allocator.Alloc(dev, page_size, 32, DataType::Float(32));
+  auto b = allocator.Alloc(dev, page_size, 32, DataType::Float(32));
+  EXPECT_EQ(allocator.UsedMemory(), 2 * page_size);
+  allocator.Free(a);
+  // Exceeds the per-thread cap, so `a` is flushed to the shared pool.
+  allocator.Free(b);
+  std::thread([&]() {
+    auto c = allocator.Alloc(dev, page_size, 32, DataType::Float(32));
+    EXPECT_EQ(c.data, a.data);
+    allocator.Free(c);
+  }).join();
+  EXPECT_EQ(allocator.UsedMemory(), 2 * page_size);
+  // The buffer cached by this thread is reused.
+  auto d = allocator.Alloc(dev, page_size, 32, DataType::Float(32));
+  EXPECT_EQ(d.data, b.data);
+  allocator.Free(d);
+  allocator.Clear();
+  EXPECT_EQ(allocator.UsedMemory(), 0);
+}
+
 TEST_F(TvmVMMemoryManagerTest, NaiveEmptyBasic) {
   Device dev = {kDLCPU, 0};
   Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kNaive);
@@ -202,6 +229,95 @@ TEST_F(TvmVMMemoryManagerTest, PooledAllocOpenCLTexture) {
     EXPECT_NE(what.find(pattern), std::string::npos) << what;
   }
 }
+
+TEST_F(TvmVMMemoryManagerTest, BucketedAllocBestFit) {
+  Device dev = {kDLCPU, 0};
+  size_t page_size = BucketedAllocator::kDefaultPageSize;
+  auto* allocator =
+      static_cast<BucketedAllocator*>(MemoryManagerWrapper::GetOrCreateAllocator(dev, kBucketed));
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+  auto buff = allocator->Alloc(dev, 3 * page_size, 32, DataType::Float(32));
+  EXPECT_EQ(buff.size, 3 * page_size);
+  allocator->Free(buff);
+  EXPECT_EQ(allocator->GetStats().bytes_cached, 3 * page_size);
+
+  // A request that does not fit in one page reuses the cached three-page block.
+  auto reused = allocator->Alloc(dev, page_size + 4, 32, DataType::Float(32));
+  EXPECT_EQ(reused.data, buff.data);
+  EXPECT_EQ(reused.size, 3 * page_size);
+  auto stats = allocator->GetStats();
+  EXPECT_EQ(stats.num_device_allocs, 1);
+  EXPECT_EQ(stats.num_reuses, 1);
+  EXPECT_EQ(stats.bytes_in_use, 3 * page_size);
+  EXPECT_EQ(stats.bytes_cached, 0);
+  EXPECT_EQ(stats.bytes_requested, page_size + 4);
+  EXPECT_GT(stats.FragmentationRatio(), 0.0);
+
+  // A much smaller request does not take the large block.
+  allocator->Free(reused);
+  auto small = allocator->Alloc(dev, 16, 32, DataType::Float(32));
+  EXPECT_NE(small.data, buff.data);
+  EXPECT_EQ(small.size, page_size);
+  allocator->Free(small);
+  EXPECT_EQ(allocator->UsedMemory(), 4 * page_size);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedSizeClass) {
+  BucketedAllocator allocator(1);
+  EXPECT_EQ(allocator.SizeClass(0), 1);
+  EXPECT_EQ(allocator.SizeClass(4), 4);
+  EXPECT_EQ(allocator.SizeClass(7), 7);
+  EXPECT_EQ(allocator.SizeClass(9), 10);
+  EXPECT_EQ(allocator.SizeClass(17), 20);
+  EXPECT_EQ(allocator.SizeClass(100), 112);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedEmptyBasic) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kBucketed);
+  auto dt = DataType::Float(32);
+  ShapeTuple shape = {1, 3, 6, 6};
+  {
+    auto ndarray = allocator->Empty(shape, dt, dev);
+    EXPECT_EQ(allocator->UsedMemory(), BucketedAllocator::kDefaultPageSize);
+  }
+  EXPECT_EQ(allocator->UsedMemory(), BucketedAllocator::kDefaultPageSize);
+}
+
+TEST_F(TvmVMMemoryManagerTest, PinnedDevice) {
+  EXPECT_EQ(PinnedAllocator::GetPinnedDevice({kDLCUDA, 1}).device_type, kDLCUDAHost);
+  EXPECT_EQ(PinnedAllocator::GetPinnedDevice({kDLCUDA, 1}).device_id, 1);
+  EXPECT_EQ(PinnedAllocator::GetPinnedDevice({kDLROCM, 0}).device_type, kDLROCMHost);
+  EXPECT_EQ(PinnedAllocator::GetPinnedDevice({kDLCPU, 0}).device_type, kDLCPU);
+  EXPECT_THROW(PinnedAllocator::GetPinnedDevice({kDLVulkan, 0}), Error);
+}
+
+TEST_F(TvmVMMemoryManagerTest, PinnedEmptyAndAsyncCopy) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kPinned);
+  EXPECT_EQ(allocator->type(), kPinned);
+  auto dt = DataType::Float(32);
+  NDArray src = allocator->Empty({16}, dt, dev);
+  EXPECT_EQ(allocator->UsedMemory(), PooledAllocator::kDefaultPageSize);
+  for (int i = 0; i < 16; ++i) {
+    static_cast<float*>(src->data)[i] = i;
+  }
+  NDArray dst = NDArray::Empty({16}, dt, dev);
+  DeviceEvent event = dst.CopyFromAsync(src, nullptr);
+  event.Synchronize();
+  EXPECT_TRUE(event.Query());
+  EXPECT_EQ(static_cast<float*>(dst->data)[15], 15.0f);
+  NDArray back = NDArray::Empty({16}, dt, dev);
+  dst.CopyToAsync(back, nullptr).Synchronize();
+  EXPECT_EQ(static_cast<float*>(back->data)[7], 7.0f);
+}
+
+TEST_F(TvmVMMemoryManagerTest, StreamOrderedUnsupportedDevice) {
+  // The host has no stream-ordered memory pool
+  EXPECT_THROW(MemoryManagerWrapper::GetOrCreateAllocator({kDLCPU, 0}, kStreamOrdered), Error);
+}
 }  // namespace memory
 }  // namespace runtime
 }  // namespace tvm
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+
+#include <vector>
+
+#include "../../../src/runtime/workspace_pool.h"
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+
+Device CPUDevice() { return Device{kDLCPU, 0}; }
+
+TVMStreamHandle FakeStream(uintptr_t id) { return reinterpret_cast<TVMStreamHandle>(id); }
+
+}  // namespace
+
+TEST(WorkspacePool, StreamsUseSeparateArenas) {
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(CPUDevice()));
+  Device dev = CPUDevice();
+  // Grow both arenas to fit the workload.
+  for (uintptr_t id : {1, 2}) {
+    void* a = pool.AllocWorkspace(dev, 1024, FakeStream(id));
+    void* b = pool.AllocWorkspace(dev, 1024, FakeStream(id));
+    pool.FreeWorkspace(dev, b);
+    pool.FreeWorkspace(dev, a);
+    pool.SyncStream(dev, FakeStream(id));
+  }
+
+  void* a1 = pool.AllocWorkspace(dev, 1024, FakeStream(1));
+  void* a2 = pool.AllocWorkspace(dev, 1024, FakeStream(2));
+  pool.FreeWorkspace(dev, a1);
+  // Space freed on stream 1 is not handed out to stream 2.
+  void* b2 = pool.AllocWorkspace(dev, 1024, FakeStream(2));
+  EXPECT_NE(b2, a1);
+  EXPECT_EQ(static_cast<char*>(b2), static_cast<char*>(a2) + 1024);
+  // Stream 1 reuses the top of its own arena.
+  EXPECT_EQ(pool.AllocWorkspace(dev, 1024, FakeStream(1)), a1);
+  pool.FreeWorkspace(dev, a1);
+  pool.FreeWorkspace(dev, b2);
+  pool.FreeWorkspace(dev, a2);
+}
+
+TEST(WorkspacePool, ArenaGrowsOnSync) {
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(CPUDevice()));
+  Device dev = CPUDevice();
+  TVMStreamHandle stream = FakeStream(1);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 4; ++i) {
+    ptrs.push_back(pool.AllocWorkspace(dev, 3000, stream));
+  }
+  // Frees in any order, the arena is empty afterwards.
+  for (int i : {1, 3, 0, 2}) {
+    pool.FreeWorkspace(dev, ptrs[i]);
+  }
+  pool.SyncStream(dev, stream);
+
+  // After the sync the allocations are contiguous in a single arena.
+  constexpr size_t kAlignedSize =
+      (3000 + kTempAllocaAlignment - 1) / kTempAllocaAlignment * kTempAllocaAlignment;
+  void* base = pool.AllocWorkspace(dev, 3000, stream);
+  for (int i = 1; i < 4; ++i) {
+    void* ptr = pool.AllocWorkspace(dev, 3000, stream);
+    EXPECT_EQ(static_cast<size_t>(static_cast<char*>(ptr) - static_cast<char*>(base)),
+              i * kAlignedSize);
+    ptrs[i] = ptr;
+  }
+  ptrs[0] = base;
+  for (int i = 3; i >= 0; --i) {
+    pool.FreeWorkspace(dev, ptrs[i]);
+  }
+  pool.ReleaseStream(dev, stream);
+}
+
+TEST(WorkspacePool, DefaultStreamUsesSharedPool) {
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(CPUDevice()));
+  Device dev = CPUDevice();
+  void* a = pool.AllocWorkspace(dev, 1024, nullptr);
+  pool.FreeWorkspace(dev, a);
+  EXPECT_EQ(pool.AllocWorkspace(dev, 1024), a);
+  pool.FreeWorkspace(dev, a);
+  EXPECT_ANY_THROW(pool.FreeWorkspace(dev, a));
+}
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <gtest/gtest.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+
+TEST(StructuralHashCache, Memoize) {
+  using namespace tvm;
+  tir::Var x("x");
+  PrimExpr expr = max(x + 1, 100);
+  int num_calls = 0;
+  auto fhash = [&num_calls](const ObjectRef& obj) {
+    ++num_calls;
+    return StructuralHash()(obj);
+  };
+
+  StructuralHashCache cache;
+  uint64_t hash_value = cache.Hash(expr, fhash);
+  EXPECT_EQ(hash_value, StructuralHash()(expr));
+  EXPECT_EQ(cache.Hash(expr, fhash), hash_value);
+  EXPECT_EQ(num_calls, 1);
+
+  // A structurally equal object is a different cache entry with the same value.
+  PrimExpr other = max(x + 1, 100);
+  EXPECT_EQ(cache.Hash(other, fhash), hash_value);
+  EXPECT_EQ(num_calls, 2);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Hash(expr, fhash), hash_value);
+  EXPECT_EQ(num_calls, 3);
+}
+
+TEST(StructuralHashCache, CopyOnWrite) {
+  using namespace tvm;
+  Array<PrimExpr> arr = {1, 2};
+  StructuralHashCache cache;
+  uint64_t hash_value = cache(arr);
+  // The cache holds a reference, so the mutation copies the array.
+  const Object* cached = arr.get();
+  arr.Set(0, 3);
+  EXPECT_NE(arr.get(), cached);
+  EXPECT_NE(cache(arr), hash_value);
+  EXPECT_EQ(cache(arr), StructuralHash()(arr));
+}
+
+TEST(StructuralHashCache, Evict) {
+  using namespace tvm;
+  int num_calls = 0;
+  auto fhash = [&num_calls](const ObjectRef& obj) {
+    ++num_calls;
+    return StructuralHash()(obj);
+  };
+  StructuralHashCache cache(2);
+  PrimExpr a = IntImm(DataType::Int(32), 1);
+  PrimExpr b = IntImm(DataType::Int(32), 2);
+  PrimExpr c = IntImm(DataType::Int(32), 3);
+  cache.Hash(a, fhash);
+  cache.Hash(b, fhash);
+  cache.Hash(c, fhash);
+  EXPECT_EQ(num_calls, 3);
+  // `a` is the oldest entry and got dropped.
+  cache.Hash(c, fhash);
+  cache.Hash(b, fhash);
+  EXPECT_EQ(num_calls, 3);
+  cache.Hash(a, fhash);
+  EXPECT_EQ(num_calls, 4);
+}
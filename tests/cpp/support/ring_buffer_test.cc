@@ -21,6 +21,9 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+#include <vector>
+
 namespace tvm {
 namespace support {
 namespace {
@@ -63,6 +66,65 @@ TEST(RingBuffer, ReadWithCallback) {
   };
   buffer.ReadWithCallback(callback1, 2 * sizeof(int));
 }
+
+TEST(LockFreeRingBuffer, PushDrain) {
+  LockFreeRingBuffer<int> buffer(3);
+  ASSERT_EQ(buffer.capacity(), 4);
+  std::vector<int> output;
+  auto fvisit = [&output](const int& record) { output.push_back(record); };
+
+  buffer.Push(1);
+  buffer.Push(2);
+  ASSERT_EQ(buffer.Drain(fvisit), 0);
+  ASSERT_EQ(output, std::vector<int>({1, 2}));
+
+  // The oldest records are overwritten once the ring is full.
+  output.clear();
+  for (int i = 3; i <= 8; ++i) {
+    buffer.Push(i);
+  }
+  ASSERT_EQ(buffer.Drain(fvisit), 2);
+  ASSERT_EQ(output, std::vector<int>({5, 6, 7, 8}));
+
+  output.clear();
+  ASSERT_EQ(buffer.Drain(fvisit), 0);
+  ASSERT_TRUE(output.empty());
+}
+
+TEST(LockFreeRingBuffer, ConcurrentPush) {
+  struct Record {
+    int thread;
+    int index;
+  };
+  constexpr int kNumThreads = 4;
+  constexpr int kNumPushes = 10000;
+  LockFreeRingBuffer<Record> buffer(256);
+  std::vector<int> last_index(kNumThreads, -1);
+  uint64_t num_drained = 0, num_lost = 0;
+  auto fvisit = [&](const Record& record) {
+    // The records of a thread are drained in order.
+    ASSERT_GT(record.index, last_index[record.thread]);
+    last_index[record.thread] = record.index;
+    ++num_drained;
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&buffer, t]() {
+      for (int i = 0; i < kNumPushes; ++i) {
+        buffer.Push(Record{t, i});
+      }
+    });
+  }
+  for (int i = 0; i < 100; ++i) {
+    num_lost += buffer.Drain(fvisit);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  num_lost += buffer.Drain(fvisit);
+  ASSERT_EQ(num_drained + num_lost, kNumThreads * kNumPushes);
+}
 }  // namespace
 }  // namespace support
 }  // namespace tvm
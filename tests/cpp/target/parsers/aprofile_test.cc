@@ -406,6 +406,35 @@ TEST(AProfileParserInvalid, LLVMUnsupportedArchitecture) {
   }
 }
 
+TEST_F(AProfileParser, DefaultBF16Support) {
+  // BF16 is mandatory from the same architecture version as I8MM
+  std::string arch_attr = "+v" + FloatToStringWithoutTrailingZeros(defaultI8MM) + "a";
+  TargetJSON target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {arch_attr});
+  TargetFeatures features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_TRUE(IsArch(target));
+  ASSERT_TRUE(Downcast<Bool>(features.at("has_bf16")));
+
+  target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {arch_attr, "-bf16"});
+  features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_TRUE(IsArch(target));
+  ASSERT_FALSE(Downcast<Bool>(features.at("has_bf16")));
+}
+
+using AProfileOptionalBF16 = AProfileParserTestWithParam;
+TEST_P(AProfileOptionalBF16, OptionalBF16Support) {
+  std::string arch_attr = "+v" + FloatToStringWithoutTrailingZeros(GetParam()) + "a";
+
+  TargetJSON target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {arch_attr});
+  TargetFeatures features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_TRUE(IsArch(target));
+  ASSERT_FALSE(Downcast<Bool>(features.at("has_bf16")));
+
+  target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {arch_attr, "+bf16"});
+  features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_TRUE(IsArch(target));
+  ASSERT_TRUE(Downcast<Bool>(features.at("has_bf16")));
+}
+
 using AProfileOptionalSME = AProfileParserTestWithParam;
 TEST_P(AProfileOptionalSME, OptionalSMESupport) {
   const std::string arch_attr = "+v9a";
@@ -429,6 +458,7 @@ INSTANTIATE_TEST_SUITE_P(AProfileParser, AProfileOptionalSVE,
 INSTANTIATE_TEST_SUITE_P(AProfileParser, AProfileOptionalFP16,
                          ::testing::Values(8.2, 8.3, 8.4, 8.5, 8.6, 8.7, 8.8, 8.9));
 INSTANTIATE_TEST_SUITE_P(AProfileParser, AProfileOptionalSME, ::testing::ValuesIn(optionalSME));
+INSTANTIATE_TEST_SUITE_P(AProfileParser, AProfileOptionalBF16, ::testing::ValuesIn(optionalI8MM));
 
 }  // namespace aprofile
 }  // namespace parsers
@@ -20,8 +20,10 @@
 #include <dmlc/logging.h>
 #include <gtest/gtest.h>
 #include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <sstream>
@@ -146,6 +148,50 @@ TEST(ThreadingBackend, TVMBackendParallelLaunchMultipleThreads) {
   }
 }
 
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealing) {
+  const tvm::runtime::PackedFunc* fconfig =
+      tvm::runtime::Registry::Get("runtime.config_threadpool_work_stealing");
+  ASSERT_NE(fconfig, nullptr);
+  int prev_grains = (*fconfig)(4);
+  std::atomic<size_t> acc(0);
+  TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+  EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+
+  // More tasks than workers are allowed in the work-stealing mode. With a single
+  // worker the launch runs inline as one task and bypasses the pool.
+  if (tvm::runtime::threading::MaxConcurrency() > 1) {
+    std::atomic<int> num_tasks_run(0);
+    TVMBackendParallelLaunch(
+        [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+          reinterpret_cast<std::atomic<int>*>(cdata)->fetch_add(1);
+          return 0;
+        },
+        &num_tasks_run, 1000);
+    EXPECT_EQ(num_tasks_run.load(), 1000);
+  }
+  (*fconfig)(prev_grains);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchSpinPolicy) {
+  const tvm::runtime::PackedFunc* fpolicy =
+      tvm::runtime::Registry::Get("runtime.config_threadpool_spin_policy");
+  const tvm::runtime::PackedFunc* flow_power =
+      tvm::runtime::Registry::Get("runtime.threadpool_set_low_power_idle");
+  ASSERT_NE(fpolicy, nullptr);
+  ASSERT_NE(flow_power, nullptr);
+  for (bool low_power_idle : {false, true}) {
+    (*fpolicy)("adaptive");
+    (*flow_power)(low_power_idle);
+    for (int i = 0; i < 10; ++i) {
+      std::atomic<size_t> acc(0);
+      TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    }
+  }
+  (*flow_power)(false);
+  (*fpolicy)("fixed");
+}
+
 TEST(ThreadingBackend, TVMBackendAffinityConfigure) {
   int max_concurrency = tvm::runtime::threading::MaxConcurrency();
   std::vector<std::unique_ptr<std::thread>> ts;
@@ -194,3 +240,76 @@ TEST(ThreadingBackend, TVMBackendParallelForWithThreadingBackend) {
     EXPECT_EQ(vec[i], i);
   }
 }
+
+TEST(ThreadingBackend, NUMANodeCPUs) {
+  const auto& nodes = tvm::runtime::threading::NUMANodeCPUs();
+  ASSERT_FALSE(nodes.empty());
+  std::unordered_set<unsigned int> seen;
+  for (const auto& cpus : nodes) {
+    EXPECT_FALSE(cpus.empty());
+    for (unsigned int cpu : cpus) {
+      EXPECT_TRUE(seen.insert(cpu).second) << "CPU " << cpu << " is in more than one node";
+    }
+  }
+  int node = tvm::runtime::threading::CurrentNUMANode();
+  EXPECT_GE(node, 0);
+  EXPECT_LT(node, static_cast<int>(nodes.size()));
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNUMANode) {
+  int num_nodes = tvm::runtime::threading::NUMANodeCPUs().size();
+  std::vector<std::thread> ts;
+  for (int node = 0; node < num_nodes; ++node) {
+    ts.emplace_back([node]() {
+      tvm::runtime::threading::ConfigureNUMANode(node, 0);
+      EXPECT_FALSE(tvm::runtime::threading::InParallelRegion());
+      std::atomic<size_t> acc(0);
+      TVMBackendParallelLaunch(
+          [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+            EXPECT_TRUE(tvm::runtime::threading::InParallelRegion());
+            AtomicCompute(task_id, N, static_cast<std::atomic<size_t>*>(cdata), penv);
+            return 0;
+          },
+          &acc, 0);
+      EXPECT_EQ(acc.load(), N * (N - 1) / 2);
+    });
+  }
+  for (auto& t : ts) {
+    t.join();
+  }
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNamedThreadPool) {
+  unsigned int num_cpus = std::max(std::thread::hardware_concurrency(), 1U);
+  std::vector<unsigned int> cpus;
+  for (unsigned int i = 0; i < std::min(num_cpus, 2U); ++i) {
+    cpus.push_back(i);
+  }
+  tvm::runtime::threading::CreateThreadPool("test_pool", cpus);
+  EXPECT_ANY_THROW(tvm::runtime::threading::CreateThreadPool("test_pool", cpus));
+  int thread_local_num_threads = tvm::runtime::threading::NumThreads();
+  {
+    tvm::runtime::threading::ThreadPoolScope scope("test_pool");
+    EXPECT_EQ(tvm::runtime::threading::NumThreads(), static_cast<int>(cpus.size()));
+    struct LaunchState {
+      std::atomic<size_t> acc{0};
+      std::atomic<int> num_on_caller{0};
+      std::thread::id caller;
+    } state;
+    state.caller = std::this_thread::get_id();
+    TVMBackendParallelLaunch(
+        [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+          auto* state = static_cast<LaunchState*>(cdata);
+          if (std::this_thread::get_id() == state->caller) state->num_on_caller++;
+          AtomicCompute(task_id, N, &state->acc, penv);
+          return 0;
+        },
+        &state, 0);
+    EXPECT_EQ(state.acc.load(), N * (N - 1) / 2);
+    // The tasks of a named pool only run on its workers.
+    EXPECT_EQ(state.num_on_caller.load(), 0);
+  }
+  EXPECT_EQ(tvm::runtime::threading::NumThreads(), thread_local_num_threads);
+  tvm::runtime::threading::RemoveThreadPool("test_pool");
+  EXPECT_ANY_THROW(tvm::runtime::threading::ThreadPoolScope("test_pool"));
+}
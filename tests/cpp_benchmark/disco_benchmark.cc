@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file disco_benchmark.cc
+ * \brief The round trip of a command from the disco controler to its workers and back.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/registry.h>
+
+namespace tvm {
+namespace runtime {
+
+TVM_REGISTER_GLOBAL("benchmark.disco.noop").set_body([](TVMArgs args, TVMRetValue* rv) {});
+
+static void BM_DiscoCallRoundTrip(benchmark::State& state) {
+  int num_workers = state.range(0);
+  Session sess = Session::ThreadedSession(num_workers, /*num_groups=*/1);
+  DRef func = sess->GetGlobalFunc("benchmark.disco.noop");
+  for (auto _ : state) {
+    sess->CallPacked(func);
+    sess->SyncWorker(0);
+  }
+  sess->Shutdown();
+}
+BENCHMARK(BM_DiscoCallRoundTrip)->Arg(1)->Arg(2)->Arg(8)->UseRealTime();
+
+static void BM_DiscoBatchedCalls(benchmark::State& state) {
+  // The commands of one step queued into a single packet
+  constexpr int kNumCalls = 32;
+  Session sess = Session::ThreadedSession(state.range(0), /*num_groups=*/1);
+  DRef func = sess->GetGlobalFunc("benchmark.disco.noop");
+  for (auto _ : state) {
+    sess->BeginBatch();
+    for (int i = 0; i < kNumCalls; ++i) {
+      sess->CallPacked(func);
+    }
+    sess->EndBatch();
+    sess->SyncWorker(0);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumCalls);
+  sess->Shutdown();
+}
+BENCHMARK(BM_DiscoBatchedCalls)->Arg(2)->Arg(8)->UseRealTime();
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file kv_cache_benchmark.cc
+ * \brief The host-side bookkeeping of the paged KV cache that precedes every decode step.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief Get a global function, which must be registered. */
+static const PackedFunc& GetFunc(const char* name) {
+  const PackedFunc* f = Registry::Get(name);
+  ICHECK(f != nullptr) << "The global function " << name << " is not registered";
+  return *f;
+}
+
+/*!
+ * \brief Create a paged KV cache on CPU, holding \p num_seqs sequences of \p seq_len tokens.
+ *  The attention kernels do nothing, so that only the bookkeeping is measured.
+ */
+static ObjectRef CreateKVCache(int64_t num_seqs, int64_t seq_len) {
+  constexpr int64_t kPageSize = 16;
+  constexpr int64_t kNumLayers = 32;
+  PackedFunc f_noop([](TVMArgs args, TVMRetValue* rv) {});
+  NDArray init = NDArray::Empty({1}, DataType::Float(16), {kDLCPU, 0});
+  ObjectRef kv_cache = GetFunc("vm.builtin.paged_attention_kv_cache_create_reduced")(
+      ShapeTuple({num_seqs, num_seqs * (seq_len + 2 * kPageSize), 2048, kPageSize, 0}),
+      ShapeTuple({0, kNumLayers}), /*num_qo_heads=*/32, /*num_kv_heads=*/8, /*head_dim=*/128,
+      /*rope_mode=*/0, /*rotary_scale=*/1.0, /*rotary_theta=*/10000.0, init,
+      /*f_transpose_append=*/f_noop, /*f_attention_prefill=*/f_noop,
+      /*f_attention_decode=*/f_noop, /*f_attention_prefill_sliding_window=*/f_noop,
+      /*f_attention_decode_sliding_window=*/f_noop, /*f_attention_prefill_ragged=*/f_noop,
+      /*f_merge_inplace=*/f_noop, /*f_split_rotary=*/f_noop, /*f_copy_single_page=*/f_noop,
+      /*f_debug_get_kv=*/nullptr);
+  const PackedFunc& f_add_sequence = GetFunc("vm.builtin.kv_state_add_sequence");
+  const PackedFunc& f_begin_forward = GetFunc("vm.builtin.kv_state_begin_forward");
+  const PackedFunc& f_end_forward = GetFunc("vm.builtin.kv_state_end_forward");
+  for (int64_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+    f_add_sequence(kv_cache, seq_id);
+    f_begin_forward(kv_cache, ShapeTuple({seq_id}), ShapeTuple({seq_len}));
+    f_end_forward(kv_cache);
+  }
+  return kv_cache;
+}
+
+static void BM_KVCacheBeginForwardDecode(benchmark::State& state) {
+  int64_t num_seqs = state.range(0);
+  ObjectRef kv_cache = CreateKVCache(num_seqs, /*seq_len=*/1000);
+  const PackedFunc& f_begin_forward = GetFunc("vm.builtin.kv_state_begin_forward");
+  const PackedFunc& f_end_forward = GetFunc("vm.builtin.kv_state_end_forward");
+  const PackedFunc& f_popn = GetFunc("vm.builtin.kv_state_popn");
+  std::vector<int64_t> seq_ids(num_seqs);
+  for (int64_t i = 0; i < num_seqs; ++i) {
+    seq_ids[i] = i;
+  }
+  ShapeTuple seq_id_tuple(seq_ids);
+  ShapeTuple append_lengths(std::vector<int64_t>(num_seqs, 1));
+  for (auto _ : state) {
+    f_begin_forward(kv_cache, seq_id_tuple, append_lengths);
+    state.PauseTiming();
+    // Drop the appended tokens, so that every step sees the same lengths
+    f_end_forward(kv_cache);
+    for (int64_t seq_id : seq_ids) {
+      f_popn(kv_cache, seq_id, 1);
+    }
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_KVCacheBeginForwardDecode)->Arg(1)->Arg(16)->Arg(128);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
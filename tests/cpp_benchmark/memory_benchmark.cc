@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file memory_benchmark.cc
+ * \brief The alloc/free pairs of the pooled allocator, as issued by the VM on every call.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <memory>
+#include <vector>
+
+#include "../../src/runtime/memory/pooled_allocator.h"
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+static const Device kCPU = {kDLCPU, 0};
+
+/*! \brief The allocator shared by the threads of a benchmark. */
+static std::unique_ptr<PooledAllocator> shared_allocator;
+
+static void BM_PooledAllocatorAllocFree(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_allocator = std::make_unique<PooledAllocator>();
+  }
+  size_t nbytes = state.range(0);
+  for (auto _ : state) {
+    Buffer buffer = shared_allocator->Alloc(kCPU, nbytes, 64, DataType::Float(32));
+    shared_allocator->Free(buffer);
+  }
+  if (state.thread_index() == 0) {
+    shared_allocator.reset();
+  }
+}
+BENCHMARK(BM_PooledAllocatorAllocFree)->Arg(1 << 10)->Arg(1 << 20)->ThreadRange(1, 8);
+
+static void BM_PooledAllocatorBurst(benchmark::State& state) {
+  // A burst of live buffers of mixed sizes, as the intermediates of a model
+  PooledAllocator allocator;
+  int num_buffers = state.range(0);
+  std::vector<Buffer> buffers(num_buffers);
+  for (auto _ : state) {
+    for (int i = 0; i < num_buffers; ++i) {
+      buffers[i] = allocator.Alloc(kCPU, (i % 7 + 1) << 12, 64, DataType::Float(32));
+    }
+    for (int i = num_buffers - 1; i >= 0; --i) {
+      allocator.Free(buffers[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_buffers);
+}
+BENCHMARK(BM_PooledAllocatorBurst)->Arg(16)->Arg(256);
+
+static void BM_NDArrayEmpty(benchmark::State& state) {
+  Allocator* allocator = MemoryManager::GetOrCreateAllocator(kCPU, kPooled);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(allocator->Empty({16, 16}, DataType::Float(32), kCPU));
+  }
+}
+BENCHMARK(BM_NDArrayEmpty);
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file packed_func_benchmark.cc
+ * \brief The overhead of calling PackedFuncs, through the C++ and the C APIs.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+namespace tvm {
+namespace runtime {
+
+TVM_REGISTER_GLOBAL("benchmark.packed_func.noop").set_body([](TVMArgs args, TVMRetValue* rv) {});
+
+static void BM_PackedFuncCallNoArgs(benchmark::State& state) {
+  PackedFunc f([](TVMArgs args, TVMRetValue* rv) {});
+  for (auto _ : state) {
+    f();
+  }
+}
+BENCHMARK(BM_PackedFuncCallNoArgs);
+
+static void BM_TypedPackedFuncCallInts(benchmark::State& state) {
+  TypedPackedFunc<int64_t(int64_t, int64_t)> f([](int64_t a, int64_t b) { return a + b; });
+  int64_t sum = 0;
+  for (auto _ : state) {
+    sum = f(sum, 1);
+  }
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_TypedPackedFuncCallInts);
+
+static void BM_PackedFuncCallNDArrays(benchmark::State& state) {
+  PackedFunc f([](TVMArgs args, TVMRetValue* rv) { *rv = args[0]; });
+  int num_args = state.range(0);
+  std::vector<NDArray> arrays;
+  for (int i = 0; i < num_args; ++i) {
+    arrays.push_back(NDArray::Empty({16}, DataType::Float(32), {kDLCPU, 0}));
+  }
+  std::vector<TVMValue> values(num_args);
+  std::vector<int> type_codes(num_args);
+  TVMArgsSetter setter(values.data(), type_codes.data());
+  for (int i = 0; i < num_args; ++i) {
+    setter(i, arrays[i]);
+  }
+  for (auto _ : state) {
+    TVMRetValue rv;
+    f.CallPacked(TVMArgs(values.data(), type_codes.data(), num_args), &rv);
+  }
+}
+BENCHMARK(BM_PackedFuncCallNDArrays)->Arg(1)->Arg(4)->Arg(16);
+
+static void BM_RegistryGet(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Registry::Get("benchmark.packed_func.noop"));
+  }
+}
+BENCHMARK(BM_RegistryGet);
+
+static void BM_TVMFuncCall(benchmark::State& state) {
+  TVMFunctionHandle handle;
+  ICHECK_EQ(TVMFuncGetGlobal("benchmark.packed_func.noop", &handle), 0);
+  TVMValue arg;
+  int type_code = kDLInt;
+  arg.v_int64 = 1;
+  for (auto _ : state) {
+    TVMValue ret;
+    int ret_type_code;
+    TVMFuncCall(handle, &arg, &type_code, 1, &ret, &ret_type_code);
+  }
+}
+BENCHMARK(BM_TVMFuncCall);
+
+}  // namespace runtime
+}  // namespace tvm
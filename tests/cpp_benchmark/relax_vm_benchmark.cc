@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relax_vm_benchmark.cc
+ * \brief The dispatch of the instructions of the Relax VM, calling trivial PackedFuncs.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/relax/exec_builder.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+TVM_REGISTER_GLOBAL("benchmark.relax_vm.identity").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = args[0];
+});
+
+/*!
+ * \brief Build a VM function chaining \p num_calls calls of the identity, starting from its input.
+ */
+static Module BuildChainedCalls(int num_calls) {
+  relax::ExecBuilder builder = relax::ExecBuilderNode::Create();
+  builder->EmitFunction("main", 1, NullOpt);
+  for (int i = 0; i < num_calls; ++i) {
+    builder->EmitCall("benchmark.relax_vm.identity", {Instruction::Arg::Register(i)}, i + 1);
+  }
+  builder->EmitRet(Instruction::Arg::Register(num_calls));
+  builder->EndFunction("main");
+  ObjectPtr<VirtualMachine> vm = VirtualMachine::Create();
+  vm->LoadExecutable(builder->Get());
+  vm->Init({Device{kDLCPU, 0}}, {memory::kPooled});
+  return Module(vm);
+}
+
+static void BM_RelaxVMCallDispatch(benchmark::State& state) {
+  int num_calls = state.range(0);
+  PackedFunc main = BuildChainedCalls(num_calls).GetFunction("main");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(main(int64_t(1)).operator int64_t());
+  }
+  state.SetItemsProcessed(state.iterations() * num_calls);
+}
+BENCHMARK(BM_RelaxVMCallDispatch)->Arg(1)->Arg(64)->Arg(1024);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
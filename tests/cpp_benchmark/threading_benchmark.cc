@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file threading_benchmark.cc
+ * \brief The latency of launching parallel jobs on the runtime thread pool.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/logging.h>
+
+#include <atomic>
+
+namespace tvm {
+namespace runtime {
+
+static int EmptyParallelLambda(int task_id, TVMParallelGroupEnv* penv, void* cdata) { return 0; }
+
+static int BarrierParallelLambda(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  TVMBackendParallelBarrier(task_id, penv);
+  return 0;
+}
+
+static int CountParallelLambda(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  static_cast<std::atomic<int64_t>*>(cdata)->fetch_add(1, std::memory_order_relaxed);
+  return 0;
+}
+
+static void BM_ParallelLaunch(benchmark::State& state) {
+  int num_task = state.range(0);
+  for (auto _ : state) {
+    ICHECK_EQ(TVMBackendParallelLaunch(EmptyParallelLambda, nullptr, num_task), 0);
+  }
+}
+// 0 launches as many tasks as the threads of the pool
+BENCHMARK(BM_ParallelLaunch)->Arg(0)->Arg(1)->Arg(2)->Arg(4);
+
+static void BM_ParallelLaunchBarrier(benchmark::State& state) {
+  for (auto _ : state) {
+    ICHECK_EQ(TVMBackendParallelLaunch(BarrierParallelLambda, nullptr, 0), 0);
+  }
+}
+BENCHMARK(BM_ParallelLaunchBarrier);
+
+static void BM_ParallelLaunchShared(benchmark::State& state) {
+  std::atomic<int64_t> counter{0};
+  for (auto _ : state) {
+    ICHECK_EQ(TVMBackendParallelLaunch(CountParallelLambda, &counter, 0), 0);
+  }
+  benchmark::DoNotOptimize(counter.load());
+}
+BENCHMARK(BM_ParallelLaunchShared);
+
+}  // namespace runtime
+}  // namespace tvm
@@ -20,6 +20,9 @@
 #include "../../src/runtime/crt/include/tvm/runtime/crt/internal/graph_executor/graph_executor.h"
 
 #include <gtest/gtest.h>
+#include <tvm/runtime/crt/platform.h>
+
+#include <vector>
 
 #include "../../src/runtime/crt/include/tvm/runtime/crt/internal/graph_executor/load_json.h"
 
@@ -112,4 +115,37 @@ TEST(TVMGraphExecutor_Load, Parse) {
   EXPECT_EQ(executor.nodes_count, 3);
 }
 
+// Check an NDArray loaded in place aliases the data in the blob.
+TEST(TVMGraphExecutor_LoadParams, NDArrayInPlace) {
+  const float data[5] = {1, 2, 3, 4, 5};
+  std::vector<char> blob;
+  auto write = [&](const void* ptr, size_t size) {
+    blob.insert(blob.end(), static_cast<const char*>(ptr), static_cast<const char*>(ptr) + size);
+  };
+  uint64_t reserved = 0;
+  DLDevice dev = {kDLCPU, 0};
+  int ndim = 2;
+  DLDataType dtype = {kDLFloat, 32, 1};
+  int64_t shape[2] = {1, 5};
+  int64_t nbytes = sizeof(data);
+  write(&kTVMNDArrayMagic, sizeof(kTVMNDArrayMagic));
+  write(&reserved, sizeof(reserved));
+  write(&dev, sizeof(dev));
+  write(&ndim, sizeof(ndim));
+  write(&dtype, sizeof(dtype));
+  write(shape, sizeof(shape));
+  write(&nbytes, sizeof(nbytes));
+  write(data, sizeof(data));
+
+  const char* strm = blob.data();
+  TVMNDArray array;
+  EXPECT_EQ(TVMNDArray_LoadInPlace(&array, &strm), 0);
+  EXPECT_EQ(strm, blob.data() + blob.size());
+  EXPECT_EQ(array.dl_tensor.data, blob.data() + blob.size() - sizeof(data));
+  EXPECT_EQ(array.dl_tensor.ndim, 2);
+  EXPECT_EQ(array.dl_tensor.shape[1], 5);
+  EXPECT_EQ(static_cast<float*>(array.dl_tensor.data)[4], 5);
+  EXPECT_EQ(TVMPlatformMemoryFree(array.dl_tensor.shape, dev), kTvmErrorNoError);
+}
+
 }  // namespace
@@ -0,0 +1,138 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <gtest/gtest.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#include <vector>
+
+#include "crt_config.h"
+
+static constexpr const size_t kMemoryPoolSizeBytes = 64 * 1024;
+
+class TLSFAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(TLSFMemoryManagerCreate(&interface, memory_pool, kMemoryPoolSizeBytes),
+              kTvmErrorNoError);
+    mgr = reinterpret_cast<TLSFMemoryManager*>(interface);
+    dev_ = {kDLCPU, 0};
+  }
+
+  // Allocate blocks of `num_bytes` until the pool is exhausted.
+  std::vector<void*> AllocateAll(size_t num_bytes) {
+    std::vector<void*> ptrs;
+    void* a;
+    while (interface->Allocate(interface, num_bytes, dev_, &a) == kTvmErrorNoError) {
+      ptrs.push_back(a);
+    }
+    EXPECT_EQ(a, nullptr);
+    return ptrs;
+  }
+
+  alignas(TLSF_ALIGN_SIZE) uint8_t memory_pool[kMemoryPoolSizeBytes];
+  MemoryManagerInterface* interface;
+  TLSFMemoryManager* mgr;
+  DLDevice dev_;
+};
+
+TEST_F(TLSFAllocatorTest, Alignment) {
+  std::vector<void*> ptrs;
+  for (size_t num_bytes : {0, 1, 3, 17, 100, 255, 4096}) {
+    void* a;
+    ASSERT_EQ(interface->Allocate(interface, num_bytes, dev_, &a), kTvmErrorNoError);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % TLSF_ALIGN_SIZE, 0u);
+    EXPECT_GE(reinterpret_cast<uint8_t*>(a), memory_pool);
+    EXPECT_LE(reinterpret_cast<uint8_t*>(a) + num_bytes, memory_pool + kMemoryPoolSizeBytes);
+    memset(a, 0xff, num_bytes);
+    ptrs.push_back(a);
+  }
+  EXPECT_EQ(static_cast<size_t>(interface->vleak_size), ptrs.size());
+  for (void* a : ptrs) {
+    EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  }
+  EXPECT_EQ(interface->vleak_size, 0);
+}
+
+TEST_F(TLSFAllocatorTest, CoalesceOnFree) {
+  // A single allocation can take the whole pool.
+  void* whole;
+  ASSERT_EQ(interface->Allocate(interface, mgr->pool_size_bytes, dev_, &whole), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, whole, dev_), kTvmErrorNoError);
+
+  std::vector<void*> ptrs = AllocateAll(64);
+  ASSERT_GT(ptrs.size(), 100u);
+  // Free every other block first, then the rest, so both neighbours get merged.
+  for (size_t i = 0; i < ptrs.size(); i += 2) {
+    EXPECT_EQ(interface->Free(interface, ptrs[i], dev_), kTvmErrorNoError);
+  }
+  for (size_t i = 1; i < ptrs.size(); i += 2) {
+    EXPECT_EQ(interface->Free(interface, ptrs[i], dev_), kTvmErrorNoError);
+  }
+  EXPECT_EQ(interface->vleak_size, 0);
+
+  ASSERT_EQ(interface->Allocate(interface, mgr->pool_size_bytes, dev_, &whole), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, whole, dev_), kTvmErrorNoError);
+}
+
+TEST_F(TLSFAllocatorTest, ReuseFreedBlock) {
+  std::vector<void*> ptrs = AllocateAll(200);
+  ASSERT_GT(ptrs.size(), 3u);
+  void* freed = ptrs[ptrs.size() / 2];
+  EXPECT_EQ(interface->Free(interface, freed, dev_), kTvmErrorNoError);
+
+  void* a;
+  ASSERT_EQ(interface->Allocate(interface, 200, dev_, &a), kTvmErrorNoError);
+  EXPECT_EQ(a, freed);
+  EXPECT_EQ(interface->Allocate(interface, 200, dev_, &a), kTvmErrorPlatformNoMemory);
+
+  for (void* p : ptrs) {
+    EXPECT_EQ(interface->Free(interface, p, dev_), kTvmErrorNoError);
+  }
+  EXPECT_EQ(interface->vleak_size, 0);
+}
+
+TEST_F(TLSFAllocatorTest, OutOfMemory) {
+  void* a;
+  EXPECT_EQ(interface->Allocate(interface, mgr->pool_size_bytes + 1, dev_, &a),
+            kTvmErrorPlatformNoMemory);
+  EXPECT_EQ(a, nullptr);
+  EXPECT_EQ(interface->Allocate(interface, SIZE_MAX, dev_, &a), kTvmErrorPlatformNoMemory);
+  EXPECT_EQ(interface->vleak_size, 0);
+}
+
+TEST_F(TLSFAllocatorTest, DoubleFree) {
+  void* a;
+  void* b;
+  ASSERT_EQ(interface->Allocate(interface, 32, dev_, &a), kTvmErrorNoError);
+  ASSERT_EQ(interface->Allocate(interface, 32, dev_, &b), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorPlatformCheckFailure);
+  EXPECT_EQ(interface->vleak_size, 1);
+  EXPECT_EQ(interface->Free(interface, b, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, nullptr, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->vleak_size, 0);
+}
+
+TEST(TLSFAllocatorCreateTest, PoolTooSmall) {
+  alignas(TLSF_ALIGN_SIZE) uint8_t memory_pool[sizeof(TLSFMemoryManager)];
+  MemoryManagerInterface* interface;
+  EXPECT_EQ(TLSFMemoryManagerCreate(&interface, memory_pool, sizeof(memory_pool)),
+            kTvmErrorPlatformNoMemory);
+}
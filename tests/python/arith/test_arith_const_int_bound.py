@@ -297,5 +297,24 @@ class TestRampBound(BaseCompare):
     )
 
 
+def test_memoized_bound_follows_constraints():
+    analyzer = tvm.arith.Analyzer()
+    x = te.var("x")
+    analyzer.bind(x, tvm.ir.Range(0, 10))
+    expr = (x + 1) * 2
+    assert analyzer.const_int_bound(expr).max_value == 20
+
+    analyzer.reset_rewrite_simplify_stats()
+    assert analyzer.const_int_bound(expr).max_value == 20
+    assert analyzer.rewrite_simplify_stats.const_int_bound_memo_hits == 1
+
+    with analyzer.constraint_scope(x < 5):
+        assert analyzer.const_int_bound(expr).max_value == 10
+    assert analyzer.const_int_bound(expr).max_value == 20
+
+    analyzer.update(x, ConstIntBound(0, 2), override=True)
+    assert analyzer.const_int_bound(expr).max_value == 6
+
+
 if __name__ == "__main__":
     tvm.testing.main()
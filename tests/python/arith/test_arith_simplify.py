@@ -131,5 +131,33 @@ def test_regression_simplify_inf_recursion():
     ana.rewrite_simplify(res)
 
 
+def test_simplify_step_budget():
+    x = tir.Var("x", "int32")
+    expr = x
+    for i in range(64):
+        expr = expr + tir.IntImm("int32", i + 1)
+
+    ana = tvm.arith.Analyzer()
+    full = ana.rewrite_simplify(expr)
+    assert ana.rewrite_simplify_stats.budget_exceeded == 0
+
+    ana = tvm.arith.Analyzer()
+    ana.set_simplify_step_budget(16)
+    partial = ana.rewrite_simplify(expr)
+    stats = ana.rewrite_simplify_stats
+    assert stats.budget_exceeded == 1
+    assert stats.budget_exceeded_exprs[0].same_as(expr)
+    assert tvm.ir.structural_equal(full, x + 2080)
+    assert not tvm.ir.structural_equal(partial, full)
+
+    # The budget applies to each simplification separately
+    assert tvm.ir.structural_equal(ana.rewrite_simplify(x + 1 - 1), x)
+
+    with tvm.transform.PassContext(config={"tir.simplify_step_budget": 16}):
+        ana = tvm.arith.Analyzer()
+    ana.canonical_simplify(expr)
+    assert ana.canonical_simplify_stats.budget_exceeded == 1
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -22,6 +22,7 @@ import tempfile
 import numpy as np
 
 import tvm
+import tvm.testing
 from tvm import auto_scheduler
 
 from tvm.testing.auto_scheduler import matmul_auto_scheduler_test
@@ -79,6 +80,29 @@ def test_xgb_model():
     model.load(tmpfile)
 
 
+def test_tree_ensemble_model():
+    task, inputs, results = get_sample_records(50)
+    states = [x.state for x in inputs]
+
+    trainer = auto_scheduler.XGBModel(num_warmup_sample=-1)
+    model = auto_scheduler.TreeEnsembleModel(trainer)
+    model.update(inputs, results)
+    preds = model.predict(task, states)
+    assert len(preds) == len(inputs)
+
+    # The native predictions match the ones of xgboost
+    expected = trainer.predict(task, states)
+    tvm.testing.assert_allclose(preds, expected, rtol=1e-4, atol=1e-4)
+
+    # test model serialization
+    tmpdir = tvm.contrib.utils.tempdir()
+    tmpfile = tmpdir.relpath("test")
+    model.save(tmpfile)
+    model.load(tmpfile)
+    tvm.testing.assert_allclose(model.predict(task, states), expected, rtol=1e-4, atol=1e-4)
+
+
 if __name__ == "__main__":
     test_random_model()
     test_xgb_model()
+    test_tree_ensemble_model()
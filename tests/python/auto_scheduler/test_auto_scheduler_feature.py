@@ -20,7 +20,10 @@
 import math
 import tempfile
 
+import numpy as np
+
 import tvm
+import tvm.testing
 from tvm import te, auto_scheduler, relay
 from tvm.script import tir as T
 
@@ -293,6 +296,34 @@ def zero_dim(
         T_cast_1[i0_i1_fused] = p2_1[0]
 
 
+def test_feature_cache():
+    target = tvm.target.Target("llvm")
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target=target
+    )
+    states = auto_scheduler.SketchPolicy(task, verbose=0).sample_initial_population()[:8]
+
+    tvm.get_global_func("auto_scheduler.ClearFeatureCache")()
+    expected = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    cached = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    for x, y in zip(expected, cached):
+        tvm.testing.assert_allclose(x, y)
+
+    # A task of another DAG under the same workload key does not hit the cache
+    other = auto_scheduler.SearchTask(
+        compute_dag=auto_scheduler.ComputeDAG(matmul_auto_scheduler_test(32, 32, 32)),
+        workload_key=task.workload_key,
+        target=target,
+    )
+    fea = auto_scheduler.feature.get_per_store_features_from_states(
+        [other.compute_dag.get_init_state()], other
+    )
+    expected = auto_scheduler.feature.get_per_store_features_from_states(
+        [task.compute_dag.get_init_state()], task
+    )
+    assert not np.array_equal(fea[0], expected[0])
+
+
 def test_zero_dim():
     features = auto_scheduler.feature.named_features_from_primfunc(zero_dim)
     assert features["B1.stride"] == 1
@@ -303,3 +334,4 @@ if __name__ == "__main__":
     test_cpu_matmul()
     test_cpu_fusion()
     test_gpu_feature()
+    test_feature_cache()
@@ -135,6 +135,27 @@ def test_cuda_multi_lib():
     worker.recv()
 
 
+@tvm.testing.requires_llvm
+def test_blob_raw_data_section():
+    """A large blob is included in the object file as a raw data section"""
+    data = bytes(np.random.randint(0, 256, size=8192, dtype="uint8"))
+    codegen_blob = tvm.get_global_func("codegen.codegen_blob")
+    with tvm.transform.PassContext(config={"llvm.raw_data_section_threshold": 4096}):
+        blob = codegen_blob(bytearray(data), False, "llvm", "")
+    assert ".incbin" in blob.get_source("ll")
+
+    temp = utils.tempdir()
+    path_obj = temp.relpath("blob.o")
+    path_dso = temp.relpath("blob.so")
+    blob.save(path_obj)
+    cc.create_shared(path_dso, [path_obj])
+    lib = ctypes.CDLL(path_dso)
+    symbol = (ctypes.c_char * len(data)).in_dll(lib, "__tvm_dev_mblob")
+    assert ctypes.addressof(symbol) % 4096 == 0
+    assert symbol.raw == data
+
+
 if __name__ == "__main__":
     test_synthetic()
     test_cuda_multilib()
+    test_blob_raw_data_section()
@@ -1069,6 +1069,37 @@ def test_cuda_save_kernels_for_profiling():
     check_cuda(64, 2)
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_cuda_nvrtc_parallel_compile_with_cache():
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    C = te.compute((n,), lambda i: B[i] * 2.0, name="C")
+    s = te.create_schedule(C.op)
+    for stage in [B, C]:
+        xo, xi = s[stage].split(stage.op.axis[0], factor=8)
+        s[stage].bind(xo, bx)
+        s[stage].bind(xi, tx)
+    cache_dir = str(utils.tempdir().path)
+    config = {
+        "cuda.use_nvrtc": True,
+        "cuda.num_compile_threads": 4,
+        "cuda.kernel_cache_dir": cache_dir,
+    }
+    dev = tvm.cuda(0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    for _ in range(2):
+        with tvm.transform.PassContext(config=config):
+            f = tvm.build(s, [A, C], "cuda")
+        # One cache file per kernel, reused by the second build
+        assert len(os.listdir(cache_dir)) == 2
+        a = tvm.nd.array(a_np, dev)
+        c = tvm.nd.empty((n,), "float32", dev)
+        f(a, c)
+        tvm.testing.assert_allclose(c.numpy(), (a_np + 1.0) * 2.0)
+
+
 @tvm.testing.requires_gpu
 @tvm.testing.requires_cuda
 def test_cuda_thread_sync_inside_condition():
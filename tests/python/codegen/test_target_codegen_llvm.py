@@ -151,6 +151,35 @@ def test_llvm_persist_parallel():
     check_llvm()
 
 
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("jit", ["mcjit", "orcjit", "orcjit-lazy"])
+def test_llvm_jit_engines(jit):
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+            for i in T.parallel(64):
+                with T.block("B"):
+                    vi = T.axis.spatial(64, i)
+                    B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func
+        def mul_two(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+            for i in range(64):
+                with T.block("B"):
+                    vi = T.axis.spatial(64, i)
+                    B[vi] = A[vi] * T.float32(2)
+
+    f = tvm.build(Module, target=f"llvm -jit={jit}")
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=64).astype("float32"), dev)
+    b = tvm.nd.array(np.zeros(64, dtype="float32"), dev)
+    f["add_one"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+    f["mul_two"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() * 2)
+
+
 @tvm.testing.requires_llvm
 def test_llvm_flip_pipeline():
     def check_llvm(nn, base):
@@ -1049,6 +1078,51 @@ def test_subroutine_call():
     assert arr.numpy()[0] == 42.0
 
 
+@tvm.testing.requires_llvm
+def test_parallel_codegen():
+    """Functions compiled on several threads are linked back into one module"""
+
+    @I.ir_module
+    class mod:
+        @T.prim_func
+        def main(A: T.Buffer(4, "float32")):
+            T.func_attr({"global_symbol": "main"})
+            mod.subroutine(A.data)
+
+        @T.prim_func
+        def subroutine(A_data: T.handle("float32")):
+            T.func_attr({"global_symbol": "subroutine", "calling_conv": -1})
+            A = T.decl_buffer(4, dtype="float32", data=A_data)
+            for i in range(4):
+                A[i] = A[i] + 1.0
+
+        @T.prim_func
+        def scale(A: T.Buffer(4, "float32"), B: T.Buffer(4, "float32")):
+            T.func_attr({"global_symbol": "scale"})
+            for i in range(4):
+                B[i] = A[i] * 2.0
+
+        @T.prim_func
+        def negate(A: T.Buffer(4, "float32"), B: T.Buffer(4, "float32")):
+            T.func_attr({"global_symbol": "negate"})
+            for i in range(4):
+                B[i] = -A[i]
+
+    with tvm.transform.PassContext(config={"llvm.num_codegen_threads": 4}):
+        built = tvm.build(mod, target="llvm")
+
+    dev = tvm.cpu()
+    a_np = np.arange(4).astype("float32")
+    a = tvm.nd.array(a_np, device=dev)
+    b = tvm.nd.empty([4], "float32", device=dev)
+    built["scale"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a_np * 2.0)
+    built["negate"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), -a_np)
+    built["main"](a)
+    tvm.testing.assert_allclose(a.numpy(), a_np + 1.0)
+
+
 @tvm.testing.requires_llvm
 def test_call_packed_returning_void():
     """Allow codegen of PackedFunc calls returning void
@@ -1109,6 +1183,36 @@ def test_call_extern_returning_void():
     built = tvm.build(func, target="llvm")
 
 
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("threshold", [0, 1024])
+def test_allocate_const_raw_data_section(threshold):
+    """Large constants can be included in the object file as raw data sections"""
+    k_np = np.random.uniform(size=1024).astype("float32")
+
+    @T.prim_func
+    def func(A: T.Buffer(1024, "float32"), B: T.Buffer(1024, "float32")):
+        T.func_attr({"global_symbol": "func"})
+        K_data = T.allocate_const(k_np, "float32", [1024])
+        K = T.Buffer(1024, "float32", data=K_data)
+        for i in range(1024):
+            B[i] = A[i] + K[i]
+
+    with tvm.transform.PassContext(config={"llvm.raw_data_section_threshold": threshold}):
+        built = tvm.build(func, target="llvm")
+    assert (".incbin" in built.get_source("ll")) == (threshold > 0)
+
+    temp = utils.tempdir()
+    path = temp.relpath("lib.so")
+    built.export_library(path)
+    loaded = tvm.runtime.load_module(path)
+
+    dev = tvm.cpu()
+    a = tvm.nd.array(np.random.uniform(size=1024).astype("float32"), dev)
+    b = tvm.nd.empty([1024], "float32", dev)
+    loaded["func"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + k_np)
+
+
 def test_invalid_volatile_masked_buffer_load():
     @T.prim_func
     def func(b: T.handle):
@@ -1138,5 +1242,33 @@ def test_invalid_volatile_masked_buffer_store():
             tvm.build(func)
 
 
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("predicate_tail", [False, True])
+def test_vectorized_reduction(predicate_tail):
+    """Reductions in vectorized loops are lowered to horizontal vector reductions"""
+
+    @T.prim_func
+    def func(A: T.Buffer((4, 14), "int32"), B: T.Buffer((4,), "int32")):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i in range(4):
+            B[i] = 0
+            for k_0 in range(4):
+                for k_1 in T.vectorized(4):
+                    if k_0 * 4 + k_1 < 14:
+                        B[i] = B[i] + A[i, k_0 * 4 + k_1]
+
+    config = {"tir.enable_buffer_level_predication": predicate_tail}
+    with tvm.transform.PassContext(config=config):
+        built = tvm.build(func, target="llvm")
+    if predicate_tail:
+        assert "llvm.vector.reduce.add" in built.get_source("ll")
+
+    dev = tvm.cpu()
+    a = np.random.randint(-100, 100, size=(4, 14)).astype("int32")
+    b = tvm.nd.empty((4,), "int32", dev)
+    built(tvm.nd.array(a, dev), b)
+    np.testing.assert_equal(b.numpy(), a.sum(axis=1))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -426,5 +426,38 @@ def test_fuse_concat_max_num_args(executor_type, shape_type):
     _validate_opencl_executors(executor_type, _get_model, ref_impl)
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_opencl
+def test_opencl_program_cache(tmp_path):
+    n = 64
+    A = te.placeholder((n,), name="A", dtype="float32")
+    C = te.compute((n,), lambda i: A[i] * 2.0 + 1.0, name="C")
+    sch = tvm.tir.Schedule(te.create_prim_func([A, C]))
+    (x,) = sch.get_loops(sch.get_block("C"))
+    sch.bind(x, "threadIdx.x")
+    lib = tvm.build(sch.mod, target=target)
+    lib_path = str(tmp_path / "lib.so")
+    lib.export_library(lib_path)
+
+    dev = tvm.device(target, 0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    set_cache_dir = tvm.get_global_func("device_api.opencl.set_program_cache_dir")
+    cache_dir = tmp_path / "cache"
+    cache_dir.mkdir()
+    set_cache_dir(str(cache_dir))
+    try:
+        # The first load builds the program from source and fills the cache, the second one
+        # creates it from the cached binary.
+        for _ in range(2):
+            f = tvm.runtime.load_module(lib_path)
+            a = tvm.nd.array(a_np, dev)
+            c = tvm.nd.empty((n,), "float32", dev)
+            f(a, c)
+            tvm.testing.assert_allclose(c.numpy(), a_np * 2.0 + 1.0)
+            assert len(list(cache_dir.glob("*.clbin"))) == 1
+    finally:
+        set_cache_dir("")
+
+
 if __name__ == "__main__":
     tvm.testing.main()
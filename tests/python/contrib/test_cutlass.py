@@ -1122,6 +1122,8 @@ def verify_group_gemm(
         a_np = get_random_ndarray((M, K), "float16")
         b_np = get_random_ndarray((num_groups, N, K), "float16")
         indptr_np = np.arange(1, num_groups + 1).astype("int64") * M_per_group
+        if func_name.endswith("_counts"):
+            indptr_np = np.full((num_groups,), M_per_group, dtype="int64")
         c_np = np.concatenate(
             [a_np[i * M_per_group : (i + 1) * M_per_group] @ b_np[i].T for i in range(num_groups)],
             axis=0,
@@ -1203,5 +1205,35 @@ def test_group_gemm_sm90():
     )
 
 
+@tvm.testing.requires_cutlass
+def test_group_gemm_sm90_counts():
+    verify_group_gemm(
+        "cutlass.group_gemm_fp16_sm90_counts",
+        8,
+        128,
+        128,
+        4,
+        "float16",
+        "float16",
+        "float16",
+        False,
+        rtol=1e-3,
+        atol=1e-3,
+    )
+    verify_group_gemm(
+        "cutlass.group_gemm_e4m3_e4m3_fp16_counts",
+        8,
+        16,
+        16,
+        4,
+        "e4m3_float8",
+        "e4m3_float8",
+        "float16",
+        True,
+        rtol=1e-1,
+        atol=1,
+    )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -643,6 +643,42 @@ def test_multiple_outputs(run_module, dtype="float32"):
     run_and_verify_func(get_graph(), run_module=run_module, dtype=dtype)
 
 
+def test_parallel_branches(run_module, monkeypatch, dtype="float32"):
+    # The independent branches of the subgraph run concurrently in the DNNL runtime
+    monkeypatch.setenv("TVM_JSON_RUNTIME_NUM_THREADS", "4")
+
+    def get_graph():
+        x_shape, k_shape = (1, 16, 8, 8), (16, 16, 3, 3)
+        x = relay.var("x", shape=x_shape, dtype=dtype)
+        kernels = [relay.var("kernel%d" % i, shape=k_shape, dtype=dtype) for i in range(3)]
+        branches = [
+            relay.nn.relu(relay.nn.conv2d(x, k, kernel_size=(3, 3), channels=16, padding=(1, 1)))
+            for k in kernels
+        ]
+        out = relay.add(relay.add(branches[0], branches[1]), branches[2])
+        f = tvm.IRModule.from_expr(out)
+        dic = {"x": x_shape, "kernel0": k_shape, "kernel1": k_shape, "kernel2": k_shape}
+        return f, dic, ["kernel0", "kernel1", "kernel2"]
+
+    run_and_verify_func(get_graph(), run_module=run_module, dtype=dtype)
+
+
+def test_shared_weights(run_module, dtype="float32"):
+    # The weight is reordered into the blocked layout once for both convolutions
+    def get_graph():
+        x_shape, k_shape = (1, 16, 8, 8), (16, 16, 3, 3)
+        x = relay.var("x", shape=x_shape, dtype=dtype)
+        kernel = relay.var("kernel", shape=k_shape, dtype=dtype)
+        out = x
+        for _ in range(2):
+            out = relay.nn.conv2d(out, kernel, kernel_size=(3, 3), channels=16, padding=(1, 1))
+            out = relay.nn.relu(out)
+        f = tvm.IRModule.from_expr(out)
+        return f, {"x": x_shape, "kernel": k_shape}, ["kernel"]
+
+    run_and_verify_func(get_graph(), run_module=run_module, dtype=dtype)
+
+
 def test_elementwise(run_module, dtype="float32"):
     def get_graph(op, x_shape=(1, 8, 3, 3)):
         x = relay.var("x", shape=(x_shape), dtype=dtype)
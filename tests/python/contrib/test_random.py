@@ -187,9 +187,47 @@ def test_random_fill_mt():
     assert no_exception_happened
 
 
+def test_random_reproducible():
+    """The seeded output must not depend on the thread pool configuration."""
+    if not tvm.get_global_func("tvm.contrib.random.seed", True):
+        print("skip because extern function is not available")
+        return
+    seed = tvm.get_global_func("tvm.contrib.random.seed")
+    uniform = tvm.get_global_func("tvm.contrib.random.uniform")
+    normal = tvm.get_global_func("tvm.contrib.random.normal")
+
+    def sample(num_threads):
+        results = []
+
+        def body():
+            if num_threads is not None:
+                configure_threads = tvm.get_global_func("runtime.config_threadpool")
+                configure_threads(1, num_threads)
+            seed(42)
+            for func, args in [(uniform, (-2.0, 3.0)), (normal, (1.0, 2.0))]:
+                value = tvm.nd.empty((1000, 1001), "float32")
+                func(*args, value)
+                results.append(value.numpy())
+
+        # ThreadPool and RandomEngine are thread local.
+        x = threading.Thread(target=body)
+        x.start()
+        x.join()
+        return results
+
+    expected = sample(None)
+    assert len(expected) == 2
+    assert expected[0].min() >= -2.0 and expected[0].max() < 3.0
+    assert abs(expected[1].mean() - 1.0) < 1e-2
+    assert abs(expected[1].std() - 2.0) < 1e-2
+    for actual, desired in zip(sample(1), expected):
+        np.testing.assert_array_equal(actual, desired)
+
+
 if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
     test_random_fill()
     test_random_fill_mt()
+    test_random_reproducible()
@@ -95,6 +95,46 @@ def test_sort_np():
     tvm.testing.assert_allclose(c.numpy(), np_out, rtol=1e-5)
 
 
+def test_argsort_topk_large():
+    """Tests the radix sort, partial top-k and parallel paths against numpy"""
+    dshape = (16, 2048)
+    k = 1024
+    data = te.placeholder(dshape, name="data")
+    dev = tvm.cpu(0)
+    target = "llvm"
+    for is_ascend in [True, False]:
+        argsort_out = te.extern(
+            data.shape,
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.argsort", ins[0], outs[0], 1, is_ascend
+            ),
+            dtype="int64",
+            name="argsort",
+        )
+        topk_out = te.extern(
+            (dshape[0], k),
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.topk", ins[0], outs[0], k, 1, "indices", is_ascend
+            ),
+            dtype="int64",
+            name="topk",
+        )
+        s = te.create_schedule([argsort_out.op, topk_out.op])
+        f = tvm.build(s, [data, argsort_out, topk_out], target)
+
+        # Draw from few values so that the ties exercise the stability.
+        np_data = np.random.randint(-50, 50, size=dshape).astype(data.dtype)
+        np_out = np.argsort(np_data if is_ascend else -np_data, axis=1, kind="stable")
+        a = tvm.nd.array(np_data, dev)
+        b = tvm.nd.array(np.zeros(dshape, dtype="int64"), dev)
+        c = tvm.nd.array(np.zeros((dshape[0], k), dtype="int64"), dev)
+        f(a, b, c)
+        tvm.testing.assert_allclose(b.numpy(), np_out)
+        tvm.testing.assert_allclose(c.numpy(), np_out[:, :k])
+
+
 def test_sort_by_key_gpu():
     """Tests sort function using gpu"""
     size = 6
@@ -131,4 +171,5 @@ def test_sort_by_key_gpu():
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_argsort_topk_large()
     test_sort_by_key_gpu()
@@ -19,7 +19,7 @@ import numpy as np
 import tvm
 import tvm.testing
 from tvm import te
-from tvm.topi.cuda import stable_sort_by_key_thrust
+from tvm.topi.cuda import argsort_thrust, stable_sort_by_key_thrust
 from tvm.topi.cuda.scan import exclusive_scan, scan_thrust, schedule_scan
 from tvm.contrib.thrust import can_use_thrust, can_use_rocthrust
 
@@ -140,7 +140,65 @@ def test_inclusive_scan():
                 tvm.testing.assert_allclose(values_out.numpy(), ref_values_out, rtol=1e-5)
 
 
+def test_argsort_segmented():
+    """Tests function argsort_thrust on batched rows"""
+    for target in ["cuda", "rocm"]:
+        if not tvm.testing.device_enabled(target):
+            print("Skip because %s is not enabled" % target)
+            continue
+
+        with tvm.target.Target(target + " -libs=thrust") as tgt:
+            if not thrust_check_func[target](tgt, "tvm.contrib.thrust.sort"):
+                print("skip because thrust is not enabled...")
+                return
+
+            for is_ascend in [True, False]:
+                data = te.placeholder((8, 100), name="data", dtype="int32")
+                out = argsort_thrust(data, is_ascend=is_ascend, dtype="int32")
+                s = te.create_schedule([out.op])
+
+                dev = tvm.device(target, 0)
+                f = tvm.build(s, [data, out], target)
+
+                # Many ties, whose indices must keep their order
+                data_np = np.random.randint(0, 10, size=(8, 100)).astype(np.int32)
+                out_nd = tvm.nd.array(np.zeros(data_np.shape, np.int32), dev)
+                f(tvm.nd.array(data_np, dev), out_nd)
+
+                key = data_np if is_ascend else -data_np
+                ref_out = np.argsort(key, axis=-1, kind="stable")
+                tvm.testing.assert_allclose(out_nd.numpy(), ref_out)
+
+
+def test_sort_on_stream():
+    """Tests tvm.contrib.thrust.sort on an explicit stream"""
+    if not tvm.testing.device_enabled("cuda"):
+        print("Skip because cuda is not enabled")
+        return
+    sort = tvm.get_global_func("tvm.contrib.thrust.sort", allow_missing=True)
+    if sort is None:
+        print("skip because thrust is not enabled...")
+        return
+
+    dev = tvm.cuda(0)
+    stream = dev.create_raw_stream()
+    try:
+        data_np = np.random.uniform(size=(4, 1000)).astype("float32")
+        values = tvm.nd.empty(data_np.shape, "float32", dev)
+        indices = tvm.nd.empty(data_np.shape, "int64", dev)
+        sort(tvm.nd.array(data_np, dev), values, indices, False, None, stream)
+        dev.sync(stream)
+
+        ref_indices = np.argsort(-data_np, axis=-1, kind="stable")
+        tvm.testing.assert_allclose(indices.numpy(), ref_indices)
+        tvm.testing.assert_allclose(values.numpy(), np.take_along_axis(data_np, ref_indices, -1))
+    finally:
+        dev.free_raw_stream(stream)
+
+
 if __name__ == "__main__":
     test_stable_sort_by_key()
     test_exclusive_scan()
     test_inclusive_scan()
+    test_argsort_segmented()
+    test_sort_on_stream()
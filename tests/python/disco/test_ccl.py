@@ -52,6 +52,15 @@ def test_init(session_kind, ccl):
     sess.init_ccl(ccl, *devices)
 
 
+@pytest.mark.parametrize("ccl", _ccl)
+def test_group_devices_by_topology(ccl):
+    devices = [0, 1, 2, 3]
+    ordered = di.group_devices_by_topology(ccl, devices, group_size=2)
+    assert sorted(ordered) == devices
+    sess = di.ThreadedSession(num_workers=len(devices), num_groups=2)
+    sess.init_ccl(ccl, *ordered)
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 def test_allreduce(session_kind, ccl):
@@ -78,6 +87,30 @@ def test_allreduce(session_kind, ccl):
         np.testing.assert_equal(result, expected)
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("ccl", _ccl)
+def test_allreduce_async(session_kind, ccl):
+    devices = [0, 1]
+    sess = session_kind(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+
+    array_1 = np.arange(12, dtype="float32").reshape(3, 4)
+    array_2 = np.arange(start=1, stop=-11, step=-1, dtype="float32").reshape(3, 4)
+    d_array = sess.empty((3, 4), "float32")
+    d_array.debug_copy_from(0, array_1)
+    d_array.debug_copy_from(1, array_2)
+    sum_array = sess.empty((3, 4), "float32")
+    gather_array = sess.empty((6, 4), "float32")
+    sum_handle = sess.allreduce_async(d_array, sum_array, op="sum")
+    gather_handle = sess.allgather_async(d_array, gather_array)
+    sess.wait_collective(sum_handle)
+    sess.wait_collective(gather_handle)
+    np.testing.assert_equal(sum_array.debug_get_from_remote(0).numpy(), array_1 + array_2)
+    np.testing.assert_equal(
+        gather_array.debug_get_from_remote(1).numpy(), np.concatenate([array_1, array_2], axis=0)
+    )
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 def test_group_allreduce(session_kind, ccl):
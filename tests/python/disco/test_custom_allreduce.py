@@ -77,6 +77,33 @@ def test_allreduce(shape, ccl, strategy):
     np.testing.assert_equal(result_2, expected)
 
 
+@pytest.mark.parametrize("ccl", _ccl)
+def test_tuned_allreduce(ccl):
+    devices = [0, 1]
+    sess: Session = disco.ProcessSession(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+    bucket_sizes = [1 << 12, 1 << 16, 1 << 20, 1 << 24]
+    strategies = sess.tune_custom_allreduce(bucket_sizes, num_iters=5)
+    assert len(strategies) == len(bucket_sizes)
+    assert all(s in (0, 1, 2) for s in strategies)
+    # Tuning again on the same topology reuses the cached result.
+    assert sess.tune_custom_allreduce(bucket_sizes, num_iters=5) == strategies
+
+    shape = (128, 128)
+    dtype = "float32"
+    falloc_ipc_storage = sess.get_global_func("runtime.disco.cuda_ipc.alloc_storage")
+    falloc_tensor = sess.get_global_func("vm.builtin.alloc_tensor")
+    fallreduce = sess.get_global_func("runtime.disco.cuda_ipc.custom_allreduce")
+    d_storage = sess.call_packed(falloc_ipc_storage, ShapeTuple(shape), DataType(dtype))
+    d_input = sess.call_packed(falloc_tensor, d_storage, 0, ShapeTuple(shape), DataType(dtype))
+    array = np.arange(128 * 128, dtype="float32").reshape(*shape)
+    d_input.debug_copy_from(0, array)
+    d_input.debug_copy_from(1, array)
+    d_output = sess.empty(shape, "float32")
+    sess.call_packed(fallreduce, d_input, AllReduceStrategyType.AUTO, d_output)
+    np.testing.assert_equal(d_output.debug_get_from_remote(0).numpy(), array * 2)
+
+
 if __name__ == "__main__":
     for shape, strategy in product(_shapes, _strategies):
         test_allreduce(shape, "nccl", strategy)
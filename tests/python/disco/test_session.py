@@ -16,6 +16,7 @@
 # under the License.
 """Basic tests for a Disco session"""
 # pylint: disable=missing-docstring
+import json
 import tempfile
 
 import numpy as np
@@ -165,6 +166,20 @@ def test_string(session_kind):
         assert result.debug_get_from_remote(i) == "hello_suffix"
 
 
+@pytest.mark.parametrize("use_shm", ["1", "0"])
+def test_process_session_large_message(use_shm, monkeypatch):
+    # Larger than the shared memory ring, so that messages stream through it in pieces.
+    monkeypatch.setenv("TVM_DISCO_SHM", use_shm)
+    num_workers = 4
+    sess = di.ProcessSession(num_workers=num_workers)
+    func: di.DPackedFunc = sess.get_global_func("tests.disco.str")
+    text = "a" * (3 << 20)
+    for _ in range(3):
+        result: di.DRef = func(text)
+        for i in range(num_workers):
+            assert result.debug_get_from_remote(i) == text + "_suffix"
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 def test_string_obj(session_kind):
     num_workers = 4
@@ -178,6 +193,26 @@ def test_string_obj(session_kind):
         assert value == "hello_suffix"
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_batch(session_kind):
+    num_workers = 4
+    sess = session_kind(num_workers=num_workers)
+    with sess.batch():
+        add_one: di.DPackedFunc = sess.get_global_func("tests.disco.add_one")
+        suffix: di.DPackedFunc = sess.get_global_func("tests.disco.str")
+        result: di.DRef = add_one(1)
+        for _ in range(10):
+            result = add_one(result)
+        with sess.batch():
+            text: di.DRef = suffix("hello")
+        # Reading a register flushes the open batch.
+        assert result.debug_get_from_remote(1) == 12
+        result = add_one(result)
+    for i in range(num_workers):
+        assert result.debug_get_from_remote(i) == 13
+        assert text.debug_get_from_remote(i) == "hello_suffix"
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 def test_shape_tuple(session_kind):
     num_workers = 4
@@ -311,5 +346,31 @@ def test_num_workers(session_kind, num_workers):
     assert sess.num_workers == num_workers
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_trace(session_kind):
+    num_workers = 2
+    sess = session_kind(num_workers=num_workers)
+    func: di.DPackedFunc = sess.get_global_func("tests.disco.add_one")
+    sess.start_trace()
+    result: di.DRef = func(1)
+    for i in range(num_workers):
+        assert result.debug_get_from_remote(i) == 2
+    trace = json.loads(sess.stop_trace())
+
+    processes = {
+        event["pid"]: event["args"]["name"]
+        for event in trace["traceEvents"]
+        if event["name"] == "process_name"
+    }
+    for i in range(num_workers):
+        assert processes[i + 1] == f"disco worker {i}"
+        calls = [
+            event
+            for event in trace["traceEvents"]
+            if event["pid"] == i + 1 and event["name"] == "kCallPacked"
+        ]
+        assert calls and all(event["ph"] == "X" and event["dur"] >= 0 for event in calls)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
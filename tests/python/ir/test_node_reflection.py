@@ -195,5 +195,32 @@ def test_alloc_const():
     np.testing.assert_array_equal(np_data, alloc_const2.data.numpy())
 
 
+def test_binary_graph_roundtrip():
+    x = te.var("x")
+    y = tvm.tir.const(2.5, "float32")
+    data = tvm.nd.array(np.random.rand(3, 5).astype("float32"))
+
+    A = te.placeholder((128,), name="A")
+    B = te.compute((128,), lambda i: A[i] * 2.0, name="B")
+    mod = tvm.IRModule({"main": te.create_prim_func([A, B])})
+
+    for node in [
+        x * 2 + x,
+        y,
+        tvm.tir.const(float("-inf"), "float64"),
+        {"key": data, "name": "str", "list": [1, 2, x]},
+        mod,
+    ]:
+        blob = tvm.ir.save_binary_graph(node)
+        assert isinstance(blob, bytearray)
+        tvm.ir.assert_structural_equal(tvm.ir.load_binary_graph(blob), node, map_free_vars=True)
+
+    data2 = tvm.ir.load_binary_graph(tvm.ir.save_binary_graph(data))
+    np.testing.assert_array_equal(data.numpy(), data2.numpy())
+
+    with pytest.raises(tvm.TVMError):
+        tvm.ir.load_binary_graph(bytearray(tvm.ir.save_json(x), "utf-8"))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -17,9 +17,11 @@
 """ Instrument test cases.
 """
 
+import json
+
 import tvm
 from tvm import relax
-from tvm.ir.instrument import PrintAfterAll, PrintBeforeAll
+from tvm.ir.instrument import PassStatisticsInstrument, PrintAfterAll, PrintBeforeAll
 from tvm.script import ir as I
 from tvm.script import relax as R
 from tvm.script import tir as T
@@ -61,3 +63,33 @@ def test_relax_print_all_passes(capsys):
     assert "Before Running Pass:" in all_passes_output
     assert "After Running Pass:" in all_passes_output
     assert "pass name: _pipeline" in all_passes_output
+
+
+def test_pass_statistics():
+    @I.ir_module
+    class Module:
+        @R.function
+        def func(x: R.Tensor((16,), "float32"), y: R.Tensor((16,), "float32")):
+            z = R.add(x, y)
+            return z
+
+    stats = PassStatisticsInstrument()
+    seq = tvm.transform.Sequential(
+        [relax.transform.LegalizeOps(), relax.transform.DeadCodeElimination()], name="seq"
+    )
+    with tvm.transform.PassContext(opt_level=3, instruments=[stats]):
+        seq(Module)
+    # The statistics outlive the pass context
+    records = json.loads(stats.render_json())
+    assert [(r["name"], r["depth"]) for r in records] == [
+        ("seq", 0),
+        ("LegalizeOps", 1),
+        ("DeadCodeElimination", 1),
+    ]
+    assert all(r["completed"] and r["duration_ms"] >= 0 for r in records)
+    legalize = records[1]
+    # LegalizeOps adds a PrimFunc and rewrites the Relax function
+    assert legalize["nodes_after"] > legalize["nodes_before"] > 0
+    assert legalize["functions_changed"] == 2
+    table = stats.render()
+    assert "  LegalizeOps" in table and "Peak RSS(MB)" in table
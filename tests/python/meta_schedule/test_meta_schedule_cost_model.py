@@ -26,7 +26,12 @@ from typing import List
 import numpy as np
 import tvm
 import tvm.testing
-from tvm.meta_schedule.cost_model import PyCostModel, RandomModel, XGBModel
+from tvm.meta_schedule.cost_model import (
+    PyCostModel,
+    RandomModel,
+    TreeEnsembleModel,
+    XGBModel,
+)
 from tvm.meta_schedule.cost_model.xgb_model import PackSum, _get_custom_call_back
 from tvm.meta_schedule.feature_extractor import RandomFeatureExtractor
 from tvm.meta_schedule.runner import RunnerResult
@@ -257,6 +262,32 @@ def test_meta_schedule_xgb_model_reupdate():
     model.predict(TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)])
 
 
+def test_meta_schedule_tree_ensemble_model():
+    extractor = RandomFeatureExtractor()
+    trainer = XGBModel(extractor=extractor, num_warmup_samples=10)
+    model = TreeEnsembleModel(trainer)
+    update_sample_count = 30
+    predict_sample_count = 100
+    model.update(
+        TuneContext(),
+        [_dummy_candidate() for i in range(update_sample_count)],
+        [_dummy_result() for i in range(update_sample_count)],
+    )
+    candidates = [_dummy_candidate() for i in range(predict_sample_count)]
+    random_state = extractor.random_state
+    res_native = model.predict(TuneContext(), candidates)
+    extractor.random_state = random_state
+    res_python = trainer.predict(TuneContext(), candidates)
+    assert np.allclose(res_native, res_python, rtol=1e-4, atol=1e-4)
+    with tempfile.NamedTemporaryFile() as path:
+        model.save(path.name)
+        reloaded = TreeEnsembleModel(XGBModel(extractor=extractor, num_warmup_samples=10))
+        reloaded.load(path.name)
+    extractor.random_state = random_state
+    res_reloaded = reloaded.predict(TuneContext(), candidates)
+    assert (res_native == res_reloaded).all()
+
+
 def test_meta_schedule_xgb_model_callback_as_function():
     # pylint: disable=import-outside-toplevel
     from itertools import chain as itertools_chain
@@ -584,6 +584,130 @@ def test_json_database_get_top_k(k, expected):
     assert result == expected
 
 
+def test_json_database_get_top_k_per_workload():
+    def commit(database, mod, sch_fn, run_secs):
+        workload = database.commit_workload(mod)
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                _create_schedule(mod, sch_fn).trace,
+                workload,
+                run_secs,
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+            )
+        )
+        return workload
+
+    def top_k(database, workload, k):
+        return [[v.value for v in r.run_secs] for r in database.get_top_k(workload, k)]
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = _create_tmp_database(tmpdir)
+        for i in range(4):
+            w_matmul = commit(database, Matmul, _schedule_matmul, [float(4 - i)])
+            w_relu = commit(database, MatmulRelu, _schedule_matmul, [float(i)])
+        commit(database, MatmulRelu, _schedule_matmul, [1e10])
+        assert top_k(database, w_matmul, 2) == [[1.0], [2.0]]
+        assert top_k(database, w_relu, 5) == [[0.0], [1.0], [2.0], [3.0]]
+        # The indexes are rebuilt when the database is loaded from disk.
+        new_database = _create_tmp_database(tmpdir)
+        assert len(new_database) == 9
+        assert top_k(new_database, new_database.commit_workload(Matmul), 2) == [[1.0], [2.0]]
+        assert top_k(new_database, new_database.commit_workload(MatmulRelu), 1) == [[0.0]]
+
+
+def test_json_database_retention_and_compaction():
+    def make_sch_fn(i_inner):
+        def sch_fn(sch: Schedule):
+            block = sch.get_block("matmul")
+            i, _, _ = sch.get_loops(block=block)
+            sch.split(loop=i, factors=[None, i_inner])
+
+        return sch_fn
+
+    def commit(database, i_inner, run_secs):
+        workload = database.commit_workload(Matmul)
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                _create_schedule(Matmul, make_sch_fn(i_inner)).trace,
+                workload,
+                run_secs,
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=Matmul["main"]),
+            )
+        )
+        return workload
+
+    def run_secs(database, workload):
+        return [[v.value for v in r.run_secs] for r in database.get_top_k(workload, 10)]
+
+    def num_lines(path):
+        with open(path, "r", encoding="utf-8") as file:
+            return len(file.readlines())
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = _create_tmp_database(tmpdir)
+        for i_inner, secs in [(2, [3.0]), (4, [1.0]), (8, [4.0]), (4, [2.0]), (16, [1e10])]:
+            workload = commit(database, i_inner, secs)
+        assert len(database) == 5
+        # The slower record of the duplicated trace and the invalid record are dropped
+        database.compact()
+        assert len(database) == 3
+        assert run_secs(database, workload) == [[1.0], [3.0], [4.0]]
+        assert num_lines(database.path_tuning_record) == 3
+        # Loading with a retention policy compacts the files
+        path_workload = database.path_workload
+        path_tuning_record = database.path_tuning_record
+        database = ms.database.JSONDatabase(path_workload, path_tuning_record, retention_top_k=2)
+        assert len(database) == 2
+        assert num_lines(path_tuning_record) == 2
+        # Only the fastest records are kept on commit
+        workload = commit(database, 32, [0.5])
+        commit(database, 64, [1e10])
+        assert run_secs(database, workload) == [[0.5], [1.0]]
+        new_database = ms.database.JSONDatabase(path_workload, path_tuning_record)
+        assert run_secs(new_database, new_database.commit_workload(Matmul)) == [
+            [0.5],
+            [1.0],
+            [3.0],
+        ]
+
+
+@pytest.mark.skipif(
+    tvm.get_global_func("meta_schedule.DatabaseSQLiteDatabase", True) is None,
+    reason="TVM is not built with USE_SQLITE=ON",
+)
+def test_sqlite_database_shared():
+    def make_record(database, mod, run_secs):
+        return ms.database.TuningRecord(
+            _create_schedule(mod, _schedule_matmul).trace,
+            database.commit_workload(mod),
+            run_secs,
+            tvm.target.Target("llvm"),
+            ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+        )
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path = osp.join(tmpdir, "database.sqlite")
+        # Two handles on the same file, as used by two tuning jobs.
+        db_0 = ms.database.SQLiteDatabase(path)
+        db_1 = ms.database.create("sqlite", path)
+        assert not db_1.has_workload(Matmul)
+        for i, run_secs in enumerate([[1.5, 4.5], [], [0.0, 2.0], None, [2.0], [3.0, 1e10]]):
+            database = [db_0, db_1][i % 2]
+            database.commit_tuning_record(make_record(database, Matmul, run_secs))
+        database.commit_tuning_record(make_record(database, MatmulRelu, [0.5]))
+        assert db_0.has_workload(Matmul) and db_0.has_workload(MatmulRelu)
+        assert len(db_0) == len(db_1) == 7
+        for database in [db_0, db_1, ms.database.SQLiteDatabase(path)]:
+            workload = database.commit_workload(Matmul)
+            top_k = [[v.value for v in r.run_secs] for r in database.get_top_k(workload, 3)]
+            assert top_k == [[0.0, 2.0], [2.0], [1.5, 4.5]]
+            (record,) = database.get_top_k(database.commit_workload(MatmulRelu), 5)
+            assert record.run_secs[0].value == 0.5
+            assert len(database.get_all_tuning_records()) == 7
+
+
 def MatmulFunc() -> IRModule:
     a = relay.var("a", relay.TensorType((1024, 1024), "float32"))
     b = relay.var("b", relay.TensorType((1024, 1024), "float32"))
@@ -1632,5 +1632,36 @@ def test_negative_extent():
     assert named_features["B0.unique_bytes"] == 0
 
 
+def test_cached_features():
+    def _create_schedule(vectorize: bool):
+        sch = tir.Schedule(matmul, debug_mask="all")
+        _, j, _ = sch.get_loops(sch.get_block("C"))
+        _, j_i = sch.split(j, factors=[None, 8])
+        if vectorize:
+            sch.vectorize(j_i)
+        return sch
+
+    extractor = ms.feature_extractor.PerStoreFeature()
+    context = _make_context(tvm.target.Target("llvm"))
+    (feature,) = extractor.extract_from(
+        context,
+        candidates=[_make_candidate(lambda: _create_schedule(vectorize=False))],
+    )
+    feature_same, feature_other = extractor.extract_from(
+        context,
+        candidates=[
+            _make_candidate(lambda: _create_schedule(vectorize=False)),
+            _make_candidate(lambda: _create_schedule(vectorize=True)),
+        ],
+    )
+    (feature_fresh,) = ms.feature_extractor.PerStoreFeature().extract_from(
+        context,
+        candidates=[_make_candidate(lambda: _create_schedule(vectorize=True))],
+    )
+    assert_allclose(feature.numpy(), feature_same.numpy())
+    assert_allclose(feature_other.numpy(), feature_fresh.numpy())
+    assert feature.numpy().tolist() != feature_other.numpy().tolist()
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,143 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm import tir
+from tvm.script import tir as T
+from tvm.target import Target
+
+
+def _create_context(mod, target) -> ms.TuneContext:
+    ctx = ms.TuneContext(
+        mod=mod,
+        target=target,
+        space_generator=ms.space_generator.PostOrderApply(
+            sch_rules=[],
+            postprocs=[
+                ms.postproc.RewriteSoftwarePipeline(),
+            ],
+            mutator_probs={},
+        ),
+        task_name="test",
+    )
+    return ctx
+
+
+# fmt: off
+# pylint: disable=no-member,invalid-name,unused-variable,no-self-argument,line-too-long,chained-comparison,not-callable,too-many-nested-blocks
+
+@tvm.script.ir_module
+class PackedMatmul:
+    @T.prim_func
+    def main(A: T.Buffer((128, 128), "float32"), B: T.Buffer((128, 128), "float32"), C: T.Buffer((128, 128), "float32")) -> None:
+        A_global = T.alloc_buffer([128, 128], dtype="float32")
+        for i0, j0, k0 in T.grid(4, 4, 8):
+            for ax0, ax1 in T.grid(32, 16):
+                with T.block("A_global"):
+                    v0 = T.axis.spatial(128, i0 * 32 + ax0)
+                    v1 = T.axis.spatial(128, k0 * 16 + ax1)
+                    A_global[v0, v1] = A[v0, v1]
+            for i1, j1, k1 in T.grid(32, 32, 16):
+                with T.block("C"):
+                    vi = T.axis.spatial(128, i0 * 32 + i1)
+                    vj = T.axis.spatial(128, j0 * 32 + j1)
+                    vk = T.axis.reduce(128, k0 * 16 + k1)
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A_global[vi, vk] * B[vk, vj]
+
+
+@tvm.script.ir_module
+class PackedMatmulReadOutside:
+    @T.prim_func
+    def main(A: T.Buffer((128, 128), "float32"), B: T.Buffer((128, 128), "float32"), C: T.Buffer((128, 128), "float32"), D: T.Buffer((128, 128), "float32")) -> None:
+        A_global = T.alloc_buffer([128, 128], dtype="float32")
+        for i0, j0, k0 in T.grid(4, 4, 8):
+            for ax0, ax1 in T.grid(32, 16):
+                with T.block("A_global"):
+                    v0 = T.axis.spatial(128, i0 * 32 + ax0)
+                    v1 = T.axis.spatial(128, k0 * 16 + ax1)
+                    A_global[v0, v1] = A[v0, v1]
+            for i1, j1, k1 in T.grid(32, 32, 16):
+                with T.block("C"):
+                    vi = T.axis.spatial(128, i0 * 32 + i1)
+                    vj = T.axis.spatial(128, j0 * 32 + j1)
+                    vk = T.axis.reduce(128, k0 * 16 + k1)
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A_global[vi, vk] * B[vk, vj]
+        for i, j in T.grid(128, 128):
+            with T.block("D"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                D[vi, vj] = A_global[vi, vj]
+
+# pylint: enable=no-member,invalid-name,unused-variable,no-self-argument,line-too-long,chained-comparison,not-callable,too-many-nested-blocks
+# fmt: on
+
+
+def _get_pipeline_annotations(sch):
+    return [
+        (
+            list(sch.get(loop).annotations.get("software_pipeline_stage", [])),
+            list(sch.get(loop).annotations.get("software_pipeline_order", [])),
+        )
+        for loop in sch.get_loops(sch.get_block("C"))
+    ]
+
+
+def test_rewrite_packed_matmul():
+    mod = PackedMatmul
+    sch = tir.Schedule(mod, debug_mask="all")
+    ctx = _create_context(mod, Target("llvm"))
+    assert ctx.space_generator.postprocs[0].apply(sch)
+    annotations = _get_pipeline_annotations(sch)
+    assert annotations[2] == ([0, 1], [0, 1])
+    assert all(not stage for stage, _ in annotations[:2] + annotations[3:])
+    # The packed tile is double buffered by the pipeline, which keeps the result unchanged
+    func = tvm.build(sch.mod, target="llvm")
+    dev = tvm.cpu()
+    a_np = np.random.uniform(size=(128, 128)).astype("float32")
+    b_np = np.random.uniform(size=(128, 128)).astype("float32")
+    a, b = tvm.nd.array(a_np, dev), tvm.nd.array(b_np, dev)
+    c = tvm.nd.empty((128, 128), "float32", dev)
+    func(a, b, c)
+    tvm.testing.assert_allclose(c.numpy(), a_np @ b_np, rtol=1e-5)
+
+def test_rewrite_packed_matmul_buffer_used_outside():
+    mod = PackedMatmulReadOutside
+    sch = tir.Schedule(mod, debug_mask="all")
+    ctx = _create_context(mod, Target("llvm"))
+    assert ctx.space_generator.postprocs[0].apply(sch)
+    assert all(not stage for stage, _ in _get_pipeline_annotations(sch))
+
+
+def test_rewrite_packed_matmul_gpu():
+    mod = PackedMatmul
+    sch = tir.Schedule(mod, debug_mask="all")
+    ctx = _create_context(mod, Target("cuda", host="llvm"))
+    assert ctx.space_generator.postprocs[0].apply(sch)
+    assert all(not stage for stage, _ in _get_pipeline_annotations(sch))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
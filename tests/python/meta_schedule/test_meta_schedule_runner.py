@@ -47,6 +47,7 @@ from tvm.meta_schedule.runner.rpc_runner import (
 from tvm.meta_schedule.runner.rpc_runner import (
     default_alloc_argument as rpc_default_alloc_argument,
 )
+from tvm.meta_schedule.runner.utils import run_evaluator_common
 from tvm.meta_schedule.testing.local_rpc import LocalRPC
 from tvm.meta_schedule.utils import (
     derived_object,
@@ -312,6 +313,39 @@ def test_meta_schedule_rpc_multiple_runs():
         _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_rpc_runner_reuse_session():
+    """Test meta schedule rpc runner reusing one session for several runs"""
+    builder = LocalBuilder()
+    (builder_result,) = builder.build([BuilderInput(MatmulModule, Target("llvm"))])
+    assert builder_result.error_msg is None
+    args_info = [TensorInfo("float32", (MATMUL_N, MATMUL_N)) for _ in range(3)]
+    runner_inputs = [RunnerInput(builder_result.artifact_path, "llvm", args_info)] * 5
+
+    with LocalRPC() as rpc:
+        rpc_config = RPCConfig(
+            tracker_host=rpc.tracker_host,
+            tracker_port=rpc.tracker_port,
+            tracker_key=rpc.tracker_key,
+            session_priority=1,
+            session_timeout_sec=100,
+            max_session_reuse=3,
+        )
+        evaluator_config = EvaluatorConfig(
+            number=1,
+            repeat=1,
+            min_repeat_ms=0,
+            enable_cpu_cache_flush=False,
+        )
+        runner = RPCRunner(rpc_config, evaluator_config)
+        runner_futures = runner.run(runner_inputs)
+        runner_results = [runner_future.result() for runner_future in runner_futures]
+
+    for runner_result in runner_results:
+        assert runner_result.error_msg is None
+        assert len(runner_result.run_secs) == 1
+    _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_local_multiple_runs():
     """Test meta schedule local runner for multiple runs"""
     # Build the module
@@ -902,5 +936,56 @@ def test_meta_schedule_local_runner_add_test():
     _clean_build(builder_result.artifact_path)
 
 
+class _ScriptedModule:
+    """A runtime module stand-in whose time evaluator replays scripted costs"""
+
+    entry_name = "main"
+
+    def __init__(self, rounds: List[List[float]]):
+        self.rounds = iter(rounds)
+        self.num_rounds = 0
+
+    def time_evaluator(self, **_kwargs):
+        def evaluate(*_args):
+            self.num_rounds += 1
+            return type("ProfileResult", (), {"results": next(self.rounds)})
+
+        return evaluate
+
+
+class _ScriptedDevice:
+    def sync(self):
+        pass
+
+
+def test_meta_schedule_runner_adaptive_repeat():
+    noisy = [[1.0, 2.0]] + [[1.5, 1.5]] * 9
+    # Without `max_repeat`, exactly one round is measured
+    rt_mod = _ScriptedModule(noisy)
+    costs = run_evaluator_common(
+        rt_mod, _ScriptedDevice(), EvaluatorConfig(number=1, repeat=2), [[]]
+    )
+    assert costs == [1.0, 2.0]
+    # Rounds are added until the confidence interval is narrow enough
+    rt_mod = _ScriptedModule(noisy)
+    costs = run_evaluator_common(
+        rt_mod,
+        _ScriptedDevice(),
+        EvaluatorConfig(number=1, repeat=2, max_repeat=10, target_rel_ci=0.1),
+        [[]],
+    )
+    assert rt_mod.num_rounds == 5
+    assert len(costs) == 10
+    # A measurement slowing down over time is thrown away and measured again
+    rt_mod = _ScriptedModule([[1.0, 1.0, 1.0, 2.0, 2.0, 2.0], [1.0, 1.0, 1.0, 1.0, 1.0, 1.0]])
+    costs = run_evaluator_common(
+        rt_mod,
+        _ScriptedDevice(),
+        EvaluatorConfig(number=1, repeat=6, drift_threshold=0.2),
+        [[]],
+    )
+    assert costs == [1.0] * 6
+
+
 if __name__ == "__main__":
     tvm.testing.main()
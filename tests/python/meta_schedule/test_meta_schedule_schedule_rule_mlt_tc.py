@@ -576,7 +576,6 @@ def test_matmul_relu_pipeline(shared_scope):
         T.func_attr({"global_symbol": "main", "tir.noalias": True})
         # body
         # with T.block("root")
-        C = T.alloc_buffer((128, 128))
         C_reindex_shared = T.alloc_buffer((4, 4, 2, 2, 16, 16), scope=shared_scope)
         C_reindex_shared_wmma_accumulator = T.alloc_buffer((4, 4, 2, 2, 16, 16), scope="wmma.accumulator")
         A_reindex_shared = T.alloc_buffer((128, 128), "float16", scope=shared_scope)
@@ -680,15 +679,9 @@ def test_matmul_relu_pipeline(shared_scope):
                             v4 = T.axis.spatial(16, ax0_ax1_ax3_ax4_ax5_fused % 256 // 16)
                             v5 = T.axis.spatial(16, ax0_ax1_ax3_ax4_ax5_fused % 16)
                             T.reads(C_reindex_shared[v0, v1, v2, v3, v4, v5])
-                            T.writes(C[v4 + v2 * 16 + v0 * 32, v5 + v3 * 16 + v1 * 32])
+                            T.writes(compute[v4 + v2 * 16 + v0 * 32, v5 + v3 * 16 + v1 * 32])
                             T.block_attr({"meta_schedule.cooperative_fetch": 3})
-                            C[v4 + v2 * 16 + v0 * 32, v5 + v3 * 16 + v1 * 32] = C_reindex_shared[v0, v1, v2, v3, v4, v5]
-        for i0, i1 in T.grid(128, 128):
-            with T.block("compute"):
-                v_i0, v_i1 = T.axis.remap("SS", [i0, i1])
-                T.reads(C[v_i0, v_i1])
-                T.writes(compute[v_i0, v_i1])
-                compute[v_i0, v_i1] = T.max(C[v_i0, v_i1], T.float32(0))
+                            compute[v4 + v2 * 16 + v0 * 32, v5 + v3 * 16 + v1 * 32] = T.max(C_reindex_shared[v0, v1, v2, v3, v4, v5], T.float32(0))
 
     # fmt: on
     decision_0 = [
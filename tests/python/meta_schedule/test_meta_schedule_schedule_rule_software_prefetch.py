@@ -0,0 +1,102 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.testing.space_generation import (
+    check_sketches,
+    generate_design_space,
+)
+from tvm.script import tir as T
+from tvm.target import Target
+
+# fmt: off
+# pylint: disable=no-member,invalid-name,unused-variable,no-self-argument,line-too-long,chained-comparison,not-callable,too-many-nested-blocks
+
+@tvm.script.ir_module
+class GEMV:
+    @T.prim_func
+    def main(A: T.Buffer((1024, 1024), "float32"), B: T.Buffer((1024,), "float32"), C: T.Buffer((1024,), "float32")) -> None:
+        T.func_attr({"global_symbol": "main"})
+        for i, k in T.grid(1024, 1024):
+            with T.block("gemv"):
+                vi, vk = T.axis.remap("SR", [i, k])
+                with T.init():
+                    C[vi] = T.float32(0)
+                C[vi] = C[vi] + A[vi, vk] * B[vk]
+
+# pylint: enable=no-member,invalid-name,unused-variable,no-self-argument,line-too-long,chained-comparison,not-callable,too-many-nested-blocks
+# fmt: on
+
+
+def test_software_prefetch():
+    @T.prim_func
+    def GEMV_0(
+        A: T.Buffer((1024, 1024), "float32"),
+        B: T.Buffer((1024,), "float32"),
+        C: T.Buffer((1024,), "float32"),
+    ) -> None:
+        T.func_attr({"global_symbol": "main"})
+        with T.block("root"):
+            T.reads()
+            T.writes()
+            T.block_attr({"pragma_software_prefetch_distance": 256})
+            for i, k in T.grid(1024, 1024):
+                with T.block("gemv"):
+                    vi, vk = T.axis.remap("SR", [i, k])
+                    T.reads(A[vi, vk], B[vk])
+                    T.writes(C[vi])
+                    with T.init():
+                        C[vi] = T.float32(0)
+                    C[vi] = C[vi] + A[vi, vk] * B[vk]
+
+    decision_0 = [
+        ("SampleCategorical", 1),
+    ]
+
+    mod = GEMV
+    actual = generate_design_space(
+        kind="llvm",
+        mod=mod,
+        target=Target("llvm --num-cores=32"),
+        types=None,
+        sch_rules=[ms.schedule_rule.SoftwarePrefetch(distances=[0, 256, 512, 1024])],
+    )
+    check_sketches(
+        mod,
+        sketches=actual,
+        expected_mods=[GEMV_0],
+        expected_decisions=[decision_0],
+    )
+
+
+def test_software_prefetch_disabled():
+    actual = generate_design_space(
+        kind="llvm",
+        mod=GEMV,
+        target=Target("llvm --num-cores=32"),
+        types=None,
+        sch_rules=[ms.schedule_rule.SoftwarePrefetch(distances=[])],
+    )
+    assert len(actual) == 1
+    trace = actual[0].trace.simplified(remove_postproc=True)
+    assert not trace.insts
+
+
+if __name__ == "__main__":
+    test_software_prefetch()
+    test_software_prefetch_disabled()
@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.testing import te_workload
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.target import Target
+from tvm.te import create_prim_func
+
+
+def _split_k():
+    return ms.schedule_rule.SplitK(
+        split_factors=[2, 4, 8, 16],
+        max_spatial_extent=4096,
+        tiling=ms.schedule_rule.MultiLevelTiling(
+            structure="SSSRRSRS",
+            tile_binds=["blockIdx.x", "vthread.x", "threadIdx.x"],
+            max_innermost_factor=64,
+            vector_load_lens=[1, 2, 3, 4, 8, 16],
+            reuse_read=ms.schedule_rule.ReuseType(req="must", levels=[4], scope="shared"),
+            reuse_write=ms.schedule_rule.ReuseType(req="must", levels=[3], scope="local"),
+        ),
+    )
+
+
+def _has_block(sch, name):
+    try:
+        sch.get_block(name)
+        return True
+    except tvm.tir.schedule.ScheduleError:
+        return False
+
+
+def test_cuda_decode_matmul_relu():
+    mod = create_prim_func(te_workload.matmul_relu(n=1, m=4096, k=4096))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=None,
+        sch_rules=[_split_k()],
+    )
+    split = [sch for sch in actual if _has_block(sch, "C_rf")]
+    assert len(split) == len(actual) - 1
+    assert not _has_block(actual[-1], "C_rf")
+    for sch in split:
+        assert "RFactor" in [inst.kind.name for inst in sch.trace.insts]
+        # The relu epilogue runs in the loop nest reducing the partial sums
+        block = sch.get_block("C")
+        (relu,) = sch.get_consumers(block)
+        assert sch.get(sch.get_loops(block)[0]).same_as(sch.get(sch.get_loops(relu)[0]))
+
+
+def test_cuda_wide_matmul_not_split():
+    mod = create_prim_func(te_workload.matmul(n=512, m=512, k=512))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=None,
+        sch_rules=[_split_k()],
+    )
+    assert len(actual) == 1
+    assert not _has_block(actual[0], "C_rf")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
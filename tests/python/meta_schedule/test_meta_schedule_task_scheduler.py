@@ -175,7 +175,8 @@ def test_meta_schedule_task_scheduler_single():
     assert len(database) == max_trials_per_task
 
 
-def test_meta_schedule_task_scheduler_multiple():
+@pytest.mark.parametrize("max_inflight_batches", [1, 3])
+def test_meta_schedule_task_scheduler_multiple(max_inflight_batches):
     num_trials_per_iter = 6
     max_trials_per_task = 101
     tasks = [
@@ -206,6 +207,7 @@ def test_meta_schedule_task_scheduler_multiple():
     ]
     database = ms.database.MemoryDatabase()
     round_robin = ms.task_scheduler.RoundRobin()
+    round_robin.set_max_inflight_batches(max_inflight_batches)
     round_robin.tune(
         tasks,
         [1.0, 1.0, 1.0],
@@ -353,6 +355,51 @@ def test_meta_schedule_task_scheduler_multiple_gradient_based():
         )
 
 
+def test_meta_schedule_task_scheduler_gradient_based_early_stop():
+    max_trials_per_task = 101
+    num_trials_per_iter = 6
+    early_stop_rounds = 2
+    tasks = [
+        ms.TuneContext(
+            MatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="Matmul",
+            rand_state=42,
+        ),
+        ms.TuneContext(
+            BatchMatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_batch_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="BatchMatmul",
+            rand_state=0x114514,
+        ),
+    ]
+    database = ms.database.MemoryDatabase()
+    # Any improvement below 100% is negligible, so every task converges after a few rounds
+    gradient_based = ms.task_scheduler.GradientBased(
+        early_stop_rounds=early_stop_rounds,
+        early_stop_min_improvement=1.0,
+    )
+    gradient_based.tune(
+        tasks,
+        task_weights=[1.0, 1.0],
+        builder=DummyBuilder(),
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        max_trials_global=max_trials_per_task * len(tasks),
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=num_trials_per_iter,
+        cost_model=None,
+    )
+    for task in tasks:
+        num_records = len(database.get_top_k(database.commit_workload(task.mod), 10000))
+        assert num_records == num_trials_per_iter * (early_stop_rounds + 1)
+
+
 def test_meta_schedule_task_scheduler_gradient_based_with_null_search_strategy():
     """
     When search strategy of one task returns empty list of candidates or None,
@@ -443,4 +490,5 @@ if __name__ == "__main__":
     test_meta_schedule_task_scheduler_avoid_cyclic()
     test_meta_schedule_task_scheduler_override_next_task_id_only()
     test_meta_schedule_task_scheduler_multiple_gradient_based()
+    test_meta_schedule_task_scheduler_gradient_based_early_stop()
     test_meta_schedule_task_scheduler_gradient_based_with_null_search_strategy()
@@ -18,6 +18,7 @@ import pytest
 import tvm
 import tvm.meta_schedule as ms
 import tvm.testing
+from tvm import te
 from tvm.script import tir as T
 from tvm.target import Target
 from tvm.target.codegen import llvm_lookup_intrinsic_id
@@ -3344,5 +3345,25 @@ def test_inline_order():
     )
 
 
+def test_apply_trace_across_shapes():
+    def matmul(n):
+        a = te.placeholder((n, n), name="A")
+        b = te.placeholder((n, n), name="B")
+        k = te.reduce_axis((0, n), name="k")
+        c = te.compute((n, n), lambda i, j: te.sum(a[i, k] * b[k, j], axis=k), name="C")
+        return tvm.IRModule({"main": te.create_prim_func([a, b, c])})
+
+    src = Schedule(matmul(128))
+    i, _, k = src.get_loops(src.get_block("C"))
+    src.split(i, src.sample_perfect_tile(i, n=3, max_innermost_factor=16, decision=[2, 4, 16]))
+    src.split(k, src.sample_perfect_tile(k, n=2, max_innermost_factor=64, decision=[2, 64]))
+
+    sch = Schedule(matmul(96))
+    ms.trace_apply.apply_trace_across_shapes(sch, src.trace)
+    extents = [int(sch.get(loop).extent) for loop in sch.get_loops(sch.get_block("C"))]
+    # The inner tiles that still divide the extent are kept
+    assert extents == [2, 3, 16, 96, 2, 48]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
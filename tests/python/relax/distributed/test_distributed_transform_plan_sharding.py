@@ -0,0 +1,77 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#  type: ignore
+
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+import tvm
+from tvm import relax
+from tvm.ir import assert_structural_equal
+import tvm.testing
+
+
+@I.ir_module
+class MLP:
+    I.module_attrs({"device_num": 2})
+    I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+    @R.function
+    def foo(
+        x: R.Tensor((128, 128), "float32"),
+        weight1: R.Tensor((128, 128), "float32"),
+        weight2: R.Tensor((128, 128), "float32"),
+    ) -> R.Tensor((128, 128), "float32"):
+        lv0 = R.matmul(x, weight1)
+        lv1 = R.nn.gelu(lv0)
+        lv2 = R.matmul(lv1, weight2)
+        lv3 = R.nn.softmax(lv2)
+        return lv3
+
+
+def test_mlp():
+    @I.ir_module
+    class AnnotatedMLP:
+        I.module_attrs({"device_num": 2})
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @R.function
+        def foo(
+            x: R.Tensor((128, 128), "float32"),
+            weight1: R.Tensor((128, 128), "float32"),
+            weight2: R.Tensor((128, 128), "float32"),
+        ) -> R.Tensor((128, 128), "float32"):
+            weight1_1 = R.dist.annotate_sharding(weight1, device_mesh="mesh[0]", placement="S[1]")
+            lv0 = R.matmul(x, weight1_1)
+            lv1 = R.nn.gelu(lv0)
+            weight2_1 = R.dist.annotate_sharding(weight2, device_mesh="mesh[0]", placement="S[0]")
+            lv2 = R.matmul(lv1, weight2_1)
+            lv3 = R.nn.softmax(lv2)
+            return lv3
+
+    # On slow devices the split computation outweighs the allreduce
+    after = relax.distributed.transform.PlanSharding(device_flops=1e9)(MLP)
+    assert_structural_equal(after, AnnotatedMLP)
+
+
+def test_mlp_communication_bound():
+    # On fast devices the small matmuls are faster replicated than followed by an allreduce
+    after = relax.distributed.transform.PlanSharding(device_flops=1e14)(MLP)
+    assert_structural_equal(after, MLP)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -168,6 +168,29 @@ def get_relax_matmul_multiply_module(
     return tvm.IRModule({"main": func})
 
 
+def test_matmul_bias_offload_repeated_calls():
+    """The cached cuBLASLt plans are reused across calls with new shapes, inputs and biases"""
+    mod = get_relax_matmul_module(
+        (tvm.tir.Var("m", "int64"), 32),
+        (32, 64),
+        "float16",
+        "float16",
+        bias_shape=(64,),
+    )
+    mod = partition_for_cublas(mod)
+    mod = relax.transform.RunCodegen()(mod)
+    dev = tvm.cuda(0)
+    vm = relax.VirtualMachine(relax.build(mod, "cuda"), dev)
+
+    for m in [4, 16, 4, 16]:
+        x = np.random.randn(m, 32).astype("float16")
+        y = np.random.randn(32, 64).astype("float16")
+        bias = np.random.randn(64).astype("float16")
+        out = vm["main"](*[tvm.nd.array(arr, dev) for arr in (x, y, bias)]).numpy()
+        ref = x.astype("float32") @ y.astype("float32") + bias.astype("float32")
+        tvm.testing.assert_allclose(out, ref, rtol=1e-2, atol=1e-2)
+
+
 @pytest.mark.parametrize(
     "x_shape, y_shape, transpose_y, epilogue",
     [
@@ -111,5 +111,43 @@ def test_tensorrt_offload():
     tvm.testing.assert_allclose(out, ref, rtol=1e-3, atol=1e-3)
 
 
+@tvm.script.ir_module
+class DynamicBatchAddRelu:
+    @R.function
+    def main(x: R.Tensor(("n", 16), "float32"), y: R.Tensor(("n", 16), "float32")):
+        with R.dataflow():
+            out = relax.op.nn.relu(relax.op.add(x, y))
+            R.output(out)
+
+        return out
+
+
+def test_tensorrt_offload_shape_profiles():
+    patterns = [
+        ("tensorrt.nn.relu", is_op("relax.nn.relu")(wildcard())),
+        ("tensorrt.add", is_op("relax.add")(wildcard(), wildcard())),
+    ]
+    options = {"use_implicit_batch": False, "shape_profiles": {"n": [1, 4, 8]}}
+    with tvm.transform.PassContext(config={"relax.ext.tensorrt.options": options}):
+        mod = tvm.transform.Sequential(
+            [
+                relax.transform.FuseOpsByPattern(patterns),
+                relax.transform.MergeCompositeFunctions(),
+                relax.transform.RunCodegen(),
+            ]
+        )(DynamicBatchAddRelu)
+
+    dev = tvm.cuda(0)
+    ex = relax.build(mod, "cuda")
+    vm = relax.VirtualMachine(ex, dev)
+    # A single engine built for the profile serves every batch size in its range
+    for batch_size in [1, 3, 8]:
+        x_np = np.random.randn(batch_size, 16).astype("float32")
+        y_np = np.random.randn(batch_size, 16).astype("float32")
+        out = vm["main"](tvm.nd.array(x_np, dev), tvm.nd.array(y_np, dev)).numpy()
+        tvm.testing.assert_allclose(out, np.maximum(x_np + y_np, 0), rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     test_tensorrt_offload()
+    test_tensorrt_offload_shape_profiles()
@@ -338,6 +338,63 @@ def test_attention():
         assert np.max(np.abs(ref - out)) == 0.0
 
 
+def test_attention_gqa():
+    np.random.seed(0)
+    num_heads = 16
+    num_kv_heads = 2
+    head_dim = 128
+    vec_size = 8
+    block_size = 16
+    context_lens = np.array([37, 700, 1]).astype("int32")
+    num_seqs = len(context_lens)
+    max_num_blocks_per_seq = (int(np.max(context_lens)) + block_size - 1) // block_size
+    num_blocks = num_seqs * max_num_blocks_per_seq
+    num_partitions = (int(np.max(context_lens)) + 511) // 512
+
+    query = np.random.randn(num_seqs, num_heads, head_dim).astype("float16")
+    key_cache = np.random.randn(
+        num_blocks, num_kv_heads, head_dim // vec_size, block_size, vec_size
+    ).astype("float16")
+    value_cache = np.random.randn(num_blocks, num_kv_heads, head_dim, block_size).astype("float16")
+    block_tables = (
+        np.random.permutation(num_blocks).reshape(num_seqs, max_num_blocks_per_seq).astype("int32")
+    )
+
+    ref = np.zeros_like(query, dtype="float32")
+    for s in range(num_seqs):
+        tokens = np.arange(context_lens[s])
+        blocks = block_tables[s, tokens // block_size]
+        for h in range(num_heads):
+            kv_head = h // (num_heads // num_kv_heads)
+            keys = key_cache[blocks, kv_head, :, tokens % block_size, :].reshape(-1, head_dim)
+            values = value_cache[blocks, kv_head, :, tokens % block_size]
+            logits = keys.astype("float32") @ query[s, h].astype("float32") / np.sqrt(head_dim)
+            probs = np.exp(logits - np.max(logits))
+            ref[s, h] = (probs / np.sum(probs)) @ values.astype("float32")
+
+    dev = tvm.cuda(0)
+    inputs = [query, key_cache, value_cache, block_tables, context_lens]
+    args = [tvm.nd.array(arr, dev) for arr in inputs]
+    max_context_len = tvm.nd.array(np.array([np.max(context_lens)]).astype("int32"))
+
+    # v2 processes the 8 query heads of each KV head in one thread block, v1 one query head per
+    # thread block
+    out_v1 = tvm.nd.empty(query.shape, "float16", dev)
+    tvm.get_global_func("tvm.contrib.vllm.single_query_cached_kv_attention_v1")(
+        *args, block_size, max_context_len, out_v1
+    )
+    out_v2 = tvm.nd.empty(query.shape, "float16", dev)
+    exp_sums = tvm.nd.empty((num_seqs, num_heads, num_partitions), "float32", dev)
+    max_logits = tvm.nd.empty((num_seqs, num_heads, num_partitions), "float32", dev)
+    tmp_out = tvm.nd.empty((num_seqs, num_heads, num_partitions, head_dim), "float16", dev)
+    tvm.get_global_func("tvm.contrib.vllm.single_query_cached_kv_attention_v2")(
+        *args, block_size, max_context_len, exp_sums, max_logits, tmp_out, out_v2
+    )
+
+    for out in [out_v1, out_v2]:
+        tvm.testing.assert_allclose(out.numpy(), ref, rtol=1e-2, atol=1e-2)
+
+
 def test_cache():
     @I.ir_module
     class Module:
@@ -18,7 +18,7 @@
 from typing import List, Set, Tuple
 import tvm
 from tvm import relax, testing
-from tvm.relax.transform import DataflowUseInplaceCalls
+from tvm.relax.transform import DataflowUseInplaceCalls, UseInplaceCalls
 from tvm.relax.testing.transform import (
     dataflow_liveness_analysis,
     dataflow_alias_analysis,
@@ -640,5 +640,175 @@ def test_dynamic_mismatch():
     tvm.ir.assert_structural_equal(new_mod, DynamicMistmatchTestCase)
 
 
+def test_inplace_outside_dataflow():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((2, 3), dtype="float32")
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            z = R.add(x, y)  # cannot be done in-place: x and y are arguments
+            a = R.multiply(z, y)  # can be done in-place: z is dead, though not in a dataflow block
+            with R.dataflow():
+                b = R.subtract(a, y)  # a is not a dataflow var, but dead after this
+                R.output(b)
+            return b
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def multiply_inplace(
+            A: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+            B: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for ax0, ax1 in T.grid(T.int64(2), T.int64(3)):
+                with T.block("T_multiply"):
+                    v_ax0, v_ax1 = T.axis.remap("SS", [ax0, ax1])
+                    T.reads(A[v_ax0, v_ax1], B[v_ax0, v_ax1])
+                    T.writes(A[v_ax0, v_ax1])
+                    A[v_ax0, v_ax1] = A[v_ax0, v_ax1] * B[v_ax0, v_ax1]
+
+        @T.prim_func(private=True)
+        def subtract_inplace(
+            A: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+            B: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for ax0, ax1 in T.grid(T.int64(2), T.int64(3)):
+                with T.block("T_subtract"):
+                    v_ax0, v_ax1 = T.axis.remap("SS", [ax0, ax1])
+                    T.reads(A[v_ax0, v_ax1], B[v_ax0, v_ax1])
+                    T.writes(A[v_ax0, v_ax1])
+                    A[v_ax0, v_ax1] = A[v_ax0, v_ax1] - B[v_ax0, v_ax1]
+
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((2, 3), dtype="float32")
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            cls = Expected
+            z: R.Tensor((2, 3), dtype="float32") = R.add(x, y)
+            a: R.Tensor((2, 3), dtype="float32") = R.call_tir_inplace(
+                cls.multiply_inplace,
+                (z, y),
+                inplace_indices=[0],
+                out_sinfo=R.Tensor((2, 3), dtype="float32"),
+            )
+            with R.dataflow():
+                b: R.Tensor((2, 3), dtype="float32") = R.call_tir_inplace(
+                    cls.subtract_inplace,
+                    (a, y),
+                    inplace_indices=[0],
+                    out_sinfo=R.Tensor((2, 3), dtype="float32"),
+                )
+                R.output(b)
+            return b
+
+    new_mod = UseInplaceCalls()(Before)
+    tvm.ir.assert_structural_equal(new_mod, Expected)
+    # the dataflow version does not see that `a` is dead
+    tvm.ir.assert_structural_equal(DataflowUseInplaceCalls()(Before), Before)
+
+
+def test_inplace_elementwise_call_tir():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def exp(A: T.Buffer((T.int64(4),), "float32"), B: T.Buffer((T.int64(4),), "float32")):
+            for i in range(T.int64(4)):
+                with T.block("exp"):
+                    vi = T.axis.spatial(T.int64(4), i)
+                    B[vi] = T.exp(A[vi])
+
+        @T.prim_func(private=True)
+        def reverse(A: T.Buffer((T.int64(4),), "float32"), B: T.Buffer((T.int64(4),), "float32")):
+            for i in range(T.int64(4)):
+                with T.block("reverse"):
+                    vi = T.axis.spatial(T.int64(4), i)
+                    B[vi] = A[T.int64(3) - vi]
+
+        @R.function
+        def main(x: R.Tensor((4,), dtype="float32")) -> R.Tensor((4,), dtype="float32"):
+            cls = Before
+            y = R.call_tir(cls.exp, (x,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            # cannot be done in-place: not elementwise
+            z = R.call_tir(cls.reverse, (y,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            w = R.call_tir(cls.exp, (z,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            return w
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def exp(A: T.Buffer((T.int64(4),), "float32"), B: T.Buffer((T.int64(4),), "float32")):
+            for i in range(T.int64(4)):
+                with T.block("exp"):
+                    vi = T.axis.spatial(T.int64(4), i)
+                    B[vi] = T.exp(A[vi])
+
+        @T.prim_func(private=True)
+        def exp_inplace(A: T.Buffer((T.int64(4),), "float32")):
+            for i in range(T.int64(4)):
+                with T.block("exp"):
+                    vi = T.axis.spatial(T.int64(4), i)
+                    A[vi] = T.exp(A[vi])
+
+        @T.prim_func(private=True)
+        def reverse(A: T.Buffer((T.int64(4),), "float32"), B: T.Buffer((T.int64(4),), "float32")):
+            for i in range(T.int64(4)):
+                with T.block("reverse"):
+                    vi = T.axis.spatial(T.int64(4), i)
+                    B[vi] = A[T.int64(3) - vi]
+
+        @R.function
+        def main(x: R.Tensor((4,), dtype="float32")) -> R.Tensor((4,), dtype="float32"):
+            cls = Expected
+            y = R.call_tir(cls.exp, (x,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            z = R.call_tir(cls.reverse, (y,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            w = R.call_tir_inplace(
+                cls.exp_inplace,
+                (z,),
+                inplace_indices=[0],
+                out_sinfo=R.Tensor((4,), dtype="float32"),
+            )
+            return w
+
+    new_mod = UseInplaceCalls()(Before)
+    tvm.ir.assert_structural_equal(new_mod, Expected)
+
+
+def test_inplace_call_dps_packed():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((4,), dtype="float32")) -> R.Tensor((4,), dtype="float32"):
+            y = R.call_dps_packed("my_exp", (x,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            z = R.call_dps_packed("my_exp", (y,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            w = R.call_dps_packed("my_log", (z,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            return w
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def my_exp_inplace(arg0: T.Buffer((T.int64(4),), "float32")):
+            T.evaluate(T.call_packed("my_exp", arg0, arg0))
+
+        @R.function
+        def main(x: R.Tensor((4,), dtype="float32")) -> R.Tensor((4,), dtype="float32"):
+            cls = Expected
+            y = R.call_dps_packed("my_exp", (x,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            z = R.call_tir_inplace(
+                cls.my_exp_inplace,
+                (y,),
+                inplace_indices=[0],
+                out_sinfo=R.Tensor((4,), dtype="float32"),
+            )
+            # not declared to be safe to call in-place
+            w = R.call_dps_packed("my_log", (z,), out_sinfo=R.Tensor((4,), dtype="float32"))
+            return w
+
+    new_mod = UseInplaceCalls(["my_exp"])(Before)
+    tvm.ir.assert_structural_equal(new_mod, Expected)
+
+
 if __name__ == "__main__":
     testing.main()
@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R
+
+
+@I.ir_module
+class Module:
+    @R.function
+    def main(
+        x: R.Tensor((4, 8), "float32"), w: R.Tensor((16, 8), "float32")
+    ) -> R.Tensor((4, 16), "float32"):
+        R.func_attr({"num_input": 1})
+        with R.dataflow():
+            w_t = R.permute_dims(w, [1, 0])
+            gv = R.matmul(x, w_t)
+            R.output(gv)
+        return gv
+
+
+def _build():
+    mod = relax.transform.LiftTransformParams()(Module)
+    key = relax.transform_params_key(mod, "main_transform_params", "llvm")
+    vm = relax.VirtualMachine(relax.build(mod, "llvm"), tvm.cpu())
+    return vm, key
+
+
+def test_cache_hit(tmp_path):
+    vm, key = _build()
+    w = tvm.nd.array(np.random.uniform(size=(16, 8)).astype("float32"))
+    num_calls = [0]
+
+    def ftransform(params):
+        num_calls[0] += 1
+        return vm["main_transform_params"](params)
+
+    first = relax.cached_transform_params(ftransform, [w], str(tmp_path), key)
+    second = relax.cached_transform_params(ftransform, [w], str(tmp_path), key)
+    assert num_calls[0] == 1
+    assert len(second) == len(first) == 1
+    tvm.testing.assert_allclose(second[0].numpy(), w.numpy().T)
+
+    # Other parameters, or another transformation, miss the cache
+    other_w = tvm.nd.array(np.random.uniform(size=(16, 8)).astype("float32"))
+    relax.cached_transform_params(ftransform, [other_w], str(tmp_path), key)
+    relax.cached_transform_params(ftransform, [w], str(tmp_path), key + "0")
+    assert num_calls[0] == 3
+
+
+def test_corrupted_entry(tmp_path):
+    vm, key = _build()
+    w = tvm.nd.array(np.random.uniform(size=(16, 8)).astype("float32"))
+    relax.cached_transform_params(vm["main_transform_params"], [w], str(tmp_path), key, "w")
+    for entry in tmp_path.iterdir():
+        entry.write_bytes(b"corrupted")
+    transformed = relax.cached_transform_params(
+        vm["main_transform_params"], [w], str(tmp_path), key, "w"
+    )
+    tvm.testing.assert_allclose(transformed[0].numpy(), w.numpy().T)
+
+
+def test_transform_params_key():
+    mod = relax.transform.LiftTransformParams()(Module)
+    key = relax.transform_params_key(mod, "main_transform_params", "llvm")
+    assert key == relax.transform_params_key(mod, "main_transform_params", "llvm")
+    assert key != relax.transform_params_key(mod, "main_transform_params", "llvm -mcpu=skylake")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
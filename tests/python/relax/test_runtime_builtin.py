@@ -188,6 +188,116 @@ def test_ndarray_cache():
         np.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_ndarray_cache_raw_mapped():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+    fclear = tvm.get_global_func("vm.builtin.ndarray_cache.clear")
+
+    param_dict = {
+        "y_0": np.arange(64, dtype="int32"),
+        "y_1": np.random.uniform(size=[10, 20]).astype("float32"),
+        "y_2": np.random.uniform(size=[7]).astype("float16"),
+    }
+
+    temp = utils.tempdir()
+    tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format="raw")
+    fload(str(temp.path), tvm.cpu().device_type, 0)
+    res = fget_params("y", -1)
+    assert len(res) == len(param_dict)
+    for i, v in enumerate(res):
+        np.testing.assert_equal(v.numpy(), param_dict[f"y_{i}"])
+
+    # Parameters that alias the mapped shard are private to the process.
+    res[0].copyfrom(np.zeros(64, dtype="int32"))
+    fclear()
+    fload(str(temp.path), tvm.cpu().device_type, 0)
+    np.testing.assert_equal(fget_params("y", -1)[0].numpy(), param_dict["y_0"])
+    fclear()
+
+
+def test_ndarray_cache_shared():
+    fupdate = tvm.get_global_func("vm.builtin.ndarray_cache.update")
+    fexport = tvm.get_global_func("vm.builtin.ndarray_cache.export_shared")
+    fimport = tvm.get_global_func("vm.builtin.ndarray_cache.import_shared")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+    fclear = tvm.get_global_func("vm.builtin.ndarray_cache.clear")
+
+    param_dict = {
+        "s_0": np.arange(7, dtype="int8"),
+        "s_1": np.random.uniform(size=[10, 20]).astype("float32"),
+        "s_2": np.random.uniform(size=[3]).astype("float16"),
+    }
+    for name, value in param_dict.items():
+        fupdate(name, tvm.nd.array(value))
+
+    temp = utils.tempdir()
+    segment = temp.relpath("weights.shm")
+    fexport(segment, ["s_0", "s_1", "s_2"])
+    fclear()
+    assert fimport(segment) == len(param_dict)
+    res = fget_params("s", -1)
+    assert len(res) == len(param_dict)
+    for i, v in enumerate(res):
+        np.testing.assert_equal(v.numpy(), param_dict[f"s_{i}"])
+    fclear()
+
+
+@pytest.mark.parametrize("encode_format", ["f32-to-bf16", "f32-to-f16"])
+def test_ndarray_cache_decode_f32(encode_format):
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+    fclear = tvm.get_global_func("vm.builtin.ndarray_cache.clear")
+
+    # Sizes that exercise both the vectorized body and the scalar tail,
+    # as well as the parallel decoding of large parameters.
+    param_dict = {
+        "z_0": np.random.uniform(size=[3]).astype("float32"),
+        "z_1": np.random.uniform(size=[37, 5]).astype("float32"),
+        "z_2": np.random.uniform(size=[300001]).astype("float32"),
+    }
+
+    temp = utils.tempdir()
+    tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format=encode_format)
+    fload(str(temp.path), tvm.cpu().device_type, 0)
+    res = fget_params("z", -1)
+    for i, v in enumerate(res):
+        v_np = param_dict[f"z_{i}"]
+        if encode_format == "f32-to-bf16":
+            v_np = tvmjs._convert_bf16_to_f32(tvmjs._convert_f32_to_bf16(v_np))
+        else:
+            v_np = v_np.astype("float16").astype("float32")
+        np.testing.assert_equal(v.numpy(), v_np)
+    fclear()
+
+
+def test_ndarray_cache_reload():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
+    freload = tvm.get_global_func("vm.builtin.ndarray_cache.reload")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+    fclear = tvm.get_global_func("vm.builtin.ndarray_cache.clear")
+
+    param_dict = {
+        "w_0": np.arange(64, dtype="int32"),
+        "w_1": np.random.uniform(size=[10, 20]).astype("float32"),
+    }
+    old_dir = utils.tempdir()
+    tvmjs.dump_ndarray_cache(param_dict, old_dir.path, encode_format="raw")
+    fload(str(old_dir.path), tvm.cpu().device_type, 0)
+    old = fget_params("w", -1)
+
+    new_dict = dict(param_dict)
+    new_dict["w_1"] = np.random.uniform(size=[10, 20]).astype("float32")
+    new_dir = utils.tempdir()
+    tvmjs.dump_ndarray_cache(new_dict, new_dir.path, encode_format="raw")
+    assert freload(str(new_dir.path), tvm.cpu().device_type, 0) == 1
+    new = fget_params("w", -1)
+    # The unchanged parameter is shared, the users of the old one are not affected.
+    assert new[0].same_as(old[0])
+    assert not new[1].same_as(old[1])
+    np.testing.assert_equal(new[1].numpy(), new_dict["w_1"])
+    np.testing.assert_equal(old[1].numpy(), param_dict["w_1"])
+    fclear()
+
 def test_ndarray_cache_update():
     fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
     fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
@@ -213,6 +323,126 @@ def test_ndarray_cache_update():
         np.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_sample_top_p_from_logits_batched():
+    fsample = tvm.get_global_func("vm.builtin.sample_top_p_from_logits_batched")
+    fsample_single = tvm.get_global_func("vm.builtin.sample_top_p_from_logits")
+    batch_size, vocab_size = 3, 32000
+    logits_np = np.random.uniform(-5, 5, size=[batch_size, 1, vocab_size]).astype("float32")
+    temperature = np.array([0.0, 0.7, 1.0], dtype="float32")
+    top_p = np.array([1.0, 0.9, 0.5], dtype="float32")
+    uniform = np.random.uniform(size=[batch_size]).astype("float32")
+    res = fsample(
+        tvm.nd.array(logits_np),
+        tvm.nd.array(temperature),
+        tvm.nd.array(top_p),
+        tvm.nd.array(uniform),
+    ).numpy()
+    assert res.shape == (batch_size,)
+    assert res[0] == np.argmax(logits_np[0])
+    for i in range(batch_size):
+        token = fsample_single(
+            tvm.nd.array(logits_np[i : i + 1]),
+            float(temperature[i]),
+            float(top_p[i]),
+            float(uniform[i]),
+        )
+        assert res[i] == token
+    for i in [1, 2]:
+        prob = np.exp((logits_np[i, 0] - logits_np[i, 0].max()) / temperature[i])
+        prob /= prob.sum()
+        rank = np.argsort(-prob)
+        kept = rank[: np.searchsorted(np.cumsum(prob[rank]), top_p[i]) + 1]
+        assert res[i] in kept
+
+
+def test_sample_top_p_from_prob_batched():
+    fsample = tvm.get_global_func("vm.builtin.sample_top_p_from_prob_batched")
+    batch_size, vocab_size = 4, 1000
+    prob_np = np.random.uniform(size=[batch_size, vocab_size]).astype("float32")
+    # A peaked distribution takes the cutoff path, a flat one the fallback path.
+    prob_np[0, 7] = 1e4
+    prob_np /= prob_np.sum(axis=-1, keepdims=True)
+    top_p = np.array([0.5, 0.95, 1.0, 0.3], dtype="float32")
+    uniform = np.random.uniform(size=[batch_size]).astype("float32")
+    res = fsample(tvm.nd.array(prob_np), tvm.nd.array(top_p), tvm.nd.array(uniform)).numpy()
+    assert res[0] == 7
+    for i in range(1, batch_size):
+        rank = np.argsort(-prob_np[i])
+        kept = rank[: np.searchsorted(np.cumsum(prob_np[i][rank]), top_p[i]) + 1]
+        assert res[i] in kept
+
+
+@tvm.testing.requires_cuda
+def test_cuda_sample_from_logits_batched():
+    fsample = tvm.get_global_func("vm.builtin.cuda.sample_from_logits_batched")
+    dev = tvm.cuda()
+    batch_size, vocab_size = 4, 32000
+    logits_np = np.random.uniform(-5, 5, size=[batch_size, vocab_size]).astype("float32")
+    # Row 0 is greedy, row 1 keeps only the top token by top-k, rows 2-3 sample under top-p.
+    temperature = np.array([0.0, 1.0, 0.7, 1.0], dtype="float32")
+    top_p = np.array([1.0, 1.0, 0.9, 0.5], dtype="float32")
+    top_k = np.array([0, 1, 0, 40], dtype="int32")
+    uniform = np.random.uniform(size=[batch_size]).astype("float32")
+    res = fsample(
+        tvm.nd.array(logits_np, dev),
+        tvm.nd.array(temperature, dev),
+        tvm.nd.array(top_p, dev),
+        tvm.nd.array(top_k, dev),
+        tvm.nd.array(uniform, dev),
+    ).numpy()
+    assert res[0] == np.argmax(logits_np[0])
+    assert res[1] == np.argmax(logits_np[1])
+    for i in [2, 3]:
+        prob = np.exp((logits_np[i] - logits_np[i].max()) / temperature[i])
+        prob /= prob.sum()
+        rank = np.argsort(-prob)
+        kept = rank[: max(np.searchsorted(np.cumsum(prob[rank]), top_p[i]) + 1, 1)]
+        if top_k[i] > 0:
+            kept = kept[: top_k[i]]
+        assert res[i] in kept
+
+    fsample_single = tvm.get_global_func("vm.builtin.cuda.sample_top_p_from_logits")
+    token = fsample_single(tvm.nd.array(logits_np[:1], dev), 0.0, 1.0, 0.5)
+    assert token == np.argmax(logits_np[0])
+
+
+@tvm.testing.requires_cuda
+def test_cuda_sample_with_penalty_batched():
+    fsample = tvm.get_global_func("vm.builtin.cuda.sample_with_penalty_batched")
+    dev = tvm.cuda()
+    batch_size, vocab_size = 2, 1000
+    logits_np = np.random.uniform(-1, 1, size=[batch_size, vocab_size]).astype("float32")
+    # The argmax of each row is penalized below every other logit.
+    argmax = np.argmax(logits_np, axis=-1).astype("int32")
+    token_indptr = np.array([0, 1, 2], dtype="int32")
+    token_counts = np.array([1, 3], dtype="int32")
+    presence = np.array([10.0, 0.0], dtype="float32")
+    frequency = np.array([0.0, 10.0], dtype="float32")
+    repetition = np.array([1.0, 1.0], dtype="float32")
+    temperature = np.zeros([batch_size], dtype="float32")
+    top_p = np.ones([batch_size], dtype="float32")
+    uniform = np.random.uniform(size=[batch_size]).astype("float32")
+    logits = tvm.nd.array(logits_np, dev)
+    res = fsample(
+        logits,
+        tvm.nd.array(token_indptr, dev),
+        tvm.nd.array(argmax, dev),
+        tvm.nd.array(token_counts, dev),
+        tvm.nd.array(presence, dev),
+        tvm.nd.array(frequency, dev),
+        tvm.nd.array(repetition, dev),
+        tvm.nd.array(temperature, dev),
+        tvm.nd.array(top_p, dev),
+        None,
+        tvm.nd.array(uniform, dev),
+    ).numpy()
+    expected = logits_np.copy()
+    expected[0, argmax[0]] -= 10.0
+    expected[1, argmax[1]] -= 30.0
+    np.testing.assert_allclose(logits.numpy(), expected, rtol=1e-6)
+    np.testing.assert_equal(res, np.argmax(expected, axis=-1))
+
+
 def test_attention_kv_cache_window_override():
     fcreate = tvm.get_global_func("vm.builtin.attention_kv_cache_create")
     foverride = tvm.get_global_func("vm.builtin.attention_kv_cache_window_override")
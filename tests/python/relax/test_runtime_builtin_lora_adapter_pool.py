@@ -0,0 +1,233 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# pylint: disable=missing-docstring
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.runtime import ShapeTuple
+from tvm.script import tir as T
+
+num_pages = 16
+max_rank = 8
+max_num_tokens = 64
+reserved_nseq = 8
+targets = [("q_proj", 32, 32), ("up_proj", 32, 48)]
+dtype = "float32"
+device = tvm.cpu()
+
+
+def _sgmv_shrink(in_features):
+    @T.prim_func
+    def sgmv_shrink(
+        var_x: T.handle,
+        var_a_pages: T.handle,
+        var_seg_token_indptr: T.handle,
+        var_seg_page_indptr: T.handle,
+        var_page_ids: T.handle,
+        var_tmp: T.handle,
+    ):
+        ntoken = T.int32()
+        npage = T.int32()
+        nseg = T.int32()
+        total_rank = T.int32()
+        x = T.match_buffer(var_x, (ntoken, in_features), dtype)
+        a_pages = T.match_buffer(var_a_pages, (npage, in_features), dtype)
+        seg_token_indptr = T.match_buffer(var_seg_token_indptr, (nseg + 1,), "int32")
+        seg_page_indptr = T.match_buffer(var_seg_page_indptr, (nseg + 1,), "int32")
+        page_ids = T.match_buffer(var_page_ids, (total_rank,), "int32")
+        tmp = T.match_buffer(var_tmp, (ntoken, max_rank), dtype)
+        for s in T.serial(nseg):
+            for t in T.serial(seg_token_indptr[s], seg_token_indptr[s + 1]):
+                for j in T.serial(seg_page_indptr[s + 1] - seg_page_indptr[s]):
+                    tmp[t, j] = T.float32(0)
+                    for k in T.serial(in_features):
+                        tmp[t, j] = (
+                            tmp[t, j] + x[t, k] * a_pages[page_ids[seg_page_indptr[s] + j], k]
+                        )
+
+    return sgmv_shrink
+
+
+def _sgmv_expand(out_features):
+    @T.prim_func
+    def sgmv_expand(
+        var_tmp: T.handle,
+        var_b_pages: T.handle,
+        var_seg_token_indptr: T.handle,
+        var_seg_page_indptr: T.handle,
+        var_page_ids: T.handle,
+        var_seg_scaling: T.handle,
+        var_y: T.handle,
+    ):
+        ntoken = T.int32()
+        npage = T.int32()
+        nseg = T.int32()
+        total_rank = T.int32()
+        tmp = T.match_buffer(var_tmp, (ntoken, max_rank), dtype)
+        b_pages = T.match_buffer(var_b_pages, (npage, out_features), dtype)
+        seg_token_indptr = T.match_buffer(var_seg_token_indptr, (nseg + 1,), "int32")
+        seg_page_indptr = T.match_buffer(var_seg_page_indptr, (nseg + 1,), "int32")
+        page_ids = T.match_buffer(var_page_ids, (total_rank,), "int32")
+        seg_scaling = T.match_buffer(var_seg_scaling, (nseg,), "float32")
+        y = T.match_buffer(var_y, (ntoken, out_features), dtype)
+        for s in T.serial(nseg):
+            for t in T.serial(seg_token_indptr[s], seg_token_indptr[s + 1]):
+                for n in T.serial(out_features):
+                    for j in T.serial(seg_page_indptr[s + 1] - seg_page_indptr[s]):
+                        y[t, n] = y[t, n] + seg_scaling[s] * tmp[t, j] * b_pages[
+                            page_ids[seg_page_indptr[s] + j], n
+                        ]
+
+    return sgmv_expand
+
+
+class _PoolKernels:
+    """Dispatch the SGMV kernels to the build of each LoRA target by the feature sizes."""
+
+    def __init__(self):
+        self.shrink = {}
+        self.expand = {}
+        for _, in_features, out_features in targets:
+            if in_features not in self.shrink:
+                self.shrink[in_features] = tvm.build(_sgmv_shrink(in_features), target="llvm")
+            if out_features not in self.expand:
+                self.expand[out_features] = tvm.build(_sgmv_expand(out_features), target="llvm")
+
+    def f_shrink(self, x, a_pages, *args):
+        self.shrink[x.shape[1]](x, a_pages, *args)
+
+    def f_expand(self, tmp, b_pages, *args):
+        self.expand[b_pages.shape[1]](tmp, b_pages, *args)
+
+
+@pytest.fixture(name="pool")
+def create_pool():
+    kernels = _PoolKernels()
+    return tvm.get_global_func("vm.builtin.lora_adapter_pool_create")(
+        ShapeTuple([num_pages, max_rank, max_num_tokens, reserved_nseq]),
+        [name for name, _, _ in targets],
+        ShapeTuple([in_features for _, in_features, _ in targets]),
+        ShapeTuple([out_features for _, _, out_features in targets]),
+        tvm.nd.empty((), dtype, device),
+        kernels.f_shrink,
+        kernels.f_expand,
+    )
+
+
+def random_adapter(rank):
+    return [
+        (
+            np.random.uniform(-1, 1, (rank, in_features)).astype(dtype),
+            np.random.uniform(-1, 1, (out_features, rank)).astype(dtype),
+        )
+        for _, in_features, out_features in targets
+    ]
+
+
+def load(pool, adapter_id, adapter, scaling):
+    tvm.get_global_func("vm.builtin.lora_adapter_pool_load")(
+        pool,
+        adapter_id,
+        [tvm.nd.array(a, device) for a, _ in adapter],
+        [tvm.nd.array(b, device) for _, b in adapter],
+        scaling,
+    )
+
+
+def check_forward(pool, adapters, batch):
+    """Apply all LoRA targets to a batch of (adapter_id, append_length) and check the outputs."""
+    fbegin_forward = tvm.get_global_func("vm.builtin.lora_adapter_pool_begin_forward")
+    fapply = tvm.get_global_func("vm.builtin.lora_adapter_pool_apply")
+    fbegin_forward(
+        pool,
+        ShapeTuple([adapter_id for adapter_id, _ in batch]),
+        ShapeTuple([length for _, length in batch]),
+    )
+    num_tokens = sum(length for _, length in batch)
+    for target_id, (_, in_features, out_features) in enumerate(targets):
+        x_np = np.random.uniform(-1, 1, (num_tokens, in_features)).astype(dtype)
+        y_np = np.random.uniform(-1, 1, (num_tokens, out_features)).astype(dtype)
+        y = fapply(pool, target_id, tvm.nd.array(x_np, device), tvm.nd.array(y_np, device))
+        expected = y_np.copy()
+        begin = 0
+        for adapter_id, length in batch:
+            if adapter_id != -1:
+                a, b = adapters[adapter_id][0][target_id]
+                scaling = adapters[adapter_id][1]
+                x_seq = x_np[begin : begin + length]
+                expected[begin : begin + length] += scaling * (x_seq @ a.T) @ b.T
+            begin += length
+        tvm.testing.assert_allclose(y.numpy(), expected, rtol=1e-4, atol=1e-4)
+
+
+def test_lora_adapter_pool_mixed_batch(pool):
+    adapters = {
+        0: (random_adapter(4), 2.0),
+        1: (random_adapter(2), 0.5),
+        5: (random_adapter(8), 1.0),
+    }
+    for adapter_id, (adapter, scaling) in adapters.items():
+        load(pool, adapter_id, adapter, scaling)
+    fget_num_available_pages = tvm.get_global_func(
+        "vm.builtin.lora_adapter_pool_get_num_available_pages"
+    )
+    assert fget_num_available_pages(pool) == num_pages - 14
+
+    check_forward(pool, adapters, [(0, 3), (1, 5), (-1, 2), (5, 7)])
+    # Consecutive sequences of one adapter, and sequences of the base model only.
+    check_forward(pool, adapters, [(5, 1), (5, 1), (-1, 1), (0, 1), (1, 1), (0, 1), (-1, 1)])
+    check_forward(pool, adapters, [(-1, 4), (-1, 1)])
+
+
+def test_lora_adapter_pool_eviction(pool):
+    fis_loaded = tvm.get_global_func("vm.builtin.lora_adapter_pool_is_loaded")
+    funload = tvm.get_global_func("vm.builtin.lora_adapter_pool_unload")
+    # Three adapters of rank 5 leave one page of the pool free.
+    adapters = {i: (random_adapter(5), 1.0) for i in range(3)}
+    for adapter_id, (adapter, scaling) in adapters.items():
+        load(pool, adapter_id, adapter, scaling)
+    # Use adapter 0, so that adapter 1 is the least recently used one.
+    check_forward(pool, adapters, [(0, 2), (2, 2)])
+    adapters[3] = (random_adapter(5), 1.5)
+    load(pool, 3, *adapters[3])
+    assert [fis_loaded(pool, i) for i in range(4)] == [True, False, True, True]
+    del adapters[1]
+    check_forward(pool, adapters, [(3, 2), (0, 3), (2, 1)])
+
+    funload(pool, 0)
+    assert not fis_loaded(pool, 0)
+    with pytest.raises(tvm.TVMError):
+        check_forward(pool, adapters, [(0, 2)])
+
+
+def test_lora_adapter_pool_load_from_cache(pool):
+    fcache_update = tvm.get_global_func("vm.builtin.ndarray_cache.update")
+    fcache_clear = tvm.get_global_func("vm.builtin.ndarray_cache.clear")
+    adapter = random_adapter(3)
+    for (name, _, _), (a, b) in zip(targets, adapter):
+        fcache_update(f"lora.{name}.lora_A.weight", tvm.nd.array(a, device), True)
+        fcache_update(f"lora.{name}.lora_B.weight", tvm.nd.array(b, device), True)
+    tvm.get_global_func("vm.builtin.lora_adapter_pool_load_from_cache")(pool, 7, "lora.", 0.25)
+    fcache_clear()
+    check_forward(pool, {7: (adapter, 0.25)}, [(-1, 2), (7, 4)])
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -57,6 +57,17 @@ fcommit_accepted_token_tree_nodes = None
 fattention_with_fuse_qkv = None
 fis_empty = None
 fdebug_get_kv = None
+fprefix_cache_insert = None
+fprefix_cache_match_and_add_sequence = None
+fprefix_cache_evict = None
+fswap_out_sequence = None
+fswap_in_sequence = None
+fexport_sequence = None
+fimport_sequence = None
+fget_num_available_pages = None
+fbegin_multi_step_decode = None
+fget_page_stats = None
+fget_sequence_num_pages = None
 
 ftranspose_append = None
 fcopy_cache = None
@@ -77,6 +88,10 @@ def set_global_func(head_dim, dtype):
     global fclear, fadd_sequence, fremove_sequence, ffork_sequence, fenable_sliding_window_for_seq
     global fpopn, fbegin_forward, fend_forward, fcommit_accepted_token_tree_nodes
     global fattention_with_fuse_qkv, fis_empty, fdebug_get_kv
+    global fprefix_cache_insert, fprefix_cache_match_and_add_sequence, fprefix_cache_evict
+    global fswap_out_sequence, fswap_in_sequence, fget_num_available_pages
+    global fexport_sequence, fimport_sequence
+    global fbegin_multi_step_decode, fget_page_stats, fget_sequence_num_pages
     global ftranspose_append, fcopy_cache, fattn_prefill, fattn_decode
     global fattn_prefill_ragged, fattn_prefill_with_tree_mask
     global fattn_prefill_sliding_window, fattn_decode_sliding_window
@@ -100,6 +115,25 @@ def set_global_func(head_dim, dtype):
     )
     fis_empty = tvm.get_global_func("vm.builtin.attention_kv_cache_empty")
     fdebug_get_kv = tvm.get_global_func("vm.builtin.attention_kv_cache_debug_get_kv")
+    fprefix_cache_insert = tvm.get_global_func("vm.builtin.attention_kv_cache_prefix_cache_insert")
+    fprefix_cache_match_and_add_sequence = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_prefix_cache_match_and_add_sequence"
+    )
+    fprefix_cache_evict = tvm.get_global_func("vm.builtin.attention_kv_cache_prefix_cache_evict")
+    fswap_out_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_swap_out_sequence")
+    fswap_in_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_swap_in_sequence")
+    fexport_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_export_sequence")
+    fimport_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_import_sequence")
+    fget_num_available_pages = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_num_available_pages"
+    )
+    fbegin_multi_step_decode = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_begin_multi_step_decode"
+    )
+    fget_page_stats = tvm.get_global_func("vm.builtin.attention_kv_cache_get_page_stats")
+    fget_sequence_num_pages = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_sequence_num_pages"
+    )
 
     target = tvm.target.Target("cuda")
     builts = []
@@ -257,6 +291,7 @@ def apply_attention(
     attn_sink_sizes: Optional[List[int]] = None,
     token_tree_parent_ptr_list: Optional[List[List[int]]] = None,
     accepted_leaf_indices: Optional[List[int]] = None,
+    skip_begin_forward: bool = False,
 ) -> None:
     seq_ids = []
     append_lengths = []
@@ -302,16 +337,17 @@ def apply_attention(
                 )
             token_tree_node_depths_list[i] = token_tree_node_depths
 
-    fbegin_forward(
-        kv_cache,
-        ShapeTuple(seq_ids),
-        ShapeTuple(append_lengths),
-        (
-            ShapeTuple(flattened_token_tree_parent_ptr)
-            if flattened_token_tree_parent_ptr is not None
-            else None
-        ),
-    )
+    if not skip_begin_forward:
+        fbegin_forward(
+            kv_cache,
+            ShapeTuple(seq_ids),
+            ShapeTuple(append_lengths),
+            (
+                ShapeTuple(flattened_token_tree_parent_ptr)
+                if flattened_token_tree_parent_ptr is not None
+                else None
+            ),
+        )
 
     global_new_q = np.zeros((num_layers, 0, num_qo_heads, head_dim), dtype)
     global_new_k = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
@@ -521,6 +557,29 @@ def test_paged_attention_kv_cache_prefill_and_decode(kv_cache_and_config):
         apply_attention(kv_cache, rope_mode, batch, cached_k, cached_v)
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_mixed_prefill_decode(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    # Prefill.
+    operation_seq = [[(0, 6)], [(1, 8)], [(2, 17)], [(3, 1)]]
+    # Decodes interleaved with prefill chunks of new and existing sequences.
+    # The batches whose decodes come first are split between the decode and prefill kernels.
+    operation_seq += [[(0, 1), (1, 1), (4, 21)], [(0, 1), (2, 1), (3, 1), (4, 13), (5, 9)]]
+    operation_seq += [[(4, 1), (5, 1), (0, 30), (1, 2)], [(2, 1), (6, 18), (3, 1), (5, 7)]]
+    operation_seq += [[(0, 1), (1, 1), (2, 1), (3, 1), (4, 1), (5, 1), (6, 1)]]
+
+    cached_k = {}
+    cached_v = {}
+    for batch in operation_seq:
+        apply_attention(kv_cache, rope_mode, batch, cached_k, cached_v)
+
+
 @tvm.testing.requires_gpu
 @tvm.testing.requires_cuda
 def test_paged_attention_kv_cache_remove_sequence(kv_cache_and_config):
@@ -667,6 +726,181 @@ def test_paged_attention_kv_cache_unlimited_depth(kv_cache_and_config):
     assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_prefix_cache(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    tokens = list(range(100, 140))
+    apply_attention(kv_cache, rope_mode, [(0, len(tokens))], cached_k, cached_v)
+    # Only the whole pages are retained.
+    assert fprefix_cache_insert(kv_cache, 0, ShapeTuple(tokens)) == 2 * page_size
+    fremove_sequence(kv_cache, 0)
+    prefix_k = cached_k.pop(0)[:, : 2 * page_size]
+    prefix_v = cached_v.pop(0)[:, : 2 * page_size]
+
+    # The prompt sharing 35 leading tokens reuses the two retained pages.
+    matched = fprefix_cache_match_and_add_sequence(kv_cache, 1, ShapeTuple(tokens[:35] + [1, 2]))
+    assert matched == 2 * page_size
+    cached_k[1] = prefix_k
+    cached_v[1] = prefix_v
+    apply_attention(kv_cache, rope_mode, [(1, 5)], cached_k, cached_v)
+    # The prompt not sharing any page reuses nothing.
+    assert fprefix_cache_match_and_add_sequence(kv_cache, 2, ShapeTuple(tokens[:10])) == 0
+    cached_k[2] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    cached_v[2] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    apply_attention(kv_cache, rope_mode, [(1, 1), (2, 10)], cached_k, cached_v)
+
+    for seq_id in [1, 2]:
+        fremove_sequence(kv_cache, seq_id)
+    assert not fis_empty(kv_cache), "The retained prefix should stay after removing sequences"
+    assert fprefix_cache_evict(kv_cache, -1) == 2
+    assert fis_empty(kv_cache), "The KV cache is not empty after evicting all prefixes"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_swap(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 40), (1, 20)], cached_k, cached_v)
+    # Sequence 2 shares the first 32 tokens of sequence 0.
+    apply_attention(kv_cache, rope_mode, [((2, 0, 32), 7)], cached_k, cached_v)
+
+    num_free_pages = fget_num_available_pages(kv_cache)
+    # Only the pages not shared with sequence 2 are swapped.
+    assert fswap_out_sequence(kv_cache, 0) == 1
+    assert fswap_out_sequence(kv_cache, 1) == 2
+    assert fget_num_available_pages(kv_cache) == num_free_pages + 3
+    # The freed pages can be reused by the other sequences.
+    apply_attention(kv_cache, rope_mode, [(2, 30), (3, 33)], cached_k, cached_v)
+
+    fswap_in_sequence(kv_cache, 0)
+    fswap_in_sequence(kv_cache, 1)
+    verify_cached_kv(kv_cache, [0, 1, 2, 3], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1)], cached_k, cached_v)
+
+    # Removing a swapped-out sequence releases its host pages.
+    fswap_out_sequence(kv_cache, 3)
+    for seq_id in range(4):
+        fremove_sequence(kv_cache, seq_id)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_transfer(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 40)], cached_k, cached_v)
+    # Sequence 1 spans a block shared with sequence 0 and a block of its own.
+    apply_attention(kv_cache, rope_mode, [((1, 0, 32), 7)], cached_k, cached_v)
+
+    num_free_pages = fget_num_available_pages(kv_cache)
+    data = fexport_sequence(kv_cache, 1)
+    assert data[0].shape[1] == 3
+    fimport_sequence(kv_cache, 2, 39, data)
+    assert fget_num_available_pages(kv_cache) == num_free_pages - 3
+    cached_k[2] = cached_k[1].copy()
+    cached_v[2] = cached_v[1].copy()
+    verify_cached_kv(kv_cache, [0, 1, 2], cached_k, cached_v)
+    # The imported sequence decodes as the exported one does.
+    fremove_sequence(kv_cache, 1)
+    cached_k.pop(1)
+    cached_v.pop(1)
+    apply_attention(kv_cache, rope_mode, [(0, 1), (2, 10)], cached_k, cached_v)
+
+    for seq_id in [0, 2]:
+        fremove_sequence(kv_cache, seq_id)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_page_stats(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 40), (1, 20)], cached_k, cached_v)
+    # Sequence 2 shares the first 32 tokens (2 pages) of sequence 0.
+    apply_attention(kv_cache, rope_mode, [((2, 0, 32), 7)], cached_k, cached_v)
+
+    num_total_pages, num_free_pages, num_shared_pages, num_prefix_cache_pages = list(
+        fget_page_stats(kv_cache)
+    )[:4]
+    assert num_free_pages == fget_num_available_pages(kv_cache)
+    assert num_total_pages - num_free_pages == 6
+    assert num_shared_pages == 2
+    assert num_prefix_cache_pages == 0
+    assert list(fget_page_stats(kv_cache))[6] == 3
+    assert list(fget_sequence_num_pages(kv_cache, ShapeTuple([0, 1, 2]))) == [3, 2, 3]
+
+    fswap_out_sequence(kv_cache, 1)
+    assert list(fget_page_stats(kv_cache))[4] == 2
+    assert list(fget_sequence_num_pages(kv_cache, ShapeTuple([1]))) == [0]
+    fswap_in_sequence(kv_cache, 1)
+    assert list(fget_page_stats(kv_cache))[4] == 0
+
+    for seq_id in range(3):
+        fremove_sequence(kv_cache, seq_id)
+    stats = list(fget_page_stats(kv_cache))
+    assert stats[1] == stats[0]
+    assert stats[6] == 0 and stats[7] == 0
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_multi_step_decode(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 30), (1, 15)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [((2, 0, -1), 3)], cached_k, cached_v)
+
+    seq_ids = [0, 1, 2]
+    for num_steps in [5, 1, 16]:
+        # The steps cross page boundaries of all the sequences.
+        fbegin_multi_step_decode(kv_cache, ShapeTuple(seq_ids), num_steps)
+        for _ in range(num_steps):
+            apply_attention(
+                kv_cache,
+                rope_mode,
+                [(seq_id, 1) for seq_id in seq_ids],
+                cached_k,
+                cached_v,
+                skip_begin_forward=True,
+            )
+    verify_cached_kv(kv_cache, seq_ids, cached_k, cached_v)
+
+
 @tvm.testing.requires_gpu
 @tvm.testing.requires_cuda
 def test_paged_attention_kv_cache_popn(kv_cache_and_config):
@@ -850,6 +1084,23 @@ def test_paged_attention_kv_cache_tree_attn(kv_cache_and_config):
     # Do 5 rounds of decode.
     for _ in range(5):
         apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1), (3, 1)], cached_k, cached_v)
+    # Tree attention where some sequences accept no node.
+    apply_attention(
+        kv_cache,
+        rope_mode,
+        [(0, 7), (1, 15), (2, 10), (3, 14)],
+        cached_k,
+        cached_v,
+        token_tree_parent_ptr_list=[
+            [-1, 0, 0, 1, 1, 2, 2],  # complete binary tree of height 3
+            [-1, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6],  # complete binary tree of height 4
+            [-1, 0, 1, 2, 3, 4, 5, 6, 7, 8],  # chain of length 10
+            [-1, 0, 0, 1, 1, 2, 2, -1, 7, 7, 8, 8, 9, 9],  # two complete binary trees of height 3
+        ],
+        accepted_leaf_indices=[-1, 11, 0, -1],
+    )
+    for _ in range(2):
+        apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1), (3, 1)], cached_k, cached_v)
 
     # Test the cases where all trees are chains.
     fclear(kv_cache)
@@ -2630,6 +2881,7 @@ if __name__ == "__main__":
         cache = create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window)
         cache_and_config = (cache, rope_mode, support_sliding_window)
         test_paged_attention_kv_cache_prefill_and_decode(cache_and_config)
+        test_paged_attention_kv_cache_mixed_prefill_decode(cache_and_config)
         test_paged_attention_kv_cache_remove_sequence(cache_and_config)
         test_paged_attention_kv_cache_fork_sequence(cache_and_config)
         test_paged_attention_kv_cache_popn(cache_and_config)
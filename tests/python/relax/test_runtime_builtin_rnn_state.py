@@ -51,6 +51,7 @@ f_end_forward = None
 f_get = None
 f_set = None
 f_debug_get = None
+f_rollback_to_checkpoint = None
 
 f_tir_gets = []
 f_tir_sets = []
@@ -60,7 +61,7 @@ f_tir_sets = []
 
 def set_global_func():
     global f_clear, f_add_sequence, f_remove_sequence, f_fork_sequence, f_popn
-    global f_begin_forward, f_end_forward, f_get, f_set, f_debug_get
+    global f_begin_forward, f_end_forward, f_get, f_set, f_debug_get, f_rollback_to_checkpoint
     global f_tir_gets, f_tir_sets
 
     f_clear = tvm.get_global_func("vm.builtin.kv_state_clear")
@@ -73,6 +74,7 @@ def set_global_func():
     f_get = tvm.get_global_func("vm.builtin.rnn_state_get")
     f_set = tvm.get_global_func("vm.builtin.rnn_state_set")
     f_debug_get = tvm.get_global_func("vm.builtin.rnn_state_debug_get")
+    f_rollback_to_checkpoint = tvm.get_global_func("vm.builtin.rnn_state_rollback_to_checkpoint")
 
     target = tvm.target.Target("cuda")
 
@@ -93,10 +95,18 @@ def set_global_func():
     f_tir_sets = _f_tir_sets
 
 
-def create_rnn_state():
+def create_rnn_state(checkpoint_interval=1):
     f_create = tvm.get_global_func("vm.builtin.rnn_state_create")
     init_values = [tvm.nd.array(np_zero, device=device), tvm.nd.array(np_one, device=device)]
-    return f_create(num_layers, reserved_nseq, max_history, f_tir_gets, f_tir_sets, init_values)
+    return f_create(
+        num_layers,
+        reserved_nseq,
+        max_history,
+        f_tir_gets,
+        f_tir_sets,
+        init_values,
+        checkpoint_interval,
+    )
 
 
 @pytest.fixture
@@ -179,6 +189,64 @@ def test_rnn_state_fork_sequence(rnn_state):  # pylint: disable=redefined-outer-
     verify_state(state, [0, 1], [[np_two, np_three], [np_zero, np_one]])
 
 
+
+def forward_and_set(state, seq_ids, append_lengths, values):
+    f_begin_forward(state, ShapeTuple(seq_ids), ShapeTuple(append_lengths))
+    for state_id, (shape, dtype) in enumerate(states):
+        data = np.stack([np.full(shape, value[state_id], dtype) for value in values])
+        f_set(state, 0, state_id, tvm.nd.array(data, device=device))
+    f_end_forward(state)
+
+
+def full_state(value):
+    return [np.full(shape, value[i], dtype) for i, (shape, dtype) in enumerate(states)]
+
+
+@tvm.testing.requires_cuda
+def test_rnn_state_fork_copy_on_write(rnn_state):  # pylint: disable=redefined-outer-name
+    state = rnn_state
+    f_clear(state)
+
+    f_add_sequence(state, 0)
+    forward_and_set(state, [0], [1], [(2, 3)])
+    # The forked sequences share the state until they write their next states.
+    for child_seq_id in range(1, 4):
+        f_fork_sequence(state, 0, child_seq_id, -1)
+    forward_and_set(state, [0, 1, 2, 3], [1] * 4, [(4, 5), (6, 7), (8, 9), (10, 11)])
+    expected_values = [full_state(value) for value in [(4, 5), (6, 7), (8, 9), (10, 11)]]
+    verify_state(state, [0, 1, 2, 3], expected_values)
+    for seq_id in range(4):
+        f_popn(state, seq_id, 1)
+    verify_state(state, [0, 1, 2, 3], [full_state((2, 3))] * 4)
+
+    # Forking at the beginning starts from the init value.
+    f_fork_sequence(state, 0, 4, 0)
+    verify_state(state, [4], {4: [np_zero, np_one]})
+
+
+@tvm.testing.requires_cuda
+def test_rnn_state_rollback():
+    set_global_func()
+    state = create_rnn_state(checkpoint_interval=2)
+
+    f_add_sequence(state, 0)
+    # A chunk of tokens can be rolled back as a whole.
+    forward_and_set(state, [0], [3], [(2, 3)])
+    verify_state(state, [0], [full_state((2, 3))])
+    f_popn(state, 0, 3)
+    verify_state(state, [0], [[np_zero, np_one]])
+
+    for value in [(2, 3), (4, 5), (6, 7)]:
+        forward_and_set(state, [0], [1], [value])
+    # Only the states at the lengths of multiples of 2 are kept besides the current one.
+    with pytest.raises(tvm.error.TVMError):
+        f_popn(state, 0, 2)
+    assert f_rollback_to_checkpoint(state, 0, 1) == 0
+    verify_state(state, [0], [full_state((4, 5))])
+    assert f_rollback_to_checkpoint(state, 0, 1) == 1
+    verify_state(state, [0], [[np_zero, np_one]])
+
+
 def rnn_state_get(
     shape: Sequence[int],
     dtype: str,
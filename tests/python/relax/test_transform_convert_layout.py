@@ -1501,5 +1501,53 @@ def test_binary_ewise_scalar():
     verify(Input, Expected)
 
 
+def test_minimize_transposes_lone_conv2d():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3, 28, 28), "float32"), w: R.Tensor((4, 3, 3, 3), "float32")
+        ) -> R.Tensor((2, 4, 26, 26), "float32"):
+            with R.dataflow():
+                lv = R.nn.conv2d(x, w, out_dtype="float32")
+                gv = R.nn.relu(lv)
+                R.output(gv)
+            return gv
+
+    # Converting the conv2d alone transposes more than it saves
+    desired_layouts = {"relax.nn.conv2d": ["NHWC", "OHWI"]}
+    mod = ConvertLayout(desired_layouts, minimize_transposes=True)(Input)
+    mod = Normalize()(mod)
+    tvm.ir.assert_structural_equal(mod, Input)
+
+
+def test_minimize_transposes_conv2d_chain():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3, 28, 28), "float32"),
+            w1: R.Tensor((4, 3, 3, 3), "float32"),
+            w2: R.Tensor((4, 4, 3, 3), "float32"),
+            w3: R.Tensor((4, 4, 3, 3), "float32"),
+        ) -> R.Tensor((2, 4, 22, 22), "float32"):
+            with R.dataflow():
+                lv0 = R.nn.conv2d(x, w1, out_dtype="float32")
+                lv1 = R.nn.relu(lv0)
+                lv2 = R.nn.conv2d(lv1, w2, out_dtype="float32")
+                lv3 = R.nn.relu(lv2)
+                gv = R.nn.conv2d(lv3, w3, out_dtype="float32")
+                R.output(gv)
+            return gv
+
+    # The transposes at the ends of the chain are shared by all the conv2d
+    desired_layouts = {"relax.nn.conv2d": ["NHWC", "OHWI"]}
+    mod = ConvertLayout(desired_layouts, minimize_transposes=True)(Input)
+    expected = ConvertLayout(desired_layouts)(Input)
+    tvm.ir.assert_structural_equal(Normalize()(mod), Normalize()(expected))
+    ops = [b.value.op.name for b in mod["main"].body.blocks[0].bindings]
+    assert ops.count("relax.permute_dims") == 5
+
+
 if __name__ == "__main__":
     tvm.testing.main()
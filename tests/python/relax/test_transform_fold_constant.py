@@ -324,6 +324,47 @@ def test_fold_multiple_relax_ops():
     tvm.ir.assert_structural_equal(after, expected)
 
 
+def test_fold_multiple_relax_ops_in_one_build():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def before(c0: R.Tensor((16, 16), "float32"), c1: R.Tensor((16, 16), "float32")):
+            with R.dataflow():
+                lv0 = R.add(c0, c1)
+                lv1 = R.multiply(c0, c1)
+                lv2 = R.subtract(lv0, lv1)
+                gv = R.concat((lv0, lv1, lv2), axis=0)
+                R.output(gv)
+            return gv
+
+        @R.function
+        def expected(c2: R.Tensor((48, 16), "float32")):
+            return c2
+
+    @tvm.instrument.pass_instrument
+    class CountBuilds:
+        def __init__(self):
+            self.num_builds = 0
+
+        def run_before_pass(self, mod, info):
+            # Run once by each build, on the whole module
+            if info.name == "tir.BindTarget":
+                self.num_builds += 1
+
+    c0_np = np.arange((16 * 16)).astype("float32").reshape(16, 16)
+    c1_np = np.arange((16 * 16)).astype("float32").reshape(16, 16) / 2
+    c2_np = np.concatenate([c0_np + c1_np, c0_np * c1_np, (c0_np + c1_np) - c0_np * c1_np])
+    before = gen_mod(Module, "before", {"c0": c0_np, "c1": c1_np})
+    expected = gen_mod(Module, "expected", {"c2": c2_np})
+
+    count_builds = CountBuilds()
+    with tvm.transform.PassContext(instruments=[count_builds]):
+        after = relax.transform.FoldConstant()(before)
+    tvm.ir.assert_structural_equal(after, expected)
+    # All the calls are folded by a single build
+    assert count_builds.num_builds == 1
+
+
 def test_do_not_fold_ops_outside_dataflow():
     # put before after in a single module
     @tvm.script.ir_module
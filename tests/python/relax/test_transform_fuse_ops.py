@@ -69,6 +69,53 @@ def test_fuse_simple():
     _check(before(), expected())
 
 
+def test_fuse_with_cost_estimator():
+    """The fusion is refused when it increases the estimated cost."""
+
+    @tvm.register_func("test.fuse_ops.cost_estimator", override=True)
+    def estimate(bindings):
+        # Groups of more than two ops are too large to schedule well
+        return 1.0 if len(bindings) <= 2 else 10.0 * len(bindings)
+
+    def before():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", R.Tensor([10, 20], "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.add, x, relax.const(1, "float32"))
+                lv1 = bb.emit_te(topi.exp, lv0)
+                gv = bb.emit_output(bb.call_te(topi.squeeze, lv1))
+            bb.emit_func_output(gv)
+
+        return bb.get()
+
+    def expected():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", R.Tensor([10, 20], "float32"))
+        p0 = relax.Var("p0", R.Tensor((), "float32"))
+
+        with bb.function("fused_add_exp", [x, p0], attrs={"Primitive": 1}, private=True):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.add, x, p0)
+                gv = bb.emit_output(bb.call_te(topi.exp, lv0))
+            bb.emit_func_output(gv)
+        fused_add_exp = bb.get().get_global_var("fused_add_exp")
+
+        x = relax.Var("x", R.Tensor([10, 20], "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv = bb.emit(relax.Call(fused_add_exp, [x, relax.const(1, "float32")]))
+                gv = bb.emit_output(bb.call_te(topi.squeeze, lv))
+            bb.emit_func_output(gv)
+
+        return bb.get()
+
+    with tvm.transform.PassContext(
+        config={"relax.FuseOps.cost_estimator": "test.fuse_ops.cost_estimator"}
+    ):
+        _check(before(), expected())
+
+
 def test_conv2d_fuse():
     """Test fusion case of conv2d"""
 
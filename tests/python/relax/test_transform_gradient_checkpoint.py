@@ -751,5 +751,66 @@ def test_checkpoint_with_intermediate_require_grads():
     assert_structural_equal(After, Expected)
 
 
+def test_checkpoint_activations():
+    # fmt: off
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((3, 3), "float32")):
+            with R.dataflow():
+                lv1 = R.power(x, R.const(3, "float32"))
+                lv2 = R.power(lv1, R.const(3, "float32"))
+                lv3 = R.power(lv2, R.const(3, "float32"))
+                lv4 = R.power(lv3, R.const(3, "float32"))
+                gv = R.sum(lv4)
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((3, 3), "float32")) -> R.Tensor((), "float32"):
+            with R.dataflow():
+                x_scp: R.Tensor((3, 3), "float32") = R.grad.start_checkpoint(x)
+                lv1: R.Tensor((3, 3), "float32") = R.power(x_scp, R.const(3, "float32"))
+                lv1_ecp: R.Tensor((3, 3), "float32") = R.grad.end_checkpoint(lv1)
+                lv2: R.Tensor((3, 3), "float32") = R.power(lv1_ecp, R.const(3, "float32"))
+                # Recomputing lv2 would also recompute lv1, so lv3 is cheaper
+                lv2_scp: R.Tensor((3, 3), "float32") = R.grad.start_checkpoint(lv2)
+                lv3: R.Tensor((3, 3), "float32") = R.power(lv2_scp, R.const(3, "float32"))
+                lv3_ecp: R.Tensor((3, 3), "float32") = R.grad.end_checkpoint(lv3)
+                lv4: R.Tensor((3, 3), "float32") = R.power(lv3_ecp, R.const(3, "float32"))
+                gv: R.Tensor((), "float32") = R.sum(lv4, axis=None, keepdims=False)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    # Each activation takes 36 bytes, two of the four fit in the budget
+    After = relax.transform.CheckpointActivations("main", 72)(Before)
+    assert_structural_equal(After, Expected)
+
+    Adjoint = relax.transform.Gradient("main")(After)
+    assert_structural_equal(Adjoint["main"], Expected["main"])
+    assert "main_adjoint" in [gv.name_hint for gv in Adjoint.get_global_vars()]
+
+
+def test_checkpoint_activations_within_budget():
+    # fmt: off
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((3, 3), "float32")):
+            with R.dataflow():
+                lv1 = R.power(x, R.const(3, "float32"))
+                lv2 = R.power(lv1, R.const(3, "float32"))
+                gv = R.sum(lv2)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    After = relax.transform.CheckpointActivations("main", 72)(Before)
+    assert_structural_equal(After, Before)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
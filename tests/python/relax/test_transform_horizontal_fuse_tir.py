@@ -0,0 +1,166 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R, tir as T
+
+
+def test_independent_kernels():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def add_one(
+            A: T.Buffer((T.int64(256),), "float32"), B: T.Buffer((T.int64(256),), "float32")
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(T.int64(2), thread="blockIdx.x"):
+                for tx in T.thread_binding(T.int64(128), thread="threadIdx.x"):
+                    with T.block("B"):
+                        vi = T.axis.spatial(T.int64(256), bx * T.int64(128) + tx)
+                        B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def exp(
+            X: T.Buffer((T.int64(512),), "float32"), Y: T.Buffer((T.int64(512),), "float32")
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(T.int64(4), thread="blockIdx.x"):
+                for tx in T.thread_binding(T.int64(128), thread="threadIdx.x"):
+                    with T.block("Y"):
+                        vi = T.axis.spatial(T.int64(512), bx * T.int64(128) + tx)
+                        Y[vi] = T.exp(X[vi])
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32"), y: R.Tensor((512,), "float32")):
+            cls = Before
+            with R.dataflow():
+                a = R.call_tir(cls.add_one, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                b = R.call_tir(cls.exp, (y,), out_sinfo=R.Tensor((512,), "float32"))
+                c = R.add(a, R.const(1, "float32"))
+                R.output(b, c)
+            return (b, c)
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def add_one(
+            A: T.Buffer((T.int64(256),), "float32"), B: T.Buffer((T.int64(256),), "float32")
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(T.int64(2), thread="blockIdx.x"):
+                for tx in T.thread_binding(T.int64(128), thread="threadIdx.x"):
+                    with T.block("B"):
+                        vi = T.axis.spatial(T.int64(256), bx * T.int64(128) + tx)
+                        B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def exp(
+            X: T.Buffer((T.int64(512),), "float32"), Y: T.Buffer((T.int64(512),), "float32")
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(T.int64(4), thread="blockIdx.x"):
+                for tx in T.thread_binding(T.int64(128), thread="threadIdx.x"):
+                    with T.block("Y"):
+                        vi = T.axis.spatial(T.int64(512), bx * T.int64(128) + tx)
+                        Y[vi] = T.exp(X[vi])
+
+        @T.prim_func(private=True)
+        def horizontal_fused_add_one_exp(
+            A: T.Buffer((T.int64(256),), "float32"),
+            X: T.Buffer((T.int64(512),), "float32"),
+            B: T.Buffer((T.int64(256),), "float32"),
+            Y: T.Buffer((T.int64(512),), "float32"),
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for blockIdx_x in T.thread_binding(T.int64(6), thread="blockIdx.x"):
+                if blockIdx_x < T.int64(2):
+                    for tx in T.thread_binding(T.int64(128), thread="threadIdx.x"):
+                        with T.block("B"):
+                            vi = T.axis.spatial(T.int64(256), blockIdx_x * T.int64(128) + tx)
+                            B[vi] = A[vi] + T.float32(1)
+                else:
+                    for tx in T.thread_binding(T.int64(128), thread="threadIdx.x"):
+                        with T.block("Y"):
+                            vi = T.axis.spatial(
+                                T.int64(512), (blockIdx_x - T.int64(2)) * T.int64(128) + tx
+                            )
+                            Y[vi] = T.exp(X[vi])
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32"), y: R.Tensor((512,), "float32")):
+            cls = Expected
+            with R.dataflow():
+                lv = R.call_tir(
+                    cls.horizontal_fused_add_one_exp,
+                    (x, y),
+                    out_sinfo=[R.Tensor((256,), "float32"), R.Tensor((512,), "float32")],
+                )
+                a = lv[0]
+                b = lv[1]
+                c = R.add(a, R.const(1, "float32"))
+                R.output(b, c)
+            return (b, c)
+
+    After = relax.transform.HorizontalFuseTIR()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_dependent_or_incompatible_kernels():
+    @I.ir_module
+    class Module:
+        @T.prim_func(private=True)
+        def exp(
+            X: T.Buffer((T.int64(512),), "float32"), Y: T.Buffer((T.int64(512),), "float32")
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(T.int64(4), thread="blockIdx.x"):
+                for tx in T.thread_binding(T.int64(128), thread="threadIdx.x"):
+                    with T.block("Y"):
+                        vi = T.axis.spatial(T.int64(512), bx * T.int64(128) + tx)
+                        Y[vi] = T.exp(X[vi])
+
+        @T.prim_func(private=True)
+        def exp_wide(
+            X: T.Buffer((T.int64(512),), "float32"), Y: T.Buffer((T.int64(512),), "float32")
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(T.int64(2), thread="blockIdx.x"):
+                for tx in T.thread_binding(T.int64(256), thread="threadIdx.x"):
+                    with T.block("Y"):
+                        vi = T.axis.spatial(T.int64(512), bx * T.int64(256) + tx)
+                        Y[vi] = T.exp(X[vi])
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32"), y: R.Tensor((512,), "float32")):
+            cls = Module
+            with R.dataflow():
+                # `b` uses `a`, and `c` launches a different number of threads
+                a = R.call_tir(cls.exp, (y,), out_sinfo=R.Tensor((512,), "float32"))
+                b = R.call_tir(cls.exp, (a,), out_sinfo=R.Tensor((512,), "float32"))
+                c = R.call_tir(cls.exp_wide, (y,), out_sinfo=R.Tensor((512,), "float32"))
+                R.output(b, c)
+            return (b, c)
+
+    After = relax.transform.HorizontalFuseTIR()(Module)
+    tvm.ir.assert_structural_equal(After, Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
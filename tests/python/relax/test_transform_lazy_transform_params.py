@@ -1186,5 +1186,111 @@ def test_set_output_callback_with_non_tuple_output():
     tvm.ir.assert_structural_equal(After, Expected)
 
 
+def test_prefetch_lazy_input():
+    """Groups of parameters are prefetched while the group before is in use
+
+    Each group is waited for right before its first fetch, where the
+    next group is prefetched into the other slot.
+    """
+
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor([16, 16], "float32"),
+            fget_param: R.Callable([R.Prim("int64"), R.Object], R.Object),
+        ):
+            R.func_attr({"num_input": 2})
+            w0 = fget_param(R.prim_value(0), R.str("w0"))
+            w0 = R.match_cast(w0, R.Tensor([16, 16], "float32"))
+            y0 = R.matmul(x, w0)
+            w1 = fget_param(R.prim_value(1), R.str("w1"))
+            w1 = R.match_cast(w1, R.Tensor([16, 16], "float32"))
+            y1 = R.matmul(y0, w1)
+            w2 = fget_param(R.prim_value(2), R.str("w2"))
+            w2 = R.match_cast(w2, R.Tensor([16, 16], "float32"))
+            y2 = R.matmul(y1, w2)
+            return y2
+
+    @I.ir_module
+    class Expected:
+        @R.function(pure=False)
+        def main(
+            x: R.Tensor([16, 16], "float32"),
+            fget_param: R.Callable([R.Prim("int64"), R.Object], R.Object),
+        ):
+            R.func_attr({"num_input": 2})
+            param_stream = R.call_builtin_with_ctx(
+                "vm.builtin.param_stream_create",
+                (fget_param, R.prim_value(0), R.shape([1024, 1024])),
+                sinfo_args=R.Object,
+            )
+            R.call_packed(
+                "vm.builtin.param_stream_prefetch",
+                param_stream,
+                R.prim_value(0),
+                R.prim_value(0),
+                R.str("w0"),
+                R.prim_value(0),
+                sinfo_args=R.Tuple(),
+            )
+            R.call_packed("vm.builtin.param_stream_wait", param_stream, sinfo_args=R.Tuple())
+            R.call_packed(
+                "vm.builtin.param_stream_prefetch",
+                param_stream,
+                R.prim_value(1),
+                R.prim_value(1),
+                R.str("w1"),
+                R.prim_value(0),
+                sinfo_args=R.Tuple(),
+            )
+            w0 = R.call_packed(
+                "vm.builtin.param_stream_get", param_stream, R.prim_value(0), sinfo_args=R.Object
+            )
+            w0 = R.match_cast(w0, R.Tensor([16, 16], "float32"))
+            y0 = R.matmul(x, w0)
+            R.call_packed("vm.builtin.param_stream_wait", param_stream, sinfo_args=R.Tuple())
+            R.call_packed(
+                "vm.builtin.param_stream_prefetch",
+                param_stream,
+                R.prim_value(0),
+                R.prim_value(2),
+                R.str("w2"),
+                R.prim_value(0),
+                sinfo_args=R.Tuple(),
+            )
+            w1 = R.call_packed(
+                "vm.builtin.param_stream_get", param_stream, R.prim_value(1), sinfo_args=R.Object
+            )
+            w1 = R.match_cast(w1, R.Tensor([16, 16], "float32"))
+            y1 = R.matmul(y0, w1)
+            R.call_packed("vm.builtin.param_stream_wait", param_stream, sinfo_args=R.Tuple())
+            w2 = R.call_packed(
+                "vm.builtin.param_stream_get", param_stream, R.prim_value(2), sinfo_args=R.Object
+            )
+            w2 = R.match_cast(w2, R.Tensor([16, 16], "float32"))
+            y2 = R.matmul(y1, w2)
+            return y2
+
+    After = relax.transform.PrefetchLazyInput(group_bytes=1024)(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_prefetch_lazy_input_output_param():
+    """A parameter returned by the function is fetched as before"""
+
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(fget_param: R.Callable([R.Prim("int64"), R.Object], R.Object)):
+            R.func_attr({"num_input": 1})
+            w0 = fget_param(R.prim_value(0), R.str("w0"))
+            w0 = R.match_cast(w0, R.Tensor([16, 16], "float32"))
+            return w0
+
+    After = relax.transform.PrefetchLazyInput()(Before)
+    tvm.ir.assert_structural_equal(After, Before)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -20,6 +20,7 @@ import tvm.testing
 from tvm import tir
 from tvm import meta_schedule as ms
 from tvm import relax
+from tvm.meta_schedule.tune_context import _normalize_mod
 from tvm.script import ir as I, tir as T
 
 target = tvm.target.Target("llvm --num-cores=16")
@@ -80,5 +81,37 @@ def test_apply_to_func_with_different_block_name():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_apply_to_funcs_sharing_workload():
+    @T.prim_func
+    def add_one(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+        for i in T.serial(64):
+            with T.block("block"):
+                vi = T.axis.spatial(64, i)
+                B[vi] = A[vi] + T.float32(1)
+
+    @T.prim_func
+    def add_two(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+        for i in T.serial(64):
+            with T.block("block"):
+                vi = T.axis.spatial(64, i)
+                B[vi] = A[vi] + T.float32(2)
+
+    workload = _normalize_mod(add_one)
+    sch = tir.Schedule(workload)
+    sch.split(sch.get_loops(sch.get_block("block"))[0], factors=[None, 8])
+    db = ms.database.create(kind="memory")
+    db.commit_tuning_record(
+        ms.database.TuningRecord(sch.trace, db.commit_workload(workload), [0.0], target)
+    )
+
+    mod = tvm.IRModule({"f0": add_one, "f1": add_one, "f2": add_two})
+    with db, target:
+        mod = relax.transform.MetaScheduleApplyDatabase()(mod)
+    for name in ["f0", "f1"]:
+        assert mod[name].attrs["tir.is_scheduled"]
+        tvm.ir.assert_structural_equal(mod[name].body, sch.mod["main"].body)
+    assert "tir.is_scheduled" not in (mod["f2"].attrs or {})
+
+
 if __name__ == "__main__":
     tvm.testing.main()
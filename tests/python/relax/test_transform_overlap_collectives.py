@@ -0,0 +1,111 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R
+
+
+def test_reorder_dataflow():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((128,), "float32"), y: R.Tensor((128,), "float32")):
+            with R.dataflow():
+                c = R.multiply(y, y)
+                a = R.ccl.allreduce(x, "sum")
+                b = R.add(a, x)
+                e = R.add(c, y)
+                d = R.add(b, e)
+                R.output(d)
+            return d
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((128,), "float32"), y: R.Tensor((128,), "float32")):
+            with R.dataflow():
+                a = R.ccl.allreduce(x, "sum")
+                c = R.multiply(y, y)
+                e = R.add(c, y)
+                b = R.add(a, x)
+                d = R.add(b, e)
+                R.output(d)
+            return d
+
+    After = relax.transform.OverlapCollectives()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_async_collectives():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((128,), "float32"), y: R.Tensor((128,), "float32")):
+            R.func_attr({"relax.force_pure": True})
+            c = R.multiply(y, y)
+            a = R.call_dps_packed(
+                "runtime.disco.allreduce",
+                [x, R.shape([0]), True],
+                out_sinfo=R.Tensor((128,), "float32"),
+            )
+            b = R.add(a, x)
+            e = R.add(c, y)
+            d = R.add(b, e)
+            return d
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((128,), "float32"), y: R.Tensor((128,), "float32")):
+            R.func_attr({"relax.force_pure": True})
+            a = R.builtin.alloc_tensor(R.shape([128]), R.dtype("float32"), R.prim_value(0))
+            handle = R.call_packed(
+                "runtime.disco.allreduce_async", x, R.shape([0]), True, a, sinfo_args=R.Object
+            )
+            c = R.multiply(y, y)
+            e = R.add(c, y)
+            _ = R.call_packed("runtime.disco.wait_collective", handle, x, a, sinfo_args=R.Object)
+            b = R.add(a, x)
+            d = R.add(b, e)
+            return d
+
+    After = relax.transform.OverlapCollectives()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_impure_barrier():
+    @I.ir_module
+    class Module:
+        @R.function(pure=False)
+        def main(x: R.Tensor((128,), "float32"), y: R.Tensor((128,), "float32")):
+            with R.dataflow():
+                c = R.multiply(y, y)
+                R.output(c)
+            _ = R.print(c, format="{}")
+            a = R.ccl.allreduce(x, "sum")
+            b = R.add(a, c)
+            return b
+
+    # The allreduce cannot be moved above the print, and nothing can be overlapped with it
+    After = relax.transform.OverlapCollectives()(Module)
+    tvm.ir.assert_structural_equal(After, Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R, tir as T
+
+
+@I.ir_module
+class Module:
+    @R.function
+    def main(
+        x: R.Tensor(("n", 64), "float32"), y: R.Tensor((64, 32), "float32")
+    ) -> R.Tensor(("n", 32), "float32"):
+        n = T.int64()
+        with R.dataflow():
+            lv = R.matmul(x, y)
+            gv = R.nn.relu(lv)
+            R.output(gv)
+        return gv
+
+
+def test_specialize():
+    mod = relax.transform.SpecializeShapeBuckets({"main": [{"n": 128}, {"n": 1}]})(Module)
+    assert relax.analysis.well_formed(mod)
+    names = sorted(gv.name_hint for gv in mod.get_global_vars())
+    assert names == ["main", "main_generic", "main_n1", "main_n128"]
+    for name in ["main_generic", "main_n1", "main_n128"]:
+        assert "global_symbol" not in mod[name].attrs
+    tvm.ir.assert_structural_equal(mod["main_generic"].struct_info, Module["main"].struct_info)
+    tvm.ir.assert_structural_equal(mod["main"].struct_info, Module["main"].struct_info)
+    tvm.ir.assert_structural_equal(
+        mod["main_n128"].params[0].struct_info, relax.TensorStructInfo([128, 64], "float32")
+    )
+    # The hottest bucket is checked first
+    dispatch = mod["main"].body.blocks[0].bindings[0].value
+    assert isinstance(dispatch, relax.If)
+    assert "128" in str(dispatch.cond)
+
+
+def test_dispatch_numerics():
+    mod = relax.transform.SpecializeShapeBuckets({"main": [{"n": 128}]})(Module)
+    vm = relax.VirtualMachine(relax.build(mod, "llvm"), tvm.cpu())
+    y = np.random.uniform(-1, 1, (64, 32)).astype("float32")
+    for n in [128, 5]:
+        x = np.random.uniform(-1, 1, (n, 64)).astype("float32")
+        out = vm["main"](tvm.nd.array(x), tvm.nd.array(y))
+        tvm.testing.assert_allclose(out.numpy(), np.maximum(x @ y, 0), rtol=1e-5, atol=1e-5)
+
+
+def test_unknown_symbolic_var():
+    with pytest.raises(tvm.TVMError):
+        relax.transform.SpecializeShapeBuckets({"main": [{"m": 128}]})(Module)
+
+
+def test_select_shape_buckets():
+    samples = [{"n": 128}] * 6 + [{"n": 256}] * 3 + [{"n": 7}]
+    assert relax.transform.select_shape_buckets(samples, min_coverage=0.9) == [
+        {"n": 128},
+        {"n": 256},
+    ]
+    assert relax.transform.select_shape_buckets(samples, max_buckets=1) == [{"n": 128}]
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -189,6 +189,230 @@ def test_basic():
     tvm.ir.assert_structural_equal(mod, ExpectedLowered)
 
 
+def test_arena():
+    # fmt: off
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add(rxplaceholder: T.Buffer(T.int64(8), "float32"), rxplaceholder_1: T.Buffer((), "float32"), T_add: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def relu(rxplaceholder: T.Buffer(T.int64(8), "float32"), compute: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def log(rxplaceholder: T.Buffer(T.int64(10), "float32"), compute: T.Buffer(T.int64(10), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def exp(rxplaceholder: T.Buffer((T.int64(2), T.int64(4)), "float32"), compute: T.Buffer((T.int64(2), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def pad(rxplaceholder: T.Buffer(T.int64(8), "float32"), PadInput: T.Buffer(T.int64(10), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((2, 4), dtype="float32")) -> R.Tensor((10,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.exp(x, alloc)
+            lv: R.Tensor((2, 4), dtype="float32") = alloc
+            lv1: R.Tensor((8,), dtype="float32") = R.reshape(lv, (8,))
+            alloc1: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.relu(lv1, alloc1)
+            lv2: R.Tensor((8,), dtype="float32") = alloc1
+            alloc2: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+            _2: R.Tuple() = cls.add(lv2, R.const(1, "float32"), alloc2)
+            lv3: R.Tensor((8,), dtype="float32") = alloc2
+            alloc3: R.Tensor((10,), dtype="float32") = R.builtin.alloc_tensor(R.shape([10]), dtype="float32", runtime_device_index=0)
+            _3: R.Tuple() = cls.pad(lv3, alloc3)
+            lv4: R.Tensor((10,), dtype="float32") = alloc3
+            alloc4: R.Tensor((10,), dtype="float32") = R.builtin.alloc_tensor(R.shape([10]), dtype="float32", runtime_device_index=0)
+            _4: R.Tuple() = cls.log(lv4, alloc4)
+            gv: R.Tensor((10,), dtype="float32") = alloc4
+            return gv
+
+    @tvm.script.ir_module
+    class Expected:
+        @T.prim_func
+        def add(rxplaceholder: T.Buffer(T.int64(8), "float32"), rxplaceholder_1: T.Buffer((), "float32"), T_add: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def relu(rxplaceholder: T.Buffer(T.int64(8), "float32"), compute: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def log(rxplaceholder: T.Buffer(T.int64(10), "float32"), compute: T.Buffer(T.int64(10), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def exp(rxplaceholder: T.Buffer((T.int64(2), T.int64(4)), "float32"), compute: T.Buffer((T.int64(2), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def pad(rxplaceholder: T.Buffer(T.int64(8), "float32"), PadInput: T.Buffer(T.int64(10), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((2, 4), dtype="float32")) -> R.Tensor((10,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Expected
+            storage: R.Object = R.memory.alloc_storage(R.shape([128]), virtual_device_index=0, storage_scope="global", dtype="uint8")
+            alloc: R.Tensor((2, 4), dtype="float32") = R.memory.alloc_tensor(storage, 0, R.shape([2, 4]), dtype="float32")
+            _ = cls.exp(x, alloc)
+            lv: R.Tensor((2, 4), dtype="float32") = alloc
+            lv1: R.Tensor((8,), dtype="float32") = R.reshape(lv, (8,))
+            # The output of relu cannot overlap its input
+            alloc1: R.Tensor((8,), dtype="float32") = R.memory.alloc_tensor(storage, 64, R.shape([8]), dtype="float32")
+            _ = cls.relu(lv1, alloc1)
+            lv2: R.Tensor((8,), dtype="float32") = alloc1
+            alloc2: R.Tensor((8,), dtype="float32") = R.memory.alloc_tensor(storage, 0, R.shape([8]), dtype="float32")
+            _ = cls.add(lv2, R.const(1, "float32"), alloc2)
+            lv3: R.Tensor((8,), dtype="float32") = alloc2
+            # The 40-byte tensor takes the dead 32-byte one's place and its aligned tail
+            alloc3: R.Tensor((10,), dtype="float32") = R.memory.alloc_tensor(storage, 64, R.shape([10]), dtype="float32")
+            _ = cls.pad(lv3, alloc3)
+            lv4: R.Tensor((10,), dtype="float32") = alloc3
+            alloc4: R.Tensor((10,), dtype="float32") = R.builtin.alloc_tensor(R.shape([10]), dtype="float32", runtime_device_index=0)
+            _ = cls.log(lv4, alloc4)
+            gv5: R.Tensor((10,), dtype="float32") = alloc4
+            return gv5
+    # fmt: on
+
+    with tvm.transform.PassContext(config={"relax.memory_plan_arena": True}):
+        mod = relax.transform.StaticPlanBlockMemory()(Module)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_arena_if_branches():
+    # fmt: off
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def relu(rxplaceholder: T.Buffer(T.int64(8), "float32"), compute: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def tile(rxplaceholder: T.Buffer(T.int64(8), "float32"), T_tile: T.Buffer(T.int64(32), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def exp(rxplaceholder: T.Buffer(T.int64(32), "float32"), compute: T.Buffer(T.int64(32), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def reduce(rxplaceholder: T.Buffer(T.int64(32), "float32"), rxplaceholder_red: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((8,), dtype="float32"), cond: R.Tensor((), dtype="bool")) -> R.Tensor((8,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Module
+            if cond:
+                alloc: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+                _: R.Tuple() = cls.relu(x, alloc)
+                alloc1: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+                _1: R.Tuple() = cls.relu(alloc, alloc1)
+                gv: R.Tensor((8,), dtype="float32") = alloc1
+            else:
+                alloc2: R.Tensor((32,), dtype="float32") = R.builtin.alloc_tensor(R.shape([32]), dtype="float32", runtime_device_index=0)
+                _2: R.Tuple() = cls.tile(x, alloc2)
+                alloc3: R.Tensor((32,), dtype="float32") = R.builtin.alloc_tensor(R.shape([32]), dtype="float32", runtime_device_index=0)
+                _3: R.Tuple() = cls.exp(alloc2, alloc3)
+                alloc4: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+                _4: R.Tuple() = cls.reduce(alloc3, alloc4)
+                gv: R.Tensor((8,), dtype="float32") = alloc4
+            return gv
+
+    @tvm.script.ir_module
+    class Expected:
+        @T.prim_func
+        def relu(rxplaceholder: T.Buffer(T.int64(8), "float32"), compute: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def tile(rxplaceholder: T.Buffer(T.int64(8), "float32"), T_tile: T.Buffer(T.int64(32), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def exp(rxplaceholder: T.Buffer(T.int64(32), "float32"), compute: T.Buffer(T.int64(32), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def reduce(rxplaceholder: T.Buffer(T.int64(32), "float32"), rxplaceholder_red: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((8,), dtype="float32"), cond: R.Tensor((), dtype="bool")) -> R.Tensor((8,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Expected
+            # The branches share the arena, which is as large as the one of the else branch
+            storage: R.Object = R.memory.alloc_storage(R.shape([256]), virtual_device_index=0, storage_scope="global", dtype="uint8")
+            if cond:
+                alloc: R.Tensor((8,), dtype="float32") = R.memory.alloc_tensor(storage, 0, R.shape([8]), dtype="float32")
+                _ = cls.relu(x, alloc)
+                alloc1: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+                _1 = cls.relu(alloc, alloc1)
+                gv: R.Tensor((8,), dtype="float32") = alloc1
+            else:
+                alloc2: R.Tensor((32,), dtype="float32") = R.memory.alloc_tensor(storage, 0, R.shape([32]), dtype="float32")
+                _2 = cls.tile(x, alloc2)
+                alloc3: R.Tensor((32,), dtype="float32") = R.memory.alloc_tensor(storage, 128, R.shape([32]), dtype="float32")
+                _3 = cls.exp(alloc2, alloc3)
+                alloc4: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+                _4 = cls.reduce(alloc3, alloc4)
+                gv: R.Tensor((8,), dtype="float32") = alloc4
+            return gv
+    # fmt: on
+
+    with tvm.transform.PassContext(config={"relax.memory_plan_arena": True}):
+        mod = relax.transform.StaticPlanBlockMemory()(Module)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_arena_private_function():
+    # fmt: off
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def relu(rxplaceholder: T.Buffer(T.int64(8), "float32"), compute: T.Buffer(T.int64(8), "float32")):
+            T.evaluate(0)
+
+        @R.function(private=True)
+        def subroutine(x: R.Tensor((8,), dtype="float32")) -> R.Tensor((8,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.relu(x, alloc)
+            alloc1: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.relu(alloc, alloc1)
+            return alloc1
+
+        @R.function
+        def main(x: R.Tensor((8,), dtype="float32")) -> R.Tensor((8,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.relu(x, alloc)
+            lv: R.Tensor((8,), dtype="float32") = cls.subroutine(alloc)
+            alloc1: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.relu(lv, alloc1)
+            return alloc1
+    # fmt: on
+
+    with tvm.transform.PassContext(config={"relax.memory_plan_arena": True}):
+        mod = relax.transform.StaticPlanBlockMemory()(Module)
+    # The subroutine is inlined, and all the intermediate tensors share one arena
+    assert [gv.name_hint for gv in mod.get_global_vars()].count("subroutine") == 0
+    script = mod["main"].script()
+    assert script.count("R.memory.alloc_storage") == 1
+    assert "R.memory.alloc_storage(R.shape([128])" in script
+
+
 def test_different_dtype():
     @tvm.script.ir_module
     class Module:
@@ -1036,5 +1036,91 @@ def test_convert_sig():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_fp32_var_names():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float32"),
+            w1: R.Tensor((8, 8), "float32"),
+            w2: R.Tensor((8, 8), "float32"),
+        ) -> R.Tensor((4, 8), "float32"):
+            with R.dataflow():
+                lv0 = R.matmul(x, w1, out_dtype="float32")
+                gv = R.matmul(lv0, w2, out_dtype="float32")
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float32"),
+            w1: R.Tensor((8, 8), "float32"),
+            w2: R.Tensor((8, 8), "float32"),
+        ) -> R.Tensor((4, 8), "float32"):
+            with R.dataflow():
+                lv = R.astype(x, dtype="float16")
+                lv1 = R.astype(w1, dtype="float16")
+                lv2 = R.matmul(lv, lv1, out_dtype="float32")
+                lv0 = R.astype(lv2, dtype="float16")
+                lv3 = R.astype(lv0, dtype="float32")
+                gv = R.matmul(lv3, w2, out_dtype="float32")
+                R.output(gv)
+            return gv
+
+    mod = ToMixedPrecision(fp32_var_names=["gv"])(Input)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_fp8_matmul():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float32"), w: R.Tensor((8, 16), "float32")
+        ) -> R.Tensor((4, 16), "float32"):
+            with R.dataflow():
+                gv = R.matmul(x, w, out_dtype="float32")
+                R.output(gv)
+            return gv
+
+    mod = ToMixedPrecision(matmul_dtype="e4m3_float8")(Input)
+    assert relax.analysis.well_formed(mod)
+    bindings = mod["main"].body.blocks[0].bindings
+    matmuls = [b.value for b in bindings if b.value.op.same_as(tvm.ir.Op.get("relax.matmul"))]
+    assert len(matmuls) == 1
+    assert [arg.struct_info.dtype for arg in matmuls[0].args] == ["e4m3_float8"] * 2
+    assert matmuls[0].struct_info.dtype == "float32"
+    # The output is scaled back by the product of the two input scales
+    assert bindings[-1].value.op.same_as(tvm.ir.Op.get("relax.multiply"))
+    assert mod["main"].ret_struct_info.dtype == "float32"
+
+
+def test_calibrate_mixed_precision():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float32"),
+            w1: R.Tensor((8, 8), "float32"),
+            w2: R.Tensor((8, 8), "float32"),
+        ) -> R.Tensor((4, 8), "float32"):
+            with R.dataflow():
+                lv0 = R.matmul(x, w1, out_dtype="float32")
+                lv1 = R.matmul(lv0, w2, out_dtype="float32")
+                gv = R.multiply(lv1, R.const(1e-3, "float32"))
+                R.output(gv)
+            return gv
+
+    np.random.seed(0)
+    x = np.random.uniform(1, 2, (4, 8)).astype("float32")
+    w1 = np.random.uniform(1, 2, (8, 8)).astype("float32")
+    # lv1 overflows in fp16, while everything else is accurate in fp16
+    w2 = np.random.uniform(1000, 2000, (8, 8)).astype("float32")
+    fp32_var_names = relax.transform.calibrate_mixed_precision(Input, [x, w1, w2], rtol=1e-2)
+    assert fp32_var_names == ["lv1"]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
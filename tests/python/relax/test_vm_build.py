@@ -467,6 +467,124 @@ def test_vm_emit_te_constant_param_cpu(exec_mode):
     tvm.testing.assert_allclose(add_res.numpy(), x_np + c_np, rtol=1e-7, atol=1e-7)
 
 
+def test_vm_create_context(exec_mode):
+    import threading
+
+    c_np = np.random.rand(2, 2).astype("float32")
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", R.Tensor((2, 2), "float32"))
+    c = relax.const(c_np, "float32")
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, c)
+            gv = bb.emit_output(lv0)
+        bb.emit_func_output(gv)
+
+    exec = relax.build(bb.get(), "llvm", exec_mode=exec_mode)
+    dev = tvm.cpu()
+    vm = relax.VirtualMachine(exec, dev)
+    contexts = [vm.create_context() for _ in range(4)]
+    errors = []
+
+    def run(ctx, seed):
+        x_np = np.random.RandomState(seed).rand(2, 2).astype("float32")
+        try:
+            for _ in range(20):
+                res = ctx["main"](tvm.nd.array(x_np, dev))
+                tvm.testing.assert_allclose(res.numpy(), x_np + c_np, rtol=1e-7, atol=1e-7)
+        except Exception as err:  # pylint: disable=broad-except
+            errors.append(err)
+
+    threads = [threading.Thread(target=run, args=(ctx, i)) for i, ctx in enumerate(contexts)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert not errors, errors
+
+    # The stateful interface of a context is independent of the VM.
+    x_np = np.random.rand(2, 2).astype("float32")
+    contexts[0].set_input("main", tvm.nd.array(x_np, dev))
+    contexts[0].invoke_stateful("main")
+    tvm.testing.assert_allclose(
+        contexts[0].get_outputs("main").numpy(), x_np + c_np, rtol=1e-7, atol=1e-7
+    )
+    with pytest.raises(ValueError):
+        vm.get_outputs("main")
+
+
+def test_vm_invoke_async(exec_mode):
+    c_np = np.random.rand(2, 2).astype("float32")
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", R.Tensor((2, 2), "float32"))
+    c = relax.const(c_np, "float32")
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, c)
+            gv = bb.emit_output(lv0)
+        bb.emit_func_output(gv)
+
+    exec = relax.build(bb.get(), "llvm", exec_mode=exec_mode)
+    dev = tvm.cpu()
+    vm = relax.VirtualMachine(exec, dev)
+    inputs = [np.random.rand(2, 2).astype("float32") for _ in range(8)]
+    futures = [vm.invoke_async("main", tvm.nd.array(x_np, dev)) for x_np in inputs]
+    # The VM stays usable while the invocations run.
+    res = vm["main"](tvm.nd.array(inputs[0], dev))
+    tvm.testing.assert_allclose(res.numpy(), inputs[0] + c_np, rtol=1e-7, atol=1e-7)
+    for future, x_np in zip(futures, inputs):
+        tvm.testing.assert_allclose(future.result().numpy(), x_np + c_np, rtol=1e-7, atol=1e-7)
+        assert future.done()
+
+    future = vm.invoke_async("main", tvm.nd.array(np.zeros((3, 3), "float32"), dev))
+    with pytest.raises(Exception):
+        future.result()
+
+
+def test_vm_output_zero_copy(exec_mode):
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(A: T.Buffer((4,), "float32"), B: T.Buffer((4,), "float32")):
+            for i in range(4):
+                with T.block("B"):
+                    vi = T.axis.spatial(4, i)
+                    B[vi] = A[vi] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((4,), "float32")):
+            cls = Module
+            y = R.call_tir(cls.add_one, (x,), R.Tensor((4,), "float32"))
+            z = R.call_tir(cls.add_one, (y,), R.Tensor((4,), "float32"))
+            return (y, z)
+
+    ex = relax.build(Module, "llvm", exec_mode=exec_mode)
+    dev = tvm.cpu()
+    vm = relax.VirtualMachine(ex, dev)
+    x_np = np.random.rand(4).astype("float32")
+    out0 = tvm.nd.empty((4,), "float32", dev)
+    out1 = tvm.nd.empty((4,), "float32", dev)
+    vm.set_output_zero_copy("main", 0, out0)
+    vm.set_output_zero_copy("main", 1, out1)
+    vm.set_input("main", tvm.nd.array(x_np, dev))
+    vm.invoke_stateful("main")
+    res = vm.get_outputs("main")
+    tvm.testing.assert_allclose(out0.numpy(), x_np + 1, rtol=1e-7, atol=1e-7)
+    tvm.testing.assert_allclose(out1.numpy(), x_np + 2, rtol=1e-7, atol=1e-7)
+    assert res[0].handle.contents.data == out0.handle.contents.data
+    assert res[1].handle.contents.data == out1.handle.contents.data
+
+    vm.set_output_zero_copy("main", 0, tvm.nd.empty((5,), "float32", dev))
+    with pytest.raises(Exception):
+        vm.invoke_stateful("main")
+
+    vm.clear_output_zero_copy("main")
+    vm.invoke_stateful("main")
+    res = vm.get_outputs("main")
+    assert res[0].handle.contents.data != out0.handle.contents.data
+    tvm.testing.assert_allclose(res[1].numpy(), x_np + 2, rtol=1e-7, atol=1e-7)
+
+
 @tvm.testing.requires_gpu
 def test_vm_emit_te_constant_param_gpu(exec_mode):
     x_np = np.random.rand(2, 2).astype("float32")
@@ -177,5 +177,42 @@ def test_capture_error_is_recoverable():
         vm["main"](arg)
 
 
+@tvm.testing.requires_cudagraph
+def test_symbolic_capture_cache_limits():
+    """Graphs captured per bucket of a symbolic variable are evicted in LRU order"""
+
+    target = tvm.target.Target("cuda")
+    dev = tvm.cuda()
+
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(A: R.Tensor(["n", 16], "float32")):
+            R.func_attr(
+                {
+                    "relax.rewrite_cuda_graph.capture_symbolic_vars": ["n"],
+                    "tir_var_upper_bound": {"n": 32},
+                }
+            )
+            B = R.add(A, A)
+            C = R.multiply(B, B)
+            D = R.add(C, A)
+            return D
+
+    with target, tvm.ir.transform.PassContext(config={"relax.backend.use_cuda_graph": True}):
+        built = tvm.relax.build(Module, target=target)
+
+    set_cache_limits = tvm.get_global_func("vm.builtin.cuda_graph.set_cache_limits")
+    set_cache_limits(1, 0)
+    try:
+        vm = tvm.relax.VirtualMachine(built, dev)
+        for n in [8, 16, 8, 32, 16, 8]:
+            a_np = np.random.uniform(size=(n, 16)).astype("float32")
+            d = vm["main"](tvm.nd.array(a_np, dev))
+            tvm.testing.assert_allclose(d.numpy(), 4 * a_np * a_np + a_np, rtol=1e-5)
+    finally:
+        set_cache_limits(0, 0)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
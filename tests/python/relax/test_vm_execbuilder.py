@@ -19,6 +19,7 @@ import numpy as np
 import pytest
 
 import tvm
+import tvm.contrib.utils
 from tvm import TVMError, relax
 from tvm.relax.testing.vm import check_saved_func
 from tvm.script import relax as R
@@ -114,6 +115,28 @@ def test_emit_cache():
         ib.emit_ret(ib.r(0))
 
 
+def test_vm_constant_save_load():
+    np_small = np.arange(3).astype("int8")
+    np_large = np.random.rand(3, 65).astype("float32")
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=0):
+        small = ib.convert_constant(tvm.nd.array(np_small))
+        large = ib.convert_constant(tvm.nd.array(np_large))
+        ib.emit_call("vm.builtin.make_tuple", args=[small, large], dst=ib.r(0))
+        ib.emit_ret(ib.r(0))
+    ex = ib.get()
+
+    temp = tvm.contrib.utils.tempdir()
+    path = temp.relpath("exec.bin")
+    ex.mod.save(path)
+    # The constants of the loaded executable alias the mapped file
+    loaded = tvm.get_global_func("relax.ExecutableLoadFromFile")(path)
+    vm = relax.VirtualMachine(loaded, tvm.cpu())
+    res_small, res_large = vm["main"]()
+    np.testing.assert_equal(res_small.numpy(), np_small)
+    np.testing.assert_equal(res_large.numpy(), np_large)
+
+
 def test_vm_formalize():
     ib0 = relax.ExecBuilder()
     ib1 = relax.ExecBuilder()
@@ -240,6 +263,24 @@ def test_vm_if():
     tvm.testing.assert_allclose(res.numpy(), a.numpy() + b.numpy(), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_register_reuse():
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=2):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_call("test.vm.add", args=[ib.r(2), ib.r(1)], dst=ib.r(3))
+        ib.emit_call("test.vm.add", args=[ib.r(3), ib.r(1)], dst=ib.r(4))
+        ib.emit_ret(ib.r(4))
+    ex = ib.get()
+    # the registers of dead values are reused, so three registers are enough
+    text = ex.as_text()
+    assert "%2" in text and "%3" not in text and "%4" not in text
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    a = tvm.nd.array(np.random.rand(4))
+    b = tvm.nd.array(np.random.rand(4))
+    res = check_saved_func(vm, "main", a, b)
+    tvm.testing.assert_allclose(res.numpy(), a.numpy() + 3 * b.numpy(), rtol=1e-7, atol=1e-7)
+
+
 def test_vm_invoke_closure():
     ib = relax.ExecBuilder()
     with ib.function("lifted_func_1", num_inputs=4):
@@ -14,7 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
 import numpy as np
+import pytest
 import tvm
 import tvm.testing
 
@@ -24,7 +27,7 @@ from tvm.relax.testing import nn
 from tvm.script import relax as R
 
 
-def get_exec(data_shape):
+def get_exec(data_shape, target="llvm"):
     builder = relax.BlockBuilder()
     weight1_np = np.random.randn(64, 64).astype("float32")
     weight2_np = np.random.randn(64, 64).astype("float32")
@@ -46,7 +49,9 @@ def get_exec(data_shape):
     params = {"linear_weight": weight1_np, "linear_weight1": weight2_np}
     mod = relax.transform.BindParams("main", params)(mod)
 
-    target = "llvm"
+    if "cuda" in str(target):
+        with tvm.target.Target(target):
+            mod = tvm.tir.transform.DefaultGPUSchedule()(relax.transform.LegalizeOps()(mod))
     return relax.build(mod, target)
 
 
@@ -62,6 +67,129 @@ def test_conv2d_cpu():
     assert "matmul" in str(report)
 
 
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is None,
+    reason="PAPI profiling not enabled",
+)
+def test_papi_collector_cpu():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+
+    vm = relax.VirtualMachine(ex, tvm.cpu(), profile=True)
+    metric = "PAPI_FP_OPS"
+    report = vm.profile(
+        "main",
+        tvm.nd.array(data_np),
+        collectors=[tvm.runtime.profiling.PAPIMetricCollector({tvm.cpu(): [metric]})],
+    )
+    matmuls = [call for call in report.calls if "matmul" in call["Name"]]
+    assert matmuls and all(call[metric].value > 0 for call in matmuls)
+
+
+@tvm.testing.requires_cuda
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is None,
+    reason="CUPTI profiling not enabled",
+)
+def test_cupti_collector_cuda():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape, "cuda")
+
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(ex, dev, profile=True)
+    metric = "dram__bytes_read.sum"
+    report = vm.profile(
+        "main",
+        tvm.nd.array(data_np, dev),
+        collectors=[tvm.runtime.profiling.CUPTIMetricCollector([metric])],
+    )
+    matmuls = [call for call in report.calls if "matmul" in call["Name"]]
+    assert matmuls and all(call[metric].value > 0 for call in matmuls)
+
+
+def test_trace_cpu():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+
+    # Tracing works on a VM created without profile=True.
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    data = tvm.nd.array(data_np)
+    expected = vm["main"](data).numpy()
+
+    vm.start_trace()
+    out = vm["main"](data)
+    report = vm.stop_trace()
+    tvm.testing.assert_allclose(out.numpy(), expected)
+
+    assert "Host Duration" in str(report)
+    assert "matmul" in str(report)
+    names = [call["Name"] for call in report.calls]
+    assert len(names) == len(set(names)), "calls are aggregated by callee"
+
+    events = json.loads(vm.chrome_trace())["traceEvents"]
+    assert any("matmul" in event["name"] and event["ph"] == "X" for event in events)
+    # The VM runs the same after tracing.
+    tvm.testing.assert_allclose(vm["main"](data).numpy(), expected)
+
+
+
+def test_sampling_cpu():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    data = tvm.nd.array(data_np)
+    expected = vm["main"](data).numpy()
+
+    profiling = tvm.runtime.profiling
+    profiling.drain_samples()
+    profiling.configure_sampling(1)
+    try:
+        for _ in range(3):
+            tvm.testing.assert_allclose(vm["main"](data).numpy(), expected)
+    finally:
+        profiling.configure_sampling(0)
+    drained = profiling.drain_samples()
+    assert drained["num_lost"] == 0
+
+    samples = drained["samples"]
+    invocations = {sample["invocation"] for sample in samples if sample["name"] == "main"}
+    assert len(invocations) == 3
+    matmuls = [sample for sample in samples if "matmul" in sample["name"]]
+    assert matmuls and all(sample["depth"] == 1 for sample in matmuls)
+    assert {sample["invocation"] for sample in matmuls} == invocations
+    assert all(sample["duration_ns"] >= 0 for sample in samples)
+
+    # Nothing is sampled after sampling is disabled.
+    vm["main"](data)
+    assert not profiling.drain_samples()["samples"]
+
+
+def test_process_trace_cpu():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    data = tvm.nd.array(data_np)
+    expected = vm["main"](data).numpy()
+
+    profiling = tvm.runtime.profiling
+    profiling.start_trace()
+    try:
+        tvm.testing.assert_allclose(vm["main"](data).numpy(), expected)
+    finally:
+        trace = json.loads(profiling.stop_trace())
+
+    spans = [event for event in trace["traceEvents"] if event["ph"] == "X"]
+    (main,) = [event for event in spans if event["name"] == "main"]
+    assert main["cat"] == "vm_function"
+    matmuls = [event for event in spans if "matmul" in event["name"]]
+    assert matmuls and all(event["tid"] == main["tid"] for event in matmuls)
+    assert all(main["ts"] <= event["ts"] <= main["ts"] + main["dur"] for event in matmuls)
+    # Nothing is recorded after the trace stops.
+    vm["main"](data)
+    assert not [e for e in json.loads(profiling.stop_trace())["traceEvents"] if e["ph"] == "X"]
+
 def with_rpc(ex, f, data_np):
     temp = utils.tempdir()
     path = temp.relpath("vm_library.so")
@@ -286,5 +286,57 @@ def test_aot_incorrect_input_name(target_kind: str):
         runner.get_input_index(incorrect_input_name)
 
 
+def _build_add_module(shape, temp_dir, name):
+    x = relay.var("x", shape=shape, dtype="float32")
+    ir_mod = IRModule.from_expr(relay.Function([x], relay.nn.relu(x) + relay.const(1.0)))
+    with tvm.transform.PassContext(opt_level=3, config={"tir.usmp.enable": True}):
+        mod = tvm.relay.build(
+            ir_mod,
+            target="llvm",
+            executor=backend.Executor("aot", {"interface-api": "packed", "unpacked-api": False}),
+        )
+    so_path = temp_dir / f"{name}.so"
+    mod.export_library(so_path, cc="gcc", options=["-std=c11"])
+    loaded_mod = tvm.runtime.load_module(so_path)
+    return tvm.runtime.executor.AotModule(loaded_mod["default"](tvm.cpu(0)))
+
+
+def test_zero_copy_io():
+    """Tests binding inputs and outputs without copies"""
+    temp_dir = tvm.contrib.utils.TempDirectory()
+    runner = _build_add_module((4, 8), temp_dir, "zero_copy")
+
+    data = np.random.uniform(-1, 1, (4, 8)).astype("float32")
+    x = tvm.nd.array(data)
+    out = tvm.nd.empty((4, 8), "float32")
+    runner.set_input_zero_copy("x", x)
+    runner.set_output_zero_copy(0, out)
+    runner.run()
+    np.testing.assert_allclose(out.numpy(), np.maximum(data, 0) + 1)
+
+    # The bound input is read again on each run, no new set_input is needed.
+    x.copyfrom(-data)
+    runner.run()
+    np.testing.assert_allclose(out.numpy(), np.maximum(-data, 0) + 1)
+    np.testing.assert_allclose(runner.get_output(0, tvm.nd.empty((4, 8))).numpy(), out.numpy())
+
+    with pytest.raises(tvm.TVMError):
+        runner.set_input_zero_copy("x", tvm.nd.empty((4, 4), "float32"))
+
+
+def test_share_workspace():
+    """Tests running several AOT modules on one set of workspace pools"""
+    temp_dir = tvm.contrib.utils.TempDirectory()
+    small = _build_add_module((2, 8), temp_dir, "small")
+    large = _build_add_module((16, 8), temp_dir, "large")
+    small.share_workspace(large)
+
+    for shape, runner in [((2, 8), small), ((16, 8), large), ((2, 8), small)]:
+        data = np.random.uniform(-1, 1, shape).astype("float32")
+        runner.set_input("x", data)
+        runner.run()
+        np.testing.assert_allclose(runner.get_output(0).numpy(), np.maximum(data, 0) + 1)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
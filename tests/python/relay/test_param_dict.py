@@ -16,6 +16,7 @@
 # under the License.
 import os
 import numpy as np
+import pytest
 import tvm
 from tvm import te, runtime
 import json
@@ -89,7 +90,36 @@ def test_bigendian_rpc_param():
         verify_graph_executor(remote, target, (10,), dtype)
 
 
+def test_save_load_chunked():
+    x = np.random.uniform(size=(100, 30)).astype("float32")
+    y = np.arange(7).astype("int8")
+    temp = utils.tempdir()
+    path = temp.relpath("params.bin")
+    runtime.save_param_dict_chunked({"x": x, "y": y}, path, chunk_size=1024)
+    assert runtime.list_param_dict_chunked(path) == ["x", "y"]
+    assert runtime.validate_param_dict_chunked(path) == []
+
+    params = runtime.load_param_dict_chunked(path)
+    np.testing.assert_equal(params["x"].numpy(), x)
+    np.testing.assert_equal(params["y"].numpy(), y)
+    partial = runtime.load_param_dict_chunked(path, ["y"])
+    assert list(partial.keys()) == ["y"]
+    np.testing.assert_equal(partial["y"].numpy(), y)
+
+    # Corrupt a byte in the middle of "x" and make sure it is detected.
+    with open(path, "r+b") as f:
+        f.seek(4096)
+        byte = f.read(1)
+        f.seek(4096)
+        f.write(bytes([byte[0] ^ 0xFF]))
+    assert runtime.validate_param_dict_chunked(path) == ["x"]
+    np.testing.assert_equal(runtime.load_param_dict_chunked(path, ["y"])["y"].numpy(), y)
+    with pytest.raises(tvm.TVMError):
+        runtime.load_param_dict_chunked(path, ["x"])
+
+
 if __name__ == "__main__":
     test_save_load()
     test_ndarray_reflection()
+    test_save_load_chunked()
     test_bigendian_rpc_param()
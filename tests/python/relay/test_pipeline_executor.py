@@ -623,5 +623,54 @@ def test_pipeline():
             reset_cpu_affinity(affinity)
 
 
+def test_pipeline_micro_batch():
+    if not pipeline_executor_build.pipeline_executor_build_enabled():
+        return
+    (mod1, mod2, mod3), dshape = get_split_mod()
+    pipe_config = pipeline_executor_build.PipelineConfig()
+    pipe_config["input"]["data_a"].connect(pipe_config[mod1]["input"]["data_0"])
+    pipe_config["input"]["data_b"].connect(pipe_config[mod2]["input"]["data_1"])
+    pipe_config[mod1]["output"][0].connect(pipe_config[mod2]["input"]["data_n_0"])
+    pipe_config[mod1]["output"][1].connect(pipe_config[mod3]["input"]["data_n_2"])
+    pipe_config[mod2]["output"][0].connect(pipe_config[mod3]["input"]["data_n_1"])
+    pipe_config[mod3]["output"][0].connect(pipe_config["output"]["0"])
+    for mod in [mod1, mod2, mod3]:
+        pipe_config[mod].target = "llvm"
+        pipe_config[mod].dev = tvm.cpu(0)
+
+    with tvm.transform.PassContext(opt_level=3):
+        pipeline_mod_factory = pipeline_executor_build.build(pipe_config)
+    pipeline_module = pipeline_executor.PipelineModule(pipeline_mod_factory)
+
+    # Every module runs once per dshape[0] requests of a single row.
+    micro_batch = dshape[0]
+    for i in range(3):
+        pipeline_module.set_micro_batch(i, micro_batch)
+    pipeline_module.set_queue_depth(micro_batch)
+
+    num_requests = 2 * micro_batch
+    requests = [np.full((1, dshape[1]), i).astype("float32") for i in range(num_requests)]
+    outputs = []
+    for data in requests:
+        pipeline_module.set_input("data_a", tvm.nd.array(data))
+        pipeline_module.set_input("data_b", tvm.nd.array(data))
+        pipeline_module.run()
+        output = pipeline_module.get_output(synchronize=False)
+        if output:
+            outputs.append(output[0].numpy())
+    while len(outputs) < num_requests:
+        outputs.append(pipeline_module.get_output()[0].numpy())
+
+    for data, output in zip(requests, outputs):
+        tvm.testing.assert_allclose(output, 3 * (2 * data + 8) + data - 2)
+
+    stats = pipeline_module.get_statistics()
+    assert len(stats["stages"]) == 3
+    for stage in stats["stages"]:
+        assert stage["micro_batch"] == micro_batch
+        assert stage["num_requests"] == num_requests
+        assert stage["num_invocations"] == num_requests // micro_batch
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -14,11 +14,14 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os
+
 import numpy as np
 import tvm
 from tvm import te
 import tvm.testing
 from tvm import relay
+from tvm.contrib import graph_executor, utils
 from tvm import autotvm
 from tvm import topi
 from tvm.relay.backend import te_compiler
@@ -284,6 +287,36 @@ def test_compile_propogate_hash():
         assert "hash" in f.attrs.keys()
 
 
+def test_compile_disk_cache():
+    def get_mod(num_funcs):
+        x = relay.var("x", shape=(4, 8), dtype="float32")
+        y = relay.exp(x)
+        for i in range(1, num_funcs):
+            y = relay.add(relay.annotation.stop_fusion(y), relay.const(float(i)))
+        return tvm.IRModule.from_expr(relay.Function([x], y))
+
+    def run(mod, cache_dir):
+        config = {"relay.backend.te_compiler_cache_dir": cache_dir}
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            lib = relay.build(mod, target="llvm")
+        runtime = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        x_np = np.random.uniform(size=(4, 8)).astype("float32")
+        runtime.set_input("x", x_np)
+        runtime.run()
+        return x_np, runtime.get_output(0).numpy()
+
+    temp = utils.tempdir()
+    cache_dir = temp.relpath("te_compiler_cache")
+    os.mkdir(cache_dir)
+    x_np, out = run(get_mod(2), cache_dir)
+    tvm.testing.assert_allclose(out, np.exp(x_np) + 1.0, rtol=1e-5)
+    assert len(os.listdir(cache_dir)) == 2
+    # Only the function appended to the model is lowered again
+    x_np, out = run(get_mod(3), cache_dir)
+    tvm.testing.assert_allclose(out, np.exp(x_np) + 3.0, rtol=1e-5)
+    assert len(os.listdir(cache_dir)) == 3
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -293,3 +326,4 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_compile_disk_cache()
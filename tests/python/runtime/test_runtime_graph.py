@@ -20,6 +20,7 @@ import tvm.testing
 from tvm import te, runtime
 import numpy as np
 import json
+import pytest
 from tvm import rpc
 from tvm import relay
 from tvm.contrib import utils, graph_executor
@@ -139,6 +140,55 @@ def test_load_unexpected_params():
     rt_mod.load_params(runtime.save_param_dict(new_params))
 
 
+@tvm.testing.requires_llvm
+def test_graph_parallel_branches():
+    x = relay.var("x", shape=(8, 16))
+    branches = [relay.nn.relu(relay.multiply(x, relay.const(float(i + 1)))) for i in range(4)]
+    y = relay.concatenate([relay.add(b, relay.const(1.0)) for b in branches], axis=1)
+    z = relay.add(relay.sum(y, axis=1), relay.sum(branches[0], axis=1))
+    func = relay.Function([x], relay.Tuple([y, z]))
+    graph, lib, _ = relay.build(func, target="llvm")
+
+    a = np.random.uniform(-1, 1, size=(8, 16)).astype("float32")
+    ref = graph_executor.create(graph, lib, tvm.cpu(0))
+    ref.run(x=a)
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod.set_num_branch_workers(4)
+    for _ in range(10):
+        mod.run(x=a)
+        for i in range(2):
+            np.testing.assert_equal(mod.get_output(i).numpy(), ref.get_output(i).numpy())
+
+    mod.set_num_branch_workers(1)
+    mod.run(x=a)
+    np.testing.assert_equal(mod.get_output(0).numpy(), ref.get_output(0).numpy())
+    with pytest.raises(tvm.TVMError):
+        mod.set_num_branch_workers(0)
+
+
+@tvm.testing.requires_llvm
+def test_graph_storage_arena(monkeypatch):
+    x = relay.var("x", shape=(8, 16))
+    y = x
+    for i in range(6):
+        y = relay.nn.relu(relay.add(relay.annotation.stop_fusion(y), relay.const(float(i))))
+    z = relay.concatenate([y, relay.nn.relu(x)], axis=0)
+    func = relay.Function([x], z)
+    graph, lib, _ = relay.build(func, target="llvm")
+
+    a = np.random.uniform(-1, 1, size=(8, 16)).astype("float32")
+    ref = graph_executor.create(graph, lib, tvm.cpu(0))
+    ref.run(x=a)
+    monkeypatch.setenv("TVM_GRAPH_EXECUTOR_STORAGE_ARENA", "1")
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    for _ in range(2):
+        mod.run(x=a)
+        np.testing.assert_equal(mod.get_output(0).numpy(), ref.get_output(0).numpy())
+    # The storages overlapping in the arena are only ordered sequentially
+    with pytest.raises(tvm.TVMError):
+        mod.set_num_branch_workers(2)
+
+
 def test_save_load_file():
     p = np.random.randn(10)
     params = {"x": p}
@@ -93,6 +93,16 @@ def test_graph_simple():
         out = mod.get_output(0, tvm.nd.empty((n,)))
         np.testing.assert_equal(out.numpy(), a + 1)
 
+        # rebind the input and output of the captured graph without capturing it again
+        for i in range(3):
+            a = np.random.uniform(size=(n,)).astype(A.dtype)
+            x = tvm.nd.array(a, dev)
+            y = tvm.nd.empty((n,), A.dtype, dev)
+            mod.set_input_zero_copy(x=x)
+            mod.set_output_zero_copy(0, y)
+            mod.run_cuda_graph()
+            np.testing.assert_equal(y.numpy(), a + 1)
+
     check_verify()
 
 
@@ -17,7 +17,9 @@
 import time
 import ctypes
 
+import numpy as np
 import tvm
+import tvm.testing
 from tvm import te
 from tvm.contrib.utils import tempdir
 from tvm.runtime.module import BenchmarkResult
@@ -66,6 +68,27 @@ def test_benchmark_result():
     assert r.std == 1.5
 
 
+def test_cache_flush_device():
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    func = tvm.build(s, [A, B])
+
+    dev = tvm.cpu()
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+    b = tvm.nd.empty((n,), B.dtype, dev)
+    ftimer = func.time_evaluator(
+        func.entry_name, dev, number=1, repeat=3, f_preproc="cache_flush_device"
+    )
+    assert len(ftimer(a, b).results) == 3
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+
+    tvm.runtime.profiling.flush_device_cache(dev)
+    assert all(isinstance(w, str) for w in tvm.runtime.profiling.check_measurement_env(dev))
+
+
 if __name__ == "__main__":
     test_min_repeat_ms()
     test_benchmark_result()
+    test_cache_flush_device()
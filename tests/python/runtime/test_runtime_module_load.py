@@ -168,6 +168,68 @@ def test_device_module_dump():
         check_stackvm(device)
 
 
+@tvm.testing.requires_llvm
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.module.loadbinary_stackvm", allow_missing=True) is None,
+    reason="StackVM runtime is not enabled",
+)
+@pytest.mark.parametrize("lazy", [True, False])
+def test_lazy_import_loading(lazy, monkeypatch):
+    """Imported modules are deserialized on first use, or eagerly in parallel."""
+    monkeypatch.setenv("TVM_MODULE_LAZY_IMPORT", "1" if lazy else "0")
+    nn = 12
+    A = te.placeholder((nn,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+
+    temp = utils.tempdir()
+    flib = tvm.build(s, [A, B], "llvm", name="myadd_llvm")
+    for i in range(4):
+        flib.import_module(tvm.build(s, [A, B], "stackvm", name=f"myadd_stackvm{i}"))
+    path_dso = temp.relpath("mylib.so")
+    flib.export_library(path_dso)
+
+    m = tvm.runtime.load_module(path_dso)
+    assert [imp.type_key for imp in m.imported_modules] == ["stackvm"] * 4
+    tvm.get_global_func("runtime.ModuleMaterializeLazyImports")(m)
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=nn).astype(A.dtype), dev)
+    for i in range(4):
+        b = tvm.nd.array(np.zeros(nn, dtype=A.dtype), dev)
+        m.get_function(f"myadd_stackvm{i}", query_imports=True)(a, b)
+        np.testing.assert_equal(b.numpy(), a.numpy() + 1)
+
+
+@tvm.testing.requires_llvm
+def test_hot_swap_module_llvm():
+    """Test swapping a rebuilt library in place of the loaded one."""
+    nn = 12
+    A = te.placeholder((nn,), name="A")
+    temp = utils.tempdir()
+    path_dso = temp.relpath("mylib.so")
+
+    def export(value):
+        B = te.compute(A.shape, lambda *i: A(*i) + value, name="B")
+        s = te.create_schedule(B.op)
+        tvm.build(s, [A, B], "llvm", name="myadd").export_library(path_dso)
+
+    export(1.0)
+    mod = tvm.runtime.hot_swap_module(tvm.runtime.load_module(path_dso))
+    fadd = mod["myadd"]
+    a = tvm.nd.array(np.random.uniform(size=nn).astype(A.dtype))
+    b = tvm.nd.array(np.zeros(nn, dtype=A.dtype))
+    fadd(a, b)
+    np.testing.assert_equal(b.numpy(), a.numpy() + 1)
+
+    # Overwrite the library that is in use, then roll it out.
+    export(2.0)
+    assert mod["load_and_swap"](path_dso) == 1
+    assert mod["get_version"]() == 1
+    fadd(a, b)
+    np.testing.assert_equal(b.numpy(), a.numpy() + 2)
+    assert temp.listdir() == ["mylib.so"]
+
+
 @tvm.testing.requires_llvm
 def test_combine_module_llvm():
     """Test combine multiple module into one shared lib."""
@@ -263,5 +263,28 @@ def test_profile_function(target, dev):
     assert report[metric].value > 0
 
 
+@T.prim_func
+def axpy_gpu_f32(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, [1024], "float32")
+    B = T.match_buffer(b, [1024], "float32")
+    C = T.match_buffer(c, [1024], "float32")
+    for bx in T.thread_binding(0, 16, "blockIdx.x"):
+        for tx in T.thread_binding(0, 64, "threadIdx.x"):
+            C[bx * 64 + tx] = A[bx * 64 + tx] + B[bx * 64 + tx]
+
+
+@tvm.testing.requires_vulkan
+def test_vulkan_timer():
+    dev = tvm.vulkan(0)
+    assert tvm.get_global_func("profiling.timer.vulkan", allow_missing=True) is not None
+    f = tvm.build(axpy_gpu_f32, target="vulkan")
+    a = tvm.nd.array(np.ones(1024, "float32"), device=dev)
+    b = tvm.nd.array(np.ones(1024, "float32"), device=dev)
+    c = tvm.nd.array(np.zeros(1024, "float32"), device=dev)
+    result = f.time_evaluator(f.entry_name, dev, number=10, repeat=2)(a, b, c)
+    assert all(t > 0 for t in result.results)
+    tvm.testing.assert_allclose(c.numpy(), np.full(1024, 2, "float32"))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
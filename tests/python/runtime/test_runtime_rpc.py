@@ -181,6 +181,43 @@ def test_rpc_large_array():
     check_remote()
 
 
+@tvm.testing.requires_rpc
+@pytest.mark.parametrize(
+    "block_size, window", [(1 << 30, 1), (1 << 20, 1), (1 << 20, 4), (1000, 3)]
+)
+def test_rpc_pipelined_copy(block_size, window):
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    rpc.set_copy_pipeline(block_size, window)
+    try:
+        dev = remote.cpu(0)
+        a_np = np.random.uniform(size=(1024, 1031)).astype("float32")
+        a = tvm.nd.array(a_np, dev)
+        np.testing.assert_equal(a.numpy(), a_np)
+    finally:
+        rpc.set_copy_pipeline()
+
+
+@tvm.testing.requires_rpc
+@pytest.mark.skipif(
+    not tvm.get_global_func("rpc.CompressionSupported")("zlib"),
+    reason="RPC compression is not enabled",
+)
+def test_rpc_compressed_channel():
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port, compress=True)
+    dev = remote.cpu(0)
+    # Compressible and incompressible payloads.
+    for a_np in [
+        np.zeros((1024, 1024), dtype="float32"),
+        np.random.uniform(size=(512, 1031)).astype("float32"),
+    ]:
+        a = tvm.nd.array(a_np, dev)
+        np.testing.assert_equal(a.numpy(), a_np)
+    fecho = remote.get_function("testing.echo")
+    assert fecho("hello") == "hello"
+
+
 @tvm.testing.skip_if_32bit(reason="skipping test for i386.")
 @tvm.testing.requires_rpc
 def test_rpc_echo():
@@ -370,6 +407,44 @@ def test_rpc_remote_module():
     check_minrpc()
 
 
+@tvm.testing.requires_rpc
+@tvm.testing.requires_llvm
+def test_rpc_batch_time_evaluator():
+    def add_const(value):
+        A = te.placeholder((1024,), name="A")
+        B = te.compute(A.shape, lambda i: A[i] + value, name="B")
+        return te.create_prim_func([A, B])
+
+    mod = tvm.IRModule(
+        {
+            "add_one": add_const(1.0).with_attr("global_symbol", "add_one"),
+            "add_two": add_const(2.0).with_attr("global_symbol", "add_two"),
+        }
+    )
+    lib = tvm.build(mod, target="llvm")
+    temp = utils.tempdir()
+    path_dso = temp.relpath("batch_lib.so")
+    lib.export_library(path_dso)
+
+    server = rpc.Server(key="x1")
+    remote = rpc.connect("127.0.0.1", server.port, key="x1")
+    remote.upload(path_dso)
+    rlib = remote.load_module("batch_lib.so")
+    args = [("float32", (1024,)), ("float32", (1024,))]
+    feval = rlib.batch_time_evaluator(
+        [("add_one", args), ("add_two", args), ("missing", args)],
+        remote.cpu(0),
+        number=2,
+        repeat=3,
+    )
+    results = feval()
+    assert len(results) == 3
+    for result in results[:2]:
+        assert len(result.results) == 3
+        assert result.mean > 0
+    assert isinstance(results[2], str) and "missing" in results[2]
+
+
 @tvm.testing.requires_rpc
 def test_rpc_return_func():
     server = rpc.Server(key="x1")
@@ -176,6 +176,8 @@ def test_target_llvm_jit_options():
     assert target.attrs["jit"] == "mcjit"
     target = tvm.target.Target("llvm -jit=orcjit")
     assert target.attrs["jit"] == "orcjit"
+    target = tvm.target.Target("llvm -jit=orcjit-lazy")
+    assert target.attrs["jit"] == "orcjit-lazy"
 
 
 def test_target_create():
@@ -559,5 +561,16 @@ def test_target_from_device_opencl(input_device):
     assert target.thread_warp_size == dev.warp_size
 
 
+def test_wasm_target_simd128():
+    target = Target("llvm -mtriple=wasm32-unknown-unknown-wasm")
+    assert list(target.attrs["mattr"]) == ["+simd128"]
+
+    target = Target("llvm -mtriple=wasm32-unknown-unknown-wasm -mattr=+bulk-memory")
+    assert list(target.attrs["mattr"]) == ["+bulk-memory", "+simd128"]
+
+    target = Target("llvm -mtriple=wasm32-unknown-unknown-wasm -mattr=-simd128")
+    assert list(target.attrs["mattr"]) == ["-simd128"]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,62 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _degrees(func):
+    result = tvm.tir.analysis.detect_shared_memory_bank_conflicts(func)
+    return {var.name: degree for var, degree in result.items()}
+
+
+def test_scheduled_transpose():
+    @T.prim_func
+    def func(A: T.Buffer((64, 64), "float16"), B: T.Buffer((64, 64), "float16")):
+        for tx in T.thread_binding(32, thread="threadIdx.x"):
+            with T.block("root"):
+                A_shared = T.alloc_buffer((64, 64), "float16", scope="shared")
+                for i in range(64):
+                    with T.block("load"):
+                        vi, vj = T.axis.remap("SS", [i, tx])
+                        A_shared[vi, vj * 2] = A[vi, vj * 2]
+                for j in range(64):
+                    with T.block("store"):
+                        vi, vj = T.axis.remap("SS", [tx, j])
+                        B[vj, vi * 2] = A_shared[vi * 2, vj]
+
+    # Two float16 share a word, so the loads of the rows 0, 2, ..., 62 hit 32 words of a bank
+    assert _degrees(func) == {"A_shared": 32}
+
+
+def test_broadcast_and_opaque_access():
+    @T.prim_func
+    def func(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        tx = T.launch_thread("threadIdx.x", 32)
+        A_shared = T.decl_buffer((32, 32), "float32", scope="shared")
+        B_shared = T.decl_buffer((32, 32), "float32", scope="shared")
+        A_shared[0, tx] = A[0, tx]
+        B_shared[0, tx] = A_shared[0, 0]
+        T.evaluate(T.address_of(B_shared[0, 0]))
+        B[0, tx] = B_shared[0, tx]
+
+    # The lanes reading the same word are served by a broadcast, B_shared is used by a pointer
+    assert _degrees(func) == {"A_shared": 1}
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
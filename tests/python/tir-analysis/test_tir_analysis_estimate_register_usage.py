@@ -0,0 +1,70 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _make_kernel(unroll: bool):
+    loop = T.unroll if unroll else T.serial
+
+    @T.prim_func
+    def func(A: T.Buffer((4096,), "float32"), B: T.Buffer((4096,), "float32")):
+        threadIdx_x = T.launch_thread("threadIdx.x", 64)
+        acc_data = T.allocate([64], "float32", "local")
+        acc = T.Buffer(64, data=acc_data, scope="local")
+        for i in loop(64):
+            acc[i] = A[threadIdx_x * 64 + i]
+        for i in range(64):
+            B[threadIdx_x * 64 + i] = acc[i] * T.float32(2)
+
+    return func
+
+
+def test_local_buffer():
+    # 16 base registers, 64 for the local buffer and one for the loaded value
+    assert tvm.tir.analysis.estimate_register_usage(_make_kernel(unroll=False)) == 81
+
+
+def test_unrolled_loads():
+    # The loads of the 64 unrolled iterations are live together
+    assert tvm.tir.analysis.estimate_register_usage(_make_kernel(unroll=True)) == 144
+
+
+def test_warp_fragment():
+    @T.prim_func
+    def func(A: T.Buffer((256,), "float16")):
+        threadIdx_x = T.launch_thread("threadIdx.x", 32)
+        frag_data = T.allocate([256], "float16", "wmma.matrix_a")
+        frag = T.Buffer(256, "float16", data=frag_data, scope="wmma.matrix_a")
+        frag[threadIdx_x] = A[threadIdx_x]
+
+    # 256 halves shared out among the 32 threads of a warp take 4 registers each
+    assert tvm.tir.analysis.estimate_register_usage(func) == 21
+
+
+def test_verify_gpu_code_registers():
+    func = _make_kernel(unroll=True)
+    verify = tvm.tir.analysis.verify_gpu_code
+    assert verify(func, {"max_registers_per_thread": 255})
+    assert not verify(func, {"max_registers_per_thread": 128})
+    assert verify(func, {"max_registers_per_block": 64 * 144})
+    assert not verify(func, {"max_registers_per_block": 64 * 144 - 1})
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
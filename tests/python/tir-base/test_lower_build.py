@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import os
+
 import numpy as np
 
 import tvm
@@ -22,6 +24,7 @@ from tvm import te
 from tvm.ir.module import IRModule
 from tvm.script import tir as T
 import tvm.testing
+import tvm.contrib.utils
 
 
 def _check_module_with_numpy(mod, shape=(128, 128, 128)):
@@ -143,8 +146,32 @@ def test_lower_build_lowered_module():
     _check_module_with_numpy(mod)
 
 
+def test_build_cache():
+    temp = tvm.contrib.utils.tempdir()
+    cache_dir = temp.relpath("build_cache")
+    os.mkdir(cache_dir)
+    with tvm.transform.PassContext(config={"tir.build_cache_dir": cache_dir}):
+        mod = tvm.build(LoweredTIRModule, target="llvm")
+        assert len(os.listdir(cache_dir)) == 1
+        # An identical build is restored from the cache
+        cached = tvm.build(LoweredTIRModule, target="llvm")
+        assert len(os.listdir(cache_dir)) == 1
+        _check_module_with_numpy(mod)
+        _check_module_with_numpy(cached)
+        # A different pass config misses the cache
+        with tvm.transform.PassContext(
+            config={"tir.build_cache_dir": cache_dir, "tir.disable_vectorize": True}
+        ):
+            tvm.build(LoweredTIRModule, target="llvm")
+        assert len(os.listdir(cache_dir)) == 2
+        # The restored module can still be exported
+        cached.export_library(temp.relpath("cached.so"))
+        _check_module_with_numpy(tvm.runtime.load_module(temp.relpath("cached.so")))
+
+
 if __name__ == "__main__":
     test_lower_build_te_schedule()
     test_lower_build_tir_func()
     test_lower_build_tir_module()
     test_lower_build_lowered_module()
+    test_build_cache()
@@ -969,6 +969,91 @@ def test_gemm_mma_m16n8k32_row_col_s8s8s32():
     tvm.testing.assert_allclose(golden, C_numpy, atol=1e-3, rtol=1e-3)
 
 
+def get_gemm_mma_m16n8k32_row_col_fp8fp8fp32(dtype):
+    abbrv = dtype.split("_")[0]
+
+    @T.prim_func
+    def gemm_mma_m16n8k32_row_col_fp8fp8fp32(a: T.handle, b: T.handle, c: T.handle):
+        T.func_attr({"global_symbol": "default_function", "tir.noalias": True})
+        A = T.match_buffer(a, [16, 32], dtype=dtype)
+        B = T.match_buffer(b, [8, 32], dtype=dtype)
+        C = T.match_buffer(c, [16, 8], dtype="float32")
+        brow = T.env_thread("blockIdx.y")
+        bcol = T.env_thread("blockIdx.x")
+        tx = T.env_thread("threadIdx.x")
+        T.launch_thread(brow, 1)
+        T.launch_thread(bcol, 1)
+        T.launch_thread(tx, 32)
+        MultiA = T.decl_buffer([16], dtype, scope="local")
+        MultiB = T.decl_buffer([8], dtype, scope="local")
+        Accum = T.decl_buffer([4], "float32", scope="local")
+        for i in range(4):
+            Accum[i] = T.float32(0)
+
+        for mma_multi_a_col in range(16):
+            MultiA[mma_multi_a_col] = A[
+                (tx % 32) // 4 + mma_multi_a_col % 8 // 4 * 8,
+                (tx % 32) % 4 * 4 + mma_multi_a_col % 4 + mma_multi_a_col // 8 * 16,
+            ]
+        for mma_multi_b_col in range(8):
+            MultiB[mma_multi_b_col] = B[
+                (tx % 32) // 4,
+                (tx % 32) % 4 * 4 + mma_multi_b_col % 4 + mma_multi_b_col // 4 * 16,
+            ]
+        T.evaluate(
+            T.ptx_mma(
+                "m16n8k32",
+                "row",
+                "col",
+                abbrv,
+                abbrv,
+                "fp32",
+                MultiA.data,
+                0,
+                MultiB.data,
+                0,
+                Accum.data,
+                0,
+                False,
+                dtype="float32",
+            )
+        )
+        for mma_accum_c_id in range(4):
+            C[
+                (tx % 32) // 4 + mma_accum_c_id // 2 * 8,
+                (tx % 32) % 4 * 2 + mma_accum_c_id % 2,
+            ] = Accum[mma_accum_c_id]
+
+    return gemm_mma_m16n8k32_row_col_fp8fp8fp32
+
+
+@pytest.mark.parametrize(
+    "dtype, numpy_dtype", [("e4m3_float8", "float8_e4m3fn"), ("e5m2_float8", "float8_e5m2")]
+)
+@tvm.testing.requires_cuda_compute_version(8, 9)
+def test_gemm_mma_m16n8k32_row_col_fp8fp8fp32(dtype, numpy_dtype):
+    pytest.importorskip("ml_dtypes")
+    sch = tvm.tir.Schedule(get_gemm_mma_m16n8k32_row_col_fp8fp8fp32(dtype))
+    cuda_mod = tvm.build(sch.mod, target="cuda")
+
+    A_np = np.random.uniform(-1, 1, [16, 32]).astype(numpy_dtype)
+    B_np = np.random.uniform(-1, 1, [8, 32]).astype(numpy_dtype)
+    C_np = np.zeros([16, 8]).astype("float32")
+
+    ctx = tvm.cuda()
+    A_tvm = tvm.nd.array(A_np, ctx)
+    B_tvm = tvm.nd.array(B_np, ctx)
+    C_tvm = tvm.nd.array(C_np, ctx)
+
+    cuda_mod(A_tvm, B_tvm, C_tvm)
+
+    golden = np.matmul(A_np.astype("float32"), B_np.astype("float32").T)
+
+    C_numpy = C_tvm.numpy()
+
+    tvm.testing.assert_allclose(golden, C_numpy, atol=1e-3, rtol=1e-3)
+
+
 @T.prim_func
 def gemm_mma_m16n8k32_row_col_s8u8s32(a: T.handle, b: T.handle, c: T.handle):
     T.func_attr({"global_symbol": "default_function", "tir.noalias": True})
@@ -419,5 +419,32 @@ def test_ir_module_equal():
     assert '<root>.functions[I.GlobalVar("func")].body.extent.value' in err.value.args[0]
 
 
+def test_ir_module_parallel_structural_equal_hash():
+    def generate(n: int, num_funcs: int = 32):
+        @T.prim_func
+        def func(A: T.Buffer(1, "int32")):
+            for i in range(n):
+                A[0] = A[0] + 1
+
+        return tvm.IRModule(
+            {f"func{i}": func.with_attr("global_symbol", f"func{i}") for i in range(num_funcs)}
+        )
+
+    phash = tvm.get_global_func("ir.Module_ParallelStructuralHash")
+    pequal = tvm.get_global_func("ir.Module_ParallelStructuralEqual")
+
+    lhs, rhs = generate(16), generate(16)
+    for num_threads in [-1, 1, 4]:
+        assert phash(lhs, num_threads) == phash(rhs, num_threads)
+        assert pequal(lhs, rhs, num_threads)
+        # The result is deterministic regardless of the number of threads.
+        assert phash(lhs, num_threads) == phash(lhs, 1)
+
+    other = generate(32)
+    assert phash(lhs, -1) != phash(other, -1)
+    assert not pequal(lhs, other, -1)
+    assert not pequal(lhs, generate(16, num_funcs=31), -1)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -1529,5 +1529,71 @@ def test_reverse_compute_inline_slicing_then_cachewrite():
     assert_structural_equal_ignore_global_symbol(after, sch.mod["main"])
 
 
+@T.prim_func
+def matmul_bias_relu(
+    A: T.Buffer((128, 128), "float32"),
+    B: T.Buffer((128, 128), "float32"),
+    bias: T.Buffer((128,), "float32"),
+    D: T.Buffer((128, 128), "float32"),
+) -> None:
+    C = T.alloc_buffer((128, 128))
+    C_local = T.alloc_buffer((128, 128), scope="local")
+    C_bias = T.alloc_buffer((128, 128))
+    for i, j, k in T.grid(128, 128, 128):
+        with T.block("C_local"):
+            vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+            with T.init():
+                C_local[vi, vj] = T.float32(0)
+            C_local[vi, vj] = C_local[vi, vj] + A[vi, vk] * B[vj, vk]
+    for i, j in T.grid(128, 128):
+        with T.block("C_local_store"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            C[vi, vj] = C_local[vi, vj]
+    for i, j in T.grid(128, 128):
+        with T.block("bias"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            C_bias[vi, vj] = C[vi, vj] + bias[vj]
+    for i, j in T.grid(128, 128):
+        with T.block("relu"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            D[vi, vj] = T.max(C_bias[vi, vj], T.float32(0))
+
+
+@T.prim_func
+def matmul_bias_relu_fused(
+    A: T.Buffer((128, 128), "float32"),
+    B: T.Buffer((128, 128), "float32"),
+    bias: T.Buffer((128,), "float32"),
+    D: T.Buffer((128, 128), "float32"),
+) -> None:
+    C_local = T.alloc_buffer((128, 128), scope="local")
+    for i, j, k in T.grid(128, 128, 128):
+        with T.block("C_local"):
+            vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+            with T.init():
+                C_local[vi, vj] = T.float32(0)
+            C_local[vi, vj] = C_local[vi, vj] + A[vi, vk] * B[vj, vk]
+    for i, j in T.grid(128, 128):
+        with T.block("C_local_store"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            D[vi, vj] = T.max(C_local[vi, vj] + bias[vj], T.float32(0))
+
+
+def test_fuse_epilogue(use_block_name):
+    sch = tir.Schedule(matmul_bias_relu, debug_mask="all")
+    block = "C_local_store" if use_block_name else sch.get_block("C_local_store")
+    sch.fuse_epilogue(block)
+    assert_structural_equal_ignore_global_symbol(matmul_bias_relu_fused, sch.mod["main"])
+    verify_trace_roundtrip(sch=sch, mod=matmul_bias_relu)
+
+
+def test_fuse_epilogue_multiple_consumers():
+    sch = tir.Schedule(elementwise_multi_producer_consumer, debug_mask="all")
+    sch.fuse_epilogue(sch.get_block("B"))
+    assert_structural_equal_ignore_global_symbol(
+        elementwise_multi_producer_consumer, sch.mod["main"]
+    )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
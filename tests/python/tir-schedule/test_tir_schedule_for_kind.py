@@ -594,6 +594,16 @@ def test_bind_not_cross_thread_reduction():
         s.bind(k, "blockIdx.x")
 
 
+def test_bind_cluster_reduction():
+    s = tir.Schedule(rowsum, debug_mask="all")
+    _, k = s.get_loops(s.get_block("B"))
+    ko, ki = s.split(k, factors=[4, 32])
+    s.bind(ko, "blockIdx.x")
+    s.bind(ki, "threadIdx.x")
+    assert s.get(ko).thread_binding.thread_tag == "blockIdx.x"
+    verify_trace_roundtrip(s, mod=rowsum)
+
+
 def test_bind_after_bind():
     s = tir.Schedule(element_wise, debug_mask="all")
     i, _ = s.get_loops(s.get_block("B"))
@@ -736,6 +736,25 @@ def test_subblock():
     # pylint: enable=protected-access
 
 
+def test_subblock_after_scope_update():
+    sch = tir.Schedule(elementwise_subblock, debug_mask="all")
+    _, j = sch.get_loops(sch.get_block("C"))
+    sch.blockize(j)
+    s = sch.state
+    # pylint: disable=protected-access
+    assert s._get_cached_flags(_get_block(s, "B_sub")) == CachedFlags(
+        affine_binding=True,
+        region_cover=True,
+        stage_pipeline=True,
+    )
+    assert s._get_cached_flags(_get_block(s, "C")) == CachedFlags(
+        affine_binding=True,
+        region_cover=True,
+        stage_pipeline=True,
+    )
+    # pylint: enable=protected-access
+
+
 def test_subblock_uncovered():
     s = tir.ScheduleState(elementwise_subblock_uncovered, debug_mask="all")
     # pylint: disable=protected-access
@@ -32,9 +32,16 @@ from tvm.tir.tensor_intrin.arm_cpu import (
     DP4A_S8U8S32_INTRIN,
     ARM_DOT_4x4_i8_NEON_INTRIN,
     ARM_DOT_4x4_i8_SDOT_INTRIN,
+    ARM_MMLA_4x4x16_i8_SMMLA_INTRIN,
+    ARM_MMLA_4x4x16_u8i8_USMMLA_INTRIN,
+    ARM_MMLA_4x4x8_bf16_BFMMLA_INTRIN,
 )
 from tvm.tir.tensor_intrin.rocm import AMDGPU_SDOT4_INTRIN
-from tvm.tir.tensor_intrin.x86 import VNNI_DOT_16x4_INTRIN, AVX512_DOT_16x4_INTRIN
+from tvm.tir.tensor_intrin.x86 import (
+    AMX_DOT_32x32x128_INTRIN,
+    AVX512_DOT_16x4_INTRIN,
+    VNNI_DOT_16x4_INTRIN,
+)
 from tvm.tir.tensor_intrin.hexagon import VRMPY_u8u8i32_INTRIN, VDMPY_i16i16i32_INTRIN
 
 # fmt: off
@@ -629,6 +636,27 @@ def test_tensorize_avx512():
     tensorize_16x4_test(AVX512_DOT_16x4_INTRIN)
 
 
+def test_tensorize_amx():
+    m, n, k = 128, 128, 256
+
+    func = get_matmul_packed(m, n, k, "uint8")
+
+    sch = tir.Schedule(func, debug_mask="all")
+    block = sch.get_block("compute")
+    sch.transform_layout(block, "W", lambda i, j: [i//16, j//4, i%16, j%4])
+    i, j, k = sch.get_loops(block)
+
+    io, ii = sch.split(i, factors=[None, 32])
+    jo, ji = sch.split(j, factors=[None, 32])
+    ko, ki = sch.split(k, factors=[None, 128])
+    sch.reorder(io, jo, ko, ii, ji, ki)
+
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ii, AMX_DOT_32x32x128_INTRIN)
+
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+
 def test_tensorize_arm_dot():
     m, n, k = 128, 128, 128
 
@@ -650,6 +678,38 @@ def test_tensorize_arm_dot():
         verify_trace_roundtrip(sch=sch, mod=func)
 
 
+def test_tensorize_arm_mmla():
+    def _test_intrin(lhs_dtype, rhs_dtype, out_dtype, k_tile, intrin):
+        m, n, k = 128, 128, 128
+        X = te.placeholder((m, k), name="X", dtype=lhs_dtype)
+        W = te.placeholder((n, k), name="W", dtype=rhs_dtype)
+        ak = te.reduce_axis((0, k), name="k")
+        matmul = te.compute(
+            (m, n),
+            lambda i, j: te.sum(X[i, ak].astype(out_dtype) * W[j, ak].astype(out_dtype), axis=ak),
+            name="compute",
+        )
+        func = te.create_prim_func([X, W, matmul])
+
+        sch = tir.Schedule(func, debug_mask="all")
+        block = sch.get_block("compute")
+        i, j, k = sch.get_loops(block)
+
+        io, ii = sch.split(i, factors=[None, 4])
+        jo, ji = sch.split(j, factors=[None, 4])
+        ko, ki = sch.split(k, factors=[None, k_tile])
+        sch.reorder(io, jo, ko, ii, ji, ki)
+
+        sch.decompose_reduction(block, ko)
+        sch.tensorize(ii, intrin)
+
+        verify_trace_roundtrip(sch=sch, mod=func)
+
+    _test_intrin("int8", "int8", "int32", 16, ARM_MMLA_4x4x16_i8_SMMLA_INTRIN)
+    _test_intrin("uint8", "int8", "int32", 16, ARM_MMLA_4x4x16_u8i8_USMMLA_INTRIN)
+    _test_intrin("bfloat16", "bfloat16", "float32", 8, ARM_MMLA_4x4x8_bf16_BFMMLA_INTRIN)
+
+
 def test_tensorize_vrmpy():
     m, n, k = 128, 128, 128
 
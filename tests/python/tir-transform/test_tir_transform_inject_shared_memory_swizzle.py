@@ -0,0 +1,112 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+class BaseCompare(tvm.testing.CompareBeforeAfter):
+    transform = tvm.transform.Sequential(
+        [
+            tvm.tir.transform.InjectSharedMemorySwizzle(),
+            tvm.tir.transform.Simplify(),
+        ]
+    )
+
+
+class TestTranspose(BaseCompare):
+    """The columns read by the lanes of a warp are swizzled across the banks"""
+
+    def before(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        tx = T.launch_thread("threadIdx.x", 32)
+        ty = T.launch_thread("threadIdx.y", 8)
+        A_shared = T.decl_buffer((32, 32), "float32", scope="shared")
+        for i in range(4):
+            A_shared[ty * 4 + i, tx] = A[ty * 4 + i, tx]
+        T.tvm_storage_sync("shared")
+        for i in range(4):
+            B[ty * 4 + i, tx] = A_shared[tx, ty * 4 + i]
+
+    def expected(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        tx = T.launch_thread("threadIdx.x", 32)
+        ty = T.launch_thread("threadIdx.y", 8)
+        A_shared = T.decl_buffer((32, 32), "float32", scope="shared")
+        for i in range(4):
+            A_shared[ty * 4 + i, T.bitwise_xor(tx, ty * 4 + i)] = A[ty * 4 + i, tx]
+        T.tvm_storage_sync("shared")
+        for i in range(4):
+            B[ty * 4 + i, tx] = A_shared[tx, T.bitwise_xor(ty * 4 + i, tx)]
+
+
+class TestConflictFree(BaseCompare):
+    """The buffers accessed without conflicts keep their layout"""
+
+    def before(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        tx = T.launch_thread("threadIdx.x", 32)
+        ty = T.launch_thread("threadIdx.y", 8)
+        A_shared = T.decl_buffer((32, 32), "float32", scope="shared")
+        for i in range(4):
+            A_shared[ty * 4 + i, tx] = A[ty * 4 + i, tx]
+        T.tvm_storage_sync("shared")
+        for i in range(4):
+            B[ty * 4 + i, tx] = A_shared[ty * 4 + i, tx] * T.float32(2)
+
+    expected = before
+
+
+class TestVectorizedAccess(BaseCompare):
+    """The buffers accessed in vectorized loops are left out"""
+
+    def before(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        tx = T.launch_thread("threadIdx.x", 32)
+        A_shared = T.decl_buffer((32, 32), "float32", scope="shared")
+        for i in T.vectorized(4):
+            A_shared[tx, i] = A[tx, i]
+        T.tvm_storage_sync("shared")
+        for i in range(4):
+            B[i, tx] = A_shared[tx, i]
+
+    expected = before
+
+
+def test_padding():
+    """The rows whose number of banks is not a power of two are padded"""
+
+    @T.prim_func
+    def func(A: T.Buffer((32, 24), "float32"), B: T.Buffer((24, 32), "float32")):
+        tx = T.launch_thread("threadIdx.x", 32)
+        A_shared = T.decl_buffer((32, 24), "float32", scope="shared")
+        for j in range(24):
+            A_shared[tx, j] = A[tx, j]
+        T.tvm_storage_sync("shared")
+        for j in range(24):
+            B[j, tx] = A_shared[tx, j]
+
+    before = tvm.tir.analysis.detect_shared_memory_bank_conflicts(func)
+    assert [degree for _, degree in before.items()] == [8]
+
+    after = tvm.tir.transform.InjectSharedMemorySwizzle()(tvm.IRModule.from_expr(func))["main"]
+    alloc = after.body.body
+    assert isinstance(alloc, tvm.tir.Allocate)
+    assert [int(extent) for extent in alloc.extents] == [32, 25]
+    assert [int(stride) for stride in alloc.body.buffer.strides] == [25, 1]
+
+    flattened = tvm.tir.transform.FlattenBuffer()(tvm.IRModule.from_expr(after))["main"]
+    assert [int(extent) for extent in flattened.body.body.extents] == [800]
+
+if __name__ == "__main__":
+    tvm.testing.main()
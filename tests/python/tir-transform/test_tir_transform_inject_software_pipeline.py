@@ -1229,6 +1229,20 @@ def test_simple_compute_async():
 
     tvm.ir.assert_structural_equal(mod["main"], ref.with_attr("global_symbol", "main"), True)
 
+
+def test_simple_compute_async_cpu():
+    func = gen_simple_compute(1).with_attr(
+        {"global_symbol": "main", "target": tvm.target.Target("llvm")}
+    )
+    sch = tvm.tir.Schedule(tvm.IRModule.from_expr(func))
+    _, loop = sch.get_loops(sch.get_block("compute"))
+    sch.annotate(loop, ann_key="software_pipeline_async_stages", ann_val=[0])
+    mod = tvm.tir.transform.InjectSoftwarePipeline()(sch.mod)
+
+    # CPUs have no asynchronous copies, so the pipeline is the synchronous one
+    ref = tvm.tir.transform.InjectSoftwarePipeline()(tvm.IRModule.from_expr(func))
+    tvm.ir.assert_structural_equal(mod["main"], ref["main"], True)
+
     mod = tvm.IRModule.from_expr(gen_simple_compute(3).with_attr("global_symbol", "main"))
     sch = tvm.tir.Schedule(mod)
 
@@ -0,0 +1,108 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _collect_prefetches(func):
+    prefetches = []
+
+    def fvisit(node):
+        if isinstance(node, tvm.tir.Call) and node.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            load = node.args[0].args[0]
+            prefetches.append((load.buffer.name, load.indices[0], int(node.args[1])))
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return prefetches
+
+
+def _inject(func, distance=None):
+    config = {} if distance is None else {"tir.software_prefetch_distance": distance}
+    with tvm.transform.PassContext(config=config):
+        return tvm.tir.transform.InjectSoftwarePrefetch()(tvm.IRModule.from_expr(func))["main"]
+
+
+def test_prefetch_streams():
+    @T.prim_func
+    def func(A: T.Buffer((2048,), "float32"), B: T.Buffer((1024,), "float32")):
+        T.func_attr({"global_symbol": "main", "target": T.target("llvm")})
+        for i in range(1024):
+            B[i] = A[i * 2] + A[i * 2 + 1]
+
+    after = _inject(func, distance=64)
+    i = after.body.loop_var
+    prefetches = _collect_prefetches(after)
+    # The two loads from A share a cache line, so a single prefetch covers them
+    assert len(prefetches) == 2
+    assert prefetches[0][0] == "A" and prefetches[0][2] == 0
+    tvm.ir.assert_structural_equal(prefetches[0][1], i * 2 + 16)
+    assert prefetches[1][0] == "B" and prefetches[1][2] == 1
+    tvm.ir.assert_structural_equal(prefetches[1][1], i + 16)
+
+
+def test_prefetch_only_innermost_linear_accesses():
+    @T.prim_func
+    def func(
+        A: T.Buffer((1024 * 1024,), "float32"),
+        B: T.Buffer((1024,), "float32"),
+        C: T.Buffer((1024,), "float32"),
+        Idx: T.Buffer((1024,), "int32"),
+    ):
+        T.func_attr({"global_symbol": "main", "target": T.target("llvm")})
+        for i in range(1024):
+            for k in range(1024):
+                C[i] = C[i] + A[i * 1024 + k] * B[Idx[k]]
+
+    after = _inject(func, distance=256)
+    prefetches = _collect_prefetches(after)
+    # C is invariant in the innermost loop, and B is accessed indirectly
+    assert [(name, rw) for name, _, rw in prefetches] == [("A", 0), ("Idx", 0)]
+
+
+def test_prefetch_pragma_overrides_config():
+    @T.prim_func
+    def func(A: T.Buffer((1024,), "float32"), B: T.Buffer((1024,), "float32")):
+        T.func_attr({"global_symbol": "main", "target": T.target("llvm")})
+        with T.attr(0, "pragma_software_prefetch_distance", 128):
+            for i in range(1024):
+                B[i] = A[i]
+
+    after = _inject(func)
+    assert not isinstance(after.body, tvm.tir.AttrStmt)
+    i = after.body.loop_var
+    prefetches = _collect_prefetches(after)
+    assert len(prefetches) == 2
+    tvm.ir.assert_structural_equal(prefetches[0][1], i + 32)
+
+    after = _inject(func.with_attr("target", tvm.target.Target("cuda")))
+    assert not _collect_prefetches(after)
+
+
+def test_prefetch_disabled_by_default():
+    @T.prim_func
+    def func(A: T.Buffer((1024,), "float32"), B: T.Buffer((1024,), "float32")):
+        T.func_attr({"global_symbol": "main", "target": T.target("llvm")})
+        for i in range(1024):
+            B[i] = A[i]
+
+    after = _inject(func)
+    tvm.ir.assert_structural_equal(after, func)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,123 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _gen_pipeline(num_versions, consumer_writes_staged=False):
+    @T.prim_func
+    def func(A: T.Buffer((1024, 128), "float32"), C: T.Buffer((128,), "float32")):
+        for tx in T.thread_binding(128, thread="threadIdx.x"):
+            for k in T.serial(
+                8,
+                annotations={
+                    "software_pipeline_stage": [0, 1],
+                    "software_pipeline_order": [0, 1],
+                    "software_pipeline_warp_specialize": num_versions,
+                },
+            ):
+                with T.block():
+                    A_shared = T.alloc_buffer((128, 128), "float32", scope="shared")
+                    with T.block():
+                        for i in range(128):
+                            A_shared[i, tx] = A[k * 128 + i, tx]
+                    with T.block():
+                        for i in range(128):
+                            if consumer_writes_staged:
+                                A_shared[tx, i] = T.float32(0)
+                            C[tx] = C[tx] + A_shared[tx, i]
+
+    return func
+
+
+def _collect_calls(func):
+    calls = {}
+
+    def fvisit(node):
+        if isinstance(node, tvm.tir.Call) and isinstance(node.op, tvm.ir.Op):
+            calls.setdefault(node.op.name, []).append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return calls
+
+
+def test_warp_specialization():
+    mod = tvm.IRModule.from_expr(_gen_pipeline(2).with_attr("global_symbol", "main"))
+    func = tvm.tir.transform.InjectWarpSpecialization()(mod)["main"]
+
+    thread_loop = func.body.block.body
+    assert thread_loop.thread_binding.thread_tag == "threadIdx.x"
+    assert thread_loop.extent == 256
+    (staged,) = thread_loop.body.block.alloc_buffers
+    assert [int(dim) for dim in staged.shape] == [2, 128, 128]
+
+    calls = _collect_calls(func)
+    assert [int(call.args[0]) for call in calls["tir.create_barriers"]] == [4]
+    assert [int(call.args[0]) for call in calls["tir.ptx_init_barrier_thread_count"]] == [0, 2, 1, 3]
+    assert all(int(call.args[1]) == 128 for call in calls["tir.ptx_init_barrier_thread_count"])
+    # One wait for each side, the producers releasing the full barriers once their copies land
+    assert len(calls["tir.ptx_wait_barrier"]) == 2
+    assert len(calls["tir.ptx_arrive_barrier"]) == 2
+    assert len(calls["tir.ptx_cp_async_barrier"]) == 1
+
+    # The pipeline annotations are consumed
+    def fcheck(node):
+        if isinstance(node, tvm.tir.For):
+            assert "software_pipeline_stage" not in node.annotations
+            assert "software_pipeline_warp_specialize" not in node.annotations
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, fcheck)
+    tvm.ir.assert_structural_equal(
+        tvm.tir.transform.InjectSoftwarePipeline()(tvm.IRModule.from_expr(func))["main"], func
+    )
+
+
+def test_warp_specialization_consumer_writes_staged_buffer():
+    mod = tvm.IRModule.from_expr(_gen_pipeline(2, consumer_writes_staged=True))
+    with pytest.raises(ValueError):
+        tvm.tir.transform.InjectWarpSpecialization()(mod)
+
+
+def test_warp_specialization_without_threads():
+    @T.prim_func
+    def func(A: T.Buffer((1024,), "float32"), C: T.Buffer((1,), "float32")):
+        for k in T.serial(
+            8,
+            annotations={
+                "software_pipeline_stage": [0, 1],
+                "software_pipeline_order": [0, 1],
+                "software_pipeline_warp_specialize": 2,
+            },
+        ):
+            with T.block():
+                A_shared = T.alloc_buffer((128,), "float32", scope="shared")
+                with T.block():
+                    for i in range(128):
+                        A_shared[i] = A[k * 128 + i]
+                with T.block():
+                    for i in range(128):
+                        C[0] = C[0] + A_shared[i]
+
+    with pytest.raises(ValueError):
+        tvm.tir.transform.InjectWarpSpecialization()(tvm.IRModule.from_expr(func))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,81 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _lower(func):
+    mod = tvm.IRModule.from_expr(func.with_attr("global_symbol", "main"))
+    mod = tvm.get_global_func("tir.transform.LowerAsyncDMA")()(mod)
+    return mod["main"]
+
+
+def _dma_calls(func):
+    calls = []
+
+    def fvisit(node):
+        if isinstance(node, tvm.tir.Call) and node.op.name.startswith("tir.dma_"):
+            calls.append(node.op.name)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return calls
+
+
+def test_contiguous_copy():
+    @T.prim_func
+    def func(A: T.Buffer((128,), "int8"), B: T.Buffer((128,), "int8")):
+        with T.attr(0, "async_commit_queue_scope", 0):
+            with T.attr(0, "async_scope", 1):
+                for i in range(128):
+                    B[i] = A[i]
+        with T.attr(0, "async_wait_queue_scope", 0):
+            with T.attr(0, "async_wait_inflight_count", 0):
+                T.evaluate(0)
+
+    # a single DMA is its own group
+    assert _dma_calls(_lower(func)) == ["tir.dma_copy", "tir.dma_wait"]
+
+
+def test_strided_tile_copy():
+    @T.prim_func
+    def func(A: T.Buffer((8, 64), "int8"), B: T.Buffer((8, 32), "int8")):
+        with T.attr(0, "async_commit_queue_scope", 0):
+            with T.attr(0, "async_scope", 1):
+                for i, j in T.grid(8, 32):
+                    B[i, j] = A[i, j]
+        with T.attr(0, "async_wait_queue_scope", 0):
+            with T.attr(0, "async_wait_inflight_count", 0):
+                T.evaluate(0)
+
+    # one DMA per row, waited on as one group
+    lowered = _lower(func)
+    assert _dma_calls(lowered) == [
+        "tir.dma_start_group",
+        "tir.dma_copy",
+        "tir.dma_end_group",
+        "tir.dma_wait",
+    ]
+    loops = []
+    tvm.tir.stmt_functor.post_order_visit(
+        lowered.body, lambda node: loops.append(node) if isinstance(node, tvm.tir.For) else None
+    )
+    assert len(loops) == 1 and loops[0].extent == 8
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -1018,6 +1018,71 @@ def reduction_loop_bound_to_blockidx(a: T.handle, b: T.handle) -> None:
                 B[vi] = B[vi] + A[vi, vk]
 
 
+@T.prim_func
+def cluster_reduction(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, [128, 128], dtype="float32")
+    B = T.match_buffer(b, [128], dtype="float32")
+    for ko in T.thread_binding(0, 4, thread="blockIdx.x"):
+        for i in T.serial(0, 128):
+            for ki in T.thread_binding(0, 32, thread="threadIdx.x"):
+                with T.block("B"):
+                    vi = T.axis.S(128, i)
+                    vk = T.axis.R(128, ko * 32 + ki)
+                    T.reads([A[vi, vk]])
+                    T.writes([B[vi]])
+                    with T.init():
+                        B[vi] = T.float32(0)
+                    B[vi] = B[vi] + A[vi, vk]
+
+
+@T.prim_func
+def lowered_cluster_reduction(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, [128, 128], dtype="float32")
+    B = T.match_buffer(b, [128], dtype="float32")
+    reduce_temp0 = T.alloc_buffer([1], dtype="float32", strides=[1], scope="local")
+    for ko in T.thread_binding(0, 4, thread="blockIdx.x"):
+        for i in T.serial(0, 128):
+            for ki in T.thread_binding(0, 32, thread="threadIdx.x"):
+                with T.block("B_cross_thread_reduction"):
+                    vi = T.axis.S(128, i)
+                    vk = T.axis.R(128, ko * 32 + ki)
+                    T.reads([A[vi, vk]])
+                    T.writes([reduce_temp0[0]])
+                    T.attr(
+                        T.comm_reducer(lambda x, y: x + y, [T.float32(0)]),
+                        "reduce_scope",
+                        T.reinterpret(T.uint64(0), dtype="handle"),
+                    )
+                    T.evaluate(
+                        T.tvm_thread_allreduce(
+                            T.uint32(1), A[vi, vk], True, reduce_temp0[0], ki, ko, dtype="handle"
+                        )
+                    )
+                with T.block("B_write_back"):
+                    vi = T.axis.S(128, i)
+                    T.where(ki == 0 and ko == 0)
+                    T.reads([reduce_temp0[0]])
+                    T.writes([B[vi]])
+                    B[vi] = reduce_temp0[0]
+
+
+@T.prim_func
+def cluster_reduction_too_large(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, [128, 128], dtype="float32")
+    B = T.match_buffer(b, [128], dtype="float32")
+    for ko in T.thread_binding(0, 16, thread="blockIdx.x"):
+        for i in T.serial(0, 128):
+            for ki in T.thread_binding(0, 8, thread="threadIdx.x"):
+                with T.block("B"):
+                    vi = T.axis.S(128, i)
+                    vk = T.axis.R(128, ko * 8 + ki)
+                    T.reads([A[vi, vk]])
+                    T.writes([B[vi]])
+                    with T.init():
+                        B[vi] = T.float32(0)
+                    B[vi] = B[vi] + A[vi, vk]
+
+
 @T.prim_func
 def different_access_indices(a: T.handle, b: T.handle) -> None:
     A = T.match_buffer(a, [128, 128, 128], dtype="float32")
@@ -1865,6 +1930,14 @@ def test_reduction_loop_bound_to_blockidx():
     _check_fail(reduction_loop_bound_to_blockidx)
 
 
+def test_cluster_reduction():
+    _check(cluster_reduction, lowered_cluster_reduction)
+
+
+def test_cluster_reduction_too_large():
+    _check_fail(cluster_reduction_too_large)
+
+
 def test_different_access_indices():
     _check_fail(different_access_indices)
 
@@ -774,5 +774,64 @@ class TestMetalNoMask(BaseCompare):
             B_1[threadIdx_y] = red_result_1[threadIdx_y]
 
 
+def _cluster_reduction(arch):
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((4, 128), "float32"), B: T.Buffer(1, "float32")):
+        T.func_attr({"target": T.target({"kind": "cuda", "arch": arch, "host": "llvm"})})
+        A_flat = T.Buffer(512, data=A.data)
+        blockIdx_x = T.launch_thread("blockIdx.x", 4)
+        threadIdx_x = T.launch_thread("threadIdx.x", 128)
+
+        reduce_data = T.allocate([1], "float32", "local")
+        reduce = T.Buffer(1, data=reduce_data, scope="local")
+
+        with T.attr(
+            T.comm_reducer(lambda x, y: x + y, [T.float32(0)]),
+            "reduce_scope",
+            T.reinterpret("handle", T.uint64(0)),
+        ):
+            T.tvm_thread_allreduce(
+                T.uint32(1),
+                A_flat[blockIdx_x * 128 + threadIdx_x],
+                T.bool(True),
+                reduce[0],
+                threadIdx_x,
+                blockIdx_x,
+            )
+        if blockIdx_x == 0 and threadIdx_x == 0:
+            B[0] = reduce[0]
+
+    return func
+
+
+class TestClusterReductionRequiresSm90(BaseFailure):
+    """Reduction across blockIdx requires thread block clusters"""
+
+    before = _cluster_reduction("sm_80")
+
+
+def test_cluster_reduction():
+    """The results of the blocks are reduced through distributed shared memory"""
+    mod = tvm.IRModule.from_expr(_cluster_reduction("sm_90"))
+    mod = tvm.tir.transform.LowerThreadAllreduce()(mod)
+
+    cluster_extents = []
+    calls = []
+
+    def visit(node):
+        if isinstance(node, tvm.tir.AttrStmt) and node.attr_key == "cluster_extent":
+            cluster_extents.append((node.node.thread_tag, node.value.value))
+        elif isinstance(node, tvm.tir.Call):
+            calls.append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    assert cluster_extents == [("blockIdx.x", 4)]
+    syncs = [call.args[0].value for call in calls if call.op.name == "tir.tvm_storage_sync"]
+    assert syncs.count("cluster") == 2
+    ranks = [call.args[2].value for call in calls if call.op.name == "tir.ptx_ld_shared_cluster"]
+    assert ranks == [0, 1, 2, 3]
+    assert not any(call.op.name == "tir.tvm_thread_allreduce" for call in calls)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
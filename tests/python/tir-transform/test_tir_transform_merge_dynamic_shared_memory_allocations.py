@@ -544,5 +544,74 @@ class TestAsyncCopy(tvm.testing.CompareBeforeAfter):
         return func
 
 
+class TestReuseWithinLoop(tvm.testing.CompareBeforeAfter):
+    """Buffers of the successive stages of a loop share memory across barriers."""
+
+    transform = tvm.tir.transform.MergeSharedMemoryAllocations()
+
+    def before(self):
+        @T.prim_func
+        def func(A: T.Buffer((512,), "float32"), B: T.Buffer((512,), "float32")):
+            threadIdx_x = T.launch_thread("threadIdx.x", 128)
+            X_data = T.allocate([128], "float32", "shared.dyn")
+            Y_data = T.allocate([128], "float32", "shared.dyn")
+            X = T.decl_buffer([128], data=X_data, scope="shared.dyn")
+            Y = T.decl_buffer([128], data=Y_data, scope="shared.dyn")
+            for k in range(4):
+                X[threadIdx_x] = A[k * 128 + threadIdx_x]
+                T.tvm_storage_sync("shared.dyn")
+                B[k * 128 + threadIdx_x] = X[127 - threadIdx_x]
+                T.tvm_storage_sync("shared.dyn")
+                Y[threadIdx_x] = B[k * 128 + threadIdx_x] * T.float32(2)
+                T.tvm_storage_sync("shared.dyn")
+                B[k * 128 + threadIdx_x] = Y[127 - threadIdx_x]
+                T.tvm_storage_sync("shared.dyn")
+
+        return func
+
+    def expected(self):
+        @T.prim_func
+        def func(A: T.Buffer((512,), "float32"), B: T.Buffer((512,), "float32")):
+            threadIdx_x = T.launch_thread("threadIdx.x", 128)
+            buf_dyn_shmem = T.allocate([512], "uint8", "shared.dyn")
+            X = T.decl_buffer((128,), data=buf_dyn_shmem, scope="shared.dyn")
+            Y = T.decl_buffer((128,), data=buf_dyn_shmem, scope="shared.dyn")
+            for k in range(4):
+                X[threadIdx_x] = A[k * 128 + threadIdx_x]
+                T.tvm_storage_sync("shared.dyn")
+                B[k * 128 + threadIdx_x] = X[127 - threadIdx_x]
+                T.tvm_storage_sync("shared.dyn")
+                Y[threadIdx_x] = B[k * 128 + threadIdx_x] * T.float32(2)
+                T.tvm_storage_sync("shared.dyn")
+                B[k * 128 + threadIdx_x] = Y[127 - threadIdx_x]
+                T.tvm_storage_sync("shared.dyn")
+
+        return func
+
+
+def test_no_reuse_across_pipeline_versions():
+    """A buffer read in the iteration after its write stays live across the loop."""
+
+    @T.prim_func
+    def func(A: T.Buffer((512,), "float32"), B: T.Buffer((512,), "float32")):
+        threadIdx_x = T.launch_thread("threadIdx.x", 128)
+        X_data = T.allocate([256], "float32", "shared.dyn")
+        Y_data = T.allocate([128], "float32", "shared.dyn")
+        X = T.Buffer(256, data=X_data, scope="shared.dyn")
+        Y = T.Buffer(128, data=Y_data, scope="shared.dyn")
+        for k in range(4):
+            X[k % 2 * 128 + threadIdx_x] = A[k * 128 + threadIdx_x]
+            T.tvm_storage_sync("shared.dyn")
+            B[k * 128 + threadIdx_x] = X[(k + 1) % 2 * 128 + threadIdx_x]
+            T.tvm_storage_sync("shared.dyn")
+            Y[threadIdx_x] = B[k * 128 + threadIdx_x] * T.float32(2)
+            T.tvm_storage_sync("shared.dyn")
+            B[k * 128 + threadIdx_x] = Y[127 - threadIdx_x]
+            T.tvm_storage_sync("shared.dyn")
+
+    mod = tvm.tir.transform.MergeSharedMemoryAllocations()(tvm.IRModule.from_expr(func))
+    verify_single_allocation(mod["main"].body, 1536)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -1776,5 +1776,31 @@ class TestNestedIfElimination(BaseBeforeAfter):
             b[i0, j0] = T.if_then_else(i0 == 1 and 6 <= j0, 0, T.max(0, a[i0, j0]))
 
 
+def test_parallel_simplify_matches_serial():
+    """Simplifying the PrimFuncs on several threads gives the serial result"""
+
+    def make_func(n):
+        @T.prim_func
+        def func(A: T.Buffer(n, "int32"), B: T.Buffer(n, "int32")):
+            for i in range(n):
+                if i < n + 1:
+                    B[i] = A[i] * 1 + 0
+
+        return func
+
+    mod = tvm.IRModule(
+        {f"func{n}": make_func(n).with_attr("global_symbol", f"func{n}") for n in range(1, 33)}
+    )
+    assert tvm.tir.transform.Simplify().info.thread_safe
+    seq = tvm.transform.Sequential([tvm.tir.transform.Simplify(), tvm.tir.transform.RemoveNoOp()])
+    expected = seq(mod)
+    with tvm.transform.PassContext(config={"ir.num_function_pass_threads": 4}):
+        after = seq(mod)
+    tvm.ir.assert_structural_equal(after, expected)
+    assert [gv.name_hint for gv in after.get_global_vars()] == [
+        gv.name_hint for gv in expected.get_global_vars()
+    ]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
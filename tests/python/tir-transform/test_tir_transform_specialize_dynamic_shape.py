@@ -0,0 +1,95 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _apply(func):
+    return tvm.tir.transform.SpecializeDynamicShape()(tvm.IRModule.from_expr(func))["main"]
+
+
+def _has_predicate(stmt):
+    found = []
+
+    def fvisit(node):
+        if isinstance(node, tvm.tir.IfThenElse):
+            found.append(node)
+        elif isinstance(node, tvm.tir.Call) and node.op.same_as(tvm.ir.Op.get("tir.if_then_else")):
+            found.append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, fvisit)
+    return len(found) > 0
+
+
+def test_split_loop():
+    @T.prim_func
+    def func(a: T.handle, b: T.handle):
+        n = T.int32()
+        A = T.match_buffer(a, (n,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for io, ii in T.grid((n + 63) // 64, 64):
+            if io * 64 + ii < n:
+                B[io * 64 + ii] = A[io * 64 + ii] * T.float32(2)
+
+    after = _apply(func)
+    n = func.buffer_map[func.params[0]].shape[0]
+    assert isinstance(after.body, tvm.tir.IfThenElse)
+    tvm.ir.assert_structural_equal(after.body.condition, n % 64 == 0)
+    # The fast path iterates over the tiles without predicates
+    fast_path = after.body.then_case
+    assert not _has_predicate(fast_path)
+    analyzer = tvm.arith.Analyzer()
+    tvm.ir.assert_structural_equal(analyzer.simplify(fast_path.extent), n // 64)
+    # The general path is kept as is
+    tvm.ir.assert_structural_equal(after.body.else_case, func.body)
+
+
+def test_padded_load():
+    @T.prim_func
+    def func(a: T.handle, b: T.handle):
+        n = T.int32()
+        m = T.int32()
+        A = T.match_buffer(a, (n, m), "float32")
+        B = T.match_buffer(b, (n, 32), "float32")
+        tx = T.launch_thread("threadIdx.x", 32)
+        for i in range(n):
+            B[i, tx] = T.float32(0)
+            for ko in range((m + 31) // 32):
+                B[i, tx] = B[i, tx] + T.if_then_else(
+                    ko * 32 + tx < m, A[i, ko * 32 + tx], T.float32(0)
+                )
+
+    after = _apply(func)
+    m = func.buffer_map[func.params[0]].shape[1]
+    tvm.ir.assert_structural_equal(after.body.condition, m % 32 == 0)
+    assert not _has_predicate(after.body.then_case)
+    assert _has_predicate(after.body.else_case)
+
+
+def test_static_shape():
+    @T.prim_func
+    def func(A: T.Buffer((100,), "float32"), B: T.Buffer((100,), "float32")):
+        for io, ii in T.grid(2, 64):
+            if io * 64 + ii < 100:
+                B[io * 64 + ii] = A[io * 64 + ii]
+
+    tvm.ir.assert_structural_equal(_apply(func), func)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -688,6 +688,79 @@ def test_vectorize_and_predicate_invalid_conditions():
     tvm.ir.assert_structural_equal(after, expected)
 
 
+def test_vectorize_reduction():
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def main(A: T.Buffer((4, 16), "float32"), B: T.Buffer((4,), "float32")):
+            for i in range(4):
+                for k in T.vectorized(16):
+                    B[i] = T.max(B[i], A[i, k])
+
+    @I.ir_module
+    class After:
+        @T.prim_func
+        def main(A: T.Buffer((4, 16), "float32"), B: T.Buffer((4,), "float32")):
+            for i in range(4):
+                B[i] = T.max(B[i], T.vector_reduce_max("float32", A[i, T.Ramp(0, 1, 16)]))
+
+    with tvm.target.Target(simple_target):
+        mod = tvm.tir.transform.VectorizeLoop()(Before)
+    tvm.ir.assert_structural_equal(mod, After)
+
+
+def test_vectorize_reduction_reading_itself_is_not_reduced():
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def main(A: T.Buffer((16,), "float32"), B: T.Buffer((1,), "float32")):
+            for k in T.vectorized(4):
+                B[0] = B[0] + B[0] * A[k]
+
+    with tvm.target.Target(simple_target):
+        mod = tvm.tir.transform.VectorizeLoop()(Before)
+    assert "vector_reduce" not in mod.script()
+
+
+def test_vectorize_and_predicate_reduction():
+    @T.prim_func
+    def before(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (16,), "float32")
+        B = T.match_buffer(b, (1,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0 in T.serial(T.ceildiv(14, 4)):
+            for i_1 in T.vectorized(4):
+                if i_0 * 4 + i_1 < 14:
+                    B[0] = B[0] + A[i_0 * 4 + i_1]
+
+    @T.prim_func
+    def expected(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (16,), "float32")
+        B = T.match_buffer(b, (1,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": T.bool(True)})
+        for i_0 in range(4):
+            load_a = T.meta_var(
+                A.vload(
+                    [T.Ramp(i_0 * 4, 1, 4)],
+                    predicate=T.get_active_lane_mask("uint1x4", i_0 * 4, 14),
+                )
+            )
+            B[0] = B[0] + T.vector_reduce_add(
+                "float32",
+                T.Select(
+                    T.get_active_lane_mask("uint1x4", i_0 * 4, 14),
+                    load_a,
+                    T.Broadcast(T.float32(0), 4),
+                ),
+            )
+
+    mod = tvm.IRModule.from_expr(before)
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        with tvm.target.Target(simple_target):
+            after = tvm.tir.transform.VectorizeLoop()(mod)["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
 def test_vectorize_with_explicitly_disabled_buffer_level_predication():
     # Since the target has the SVE feature, buffer level predication is enabled
     # by default. However, it has been explicitly disabled by the pass context
@@ -17,6 +17,7 @@
 import sys
 import pytest
 import random
+import time
 import tvm
 import tvm.testing
 from tvm.tir.usmp.utils import BufferInfo
@@ -355,6 +356,58 @@ def test_random_intervals(interval_len=16):
     return run_intervals(intervals)
 
 
+def test_time_limit():
+    """Tests that hill climb keeps searching until the time limit"""
+    random.seed(0)
+    pools = [WorkspacePoolInfo("default", [])]
+    intervals = list(generate_range(16))
+    buffers = [BufferInfo(str(i), size, pools) for i, (_, _, size) in enumerate(intervals)]
+    for i, buf in enumerate(buffers):
+        buf.set_conflicts([buffers[j] for j in range(len(buffers)) if j != i])
+
+    fusmp_algo = tvm.get_global_func("tir.usmp.algo.hill_climb")
+    with tvm.transform.PassContext(config={"tir.usmp.time_limit_ms": 200}):
+        start = time.time()
+        buffer_info_arr = fusmp_algo(buffers, 0)
+        elapsed = time.time() - start
+    assert elapsed >= 0.2
+    _verify_all_conflicts(buffer_info_arr)
+
+
+@pytest.mark.parametrize("interval_len", [4, 6, 8])
+def test_branch_and_bound(interval_len):
+    """Tests that branch and bound never plans more memory than greedy by size"""
+    random.seed(interval_len)
+    intervals = list(generate_range(interval_len))
+    expected_mem = find_maximum_from_intervals(intervals)
+    pools = [WorkspacePoolInfo("default", [])]
+    buffers = _build_interval_buffers(intervals, pools)
+
+    sizes = {}
+    for alg in ["greedy_by_size", "branch_and_bound"]:
+        buffer_info_arr = tvm.get_global_func(f"tir.usmp.algo.{alg}")(buffers, expected_mem)
+        _verify_all_conflicts(buffer_info_arr)
+        sizes[alg] = max(
+            pool_allocation.byte_offset.value + buffer_info.size_bytes.value
+            for buffer_info, pool_allocation in buffer_info_arr.items()
+        )
+    assert expected_mem <= sizes["branch_and_bound"] <= sizes["greedy_by_size"]
+
+
+def _build_interval_buffers(intervals, pools):
+    """Helper to create buffers conflicting when their intervals intersect"""
+    buffers = [BufferInfo(str(i), size, pools) for i, (_, _, size) in enumerate(intervals)]
+    for i, (i_start, i_stop, _) in enumerate(intervals):
+        buffers[i].set_conflicts(
+            [
+                buffers[j]
+                for j, (j_start, j_stop, _) in enumerate(intervals)
+                if i != j and i_start <= j_stop and j_start <= i_stop
+            ]
+        )
+    return buffers
+
+
 def run_intervals(intervals, tolerance=0):
     """Helper to run intervals"""
     expected_mem = find_maximum_from_intervals(intervals)
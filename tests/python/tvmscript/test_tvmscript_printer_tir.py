@@ -250,6 +250,33 @@ for i, j, k in T.grid(128, 128, 128):
     )
 
 
+def test_duplicated_var_names():
+    i = [tir.Var("i", "int32") for _ in range(4)]
+
+    def _loop(var, body):
+        return tir.For(var, 0, 2, tir.ForKind.SERIAL, body)
+
+    obj = _loop(
+        i[0],
+        tir.SeqStmt(
+            [
+                _loop(i[1], _loop(i[2], tir.Evaluate(i[2]))),
+                _loop(i[3], tir.Evaluate(i[3])),
+            ]
+        ),
+    )
+    _assert_print(
+        obj,
+        """
+for i in range(2):
+    for i_1, i_2 in T.grid(2, 2):
+        T.evaluate(i_2)
+    for i_1 in range(2):
+        T.evaluate(i_1)
+""",
+    )
+
+
 def test_let_stmt():
     with IRBuilder() as ib:
         with T.LetStmt(T.float32(10)) as v:
@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""
+Compare two result files of the C++ microbenchmarks (see task_cpp_benchmark.sh)
+and fail on the benchmarks that got slower than the threshold.
+
+    python3 tests/scripts/compare_cpp_benchmarks.py baseline.json current.json
+"""
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_times(path):
+    """Load the time in nanoseconds of each benchmark, preferring the median of the repetitions."""
+    with open(path) as f:
+        results = json.load(f)
+    medians = {}
+    iterations = {}
+    for bench in results["benchmarks"]:
+        if bench.get("error_occurred", False):
+            continue
+        time = bench["real_time"] * TIME_UNITS[bench.get("time_unit", "ns")]
+        name = bench.get("run_name", bench["name"])
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[name] = time
+        else:
+            iterations.setdefault(name, []).append(time)
+    times = {name: sorted(ts)[len(ts) // 2] for name, ts in iterations.items()}
+    times.update(medians)
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline", help="The results of the baseline in JSON")
+    parser.add_argument("current", help="The results to be checked in JSON")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="The relative slowdown reported as a regression, 0.1 by default",
+    )
+    args = parser.parse_args()
+
+    baseline = load_times(args.baseline)
+    current = load_times(args.current)
+    regressions = []
+    print(f"{'benchmark':<60} {'baseline':>12} {'current':>12} {'change':>8}")
+    for name in sorted(current):
+        if name not in baseline:
+            print(f"{name:<60} {'-':>12} {current[name]:>10.1f}ns {'new':>8}")
+            continue
+        change = current[name] / baseline[name] - 1.0
+        mark = ""
+        if change > args.threshold:
+            regressions.append(name)
+            mark = " <- regression"
+        print(
+            f"{name:<60} {baseline[name]:>10.1f}ns {current[name]:>10.1f}ns "
+            f"{change * 100:>+7.1f}%{mark}"
+        )
+    for name in sorted(set(baseline) - set(current)):
+        print(f"{name:<60} {baseline[name]:>10.1f}ns {'-':>12} {'removed':>8}")
+
+    if regressions:
+        print(f"{len(regressions)} benchmarks regressed by more than {args.threshold * 100:.0f}%")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,45 @@
+#!/usr/bin/env bash
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Run the C++ microbenchmarks of the runtime hot paths, and compare them to a
+# baseline when one is given.
+#
+# Usage: task_cpp_benchmark.sh [BUILD_DIR] [BASELINE_JSON]
+#
+# The results are written in the JSON format of Google Benchmark to
+# $BUILD_DIR/cppbench.json, and the extra arguments of cppbench can be passed in
+# CPPBENCH_ARGS, e.g. CPPBENCH_ARGS="--benchmark_filter=PackedFunc".
+
+set -euxo pipefail
+
+BUILD_DIR=${1:-build}
+BASELINE=${2:-}
+
+# to avoid CI thread throttling.
+export TVM_BIND_THREADS=0
+
+"${BUILD_DIR}/cppbench" \
+    --benchmark_repetitions=5 \
+    --benchmark_report_aggregates_only=true \
+    --benchmark_out="${BUILD_DIR}/cppbench.json" \
+    --benchmark_out_format=json \
+    ${CPPBENCH_ARGS:-}
+
+if [ -n "${BASELINE}" ]; then
+    python3 tests/scripts/compare_cpp_benchmarks.py "${BASELINE}" "${BUILD_DIR}/cppbench.json"
+fi
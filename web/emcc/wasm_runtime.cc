@@ -135,21 +135,14 @@ TVM_REGISTER_GLOBAL("testing.object_use_count").set_body([](TVMArgs args, TVMRet
 });
 
 void ArrayDecodeStorage(NDArray cpu_arr, std::string bytes, std::string format, std::string dtype) {
-  if (format == "f32-to-bf16" && dtype == "float32") {
-    std::vector<uint16_t> buffer(bytes.length() / 2);
-    std::memcpy(buffer.data(), bytes.data(), buffer.size() * 2);
-    // decode bf16 to f32
-    const uint16_t* bf16 = reinterpret_cast<const uint16_t*>(buffer.data());
-    uint32_t* data = static_cast<uint32_t*>(cpu_arr->data);
+  if (relax_vm::IsF32EncodedFormat(format) && dtype == "float32") {
     ICHECK(cpu_arr.IsContiguous());
     size_t size = 1;
     for (int i = 0; i < cpu_arr->ndim; ++i) {
       size *= cpu_arr->shape[i];
     }
     ICHECK_EQ(size, bytes.length() / 2);
-    for (size_t i = 0; i < size; ++i) {
-      data[i] = static_cast<uint32_t>(bf16[i]) << 16;
-    }
+    relax_vm::DecodeF32Param(format, bytes.data(), cpu_arr->data, size);
   } else {
     cpu_arr.CopyFromBytes(bytes.data(), bytes.length());
   }
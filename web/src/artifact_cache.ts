@@ -21,7 +21,7 @@ export interface NDArrayCacheEntry {
   name: string;
   shape: Array<number>;
   dtype: string;
-  format: "f32-to-bf16" | "raw";
+  format: "f32-to-bf16" | "f32-to-f16" | "raw";
   byteOffset: number;
   nbytes: number;
 }
@@ -31,6 +31,8 @@ export interface NDArrayShardEntry {
   format: "raw-shard";
   nbytes: number;
   records: Array<NDArrayCacheEntry>;
+  md5sum?: string;
+  sha256?: string;
 }
 
 /**
@@ -67,6 +69,17 @@ export interface ArtifactCacheTemplate {
    */
   addToCache(url: string, storetype?: string, signal?: AbortSignal): Promise<void>;
 
+  /**
+   * Store data fetched by the caller into cache, overwriting the existing data of `url` if any.
+   *
+   * @param url: The url of the data.
+   * @param data: The content of the url.
+   * @param storetype: Only applies to `ArtifactIndexedDBCache`, see `addToCache()`.
+   *
+   * @note This is an async function.
+   */
+  putToCache(url: string, data: ArrayBuffer, storetype?: string): Promise<void>;
+
   /**
    * check if cache has all keys in Cache
    *
@@ -139,6 +152,14 @@ export class ArtifactCache implements ArtifactCacheTemplate {
     }
   }
 
+  // eslint-disable-next-line @typescript-eslint/no-unused-vars
+  async putToCache(url: string, data: ArrayBuffer, storetype?: string) {
+    if (this.cache === undefined) {
+      this.cache = await caches.open(this.scope);
+    }
+    await this.cache.put(new Request(url), new Response(data));
+  }
+
   /**
    * Determine if all keys exist in the cache
    * @param keys the url key list of the strings
@@ -303,6 +324,24 @@ export class ArtifactIndexedDBCache implements ArtifactCacheTemplate {
     }
   }
 
+  async putToCache(url: string, data: ArrayBuffer, storetype?: string): Promise<void> {
+    await this.initDB();
+    let value: any = data;
+    if (storetype != undefined && storetype.toLowerCase() === "json") {
+      value = JSON.parse(new TextDecoder().decode(data));
+    }
+    return new Promise<void>((resolve, reject) => {
+      const transaction = this.db?.transaction(['urls'], 'readwrite');
+      if (transaction === undefined) {
+        return;
+      }
+      const store = transaction.objectStore('urls');
+      const request = store.put({ data: value, url });
+      request.onsuccess = () => resolve();
+      request.onerror = (event) => reject((event.target as IDBRequest).error);
+    });
+  }
+
   async hasAllKeys(keys: string[]): Promise<boolean> {
     await this.initDB(); // Ensure the DB is initialized
     if (!this.db) {
@@ -353,6 +392,89 @@ export class ArtifactIndexedDBCache implements ArtifactCacheTemplate {
 }
 
 
+/**
+ * Fetch the content of `url` as a stream, resuming the download with ranged requests
+ * from the received bytes when it is interrupted.
+ *
+ * @param url The url to fetch.
+ * @param onChunk Callback on each chunk of the content with its offset in the content.
+ * The offset restarts from 0 when the server does not support ranged requests.
+ * @param signal An optional AbortSignal to abort the download.
+ * @param maxRetries The maximum number of times to resume the download.
+ * @returns The total number of bytes of the content.
+ */
+export async function fetchWithResume(
+  url: string,
+  onChunk: (chunk: Uint8Array, offset: number) => Promise<void> | void,
+  signal?: AbortSignal,
+  maxRetries = 3,
+): Promise<number> {
+  let received = 0;
+  let retries = 0;
+  for (;;) {
+    try {
+      const headers: Record<string, string> = {};
+      if (received > 0) {
+        headers["Range"] = "bytes=" + received + "-";
+      }
+      const response = await fetch(url, { headers, signal });
+      if (!response.ok) {
+        throw Error("Network response was not ok, status " + response.status);
+      }
+      if (received > 0 && response.status !== 206) {
+        // The server sends the full content instead of the requested range.
+        received = 0;
+      }
+      if (response.body === null) {
+        const data = new Uint8Array(await response.arrayBuffer());
+        await onChunk(data, received);
+        return received + data.length;
+      }
+      const reader = response.body.getReader();
+      for (;;) {
+        const { done, value } = await reader.read();
+        if (done) {
+          return received;
+        }
+        await onChunk(value, received);
+        received += value.length;
+      }
+    } catch (err) {
+      if ((signal !== undefined && signal.aborted) || retries >= maxRetries) {
+        throw err;
+      }
+      ++retries;
+    }
+  }
+}
+
+/**
+ * Check the content of a shard against its size and digest in `ndarray-cache.json`.
+ * The digest is only checked when it has `sha256`, which is available in WebCrypto.
+ *
+ * @param shard The shard entry.
+ * @param data The content of the shard.
+ * @throws Error if the content does not match.
+ */
+export async function checkShardIntegrity(shard: NDArrayShardEntry, data: Uint8Array) {
+  if (data.length !== shard.nbytes) {
+    throw Error(
+      "Shard " + shard.dataPath + " has " + data.length + " bytes, expected " + shard.nbytes
+    );
+  }
+  if (shard.sha256 === undefined || typeof crypto === "undefined" || !crypto.subtle) {
+    return;
+  }
+  const digest = new Uint8Array(await crypto.subtle.digest("SHA-256", data));
+  let hex = "";
+  for (let i = 0; i < digest.length; ++i) {
+    hex += ("0" + digest[i].toString(16)).slice(-2);
+  }
+  if (hex !== shard.sha256) {
+    throw Error("Shard " + shard.dataPath + " has sha256 " + hex + ", expected " + shard.sha256);
+  }
+}
+
 /**
  * Function to check if NDarray is in Cache or not
  *
@@ -34,5 +34,5 @@ export {
 export { Disposable, LibraryProvider } from "./types";
 export { RPCServer } from "./rpc_server";
 export { assert, wasmPath, LinearCongruentialGenerator } from "./support";
-export { detectGPUDevice, GPUDeviceDetectOutput } from "./webgpu";
+export { detectGPUDevice, GPUDeviceDetectOutput, GPUBufferPoolStats } from "./webgpu";
 export { createPolyfillWASI } from "./compact";
@@ -26,12 +26,15 @@ import { Memory, CachedCallStack } from "./memory";
 import { assert, StringToUint8Array, LinearCongruentialGenerator } from "./support";
 import { Environment } from "./environment";
 import { AsyncifyHandler } from "./asyncify";
-import { FunctionInfo, WebGPUContext } from "./webgpu";
+import { FunctionInfo, GPUBufferPoolStats, WebGPUContext } from "./webgpu";
 import {
   ArtifactCache,
   ArtifactCacheTemplate,
   ArtifactIndexedDBCache,
+  NDArrayCacheEntry,
   NDArrayShardEntry,
+  checkShardIntegrity,
+  fetchWithResume,
 } from "./artifact_cache";
 import * as compact from "./compact";
 import * as ctypes from "./ctypes";
@@ -1136,6 +1139,14 @@ export class Instance implements Disposable {
     }
   }
 
+  /**
+   * Obtain the statistics of the WebGPU buffer pool.
+   * @returns The statistics, undefined if WebGPU is not initialized.
+   */
+  webGPUBufferPoolStats(): GPUBufferPoolStats | undefined {
+    return this.lib.webGPUContext?.bufferPoolStats();
+  }
+
   /**
    * Begin a new scope for tracking object disposal.
    */
@@ -1496,12 +1507,10 @@ export class Instance implements Disposable {
       totalBytes += list[i].nbytes;
     }
     let fetchedBytes = 0;
-    let fetchedShards = 0;
+    let processedShards = 0;
     let timeElapsed = 0;
 
-    const cacheOnly = await artifactCache.hasAllKeys(list.map(key => new URL(key.dataPath, ndarrayCacheUrl).href));
-
-    // `loading`: we have finished downloading (or already cacheOnly) and are loading onto WebGPU
+    // `loading`: the shard is loaded from cache onto WebGPU, rather than downloaded
     const reportCallback = (iter: number, loading = false) => {
       // report
       for (let j = 0; j < this.initProgressCallback.length; ++j) {
@@ -1535,84 +1544,122 @@ export class Instance implements Disposable {
       });
     }
 
-    // First download all shards to cache parallely if not yet in cache
-    const downloadCache = async (start: number, end: number) => {
-      // Download params [start, end) from `list`
-      for (let i = start; i < end; i++) {
-        const shard = list[i];
-        const dataUrl = new URL(shard.dataPath, ndarrayCacheUrl).href;
-        try {
-          await artifactCache.addToCache(dataUrl, "arraybuffer", signal);
-        } catch (err) {
-          this.env.logger("Error: Cannot fetch " + dataUrl + " err= " + err);
-          throw err;
+    // Decode a record into the NDArrayCache on the device.
+    const loadRecord = async (i: number, rec: NDArrayCacheEntry, data: Uint8Array) => {
+      try {
+        const cpu_arr = this.withNewScope(() => {
+          return this.detachFromCurrentScope(
+            this.empty(rec.shape, rec.dtype, this.cpu())
+          )
+        });
+        // first sync copy to cpu.
+        this.ctx.arrayDecodeStorage(cpu_arr, data, rec.format, rec.dtype);
+        // then async stream into GPU if needed
+        if (device.deviceType === DeviceStrToEnum.cpu) {
+          this.ndarrayCacheUpdate(rec.name, cpu_arr, false);
+          cpu_arr.dispose();
+        } else {
+          // allocate a gpu arr and async copy to it.
+          const gpu_arr = this.withNewScope(() => {
+            return this.detachFromCurrentScope(
+              this.empty(rec.shape, rec.dtype, device)
+            )
+          });
+          gpu_arr.copyFrom(cpu_arr);
+          await device.sync();
+          this.ndarrayCacheUpdate(rec.name, gpu_arr, false);
+          cpu_arr.dispose();
+          gpu_arr.dispose();
         }
-        timeElapsed = Math.ceil((perf.now() - tstart) / 1000);
-        fetchedBytes += shard.nbytes;
-        reportCallback(fetchedShards++, /*loading=*/false);
+      } catch (err) {
+        this.env.logger(
+          "Failed to load shard " + i + "'s record: " + JSON.stringify(rec) + "\n" +
+          "Error: " + err
+        );
+        throw err;
       }
-    }
-    // We launch 4 parallel for loops to limit the max concurrency to 4 download
-    if (!cacheOnly) {
-      const loopSize = Math.floor(list.length / 4);
-      await Promise.all([
-        downloadCache(0, loopSize),
-        downloadCache(loopSize, 2 * loopSize),
-        downloadCache(2 * loopSize, 3 * loopSize),
-        downloadCache(3 * loopSize, list.length)
-      ]);
-    }
+    };
 
-    // Then iteratively, load the shard from cache
-    for (let i = 0; i < list.length; ++i) {
-      const shard = list[i];
-      const dataUrl = new URL(shard.dataPath, ndarrayCacheUrl).href;
-      let buffer;
+    // Load a shard in cache.
+    const loadShardFromCache = async (i: number, dataUrl: string) => {
+      let buffer: ArrayBuffer;
       try {
         buffer = await artifactCache.fetchWithCache(dataUrl, "arraybuffer");
       } catch (err) {
         this.env.logger("Error: Cannot fetch " + dataUrl + " err= " + err);
         throw err;
       }
-      const shardRecords = shard.records;
-      for (let j = 0; j < shardRecords.length; ++j) {
+      for (const rec of list[i].records) {
+        await loadRecord(i, rec, new Uint8Array(buffer, rec.byteOffset, rec.nbytes));
+      }
+      fetchedBytes += list[i].nbytes;
+    };
+
+    // Download a shard, and load its records as soon as their bytes arrive. The shard is
+    // put into cache after its content is checked.
+    const streamShard = async (i: number, dataUrl: string) => {
+      const shard = list[i];
+      const shardData = new Uint8Array(shard.nbytes);
+      const records = shard.records.slice().sort((a, b) => a.byteOffset - b.byteOffset);
+      let numLoaded = 0;
+      let shardFetchedBytes = 0;
+      try {
         try {
-          const rec = shardRecords[j];
-          const cpu_arr = this.withNewScope(() => {
-            return this.detachFromCurrentScope(
-              this.empty(rec.shape, rec.dtype, this.cpu())
-            )
-          });
-          const recSource = buffer.slice(rec.byteOffset, rec.byteOffset + rec.nbytes);
-          // first sync copy to cpu.
-          this.ctx.arrayDecodeStorage(cpu_arr, new Uint8Array(recSource), rec.format, rec.dtype);
-          // then async stream into GPU if needed
-          if (device.deviceType === DeviceStrToEnum.cpu) {
-            this.ndarrayCacheUpdate(rec.name, cpu_arr, false);
-            cpu_arr.dispose();
-          } else {
-            // allocate a gpu arr and async copy to it.
-            const gpu_arr = this.withNewScope(() => {
-              return this.detachFromCurrentScope(
-                this.empty(rec.shape, rec.dtype, device)
-              )
-            });
-            gpu_arr.copyFrom(cpu_arr);
-            await device.sync();
-            this.ndarrayCacheUpdate(rec.name, gpu_arr, false);
-            cpu_arr.dispose();
-            gpu_arr.dispose();
-          }
+          await fetchWithResume(dataUrl, async (chunk: Uint8Array, offset: number) => {
+            const end = offset + chunk.length;
+            if (end > shard.nbytes) {
+              throw Error("Shard has more bytes than " + shard.nbytes);
+            }
+            shardData.set(chunk, offset);
+            if (end > shardFetchedBytes) {
+              fetchedBytes += end - shardFetchedBytes;
+              shardFetchedBytes = end;
+            }
+            while (numLoaded < records.length &&
+              records[numLoaded].byteOffset + records[numLoaded].nbytes <= end) {
+              const rec = records[numLoaded];
+              const recData = shardData.subarray(rec.byteOffset, rec.byteOffset + rec.nbytes);
+              await loadRecord(i, rec, recData);
+              ++numLoaded;
+            }
+          }, signal);
         } catch (err) {
-          this.env.logger(
-            "Failed to load shard " + i + "'s record: " + JSON.stringify(shardRecords[j]) + "\n" +
-            "Error: " + err
-          );
+          this.env.logger("Error: Cannot fetch " + dataUrl + " err= " + err);
           throw err;
         }
+        await checkShardIntegrity(shard, shardData.subarray(0, shardFetchedBytes));
+      } catch (err) {
+        // Do not keep the records of a failed shard.
+        for (let j = 0; j < numLoaded; ++j) {
+          this.ndarrayCacheRemove(records[j].name);
+        }
+        throw err;
       }
-      reportCallback(i + 1, /*loading=*/true);
-    }
+      await artifactCache.putToCache(dataUrl, shardData.buffer, "arraybuffer");
+    };
+
+    const processShards = async (start: number, end: number) => {
+      // Process params [start, end) from `list`
+      for (let i = start; i < end; i++) {
+        const dataUrl = new URL(list[i].dataPath, ndarrayCacheUrl).href;
+        const inCache = await artifactCache.hasAllKeys([dataUrl]);
+        if (inCache) {
+          await loadShardFromCache(i, dataUrl);
+        } else {
+          await streamShard(i, dataUrl);
+        }
+        timeElapsed = Math.ceil((perf.now() - tstart) / 1000);
+        reportCallback(++processedShards, /*loading=*/inCache);
+      }
+    };
+    // We launch 4 parallel for loops to limit the max concurrency to 4 download
+    const loopSize = Math.floor(list.length / 4);
+    await Promise.all([
+      processShards(0, loopSize),
+      processShards(loopSize, 2 * loopSize),
+      processShards(2 * loopSize, 3 * loopSize),
+      processShards(3 * loopSize, list.length)
+    ]);
   }
 
   /**
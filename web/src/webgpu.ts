@@ -24,6 +24,20 @@ import { Disposable } from "./types";
 /** A pointer to points to the raw address space. */
 export type GPUPointer = number;
 
+/** Statistics of the WebGPU buffer pool. */
+export interface GPUBufferPoolStats {
+  /** Number of allocations served from the pool. */
+  numHits: number;
+  /** Number of allocations that created a new buffer. */
+  numMisses: number;
+  /** Total bytes of buffers currently held by the runtime. */
+  allocatedBytes: number;
+  /** Bytes of pooled buffers that are free for reuse. */
+  freeBytes: number;
+  /** Number of queue submissions. */
+  numQueueSubmits: number;
+}
+
 export interface GPUDeviceDetectOutput {
   adapter: GPUAdapter;
   adapterInfo: GPUAdapterInfo;
@@ -387,10 +401,25 @@ export class WebGPUContext {
   // internal data
   private bufferTable: Array<GPUBuffer | undefined> = [undefined];
   private bufferTableFreeId: Array<number> = [];
-  private podArgStagingBuffers: Array<GPUBuffer> = [];
   private canvasRenderManager?: CanvasRenderManager = undefined;
-  // number of pod arg staging buffers
-  private maxNumPodArgsStagingBuffers = 2;
+  // free buffers of the pool, keyed by their page-rounded size
+  private bufferPool: Map<number, Array<GPUBuffer>> = new Map();
+  // granularity of the pooled buffer sizes
+  private bufferPoolPageSize = 4096;
+  // command encoder that batches the dispatches until the next flush
+  private pendingEncoder?: GPUCommandEncoder = undefined;
+  // compute pass of the pending encoder
+  private pendingComputePass?: GPUComputePassEncoder = undefined;
+  // number of dispatches recorded in the pending encoder
+  private numPendingDispatches = 0;
+  // maximum number of dispatches batched into one submission
+  private maxNumPendingDispatches = 32;
+  // uniform buffer holding the pod arguments of the pending dispatches
+  private podArgsBuffer?: GPUBuffer = undefined;
+  // host copy of the pod arguments, written to podArgsBuffer on flush
+  private podArgsHostData = new Uint8Array(0);
+  // bytes of podArgsHostData used by the pending dispatches
+  private podArgsOffset = 0;
   // flags for debugging
   // stats of the runtime.
   // peak allocation
@@ -399,8 +428,15 @@ export class WebGPUContext {
   private currAllocatedBytes = 0;
   // all allocation(ignoring free)
   private allAllocatedBytes = 0;
+  // bytes of the free buffers in the pool
+  private pooledBytes = 0;
+  // buffer pool hit and miss counters
+  private bufferPoolHitCounter = 0;
+  private bufferPoolMissCounter = 0;
   // shader submit counter
   private shaderSubmitCounter = 0;
+  // queue submit counter
+  private queueSubmitCounter = 0;
   // limite number of shaders to be submitted, useful for debugging, default to -1
   protected debugShaderSubmitLimit = -1;
   // log and sync each step
@@ -416,13 +452,15 @@ export class WebGPUContext {
    */
   dispose() {
     this.canvasRenderManager?.dispose();
+    this.pendingComputePass = undefined;
+    this.pendingEncoder = undefined;
     this.bufferTableFreeId = [];
     while (this.bufferTable.length != 0) {
       this.bufferTable.pop()?.destroy();
     }
-    while (this.podArgStagingBuffers.length != 0) {
-      this.podArgStagingBuffers.pop()?.destroy();
-    }
+    this.releaseBufferPool();
+    this.podArgsBuffer?.destroy();
+    this.podArgsBuffer = undefined;
     this.device.destroy();
   }
 
@@ -430,16 +468,70 @@ export class WebGPUContext {
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flushCommands();
     await this.device.queue.onSubmittedWorkDone();
   }
 
+  /**
+   * Submit the dispatches batched in the pending command encoder.
+   */
+  flushCommands(): void {
+    if (this.pendingEncoder === undefined) return;
+    this.pendingComputePass?.end();
+    if (this.podArgsOffset != 0) {
+      assert(this.podArgsBuffer !== undefined);
+      this.device.queue.writeBuffer(
+        this.podArgsBuffer, 0, this.podArgsHostData, 0, this.podArgsOffset
+      );
+    }
+    this.device.queue.submit([this.pendingEncoder.finish()]);
+    this.pendingComputePass = undefined;
+    this.pendingEncoder = undefined;
+    this.numPendingDispatches = 0;
+    this.podArgsOffset = 0;
+    this.queueSubmitCounter += 1;
+  }
+
+  /**
+   * Destroy the free buffers held by the buffer pool.
+   */
+  releaseBufferPool(): void {
+    // pooled buffers can still be referenced by the pending dispatches
+    this.flushCommands();
+    for (const buffers of this.bufferPool.values()) {
+      for (const buffer of buffers) {
+        this.currAllocatedBytes -= buffer.size;
+        buffer.destroy();
+      }
+    }
+    this.bufferPool.clear();
+    this.pooledBytes = 0;
+  }
+
+  /**
+   * Obtain the statistics of the buffer pool.
+   */
+  bufferPoolStats(): GPUBufferPoolStats {
+    return {
+      numHits: this.bufferPoolHitCounter,
+      numMisses: this.bufferPoolMissCounter,
+      allocatedBytes: this.currAllocatedBytes,
+      freeBytes: this.pooledBytes,
+      numQueueSubmits: this.queueSubmitCounter,
+    };
+  }
+
   /**
    * Obtain the runtime information in readable format.
    */
   runtimeStatsText(): string {
     let info = "peak-memory=" + Math.ceil(this.peakAllocatedBytes / (1 << 20)) + " MB";
     info += ", all-memory=" + Math.ceil(this.allAllocatedBytes / (1 << 20)) + " MB";
+    info += ", pooled-memory=" + Math.ceil(this.pooledBytes / (1 << 20)) + " MB";
+    info += ", pool-hits=" + this.bufferPoolHitCounter;
+    info += ", pool-misses=" + this.bufferPoolMissCounter;
     info += ", shader-submissions=" + this.shaderSubmitCounter;
+    info += ", queue-submissions=" + this.queueSubmitCounter;
     return info;
   }
 
@@ -453,6 +545,7 @@ export class WebGPUContext {
     if (this.canvasRenderManager == undefined) {
       throw Error("Do not have a canvas context, call bindCanvas first");
     }
+    this.flushCommands();
     this.canvasRenderManager.draw(this.gpuBufferFromPtr(ptr), height, width);
   }
 
@@ -470,7 +563,8 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    // Perhaps it would be more useful to use a staging buffer?
+    // writeBuffer runs ahead of unsubmitted commands, so flush them first.
+    this.flushCommands();
     this.device.queue.writeBuffer(
       this.gpuBufferFromPtr(toPtr),
       toOffset,
@@ -483,6 +577,7 @@ export class WebGPUContext {
    * Clear canvas
    */
   clearCanvas() {
+    this.flushCommands();
     this.canvasRenderManager?.clear();
   }
 
@@ -519,37 +614,54 @@ export class WebGPUContext {
   }
 
   /**
-   * Get the pod arg staging buffer
-   * \param nbytes The minimum size.
-   * \return The allocated buffer
+   * Reserve space for the pod arguments of a dispatch in the pending batch.
+   * Flushes the batch when the pod argument buffer is full.
+   * \param nbytes The number of bytes of the pod arguments.
+   * \return The offset of the arguments in the pod argument buffer.
    */
-  private getPodArgsBuffer(nbytes: number): GPUBuffer {
-    let buffer: GPUBuffer | undefined = undefined;
-    if (this.podArgStagingBuffers.length >= this.maxNumPodArgsStagingBuffers) {
-      buffer = this.podArgStagingBuffers.shift();
+  private reservePodArgs(nbytes: number): number {
+    const alignment = this.device.limits.minUniformBufferOffsetAlignment;
+    const stride = Math.ceil(nbytes / alignment) * alignment;
+    if (this.podArgsOffset + stride > this.podArgsHostData.length) {
+      this.flushCommands();
     }
-    // minimum of 16 bytes
-    let allocSize = 16;
-    if (buffer !== undefined) {
-      allocSize = buffer.size;
-      if (buffer.size < nbytes) {
-        buffer.destroy();
-        buffer = undefined;
-      }
-    }
-    while (allocSize < nbytes) {
-      allocSize *= 2;
-    }
-
-    if (buffer == undefined) {
-      // create uniform buffer
-      buffer = tryCreateBuffer(this.device, {
+    if (stride > this.podArgsHostData.length) {
+      // the previous buffer is only released after the submitted work finishes.
+      this.podArgsBuffer?.destroy();
+      const allocSize = stride * this.maxNumPendingDispatches;
+      this.podArgsBuffer = tryCreateBuffer(this.device, {
         size: allocSize,
         usage: GPUBufferUsage.UNIFORM | GPUBufferUsage.COPY_DST,
       });
+      this.podArgsHostData = new Uint8Array(allocSize);
     }
-    assert(nbytes <= buffer.size);
-    return buffer;
+    const offset = this.podArgsOffset;
+    this.podArgsOffset += stride;
+    return offset;
+  }
+
+  /**
+   * Get the command encoder of the pending batch, ending its compute pass.
+   */
+  private getPendingCommandEncoder(): GPUCommandEncoder {
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
+    }
+    if (this.pendingComputePass !== undefined) {
+      this.pendingComputePass.end();
+      this.pendingComputePass = undefined;
+    }
+    return this.pendingEncoder;
+  }
+
+  /**
+   * Get the compute pass that dispatches of the pending batch are recorded into.
+   */
+  private getPendingComputePass(): GPUComputePassEncoder {
+    if (this.pendingComputePass === undefined) {
+      this.pendingComputePass = this.getPendingCommandEncoder().beginComputePass();
+    }
+    return this.pendingComputePass;
   }
 
   /**
@@ -634,9 +746,6 @@ export class WebGPUContext {
           return;
         }
 
-        const commandEncoder = this.device.createCommandEncoder();
-        const compute = commandEncoder.beginComputePass();
-        compute.setPipeline(pipeline);
         const bindGroupEntries: Array<GPUBindGroupEntry> = [];
         const numBufferOrPodArgs = bufferArgIndices.length + podArgIndices.length;
 
@@ -681,8 +790,6 @@ export class WebGPUContext {
         }
 
         // push pod buffer
-        const sizeOfI32 = 4;
-        const podArgBuffer = this.getPodArgsBuffer((podArgIndices.length + 1) * sizeOfI32);
         const i32View = new Int32Array(podArgIndices.length + 1);
         const u32View = new Uint32Array(i32View.buffer);
         const f32View = new Float32Array(i32View.buffer);
@@ -702,25 +809,32 @@ export class WebGPUContext {
         }
         // always pass in dim z launching grid size in
         u32View[podArgIndices.length] = packDimX;
-        this.device.queue.writeBuffer(podArgBuffer, 0, i32View.buffer);
+        // the pod arguments are uploaded together when the batch is flushed
+        const podArgsOffset = this.reservePodArgs(i32View.byteLength);
+        this.podArgsHostData.set(new Uint8Array(i32View.buffer), podArgsOffset);
+        assert(this.podArgsBuffer !== undefined);
 
         bindGroupEntries.push({
           binding: bufferArgIndices.length,
           resource: {
-            buffer: podArgBuffer,
-            size: i32View.buffer.byteLength
+            buffer: this.podArgsBuffer,
+            offset: podArgsOffset,
+            size: i32View.byteLength
           }
         });
 
+        const compute = this.getPendingComputePass();
+        compute.setPipeline(pipeline);
         compute.setBindGroup(0, this.device.createBindGroup({
           layout: bindGroupLayout,
           entries: bindGroupEntries
         }));
 
         compute.dispatchWorkgroups(workDim[0], workDim[1], workDim[2])
-        compute.end()
-        const command = commandEncoder.finish();
-        this.device.queue.submit([command]);
+        this.numPendingDispatches += 1;
+        if (this.numPendingDispatches >= this.maxNumPendingDispatches || this.debugLogFinish) {
+          this.flushCommands();
+        }
 
         if (this.debugLogFinish) {
           const currCounter = this.shaderSubmitCounter;
@@ -814,16 +928,23 @@ export class WebGPUContext {
 
   // DeviceAPI
   private deviceAllocDataSpace(nbytes: number): GPUPointer {
-    // allocate 0 bytes buffer as 1 bytes buffer.
-    if (nbytes == 0) {
-      nbytes = 1;
+    // allocate 0 bytes buffer as 1 page, sizes are rounded to pages like PooledAllocator.
+    const pageSize = this.bufferPoolPageSize;
+    const size = Math.max(Math.ceil(nbytes / pageSize), 1) * pageSize;
+    const pooled = this.bufferPool.get(size);
+    if (pooled !== undefined && pooled.length != 0) {
+      const buffer = pooled.pop() as GPUBuffer;
+      this.pooledBytes -= size;
+      this.bufferPoolHitCounter += 1;
+      return this.attachToBufferTable(buffer);
     }
     const buffer = tryCreateBuffer(this.device, {
-      size: nbytes,
+      size: size,
       usage: GPUBufferUsage.STORAGE | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
     });
-    this.currAllocatedBytes += nbytes;
-    this.allAllocatedBytes += nbytes;
+    this.bufferPoolMissCounter += 1;
+    this.currAllocatedBytes += size;
+    this.allAllocatedBytes += size;
     if (this.currAllocatedBytes > this.peakAllocatedBytes) {
       this.peakAllocatedBytes = this.currAllocatedBytes;
     }
@@ -837,8 +958,14 @@ export class WebGPUContext {
     this.bufferTable[idx] = undefined;
     assert(buffer !== undefined);
     this.bufferTableFreeId.push(idx);
-    this.currAllocatedBytes -= buffer.size;
-    buffer.destroy();
+    // keep the buffer for reuse, released by releaseBufferPool.
+    const pooled = this.bufferPool.get(buffer.size);
+    if (pooled === undefined) {
+      this.bufferPool.set(buffer.size, [buffer]);
+    } else {
+      pooled.push(buffer);
+    }
+    this.pooledBytes += buffer.size;
   }
 
   private deviceCopyToGPU(
@@ -847,6 +974,8 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
+    // writeBuffer runs ahead of unsubmitted commands, so flush them first.
+    this.flushCommands();
     // Perhaps it would be more useful to use a staging buffer?
     let rawBytes = this.memory.loadRawBytes(from, nbytes);
     if (rawBytes.length % 4 !== 0) {
@@ -877,7 +1006,7 @@ export class WebGPUContext {
       usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
     });
 
-    const copyEncoder = this.device.createCommandEncoder();
+    const copyEncoder = this.getPendingCommandEncoder();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
@@ -885,8 +1014,7 @@ export class WebGPUContext {
       0,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
+    this.flushCommands();
 
     gpuTemp.mapAsync(GPUMapMode.READ).then(() => {
       const data = gpuTemp.getMappedRange();
@@ -902,7 +1030,8 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    const copyEncoder = this.device.createCommandEncoder();
+    // recorded into the pending batch, keeping the order with the dispatches
+    const copyEncoder = this.getPendingCommandEncoder();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
@@ -910,8 +1039,6 @@ export class WebGPUContext {
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
   }
 
   private gpuBufferFromPtr(ptr: GPUPointer): GPUBuffer {